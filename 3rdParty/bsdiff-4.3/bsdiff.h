@@ -0,0 +1,52 @@
+/**
+ * @file bsdiff.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef BSDIFF_INCLUDE_GUARD
+#define BSDIFF_INCLUDE_GUARD
+
+#include <sys/types.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sorts the suffixes of an origin image. The returned suffix array is only read by
+ * bsDiff(), so it may be shared by several threads computing the patches of different destination
+ * segments against the same origin image. It must be released with free(3).
+ *
+ * @note On failure, this function calls exit(3) like the bsdiff tool
+ *
+ * @return
+ *      - The suffix array of oldsize + 1 elements
+ */
+//--------------------------------------------------------------------------------------------------
+off_t *bsDiff_Sort
+(
+    u_char *old,            ///< [IN] Origin image
+    off_t oldsize           ///< [IN] Size of the origin image
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function computes the BSDIFF40 delta patch of a destination image against an origin image
+ * and writes it to a patch file. The produced patch is the same as the one of the bsdiff tool.
+ *
+ * @note On failure, this function calls exit(3) like the bsdiff tool
+ *
+ * @return
+ *      - 0           Patch is successfully written
+ */
+//--------------------------------------------------------------------------------------------------
+int bsDiff
+(
+    u_char *old,            ///< [IN] Origin image
+    off_t oldsize,          ///< [IN] Size of the origin image
+    off_t *I,               ///< [IN] Suffix array of the origin image, returned by bsDiff_Sort()
+    u_char *new,            ///< [IN] Destination image
+    off_t newsize,          ///< [IN] Size of the destination image
+    char *patchfile         ///< [IN] File where to write the patch
+);
+
+#endif // BSDIFF_INCLUDE_GUARD
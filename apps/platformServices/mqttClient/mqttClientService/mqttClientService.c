@@ -12,6 +12,9 @@
 #include "legato.h"
 #include "interfaces.h"
 
+#include <sys/mman.h>
+#include <sys/uio.h>
+
 #include "MQTTClient.h"
 #include "Socket.h"
 
@@ -22,6 +25,22 @@
 //--------------------------------------------------------------------------------------------------
 static const char *SslCaCertsPathPtr = "/etc/ssl/certs/ca-certificates.crt";
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the offline stores of the sessions, one file per client ID.  The sandbox is kept in
+ * flash.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SPOOL_DIR "/mqttSpool"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum number of payload bytes waiting to be published, unless changed with
+ * mqtt_SetPublishOptions().
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_MAX_QUEUED_BYTES (64 * 1024)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * MQTT Session structure
@@ -38,15 +57,92 @@ typedef struct mqtt_Session
     void* connectionLostHandlerContextPtr;
     // The legato client session that owns this MQTT session
     le_msg_SessionRef_t clientSession;
+    char clientId[MQTT_MAX_CLIENT_ID_LENGTH + 1];
+    // Messages queued by mqtt_QueuePublish() and mqtt_QueuePublishFile(), waiting to be published
+    // and waiting for the broker's acknowledgement
+    le_dls_List_t publishQueue;
+    le_dls_List_t inflightList;
+    size_t numInflight;
+    size_t maxInflight;
+    size_t queuedBytes;
+    size_t maxQueuedBytes;
+    bool storeOffline;
 } mqtt_Session;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Where the payload of a queued message is kept, which decides how it is freed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PAYLOAD_POOL,       ///< Block from the payload pool
+    PAYLOAD_HEAP,       ///< Heap allocation, or NULL for an empty payload
+    PAYLOAD_MAPPED      ///< Read-only mapping of the file given to mqtt_QueuePublishFile()
+}
+PayloadStorage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message queued by mqtt_QueuePublish() or mqtt_QueuePublishFile().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;                 ///< Link in the publish queue or the in-flight list
+    char* topicPtr;                     ///< Topic, from the queued topic pool
+    uint8_t* payloadPtr;                ///< Payload
+    size_t payloadLength;               ///< Payload length in bytes
+    PayloadStorage_t storage;           ///< Where the payload is kept
+    int qos;                            ///< QoS value as defined by the MQTT specification
+    bool retain;                        ///< Retain flag for the message
+    MQTTClient_deliveryToken token;     ///< Token of the message once published
+}
+PendingPublish_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a message in an offline store.  The topic (without terminating null character) and
+ * the payload follow.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t qos;
+    uint8_t retain;
+    uint16_t topicLength;
+    uint32_t payloadLength;
+}
+SpoolRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delivery complete event report, see DeliveryCompleteHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    mqtt_SessionRef_t sessionRef;
+    MQTTClient_deliveryToken token;
+}
+DeliveryReport_t;
+
 static int QosEnumToValue(mqtt_Qos_t qos);
 static void ConnectionLostHandler(void* contextPtr, char* causePtr);
 static void ConnectionLostEventHandler(void* reportPtr);
 static int MessageArrivedHandler(
     void* contextPtr, char* topicNamePtr, int topicLen, MQTTClient_message* messagePtr);
 static void MessageReceivedEventHandler(void* reportPtr);
+static void DeliveryCompleteHandler(void* contextPtr, MQTTClient_deliveryToken token);
+static void DeliveryCompleteEventHandler(void* reportPtr);
 static void DestroySessionInternal(mqtt_Session* sessionPtr);
+static void ReleasePendingPublish(PendingPublish_t* pubPtr);
+static void ReleasePendingPublishList(mqtt_Session* s, le_dls_List_t* listPtr);
+static void LoadSpool(mqtt_Session* s);
+static void PumpPublishQueue(mqtt_Session* s);
+static void HandleDisconnection(mqtt_Session* s);
+static le_result_t QueuePendingPublish(mqtt_Session* s, PendingPublish_t* pubPtr);
+static PendingPublish_t* CreatePendingPublish(const char* topicPtr, mqtt_Qos_t qos, bool retain);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -72,6 +168,14 @@ static le_event_Id_t ReceiveThreadEventId;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t ConnectionLostThreadEventId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event id for delivery complete events from paho.  The justification for this event is the same
+ * as for ReceiveThreadEventId.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t DeliveryCompleteThreadEventId;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * MQTT session memory pool.
@@ -114,6 +218,20 @@ static le_mem_PoolRef_t TopicPoolRef = NULL;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t PayloadPoolRef = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued message memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PendingPublishPoolRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued message topic memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t QueuedTopicPoolRef = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a message which has been received from the MQTT broker.
@@ -174,6 +292,12 @@ le_result_t mqtt_CreateSession
 
     le_msg_SessionRef_t clientSession = mqtt_GetClientSessionRef();
     s->clientSession = clientSession;
+    le_utf8_Copy(s->clientId, clientIdPtr, sizeof(s->clientId), NULL);
+
+    s->publishQueue = LE_DLS_LIST_INIT;
+    s->inflightList = LE_DLS_LIST_INIT;
+    s->maxInflight = 1;
+    s->maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES;
 
     *sessionRefPtr = le_ref_CreateRef(SessionRefMap, s);
 
@@ -182,7 +306,7 @@ le_result_t mqtt_CreateSession
             *sessionRefPtr,
             &ConnectionLostHandler,
             &MessageArrivedHandler,
-            NULL) == MQTTCLIENT_SUCCESS);
+            &DeliveryCompleteHandler) == MQTTCLIENT_SUCCESS);
 
     return LE_OK;
 }
@@ -229,6 +353,8 @@ static void DestroySessionInternal
 )
 {
     MQTTClient_destroy(&(sessionPtr->client));
+    ReleasePendingPublishList(sessionPtr, &sessionPtr->inflightList);
+    ReleasePendingPublishList(sessionPtr, &sessionPtr->publishQueue);
     // It is necessary to cast to char* from const char* in order to free the memory
     // associated with the username and password.
     le_mem_Release((char*)sessionPtr->connectOptions.username);
@@ -370,6 +496,11 @@ le_result_t mqtt_Connect
 
         case MQTTCLIENT_SUCCESS:
             result = LE_OK;
+            if (s->storeOffline)
+            {
+                LoadSpool(s);
+            }
+            PumpPublishQueue(s);
             break;
 
          default:
@@ -418,6 +549,7 @@ le_result_t mqtt_Disconnect
     {
         case MQTTCLIENT_SUCCESS:
             result = LE_OK;
+            HandleDisconnection(s);
             break;
 
         case MQTTCLIENT_FAILURE:
@@ -481,6 +613,214 @@ le_result_t mqtt_Publish
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how messages given to mqtt_QueuePublish() and mqtt_QueuePublishFile() are published.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if maxInflight is 0, or if storeOffline is requested for a client ID
+ *        that can't be used as a file name
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t mqtt_SetPublishOptions
+(
+    mqtt_SessionRef_t sessionRef,   ///< [IN] Session
+    uint16_t maxInflight,           ///< [IN] Maximum number of unacknowledged QoS 1 and 2 messages
+    uint32_t maxQueuedBytes,        ///< [IN] Maximum number of payload bytes waiting to be
+                                    ///  published or acknowledged, and in the offline store
+    bool storeOffline               ///< [IN] Keep messages in flash while disconnected
+)
+{
+    mqtt_Session* s = le_ref_Lookup(SessionRefMap, sessionRef);
+    if (s == NULL)
+    {
+        LE_KILL_CLIENT("Session doesn't exist");
+        return LE_FAULT;
+    }
+    if (s->clientSession != mqtt_GetClientSessionRef())
+    {
+        LE_KILL_CLIENT("Session doesn't belong to this client");
+        return LE_FAULT;
+    }
+
+    if (maxInflight == 0)
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (storeOffline &&
+        ((s->clientId[0] == '\0') || (s->clientId[0] == '.') || (strchr(s->clientId, '/') != NULL)))
+    {
+        LE_WARN("Client ID '%s' can't name an offline store", s->clientId);
+        return LE_BAD_PARAMETER;
+    }
+
+    s->maxInflight = maxInflight;
+    s->maxQueuedBytes = maxQueuedBytes;
+    s->storeOffline = storeOffline;
+
+    // paho only lets one message be in flight at a time on a "reliable" connection.
+    s->connectOptions.reliable = (maxInflight == 1);
+
+    PumpPublishQueue(s);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the supplied payload for publishing to the MQTT broker on the given topic.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the queue or the offline store is full
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t mqtt_QueuePublish
+(
+    mqtt_SessionRef_t sessionRef,   ///< [IN] Session
+    const char* topicPtr,           ///< [IN] Topic
+    const uint8_t* payloadPtr,      ///< [IN] Message
+    size_t payloadLen,              ///< [IN] Message length
+    mqtt_Qos_t qos,                 ///< [IN] QoS mode
+    bool retain                     ///< [IN] Retain flag for message
+)
+{
+    mqtt_Session* s = le_ref_Lookup(SessionRefMap, sessionRef);
+    if (s == NULL)
+    {
+        LE_KILL_CLIENT("Session doesn't exist");
+        return LE_FAULT;
+    }
+    if (s->clientSession != mqtt_GetClientSessionRef())
+    {
+        LE_KILL_CLIENT("Session doesn't belong to this client");
+        return LE_FAULT;
+    }
+
+    PendingPublish_t* pubPtr = CreatePendingPublish(topicPtr, qos, retain);
+    pubPtr->storage = PAYLOAD_POOL;
+    pubPtr->payloadPtr = le_mem_ForceAlloc(PayloadPoolRef);
+    pubPtr->payloadLength = payloadLen;
+    memcpy(pubPtr->payloadPtr, payloadPtr, payloadLen);
+
+    return QueuePendingPublish(s, pubPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the contents of a file for publishing to the MQTT broker on the given topic.  Regular
+ * files are mapped rather than copied; the contents of other files, such as pipes, are read in.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the queue or the offline store is full
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t mqtt_QueuePublishFile
+(
+    mqtt_SessionRef_t sessionRef,   ///< [IN] Session
+    const char* topicPtr,           ///< [IN] Topic
+    int payloadFile,                ///< [IN] File holding the message
+    mqtt_Qos_t qos,                 ///< [IN] QoS mode
+    bool retain                     ///< [IN] Retain flag for message
+)
+{
+    struct stat st;
+
+    mqtt_Session* s = le_ref_Lookup(SessionRefMap, sessionRef);
+    if (s == NULL)
+    {
+        LE_KILL_CLIENT("Session doesn't exist");
+        close(payloadFile);
+        return LE_FAULT;
+    }
+    if (s->clientSession != mqtt_GetClientSessionRef())
+    {
+        LE_KILL_CLIENT("Session doesn't belong to this client");
+        close(payloadFile);
+        return LE_FAULT;
+    }
+
+    if (fstat(payloadFile, &st) != 0)
+    {
+        LE_ERROR("Couldn't stat payload file (%m)");
+        close(payloadFile);
+        return LE_FAULT;
+    }
+
+    PendingPublish_t* pubPtr = CreatePendingPublish(topicPtr, qos, retain);
+
+    if (S_ISREG(st.st_mode))
+    {
+        if ((size_t)st.st_size > s->maxQueuedBytes)
+        {
+            close(payloadFile);
+            ReleasePendingPublish(pubPtr);
+            return LE_OVERFLOW;
+        }
+
+        if (st.st_size > 0)
+        {
+            void* mapPtr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, payloadFile, 0);
+            if (mapPtr == MAP_FAILED)
+            {
+                LE_ERROR("Couldn't map payload file (%m)");
+                close(payloadFile);
+                ReleasePendingPublish(pubPtr);
+                return LE_FAULT;
+            }
+            pubPtr->storage = PAYLOAD_MAPPED;
+            pubPtr->payloadPtr = mapPtr;
+            pubPtr->payloadLength = st.st_size;
+        }
+    }
+    else
+    {
+        size_t capacity = 0;
+        ssize_t readCount;
+
+        do
+        {
+            if (pubPtr->payloadLength == capacity)
+            {
+                if (capacity > s->maxQueuedBytes)
+                {
+                    close(payloadFile);
+                    ReleasePendingPublish(pubPtr);
+                    return LE_OVERFLOW;
+                }
+                capacity = (capacity == 0) ? MQTT_MAX_PAYLOAD_LENGTH : capacity * 2;
+                pubPtr->payloadPtr = realloc(pubPtr->payloadPtr, capacity);
+                LE_ASSERT(pubPtr->payloadPtr != NULL);
+            }
+
+            readCount = read(payloadFile,
+                             pubPtr->payloadPtr + pubPtr->payloadLength,
+                             capacity - pubPtr->payloadLength);
+            if (readCount > 0)
+            {
+                pubPtr->payloadLength += readCount;
+            }
+        }
+        while ((readCount > 0) || ((readCount < 0) && (errno == EINTR)));
+
+        if (readCount < 0)
+        {
+            LE_ERROR("Couldn't read payload file (%m)");
+            close(payloadFile);
+            ReleasePendingPublish(pubPtr);
+            return LE_FAULT;
+        }
+    }
+
+    close(payloadFile);
+
+    return QueuePendingPublish(s, pubPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Subscribe to the given topic pattern.  Topics look like UNIX filesystem paths.  Eg.
@@ -737,6 +1077,458 @@ static int QosEnumToValue
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free a queued message.  The caller accounts for its payload in the session's queued bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleasePendingPublish
+(
+    PendingPublish_t* pubPtr    ///< [IN] Message to free
+)
+{
+    switch (pubPtr->storage)
+    {
+        case PAYLOAD_POOL:
+            le_mem_Release(pubPtr->payloadPtr);
+            break;
+
+        case PAYLOAD_HEAP:
+            free(pubPtr->payloadPtr);
+            break;
+
+        case PAYLOAD_MAPPED:
+            munmap(pubPtr->payloadPtr, pubPtr->payloadLength);
+            break;
+    }
+
+    le_mem_Release(pubPtr->topicPtr);
+    le_mem_Release(pubPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free all the queued messages of a list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleasePendingPublishList
+(
+    mqtt_Session* s,            ///< [IN] Session the list belongs to
+    le_dls_List_t* listPtr      ///< [IN] List of PendingPublish_t
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(listPtr)) != NULL)
+    {
+        PendingPublish_t* pubPtr = CONTAINER_OF(linkPtr, PendingPublish_t, link);
+
+        s->queuedBytes -= pubPtr->payloadLength;
+        ReleasePendingPublish(pubPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the offline store of a session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSpoolPath
+(
+    mqtt_Session* s,            ///< [IN] Session
+    char* pathPtr,              ///< [OUT] Path
+    size_t pathSize             ///< [IN] Size of the path buffer
+)
+{
+    snprintf(pathPtr, pathSize, "%s/%s", SPOOL_DIR, s->clientId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read exactly the given number of bytes from a file.
+ *
+ * @return
+ *      true if all the bytes were read, false at end of file or on error
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadFully
+(
+    int fd,                     ///< [IN] File to read from
+    void* bufPtr,               ///< [OUT] Buffer
+    size_t numBytes             ///< [IN] Number of bytes to read
+)
+{
+    size_t offset = 0;
+
+    while (offset < numBytes)
+    {
+        ssize_t readCount = read(fd, (uint8_t*)bufPtr + offset, numBytes - offset);
+        if (readCount < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (readCount <= 0)
+        {
+            return false;
+        }
+        offset += readCount;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a message to the offline store of a session.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the store would grow beyond the session's maximum queued bytes
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SpoolPublish
+(
+    mqtt_Session* s,            ///< [IN] Session
+    PendingPublish_t* pubPtr    ///< [IN] Message to store
+)
+{
+    char path[PATH_MAX];
+    struct stat st;
+    SpoolRecord_t record =
+    {
+        .qos = pubPtr->qos,
+        .retain = pubPtr->retain,
+        .topicLength = strlen(pubPtr->topicPtr),
+        .payloadLength = pubPtr->payloadLength
+    };
+    struct iovec iov[] =
+    {
+        { .iov_base = &record, .iov_len = sizeof(record) },
+        { .iov_base = pubPtr->topicPtr, .iov_len = record.topicLength },
+        { .iov_base = pubPtr->payloadPtr, .iov_len = pubPtr->payloadLength }
+    };
+    size_t recordLength = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+    if (le_dir_MakePath(SPOOL_DIR, S_IRWXU) == LE_FAULT)
+    {
+        LE_ERROR("Couldn't create directory '%s'", SPOOL_DIR);
+        return LE_FAULT;
+    }
+
+    GetSpoolPath(s, path, sizeof(path));
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LE_ERROR("Couldn't open '%s' (%m)", path);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    if (fstat(fd, &st) != 0)
+    {
+        LE_ERROR("Couldn't stat '%s' (%m)", path);
+        result = LE_FAULT;
+    }
+    else if ((size_t)st.st_size + recordLength > s->maxQueuedBytes)
+    {
+        result = LE_OVERFLOW;
+    }
+    else if (writev(fd, iov, NUM_ARRAY_MEMBERS(iov)) != (ssize_t)recordLength)
+    {
+        // Don't leave a partial record behind.
+        LE_ERROR("Couldn't write to '%s' (%m)", path);
+        if (ftruncate(fd, st.st_size) != 0)
+        {
+            LE_ERROR("Couldn't truncate '%s' (%m)", path);
+        }
+        result = LE_FAULT;
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the messages kept in the offline store of a session to the end of its publish queue, and
+ * delete the store.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadSpool
+(
+    mqtt_Session* s             ///< [IN] Session
+)
+{
+    char path[PATH_MAX];
+    SpoolRecord_t record;
+    size_t numLoaded = 0;
+
+    GetSpoolPath(s, path, sizeof(path));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Couldn't open '%s' (%m)", path);
+        }
+        return;
+    }
+
+    // A record cut short by a crash ends the store.
+    while (ReadFully(fd, &record, sizeof(record)))
+    {
+        if (record.topicLength > MQTT_MAX_TOPIC_LENGTH)
+        {
+            LE_ERROR("Corrupt record in '%s'", path);
+            break;
+        }
+
+        PendingPublish_t* pubPtr = le_mem_ForceAlloc(PendingPublishPoolRef);
+        memset(pubPtr, 0, sizeof(*pubPtr));
+        pubPtr->link = LE_DLS_LINK_INIT;
+        pubPtr->topicPtr = le_mem_ForceAlloc(QueuedTopicPoolRef);
+        pubPtr->storage = PAYLOAD_HEAP;
+        pubPtr->payloadPtr = malloc(record.payloadLength);
+        pubPtr->payloadLength = record.payloadLength;
+        pubPtr->qos = record.qos;
+        pubPtr->retain = record.retain;
+        LE_ASSERT(pubPtr->payloadPtr != NULL || record.payloadLength == 0);
+
+        if (!ReadFully(fd, pubPtr->topicPtr, record.topicLength) ||
+            !ReadFully(fd, pubPtr->payloadPtr, record.payloadLength))
+        {
+            ReleasePendingPublish(pubPtr);
+            break;
+        }
+        pubPtr->topicPtr[record.topicLength] = '\0';
+
+        le_dls_Queue(&s->publishQueue, &pubPtr->link);
+        s->queuedBytes += pubPtr->payloadLength;
+        numLoaded++;
+    }
+
+    close(fd);
+    unlink(path);
+
+    LE_INFO("Loaded %zu stored messages for '%s'", numLoaded, s->clientId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Publish queued messages until the in-flight window of a session is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PumpPublishQueue
+(
+    mqtt_Session* s             ///< [IN] Session
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((s->numInflight < s->maxInflight) &&
+           ((linkPtr = le_dls_Peek(&s->publishQueue)) != NULL))
+    {
+        PendingPublish_t* pubPtr = CONTAINER_OF(linkPtr, PendingPublish_t, link);
+
+        const int publishResult = MQTTClient_publish(s->client,
+                                                     pubPtr->topicPtr,
+                                                     pubPtr->payloadLength,
+                                                     pubPtr->payloadPtr,
+                                                     pubPtr->qos,
+                                                     pubPtr->retain,
+                                                     &pubPtr->token);
+        if ((publishResult == MQTTCLIENT_MAX_MESSAGES_INFLIGHT) ||
+            (publishResult == MQTTCLIENT_DISCONNECTED))
+        {
+            // Retried when a message is acknowledged or the session connects again.
+            break;
+        }
+
+        le_dls_Remove(&s->publishQueue, linkPtr);
+
+        if (publishResult != MQTTCLIENT_SUCCESS)
+        {
+            LE_WARN("Publish to '%s' failed with error code (%d)", pubPtr->topicPtr, publishResult);
+            s->queuedBytes -= pubPtr->payloadLength;
+            ReleasePendingPublish(pubPtr);
+        }
+        else if (pubPtr->qos == 0)
+        {
+            s->queuedBytes -= pubPtr->payloadLength;
+            ReleasePendingPublish(pubPtr);
+        }
+        else
+        {
+            le_dls_Queue(&s->inflightList, linkPtr);
+            s->numInflight++;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the loss or closing of the broker connection of a session: unacknowledged messages go
+ * back to the head of the publish queue, to be published again, and if the session keeps messages
+ * offline the whole queue is moved to the offline store.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleDisconnection
+(
+    mqtt_Session* s             ///< [IN] Session
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_PopTail(&s->inflightList)) != NULL)
+    {
+        le_dls_Stack(&s->publishQueue, linkPtr);
+    }
+    s->numInflight = 0;
+
+    if (!s->storeOffline)
+    {
+        return;
+    }
+
+    while ((linkPtr = le_dls_Pop(&s->publishQueue)) != NULL)
+    {
+        PendingPublish_t* pubPtr = CONTAINER_OF(linkPtr, PendingPublish_t, link);
+
+        if (SpoolPublish(s, pubPtr) != LE_OK)
+        {
+            LE_WARN("Dropping message to '%s'", pubPtr->topicPtr);
+        }
+        s->queuedBytes -= pubPtr->payloadLength;
+        ReleasePendingPublish(pubPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a message for publishing, or keep it in the offline store if the session isn't connected
+ * and keeps messages offline.  Takes ownership of the message.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the queue or the offline store is full
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t QueuePendingPublish
+(
+    mqtt_Session* s,            ///< [IN] Session
+    PendingPublish_t* pubPtr    ///< [IN] Message
+)
+{
+    le_result_t result = LE_OK;
+
+    if (s->storeOffline && !MQTTClient_isConnected(s->client))
+    {
+        result = SpoolPublish(s, pubPtr);
+        ReleasePendingPublish(pubPtr);
+    }
+    else if (s->queuedBytes + pubPtr->payloadLength > s->maxQueuedBytes)
+    {
+        result = LE_OVERFLOW;
+        ReleasePendingPublish(pubPtr);
+    }
+    else
+    {
+        le_dls_Queue(&s->publishQueue, &pubPtr->link);
+        s->queuedBytes += pubPtr->payloadLength;
+        PumpPublishQueue(s);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a message to be queued, without its payload.
+ *
+ * @return
+ *      The message
+ */
+//--------------------------------------------------------------------------------------------------
+static PendingPublish_t* CreatePendingPublish
+(
+    const char* topicPtr,       ///< [IN] Topic
+    mqtt_Qos_t qos,             ///< [IN] QoS mode
+    bool retain                 ///< [IN] Retain flag for the message
+)
+{
+    PendingPublish_t* pubPtr = le_mem_ForceAlloc(PendingPublishPoolRef);
+    memset(pubPtr, 0, sizeof(*pubPtr));
+
+    pubPtr->link = LE_DLS_LINK_INIT;
+    pubPtr->topicPtr = le_mem_ForceAlloc(QueuedTopicPoolRef);
+    LE_ASSERT(le_utf8_Copy(pubPtr->topicPtr, topicPtr, MQTT_MAX_TOPIC_LENGTH + 1, NULL) == LE_OK);
+    pubPtr->storage = PAYLOAD_HEAP;
+    pubPtr->qos = QosEnumToValue(qos);
+    pubPtr->retain = retain;
+
+    return pubPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This is the delivery complete callback function that is supplied to the paho library.  It is
+ * called when the broker has acknowledged a QoS 1 or 2 message.  The function generates an event
+ * because it will be called on a non-Legato thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeliveryCompleteHandler
+(
+    void* contextPtr,                   ///< context parameter contains the session
+    MQTTClient_deliveryToken token      ///< token of the acknowledged message
+)
+{
+    DeliveryReport_t report = { .sessionRef = contextPtr, .token = token };
+
+    le_event_Report(DeliveryCompleteThreadEventId, &report, sizeof(report));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The event handler for the delivery complete event that is generated by DeliveryCompleteHandler.
+ * This function frees the acknowledged message and publishes more queued messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeliveryCompleteEventHandler
+(
+    void* reportPtr
+)
+{
+    const DeliveryReport_t* deliveryPtr = reportPtr;
+
+    mqtt_Session* s = le_ref_Lookup(SessionRefMap, deliveryPtr->sessionRef);
+    if (s == NULL)
+    {
+        return;
+    }
+
+    // Messages published with mqtt_Publish() aren't tracked, so the token may not be found.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&s->inflightList);
+    while (linkPtr != NULL)
+    {
+        PendingPublish_t* pubPtr = CONTAINER_OF(linkPtr, PendingPublish_t, link);
+
+        if (pubPtr->token == deliveryPtr->token)
+        {
+            le_dls_Remove(&s->inflightList, linkPtr);
+            s->numInflight--;
+            s->queuedBytes -= pubPtr->payloadLength;
+            ReleasePendingPublish(pubPtr);
+            break;
+        }
+
+        linkPtr = le_dls_PeekNext(&s->inflightList, linkPtr);
+    }
+
+    PumpPublishQueue(s);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This is the connection lost callback function that is supplied to the paho library.  The
@@ -764,13 +1556,15 @@ static void ConnectionLostEventHandler
     void* reportPtr
 )
 {
-    mqtt_Session* s = le_ref_Lookup(SessionRefMap, reportPtr);
+    mqtt_Session* s = le_ref_Lookup(SessionRefMap, *((void**)reportPtr));
     if (s == NULL)
     {
-        LE_KILL_CLIENT("Session doesn't exist");
+        LE_WARN("Session doesn't exist");
         return;
     }
 
+    HandleDisconnection(s);
+
     if (s->connectionLostHandler != NULL)
     {
         s->connectionLostHandler(s->connectionLostHandlerContextPtr);
@@ -924,6 +1718,9 @@ COMPONENT_INIT
     MessagePoolRef = le_mem_CreatePool("MQTT message pool", sizeof(mqtt_Message));
     TopicPoolRef = le_mem_CreatePool("MQTT topic pool", MQTT_MAX_TOPIC_LENGTH);
     PayloadPoolRef = le_mem_CreatePool("MQTT payload pool", MQTT_MAX_PAYLOAD_LENGTH);
+    PendingPublishPoolRef = le_mem_CreatePool("MQTT queued message pool",
+                                              sizeof(PendingPublish_t));
+    QueuedTopicPoolRef = le_mem_CreatePool("MQTT queued topic pool", MQTT_MAX_TOPIC_LENGTH + 1);
 
     SessionRefMap = le_ref_CreateMap("MQTT sessions", 16);
 
@@ -939,6 +1736,13 @@ COMPONENT_INIT
         ConnectionLostThreadEventId,
         ConnectionLostEventHandler);
 
+    DeliveryCompleteThreadEventId = le_event_CreateId(
+        "MqttClient delivery complete notification", sizeof(DeliveryReport_t));
+    le_event_AddHandler(
+        "MqttClient delivery complete notification",
+        DeliveryCompleteThreadEventId,
+        DeliveryCompleteEventHandler);
+
     le_msg_AddServiceCloseHandler(mqtt_GetServiceRef(), DestroyAllOwnedSessions, NULL);
 
     MQTTClient_init_options initOptions = MQTTClient_init_options_initializer;
@@ -0,0 +1,290 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performance benchmark for the AT commands parser of the AT server.
+ *
+ * Registers a command table of the given size, (the commands used below and 100 fillers by
+ * default,) opens the server on one end of a socket pair, and sends concatenated command lines on
+ * the other end, as fast as the server answers them.  For each command line it measures the
+ * number of AT commands parsed and handled per second.
+ *
+ * Usage:
+ *
+ *      atServerParserBench [fillerCount]
+ *
+ * The results are printed to stdout, one line per command line.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+
+/// Number of times each command line is sent.
+#define LOOPS 2000
+
+/// Largest number of filler commands that can be registered.
+#define MAX_FILLERS 500
+
+/// Final response of the command lines.
+#define OK_RSP "\r\nOK\r\n"
+
+/// Size of the host receive buffer.
+#define RSP_MAX_BYTES 256
+
+
+
+/// Command lines sent by the host, and the number of AT commands in each of them.
+static const struct
+{
+    const char* linePtr;
+    size_t      cmdCount;
+}
+Lines[] =
+{
+    { "AT\r",                                   1 },
+    { "ATE0V1&C1&D2S0=0\r",                     5 },
+    { "AT&FE0V1&C1&D2S95=47S0=0Q0\r",           8 },
+    { "AT+CPIN?;+CSQ;+COPS?;+CGDCONT=1,\"IP\",\"apn\"\r", 4 },
+    { "ATE0;+CPIN?;V1;+CSQ;&C1;+CGDCONT?\r",    6 },
+};
+
+/// Commands used by the command lines.
+static const char* const Commands[] =
+{
+    "AT", "ATE", "ATV", "ATQ", "ATS", "AT&C", "AT&D", "AT&F",
+    "AT+CPIN", "AT+CSQ", "AT+COPS", "AT+CGDCONT",
+};
+
+/// Number of filler commands, which make the command table bigger.
+static size_t FillerCount = 100;
+
+/// Host end of the socket pair.
+static int HostFd = -1;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of all the AT commands: answers OK right away.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CmdHandler
+(
+    le_atServer_CmdRef_t commandRef,
+    le_atServer_Type_t type,
+    uint32_t parametersNumber,
+    void* contextPtr
+)
+{
+    LE_ASSERT_OK(le_atServer_SendFinalResultCode(commandRef, LE_ATSERVER_OK, "", 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register an AT command.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RegisterCommand
+(
+    const char* namePtr
+)
+{
+    le_atServer_CmdRef_t cmdRef = le_atServer_Create(namePtr);
+    LE_ASSERT(cmdRef != NULL);
+
+    LE_ASSERT(le_atServer_AddCommandHandler(cmdRef, CmdHandler, NULL) != NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a command line, and wait for its final response.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendLine
+(
+    const char* linePtr,
+    size_t lineLen
+)
+{
+    char rsp[RSP_MAX_BYTES];
+    size_t rspLen = 0;
+
+    LE_ASSERT(write(HostFd, linePtr, lineLen) == (ssize_t)lineLen);
+
+    while ((rspLen < sizeof(OK_RSP) - 1) ||
+           (memcmp(rsp + rspLen - (sizeof(OK_RSP) - 1), OK_RSP, sizeof(OK_RSP) - 1) != 0))
+    {
+        ssize_t count = read(HostFd, rsp + rspLen, sizeof(rsp) - rspLen);
+        LE_ASSERT(count > 0);
+
+        rspLen += count;
+        LE_ASSERT(rspLen < sizeof(rsp));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host thread: sends the command lines and prints the results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* HostThread
+(
+    void* contextPtr
+)
+{
+    size_t i;
+
+    printf("%zu commands registered\n", NUM_ARRAY_MEMBERS(Commands) + FillerCount);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Lines); i++)
+    {
+        size_t lineLen = strlen(Lines[i].linePtr);
+        int loop;
+
+        // Warm up
+        SendLine(Lines[i].linePtr, lineLen);
+
+        le_clk_Time_t start = le_clk_GetRelativeTime();
+
+        for (loop = 0; loop < LOOPS; loop++)
+        {
+            SendLine(Lines[i].linePtr, lineLen);
+        }
+
+        le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+        double usec = (double)elapsed.sec * 1000000 + elapsed.usec;
+
+        printf("%-48.*s %10.0f commands/s %8.1f us/line\n",
+               (int)(lineLen - 1),
+               Lines[i].linePtr,
+               (double)(LOOPS * Lines[i].cmdCount) * 1000000 / usec,
+               usec / LOOPS);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT client stubs, for the bridge of the AT server.  No bridge is opened by the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_ConnectService(void) {}
+
+le_atClient_DeviceRef_t le_atClient_Start(int32_t fd)
+{
+    return NULL;
+}
+
+le_result_t le_atClient_Stop(le_atClient_DeviceRef_t deviceRef)
+{
+    return LE_FAULT;
+}
+
+le_result_t le_atClient_SetCommandAndSend(le_atClient_CmdRef_t* cmdRefPtr,
+                                          le_atClient_DeviceRef_t devRef,
+                                          const char* commandPtr,
+                                          const char* interRespPtr,
+                                          const char* finalRespPtr,
+                                          uint32_t timeout)
+{
+    return LE_FAULT;
+}
+
+le_result_t le_atClient_GetFirstIntermediateResponse(le_atClient_CmdRef_t cmdRef,
+                                                     char* responseStr,
+                                                     size_t responseStrNumElements)
+{
+    return LE_FAULT;
+}
+
+le_result_t le_atClient_GetNextIntermediateResponse(le_atClient_CmdRef_t cmdRef,
+                                                    char* responseStr,
+                                                    size_t responseStrNumElements)
+{
+    return LE_FAULT;
+}
+
+le_result_t le_atClient_GetFinalResponse(le_atClient_CmdRef_t cmdRef,
+                                         char* responseStr,
+                                         size_t responseStrNumElements)
+{
+    return LE_FAULT;
+}
+
+le_result_t le_atClient_Delete(le_atClient_CmdRef_t cmdRef)
+{
+    return LE_FAULT;
+}
+
+le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHandler
+(
+    const char* unsolRsp,
+    le_atClient_DeviceRef_t devRef,
+    le_atClient_UnsolicitedResponseHandlerFunc_t handlerPtr,
+    void* contextPtr,
+    uint32_t lineCount
+)
+{
+    return NULL;
+}
+
+void le_atClient_RemoveUnsolicitedResponseHandler
+(
+    le_atClient_UnsolicitedResponseHandlerRef_t handlerRef
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Component initializer.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    char name[LE_ATDEFS_COMMAND_MAX_BYTES];
+    int fds[2];
+    size_t i;
+
+    if (le_arg_NumArgs() >= 1)
+    {
+        const char* argPtr = le_arg_GetArg(0);
+
+        if ((argPtr == NULL) || (sscanf(argPtr, "%zu", &FillerCount) != 1) ||
+            (FillerCount > MAX_FILLERS))
+        {
+            fprintf(stderr, "Usage: atServerParserBench [fillerCount (max %d)]\n", MAX_FILLERS);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Filler commands share the first letters of real ones, as vendor commands often do.
+    for (i = 0; i < FillerCount; i++)
+    {
+        snprintf(name, sizeof(name), "AT+C%03zu", i);
+        RegisterCommand(name);
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Commands); i++)
+    {
+        RegisterCommand(Commands[i]);
+    }
+
+    LE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    HostFd = fds[1];
+
+    // The server owns the fd it is given.
+    LE_ASSERT(le_atServer_Open(fds[0]) != NULL);
+
+    le_thread_Start(le_thread_Create("atHostThread", HostThread, NULL));
+}
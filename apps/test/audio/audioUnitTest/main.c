@@ -8,11 +8,13 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "le_audio_local.h"
+#include "le_media_local.h"
 #include "pa_audio.h"
 #include "log.h"
 #include "pa_pcm_simu.h"
 #include "pa_audio_simu.h"
 #include <string.h>
+#include <math.h>
 
 #define BUFFER_LEN  5000
 
@@ -467,12 +469,15 @@ void Testle_audio_CloseStream
  * Sub-test 1: Connect all streams to a created connector. Check audio paths set.
  * Disconnect all streams. Check that all audio paths are reseted.
  *
- * Sub-test 2: Connect again all streams to the creator.
+ * Sub-test 2: Connect all streams within a routing update, check that the audio paths are set
+ * only when it is applied. Disconnect all streams the same way.
+ *
+ * Sub-test 3: Connect again all streams to the creator.
  * Delete the connector. Check that all audio paths are reseted.
  *
- * Sub-test 3 : Try to connect a stream to a deleted connector (error expected)
+ * Sub-test 4 : Try to connect a stream to a deleted connector (error expected)
  *
- * Sub-test 4 : Connect all streams to a created connector. Check audio paths set.
+ * Sub-test 5 : Connect all streams to a created connector. Check audio paths set.
  * Deleted all streams. Check that all audio paths are reseted.
  *
  * API tested:
@@ -480,6 +485,8 @@ void Testle_audio_CloseStream
  * - le_audio_DeleteConnector
  * - le_audio_Connect
  * - le_audio_Disconnect
+ * - le_audio_StartRoutingUpdate
+ * - le_audio_ApplyRoutingUpdate
  *
  * Exit if failed
  *
@@ -530,6 +537,36 @@ void Testle_audio_Connector
     // Sub-test 2
     //------------
 
+    // Connect and disconnect all streams within routing updates: the audio paths are changed only
+    // when the updates are applied
+    LE_ASSERT(le_audio_ApplyRoutingUpdate() == LE_NOT_PERMITTED);
+    LE_ASSERT(le_audio_StartRoutingUpdate() == LE_OK);
+    LE_ASSERT(le_audio_StartRoutingUpdate() == LE_BUSY);
+
+    for (audioIf = 0; audioIf < LE_AUDIO_NUM_INTERFACES; audioIf++)
+    {
+        LE_ASSERT(le_audio_Connect(connectorRef, StreamRef[audioIf])==LE_OK);
+    }
+
+    LE_ASSERT(pa_audioSimu_CheckAudioPathReseted() == LE_OK);
+    LE_ASSERT(le_audio_ApplyRoutingUpdate() == LE_OK);
+    LE_ASSERT(pa_audioSimu_CheckAudioPathSet() == LE_OK);
+
+    LE_ASSERT(le_audio_StartRoutingUpdate() == LE_OK);
+
+    for (audioIf = 0; audioIf < LE_AUDIO_NUM_INTERFACES; audioIf++)
+    {
+        le_audio_Disconnect(connectorRef, StreamRef[audioIf]);
+    }
+
+    LE_ASSERT(pa_audioSimu_CheckAudioPathSet() == LE_OK);
+    LE_ASSERT(le_audio_ApplyRoutingUpdate() == LE_OK);
+    LE_ASSERT(pa_audioSimu_CheckAudioPathReseted() == LE_OK);
+
+    //------------
+    // Sub-test 3
+    //------------
+
     // Connect again, and check that, when the connector is deleted, all audio path have been
     // reseted
     for (audioIf=0; audioIf < LE_AUDIO_NUM_INTERFACES; audioIf++)
@@ -546,14 +583,14 @@ void Testle_audio_Connector
     LE_ASSERT(pa_audioSimu_CheckAudioPathReseted() == LE_OK);
 
     //------------
-    // Sub-test 3
+    // Sub-test 4
     //------------
 
     // Try to connect a stream to a deleted connector: error expected
     LE_ASSERT(le_audio_Connect(connectorRef, StreamRef[0])==LE_BAD_PARAMETER);
 
     //------------
-    // Sub-test 4
+    // Sub-test 5
     //------------
 
     // Create a new connector
@@ -585,8 +622,11 @@ void Testle_audio_Connector
  * When the event "LE_AUDIO_MEDIA_NO_MORE_SAMPLES" is received, the test check the received data.
  *
  * API tested:
+ * - le_audio_SetSampleLatency
+ * - le_audio_GetSampleLatency
  * - le_audio_PlaySamples
  * - le_audio_AddMediaHandler
+ * - le_audio_GetSampleXrunCount
  * - le_audio_Stop
  *
  * Exit if failed
@@ -600,6 +640,9 @@ void Testle_audio_PlaySamples
 {
     int i;
     le_audio_StreamRef_t playbackStreamRef = NULL;
+    uint32_t latency;
+    uint32_t underrunCount;
+    uint32_t overrunCount;
 
     LE_ASSERT(pipe(Pipefd) == 0);
 
@@ -610,6 +653,14 @@ void Testle_audio_PlaySamples
     playbackStreamRef = le_audio_OpenPlayer();
     LE_ASSERT(playbackStreamRef != NULL);
 
+    // Set the latency target of the samples buffer
+    LE_ASSERT(le_audio_GetSampleLatency(playbackStreamRef, &latency) == LE_OK);
+    LE_ASSERT(latency == LE_MEDIA_DEFAULT_SAMPLE_LATENCY);
+    LE_ASSERT(le_audio_SetSampleLatency(playbackStreamRef, 0) == LE_BAD_PARAMETER);
+    LE_ASSERT(le_audio_SetSampleLatency(playbackStreamRef, 20) == LE_OK);
+    LE_ASSERT(le_audio_GetSampleLatency(playbackStreamRef, &latency) == LE_OK);
+    LE_ASSERT(latency == 20);
+
     // Set the test case
     TestCase = TEST_PLAY_SAMPLES;
 
@@ -630,6 +681,11 @@ void Testle_audio_PlaySamples
     // check data
     LE_ASSERT(memcmp(Buffer, sentPcmPtr, BUFFER_LEN) == 0);
 
+    // No sample was captured
+    LE_ASSERT(le_audio_GetSampleXrunCount(playbackStreamRef, &underrunCount, &overrunCount)
+              == LE_OK);
+    LE_ASSERT(overrunCount == 0);
+
     // Release buffer in pa_pcm_simu
     pa_pcmSimu_ReleaseData();
 
@@ -1029,6 +1085,52 @@ void Testle_audio_DecodingDtmf
     LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the samples of the played dtmf list: each dtmf must be within 1 LSB of the two tones
+ * computed with sin(), and each pause must be silent.
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDtmfSamples
+(
+    const int16_t* samplePtr,
+    uint32_t sampleRate
+)
+{
+    static const char     Keypad[] = "123A456B789C*0#D";
+    static const uint32_t LowFreq[] = { 697, 770, 852, 941 };
+    static const uint32_t HighFreq[] = { 1209, 1336, 1477, 1633 };
+    uint32_t dtmfSamples = sampleRate * DtmfDuration / 1000;
+    uint32_t pauseSamples = sampleRate * DtmfPause / 1000;
+    int i;
+    uint32_t j;
+
+    for (i = 0; i < strlen(DtmfList); i++)
+    {
+        int key = strchr(Keypad, DtmfList[i]) - Keypad;
+        double d1 = (double) LowFreq[key / 4] / sampleRate;
+        double d2 = (double) HighFreq[key % 4] / sampleRate;
+
+        for (j = 0; j < dtmfSamples; j++)
+        {
+            int32_t s1 = (int16_t)(32767 * 40 / 100.0 * sin(2 * M_PI * d1 * j));
+            int32_t s2 = (int16_t)(32767 * 40 / 100.0 * sin(2 * M_PI * d2 * j));
+
+            LE_ASSERT(abs(*samplePtr - (s1 + s2)) <= 1);
+            samplePtr++;
+        }
+
+        for (j = 0; j < pauseSamples; j++)
+        {
+            LE_ASSERT(*samplePtr == 0);
+            samplePtr++;
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test the dtmf playing functionality.
@@ -1085,6 +1187,9 @@ void Testle_audio_PlayDtmf
     // Check that something has been wrote
     LE_ASSERT((uint32_t) *dataPtr == 0x00000000);
 
+    // Check the generated tones
+    CheckDtmfSamples((const int16_t*) dataPtr, sampleRate);
+
     pa_pcmSimu_ReleaseData();
 
     // Stop the test thread
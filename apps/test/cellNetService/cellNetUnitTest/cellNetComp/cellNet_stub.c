@@ -128,6 +128,53 @@ void le_simTest_SimulateState
 }
 
 
+//--------------------------------------------------------------------------------------------------
+// Messaging stubbing
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_cellnet_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_cellnet_GetClientSessionRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [in] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [in] Handler function.
+    void*                           contextPtr  ///< [in] Opaque pointer value to pass to handler.
+)
+{
+    return NULL;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // Secure storage service stubbing
 //--------------------------------------------------------------------------------------------------
@@ -1625,6 +1625,20 @@ le_result_t pa_dcs_GetTimeWithNetworkTimeProtocol
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_dcs_AddNetworkChangeHandler
+(
+    pa_dcs_NetworkChangeHandler_t handlerPtr,   ///< [IN] The network change handler function.
+    void*                         contextPtr    ///< [IN] The context to be given to the handler.
+)
+{
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start watchdogs 0..N-1.  Typically this is used in COMPONENT_INIT to start all watchdogs needed
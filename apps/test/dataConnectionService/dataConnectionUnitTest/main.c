@@ -6,6 +6,7 @@
  * - le_data_GetFirstUsedTechnology
  * - le_data_GetNextUsedTechnology
  * - le_data_GetTechnology
+ * - le_data_GetConnectionTime
  * - le_data_AddConnectionStateHandler
  * - le_data_Request
  * - le_data_Release
@@ -319,6 +320,11 @@ static void DcsStateHandler
     if (isConnected)
     {
         LE_ASSERT(0 == strncmp(intfName, ExpectedIntf, strlen(ExpectedIntf)));
+
+        // Check that the connection time of the connected technology is available
+        uint32_t connectionTimeMs;
+        LE_ASSERT_OK(le_data_GetConnectionTime(currentTech, &connectionTimeMs));
+        LE_DEBUG("Connection time: %"PRIu32" ms", connectionTimeMs);
     }
 
     // Note: the technology retrieved by le_data_GetTechnology() cannot be tested again an expected
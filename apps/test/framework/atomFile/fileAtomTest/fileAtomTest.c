@@ -1139,6 +1139,80 @@ void TestAccessMode
 }
 
 
+static void CheckFileContent(const char* pathPtr, const char* expectedPtr)
+{
+    char buffer[100];
+    int fd = open(pathPtr, O_RDONLY);
+
+    PRINT_ERR_IF(fd < 0, "Failed to open '%s' (%m)", pathPtr);
+    ssize_t len = fd_ReadSize(fd, buffer, sizeof(buffer) - 1);
+    fd_Close(fd);
+
+    PRINT_ERR_IF(len < 0, "Failed to read '%s'", pathPtr);
+    buffer[len] = '\0';
+    PRINT_ERR_IF(strcmp(buffer, expectedPtr) != 0,
+                 "Content of '%s' is '%s', expected '%s'", pathPtr, buffer, expectedPtr);
+}
+
+
+static void TestJournal(const char* testFilePath)
+{
+    char journalPath[PATH_MAX];
+    int fd;
+
+    LE_ASSERT(snprintf(journalPath, sizeof(journalPath), "%s.journal~~", testFilePath)
+                  < sizeof(journalPath));
+
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, 0, "x", 1) != LE_NOT_FOUND,
+                 "Journal write to missing file '%s' didn't fail", testFilePath);
+
+    fd = le_atomFile_Create(testFilePath, LE_FLOCK_WRITE, LE_FLOCK_REPLACE_IF_EXIST, S_IRUSR | S_IWUSR);
+    PRINT_ERR_IF(fd < 0, "Failed to create '%s'", testFilePath);
+    LE_ASSERT(fd_WriteSize(fd, "0123456789", 10) == 10);
+    PRINT_ERR_IF(le_atomFile_Close(fd) != LE_OK, "Failed to close '%s'", testFilePath);
+
+    // Records go to the journal, and leave the file itself untouched.
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, 2, "ab", 2) != LE_OK,
+                 "Journal write to '%s' failed", testFilePath);
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, LE_ATOMFILE_JOURNAL_APPEND, "XYZ", 3)
+                     != LE_OK,
+                 "Journal append to '%s' failed", testFilePath);
+    CheckFileContent(testFilePath, "0123456789");
+    PRINT_ERR_IF(!file_Exists(journalPath), "Journal '%s' doesn't exist", journalPath);
+
+    // A torn record at the end of the journal is dropped, and doesn't hide the next one.
+    fd = open(journalPath, O_WRONLY | O_APPEND);
+    PRINT_ERR_IF(fd < 0, "Failed to open '%s' (%m)", journalPath);
+    LE_ASSERT(fd_WriteSize(fd, "LJRN garbage", 12) == 12);
+    fd_Close(fd);
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, LE_ATOMFILE_JOURNAL_APPEND, "!", 1)
+                     != LE_OK,
+                 "Journal append to '%s' failed", testFilePath);
+
+    // Opening the file applies the journal.
+    fd = le_atomFile_Open(testFilePath, LE_FLOCK_READ);
+    PRINT_ERR_IF(fd < 0, "Failed to open '%s'", testFilePath);
+    le_atomFile_Cancel(fd);
+    CheckFileContent(testFilePath, "01ab456789XYZ!");
+    PRINT_ERR_IF(file_Exists(journalPath), "Journal '%s' wasn't deleted", journalPath);
+
+    // Compacting explicitly.
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, 0, "Z", 1) != LE_OK,
+                 "Journal write to '%s' failed", testFilePath);
+    PRINT_ERR_IF(le_atomFile_CompactJournal(testFilePath) != LE_OK,
+                 "Failed to compact journal of '%s'", testFilePath);
+    CheckFileContent(testFilePath, "Z1ab456789XYZ!");
+    PRINT_ERR_IF(le_atomFile_CompactJournal(testFilePath) != LE_OK,
+                 "Failed to compact missing journal of '%s'", testFilePath);
+
+    // Deleting the file deletes its journal.
+    PRINT_ERR_IF(le_atomFile_WriteJournal(testFilePath, 0, "Y", 1) != LE_OK,
+                 "Journal write to '%s' failed", testFilePath);
+    PRINT_ERR_IF(le_atomFile_Delete(testFilePath) != LE_OK, "Failed to delete '%s'", testFilePath);
+    PRINT_ERR_IF(file_Exists(journalPath), "Journal '%s' wasn't deleted", journalPath);
+}
+
+
 COMPONENT_INIT
 {
 
@@ -1157,6 +1231,10 @@ COMPONENT_INIT
         TestAtomicWrite(TestFileList[i][1]);
         LE_INFO("======== Atomic write test done ========");
 
+        LE_INFO("======== Starting journal test for file: %s ========", TestFileList[i][1]);
+        TestJournal(TestFileList[i][1]);
+        LE_INFO("======== Journal test done ========");
+
         LE_INFO("======== Starting try api test for file: %s ========", TestFileList[i][2]);
         TestTryApis(TestFileList[i][2]);
         LE_INFO("======== Try api test done ========");
@@ -0,0 +1,443 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performance benchmark for the configuration tree.
+ *
+ * Builds synthetic trees of the given numbers of nodes, (1000, 10000 and 100000 by default,) and
+ * for each one measures:
+ *
+ *  - the latency of a read transaction, and of a write transaction that changes one node,
+ *  - the cost of committing a transaction that changes many nodes,
+ *  - the throughput of iterating over the tree with le_cfg_GoToNextSibling(),
+ *  - the time taken to deliver a commit to many change handlers,
+ *  - the time taken to load the tree, measured by importing an export of it.
+ *
+ * The configTree must be running.  Usage:
+ *
+ *      configPerfExe [nodeCount ...]
+ *
+ * The results are printed to stdout, one line per measurement.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+
+/// Where the synthetic trees are built, in the benchmark's own tree.
+#define TEST_ROOT_DIR "/configPerf"
+
+/// Where the exported tree is imported to.
+#define IMPORT_ROOT_DIR "/configPerfImport"
+
+/// Number of value nodes under each stem of the synthetic trees.
+#define GROUP_SIZE 100
+
+/// Number of nodes written by each transaction while building a tree.
+#define BUILD_TXN_SIZE 1000
+
+/// Number of transactions each latency is averaged over.
+#define READ_LOOPS 1000
+#define WRITE_LOOPS 100
+
+/// Number of nodes changed by the large commit.
+#define LARGE_COMMIT_SIZE 1000
+
+/// Largest number of change handlers registered for the fan-out measurement.
+#define HANDLER_COUNT 100
+
+/// Largest number of tree sizes that can be given on the command line.
+#define MAX_SIZES 16
+
+
+
+/// Tree sizes to run the benchmark with.
+static size_t Sizes[MAX_SIZES] = { 1000, 10000, 100000 };
+static size_t SizeCount = 3;
+static size_t SizeIndex = 0;
+
+/// State of the handler fan-out measurement.
+static le_cfg_ChangeHandlerRef_t HandlerRefs[HANDLER_COUNT];
+static size_t HandlerCount = 0;
+static size_t CallCount = 0;
+static le_clk_Time_t FanOutStart;
+
+
+static void RunNextSize(void* param1Ptr, void* param2Ptr);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedUsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return ((double)elapsed.sec * 1000000.0) + (double)elapsed.usec;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Report
+(
+    const char* namePtr,
+    double value,
+    const char* unitPtr
+)
+{
+    printf("%8zu  %-32s %14.1f %s\n", Sizes[SizeIndex], namePtr, value, unitPtr);
+    fflush(stdout);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the synthetic tree, GROUP_SIZE value nodes per stem.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildTree
+(
+    size_t nodeCount
+)
+{
+    le_cfg_QuickDeleteNode(TEST_ROOT_DIR);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    le_cfg_IteratorRef_t iterRef = NULL;
+
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        char path[LE_CFG_STR_LEN_BYTES];
+
+        if (iterRef == NULL)
+        {
+            iterRef = le_cfg_CreateWriteTxn(TEST_ROOT_DIR);
+        }
+
+        snprintf(path, sizeof(path), "g%zu/n%zu", i / GROUP_SIZE, i % GROUP_SIZE);
+        le_cfg_SetInt(iterRef, path, (int32_t)i);
+
+        if (((i + 1) % BUILD_TXN_SIZE) == 0)
+        {
+            le_cfg_CommitTxn(iterRef);
+            iterRef = NULL;
+        }
+    }
+
+    if (iterRef != NULL)
+    {
+        le_cfg_CommitTxn(iterRef);
+    }
+
+    Report("build (per node)", ElapsedUsec(start) / nodeCount, "us");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the latency of short read and write transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TransactionLatency
+(
+    size_t nodeCount
+)
+{
+    size_t groupCount = (nodeCount + GROUP_SIZE - 1) / GROUP_SIZE;
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (size_t i = 0; i < READ_LOOPS; i++)
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_ROOT_DIR);
+
+        snprintf(path, sizeof(path), "g%zu/n0", i % groupCount);
+        le_cfg_GetInt(iterRef, path, 0);
+        le_cfg_CancelTxn(iterRef);
+    }
+
+    Report("read txn", ElapsedUsec(start) / READ_LOOPS, "us");
+
+    start = le_clk_GetRelativeTime();
+
+    for (size_t i = 0; i < WRITE_LOOPS; i++)
+    {
+        snprintf(path, sizeof(path), TEST_ROOT_DIR "/g%zu", i % groupCount);
+
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(path);
+
+        le_cfg_SetInt(iterRef, "n0", (int32_t)i);
+        le_cfg_CommitTxn(iterRef);
+    }
+
+    Report("write txn (1 node)", ElapsedUsec(start) / WRITE_LOOPS, "us");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of committing a transaction that changes nodes all over the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LargeCommit
+(
+    size_t nodeCount
+)
+{
+    size_t changeCount = (nodeCount < LARGE_COMMIT_SIZE) ? nodeCount : LARGE_COMMIT_SIZE;
+    size_t step = nodeCount / changeCount;
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TEST_ROOT_DIR);
+
+    for (size_t i = 0; i < changeCount; i++)
+    {
+        char path[LE_CFG_STR_LEN_BYTES];
+        size_t node = i * step;
+
+        snprintf(path, sizeof(path), "g%zu/n%zu", node / GROUP_SIZE, node % GROUP_SIZE);
+        le_cfg_SetInt(iterRef, path, -(int32_t)node);
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    le_cfg_CommitTxn(iterRef);
+
+    char name[64];
+    snprintf(name, sizeof(name), "commit (%zu nodes)", changeCount);
+    Report(name, ElapsedUsec(start), "us");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of iterating over the whole tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IterationThroughput
+(
+    void
+)
+{
+    size_t count = 0;
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_ROOT_DIR);
+
+    le_result_t result = le_cfg_GoToFirstChild(iterRef);
+
+    while (result == LE_OK)
+    {
+        count++;
+
+        if (le_cfg_GoToFirstChild(iterRef) == LE_OK)
+        {
+            do
+            {
+                count++;
+            }
+            while (le_cfg_GoToNextSibling(iterRef) == LE_OK);
+
+            le_cfg_GoToParent(iterRef);
+        }
+
+        result = le_cfg_GoToNextSibling(iterRef);
+    }
+
+    le_cfg_CancelTxn(iterRef);
+
+    Report("iteration", count / (ElapsedUsec(start) / 1000000.0), "nodes/s");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the time taken to load the tree.  The config tree doesn't reload a tree that's already
+ * loaded, so the tree is exported and imported again instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadTime
+(
+    void
+)
+{
+    char filePath[LE_CFG_STR_LEN_BYTES];
+    snprintf(filePath, sizeof(filePath), "/tmp/configPerf_%d.cfg", (int)getpid());
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_ROOT_DIR);
+    LE_FATAL_IF(le_cfgAdmin_ExportTree(iterRef, filePath, "") != LE_OK,
+                "Could not export the tree to '%s'.",
+                filePath);
+    le_cfg_CancelTxn(iterRef);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    iterRef = le_cfg_CreateWriteTxn(IMPORT_ROOT_DIR);
+    LE_FATAL_IF(le_cfgAdmin_ImportTree(iterRef, filePath, "") != LE_OK,
+                "Could not import the tree from '%s'.",
+                filePath);
+    le_cfg_CommitTxn(iterRef);
+
+    Report("load (import + commit)", ElapsedUsec(start) / 1000.0, "ms");
+
+    unlink(filePath);
+    le_cfg_QuickDeleteNode(IMPORT_ROOT_DIR);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a commit is delivered to one of the fan-out handlers.  Once all of them have been
+ * called, the measurement is done and the benchmark moves on.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FanOutHandler
+(
+    void* contextPtr
+)
+{
+    if (++CallCount < HandlerCount)
+    {
+        return;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "handler fan-out (%zu handlers)", HandlerCount);
+    Report(name, ElapsedUsec(FanOutStart), "us");
+
+    for (size_t i = 0; i < HandlerCount; i++)
+    {
+        le_cfg_RemoveChangeHandler(HandlerRefs[i]);
+    }
+
+    LoadTime();
+
+    le_cfg_QuickDeleteNode(TEST_ROOT_DIR);
+
+    SizeIndex++;
+    le_event_QueueFunction(RunNextSize, NULL, NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register a change handler on each of the first stems of the tree, then commit one transaction
+ * that changes a node under each of them.  The time is taken once all of the handlers are called.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartFanOut
+(
+    size_t nodeCount
+)
+{
+    size_t groupCount = (nodeCount + GROUP_SIZE - 1) / GROUP_SIZE;
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    HandlerCount = (groupCount < HANDLER_COUNT) ? groupCount : HANDLER_COUNT;
+    CallCount = 0;
+
+    for (size_t i = 0; i < HandlerCount; i++)
+    {
+        snprintf(path, sizeof(path), TEST_ROOT_DIR "/g%zu", i);
+        HandlerRefs[i] = le_cfg_AddChangeHandler(path, FanOutHandler, NULL);
+    }
+
+    FanOutStart = le_clk_GetRelativeTime();
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TEST_ROOT_DIR);
+
+    for (size_t i = 0; i < HandlerCount; i++)
+    {
+        snprintf(path, sizeof(path), "g%zu/n0", i);
+        le_cfg_SetInt(iterRef, path, -1);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the benchmark for the next tree size.  The fan-out measurement needs the event loop to
+ * deliver the change notifications, so each size is run from the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunNextSize
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    if (SizeIndex >= SizeCount)
+    {
+        LE_INFO("---------- configTree benchmark complete ----------");
+        exit(EXIT_SUCCESS);
+    }
+
+    size_t nodeCount = Sizes[SizeIndex];
+
+    BuildTree(nodeCount);
+    TransactionLatency(nodeCount);
+    LargeCommit(nodeCount);
+    IterationThroughput();
+    StartFanOut(nodeCount);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    size_t argCount = le_arg_NumArgs();
+
+    if (argCount > 0)
+    {
+        LE_FATAL_IF(argCount > MAX_SIZES, "At most %d tree sizes can be given.", MAX_SIZES);
+
+        for (size_t i = 0; i < argCount; i++)
+        {
+            const char* argPtr = le_arg_GetArg(i);
+            char* endPtr = NULL;
+            long size = strtol(argPtr, &endPtr, 10);
+
+            LE_FATAL_IF((*endPtr != '\0') || (size <= 0), "Bad node count '%s'.", argPtr);
+            Sizes[i] = (size_t)size;
+        }
+
+        SizeCount = argCount;
+    }
+
+    LE_INFO("---------- configTree benchmark started ----------");
+    printf("%8s  %-32s %14s\n", "nodes", "measurement", "value");
+
+    le_event_QueueFunction(RunNextSize, NULL, NULL);
+}
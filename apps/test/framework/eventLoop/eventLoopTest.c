@@ -14,6 +14,15 @@ static le_event_Id_t EventIdC;
 
 static char EventContextA[] = "Context A";
 
+// Number of threads that queue functions to the main thread at the same time, and the number of
+// functions each of them queues.
+#define NUM_PRODUCER_THREADS 4
+#define NUM_QUEUED_PER_PRODUCER 10000
+
+static le_thread_Ref_t MainThread;
+static uint32_t NextSeqNum[NUM_PRODUCER_THREADS];
+static uint32_t NumQueuedCalled = 0;
+
 typedef struct
 {
     char str[10];
@@ -82,6 +91,44 @@ static void Destructor
 }
 
 
+static void ProducerFunc
+(
+    void* param1Ptr,    // Producer thread number.
+    void* param2Ptr     // Sequence number.
+)
+{
+    uintptr_t producer = (uintptr_t)param1Ptr;
+    uintptr_t seqNum = (uintptr_t)param2Ptr;
+
+    // Each thread's functions must be called in the order they were queued.
+    LE_ASSERT(NextSeqNum[producer] == seqNum);
+    NextSeqNum[producer]++;
+
+    NumQueuedCalled++;
+    if (NumQueuedCalled == (NUM_PRODUCER_THREADS * NUM_QUEUED_PER_PRODUCER))
+    {
+        LE_INFO("======== EVENT LOOP TEST COMPLETE (PASSED) ========");
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+static void* ProducerThreadMain
+(
+    void* contextPtr    // Producer thread number.
+)
+{
+    uintptr_t seqNum;
+
+    for (seqNum = 0; seqNum < NUM_QUEUED_PER_PRODUCER; seqNum++)
+    {
+        le_event_QueueFunctionToThread(MainThread, ProducerFunc, contextPtr, (void*)seqNum);
+    }
+
+    return NULL;
+}
+
+
 static void CheckTestResults
 (
     void* param1Ptr,
@@ -95,8 +142,15 @@ static void CheckTestResults
     LE_ASSERT(TestBPassed);
     LE_ASSERT(TestCPassed);
 
-    LE_INFO("======== EVENT LOOP TEST COMPLETE (PASSED) ========");
-    exit(EXIT_SUCCESS);
+    // Now flood the main thread with queued functions from several threads at once.
+    uintptr_t i;
+    MainThread = le_thread_GetCurrent();
+    for (i = 0; i < NUM_PRODUCER_THREADS; i++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "Producer%" PRIuPTR, i);
+        le_thread_Start(le_thread_Create(name, ProducerThreadMain, (void*)i));
+    }
 }
 
 
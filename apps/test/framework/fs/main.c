@@ -336,6 +336,56 @@ facilisis erat, a imperdiet risus eleifend nec.";
     LE_ASSERT(LE_BAD_PARAMETER == le_fs_Delete(wrongFilePath));
     LE_ASSERT(LE_BAD_PARAMETER == le_fs_Move(loremFilePath, loremFilePath));
 
+    // Buffered writes only reach the file when the buffer fills up or is flushed.
+    const char bufFilePath[PATH_LENGTH] = "/foo/buffered/records.bin";
+    const uint8_t record[SHORT_DATA_LENGTH] = "0123456789";
+    int i;
+    printf("Test buffered writes in file '%s'\n", bufFilePath);
+    LE_ASSERT_OK(le_fs_Open(bufFilePath, LE_FS_CREAT | LE_FS_RDWR | LE_FS_TRUNC, &fileRef));
+    LE_ASSERT(LE_BAD_PARAMETER == le_fs_SetWriteBuffer(fileRef, LE_FS_WRITE_BUFFER_MAX_SIZE + 1,
+                                                       LE_FS_SYNC_NEVER));
+    LE_ASSERT_OK(le_fs_SetWriteBuffer(fileRef, 1000, LE_FS_SYNC_ON_CLOSE));
+    for (i = 0; i < 6; i++)
+    {
+        LE_ASSERT_OK(le_fs_Write(fileRef, record, SHORT_DATA_LENGTH));
+    }
+    LE_ASSERT_OK(le_fs_GetSize(bufFilePath, &fileSize));
+    LE_ASSERT(0 == fileSize);
+    LE_ASSERT_OK(le_fs_Write(fileRef, record, SHORT_DATA_LENGTH));
+    LE_ASSERT_OK(le_fs_GetSize(bufFilePath, &fileSize));
+    LE_ASSERT((6 * SHORT_DATA_LENGTH) == fileSize);
+    LE_ASSERT_OK(le_fs_Flush(fileRef));
+    LE_ASSERT_OK(le_fs_GetSize(bufFilePath, &fileSize));
+    LE_ASSERT((7 * SHORT_DATA_LENGTH) == fileSize);
+
+    // Writes bigger than the buffer go straight to the file, after what was buffered.
+    LE_ASSERT_OK(le_fs_Write(fileRef, record, 10));
+    LE_ASSERT_OK(le_fs_Write(fileRef, loremIpsum, 1000));
+    LE_ASSERT_OK(le_fs_GetSize(bufFilePath, &fileSize));
+    LE_ASSERT((7 * SHORT_DATA_LENGTH + 1010) == fileSize);
+
+    // Seeking and reading see the buffered data.
+    LE_ASSERT_OK(le_fs_Write(fileRef, record, 5));
+    LE_ASSERT_OK(le_fs_Seek(fileRef, 7 * SHORT_DATA_LENGTH, LE_FS_SEEK_SET, &currentOffset));
+    readLength = 10;
+    LE_ASSERT_OK(le_fs_Read(fileRef, readLoremIpsum, &readLength));
+    LE_ASSERT((10 == readLength) && (0 == memcmp(readLoremIpsum, record, 10)));
+    LE_ASSERT_OK(le_fs_Seek(fileRef, 0, LE_FS_SEEK_END, &currentOffset));
+    LE_ASSERT((7 * SHORT_DATA_LENGTH + 1015) == currentOffset);
+    LE_ASSERT_OK(le_fs_Write(fileRef, record, 3));
+    LE_ASSERT_OK(le_fs_Close(fileRef));
+    LE_ASSERT_OK(le_fs_GetSize(bufFilePath, &fileSize));
+    LE_ASSERT((7 * SHORT_DATA_LENGTH + 1018) == fileSize);
+
+    // Files in a moved directory are found at its new location.
+    const char movedFilePath[PATH_LENGTH] = "/foo/moved/records.bin";
+    LE_ASSERT_OK(le_fs_Move("/foo/buffered", "/foo/moved"));
+    LE_ASSERT(LE_NOT_FOUND == le_fs_Open(bufFilePath, LE_FS_RDONLY, &fileRef));
+    LE_ASSERT_OK(le_fs_Open(movedFilePath, LE_FS_RDONLY, &fileRef));
+    LE_ASSERT_OK(le_fs_Close(fileRef));
+    LE_ASSERT_OK(le_fs_RemoveDirRecursive("/foo/moved"));
+    LE_ASSERT(LE_NOT_FOUND == le_fs_Open(movedFilePath, LE_FS_RDONLY, &fileRef));
+
     printf("Successful FS test\n");
     exit(EXIT_SUCCESS);
 }
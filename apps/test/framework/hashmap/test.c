@@ -21,6 +21,7 @@ size_t le_hashmap_HashCustom(const void* keyPtr);
 bool le_hashmap_EqualsCustom(const void* firstPtr, const void* secondPtr);
 bool itHandler(const void* keyPtr, const void* valuePtr, void* contextPtr);
 void TestIterRemove(le_hashmap_Ref_t map);
+void TestGrowMap(le_hashmap_Ref_t map);
 
 typedef struct Key Key_t;
 struct Key {
@@ -55,7 +56,16 @@ COMPONENT_INIT
     LE_INFO("Creating long int/long int map");
     le_hashmap_Ref_t map6 = le_hashmap_Create("Map6", 200, &le_hashmap_HashUInt64, &le_hashmap_EqualsUInt64);
 
-    LE_TEST(map1 && map2 && map3 && map4 && map5 && map6);
+    LE_INFO("Creating growing map");
+    le_hashmap_Ref_t map7 = le_hashmap_Create("Map7", 4, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+
+    LE_INFO("Creating flat int/int map");
+    le_hashmap_Ref_t map8 = le_hashmap_CreateFlat("Map8", 4, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+
+    LE_INFO("Creating flat pointer map");
+    le_hashmap_Ref_t map9 = le_hashmap_CreateFlat("Map9", 100, &le_hashmap_HashVoidPointer, &le_hashmap_EqualsVoidPointer);
+
+    LE_TEST(map1 && map2 && map3 && map4 && map5 && map6 && map7 && map8 && map9);
 
     TestHashFns();
     TestIntHashMap(map1);
@@ -66,6 +76,10 @@ COMPONENT_INIT
     TestLongIntHashMap(map6);
     TestNewIter();
     TestIterRemove(map1);
+    TestGrowMap(map7);
+    TestGrowMap(map8);
+    TestIterRemove(map8);
+    TestPointerMap(map9);
 
     LE_INFO("==== Hashmap Tests PASSED ====\n");
 
@@ -135,7 +149,8 @@ void TestIntHashMap(le_hashmap_Ref_t map)
         le_hashmap_GetValue(mapIt);
     }
     LE_INFO("Iterator count = %d", itercnt);
-    LE_TEST(itercnt == -1);
+    // Stepping back from the end visits every entry again, starting with the last one.
+    LE_TEST(itercnt == 0);
 
     // Cleanup the map again to allow it to be reused
     le_hashmap_RemoveAll(map);
@@ -528,3 +543,92 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     mapIt = le_hashmap_GetIterator(map);
     LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
 }
+
+void TestGrowMap(le_hashmap_Ref_t map)
+{
+    static uint32_t iKeys[5000];
+    static uint32_t iVals[5000];
+    int j = 0;
+    int itercnt = 0;
+    bool allFound = true;
+
+    LE_INFO("*** Running growing hashmap tests ***");
+
+    // Put far more keys than the map was created for, checking that every key put so far can
+    // still be found while the map is growing.
+    for (j=0; j<5000; j++) {
+        iKeys[j] = j * 3;
+        iVals[j] = j * 5;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+
+        if ((j % 97) == 0)
+        {
+            int k;
+            for (k=0; k<=j; k++)
+            {
+                uint32_t* valuePtr = le_hashmap_Get(map, &iKeys[k]);
+                if ((valuePtr == NULL) || (*valuePtr != iVals[k]))
+                {
+                    allFound = false;
+                }
+            }
+        }
+    }
+    LE_TEST(allFound);
+    LE_TEST(le_hashmap_Size(map) == 5000);
+
+    // Replacing a value must not add a second entry, wherever the old one is.
+    uint32_t newVal = 1;
+    LE_TEST(le_hashmap_Put(map, &iKeys[10], &newVal) == &iVals[10]);
+    LE_TEST(le_hashmap_Size(map) == 5000);
+    LE_TEST(le_hashmap_Put(map, &iKeys[10], &iVals[10]) == &newVal);
+
+    // Every key must be seen exactly once by the iterator, even with lookups part way through.
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        const uint32_t* keyPtr = le_hashmap_GetKey(mapIt);
+        LE_ASSERT(NULL != keyPtr);
+        LE_ASSERT(le_hashmap_ContainsKey(map, keyPtr));
+        itercnt++;
+    }
+    LE_INFO("Iterator count = %d", itercnt);
+    LE_TEST(itercnt == 5000);
+
+    // Remove every other key.
+    for (j=0; j<5000; j+=2) {
+        LE_ASSERT(le_hashmap_Remove(map, &iKeys[j]) == &iVals[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 2500);
+
+    allFound = true;
+    for (j=0; j<5000; j++) {
+        bool isPresent = le_hashmap_ContainsKey(map, &iKeys[j]);
+        if (isPresent != ((j % 2) == 1))
+        {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound);
+
+    // The map should have grown enough to keep collisions down.
+    LE_INFO("Collision count = %zu", le_hashmap_CountCollisions(map));
+    LE_TEST(le_hashmap_CountCollisions(map) < 2500);
+
+    // Walk the map using the node functions.
+    void* keyPtr = NULL;
+    void* valuePtr = NULL;
+    itercnt = 0;
+    le_result_t result = le_hashmap_GetFirstNode(map, &keyPtr, &valuePtr);
+    while (result == LE_OK)
+    {
+        itercnt++;
+        result = le_hashmap_GetNodeAfter(map, keyPtr, &keyPtr, &valuePtr);
+    }
+    LE_TEST(result == LE_NOT_FOUND);
+    LE_TEST(itercnt == 2500);
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+    LE_TEST(le_hashmap_Get(map, &iKeys[1]) == NULL);
+}
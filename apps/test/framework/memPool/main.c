@@ -31,6 +31,11 @@ colourObj_t;
 #define FORCE_SIZE          3
 #define NUM_EXPAND_SUB_POOL 2
 #define NUM_ALLOC_SUPER_POOL    1
+#define NUM_THREADS         4
+#define NUM_OBJS_PER_THREAD 20
+#define NUM_THREAD_LOOPS    1000
+#define NUM_COMPACT_CHUNKS  8
+#define COMPACT_CHUNK_SIZE  4
 
 static unsigned int NumRelease = 0;
 static unsigned int ReleaseId;
@@ -46,6 +51,36 @@ static void IdDestructor(void* objPtr)
 }
 
 
+static le_mem_PoolRef_t ThreadPool;
+
+static void* AllocReleaseThread(void* contextPtr)
+{
+    idObj_t* objsPtr[NUM_OBJS_PER_THREAD];
+    unsigned int i, j;
+
+    // The pool holds exactly enough objects for every thread to have all of its objects allocated
+    // at once, so no allocation can fail even if other threads' caches hold free blocks.
+    for (i = 0; i < NUM_THREAD_LOOPS; i++)
+    {
+        for (j = 0; j < NUM_OBJS_PER_THREAD; j++)
+        {
+            objsPtr[j] = le_mem_AssertAlloc(ThreadPool);
+            objsPtr[j]->id = j;
+        }
+
+        for (j = 0; j < NUM_OBJS_PER_THREAD; j++)
+        {
+            LE_ASSERT(objsPtr[j]->id == j);
+            le_mem_AddRef(objsPtr[j]);
+            le_mem_Release(objsPtr[j]);
+            le_mem_Release(objsPtr[j]);
+        }
+    }
+
+    return NULL;
+}
+
+
 COMPONENT_INIT
 {
     le_mem_PoolRef_t idPool, colourPool;
@@ -511,6 +546,156 @@ COMPONENT_INIT
 
     printf("Successfully recreated sub-pool.\n");
 
+    //
+    // Allocate and release from multiple threads at once.
+    //
+    le_thread_Ref_t threads[NUM_THREADS];
+
+    ThreadPool = le_mem_ExpandPool(le_mem_CreatePool("Thread Pool", sizeof(idObj_t)),
+                                   NUM_THREADS * NUM_OBJS_PER_THREAD);
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        threads[i] = le_thread_Create("memTest", AllocReleaseThread, NULL);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+    }
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        le_thread_Join(threads[i], NULL);
+    }
+
+    le_mem_GetStats(ThreadPool, &stats);
+    if ( (le_mem_GetObjectCount(ThreadPool) != NUM_THREADS * NUM_OBJS_PER_THREAD) ||
+         (stats.numBlocksInUse != 0) ||
+         (stats.numFree != NUM_THREADS * NUM_OBJS_PER_THREAD) ||
+         (stats.numAllocs != NUM_THREADS * NUM_OBJS_PER_THREAD * NUM_THREAD_LOOPS) ||
+         (stats.numOverflows != 0) )
+    {
+        printf("Error allocating from multiple threads: %d", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Allocated from multiple threads correctly.\n");
+
+    //
+    // Allocate variable-size objects from a slab allocator.
+    //
+    le_mem_SlabRef_t slab = le_mem_CreateSlabAllocator("Slab", 100);
+    le_mem_ExpandSlabAllocator(slab, 10, 2);
+
+    if ( (le_mem_GetObjectSize(le_mem_GetSlabPool(slab, 1)) != 16) ||
+         (le_mem_GetObjectSize(le_mem_GetSlabPool(slab, 17)) != 32) ||
+         (le_mem_GetObjectSize(le_mem_GetSlabPool(slab, 64)) != 64) ||
+         (le_mem_GetObjectSize(le_mem_GetSlabPool(slab, 65)) != 100) ||
+         (le_mem_GetObjectCount(le_mem_GetSlabPool(slab, 16)) != 2) )
+    {
+        printf("Error in slab allocator size classes: %d", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    char* smallStrPtr = le_mem_SlabStrDup(slab, "small");
+    void* bigObjPtr = le_mem_AssertSlabAlloc(slab, 10);
+    void* hugeObjPtr = le_mem_ForceSlabAlloc(slab, 100);
+
+    le_mem_GetSlabStats(slab, &stats);
+    if ( (strcmp(smallStrPtr, "small") != 0) ||
+         (le_mem_TrySlabAlloc(slab, 16) != NULL) ||
+         (stats.numBlocksInUse != 3) ||
+         (stats.numAllocs != 3) ||
+         (stats.numOverflows != 1) ||
+         (stats.numFree != 0) )
+    {
+        printf("Error allocating from slab allocator: %d", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    le_mem_Release(smallStrPtr);
+    le_mem_Release(bigObjPtr);
+    le_mem_Release(hugeObjPtr);
+
+    le_mem_GetSlabStats(slab, &stats);
+    if ( (stats.numBlocksInUse != 0) || (stats.numFree != 3) )
+    {
+        printf("Error releasing to slab allocator: %d", __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Allocated from slab allocator correctly.\n");
+
+    //
+    // Give idle chunks back to the system.
+    //
+    {
+        idObj_t* objsPtr[NUM_COMPACT_CHUNKS * COMPACT_CHUNK_SIZE];
+        le_mem_PoolRef_t compactPool = le_mem_CreatePool("Compact Pool", sizeof(idObj_t));
+
+        le_mem_ExpandPool(compactPool, COMPACT_CHUNK_SIZE);
+        le_mem_ExpandPool(compactPool, COMPACT_CHUNK_SIZE);
+
+        // One chunk is idle, the other has an object in use.
+        objsPtr[0] = le_mem_AssertAlloc(compactPool);
+
+        if ( (le_mem_Compact(compactPool) != COMPACT_CHUNK_SIZE) ||
+             (le_mem_GetObjectCount(compactPool) != COMPACT_CHUNK_SIZE) )
+        {
+            printf("Error compacting pool: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        le_mem_Release(objsPtr[0]);
+
+        if ( (le_mem_Compact(compactPool) != COMPACT_CHUNK_SIZE) ||
+             (le_mem_GetObjectCount(compactPool) != 0) )
+        {
+            printf("Error compacting pool: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        // Idle chunks are released as objects are released, once there are enough free objects.
+        for (i = 0; i < NUM_COMPACT_CHUNKS; i++)
+        {
+            le_mem_ExpandPool(compactPool, COMPACT_CHUNK_SIZE);
+        }
+
+        for (i = 0; i < NUM_COMPACT_CHUNKS * COMPACT_CHUNK_SIZE; i++)
+        {
+            objsPtr[i] = le_mem_AssertAlloc(compactPool);
+        }
+
+        le_mem_SetMaxIdleBlocks(compactPool, COMPACT_CHUNK_SIZE);
+
+        for (i = 0; i < NUM_COMPACT_CHUNKS * COMPACT_CHUNK_SIZE; i++)
+        {
+            le_mem_Release(objsPtr[i]);
+        }
+
+        le_mem_GetStats(compactPool, &stats);
+        if ( (le_mem_GetObjectCount(compactPool) >= NUM_COMPACT_CHUNKS * COMPACT_CHUNK_SIZE) ||
+             (stats.numFree < COMPACT_CHUNK_SIZE) ||
+             (stats.numBlocksInUse != 0) )
+        {
+            printf("Error releasing idle chunks: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        le_mem_Compact(compactPool);
+
+        // A compacted pool can still grow.
+        objsPtr[0] = le_mem_ForceAlloc(compactPool);
+
+        if (le_mem_GetObjectCount(compactPool) != 1)
+        {
+            printf("Error expanding compacted pool: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        le_mem_Release(objsPtr[0]);
+    }
+
+    printf("Released idle memory correctly.\n");
+
     // FIXME: Find pool by name is currently suffering from issues
     // Failure is tracked by ticket LE-5909
 #if 0
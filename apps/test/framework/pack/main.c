@@ -120,6 +120,81 @@ static void TestString(void)
     CheckString("", 512, 12, true); // Empty
 }
 
+/** Arrays **/
+
+static void CheckUint16Array
+(
+    size_t arrayCount,          ///< Number of elements to pack
+    size_t arrayMaxCount,       ///< Max number of elements
+    size_t reportedBufferSz,    ///< Buffer size reported to pack
+    bool expectedRes            ///< Expected result
+)
+{
+    uint16_t array[BUFFER_SZ / 4];
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t elementBuffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    uint8_t* elementBufferPtr = elementBuffer;
+    size_t bufferSz = reportedBufferSz;
+    size_t elementBufferSz = reportedBufferSz;
+    size_t i;
+    bool elementRes;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(array); i++)
+    {
+        array[i] = (uint16_t)(0xA5A5 + (i * 257));
+    }
+
+    ResetBuffer(buffer, sizeof(buffer));
+    ResetBuffer(elementBuffer, sizeof(elementBuffer));
+
+    printf("array[%zd] - max[%zd] buffer[%zd]:\n", arrayCount, arrayMaxCount, reportedBufferSz);
+
+    // Pack in a single copy and element by element.  Both must give the same result.
+    LE_TEST(expectedRes == le_pack_PackUint16Array(&bufferPtr, &bufferSz, array,
+                                                   arrayCount, arrayMaxCount));
+    LE_PACK_PACKARRAY(&elementBufferPtr, &elementBufferSz, array, arrayCount, arrayMaxCount,
+                      le_pack_PackUint16, &elementRes);
+    LE_TEST(expectedRes == elementRes);
+    if (!expectedRes)
+    {
+        printf("   [passed]\n");
+        return;
+    }
+
+    LE_TEST((bufferPtr - buffer) == (elementBufferPtr - elementBuffer));
+    LE_TEST(bufferSz == elementBufferSz);
+    LE_TEST(0 == memcmp(buffer, elementBuffer, sizeof(buffer)));
+    LE_TEST(bufferPtr[0] == CHECK_CHAR);
+
+    // Unpack
+    uint16_t arrayOut[BUFFER_SZ / 4];
+    size_t arrayOutCount = 0;
+    bufferPtr = buffer;
+    bufferSz = reportedBufferSz;
+    LE_TEST(le_pack_UnpackUint16Array(&bufferPtr, &bufferSz, arrayOut,
+                                      &arrayOutCount, arrayMaxCount));
+    LE_TEST(bufferSz == elementBufferSz);
+
+    // Output must be the same as input
+    LE_TEST(arrayOutCount == arrayCount);
+    LE_TEST(0 == memcmp(array, arrayOut, arrayCount * sizeof(array[0])));
+
+    printf("   [passed]\n");
+}
+
+static void TestArray(void)
+{
+    printf("=> array\n");
+
+    CheckUint16Array(10, 20, 512, true);
+    CheckUint16Array(0, 20, 512, true);  // Empty
+    CheckUint16Array(20, 20, 512, true); // Full
+    CheckUint16Array(21, 20, 512, false); // Too many elements
+    CheckUint16Array(10, 254, 512, true);
+    CheckUint16Array(10, 255, 512, false); // Buffer too short for max elements
+}
+
 COMPONENT_INIT
 {
     printf("======== le_pack Test Started ========\n");
@@ -129,6 +204,7 @@ COMPONENT_INIT
 
     TestUint8();
     TestString();
+    TestArray();
 
     printf("======== le_pack Test Complete ========\n");
     printf("\n");
@@ -700,6 +700,69 @@ static void TestUnixStyleAppends(void)
 }
 
 
+static void TestPathView(void)
+{
+    LE_INFO("======== Test Path Views.");
+
+    const char* nodePtr;
+    size_t nodeSize;
+
+    {
+        le_pathIter_View_t view;
+        le_pathIter_InitView(&view, "/a//path/../to/", "/");
+        LE_TEST(le_pathIter_ViewIsAbsolute(&view) == true);
+
+        static const char* nodes[] = { "a", "path", "..", "to" };
+
+        for (size_t i = 0; i < NUM_ARRAY_MEMBERS(nodes); i++)
+        {
+            LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK);
+            LE_TEST(   (nodeSize == strlen(nodes[i]))
+                    && (strncmp(nodePtr, nodes[i], nodeSize) == 0));
+        }
+
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+    }
+
+    {
+        le_pathIter_View_t view;
+        le_pathIter_InitView(&view, "some::::path", "::");
+        LE_TEST(le_pathIter_ViewIsAbsolute(&view) == false);
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK);
+        LE_TEST((nodeSize == 4) && (strncmp(nodePtr, "some", nodeSize) == 0));
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK);
+        LE_TEST((nodeSize == 4) && (strncmp(nodePtr, "path", nodeSize) == 0));
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+    }
+
+    {
+        le_pathIter_View_t view;
+        le_pathIter_InitView(&view, "/", "/");
+        LE_TEST(le_pathIter_ViewIsAbsolute(&view) == true);
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+
+        le_pathIter_InitView(&view, "", "/");
+        LE_TEST(le_pathIter_ViewIsAbsolute(&view) == false);
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+    }
+
+    {
+        le_pathIter_Ref_t iteratorRef = le_pathIter_CreateForUnix("/a/b/../c");
+        le_pathIter_View_t view;
+
+        le_pathIter_GetView(iteratorRef, &view);
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK);
+        LE_TEST((nodeSize == 1) && (nodePtr[0] == 'a'));
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK);
+        LE_TEST((nodeSize == 1) && (nodePtr[0] == 'c'));
+        LE_TEST(le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_NOT_FOUND);
+
+        le_pathIter_Delete(iteratorRef);
+    }
+}
+
+
 COMPONENT_INIT
 {
     LE_TEST_INIT;
@@ -715,6 +778,7 @@ COMPONENT_INIT
     LE_INFO("======== Begin Path Iterator API Test ========");
     TestUnixStyleIterator();
     TestUnixStyleAppends();
+    TestPathView();
 
 
     LE_INFO("======== Path API Test Complete ========");
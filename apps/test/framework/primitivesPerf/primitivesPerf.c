@@ -0,0 +1,746 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performance benchmark for the framework primitives every daemon depends on.  Measures:
+ *
+ *  - the throughput of le_event_QueueFunctionToThread() from one thread to another,
+ *  - the latency of dispatching an fd event handler in another thread,
+ *  - the cost of le_timer_Start() followed by le_timer_Stop() with 10, 1000 and 10000 other
+ *    timers running,
+ *  - the throughput of le_mem_TryAlloc() and le_mem_Release() on one pool shared by 1 to 4
+ *    threads,
+ *  - the cost of le_hashmap_Put() and le_hashmap_Get() at various load factors, for both the
+ *    chained and the flat maps.  The load factor is the number of keys over the capacity the map
+ *    was created with, so above 1 the cost of growing the map is included,
+ *  - the cost of le_ref_Lookup() in maps of various sizes,
+ *  - the cost of le_utf8_NumChars(), le_utf8_IsFormatCorrect() and le_utf8_Copy() on ASCII and
+ *    mixed strings of various lengths, next to a byte-at-a-time character count for comparison,
+ *  - the cost of reading each kind of clock, both with clock_gettime() and through the le_clk
+ *    functions, and of le_clk_GetDispatchTime() within a handler.
+ *
+ * Usage:
+ *
+ *      primitivesPerf
+ *
+ * The results are printed to stdout, one line per measurement.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+
+/// Number of functions queued to the other thread.
+#define QUEUE_LOOPS 100000
+
+/// Number of fd events dispatched.
+#define FD_LOOPS 10000
+
+/// Number of timer start/stop pairs.
+#define TIMER_LOOPS 10000
+
+/// Number of allocations per thread.
+#define MEM_LOOPS 1000000
+
+/// Largest number of threads sharing a pool.
+#define MAX_MEM_THREADS 4
+
+/// Capacity the hash maps are created with.
+#define HASHMAP_CAPACITY 1024
+
+/// Largest number of keys put in a hash map.
+#define MAX_HASHMAP_KEYS (HASHMAP_CAPACITY * 4)
+
+/// Number of hash map and safe reference lookups.
+#define LOOKUP_LOOPS 1000000
+
+/// Largest number of safe references in a map.
+#define MAX_REFS 10000
+
+
+
+/// Thread whose event loop runs the queued functions and fd event handlers.
+static le_thread_Ref_t WorkerThreadRef;
+
+/// Posted by the worker thread, when it is ready and when it is done with a measurement.
+static le_sem_Ref_t WorkerSemRef;
+
+/// Number of queued functions run by the worker thread.
+static size_t QueuedCount;
+
+/// Pipe the fd events are sent through.
+static int PipeFds[2];
+
+/// Pool shared by the allocating threads.
+static le_mem_PoolRef_t SharedPool;
+
+/// Keys put in the hash maps.
+static uint32_t HashmapKeys[MAX_HASHMAP_KEYS];
+
+/// Objects the safe references point to.
+static char RefObjects[MAX_REFS];
+static void* Refs[MAX_REFS];
+
+/// Number of UTF-8 string operations.
+#define UTF8_LOOPS 100000
+
+/// Longest UTF-8 string measured.
+#define MAX_UTF8_BYTES 4096
+
+/// Strings the UTF-8 operations work on, and where le_utf8_Copy() copies them.
+static char Utf8Str[MAX_UTF8_BYTES + 1];
+static char Utf8Dest[MAX_UTF8_BYTES + 1];
+
+/// Number of clock reads.
+#define CLOCK_LOOPS 1000000
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedNsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return ((double)elapsed.sec * 1000000000.0) + ((double)elapsed.usec * 1000.0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Report
+(
+    const char* namePtr,
+    double value,
+    const char* unitPtr
+)
+{
+    printf("%-48s %14.1f %s\n", namePtr, value, unitPtr);
+    fflush(stdout);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function queued to the worker thread.  The last one wakes up the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueuedFunction
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    if (++QueuedCount == QUEUE_LOOPS)
+    {
+        le_sem_Post(WorkerSemRef);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the fd events in the worker thread.  Wakes up the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PipeHandler
+(
+    int fd,
+    short events
+)
+{
+    char byte;
+
+    LE_ASSERT(read(fd, &byte, 1) == 1);
+    le_sem_Post(WorkerSemRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* contextPtr
+)
+{
+    le_fdMonitor_Create("PerfPipe", PipeFds[0], PipeHandler, POLLIN);
+    le_sem_Post(WorkerSemRef);
+
+    le_event_RunLoop();
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of queuing functions to another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureQueueFunction
+(
+    void
+)
+{
+    size_t i;
+
+    QueuedCount = 0;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < QUEUE_LOOPS; i++)
+    {
+        le_event_QueueFunctionToThread(WorkerThreadRef, QueuedFunction, NULL, NULL);
+    }
+
+    le_sem_Wait(WorkerSemRef);
+
+    Report("queue function to thread", (QUEUE_LOOPS * 1000000000.0) / ElapsedNsec(start), "/s");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the latency of dispatching an fd event handler in another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureFdDispatch
+(
+    void
+)
+{
+    size_t i;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < FD_LOOPS; i++)
+    {
+        LE_ASSERT(write(PipeFds[1], "x", 1) == 1);
+        le_sem_Wait(WorkerSemRef);
+    }
+
+    Report("fd handler dispatch (round trip)", ElapsedNsec(start) / FD_LOOPS, "ns");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of starting and stopping a timer while other timers are running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureTimers
+(
+    size_t runningCount
+)
+{
+    le_timer_Ref_t* timerRefs = calloc(runningCount, sizeof(le_timer_Ref_t));
+    char name[64];
+    size_t i;
+
+    LE_ASSERT(timerRefs != NULL);
+
+    // The running timers expire at various times within the next hour, so the measured timer,
+    // which expires after them, goes through all of them.
+    for (i = 0; i < runningCount; i++)
+    {
+        timerRefs[i] = le_timer_Create("PerfTimer");
+        le_timer_SetMsInterval(timerRefs[i], 3600000 - (uint32_t)i);
+        le_timer_Start(timerRefs[i]);
+    }
+
+    le_timer_Ref_t timerRef = le_timer_Create("MeasuredTimer");
+    le_timer_SetMsInterval(timerRef, 7200000);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < TIMER_LOOPS; i++)
+    {
+        le_timer_Start(timerRef);
+        le_timer_Stop(timerRef);
+    }
+
+    snprintf(name, sizeof(name), "timer start + stop (%zu running)", runningCount);
+    Report(name, ElapsedNsec(start) / TIMER_LOOPS, "ns");
+
+    le_timer_Delete(timerRef);
+
+    for (i = 0; i < runningCount; i++)
+    {
+        le_timer_Delete(timerRefs[i]);
+    }
+
+    free(timerRefs);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the allocating threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocMain
+(
+    void* contextPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < MEM_LOOPS; i++)
+    {
+        void* objPtr = le_mem_TryAlloc(SharedPool);
+
+        LE_ASSERT(objPtr != NULL);
+        le_mem_Release(objPtr);
+    }
+
+    return NULL;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of allocating from and releasing to a pool shared by several threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureMemPool
+(
+    size_t threadCount
+)
+{
+    le_thread_Ref_t threadRefs[MAX_MEM_THREADS];
+    char name[64];
+    size_t i;
+
+    for (i = 0; i < threadCount; i++)
+    {
+        threadRefs[i] = le_thread_Create("PerfAlloc", AllocMain, NULL);
+        le_thread_SetJoinable(threadRefs[i]);
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < threadCount; i++)
+    {
+        le_thread_Start(threadRefs[i]);
+    }
+
+    for (i = 0; i < threadCount; i++)
+    {
+        le_thread_Join(threadRefs[i], NULL);
+    }
+
+    snprintf(name, sizeof(name), "mem alloc + release (%zu threads)", threadCount);
+    Report(name, (threadCount * MEM_LOOPS * 1000000000.0) / ElapsedNsec(start), "/s");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of putting keys in a hash map and getting them back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureHashmap
+(
+    bool isFlat,
+    size_t keyCount
+)
+{
+    const char* kindPtr = isFlat ? "flat hashmap" : "hashmap";
+    double loadFactor = (double)keyCount / HASHMAP_CAPACITY;
+    char name[64];
+    size_t i;
+
+    le_hashmap_Ref_t mapRef = isFlat ?
+        le_hashmap_CreateFlat("PerfMap", HASHMAP_CAPACITY,
+                              le_hashmap_HashUInt32, le_hashmap_EqualsUInt32) :
+        le_hashmap_Create("PerfMap", HASHMAP_CAPACITY,
+                          le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < keyCount; i++)
+    {
+        le_hashmap_Put(mapRef, &HashmapKeys[i], &HashmapKeys[i]);
+    }
+
+    snprintf(name, sizeof(name), "%s put (load factor %.2f)", kindPtr, loadFactor);
+    Report(name, ElapsedNsec(start) / keyCount, "ns");
+
+    start = le_clk_GetRelativeTime();
+
+    // Get the keys in an order that is not the insertion order.
+    for (i = 0; i < LOOKUP_LOOPS; i++)
+    {
+        uint32_t key = (uint32_t)((i * 7919) % keyCount);
+
+        LE_ASSERT(le_hashmap_Get(mapRef, &key) != NULL);
+    }
+
+    snprintf(name, sizeof(name), "%s get (load factor %.2f)", kindPtr, loadFactor);
+    Report(name, ElapsedNsec(start) / LOOKUP_LOOPS, "ns");
+
+    le_hashmap_RemoveAll(mapRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of looking up safe references.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureSafeRef
+(
+    size_t refCount
+)
+{
+    le_ref_MapRef_t mapRef = le_ref_CreateMap("PerfRefs", refCount);
+    char name[64];
+    size_t i;
+
+    for (i = 0; i < refCount; i++)
+    {
+        Refs[i] = le_ref_CreateRef(mapRef, &RefObjects[i]);
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < LOOKUP_LOOPS; i++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef, Refs[(i * 7919) % refCount]) != NULL);
+    }
+
+    snprintf(name, sizeof(name), "safe ref lookup (%zu refs)", refCount);
+    Report(name, ElapsedNsec(start) / LOOKUP_LOOPS, "ns");
+
+    for (i = 0; i < refCount; i++)
+    {
+        le_ref_DeleteRef(mapRef, Refs[i]);
+    }
+}
+
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the characters in a UTF-8 string one byte at a time, the way le_utf8_NumChars() used to.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ByteAtATimeNumChars
+(
+    const char* string
+)
+{
+    size_t strIndex = 0;
+    size_t numChars = 0;
+
+    while (string[strIndex] != '\0')
+    {
+        size_t numBytes = le_utf8_NumBytesInChar(string[strIndex]);
+        size_t i;
+
+        if (numBytes == 0)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        for (i = 1; i < numBytes; i++)
+        {
+            if (!le_utf8_IsContinuationByte(string[++strIndex]))
+            {
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        numChars++;
+        strIndex++;
+    }
+
+    return numChars;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of the UTF-8 string operations on a string of a given length, either all ASCII
+ * or with a two-byte character every 16 bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureUtf8
+(
+    size_t numBytes,
+    bool isMixed
+)
+{
+    const char* kindPtr = isMixed ? "mixed" : "ascii";
+    char name[64];
+    size_t i;
+
+    memset(Utf8Str, 'a', numBytes);
+    Utf8Str[numBytes] = '\0';
+
+    if (isMixed)
+    {
+        for (i = 0; i + 2 <= numBytes; i += 16)
+        {
+            Utf8Str[i] = (char)0xC3;
+            Utf8Str[i + 1] = (char)0xA9;
+        }
+    }
+
+    ssize_t numChars = le_utf8_NumChars(Utf8Str);
+    LE_ASSERT(numChars == ByteAtATimeNumChars(Utf8Str));
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < UTF8_LOOPS; i++)
+    {
+        LE_ASSERT(ByteAtATimeNumChars(Utf8Str) == numChars);
+    }
+
+    snprintf(name, sizeof(name), "utf8 byte-at-a-time count (%zu %s)", numBytes, kindPtr);
+    Report(name, ElapsedNsec(start) / UTF8_LOOPS, "ns");
+
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < UTF8_LOOPS; i++)
+    {
+        LE_ASSERT(le_utf8_NumChars(Utf8Str) == numChars);
+    }
+
+    snprintf(name, sizeof(name), "le_utf8_NumChars (%zu %s)", numBytes, kindPtr);
+    Report(name, ElapsedNsec(start) / UTF8_LOOPS, "ns");
+
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < UTF8_LOOPS; i++)
+    {
+        LE_ASSERT(le_utf8_IsFormatCorrect(Utf8Str));
+    }
+
+    snprintf(name, sizeof(name), "le_utf8_IsFormatCorrect (%zu %s)", numBytes, kindPtr);
+    Report(name, ElapsedNsec(start) / UTF8_LOOPS, "ns");
+
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < UTF8_LOOPS; i++)
+    {
+        LE_ASSERT(le_utf8_Copy(Utf8Dest, Utf8Str, sizeof(Utf8Dest), NULL) == LE_OK);
+    }
+
+    snprintf(name, sizeof(name), "le_utf8_Copy (%zu %s)", numBytes, kindPtr);
+    Report(name, ElapsedNsec(start) / UTF8_LOOPS, "ns");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of reading a clock with clock_gettime().
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureClockGettime
+(
+    clockid_t clockId,
+    const char* clockNamePtr
+)
+{
+    struct timespec ts;
+    char name[64];
+    size_t i;
+
+    if (clock_gettime(clockId, &ts) != 0)
+    {
+        printf("%-48s %14s\n", clockNamePtr, "unsupported");
+        return;
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < CLOCK_LOOPS; i++)
+    {
+        clock_gettime(clockId, &ts);
+    }
+
+    snprintf(name, sizeof(name), "clock_gettime(%s)", clockNamePtr);
+    Report(name, ElapsedNsec(start) / CLOCK_LOOPS, "ns");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of a le_clk time function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureClkFunction
+(
+    le_clk_Time_t (*getTimeFunc)(void),
+    const char* namePtr
+)
+{
+    size_t i;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < CLOCK_LOOPS; i++)
+    {
+        getTimeFunc();
+    }
+
+    Report(namePtr, ElapsedNsec(start) / CLOCK_LOOPS, "ns");
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function queued to the worker thread, to measure le_clk_GetDispatchTime() within a handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureDispatchTime
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    MeasureClkFunction(le_clk_GetDispatchTime, "le_clk_GetDispatchTime (in handler)");
+    le_sem_Post(WorkerSemRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of reading the clocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureClocks
+(
+    void
+)
+{
+    MeasureClockGettime(CLOCK_REALTIME, "CLOCK_REALTIME");
+    MeasureClockGettime(CLOCK_MONOTONIC, "CLOCK_MONOTONIC");
+    MeasureClockGettime(CLOCK_MONOTONIC_COARSE, "CLOCK_MONOTONIC_COARSE");
+    MeasureClockGettime(CLOCK_MONOTONIC_RAW, "CLOCK_MONOTONIC_RAW");
+    MeasureClockGettime(CLOCK_BOOTTIME, "CLOCK_BOOTTIME");
+
+    MeasureClkFunction(le_clk_GetRelativeTime, "le_clk_GetRelativeTime");
+    MeasureClkFunction(le_clk_GetAbsoluteTime, "le_clk_GetAbsoluteTime");
+    MeasureClkFunction(le_clk_GetCoarseTime, "le_clk_GetCoarseTime");
+
+    le_event_QueueFunctionToThread(WorkerThreadRef, MeasureDispatchTime, NULL, NULL);
+    le_sem_Wait(WorkerSemRef);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    static const size_t timerCounts[] = { 10, 1000, 10000 };
+    static const size_t keyCounts[] = { HASHMAP_CAPACITY / 4, HASHMAP_CAPACITY / 2,
+                                        HASHMAP_CAPACITY, MAX_HASHMAP_KEYS };
+    static const size_t refCounts[] = { 100, 1000, MAX_REFS };
+    static const size_t utf8Lengths[] = { 16, 256, MAX_UTF8_BYTES };
+    size_t i;
+
+    printf("%-48s %14s\n", "measurement", "value");
+
+    // Event loop.
+    LE_ASSERT(pipe2(PipeFds, O_CLOEXEC) == 0);
+    WorkerSemRef = le_sem_Create("PerfWorker", 0);
+    WorkerThreadRef = le_thread_Create("PerfWorker", WorkerMain, NULL);
+    le_thread_Start(WorkerThreadRef);
+    le_sem_Wait(WorkerSemRef);
+
+    MeasureQueueFunction();
+    MeasureFdDispatch();
+
+    // Clocks.
+    MeasureClocks();
+
+    // Timers.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(timerCounts); i++)
+    {
+        MeasureTimers(timerCounts[i]);
+    }
+
+    // Memory pools.
+    SharedPool = le_mem_CreatePool("PerfShared", 64);
+    le_mem_ExpandPool(SharedPool, MAX_MEM_THREADS);
+
+    for (i = 1; i <= MAX_MEM_THREADS; i++)
+    {
+        MeasureMemPool(i);
+    }
+
+    // Hash maps.
+    for (i = 0; i < MAX_HASHMAP_KEYS; i++)
+    {
+        HashmapKeys[i] = (uint32_t)i;
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(keyCounts); i++)
+    {
+        MeasureHashmap(false, keyCounts[i]);
+        MeasureHashmap(true, keyCounts[i]);
+    }
+
+    // Safe references.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(refCounts); i++)
+    {
+        MeasureSafeRef(refCounts[i]);
+    }
+
+    // UTF-8 strings.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(utf8Lengths); i++)
+    {
+        MeasureUtf8(utf8Lengths[i], false);
+        MeasureUtf8(utf8Lengths[i], true);
+    }
+
+    exit(EXIT_SUCCESS);
+}
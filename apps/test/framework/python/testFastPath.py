@@ -0,0 +1,122 @@
+"""
+Check that the compiled _liblegato_fast path of liblegato.py gives the same results as the cffi
+fallback, for message packing, unpacking and event loop servicing.
+"""
+
+import sys
+import liblegato
+from liblegato import ffi, lib
+
+__copyright__ = 'Copyright (C) Sierra Wireless Inc.'
+
+FORMAT = 'bBhHiIqQ?dzrs16'
+VALUES = (-5, 250, -1234, 65000, -123456, 4000000000, -(1 << 40), (1 << 63) + 7,
+          True, 3.25, 0x12345678, 0x1000, b'hello')
+MAX_MSG_SIZE = 256
+
+Failures = 0
+
+def check(condition, what):
+    global Failures
+    if not condition:
+        print("FAIL: " + what)
+        Failures += 1
+
+def run(fast, function, *args):
+    """
+    Call a liblegato.py function with the fast path enabled or disabled.
+    """
+    saved = liblegato._fast
+    if not fast:
+        liblegato._fast = None
+    try:
+        return function(*args)
+    finally:
+        liblegato._fast = saved
+
+def run_error(fast, function, *args):
+    """
+    Call a liblegato.py function that is expected to fail, and return the exception type.
+    """
+    try:
+        run(fast, function, *args)
+    except Exception as e:
+        return type(e)
+    return None
+
+def payload(msgRef):
+    return bytes(liblegato._payload(msgRef)[:])
+
+def test_pack(sessionRef):
+    fastMsg = lib.le_msg_CreateMsg(sessionRef)
+    slowMsg = lib.le_msg_CreateMsg(sessionRef)
+
+    fastEnd = run(True, liblegato.le_msg_Pack, fastMsg, 0, FORMAT, *VALUES)
+    slowEnd = run(False, liblegato.le_msg_Pack, slowMsg, 0, FORMAT, *VALUES)
+    check(fastEnd == slowEnd, "pack offsets differ: %d != %d" % (fastEnd, slowEnd))
+    check(payload(fastMsg) == payload(slowMsg), "packed payloads differ")
+
+    # Each path must read back what either path wrote.
+    for msgRef in (fastMsg, slowMsg):
+        fastValues = run(True, liblegato.le_msg_Unpack, msgRef, 0, FORMAT)
+        slowValues = run(False, liblegato.le_msg_Unpack, msgRef, 0, FORMAT)
+        check(fastValues == slowValues, "unpacked values differ: %r != %r" %
+              (fastValues, slowValues))
+        check(fastValues == (VALUES, fastEnd), "unpacked values are wrong: %r" % (fastValues,))
+
+    # A null reference packs as zero on both paths.
+    fastEnd = run(True, liblegato.le_msg_Pack, fastMsg, 0, 'r', None)
+    slowEnd = run(False, liblegato.le_msg_Pack, slowMsg, 0, 'r', None)
+    check(fastEnd == slowEnd, "null reference offsets differ")
+    check(payload(fastMsg) == payload(slowMsg), "null reference payloads differ")
+
+    # Both paths must refuse a string longer than its maximum size.
+    fastError = run_error(True, liblegato.le_msg_Pack, fastMsg, 0, 's4', b'too long')
+    slowError = run_error(False, liblegato.le_msg_Pack, slowMsg, 0, 's4', b'too long')
+    check(fastError is OverflowError and slowError is OverflowError,
+          "oversized string errors: %r, %r" % (fastError, slowError))
+
+    lib.le_msg_ReleaseMsg(fastMsg)
+    lib.le_msg_ReleaseMsg(slowMsg)
+
+CalledCount = 0
+
+@ffi.callback('void(void*, void*)')
+def queued_function(param1Ptr, param2Ptr):
+    global CalledCount
+    CalledCount += 1
+
+def test_service_all():
+    global CalledCount
+    counts = []
+    for fast in (True, False):
+        CalledCount = 0
+        for i in range(3):
+            lib.le_event_QueueFunction(queued_function, ffi.NULL, ffi.NULL)
+        counts.append(run(fast, liblegato.le_event_ServiceAll))
+        check(CalledCount == 3, "fast=%s: %d queued functions run" % (fast, CalledCount))
+        check(run(fast, liblegato.le_event_ServiceAll) == 0,
+              "fast=%s: event loop not idle after servicing" % fast)
+    check(counts[0] == counts[1], "event loop serviced %d and %d times" % tuple(counts))
+
+def main():
+    if liblegato._fast is None:
+        print("FAIL: _liblegato_fast is not available")
+        return 1
+
+    protocolRef = lib.le_msg_GetProtocolRef(b'testFastPath', MAX_MSG_SIZE)
+    sessionRef = lib.le_msg_CreateSession(protocolRef, b'testFastPath')
+
+    test_pack(sessionRef)
+    test_service_all()
+
+    lib.le_msg_DeleteSession(sessionRef)
+
+    if Failures:
+        print("%d failures" % Failures)
+        return 1
+    print("Fast path and cffi fallback agree")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
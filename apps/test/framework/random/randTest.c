@@ -317,6 +317,41 @@ static bool TestLargeBuffer(void)
     return Chi2Test(buckets, numBuckets, numSamples);
 }
 
+// The parent and a forked child must not get the same random numbers.
+static bool TestFork(void)
+{
+    uint8_t parentBuf[16];
+    uint8_t childBuf[16];
+    int fds[2];
+
+    LE_INFO("Test random numbers after fork");
+
+    // Make sure the calling thread's generator is seeded before the fork.
+    le_rand_GetBuffer(parentBuf, sizeof(parentBuf));
+
+    LE_ASSERT(pipe(fds) == 0);
+
+    pid_t pid = fork();
+    LE_ASSERT(pid >= 0);
+
+    if (pid == 0)
+    {
+        le_rand_GetBuffer(childBuf, sizeof(childBuf));
+        _exit(write(fds[1], childBuf, sizeof(childBuf)) == sizeof(childBuf) ?
+              EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    le_rand_GetBuffer(parentBuf, sizeof(parentBuf));
+
+    bool result = (read(fds[0], childBuf, sizeof(childBuf)) == sizeof(childBuf));
+
+    LE_ASSERT(waitpid(pid, NULL, 0) == pid);
+    close(fds[0]);
+    close(fds[1]);
+
+    return result && (memcmp(parentBuf, childBuf, sizeof(parentBuf)) != 0);
+}
+
 COMPONENT_INIT
 {
     LE_INFO("======== Begin Random Number Tests ========");
@@ -343,6 +378,7 @@ COMPONENT_INIT
     LE_TEST(TestSmallRange());
     LE_TEST(TestLargeRange());
     LE_TEST(TestSmallBuffer());
+    LE_TEST(TestFork());
 
     LE_INFO("======== Completed Random Number Tests (Passed) ========");
 
@@ -64,6 +64,56 @@ COMPONENT_INIT
     LE_ASSERT(le_ref_Lookup(mapRef1, &mapRef1) == NULL);
     LE_INFO("Looking up a pointer value failed, as expected");
 
+    LE_INFO("Checking that deleted references stay invalid after their slot is reused.");
+    le_ref_DeleteRef(mapRef1, safeRef1);
+    void* safeRef5 = le_ref_CreateRef(mapRef1, (void*)0x1005);
+    LE_ASSERT(safeRef5 != safeRef1);
+    LE_ASSERT(le_ref_Lookup(mapRef1, safeRef1) == NULL);
+    LE_ASSERT(le_ref_Lookup(mapRef1, safeRef5) == (void*)0x1005);
+
+    LE_INFO("Growing map %p past its expected size.", mapRef1);
+    static void* manyRefs[1000];
+    size_t i;
+    for (i = 0; i < 1000; i++)
+    {
+        manyRefs[i] = le_ref_CreateRef(mapRef1, (void*)(0x2000 + i));
+    }
+    for (i = 0; i < 1000; i++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef1, manyRefs[i]) == (void*)(0x2000 + i));
+    }
+    LE_ASSERT(le_ref_Lookup(mapRef1, safeRef2) == (void*)0x1002);
+
+    LE_INFO("Iterating over map %p, deleting as we go.", mapRef1);
+    size_t count = 0;
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(mapRef1);
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        void* safeRef = (void*)le_ref_GetSafeRef(iterRef);
+        LE_ASSERT(le_ref_Lookup(mapRef1, safeRef) == le_ref_GetValue(iterRef));
+        le_ref_DeleteRef(mapRef1, safeRef);
+        LE_ASSERT(le_ref_GetSafeRef(iterRef) == NULL);
+        count++;
+    }
+    LE_ASSERT(count == 1004);
+    LE_ASSERT(le_ref_Lookup(mapRef1, manyRefs[0]) == NULL);
+    LE_INFO("  Iterated over %zu references.", count);
+
+    LE_INFO("Checking that a deleted reference stays invalid after its slot is reused many times.");
+    le_ref_MapRef_t mapRef2 = le_ref_CreateMap("Map 2", 1);
+    void* staleRef = le_ref_CreateRef(mapRef2, (void*)0x3000);
+    le_ref_DeleteRef(mapRef2, staleRef);
+    for (i = 0; i < 100000; i++)
+    {
+        void* safeRef = le_ref_CreateRef(mapRef2, (void*)(0x3001 + i));
+        LE_ASSERT(safeRef != staleRef);
+        LE_ASSERT(le_ref_Lookup(mapRef2, staleRef) == NULL);
+        LE_ASSERT(le_ref_Lookup(mapRef2, safeRef) == (void*)(0x3001 + i));
+        le_ref_DeleteRef(mapRef2, safeRef);
+    }
+    LE_ASSERT((uintptr_t)staleRef <= UINT32_MAX);
+    LE_INFO("  Reused the slot %zu times.", i);
+
 
     LE_INFO("======== SAFE REFERENCES TEST COMPLETE (PASSED) ========");
     exit(EXIT_SUCCESS);
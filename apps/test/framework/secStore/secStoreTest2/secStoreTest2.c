@@ -258,6 +258,88 @@ static void Test6
     LE_INFO(" ");
 }
 
+// writing a counter with write-behind enabled
+// reading the deferred value back before and after flushing
+// delete a deferred file
+static void Test7
+(
+    void
+)
+{
+    LE_INFO("############################################################################################");
+    LE_INFO("#################### Test7 #################################################################");
+    LE_INFO("############################################################################################");
+
+    char outBuffer[1024] = {0};
+    size_t outBufferSize = sizeof(outBuffer);
+    le_result_t result;
+    int i;
+
+    le_secStore_SetWriteBehind(true);
+
+    LE_INFO("=======================   Update a counter file.   ==============================");
+    for (i = 0; i < 100; i++)
+    {
+        char counter[16];
+        snprintf(counter, sizeof(counter), "%d", i);
+
+        result = le_secStore_Write("counter", (uint8_t*)counter, strlen(counter) + 1);
+        LE_FATAL_IF(result != LE_OK, "write failed: [%s]", LE_RESULT_TXT(result));
+    }
+
+
+    LE_INFO("=======================   Read the deferred counter.   =================================");
+    result = le_secStore_Read("counter", (uint8_t*)outBuffer, &outBufferSize);
+    LE_FATAL_IF(result != LE_OK, "read failed: [%s]", LE_RESULT_TXT(result));
+
+    if (strcmp(outBuffer, "99") != 0)
+    {
+        LE_FATAL("Reading secStore item resulting in unexpected item contents: [%s]", outBuffer);
+    }
+
+
+    LE_INFO("=======================   Flush and read the counter.   =================================");
+    result = le_secStore_Flush();
+    LE_FATAL_IF(result != LE_OK, "flush failed: [%s]", LE_RESULT_TXT(result));
+
+    le_secStore_SetWriteBehind(false);
+
+    outBufferSize = sizeof(outBuffer);
+    result = le_secStore_Read("counter", (uint8_t*)outBuffer, &outBufferSize);
+    LE_FATAL_IF(result != LE_OK, "read failed: [%s]", LE_RESULT_TXT(result));
+
+    if (strcmp(outBuffer, "99") != 0)
+    {
+        LE_FATAL("Reading secStore item resulting in unexpected item contents: [%s]", outBuffer);
+    }
+    else
+    {
+        LE_INFO("secStore item read: [%s]", outBuffer);
+    }
+
+
+    LE_INFO("=======================   Delete a deferred file.   ====================================");
+    le_secStore_SetWriteBehind(true);
+
+    result = le_secStore_Write("file3", (uint8_t*)"string321", 10);
+    LE_FATAL_IF(result != LE_OK, "write failed: [%s]", LE_RESULT_TXT(result));
+
+    result = le_secStore_Delete("file3");
+    LE_FATAL_IF(result != LE_OK, "delete failed: [%s]", LE_RESULT_TXT(result));
+
+    le_secStore_SetWriteBehind(false);
+
+    outBufferSize = sizeof(outBuffer);
+    result = le_secStore_Read("file3", (uint8_t*)outBuffer, &outBufferSize);
+    LE_FATAL_IF(result != LE_NOT_FOUND, "read failed: [%s]", LE_RESULT_TXT(result));
+
+    result = le_secStore_Delete("counter");
+    LE_FATAL_IF(result != LE_OK, "delete failed: [%s]", LE_RESULT_TXT(result));
+
+    LE_INFO("#################### END OF Test7 #################################################################");
+    LE_INFO(" ");
+}
+
 
 COMPONENT_INIT
 {
@@ -271,6 +353,7 @@ COMPONENT_INIT
     Test4();
     Test5();
     Test6();
+    Test7();
 
     LE_INFO("============ SecStoreTest2 PASSED =============");
 
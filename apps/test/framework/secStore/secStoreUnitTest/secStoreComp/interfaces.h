@@ -35,6 +35,16 @@ le_msg_ServiceRef_t secStoreAdmin_GetServiceRef
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_secStore_GetServiceRef
+(
+    void
+);
+
 //--------------------------------------------------------------------------------------------------
 /*
  * FIXME: Declaring secStoreGlobal here since I can't seem to be able to include an api as another
@@ -96,4 +106,51 @@ le_result_t secStoreGlobal_Read
 le_result_t secStoreGlobal_Delete
 (
     const char* name    ///< [IN] Name of the secure storage item.
-);
\ No newline at end of file
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables or disables write-behind for the calling client.  Disabling write-behind flushes the
+ * pending writes of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreGlobal_SetWriteBehind
+(
+    bool enable         ///< [IN] true to defer the writes, false to write them through.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the pending deferred writes of the calling client to secure storage.
+ *
+ * @return
+ *      LE_OK if successful, or if there was nothing to flush.
+ *      LE_NO_MEMORY if there isn't enough memory to store an item. The item is dropped.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_Flush
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t secStoreGlobal_GetClientSessionRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t secStoreGlobal_GetServiceRef
+(
+    void
+);
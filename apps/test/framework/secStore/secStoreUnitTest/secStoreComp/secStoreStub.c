@@ -53,6 +53,45 @@ le_msg_SessionRef_t le_secStore_GetClientSessionRef
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_secStore_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub the client session reference for the current message for secStoreGlobal
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t secStoreGlobal_GetClientSessionRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t secStoreGlobal_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the user credentials of the client at the far end of a given IPC session.
@@ -265,3 +304,15 @@ void le_wdogChain_MonitorEventLoop
 )
 {
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick a watchdog on the chain.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wdogChain_Kick
+(
+    uint32_t watchdog
+)
+{
+}
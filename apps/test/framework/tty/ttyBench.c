@@ -0,0 +1,264 @@
+/*
+ * Serial port throughput and latency benchmark.
+ *
+ * The serial port must be looped back (TX wired to RX, and RTS to CTS for hardware flow control).
+ * The benchmark sends a counting pattern through the loop and checks what comes back, then times
+ * single byte round trips.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "fileDescriptor.h"
+#include <termios.h>
+
+/// Default number of bytes sent for the throughput test.
+#define DEFAULT_BENCH_BYTES     (1024 * 1024)
+
+/// Number of round trips timed for the latency test.
+#define LATENCY_ROUND_TRIPS     100
+
+/// Size of the reads and writes of the throughput test.
+#define BENCH_CHUNK_BYTES       4096
+
+/// Minimum number of bytes returned by a read (VMIN) of the throughput test.
+#define BENCH_READ_MIN_BYTES    64
+
+/// Inter-byte read timeout (VTIME) in tenths of a second, which ends the throughput test if
+/// bytes are lost.
+#define BENCH_READ_TIMEOUT      10
+
+static const char* DevTty;
+static int Fd = -1;
+static size_t BenchBytes = DEFAULT_BENCH_BYTES;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + now.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writer thread of the throughput test: sends the counting pattern.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr
+)
+{
+    uint8_t buffer[BENCH_CHUNK_BYTES];
+    size_t sent = 0;
+
+    while (sent < BenchBytes)
+    {
+        size_t len = BenchBytes - sent;
+        size_t i;
+
+        if (len > sizeof(buffer))
+        {
+            len = sizeof(buffer);
+        }
+
+        for (i = 0; i < len; i++)
+        {
+            buffer[i] = (uint8_t)(sent + i);
+        }
+
+        LE_ASSERT(fd_WriteSize(Fd, buffer, len) == (ssize_t)len);
+        sent += len;
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Throughput test: read back the counting pattern and check it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestThroughput
+(
+    uint32_t baudRate
+)
+{
+    uint8_t buffer[BENCH_CHUNK_BYTES];
+    size_t received = 0;
+    size_t errors = 0;
+    size_t reads = 0;
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+
+    LE_ASSERT(LE_OK == le_tty_SetRaw(Fd, BENCH_READ_MIN_BYTES, BENCH_READ_TIMEOUT));
+
+    le_thread_Ref_t writerRef = le_thread_Create("ttyBenchWriter", WriterThread, NULL);
+    le_thread_SetJoinable(writerRef);
+    le_thread_Start(writerRef);
+
+    while (received < BenchBytes)
+    {
+        ssize_t len = read(Fd, buffer, sizeof(buffer));
+        ssize_t i;
+
+        if (len <= 0)
+        {
+            // Timed out: the remaining bytes are lost.
+            break;
+        }
+
+        if (0 == startTime)
+        {
+            startTime = GetTimeUs();
+        }
+        endTime = GetTimeUs();
+
+        for (i = 0; i < len; i++)
+        {
+            if (buffer[i] != (uint8_t)(received + i))
+            {
+                errors++;
+            }
+        }
+
+        received += len;
+        reads++;
+    }
+
+    le_thread_Join(writerRef, NULL);
+
+    uint64_t elapsed = endTime - startTime;
+
+    LE_INFO("Throughput: %zu/%zu bytes in %"PRIu64" us, %zu reads, %zu corrupted bytes",
+            received, BenchBytes, elapsed, reads, errors);
+
+    if (elapsed)
+    {
+        // 8N1 framing: 10 bits on the line per byte.
+        uint64_t bytesPerSec = ((uint64_t)received * 1000000) / elapsed;
+
+        LE_INFO("Throughput: %"PRIu64" bytes/s, %"PRIu64"%% of the line rate",
+                bytesPerSec, (bytesPerSec * 10 * 100) / baudRate);
+    }
+
+    LE_ASSERT(received == BenchBytes);
+    LE_ASSERT(0 == errors);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latency test: time single byte round trips.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestLatency
+(
+    void
+)
+{
+    uint64_t minTime = UINT64_MAX;
+    uint64_t maxTime = 0;
+    uint64_t totalTime = 0;
+    int i;
+
+    LE_ASSERT(LE_OK == le_tty_SetRaw(Fd, 1, BENCH_READ_TIMEOUT));
+
+    for (i = 0; i < LATENCY_ROUND_TRIPS; i++)
+    {
+        uint8_t byte = (uint8_t)i;
+        uint8_t readByte = 0;
+        uint64_t startTime = GetTimeUs();
+
+        LE_ASSERT(1 == fd_WriteSize(Fd, &byte, 1));
+        LE_ASSERT(1 == read(Fd, &readByte, 1));
+
+        uint64_t roundTrip = GetTimeUs() - startTime;
+
+        LE_ASSERT(readByte == byte);
+
+        totalTime += roundTrip;
+        if (roundTrip < minTime)
+        {
+            minTime = roundTrip;
+        }
+        if (roundTrip > maxTime)
+        {
+            maxTime = roundTrip;
+        }
+    }
+
+    LE_INFO("Latency: round trip min %"PRIu64" us, avg %"PRIu64" us, max %"PRIu64" us",
+            minTime, totalTime / LATENCY_ROUND_TRIPS, maxTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App init.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    uint32_t baudRate = 0;
+    bool isHardwareFlowControl = false;
+    struct termios portSettings;
+
+    LE_INFO("======== Starting Tty Benchmark ========");
+
+    if ((le_arg_NumArgs() < 2) || (le_arg_NumArgs() > 4))
+    {
+        LE_INFO("PRINT USAGE => testTtyBench /dev/ttyHS0 <baud rate> [<bytes>] [rtscts]");
+        exit(EXIT_FAILURE);
+    }
+
+    DevTty = le_arg_GetArg(0);
+    baudRate = strtoul(le_arg_GetArg(1), NULL, 10);
+
+    if (le_arg_NumArgs() >= 3)
+    {
+        BenchBytes = strtoul(le_arg_GetArg(2), NULL, 10);
+    }
+
+    if ((le_arg_NumArgs() == 4) && (0 == strcmp(le_arg_GetArg(3), "rtscts")))
+    {
+        isHardwareFlowControl = true;
+    }
+
+    Fd = le_tty_Open(DevTty, O_RDWR | O_NOCTTY);
+    LE_ASSERT(Fd > -1);
+
+    // Save configuration
+    LE_ASSERT(-1 != tcgetattr(Fd, &portSettings));
+
+    LE_ASSERT(LE_OK == le_tty_SetCustomBaudRate(Fd, baudRate));
+    LE_ASSERT(LE_OK == le_tty_SetFraming(Fd, 'N', 8, 1));
+    LE_ASSERT(LE_OK == le_tty_SetFlowControl(Fd, isHardwareFlowControl ?
+                                                 LE_TTY_FLOW_CONTROL_HARDWARE :
+                                                 LE_TTY_FLOW_CONTROL_NONE));
+
+    if (LE_OK != le_tty_SetLowLatency(Fd, true))
+    {
+        LE_WARN("Low latency mode not supported by %s", DevTty);
+    }
+
+    LE_INFO("Benchmark of %s at %"PRIu32" bits/s, %s flow control",
+            DevTty, baudRate, isHardwareFlowControl ? "hardware" : "no");
+
+    TestThroughput(baudRate);
+    TestLatency();
+
+    // restore configuration
+    LE_ASSERT(-1 != tcsetattr(Fd, TCSANOW, &portSettings));
+    le_tty_Close(Fd);
+
+    LE_INFO("======== Tty Benchmark Completed Successfully ========");
+    exit(EXIT_SUCCESS);
+}
@@ -137,6 +137,76 @@ static void TestTtySettingBaudRate
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test custom baud rates
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTtySettingCustomBaudRate
+(
+    void
+)
+{
+    const uint32_t baudRates[] = { 9600, 115200, 3000000, 3686400 };
+    uint32_t inRate, outRate;
+    int i;
+
+    int fd = TestTtyOpen();
+
+    LE_ASSERT(LE_NOT_FOUND == le_tty_SetCustomBaudRate(fd, 0));
+
+    for (i = 0; i < ARRAY_SIZE(baudRates); i++)
+    {
+        le_result_t result = le_tty_SetCustomBaudRate(fd, baudRates[i]);
+
+        if (LE_OK == result)
+        {
+            LE_ASSERT(LE_OK == le_tty_GetCustomBaudRate(fd, &inRate, &outRate));
+            LE_INFO("Custom baud rate %"PRIu32" set as %"PRIu32"/%"PRIu32,
+                    baudRates[i], inRate, outRate);
+        }
+        else
+        {
+            LE_ASSERT(LE_UNSUPPORTED == result)
+        }
+    }
+
+    // A baud rate of the table is also retrieved by le_tty_GetBaudRate().
+    if (LE_OK == le_tty_SetCustomBaudRate(fd, 115200))
+    {
+        tty_Speed_t ispeed, ospeed;
+
+        LE_ASSERT(LE_OK == le_tty_GetBaudRate(fd, &ispeed, &ospeed))
+        LE_ASSERT((LE_TTY_SPEED_115200 == ispeed) && (LE_TTY_SPEED_115200 == ospeed))
+    }
+
+    TestTtyClose(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test low latency mode
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTtySetLowLatency
+(
+    void
+)
+{
+    int fd = TestTtyOpen();
+    le_result_t result = le_tty_SetLowLatency(fd, true);
+
+    LE_ASSERT((LE_OK == result) || (LE_UNSUPPORTED == result))
+    if (LE_OK == result)
+    {
+        LE_ASSERT(LE_OK == le_tty_SetLowLatency(fd, false));
+    }
+
+    TestTtyClose(fd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test Framing
@@ -296,10 +366,12 @@ COMPONENT_INIT
 
     TestTtyOpenClose();
     TestTtySettingBaudRate();
+    TestTtySettingCustomBaudRate();
     TestTtySetFraming();
     TestTtySetFlowControl();
     TestTtySetCanonical();
     TestTtySetRaw();
+    TestTtySetLowLatency();
 
     // restore configuration
     fd = TestTtyOpen();
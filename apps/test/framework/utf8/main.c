@@ -311,6 +311,73 @@ static void TestEncodeDecodeCodePoint(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks strings long enough for the ASCII runs to be scanned several bytes at a time, starting at
+ * every alignment and with a multi-byte or invalid character at every position.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestLongStrings(void)
+{
+    char src[80];
+    char dest[80];
+    size_t offset;
+    size_t pos;
+    size_t destSize;
+    size_t numBytesCopied;
+
+    for (offset = 0; offset < 8; offset++)
+    {
+        char* strPtr = &src[offset];
+        size_t len = sizeof(src) - offset - 1;
+
+        // All ASCII.
+        memset(strPtr, 'a', len);
+        strPtr[len] = '\0';
+
+        LE_ASSERT(le_utf8_NumChars(strPtr) == len);
+        LE_ASSERT(le_utf8_IsFormatCorrect(strPtr));
+
+        for (destSize = 1; destSize <= len + 1; destSize++)
+        {
+            memset(dest, 'x', sizeof(dest));
+            LE_ASSERT(le_utf8_Copy(dest, strPtr, destSize, &numBytesCopied)
+                      == ((destSize == len + 1) ? LE_OK : LE_OVERFLOW));
+            LE_ASSERT(numBytesCopied == destSize - 1);
+            LE_ASSERT(strncmp(dest, strPtr, destSize - 1) == 0);
+            LE_ASSERT(dest[destSize - 1] == '\0');
+            LE_ASSERT((destSize == sizeof(dest)) || (dest[destSize] == 'x'));
+        }
+
+        for (pos = 0; pos + 1 < len; pos++)
+        {
+            // A two-byte character somewhere in the ASCII.
+            strPtr[pos] = TWO_CHAR_BYTE;
+            strPtr[pos + 1] = CONT_BYTE;
+
+            LE_ASSERT(le_utf8_NumChars(strPtr) == len - 1);
+            LE_ASSERT(le_utf8_IsFormatCorrect(strPtr));
+
+            // Truncating in the middle of the character drops all of it.
+            LE_ASSERT(le_utf8_Copy(dest, strPtr, pos + 2, &numBytesCopied) == LE_OVERFLOW);
+            LE_ASSERT(numBytesCopied == pos);
+            LE_ASSERT(le_utf8_Copy(dest, strPtr, sizeof(dest), &numBytesCopied) == LE_OK);
+            LE_ASSERT(numBytesCopied == len);
+            LE_ASSERT(strcmp(dest, strPtr) == 0);
+
+            // A continuation byte without a lead byte.
+            strPtr[pos] = CONT_BYTE;
+
+            LE_ASSERT(le_utf8_NumChars(strPtr) == LE_FORMAT_ERROR);
+            LE_ASSERT(!le_utf8_IsFormatCorrect(strPtr));
+
+            strPtr[pos] = 'a';
+            strPtr[pos + 1] = 'a';
+        }
+    }
+}
+
+
 COMPONENT_INIT
 {
     size_t numBytesCopied;
@@ -636,6 +703,10 @@ COMPONENT_INIT
 
     printf("Int parsing correct.\n");
 
+    TestLongStrings();
+
+    printf("Long strings correct.\n");
+
     printf("Testing encode/decode\n");
     TestEncodeDecodeCodePoint();
     printf("Completed testing encode/decode\n");
@@ -50,6 +50,7 @@ static le_result_t FlashApiTest_Info(char **args);
 static le_result_t FlashApiTest_Dump(char **args);
 static le_result_t FlashApiTest_Flash(char **args);
 static le_result_t FlashApiTest_FlashErase(char **args);
+static le_result_t FlashApiTest_FlashStream(char **args);
 static le_result_t FlashApiTest_Copy(char **args);
 static le_result_t FlashApiTest_InfoUbi(char **args);
 static le_result_t FlashApiTest_DumpUbi(char **args);
@@ -78,6 +79,9 @@ static FlashApiTest_t FlashApiTest[] =
     { "flash-erase",    2, FlashApiTest_FlashErase,
       "flash-erase paritionName fileName: flash the file into the given"
            " partition and erase remaining blocks",                             },
+    { "flash-stream",   2, FlashApiTest_FlashStream,
+      "flash-stream paritionName fileName: stream the file into the given"
+           " partition",                                                        },
     { "copy",           2, FlashApiTest_Copy,
       "copy sourceName destinationName: copy in raw the source to the"
            " destination",                                                      },
@@ -391,6 +395,59 @@ static le_result_t FlashApiTest_Flash
 }
 //! [Flash]
 
+//! [FlashStream]
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream a file into a MTD partition
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_FlashStream
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    const char *fromFile = args[1];
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t writtenBlock;
+    int fromFd;
+
+    fromFd = open(fromFile, O_RDONLY);
+    if (-1 == fromFd)
+    {
+        LE_ERROR("Failed to open '%s': %m", fromFile);
+        return LE_FAULT;
+    }
+
+    // Open the given MTD partition in W/O
+    res = le_flash_OpenMtd(partNameStr, LE_FLASH_WRITE_ONLY, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        close(fromFd);
+        return res;
+    }
+
+    // Stream the whole file from the first block. The file descriptor is sent to the flash
+    // service, which reads the file and writes it block by block. It is closed by the service.
+    res = le_flash_WriteStream(partRef, 0, fromFd, &writtenBlock);
+    if (LE_OK != res)
+    {
+        LE_ERROR("le_flash_WriteStream failed: %d", res);
+        le_flash_Close(partRef);
+        return res;
+    }
+    LE_INFO("Written %u blocks to partition \"%s\"", writtenBlock, partNameStr);
+
+    // Close the MTD
+    res = le_flash_Close(partRef);
+    LE_INFO("partition \"%s\" close ref %p, res %d", partNameStr, partRef, res);
+    return res;
+}
+//! [FlashStream]
+
 //! [FlashErase]
 //--------------------------------------------------------------------------------------------------
 /**
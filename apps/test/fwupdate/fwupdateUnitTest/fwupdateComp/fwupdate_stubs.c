@@ -36,6 +36,18 @@ void le_wdogChain_MonitorEventLoop
 {
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick a watchdog on the chain.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wdogChain_Kick
+(
+    uint32_t watchdog
+)
+{
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the client session reference for the current message
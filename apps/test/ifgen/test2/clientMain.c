@@ -265,11 +265,92 @@ void test1(void)
 }
 
 
-void StartTest(void)
+void testBatch(void)
 {
-    banner("Test 1");
-    test1();
+    uint32_t data[] = {1, 2, 3, 4};
+    uint32_t value[2] = {10, 10};
+    size_t length[2] = {10, 10};
+    uint32_t output[2][10];
+    char response[2][21];
+    char more[2][21];
+    int fdToServer;
+    int fdFromServer = -1;
+
+    // Queue the same calls as in test1, and send them to the server in one go.  Nothing is
+    // returned until the batch is sent.
+    fdToServer = open("/usr/include/stdio.h", O_RDONLY);
+
+    example_BatchallParameters(COMMON_TWO,
+                               &value[0],
+                               data,
+                               4,
+                               output[0],
+                               &length[0],
+                               "input string",
+                               response[0],
+                               sizeof(response[0]),
+                               more[0],
+                               sizeof(more[0]));
+    example_BatchFileTest(fdToServer, &fdFromServer);
+    example_BatchallParameters(COMMON_ZERO,
+                               &value[1],
+                               data,
+                               4,
+                               output[1],
+                               &length[1],
+                               "new string",
+                               response[1],
+                               sizeof(response[1]),
+                               more[1],
+                               sizeof(more[1]));
+    LE_ASSERT(fdFromServer == -1);
+
+    example_SendBatch();
+
+    LE_PRINT_VALUE("%i", value[0]);
+    LE_PRINT_ARRAY("%i", length[0], output[0]);
+    LE_PRINT_VALUE("%s", response[0]);
+    LE_PRINT_VALUE("%s", more[0]);
+    LE_PRINT_VALUE("%i", value[1]);
+    LE_PRINT_VALUE("%i", fdFromServer);
+
+    LE_ASSERT(fdFromServer >= 0);
+    writeFdToLog(fdFromServer);
+    close(fdToServer);
+
+    // Sending an empty batch does nothing.
+    example_SendBatch();
+}
+
+
+static void AllParametersAsyncDone
+(
+    uint32_t b,
+    const uint32_t* outputPtr,
+    size_t outputSize,
+    const char* response,
+    const char* more,
+    void* contextPtr
+);
+
+
+void testAsync(void)
+{
+    uint32_t data[] = {1, 2, 3, 4};
+
+    // The response is handled by the event loop, so the rest of the test continues in the
+    // callback.
+    example_allParametersAsync(COMMON_TWO,
+                               data,
+                               4,
+                               "input string",
+                               AllParametersAsyncDone,
+                               &SomeData);
+}
+
 
+void ContinueTest(void)
+{
     // Verify that the client session can be stopped.
     banner("Test Stop/Restart Client");
     example_DisconnectService();
@@ -285,6 +366,40 @@ void StartTest(void)
 }
 
 
+static void AllParametersAsyncDone
+(
+    uint32_t b,
+    const uint32_t* outputPtr,
+    size_t outputSize,
+    const char* response,
+    const char* more,
+    void* contextPtr
+)
+{
+    LE_ASSERT(contextPtr == &SomeData);
+
+    LE_PRINT_VALUE("%i", b);
+    LE_PRINT_ARRAY("%i", outputSize, outputPtr);
+    LE_PRINT_VALUE("%s", response);
+    LE_PRINT_VALUE("%s", more);
+
+    ContinueTest();
+}
+
+
+void StartTest(void)
+{
+    banner("Test 1");
+    test1();
+
+    banner("Test Batch");
+    testBatch();
+
+    banner("Test Async");
+    testAsync();
+}
+
+
 COMPONENT_INIT
 {
     banner("Test TryConnect");
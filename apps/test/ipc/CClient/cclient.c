@@ -7,6 +7,7 @@
 
 #include <setjmp.h>
 #include <string.h>
+#include <sys/mman.h>
 
 #include <CUnit/Console.h>
 #include <CUnit/Basic.h>
@@ -241,6 +242,77 @@ static void TestEchoArrayNull(void)
 }
 #endif
 
+// Set if the shared buffer test service is bound (only when the server is written in C).
+static bool SharedTestConnected;
+
+static void TestCheckShared(void)
+{
+    if (!SharedTestConnected)
+    {
+        CU_PASS("Shared buffers not supported by this server");
+        return;
+    }
+
+    static uint8_t inBuffer[IPCSHAREDTEST_MAX_BUFFER_BYTES];
+    uint32_t checksum = 0;
+    uint32_t outSize = 0;
+    uint32_t outChecksum = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(inBuffer); ++i)
+    {
+        inBuffer[i] = (uint8_t)(i * 7);
+        checksum += inBuffer[i];
+    }
+
+    ipcSharedTest_CheckShared(inBuffer, sizeof(inBuffer), &outSize, &outChecksum);
+    CU_ASSERT(outSize == sizeof(inBuffer));
+    CU_ASSERT(outChecksum == checksum);
+
+    ipcSharedTest_CheckShared(inBuffer, 3, &outSize, &outChecksum);
+    CU_ASSERT(outSize == 3);
+    CU_ASSERT(outChecksum == (uint32_t)inBuffer[0] + inBuffer[1] + inBuffer[2]);
+}
+
+// Creates a shared memory file, with the given seals.  The file is closed when it's sent.
+static int CreateSharedFile(unsigned int seals)
+{
+    int fd = memfd_create("ipcSharedTest", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(ftruncate(fd, 4096) == 0);
+
+    if (seals != 0)
+    {
+        LE_ASSERT(fcntl(fd, F_ADD_SEALS, seals) == 0);
+    }
+
+    return fd;
+}
+
+static void TestMapSealedFile(void)
+{
+    if (!SharedTestConnected)
+    {
+        CU_PASS("Shared buffers not supported by this server");
+        return;
+    }
+
+    CU_ASSERT(ipcSharedTest_MapFile(CreateSharedFile(F_SEAL_SHRINK | F_SEAL_WRITE)) == LE_OK);
+}
+
+static void TestMapUnsealedFile(void)
+{
+    if (!SharedTestConnected)
+    {
+        CU_PASS("Shared buffers not supported by this server");
+        return;
+    }
+
+    // The sender could change or truncate these files while the receiver reads them.
+    CU_ASSERT(ipcSharedTest_MapFile(CreateSharedFile(0)) == LE_FAULT);
+    CU_ASSERT(ipcSharedTest_MapFile(CreateSharedFile(F_SEAL_SHRINK)) == LE_FAULT);
+}
+
 // Server exit handler.
 static jmp_buf ServerExitJump;
 
@@ -269,6 +341,7 @@ static void TestServerExit(void)
 static void* run_test(void* context)
 {
     ipcTest_ConnectService();
+    SharedTestConnected = (ipcSharedTest_TryConnectService() == LE_OK);
 
     // Initialize the CUnit test registry and register the test suite
     if (CUE_SUCCESS != CU_initialize_registry())
@@ -297,6 +370,9 @@ static void* run_test(void* context)
 //              { "EchoArray", TestEchoSmallArray },
 //              { "EchoArray with max size array", TestEchoMaxArray },
 //              { "EchoArray with NULL output", TestEchoArrayNull },
+              { "CheckShared", TestCheckShared },
+              { "MapFile with sealed file", TestMapSealedFile },
+              { "MapFile with unsealed file", TestMapUnsealedFile },
               { "Server exit", TestServerExit},
               CU_TEST_INFO_NULL
         };
@@ -144,6 +144,52 @@ void ipcTest_EchoArray
 }
 #endif
 
+void ipcSharedTest_CheckShared
+(
+    const uint8_t* InBufferPtr,
+    size_t InBufferSize,
+    uint32_t* OutSizePtr,
+    uint32_t* OutChecksumPtr
+)
+{
+    uint32_t checksum = 0;
+    size_t i;
+
+    for (i = 0; i < InBufferSize; ++i)
+    {
+        checksum += InBufferPtr[i];
+    }
+
+    if (OutSizePtr)
+    {
+        *OutSizePtr = InBufferSize;
+    }
+    if (OutChecksumPtr)
+    {
+        *OutChecksumPtr = checksum;
+    }
+}
+
+le_result_t ipcSharedTest_MapFile
+(
+    int InFile
+)
+{
+    // Attach the file to a message, as if it had been received with one.
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(ipcSharedTest_GetClientSessionRef());
+    const void* bufferPtr;
+    size_t bufferSize;
+
+    le_msg_SetFd(msgRef, InFile);
+
+    le_result_t result = le_msg_GetSharedBuffer(msgRef, &bufferPtr, &bufferSize);
+
+    le_msg_ReleaseSharedBuffer(bufferPtr, bufferSize);
+    le_msg_ReleaseMsg(msgRef);
+
+    return result;
+}
+
 void ipcTest_ExitServer
 (
     void
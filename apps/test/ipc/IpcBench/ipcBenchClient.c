@@ -0,0 +1,693 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC throughput and latency benchmark.
+ *
+ * Measures, over Unix sockets (TEST_UNIX_SOCKET, with the server in another process) or over local
+ * messaging (TEST_LOCAL, with the server in another thread of this process):
+ *
+ *  - syncLatency: the latency of synchronous request-response transactions, with small and
+ *    maximum size payloads,
+ *  - asyncThroughput: the throughput of asynchronous request-response transactions, with
+ *    ASYNC_WINDOW requests in flight, with small and maximum size payloads,
+ *  - fdPassing: the latency of synchronous transactions carrying a file descriptor,
+ *  - concurrentSessions: the latency and aggregate throughput of synchronous transactions made
+ *    by many client threads at once, each over its own session,
+ *  - sessionOpenClose: the time taken to open and close a session, which goes through the
+ *    Service Directory for Unix sockets,
+ *  - sessionOpenCloseCached: the same, with the server's endpoint cached by the client (Unix
+ *    sockets only).
+ *
+ * Usage:
+ *
+ *      ipcBenchClient [-n ITERATIONS] [-s SESSIONS] [-o OUTPUT_FILE]
+ *
+ * Each result is printed to stdout as one JSON object per line, and appended to OUTPUT_FILE if
+ * one is given.  Times are in nanoseconds.  For example:
+ *
+ *      {"benchmark":"syncLatency","transport":"unix","payloadBytes":24,"count":10000,
+ *       "meanNs":21034,"p50Ns":19870,"p99Ns":41233,"opsPerSec":47542}
+ *
+ * The benchmark exits when done.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include <poll.h>
+#include "ipcBenchProtocol.h"
+#include "ipcBenchServer.h"
+
+
+#if defined(TEST_UNIX_SOCKET)
+#define TRANSPORT_NAME "unix"
+#elif defined(TEST_LOCAL)
+#define TRANSPORT_NAME "local"
+#else
+#error "Either TEST_UNIX_SOCKET or TEST_LOCAL must be defined."
+#endif
+
+/// Number of asynchronous requests kept in flight by the throughput benchmark.
+#define ASYNC_WINDOW 16
+
+/// Largest number of client threads for the concurrent sessions benchmark.
+#define MAX_SESSIONS 256
+
+/// Number of sessions opened and closed is the number of iterations divided by this.
+#define OPEN_CLOSE_DIVIDER 10
+
+
+/// Number of transactions per measurement.
+static int Iterations = 10000;
+
+/// Number of client threads for the concurrent sessions benchmark.
+static int Sessions = 16;
+
+/// File to append the results to, if any.
+static const char* OutputPathPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of one measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* benchmarkPtr;   ///< Name of the benchmark.
+    size_t payloadBytes;        ///< Size of the request payload, 0 if not relevant.
+    size_t count;               ///< Number of operations.
+    uint64_t totalNs;           ///< Time taken by all the operations.
+    uint64_t* samplesPtr;       ///< Duration of each operation, NULL if not measured.
+}
+Result_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the asynchronous throughput benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;
+    size_t payloadBytes;
+    size_t sentCount;           ///< Number of requests sent.
+    size_t doneCount;           ///< Number of responses received.
+    size_t totalCount;          ///< Number of requests to send.
+}
+AsyncState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A client thread of the concurrent sessions benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_thread_Ref_t threadRef;
+    size_t count;               ///< Number of transactions to make.
+    uint64_t* samplesPtr;       ///< Where to store the duration of each transaction.
+}
+SessionThread_t;
+
+
+#if defined(TEST_UNIX_SOCKET)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_ProtocolRef_t ProtocolRef;
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server started semaphore, for local messaging.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t ServerStartedSemRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NowNs
+(
+    void
+)
+{
+    struct timespec now;
+
+    LE_ASSERT(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two samples, for qsort().
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareSamples
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    uint64_t a = *(const uint64_t*)aPtr;
+    uint64_t b = *(const uint64_t*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a result, and append it to the output file if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Report
+(
+    Result_t* resultPtr
+)
+{
+    char line[512];
+    size_t len = 0;
+
+    len += snprintf(line + len, sizeof(line) - len,
+                    "{\"benchmark\":\"%s\",\"transport\":\"%s\"",
+                    resultPtr->benchmarkPtr, TRANSPORT_NAME);
+
+    if (resultPtr->payloadBytes != 0)
+    {
+        len += snprintf(line + len, sizeof(line) - len,
+                        ",\"payloadBytes\":%zu", resultPtr->payloadBytes);
+    }
+
+    len += snprintf(line + len, sizeof(line) - len, ",\"count\":%zu", resultPtr->count);
+
+    if ((resultPtr->samplesPtr != NULL) && (resultPtr->count > 0))
+    {
+        size_t count = resultPtr->count;
+        uint64_t sum = 0;
+        size_t i;
+
+        for (i = 0; i < count; i++)
+        {
+            sum += resultPtr->samplesPtr[i];
+        }
+
+        qsort(resultPtr->samplesPtr, count, sizeof(uint64_t), CompareSamples);
+
+        len += snprintf(line + len, sizeof(line) - len,
+                        ",\"meanNs\":%" PRIu64 ",\"p50Ns\":%" PRIu64 ",\"p99Ns\":%" PRIu64,
+                        sum / count,
+                        resultPtr->samplesPtr[((count - 1) * 50) / 100],
+                        resultPtr->samplesPtr[((count - 1) * 99) / 100]);
+    }
+
+    if (resultPtr->totalNs > 0)
+    {
+        double opsPerSec = ((double)resultPtr->count * 1e9) / (double)resultPtr->totalNs;
+
+        len += snprintf(line + len, sizeof(line) - len, ",\"opsPerSec\":%.0f", opsPerSec);
+
+        if (resultPtr->payloadBytes != 0)
+        {
+            len += snprintf(line + len, sizeof(line) - len, ",\"bytesPerSec\":%.0f",
+                            opsPerSec * (double)resultPtr->payloadBytes);
+        }
+    }
+
+    snprintf(line + len, sizeof(line) - len, "}");
+
+    printf("%s\n", line);
+    fflush(stdout);
+
+    if (OutputPathPtr != NULL)
+    {
+        FILE* filePtr = fopen(OutputPathPtr, "a");
+
+        if (filePtr == NULL)
+        {
+            LE_ERROR("Could not open '%s'.  %m.", OutputPathPtr);
+        }
+        else
+        {
+            fprintf(filePtr, "%s\n", line);
+            fclose(filePtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create and open a session with the server.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t OpenSession
+(
+    void
+)
+{
+#if defined(TEST_UNIX_SOCKET)
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(ProtocolRef, IPC_BENCH_SERVICE_NAME);
+#elif defined(TEST_LOCAL)
+    le_msg_SessionRef_t sessionRef = le_msg_CreateLocalSession(&IpcBenchService);
+#endif
+
+    le_msg_OpenSessionSync(sessionRef);
+
+    return sessionRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close and delete a session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSession
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    le_msg_CloseSession(sessionRef);
+    le_msg_DeleteSession(sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a request.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t CreateRequest
+(
+    le_msg_SessionRef_t sessionRef,
+    uint32_t op,
+    size_t payloadBytes
+)
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateSizedMsg(sessionRef, payloadBytes);
+    ipcBench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->op = op;
+
+    return msgRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make a synchronous echo transaction.
+ *
+ * @return its duration.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t DoSyncRequest
+(
+    le_msg_SessionRef_t sessionRef,
+    size_t payloadBytes
+)
+{
+    le_msg_MessageRef_t msgRef = CreateRequest(sessionRef, IPC_BENCH_OP_ECHO, payloadBytes);
+
+    uint64_t start = NowNs();
+    le_msg_MessageRef_t responseRef = le_msg_RequestSyncResponse(msgRef);
+    uint64_t duration = NowNs() - start;
+
+    LE_FATAL_IF(responseRef == NULL, "Transaction failed.");
+    le_msg_ReleaseMsg(responseRef);
+
+    return duration;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the latency of synchronous transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchSyncLatency
+(
+    le_msg_SessionRef_t sessionRef,
+    size_t payloadBytes
+)
+{
+    Result_t result = { "syncLatency", payloadBytes, Iterations, 0, NULL };
+    size_t i;
+
+    result.samplesPtr = calloc(result.count, sizeof(uint64_t));
+    LE_ASSERT(result.samplesPtr != NULL);
+
+    // Warm up the message pools.
+    DoSyncRequest(sessionRef, payloadBytes);
+
+    for (i = 0; i < result.count; i++)
+    {
+        result.samplesPtr[i] = DoSyncRequest(sessionRef, payloadBytes);
+        result.totalNs += result.samplesPtr[i];
+    }
+
+    Report(&result);
+    free(result.samplesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the next asynchronous request, if there are any left.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendAsyncRequest(AsyncState_t* statePtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the response to an asynchronous request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AsyncResponseHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void* contextPtr
+)
+{
+    AsyncState_t* statePtr = contextPtr;
+
+    LE_FATAL_IF(msgRef == NULL, "Transaction failed.");
+    le_msg_ReleaseMsg(msgRef);
+
+    statePtr->doneCount++;
+    SendAsyncRequest(statePtr);
+}
+
+
+static void SendAsyncRequest
+(
+    AsyncState_t* statePtr
+)
+{
+    if (statePtr->sentCount < statePtr->totalCount)
+    {
+        le_msg_MessageRef_t msgRef = CreateRequest(statePtr->sessionRef,
+                                                   IPC_BENCH_OP_ECHO,
+                                                   statePtr->payloadBytes);
+        statePtr->sentCount++;
+        le_msg_RequestResponse(msgRef, AsyncResponseHandler, statePtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of asynchronous transactions.  Responses are handled by servicing this
+ * thread's event loop until they have all arrived.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchAsyncThroughput
+(
+    le_msg_SessionRef_t sessionRef,
+    size_t payloadBytes
+)
+{
+    AsyncState_t state = { sessionRef, payloadBytes, 0, 0, Iterations };
+    struct pollfd pollFd = { .fd = le_event_GetFd(), .events = POLLIN };
+    size_t i;
+
+    uint64_t start = NowNs();
+
+    for (i = 0; i < ASYNC_WINDOW; i++)
+    {
+        SendAsyncRequest(&state);
+    }
+
+    while (state.doneCount < state.totalCount)
+    {
+        while (le_event_ServiceLoop() == LE_OK)
+        {
+        }
+
+        if (state.doneCount < state.totalCount)
+        {
+            LE_ASSERT((poll(&pollFd, 1, -1) >= 0) || (errno == EINTR));
+        }
+    }
+
+    Result_t result = { "asyncThroughput", payloadBytes, state.totalCount, NowNs() - start, NULL };
+    Report(&result);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the latency of synchronous transactions carrying a file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchFdPassing
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    Result_t result = { "fdPassing", IPC_BENCH_MSG_SIZE(IPC_BENCH_SMALL_DATA_BYTES),
+                        Iterations, 0, NULL };
+    size_t fdReceivedCount = 0;
+    size_t i;
+
+    int fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    LE_FATAL_IF(fd < 0, "Could not open /dev/null.  %m.");
+
+    result.samplesPtr = calloc(result.count, sizeof(uint64_t));
+    LE_ASSERT(result.samplesPtr != NULL);
+
+    for (i = 0; i < result.count; i++)
+    {
+        le_msg_MessageRef_t msgRef = CreateRequest(sessionRef, IPC_BENCH_OP_FD,
+                                                   result.payloadBytes);
+
+        // The messaging system takes ownership of the file descriptor, and closes it once sent.
+        int dupFd = dup(fd);
+        LE_FATAL_IF(dupFd < 0, "Could not duplicate fd.  %m.");
+
+        uint64_t start = NowNs();
+        le_msg_SetFd(msgRef, dupFd);
+        le_msg_MessageRef_t responseRef = le_msg_RequestSyncResponse(msgRef);
+        result.samplesPtr[i] = NowNs() - start;
+        result.totalNs += result.samplesPtr[i];
+
+        LE_FATAL_IF(responseRef == NULL, "Transaction failed.");
+        fdReceivedCount += ((ipcBench_Message_t*)le_msg_GetPayloadPtr(responseRef))->fdReceived;
+        le_msg_ReleaseMsg(responseRef);
+    }
+
+    close(fd);
+
+    LE_ERROR_IF(fdReceivedCount != result.count,
+                "Server received only %zu file descriptors out of %zu.",
+                fdReceivedCount, result.count);
+
+    Report(&result);
+    free(result.samplesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a client thread of the concurrent sessions benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SessionThreadMain
+(
+    void* contextPtr
+)
+{
+    SessionThread_t* threadPtr = contextPtr;
+    le_msg_SessionRef_t sessionRef = OpenSession();
+    size_t i;
+
+    for (i = 0; i < threadPtr->count; i++)
+    {
+        threadPtr->samplesPtr[i] =
+            DoSyncRequest(sessionRef, IPC_BENCH_MSG_SIZE(IPC_BENCH_SMALL_DATA_BYTES));
+    }
+
+    CloseSession(sessionRef);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure synchronous transactions made by many threads at once, each over its own session.
+ * The iterations are shared between the threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchConcurrentSessions
+(
+    void
+)
+{
+    static SessionThread_t threads[MAX_SESSIONS];
+    size_t sessionCount = Sessions;
+    size_t perThreadCount = Iterations / sessionCount;
+    Result_t result = { "concurrentSessions", IPC_BENCH_MSG_SIZE(IPC_BENCH_SMALL_DATA_BYTES),
+                        perThreadCount * sessionCount, 0, NULL };
+    size_t i;
+
+    result.samplesPtr = calloc(result.count, sizeof(uint64_t));
+    LE_ASSERT(result.samplesPtr != NULL);
+
+    for (i = 0; i < sessionCount; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "IpcBench%zu", i);
+        threads[i].count = perThreadCount;
+        threads[i].samplesPtr = result.samplesPtr + (i * perThreadCount);
+        threads[i].threadRef = le_thread_Create(name, SessionThreadMain, &threads[i]);
+        le_thread_SetJoinable(threads[i].threadRef);
+    }
+
+    uint64_t start = NowNs();
+
+    for (i = 0; i < sessionCount; i++)
+    {
+        le_thread_Start(threads[i].threadRef);
+    }
+
+    for (i = 0; i < sessionCount; i++)
+    {
+        le_thread_Join(threads[i].threadRef, NULL);
+    }
+
+    result.totalNs = NowNs() - start;
+
+    Report(&result);
+    free(result.samplesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure how long it takes to open and close a session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchSessionOpenClose
+(
+    const char* benchmarkPtr
+)
+{
+    Result_t result = { benchmarkPtr, 0, Iterations / OPEN_CLOSE_DIVIDER, 0, NULL };
+    size_t i;
+
+    if (result.count == 0)
+    {
+        result.count = 1;
+    }
+
+    result.samplesPtr = calloc(result.count, sizeof(uint64_t));
+    LE_ASSERT(result.samplesPtr != NULL);
+
+    for (i = 0; i < result.count; i++)
+    {
+        uint64_t start = NowNs();
+        CloseSession(OpenSession());
+        result.samplesPtr[i] = NowNs() - start;
+        result.totalNs += result.samplesPtr[i];
+    }
+
+    Report(&result);
+    free(result.samplesPtr);
+}
+
+
+#if defined(TEST_UNIX_SOCKET)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure how long it takes to open and close a session when the client has cached the server's
+ * endpoint, so it doesn't go through the Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchSessionOpenCloseCached
+(
+    void
+)
+{
+    le_msg_SessionRef_t sessionRef = OpenSession();
+    le_msg_CacheServerEndpoint(sessionRef);
+    CloseSession(sessionRef);
+
+    BenchSessionOpenClose("sessionOpenCloseCached");
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the server thread, for local messaging.
+ */
+//--------------------------------------------------------------------------------------------------
+static __attribute__((unused)) void* ServerThreadMain
+(
+    void* contextPtr
+)
+{
+    ipcBenchServer_Start();
+    le_sem_Post(ServerStartedSemRef);
+
+    le_event_RunLoop();
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetIntVar(&Iterations, "n", "iterations");
+    le_arg_SetIntVar(&Sessions, "s", "sessions");
+    le_arg_SetStringVar(&OutputPathPtr, "o", "output");
+    le_arg_Scan();
+
+    LE_FATAL_IF(Iterations <= 0, "Number of iterations must be positive.");
+    LE_FATAL_IF((Sessions <= 0) || (Sessions > MAX_SESSIONS),
+                "Number of sessions must be between 1 and %d.", MAX_SESSIONS);
+    LE_FATAL_IF(Sessions > Iterations, "Number of sessions can't exceed number of iterations.");
+
+#if defined(TEST_UNIX_SOCKET)
+    ProtocolRef = le_msg_GetProtocolRef(IPC_BENCH_PROTOCOL_ID_STR, sizeof(ipcBench_Message_t));
+#elif defined(TEST_LOCAL)
+    ServerStartedSemRef = le_sem_Create("IpcBenchServerStarted", 0);
+    ipcBenchServer_Init();
+    le_thread_Start(le_thread_Create("IpcBenchServer", ServerThreadMain, NULL));
+    le_sem_Wait(ServerStartedSemRef);
+#endif
+
+    le_msg_SessionRef_t sessionRef = OpenSession();
+
+    BenchSyncLatency(sessionRef, IPC_BENCH_MSG_SIZE(IPC_BENCH_SMALL_DATA_BYTES));
+    BenchSyncLatency(sessionRef, sizeof(ipcBench_Message_t));
+
+    BenchAsyncThroughput(sessionRef, IPC_BENCH_MSG_SIZE(IPC_BENCH_SMALL_DATA_BYTES));
+    BenchAsyncThroughput(sessionRef, sizeof(ipcBench_Message_t));
+
+    BenchFdPassing(sessionRef);
+
+    CloseSession(sessionRef);
+
+    BenchConcurrentSessions();
+
+    BenchSessionOpenClose("sessionOpenClose");
+
+#if defined(TEST_UNIX_SOCKET)
+    BenchSessionOpenCloseCached();
+#endif
+
+    exit(EXIT_SUCCESS);
+}
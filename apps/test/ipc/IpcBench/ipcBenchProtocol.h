@@ -0,0 +1,40 @@
+/**
+ * Protocol used by the IPC benchmark.
+ *
+ * Every message is a request that the server answers with the same payload (an echo), so the
+ * round trip moves the same number of bytes in both directions.  A request can also carry a file
+ * descriptor, which the server closes before responding.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef IPC_BENCH_PROTOCOL_H_INCLUDE_GUARD
+#define IPC_BENCH_PROTOCOL_H_INCLUDE_GUARD
+
+#define IPC_BENCH_PROTOCOL_ID_STR "IpcBenchProtocol"
+
+/// Name of the service, on both the client and the server side.
+#define IPC_BENCH_SERVICE_NAME "IpcBench"
+
+/// Largest payload of a message, not counting the header.
+#define IPC_BENCH_MAX_DATA_BYTES 4096
+
+/// Payload of a small message, not counting the header.
+#define IPC_BENCH_SMALL_DATA_BYTES 16
+
+/// Operations.
+#define IPC_BENCH_OP_ECHO 0     ///< Respond with the same payload.
+#define IPC_BENCH_OP_FD   1     ///< Close the file descriptor sent with the request, then respond.
+
+typedef struct
+{
+    uint32_t op;                ///< IPC_BENCH_OP_xxx
+    uint32_t fdReceived;        ///< Set by the server to 1 if it received a file descriptor.
+    uint8_t data[IPC_BENCH_MAX_DATA_BYTES];
+}
+ipcBench_Message_t;
+
+/// Size of a message carrying a given number of data bytes.
+#define IPC_BENCH_MSG_SIZE(dataBytes) (offsetof(ipcBench_Message_t, data) + (dataBytes))
+
+#endif // IPC_BENCH_PROTOCOL_H_INCLUDE_GUARD
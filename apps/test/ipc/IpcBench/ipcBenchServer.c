@@ -0,0 +1,112 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC benchmark server.  Echoes every request back to the client.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "ipcBenchProtocol.h"
+#include "ipcBenchServer.h"
+
+
+#if defined(TEST_LOCAL)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the messages of the local service.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MessagePoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The service, when the benchmark runs over local messaging.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_LocalService_t IpcBenchService;
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Service reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_ServiceRef_t ServiceRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a request from a client.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void MsgRecvHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void* contextPtr
+)
+{
+    ipcBench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    if (msgPtr->op == IPC_BENCH_OP_FD)
+    {
+        int fd = le_msg_GetFd(msgRef);
+
+        msgPtr->fdReceived = (fd >= 0);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    if (le_msg_NeedsResponse(msgRef))
+    {
+        le_msg_Respond(msgRef);
+    }
+    else
+    {
+        le_msg_ReleaseMsg(msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the server.  For local messaging, must be run before any client tries to open a
+ * session, but doesn't need to be run in the server thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ipcBenchServer_Init
+(
+    void
+)
+{
+#if defined(TEST_LOCAL)
+    MessagePoolRef = le_mem_CreatePool("IpcBenchMessage",
+                                       LE_MSG_LOCAL_HEADER_SIZE + sizeof(ipcBench_Message_t));
+
+    ServiceRef = le_msg_InitLocalService(&IpcBenchService, IPC_BENCH_SERVICE_NAME, MessagePoolRef);
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the server in the calling thread.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ipcBenchServer_Start
+(
+    void
+)
+{
+#if defined(TEST_UNIX_SOCKET)
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(IPC_BENCH_PROTOCOL_ID_STR,
+                                                             sizeof(ipcBench_Message_t));
+    ServiceRef = le_msg_CreateService(protocolRef, IPC_BENCH_SERVICE_NAME);
+#endif
+
+    le_msg_SetServiceRecvHandler(ServiceRef, MsgRecvHandler, NULL);
+    le_msg_AdvertiseService(ServiceRef);
+}
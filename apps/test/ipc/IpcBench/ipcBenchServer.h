@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC benchmark server API.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#ifndef IPC_BENCH_SERVER_H_INCLUDE_GUARD
+#define IPC_BENCH_SERVER_H_INCLUDE_GUARD
+
+#if defined(TEST_LOCAL)
+//--------------------------------------------------------------------------------------------------
+/**
+ * The service, when the benchmark runs over local messaging.
+ */
+//--------------------------------------------------------------------------------------------------
+extern le_msg_LocalService_t IpcBenchService;
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the server.  For local messaging, must be run before any client tries to open a
+ * session, but doesn't need to be run in the server thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ipcBenchServer_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the server in the calling thread.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ipcBenchServer_Start
+(
+    void
+);
+
+#endif // IPC_BENCH_SERVER_H_INCLUDE_GUARD
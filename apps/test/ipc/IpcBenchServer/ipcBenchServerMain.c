@@ -0,0 +1,17 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stand-alone IPC benchmark server, for the benchmark over Unix sockets.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "ipcBenchServer.h"
+
+
+COMPONENT_INIT
+{
+    ipcBenchServer_Init();
+    ipcBenchServer_Start();
+}
@@ -0,0 +1,75 @@
+/*
+ * Benchmark of the IPC calls made from Java: times a series of echo calls to the server and
+ * reports the number of calls per second.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+package io.legato.test;
+
+import java.math.BigInteger;
+
+import io.legato.Ref;
+import io.legato.Level;
+import io.legato.Component;
+import io.legato.api.ipcTest;
+
+public class JavaClient extends Component {
+	/**
+	 * Number of calls timed for each function.
+	 */
+	private static final int CALL_COUNT = 10000;
+
+	/**
+	 * String echoed by the string benchmark.
+	 */
+	private static final String TEST_STRING = "Benchmark of the Legato IPC from Java";
+
+	private void report(String functionName, long startTimeNs) {
+		long elapsedNs = System.nanoTime() - startTimeNs;
+
+		getLogger().log(Level.INFO, String.format("%s: %d calls in %d ms, %d calls/s",
+				functionName, CALL_COUNT, elapsedNs / 1000000,
+				(CALL_COUNT * 1000000000L) / Math.max(elapsedNs, 1)));
+	}
+
+	private void benchEchoSimple(ipcTest client) {
+		Ref<BigInteger> out = new Ref<BigInteger>();
+		long startTimeNs = System.nanoTime();
+
+		for (int i = 0; i < CALL_COUNT; i++) {
+			BigInteger in = BigInteger.valueOf(i);
+
+			client.EchoSimple(in, out);
+			if (!in.equals(out.getValue())) {
+				throw new IllegalStateException("EchoSimple returned " + out.getValue() + " for " + in);
+			}
+		}
+
+		report("EchoSimple", startTimeNs);
+	}
+
+	private void benchEchoString(ipcTest client) {
+		Ref<String> out = new Ref<String>();
+		long startTimeNs = System.nanoTime();
+
+		for (int i = 0; i < CALL_COUNT; i++) {
+			client.EchoString(TEST_STRING, out);
+			if (!TEST_STRING.equals(out.getValue())) {
+				throw new IllegalStateException("EchoString returned " + out.getValue());
+			}
+		}
+
+		report("EchoString", startTimeNs);
+	}
+
+	@Override
+	public void componentInit() {
+		ipcTest client = getService(ipcTest.class);
+
+		benchEchoSimple(client);
+		benchEchoString(client);
+
+		System.exit(0);
+	}
+}
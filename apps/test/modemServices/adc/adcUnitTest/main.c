@@ -9,6 +9,122 @@
 #include "interfaces.h"
 #include "pa_adc_simu.h"
 #include "le_adc_interface.h"
+#include "le_adc_local.h"
+#include "sampler.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dummy config tree transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ConfigTxn;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_adc_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_adc_GetClientSessionRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [in] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [in] Handler function.
+    void*                           contextPtr  ///< [in] Opaque pointer value to pass to handler.
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateReadTxn
+(
+    const char* basePath    ///< [IN] Path to the location to create the new iterator.
+)
+{
+    return (le_cfg_IteratorRef_t)&ConfigTxn;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer from the config tree (STUBBED FUNCTION): the default value is always used.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef,   ///< [IN] Iterator to use as a basis for the transaction.
+    const char* path,                   ///< [IN] Path to the target node.
+    int32_t defaultValue                ///< [IN] Default value to use if the original can't be
+                                        ///<      read.
+)
+{
+    return defaultValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_CancelTxn
+(
+    le_cfg_IteratorRef_t iteratorRef    ///< [IN] Iterator of the transaction.
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling handlers, never called by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleThresholdHandlerFunc
+(
+    le_adc_SampleLevel_t level,
+    int32_t value,
+    void* contextPtr
+)
+{
+}
+
+static void SampleWindowHandlerFunc
+(
+    int32_t minValue,
+    int32_t maxValue,
+    int32_t avgValue,
+    void* contextPtr
+)
+{
+}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -36,6 +152,37 @@ static void Testle_adc_ReadValue
     LE_INFO("ADC value obtained = %d ", adcValuePtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: le_adc_AddSampleThresholdHandler(), le_adc_AddSampleWindowHandler() and their remove
+ * functions
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_adc_AddRemoveSampleHandlers
+(
+    void
+)
+{
+    const char adcName[] = "EXT_ADC1";
+    le_adc_SampleThresholdHandlerRef_t thresholdRef;
+    le_adc_SampleWindowHandlerRef_t windowRef;
+
+    // Invalid thresholds and window
+    LE_ASSERT(NULL == le_adc_AddSampleThresholdHandler(adcName, 10, 10, 0,
+                                                       SampleThresholdHandlerFunc, NULL));
+    LE_ASSERT(NULL == le_adc_AddSampleWindowHandler(adcName, 0, SampleWindowHandlerFunc, NULL));
+
+    thresholdRef = le_adc_AddSampleThresholdHandler(adcName, -10, 10, 1,
+                                                    SampleThresholdHandlerFunc, NULL);
+    LE_ASSERT(NULL != thresholdRef);
+    windowRef = le_adc_AddSampleWindowHandler(adcName, 4, SampleWindowHandlerFunc, NULL);
+    LE_ASSERT(NULL != windowRef);
+
+    le_adc_RemoveSampleThresholdHandler(thresholdRef);
+    le_adc_RemoveSampleWindowHandler(windowRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -49,11 +196,16 @@ COMPONENT_INIT
 
     // Init pa simu
     pa_adc_Init();
+    sampler_Init();
+    le_adc_Init();
     LE_INFO("======== UnitTest of ADC API Started ========");
 
     LE_INFO("========  Testle_adc_ReadValue Test ========");
     Testle_adc_ReadValue();
 
+    LE_INFO("========  Testle_adc_AddRemoveSampleHandlers Test ========");
+    Testle_adc_AddRemoveSampleHandlers();
+
     LE_INFO("======== UnitTest of ADC API FINISHED ========");
     exit(0);
 }
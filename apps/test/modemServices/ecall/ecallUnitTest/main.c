@@ -16,6 +16,7 @@
 #include "pa_ecall.h"
 #include "pa_ecall_simu.h"
 #include "mdmCfgEntries.h"
+#include "asn1Msd.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -249,6 +250,14 @@ static le_ecall_State_t     CurrentEcallState;
 //--------------------------------------------------------------------------------------------------
 static le_ecall_CallRef_t   CurrentEcallRef = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of MSD encodings used to measure the encoding latency, and maximum average latency
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_ENCODING_NB             10000
+#define MSD_ENCODING_MAX_LATENCY_US 50
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function for eCall state Notifications.
@@ -878,6 +887,110 @@ static void Testle_ecall_LoadMsd
     le_ecall_Delete(testECallRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: Encode MSD with a template of the static fields, and measure the encoding latency.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testmsd_EncodeMsdMessageWithTemplate
+(
+    void
+)
+{
+    // MSD version 2 encoded from the MSD data below
+    uint8_t expectedMsd[] = {0x02, 0x24, 0x1C, 0x06, 0x8D, 0xD5, 0x49, 0x70, 0xD6, 0x5C,
+                             0x35, 0x97, 0xCA, 0x04, 0x20, 0xC4, 0x14, 0x62, 0x0A, 0x8C,
+                             0x41, 0x59, 0xA4, 0x53, 0xEF, 0xEA, 0x44, 0x03, 0xCE, 0xBE,
+                             0x60, 0x2F, 0xFE, 0x00, 0x3E, 0xD0, 0xA0, 0x10};
+    uint8_t msd[LE_ECALL_MSD_MAX_LEN];
+    uint8_t fullMsd[LE_ECALL_MSD_MAX_LEN];
+    msd_Template_t msdTemplate;
+    msd_t msdData;
+    le_clk_Time_t startTime;
+    le_clk_Time_t duration;
+    uint64_t latencyUs;
+    int32_t msdLen;
+    int i;
+
+    LE_INFO("Start Testmsd_EncodeMsdMessageWithTemplate");
+
+    memset(&msdTemplate, 0, sizeof(msdTemplate));
+    memset(&msdData, 0, sizeof(msdData));
+    msdData.version = 2;
+    msdData.msdMsg.msdStruct.messageIdentifier = 1;
+    msdData.msdMsg.msdStruct.control.automaticActivation = true;
+    msdData.msdMsg.msdStruct.control.positionCanBeTrusted = true;
+    msdData.msdMsg.msdStruct.control.vehType = MSD_VEHICLE_COMMERCIAL_N1;
+    memcpy(&msdData.msdMsg.msdStruct.vehIdentificationNumber, "WM9VDSVDSYA123456",
+           sizeof(msdData.msdMsg.msdStruct.vehIdentificationNumber));
+    msdData.msdMsg.msdStruct.vehPropulsionStorageType.dieselTankPresent = true;
+    msdData.msdMsg.msdStruct.timestamp = 1367878452;
+    msdData.msdMsg.msdStruct.vehLocation.latitude = 176029000;
+    msdData.msdMsg.msdStruct.vehLocation.longitude = 7985100;
+    msdData.msdMsg.msdStruct.vehDirection = 5;
+    msdData.msdMsg.msdStruct.recentVehLocationN1Pres = true;
+    msdData.msdMsg.msdStruct.recentVehLocationN1.latitudeDelta = 511;
+    msdData.msdMsg.msdStruct.recentVehLocationN1.longitudeDelta = -512;
+    msdData.msdMsg.msdStruct.recentVehLocationN2Pres = true;
+    msdData.msdMsg.msdStruct.recentVehLocationN2.latitudeDelta = -10;
+    msdData.msdMsg.msdStruct.recentVehLocationN2.longitudeDelta = 20;
+    msdData.msdMsg.msdStruct.numberOfPassengersPres = true;
+    msdData.msdMsg.msdStruct.numberOfPassengers = 2;
+
+    // Check the MSD encoded with and without template
+    LE_ASSERT(sizeof(expectedMsd) == msd_EncodeMsdMessage(&msdData, fullMsd));
+    LE_ASSERT(0 == memcmp(fullMsd, expectedMsd, sizeof(expectedMsd)));
+    LE_ASSERT(sizeof(expectedMsd) ==
+              msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+    LE_ASSERT(0 == memcmp(msd, expectedMsd, sizeof(expectedMsd)));
+
+    // Update the dynamic fields: the template is used
+    for (i = 0; i < 100; i++)
+    {
+        msdData.msdMsg.msdStruct.messageIdentifier = i;
+        msdData.msdMsg.msdStruct.control.positionCanBeTrusted = (i % 2);
+        msdData.msdMsg.msdStruct.timestamp += 13;
+        msdData.msdMsg.msdStruct.vehLocation.latitude -= 1000003;
+        msdData.msdMsg.msdStruct.vehLocation.longitude += 999983;
+        msdData.msdMsg.msdStruct.vehDirection = i;
+
+        msdLen = msd_EncodeMsdMessage(&msdData, fullMsd);
+        LE_ASSERT(msdLen == msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+        LE_ASSERT(0 == memcmp(msd, fullMsd, msdLen));
+    }
+
+    // Update the static fields: the template is rebuilt
+    msdData.version = 1;
+    msdData.msdMsg.msdStruct.numberOfPassengersPres = false;
+    msdData.msdMsg.msdStruct.vehPropulsionStorageType.electricEnergyStorage = true;
+    memcpy(&msdData.msdMsg.msdStruct.vehIdentificationNumber, "VF37BRFVE12345678",
+           sizeof(msdData.msdMsg.msdStruct.vehIdentificationNumber));
+    msdLen = msd_EncodeMsdMessage(&msdData, fullMsd);
+    LE_ASSERT(msdLen == msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+    LE_ASSERT(0 == memcmp(msd, fullMsd, msdLen));
+
+    // Invalid VIN is rejected
+    msdData.msdMsg.msdStruct.vehIdentificationNumber.isowmi[0] = 'O';
+    LE_ASSERT(LE_FAULT == msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+    LE_ASSERT(LE_FAULT == msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+    msdData.msdMsg.msdStruct.vehIdentificationNumber.isowmi[0] = 'V';
+
+    // Measure the encoding latency when only the position and time change
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < MSD_ENCODING_NB; i++)
+    {
+        msdData.msdMsg.msdStruct.timestamp++;
+        msdData.msdMsg.msdStruct.vehLocation.latitude = (i * 1000) - 5000000;
+        LE_ASSERT(0 < msd_EncodeMsdMessageWithTemplate(&msdData, &msdTemplate, msd));
+    }
+    duration = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    latencyUs = ((((uint64_t)duration.sec * 1000000) + duration.usec) / MSD_ENCODING_NB);
+
+    LE_INFO("MSD encoding average latency: %"PRIu64" us", latencyUs);
+    LE_ASSERT(latencyUs <= MSD_ENCODING_MAX_LATENCY_US);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test: Create and start a manual eCall.
@@ -1024,6 +1137,8 @@ COMPONENT_INIT
     Testle_ecall_EraGlonassSettings();
     LE_INFO("======== LoadMsd Test  ========");
     Testle_ecall_LoadMsd();
+    LE_INFO("======== EncodeMsdMessageWithTemplate Test  ========");
+    Testmsd_EncodeMsdMessageWithTemplate();
     LE_INFO("======== StartManual Test  ========");
     Testle_ecall_StartManual();
     LE_INFO("======== StartTest Test  ========");
@@ -10,6 +10,7 @@
 #include "pa_simu.h"
 #include "pa_info_simu.h"
 #include "sysResets.h"
+#include "le_info_local.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -125,6 +126,7 @@ COMPONENT_INIT
     LE_INFO("le_info_GetBootloaderVersion get => %s", BootLoaderVersion);
     LE_ASSERT(le_info_GetBootloaderVersion(BootLoaderVersion, 2) == LE_OVERFLOW);
     LE_ASSERT_OK(le_info_GetBootloaderVersion(BootLoaderVersion, sizeof(BootLoaderVersion)));
+    le_info_ClearIdentityCache();
     pa_infoSimu_SetErrorCase(LE_NOT_FOUND);
     LE_ASSERT(le_info_GetBootloaderVersion
                              (BootLoaderVersion, sizeof(BootLoaderVersion)) == LE_NOT_FOUND);
@@ -137,6 +139,7 @@ COMPONENT_INIT
     LE_INFO("le_info_GetFirmwareVersion get => %s", FirmwareVersion);
     LE_ASSERT(le_info_GetFirmwareVersion(FirmwareVersion, 2) == LE_OVERFLOW);
     LE_ASSERT_OK(le_info_GetFirmwareVersion(FirmwareVersion,sizeof(FirmwareVersion)));
+    le_info_ClearIdentityCache();
     pa_infoSimu_SetErrorCase(LE_NOT_FOUND);
     LE_ASSERT(le_info_GetFirmwareVersion(FirmwareVersion, sizeof(FirmwareVersion)) == LE_NOT_FOUND);
     pa_infoSimu_ResetErrorCase();
@@ -196,6 +199,7 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetManufacturerName(MfrName, sizeof(MfrName)));
     LE_INFO("le_info_GetManufacturerName get => %s", MfrName);
     LE_ASSERT(le_info_GetManufacturerName(MfrName, 1) == LE_OVERFLOW);
+    le_info_ClearIdentityCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetManufacturerName(MfrName, sizeof(MfrName)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -213,6 +217,7 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetSku(Sku, sizeof(Sku)));
     LE_INFO("le_info_GetSku get => %s", Sku);
     LE_ASSERT(le_info_GetSku(Sku, 1) == LE_OVERFLOW);
+    le_info_ClearIdentityCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetSku(Sku, sizeof(Sku)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
@@ -221,10 +226,69 @@ COMPONENT_INIT
     LE_ASSERT_OK(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)));
     LE_INFO("le_info_GetPlatformSerialNumber get => %s", Psn);
     LE_ASSERT(le_info_GetPlatformSerialNumber(Psn, 1) == LE_OVERFLOW);
+    le_info_ClearIdentityCache();
     pa_infoSimu_SetErrorCase(LE_FAULT);
     LE_ASSERT(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)) == LE_FAULT);
     pa_infoSimu_ResetErrorCase();
 
+    LE_INFO("======== IdentityCacheTest ========");
+    // Once read, identity fields are served from the cache even if the PA starts failing.
+    LE_ASSERT_OK(le_info_GetSku(Sku, sizeof(Sku)));
+    LE_ASSERT_OK(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)));
+    pa_infoSimu_SetErrorCase(LE_FAULT);
+    LE_ASSERT_OK(le_info_GetSku(Sku, sizeof(Sku)));
+    LE_ASSERT_OK(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)));
+    LE_ASSERT(le_info_GetPlatformSerialNumber(Psn, 1) == LE_OVERFLOW);
+    le_info_ClearIdentityCache();
+    LE_ASSERT(le_info_GetSku(Sku, sizeof(Sku)) == LE_FAULT);
+    pa_infoSimu_ResetErrorCase();
+
+    LE_INFO("======== GetDeviceIdentityTest ========");
+    {
+        char imei[LE_INFO_IMEI_MAX_BYTES];
+        char imeiSv[LE_INFO_IMEISV_MAX_BYTES];
+        char model[LE_INFO_MAX_MODEL_BYTES];
+        char firmwareVersion[LE_INFO_MAX_VERS_BYTES];
+        char bootloaderVersion[LE_INFO_MAX_VERS_BYTES];
+        char mfrName[LE_INFO_MAX_MFR_NAME_BYTES];
+        char skuId[LE_INFO_MAX_SKU_BYTES];
+        char psn[LE_INFO_MAX_PSN_BYTES];
+
+        LE_ASSERT_OK(le_info_GetDeviceIdentity(imei, sizeof(imei),
+                                               imeiSv, sizeof(imeiSv),
+                                               model, sizeof(model),
+                                               firmwareVersion, sizeof(firmwareVersion),
+                                               bootloaderVersion, sizeof(bootloaderVersion),
+                                               mfrName, sizeof(mfrName),
+                                               skuId, sizeof(skuId),
+                                               psn, sizeof(psn)));
+        LE_ASSERT_OK(le_info_GetImei(Imei, sizeof(Imei)));
+        LE_ASSERT(0 == strcmp(imei, Imei));
+        LE_ASSERT_OK(le_info_GetImeiSv(ImeiSv, sizeof(ImeiSv)));
+        LE_ASSERT(0 == strcmp(imeiSv, ImeiSv));
+        LE_ASSERT_OK(le_info_GetDeviceModel(ModelDevice, sizeof(ModelDevice)));
+        LE_ASSERT(0 == strcmp(model, ModelDevice));
+        LE_ASSERT_OK(le_info_GetFirmwareVersion(FirmwareVersion, sizeof(FirmwareVersion)));
+        LE_ASSERT(0 == strcmp(firmwareVersion, FirmwareVersion));
+        LE_ASSERT_OK(le_info_GetBootloaderVersion(BootLoaderVersion, sizeof(BootLoaderVersion)));
+        LE_ASSERT(0 == strcmp(bootloaderVersion, BootLoaderVersion));
+        LE_ASSERT_OK(le_info_GetManufacturerName(MfrName, sizeof(MfrName)));
+        LE_ASSERT(0 == strcmp(mfrName, MfrName));
+        LE_ASSERT_OK(le_info_GetSku(Sku, sizeof(Sku)));
+        LE_ASSERT(0 == strcmp(skuId, Sku));
+        LE_ASSERT_OK(le_info_GetPlatformSerialNumber(Psn, sizeof(Psn)));
+        LE_ASSERT(0 == strcmp(psn, Psn));
+
+        LE_ASSERT(le_info_GetDeviceIdentity(imei, sizeof(imei),
+                                            imeiSv, sizeof(imeiSv),
+                                            model, sizeof(model),
+                                            firmwareVersion, sizeof(firmwareVersion),
+                                            bootloaderVersion, sizeof(bootloaderVersion),
+                                            mfrName, sizeof(mfrName),
+                                            skuId, 1,
+                                            psn, sizeof(psn)) == LE_OVERFLOW);
+    }
+
     LE_INFO("======== GetRfDeviceStatusTest ========");
     pa_infoSimu_SetErrorCase(LE_UNSUPPORTED);
     LE_ASSERT(le_info_GetRfDeviceStatus(ManufacturedIdPtr,
@@ -11,6 +11,7 @@
 #include "log.h"
 #include "pa_ips.h"
 #include "pa_ips_simu.h"
+#include "sampler.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -43,6 +44,145 @@
 //--------------------------------------------------------------------------------------------------
 #define TEST_IPS_EXT_BATTERY_LEVEL          100
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling period returned by the config tree stub, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SAMPLING_PERIOD_MS             10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling thresholds and window for tests
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SAMPLE_LOW_THRESHOLD           3500
+#define TEST_SAMPLE_HIGH_THRESHOLD          4000
+#define TEST_SAMPLE_HYSTERESIS              100
+#define TEST_SAMPLE_WINDOW                  5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Input voltages successively sampled by the sampling test.  With the thresholds above, 3950 mV
+ * stays high because of the hysteresis.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t SampledVoltages[TEST_SAMPLE_WINDOW] = { 3900, 4100, 3950, 3850, 3400 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Levels and values expected from the SampleThreshold handler for SampledVoltages.
+ */
+//--------------------------------------------------------------------------------------------------
+static const le_ips_SampleLevel_t ExpectedLevels[] =
+{
+    LE_IPS_SAMPLE_LEVEL_NORMAL, LE_IPS_SAMPLE_LEVEL_HIGH, LE_IPS_SAMPLE_LEVEL_NORMAL,
+    LE_IPS_SAMPLE_LEVEL_LOW
+};
+static const uint32_t ExpectedLevelVoltages[] = { 3900, 4100, 3850, 3400 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the sampling test.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SampleIndex;
+static size_t LevelCount;
+static size_t WindowCount;
+static le_ips_SampleThresholdHandlerRef_t SampleThresholdRef;
+static le_ips_SampleWindowHandlerRef_t SampleWindowRef;
+static le_ips_SampleWindowHandlerRef_t SampleStepRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dummy config tree transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ConfigTxn;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_ips_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_ips_GetClientSessionRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [in] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [in] Handler function.
+    void*                           contextPtr  ///< [in] Opaque pointer value to pass to handler.
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateReadTxn
+(
+    const char* basePath    ///< [IN] Path to the location to create the new iterator.
+)
+{
+    return (le_cfg_IteratorRef_t)&ConfigTxn;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer from the config tree (STUBBED FUNCTION): only the sampling period is read.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef,   ///< [IN] Iterator to use as a basis for the transaction.
+    const char* path,                   ///< [IN] Path to the target node.
+    int32_t defaultValue                ///< [IN] Default value to use if the original can't be
+                                        ///<      read.
+)
+{
+    return TEST_SAMPLING_PERIOD_MS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_CancelTxn
+(
+    le_cfg_IteratorRef_t iteratorRef    ///< [IN] Iterator of the transaction.
+)
+{
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -234,6 +374,126 @@ static void Testle_ips_SetBatteryLevel
     LE_ASSERT(LE_IPS_POWER_SOURCE_BATTERY == powerSource);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * SampleThreshold handler of the sampling test
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleThresholdHandlerFunc
+(
+    le_ips_SampleLevel_t level,
+    uint32_t value,
+    void* contextPtr
+)
+{
+    LE_INFO("Sampled level %d at %"PRIu32" mV", level, value);
+    LE_ASSERT(LevelCount < NUM_ARRAY_MEMBERS(ExpectedLevels));
+    LE_ASSERT(ExpectedLevels[LevelCount] == level);
+    LE_ASSERT(ExpectedLevelVoltages[LevelCount] == value);
+    LevelCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SampleWindow handler of the sampling test
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleWindowHandlerFunc
+(
+    uint32_t minValue,
+    uint32_t maxValue,
+    uint32_t avgValue,
+    void* contextPtr
+)
+{
+    LE_INFO("Sampled window: min %"PRIu32", max %"PRIu32", avg %"PRIu32" mV",
+            minValue, maxValue, avgValue);
+    LE_ASSERT(3400 == minValue);
+    LE_ASSERT(4100 == maxValue);
+    LE_ASSERT(3840 == avgValue);
+    WindowCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One-sample window handler driving the sampling test: checks each sample and sets the voltage
+ * of the next one.  Ends the test on the sample following the last step, once every other handler
+ * has seen the whole sequence.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleStepHandlerFunc
+(
+    uint32_t minValue,
+    uint32_t maxValue,
+    uint32_t avgValue,
+    void* contextPtr
+)
+{
+    if (SampleIndex < TEST_SAMPLE_WINDOW)
+    {
+        LE_ASSERT(SampledVoltages[SampleIndex] == minValue);
+        LE_ASSERT(minValue == maxValue);
+        LE_ASSERT(minValue == avgValue);
+
+        SampleIndex++;
+        if (SampleIndex < TEST_SAMPLE_WINDOW)
+        {
+            pa_ipsSimu_SetInputVoltage(SampledVoltages[SampleIndex]);
+        }
+        return;
+    }
+
+    LE_ASSERT(NUM_ARRAY_MEMBERS(ExpectedLevels) == LevelCount);
+    LE_ASSERT(1 == WindowCount);
+
+    le_ips_RemoveSampleThresholdHandler(SampleThresholdRef);
+    le_ips_RemoveSampleWindowHandler(SampleWindowRef);
+    le_ips_RemoveSampleWindowHandler(SampleStepRef);
+
+    LE_INFO("======== UnitTest of IPS API ends with SUCCESS ========");
+
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: le_ips_AddSampleThresholdHandler(), le_ips_AddSampleWindowHandler()
+ *
+ * The test goes on in the event loop, and ends the process once all the samples are checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_ips_Sampling
+(
+    void
+)
+{
+    LE_INFO("======== Testle_ips_Sampling Test ========");
+
+    LE_ASSERT(NULL == le_ips_AddSampleThresholdHandler(TEST_SAMPLE_HIGH_THRESHOLD,
+                                                       TEST_SAMPLE_LOW_THRESHOLD,
+                                                       TEST_SAMPLE_HYSTERESIS,
+                                                       SampleThresholdHandlerFunc,
+                                                       NULL));
+    LE_ASSERT(NULL == le_ips_AddSampleWindowHandler(0, SampleWindowHandlerFunc, NULL));
+
+    pa_ipsSimu_SetInputVoltage(SampledVoltages[0]);
+
+    SampleThresholdRef = le_ips_AddSampleThresholdHandler(TEST_SAMPLE_LOW_THRESHOLD,
+                                                          TEST_SAMPLE_HIGH_THRESHOLD,
+                                                          TEST_SAMPLE_HYSTERESIS,
+                                                          SampleThresholdHandlerFunc,
+                                                          NULL);
+    LE_ASSERT(NULL != SampleThresholdRef);
+
+    SampleWindowRef = le_ips_AddSampleWindowHandler(TEST_SAMPLE_WINDOW,
+                                                    SampleWindowHandlerFunc,
+                                                    NULL);
+    LE_ASSERT(NULL != SampleWindowRef);
+
+    SampleStepRef = le_ips_AddSampleWindowHandler(1, SampleStepHandlerFunc, NULL);
+    LE_ASSERT(NULL != SampleStepRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -243,6 +503,7 @@ static void Testle_ips_SetBatteryLevel
 COMPONENT_INIT
 {
     pa_ipsSimu_Init();
+    sampler_Init();
     le_ips_Init();
 
     LE_INFO("======== Start UnitTest of IPS API ========");
@@ -253,8 +514,5 @@ COMPONENT_INIT
     Testle_ips_GetPowerSource();
     Testle_ips_GetBatteryLevel();
     Testle_ips_SetBatteryLevel();
-
-    LE_INFO("======== UnitTest of IPS API ends with SUCCESS ========");
-
-    exit(EXIT_SUCCESS);
+    Testle_ips_Sampling();
 }
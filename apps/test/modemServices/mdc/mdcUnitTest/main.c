@@ -94,6 +94,32 @@ le_msg_SessionRef_t le_sim_GetClientSessionRef
     return _ClientSessionRef;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_mdc_GetServiceRef
+(
+    void
+)
+{
+    return _ServerServiceRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_mdc_GetClientSessionRef
+(
+    void
+)
+{
+    return _ClientSessionRef;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SIM Refresh handler: this handler is called on STK event
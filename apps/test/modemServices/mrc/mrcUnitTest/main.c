@@ -244,6 +244,39 @@ void Testle_mrc_SignalTest
     LE_ASSERT(quality != 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/*
+ * MRC Signal snapshot Test
+ * APIs tested:
+ * - le_mrc_GetSignalSnapshot()
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_mrc_SignalSnapshotTest
+(
+    void
+)
+{
+    le_mrc_ServingSignalMetrics_t serving;
+    le_mrc_NeighborCellMetrics_t  neighbors[LE_MRC_SNAPSHOT_MAX_NEIGHBORS];
+    size_t                        neighborsCount = NUM_ARRAY_MEMBERS(neighbors);
+    le_mrc_MetricsRef_t           metricsRef = le_mrc_MeasureSignalMetrics();
+
+    if (NULL == metricsRef)
+    {
+        LE_ASSERT(LE_FAULT == le_mrc_GetSignalSnapshot(&serving, neighbors, &neighborsCount));
+        LE_ASSERT(0 == neighborsCount);
+        return;
+    }
+
+    LE_ASSERT_OK(le_mrc_GetSignalSnapshot(&serving, neighbors, &neighborsCount));
+    LE_ASSERT(serving.rat == le_mrc_GetRatOfSignalMetrics(metricsRef));
+    LE_ASSERT(serving.quality <= 5);
+    LE_ASSERT(neighborsCount <= LE_MRC_SNAPSHOT_MAX_NEIGHBORS);
+
+    le_mrc_DeleteSignalMetrics(metricsRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /*
  * MRC RAT in use test
@@ -1149,6 +1182,8 @@ static void* TestThread
     Testle_mrc_RegisterTest();
     LE_INFO("======== MRC Signal Test ========");
     Testle_mrc_SignalTest();
+    LE_INFO("======== MRC Signal snapshot Test ========");
+    Testle_mrc_SignalSnapshotTest();
     LE_INFO("======== MRC RAT In use Test ========");
     Testle_mrc_RatInUseTest();
     LE_INFO("======== MRC Band Preferences Test ========");
@@ -1482,6 +1482,76 @@ static void TestSim_ApduOnLogicalChannel
     LE_ASSERT_OK(le_sim_CloseLogicalChannel(channel));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the response of a queued APDU
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApduResponseHandler
+(
+    le_sim_Id_t    simId,
+    le_result_t    result,
+    const uint8_t* responseApduPtr,
+    size_t         responseApduNumElements,
+    void*          contextPtr
+)
+{
+    uint8_t expectedResult[] = {0x90, 0x00};
+
+    LE_ASSERT(simId == CurrentSimId);
+    LE_ASSERT((le_result_t)(intptr_t)contextPtr == result);
+
+    if (LE_OK == result)
+    {
+        LE_ASSERT(responseApduNumElements == sizeof(expectedResult));
+        LE_ASSERT(0 == memcmp(responseApduPtr, expectedResult, responseApduNumElements));
+    }
+    else
+    {
+        LE_ASSERT(0 == responseApduNumElements);
+    }
+
+    le_sem_Post(ThreadSemaphore);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test queued APDUs
+ *
+ * API tested:
+ * - le_sim_QueueApdu
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSim_QueueApdu
+(
+    void
+)
+{
+    uint8_t apdu[] = {0x00, 0xA4, 0x00, 0x0C, 0x02, 0x6F, 0x07};
+    int i;
+
+    pa_simSimu_SetSIMAccessTest(true);
+
+    le_sim_QueueApdu(CurrentSimId, 0, apdu, LE_SIM_APDU_MAX_BYTES+1, ApduResponseHandler,
+                     (void*)(intptr_t)LE_BAD_PARAMETER);
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, TimeToWait));
+
+    for (i = 0; i < 3; i++)
+    {
+        le_sim_QueueApdu(CurrentSimId, 0, apdu, sizeof(apdu), ApduResponseHandler,
+                         (void*)(intptr_t)LE_OK);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, TimeToWait));
+    }
+
+    pa_simSimu_SetSIMAccessTest(false);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test Read / write FPLMN list
@@ -1621,6 +1691,9 @@ static void* TestThread
     LE_INFO("======== APDU on logical channel Test  ========");
     TestSim_ApduOnLogicalChannel();
 
+    LE_INFO("======== Queued APDU Test  ========");
+    TestSim_QueueApdu();
+
     LE_INFO("======== Handlers removal Test  ========");
     TestSim_RemoveHandlers();
 
@@ -122,4 +122,21 @@ void le_cfg_SetString
 )
 {
     memcpy(Iccid, valuePtr, LE_SIM_ICCID_BYTES);
-};
\ No newline at end of file
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a signed integer value from the config tree.
+ *
+ * @return This function will return the default value.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef, ///< [IN] Iterator to use as a basis for the transaction
+    const char* pathPtr,              ///< [IN] Path to the target node
+    int32_t defaultValue              ///< [IN] Default value to use if the original can't be read
+)
+{
+    return defaultValue;
+}
@@ -15,6 +15,9 @@
 
 #define PDU_MAX     256
 
+/// Number of encodings and decodings timed for each PDU by Bench7BitsPdu().
+#define BENCH_LOOPS 10000
+
 
 typedef struct
 {
@@ -2097,12 +2100,172 @@ static le_result_t TestEncodePdu
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode the first part of a concatenated message, in 7 and 8 bits, and check it against the
+ * reference PDUs: the septets follow the User Data Header after one fill bit.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t TestEncodeConcatPdu
+(
+    void
+)
+{
+    static const uint8_t pdu7Bits[] =
+    {
+        0x00, 0x51, 0x00, 0x0B, 0x91, 0x33, 0x66, 0x61, 0x15, 0x68,
+        0xF6, 0x00, 0x00, 0xAD, 0x1B, 0x05, 0x00, 0x03, 0x5A, 0x02,
+        0x01, 0xA8, 0xE5, 0x39, 0x1D, 0x34, 0x2F, 0xBB, 0xC9, 0x69,
+        0xF7, 0x19, 0xD4, 0x2E, 0xCF, 0xE7, 0xE1, 0x73, 0x19,
+    };
+    static const uint8_t pdu8Bits[] =
+    {
+        0x00, 0x51, 0x00, 0x0B, 0x91, 0x33, 0x66, 0x61, 0x15, 0x68,
+        0xF6, 0x00, 0x04, 0xAD, 0x1A, 0x05, 0x00, 0x03, 0x5A, 0x02,
+        0x01, 0x54, 0x65, 0x73, 0x74, 0x20, 0x73, 0x65, 0x6E, 0x64,
+        0x69, 0x6E, 0x67, 0x20, 0x6D, 0x65, 0x73, 0x73, 0x61, 0x67,
+        0x65,
+    };
+    const char* textPtr = "Test sending message";
+    char longText[SMSPDU_CONCAT_7BITS_MAX_LEN + 1];
+    pa_sms_Pdu_t pdu;
+    smsPdu_DataToEncode_t data;
+
+    memset(&data, 0, sizeof(data));
+    data.protocol = PA_SMS_PROTOCOL_GSM;
+    data.messagePtr = (const uint8_t*)textPtr;
+    data.length = strlen(textPtr);
+    data.addressPtr = "+33661651866";
+    data.encoding = SMSPDU_7_BITS;
+    data.messageType = PA_SMS_SUBMIT;
+    data.concatCount = 2;
+    data.concatSeq = 1;
+    data.concatRef = 0x5A;
+
+    if ((smsPdu_Encode(&data, &pdu) != LE_OK) || (pdu.dataLen != sizeof(pdu7Bits)) ||
+        (memcmp(pdu.data, pdu7Bits, pdu.dataLen) != 0))
+    {
+        LE_ERROR("7 bits concatenated PDU differs from the reference");
+        return LE_FAULT;
+    }
+
+    data.encoding = SMSPDU_8_BITS;
+
+    if ((smsPdu_Encode(&data, &pdu) != LE_OK) || (pdu.dataLen != sizeof(pdu8Bits)) ||
+        (memcmp(pdu.data, pdu8Bits, pdu.dataLen) != 0))
+    {
+        LE_ERROR("8 bits concatenated PDU differs from the reference");
+        return LE_FAULT;
+    }
+
+    // Escaped characters take two septets: at most 76 of them fit in a part.
+    memset(longText, '[', SMSPDU_CONCAT_7BITS_MAX_LEN);
+    longText[SMSPDU_CONCAT_7BITS_MAX_LEN] = '\0';
+
+    if (smsPdu_Get7BitsSplitLength((const uint8_t*)longText, strlen(longText),
+                                   SMSPDU_CONCAT_7BITS_MAX_LEN) != 76)
+    {
+        LE_ERROR("Wrong split of a text of escaped characters");
+        return LE_FAULT;
+    }
+
+    data.encoding = SMSPDU_7_BITS;
+    data.messagePtr = (const uint8_t*)longText;
+    data.length = 77;
+
+    if (smsPdu_Encode(&data, &pdu) != LE_OVERFLOW)
+    {
+        LE_ERROR("Too long concatenated part encoded");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /*
  * SMS PDU encoding and decoding test
  *
  */
 //--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+/**
+ * Micro-benchmark of the GSM 7 bits packing: encode and decode the 7 bits PDUs of the test table
+ * many times, checking that each result stays bit-exact with the reference PDU.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Bench7BitsPdu
+(
+    void
+)
+{
+    pa_sms_Pdu_t pdu;
+    pa_sms_Message_t message;
+    smsPdu_DataToEncode_t data;
+    int i;
+
+    for (i = 0; i < sizeof(PduAssocDb)/sizeof(PduAssoc_t); i++)
+    {
+        const PduAssoc_t * assoc = &PduAssocDb[i];
+        le_clk_Time_t start;
+        le_clk_Time_t elapsed;
+        int loop;
+
+        if (assoc->gsm_7bits.conversionResult != LE_OK)
+        {
+            continue;
+        }
+
+        memset(&data, 0, sizeof(data));
+        data.protocol = PA_SMS_PROTOCOL_GSM;
+        data.messagePtr = (const uint8_t*)assoc->text;
+        data.length = strlen(assoc->text);
+        data.addressPtr = assoc->dest;
+        data.encoding = SMSPDU_7_BITS;
+        data.messageType = assoc->type;
+        data.statusReport = assoc->statusReportEnabled;
+
+        start = le_clk_GetRelativeTime();
+        for (loop = 0; loop < BENCH_LOOPS; loop++)
+        {
+            if ((smsPdu_Encode(&data, &pdu) != LE_OK) ||
+                (pdu.dataLen != assoc->gsm_7bits.length) ||
+                (memcmp(pdu.data, assoc->gsm_7bits.data, pdu.dataLen) != 0))
+            {
+                LE_ERROR("Index %d: encoded PDU differs from the reference", i);
+                return LE_FAULT;
+            }
+        }
+        elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+        LE_INFO("Index %d: %zu chars encoded in %.2f us", i, data.length,
+                ((double)elapsed.sec * 1000000 + elapsed.usec) / BENCH_LOOPS);
+
+        start = le_clk_GetRelativeTime();
+        for (loop = 0; loop < BENCH_LOOPS; loop++)
+        {
+            if (smsPdu_Decode(PA_SMS_PROTOCOL_GSM, assoc->gsm_7bits.data, assoc->gsm_7bits.length,
+                              true, &message) != LE_OK)
+            {
+                LE_ERROR("Index %d: reference PDU not decoded", i);
+                return LE_FAULT;
+            }
+        }
+        elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+        LE_INFO("Index %d: %zu chars decoded in %.2f us", i, data.length,
+                ((double)elapsed.sec * 1000000 + elapsed.usec) / BENCH_LOOPS);
+
+        if (memcmp((message.type == PA_SMS_DELIVER) ? message.smsDeliver.data :
+                                                      message.smsSubmit.data,
+                   assoc->text, data.length) != 0)
+        {
+            LE_ERROR("Index %d: decoded text differs from the reference", i);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
 void testle_sms_SmsPduTest
 (
     void
@@ -2114,5 +2277,11 @@ void testle_sms_SmsPduTest
     LE_INFO("Test DecodePdu started");
     LE_ASSERT_OK(TestDecodePdu());
 
+    LE_INFO("Test EncodeConcatPdu started");
+    LE_ASSERT_OK(TestEncodeConcatPdu());
+
+    LE_INFO("Bench 7 bits PDU started");
+    LE_ASSERT_OK(Bench7BitsPdu());
+
     LE_INFO("smsPduTest SUCCESS");
 }
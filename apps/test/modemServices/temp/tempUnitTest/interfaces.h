@@ -1,4 +1,5 @@
 #include "le_temp_interface.h"
+#include "le_cfg_interface.h"
 
 #undef LE_KILL_CLIENT
 #define LE_KILL_CLIENT LE_ERROR
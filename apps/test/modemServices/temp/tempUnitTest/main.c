@@ -10,6 +10,7 @@
 #include "pa_temp.h"
 #include "pa_temp_simu.h"
 #include "le_temp_local.h"
+#include "sampler.h"
 
 #define NB_CLIENT 2
 
@@ -30,6 +31,20 @@ static AppContext_t AppCtx[NB_CLIENT];
 static le_clk_Time_t TimeToWait ={ 0, 1000000 };
 static char ExpectedThreshold[LE_TEMP_THRESHOLD_NAME_MAX_BYTES];
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling period returned by the config tree stub, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SAMPLING_PERIOD_MS             10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dummy config tree transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ConfigTxn;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Server Service Reference
@@ -87,6 +102,47 @@ le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateReadTxn
+(
+    const char* basePath    ///< [IN] Path to the location to create the new iterator.
+)
+{
+    return (le_cfg_IteratorRef_t)&ConfigTxn;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer from the config tree (STUBBED FUNCTION): only the sampling period is read.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef,   ///< [IN] Iterator to use as a basis for the transaction.
+    const char* path,                   ///< [IN] Path to the target node.
+    int32_t defaultValue                ///< [IN] Default value to use if the original can't be
+                                        ///<      read.
+)
+{
+    return TEST_SAMPLING_PERIOD_MS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a read transaction on the config tree (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_CancelTxn
+(
+    le_cfg_IteratorRef_t iteratorRef    ///< [IN] Iterator of the transaction.
+)
+{
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Synchronize test threads and tasks
@@ -191,6 +247,7 @@ static void* TempThread
 {
     pa_temp_Init();
 
+    sampler_Init();
     le_temp_Init();
 
     le_sem_Post(ThreadSemaphore);
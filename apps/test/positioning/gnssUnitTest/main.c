@@ -438,6 +438,83 @@ static void Testle_gnss_SetDataResolution
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: API testing for le_gnss_GetSample().
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef
+)
+{
+    le_gnss_SampleDataBitMask_t allData = LE_GNSS_SAMPLE_LOCATION
+                                          | LE_GNSS_SAMPLE_ALTITUDE
+                                          | LE_GNSS_SAMPLE_ALTITUDE_ON_WGS84
+                                          | LE_GNSS_SAMPLE_DATE
+                                          | LE_GNSS_SAMPLE_TIME
+                                          | LE_GNSS_SAMPLE_EPOCH_TIME
+                                          | LE_GNSS_SAMPLE_GPS_TIME
+                                          | LE_GNSS_SAMPLE_TIME_ACCURACY
+                                          | LE_GNSS_SAMPLE_HORIZONTAL_SPEED
+                                          | LE_GNSS_SAMPLE_VERTICAL_SPEED
+                                          | LE_GNSS_SAMPLE_DIRECTION
+                                          | LE_GNSS_SAMPLE_DOP
+                                          | LE_GNSS_SAMPLE_MAGNETIC_DEVIATION
+                                          | LE_GNSS_SAMPLE_SATELLITES_STATUS;
+    le_gnss_SampleDataBitMask_t validMask;
+    le_gnss_SampleData_t sample;
+    le_gnss_FixState_t state;
+    le_result_t result;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t hAccuracy;
+    int32_t altitude;
+    int32_t vAccuracy;
+    uint32_t hSpeed;
+    uint32_t hSpeedAccuracy;
+    uint16_t pdop;
+
+    // Get all the data and compare them with the dedicated functions
+    result = le_gnss_GetSample(positionSampleRef, allData, &sample, &validMask);
+    LE_ASSERT((LE_OK == result) || (LE_OUT_OF_RANGE == result));
+    LE_ASSERT((LE_OK == result) == (allData == validMask));
+
+    LE_ASSERT_OK(le_gnss_GetPositionState(positionSampleRef, &state));
+    LE_ASSERT(state == sample.fixState);
+
+    result = le_gnss_GetLocation(positionSampleRef, &latitude, &longitude, &hAccuracy);
+    LE_ASSERT((LE_OK == result) == ((validMask & LE_GNSS_SAMPLE_LOCATION) != 0));
+    LE_ASSERT((latitude == sample.latitude) && (longitude == sample.longitude)
+              && (hAccuracy == sample.hAccuracy));
+
+    result = le_gnss_GetAltitude(positionSampleRef, &altitude, &vAccuracy);
+    LE_ASSERT((LE_OK == result) == ((validMask & LE_GNSS_SAMPLE_ALTITUDE) != 0));
+    LE_ASSERT((altitude == sample.altitude) && (vAccuracy == sample.vAccuracy));
+
+    result = le_gnss_GetHorizontalSpeed(positionSampleRef, &hSpeed, &hSpeedAccuracy);
+    LE_ASSERT((LE_OK == result) == ((validMask & LE_GNSS_SAMPLE_HORIZONTAL_SPEED) != 0));
+    LE_ASSERT((hSpeed == sample.hSpeed) && (hSpeedAccuracy == sample.hSpeedAccuracy));
+
+    result = le_gnss_GetDilutionOfPrecision(positionSampleRef, LE_GNSS_PDOP, &pdop);
+    LE_ASSERT(pdop == sample.pdop);
+
+    // Get a subset of the data: the other ones are not retrieved
+    result = le_gnss_GetSample(positionSampleRef, LE_GNSS_SAMPLE_LOCATION, &sample, &validMask);
+    LE_ASSERT((LE_OK == result) || (LE_OUT_OF_RANGE == result));
+    LE_ASSERT(0 == (validMask & ~LE_GNSS_SAMPLE_LOCATION));
+    LE_ASSERT(latitude == sample.latitude);
+    LE_ASSERT((0 == sample.altitude) && (0 == sample.hSpeed) && (0 == sample.pdop));
+
+    // No data selected: only the fix state is returned
+    LE_ASSERT_OK(le_gnss_GetSample(positionSampleRef, 0, &sample, &validMask));
+    LE_ASSERT(0 == validMask);
+    LE_ASSERT(state == sample.fixState);
+
+    // Pass invalid sample reference
+    LE_ASSERT(LE_FAULT == le_gnss_GetSample(GnssPositionSampleRef, allData, &sample, &validMask));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function for Position Notifications.
@@ -659,6 +736,9 @@ static void GnssPositionHandlerFunction
                                         &satElevNumElements);
     LE_ASSERT((LE_OK == result) || (LE_OUT_OF_RANGE == result));
 
+    LE_INFO("======== GNSS GetSample ========");
+    Testle_gnss_GetSample(positionSampleRef);
+
     LE_INFO("======== GNSS SetGetDOPResolution ========");
     Testle_gnss_SetGetDOPResolution(positionSampleRef);
 
@@ -1028,6 +1028,56 @@ static void Testle_pos_RemoveMovementHandler
     le_thread_Cancel(NavigationThreadRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tested API: le_pos_GetHistory()
+ *
+ * Verify that the position fixes reported during the test are recorded in the history. This
+ * function is queued to the thread which requested the positioning activation, so it runs after
+ * that thread has handled the reported fixes.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_pos_GetHistory
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_pos_HistorySample_t samples[LE_POS_HISTORY_MAX_LEN];
+    size_t samplesNb = LE_POS_HISTORY_MAX_LEN;
+    int32_t latitude, longitude, hAccuracy;
+
+    // Two fixes are reported by Testle_pos_AddMovementHandler and
+    // Testle_pos_RemoveMovementHandler
+    LE_ASSERT_OK(le_pos_GetHistory(0, samples, &samplesNb));
+    LE_ASSERT(2 == samplesNb);
+    LE_ASSERT(1 == samples[0].sequence);
+    LE_ASSERT(2 == samples[1].sequence);
+
+    LE_ASSERT_OK(le_pos_Get2DLocation(&latitude, &longitude, &hAccuracy));
+    LE_ASSERT(latitude == samples[1].latitude);
+    LE_ASSERT(longitude == samples[1].longitude);
+
+    // Only the fixes recorded after the given sequence number are returned
+    samplesNb = LE_POS_HISTORY_MAX_LEN;
+    LE_ASSERT_OK(le_pos_GetHistory(1, samples, &samplesNb));
+    LE_ASSERT(1 == samplesNb);
+    LE_ASSERT(2 == samples[0].sequence);
+
+    samplesNb = LE_POS_HISTORY_MAX_LEN;
+    LE_ASSERT_OK(le_pos_GetHistory(2, samples, &samplesNb));
+    LE_ASSERT(0 == samplesNb);
+
+    // The number of returned fixes is limited by the caller's buffer
+    samplesNb = 1;
+    LE_ASSERT_OK(le_pos_GetHistory(0, samples, &samplesNb));
+    LE_ASSERT(1 == samplesNb);
+    LE_ASSERT(1 == samples[0].sequence);
+
+    le_sem_Post(InitSemaphore);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * UnitTestInit thread: this function initializes the test and runs an eventLoop
@@ -1041,7 +1091,7 @@ static void* UnitTestInit
 {
     Testle_pos_AddMovementHandler();
     Testle_pos_RemoveMovementHandler();
-    le_sem_Post(InitSemaphore);
+    le_event_QueueFunction(Testle_pos_GetHistory, NULL, NULL);
     le_event_RunLoop();
 }
 
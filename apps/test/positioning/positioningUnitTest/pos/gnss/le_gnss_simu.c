@@ -1489,6 +1489,85 @@ le_result_t le_gnss_GetMagneticDeviation
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position sample's fix state and the selected data in a single call.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OUT_OF_RANGE  At least one of the selected data is invalid.
+ *  - LE_OK            Function succeeded, all the selected data are valid.
+ *
+ * @note The simulated sample has no epoch time, it is never reported valid.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_SampleDataBitMask_t dataMask,
+        ///< [IN] Data to retrieve.
+
+    le_gnss_SampleData_t* samplePtr,
+        ///< [OUT] Position sample data.
+
+    le_gnss_SampleDataBitMask_t* validMaskPtr
+        ///< [OUT] Valid data among the retrieved ones.
+)
+{
+    if ((NULL == samplePtr) || (NULL == validMaskPtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer provided!");
+        return LE_FAULT;
+    }
+
+    memset(samplePtr, 0, sizeof(le_gnss_SampleData_t));
+    *validMaskPtr = 0;
+
+    if (LE_FAULT == le_gnss_GetPositionState(positionSampleRef, &samplePtr->fixState))
+    {
+        return LE_FAULT;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_LOCATION) &&
+        (LE_OK == le_gnss_GetLocation(positionSampleRef, &samplePtr->latitude,
+                                      &samplePtr->longitude, &samplePtr->hAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_LOCATION;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_ALTITUDE) &&
+        (LE_OK == le_gnss_GetAltitude(positionSampleRef, &samplePtr->altitude,
+                                      &samplePtr->vAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_ALTITUDE;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_HORIZONTAL_SPEED) &&
+        (LE_OK == le_gnss_GetHorizontalSpeed(positionSampleRef, &samplePtr->hSpeed,
+                                             &samplePtr->hSpeedAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_HORIZONTAL_SPEED;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_VERTICAL_SPEED) &&
+        (LE_OK == le_gnss_GetVerticalSpeed(positionSampleRef, &samplePtr->vSpeed,
+                                           &samplePtr->vSpeedAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_VERTICAL_SPEED;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_DIRECTION) &&
+        (LE_OK == le_gnss_GetDirection(positionSampleRef, &samplePtr->direction,
+                                       &samplePtr->directionAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_DIRECTION;
+    }
+
+    return ((*validMaskPtr == dataMask) ? LE_OK : LE_OUT_OF_RANGE);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -449,7 +449,8 @@ static void Simulate_smsInbox_cfgFileInit
 )
 {
     LE_INFO("Init Sms InBox cfg files");
-    char cfgCpCommand[512] = "cp -rf ";
+    // The files of former versions are migrated into the store, which no longer uses this folder
+    char cfgCpCommand[512] = "mkdir -p" SIMU_CONF_PATH " && cp -rf ";
     size_t cfgFilePathLen = strlen(smsCfgFilePath);
     strncat(cfgCpCommand, smsCfgFilePath, cfgFilePathLen + 1);
     strncat(cfgCpCommand, SIMU_CONF_PATH, MAX_SIMU_PATH_LEN);
@@ -467,7 +468,8 @@ static void Simulate_smsInbox_msgFileInit
 )
 {
     LE_INFO("Init Sms InBox msg files");
-    char msgCpCommand[512]= "cp -rf ";
+    // The files of former versions are migrated into the store, which no longer uses this folder
+    char msgCpCommand[512]= "mkdir -p" SIMU_MSG_PATH " && cp -rf ";
     size_t msgFilePathLen = strlen(smsMsgFilePath);
     strncat(msgCpCommand, smsMsgFilePath, msgFilePathLen + 1);
     strncat(msgCpCommand, SIMU_MSG_PATH, MAX_SIMU_PATH_LEN);
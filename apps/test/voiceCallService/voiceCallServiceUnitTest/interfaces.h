@@ -23,10 +23,10 @@ typedef struct le_mcc_Call* le_mcc_CallRef_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Reference type used by Add/Remove functions for EVENT 'le_mcc_CallEvent'
+ * Reference type used by Add/Remove functions for EVENT 'le_mcc_CallState'
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct le_mcc_CallEventHandler* le_mcc_CallEventHandlerRef_t;
+typedef struct le_mcc_CallStateHandler* le_mcc_CallStateHandlerRef_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -182,16 +182,24 @@ le_mcc_Event_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handler for call state changes.
+ * Handler for call state changes, carrying the call state.
  *
  */
 //--------------------------------------------------------------------------------------------------
-typedef void (*le_mcc_CallEventHandlerFunc_t)
+typedef void (*le_mcc_CallStateHandlerFunc_t)
 (
     le_mcc_CallRef_t callRef,
         ///< The call reference.
     le_mcc_Event_t event,
         ///< Call event.
+    const char* telNumber,
+        ///< Remote party telephone number.
+    bool isIncoming,
+        ///< True for a call initiated by the remote party.
+    le_mcc_TerminationReason_t termination,
+        ///< Termination reason.
+    int32_t terminationCode,
+        ///< Platform specific termination code.
     void* contextPtr
         ///<
 );
@@ -216,19 +224,6 @@ void le_mccTest_SimulateTerminationReason
     le_mcc_TerminationReason_t Termination
 );
 
-//--------------------------------------------------------------------------------------------------
-/**
- * le_mcc_GetRemoteTel() stub.
- *
- */
-//--------------------------------------------------------------------------------------------------
-le_result_t le_mcc_GetRemoteTel
-(
-    le_mcc_CallRef_t callRef,    ///< [IN]  The call reference to read from.
-    char*                telPtr,     ///< [OUT] The telephone number string.
-    size_t               len         ///< [IN]  The length of telephone number string.
-);
-
 //--------------------------------------------------------------------------------------------------
 /**
  * le_mcc_Start() stub.
@@ -253,25 +248,14 @@ le_result_t le_mcc_Answer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * le_mcc_AddCallEventHandler() stub.
- *
- */
-//--------------------------------------------------------------------------------------------------
-le_mcc_CallEventHandlerRef_t le_mcc_AddCallEventHandler
-(
-    le_mcc_CallEventHandlerFunc_t       handlerFuncPtr, ///< [IN] The event handler function.
-    void*                                   contextPtr      ///< [IN] The handlers context.
-);
-
-//--------------------------------------------------------------------------------------------------
-/**
- * le_mcc_GetTerminationReason() stub.
+ * le_mcc_AddCallStateHandler() stub.
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_mcc_TerminationReason_t le_mcc_GetTerminationReason
+le_mcc_CallStateHandlerRef_t le_mcc_AddCallStateHandler
 (
-    le_mcc_CallRef_t callRef   ///< [IN] The call reference to read from.
+    le_mcc_CallStateHandlerFunc_t       handlerFuncPtr, ///< [IN] The event handler function.
+    void*                               contextPtr      ///< [IN] The handlers context.
 );
 
 //--------------------------------------------------------------------------------------------------
@@ -290,13 +274,13 @@ le_mcc_CallRef_t le_mcc_Create
 
 //--------------------------------------------------------------------------------------------------
 /**
- * le_mcc_RemoveCallEventHandler() stub.
+ * le_mcc_RemoveCallStateHandler() stub.
  *
  */
 //--------------------------------------------------------------------------------------------------
-void le_mcc_RemoveCallEventHandler
+void le_mcc_RemoveCallStateHandler
 (
-    le_mcc_CallEventHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
+    le_mcc_CallStateHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
 );
 
 //--------------------------------------------------------------------------------------------------
@@ -115,26 +115,6 @@ void le_mccTest_SimulateTerminationReason
     TermReason = termination;
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * le_mcc_GetRemoteTel() stub.
- *
- */
-//--------------------------------------------------------------------------------------------------
-le_result_t le_mcc_GetRemoteTel
-(
-    le_mcc_CallRef_t callRef,    ///< [IN]  The call reference to read from.
-    char*                telPtr,     ///< [OUT] The telephone number string.
-    size_t               len         ///< [IN]  The length of telephone number string.
-)
-{
-    if (LE_MDMDEFS_PHONE_NUM_MAX_BYTES <= len)
-    {
-        return le_utf8_Copy(telPtr, RemotePhoneNum, LE_MDMDEFS_PHONE_NUM_MAX_BYTES, NULL);
-    }
-    return LE_FAULT;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * le_mcc_Start() stub.
@@ -177,23 +157,27 @@ static void FirstLayerStateHandler
 )
 {
     MccContext_t* MccCtxPtr = reportPtr;
-    le_mcc_CallEventHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+    le_mcc_CallStateHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
 
     clientHandlerFunc(  MccCtxPtr->callRef,
                         MccCtxPtr->callEvent,
+                        RemotePhoneNum,
+                        (LE_MCC_EVENT_INCOMING == MccCtxPtr->callEvent),
+                        TermReason,
+                        0,
                         le_event_GetContextPtr()
                      );
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * le_mcc_AddCallEventHandler() stub.
+ * le_mcc_AddCallStateHandler() stub.
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_mcc_CallEventHandlerRef_t le_mcc_AddCallEventHandler
+le_mcc_CallStateHandlerRef_t le_mcc_AddCallStateHandler
 (
-    le_mcc_CallEventHandlerFunc_t       handlerFuncPtr, ///< [IN] The event handler function.
+    le_mcc_CallStateHandlerFunc_t       handlerFuncPtr, ///< [IN] The event handler function.
     void*                               contextPtr      ///< [IN] The handlers context.
 )
 {
@@ -218,21 +202,7 @@ le_mcc_CallEventHandlerRef_t le_mcc_AddCallEventHandler
 
     le_event_SetContextPtr(handlerRef, contextPtr);
 
-    return (le_mcc_CallEventHandlerRef_t)(handlerRef);
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * le_mcc_GetTerminationReason() stub.
- *
- */
-//--------------------------------------------------------------------------------------------------
-le_mcc_TerminationReason_t le_mcc_GetTerminationReason
-(
-    le_mcc_CallRef_t callRef   ///< [IN] The call reference to read from.
-)
-{
-   return TermReason;
+    return (le_mcc_CallStateHandlerRef_t)(handlerRef);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -255,13 +225,13 @@ le_mcc_CallRef_t le_mcc_Create
 
 //--------------------------------------------------------------------------------------------------
 /**
- * le_mcc_RemoveCallEventHandler() stub.
+ * le_mcc_RemoveCallStateHandler() stub.
  *
  */
 //--------------------------------------------------------------------------------------------------
-void le_mcc_RemoveCallEventHandler
+void le_mcc_RemoveCallStateHandler
 (
-    le_mcc_CallEventHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
+    le_mcc_CallStateHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
 )
 {
    LE_INFO("Clear Call Event handler %p", handlerRef);
@@ -44,6 +44,14 @@ static char Path[SECSTOREADMIN_MAX_PATH_BYTES] = "/";
 static const char* InputFilePtr = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The output file specified on the command line.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* OutputFilePtr = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Flag to indicate whether the size of the entry should be listed.
@@ -97,6 +105,16 @@ static void PrintHelp
         "       Deletes <path> and all items under it.  <path> is assumed to be absolute.\n"
         "\n"
         "\n"
+        "    secstore export <outputFile> [<path>]\n"
+        "       Exports all the items under <path>, or all the items if <path> is omitted, into\n"
+        "       <outputFile>.  <outputFile> can be '-' to write to the standard output.  The exported\n"
+        "       data is not encrypted.\n"
+        "\n"
+        "    secstore import <inputFile>\n"
+        "       Writes the items exported in <inputFile> into secure storage, overwriting the\n"
+        "       existing items.  <inputFile> can be '-' to read from the standard input.\n"
+        "       Note that this import will not respect an application's secure storage limit.\n"
+        "\n"
         "    secstore readmeta\n"
         "       Prints the contents of the meta file.\n"
         "\n"
@@ -358,6 +376,122 @@ static void WriteEntry
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exports the items under a secure storage path into a file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExportItems
+(
+    void
+)
+{
+    if (OutputFilePtr == NULL)
+    {
+        fprintf(stderr, "Output file is missing.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bool isStdout = (strcmp(OutputFilePtr, "-") == 0);
+    int fd;
+
+    do
+    {
+        if (isStdout)
+        {
+            fd = dup(STDOUT_FILENO);
+        }
+        else
+        {
+            fd = open(OutputFilePtr, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        }
+    }
+    while ( (fd == -1) && (errno == EINTR) );
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Could not open file '%s'.  %m.\n", OutputFilePtr);
+        exit(EXIT_FAILURE);
+    }
+
+    // The file descriptor is closed once sent to the secure storage daemon.
+    uint32_t numItems = 0;
+    le_result_t result = secStoreAdmin_Export(Path, fd, &numItems);
+
+    if (result == LE_NOT_FOUND)
+    {
+        fprintf(stderr, "Path %s not found.\n", Path);
+        exit(EXIT_FAILURE);
+    }
+    else if (result != LE_OK)
+    {
+        INTERNAL_ERR("Could not export path %s.  Result code %s.", Path, LE_RESULT_TXT(result));
+    }
+
+    if (!isStdout)
+    {
+        printf("Exported %" PRIu32 " items.\n", numItems);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Imports the items exported into a file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ImportItems
+(
+    void
+)
+{
+    int fd;
+
+    do
+    {
+        if (strcmp(InputFilePtr, "-") == 0)
+        {
+            fd = dup(STDIN_FILENO);
+        }
+        else
+        {
+            fd = open(InputFilePtr, O_RDONLY);
+        }
+    }
+    while ( (fd == -1) && (errno == EINTR) );
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Could not open file '%s'.  %m.\n", InputFilePtr);
+        exit(EXIT_FAILURE);
+    }
+
+    // The file descriptor is closed once sent to the secure storage daemon.
+    uint32_t numItems = 0;
+    le_result_t result = secStoreAdmin_Import(fd, &numItems);
+
+    if (result == LE_FORMAT_ERROR)
+    {
+        fprintf(stderr, "'%s' is not a complete secure storage export.  %" PRIu32
+                " items were imported.\n", InputFilePtr, numItems);
+        exit(EXIT_FAILURE);
+    }
+    else if (result == LE_NO_MEMORY)
+    {
+        fprintf(stderr, "Out of secure storage space.  %" PRIu32 " items were imported.\n",
+                numItems);
+        exit(EXIT_FAILURE);
+    }
+    else if (result != LE_OK)
+    {
+        INTERNAL_ERR("Could not import from %s.  Result code %s.",
+                     InputFilePtr, LE_RESULT_TXT(result));
+    }
+
+    printf("Imported %" PRIu32 " items.\n", numItems);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Recursively deletes a secure storage path.
@@ -587,6 +721,20 @@ static void SetInputFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the output file specified on the command-line.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetOutputFile
+(
+    const char* argPtr                  ///< [IN] Command-line argument.
+)
+{
+    OutputFilePtr = argPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the command handler to call depending on which command was specified on the command-line.
@@ -615,6 +763,18 @@ static void SetCommandHandler
         le_arg_AddPositionalCallback(SetInputFile);
         le_arg_AddPositionalCallback(SetPath);
     }
+    else if (strcmp(argPtr, "export") == 0)
+    {
+        CommandHandler = ExportItems;
+        le_arg_AddPositionalCallback(SetOutputFile);
+        le_arg_AddPositionalCallback(SetPath);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
+    else if (strcmp(argPtr, "import") == 0)
+    {
+        CommandHandler = ImportItems;
+        le_arg_AddPositionalCallback(SetInputFile);
+    }
     else if (strcmp(argPtr, "rm") == 0)
     {
         CommandHandler = DeletePath;
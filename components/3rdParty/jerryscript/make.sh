@@ -1,5 +1,6 @@
 #!/bin/sh -x
 python ${LEGATO_ROOT}/3rdParty/jerryscript/tools/build.py \
        --jerry-libc=off                                   \
+       --snapshot-exec=on                                 \
        --cmake-param="-DCMAKE_C_COMPILER=${CC}" \
-       --compile-flag="-nostdlib -I${LEGATO_SYSROOT}"
\ No newline at end of file
+       --compile-flag="-nostdlib -I${LEGATO_SYSROOT}"
@@ -48,6 +48,18 @@
 #define STATE_INSTALL_STARTED       "InstallStarted"
 #define STATE_UNINSTALL_STARTED     "UninstallStarted"
 #define STATE_DOWNLOAD_REQUESTED    "DownloadRequested"
+#define STATE_DOWNLOAD_RETRIES      "DownloadRetries"
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Number of times an interrupted download is requested again before reporting the failure, and
+ *  delay before the first retry. The delay grows with each retry.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_DOWNLOAD_RETRIES        3
+#define DOWNLOAD_RETRY_DELAY_MS     30000
 
 
 
@@ -234,6 +246,14 @@ static bool AvmsInstall = false;
 //--------------------------------------------------------------------------------------------------
 static bool IsLocalUninstall = false;
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Timer delaying the retry of an interrupted download.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t DownloadRetryTimerRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Store the state of the avc update process in config tree
@@ -1148,6 +1168,88 @@ static void UpdateProgressHandler
 
 
 
+void OnUriDownloadUpdate(le_avc_Status_t updateStatus);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Request again the download of the backed up URI, once the retry delay expired.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DownloadRetryTimerHandler
+(
+    le_timer_Ref_t timerRef  ///< Timer that expired.
+)
+{
+    char uri[MAX_URI_STR_BYTES];
+    le_cfg_IteratorRef_t iterRef;
+
+    if (CurrentObj9 == NULL)
+    {
+        LE_DEBUG("Download cancelled.");
+        return;
+    }
+
+    iterRef = le_cfg_CreateReadTxn(UPDATE_STATE_BACKUP);
+    le_cfg_GetString(iterRef, "uri", uri, sizeof(uri), "");
+    le_cfg_CancelTxn(iterRef);
+
+    LE_INFO("Retrying download from Url: %s", uri);
+
+    if (pa_avc_StartURIDownload(uri, OnUriDownloadUpdate) != LE_OK)
+    {
+        LE_ERROR("Download request failed.");
+        OnUriDownloadUpdate(LE_AVC_DOWNLOAD_FAILED);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Schedule the retry of an interrupted download. The same URI is requested again, so that the
+ *  download resumes from the data already received where the modem firmware supports it. The
+ *  number of retries is backed up, so that it is bounded across reboots too.
+ *
+ *  @return true if a retry is scheduled, false if the download has to be reported as failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RetryDownload
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t iterRef;
+    int retries;
+
+    if (CurrentObj9 == NULL)
+    {
+        return false;
+    }
+
+    iterRef = le_cfg_CreateWriteTxn(UPDATE_STATE_BACKUP);
+    retries = le_cfg_GetInt(iterRef, STATE_DOWNLOAD_RETRIES, 0);
+
+    if (retries >= MAX_DOWNLOAD_RETRIES)
+    {
+        le_cfg_SetInt(iterRef, STATE_DOWNLOAD_RETRIES, 0);
+        le_cfg_CommitTxn(iterRef);
+        return false;
+    }
+
+    le_cfg_SetInt(iterRef, STATE_DOWNLOAD_RETRIES, retries + 1);
+    le_cfg_CommitTxn(iterRef);
+
+    LE_INFO("Download interrupted, retry %d of %d in %d ms.",
+            retries + 1, MAX_DOWNLOAD_RETRIES, DOWNLOAD_RETRY_DELAY_MS * (retries + 1));
+
+    le_timer_Stop(DownloadRetryTimerRef);
+    le_timer_SetMsInterval(DownloadRetryTimerRef, DOWNLOAD_RETRY_DELAY_MS * (retries + 1));
+    le_timer_Start(DownloadRetryTimerRef);
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Called during application download.
@@ -1172,12 +1274,19 @@ void OnUriDownloadUpdate
             // Clear download requested flag.
             iterRef = le_cfg_CreateWriteTxn(UPDATE_STATE_BACKUP);
             le_cfg_SetBool(iterRef, STATE_DOWNLOAD_REQUESTED, false);
+            le_cfg_SetInt(iterRef, STATE_DOWNLOAD_RETRIES, 0);
             le_cfg_CommitTxn(iterRef);
 
             break;
 
         case LE_AVC_DOWNLOAD_FAILED:
             LE_DEBUG("Download failed.");
+
+            // Request the download again before giving up.
+            if (RetryDownload())
+            {
+                break;
+            }
             // TODO: Find out the real reason this failed.
             SetObj9State(CurrentObj9, US_INITIAL, UR_INSTALLATION_FAILURE, true);
             assetData_RegUpdateIfNotObserved(CurrentObj9, ASSET_DATA_SESSION_STATUS_CHECK);
@@ -1501,6 +1610,7 @@ static void Object9FieldActivityHandler
                     le_cfg_IteratorRef_t iterRef;
                     iterRef = le_cfg_CreateWriteTxn(UPDATE_STATE_BACKUP);
                     le_cfg_SetBool(iterRef, STATE_DOWNLOAD_REQUESTED, true);
+                    le_cfg_SetInt(iterRef, STATE_DOWNLOAD_RETRIES, 0);
                     le_cfg_CommitTxn(iterRef);
                 }
                 else
@@ -1953,6 +2063,9 @@ static void RestoreAvcAppUpdateState
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    DownloadRetryTimerRef = le_timer_Create("Download retry timer");
+    le_timer_SetHandler(DownloadRetryTimerRef, DownloadRetryTimerHandler);
+
     // Register our handler for update progress reports from the Update Daemon.
     le_update_AddProgressHandler(UpdateProgressHandler, NULL);
 
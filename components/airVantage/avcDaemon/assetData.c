@@ -60,10 +60,82 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
+ * Number of bytes in one chunk of CBOR encoded time series data. The time series buffer grows by
+ * one chunk at a time.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CBOR_BUFFER_NUMBYTES 1024
+#define CBOR_CHUNK_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the CBOR encoded header of a time series
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_HEADER_NUMBYTES 128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for one CBOR encoded time series sample (time stamp and value)
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_SAMPLE_NUMBYTES (STRING_VALUE_NUMBYTES + 32)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR "break" stop code, closing the indefinite length sample array. The map holding the header,
+ * factor and sample arrays has a definite length and doesn't need any closing.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_BREAK_BYTE 0xFF
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the resource TLVs of a batch observe notification
+ */
+//--------------------------------------------------------------------------------------------------
+#define BATCH_NOTIFY_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the notification of a single resource.  A string resource takes up
+ * to STRING_VALUE_NUMBYTES, plus the TLV header or the SenML base name, base time and name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFY_NUMBYTES (STRING_VALUE_NUMBYTES + 64)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the time series settings:
+ *  - maxBytes: maximum number of bytes of CBOR encoded data accumulated by a time series
+ *  - compressionLevel: zlib compression level used when the time series is pushed
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_CFG "/apps/avcService/timeSeries"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the observe notification settings:
+ *  - format: content format of the notifications, "tlv" (default) or "senml-cbor"
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFY_CFG "/apps/avcService/notify"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default, minimum and maximum number of bytes of CBOR encoded data accumulated by a time series
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_DEFAULT_MAX_NUMBYTES (8 * CBOR_CHUNK_NUMBYTES)
+#define TIME_SERIES_MIN_MAX_NUMBYTES     CBOR_CHUNK_NUMBYTES
+#define TIME_SERIES_MAX_MAX_NUMBYTES     (64 * CBOR_CHUNK_NUMBYTES)
 
 
 //--------------------------------------------------------------------------------------------------
@@ -117,6 +189,66 @@ typedef enum
 AccessBitMask_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * LwM2M notification attributes, written by the server on a resource, an instance or an object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    NOTIFY_ATTR_PMIN = 0x01,            ///< Minimum period
+    NOTIFY_ATTR_PMAX = 0x02,            ///< Maximum period
+    NOTIFY_ATTR_GT   = 0x04,            ///< Greater than
+    NOTIFY_ATTR_LT   = 0x08,            ///< Less than
+    NOTIFY_ATTR_ST   = 0x10             ///< Step
+}
+NotifyAttrBitMask_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification attributes of a field
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t mask;                       ///< Attributes which are set (NotifyAttrBitMask_t)
+    uint32_t pmin;                      ///< Minimum period between notifications, in seconds
+    uint32_t pmax;                      ///< Maximum period between notifications, in seconds
+    double gt;                          ///< Notify when the value crosses this upper threshold
+    double lt;                          ///< Notify when the value crosses this lower threshold
+    double st;                          ///< Notify when the value changes by at least this step
+}
+NotifyAttr_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the maps indexing an instance or a field by id, or the field action handlers by field id.
+ * The owner is the asset of an instance or of field action handlers, or the instance of a field.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void* ownerPtr;               ///< Asset or instance the key belongs to
+    int id;                             ///< Instance or field id
+}
+IdKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the map indexing a field by name within its instance.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void* ownerPtr;               ///< Instance the field belongs to
+    const char* namePtr;                ///< Field name
+}
+NameKey_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data associated with an asset with a particular id
@@ -129,7 +261,7 @@ typedef struct assetData_AssetData
     char appName[100];                  ///< Name for app containing this asset
     int lastInstanceId;                 ///< Last assigned instance Id
     le_dls_List_t instanceList;         ///< List of instances for this asset
-    le_dls_List_t fieldActionList;      ///< List of registered fieldAction handlers
+    le_dls_List_t fieldActionList;      ///< List of fields with registered fieldAction handlers
     le_dls_List_t assetActionList;      ///< List of registered assetAction handlers
     bool isObjectObserve;               ///< Is Observe enabled on this object?
     uint8_t tokenLength;                ///< Token length of the lwm2m observe request.
@@ -148,6 +280,9 @@ typedef struct le_avdata_AssetInstance
     int instanceId;              ///< Id for this instance
     AssetData_t* assetDataPtr;   ///< Back reference to asset data containing this instance
     le_dls_List_t fieldList;     ///< List of fields for this instance
+    bool isBatchStarted;         ///< Are observe notifications deferred until the batch is pushed?
+    le_timer_Ref_t notifyTimerRef;   ///< Timer of the deferred observe notifications, or NULL
+    IdKey_t key;                 ///< Key in the instance map
     le_dls_Link_t link;          ///< For adding to the asset instance list
 }
 InstanceData_t;
@@ -160,8 +295,8 @@ InstanceData_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
+    le_dls_List_t chunkList;        ///< Chunks of CBOR encoded history data.
+    size_t bufferSize;              ///< Number of bytes of CBOR encoded history data.
 
 #ifdef LEGATO_FEATURE_TIMESERIES
     double timeStampFactor;         ///< Factor of time stamp.
@@ -175,15 +310,25 @@ typedef struct
     };
 
     uint32_t numElements;           ///< Number of elements in cbor encoded stream.
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
 #endif
 }
 TimeSeriesData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk of CBOR encoded time series data
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t numBytes;                        ///< Number of bytes used in the chunk.
+    uint8_t data[CBOR_CHUNK_NUMBYTES];      ///< CBOR encoded data.
+    le_dls_Link_t link;                     ///< For adding to the time series chunk list.
+}
+CborChunk_t;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -197,6 +342,7 @@ typedef struct
     DataTypes_t type;
     AccessBitMask_t access;
     bool isObserve;
+    bool isNotifyPending;        ///< Has the field changed since the start of the batch?
     pa_avc_LWM2MOperationDataRef_t readCallBackOpRef;
     uint8_t tokenLength;
     uint8_t token[8];
@@ -210,6 +356,12 @@ typedef struct
 
     TimeSeriesData_t* timeSeriesPtr;
 
+    NotifyAttr_t notifyAttr;         ///< Notification attributes written by the server
+    double lastNotifyValue;          ///< Numeric value in the last notification of the field
+    le_clk_Time_t lastNotifyTime;    ///< Time of the last notification of the field
+
+    IdKey_t idKey;               ///< Key in the field map
+    NameKey_t nameKey;           ///< Key in the field name map
     le_dls_Link_t link;          ///< For adding to the field list
 }
 FieldData_t;
@@ -238,6 +390,20 @@ typedef struct
 ActionHandlerData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handlers registered against the actions of one field of an asset
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    IdKey_t key;                ///< Key in the field action map
+    le_dls_List_t handlerList;  ///< List of registered handlers for this field
+    le_dls_Link_t link;         ///< For adding to the asset field action list
+}
+FieldActionData_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Entry in table mapping data type strings to DataType_t values. All strings must be literals,
@@ -290,6 +456,14 @@ static le_mem_PoolRef_t AssetDataPoolRef = NULL;
 static le_mem_PoolRef_t ActionHandlerDataPoolRef = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field action data memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FieldActionDataPoolRef = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This pool is used for the string representation of a LWM2M address, which is used as a key in a
@@ -323,6 +497,39 @@ static le_hashmap_Ref_t AssetMap = NULL;
 static le_hashmap_Ref_t AssetMapByName = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (asset, instanceId) to an asset instance.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t InstanceMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (instance, fieldId) to a field.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (instance, field name) to a field.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldNameMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps (asset, fieldId) to the handlers registered against the field actions.  Initialized in
+ * assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldActionMap = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Used to delay reporting REG_UPDATE, so that we don't generate too much message traffic.
@@ -341,12 +548,48 @@ static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CBOR buffer memory pool.  Initialized in assetData_Init().
+ * CBOR buffer chunk memory pool.  Initialized in assetData_Init().
  */
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t CborBufferPoolRef = NULL;
 
 
+#ifdef LEGATO_FEATURE_TIMESERIES
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compressed time series memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CompressedBufferPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of CBOR encoded data accumulated by a time series.  Read from the
+ * config tree in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TimeSeriesMaxNumBytes = TIME_SERIES_DEFAULT_MAX_NUMBYTES;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compression level of the pushed time series.  Read from the config tree in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static int TimeSeriesCompressionLevel;
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Content type of the observe notifications.  SenML CBOR can be selected in the config tree when
+ * CBOR support is built in; read in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t NotifyContentType = TLV_ENCODING;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Table mapping data type strings to DataType_t values
@@ -387,19 +630,28 @@ static bool IsRegUpdatePending = false;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Declare this function here, until the QMI functions are moved out of this file.
+ * Declare these functions here, until the QMI functions are moved out of this file.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteNotifyObjectToTLV
+static le_result_t WriteNotifyObject
 (
     assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
     int instanceId,                             ///< [IN] Instance that has a changed resource
     int fieldId,                                ///< [IN] The resource which changed
-    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the notification
     size_t bufNumBytes,                         ///< [IN] Size of buffer
     size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
 );
 
+static le_result_t WriteNotifyBatch
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance with changed resources
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the notification
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr,                 ///< [OUT] # bytes written to buffer.
+    FieldData_t** notifyFieldPtrPtr             ///< [OUT] One of the changed fields, or NULL
+);
+
 //--------------------------------------------------------------------------------------------------
 // Local functions
 //--------------------------------------------------------------------------------------------------
@@ -558,6 +810,8 @@ static void InitDefaultFieldData
 )
 {
     fieldDataPtr->isObserve = false;
+    fieldDataPtr->isNotifyPending = false;
+    fieldDataPtr->notifyAttr.mask = 0;
     fieldDataPtr->readCallBackOpRef = NULL;
 
     fieldDataPtr->timeSeriesPtr = NULL;
@@ -656,6 +910,141 @@ static le_result_t CreateFieldFromModel
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for the IdKey_t keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashIdKey
+(
+    const void* keyPtr
+)
+{
+    const IdKey_t* idKeyPtr = keyPtr;
+
+    return ((size_t)(uintptr_t)idKeyPtr->ownerPtr >> 3) * 31 + (size_t)idKeyPtr->id;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for the IdKey_t keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsIdKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const IdKey_t* firstIdKeyPtr = firstKeyPtr;
+    const IdKey_t* secondIdKeyPtr = secondKeyPtr;
+
+    return (firstIdKeyPtr->ownerPtr == secondIdKeyPtr->ownerPtr) &&
+           (firstIdKeyPtr->id == secondIdKeyPtr->id);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for the NameKey_t keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashNameKey
+(
+    const void* keyPtr
+)
+{
+    const NameKey_t* nameKeyPtr = keyPtr;
+
+    return ((size_t)(uintptr_t)nameKeyPtr->ownerPtr >> 3) * 31 +
+           le_hashmap_HashString(nameKeyPtr->namePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for the NameKey_t keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsNameKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const NameKey_t* firstNameKeyPtr = firstKeyPtr;
+    const NameKey_t* secondNameKeyPtr = secondKeyPtr;
+
+    return (firstNameKeyPtr->ownerPtr == secondNameKeyPtr->ownerPtr) &&
+           (strcmp(firstNameKeyPtr->namePtr, secondNameKeyPtr->namePtr) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a field to the field list of an instance, and index it by id and by name.
+ *
+ * If the instance already has a field with the same id or name, the first one stays indexed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddFieldToInstance
+(
+    InstanceData_t* assetInstPtr,       ///< [IN] Instance the field belongs to
+    FieldData_t* fieldDataPtr           ///< [IN] Field to add
+)
+{
+    fieldDataPtr->idKey.ownerPtr = assetInstPtr;
+    fieldDataPtr->idKey.id = fieldDataPtr->fieldId;
+    fieldDataPtr->nameKey.ownerPtr = assetInstPtr;
+    fieldDataPtr->nameKey.namePtr = fieldDataPtr->name;
+
+    if (le_hashmap_ContainsKey(FieldMap, &fieldDataPtr->idKey))
+    {
+        LE_WARN("Duplicate field id %d", fieldDataPtr->fieldId);
+    }
+    else
+    {
+        le_hashmap_Put(FieldMap, &fieldDataPtr->idKey, fieldDataPtr);
+    }
+
+    if (le_hashmap_ContainsKey(FieldNameMap, &fieldDataPtr->nameKey))
+    {
+        LE_WARN("Duplicate field name '%s'", fieldDataPtr->name);
+    }
+    else
+    {
+        le_hashmap_Put(FieldNameMap, &fieldDataPtr->nameKey, fieldDataPtr);
+    }
+
+    fieldDataPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&assetInstPtr->fieldList, &fieldDataPtr->link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a field from the field maps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFieldFromMaps
+(
+    FieldData_t* fieldDataPtr           ///< [IN] Field to remove
+)
+{
+    // Only remove the map entries indexing this field, not a duplicate one.
+    if (le_hashmap_Get(FieldMap, &fieldDataPtr->idKey) == fieldDataPtr)
+    {
+        le_hashmap_Remove(FieldMap, &fieldDataPtr->idKey);
+    }
+
+    if (le_hashmap_Get(FieldNameMap, &fieldDataPtr->nameKey) == fieldDataPtr)
+    {
+        le_hashmap_Remove(FieldNameMap, &fieldDataPtr->nameKey);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read asset model from configDB, and fill in asset data instance
@@ -693,6 +1082,8 @@ static le_result_t CreateInstanceFromModel
 
     // Init the field list for this instance; it will get populated below
     assetInstPtr->fieldList = LE_DLS_LIST_INIT;
+    assetInstPtr->isBatchStarted = false;
+    assetInstPtr->notifyTimerRef = NULL;
 
     do
     {
@@ -713,7 +1104,7 @@ static le_result_t CreateInstanceFromModel
         }
 
         // Field read okay; add it to the list.
-        le_dls_Queue(&assetInstPtr->fieldList, &fieldDataPtr->link);
+        AddFieldToInstance(assetInstPtr, fieldDataPtr);
 
     } while ( le_cfg_GoToNextSibling(assetCfg) == LE_OK );
 
@@ -795,7 +1186,7 @@ static void AddFieldFromData
     fieldDataPtr->access = access;
     InitDefaultFieldData(fieldDataPtr);
 
-    le_dls_Queue(&assetInstPtr->fieldList, &fieldDataPtr->link);
+    AddFieldToInstance(assetInstPtr, fieldDataPtr);
 }
 
 
@@ -811,6 +1202,8 @@ static void CreateInstanceForObjectNine
 {
     // Init the field list for this instance; it will get populated below
     assetInstPtr->fieldList = LE_DLS_LIST_INIT;
+    assetInstPtr->isBatchStarted = false;
+    assetInstPtr->notifyTimerRef = NULL;
 
     // todo: Not all fields are defined for now; only the ones that are actually needed, which
     //       turn out to be most of the mandatory fields/resources, except for "Package"
@@ -1121,25 +1514,13 @@ static le_result_t GetInstanceFromAssetData
     InstanceData_t** instanceDataPtrPtr   ///< [OUT]
 )
 {
-    InstanceData_t* assetInstancePtr;
-    le_dls_Link_t* linkPtr;
-
-    // Get the start of the instance list
-    linkPtr = le_dls_Peek(&assetDataPtr->instanceList);
+    IdKey_t key = { .ownerPtr = assetDataPtr, .id = instanceId };
+    InstanceData_t* assetInstancePtr = le_hashmap_Get(InstanceMap, &key);
 
-    // Loop through the asset instances
-    while ( linkPtr != NULL )
+    if ( assetInstancePtr != NULL )
     {
-        assetInstancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
-        //LE_PRINT_VALUE("%i", assetInstancePtr->instanceId);
-
-        if ( assetInstancePtr->instanceId == instanceId )
-        {
-            *instanceDataPtrPtr = assetInstancePtr;
-            return LE_OK;
-        }
-
-        linkPtr = le_dls_PeekNext(&assetDataPtr->instanceList, linkPtr);
+        *instanceDataPtrPtr = assetInstancePtr;
+        return LE_OK;
     }
 
     return LE_NOT_FOUND;
@@ -1162,25 +1543,13 @@ static le_result_t GetFieldFromInstance
     FieldData_t** fieldDataPtrPtr   ///< [OUT]
 )
 {
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
+    IdKey_t key = { .ownerPtr = instanceDataPtr, .id = fieldId };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldMap, &key);
 
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
-
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr != NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
-
-        if ( fieldDataPtr->fieldId == fieldId )
-        {
-            *fieldDataPtrPtr = fieldDataPtr;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, fieldLinkPtr);
+        *fieldDataPtrPtr = fieldDataPtr;
+        return LE_OK;
     }
 
     return LE_NOT_FOUND;
@@ -1286,6 +1655,147 @@ static le_result_t GetField
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a time series and all its buffer chunks.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseTimeSeries
+(
+    TimeSeriesData_t* timeSeriesPtr             ///< [IN] Time series to release
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&timeSeriesPtr->chunkList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, CborChunk_t, link));
+    }
+
+    le_mem_Release(timeSeriesPtr);
+}
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append CBOR encoded data to a time series, growing its buffer by one chunk when the last chunk
+ * is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendTimeSeriesData
+(
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series to append the data to
+    const uint8_t* dataPtr,                     ///< [IN] CBOR encoded data
+    size_t numBytes                             ///< [IN] Number of bytes of data
+)
+{
+    while (numBytes > 0)
+    {
+        CborChunk_t* chunkPtr = NULL;
+        le_dls_Link_t* linkPtr = le_dls_PeekTail(&timeSeriesPtr->chunkList);
+
+        if (linkPtr != NULL)
+        {
+            chunkPtr = CONTAINER_OF(linkPtr, CborChunk_t, link);
+        }
+
+        if ((chunkPtr == NULL) || (chunkPtr->numBytes == sizeof(chunkPtr->data)))
+        {
+            chunkPtr = le_mem_ForceAlloc(CborBufferPoolRef);
+            chunkPtr->numBytes = 0;
+            chunkPtr->link = LE_DLS_LINK_INIT;
+            le_dls_Queue(&timeSeriesPtr->chunkList, &chunkPtr->link);
+        }
+
+        size_t copySize = sizeof(chunkPtr->data) - chunkPtr->numBytes;
+        if (copySize > numBytes)
+        {
+            copySize = numBytes;
+        }
+
+        memcpy(chunkPtr->data + chunkPtr->numBytes, dataPtr, copySize);
+        chunkPtr->numBytes += copySize;
+        timeSeriesPtr->bufferSize += copySize;
+
+        dataPtr += copySize;
+        numBytes -= copySize;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the accumulated CBOR encoded time series data in a single deflate stream, fed one
+ * chunk at a time, and close the sample array at the end of the compressed stream.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any compression error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompressTimeSeries
+(
+    TimeSeriesData_t* timeSeriesPtr,            ///< [IN] Time series to compress
+    uint8_t* compressedBufPtr,                  ///< [OUT] Compressed data
+    size_t compressedBufSize,                   ///< [IN] Size of the compressed data buffer
+    size_t* compressedLenPtr                    ///< [OUT] Number of bytes of compressed data
+)
+{
+    z_stream defstream;
+    uint8_t breakByte = CBOR_BREAK_BYTE;
+    int ret = Z_OK;
+
+    memset(&defstream, 0, sizeof(defstream));
+    defstream.zalloc = Z_NULL;
+    defstream.zfree = Z_NULL;
+    defstream.opaque = Z_NULL;
+
+    if (deflateInit(&defstream, TimeSeriesCompressionLevel) != Z_OK)
+    {
+        LE_ERROR("Failed to initialize the compression stream.");
+        return LE_FAULT;
+    }
+
+    defstream.next_out = (Bytef *)compressedBufPtr;
+    defstream.avail_out = (uInt)compressedBufSize;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&timeSeriesPtr->chunkList);
+
+    while ((linkPtr != NULL) && (ret == Z_OK))
+    {
+        CborChunk_t* chunkPtr = CONTAINER_OF(linkPtr, CborChunk_t, link);
+        linkPtr = le_dls_PeekNext(&timeSeriesPtr->chunkList, linkPtr);
+
+        defstream.next_in = (Bytef *)chunkPtr->data;
+        defstream.avail_in = (uInt)chunkPtr->numBytes;
+
+        ret = deflate(&defstream, Z_NO_FLUSH);
+    }
+
+    if (ret == Z_OK)
+    {
+        defstream.next_in = (Bytef *)&breakByte;
+        defstream.avail_in = sizeof(breakByte);
+
+        ret = deflate(&defstream, Z_FINISH);
+    }
+
+    deflateEnd(&defstream);
+
+    if (ret != Z_STREAM_END)
+    {
+        LE_ERROR("Failed to compress the time series (%d).", ret);
+        return LE_FAULT;
+    }
+
+    *compressedLenPtr = defstream.total_out;
+
+    return LE_OK;
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Allocate resources and start accumulating time series data on the specified field.
@@ -1309,11 +1819,14 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
+    uint8_t header[CBOR_HEADER_NUMBYTES];
     char headerId[64];
     CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
     CborEncoder headerArray;
     CborEncoder factorArray;
+    CborEncoder sampleRef;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1335,34 +1848,19 @@ static le_result_t StartTimeSeries
                  instanceRef->instanceId,
                  fieldId);
 
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
-
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
+    // Initialize CBOR stream. The header is encoded up to the opening of the sample array, the
+    // samples are appended to the time series buffer as they are added.
+    cbor_encoder_init(&streamRef, header, sizeof(header), 0);
 
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
     RETURN_IF_CBOR_ERROR(err);
 
     // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
+    err = cbor_encode_text_stringz(&mapRef, "h");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
+    err = cbor_encoder_create_array(&mapRef, &headerArray, 1);
     RETURN_IF_CBOR_ERROR(err);
 
     err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
@@ -1370,18 +1868,15 @@ static le_result_t StartTimeSeries
 
     // Close the heade map i.e done with entering in to header array.
     // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
+    cbor_encoder_close_container(&mapRef, &headerArray);
 
     // Create a map for factor.
     // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
+    err = cbor_encode_text_stringz(&mapRef, "f");
     RETURN_IF_CBOR_ERROR(err);
 
     // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
+    err = cbor_encoder_create_array(&mapRef, &factorArray, 2);
     RETURN_IF_CBOR_ERROR(err);
 
     // Add factor for time stamp.
@@ -1393,18 +1888,24 @@ static le_result_t StartTimeSeries
     RETURN_IF_CBOR_ERROR(err);
 
     // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
+    cbor_encoder_close_container(&mapRef, &factorArray);
 
     // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
+    err = cbor_encode_text_stringz(&mapRef, "s");
     RETURN_IF_CBOR_ERROR(err);
 
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
+    err = cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
     RETURN_IF_CBOR_ERROR(err);
 
+    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
+
+    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
+    fieldDataPtr->timeSeriesPtr->chunkList = LE_DLS_LIST_INIT;
+
+    AppendTimeSeriesData(fieldDataPtr->timeSeriesPtr,
+                         header,
+                         cbor_encoder_get_buffer_size(&sampleRef, header));
+
     fieldDataPtr->timeSeriesPtr->factor = factor;
     fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
 
@@ -1450,8 +1951,7 @@ static le_result_t StopTimeSeries
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+    ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
 
     fieldDataPtr->timeSeriesPtr = NULL;
 
@@ -1488,12 +1988,9 @@ static le_result_t PushTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
+    uint8_t* compressedBufPtr;
+    size_t compressBufLength;
     pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
 
     double dataFactor;
     double timeStampFactor;
@@ -1522,43 +2019,23 @@ static le_result_t PushTimeSeries
     dataFactor = fieldDataPtr->timeSeriesPtr->factor;
     timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
 
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
+    //LE_DEBUG("cborStreamSize = %zd", fieldDataPtr->timeSeriesPtr->bufferSize);
 
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
-
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
-
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
-
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
+    // Compress the cbor encoded data, closing the sample array.
+    compressedBufPtr = le_mem_ForceAlloc(CompressedBufferPoolRef);
 
-    compressBufLength = defstream.total_out;
+    result = CompressTimeSeries(fieldDataPtr->timeSeriesPtr,
+                                compressedBufPtr,
+                                le_mem_GetObjectSize(CompressedBufferPoolRef),
+                                &compressBufLength);
+    if (result != LE_OK)
+    {
+        le_mem_Release(compressedBufPtr);
+        return result;
+    }
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+    //LE_DEBUG("Compressed size is: %zd\n", compressBufLength);
+    //LE_DUMP(compressedBufPtr, compressBufLength);
 
     // Send the delta encoded + CBOR encoded + Zipped data to the server.
     opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
@@ -1570,7 +2047,9 @@ static le_result_t PushTimeSeries
                                 fieldDataPtr->token,
                                 fieldDataPtr->tokenLength);
 
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+    pa_avc_NotifyChange(opRef, compressedBufPtr, compressBufLength);
+
+    le_mem_Release(compressedBufPtr);
 
     // Stop time series.
     result = StopTimeSeries(instanceRef, fieldId);
@@ -1662,26 +2141,15 @@ static le_result_t TimeSeriesAddEntry
 
 #ifdef LEGATO_FEATURE_TIMESERIES
 
-    CborError err;
+    CborError err = CborNoError;
     uint64_t timeStamp;
     int intDelta;
     double floatDelta;
-    size_t currentSize;
+    size_t sampleSize;
     struct timeval tv;
-
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_OVERFLOW;
-    }
+    uint8_t sample[CBOR_SAMPLE_NUMBYTES];
+    CborEncoder sampleRef;
+    TimeSeriesData_t* timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
 
     // Get current system time if utc milli seconds is not provided.
     // The time stamp is expected in UTC milli seconds by the server.
@@ -1692,76 +2160,80 @@ static le_result_t TimeSeriesAddEntry
     }
 
     // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+    if (timeSeriesPtr->numElements == 0)
     {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        timeStamp = utcMilliSec * timeSeriesPtr->timeStampFactor;
     }
     else
     {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
+        timeStamp = (utcMilliSec - timeSeriesPtr->prevTimeStamp) * timeSeriesPtr->timeStampFactor;
     }
 
+    // The sample is encoded apart, then appended to the time series buffer.
+    cbor_encoder_init(&sampleRef, sample, sizeof(sample), 0);
+
     // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
+    err = cbor_encode_int(&sampleRef, timeStamp);
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
-
     // Add the data to sample array.
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+            if (timeSeriesPtr->numElements == 0)
             {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
+                intDelta = fieldDataPtr->intValue * timeSeriesPtr->factor;
             }
             else
             {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
+                intDelta = (fieldDataPtr->intValue - timeSeriesPtr->prevIntValue) *
+                            timeSeriesPtr->factor;
             }
 
             //LE_DEBUG("intDelta = %d", intDelta);
 
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
+            err = cbor_encode_int(&sampleRef, intDelta);
             break;
 
         case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
+            err = cbor_encode_boolean(&sampleRef, fieldDataPtr->boolValue);
             break;
 
         case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
+            err = cbor_encode_text_string(&sampleRef,
                                           fieldDataPtr->strValuePtr,
                                           strlen(fieldDataPtr->strValuePtr));
             break;
 
         case DATA_TYPE_FLOAT:
             // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
+            if (timeSeriesPtr->numElements == 0)
             {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
+                floatDelta = fieldDataPtr->floatValue * timeSeriesPtr->factor;
             }
             else
             {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
+                floatDelta = (fieldDataPtr->floatValue - timeSeriesPtr->prevFloatValue);
+                floatDelta = floatDelta * timeSeriesPtr->factor;
             }
 
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
+            if ((uint64_t)timeSeriesPtr->factor == 1)
             {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
+                // Single precision saves 4 bytes per sample when the delta stays exact.
+                if ((double)(float)floatDelta == floatDelta)
+                {
+                    err = cbor_encode_float(&sampleRef, (float)floatDelta);
+                }
+                else
+                {
+                    err = cbor_encode_double(&sampleRef, floatDelta);
+                }
             }
             else
             {
                 LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
+                err = cbor_encode_int(&sampleRef, (int64_t)floatDelta);
             }
-
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
             break;
 
         case DATA_TYPE_NONE:
@@ -1771,19 +2243,45 @@ static le_result_t TimeSeriesAddEntry
 
     RETURN_IF_CBOR_ERROR(err);
 
-    fieldDataPtr->timeSeriesPtr->numElements++;
-
-
     // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
     // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
+    sampleSize = cbor_encoder_get_buffer_size(&sampleRef, sample);
+
+    if ((timeSeriesPtr->bufferSize + sampleSize) > (TimeSeriesMaxNumBytes - CBOR_RESERVED_BYTES))
+    {
+        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
+        LE_DEBUG("currentSize = %zd.", timeSeriesPtr->bufferSize);
+
+        return LE_OVERFLOW;
+    }
+
+    AppendTimeSeriesData(timeSeriesPtr, sample, sampleSize);
+
+    // Values of the last data capture, used for delta encoding.
+    timeSeriesPtr->prevTimeStamp = utcMilliSec;
+
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
+            break;
+
+        case DATA_TYPE_FLOAT:
+            timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
+            break;
+
+        default:
+            break;
+    }
+
+    timeSeriesPtr->numElements++;
 
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
+    // The time series has to be flushed once it gets in to the reserved area.
+    if ((timeSeriesPtr->bufferSize + CBOR_RESERVED_BYTES) > TimeSeriesMaxNumBytes)
     {
         LE_WARN("Time series buffer full; flush and restart time series on field %d.",
                  fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
+        LE_DEBUG("currentSize = %zd.", timeSeriesPtr->bufferSize);
 
         return LE_NO_MEMORY;
     }
@@ -1812,9 +2310,6 @@ static bool IsFieldReadCallBackExist
     FieldData_t* fieldDataPtr               ///< [IN] Field data ptr
 )
 {
-    ActionHandlerData_t* handlerDataPtr;
-    le_dls_Link_t* linkPtr;
-
     LE_PRINT_VALUE("%d", fieldDataPtr->access);
 
     // Verify that the field is writeable by the client.
@@ -1823,21 +2318,12 @@ static bool IsFieldReadCallBackExist
         return false;
     }
 
-    // Get the start of the handler list
-    linkPtr = le_dls_Peek(&instanceDataPtr->assetDataPtr->fieldActionList);
+    // Return true if there is a handler for this field.
+    IdKey_t key = { .ownerPtr = instanceDataPtr->assetDataPtr, .id = fieldDataPtr->fieldId };
 
-    // Loop through the list looking for a handler.
-    while ( linkPtr != NULL )
+    if ( le_hashmap_ContainsKey(FieldActionMap, &key) )
     {
-        handlerDataPtr = CONTAINER_OF(linkPtr, ActionHandlerData_t, link);
-
-        // Return true if we find a handler.
-        if ( fieldDataPtr->fieldId == handlerDataPtr->fieldId )
-        {
-           return true;
-        }
-
-        linkPtr = le_dls_PeekNext(&instanceDataPtr->assetDataPtr->fieldActionList, linkPtr);
+        return true;
     }
 
     return false;
@@ -1863,32 +2349,36 @@ static le_result_t CallFieldActionHandlers
 {
     ActionHandlerData_t* handlerDataPtr;
     le_dls_Link_t* linkPtr;
+    IdKey_t key = { .ownerPtr = instanceDataPtr->assetDataPtr, .id = fieldId };
+
+    // Get the handlers registered for this field, if any.
+    FieldActionData_t* fieldActionPtr = le_hashmap_Get(FieldActionMap, &key);
+
+    if ( fieldActionPtr == NULL )
+    {
+        return LE_OK;
+    }
 
     // Get the start of the handler list
-    linkPtr = le_dls_Peek(&instanceDataPtr->assetDataPtr->fieldActionList);
+    linkPtr = le_dls_Peek(&fieldActionPtr->handlerList);
 
     // Loop through the list, calling the handlers
     while ( linkPtr != NULL )
     {
         handlerDataPtr = CONTAINER_OF(linkPtr, ActionHandlerData_t, link);
 
-        // The list contains registered handlers for all fields of the given asset, so call only
-        // those handlers that are applicable for this field.
-        if ( fieldId == handlerDataPtr->fieldId )
+        // Client registered handlers should only be called by server actions, and server
+        // registered handlers should only be called by client actions.
+        if ( ( handlerDataPtr->isClient && !isClient ) ||
+             ( !handlerDataPtr->isClient && isClient ) )
         {
-            // Client registered handlers should only be called by server actions, and server
-            // registered handlers should only be called by client actions.
-            if ( ( handlerDataPtr->isClient && !isClient ) ||
-                 ( !handlerDataPtr->isClient && isClient ) )
-            {
-                handlerDataPtr->fieldActionHandlerPtr(instanceDataPtr,
-                                                      fieldId,
-                                                      action,
-                                                      handlerDataPtr->contextPtr);
-            }
+            handlerDataPtr->fieldActionHandlerPtr(instanceDataPtr,
+                                                  fieldId,
+                                                  action,
+                                                  handlerDataPtr->contextPtr);
         }
 
-        linkPtr = le_dls_PeekNext(&instanceDataPtr->assetDataPtr->fieldActionList, linkPtr);
+        linkPtr = le_dls_PeekNext(&fieldActionPtr->handlerList, linkPtr);
     }
 
     return LE_OK;
@@ -2045,87 +2535,404 @@ static void PrintAssetMap
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the integer value for the specified field
+ * Get the value of an integer or float field as a double
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_FAULT on any other error
+ *      - true if the field is numeric
+ *      - false otherwise
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetInt
+static bool GetNumericValue
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to read
-    int* valuePtr,                              ///< [OUT] The value read
-    bool isClient                               ///< [IN] Is it client or server access
+    FieldData_t* fieldDataPtr,          ///< [IN] Field to read
+    double* valuePtr                    ///< [OUT] Value of the field
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            *valuePtr = fieldDataPtr->intValue;
+            return true;
 
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+        case DATA_TYPE_FLOAT:
+            *valuePtr = fieldDataPtr->floatValue;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the change of a field against its gt, lt and st notification attributes: the change is
+ * notified if the value crossed the gt or lt threshold, or moved by at least st, since the last
+ * notification. Changes of fields without such attributes, or non numeric fields, are always
+ * notified.
+ *
+ * @return:
+ *      - true if the change has to be notified
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNotifyThresholdReached
+(
+    FieldData_t* fieldDataPtr           ///< [IN] Changed field
+)
+{
+    const NotifyAttr_t* attrPtr = &fieldDataPtr->notifyAttr;
+    double lastValue = fieldDataPtr->lastNotifyValue;
+    double value;
+
+    if ( ( (attrPtr->mask & (NOTIFY_ATTR_GT | NOTIFY_ATTR_LT | NOTIFY_ATTR_ST)) == 0 ) ||
+         ( !GetNumericValue(fieldDataPtr, &value) ) )
     {
-        return result;
+        return true;
     }
 
-    //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
-    //LE_PRINT_VALUE("%s", fieldDataPtr->name);
+    if ( (attrPtr->mask & NOTIFY_ATTR_GT) && ((lastValue > attrPtr->gt) != (value > attrPtr->gt)) )
+    {
+        return true;
+    }
 
-    if ( fieldDataPtr->type != DATA_TYPE_INT )
+    if ( (attrPtr->mask & NOTIFY_ATTR_LT) && ((lastValue < attrPtr->lt) != (value < attrPtr->lt)) )
     {
-        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
+        return true;
     }
 
-    // Call any registered handlers to be notified of read
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+    if ( (attrPtr->mask & NOTIFY_ATTR_ST) &&
+         ( ((value > lastValue) ? (value - lastValue) : (lastValue - value)) >= attrPtr->st ) )
+    {
+        return true;
+    }
 
-    // Get the value and return it
-    *valuePtr = fieldDataPtr->intValue;
-    return LE_OK;
+    return false;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the float value for the specified field
+ * Send the pending changes of an instance in a single observe notification.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
+ *      - LE_OK on success, or if there is nothing to notify
+ *      - LE_OVERFLOW if the changed fields don't fit in one notification
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetFloat
+static le_result_t NotifyPendingFields
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to read
-    double* valuePtr,                           ///< [OUT] The value read
-    bool isClient                               ///< [IN] Is it client or server access
+    InstanceData_t* instancePtr         ///< [IN] Asset instance with pending changes
 )
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
+    size_t bytesWritten;
+    uint8_t valueData[BATCH_NOTIFY_NUMBYTES + 6];
+    pa_avc_LWM2MOperationDataRef_t opRef;
 
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    result = WriteNotifyBatch(instancePtr,
+                              valueData,
+                              sizeof(valueData),
+                              &bytesWritten,
+                              &fieldDataPtr);
     if ( result != LE_OK )
     {
+        LE_ERROR("Failed to send lwm2m notification.");
         return result;
     }
 
-    if ( fieldDataPtr->type != DATA_TYPE_FLOAT )
+    // Nothing to notify
+    if ( fieldDataPtr == NULL )
     {
-        LE_ERROR("Field type mismatch: expected 'float', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
+        return LE_OK;
     }
 
-    // Call any registered handlers to be notified of read
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+    opRef = pa_avc_CreateOpData(instancePtr->assetDataPtr->appName,
+                                instancePtr->assetDataPtr->assetId,
+                                -1,
+                                -1,
+                                PA_AVC_OPTYPE_NOTIFY,
+                                NotifyContentType,
+                                fieldDataPtr->token,
+                                fieldDataPtr->tokenLength);
+
+    pa_avc_NotifyChange(opRef, valueData, bytesWritten);
 
-    // Get the value and return it
-    *valuePtr = fieldDataPtr->floatValue;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a number of seconds to a time
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t AddSeconds
+(
+    le_clk_Time_t time,                 ///< [IN] Time
+    uint32_t seconds                    ///< [IN] Number of seconds to add
+)
+{
+    le_clk_Time_t period = { .sec = seconds, .usec = 0 };
+
+    return le_clk_Add(time, period);
+}
+
+
+static void ScheduleNotify(InstanceData_t* instancePtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the instance notification timer: the fields whose pmax period elapsed are notified
+ * along with the pending changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyTimerHandler
+(
+    le_timer_Ref_t timerRef             ///< [IN] Notification timer of the instance
+)
+{
+    InstanceData_t* instancePtr = le_timer_GetContextPtr(timerRef);
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+
+    linkPtr = le_dls_Peek(&instancePtr->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isObserve &&
+             (fieldDataPtr->notifyAttr.mask & NOTIFY_ATTR_PMAX) &&
+             !le_clk_GreaterThan(AddSeconds(fieldDataPtr->lastNotifyTime,
+                                            fieldDataPtr->notifyAttr.pmax),
+                                 now) )
+        {
+            fieldDataPtr->isNotifyPending = true;
+        }
+
+        linkPtr = le_dls_PeekNext(&instancePtr->fieldList, linkPtr);
+    }
+
+    NotifyPendingFields(instancePtr);
+
+    ScheduleNotify(instancePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule the next observe notification of an instance. The pending changes are notified
+ * together once the pmin period of all of them elapsed, or earlier if the pmax period of an
+ * observed field elapses first. Nothing is scheduled while a batch is started.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleNotify
+(
+    InstanceData_t* instancePtr         ///< [IN] Asset instance to schedule
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t pendingTime = now;
+    le_clk_Time_t dueTime = now;
+    le_clk_Time_t time;
+    bool isPending = false;
+    bool isDue = false;
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+
+    linkPtr = le_dls_Peek(&instancePtr->fieldList);
+
+    while ( (linkPtr != NULL) && !instancePtr->isBatchStarted )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isObserve && fieldDataPtr->isNotifyPending )
+        {
+            time = fieldDataPtr->lastNotifyTime;
+
+            if ( fieldDataPtr->notifyAttr.mask & NOTIFY_ATTR_PMIN )
+            {
+                time = AddSeconds(time, fieldDataPtr->notifyAttr.pmin);
+            }
+
+            if ( le_clk_GreaterThan(time, pendingTime) )
+            {
+                pendingTime = time;
+            }
+
+            isPending = true;
+        }
+
+        if ( fieldDataPtr->isObserve && (fieldDataPtr->notifyAttr.mask & NOTIFY_ATTR_PMAX) )
+        {
+            time = AddSeconds(fieldDataPtr->lastNotifyTime, fieldDataPtr->notifyAttr.pmax);
+
+            if ( !isDue || le_clk_GreaterThan(dueTime, time) )
+            {
+                dueTime = time;
+                isDue = true;
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&instancePtr->fieldList, linkPtr);
+    }
+
+    if ( isPending && (!isDue || le_clk_GreaterThan(dueTime, pendingTime)) )
+    {
+        dueTime = pendingTime;
+        isDue = true;
+    }
+
+    if ( instancePtr->notifyTimerRef != NULL )
+    {
+        le_timer_Stop(instancePtr->notifyTimerRef);
+    }
+
+    if ( !isDue )
+    {
+        return;
+    }
+
+    if ( instancePtr->notifyTimerRef == NULL )
+    {
+        instancePtr->notifyTimerRef = le_timer_Create("Notify timer");
+        le_timer_SetHandler(instancePtr->notifyTimerRef, NotifyTimerHandler);
+        le_timer_SetContextPtr(instancePtr->notifyTimerRef, instancePtr);
+    }
+
+    // Expire on the next pass of the event loop if the notification is already due, so that the
+    // changes made meanwhile are coalesced.
+    le_clk_Time_t interval = { .sec = 0, .usec = 1 };
+
+    if ( le_clk_GreaterThan(dueTime, now) )
+    {
+        interval = le_clk_Sub(dueTime, now);
+    }
+
+    le_timer_SetInterval(instancePtr->notifyTimerRef, interval);
+    le_timer_Start(instancePtr->notifyTimerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Defer the observe notification of a field change, if a batch is started on the instance or if
+ * the server wrote notification attributes on the field.
+ *
+ * @return:
+ *      - true if the change is deferred, or dropped as it doesn't reach the notification thresholds
+ *      - false if the change has to be notified right away
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DeferNotify
+(
+    InstanceData_t* instancePtr,        ///< [IN] Asset instance of the field
+    FieldData_t* fieldDataPtr           ///< [IN] Changed field
+)
+{
+    if ( !instancePtr->isBatchStarted && (fieldDataPtr->notifyAttr.mask == 0) )
+    {
+        return false;
+    }
+
+    if ( IsNotifyThresholdReached(fieldDataPtr) )
+    {
+        fieldDataPtr->isNotifyPending = true;
+        ScheduleNotify(instancePtr);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the integer value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInt
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to read
+    int* valuePtr,                              ///< [OUT] The value read
+    bool isClient                               ///< [IN] Is it client or server access
+)
+{
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
+
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    //LE_PRINT_VALUE("%i", fieldDataPtr->fieldId);
+    //LE_PRINT_VALUE("%s", fieldDataPtr->name);
+
+    if ( fieldDataPtr->type != DATA_TYPE_INT )
+    {
+        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
+        return LE_FAULT;
+    }
+
+    // Call any registered handlers to be notified of read
+    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+
+    // Get the value and return it
+    *valuePtr = fieldDataPtr->intValue;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the float value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFloat
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to read
+    double* valuePtr,                           ///< [OUT] The value read
+    bool isClient                               ///< [IN] Is it client or server access
+)
+{
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
+
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    if ( fieldDataPtr->type != DATA_TYPE_FLOAT )
+    {
+        LE_ERROR("Field type mismatch: expected 'float', got '%s'", GetDataTypeStr(fieldDataPtr->type));
+        return LE_FAULT;
+    }
+
+    // Call any registered handlers to be notified of read
+    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+
+    // Get the value and return it
+    *valuePtr = fieldDataPtr->floatValue;
     return LE_OK;
 }
 
@@ -2154,7 +2961,7 @@ static le_result_t SetInt
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
+    uint8_t valueData[NOTIFY_NUMBYTES];
     size_t bytesWritten;
     int prevValue;
     pa_avc_LWM2MOperationDataRef_t opRef;
@@ -2208,6 +3015,13 @@ static le_result_t SetInt
     // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
+        // Within a batch, or with notification attributes written by the server, the change is
+        // notified later on along with the other changes of the instance.
+        if (DeferNotify(instanceRef, fieldDataPtr))
+        {
+            return LE_OK;
+        }
+
         assetData_AssetDataRef_t assetRef;
         result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
                                            instanceRef->assetDataPtr->assetId,
@@ -2215,12 +3029,12 @@ static le_result_t SetInt
 
         if ( result == LE_OK)
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
+            result = WriteNotifyObject(assetRef,
+                                       instanceRef->instanceId,
+                                       fieldId,
+                                       valueData,
+                                       sizeof(valueData),
+                                       &bytesWritten);
             if ( result != LE_OK )
             {
                 LE_ERROR("Failed to send lwm2m notification.");
@@ -2232,7 +3046,7 @@ static le_result_t SetInt
                                         -1,
                                         -1,
                                         PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
+                                        NotifyContentType,
                                         fieldDataPtr->token,
                                         fieldDataPtr->tokenLength);
 
@@ -2269,7 +3083,7 @@ static le_result_t SetFloat
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
+    uint8_t valueData[NOTIFY_NUMBYTES];
     size_t bytesWritten;
     float prevValue;
     pa_avc_LWM2MOperationDataRef_t opRef;
@@ -2322,6 +3136,13 @@ static le_result_t SetFloat
     // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
+        // Within a batch, or with notification attributes written by the server, the change is
+        // notified later on along with the other changes of the instance.
+        if (DeferNotify(instanceRef, fieldDataPtr))
+        {
+            return LE_OK;
+        }
+
         assetData_AssetDataRef_t assetRef;
         result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
                                            instanceRef->assetDataPtr->assetId,
@@ -2329,12 +3150,12 @@ static le_result_t SetFloat
 
         if ( result == LE_OK)
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
+            result = WriteNotifyObject(assetRef,
+                                       instanceRef->instanceId,
+                                       fieldId,
+                                       valueData,
+                                       sizeof(valueData),
+                                       &bytesWritten);
             if ( result != LE_OK )
             {
                 LE_ERROR("Failed to send lwm2m notification.");
@@ -2346,7 +3167,7 @@ static le_result_t SetFloat
                                         -1,
                                         -1,
                                         PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
+                                        NotifyContentType,
                                         fieldDataPtr->token,
                                         fieldDataPtr->tokenLength);
 
@@ -2424,7 +3245,7 @@ static le_result_t SetBool
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
+    uint8_t valueData[NOTIFY_NUMBYTES];
     size_t bytesWritten;
     bool prevValue;
     pa_avc_LWM2MOperationDataRef_t opRef;
@@ -2477,6 +3298,13 @@ static le_result_t SetBool
     // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
     {
+        // Within a batch, or with notification attributes written by the server, the change is
+        // notified later on along with the other changes of the instance.
+        if (DeferNotify(instanceRef, fieldDataPtr))
+        {
+            return LE_OK;
+        }
+
         assetData_AssetDataRef_t assetRef;
         result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
                                            instanceRef->assetDataPtr->assetId,
@@ -2484,12 +3312,12 @@ static le_result_t SetBool
 
         if ( result == LE_OK)
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
+            result = WriteNotifyObject(assetRef,
+                                       instanceRef->instanceId,
+                                       fieldId,
+                                       valueData,
+                                       sizeof(valueData),
+                                       &bytesWritten);
             if ( result != LE_OK )
             {
                 LE_ERROR("Failed to send lwm2m notification.");
@@ -2501,7 +3329,7 @@ static le_result_t SetBool
                                         -1,
                                         -1,
                                         PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
+                                        NotifyContentType,
                                         fieldDataPtr->token,
                                         fieldDataPtr->tokenLength);
 
@@ -2582,7 +3410,7 @@ static le_result_t SetString
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
+    uint8_t valueData[NOTIFY_NUMBYTES];
     size_t bytesWritten;
     char prevStr[STRING_VALUE_NUMBYTES];
     pa_avc_LWM2MOperationDataRef_t opRef;
@@ -2635,6 +3463,13 @@ static le_result_t SetString
     // object but include only the resource that changed.
     if (fieldDataPtr->isObserve && strcmp(prevStr, strPtr) != 0 && isClient == true)
     {
+        // Within a batch, or with notification attributes written by the server, the change is
+        // notified later on along with the other changes of the instance.
+        if (DeferNotify(instanceRef, fieldDataPtr))
+        {
+            return LE_OK;
+        }
+
         assetData_AssetDataRef_t assetRef;
         result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
                                            instanceRef->assetDataPtr->assetId,
@@ -2642,12 +3477,12 @@ static le_result_t SetString
 
         if ( result == LE_OK)
         {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
+            result = WriteNotifyObject(assetRef,
+                                       instanceRef->instanceId,
+                                       fieldId,
+                                       valueData,
+                                       sizeof(valueData),
+                                       &bytesWritten);
             if ( result != LE_OK )
             {
                 LE_ERROR("Failed to send lwm2m notification.");
@@ -2659,7 +3494,7 @@ static le_result_t SetString
                                         -1,
                                         -1,
                                         PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
+                                        NotifyContentType,
                                         fieldDataPtr->token,
                                         fieldDataPtr->tokenLength);
 
@@ -2806,6 +3641,21 @@ static assetData_FieldActionHandlerRef_t AddFieldActionHandler
 )
 {
     ActionHandlerData_t* newHandlerDataPtr;
+    IdKey_t key = { .ownerPtr = assetRef, .id = fieldId };
+
+    // Get the handlers of this field, creating the entry on the first handler.
+    FieldActionData_t* fieldActionPtr = le_hashmap_Get(FieldActionMap, &key);
+
+    if ( fieldActionPtr == NULL )
+    {
+        fieldActionPtr = le_mem_ForceAlloc(FieldActionDataPoolRef);
+        fieldActionPtr->key = key;
+        fieldActionPtr->handlerList = LE_DLS_LIST_INIT;
+        fieldActionPtr->link = LE_DLS_LINK_INIT;
+
+        le_dls_Queue(&assetRef->fieldActionList, &fieldActionPtr->link);
+        le_hashmap_Put(FieldActionMap, &fieldActionPtr->key, fieldActionPtr);
+    }
 
     newHandlerDataPtr = le_mem_ForceAlloc(ActionHandlerDataPoolRef);
     newHandlerDataPtr->fieldActionHandlerPtr = handlerPtr;
@@ -2814,7 +3664,7 @@ static assetData_FieldActionHandlerRef_t AddFieldActionHandler
     newHandlerDataPtr->isClient = isClient;
 
     newHandlerDataPtr->link = LE_DLS_LINK_INIT;
-    le_dls_Queue(&assetRef->fieldActionList, &newHandlerDataPtr->link);
+    le_dls_Queue(&fieldActionPtr->handlerList, &newHandlerDataPtr->link);
 
     // return something unique as a reference
     return (assetData_FieldActionHandlerRef_t)newHandlerDataPtr;
@@ -3066,6 +3916,10 @@ le_result_t assetData_CreateInstanceById
 
     le_dls_Queue(&assetDataPtr->instanceList, &assetInstPtr->link);
 
+    assetInstPtr->key.ownerPtr = assetDataPtr;
+    assetInstPtr->key.id = assetInstPtr->instanceId;
+    le_hashmap_Put(InstanceMap, &assetInstPtr->key, assetInstPtr);
+
     // todo: For now, for testing, print it out; add trace support later.
     if ( 0 )
         PrintAssetMap();
@@ -3191,19 +4045,25 @@ void assetData_DeleteInstance
         if (fieldDataPtr->timeSeriesPtr != NULL)
         {
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+            ReleaseTimeSeries(fieldDataPtr->timeSeriesPtr);
         }
 
         // Release the field.
         LE_DEBUG("Deleting field %s", fieldDataPtr->name);
+        RemoveFieldFromMaps(fieldDataPtr);
         le_mem_Release(fieldDataPtr);
 
         linkPtr = le_dls_Pop(&instanceRef->fieldList);
     }
 
+    if ( instanceRef->notifyTimerRef != NULL )
+    {
+        le_timer_Delete(instanceRef->notifyTimerRef);
+    }
+
     // Remove the instance from the asset instance list
     le_dls_Remove(&instanceRef->assetDataPtr->instanceList, &instanceRef->link);
+    le_hashmap_Remove(InstanceMap, &instanceRef->key);
 
     // Lastly, release the instance data.
     le_mem_Release(instanceRef);
@@ -3234,16 +4094,26 @@ void assetData_DeleteInstanceAndAsset
          */
 
         ActionHandlerData_t* handlerDataPtr;
+        FieldActionData_t* fieldActionPtr;
         le_dls_Link_t* linkPtr;
+        le_dls_Link_t* handlerLinkPtr;
 
-        // Get the first item from the handler list
+        // Get the first field from the field action list
         linkPtr = le_dls_Pop(&assetDataPtr->fieldActionList);
 
-        // Loop through the list, deleting each item
+        // Loop through the list, deleting each field and its handlers
         while ( linkPtr != NULL )
         {
-            handlerDataPtr = CONTAINER_OF(linkPtr, ActionHandlerData_t, link);
-            le_mem_Release(handlerDataPtr);
+            fieldActionPtr = CONTAINER_OF(linkPtr, FieldActionData_t, link);
+
+            while ( (handlerLinkPtr = le_dls_Pop(&fieldActionPtr->handlerList)) != NULL )
+            {
+                handlerDataPtr = CONTAINER_OF(handlerLinkPtr, ActionHandlerData_t, link);
+                le_mem_Release(handlerDataPtr);
+            }
+
+            le_hashmap_Remove(FieldActionMap, &fieldActionPtr->key);
+            le_mem_Release(fieldActionPtr);
 
             linkPtr = le_dls_Pop(&assetDataPtr->fieldActionList);
         }
@@ -3550,40 +4420,13 @@ le_result_t assetData_GetFieldIdFromName
     int* fieldIdPtr                             ///< [OUT] The field id
 )
 {
-    /*
-     * NOTE:
-     *   The main use for this function is to get the fieldId that is then passed to the various
-     *   assetData_client_Get* functions.  This is not particularly efficient as it requires
-     *   iterating twice through the field list.  One alternative would be to add a new set of
-     *   assetData_client_Get* functions that take a field name instead of field id.
-     *
-     *   For now, assume that the performance is good enough, but if it becomes an issue then
-     *   this second set of functions may need to be added.  Of course, there might also be some
-     *   other alternative solution that has not yet been considered.
-     */
+    NameKey_t key = { .ownerPtr = instanceRef, .namePtr = fieldNamePtr };
+    FieldData_t* fieldDataPtr = le_hashmap_Get(FieldNameMap, &key);
 
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
-
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceRef->fieldList);
-
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->appName);
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->assetName);
-
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    if ( fieldDataPtr != NULL )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%s", fieldDataPtr->name);
-
-        if ( strcmp(fieldDataPtr->name, fieldNamePtr) == 0 )
-        {
-            *fieldIdPtr = fieldDataPtr->fieldId;
-            return LE_OK;
-        }
-
-        fieldLinkPtr = le_dls_PeekNext(&instanceRef->fieldList, fieldLinkPtr);
+        *fieldIdPtr = fieldDataPtr->fieldId;
+        return LE_OK;
     }
 
     return LE_FAULT;
@@ -4002,24 +4845,85 @@ le_result_t assetData_client_IsObserve
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a handler to be notified on field actions, such as write or execute
+ * Start a batch of changes on an instance. Until the batch is pushed, the observe notifications of
+ * the changed fields are deferred.
  *
  * @return:
- *      - On success, reference for removing handler (with assetData_client_RemoveFieldActionHandler)
- *      - On error, NULL
+ *      - LE_OK on success
+ *      - LE_DUPLICATE if a batch is already started on this instance
  */
 //--------------------------------------------------------------------------------------------------
-assetData_FieldActionHandlerRef_t assetData_client_AddFieldActionHandler
+le_result_t assetData_client_StartBatch
 (
-    assetData_AssetDataRef_t assetRef,                  ///< [IN] Asset to monitor
-    int fieldId,                                        ///< [IN] Field within asset to monitor
-    assetData_FieldActionHandlerFunc_t handlerPtr,      ///< [IN] Handler to call upon action
-    void* contextPtr                                    ///< [IN] User specified context pointer
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
 )
 {
-    return AddFieldActionHandler(assetRef, fieldId, handlerPtr, contextPtr, true);
-}
-
+    if ( instanceRef->isBatchStarted )
+    {
+        return LE_DUPLICATE;
+    }
+
+    instanceRef->isBatchStarted = true;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the batch of changes started on an instance: the fields changed since the start of the
+ * batch are notified in a single observe notification, and the batch is ended.
+ *
+ * @return:
+ *      - LE_OK on success, or if no observed field has changed
+ *      - LE_NOT_PERMITTED if no batch is started on this instance
+ *      - LE_OVERFLOW if the changed fields don't fit in one notification
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_PushBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+)
+{
+    le_result_t result;
+
+    if ( !instanceRef->isBatchStarted )
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    instanceRef->isBatchStarted = false;
+
+    result = NotifyPendingFields(instanceRef);
+
+    // Restart the periodic notifications, if any.
+    ScheduleNotify(instanceRef);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler to be notified on field actions, such as write or execute
+ *
+ * @return:
+ *      - On success, reference for removing handler (with assetData_client_RemoveFieldActionHandler)
+ *      - On error, NULL
+ */
+//--------------------------------------------------------------------------------------------------
+assetData_FieldActionHandlerRef_t assetData_client_AddFieldActionHandler
+(
+    assetData_AssetDataRef_t assetRef,                  ///< [IN] Asset to monitor
+    int fieldId,                                        ///< [IN] Field within asset to monitor
+    assetData_FieldActionHandlerFunc_t handlerPtr,      ///< [IN] Handler to call upon action
+    void* contextPtr                                    ///< [IN] User specified context pointer
+)
+{
+    return AddFieldActionHandler(assetRef, fieldId, handlerPtr, contextPtr, true);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -4527,10 +5431,64 @@ le_result_t assetData_Init
     AssetDataPoolRef = le_mem_CreatePool("Asset data pool", sizeof(AssetData_t));
     ActionHandlerDataPoolRef = le_mem_CreatePool("Action handler data pool",
                                                  sizeof(ActionHandlerData_t));
+    FieldActionDataPoolRef = le_mem_CreatePool("Field action data pool",
+                                               sizeof(FieldActionData_t));
 
     // Memory pool for time series data.
     TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
-    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", sizeof(CborChunk_t));
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+    // Read the time series settings from config tree @ /apps/avcService/timeSeries
+    le_cfg_IteratorRef_t timeSeriesCfg = le_cfg_CreateReadTxn(TIME_SERIES_CFG);
+
+    int maxNumBytes = le_cfg_GetInt(timeSeriesCfg, "maxBytes", TIME_SERIES_DEFAULT_MAX_NUMBYTES);
+    if ((maxNumBytes < TIME_SERIES_MIN_MAX_NUMBYTES) ||
+        (maxNumBytes > TIME_SERIES_MAX_MAX_NUMBYTES))
+    {
+        LE_WARN("Invalid time series maxBytes %d, using %d",
+                maxNumBytes, TIME_SERIES_DEFAULT_MAX_NUMBYTES);
+        maxNumBytes = TIME_SERIES_DEFAULT_MAX_NUMBYTES;
+    }
+    TimeSeriesMaxNumBytes = maxNumBytes;
+
+    TimeSeriesCompressionLevel = le_cfg_GetInt(timeSeriesCfg,
+                                               "compressionLevel",
+                                               Z_BEST_COMPRESSION);
+    if ((TimeSeriesCompressionLevel < Z_NO_COMPRESSION) ||
+        (TimeSeriesCompressionLevel > Z_BEST_COMPRESSION))
+    {
+        LE_WARN("Invalid time series compressionLevel %d, using %d",
+                TimeSeriesCompressionLevel, Z_BEST_COMPRESSION);
+        TimeSeriesCompressionLevel = Z_BEST_COMPRESSION;
+    }
+
+    le_cfg_CancelTxn(timeSeriesCfg);
+
+    // A pushed time series is compressed at once, in a buffer large enough for the worst case.
+    CompressedBufferPoolRef = le_mem_CreatePool("Compressed buffer pool",
+                                                compressBound(TimeSeriesMaxNumBytes));
+
+    // Read the notification format from config tree @ /apps/avcService/notify
+    le_cfg_IteratorRef_t notifyCfg = le_cfg_CreateReadTxn(NOTIFY_CFG);
+    char format[32];
+
+    if (le_cfg_GetString(notifyCfg, "format", format, sizeof(format), "tlv") != LE_OK)
+    {
+        format[0] = '\0';
+    }
+
+    if (strcmp(format, "senml-cbor") == 0)
+    {
+        NotifyContentType = SENML_CBOR_ENCODING;
+    }
+    else if (strcmp(format, "tlv") != 0)
+    {
+        LE_WARN("Invalid notification format '%s', using TLV", format);
+    }
+
+    le_cfg_CancelTxn(notifyCfg);
+#endif
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
@@ -4544,6 +5502,12 @@ le_result_t assetData_Init
                                        le_hashmap_HashString,
                                        le_hashmap_EqualsString);
 
+    // Create the maps indexing the instances, fields and field action handlers of the assets.
+    InstanceMap = le_hashmap_Create("Asset Instance Map", 31, HashIdKey, EqualsIdKey);
+    FieldMap = le_hashmap_Create("Asset Field Map", 127, HashIdKey, EqualsIdKey);
+    FieldNameMap = le_hashmap_Create("Asset Field Name Map", 127, HashNameKey, EqualsNameKey);
+    FieldActionMap = le_hashmap_Create("Field Action Map", 31, HashIdKey, EqualsIdKey);
+
 
     // Use a timer to delay reporting instance creation events to the modem for 15 seconds after
     // the last creation event. This allows us to aggregate multiple registration updates together.
@@ -5114,6 +6078,513 @@ static le_result_t WriteNotifyObjectToTLV
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the TLV of an instance including only the resources which changed since the start of the
+ *  batch, and clear their pending notification.
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyBatchToTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance with changed resources
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr,                 ///< [OUT] # bytes written to buffer.
+    FieldData_t** notifyFieldPtrPtr             ///< [OUT] One of the changed fields, or NULL
+)
+{
+    le_result_t result = LE_OK;
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    size_t totalNumBytesWritten = 0;
+    size_t numBytesWritten;
+    uint8_t tmpBuffer[BATCH_NOTIFY_NUMBYTES];
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    *notifyFieldPtrPtr = NULL;
+
+    // Write the TLVs of the changed fields first, to know how many bytes will be in the
+    // instance TLV.
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isNotifyPending )
+        {
+            fieldDataPtr->isNotifyPending = false;
+
+            // Observe may have been cancelled since the change.
+            if ( fieldDataPtr->isObserve && (result == LE_OK) )
+            {
+                result = WriteFieldTLV(instanceRef,
+                                       fieldDataPtr,
+                                       tmpBuffer + totalNumBytesWritten,
+                                       sizeof(tmpBuffer) - totalNumBytesWritten,
+                                       &numBytesWritten);
+
+                if ( result == LE_OK )
+                {
+                    totalNumBytesWritten += numBytesWritten;
+                    *notifyFieldPtrPtr = fieldDataPtr;
+
+                    GetNumericValue(fieldDataPtr, &fieldDataPtr->lastNotifyValue);
+                    fieldDataPtr->lastNotifyTime = now;
+                }
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    if ( result != LE_OK )
+    {
+        LE_WARN("Overflow: oiid=%i", instanceRef->instanceId);
+        *numBytesWrittenPtr = 0;
+        return result;
+    }
+
+    // Ensure that all the TLV data will fit, plus 6 bytes for the instance header.
+    if ( totalNumBytesWritten + 6 > bufNumBytes )
+    {
+        LE_WARN("Overflow: oiid=%i", instanceRef->instanceId);
+        *numBytesWrittenPtr = 0;
+        return LE_OVERFLOW;
+    }
+
+    WriteTLVHeader(TLV_TYPE_OBJ_INST,
+                   instanceRef->instanceId,
+                   totalNumBytesWritten,
+                   bufPtr,
+                   bufNumBytes,
+                   &numBytesWritten);
+
+    memcpy(bufPtr + numBytesWritten, tmpBuffer, totalNumBytesWritten);
+    *numBytesWrittenPtr = numBytesWritten + totalNumBytesWritten;
+
+    return LE_OK;
+}
+
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SenML labels used in LWM2M SenML CBOR records, encoded as the integer keys of RFC 8428 table 6.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_BASE_NAME     -2
+#define SENML_BASE_TIME     -3
+#define SENML_NAME          0
+#define SENML_VALUE         2
+#define SENML_STRING_VALUE  3
+#define SENML_BOOL_VALUE    4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a tinyCBOR encoder error to a result code.
+ *
+ * @return:
+ *      - LE_OK if there was no error
+ *      - LE_OVERFLOW if the encoded data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SenmlResult
+(
+    CborError err                       ///< [IN] Encoder error
+)
+{
+    if ( err == CborNoError )
+    {
+        return LE_OK;
+    }
+
+    if ( err == CborErrorOutOfMemory )
+    {
+        return LE_OVERFLOW;
+    }
+
+    LE_ERROR("CBOR encoding error %s", cbor_error_string(err));
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode one SenML record holding the value of a LWM2M resource.  The first record of a pack also
+ * carries the base name, i.e. the path of the object instance, and the base time.
+ *
+ * @return The tinyCBOR encoder error.
+ */
+//--------------------------------------------------------------------------------------------------
+static CborError EncodeSenmlRecord
+(
+    CborEncoder* packPtr,               ///< [IN] Encoder of the SenML pack (array of records)
+    const char* baseNamePtr,            ///< [IN] Base name, or NULL if not the first record
+    double baseTime,                    ///< [IN] Base time (only used with the base name)
+    FieldData_t* fieldDataPtr           ///< [IN] The resource
+)
+{
+    CborEncoder record;
+    CborError err;
+    char name[12];
+
+    if ( fieldDataPtr->type == DATA_TYPE_NONE )
+    {
+        LE_ERROR("No data to read");
+        return CborErrorUnknownType;
+    }
+
+    snprintf(name, sizeof(name), "%d", fieldDataPtr->fieldId);
+
+    err = cbor_encoder_create_map(packPtr, &record, (baseNamePtr != NULL) ? 4 : 2);
+
+    if ( (err == CborNoError) && (baseNamePtr != NULL) )
+    {
+        err = cbor_encode_int(&record, SENML_BASE_NAME);
+        if ( err == CborNoError )
+        {
+            err = cbor_encode_text_stringz(&record, baseNamePtr);
+        }
+        if ( err == CborNoError )
+        {
+            err = cbor_encode_int(&record, SENML_BASE_TIME);
+        }
+        if ( err == CborNoError )
+        {
+            err = cbor_encode_double(&record, baseTime);
+        }
+    }
+
+    if ( err == CborNoError )
+    {
+        err = cbor_encode_int(&record, SENML_NAME);
+    }
+    if ( err == CborNoError )
+    {
+        err = cbor_encode_text_stringz(&record, name);
+    }
+
+    if ( err == CborNoError )
+    {
+        switch ( fieldDataPtr->type )
+        {
+            case DATA_TYPE_INT:
+                err = cbor_encode_int(&record, SENML_VALUE);
+                if ( err == CborNoError )
+                {
+                    err = cbor_encode_int(&record, fieldDataPtr->intValue);
+                }
+                break;
+
+            case DATA_TYPE_FLOAT:
+                err = cbor_encode_int(&record, SENML_VALUE);
+                if ( err == CborNoError )
+                {
+                    err = cbor_encode_double(&record, fieldDataPtr->floatValue);
+                }
+                break;
+
+            case DATA_TYPE_BOOL:
+                err = cbor_encode_int(&record, SENML_BOOL_VALUE);
+                if ( err == CborNoError )
+                {
+                    err = cbor_encode_boolean(&record, fieldDataPtr->boolValue);
+                }
+                break;
+
+            default:
+                err = cbor_encode_int(&record, SENML_STRING_VALUE);
+                if ( err == CborNoError )
+                {
+                    err = cbor_encode_text_stringz(&record, fieldDataPtr->strValuePtr);
+                }
+                break;
+        }
+    }
+
+    if ( err == CborNoError )
+    {
+        err = cbor_encoder_close_container(packPtr, &record);
+    }
+
+    return err;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the SenML base name of an object instance, and the current time as SenML base time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSenmlBase
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance
+    char* baseNamePtr,                          ///< [OUT] Base name, "/<object>/<instance>/"
+    size_t baseNameNumBytes,                    ///< [IN] Size of the base name buffer
+    double* baseTimePtr                         ///< [OUT] Base time, in seconds since the epoch
+)
+{
+    le_clk_Time_t now = le_clk_GetAbsoluteTime();
+
+    snprintf(baseNamePtr,
+             baseNameNumBytes,
+             "/%d/%d/",
+             instanceRef->assetDataPtr->assetId,
+             instanceRef->instanceId);
+
+    *baseTimePtr = (double)now.sec + ((double)now.usec / 1000000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the SenML CBOR pack of a changed resource.  The SenML equivalent of
+ *  WriteNotifyObjectToTLV().
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyObjectToSenmlCbor
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int instanceId,                             ///< [IN] Instance that has a changed resource
+    int fieldId,                                ///< [IN] The resource which changed
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the SenML pack
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    InstanceData_t* instancePtr;
+    FieldData_t* fieldDataPtr;
+    CborEncoder stream;
+    CborEncoder pack;
+    CborError err;
+    char baseName[32];
+    double baseTime;
+
+    if ( (GetInstanceFromAssetData(assetRef, instanceId, &instancePtr) != LE_OK) ||
+         (GetFieldFromInstance(instancePtr, fieldId, &fieldDataPtr) != LE_OK) )
+    {
+        LE_ERROR("Error reading resource %d/%d.", instanceId, fieldId);
+        return LE_FAULT;
+    }
+
+    GetSenmlBase(instancePtr, baseName, sizeof(baseName), &baseTime);
+
+    cbor_encoder_init(&stream, bufPtr, bufNumBytes, 0);
+
+    err = cbor_encoder_create_array(&stream, &pack, 1);
+    if ( err == CborNoError )
+    {
+        err = EncodeSenmlRecord(&pack, baseName, baseTime, fieldDataPtr);
+    }
+    if ( err == CborNoError )
+    {
+        err = cbor_encoder_close_container(&stream, &pack);
+    }
+
+    if ( SenmlResult(err) != LE_OK )
+    {
+        LE_ERROR("Error while encoding resource %d/%d.", instanceId, fieldId);
+        return LE_FAULT;
+    }
+
+    *numBytesWrittenPtr = cbor_encoder_get_buffer_size(&stream, bufPtr);
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the SenML CBOR pack of the resources of an instance which changed since the start of the
+ *  batch, and clear their pending notification.  The SenML equivalent of WriteNotifyBatchToTLV().
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the SenML data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyBatchToSenmlCbor
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance with changed resources
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the SenML pack
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr,                 ///< [OUT] # bytes written to buffer.
+    FieldData_t** notifyFieldPtrPtr             ///< [OUT] One of the changed fields, or NULL
+)
+{
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    CborEncoder stream;
+    CborEncoder pack;
+    CborError err;
+    size_t numRecords = 0;
+    char baseName[32];
+    double baseTime;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    *notifyFieldPtrPtr = NULL;
+    *numBytesWrittenPtr = 0;
+
+    // Count the records first, so that the pack can be encoded as a definite length array.
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        // Observe may have been cancelled since the change.
+        if ( fieldDataPtr->isNotifyPending && fieldDataPtr->isObserve )
+        {
+            numRecords++;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    GetSenmlBase(instanceRef, baseName, sizeof(baseName), &baseTime);
+
+    cbor_encoder_init(&stream, bufPtr, bufNumBytes, 0);
+    err = cbor_encoder_create_array(&stream, &pack, numRecords);
+
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        if ( fieldDataPtr->isNotifyPending )
+        {
+            fieldDataPtr->isNotifyPending = false;
+
+            if ( fieldDataPtr->isObserve && (err == CborNoError) )
+            {
+                err = EncodeSenmlRecord(&pack,
+                                        (*notifyFieldPtrPtr == NULL) ? baseName : NULL,
+                                        baseTime,
+                                        fieldDataPtr);
+
+                if ( err == CborNoError )
+                {
+                    *notifyFieldPtrPtr = fieldDataPtr;
+
+                    GetNumericValue(fieldDataPtr, &fieldDataPtr->lastNotifyValue);
+                    fieldDataPtr->lastNotifyTime = now;
+                }
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    if ( err == CborNoError )
+    {
+        err = cbor_encoder_close_container(&stream, &pack);
+    }
+
+    le_result_t result = SenmlResult(err);
+    if ( result != LE_OK )
+    {
+        LE_WARN("Overflow: oiid=%i", instanceRef->instanceId);
+        return result;
+    }
+
+    *numBytesWrittenPtr = cbor_encoder_get_buffer_size(&stream, bufPtr);
+    return LE_OK;
+}
+
+#endif // LEGATO_FEATURE_TIMESERIES
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the notification of a changed resource, in the configured notification content type.
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyObject
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int instanceId,                             ///< [IN] Instance that has a changed resource
+    int fieldId,                                ///< [IN] The resource which changed
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the notification
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+    if ( NotifyContentType == SENML_CBOR_ENCODING )
+    {
+        return WriteNotifyObjectToSenmlCbor(assetRef,
+                                            instanceId,
+                                            fieldId,
+                                            bufPtr,
+                                            bufNumBytes,
+                                            numBytesWrittenPtr);
+    }
+#endif
+
+    return WriteNotifyObjectToTLV(assetRef,
+                                  instanceId,
+                                  fieldId,
+                                  bufPtr,
+                                  bufNumBytes,
+                                  numBytesWrittenPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write the notification of the resources of an instance which changed since the start of the
+ *  batch, in the configured notification content type, and clear their pending notification.
+ *
+ *  @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the notification could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNotifyBatch
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance with changed resources
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the notification
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr,                 ///< [OUT] # bytes written to buffer.
+    FieldData_t** notifyFieldPtrPtr             ///< [OUT] One of the changed fields, or NULL
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+    if ( NotifyContentType == SENML_CBOR_ENCODING )
+    {
+        return WriteNotifyBatchToSenmlCbor(instanceRef,
+                                           bufPtr,
+                                           bufNumBytes,
+                                           numBytesWrittenPtr,
+                                           notifyFieldPtrPtr);
+    }
+#endif
+
+    return WriteNotifyBatchToTLV(instanceRef,
+                                 bufPtr,
+                                 bufNumBytes,
+                                 numBytesWrittenPtr,
+                                 notifyFieldPtrPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read an integer of the given size and in network byte order from the buffer
@@ -5386,16 +6857,229 @@ le_result_t assetData_SetObserve
                 fieldDataPtr->tokenLength = tokenLength;
                 memcpy(fieldDataPtr->token, tokenPtr, tokenLength);
             }
+
+            // The server reads the current value along with the observe request.
+            GetNumericValue(fieldDataPtr, &fieldDataPtr->lastNotifyValue);
+            fieldDataPtr->lastNotifyTime = le_clk_GetRelativeTime();
+
             result = LE_OK;
         }
 
         linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
     }
 
+    // Start or stop the periodic notifications, if any.
+    ScheduleNotify(instanceRef);
+
     return result;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse LwM2M notification attributes, given as a Write-Attributes query string such as
+ * "pmin=10&pmax=60&st=0.5", and update the attributes accordingly. An attribute without a value
+ * is removed. Unknown attributes are ignored.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the string is malformed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseNotifyAttributes
+(
+    const char* attrPtr,                ///< [IN] Notification attributes query string
+    NotifyAttr_t* notifyAttrPtr         ///< [IN/OUT] Attributes to update
+)
+{
+    char buffer[LIMIT_MAX_PATH_BYTES];
+    char* savePtr;
+    char* namePtr;
+    char* valuePtr;
+    char* endPtr;
+    double value;
+    NotifyAttrBitMask_t bit;
+
+    if ( le_utf8_Copy(buffer, attrPtr, sizeof(buffer), NULL) != LE_OK )
+    {
+        return LE_FAULT;
+    }
+
+    for ( namePtr = strtok_r(buffer, "&", &savePtr);
+          namePtr != NULL;
+          namePtr = strtok_r(NULL, "&", &savePtr) )
+    {
+        valuePtr = strchr(namePtr, '=');
+        if ( valuePtr != NULL )
+        {
+            *valuePtr++ = '\0';
+        }
+
+        if ( strcmp(namePtr, "pmin") == 0 )
+            bit = NOTIFY_ATTR_PMIN;
+        else if ( strcmp(namePtr, "pmax") == 0 )
+            bit = NOTIFY_ATTR_PMAX;
+        else if ( strcmp(namePtr, "gt") == 0 )
+            bit = NOTIFY_ATTR_GT;
+        else if ( strcmp(namePtr, "lt") == 0 )
+            bit = NOTIFY_ATTR_LT;
+        else if ( strcmp(namePtr, "st") == 0 )
+            bit = NOTIFY_ATTR_ST;
+        else
+        {
+            LE_WARN("Ignoring notification attribute '%s'", namePtr);
+            continue;
+        }
+
+        if ( (valuePtr == NULL) || (*valuePtr == '\0') )
+        {
+            notifyAttrPtr->mask &= ~bit;
+            continue;
+        }
+
+        value = strtod(valuePtr, &endPtr);
+        if ( *endPtr != '\0' )
+        {
+            LE_ERROR("Invalid value '%s' of notification attribute '%s'", valuePtr, namePtr);
+            return LE_FAULT;
+        }
+
+        switch ( bit )
+        {
+            case NOTIFY_ATTR_PMIN:
+            case NOTIFY_ATTR_PMAX:
+                if ( (value < 0) || (value > UINT32_MAX) || (value != (uint32_t)value) )
+                {
+                    LE_ERROR("Invalid period '%s' of notification attribute '%s'",
+                             valuePtr, namePtr);
+                    return LE_FAULT;
+                }
+
+                if ( bit == NOTIFY_ATTR_PMIN )
+                    notifyAttrPtr->pmin = (uint32_t)value;
+                else
+                    notifyAttrPtr->pmax = (uint32_t)value;
+                break;
+
+            case NOTIFY_ATTR_GT:
+                notifyAttrPtr->gt = value;
+                break;
+
+            case NOTIFY_ATTR_LT:
+                notifyAttrPtr->lt = value;
+                break;
+
+            case NOTIFY_ATTR_ST:
+                if ( value < 0 )
+                {
+                    LE_ERROR("Invalid step '%s'", valuePtr);
+                    return LE_FAULT;
+                }
+                notifyAttrPtr->st = value;
+                break;
+        }
+
+        notifyAttrPtr->mask |= bit;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the LwM2M notification attributes (pmin, pmax, gt, lt, st) of a field, or of all the
+ * observable fields of an instance. Changes of fields with attributes are notified in a single
+ * notification per instance, no sooner than pmin seconds after the previous notification, and at
+ * least every pmax seconds. The changes of numeric fields not crossing gt or lt, or smaller than
+ * st, are not notified.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the field is not found
+ *      - LE_FAULT if the attributes are malformed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributes
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to use, or -1 for all fields
+    const char* attrPtr                         ///< [IN] Notification attributes query string
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    NotifyAttr_t notifyAttr = { .mask = 0 };
+
+    // Validate the attributes before updating any field.
+    if ( ParseNotifyAttributes(attrPtr, &notifyAttr) != LE_OK )
+    {
+        return LE_FAULT;
+    }
+
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        // Only the resources which can be observed get notification attributes.
+        if ( ( (fieldId == -1) && (fieldDataPtr->access & ACCESS_WRITE) ) ||
+             ( fieldDataPtr->fieldId == fieldId ) )
+        {
+            ParseNotifyAttributes(attrPtr, &fieldDataPtr->notifyAttr);
+            result = LE_OK;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
+    }
+
+    ScheduleNotify(instanceRef);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the LwM2M notification attributes of the observable fields of all instances of an asset.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the attributes are malformed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributesAllInstances
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    const char* attrPtr                         ///< [IN] Notification attributes query string
+)
+{
+    le_dls_Link_t* linkPtr;
+    InstanceData_t* instancePtr;
+    NotifyAttr_t notifyAttr = { .mask = 0 };
+
+    if ( ParseNotifyAttributes(attrPtr, &notifyAttr) != LE_OK )
+    {
+        return LE_FAULT;
+    }
+
+    linkPtr = le_dls_Peek(&assetRef->instanceList);
+
+    while ( linkPtr != NULL )
+    {
+        instancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
+
+        assetData_SetNotifyAttributes(instancePtr, -1, attrPtr);
+
+        linkPtr = le_dls_PeekNext(&assetRef->instanceList, linkPtr);
+    }
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Is Observe flag set for object9 state and result fields.
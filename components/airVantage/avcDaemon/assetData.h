@@ -989,6 +989,44 @@ le_result_t assetData_SetObserveAllInstances
     uint8_t tokenLength                         ///< [IN] Token Length
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the LwM2M notification attributes (pmin, pmax, gt, lt, st) of a field, or of all the
+ * observable fields of an instance. Changes of fields with attributes are notified in a single
+ * notification per instance, no sooner than pmin seconds after the previous notification, and at
+ * least every pmax seconds. The changes of numeric fields not crossing gt or lt, or smaller than
+ * st, are not notified.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the field is not found
+ *      - LE_FAULT if the attributes are malformed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributes
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to use, or -1 for all fields
+    const char* attrPtr                         ///< [IN] Notification attributes query string
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the LwM2M notification attributes of the observable fields of all instances of an asset.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the attributes are malformed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_SetNotifyAttributesAllInstances
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    const char* attrPtr                         ///< [IN] Notification attributes query string
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Is Observe flag set for object9 state and result fields.
@@ -1111,6 +1149,40 @@ le_result_t assetData_client_IsObserve
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of changes on an instance. Until the batch is pushed, the observe notifications of
+ * the changed fields are deferred.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_DUPLICATE if a batch is already started on this instance
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_StartBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the batch of changes started on an instance: the fields changed since the start of the
+ * batch are notified in a single observe notification, and the batch is ended.
+ *
+ * @return:
+ *      - LE_OK on success, or if no observed field has changed
+ *      - LE_NOT_PERMITTED if no batch is started on this instance
+ *      - LE_OVERFLOW if the changed fields don't fit in one notification
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_PushBatch
+(
+    assetData_InstanceDataRef_t instanceRef     ///< [IN] Asset instance to use
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a registration update to the server.
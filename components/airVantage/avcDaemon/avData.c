@@ -1036,6 +1036,67 @@ le_result_t le_avdata_IsObserve
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of changes on an asset instance. Until the batch is pushed with
+ * le_avdata_PushBatch(), the observe notifications of the fields set on this instance are deferred.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_DUPLICATE if a batch is already started on this instance
+ *
+ * @note client will be terminated if instRef isn't valid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_avdata_StartBatch
+(
+    le_avdata_AssetInstanceRef_t instRef
+        ///< [IN]
+)
+{
+    // Map safeRef to desired data
+    instRef = GetInstRefFromSafeRef(instRef, __func__);
+
+    return assetData_client_StartBatch(instRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the batch of changes started on an asset instance. All the observed fields changed since
+ * the start of the batch are sent in a single notification, and the batch is ended.
+ *
+ * @return
+ *      - LE_OK on success, or if no observed field has changed
+ *      - LE_NOT_PERMITTED if no batch is started on this instance
+ *      - LE_OVERFLOW if the changed fields don't fit in one notification
+ *      - LE_FAULT on any other error
+ *
+ * @note client will be terminated if instRef isn't valid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_avdata_PushBatch
+(
+    le_avdata_AssetInstanceRef_t instRef
+        ///< [IN]
+)
+{
+    le_result_t result;
+
+    // Map safeRef to desired data
+    instRef = GetInstRefFromSafeRef(instRef, __func__);
+
+    result = assetData_client_PushBatch(instRef);
+
+    if ( (result != LE_OK) && (result != LE_NOT_PERMITTED) )
+    {
+        LE_ERROR("Error pushing the batch of changes");
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Allocate resources and start accumulating time series data on the specified field.
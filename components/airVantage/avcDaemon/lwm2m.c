@@ -363,11 +363,57 @@ static void OperationHandler
         return;
     }
 
+    // Write attributes with an objInstId of -1 means, write attributes of all instances.
+    if ( (opType == PA_AVC_OPTYPE_WRITE_ATTR) && (objInstId == -1) )
+    {
+        LE_DEBUG("PA_AVC_OPTYPE_WRITE_ATTR %s/%d", newPrefixPtr, objId);
+
+        assetData_AssetDataRef_t assetRef;
+
+        result = assetData_GetAssetRefById(newPrefixPtr, objId, &assetRef);
+
+        if ( result == LE_NOT_FOUND )
+            opErr = PA_AVC_OPERR_OBJ_UNSUPPORTED;
+        else if ( result != LE_OK )
+            opErr = PA_AVC_OPERR_INTERNAL;
+
+        if ( opErr != PA_AVC_OPERR_NO_ERROR )
+        {
+            LE_ERROR("Failed to read AssetRef.");
+            pa_avc_OperationReportError(opRef, opErr);
+            return;
+        }
+
+        // The payload is the attributes query string, e.g. "pmin=10&pmax=60", which can't be
+        // guaranteed to be null terminated, so copy it to the local buffer.
+        if ( payloadLength >= sizeof(ValueData) )
+        {
+            pa_avc_OperationReportError(opRef, PA_AVC_OPERR_OVERFLOW);
+            return;
+        }
+
+        memcpy(ValueData, payloadPtr, payloadLength);
+        ValueData[payloadLength] = 0;
+
+        result = assetData_SetNotifyAttributesAllInstances(assetRef, (const char*)ValueData);
+
+        if ( result != LE_OK )
+        {
+            LE_ERROR("Failed to write the notification attributes.");
+            pa_avc_OperationReportError(opRef, PA_AVC_OPERR_INTERNAL);
+            return;
+        }
+
+        pa_avc_OperationReportSuccess(opRef, NULL, 0);
+        return;
+    }
+
     // These operations all need a valid instanceRef.  Ensure that the specified instance exists,
     // and get the instanceRef; this check is common across several of the opTypes.
     if ( (opType == PA_AVC_OPTYPE_READ) ||
          (opType == PA_AVC_OPTYPE_WRITE) ||
          (opType == PA_AVC_OPTYPE_EXECUTE) ||
+         (opType == PA_AVC_OPTYPE_WRITE_ATTR) ||
          (opType == PA_AVC_OPTYPE_DELETE))
     {
         result = assetData_GetInstanceRefById(newPrefixPtr, objId, objInstId, &instRef);
@@ -492,6 +538,36 @@ static void OperationHandler
             break;
 
 
+        case PA_AVC_OPTYPE_WRITE_ATTR:
+            LE_DEBUG("PA_AVC_OPTYPE_WRITE_ATTR %s/%d/%d/%d",
+                     newPrefixPtr, objId, objInstId, resourceId);
+
+            if ( payloadLength >= sizeof(ValueData) )
+            {
+                pa_avc_OperationReportError(opRef, PA_AVC_OPERR_OVERFLOW);
+                return;
+            }
+
+            // The payload is the attributes query string; null terminate it.
+            memcpy(ValueData, payloadPtr, payloadLength);
+            ValueData[payloadLength] = 0;
+
+            result = assetData_SetNotifyAttributes(instRef, resourceId, (const char*)ValueData);
+            if ( result == LE_NOT_FOUND )
+                opErr = PA_AVC_OPERR_RESOURCE_UNSUPPORTED;
+            else if ( result != LE_OK )
+                opErr = PA_AVC_OPERR_INTERNAL;
+
+            if ( opErr != PA_AVC_OPERR_NO_ERROR )
+            {
+                pa_avc_OperationReportError(opRef, opErr);
+                return;
+            }
+
+            pa_avc_OperationReportSuccess(opRef, NULL, 0);
+            break;
+
+
         case PA_AVC_OPTYPE_EXECUTE:
             LE_DEBUG("PA_AVC_OPTYPE_EXEC %s/%d/%d/%d", newPrefixPtr, objId, objInstId, resourceId);
 
@@ -66,6 +66,14 @@
 #define TLV_ENCODING    1542
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Content type: SenML CBOR encoding (LWM2M 1.1, RFC 8428), used only for notify messages.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_CBOR_ENCODING    112
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The possible actions to take after receiving a pending download or install notification.
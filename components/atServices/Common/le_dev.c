@@ -10,6 +10,7 @@
 #include "le_dev.h"
 #include <pwd.h>
 #include <grp.h>
+#include <sys/ioctl.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -185,27 +186,33 @@ static void PrintBuffer
         }
 
         char string[dataLen];
-        memset(string, 0, dataLen);
+        char* outPtr = string;
 
+        // Append as we go, rather than formatting each character after a strlen() of the whole
+        // string so far.
         for(i=0;i<bufferSize;i++)
         {
             if (bufferPtr[i] == '\r' )
             {
-                snprintf(string+strlen(string), dataLen-strlen(string), "<CR>");
+                memcpy(outPtr, "<CR>", 4);
+                outPtr += 4;
             }
             else if (bufferPtr[i] == '\n')
             {
-                snprintf(string+strlen(string), dataLen-strlen(string), "<LF>");
+                memcpy(outPtr, "<LF>", 4);
+                outPtr += 4;
             }
             else if (bufferPtr[i] == 0x1A)
             {
-                snprintf(string+strlen(string), dataLen-strlen(string), "<CTRL+Z>");
+                memcpy(outPtr, "<CTRL+Z>", 8);
+                outPtr += 8;
             }
             else
             {
-                snprintf(string+strlen(string), dataLen-strlen(string), "%c", bufferPtr[i]);
+                *outPtr++ = bufferPtr[i];
             }
         }
+        *outPtr = '\0';
 
         if (GetDeviceInformation())
         {
@@ -296,7 +303,7 @@ ssize_t le_dev_Read
     count = read(devicePtr->fd, rxDataPtr, size);
     if (-1 == count)
     {
-        LE_ERROR("read error: %s", StrError(errno));
+        LE_ERROR_RATELIMITED("read error: %s", StrError(errno));
         return -1;
     }
 
@@ -305,6 +312,74 @@ ssize_t le_dev_Read
     return count;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to read the data available on device (or port) into an Rx buffer.
+ * The data are read with a single read(), sized to the number of bytes available.
+ *
+ * If the bytes still needed had to be moved to make room, the start and end offsets of the Rx
+ * buffer are decreased, and any offset into the buffer kept by the reader must be decreased by
+ * the value returned in shiftPtr.
+ *
+ * @return byte number read, or -1 on error (or if the Rx buffer is full)
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_dev_ReadRxBuffer
+(
+    Device_t*           devicePtr,    ///< device pointer
+    le_dev_RxBuffer_t*  rxBufferPtr,  ///< Rx buffer to read into
+    size_t*             shiftPtr      ///< [OUT] how many bytes the buffer content was moved by
+)
+{
+    int available = 0;
+    ssize_t count;
+
+    *shiftPtr = 0;
+
+    // If the number of bytes available is unknown, read as much as possible.
+    if ((ioctl(devicePtr->fd, FIONREAD, &available) == -1) || (available <= 0))
+    {
+        available = rxBufferPtr->size;
+    }
+
+    // Only move the bytes still needed when the room after them is too small.
+    if (((rxBufferPtr->size - rxBufferPtr->end) < (size_t)available) && (rxBufferPtr->start > 0))
+    {
+        memmove(rxBufferPtr->dataPtr,
+                rxBufferPtr->dataPtr + rxBufferPtr->start,
+                rxBufferPtr->end - rxBufferPtr->start);
+
+        *shiftPtr = rxBufferPtr->start;
+        rxBufferPtr->end -= rxBufferPtr->start;
+        rxBufferPtr->start = 0;
+    }
+
+    size_t size = rxBufferPtr->size - rxBufferPtr->end;
+    if (0 == size)
+    {
+        LE_ERROR_RATELIMITED("Rx buffer of fd %d is full!", devicePtr->fd);
+        return -1;
+    }
+
+    if ((size_t)available < size)
+    {
+        size = available;
+    }
+
+    count = read(devicePtr->fd, rxBufferPtr->dataPtr + rxBufferPtr->end, size);
+    if (-1 == count)
+    {
+        LE_ERROR_RATELIMITED("read error: %s", StrError(errno));
+        return -1;
+    }
+
+    PrintBuffer(devicePtr->fd, rxBufferPtr->dataPtr + rxBufferPtr->end, count);
+
+    rxBufferPtr->end += count;
+
+    return count;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to write on device (or port)
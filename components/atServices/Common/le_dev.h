@@ -21,6 +21,24 @@ typedef struct Device
 }
 Device_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer receiving the data read on a device, which the reader parses in place.
+ *
+ * The reader tells which bytes it still needs by moving the start offset.  The bytes before it
+ * are only reclaimed when there isn't enough room left after the end offset for the next read:
+ * the bytes still needed are then moved to the beginning of the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t*    dataPtr;      ///< Buffer storage
+    size_t      size;         ///< Size of the buffer storage
+    size_t      start;        ///< Offset of the first byte still needed by the reader
+    size_t      end;          ///< Offset following the last byte read
+}
+le_dev_RxBuffer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called when we want to read on device (or port)
@@ -35,6 +53,25 @@ ssize_t le_dev_Read
     size_t      size          ///< size of buffer
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to read the data available on device (or port) into an Rx buffer.
+ * The data are read with a single read(), sized to the number of bytes available.
+ *
+ * If the bytes still needed had to be moved to make room, the start and end offsets of the Rx
+ * buffer are decreased, and any offset into the buffer kept by the reader must be decreased by
+ * the value returned in shiftPtr.
+ *
+ * @return byte number read, or -1 on error (or if the Rx buffer is full)
+ */
+//--------------------------------------------------------------------------------------------------
+ssize_t le_dev_ReadRxBuffer
+(
+    Device_t*           devicePtr,    ///< device pointer
+    le_dev_RxBuffer_t*  rxBufferPtr,  ///< Rx buffer to read into
+    size_t*             shiftPtr      ///< [OUT] how many bytes the buffer content was moved by
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to write on device (or port)
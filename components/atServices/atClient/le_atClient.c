@@ -106,6 +106,22 @@
 //--------------------------------------------------------------------------------------------------
 #define UNSOLICITED_POOL_SIZE 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited pattern trie node pool size
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNSOLICITED_NODE_POOL_SIZE 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets of the command latency histogram.  Bucket 0 counts the commands answered in
+ * less than 1 ms, bucket n those answered in [2^(n-1), 2^n) ms, and the last bucket all the
+ * slower ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LATENCY_BUCKETS 17
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rx Buffer length
@@ -201,8 +217,8 @@ ClientState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    char            line[LE_ATDEFS_RESPONSE_MAX_BYTES]; ///< string value
     le_dls_Link_t   link;                               ///< link for list
+    char            line[];                             ///< string value
 }
 RspString_t;
 
@@ -215,8 +231,8 @@ RspString_t;
 typedef struct RxData
 {
     uint8_t  buffer[PARSER_BUFFER_MAX_BYTES];///< buffer read
+    le_dev_RxBuffer_t rxBuffer;              ///< read state of the buffer (idx<rxBuffer.end)
     int32_t  idx;                            ///< index of parsing the buffer
-    size_t   endBuffer;                      ///< index where the read was finished (idx<endbuffer)
     int32_t  idxLastCrLf;                    ///< index where the last CRLF has been found
 }
 RxData_t;
@@ -249,22 +265,42 @@ RxParser_t;
  *
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Unsolicited
 {
     le_atClient_UnsolicitedResponseHandlerFunc_t handlerPtr;    ///< Unsolicited handler
     void*         contextPtr;                                   ///< User context
     char          unsolRsp[LE_ATDEFS_UNSOLICITED_MAX_BYTES];    ///< pattern to match
     char          unsolBuffer[LE_ATDEFS_UNSOLICITED_MAX_BYTES]; ///< Unsolicited buffer
+    size_t        unsolBufferLen;                               ///< Unsolicited buffer length
     uint32_t      lineCount;                                    ///< Unsolicited lines number
     uint32_t      lineCounter;                                  ///< Received line counter
     bool          inProgress;                                   ///< Reception in progress
     le_atClient_UnsolicitedResponseHandlerRef_t ref;            ///< Unsolicited reference
     DeviceContextPtr_t interfacePtr;                            ///< device context
     le_dls_Link_t link;                                         ///< link in Unsolicited List
+    le_dls_Link_t inProgressLink;                               ///< link in In Progress List
+    struct Unsolicited* nextSamePatternPtr;                     ///< next with the same pattern
     le_msg_SessionRef_t sessionRef;                             ///< client session reference
 }
 Unsolicited_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the trie of unsolicited patterns.  A node stands for the pattern prefix spelled by the
+ * characters on the path from the root to it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct UnsolNode
+{
+    struct UnsolNode* childPtr;     ///< first node for the next character
+    struct UnsolNode* siblingPtr;   ///< next node for another character at the same position
+    Unsolicited_t*    unsolPtr;     ///< first unsolicited whose pattern ends here
+    char              character;    ///< character leading to this node
+    le_sls_Link_t     link;         ///< link in the device's node list
+}
+UnsolNode_t;
+
 
 
 //--------------------------------------------------------------------------------------------------
@@ -282,7 +318,12 @@ typedef struct DeviceContext
     le_timer_Ref_t  timerRef;           ///< command timer
     le_dls_List_t   atCommandList;      ///< List of command waiting for execution
     le_dls_List_t   unsolicitedList;    ///< unsolicited command list
+    le_dls_List_t   inProgressList;     ///< unsolicited being received (multi-line)
+    le_sls_List_t   unsolNodeList;      ///< all the nodes of the unsolicited trie
+    UnsolNode_t*    unsolTriePtr;       ///< root of the unsolicited trie (NULL if not built)
+    bool            unsolTrieValid;     ///< false when the unsolicited list has changed
     le_sem_Ref_t    waitingSemaphore;   ///< semaphore used for synchronization
+    uint32_t        latencyHistogram[LATENCY_BUCKETS]; ///< command count per latency bucket
     le_atClient_DeviceRef_t ref;        ///< reference of the device context
     le_msg_SessionRef_t sessionRef;     ///< client session reference
 }
@@ -311,6 +352,7 @@ typedef struct AtCmd
                                                                 ///< reponses reading
     uint32_t               responsesCount;                      ///< responses count in responseList
     le_sem_Ref_t           endSem;                              ///< end treatment semaphore
+    le_clk_Time_t          sendTime;                            ///< time the command was queued
     le_result_t            result;                              ///< result operation
     le_dls_Link_t          link;                                ///< link in AT commands list
     le_msg_SessionRef_t    sessionRef;                          ///< client session reference
@@ -334,10 +376,10 @@ static le_mem_PoolRef_t  AtCommandPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pool for responses string
+ * Slab allocator for responses string, so that each string only takes the memory it needs
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t  RspStringPool;
+static le_mem_SlabRef_t  RspStringSlab;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -346,6 +388,13 @@ static le_mem_PoolRef_t  RspStringPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  UnsolicitedPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for unsolicited pattern trie nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  UnsolNodePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map for AT commands
@@ -380,6 +429,156 @@ static void UpdateTransitionManager(ClientStatePtr_t  parserStatePtr,
 static void SendLine(RxParserPtr_t charParserPtr);
 static void SendData(RxParserPtr_t charParserPtr);
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to create a response string, holding at most len bytes of the given
+ * string.
+ *
+ * @return
+ *      - pointer to the new response string
+ */
+//--------------------------------------------------------------------------------------------------
+static RspString_t* CreateRspString
+(
+    const char* strPtr,     ///< [IN] String to copy
+    size_t      len         ///< [IN] Maximum number of bytes to copy
+)
+{
+    len = strnlen(strPtr, len);
+
+    RspString_t* newStringPtr = le_mem_ForceSlabAlloc(RspStringSlab,
+                                                      sizeof(RspString_t) + len + 1);
+
+    le_utf8_Copy(newStringPtr->line, strPtr, len + 1, NULL);
+    newStringPtr->link = LE_DLS_LINK_INIT;
+
+    return newStringPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to allocate a node of the unsolicited trie.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* NewUnsolNode
+(
+    DeviceContext_t* interfacePtr,
+    char character
+)
+{
+    UnsolNode_t* nodePtr = le_mem_ForceAlloc(UnsolNodePool);
+
+    memset(nodePtr, 0, sizeof(UnsolNode_t));
+    nodePtr->character = character;
+    nodePtr->link = LE_SLS_LINK_INIT;
+    le_sls_Stack(&interfacePtr->unsolNodeList, &nodePtr->link);
+
+    return nodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to release the unsolicited trie of a device.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearUnsolTrie
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&interfacePtr->unsolNodeList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, UnsolNode_t, link));
+    }
+
+    interfacePtr->unsolTriePtr = NULL;
+    interfacePtr->unsolTrieValid = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to build the trie of the subscribed unsolicited patterns, so that a
+ * received line is matched against all of them in a single pass.  Unsolicited with the same
+ * pattern are chained in subscription order.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildUnsolTrie
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    ClearUnsolTrie(interfacePtr);
+
+    interfacePtr->unsolTriePtr = NewUnsolNode(interfacePtr, '\0');
+
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&interfacePtr->unsolicitedList);
+
+    while (linkPtr != NULL)
+    {
+        Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
+        UnsolNode_t* nodePtr = interfacePtr->unsolTriePtr;
+        const char* charPtr;
+
+        for (charPtr = unsolPtr->unsolRsp; *charPtr != '\0'; charPtr++)
+        {
+            UnsolNode_t* childPtr = nodePtr->childPtr;
+
+            while ((childPtr != NULL) && (childPtr->character != *charPtr))
+            {
+                childPtr = childPtr->siblingPtr;
+            }
+
+            if (childPtr == NULL)
+            {
+                childPtr = NewUnsolNode(interfacePtr, *charPtr);
+                childPtr->siblingPtr = nodePtr->childPtr;
+                nodePtr->childPtr = childPtr;
+            }
+
+            nodePtr = childPtr;
+        }
+
+        // The list is browsed backward, so pushing keeps the subscription order.
+        unsolPtr->nextSamePatternPtr = nodePtr->unsolPtr;
+        nodePtr->unsolPtr = unsolPtr;
+
+        linkPtr = le_dls_PeekPrev(&interfacePtr->unsolicitedList, linkPtr);
+    }
+
+    interfacePtr->unsolTrieValid = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to start the reception of the unsolicited whose pattern ends at a trie
+ * node.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartUnsolicited
+(
+    DeviceContext_t* interfacePtr,
+    UnsolNode_t* nodePtr
+)
+{
+    Unsolicited_t* unsolPtr;
+
+    for (unsolPtr = nodePtr->unsolPtr; unsolPtr != NULL; unsolPtr = unsolPtr->nextSamePatternPtr)
+    {
+        if (!unsolPtr->inProgress)
+        {
+            LE_DEBUG("unsol found");
+            unsolPtr->inProgress = true;
+            le_dls_Queue(&interfacePtr->inProgressList, &unsolPtr->inProgressLink);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to check if the received data matches with a subscribed unsolicited
@@ -391,60 +590,82 @@ static void CheckUnsolicited
 (
     char* unsolRspPtr,
     size_t stringSize,
-    le_dls_List_t *unsolListPtr
+    DeviceContext_t* interfacePtr
 )
 {
-    LE_DEBUG("Start checking unsolicited");
+    LE_DEBUG_RATELIMITED("Start checking unsolicited");
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(unsolListPtr);
+    if (!interfacePtr->unsolTrieValid)
+    {
+        BuildUnsolTrie(interfacePtr);
+    }
 
-    /* Browse all the queue while the string is not found */
+    /* Walk down the trie along the line: every node passed ends a pattern prefixing the line */
+    UnsolNode_t* nodePtr = interfacePtr->unsolTriePtr;
+    size_t i = 0;
+
+    while (nodePtr != NULL)
+    {
+        StartUnsolicited(interfacePtr, nodePtr);
+
+        if (i == stringSize)
+        {
+            break;
+        }
+
+        nodePtr = nodePtr->childPtr;
+        while ((nodePtr != NULL) && (nodePtr->character != unsolRspPtr[i]))
+        {
+            nodePtr = nodePtr->siblingPtr;
+        }
+        i++;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->inProgressList);
+
+    /* Add the line to all the unsolicited being received */
     while (linkPtr != NULL)
     {
         Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr,
                                                Unsolicited_t,
-                                                link);
+                                               inProgressLink);
 
-        if ((strncmp(unsolPtr->unsolRsp,unsolRspPtr,strlen(unsolPtr->unsolRsp)) == 0) ||
-            (unsolPtr->inProgress))
+        linkPtr = le_dls_PeekNext(&interfacePtr->inProgressList, linkPtr);
+
+        size_t len = LE_ATDEFS_UNSOLICITED_MAX_LEN - unsolPtr->unsolBufferLen;
+        if (stringSize < len)
         {
-            LE_DEBUG("unsol found");
-            uint32_t len =
-                (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
-                stringSize :
-                LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer);
+            len = stringSize;
+        }
 
-            strncpy(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer), unsolRspPtr, len);
+        memcpy(unsolPtr->unsolBuffer + unsolPtr->unsolBufferLen, unsolRspPtr, len);
+        unsolPtr->unsolBufferLen += len;
+        unsolPtr->unsolBuffer[unsolPtr->unsolBufferLen] = '\0';
 
-            unsolPtr->inProgress = true;
-        }
+        if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+        {
+            le_dls_Remove(&interfacePtr->inProgressList, &unsolPtr->inProgressLink);
+            unsolPtr->inProgress = false;
+            unsolPtr->lineCounter = 0;
+
+            unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
 
-        if (unsolPtr->inProgress)
+            unsolPtr->unsolBuffer[0] = '\0';
+            unsolPtr->unsolBufferLen = 0;
+        }
+        else
         {
-            if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+            if (LE_ATDEFS_UNSOLICITED_MAX_BYTES - unsolPtr->unsolBufferLen > sizeof("\r\n"))
             {
-                unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
-                memset(unsolPtr->unsolBuffer,0,LE_ATDEFS_UNSOLICITED_MAX_BYTES);
-                unsolPtr->lineCounter = 0;
-                unsolPtr->inProgress = false;
+                memcpy(unsolPtr->unsolBuffer + unsolPtr->unsolBufferLen, "\r\n", sizeof("\r\n"));
+                unsolPtr->unsolBufferLen += sizeof("\r\n") - 1;
             }
-            else
-            {
-                if (LE_ATDEFS_UNSOLICITED_MAX_BYTES - strlen(unsolPtr->unsolBuffer) > sizeof("\r\n"))
-                {
-                    snprintf(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer),
-                             sizeof("\r\n") + 1,    // +1 for Null terminator
-                             "\r\n" );
-                }
 
-                unsolPtr->lineCounter++;
-            }
+            unsolPtr->lineCounter++;
         }
-
-        linkPtr = le_dls_PeekNext(unsolListPtr, linkPtr);
     }
 
-    LE_DEBUG("Stop checking unsolicited");
+    LE_DEBUG_RATELIMITED("Stop checking unsolicited");
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -464,12 +685,12 @@ static bool GetNextEvent
 )
 {
     int32_t idx = charParserPtr->rxData.idx++;
-    if (idx < charParserPtr->rxData.endBuffer)
+    if (idx < charParserPtr->rxData.rxBuffer.end)
     {
         if (charParserPtr->rxData.buffer[idx] == '\r')
         {
             idx = charParserPtr->rxData.idx++;
-            if (idx < charParserPtr->rxData.endBuffer)
+            if (idx < charParserPtr->rxData.rxBuffer.end)
             {
                 if ( charParserPtr->rxData.buffer[idx] == '\n')
                 {
@@ -536,7 +757,7 @@ static void ParseRxBuffer
 {
     RxEvent_t event;
 
-    for (;rxParserPtr->rxData.idx < rxParserPtr->rxData.endBuffer;)
+    for (;rxParserPtr->rxData.idx < rxParserPtr->rxData.rxBuffer.end;)
     {
         if (GetNextEvent(rxParserPtr, &event))
         {
@@ -547,39 +768,33 @@ static void ParseRxBuffer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to delete characters that were already read.
+ * This function must be called to release the characters that were already parsed.  They are
+ * only discarded when the room is needed for the next read.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void ResetRxBuffer
+static void ReleaseRxBuffer
 (
     RxParserPtr_t rxParserPtr
 )
 {
+    le_dev_RxBuffer_t* rxBufferPtr = &rxParserPtr->rxData.rxBuffer;
+
     if (rxParserPtr->curState == ProcessingState)
     {
-        size_t idx,sizeToCopy;
-        sizeToCopy = rxParserPtr->rxData.endBuffer-rxParserPtr->rxData.idxLastCrLf+2;
-
-        LE_DEBUG("%d sizeToCopy %zd from %d",
-                            rxParserPtr->rxData.idx,sizeToCopy,rxParserPtr->rxData.idxLastCrLf-2);
-
-        for (idx = 0; idx < sizeToCopy; idx++) {
-            rxParserPtr->rxData.buffer[idx] =
-                                rxParserPtr->rxData.buffer[idx+rxParserPtr->rxData.idxLastCrLf-2];
-        }
-
-        rxParserPtr->rxData.idxLastCrLf = 2;
-        rxParserPtr->rxData.endBuffer = sizeToCopy;
-        rxParserPtr->rxData.idx = rxParserPtr->rxData.endBuffer;
-        LE_DEBUG("new idx %d, startLine %d",
-                 rxParserPtr->rxData.idx,
-                 rxParserPtr->rxData.idxLastCrLf);
+        // Keep the current line, with the CRLF before it.
+        rxBufferPtr->start = rxParserPtr->rxData.idxLastCrLf - 2;
     }
-    else
+    else if (rxBufferPtr->end > 0)
     {
-        LE_DEBUG("Nothing should be copied in RxData\n");
+        // Keep the last character, which could be the CR of a CRLF.
+        rxBufferPtr->start = rxBufferPtr->end - 1;
     }
+
+    LE_DEBUG("idx %d, startLine %d, start %zu",
+             rxParserPtr->rxData.idx,
+             rxParserPtr->rxData.idxLastCrLf,
+             rxBufferPtr->start);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -600,6 +815,10 @@ static void InitializeState
     RxParserPtr_t rxParserPtr = &interfacePtr->rxParser;
     rxParserPtr->curState = StartingState;
 
+    // PARSER_BUFFER_MAX_BYTES length is including '\0' character.
+    rxParserPtr->rxData.rxBuffer.dataPtr = rxParserPtr->rxData.buffer;
+    rxParserPtr->rxData.rxBuffer.size = PARSER_BUFFER_MAX_BYTES - 1;
+
     interfacePtr->timerRef = le_timer_Create("CommandTimer");
     interfacePtr->rxParser.interfacePtr = interfacePtr;
 }
@@ -622,35 +841,65 @@ static void RxNewData
     }
 
     ssize_t size = 0;
+    size_t shift;
     DeviceContext_t *interfacePtr = le_fdMonitor_GetContextPtr();
+    RxData_t* rxDataPtr = &interfacePtr->rxParser.rxData;
 
     LE_DEBUG("Start read");
 
     /* Read RX data on uart */
-    // PARSER_BUFFER_MAX_BYTES length is including '\0' character.
-    size = le_dev_Read(&interfacePtr->device,
-                         (uint8_t *)(&interfacePtr->rxParser.rxData.buffer) +
-                         interfacePtr->rxParser.rxData.idx,
-                         (PARSER_BUFFER_MAX_BYTES - interfacePtr->rxParser.rxData.idx - 1));
+    size = le_dev_ReadRxBuffer(&interfacePtr->device, &rxDataPtr->rxBuffer, &shift);
+
+    /* Follow the data if they were moved to make room */
+    rxDataPtr->idx -= (int32_t)shift;
+    rxDataPtr->idxLastCrLf = (rxDataPtr->idxLastCrLf > (int32_t)shift) ?
+                             (rxDataPtr->idxLastCrLf - shift) : 0;
 
     /* Start the parsing only if we have read some bytes */
     if (size > 0)
     {
-        interfacePtr->rxParser.rxData.buffer[interfacePtr->rxParser.rxData.idx + size] = '\0';
-        interfacePtr->rxParser.rxData.endBuffer += size;
+        rxDataPtr->buffer[rxDataPtr->rxBuffer.end] = '\0';
 
         /* Call the parser */
-        LE_DEBUG("Parsing received data: %s", interfacePtr->rxParser.rxData.buffer);
+        LE_DEBUG("Parsing received data: %s", rxDataPtr->buffer + rxDataPtr->idx);
         ParseRxBuffer(&interfacePtr->rxParser);
-        ResetRxBuffer(&interfacePtr->rxParser);
+        ReleaseRxBuffer(&interfacePtr->rxParser);
     }
 
-    if (interfacePtr->rxParser.rxData.endBuffer > PARSER_BUFFER_MAX_BYTES)
+    LE_DEBUG("read finished");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to log the latency histogram of the commands sent on a device.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogLatencyHistogram
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    uint32_t i;
+
+    LE_INFO("Command latency histogram for interface %d:", interfacePtr->device.fd);
+
+    for (i = 0; i < LATENCY_BUCKETS; i++)
     {
-        LE_WARN("Rx Buffer Overflow (FillIndex = %d)!!!", interfacePtr->rxParser.rxData.idx);
-    }
+        if (interfacePtr->latencyHistogram[i] == 0)
+        {
+            continue;
+        }
 
-    LE_DEBUG("read finished");
+        if (i == (LATENCY_BUCKETS - 1))
+        {
+            LE_INFO("  >= %u ms: %u", 1U << (i - 1), interfacePtr->latencyHistogram[i]);
+        }
+        else
+        {
+            LE_INFO("  < %u ms: %u", 1U << i, interfacePtr->latencyHistogram[i]);
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -669,12 +918,16 @@ static void DestroyDeviceThread
 
     LE_DEBUG("Destroy thread for interface %d", interfacePtr->device.fd);
 
+    LogLatencyHistogram(interfacePtr);
+
     while ((linkPtr=le_dls_Pop(&interfacePtr->unsolicitedList)) != NULL)
     {
         Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
         le_mem_Release(unsolPtr);
     }
 
+    ClearUnsolTrie(interfacePtr);
+
     while ((linkPtr=le_dls_Pop(&interfacePtr->atCommandList)) != NULL)
     {
         AtCmd_t* atCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
@@ -770,6 +1023,32 @@ static void UpdateTransitionManager
     clientStatePtr->lastEvent   = input;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to add the time a command took, from its queuing to its final response
+ * or timeout, to the latency histogram of its device.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordLatency
+(
+    AtCmd_t* cmdPtr
+)
+{
+    le_clk_Time_t latency = le_clk_Sub(le_clk_GetRelativeTime(), cmdPtr->sendTime);
+    uint64_t latencyMs = ((uint64_t)latency.sec * 1000) + (latency.usec / 1000);
+    uint32_t bucket = 0;
+
+    while ((bucket < (LATENCY_BUCKETS - 1)) && ((latencyMs >> bucket) != 0))
+    {
+        bucket++;
+    }
+
+    cmdPtr->interfacePtr->latencyHistogram[bucket]++;
+
+    LE_DEBUG("Command %s took %"PRIu64" ms", cmdPtr->cmd, latencyMs);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to stop the timer of a command
@@ -800,6 +1079,7 @@ static void TimerHandler
     LE_ERROR("Timeout when sending %s, timeout = %d",  atCmdPtr->cmd, atCmdPtr->timeout);
     atCmdPtr->result = LE_TIMEOUT;
     le_dls_Pop(&atCmdPtr->interfacePtr->atCommandList);
+    RecordLatency(atCmdPtr);
     le_sem_Post(atCmdPtr->endSem);
     ClientStatePtr_t clientStatePtr = &atCmdPtr->interfacePtr->clientState;
 
@@ -883,18 +1163,13 @@ static bool CheckResponse
         {
             LE_DEBUG("Rsp matched, size: %zu", lineSize);
 
-            RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
-            memset(newStringPtr, 0, sizeof(RspString_t));
-
             if(lineSize>LE_ATDEFS_RESPONSE_MAX_BYTES)
             {
                 LE_ERROR("String too long");
-                le_mem_Release(newStringPtr);
                 return false;
             }
 
-            strncpy(newStringPtr->line, receivedRspPtr, lineSize);
-            newStringPtr->link = LE_DLS_LINK_INIT;
+            RspString_t* newStringPtr = CreateRspString(receivedRspPtr, lineSize);
             le_dls_Queue(resultListPtr, &(newStringPtr->link));
             return true;
         }
@@ -970,6 +1245,7 @@ static void SendingState
 
                 cmdPtr->result = LE_OK;
                 StopTimer(cmdPtr);
+                RecordLatency(cmdPtr);
                 le_sem_Post(cmdPtr->endSem);
 
                 UpdateTransitionManager(clientStatePtr,input,WaitingState);
@@ -1050,7 +1326,7 @@ static void WaitingState
 
             CheckUnsolicited((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]),
                               lineSize,
-                              &interfacePtr->unsolicitedList);
+                              interfacePtr);
             break;
         }
         default:
@@ -1201,7 +1477,8 @@ static void ReleaseRspStringList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is to send a new AT command
+ * This function is to send a new AT command.  It is called in the device thread, which owns the
+ * list of commands waiting for execution.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -1211,13 +1488,14 @@ static void SendCommand
     void *param2Ptr
 )
 {
-    DeviceContext_t* interfacePtr = param1Ptr;
+    AtCmd_t* cmdPtr = param1Ptr;
+    DeviceContext_t* interfacePtr = cmdPtr->interfacePtr;
 
-    if (interfacePtr)
-    {
-        ClientState_t* clientState = &interfacePtr->clientState;
-        (clientState->curState)(clientState,EVENT_SENDCMD);
-    }
+    cmdPtr->sendTime = le_clk_GetRelativeTime();
+    le_dls_Queue(&interfacePtr->atCommandList, &cmdPtr->link);
+
+    ClientState_t* clientState = &interfacePtr->clientState;
+    (clientState->curState)(clientState,EVENT_SENDCMD);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1292,6 +1570,15 @@ static void UnsolicitedPoolDestructor
         le_dls_Remove(listPtr, linkPtr);
     }
 
+    if (unsolicitedPtr->inProgress)
+    {
+        le_dls_Remove(&unsolicitedPtr->interfacePtr->inProgressList,
+                      &unsolicitedPtr->inProgressLink);
+    }
+
+    // The trie may point to the unsolicited: rebuild it before the next line is checked.
+    unsolicitedPtr->interfacePtr->unsolTrieValid = false;
+
     // Delete the reference for unsolicited structure pointer.
     le_ref_DeleteRef(UnsolRefMap, unsolicitedPtr->ref);
 }
@@ -1529,12 +1816,8 @@ le_result_t le_atClient_SetIntermediateResponse
 
         while(interPtr != NULL)
         {
-            RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
-            memset(newStringPtr, 0, sizeof(RspString_t));
-
-            le_utf8_Copy(newStringPtr->line, interPtr, LE_ATDEFS_RESPONSE_MAX_BYTES, NULL);
-
-            newStringPtr->link = LE_DLS_LINK_INIT;
+            RspString_t* newStringPtr = CreateRspString(interPtr,
+                                                        LE_ATDEFS_RESPONSE_MAX_BYTES - 1);
 
             le_dls_Queue(&(cmdPtr->ExpectintermediateResponseList), &(newStringPtr->link));
 
@@ -1543,9 +1826,7 @@ le_result_t le_atClient_SetIntermediateResponse
     }
     else
     {
-        RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
-        memset(newStringPtr, 0, sizeof(RspString_t));
-        newStringPtr->link = LE_DLS_LINK_INIT;
+        RspString_t* newStringPtr = CreateRspString("", 0);
         le_dls_Queue(&(cmdPtr->ExpectintermediateResponseList), &(newStringPtr->link));
 
     }
@@ -1601,12 +1882,8 @@ le_result_t le_atClient_SetFinalResponse
 
         while(respPtr != NULL)
         {
-            RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
-            memset(newStringPtr,0,sizeof(RspString_t));
-
-            le_utf8_Copy(newStringPtr->line,respPtr,LE_ATDEFS_RESPONSE_MAX_BYTES, NULL);
-
-            newStringPtr->link = LE_DLS_LINK_INIT;
+            RspString_t* newStringPtr = CreateRspString(respPtr,
+                                                        LE_ATDEFS_RESPONSE_MAX_BYTES - 1);
 
             le_dls_Queue(&(cmdPtr->expectResponseList),&(newStringPtr->link));
 
@@ -1735,13 +2012,12 @@ le_result_t le_atClient_Send
     }
 
     cmdPtr->endSem = le_sem_Create("ResultSignal",0);
-    le_dls_Queue(&cmdPtr->interfacePtr->atCommandList, &cmdPtr->link);
 
     ReleaseRspStringList(&cmdPtr->responseList);
 
     le_event_QueueFunctionToThread(cmdPtr->interfacePtr->threadRef,
                                                 SendCommand,
-                                                (void*) cmdPtr->interfacePtr,
+                                                (void*) cmdPtr,
                                                 (void*) NULL);
 
     le_sem_Wait(cmdPtr->endSem);
@@ -2052,9 +2328,11 @@ le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHa
     unsolicitedPtr->ref = le_ref_CreateRef(UnsolRefMap, unsolicitedPtr);
     unsolicitedPtr->interfacePtr = interfacePtr;
     unsolicitedPtr->link = LE_DLS_LINK_INIT;
+    unsolicitedPtr->inProgressLink = LE_DLS_LINK_INIT;
     unsolicitedPtr->sessionRef = le_atClient_GetClientSessionRef();
 
     le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
+    interfacePtr->unsolTrieValid = false;
 
     return unsolicitedPtr->ref;
 }
@@ -2242,14 +2520,18 @@ COMPONENT_INIT
     CmdRefMap = le_ref_CreateMap("CmdRefMap", CMD_POOL_SIZE);
 
     // Response pool allocation
-    RspStringPool = le_mem_CreatePool("RspStringPool",sizeof(RspString_t));
-    le_mem_ExpandPool(RspStringPool,RSP_POOL_SIZE);
+    RspStringSlab = le_mem_CreateSlabAllocator("RspStringSlab",
+                                               sizeof(RspString_t) +
+                                               LE_ATDEFS_RESPONSE_MAX_BYTES + 1);
+    le_mem_ExpandSlabAllocator(RspStringSlab, sizeof(RspString_t) + 1, RSP_POOL_SIZE);
 
     // Unsolicited pool allocation
     UnsolicitedPool = le_mem_CreatePool("AtUnsolicitedPool",sizeof(Unsolicited_t));
     le_mem_ExpandPool(UnsolicitedPool,UNSOLICITED_POOL_SIZE);
     le_mem_SetDestructor(UnsolicitedPool,UnsolicitedPoolDestructor);
     UnsolRefMap = le_ref_CreateMap("UnsolRefMap", UNSOLICITED_POOL_SIZE);
+    UnsolNodePool = le_mem_CreatePool("AtUnsolNodePool",sizeof(UnsolNode_t));
+    le_mem_ExpandPool(UnsolNodePool,UNSOLICITED_NODE_POOL_SIZE);
 
     // Add a handler to the close session service
     le_msg_AddServiceCloseHandler(
@@ -8,6 +8,7 @@
 #include "interfaces.h"
 #include "bridge.h"
 #include "le_atServer_local.h"
+#include <sys/ioctl.h>
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -28,6 +29,27 @@
 //--------------------------------------------------------------------------------------------------
 #define AT_CLIENT_TIMEOUT 5*60*1000
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes moved at once in data mode
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_CHUNK_BYTES    4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Final response of the modem when it enters data mode
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONNECT_RSP     "CONNECT"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Text sent by the modem when it leaves data mode
+ */
+//--------------------------------------------------------------------------------------------------
+#define NO_CARRIER_RSP  "NO CARRIER"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Responses codes definition
@@ -59,6 +81,21 @@
 //--------------------------------------------------------------------------------------------------
 typedef struct ModemCmd* ModemCmdRef_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Data mode pipe structure: moves the data from one fd to the other, in one direction.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int     inFd;                           ///< fd the data are read from
+    int     outFd;                          ///< fd the data are written to
+    int     pipeFds[2];                     ///< pipe used to splice the data (-1 to copy them)
+    bool    watchCarrier;                   ///< look for the end of data mode in the data
+    uint8_t buffer[DATA_CHUNK_BYTES];       ///< buffer used to copy the data
+}
+DataPipe_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Bridge context structure.
@@ -76,6 +113,10 @@ typedef struct
                                                                     ///< handler refenrece
     le_sem_Ref_t                                semRef;             ///< semaphore reference
     le_msg_SessionRef_t                         sessionRef;         ///< session reference
+    int                                         modemFd;            ///< modem fd (-1 if none)
+    le_atServer_DeviceRef_t                     dataDeviceRef;      ///< device in data mode
+    DataPipe_t                                  toHost;             ///< data mode, modem to host
+    DataPipe_t                                  toModem;            ///< data mode, host to modem
 }
 BridgeCtx_t;
 
@@ -220,6 +261,272 @@ static void ModemCmdPoolDestructor
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the pipe of a data mode pipe, if it has one
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClosePipe
+(
+    DataPipe_t* pipePtr
+)
+{
+    if (-1 != pipePtr->pipeFds[0])
+    {
+        close(pipePtr->pipeFds[0]);
+        close(pipePtr->pipeFds[1]);
+        pipePtr->pipeFds[0] = -1;
+        pipePtr->pipeFds[1] = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepare a data mode pipe.  The data are spliced through a pipe, without being copied to user
+ * space, unless they have to be looked at to detect the end of data mode.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenPipe
+(
+    DataPipe_t* pipePtr,
+    int         inFd,
+    int         outFd,
+    bool        watchCarrier
+)
+{
+    pipePtr->inFd = inFd;
+    pipePtr->outFd = outFd;
+    pipePtr->watchCarrier = watchCarrier;
+    pipePtr->pipeFds[0] = -1;
+    pipePtr->pipeFds[1] = -1;
+
+    if ((!watchCarrier) && (-1 == pipe2(pipePtr->pipeFds, O_CLOEXEC | O_NONBLOCK)))
+    {
+        LE_WARN("Unable to create pipe, data will be copied: %m");
+        pipePtr->pipeFds[0] = -1;
+        pipePtr->pipeFds[1] = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait until a non blocking fd can be written
+ *
+ * @return
+ *      - LE_OK            The fd can be written.
+ *      - LE_FAULT         The fd is in error, or has been hung up.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitWritable
+(
+    int fd
+)
+{
+    struct pollfd pollFd = { .fd = fd, .events = POLLOUT };
+
+    while (-1 == poll(&pollFd, 1, -1))
+    {
+        if (EINTR != errno)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return (pollFd.revents & POLLOUT) ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer on a non blocking fd
+ *
+ * @return
+ *      - LE_OK            The buffer was written.
+ *      - LE_FAULT         An error occurred.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int            fd,
+    const uint8_t* bufPtr,
+    size_t         size
+)
+{
+    while (size > 0)
+    {
+        ssize_t count = write(fd, bufPtr, size);
+
+        if (-1 == count)
+        {
+            if ((EAGAIN == errno) || (EINTR == errno))
+            {
+                if (LE_OK != WaitWritable(fd))
+                {
+                    return LE_FAULT;
+                }
+                continue;
+            }
+
+            LE_ERROR("write error on fd %d: %m", fd);
+            return LE_FAULT;
+        }
+
+        bufPtr += count;
+        size -= count;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the bytes spliced in the pipe of a data mode pipe to its output fd
+ *
+ * @return
+ *      - LE_OK            The bytes were moved.
+ *      - LE_FAULT         An error occurred.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushPipe
+(
+    DataPipe_t* pipePtr,
+    size_t      size
+)
+{
+    while (size > 0)
+    {
+        ssize_t count = splice(pipePtr->pipeFds[0], NULL, pipePtr->outFd, NULL, size,
+                               SPLICE_F_MOVE);
+
+        if (-1 == count)
+        {
+            if ((EAGAIN == errno) || (EINTR == errno))
+            {
+                if (LE_OK != WaitWritable(pipePtr->outFd))
+                {
+                    return LE_FAULT;
+                }
+                continue;
+            }
+
+            if (EINVAL != errno)
+            {
+                LE_ERROR("splice error on fd %d: %m", pipePtr->outFd);
+                return LE_FAULT;
+            }
+
+            // The output fd can't be spliced to: copy what is left in the pipe, and copy the
+            // next data directly.
+            count = read(pipePtr->pipeFds[0], pipePtr->buffer, size);
+            if ((count <= 0) || (LE_OK != WriteAll(pipePtr->outFd, pipePtr->buffer, count)))
+            {
+                return LE_FAULT;
+            }
+
+            if ((size_t)count == size)
+            {
+                ClosePipe(pipePtr);
+            }
+        }
+
+        size -= count;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the data available on the input fd of a data mode pipe to its output fd
+ *
+ * @return
+ *      - LE_OK            The data were moved.
+ *      - LE_TERMINATED    The input fd was hung up, or the modem left data mode.
+ *      - LE_FAULT         An error occurred.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MoveData
+(
+    DataPipe_t* pipePtr
+)
+{
+    ssize_t count;
+
+    if (-1 != pipePtr->pipeFds[0])
+    {
+        count = splice(pipePtr->inFd, NULL, pipePtr->pipeFds[1], NULL, DATA_CHUNK_BYTES,
+                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+        if (count > 0)
+        {
+            return FlushPipe(pipePtr, count);
+        }
+
+        if ((-1 == count) && (EINVAL == errno))
+        {
+            // The input fd can't be spliced from: copy the data instead.
+            ClosePipe(pipePtr);
+        }
+    }
+
+    if (-1 == pipePtr->pipeFds[0])
+    {
+        count = read(pipePtr->inFd, pipePtr->buffer, sizeof(pipePtr->buffer));
+
+        if (count > 0)
+        {
+            if (LE_OK != WriteAll(pipePtr->outFd, pipePtr->buffer, count))
+            {
+                return LE_FAULT;
+            }
+
+            // Without the DCD line, the modem result code is the only sign of the end of data
+            // mode.
+            if ((pipePtr->watchCarrier) &&
+                (NULL != memmem(pipePtr->buffer, count,
+                                NO_CARRIER_RSP, sizeof(NO_CARRIER_RSP) - 1)))
+            {
+                LE_INFO("Carrier lost");
+                return LE_TERMINATED;
+            }
+
+            return LE_OK;
+        }
+    }
+
+    if (0 == count)
+    {
+        LE_INFO("fd %d hung up", pipePtr->inFd);
+        return LE_TERMINATED;
+    }
+
+    if ((EAGAIN == errno) || (EINTR == errno))
+    {
+        return LE_OK;
+    }
+
+    LE_ERROR("read error on fd %d: %m", pipePtr->inFd);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the modem reports its carrier with the DCD line
+ *
+ * @return true if the DCD line can be used to detect the end of data mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasCarrierDetect
+(
+    int fd
+)
+{
+    int status;
+
+    return (0 == ioctl(fd, TIOCMGET, &status)) && (status & TIOCM_CD);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is the destructor for BridgeCtx_t struct
@@ -263,6 +570,14 @@ static void BridgePoolDestructor
         le_sem_Delete(bridgePtr->semRef);
     }
 
+    ClosePipe(&bridgePtr->toHost);
+    ClosePipe(&bridgePtr->toModem);
+
+    if (-1 != bridgePtr->modemFd)
+    {
+        close(bridgePtr->modemFd);
+    }
+
     // Release devices list
     le_dls_Link_t* linkPtr = le_dls_Pop(&bridgePtr->devicesList);
 
@@ -278,6 +593,231 @@ static void BridgePoolDestructor
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT client unsolicited handler
+ * All unsolicited coming from the AT client are sent to the hosts
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnsolicitedResponseHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    BridgeCtx_t* bridgeCtxPtr = contextPtr;
+
+    if (NULL == bridgeCtxPtr)
+    {
+        LE_ERROR("Bad parameter");
+        return;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&bridgeCtxPtr->devicesList);
+
+
+    while (NULL != linkPtr)
+    {
+        DeviceLink_t* devLinkPtr = CONTAINER_OF(linkPtr,
+                                   DeviceLink_t,
+                                   link);
+
+        if (LE_OK != le_atServer_SendUnsolicitedResponse(unsolicitedRsp,
+                                                         LE_ATSERVER_SPECIFIC_DEVICE,
+                                                         devLinkPtr->deviceRef))
+        {
+            LE_ERROR("Error during sending unsol on %p", devLinkPtr->deviceRef);
+        }
+
+        linkPtr = le_dls_PeekNext(&bridgeCtxPtr->devicesList,linkPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the AT client on the modem, and subscribe to all its unsolicited responses
+ * This function is called in the main thread
+ *
+ * @note The fd now belongs to AT command client.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The AT client could not be started.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartAtClient
+(
+    BridgeCtx_t* bridgePtr,
+    int          fd
+)
+{
+    bridgePtr->atClientRef = le_atClient_Start(fd);
+
+    if (NULL == bridgePtr->atClientRef)
+    {
+        LE_ERROR("ATClient error");
+        return LE_FAULT;
+    }
+
+    // Subscribe to all unsolicited responses
+    bridgePtr->unsolHandlerRef = le_atClient_AddUnsolicitedResponseHandler(
+                                                                        "",
+                                                                        bridgePtr->atClientRef,
+                                                                        UnsolicitedResponseHandler,
+                                                                        bridgePtr,
+                                                                        1);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Go back to command mode once the data mode is over
+ * This function is called in the main thread
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LeaveDataMode
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    BridgeCtx_t* bridgePtr = param1Ptr;
+
+    ClosePipe(&bridgePtr->toHost);
+    ClosePipe(&bridgePtr->toModem);
+
+    int fd = dup(bridgePtr->modemFd);
+
+    if ((-1 == fd) || (LE_OK != StartAtClient(bridgePtr, fd)))
+    {
+        LE_ERROR("Unable to restart the AT client");
+    }
+
+    if (LE_OK != le_atServer_Resume(bridgePtr->dataDeviceRef))
+    {
+        LE_ERROR("Unable to resume device %p", bridgePtr->dataDeviceRef);
+    }
+
+    bridgePtr->dataDeviceRef = NULL;
+
+    LE_INFO("Data mode left");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the data between the host and the modem until the data mode is over
+ * This function is called in the bridge thread: it blocks until the modem or the host leaves the
+ * data mode.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunDataMode
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    BridgeCtx_t* bridgePtr = param1Ptr;
+    bool hasCarrierDetect = !bridgePtr->toHost.watchCarrier;
+    struct pollfd pollFds[2] =
+    {
+        { .fd = bridgePtr->toHost.inFd, .events = POLLIN },
+        { .fd = bridgePtr->toModem.inFd, .events = POLLIN },
+    };
+    le_result_t result = LE_OK;
+
+    while (LE_OK == result)
+    {
+        // Without traffic, the DCD line is checked every second
+        int count = poll(pollFds, NUM_ARRAY_MEMBERS(pollFds), hasCarrierDetect ? 1000 : -1);
+
+        if (-1 == count)
+        {
+            if (EINTR != errno)
+            {
+                LE_ERROR("poll error: %m");
+                result = LE_FAULT;
+            }
+            continue;
+        }
+
+        if (pollFds[0].revents)
+        {
+            result = MoveData(&bridgePtr->toHost);
+        }
+
+        if ((LE_OK == result) && (pollFds[1].revents))
+        {
+            result = MoveData(&bridgePtr->toModem);
+        }
+
+        if ((LE_OK == result) && hasCarrierDetect && (!HasCarrierDetect(bridgePtr->modemFd)))
+        {
+            LE_INFO("Carrier lost");
+            result = LE_TERMINATED;
+        }
+    }
+
+    le_event_QueueFunctionToThread(bridgePtr->mainThreadRef, LeaveDataMode, bridgePtr, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Switch a device to data mode, after the modem answered CONNECT to one of its commands: from now
+ * on, the data are moved between the device and the modem as they are, until the modem drops the
+ * carrier.
+ * This function is called in the main thread
+ *
+ * @note The AT client is stopped during the data mode, as it would read the modem data otherwise.
+ *       The commands sent by the other devices of the bridge meanwhile fail.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EnterDataMode
+(
+    BridgeCtx_t*            bridgePtr,
+    le_atServer_DeviceRef_t deviceRef
+)
+{
+    int hostFd;
+
+    if (LE_OK != le_atServer_GetDeviceFd(deviceRef, &hostFd))
+    {
+        return;
+    }
+
+    if (LE_OK != le_atServer_Suspend(deviceRef))
+    {
+        LE_ERROR("Unable to suspend device %p", deviceRef);
+        return;
+    }
+
+    if (bridgePtr->unsolHandlerRef)
+    {
+        le_atClient_RemoveUnsolicitedResponseHandler(bridgePtr->unsolHandlerRef);
+        bridgePtr->unsolHandlerRef = NULL;
+    }
+
+    if (bridgePtr->atClientRef)
+    {
+        le_atClient_Stop(bridgePtr->atClientRef);
+        bridgePtr->atClientRef = NULL;
+    }
+
+    // Modem data are spliced only if the DCD line tells when the modem leaves data mode, they
+    // have to be looked at otherwise.
+    OpenPipe(&bridgePtr->toHost, bridgePtr->modemFd, hostFd,
+             !HasCarrierDetect(bridgePtr->modemFd));
+    OpenPipe(&bridgePtr->toModem, hostFd, bridgePtr->modemFd, false);
+
+    bridgePtr->dataDeviceRef = deviceRef;
+
+    LE_INFO("Data mode entered on device %p", deviceRef);
+
+    le_event_QueueFunctionToThread(bridgePtr->threadRef, RunDataMode, bridgePtr, NULL);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Treat error
@@ -385,6 +925,21 @@ static void TreatResponse
 
         LE_DEBUG("finalRsp = %s", (finalRsp == LE_ATSERVER_OK) ? "ok": "error");
 
+        // The device has to be retrieved while the command is still in progress
+        le_atServer_DeviceRef_t deviceRef = NULL;
+        BridgeCtx_t* bridgePtr = NULL;
+
+        if (0 == strncmp(rsp, CONNECT_RSP, sizeof(CONNECT_RSP) - 1))
+        {
+            le_atServer_BridgeRef_t bridgeRef = NULL;
+
+            if ((LE_OK == le_atServer_GetBridgeRef(atServerCmdRef, &bridgeRef)) &&
+                (LE_OK == le_atServer_GetDevice(atServerCmdRef, &deviceRef)))
+            {
+                bridgePtr = le_ref_Lookup(BridgesRefMap, bridgeRef);
+            }
+        }
+
         if (LE_OK != le_atServer_SendFinalResponse(atServerCmdRef,
                                                    finalRsp,
                                                    true,
@@ -404,6 +959,11 @@ static void TreatResponse
             modemCmdDescPtr->atClientCmdRef = 0;
         }
 
+        if (NULL != bridgePtr)
+        {
+            EnterDataMode(bridgePtr, deviceRef);
+        }
+
         // "ERROR" final response could mean that the AT command doesn't exist => delete it in this
         // case
         if (0 == strncmp(rsp, ErrorString, sizeof(ErrorString)))
@@ -603,47 +1163,6 @@ static void AtCmdHandler
                                    bridgePtr);
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * AT client unsolicited handler
- * All unsolicited coming from the AT client are sent to the hosts
- *
- */
-//--------------------------------------------------------------------------------------------------
-static void UnsolicitedResponseHandler
-(
-    const char* unsolicitedRsp,
-    void* contextPtr
-)
-{
-    BridgeCtx_t* bridgeCtxPtr = contextPtr;
-
-    if (NULL == bridgeCtxPtr)
-    {
-        LE_ERROR("Bad parameter");
-        return;
-    }
-
-    le_dls_Link_t* linkPtr = le_dls_Peek(&bridgeCtxPtr->devicesList);
-
-
-    while (NULL != linkPtr)
-    {
-        DeviceLink_t* devLinkPtr = CONTAINER_OF(linkPtr,
-                                   DeviceLink_t,
-                                   link);
-
-        if (LE_OK != le_atServer_SendUnsolicitedResponse(unsolicitedRsp,
-                                                         LE_ATSERVER_SPECIFIC_DEVICE,
-                                                         devLinkPtr->deviceRef))
-        {
-            LE_ERROR("Error during sending unsol on %p", devLinkPtr->deviceRef);
-        }
-
-        linkPtr = le_dls_PeekNext(&bridgeCtxPtr->devicesList,linkPtr);
-    }
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Thread used for the bridge
@@ -785,6 +1304,9 @@ le_atServer_BridgeRef_t bridge_Open
 
     BridgeCtx_t* bridgeCtxPtr = le_mem_ForceAlloc(BridgesPool);
     memset(bridgeCtxPtr, 0, sizeof(BridgeCtx_t));
+    bridgeCtxPtr->modemFd = -1;
+    bridgeCtxPtr->toHost.pipeFds[0] = -1;
+    bridgeCtxPtr->toModem.pipeFds[0] = -1;
 
 
     bridgeCtxPtr->bridgeRef = le_ref_CreateRef(BridgesRefMap, bridgeCtxPtr);
@@ -817,25 +1339,16 @@ le_atServer_BridgeRef_t bridge_Open
 
     bridgeCtxPtr->mainThreadRef = le_thread_GetCurrent();
 
-    // Create the bridge with the AT client
-    // fd now belongs to AT command client
-    bridgeCtxPtr->atClientRef = le_atClient_Start(fd);
+    // Keep a copy of the modem fd for the data mode, as the AT client owns the given one
+    bridgeCtxPtr->modemFd = dup(fd);
 
-    if (NULL == bridgeCtxPtr->atClientRef)
+    // Create the bridge with the AT client
+    if ((-1 == bridgeCtxPtr->modemFd) || (LE_OK != StartAtClient(bridgeCtxPtr, fd)))
     {
-        LE_ERROR("ATClient error");
         le_mem_Release(bridgeCtxPtr);
         return NULL;
     }
 
-    // Subscribe to all unsolicited responses
-    bridgeCtxPtr->unsolHandlerRef = le_atClient_AddUnsolicitedResponseHandler(
-                                                                        "",
-                                                                        bridgeCtxPtr->atClientRef,
-                                                                        UnsolicitedResponseHandler,
-                                                                        bridgeCtxPtr,
-                                                                        1);
-
     threadNumber++;
     bridgeCtxPtr->sessionRef = le_atServer_GetClientSessionRef();
 
@@ -33,6 +33,13 @@
 //--------------------------------------------------------------------------------------------------
 #define CMD_POOL_SIZE       100
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT commands trie node pool size
+ */
+//--------------------------------------------------------------------------------------------------
+#define CMD_NODE_POOL_SIZE  (CMD_POOL_SIZE * 4)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Command parameters pool size
@@ -258,6 +265,13 @@ static le_ref_MapRef_t UserErrorRefMap;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t DevicesRefMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of devices waiting for a command in progress on another device
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t WaitingDevicesCount = 0;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map for AT commands
@@ -631,6 +645,51 @@ typedef struct
 }
 ATCmdSubscribed_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the trie of AT command names.  A node stands for the name prefix spelled by the
+ * characters on the path from the root to it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct CmdNode
+{
+    struct CmdNode*     childPtr;       ///< first node for the next character
+    struct CmdNode*     siblingPtr;     ///< next node for another character at the same position
+    ATCmdSubscribed_t*  cmdPtr;         ///< command whose name ends here (NULL if none)
+    char                character;      ///< character leading to this node
+    le_sls_Link_t       link;           ///< link in the node list
+}
+CmdNode_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for AT commands trie nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  CmdNodePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of all the AT commands trie nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_List_t  CmdNodeList = LE_SLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Root of the AT commands trie (NULL if not built)
+ */
+//--------------------------------------------------------------------------------------------------
+static CmdNode_t*  CmdTriePtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is the AT commands trie up to date with the commands map ?
+ */
+//--------------------------------------------------------------------------------------------------
+static bool  CmdTrieValid;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * AT Command parser structure.
@@ -714,6 +773,9 @@ typedef struct
     le_atServer_BridgeRef_t bridgeRef;                            ///< bridge reference
     le_msg_SessionRef_t     sessionRef;                           ///< session reference
     bool                    suspended;                            ///< is device in data mode
+    bool                    waiting;                              ///< is parsing waiting for a
+                                                                  ///< command in progress on
+                                                                  ///< another device
     bool                    echo;                                 ///< is echo enabled
     Text_t                  text;                                 ///< text data
 }
@@ -835,6 +897,54 @@ CmdParserFunc_t CmdParserTab[PARSE_MAX][PARSE_MAX] =
                          }
 };
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resume the parsing of the devices waiting for a command in progress on another device.  The
+ * command line of each device is parsed again from the command it was waiting for, so the
+ * devices still waiting for a command in progress wait again.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResumeWaitingDevices
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_ref_IterRef_t iter = le_ref_GetIterator(DevicesRefMap);
+
+    while ((WaitingDevicesCount > 0) && (le_ref_NextNode(iter) == LE_OK))
+    {
+        DeviceContext_t* devPtr = (DeviceContext_t*) le_ref_GetValue(iter);
+
+        if (devPtr->waiting)
+        {
+            devPtr->waiting = false;
+            WaitingDevicesCount--;
+
+            ParseAtCmd(devPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a command is not in progress anymore, or is deleted: the devices waiting for it
+ * can go on.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommandReleased
+(
+    void
+)
+{
+    if (WaitingDevicesCount > 0)
+    {
+        le_event_QueueFunction(ResumeWaitingDevices, NULL, NULL);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is the destructor for ATCmdSubscribed_t struct
@@ -853,6 +963,7 @@ static void AtCmdPoolDestructor
 
     // cleanup the hashmap
     le_hashmap_Remove(CmdHashMap, cmdPtr->cmdName);
+    CmdTrieValid = false;
 
     // cleanup ParamList dls pool
     while((linkPtr = le_dls_Pop(&cmdPtr->paramList)) != NULL)
@@ -864,6 +975,8 @@ static void AtCmdPoolDestructor
     }
 
     le_ref_DeleteRef(SubscribedCmdRefMap, cmdPtr->cmdRef);
+
+    CommandReleased();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1623,6 +1736,134 @@ static void BasicCmdFound
     cmdParserPtr->currentCmdPtr->processing = true;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to allocate a node of the AT commands trie.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static CmdNode_t* NewCmdNode
+(
+    char character
+)
+{
+    CmdNode_t* nodePtr = le_mem_ForceAlloc(CmdNodePool);
+
+    memset(nodePtr, 0, sizeof(CmdNode_t));
+    nodePtr->character = character;
+    nodePtr->link = LE_SLS_LINK_INIT;
+    le_sls_Stack(&CmdNodeList, &nodePtr->link);
+
+    return nodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to build the trie of the AT command names, so that the longest command
+ * name prefixing a basic format command line is found in a single pass.  It is rebuilt on the
+ * first lookup following a change of the commands map.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildCmdTrie
+(
+    void
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&CmdNodeList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, CmdNode_t, link));
+    }
+
+    CmdTriePtr = NewCmdNode('\0');
+
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(CmdHashMap);
+
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
+    {
+        ATCmdSubscribed_t* cmdPtr = (ATCmdSubscribed_t*) le_hashmap_GetValue(iterRef);
+        CmdNode_t* nodePtr = CmdTriePtr;
+        const char* charPtr;
+
+        for (charPtr = cmdPtr->cmdName; *charPtr != '\0'; charPtr++)
+        {
+            CmdNode_t* childPtr = nodePtr->childPtr;
+
+            while ((childPtr != NULL) && (childPtr->character != *charPtr))
+            {
+                childPtr = childPtr->siblingPtr;
+            }
+
+            if (childPtr == NULL)
+            {
+                childPtr = NewCmdNode(*charPtr);
+                childPtr->siblingPtr = nodePtr->childPtr;
+                nodePtr->childPtr = childPtr;
+            }
+
+            nodePtr = childPtr;
+        }
+
+        nodePtr->cmdPtr = cmdPtr;
+    }
+
+    CmdTrieValid = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to find the longest AT command name prefixing a string.  Only names longer
+ * than the "AT" prefix are considered.
+ *
+ * @return
+ *      - The command found, and its name length in lenPtr.
+ *      - NULL if no command name prefixes the string.
+ */
+//--------------------------------------------------------------------------------------------------
+static ATCmdSubscribed_t* FindLongestCmd
+(
+    const char* strPtr,     ///< [IN] string to look at
+    size_t      strLen,     ///< [IN] string length
+    size_t*     lenPtr      ///< [OUT] length of the command name found
+)
+{
+    ATCmdSubscribed_t* foundPtr = NULL;
+    CmdNode_t* nodePtr;
+    size_t i;
+
+    if (!CmdTrieValid)
+    {
+        BuildCmdTrie();
+    }
+
+    nodePtr = CmdTriePtr;
+
+    for (i = 0; i < strLen; i++)
+    {
+        nodePtr = nodePtr->childPtr;
+
+        while ((nodePtr != NULL) && (nodePtr->character != strPtr[i]))
+        {
+            nodePtr = nodePtr->siblingPtr;
+        }
+
+        if (nodePtr == NULL)
+        {
+            break;
+        }
+
+        if ((nodePtr->cmdPtr != NULL) && (i >= 2))
+        {
+            foundPtr = nodePtr->cmdPtr;
+            *lenPtr = i + 1;
+        }
+    }
+
+    return foundPtr;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * AT parser transition (treatment of a basic format commands)
@@ -1643,37 +1884,32 @@ static le_result_t ParseBasic
     }
 
     uint32_t len = cmdParserPtr->currentCharPtr-cmdParserPtr->currentAtCmdPtr+1;
-    char* initialPosPtr = cmdParserPtr->currentCharPtr;
-    char atCmd[len];
-    memset(atCmd,0,len);
-    strncpy(atCmd, cmdParserPtr->currentAtCmdPtr, len-1);
+    size_t cmdLen = 0;
 
-    while (strlen(atCmd) > 2)
-    {
-        cmdParserPtr->currentCmdPtr = le_hashmap_Get(CmdHashMap, atCmd);
+    // Look for the longest registered command prefixing the basic command
+    cmdParserPtr->currentCmdPtr = FindLongestCmd(cmdParserPtr->currentAtCmdPtr, len-1, &cmdLen);
 
-        if ( cmdParserPtr->currentCmdPtr == NULL )
+    if ( cmdParserPtr->currentCmdPtr != NULL )
+    {
+        if ( cmdParserPtr->currentCmdPtr->processing )
         {
-            atCmd[strlen(atCmd)-1] = '\0';
-            cmdParserPtr->currentCharPtr--;
+            LE_DEBUG("AT command currently in processing");
+            return LE_BUSY;
         }
-        else
-        {
-            BasicCmdFound(cmdParserPtr);
 
-            cmdParserPtr->currentCharPtr--;
+        BasicCmdFound(cmdParserPtr);
 
-            return LE_OK;
-        }
+        cmdParserPtr->currentCharPtr = cmdParserPtr->currentAtCmdPtr + cmdLen - 1;
+
+        return LE_OK;
     }
 
     DeviceContext_t* devPtr = CONTAINER_OF(cmdParserPtr, DeviceContext_t, cmdParser);
 
     if ( devPtr->bridgeRef )
     {
-        //Reset the pointer to its initial value
-        cmdParserPtr->currentCharPtr = initialPosPtr;
-
+        char atCmd[len];
+        memset(atCmd,0,len);
         strncpy(atCmd, cmdParserPtr->currentAtCmdPtr, len-1);
 
         if (( CreateModemCommand(cmdParserPtr, atCmd) != LE_OK ) ||
@@ -1850,9 +2086,11 @@ static le_result_t ParseSemicolon
     *cmdParserPtr->currentCharPtr='\0';
 
     // if AT command not resolved yet, try to get it
-    if ( ParseLastChar(cmdParserPtr) != LE_OK )
+    le_result_t res = ParseLastChar(cmdParserPtr);
+
+    if ( res != LE_OK )
     {
-        return LE_FAULT;
+        return (res == LE_BUSY) ? LE_BUSY : LE_FAULT;
     }
 
     // Concatenate command: prepare the buffer for the next parsing
@@ -1892,6 +2130,8 @@ static void ParseAtCmd
     }
 
     CmdParser_t* cmdParserPtr = &devPtr->cmdParser;
+    char* cmdStartPtr = cmdParserPtr->currentCharPtr;
+    CmdParserState_t startParserState = cmdParserPtr->lastCmdParserState;
 
     cmdParserPtr->cmdParser = PARSE_CMDNAME;
 
@@ -1982,6 +2222,10 @@ static void ParseAtCmd
             return;
         }
 
+        // The transitions may terminate the command name in place
+        char* charPtr = cmdParserPtr->currentCharPtr;
+        char character = *charPtr;
+
         le_result_t res;
         res = CmdParserTab[cmdParserPtr->lastCmdParserState][cmdParserPtr->cmdParser](cmdParserPtr);
 
@@ -1995,22 +2239,32 @@ static void ParseAtCmd
                 cmdParserPtr->cmdParser = PARSE_LAST;
             }
         }
+        else if (res == LE_BUSY)
+        {
+            // The command is in progress on another device: parse it again once released, the
+            // next commands of the line waiting behind it.
+            LE_INFO("AT command busy, waiting for it");
+
+            *charPtr = character;
+            cmdParserPtr->currentCharPtr = cmdStartPtr;
+            cmdParserPtr->lastCmdParserState = startParserState;
+            cmdParserPtr->currentCmdPtr = NULL;
+
+            devPtr->waiting = true;
+            WaitingDevicesCount++;
+
+            return;
+        }
         else
         {
             LE_ERROR("Error in parsing AT command, lastState %d, current state %d",
                                                         cmdParserPtr->lastCmdParserState,
                                                         cmdParserPtr->cmdParser);
 
-            if (res == LE_BUSY)
-            {
-                LE_INFO("AT command busy");
-            }
-            else
+            if (cmdParserPtr->currentCmdPtr)
             {
-                if (cmdParserPtr->currentCmdPtr)
-                {
-                    cmdParserPtr->currentCmdPtr->processing = false;
-                }
+                cmdParserPtr->currentCmdPtr->processing = false;
+                CommandReleased();
             }
 
             // Incurred error in parsing AT command. Clear all parsed parameters.
@@ -2044,6 +2298,7 @@ static void ParseAtCmd
         {
             // Command exists, but no handler associate to it
             cmdParserPtr->currentCmdPtr->processing = false;
+            CommandReleased();
 
             // Clean AT command context, not in use now
             le_dls_Link_t* linkPtr;
@@ -2196,7 +2451,7 @@ static void ReceiveCmd
     // Value of size is negative.
     if (0 > size)
     {
-        LE_ERROR("le_dev_Read failed!");
+        LE_ERROR_RATELIMITED("le_dev_Read failed!");
         return;
     }
     // Value of size is 0.
@@ -2532,6 +2787,12 @@ static le_result_t CloseServer
     if (cmdPtr)
     {
         cmdPtr->processing = false;
+        CommandReleased();
+    }
+
+    if (devPtr->waiting)
+    {
+        WaitingDevicesCount--;
     }
 
     // cleanup the dls pool
@@ -2778,6 +3039,37 @@ le_result_t le_atServer_UnlinkDeviceFromBridge
 
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the file descriptor of a device.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The device reference is invalid.
+ *
+ * @note
+ *  This function internal, not exposed as API
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atServer_GetDeviceFd
+(
+    le_atServer_DeviceRef_t deviceRef,
+    int*                    fdPtr
+)
+{
+    DeviceContext_t* devPtr = le_ref_Lookup(DevicesRefMap, deviceRef);
+
+    if (devPtr == NULL)
+    {
+        LE_ERROR("Bad reference");
+        return LE_FAULT;
+    }
+
+    *fdPtr = devPtr->device.fd;
+
+    return LE_OK;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2914,6 +3206,7 @@ le_atServer_CmdRef_t le_atServer_Create
     cmdPtr->cmdRef = le_ref_CreateRef(SubscribedCmdRefMap, cmdPtr);
 
     le_hashmap_Put(CmdHashMap, cmdPtr->cmdName, cmdPtr);
+    CmdTrieValid = false;
 
     cmdPtr->availableDevice = LE_ATSERVER_ALL_DEVICES;
     cmdPtr->paramList = LE_DLS_LIST_INIT;
@@ -3283,6 +3576,7 @@ le_result_t le_atServer_SendFinalResponse
 
     cmdPtr->deviceRef = NULL;
     cmdPtr->processing = false;
+    CommandReleased();
 
     if (final != LE_ATSERVER_ERROR)
     {
@@ -3363,6 +3657,7 @@ le_result_t le_atServer_SendFinalResultCode
 
     cmdPtr->deviceRef = NULL;
     cmdPtr->processing = false;
+    CommandReleased();
 
     if (final != LE_ATSERVER_ERROR)
     {
@@ -3851,6 +4146,8 @@ COMPONENT_INIT
     AtCommandsPool = le_mem_CreatePool("AtServerCommandsPool",sizeof(ATCmdSubscribed_t));
     le_mem_ExpandPool(AtCommandsPool, CMD_POOL_SIZE);
     le_mem_SetDestructor(AtCommandsPool,AtCmdPoolDestructor);
+    CmdNodePool = le_mem_CreatePool("AtServerCmdNodePool",sizeof(CmdNode_t));
+    le_mem_ExpandPool(CmdNodePool, CMD_NODE_POOL_SIZE);
     SubscribedCmdRefMap = le_ref_CreateMap("SubscribedCmdRefMap", CMD_POOL_SIZE);
     CmdHashMap = le_hashmap_Create("CmdHashMap",
                                     CMD_POOL_SIZE,
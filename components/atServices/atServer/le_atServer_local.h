@@ -72,4 +72,22 @@ le_result_t le_atServer_UnlinkDeviceFromBridge
     le_atServer_BridgeRef_t bridgeRef
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets the file descriptor of a device.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The device reference is invalid.
+ *
+ * @note
+ *  This function internal, not exposed as API
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atServer_GetDeviceFd
+(
+    le_atServer_DeviceRef_t deviceRef,
+    int*                    fdPtr
+);
+
 #endif //LEGATO_LE_ATSERVER_LOCAL_INCLUDE_GUARD
@@ -35,6 +35,7 @@
 #define CONNECTOR_DEFAULT_POOL_SIZE     1
 #define HASHMAP_DEFAULT_POOL_SIZE       1
 #define EVENTID_DEFAULT_POOL_SIZE       2
+#define PATHCHANGE_DEFAULT_POOL_SIZE    4
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -173,6 +174,23 @@ struct eventIdList {
     bool            isUsed;  ///< is it used?
     le_dls_Link_t   link;    ///< link for eventIdList
 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path change structure.
+ * Objects of this type record the net change of a DSP audio path during a routing update.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_audio_Stream_t*  inputStreamPtr;   ///< input stream of the path
+    le_audio_Stream_t*  outputStreamPtr;  ///< output stream of the path
+    bool                isSet;            ///< is the path set in the PA?
+    bool                toBeSet;          ///< must the path be set when the update is applied?
+    le_dls_Link_t       link;             ///< link for PathChangeList
+}
+PathChange_t;
 //--------------------------------------------------------------------------------------------------
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
@@ -241,6 +259,34 @@ static le_mem_PoolRef_t AudioHashMapPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t EventIdPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for PathChange objects
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PathChangePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the path changes recorded during the routing update
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t    PathChangeList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is a routing update in progress?
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRoutingUpdateStarted = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client session which started the routing update
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t RoutingUpdateSessionRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The memory pool for stream reference node objects (used by stream event add/remove handler
@@ -312,6 +358,174 @@ static bool EqualsAudioRef
     return firstSafeRef == secondSafeRef;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the new state of a DSP audio path during a routing update. Successive changes of the same
+ * path cancel out, so that only the net change is applied.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordPathChange
+(
+    le_audio_Stream_t*  inputStreamPtr,     ///< [IN] The input stream
+    le_audio_Stream_t*  outputStreamPtr,    ///< [IN] The output stream
+    bool                toBeSet             ///< [IN] Must the path be set?
+)
+{
+    PathChange_t* changePtr;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PathChangeList);
+
+    while (linkPtr)
+    {
+        changePtr = CONTAINER_OF(linkPtr, PathChange_t, link);
+
+        if ((changePtr->inputStreamPtr == inputStreamPtr) &&
+            (changePtr->outputStreamPtr == outputStreamPtr))
+        {
+            changePtr->toBeSet = toBeSet;
+            return;
+        }
+
+        linkPtr = le_dls_PeekNext(&PathChangeList, linkPtr);
+    }
+
+    changePtr = le_mem_ForceAlloc(PathChangePool);
+    changePtr->inputStreamPtr = inputStreamPtr;
+    changePtr->outputStreamPtr = outputStreamPtr;
+    changePtr->isSet = !toBeSet;
+    changePtr->toBeSet = toBeSet;
+    changePtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&PathChangeList, &(changePtr->link));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function applies the recorded path changes to the PA: the paths to reset first, then the
+ * paths to set. Only the changes involving streamPtr are applied if it is not NULL.
+ *
+ * @return LE_FAULT         A path could not be set or reset.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyPathChanges
+(
+    le_audio_Stream_t*  streamPtr       ///< [IN] The stream, NULL for all streams
+)
+{
+    le_result_t res = LE_OK;
+    int pass;
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        bool toBeSet = (pass != 0);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&PathChangeList);
+
+        while (linkPtr)
+        {
+            PathChange_t* changePtr = CONTAINER_OF(linkPtr, PathChange_t, link);
+
+            linkPtr = le_dls_PeekNext(&PathChangeList, linkPtr);
+
+            if ((streamPtr != NULL) &&
+                (changePtr->inputStreamPtr != streamPtr) &&
+                (changePtr->outputStreamPtr != streamPtr))
+            {
+                continue;
+            }
+
+            if (changePtr->toBeSet != toBeSet)
+            {
+                continue;
+            }
+
+            if (changePtr->isSet != changePtr->toBeSet)
+            {
+                le_result_t pathRes;
+
+                LE_DEBUG("%s the DSP audio path (inputInterface.%d with outputInterface.%d)",
+                         toBeSet ? "Set" : "Reset",
+                         changePtr->inputStreamPtr->audioInterface,
+                         changePtr->outputStreamPtr->audioInterface);
+
+                if (toBeSet)
+                {
+                    pathRes = pa_audio_SetDspAudioPath(changePtr->inputStreamPtr,
+                                                       changePtr->outputStreamPtr);
+                }
+                else
+                {
+                    pathRes = pa_audio_ResetDspAudioPath(changePtr->inputStreamPtr,
+                                                         changePtr->outputStreamPtr);
+                }
+
+                if (pathRes != LE_OK)
+                {
+                    LE_ERROR("Cannot %s the DSP audio path", toBeSet ? "set" : "reset");
+                    res = LE_FAULT;
+                }
+            }
+
+            le_dls_Remove(&PathChangeList, &(changePtr->link));
+            le_mem_Release(changePtr);
+        }
+    }
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function sets the dsp path between two streams, or records it if a routing update is in
+ * progress.
+ *
+ * @return LE_BAD_PARAMETER The audio stream reference is invalid.
+ * @return LE_UNAVAILABLE   The audio service initialization failed.
+ * @return LE_FAULT         On any other failure.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetStreamPath
+(
+    le_audio_Stream_t*  inputStreamPtr,     ///< [IN] The input stream
+    le_audio_Stream_t*  outputStreamPtr     ///< [IN] The output stream
+)
+{
+    if (IsRoutingUpdateStarted)
+    {
+        RecordPathChange(inputStreamPtr, outputStreamPtr, true);
+        return LE_OK;
+    }
+
+    return pa_audio_SetDspAudioPath(inputStreamPtr, outputStreamPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function resets the dsp path between two streams, or records it if a routing update is in
+ * progress.
+ *
+ * @return LE_BAD_PARAMETER The audio stream reference is invalid.
+ * @return LE_UNAVAILABLE   The audio service initialization failed.
+ * @return LE_FAULT         On any other failure.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ResetStreamPath
+(
+    le_audio_Stream_t*  inputStreamPtr,     ///< [IN] The input stream
+    le_audio_Stream_t*  outputStreamPtr     ///< [IN] The output stream
+)
+{
+    if (IsRoutingUpdateStarted)
+    {
+        RecordPathChange(inputStreamPtr, outputStreamPtr, false);
+        return LE_OK;
+    }
+
+    return pa_audio_ResetDspAudioPath(inputStreamPtr, outputStreamPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function set all dsp path from streamPtr to all stream into the streamListPtr
@@ -362,7 +576,7 @@ static le_result_t OpenStreamPaths
                  inputStreamPtr->audioInterface,
                  outputStreamPtr->audioInterface);
 
-        res = pa_audio_SetDspAudioPath(inputStreamPtr, outputStreamPtr);
+        res = SetStreamPath(inputStreamPtr, outputStreamPtr);
     }
 
     return res;
@@ -419,7 +633,7 @@ static le_result_t CloseStreamPaths
                  inputStreamPtr->audioInterface,
                  outputStreamPtr->audioInterface);
 
-        res = pa_audio_ResetDspAudioPath(inputStreamPtr, outputStreamPtr);
+        res = ResetStreamPath(inputStreamPtr, outputStreamPtr);
     }
 
     return res;
@@ -978,6 +1192,9 @@ static void DestructStream
 
     DisconnectStreamFromAllConnectors (streamPtr);
 
+    // The stream is released: its paths can't wait for the end of the routing update.
+    ApplyPathChanges(streamPtr);
+
     pa_audio_ReleasePaParameters(streamPtr);
 
     le_hashmap_RemoveAll(streamPtr->connectorList);
@@ -1111,6 +1328,7 @@ static le_audio_StreamRef_t OpenAudioStream
                 memcpy( &audioStreamPtr->samplePcmConfig,
                         &SampleDefaultPcmConfig,
                         sizeof(le_audio_SamplePcmConfig_t) );
+                audioStreamPtr->sampleLatency = LE_MEDIA_DEFAULT_SAMPLE_LATENCY;
             break;
             case LE_AUDIO_IF_DSP_BACKEND_MODEM_VOICE_RX:
                 // streamEventId needed for DTMF detection
@@ -1206,6 +1424,13 @@ static void CloseSessionEventHandler
     void*               contextPtr
 )
 {
+    // Apply the routing update left in progress by the client
+    if (IsRoutingUpdateStarted && (RoutingUpdateSessionRef == sessionRef))
+    {
+        IsRoutingUpdateStarted = false;
+        ApplyPathChanges(NULL);
+    }
+
     le_ref_IterRef_t iterRef = le_ref_GetIterator(AudioConnectorRefMap);
 
     le_result_t result = le_ref_NextNode(iterRef);
@@ -1292,6 +1517,9 @@ COMPONENT_INIT
     EventIdPool = le_mem_CreatePool("EventIdPool", sizeof(struct eventIdList));
     le_mem_ExpandPool(EventIdPool, EVENTID_DEFAULT_POOL_SIZE);
 
+    PathChangePool = le_mem_CreatePool("PathChangePool", sizeof(PathChange_t));
+    le_mem_ExpandPool(PathChangePool, PATHCHANGE_DEFAULT_POOL_SIZE);
+
     SessionRefPool = le_mem_CreatePool("SessionRefPool", sizeof(SessionRefNode_t));
     le_mem_ExpandPool(SessionRefPool, MAX_NUM_OF_STREAM);
 
@@ -2017,6 +2245,59 @@ void le_audio_Disconnect
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a routing update. Until the update is applied, the audio paths are not changed by
+ * le_audio_Connect(), le_audio_Disconnect() and le_audio_DeleteConnector(): their net changes are
+ * recorded and then applied together by le_audio_ApplyRoutingUpdate().
+ *
+ * @return LE_BUSY          A routing update is already in progress.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_StartRoutingUpdate
+(
+    void
+)
+{
+    if (IsRoutingUpdateStarted)
+    {
+        LE_ERROR("A routing update is already in progress");
+        return LE_BUSY;
+    }
+
+    IsRoutingUpdateStarted = true;
+    RoutingUpdateSessionRef = le_audio_GetClientSessionRef();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the routing update: the audio paths which are no longer needed are reset, then the new
+ * audio paths are set. The paths which are kept, or set and reset again, are left unchanged.
+ *
+ * @return LE_NOT_PERMITTED No routing update was started by this client.
+ * @return LE_FAULT         An audio path could not be changed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_ApplyRoutingUpdate
+(
+    void
+)
+{
+    if ((!IsRoutingUpdateStarted) || (RoutingUpdateSessionRef != le_audio_GetClientSessionRef()))
+    {
+        LE_ERROR("No routing update was started by this client");
+        return LE_NOT_PERMITTED;
+    }
+
+    IsRoutingUpdateStarted = false;
+
+    return ApplyPathChanges(NULL);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * le_audio_DtmfDetectorHandler handler ADD function
@@ -3262,6 +3543,119 @@ le_result_t le_audio_GetSamplePcmSamplingResolution
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the latency target of the PCM samples buffer of a player or recorder stream. It is used by
+ * the next play/record.
+ *
+ * @return LE_BAD_PARAMETER The latency target is 0.
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_SetSampleLatency
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t latency
+        ///< [IN]
+        ///< Latency target in milliseconds.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    if (latency == 0)
+    {
+        LE_ERROR("Invalid latency target");
+        return LE_BAD_PARAMETER;
+    }
+
+    streamPtr->sampleLatency = latency;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the latency target of the PCM samples buffer of a player or recorder stream.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_GetSampleLatency
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t* latencyPtr
+        ///< [OUT]
+        ///< Latency target in milliseconds.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    *latencyPtr = streamPtr->sampleLatency;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of playback underruns and capture overruns of the PCM samples buffer of a player
+ * or recorder stream, since the start of the last play/record.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_GetSampleXrunCount
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t* underrunCountPtr,
+        ///< [OUT]
+        ///< Number of playback underruns.
+
+    uint32_t* overrunCountPtr
+        ///< [OUT]
+        ///< Number of capture overruns.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    *underrunCountPtr = __atomic_load_n(&streamPtr->underrunCount, __ATOMIC_RELAXED);
+    *overrunCountPtr = __atomic_load_n(&streamPtr->overrunCount, __ATOMIC_RELAXED);
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to play a DTMF on a specific audio stream.
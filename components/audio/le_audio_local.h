@@ -73,6 +73,49 @@ typedef enum
 le_audio_If_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Single producer, single consumer ring of PCM samples between the file descriptor of a
+ * playback/capture and the PCM thread.
+ *
+ * The head is only moved by the producer and the tail by the consumer. Both are free running byte
+ * counters, published with release/acquire ordering so that the PCM thread never takes a lock nor
+ * blocks on the file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct {
+    uint8_t*                    bufferPtr;          ///< Ring storage
+    uint32_t                    size;               ///< Size of the storage, a power of 2
+    uint32_t                    head;               ///< Bytes written by the producer
+    uint32_t                    tail;               ///< Bytes read by the consumer
+    uint32_t                    threshold;          ///< Bytes to buffer before playing, i.e. the
+                                                    ///  latency target
+    uint32_t                    frameSize;          ///< Size of a PCM frame in bytes
+    struct timespec             waitTime;           ///< Time to wait on a full/empty ring
+    bool                        isPrimed;           ///< Playback started, reset on underrun
+    uint32_t                    primingLen;         ///< Silence played waiting for the latency
+                                                    ///  target, in bytes
+    bool                        isFlushRequested;   ///< Samples to drop by the consumer
+    bool                        isClosed;           ///< The ring thread has stopped
+    le_result_t                 result;             ///< Result of the ring thread once closed
+    le_sem_Ref_t                primedSemaphore;    ///< Semaphore posted when playback can start
+    le_thread_Ref_t             threadRef;          ///< Thread feeding (playback) or draining
+                                                    ///  (capture) the ring
+}
+le_audio_SampleRing_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory mapping of a WAV file, whose samples are played straight from the mapping.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct {
+    uint8_t*                    addr;               ///< Address of the mapping, NULL if unmapped
+    size_t                      len;                ///< Length of the mapping (whole file)
+    size_t                      pos;                ///< Offset of the next sample to play
+}
+le_audio_FileMap_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The data parameters structure associated to the playback/capture thread.
@@ -87,7 +130,8 @@ typedef struct {
     le_audio_If_t               interface;          ///< audio interface
     bool                        pause;              ///< pause in capture
     le_audio_MediaEvent_t       mediaEvent;         ///< media event to be sent
-    int                         framesFuncTimeout;  ///< Timeout for getFramesFunc callback
+    le_audio_SampleRing_t       ring;               ///< Samples ring between fd and PCM thread
+    bool                        isMapped;           ///< Samples are played from a file mapping
 }
 le_audio_PcmContext_t;
 
@@ -148,6 +192,21 @@ typedef le_result_t (*CloseMediaFunc_t)
 typedef struct le_audio_Opaque* le_audio_Codec_t;
 typedef struct le_audio_Opaque* pa_audio_Params_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Codec statistics of the Media thread.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t                         frameLen;           ///< Length of a PCM frame in bytes
+    uint32_t                         callCount;          ///< Number of codec calls
+    uint64_t                         pcmBytes;           ///< Number of PCM bytes coded
+    uint64_t                         cpuTimeNs;          ///< CPU time spent in the codec
+    uint64_t                         maxLatencyNs;       ///< Longest delay of a codec call
+}
+le_audio_CodecStats_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The data parameters structure associated to the Media thread.
@@ -172,6 +231,7 @@ typedef struct le_audio_MediaThreadContext
     CloseMediaFunc_t                 closeFunc;          ///< Close function for play/capture
                                                          ///< in WAV/AMR format
     le_audio_Codec_t                 codecParams;        ///< Codec parameters
+    le_audio_CodecStats_t            codecStats;         ///< Codec statistics
 }
 le_audio_MediaThreadContext_t;
 
@@ -208,6 +268,11 @@ typedef struct le_audio_Stream {
     pa_audio_Params_t   PaParams;                      ///< PA Parameters
     bool echoCancellerEnabled;                         ///< Store the status of echo canceller
     bool noiseSuppressorEnabled;                       ///< Store the status of noise suppressor
+    uint32_t            sampleLatency;                 ///< Latency target of the samples ring in
+                                                       ///  milliseconds
+    uint32_t            underrunCount;                 ///< Playback underruns of the last play
+    uint32_t            overrunCount;                  ///< Capture overruns of the last record
+    le_audio_FileMap_t  fileMap;                       ///< Mapping of the WAV file played
 }
 le_audio_Stream_t;
 
@@ -16,6 +16,7 @@
 #include "pa_amr.h"
 #include "pa_pcm.h"
 #include <math.h>
+#include <sys/mman.h>
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -39,6 +40,24 @@
 #define PI 3.14159265358979323846264338327
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sine table used to generate the DTMF tones: number of entries (a power of 2, plus one entry to
+ * interpolate the last one), and fixed point format of its values (Q30).
+ */
+//--------------------------------------------------------------------------------------------------
+#define SINE_TABLE_BITS     10
+#define SINE_TABLE_SIZE     (1 << SINE_TABLE_BITS)
+#define SINE_TABLE_SHIFT    30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Amplitude of a DTMF tone, in Q8 fixed point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TONE_AMPLITUDE_SHIFT    8
+#define TONE_AMPLITUDE          ((SAMPLE_SCALE * DTMF_AMPLITUDE << TONE_AMPLITUDE_SHIFT) / 100)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Symbols used to populate wave header file.
@@ -57,6 +76,23 @@
 //--------------------------------------------------------------------------------------------------
 #define NO_MORE_SAMPLES_INFINITE_TIMEOUT -1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the samples ring between the file descriptor and the PCM thread (a power of 2).
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_RING_SIZE    (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AMR frames: duration of a frame in ms, number of frames encoded per codec call, and biggest
+ * encoded frame (AMR-WB 23.85 kbps) in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_FRAME_MS            20
+#define AMR_BATCH_FRAMES        5
+#define AMR_MAX_FRAME_BYTES     61
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
@@ -139,6 +175,13 @@ ControlOperation_t;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t DtmfParamsPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sine table of a whole cycle used to generate the DTMF tones, in Q30 fixed point.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t SineTable[SINE_TABLE_SIZE + 1];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The memory pool for the WAV parameters
@@ -160,6 +203,13 @@ static le_mem_PoolRef_t MediaThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t PcmThreadContextPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the samples ring storage
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SampleRingPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Wake Lock for audio streams
@@ -409,6 +459,49 @@ static inline int16_t SaturateAdd16
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the phase of a tone at a given sample, in 1/2^32 of a cycle. The phase is computed exactly
+ *  from the sample index, so that a tone split over several calls of PlayTone() stays continuous.
+ *  For the sample 1, this is the phase increment of the tone, rounded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t TonePhase
+(
+    uint32_t freq,          ///< [IN] Tone frequency in Hertz
+    uint32_t sampleRate,    ///< [IN] Sample frequency in Hertz
+    uint32_t sampleIndex    ///< [IN] Index of the sample
+)
+{
+    uint64_t cycleFraction = ((uint64_t)freq * sampleIndex) % sampleRate;
+
+    return (uint32_t)(((cycleFraction << 32) + (sampleRate / 2)) / sampleRate);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a sample of a DTMF tone from the sine table, at a given phase (in 1/2^32 of a cycle).
+ *  The table is linearly interpolated, so the samples are within 1 LSB of the ones computed with
+ *  sin().
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int32_t ToneSample
+(
+    uint32_t phase          ///< [IN] Phase of the sample
+)
+{
+    uint32_t index = phase >> (32 - SINE_TABLE_BITS);
+    int32_t  frac = (phase >> (32 - SINE_TABLE_BITS - 15)) & 0x7FFF;
+    int32_t  sine = SineTable[index] +
+                    (int32_t)(((int64_t)(SineTable[index + 1] - SineTable[index]) * frac) >> 15);
+
+    // Round toward zero, as the conversion of the sin() product to an integer does.
+    return (int32_t)(((int64_t)sine * TONE_AMPLITUDE) /
+                     ((int64_t)1 << (SINE_TABLE_SHIFT + TONE_AMPLITUDE_SHIFT)));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Play Tone function. This function split into samples of 1s. To play a DTMF or a PAUSE for a
@@ -423,7 +516,8 @@ static le_result_t PlayTone
     uint32_t*                      bufferLenPtr  ///< [OUT] Length of the buffer
 )
 {
-    double   d1, d2;
+    uint32_t phase1, phase2;
+    uint32_t step1, step2;
     uint32_t i;
 
     DtmfParams_t*  dtmfParamsPtr = (DtmfParams_t*) mediaCtxPtr->codecParams;
@@ -433,8 +527,6 @@ static le_result_t PlayTone
     uint32_t sampleOneSecond = dtmfParamsPtr->sampleRate + dtmfParamsPtr->currentSampleCount;
     uint32_t freq1;
     uint32_t freq2;
-    int32_t  amp1;
-    int32_t  amp2;
     int16_t* dataPtr = (int16_t*) bufferOutPtr;
     // Length of the current sample: max 1 second, i.e, sampleRate
     uint32_t sampleLength;
@@ -490,22 +582,20 @@ static le_result_t PlayTone
 
         freq1 = Digit2LowFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
         freq2 = Digit2HighFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
-        amp1 = DTMF_AMPLITUDE;
-        amp2 = DTMF_AMPLITUDE;
-
-        d1 = 1.0f * freq1 / dtmfParamsPtr->sampleRate;
-        d2 = 1.0f * freq2 / dtmfParamsPtr->sampleRate;
+        // Both tones are generated with a phase accumulator over the sine table.
+        phase1 = TonePhase(freq1, dtmfParamsPtr->sampleRate, dtmfParamsPtr->currentSampleCount);
+        phase2 = TonePhase(freq2, dtmfParamsPtr->sampleRate, dtmfParamsPtr->currentSampleCount);
+        step1 = TonePhase(freq1, dtmfParamsPtr->sampleRate, 1);
+        step2 = TonePhase(freq2, dtmfParamsPtr->sampleRate, 1);
 
         for (i = dtmfParamsPtr->currentSampleCount;
              // Play max sampleRate (1s) of DTMF and continue at next call
              (i < sampleOneSecond) && (i < samplesCount);
              i++)
         {
-            int16_t s1, s2;
-
-            s1 = (int16_t)(SAMPLE_SCALE * amp1 / 100.0f * sin(2 * PI * d1 * i));
-            s2 = (int16_t)(SAMPLE_SCALE * amp2 / 100.0f * sin(2 * PI * d2 * i));
-            *(dataPtr++) = SaturateAdd16(s1, s2);
+            *(dataPtr++) = SaturateAdd16(ToneSample(phase1), ToneSample(phase2));
+            phase1 += step1;
+            phase2 += step2;
         }
 
         // Save the current sample count. If the whole DTMF is played, reset to 0
@@ -573,6 +663,101 @@ static le_result_t SetWavHeader
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time of a clock in ns.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetClockNs
+(
+    clockid_t clockId       ///< [IN] Clock to read
+)
+{
+    struct timespec ts;
+
+    clock_gettime(clockId, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the codec statistics of an AMR codec.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitAmrStats
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr      ///< [IN] Media thread context
+)
+{
+    uint32_t sampleRate = (mediaCtxPtr->format == LE_AUDIO_FILE_AMR_WB) ? 16000 : 8000;
+
+    memset(&mediaCtxPtr->codecStats, 0, sizeof(mediaCtxPtr->codecStats));
+    mediaCtxPtr->codecStats.frameLen = (sampleRate / 1000) * AMR_FRAME_MS * sizeof(int16_t);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for a codec call in the codec statistics. The delay of a call is the duration of the
+ * PCM samples it codes, plus the time it takes.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateCodecStats
+(
+    le_audio_CodecStats_t* statsPtr,    ///< [IN] Codec statistics
+    uint64_t               cpuStartNs,  ///< [IN] Thread CPU time at the start of the call
+    uint64_t               startNs,     ///< [IN] Monotonic time at the start of the call
+    uint32_t               pcmLen       ///< [IN] Length of the PCM samples coded by the call
+)
+{
+    uint64_t latencyNs = GetClockNs(CLOCK_MONOTONIC) - startNs;
+
+    statsPtr->cpuTimeNs += GetClockNs(CLOCK_THREAD_CPUTIME_ID) - cpuStartNs;
+    statsPtr->callCount++;
+    statsPtr->pcmBytes += pcmLen;
+
+    if (statsPtr->frameLen)
+    {
+        latencyNs += ((uint64_t)pcmLen * AMR_FRAME_MS * 1000000ULL) / statsPtr->frameLen;
+    }
+
+    if (latencyNs > statsPtr->maxLatencyNs)
+    {
+        statsPtr->maxLatencyNs = latencyNs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the codec statistics.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportCodecStats
+(
+    le_audio_CodecStats_t* statsPtr     ///< [IN] Codec statistics
+)
+{
+    uint64_t frameCount;
+
+    if ((statsPtr->callCount == 0) || (statsPtr->frameLen == 0))
+    {
+        return;
+    }
+
+    frameCount = statsPtr->pcmBytes / statsPtr->frameLen;
+
+    LE_INFO("AMR codec: %"PRIu64" frames in %"PRIu32" calls, %"PRIu64" us CPU per frame, "
+            "max latency %"PRIu64" ms",
+            frameCount,
+            statsPtr->callCount,
+            frameCount ? (statsPtr->cpuTimeNs / frameCount) / 1000 : 0,
+            statsPtr->maxLatencyNs / 1000000);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read a file descriptor.
@@ -636,6 +821,10 @@ static le_result_t AmrWriteFd
     uint32_t outputBufLen = 500;
     uint8_t outputBuf[outputBufLen];
     le_result_t result = LE_FAULT;
+    uint64_t cpuStartNs = GetClockNs(CLOCK_THREAD_CPUTIME_ID);
+    uint64_t startNs = GetClockNs(CLOCK_MONOTONIC);
+
+    LE_ASSERT(outputBufLen >= AMR_BATCH_FRAMES * AMR_MAX_FRAME_BYTES);
 
     if (pa_amr_EncodeFrames(mediaCtxPtr,
                             bufferInPtr,
@@ -643,6 +832,8 @@ static le_result_t AmrWriteFd
                             outputBuf,
                             &outputBufLen) == LE_OK)
     {
+        UpdateCodecStats(&mediaCtxPtr->codecStats, cpuStartNs, startNs, bufferLen);
+
         int32_t writeLen = WriteFd( mediaCtxPtr->fd_out, outputBuf, outputBufLen );
 
         if (writeLen != outputBufLen)
@@ -829,6 +1020,8 @@ static void DestroyMediaThread
 
     if (mediaCtxPtr)
     {
+        ReportCodecStats(&mediaCtxPtr->codecStats);
+
         mediaCtxPtr->closeFunc(mediaCtxPtr);
 
         close(mediaCtxPtr->fd_pipe_input);
@@ -1038,6 +1231,138 @@ static le_result_t PlayWavFile
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a WAV file whose header has been read, so that its samples are played straight from the
+ * mapping, without media thread nor copy through a pipe. The file is read ahead from now on,
+ * so that the playback doesn't wait for the flash.
+ *
+ * @return LE_UNSUPPORTED   The file can't be mapped (not a regular file).
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MapWavFile
+(
+    le_audio_Stream_t*             streamPtr
+)
+{
+    struct stat st;
+    off_t dataOffset = lseek(streamPtr->fd, 0, SEEK_CUR);
+    void* addr;
+
+    if ((dataOffset < 0) || (fstat(streamPtr->fd, &st) != 0) || !S_ISREG(st.st_mode) ||
+        (st.st_size <= dataOffset))
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, streamPtr->fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        LE_WARN("Cannot map WAV file: %m");
+        return LE_FAULT;
+    }
+
+    // The samples are read once, from the beginning to the end
+    if ((madvise(addr, st.st_size, MADV_SEQUENTIAL) != 0) ||
+        (madvise(addr, st.st_size, MADV_WILLNEED) != 0))
+    {
+        LE_WARN("madvise failed on WAV file: %m");
+    }
+
+    streamPtr->fileMap.addr = addr;
+    streamPtr->fileMap.len = st.st_size;
+    streamPtr->fileMap.pos = dataOffset;
+
+    LE_DEBUG("WAV file mapped, %zu bytes of samples", (size_t)(st.st_size - dataOffset));
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a WAV file. The file offset is set after the last sample played, as if the samples were
+ * read.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnmapWavFile
+(
+    le_audio_Stream_t*             streamPtr
+)
+{
+    if (streamPtr->fileMap.addr)
+    {
+        lseek(streamPtr->fd, streamPtr->fileMap.pos, SEEK_SET);
+        munmap(streamPtr->fileMap.addr, streamPtr->fileMap.len);
+        memset(&streamPtr->fileMap, 0, sizeof(streamPtr->fileMap));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the AMR decoder.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AmrStartDecoder
+(
+    le_audio_Stream_t*             streamPtr,       ///< [IN] Stream object
+    le_audio_MediaThreadContext_t* mediaCtxPtr      ///< [IN] Media thread context
+)
+{
+    InitAmrStats(mediaCtxPtr);
+
+    return pa_amr_StartDecoder(streamPtr, mediaCtxPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode AMR frames.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AmrDecodeFrames
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,     ///< [IN] Media thread context
+    uint8_t*                       bufferOutPtr,    ///< [OUT] Decoding samples buffer output
+    uint32_t*                      readLenPtr       ///< [OUT] Length of the read data
+)
+{
+    uint64_t cpuStartNs = GetClockNs(CLOCK_THREAD_CPUTIME_ID);
+    uint64_t startNs = GetClockNs(CLOCK_MONOTONIC);
+    le_result_t result = pa_amr_DecodeFrames(mediaCtxPtr, bufferOutPtr, readLenPtr);
+
+    if (result == LE_OK)
+    {
+        UpdateCodecStats(&mediaCtxPtr->codecStats, cpuStartNs, startNs, *readLenPtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the AMR encoder. The samples are read by batches of AMR_BATCH_FRAMES frames, so that each
+ * codec call encodes several frames.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AmrStartEncoder
+(
+    le_audio_Stream_t*             streamPtr,       ///< [IN] Stream object
+    le_audio_MediaThreadContext_t* mediaCtxPtr      ///< [IN] Media thread context
+)
+{
+    le_result_t result = pa_amr_StartEncoder(streamPtr, mediaCtxPtr);
+
+    InitAmrStats(mediaCtxPtr);
+    mediaCtxPtr->bufferSize = mediaCtxPtr->codecStats.frameLen * AMR_BATCH_FRAMES;
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function check the file header to detect an AMR file, and get the PCM configuration.
@@ -1099,8 +1424,8 @@ static le_result_t PlayAmrFile
         samplePcmConfigPtr->channelsCount = 1;
         samplePcmConfigPtr->bitsPerSample = 16;
 
-        mediaContextPtr->initFunc = pa_amr_StartDecoder;
-        mediaContextPtr->readFunc = pa_amr_DecodeFrames;
+        mediaContextPtr->initFunc = AmrStartDecoder;
+        mediaContextPtr->readFunc = AmrDecodeFrames;
         mediaContextPtr->writeFunc = MediaWriteFd;
         mediaContextPtr->closeFunc = pa_amr_StopDecoder;
 
@@ -1197,7 +1522,7 @@ static le_result_t RecordAmrFile
         samplePcmConfigPtr->sampleRate = 8000;
     }
 
-    mediaCtxPtr->initFunc = pa_amr_StartEncoder;
+    mediaCtxPtr->initFunc = AmrStartEncoder;
     mediaCtxPtr->readFunc = MediaReadFd;
     mediaCtxPtr->writeFunc = AmrWriteFd;
     mediaCtxPtr->closeFunc = pa_amr_StopEncoder;
@@ -1241,6 +1566,335 @@ static le_result_t RecordWavFile
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write samples in the ring. Called by the producer only.
+ *
+ * @return
+ *      Number of bytes written, less than requested if the ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t WriteSampleRing
+(
+    le_audio_SampleRing_t* ringPtr,     ///< [IN] Samples ring
+    const uint8_t* bufferPtr,           ///< [IN] Samples to write
+    uint32_t len                        ///< [IN] Number of bytes to write
+)
+{
+    uint32_t head = ringPtr->head;
+    uint32_t space = ringPtr->size - (head - __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE));
+    uint32_t offset = head & (ringPtr->size - 1);
+    uint32_t firstLen;
+
+    if (len > space)
+    {
+        len = space;
+    }
+
+    // Copy up to the end of the storage, then wrap around
+    firstLen = ((ringPtr->size - offset) < len) ? (ringPtr->size - offset) : len;
+    memcpy(ringPtr->bufferPtr + offset, bufferPtr, firstLen);
+    memcpy(ringPtr->bufferPtr, bufferPtr + firstLen, len - firstLen);
+
+    __atomic_store_n(&ringPtr->head, head + len, __ATOMIC_RELEASE);
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read samples from the ring. Called by the consumer only.
+ *
+ * @return
+ *      Number of bytes read, less than requested if the ring is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReadSampleRing
+(
+    le_audio_SampleRing_t* ringPtr,     ///< [IN] Samples ring
+    uint8_t* bufferPtr,                 ///< [OUT] Buffer to store the samples in
+    uint32_t len                        ///< [IN] Size of the buffer
+)
+{
+    uint32_t tail = ringPtr->tail;
+    uint32_t fill = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE) - tail;
+    uint32_t offset = tail & (ringPtr->size - 1);
+    uint32_t firstLen;
+
+    if (len > fill)
+    {
+        len = fill;
+    }
+
+    // Copy up to the end of the storage, then wrap around
+    firstLen = ((ringPtr->size - offset) < len) ? (ringPtr->size - offset) : len;
+    memcpy(bufferPtr, ringPtr->bufferPtr + offset, firstLen);
+    memcpy(bufferPtr + firstLen, ringPtr->bufferPtr, len - firstLen);
+
+    __atomic_store_n(&ringPtr->tail, tail + len, __ATOMIC_RELEASE);
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the ring from the thread on the file descriptor side, with the given result.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSampleRing
+(
+    le_audio_SampleRing_t* ringPtr,     ///< [IN] Samples ring
+    le_result_t result                  ///< [IN] Result of the ring thread
+)
+{
+    ringPtr->result = result;
+    __atomic_store_n(&ringPtr->isClosed, true, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Playback ring thread: read the samples from the file descriptor into the ring, so that the PCM
+ * thread never blocks on the file descriptor.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PlaybackRingThread
+(
+    void* contextPtr
+)
+{
+    le_audio_PcmContext_t* pcmContextPtr = contextPtr;
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
+    struct pollfd pfd;
+    bool semPost = false;
+
+    pfd.fd = pcmContextPtr->fd;
+    pfd.events = POLLIN;
+
+    while (1)
+    {
+        uint32_t head = ringPtr->head;
+        uint32_t fill = head - __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE);
+        uint32_t offset = head & (ringPtr->size - 1);
+        uint32_t len = ringPtr->size - fill;
+        ssize_t readLen;
+
+        if (!semPost && (fill >= ringPtr->threshold))
+        {
+            le_sem_Post(ringPtr->primedSemaphore);
+            semPost = true;
+        }
+
+        if (0 == len)
+        {
+            // Ring is full: wait for the PCM thread to consume samples
+            nanosleep(&ringPtr->waitTime, NULL);
+            continue;
+        }
+
+        // Read up to the end of the storage, the rest is read on the next loop
+        if (len > (ringPtr->size - offset))
+        {
+            len = ringPtr->size - offset;
+        }
+
+        // The file descriptor may be temporarily set non-blocking by a flush
+        if ((poll(&pfd, 1, -1) == -1) && (errno != EINTR) && (errno != EAGAIN))
+        {
+            LE_ERROR("Failed in poll: %m");
+            CloseSampleRing(ringPtr, LE_FAULT);
+            break;
+        }
+
+        readLen = read(pcmContextPtr->fd, ringPtr->bufferPtr + offset, len);
+
+        if (readLen == 0)
+        {
+            LE_DEBUG("Writing end of pipe was closed on fd %d", pcmContextPtr->fd);
+            CloseSampleRing(ringPtr, LE_CLOSED);
+            break;
+        }
+        else if (readLen < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                continue;
+            }
+
+            LE_ERROR("Failed in read: %m");
+            CloseSampleRing(ringPtr, LE_FAULT);
+            break;
+        }
+
+        __atomic_store_n(&ringPtr->head, head + readLen, __ATOMIC_RELEASE);
+    }
+
+    if (!semPost)
+    {
+        le_sem_Post(ringPtr->primedSemaphore);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capture ring thread: write the samples captured by the PCM thread into the file descriptor, so
+ * that the PCM thread never blocks on the file descriptor.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CaptureRingThread
+(
+    void* contextPtr
+)
+{
+    le_audio_PcmContext_t* pcmContextPtr = contextPtr;
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
+
+    while (1)
+    {
+        uint32_t tail = ringPtr->tail;
+        uint32_t fill = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE) - tail;
+        uint32_t offset = tail & (ringPtr->size - 1);
+
+        if (0 == fill)
+        {
+            // Ring is empty: wait for the PCM thread to capture samples
+            nanosleep(&ringPtr->waitTime, NULL);
+            continue;
+        }
+
+        // Write up to the end of the storage, the rest is written on the next loop
+        if (fill > (ringPtr->size - offset))
+        {
+            fill = ringPtr->size - offset;
+        }
+
+        if (WriteFd(pcmContextPtr->fd, ringPtr->bufferPtr + offset, fill) < 0)
+        {
+            LE_ERROR("Cannot write on pipe");
+            CloseSampleRing(ringPtr, LE_FAULT);
+            break;
+        }
+
+        __atomic_store_n(&ringPtr->tail, tail + fill, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the samples ring of a playback/capture, and its thread on the file descriptor side.
+ * For a playback, wait (up to twice the latency target) for the ring to be filled up to the
+ * latency target, so that the playback starts with the expected samples.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartSampleRing
+(
+    le_audio_Stream_t*     streamPtr,       ///< [IN] Stream object
+    le_audio_PcmContext_t* pcmContextPtr    ///< [IN] Playback/capture context
+)
+{
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
+    uint32_t latency = streamPtr->sampleLatency;
+    uint64_t threshold;
+    uint64_t waitTime;
+    char name[STRING_LEN];
+
+    ringPtr->bufferPtr = le_mem_ForceAlloc(SampleRingPool);
+    ringPtr->size = SAMPLE_RING_SIZE;
+    ringPtr->frameSize = (pcmContextPtr->pcmConfig.channelsCount *
+                          pcmContextPtr->pcmConfig.bitsPerSample) / 8;
+    if (0 == ringPtr->frameSize)
+    {
+        ringPtr->frameSize = 1;
+    }
+
+    // Latency target in whole frames, leaving room in the ring for the producer
+    threshold = ((uint64_t)latency * pcmContextPtr->pcmConfig.byteRate) / 1000;
+    if (threshold > (SAMPLE_RING_SIZE / 2))
+    {
+        LE_WARN("Latency %u ms too high for the samples ring, limited to %u bytes",
+                latency, SAMPLE_RING_SIZE / 2);
+        threshold = SAMPLE_RING_SIZE / 2;
+    }
+    ringPtr->threshold = threshold - (threshold % ringPtr->frameSize);
+    if (0 == ringPtr->threshold)
+    {
+        ringPtr->threshold = ringPtr->frameSize;
+    }
+
+    // A full/empty ring is polled every half latency target
+    waitTime = (uint64_t)latency * 500000;
+    ringPtr->waitTime.tv_sec = waitTime / 1000000000;
+    ringPtr->waitTime.tv_nsec = waitTime % 1000000000;
+
+    streamPtr->underrunCount = 0;
+    streamPtr->overrunCount = 0;
+
+    LE_DEBUG("Samples ring: latency %u ms, threshold %u bytes", latency, ringPtr->threshold);
+
+    snprintf(name, sizeof(name), "SampleRing-%p", streamPtr->streamRef);
+
+    if (LE_AUDIO_IF_DSP_FRONTEND_FILE_PLAY == streamPtr->audioInterface)
+    {
+        ringPtr->primedSemaphore = le_sem_Create(name, 0);
+        ringPtr->threadRef = le_thread_Create(name, PlaybackRingThread, pcmContextPtr);
+    }
+    else
+    {
+        ringPtr->threadRef = le_thread_Create(name, CaptureRingThread, pcmContextPtr);
+    }
+
+    // Same priority as the file playback media thread, to avoid underflow
+    le_thread_SetPriority(ringPtr->threadRef, LE_THREAD_PRIORITY_RT_3);
+    le_thread_SetJoinable(ringPtr->threadRef);
+    le_thread_Start(ringPtr->threadRef);
+
+    if (ringPtr->primedSemaphore)
+    {
+        le_clk_Time_t timeToWait = { latency / 500, (latency % 500) * 2000 };
+        le_sem_WaitWithTimeOut(ringPtr->primedSemaphore, timeToWait);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the samples ring of a playback/capture, once the PCM thread is stopped. The samples left
+ * in the ring are dropped.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopSampleRing
+(
+    le_audio_PcmContext_t* pcmContextPtr    ///< [IN] Playback/capture context
+)
+{
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
+
+    if (ringPtr->threadRef)
+    {
+        le_thread_Cancel(ringPtr->threadRef);
+        le_thread_Join(ringPtr->threadRef, NULL);
+        ringPtr->threadRef = NULL;
+    }
+
+    if (ringPtr->primedSemaphore)
+    {
+        le_sem_Delete(ringPtr->primedSemaphore);
+        ringPtr->primedSemaphore = NULL;
+    }
+
+    if (ringPtr->bufferPtr)
+    {
+        le_mem_Release(ringPtr->bufferPtr);
+        ringPtr->bufferPtr = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Control the playback thread (pause/resume)
@@ -1288,7 +1942,12 @@ static le_result_t PlayCaptControl
 
         case FLUSH:
             // flush the audio stream
-            if (pcmContextPtr)
+            if (pcmContextPtr && pcmContextPtr->isMapped)
+            {
+                // The samples are played from the file mapping: none is buffered
+                res = LE_OK;
+            }
+            else if (pcmContextPtr)
             {
                 pcmContextPtr->pause = true;
 
@@ -1322,6 +1981,9 @@ static le_result_t PlayCaptControl
                     break;
                 }
 
+                // Drop the samples already in the ring
+                __atomic_store_n(&pcmContextPtr->ring.isFlushRequested, true, __ATOMIC_RELEASE);
+
                 pcmContextPtr->pause = false;
 
                 res = LE_OK;
@@ -1411,7 +2073,11 @@ static void PlayTreatEvent
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get Playback frames
+ * Get Playback frames from the samples ring. This function never blocks:
+ * - when the ring is empty, no frame is returned, as when all the samples have been played. If
+ *   the ring ran empty while playing (underrun), it is filled again up to the latency target.
+ * - until the latency target is buffered, silence frames are played. The wait is limited to the
+ *   latency target, so that the last samples of a stream are eventually played.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -1424,102 +2090,127 @@ static le_result_t GetPlaybackFrames
 {
     le_audio_Stream_t* streamPtr = contextPtr;
     le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
-    int32_t len = 0;
-    int ret;
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
     uint32_t size = *bufsizePtr;
-    uint32_t amount = 0;
-    nfds_t nfds = 1;
-    struct pollfd pfd;
+    uint32_t fill;
+    bool isClosed;
 
-    pfd.fd = pcmContextPtr->fd;
-    pfd.events = POLLIN;
+    if (__atomic_exchange_n(&ringPtr->isFlushRequested, false, __ATOMIC_ACQUIRE))
+    {
+        __atomic_store_n(&ringPtr->tail,
+                         __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
+        ringPtr->isPrimed = false;
+    }
+
+    // playback is paused: return without reading samples
+    if (pcmContextPtr->pause)
+    {
+        memset(bufferPtr, 0, size);
+        return LE_OK;
+    }
+
+    // Once the ring is closed, its head doesn't move anymore
+    isClosed = __atomic_load_n(&ringPtr->isClosed, __ATOMIC_ACQUIRE);
+    fill = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE) - ringPtr->tail;
+
+    if (isClosed && (0 == fill))
+    {
+        return ringPtr->result;
+    }
 
-    while (size)
+    // Only play whole frames, except for the last samples
+    if (!isClosed)
     {
-        ret = poll(&pfd, nfds, pcmContextPtr->framesFuncTimeout);
+        fill -= fill % ringPtr->frameSize;
+    }
 
-        switch (ret)
+    if (0 == fill)
+    {
+        // no more samples available at this point:
+        // send silence frames to avoid xrun
+        if (ringPtr->isPrimed)
         {
-            case -1:
-                if ((errno == EINTR) || (errno == EAGAIN))
-                {
-                    // read again
-                    LE_WARN("Failed in poll: %m");
-                    continue;
-                }
-                else
-                {
-                    LE_ERROR("Failed in poll: %m");
-                    return LE_FAULT;
-                }
-                break;
-            case 0:
-                // timeout: no data read
-                LE_DEBUG("No data read");
-                if (!amount)
-                {
-                    // no more samples available at this point:
-                    // send silence frames to avoid xrun
-                    memset(bufferPtr, 0, size);
-                    size = 0;
-                }
-                *bufsizePtr = amount;
-                return LE_OK;
-            default:
-                // playback is paused: return without reading samples
-                if (pcmContextPtr->pause)
-                {
-                    amount = *bufsizePtr;
-                    memset(bufferPtr, 0, amount);
-                    return LE_OK;
-                }
-                else if (pfd.revents & POLLIN)
-                {
-                    len = read(pcmContextPtr->fd, bufferPtr + amount, size);
-
-                    if (len == 0)
-                    {
-                        LE_ERROR("Failed to read on fd %d, writing end of pipe was closed",
-                                 pcmContextPtr->fd);
-                        return LE_CLOSED;
-                    }
-                    else if (len > 0)
-                    {
-                        size -= len;
-                        amount += len;
-                        *bufsizePtr = amount;
-                        // update timeout value for remaining data to be read
-                        long msec = (pa_pcm_GetPeriodSize(pcmContextPtr->pcmHandle) *
-                                     (1000000 / (pcmContextPtr->pcmConfig.byteRate))) / 1000;
-                        pcmContextPtr->framesFuncTimeout = msec;
-                        continue;
-                    }
-                    else if (len < 0)
-                    {
-                        LE_ERROR("Failed in read: %m");
-                        return LE_FAULT;
-                    }
-                }
-                else if ((pfd.revents & POLLHUP) || (pfd.revents & POLLRDHUP))
-                {
-                    LE_ERROR("Write-end of pipe was closed (%m)");
-                    return LE_CLOSED;
-                }
-                else if (pfd.revents & POLLERR)
-                {
-                    LE_ERROR("Failed in poll: %m");
-                    return LE_FAULT;
-                }
-                break;
+            // The ring ran empty while playing: buffer again up to the latency target
+            LE_DEBUG("Playback underrun");
+            __atomic_fetch_add(&streamPtr->underrunCount, 1, __ATOMIC_RELAXED);
+            ringPtr->isPrimed = false;
+        }
+        memset(bufferPtr, 0, size);
+        *bufsizePtr = 0;
+        return LE_OK;
+    }
+
+    if (!ringPtr->isPrimed)
+    {
+        // Play silence until the latency target is buffered, for at most the latency target
+        if ((fill < ringPtr->threshold) && !isClosed && (ringPtr->primingLen < ringPtr->threshold))
+        {
+            ringPtr->primingLen += size;
+            memset(bufferPtr, 0, size);
+            return LE_OK;
         }
+
+        ringPtr->isPrimed = true;
+        ringPtr->primingLen = 0;
+    }
+
+    *bufsizePtr = ReadSampleRing(ringPtr, bufferPtr, (fill < size) ? fill : size);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get Playback frames straight from the mapping of a WAV file. This function never blocks nor
+ * issues any system call: the file has been read ahead when it was mapped.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetMappedPlaybackFrames
+(
+    uint8_t* bufferPtr,
+    uint32_t* bufsizePtr,
+    void* contextPtr
+)
+{
+    le_audio_Stream_t* streamPtr = contextPtr;
+    le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
+    le_audio_FileMap_t* fileMapPtr = &streamPtr->fileMap;
+    size_t remaining = fileMapPtr->len - fileMapPtr->pos;
+    uint32_t size = *bufsizePtr;
+
+    // playback is paused: return without reading samples
+    if (pcmContextPtr->pause)
+    {
+        memset(bufferPtr, 0, size);
+        return LE_OK;
+    }
+
+    if (0 == remaining)
+    {
+        // All the samples are played
+        memset(bufferPtr, 0, size);
+        *bufsizePtr = 0;
+        return LE_OK;
+    }
+
+    if (size > remaining)
+    {
+        size = remaining;
     }
 
+    memcpy(bufferPtr, fileMapPtr->addr + fileMapPtr->pos, size);
+    fileMapPtr->pos += size;
+    *bufsizePtr = size;
+
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set capture frames
+ * Set capture frames in the samples ring. This function never blocks: when the ring is full
+ * (overrun), the frames which don't fit are dropped.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -1532,13 +2223,19 @@ static le_result_t SetCaptureFrames
 {
     le_audio_Stream_t*     streamPtr = contextPtr;
     le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
+    le_audio_SampleRing_t* ringPtr = &pcmContextPtr->ring;
+
+    if (__atomic_load_n(&ringPtr->isClosed, __ATOMIC_ACQUIRE))
+    {
+        return ringPtr->result;
+    }
 
     if ( !pcmContextPtr->pause )
     {
-        if (WriteFd(pcmContextPtr->fd, bufferPtr, *bufsizePtr) < 0)
+        if (WriteSampleRing(ringPtr, bufferPtr, *bufsizePtr) < *bufsizePtr)
         {
-            LE_ERROR("Cannot write on pipe");
-            return LE_FAULT;
+            LE_DEBUG("Capture overrun");
+            __atomic_fetch_add(&streamPtr->overrunCount, 1, __ATOMIC_RELAXED);
         }
     }
 
@@ -1741,6 +2438,13 @@ le_result_t le_media_Open
             // Check wav format
             res = PlayWavFile(streamPtr, samplePcmConfigPtr, mediaCtxPtr, &format);
 
+            if ((res == LE_OK) && (MapWavFile(streamPtr) == LE_OK))
+            {
+                // The samples are played from the mapping: no media thread is needed
+                le_mem_Release(mediaCtxPtr);
+                return LE_OK;
+            }
+
             if (res != LE_OK)
             {
                 // Check amr format
@@ -1922,12 +2626,25 @@ le_result_t le_media_PlaySamples
     }
 
     pcmContextPtr->pcmHandle = pcmHandle;
-    pcmContextPtr->framesFuncTimeout = 0;
 
-    pa_pcm_SetCallbackHandlers( pcmHandle,
-                                GetPlaybackFrames,
-                                PlayCaptResult,
-                                streamPtr );
+    if (streamPtr->fileMap.addr)
+    {
+        pcmContextPtr->isMapped = true;
+
+        pa_pcm_SetCallbackHandlers( pcmHandle,
+                                    GetMappedPlaybackFrames,
+                                    PlayCaptResult,
+                                    streamPtr );
+    }
+    else
+    {
+        StartSampleRing(streamPtr, pcmContextPtr);
+
+        pa_pcm_SetCallbackHandlers( pcmHandle,
+                                    GetPlaybackFrames,
+                                    PlayCaptResult,
+                                    streamPtr );
+    }
 
     if (pa_pcm_Play(pcmHandle) != LE_OK)
     {
@@ -2116,6 +2833,7 @@ le_result_t le_media_Stop
             {
                 LE_DEBUG("Close pa_pcm");
                 pa_pcm_Close(streamPtr->pcmContextPtr->pcmHandle);
+                StopSampleRing(streamPtr->pcmContextPtr);
                 le_mem_Release(streamPtr->pcmContextPtr);
                 streamPtr->pcmContextPtr = NULL;
             }
@@ -2128,6 +2846,8 @@ le_result_t le_media_Stop
                 streamPtr->mediaThreadRef = NULL;
             }
 
+            UnmapWavFile(streamPtr);
+
             // Release the wakeup source for media streams
             le_pm_Relax(MediaWakeLock);
 
@@ -2208,6 +2928,8 @@ le_result_t le_media_Capture
 
     pcmContextPtr->pcmHandle = pcmHandle;
 
+    StartSampleRing(streamPtr, pcmContextPtr);
+
     pa_pcm_SetCallbackHandlers( pcmHandle,
                                 SetCaptureFrames,
                                 PlayCaptResult,
@@ -2271,6 +2993,14 @@ void le_media_Init
     // Allocate the DTMF parameters pool.
     DtmfParamsPool = le_mem_CreatePool("DtmfParamsPool", sizeof(DtmfParams_t));
 
+    // Compute the sine table used to generate the DTMF tones.
+    int i;
+    for (i = 0; i <= SINE_TABLE_SIZE; i++)
+    {
+        SineTable[i] = (int32_t)lround(sin(2 * PI * i / SINE_TABLE_SIZE) *
+                                       (1 << SINE_TABLE_SHIFT));
+    }
+
     // Allocate the WAV parameters pool.
     WavParamsPool = le_mem_CreatePool("WavParamsPool", sizeof(WavParams_t));
 
@@ -2278,6 +3008,9 @@ void le_media_Init
     PcmThreadContextPool = le_mem_CreatePool("PcmThreadContextPool",
                                                                sizeof(le_audio_PcmContext_t));
 
+    // Allocate the samples ring pool.
+    SampleRingPool = le_mem_CreatePool("SampleRingPool", SAMPLE_RING_SIZE);
+
     // Create a Wakeup source for Media
     MediaWakeLock = le_pm_NewWakeupSource( LE_PM_REF_COUNT, "MediaStream" );
 }
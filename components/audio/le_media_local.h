@@ -6,6 +6,13 @@
 #ifndef LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
 #define LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default latency target of the samples buffer of a playback/capture, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MEDIA_DEFAULT_SAMPLE_LATENCY     40
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to play a DTMF on a specific audio stream.
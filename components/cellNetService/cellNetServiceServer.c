@@ -65,6 +65,48 @@ static le_ref_MapRef_t RequestRefMap;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t CellNetStateEvent;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing settings of a client session for its state handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;     ///< Client session.
+    uint32_t            quietPeriodMs;  ///< Quiet period before delivering a state, 0 if none.
+    uint32_t            coalescedCount; ///< Number of states dropped because a newer one came
+                                        ///  within the quiet period.
+    le_dls_List_t       handlerList;    ///< State handlers of the session.
+}
+StateClient_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A client's state handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_event_HandlerRef_t           handlerRef;     ///< Handler of the state event.
+    le_cellnet_StateHandlerFunc_t   handlerFunc;    ///< Client handler.
+    void*                           contextPtr;     ///< Client context.
+    StateClient_t*                  clientPtr;      ///< Client the handler belongs to.
+    le_timer_Ref_t                  timerRef;       ///< Quiet period timer, created when needed.
+    le_cellnet_State_t              pendingState;   ///< State to deliver when the timer expires.
+    le_dls_Link_t                   link;           ///< Link in the client's handler list.
+}
+StateHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools and maps of the clients and their state handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StateClientPool;
+static le_mem_PoolRef_t StateHandlerPool;
+static le_hashmap_Ref_t StateClientMap;
+static le_ref_MapRef_t  StateHandlerRefMap;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Current cellular network state
@@ -552,10 +594,72 @@ static void MrcNetRegHandler
     ReportCellNetStateEvent(cellNetState);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the coalescing settings of a client session, creating them the first time.
+ */
+//--------------------------------------------------------------------------------------------------
+static StateClient_t* GetStateClient
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    StateClient_t* clientPtr = le_hashmap_Get(StateClientMap, sessionRef);
+
+    if (NULL == clientPtr)
+    {
+        clientPtr = le_mem_ForceAlloc(StateClientPool);
+        clientPtr->sessionRef = sessionRef;
+        clientPtr->quietPeriodMs = 0;
+        clientPtr->coalescedCount = 0;
+        clientPtr->handlerList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(StateClientMap, sessionRef, clientPtr);
+    }
+
+    return clientPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client session close handler: forget the session's coalescing settings.  Its handlers, removed
+ * separately, keep a reference to them until then.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    StateClient_t* clientPtr = le_hashmap_Remove(StateClientMap, sessionRef);
+
+    if (NULL != clientPtr)
+    {
+        le_mem_Release(clientPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quiet period timer handler: deliver the latest state to the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StateQuietTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    StateHandler_t* handlerPtr = le_timer_GetContextPtr(timerRef);
+
+    handlerPtr->handlerFunc(handlerPtr->pendingState, handlerPtr->contextPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer Connection State Handler
  *
+ * Without a quiet period, the state is delivered at once.  Otherwise it is held until no other
+ * state has come for the quiet period, a newer state replacing the one held.
  */
 //--------------------------------------------------------------------------------------------------
 static void FirstLayerCellNetStateHandler
@@ -565,10 +669,32 @@ static void FirstLayerCellNetStateHandler
 )
 {
     le_cellnet_State_t* eventDataPtr = reportPtr;
-    le_cellnet_StateHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+    StateHandler_t* handlerPtr = le_event_GetContextPtr();
+    StateClient_t* clientPtr = handlerPtr->clientPtr;
+
+    if (0 == clientPtr->quietPeriodMs)
+    {
+        handlerPtr->handlerFunc(*eventDataPtr, handlerPtr->contextPtr);
+        return;
+    }
+
+    if (NULL == handlerPtr->timerRef)
+    {
+        handlerPtr->timerRef = le_timer_Create("CellNetStateQuiet");
+        le_timer_SetHandler(handlerPtr->timerRef, StateQuietTimerHandler);
+        le_timer_SetContextPtr(handlerPtr->timerRef, handlerPtr);
+    }
+    else if (le_timer_IsRunning(handlerPtr->timerRef))
+    {
+        LE_DEBUG("State %d (%s) replaces pending state %d (%s)",
+                 *eventDataPtr, cellNetStateStr[*eventDataPtr],
+                 handlerPtr->pendingState, cellNetStateStr[handlerPtr->pendingState]);
+        clientPtr->coalescedCount++;
+    }
 
-    clientHandlerFunc(*eventDataPtr,
-                      le_event_GetContextPtr());
+    handlerPtr->pendingState = *eventDataPtr;
+    le_timer_SetMsInterval(handlerPtr->timerRef, clientPtr->quietPeriodMs);
+    le_timer_Restart(handlerPtr->timerRef);
 }
 
 
@@ -586,15 +712,25 @@ le_cellnet_StateEventHandlerRef_t le_cellnet_AddStateEventHandler
     LE_PRINT_VALUE("%p", handlerPtr);
     LE_PRINT_VALUE("%p", contextPtr);
 
-    le_event_HandlerRef_t handlerRef = le_event_AddLayeredHandler(
-                                                    "CellNetState",
-                                                    CellNetStateEvent,
-                                                    FirstLayerCellNetStateHandler,
-                                                    handlerPtr);
+    StateHandler_t* stateHandlerPtr = le_mem_ForceAlloc(StateHandlerPool);
+    stateHandlerPtr->handlerFunc = handlerPtr;
+    stateHandlerPtr->contextPtr = contextPtr;
+    stateHandlerPtr->clientPtr = GetStateClient(le_cellnet_GetClientSessionRef());
+    stateHandlerPtr->timerRef = NULL;
+    stateHandlerPtr->pendingState = LE_CELLNET_REG_UNKNOWN;
+    stateHandlerPtr->link = LE_DLS_LINK_INIT;
+
+    le_mem_AddRef(stateHandlerPtr->clientPtr);
+    le_dls_Queue(&stateHandlerPtr->clientPtr->handlerList, &stateHandlerPtr->link);
 
-    le_event_SetContextPtr(handlerRef, contextPtr);
+    stateHandlerPtr->handlerRef = le_event_AddLayeredHandler("CellNetState",
+                                                             CellNetStateEvent,
+                                                             FirstLayerCellNetStateHandler,
+                                                             handlerPtr);
 
-    return (le_cellnet_StateEventHandlerRef_t)(handlerRef);
+    le_event_SetContextPtr(stateHandlerPtr->handlerRef, stateHandlerPtr);
+
+    return le_ref_CreateRef(StateHandlerRefMap, stateHandlerPtr);
 }
 
 
@@ -610,7 +746,82 @@ void le_cellnet_RemoveStateEventHandler
 {
     LE_PRINT_VALUE("%p", addHandlerRef);
 
-    le_event_RemoveHandler((le_event_HandlerRef_t)addHandlerRef);
+    StateHandler_t* handlerPtr = le_ref_Lookup(StateHandlerRefMap, addHandlerRef);
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", addHandlerRef);
+        return;
+    }
+
+    le_ref_DeleteRef(StateHandlerRefMap, addHandlerRef);
+    le_event_RemoveHandler(handlerPtr->handlerRef);
+
+    if (NULL != handlerPtr->timerRef)
+    {
+        le_timer_Delete(handlerPtr->timerRef);
+    }
+
+    le_dls_Remove(&handlerPtr->clientPtr->handlerList, &handlerPtr->link);
+    le_mem_Release(handlerPtr->clientPtr);
+    le_mem_Release(handlerPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the quiet period of the calling client's state handlers.
+ *
+ * A state is only delivered once no other state has come for the quiet period; the states it
+ * replaces are dropped and counted.  Setting the quiet period to 0 delivers pending states at once.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cellnet_SetStateEventQuietPeriod
+(
+    uint32_t quietPeriodMs  ///< [IN] Quiet period in milliseconds, 0 to deliver states at once.
+)
+{
+    StateClient_t* clientPtr = GetStateClient(le_cellnet_GetClientSessionRef());
+
+    LE_DEBUG("State quiet period of session %p set to %"PRIu32" ms",
+             clientPtr->sessionRef, quietPeriodMs);
+
+    clientPtr->quietPeriodMs = quietPeriodMs;
+
+    if (0 != quietPeriodMs)
+    {
+        return;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&clientPtr->handlerList);
+    while (NULL != linkPtr)
+    {
+        StateHandler_t* handlerPtr = CONTAINER_OF(linkPtr, StateHandler_t, link);
+
+        linkPtr = le_dls_PeekNext(&clientPtr->handlerList, linkPtr);
+
+        if ((NULL != handlerPtr->timerRef) && le_timer_IsRunning(handlerPtr->timerRef))
+        {
+            le_timer_Stop(handlerPtr->timerRef);
+            handlerPtr->handlerFunc(handlerPtr->pendingState, handlerPtr->contextPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of states the calling client's state handlers did not get because a newer state
+ * came within the quiet period.
+ *
+ * @return The number of coalesced states.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_cellnet_GetStateEventCoalescedCount
+(
+    void
+)
+{
+    return GetStateClient(le_cellnet_GetClientSessionRef())->coalescedCount;
 }
 
 
@@ -889,6 +1100,17 @@ COMPONENT_INIT
     CommandEvent = le_event_CreateId("CellNet Command", sizeof(uint32_t));
     CellNetStateEvent = le_event_CreateId("CellNet State", sizeof(le_cellnet_State_t));
 
+    // Create the pools and maps of the state handlers and their clients' coalescing settings
+    StateClientPool = le_mem_CreatePool("CellNet State Clients", sizeof(StateClient_t));
+    StateHandlerPool = le_mem_CreatePool("CellNet State Handlers", sizeof(StateHandler_t));
+    StateClientMap = le_hashmap_Create("CellNet State Clients", 5,
+                                       le_hashmap_HashVoidPointer,
+                                       le_hashmap_EqualsVoidPointer);
+    StateHandlerRefMap = le_ref_CreateMap("CellNet State Handlers", 5);
+
+    // Forget the coalescing settings of closed client sessions
+    le_msg_AddServiceCloseHandler(le_cellnet_GetServiceRef(), CloseSessionEventHandler, NULL);
+
     // Create safe reference map for request references. The size of the map should be based on
     // the expected number of simultaneous cellular network requests, so take a reasonable guess.
     RequestRefMap = le_ref_CreateMap("CellNet Requests", 5);
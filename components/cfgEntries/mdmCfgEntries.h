@@ -62,4 +62,24 @@
 #define CFG_NODE_ICCID                      "iccid"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths to MRC data in the config tree
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_MRC                        "mrc"
+#define CFG_MODEMSERVICE_MRC_PATH           MODEMSERVICE_CONFIG_TREE_ROOT_DIR"/"CFG_NODE_MRC
+#define CFG_NODE_SCAN_CACHE_TIMEOUT         "scanCacheTimeout"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths to the daemon-side sampling settings in the config tree.  Each kind of sampled value (e.g.
+ * "temp", "ips", "adc") has its own node under CFG_MODEMSERVICE_SAMPLING_PATH.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_SAMPLING                   "sampling"
+#define CFG_MODEMSERVICE_SAMPLING_PATH      MODEMSERVICE_CONFIG_TREE_ROOT_DIR"/"CFG_NODE_SAMPLING
+#define CFG_NODE_SAMPLING_PERIOD            "period"
+
+
 #endif // LEGATO_MDMCFGENTRIES_INCLUDE_GUARD
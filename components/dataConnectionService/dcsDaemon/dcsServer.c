@@ -53,6 +53,8 @@
 #define DCS_CONFIG_TREE_ROOT_DIR    "dataConnectionService:"
 #define CFG_PATH_ROUTING            "routing"
 #define CFG_NODE_DEFAULTROUTE       "useDefaultRoute"
+#define CFG_PATH_RACE               "race"
+#define CFG_NODE_TECHCOUNT          "techCount"
 #define CFG_PATH_WIFI               "wifi"
 #define CFG_NODE_SSID               "SSID"
 #define CFG_NODE_SECPROTOCOL        "secProtocol"
@@ -184,6 +186,23 @@ typedef struct
 }
 TechRecord_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection state of a technology, used to race the technologies and to measure their connection
+ * time
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_clk_Time_t startTime;        ///< Time when the technology was last started
+    bool          isStarting;       ///< Started and not connected yet, connection time pending
+    bool          isRacing;         ///< Started by the ongoing race, not connected nor failed yet
+    bool          hasLost;          ///< Lost the race and torn down, its events are ignored
+    bool          isTimeValid;      ///< Connection time is valid
+    uint32_t      connectionTimeMs; ///< Time needed to establish the last connection, in ms
+}
+TechState_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations
 //--------------------------------------------------------------------------------------------------
@@ -194,6 +213,7 @@ TechRecord_t;
  */
 //--------------------------------------------------------------------------------------------------
 static void ConnectionStatusHandler(le_data_Technology_t technology, bool connected);
+static le_result_t RestoreDefaultGateway(void);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -384,6 +404,21 @@ static le_data_Technology_t CurrentTech = LE_DATA_MAX;
 //--------------------------------------------------------------------------------------------------
 static bool DefaultRouteStatus = true;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of technologies started concurrently when the default data connection is requested, read
+ * at start-up in config tree. The technologies are only raced if it is greater than one.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RaceTechCount = 1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection state of the technologies
+ */
+//--------------------------------------------------------------------------------------------------
+static TechState_t TechState[DCS_TECH_NUMBER];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the list of technologies to use with the default values
@@ -610,6 +645,166 @@ static le_data_Technology_t GetNextTech
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if some technologies of the race are still trying to connect
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsTechRaceRunning
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < DCS_TECH_NUMBER; i++)
+    {
+        if (TechState[i].isRacing)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tear down the connection of a technology which lost the race. The loser is not the current
+ * technology, so its connection is torn down even if the default data connection is requested.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopLostTech
+(
+    le_data_Technology_t technology     ///< [IN] Technology which lost the race
+)
+{
+    LE_INFO("Tearing down technology %d which lost the race", technology);
+
+    switch (technology)
+    {
+        case LE_DATA_CELLULAR:
+            if (LE_OK == le_mdc_StopSession(MobileProfileRef))
+            {
+                // Restore the parameters backed up when the session was started
+                if (DefaultRouteStatus)
+                {
+                    RestoreDefaultGateway();
+                }
+                pa_dcs_RestoreInitialDnsNameServers(&InterfaceDataBackup);
+            }
+            else
+            {
+                LE_DEBUG("Mobile data session not stopped");
+            }
+            break;
+
+        case LE_DATA_WIFI:
+            if (LE_OK != le_wifiClient_Disconnect())
+            {
+                LE_DEBUG("Wifi client not disconnected");
+            }
+            break;
+
+        default:
+            LE_ERROR("Unknown technology %d to stop", technology);
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the race: keep the technology given as parameter and tear down the other racing ones
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndTechRace
+(
+    le_data_Technology_t keptTech       ///< [IN] Technology to keep, LE_DATA_MAX for none
+)
+{
+    int i;
+
+    for (i = 0; i < DCS_TECH_NUMBER; i++)
+    {
+        if (TechState[i].isRacing)
+        {
+            TechState[i].isRacing = false;
+
+            if ((le_data_Technology_t)i != keptTech)
+            {
+                TechState[i].hasLost = true;
+                StopLostTech((le_data_Technology_t)i);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a connection event is sent by a technology which lost the race. Such an event is not
+ * reported: a late connection is torn down again and a disconnection ends the teardown.
+ *
+ * @return
+ *      - true if the event has to be ignored
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLostTechEvent
+(
+    le_data_Technology_t technology,    ///< [IN] Technology sending the event
+    bool connected                      ///< [IN] Connection status
+)
+{
+    if (!TechState[technology].hasLost)
+    {
+        return false;
+    }
+
+    if (connected)
+    {
+        StopLostTech(technology);
+    }
+    else
+    {
+        TechState[technology].hasLost = false;
+    }
+
+    LE_DEBUG("Ignoring event of technology %d which lost the race", technology);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the connection of a technology: measure its connection time and, if a race is running,
+ * make it the current technology and tear down the other racing ones
+ */
+//--------------------------------------------------------------------------------------------------
+static void TechConnectedHandler
+(
+    le_data_Technology_t technology     ///< [IN] Connected technology
+)
+{
+    TechState_t* statePtr = &TechState[technology];
+
+    if (statePtr->isStarting)
+    {
+        le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), statePtr->startTime);
+
+        statePtr->isStarting = false;
+        statePtr->isTimeValid = true;
+        statePtr->connectionTimeMs = (duration.sec * 1000) + (duration.usec / 1000);
+        LE_INFO("Technology %d connected in %"PRIu32" ms", technology,
+                statePtr->connectionTimeMs);
+    }
+
+    if (IsTechRaceRunning())
+    {
+        LE_INFO("Technology %d won the race", technology);
+        CurrentTech = technology;
+        EndTechRace(technology);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event callback for Wifi Client changes
@@ -628,9 +823,15 @@ static void WifiClientEventHandler
         case LE_WIFICLIENT_EVENT_CONNECTED:
             LE_INFO("Wifi client connected");
 
+            if (IsLostTechEvent(LE_DATA_WIFI, true))
+            {
+                break;
+            }
+
             // Request an IP address through DHCP if DCS initiated the connection
             // and update connection status
-            if ((LE_DATA_WIFI == CurrentTech) && (RequestCount > 0))
+            if (((LE_DATA_WIFI == CurrentTech) || (TechState[LE_DATA_WIFI].isRacing))
+                && (RequestCount > 0))
             {
                 if (LE_OK == pa_dcs_AskForIpAddress(WIFI_INTF))
                 {
@@ -646,6 +847,11 @@ static void WifiClientEventHandler
                 IsConnected = true;
             }
 
+            if (IsConnected)
+            {
+                TechConnectedHandler(LE_DATA_WIFI);
+            }
+
             // Send notification to registered applications
             SendConnStateEvent(IsConnected);
 
@@ -656,6 +862,11 @@ static void WifiClientEventHandler
         case LE_WIFICLIENT_EVENT_DISCONNECTED:
             LE_INFO("Wifi client disconnected");
 
+            if (IsLostTechEvent(LE_DATA_WIFI, false))
+            {
+                break;
+            }
+
             // Update connection status and send notification to registered applications
             IsConnected = false;
             SendConnStateEvent(IsConnected);
@@ -726,8 +937,20 @@ static void DataSessionStateHandler
     le_timer_Restart(DelayRequestTimer);
     #endif
 
+    bool connected = (connectionStatus == LE_MDC_CONNECTED) ? true : false;
+
+    if (IsLostTechEvent(LE_DATA_CELLULAR, connected))
+    {
+        return;
+    }
+
+    if (connected)
+    {
+        TechConnectedHandler(LE_DATA_CELLULAR);
+    }
+
     // Update connection status and send notification to registered applications
-    IsConnected = (connectionStatus == LE_MDC_CONNECTED) ? true : false;
+    IsConnected = connected;
     SendConnStateEvent(IsConnected);
 
     // Handle new connection status for this technology
@@ -834,6 +1057,44 @@ static bool GetDefaultRouteStatus
     return defaultRouteStatus;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the number of technologies to start concurrently from config tree
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetRaceTechCount
+(
+    void
+)
+{
+    int32_t techCount = 1;
+
+    char configPath[LE_CFG_STR_LEN_BYTES];
+    snprintf(configPath, sizeof(configPath), "%s/%s", DCS_CONFIG_TREE_ROOT_DIR, CFG_PATH_RACE);
+
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateReadTxn(configPath);
+
+    // Get the number of technologies to race
+    if (le_cfg_NodeExists(cfg, CFG_NODE_TECHCOUNT))
+    {
+        techCount = le_cfg_GetInt(cfg, CFG_NODE_TECHCOUNT, 1);
+        LE_DEBUG("Number of technologies to race = %d", techCount);
+    }
+    le_cfg_CancelTxn(cfg);
+
+    if (techCount < 1)
+    {
+        LE_WARN("Invalid number of technologies to race %d, race disabled", techCount);
+        techCount = 1;
+    }
+    else if (techCount > DCS_TECH_NUMBER)
+    {
+        techCount = DCS_TECH_NUMBER;
+    }
+
+    return (uint32_t)techCount;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Get the time protocol to use from config tree
@@ -1335,13 +1596,16 @@ static le_result_t SetDefaultRouteAndDns
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set DNS Configuration Service Timer Handler.
- * When the timer expires, this handler attempts to set DNS configuration.
+ * Retry to set the DNS configuration of the connected cellular data session.
+ *
+ * @return
+ *      LE_FAULT        Function failed
+ *      LE_OK           Function succeed
  */
 //--------------------------------------------------------------------------------------------------
-static void SetDNSConfigTimerHandler
+static le_result_t RetryDnsConfiguration
 (
-    le_timer_Ref_t timerRef    ///< [IN] Timer used to ensure DNS address is present.
+    void
 )
 {
     le_mdc_ConState_t  sessionState;
@@ -1350,7 +1614,7 @@ static void SetDNSConfigTimerHandler
     if(0 == RequestCount)
     {
         // Release has been requested in the meantime, We must cancel the Request command process.
-        return;
+        return LE_OK;
     }
 
     result = le_mdc_GetSessionState(MobileProfileRef, &sessionState);
@@ -1359,11 +1623,58 @@ static void SetDNSConfigTimerHandler
         if (LE_OK != SetDnsConfiguration(MobileProfileRef, !DefaultRouteStatus))
         {
             LE_ERROR("Failed to set DNS configuration.");
+            return LE_FAULT;
         }
-        else
-        {
-            LE_INFO("DNS configuration is set successfully");
-        }
+
+        LE_INFO("DNS configuration is set successfully");
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set DNS Configuration Service Timer Handler.
+ * When the timer expires, this handler attempts to set DNS configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetDNSConfigTimerHandler
+(
+    le_timer_Ref_t timerRef    ///< [IN] Timer used to ensure DNS address is present.
+)
+{
+    RetryDnsConfiguration();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network change handler.
+ * When an address or a route is added on the cellular interface while the DNS configuration is
+ * pending, this handler attempts to set it without waiting for the SetDNSConfig timer, which is
+ * kept as a fallback if it fails again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NetworkChangeHandler
+(
+    const char* interfacePtr,   ///< [IN] Network interface name
+    void*       contextPtr      ///< [IN] Handler context
+)
+{
+    char interface[LE_MDC_INTERFACE_NAME_MAX_BYTES] = {0};
+
+    if (   (!le_timer_IsRunning(SetDNSConfigTimer))
+        || (!MobileProfileRef)
+        || (LE_OK != le_mdc_GetInterfaceName(MobileProfileRef, interface, sizeof(interface)))
+        || (0 != strcmp(interface, interfacePtr)))
+    {
+        return;
+    }
+
+    LE_DEBUG("Network change on %s, retry the DNS configuration", interfacePtr);
+
+    if (LE_OK == RetryDnsConfiguration())
+    {
+        le_timer_Stop(SetDNSConfigTimer);
     }
 }
 
@@ -1542,6 +1853,12 @@ static void TryStartTechSession
         // Store the currently used technology
         CurrentTech = technology;
 
+        // Start measuring the connection time, the events of this technology are not ignored
+        // anymore if it lost a previous race
+        TechState[technology].startTime = le_clk_GetRelativeTime();
+        TechState[technology].isStarting = true;
+        TechState[technology].hasLost = false;
+
         switch (technology)
         {
             case LE_DATA_CELLULAR:
@@ -1877,6 +2194,49 @@ static void RetryTechTimerHandler
     TryStartTechSession(GetNextTech(technology));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the default data session: either with the first technology of the list, or by racing the
+ * first technologies of the list if configured
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTechSessions
+(
+    void
+)
+{
+    le_data_Technology_t raceTechs[DCS_TECH_NUMBER];
+    uint32_t techCount = 0;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&TechList);
+
+    while ((NULL != linkPtr) && (techCount < RaceTechCount))
+    {
+        raceTechs[techCount++] = CONTAINER_OF(linkPtr, TechRecord_t, link)->tech;
+        linkPtr = le_dls_PeekNext(&TechList, linkPtr);
+    }
+
+    if (techCount < 2)
+    {
+        TryStartTechSession(le_data_GetFirstUsedTechnology());
+        return;
+    }
+
+    LE_INFO("Racing the first %"PRIu32" technologies", techCount);
+
+    uint32_t i;
+    for (i = 0; i < techCount; i++)
+    {
+        TechState[raceTechs[i]].isRacing = true;
+    }
+
+    // Start the lowest ranked technology first: the cellular start blocks until its route and DNS
+    // are set, and the last started technology is the current one until the race is won
+    for (i = techCount; i > 0; i--)
+    {
+        TryStartTechSession(raceTechs[i - 1]);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler to process a command
@@ -1905,7 +2265,7 @@ static void ProcessCommand
             if (1 == RequestCount)
             {
                 // Get the technology to use from the list and start the data session
-                TryStartTechSession(le_data_GetFirstUsedTechnology());
+                StartTechSessions();
             }
         }
         else
@@ -1926,6 +2286,9 @@ static void ProcessCommand
 
         if (0 == RequestCount)
         {
+            // Tear down the other technologies of a running race
+            EndTechRace(CurrentTech);
+
             // Try and disconnect the current technology
             TryStopTechSession(CurrentTech);
         }
@@ -1963,7 +2326,8 @@ static void PacketSwitchHandler
         case LE_MRC_REG_HOME:
         case LE_MRC_REG_ROAMING:
             LE_DEBUG("New PS state ATTACHED");
-            if ((LE_DATA_CELLULAR == CurrentTech) && (RequestCount > 0) && (!IsConnected))
+            if (((LE_DATA_CELLULAR == CurrentTech) || (TechState[LE_DATA_CELLULAR].isRacing))
+                && (RequestCount > 0) && (!IsConnected))
             {
                 // Start a connection
                 TryStartDataSession();
@@ -1988,6 +2352,19 @@ static void ConnectionStatusHandler
 )
 {
     LE_DEBUG("Technology: %d Connected: %d", technology, connected);
+
+    // A failed technology of the race is only retried when all the racing technologies failed
+    if ((false == connected) && (TechState[technology].isRacing))
+    {
+        TechState[technology].isRacing = false;
+
+        if (IsTechRaceRunning())
+        {
+            LE_INFO("Technology %d failed, waiting for the other racing technologies", technology);
+            return;
+        }
+    }
+
     // Check if the default data connection is still necessary
     if ((false == connected) && (RequestCount > 0))
     {
@@ -2578,6 +2955,38 @@ le_data_Technology_t le_data_GetTechnology
     return CurrentTech;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time needed by a technology to establish its last connection, from the start of the
+ * technology to the connection notification.
+ *
+ * @return
+ *      - LE_OK if the time is retrieved
+ *      - LE_BAD_PARAMETER if the technology is unknown
+ *      - LE_UNAVAILABLE if the technology has not been connected yet
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_data_GetConnectionTime
+(
+    le_data_Technology_t technology,    ///< [IN] Technology
+    uint32_t* timeMsPtr                 ///< [OUT] Connection time in milliseconds
+)
+{
+    if ((technology >= DCS_TECH_NUMBER) || (NULL == timeMsPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (!TechState[technology].isTimeValid)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    *timeMsPtr = TechState[technology].connectionTimeMs;
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the cellular profile index used by the data connection service when the cellular technology
@@ -2840,9 +3249,19 @@ COMPONENT_INIT
         LE_ERROR("Could not start the SetDNSConfig timer!");
     }
 
+    // Retry the DNS configuration as soon as the cellular interface changes, if the platform
+    // reports the network changes
+    if (NULL == pa_dcs_AddNetworkChangeHandler(NetworkChangeHandler, NULL))
+    {
+        LE_INFO("Network changes not reported, DNS configuration retried by timer only");
+    }
+
     // Retrieve default gateway activation status
     DefaultRouteStatus = GetDefaultRouteStatus();
 
+    // Retrieve the number of technologies to race
+    RaceTechCount = GetRaceTechCount();
+
     // Set a timer to retry the tech
     RetryTechTimer = le_timer_Create("RetryTechTimer");
     RetryTechBackoffCurrent = RETRY_TECH_BACKOFF_INIT;
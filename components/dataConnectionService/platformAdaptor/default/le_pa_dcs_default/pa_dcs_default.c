@@ -180,6 +180,25 @@ le_result_t pa_dcs_GetTimeWithNetworkTimeProtocol
     return LE_UNSUPPORTED;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler for the network changes, i.e. an address or a route added on an interface.
+ *
+ * @return
+ *      - A handler reference on success
+ *      - NULL if the network changes are not reported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_dcs_AddNetworkChangeHandler
+(
+    pa_dcs_NetworkChangeHandler_t handlerPtr,   ///< [IN] The network change handler function.
+    void*                         contextPtr    ///< [IN] The context to be given to the handler.
+)
+{
+    LE_ERROR("Unsupported function called");
+    return NULL;
+}
+
 COMPONENT_INIT
 {
 }
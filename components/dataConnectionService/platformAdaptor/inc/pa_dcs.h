@@ -77,6 +77,20 @@ typedef struct
 }
 pa_dcs_TimeStruct_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for network change handler function.
+ *
+ * This handler receives the name of the network interface on which an address or a route has been
+ * added.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_dcs_NetworkChangeHandler_t)
+(
+    const char* interfacePtr,   ///< [IN] Network interface name
+    void*       contextPtr      ///< [IN] Context given when the handler was added
+);
+
 /*********************************************************
  *
  *     APIs
@@ -204,4 +218,19 @@ LE_SHARED le_result_t pa_dcs_GetTimeWithNetworkTimeProtocol
     pa_dcs_TimeStruct_t* timePtr    ///< [OUT] Time structure
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler for the network changes, i.e. an address or a route added on an interface.
+ *
+ * @return
+ *      - A handler reference on success
+ *      - NULL if the network changes are not reported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_event_HandlerRef_t pa_dcs_AddNetworkChangeHandler
+(
+    pa_dcs_NetworkChangeHandler_t handlerPtr,   ///< [IN] The network change handler function.
+    void*                         contextPtr    ///< [IN] The context to be given to the handler.
+);
+
 #endif
@@ -0,0 +1,1039 @@
+/**
+ * @file pa_dcs_netlink.c
+ *
+ * Linux implementation of the Data Connection Service platform adaptor, based on rtnetlink.
+ *
+ * The routes are changed with rtnetlink requests instead of route commands. The default route is
+ * replaced in a single request, so the system is never left without a default route. The DNS
+ * name servers are written in a new resolv file renamed over the previous one, so the resolvers
+ * never read a partially written file, and the file is not rewritten when it is already up to date.
+ *
+ * The addresses and routes added on an interface are reported to the handlers registered with
+ * pa_dcs_AddNetworkChangeHandler(), so that the configuration can be applied as soon as the
+ * bearer is up instead of being retried periodically.
+ *
+ * The IP address request and the time protocols are not supported by this platform adaptor.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+
+#include "legato.h"
+#include "pa_dcs.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the resolv file holding the DNS name servers
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOLV_CONF_PATH            "/etc/resolv.conf"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the resolv file
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOLV_CONF_MAX_BYTES       4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name server entry keyword in the resolv file
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOLV_CONF_NAME_SERVER     "nameserver"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer receiving the netlink messages
+ */
+//--------------------------------------------------------------------------------------------------
+#define NETLINK_BUFFER_BYTES        8192
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the attributes of a route request: destination, gateway and interface
+ */
+//--------------------------------------------------------------------------------------------------
+#define ROUTE_ATTR_MAX_BYTES        (2 * RTA_SPACE(sizeof(struct in6_addr)) + \
+                                     RTA_SPACE(sizeof(int)))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Netlink multicast groups reporting the network changes
+ */
+//--------------------------------------------------------------------------------------------------
+#define NETWORK_CHANGE_GROUPS       (RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | \
+                                     RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE)
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Route request sent to the kernel
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    struct nlmsghdr hdr;                            ///< Netlink message header
+    struct rtmsg    rt;                             ///< Route message
+    char            attr[ROUTE_ATTR_MAX_BYTES];     ///< Route attributes
+}
+RouteRequest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of the function handling the messages received in response to a request
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*ResponseHandler_t)
+(
+    struct nlmsghdr* hdrPtr,    ///< [IN] Received message
+    void*            contextPtr ///< [IN] Context given with the request
+);
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the last netlink request
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RequestSequence = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Netlink socket receiving the network changes, opened when the first handler is added
+ */
+//--------------------------------------------------------------------------------------------------
+static int NetworkChangeFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID on which the network changes are reported, with the interface name as payload
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t NetworkChangeEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a netlink route socket.
+ *
+ * @return
+ *      - The socket file descriptor on success
+ *      - -1 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenNetlinkSocket
+(
+    uint32_t groups     ///< [IN] Multicast groups to join, 0 to send requests only
+)
+{
+    struct sockaddr_nl addr;
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open a netlink socket: %m");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = groups;
+
+    if (-1 == bind(fd, (struct sockaddr*)&addr, sizeof(addr)))
+    {
+        LE_ERROR("Unable to bind the netlink socket: %m");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find an attribute of a route message.
+ *
+ * @return The attribute, or NULL if it is not in the message
+ */
+//--------------------------------------------------------------------------------------------------
+static struct rtattr* GetRouteAttribute
+(
+    struct nlmsghdr* hdrPtr,    ///< [IN] Route message
+    unsigned short   type       ///< [IN] Attribute type
+)
+{
+    struct rtmsg* rtPtr = NLMSG_DATA(hdrPtr);
+    struct rtattr* attrPtr;
+    int attrLen = RTM_PAYLOAD(hdrPtr);
+
+    for (attrPtr = RTM_RTA(rtPtr); RTA_OK(attrPtr, attrLen); attrPtr = RTA_NEXT(attrPtr, attrLen))
+    {
+        if (type == attrPtr->rta_type)
+        {
+            return attrPtr;
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an attribute to a route request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddRouteAttribute
+(
+    RouteRequest_t* requestPtr, ///< [IN] Route request
+    unsigned short  type,       ///< [IN] Attribute type
+    const void*     dataPtr,    ///< [IN] Attribute data
+    size_t          dataLen     ///< [IN] Attribute data length
+)
+{
+    struct rtattr* attrPtr;
+
+    LE_ASSERT((NLMSG_ALIGN(requestPtr->hdr.nlmsg_len) + RTA_SPACE(dataLen))
+              <= sizeof(RouteRequest_t));
+
+    attrPtr = (struct rtattr*)(((char*)requestPtr) + NLMSG_ALIGN(requestPtr->hdr.nlmsg_len));
+    attrPtr->rta_type = type;
+    attrPtr->rta_len = RTA_LENGTH(dataLen);
+    memcpy(RTA_DATA(attrPtr), dataPtr, dataLen);
+
+    requestPtr->hdr.nlmsg_len = NLMSG_ALIGN(requestPtr->hdr.nlmsg_len) + RTA_SPACE(dataLen);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the response to a netlink request, until its acknowledgement or the end of the dump.
+ *
+ * @return
+ *      LE_OK           The request succeeded
+ *      LE_FAULT        The request failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadResponse
+(
+    int               fd,           ///< [IN] Netlink socket
+    uint32_t          sequence,     ///< [IN] Sequence number of the request
+    ResponseHandler_t handlerPtr,   ///< [IN] Handler of the response messages, can be NULL
+    void*             contextPtr    ///< [IN] Context given to the handler
+)
+{
+    uint32_t buffer[NETLINK_BUFFER_BYTES / sizeof(uint32_t)];
+
+    for (;;)
+    {
+        struct nlmsghdr* hdrPtr = (struct nlmsghdr*)buffer;
+        ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+
+        if (-1 == len)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Unable to read the netlink response: %m");
+            return LE_FAULT;
+        }
+
+        for (; NLMSG_OK(hdrPtr, len); hdrPtr = NLMSG_NEXT(hdrPtr, len))
+        {
+            if (sequence != hdrPtr->nlmsg_seq)
+            {
+                continue;
+            }
+
+            if (NLMSG_DONE == hdrPtr->nlmsg_type)
+            {
+                return LE_OK;
+            }
+
+            if (NLMSG_ERROR == hdrPtr->nlmsg_type)
+            {
+                struct nlmsgerr* errPtr = NLMSG_DATA(hdrPtr);
+
+                if (0 == errPtr->error)
+                {
+                    return LE_OK;
+                }
+                LE_ERROR("Netlink request failed: %s", strerror(-errPtr->error));
+                return LE_FAULT;
+            }
+
+            if (NULL != handlerPtr)
+            {
+                handlerPtr(hdrPtr, contextPtr);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a netlink request to the kernel and wait for its response.
+ *
+ * @return
+ *      LE_OK           The request succeeded
+ *      LE_FAULT        The request failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendRequest
+(
+    struct nlmsghdr*  hdrPtr,       ///< [IN] Request
+    ResponseHandler_t handlerPtr,   ///< [IN] Handler of the response messages, can be NULL
+    void*             contextPtr    ///< [IN] Context given to the handler
+)
+{
+    struct sockaddr_nl kernelAddr;
+    le_result_t result;
+    int fd = OpenNetlinkSocket(0);
+
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    memset(&kernelAddr, 0, sizeof(kernelAddr));
+    kernelAddr.nl_family = AF_NETLINK;
+
+    hdrPtr->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+    hdrPtr->nlmsg_seq = ++RequestSequence;
+
+    if (-1 == sendto(fd, hdrPtr, hdrPtr->nlmsg_len, 0,
+                     (struct sockaddr*)&kernelAddr, sizeof(kernelAddr)))
+    {
+        LE_ERROR("Unable to send the netlink request: %m");
+        result = LE_FAULT;
+    }
+    else
+    {
+        result = ReadResponse(fd, hdrPtr->nlmsg_seq, handlerPtr, contextPtr);
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add, replace or delete a route in the main routing table.
+ *
+ * @return
+ *      LE_OK           Function succeed
+ *      LE_FAULT        Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RequestRoute
+(
+    uint16_t    type,           ///< [IN] RTM_NEWROUTE or RTM_DELROUTE
+    uint16_t    flags,          ///< [IN] Netlink request flags
+    const char* destPtr,        ///< [IN] Destination host address, NULL for the default route
+    const char* gatewayPtr,     ///< [IN] Gateway address, NULL or empty for a direct route
+    const char* interfacePtr,   ///< [IN] Interface name
+    bool        isIpv6          ///< [IN] IPv6 or not
+)
+{
+    RouteRequest_t request;
+    struct in6_addr addr;       // Large enough for both IPv4 and IPv6 addresses
+    int family = (isIpv6 ? AF_INET6 : AF_INET);
+    size_t addrLen = (isIpv6 ? sizeof(struct in6_addr) : sizeof(struct in_addr));
+    int ifIndex = (int)if_nametoindex(interfacePtr);
+
+    if (0 == ifIndex)
+    {
+        LE_ERROR("Unknown interface '%s'", interfacePtr);
+        return LE_FAULT;
+    }
+
+    memset(&request, 0, sizeof(request));
+    request.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    request.hdr.nlmsg_type = type;
+    request.hdr.nlmsg_flags = flags;
+    request.rt.rtm_family = family;
+    request.rt.rtm_table = RT_TABLE_MAIN;
+    request.rt.rtm_protocol = RTPROT_BOOT;
+    request.rt.rtm_type = RTN_UNICAST;
+    request.rt.rtm_scope = ((RTM_DELROUTE == type) ? RT_SCOPE_NOWHERE : RT_SCOPE_LINK);
+
+    if (NULL != destPtr)
+    {
+        if (1 != inet_pton(family, destPtr, &addr))
+        {
+            LE_ERROR("Bad destination address '%s'", destPtr);
+            return LE_FAULT;
+        }
+        AddRouteAttribute(&request, RTA_DST, &addr, addrLen);
+        request.rt.rtm_dst_len = addrLen * 8;
+    }
+
+    if ((NULL != gatewayPtr) && ('\0' != gatewayPtr[0]))
+    {
+        if (1 != inet_pton(family, gatewayPtr, &addr))
+        {
+            LE_ERROR("Bad gateway address '%s'", gatewayPtr);
+            return LE_FAULT;
+        }
+        AddRouteAttribute(&request, RTA_GATEWAY, &addr, addrLen);
+
+        if (RTM_DELROUTE != type)
+        {
+            request.rt.rtm_scope = RT_SCOPE_UNIVERSE;
+        }
+    }
+
+    AddRouteAttribute(&request, RTA_OIF, &ifIndex, sizeof(ifIndex));
+
+    return SendRequest(&request.hdr, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the IPv4 default route found in a route dump response.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DefaultGatewayHandler
+(
+    struct nlmsghdr* hdrPtr,    ///< [IN] Received message
+    void*            contextPtr ///< [IN] Interface data backup
+)
+{
+    pa_dcs_InterfaceDataBackup_t* interfaceDataBackupPtr = contextPtr;
+    struct rtmsg* rtPtr = NLMSG_DATA(hdrPtr);
+    struct rtattr* gatewayPtr;
+    struct rtattr* interfacePtr;
+    char interface[IF_NAMESIZE];
+
+    // Only the first default route of the main table is saved
+    if (   (RTM_NEWROUTE != hdrPtr->nlmsg_type)
+        || (RT_TABLE_MAIN != rtPtr->rtm_table)
+        || (0 != rtPtr->rtm_dst_len)
+        || ('\0' != interfaceDataBackupPtr->defaultInterface[0]))
+    {
+        return;
+    }
+
+    gatewayPtr = GetRouteAttribute(hdrPtr, RTA_GATEWAY);
+    interfacePtr = GetRouteAttribute(hdrPtr, RTA_OIF);
+    if (   (NULL == gatewayPtr)
+        || (NULL == interfacePtr)
+        || (NULL == if_indextoname(*(int*)RTA_DATA(interfacePtr), interface)))
+    {
+        return;
+    }
+
+    if (NULL == inet_ntop(AF_INET, RTA_DATA(gatewayPtr),
+                          interfaceDataBackupPtr->defaultGateway,
+                          sizeof(interfaceDataBackupPtr->defaultGateway)))
+    {
+        LE_WARN("Unable to convert the default gateway address: %m");
+        return;
+    }
+
+    le_utf8_Copy(interfaceDataBackupPtr->defaultInterface, interface,
+                 sizeof(interfaceDataBackupPtr->defaultInterface), NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a line of the resolv file is the entry of a name server.
+ *
+ * @return True if the line is the entry of the name server
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNameServerLine
+(
+    const char* linePtr,    ///< [IN] Line of the resolv file, without its end of line
+    size_t      lineLen,    ///< [IN] Line length
+    const char* addrPtr     ///< [IN] Name server address
+)
+{
+    size_t addrLen = strlen(addrPtr);
+    size_t i = sizeof(RESOLV_CONF_NAME_SERVER) - 1;
+
+    if (   (0 == addrLen)
+        || (lineLen <= i)
+        || (0 != strncmp(linePtr, RESOLV_CONF_NAME_SERVER, i))
+        || (!isspace((unsigned char)linePtr[i])))
+    {
+        return false;
+    }
+
+    while ((i < lineLen) && isspace((unsigned char)linePtr[i]))
+    {
+        i++;
+    }
+
+    if (((lineLen - i) < addrLen) || (0 != strncmp(&linePtr[i], addrPtr, addrLen)))
+    {
+        return false;
+    }
+    i += addrLen;
+
+    return ((i == lineLen) || isspace((unsigned char)linePtr[i]));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the resolv file contents have the entry of a name server.
+ *
+ * @return True if the name server is in the resolv file
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasNameServer
+(
+    const char* bufferPtr,  ///< [IN] Resolv file contents
+    const char* addrPtr     ///< [IN] Name server address
+)
+{
+    while ('\0' != *bufferPtr)
+    {
+        const char* endPtr = strchr(bufferPtr, '\n');
+        size_t lineLen = (endPtr ? (size_t)(endPtr - bufferPtr) : strlen(bufferPtr));
+
+        if (IsNameServerLine(bufferPtr, lineLen, addrPtr))
+        {
+            return true;
+        }
+
+        bufferPtr += lineLen + (endPtr ? 1 : 0);
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the resolv file contents. A missing file is read as an empty one.
+ *
+ * @return
+ *      - The length of the contents, which are null-terminated
+ *      - -1 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadResolvConf
+(
+    char*  bufferPtr,   ///< [OUT] Resolv file contents
+    size_t bufferSize   ///< [IN] Buffer size
+)
+{
+    size_t len = 0;
+    int fd = open(RESOLV_CONF_PATH, O_RDONLY | O_CLOEXEC);
+
+    if (-1 == fd)
+    {
+        if (ENOENT == errno)
+        {
+            bufferPtr[0] = '\0';
+            return 0;
+        }
+        LE_ERROR("Unable to open '%s': %m", RESOLV_CONF_PATH);
+        return -1;
+    }
+
+    for (;;)
+    {
+        ssize_t readLen = read(fd, &bufferPtr[len], bufferSize - 1 - len);
+
+        if (0 == readLen)
+        {
+            break;
+        }
+        if (-1 == readLen)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Unable to read '%s': %m", RESOLV_CONF_PATH);
+            close(fd);
+            return -1;
+        }
+
+        len += readLen;
+        if ((bufferSize - 1) == len)
+        {
+            LE_ERROR("'%s' is too large", RESOLV_CONF_PATH);
+            close(fd);
+            return -1;
+        }
+    }
+
+    close(fd);
+    bufferPtr[len] = '\0';
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace the resolv file contents. The new contents are written in a temporary file renamed over
+ * the resolv file, so the resolvers read either the previous or the new contents.
+ *
+ * @return
+ *      LE_OK           Function succeed
+ *      LE_FAULT        Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteResolvConf
+(
+    const char* bufferPtr,  ///< [IN] New resolv file contents
+    size_t      len         ///< [IN] Contents length
+)
+{
+    char path[PATH_MAX];
+    char tmpPath[PATH_MAX];
+    int fd;
+
+    // Replace the target of the resolv file when it is a symbolic link, not the link itself
+    if (NULL == realpath(RESOLV_CONF_PATH, path))
+    {
+        LE_ASSERT_OK(le_utf8_Copy(path, RESOLV_CONF_PATH, sizeof(path), NULL));
+    }
+
+    if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int)sizeof(tmpPath))
+    {
+        LE_ERROR("Path of '%s' is too long", path);
+        return LE_FAULT;
+    }
+
+    fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP |
+                                                                 S_IROTH);
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open '%s': %m", tmpPath);
+        return LE_FAULT;
+    }
+
+    while (len > 0)
+    {
+        ssize_t writeLen = write(fd, bufferPtr, len);
+
+        if (-1 == writeLen)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Unable to write '%s': %m", tmpPath);
+            close(fd);
+            unlink(tmpPath);
+            return LE_FAULT;
+        }
+
+        bufferPtr += writeLen;
+        len -= writeLen;
+    }
+
+    if ((0 != close(fd)) || (0 != rename(tmpPath, path)))
+    {
+        LE_ERROR("Unable to replace '%s': %m", path);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the network changes reported on the netlink socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NetworkChangeMonitorHandler
+(
+    int   fd,       ///< [IN] Netlink socket
+    short events    ///< [IN] Event bit mask
+)
+{
+    uint32_t buffer[NETLINK_BUFFER_BYTES / sizeof(uint32_t)];
+    ssize_t len;
+
+    while ((len = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+    {
+        struct nlmsghdr* hdrPtr = (struct nlmsghdr*)buffer;
+
+        for (; NLMSG_OK(hdrPtr, len); hdrPtr = NLMSG_NEXT(hdrPtr, len))
+        {
+            char interface[IF_NAMESIZE];
+            int ifIndex = 0;
+
+            if (RTM_NEWADDR == hdrPtr->nlmsg_type)
+            {
+                ifIndex = ((struct ifaddrmsg*)NLMSG_DATA(hdrPtr))->ifa_index;
+            }
+            else if (RTM_NEWROUTE == hdrPtr->nlmsg_type)
+            {
+                struct rtattr* attrPtr = GetRouteAttribute(hdrPtr, RTA_OIF);
+
+                ifIndex = (attrPtr ? *(int*)RTA_DATA(attrPtr) : 0);
+            }
+
+            if ((0 != ifIndex) && (NULL != if_indextoname(ifIndex, interface)))
+            {
+                LE_DEBUG("Network change on %s", interface);
+                le_event_Report(NetworkChangeEventId, interface, sizeof(interface));
+            }
+        }
+    }
+
+    if ((-1 == len) && (EAGAIN != errno) && (EWOULDBLOCK != errno) && (EINTR != errno))
+    {
+        // ENOBUFS means that some changes were dropped by the kernel, the next ones are reported
+        LE_WARN("Unable to read the network changes: %m");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer network change handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerNetworkChangeHandler
+(
+    void* reportPtr,
+    void* secondLayerHandlerFunc
+)
+{
+    pa_dcs_NetworkChangeHandler_t clientHandlerFunc = secondLayerHandlerFunc;
+
+    clientHandlerFunc((const char*)reportPtr, le_event_GetContextPtr());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ask For Ip Address
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_UNSUPPORTED if not supported by the target
+ *      - LE_FAULT for all other errors
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_AskForIpAddress
+(
+    const char* interfaceStrPtr
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_UNSUPPORTED;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the default gateway in the system
+ *
+ * @return
+ *      LE_OK           Function succeed
+ *      LE_FAULT        Function failed
+ *      LE_UNSUPPORTED  Function not supported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_SetDefaultGateway
+(
+    const char*  interfacePtr,   ///< [IN] Pointer on the interface name
+    const char*  gatewayPtr,     ///< [IN] Pointer on the gateway name
+    bool         isIpv6          ///< [IN] IPv6 or not
+)
+{
+    if ((NULL == interfacePtr) || ('\0' == interfacePtr[0]))
+    {
+        LE_ERROR("No interface for the default gateway");
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Default gateway '%s' on %s", gatewayPtr, interfacePtr);
+
+    // Replace the current default route, if any, in a single request
+    return RequestRoute(RTM_NEWROUTE, NLM_F_CREATE | NLM_F_REPLACE,
+                        NULL, gatewayPtr, interfacePtr, isIpv6);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the default route
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dcs_SaveDefaultGateway
+(
+    pa_dcs_InterfaceDataBackup_t*  interfaceDataBackupPtr
+)
+{
+    struct
+    {
+        struct nlmsghdr hdr;
+        struct rtmsg    rt;
+    }
+    request;
+
+    memset(interfaceDataBackupPtr->defaultInterface, '\0',
+           sizeof(interfaceDataBackupPtr->defaultInterface));
+    memset(interfaceDataBackupPtr->defaultGateway, '\0',
+           sizeof(interfaceDataBackupPtr->defaultGateway));
+
+    memset(&request, 0, sizeof(request));
+    request.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    request.hdr.nlmsg_type = RTM_GETROUTE;
+    request.hdr.nlmsg_flags = NLM_F_DUMP;
+    request.rt.rtm_family = AF_INET;
+
+    if (LE_OK != SendRequest(&request.hdr, DefaultGatewayHandler, interfaceDataBackupPtr))
+    {
+        LE_WARN("Unable to save the default gateway");
+        return;
+    }
+
+    LE_DEBUG("Default gateway '%s' on '%s' saved", interfaceDataBackupPtr->defaultGateway,
+             interfaceDataBackupPtr->defaultInterface);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Executes change route
+ *
+ * @return
+ *      LE_OK           Function succeed
+ *      LE_FAULT        Function failed
+ *      LE_UNSUPPORTED  Function not supported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_ChangeRoute
+(
+    pa_dcs_RouteAction_t   routeAction,
+    const char*            ipDestAddrStrPtr,
+    const char*            interfaceStrPtr
+)
+{
+    bool isIpv6 = (NULL != strchr(ipDestAddrStrPtr, ':'));
+
+    switch (routeAction)
+    {
+        case PA_DCS_ROUTE_ADD:
+            return RequestRoute(RTM_NEWROUTE, NLM_F_CREATE | NLM_F_REPLACE,
+                                ipDestAddrStrPtr, NULL, interfaceStrPtr, isIpv6);
+
+        case PA_DCS_ROUTE_DELETE:
+            return RequestRoute(RTM_DELROUTE, 0, ipDestAddrStrPtr, NULL, interfaceStrPtr, isIpv6);
+
+        default:
+            LE_ERROR("Unknown route action %d", routeAction);
+            return LE_FAULT;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used the data backup upon connection to remove DNS entries locally added
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dcs_RestoreInitialDnsNameServers
+(
+    pa_dcs_InterfaceDataBackup_t*  interfaceDataBackupPtr
+)
+{
+    const char* dnsPtrs[] =
+    {
+        interfaceDataBackupPtr->newDnsIPv4[0], interfaceDataBackupPtr->newDnsIPv4[1],
+        interfaceDataBackupPtr->newDnsIPv6[0], interfaceDataBackupPtr->newDnsIPv6[1]
+    };
+    char current[RESOLV_CONF_MAX_BYTES];
+    char restored[RESOLV_CONF_MAX_BYTES];
+    const char* linePtr = current;
+    size_t restoredLen = 0;
+
+    if (-1 == ReadResolvConf(current, sizeof(current)))
+    {
+        return;
+    }
+
+    // Keep the lines which are not the entries of the added name servers
+    while ('\0' != *linePtr)
+    {
+        const char* endPtr = strchr(linePtr, '\n');
+        size_t lineLen = (endPtr ? (size_t)(endPtr - linePtr) + 1 : strlen(linePtr));
+        bool isAdded = false;
+        size_t i;
+
+        for (i = 0; (i < NUM_ARRAY_MEMBERS(dnsPtrs)) && !isAdded; i++)
+        {
+            isAdded = IsNameServerLine(linePtr, (endPtr ? lineLen - 1 : lineLen), dnsPtrs[i]);
+        }
+
+        if (!isAdded)
+        {
+            memcpy(&restored[restoredLen], linePtr, lineLen);
+            restoredLen += lineLen;
+        }
+
+        linePtr += lineLen;
+    }
+
+    if (restoredLen == strlen(current))
+    {
+        LE_DEBUG("No DNS entry to remove");
+        return;
+    }
+
+    if (LE_OK != WriteResolvConf(restored, restoredLen))
+    {
+        LE_ERROR("Unable to restore the initial DNS name servers");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the DNS configuration
+ *
+ * @return
+ *      LE_FAULT        Function failed
+ *      LE_OK           Function succeed
+ *      LE_UNSUPPORTED  Function not supported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_SetDnsNameServers
+(
+    const char* dns1Ptr,    ///< [IN] Pointer on first DNS address
+    const char* dns2Ptr     ///< [IN] Pointer on second DNS address
+)
+{
+    char current[RESOLV_CONF_MAX_BYTES];
+    char updated[RESOLV_CONF_MAX_BYTES + 2 * (sizeof(RESOLV_CONF_NAME_SERVER" \n")
+                                              + LE_MDC_IPV6_ADDR_MAX_BYTES)];
+    ssize_t currentLen = ReadResolvConf(current, sizeof(current));
+    size_t updatedLen = 0;
+
+    if (-1 == currentLen)
+    {
+        return LE_FAULT;
+    }
+
+    // Add the missing name servers before the current ones, to be used first
+    if (('\0' != dns1Ptr[0]) && !HasNameServer(current, dns1Ptr))
+    {
+        updatedLen += snprintf(&updated[updatedLen], sizeof(updated) - updatedLen,
+                               RESOLV_CONF_NAME_SERVER" %s\n", dns1Ptr);
+    }
+
+    if (('\0' != dns2Ptr[0]) && (0 != strcmp(dns1Ptr, dns2Ptr)) && !HasNameServer(current, dns2Ptr))
+    {
+        updatedLen += snprintf(&updated[updatedLen], sizeof(updated) - updatedLen,
+                               RESOLV_CONF_NAME_SERVER" %s\n", dns2Ptr);
+    }
+
+    if (0 == updatedLen)
+    {
+        LE_DEBUG("DNS name servers already set");
+        return LE_OK;
+    }
+
+    LE_ASSERT((updatedLen + currentLen) < sizeof(updated));
+    memcpy(&updated[updatedLen], current, currentLen);
+
+    return WriteResolvConf(updated, updatedLen + currentLen);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retrieve time from a server using the Time Protocol.
+ *
+ * @return
+ *      - LE_OK             Function successful
+ *      - LE_BAD_PARAMETER  A parameter is incorrect
+ *      - LE_FAULT          Function failed
+ *      - LE_UNSUPPORTED    Function not supported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_GetTimeWithTimeProtocol
+(
+    const char* serverStrPtr,       ///< [IN]  Time server
+    pa_dcs_TimeStruct_t* timePtr    ///< [OUT] Time structure
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_UNSUPPORTED;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retrieve time from a server using the Network Time Protocol.
+ *
+ * @return
+ *      - LE_OK             Function successful
+ *      - LE_BAD_PARAMETER  A parameter is incorrect
+ *      - LE_FAULT          Function failed
+ *      - LE_UNSUPPORTED    Function not supported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dcs_GetTimeWithNetworkTimeProtocol
+(
+    const char* serverStrPtr,       ///< [IN]  Time server
+    pa_dcs_TimeStruct_t* timePtr    ///< [OUT] Time structure
+)
+{
+    LE_ERROR("Unsupported function called");
+    return LE_UNSUPPORTED;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler for the network changes, i.e. an address or a route added on an interface.
+ *
+ * @return
+ *      - A handler reference on success
+ *      - NULL if the network changes are not reported by the target
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_dcs_AddNetworkChangeHandler
+(
+    pa_dcs_NetworkChangeHandler_t handlerPtr,   ///< [IN] The network change handler function.
+    void*                         contextPtr    ///< [IN] The context to be given to the handler.
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    if (NULL == handlerPtr)
+    {
+        LE_ERROR("Handler function is NULL!");
+        return NULL;
+    }
+
+    // Join the netlink groups reporting the changes with the first handler
+    if (-1 == NetworkChangeFd)
+    {
+        NetworkChangeFd = OpenNetlinkSocket(NETWORK_CHANGE_GROUPS);
+        if (-1 == NetworkChangeFd)
+        {
+            return NULL;
+        }
+        le_fdMonitor_Create("DcsNetworkChange", NetworkChangeFd, NetworkChangeMonitorHandler,
+                            POLLIN);
+    }
+
+    handlerRef = le_event_AddLayeredHandler("DcsNetworkChangeHandler",
+                                            NetworkChangeEventId,
+                                            FirstLayerNetworkChangeHandler,
+                                            (le_event_HandlerFunc_t)handlerPtr);
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return handlerRef;
+}
+
+COMPONENT_INIT
+{
+    NetworkChangeEventId = le_event_CreateId("DcsNetworkChange", IF_NAMESIZE);
+}
@@ -10,6 +10,8 @@
 #include "interfaces.h"
 #include "pa_fwupdate.h"
 #include "pa_flash.h"
+#include "fwupdate_local.h"
+#include "watchdogChain.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -67,6 +69,35 @@ typedef struct
 }
 Partition_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer of a stream write, holding the data of one block.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t*                dataPtr;       ///< Data of the block
+    size_t                  dataSize;      ///< Data size of the block, 0 at end of stream
+}
+StreamBuffer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream write context, shared between the reader (the service thread) and the writer thread.
+ * The reader fills a buffer while the writer erases and writes the other one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Partition_t*            partPtr;       ///< Partition being written
+    uint32_t                blockIndex;    ///< Logical block index to be written next
+    StreamBuffer_t          buffers[2];    ///< Double buffer
+    le_sem_Ref_t            freeSem;       ///< Posted when a buffer can be filled by the reader
+    le_sem_Ref_t            fullSem;       ///< Posted when a buffer can be written by the writer
+    le_result_t             result;        ///< Result of the writes, set by the writer
+}
+WriteStream_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory pool for allocating partitions ref.
@@ -81,6 +112,13 @@ static le_mem_PoolRef_t PartitionPool = NULL;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t PartitionRefMap = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for allocating the stream write buffers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StreamBufferPool = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory pool for allocating request count by client.
@@ -619,6 +657,139 @@ static void ReleaseClientAccess
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write data to a block of a flash partition. The block of a MTD partition is erased before to be
+ * written. The partition must be open for writing, and the UBI volume open for UBI partitions.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_FAULT         On errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteBlock
+(
+    Partition_t*            partPtr,      ///< [IN] Partition descriptor
+    uint32_t                blockIndex,   ///< [IN] Logical block index to be write.
+    const uint8_t*          writeData,    ///< [IN] Data buffer to be written.
+    size_t                  writeDataSize ///< [IN] Data size to be written
+)
+{
+    le_result_t res;
+
+    if (partPtr->isUbi)
+    {
+        res = pa_flash_WriteUbiAtBlock(partPtr->desc, blockIndex,
+                                       (uint8_t*)writeData, writeDataSize, true);
+        if (LE_OK != res)
+        {
+            LE_ERROR("Ubi Volume %u Partition \"%s\" MTD%d: Write failed at blockIndex %u,"
+                     " dataSize %zu: %d",
+                     partPtr->ubiVolume, partPtr->partitionName, partPtr->mtdNum, blockIndex,
+                     writeDataSize, res);
+            res = LE_FAULT;
+        }
+    }
+    else
+    {
+        res = pa_flash_EraseBlock( partPtr->desc, blockIndex );
+        if (LE_OK != res)
+        {
+            LE_ERROR("Partition \"%s\" MTD%d: Erase failed at blockIndex %u",
+                     partPtr->partitionName, partPtr->mtdNum, blockIndex);
+            return LE_FAULT;
+        }
+        res = pa_flash_WriteAtBlock( partPtr->desc, blockIndex, (uint8_t*)writeData, writeDataSize);
+        if (LE_OK != res)
+        {
+            LE_ERROR("Partition \"%s\" MTD%d: Write failed at blockIndex %u, dataSize %zu: %d",
+                     partPtr->partitionName, partPtr->mtdNum, blockIndex, writeDataSize, res);
+            res = LE_FAULT;
+        }
+    }
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a whole block of data from a file descriptor. Less data are read only at end of file.
+ *
+ * @return
+ *      - The number of bytes read
+ *      - -1 on read error
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadStreamBlock
+(
+    int     fd,          ///< [IN] File descriptor to read from
+    uint8_t *dataPtr,    ///< [OUT] Buffer for the data
+    size_t  dataSize     ///< [IN] Block size
+)
+{
+    size_t readSize = 0;
+
+    while (readSize < dataSize)
+    {
+        ssize_t rc = read(fd, dataPtr + readSize, dataSize - readSize);
+        if (-1 == rc)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Read from stream failed: %m");
+            return -1;
+        }
+        if (0 == rc)
+        {
+            break;
+        }
+        readSize += rc;
+    }
+    return readSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writer thread of a stream write: erases and writes the buffers filled by the reader, until the
+ * end of stream. After an error, the buffers are released without being written.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriteStreamThread
+(
+    void* contextPtr    ///< [IN] Stream write context
+)
+{
+    WriteStream_t* streamPtr = (WriteStream_t*)contextPtr;
+    int idx = 0;
+
+    for (;;)
+    {
+        le_sem_Wait(streamPtr->fullSem);
+
+        StreamBuffer_t* bufferPtr = &streamPtr->buffers[idx];
+        if (0 == bufferPtr->dataSize)
+        {
+            break;
+        }
+
+        if (LE_OK == __atomic_load_n(&streamPtr->result, __ATOMIC_ACQUIRE))
+        {
+            le_result_t res = WriteBlock(streamPtr->partPtr, streamPtr->blockIndex,
+                                         bufferPtr->dataPtr, bufferPtr->dataSize);
+            if (LE_OK == res)
+            {
+                streamPtr->blockIndex++;
+            }
+            __atomic_store_n(&streamPtr->result, res, __ATOMIC_RELEASE);
+        }
+
+        le_sem_Post(streamPtr->freeSem);
+        idx ^= 1;
+    }
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialization for Partition
@@ -633,6 +804,7 @@ static void PartitionInit
     {
         PartitionPool = le_mem_CreatePool("Flash Partition Pool", sizeof(Partition_t));
         PartitionRefMap = le_ref_CreateMap("Flash Partition Ref Map", MAX_PARTITION_REF);
+        StreamBufferPool = le_mem_CreatePool("Flash Stream Buffer Pool", LE_FLASH_MAX_WRITE_SIZE);
 
         // Register a handler to be notified when clients disconnect
         le_msg_AddServiceCloseHandler(le_flash_GetServiceRef(), CloseClientPartitions, NULL);
@@ -1177,7 +1349,6 @@ le_result_t le_flash_Write
 )
 {
     Partition_t *partPtr = GetPartitionFromRef(partitionRef);
-    le_result_t res;
 
     if ((NULL == partPtr) || !(partPtr->isWrite) || (NULL == writeData))
     {
@@ -1191,35 +1362,128 @@ le_result_t le_flash_Write
             return LE_BAD_PARAMETER;
         }
         LE_INFO("MTD%d BlockIndex %u WriteDataSize %zu", partPtr->mtdNum, blockIndex, writeDataSize);
-        res = pa_flash_WriteUbiAtBlock(partPtr->desc, blockIndex,
-                                       (uint8_t*)writeData, writeDataSize, true);
-        if (LE_OK != res)
-        {
-            LE_ERROR("Ubi Volume %u Partition \"%s\" MTD%d: Write failed at blockIndex %u,"
-                     " dataSize %zu: %d",
-                     partPtr->ubiVolume, partPtr->partitionName, partPtr->mtdNum, blockIndex,
-                     writeDataSize, res);
-            res = LE_FAULT;
-        }
     }
-    else
+    return WriteBlock(partPtr, blockIndex, writeData, writeDataSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a data stream to a flash partition.
+ * - the data are read from the file descriptor until its end.
+ * - the data are programmed at consecutive logical block indexes, starting at blockIndex. Each
+ *   block is written with the maximum data length accepted by le_flash_Write(), except the last
+ *   one.
+ * - the blocks are erased and written as by le_flash_Write(), by a writer thread, while the next
+ *   block is read from the file descriptor.
+ *
+ * @note
+ *      The file descriptor is closed by the service.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_BAD_PARAMETER If a parameter is invalid
+ *      - LE_FAULT         On other error, e.g. if the data cannot be read from the file descriptor
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_flash_WriteStream
+(
+    le_flash_PartitionRef_t partitionRef,           ///< [IN] Partition reference to be used.
+    uint32_t                blockIndex,             ///< [IN] First logical block index to be write.
+    int                     fd,                     ///< [IN] File descriptor to read the data from.
+    uint32_t*               writtenBlocksNumberPtr  ///< [OUT] Number of blocks written.
+)
+{
+    Partition_t *partPtr = GetPartitionFromRef(partitionRef);
+    WriteStream_t stream;
+    le_thread_Ref_t threadRef;
+    le_result_t readRes = LE_OK;
+    size_t blockSize;
+    ssize_t readSize;
+    int idx;
+
+    if ((NULL == partPtr) || !(partPtr->isWrite) || (fd < 0) || (NULL == writtenBlocksNumberPtr) ||
+        ((partPtr->isUbi) && (-1 == partPtr->ubiVolume)))
     {
-        res = pa_flash_EraseBlock( partPtr->desc, blockIndex );
-        if (LE_OK != res)
+        if (fd >= 0)
         {
-            LE_ERROR("Partition \"%s\" MTD%d: Erase failed at blockIndex %u",
-                     partPtr->partitionName, partPtr->mtdNum, blockIndex);
-            return LE_FAULT;
+            close(fd);
         }
-        res = pa_flash_WriteAtBlock( partPtr->desc, blockIndex, (uint8_t*)writeData, writeDataSize);
-        if (LE_OK != res)
+        return LE_BAD_PARAMETER;
+    }
+
+    blockSize = partPtr->mtdInfo->eraseSize;
+    if (partPtr->isUbi)
+    {
+        blockSize -= 2 * partPtr->mtdInfo->writeSize;
+    }
+    if (blockSize > LE_FLASH_MAX_WRITE_SIZE)
+    {
+        LE_ERROR("Partition \"%s\" MTD%d: Block size %zu is too large",
+                 partPtr->partitionName, partPtr->mtdNum, blockSize);
+        close(fd);
+        return LE_FAULT;
+    }
+
+    LE_INFO("MTD%d BlockIndex %u stream with block size %zu",
+            partPtr->mtdNum, blockIndex, blockSize);
+
+    memset(&stream, 0, sizeof(stream));
+    stream.partPtr = partPtr;
+    stream.blockIndex = blockIndex;
+    stream.result = LE_OK;
+    for (idx = 0; idx < NUM_ARRAY_MEMBERS(stream.buffers); idx++)
+    {
+        stream.buffers[idx].dataPtr = le_mem_ForceAlloc(StreamBufferPool);
+    }
+    stream.freeSem = le_sem_Create("FlashStreamFree", NUM_ARRAY_MEMBERS(stream.buffers));
+    stream.fullSem = le_sem_Create("FlashStreamFull", 0);
+
+    threadRef = le_thread_Create("FlashStreamWriter", WriteStreamThread, &stream);
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    // Fill the buffers until end of stream or error. An empty buffer ends the writer thread.
+    idx = 0;
+    do
+    {
+        le_sem_Wait(stream.freeSem);
+
+        // The service thread is busy until the end of stream, keep the watchdog happy.
+        le_wdogChain_Kick(FWUPDATE_WDOG_TIMER);
+
+        StreamBuffer_t* bufferPtr = &stream.buffers[idx];
+        readSize = 0;
+        if (LE_OK == __atomic_load_n(&stream.result, __ATOMIC_ACQUIRE))
         {
-            LE_ERROR("Partition \"%s\" MTD%d: Write failed at blockIndex %u, dataSize %zu: %d",
-                     partPtr->partitionName, partPtr->mtdNum, blockIndex, writeDataSize, res);
-            res = LE_FAULT;
+            readSize = ReadStreamBlock(fd, bufferPtr->dataPtr, blockSize);
+            if (-1 == readSize)
+            {
+                readRes = LE_FAULT;
+                readSize = 0;
+            }
         }
+        bufferPtr->dataSize = readSize;
+
+        le_sem_Post(stream.fullSem);
+        idx ^= 1;
     }
-    return res;
+    while (0 != readSize);
+
+    le_thread_Join(threadRef, NULL);
+    close(fd);
+
+    le_sem_Delete(stream.freeSem);
+    le_sem_Delete(stream.fullSem);
+    for (idx = 0; idx < NUM_ARRAY_MEMBERS(stream.buffers); idx++)
+    {
+        le_mem_Release(stream.buffers[idx].dataPtr);
+    }
+
+    *writtenBlocksNumberPtr = stream.blockIndex - blockIndex;
+    LE_INFO("MTD%d %u blocks written from BlockIndex %u",
+            partPtr->mtdNum, *writtenBlocksNumberPtr, blockIndex);
+
+    return (LE_OK != stream.result) ? stream.result : readRes;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,213 @@
+/** @file jsRuntime.c
+ *
+ * JerryScript runtime for JavaScript apps.
+ *
+ * Runs one or more JerryScript snapshots, given as command-line arguments, in order.  The
+ * snapshots are generated at build time from the scripts listed in a component's "javascript:"
+ * section and bundled into the app's lib directory, so an app typically runs this as:
+ *
+ * @verbatim
+    run:
+    {
+        ( jsRuntime /lib/dashboard.snapshot )
+    }
+@endverbatim
+ *
+ * Each snapshot is mapped read-only and executed in place: the byte-code is never parsed nor
+ * copied to the engine heap, and static snapshots are accepted, so start-up cost does not grow
+ * with the size of the script.  The mapping is kept for the life of the process since the engine
+ * keeps referencing it.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "jerryscript.h"
+
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a line logged by print(), including the null terminator.  Longer lines are
+ * truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PRINT_LINE_BYTES 256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implementation of the global print() function.  Logs its arguments, separated by spaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static jerry_value_t PrintHandler
+(
+    const jerry_value_t funcObj,
+    const jerry_value_t thisVal,
+    const jerry_value_t args[],
+    const jerry_length_t argCount
+)
+{
+    char line[MAX_PRINT_LINE_BYTES] = "";
+    size_t used = 0;
+    jerry_length_t i;
+
+    for (i = 0; (i < argCount) && (used < sizeof(line) - 1); i++)
+    {
+        jerry_value_t strVal = jerry_value_to_string(args[i]);
+
+        if (i > 0)
+        {
+            line[used++] = ' ';
+        }
+
+        // Unlike jerry_string_to_utf8_char_buffer(), this copies as many whole characters as fit
+        // rather than nothing at all if the string is too long.
+        used += jerry_substring_to_utf8_char_buffer(strVal,
+                                                    0,
+                                                    jerry_get_utf8_string_length(strVal),
+                                                    (jerry_char_t*)line + used,
+                                                    sizeof(line) - 1 - used);
+        jerry_release_value(strVal);
+    }
+
+    line[used] = '\0';
+    LE_INFO("%s", line);
+
+    return jerry_create_undefined();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds the runtime's native functions to the global object.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RegisterNatives
+(
+    void
+)
+{
+    jerry_value_t globalObj = jerry_get_global_object();
+    jerry_value_t nameVal = jerry_create_string((const jerry_char_t*)"print");
+    jerry_value_t funcVal = jerry_create_external_function(PrintHandler);
+
+    jerry_release_value(jerry_set_property(globalObj, nameVal, funcVal));
+
+    jerry_release_value(funcVal);
+    jerry_release_value(nameVal);
+    jerry_release_value(globalObj);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a snapshot file into memory.
+ *
+ * @return Address of the mapping.  Exits the process on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t* MapSnapshot
+(
+    const char* pathPtr,        ///< [IN] Path to the snapshot file.
+    size_t* sizePtr             ///< [OUT] Size of the snapshot, in bytes.
+)
+{
+    struct stat st;
+    int fd = open(pathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        LE_FATAL("Failed to open snapshot '%s' (%m).", pathPtr);
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+    {
+        LE_FATAL("Snapshot '%s' is empty or can't be read (%m).", pathPtr);
+    }
+
+    // The snapshot is page-aligned, which satisfies the engine's 32-bit alignment requirement.
+    void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (addr == MAP_FAILED)
+    {
+        LE_FATAL("Failed to map snapshot '%s' (%m).", pathPtr);
+    }
+
+    close(fd);
+
+    *sizePtr = st.st_size;
+
+    return addr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Executes one snapshot and any jobs (promise reactions) it enqueued.
+ *
+ * @return true if the script completed without throwing.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RunSnapshot
+(
+    const char* pathPtr
+)
+{
+    size_t size;
+    const uint32_t* snapshotPtr = MapSnapshot(pathPtr, &size);
+
+    jerry_value_t result = jerry_exec_snapshot(snapshotPtr,
+                                               size,
+                                               0,
+                                               JERRY_SNAPSHOT_EXEC_ALLOW_STATIC);
+
+    if (!jerry_value_is_error(result))
+    {
+        jerry_release_value(result);
+        result = jerry_run_all_enqueued_jobs();
+    }
+
+    bool ok = !jerry_value_is_error(result);
+
+    if (!ok)
+    {
+        LE_CRIT("Uncaught exception in '%s'.", pathPtr);
+    }
+
+    jerry_release_value(result);
+
+    return ok;
+}
+
+
+COMPONENT_INIT
+{
+    size_t argCount = le_arg_NumArgs();
+    size_t i;
+    int status = EXIT_SUCCESS;
+
+    if (argCount == 0)
+    {
+        fprintf(stderr, "Usage: %s <snapshot> [<snapshot> ...]\n", le_arg_GetProgramName());
+        exit(EXIT_FAILURE);
+    }
+
+    jerry_init(JERRY_INIT_EMPTY);
+    RegisterNatives();
+
+    for (i = 0; (i < argCount) && (status == EXIT_SUCCESS); i++)
+    {
+        if (!RunSnapshot(le_arg_GetArg(i)))
+        {
+            status = EXIT_FAILURE;
+        }
+    }
+
+    jerry_cleanup();
+
+    exit(status);
+}
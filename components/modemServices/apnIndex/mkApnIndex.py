@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+#
+# Compiles an APN database in JSON format (apns-full-conf.json or apns-iin-conf.json) into the
+# sorted binary index that the Modem Data Control service looks default APNs up in.
+#
+# Index file layout (all integers are little-endian):
+#
+#   Header:             char     magic[4]          "LAPN"
+#                       uint16_t version           1
+#                       uint16_t maxKeyLength      Length of the longest key, in bytes.
+#                       uint32_t recordCount       Number of records.
+#                       uint32_t stringsOffset     Offset of the string table from file start.
+#
+#   Records, sorted by key:
+#                       char     key[16]           "MCC:MNC" or IIN, null-padded.
+#                       uint32_t order             Position of the entry in the JSON file.
+#                       uint32_t apnOffset         Offset of the APN in the string table.
+#
+#   String table:       Null-terminated APN strings.
+#
+# Only the first usable entry for each key is kept, because that is the one the service would
+# pick.  For the MCC/MNC database, only entries of type "default" are usable.
+#
+# Copyright (C) Sierra Wireless Inc.
+#
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+MAGIC = b'LAPN'
+VERSION = 1
+KEY_BYTES = 16
+
+
+def ReadEntries(jsonPath):
+    with open(jsonPath) as f:
+        root = json.load(f)
+
+    try:
+        return root['apns']['apn']
+    except (KeyError, TypeError):
+        sys.exit("%s: expected an 'apns' object containing an 'apn' array" % jsonPath)
+
+
+def MccMncKeys(entries):
+    for entry in entries:
+        if ('@mcc' in entry) and ('@mnc' in entry) and ('@apn' in entry):
+            # Entries without a type are "default" entries.
+            if 'default' in entry.get('@type', 'default'):
+                yield entry['@mcc'] + ':' + entry['@mnc'], entry['@apn']
+
+
+def IinKeys(entries):
+    for entry in entries:
+        if ('@iin' in entry) and ('@apn' in entry):
+            yield entry['@iin'], entry['@apn']
+
+
+def WriteIndex(outPath, keyedApns):
+    records = {}
+    strings = bytearray()
+    stringOffsets = {}
+
+    for order, (key, apn) in enumerate(keyedApns):
+        key = key.encode('utf-8')
+        if (len(key) == 0) or (len(key) >= KEY_BYTES):
+            sys.exit("Invalid APN database key '%s'" % key.decode('utf-8'))
+
+        # Keep the first entry for each key.
+        if key in records:
+            continue
+
+        apn = apn.encode('utf-8')
+        if apn not in stringOffsets:
+            stringOffsets[apn] = len(strings)
+            strings += apn + b'\0'
+
+        records[key] = (order, stringOffsets[apn])
+
+    keys = sorted(records)
+    maxKeyLength = max([len(key) for key in keys] or [0])
+    stringsOffset = 16 + (len(keys) * (KEY_BYTES + 8))
+
+    out = bytearray()
+    out += struct.pack('<4sHHII', MAGIC, VERSION, maxKeyLength, len(keys), stringsOffset)
+    for key in keys:
+        order, apnOffset = records[key]
+        out += struct.pack('<%dsII' % KEY_BYTES, key, order, apnOffset)
+    out += strings
+
+    outDir = os.path.dirname(outPath)
+    if outDir and not os.path.isdir(outDir):
+        os.makedirs(outDir)
+
+    with open(outPath, 'wb') as f:
+        f.write(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile an APN database into a binary index.')
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument('--mccmnc', action='store_true',
+                       help='index the default APN of each MCC/MNC (apns-full-conf.json)')
+    group.add_argument('--iin', action='store_true',
+                       help='index the APN of each SIM IIN (apns-iin-conf.json)')
+    parser.add_argument('input', help='APN database in JSON format')
+    parser.add_argument('output', help='index file to create')
+    args = parser.parse_args()
+
+    entries = ReadEntries(args.input)
+    WriteIndex(args.output, MccMncKeys(entries) if args.mccmnc else IinKeys(entries))
+
+
+if __name__ == '__main__':
+    main()
@@ -11,6 +11,24 @@
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit offsets of the MSD structure in the MSD message for MSD versions 1 and 2. MSD version 2
+ * inserts the MSD structure length after the version.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_V1_STRUCT_OFFSET            10
+#define MSD_V2_STRUCT_OFFSET            18
+#define MSD_V2_LENGTH_OFFSET            8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit offsets of the fields patched in the MSD template, from the MSD structure start
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_MESSAGE_ID_OFFSET           4
+#define MSD_POSITION_TRUSTED_OFFSET     14
+
 //--------------------------------------------------------------------------------------------------
 /**
  * ...
@@ -92,60 +110,40 @@ static int8_t GetAsciiCode
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function insert an 'up to 8-bit' element in the MSD message
+ * This function insert an 'up to 32-bit' element in the MSD message.
+ *
+ * The message bytes spanned by the element are loaded in a 64-bit word, the element is merged in
+ * with a single mask operation and the bytes are written back.
  *
  * @return the updated offset after the element insertion
  */
 //--------------------------------------------------------------------------------------------------
-static uint16_t PutBits
+static uint16_t PutValue
 (
     uint16_t msgOffset,   ///< [IN] Element position in the MSD message
-    uint16_t elmtLen,     ///< [IN] Element length in bits
-    uint8_t* elmtPtr,     ///< [IN] Pointer to the element to insert
+    uint8_t  elmtLen,     ///< [IN] Element length in bits (1 to 32)
+    uint32_t elmtValue,   ///< [IN] Element value, in the elmtLen least significant bits
     uint8_t* msgPtr       ///< [OUT] updated MSD message with the new element
 )
 {
-    register uint8_t elmtPos;
-    register uint8_t msgPos;
-    register uint8_t val;
-    register int8_t shift;
-    uint8_t mask;
-    uint16_t i ;
-    uint8_t bitMask [8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
-
-    msgPos = (msgOffset & 0x07);      /* Modulus 8      */
-    msgPtr += msgOffset >> 3;         /* integral div 8 */
-    elmtPos  = 8 - ((elmtLen & 0x07) ? elmtLen & 0x07 : (elmtLen & 0x07) + 8);
-
-    for (i = 0 ; i < elmtLen ; i++)
-    {
-        val = (*elmtPtr) &  bitMask [elmtPos];
-        mask = bitMask [elmtPos];
-        shift = msgPos - elmtPos;
-        if (shift >= 0)
-        {
-            val >>= shift;
-            mask >>= shift;
-        }
-        else
-        {
-            val <<= (- shift);
-            mask <<= (-shift);
-        }
-        *msgPtr &= ~mask;
-        *msgPtr |= val;
-        elmtPos++;
-        msgPos++;
-        if (elmtPos > 7) /* byte change in elmtPtr */
-        {
-            elmtPtr++;
-            elmtPos = 0;
-        }
-        if (msgPos > 7) /* byte change in elmtPtr */
-        {
-            msgPtr++;
-            msgPos = 0;
-        }
+    uint8_t* bytePtr = msgPtr + (msgOffset >> 3);
+    uint8_t  bitPos = (msgOffset & 0x07);
+    uint8_t  byteNb = (bitPos + elmtLen + 7) >> 3;
+    uint8_t  shift = 64 - bitPos - elmtLen;
+    uint64_t mask = ((((uint64_t)1) << elmtLen) - 1) << shift;
+    uint64_t word = 0;
+    uint8_t  i;
+
+    for (i = 0; i < byteNb; i++)
+    {
+        word |= ((uint64_t)bytePtr[i]) << (56 - (8 * i));
+    }
+
+    word = (word & ~mask) | ((((uint64_t)elmtValue) << shift) & mask);
+
+    for (i = 0; i < byteNb; i++)
+    {
+        bytePtr[i] = (uint8_t)(word >> (56 - (8 * i)));
     }
 
     return (msgOffset + elmtLen);
@@ -153,38 +151,20 @@ static uint16_t PutBits
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function insert an 'up to 2-byte' element in the MSD message
+ * This function insert an 'up to 8-bit' element in the MSD message
  *
  * @return the updated offset after the element insertion
  */
 //--------------------------------------------------------------------------------------------------
-static uint16_t PutTwoBytes
+static uint16_t PutBits
 (
-    uint16_t  msgOffset,   ///< [IN] Element position in the MSD message
-    uint16_t  elmtLen,     ///< [IN] Element length in bits
-    uint16_t* elmtPtr,     ///< [IN] Pointer to the element to insert
-    uint8_t*  msgPtr       ///< [OUT] updated MSD message with the new element
+    uint16_t msgOffset,   ///< [IN] Element position in the MSD message
+    uint16_t elmtLen,     ///< [IN] Element length in bits
+    uint8_t* elmtPtr,     ///< [IN] Pointer to the element to insert
+    uint8_t* msgPtr       ///< [OUT] updated MSD message with the new element
 )
 {
-   uint16_t  msgOffsetCurrent = msgOffset;
-   uint8_t n;
-   uint16_t setBit[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
-                           0x100, 0x200, 0x400, 0x800, 0x1000, 0x2000, 0x4000, 0x8000 };
-
-   for( n = 0; n < elmtLen; n++ )
-   {
-      if( *(elmtPtr) & setBit[elmtLen-1-n] )
-      {
-         msgPtr[ (msgOffsetCurrent>>3) ] |= 0x01<<(7-( msgOffsetCurrent&0x07 ));
-      }
-      else
-      {
-         msgPtr[ (msgOffsetCurrent>>3) ] &=~( 0x01<<(7-( msgOffsetCurrent&0x07 )));
-      }
-      msgOffsetCurrent++;
-   }
-
-   return (msgOffset + elmtLen);
+    return PutValue(msgOffset, elmtLen, *elmtPtr, msgPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -267,37 +247,27 @@ static int32_t msd_EncodeMsdMessageOptionalData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function encodes the MSD message from the elements of the MSD data structure
+ * This function encodes the static fields of the MSD message, i.e. all the fields located before
+ * the timestamp.
  *
- * @return the MSD message length in bytes on success
+ * @return the encoded static fields length in bits on success
  * @return LE_FAULT on failure
- *
  */
 //--------------------------------------------------------------------------------------------------
-int32_t msd_EncodeMsdMessage
+static int32_t EncodeMsdStaticFields
 (
     msd_t*      msdDataPtr, ///< [IN] MSD data
-    uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
+    uint8_t*    outDataPtr  ///< [OUT] encoded MSD static fields
 )
 {
     uint8_t off = 0;
     uint16_t offset=0;
     int i;
-    uint16_t offsetV2=0;
-    uint8_t *outDataV2Ptr;
-
 
     /* MSD Format */
-    if ((msdDataPtr->version != 1)&&(msdDataPtr->version != 2))
-    {
-        LE_ERROR("MSD version %d not supported", msdDataPtr->version);
-        return LE_FAULT;
-    }
     offset = PutBits(offset, 8, &msdDataPtr->version, outDataPtr);
 
     /* MSD structure size field for MSD V2 coding (left empty and compute at the end) */
-    offsetV2 = offset;
-    outDataV2Ptr = outDataPtr;
     if (msdDataPtr->version == 2)
     {
        /* Length for MSD structure */
@@ -482,21 +452,153 @@ int32_t msd_EncodeMsdMessage
        }
     }
 
-    /* Timestamp ( 32 bits ==> 4 * 8 bits ==> to check order ) */
+    return offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function checks if an MSD template was encoded from the static fields of the MSD data
+ * structure.
+ *
+ * @return true if the template can be used to encode the MSD, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsTemplateUpToDate
+(
+    const msd_Template_t* templatePtr,  ///< [IN] MSD template
+    const msd_t*          msdDataPtr    ///< [IN] MSD data
+)
+{
+    const msd_Structure_t* msdStructPtr = &msdDataPtr->msdMsg.msdStruct;
+    const msd_VehiclePropulsionStorageType_t* propPtr = &msdStructPtr->vehPropulsionStorageType;
+
+    return (   (templatePtr->isValid)
+            && (templatePtr->version == msdDataPtr->version)
+            && (templatePtr->optionalDataPres == msdDataPtr->msdMsg.optionalDataPres)
+            && (templatePtr->recentVehLocationN1Pres == msdStructPtr->recentVehLocationN1Pres)
+            && (templatePtr->recentVehLocationN2Pres == msdStructPtr->recentVehLocationN2Pres)
+            && (templatePtr->numberOfPassengersPres == msdStructPtr->numberOfPassengersPres)
+            && (templatePtr->automaticActivation == msdStructPtr->control.automaticActivation)
+            && (templatePtr->testCall == msdStructPtr->control.testCall)
+            && (templatePtr->vehType == msdStructPtr->control.vehType)
+            && (0 == memcmp(&templatePtr->vin,
+                            &msdStructPtr->vehIdentificationNumber,
+                            sizeof(templatePtr->vin)))
+            && (templatePtr->gasolineTankPresent == propPtr->gasolineTankPresent)
+            && (templatePtr->dieselTankPresent == propPtr->dieselTankPresent)
+            && (templatePtr->compressedNaturalGas == propPtr->compressedNaturalGas)
+            && (templatePtr->liquidPropaneGas == propPtr->liquidPropaneGas)
+            && (templatePtr->electricEnergyStorage == propPtr->electricEnergyStorage)
+            && (templatePtr->hydrogenStorage == propPtr->hydrogenStorage)
+            && (templatePtr->otherStorage == propPtr->otherStorage));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the static fields of the MSD data structure into an MSD template.
+ *
+ * @return LE_OK on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t BuildTemplate
+(
+    msd_Template_t* templatePtr,    ///< [OUT] MSD template
+    const msd_t*    msdDataPtr      ///< [IN] MSD data
+)
+{
+    const msd_Structure_t* msdStructPtr = &msdDataPtr->msdMsg.msdStruct;
+    const msd_VehiclePropulsionStorageType_t* propPtr = &msdStructPtr->vehPropulsionStorageType;
+    int32_t length;
+
+    memset(templatePtr, 0, sizeof(msd_Template_t));
+
+    length = EncodeMsdStaticFields((msd_t*)msdDataPtr, templatePtr->data);
+    if (LE_FAULT == length)
+    {
+        return LE_FAULT;
+    }
+
+    templatePtr->length = length;
+    templatePtr->version = msdDataPtr->version;
+    templatePtr->optionalDataPres = msdDataPtr->msdMsg.optionalDataPres;
+    templatePtr->recentVehLocationN1Pres = msdStructPtr->recentVehLocationN1Pres;
+    templatePtr->recentVehLocationN2Pres = msdStructPtr->recentVehLocationN2Pres;
+    templatePtr->numberOfPassengersPres = msdStructPtr->numberOfPassengersPres;
+    templatePtr->automaticActivation = msdStructPtr->control.automaticActivation;
+    templatePtr->testCall = msdStructPtr->control.testCall;
+    templatePtr->vehType = msdStructPtr->control.vehType;
+    memcpy(&templatePtr->vin, &msdStructPtr->vehIdentificationNumber, sizeof(templatePtr->vin));
+    templatePtr->gasolineTankPresent = propPtr->gasolineTankPresent;
+    templatePtr->dieselTankPresent = propPtr->dieselTankPresent;
+    templatePtr->compressedNaturalGas = propPtr->compressedNaturalGas;
+    templatePtr->liquidPropaneGas = propPtr->liquidPropaneGas;
+    templatePtr->electricEnergyStorage = propPtr->electricEnergyStorage;
+    templatePtr->hydrogenStorage = propPtr->hydrogenStorage;
+    templatePtr->otherStorage = propPtr->otherStorage;
+    templatePtr->isValid = true;
+
+    LE_DEBUG("MSD template built: %d bits", templatePtr->length);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the MSD message from the elements of the MSD data structure, using an MSD
+ * template for the static fields. The template is rebuilt if the static fields changed.
+ *
+ * @return the MSD message length in bytes on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t msd_EncodeMsdMessageWithTemplate
+(
+    msd_t*          msdDataPtr,     ///< [IN] MSD data
+    msd_Template_t* templatePtr,    ///< [IN,OUT] MSD template
+    uint8_t*        outDataPtr      ///< [OUT] encoded MSD message
+)
+{
+    uint16_t offset;
+    uint16_t msdStructOffset;
+
+    /* MSD Format */
+    if ((msdDataPtr->version != 1)&&(msdDataPtr->version != 2))
     {
-        uint8_t* ptr = (uint8_t*) &msdDataPtr->msdMsg.msdStruct.timestamp;
+        LE_ERROR("MSD version %d not supported", msdDataPtr->version);
+        return LE_FAULT;
+    }
 
-        for (i=0;i<4;i++)
+    /* Static fields */
+    if (!IsTemplateUpToDate(templatePtr, msdDataPtr))
+    {
+        if (LE_OK != BuildTemplate(templatePtr, msdDataPtr))
         {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
+            templatePtr->isValid = false;
+            return LE_FAULT;
         }
     }
+    memcpy(outDataPtr, templatePtr->data, (templatePtr->length + 7) / 8);
+    offset = templatePtr->length;
+
+    /* Patch the message identifier and the position trust bit in the static fields */
+    msdStructOffset = (msdDataPtr->version == 2) ? MSD_V2_STRUCT_OFFSET : MSD_V1_STRUCT_OFFSET;
+    PutValue(msdStructOffset + MSD_MESSAGE_ID_OFFSET,
+             8,
+             msdDataPtr->msdMsg.msdStruct.messageIdentifier,
+             outDataPtr);
+    PutValue(msdStructOffset + MSD_POSITION_TRUSTED_OFFSET,
+             1,
+             msdDataPtr->msdMsg.msdStruct.control.positionCanBeTrusted,
+             outDataPtr);
+
+    /* Timestamp (32 bits) */
+    offset = PutValue(offset, 32, msdDataPtr->msdMsg.msdStruct.timestamp, outDataPtr);
 
     /* vehLocation idem on 32 bits for latitude and longitude */
     /* latitude */
     {
         int32_t latitudeTmp = msdDataPtr->msdMsg.msdStruct.vehLocation.latitude;
-        uint8_t* ptr = (uint8_t*) &latitudeTmp;
         if((latitudeTmp < -324000000) || (latitudeTmp > 324000000))
         {
             if(latitudeTmp != 0x7FFFFFFF)
@@ -505,17 +607,12 @@ int32_t msd_EncodeMsdMessage
                 return LE_FAULT;
             }
         }
-        latitudeTmp += 0x80000000;
-        for (i=0;i<4;i++)
-        {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
-        }
+        offset = PutValue(offset, 32, (uint32_t)latitudeTmp + 0x80000000U, outDataPtr);
     }
 
     /* longitude */
     {
         int32_t longitudeTmp = msdDataPtr->msdMsg.msdStruct.vehLocation.longitude;
-        uint8_t* ptr = (uint8_t*) &longitudeTmp;
         if((longitudeTmp < -648000000) || (longitudeTmp > 648000000))
         {
             if(longitudeTmp != 0x7FFFFFFF)
@@ -524,11 +621,7 @@ int32_t msd_EncodeMsdMessage
                 return LE_FAULT;
             }
         }
-        longitudeTmp += 0x80000000;
-        for (i=0;i<4;i++)
-        {
-            offset = PutBits(offset, 8, (uint8_t*) &ptr[3-i], outDataPtr);
-        }
+        offset = PutValue(offset, 32, (uint32_t)longitudeTmp + 0x80000000U, outDataPtr);
     }
 
     /* vehDirection */
@@ -557,7 +650,7 @@ int32_t msd_EncodeMsdMessage
             return LE_FAULT;
         }
         latitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&latitudeDeltaTmp, outDataPtr);
+        offset = PutValue(offset, 10, latitudeDeltaTmp, outDataPtr);
 
         /* longitudeDelta */
         longitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN1.longitudeDelta;
@@ -568,7 +661,7 @@ int32_t msd_EncodeMsdMessage
             return LE_FAULT;
         }
         longitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&longitudeDeltaTmp, outDataPtr);
+        offset = PutValue(offset, 10, longitudeDeltaTmp, outDataPtr);
     }
 
     /* recentVehLocationN2 */
@@ -585,7 +678,7 @@ int32_t msd_EncodeMsdMessage
         }
 
         latitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&latitudeDeltaTmp, outDataPtr);
+        offset = PutValue(offset, 10, latitudeDeltaTmp, outDataPtr);
 
         /* longitudeDelta */
         longitudeDeltaTmp = msdDataPtr->msdMsg.msdStruct.recentVehLocationN2.longitudeDelta;
@@ -596,7 +689,7 @@ int32_t msd_EncodeMsdMessage
             return LE_FAULT;
         }
         longitudeDeltaTmp += 512;
-        offset = PutTwoBytes(offset, 10, (uint16_t*)&longitudeDeltaTmp, outDataPtr);
+        offset = PutValue(offset, 10, longitudeDeltaTmp, outDataPtr);
     }
 
     /* numberOfPassengers */
@@ -637,14 +730,34 @@ int32_t msd_EncodeMsdMessage
         {
             /* MSD structure size for MSD V2 coding */
             uint8_t msdV2StructLen = msdMsgLen-2;
-            LE_DEBUG("MSD version 2: offset %d, MSD struct length %d", offsetV2, msdV2StructLen );
-            offset = PutBits(offsetV2, 8, &msdV2StructLen, outDataV2Ptr);
+            LE_DEBUG("MSD version 2: MSD struct length %d", msdV2StructLen);
+            PutBits(MSD_V2_LENGTH_OFFSET, 8, &msdV2StructLen, outDataPtr);
         }
 
         return msdMsgLen;
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the MSD message from the elements of the MSD data structure
+ *
+ * @return the MSD message length in bytes on success
+ * @return LE_FAULT on failure
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t msd_EncodeMsdMessage
+(
+    msd_t*      msdDataPtr, ///< [IN] MSD data
+    uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
+)
+{
+    msd_Template_t msdTemplate = { .isValid = false };
+
+    return msd_EncodeMsdMessageWithTemplate(msdDataPtr, &msdTemplate, outDataPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function encodes a data buffer from the elements of the ERA Glonass additional data
@@ -703,8 +816,7 @@ int32_t msd_EncodeOptionalDataForEraGlonass
         {
             /* crashSeverity : INTEGER (0..2047) OPTIONAL*/
             /* Fits in 11 bits */
-            offset = PutTwoBytes(offset, 11 ,(uint16_t*)&eraGlonassDataPtr->crashSeverity
-                                 , outDataPtr);
+            offset = PutValue(offset, 11, eraGlonassDataPtr->crashSeverity, outDataPtr);
         }
 
         if (eraGlonassDataPtr->presentDiagnosticResult)
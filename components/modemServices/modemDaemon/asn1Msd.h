@@ -26,6 +26,13 @@
 #define ASN1_LONGITUDE_DELTA_MAX  511
 #define ASN1_LONGITUDE_DELTA_MIN  -512
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length in bytes of the MSD static fields encoded in an MSD template
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSD_TEMPLATE_MAX_LEN  24
+
 //--------------------------------------------------------------------------------------------------
 // Symbols and enums.
 //--------------------------------------------------------------------------------------------------
@@ -198,6 +205,35 @@ typedef struct {
     msd_Message_t msdMsg;
 } msd_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data structure holding the pre-encoded static fields of an MSD message, i.e. the fields located
+ * before the timestamp, with the MSD data they were encoded from.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct {
+   bool                 isValid;
+   uint8_t              version;
+   bool                 optionalDataPres;
+   bool                 recentVehLocationN1Pres;
+   bool                 recentVehLocationN2Pres;
+   bool                 numberOfPassengersPres;
+   bool                 automaticActivation;
+   bool                 testCall;
+   msd_VehicleType_t    vehType;
+   msd_Vin_t            vin;
+   bool                 gasolineTankPresent;
+   bool                 dieselTankPresent;
+   bool                 compressedNaturalGas;
+   bool                 liquidPropaneGas;
+   bool                 electricEnergyStorage;
+   bool                 hydrogenStorage;
+   bool                 otherStorage;
+   uint16_t             length;                         /* Encoded length in bits */
+   uint8_t              data[MSD_TEMPLATE_MAX_LEN];     /* Encoded static fields */
+} msd_Template_t;
+
 
 /* ERA GLONASS specific types for the OptionalData_t parts */
 //--------------------------------------------------------------------------------------------------
@@ -352,4 +388,23 @@ int32_t msd_EncodeMsdMessage
     uint8_t*    outDataPtr  ///< [OUT] encoded MSD message
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function encodes the MSD message from the elements of the MSD data structure, using an MSD
+ * template for the static fields. Only the message identifier, the position and the time are
+ * encoded when the static fields did not change since the template was built.
+ *
+ * @return the MSD message length in bytes on success
+ * @return LE_FAULT on failure
+ *
+ * @note The template must be zero-initialized before its first use.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t msd_EncodeMsdMessageWithTemplate
+(
+    msd_t*          msdDataPtr,     ///< [IN] MSD data
+    msd_Template_t* templatePtr,    ///< [IN,OUT] MSD template
+    uint8_t*        outDataPtr      ///< [OUT] encoded MSD message
+);
+
 #endif // LEGATO_ASN1_MSD_INCLUDE_GUARD
@@ -11,6 +11,122 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_adc.h"
+#include "le_adc_local.h"
+#include "sampler.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kind of the sampler sources of ADC channels.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLER_KIND    "adc"
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an ADC channel for the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SampleAdc
+(
+    const char* namePtr,    ///< [IN] Name of the ADC channel.
+    int32_t* valuePtr       ///< [OUT] The value.
+)
+{
+    return pa_adc_ReadValue(namePtr, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleThreshold handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallThresholdHandler
+(
+    sampler_Level_t level,
+    int32_t value,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_adc_SampleThresholdHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc((le_adc_SampleLevel_t)level, value, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleWindow handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallWindowHandler
+(
+    int32_t minValue,
+    int32_t maxValue,
+    int32_t avgValue,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_adc_SampleWindowHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc(minValue, maxValue, avgValue, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close session handler: remove the sampling handlers of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Message session reference.
+    void* contextPtr                ///< [IN] Context pointer.
+)
+{
+    sampler_RemoveSessionMonitors(sessionRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sampler source of an ADC channel.
+ *
+ * @return The source, or NULL if the name is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static sampler_SourceRef_t GetSource
+(
+    const char* adcNamePtr  ///< [IN] Name of the ADC channel.
+)
+{
+    if (strnlen(adcNamePtr, LE_ADC_ADC_NAME_MAX_BYTES) >= LE_ADC_ADC_NAME_MAX_BYTES)
+    {
+        LE_KILL_CLIENT("strlen(adcNamePtr) > %d", LE_ADC_ADC_NAME_MAX_LEN);
+        return NULL;
+    }
+
+    return sampler_GetSource(SAMPLER_KIND, adcNamePtr, SampleAdc);
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialization of the ADC service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_Init
+(
+    void
+)
+{
+    le_msg_AddServiceCloseHandler(le_adc_GetServiceRef(), CloseSessionEventHandler, NULL);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -40,3 +156,113 @@ le_result_t le_adc_ReadValue
     return pa_adc_ReadValue(adcNamePtr, adcValuePtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_adc_SampleThreshold'
+ *
+ * This event reports the level of an ADC channel sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_adc_SampleThresholdHandlerRef_t le_adc_AddSampleThresholdHandler
+(
+    const char* adcNamePtr,                         ///< [IN] Name of the ADC to sample.
+    int32_t lowThreshold,                           ///< [IN] Low threshold.
+    int32_t highThreshold,                          ///< [IN] High threshold.
+    uint32_t hysteresis,                            ///< [IN] Hysteresis.
+    le_adc_SampleThresholdHandlerFunc_t handlerPtr, ///< [IN] The handler function.
+    void* contextPtr                                ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    sampler_SourceRef_t sourceRef = GetSource(adcNamePtr);
+    if (NULL == sourceRef)
+    {
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddThresholdMonitor(sourceRef,
+                                                                  lowThreshold,
+                                                                  highThreshold,
+                                                                  hysteresis,
+                                                                  CallThresholdHandler,
+                                                                  handlerPtr,
+                                                                  contextPtr,
+                                                                  le_adc_GetClientSessionRef());
+
+    return (le_adc_SampleThresholdHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_adc_SampleThreshold'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_RemoveSampleThresholdHandler
+(
+    le_adc_SampleThresholdHandlerRef_t handlerRef   ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_adc_SampleWindow'
+ *
+ * This event reports the minimum, maximum and average of every windowSamples samples of an ADC
+ * channel sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_adc_SampleWindowHandlerRef_t le_adc_AddSampleWindowHandler
+(
+    const char* adcNamePtr,                         ///< [IN] Name of the ADC to sample.
+    uint32_t windowSamples,                         ///< [IN] Number of samples in a window.
+    le_adc_SampleWindowHandlerFunc_t handlerPtr,    ///< [IN] The handler function.
+    void* contextPtr                                ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    sampler_SourceRef_t sourceRef = GetSource(adcNamePtr);
+    if (NULL == sourceRef)
+    {
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddWindowMonitor(sourceRef,
+                                                               windowSamples,
+                                                               CallWindowHandler,
+                                                               handlerPtr,
+                                                               contextPtr,
+                                                               le_adc_GetClientSessionRef());
+
+    return (le_adc_SampleWindowHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_adc_SampleWindow'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_RemoveSampleWindowHandler
+(
+    le_adc_SampleWindowHandlerRef_t handlerRef      ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
@@ -0,0 +1,19 @@
+/** @file le_adc_local.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LEADC_LOCAL_INCLUDE_GUARD
+#define LEGATO_LEADC_LOCAL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialization of the ADC service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_adc_Init
+(
+    void
+);
+
+#endif // LEGATO_LEADC_LOCAL_INCLUDE_GUARD
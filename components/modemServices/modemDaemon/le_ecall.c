@@ -253,6 +253,8 @@ typedef struct
                                                                         /// when requested by the
                                                                         /// PSAP (pull)
     msd_t                   msd;                                        ///< MSD
+    msd_Template_t          msdTemplate;                                ///< Pre-encoded MSD
+                                                                        ///  static fields
     uint8_t                 builtMsd[LE_ECALL_MSD_MAX_LEN];             ///< built MSD
     size_t                  builtMsdSize;                               ///< Size of the built MSD
     bool                    isMsdImported;                              ///< True if the MSD is
@@ -272,9 +274,31 @@ typedef struct
     bool                    t5Received;                                 ///< T5 timeout received
     bool                    sendMsdSignalReceived;                      ///< Send MSD signal
                                                                         ///< received
+    le_clk_Time_t           triggerTime;                                ///< Relative time the
+                                                                        ///< session was started at
 }
 ECall_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * eCall settings of the config tree, read and validated when they change so that they are not
+ * read during an eCall session.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                               vin[LE_ECALL_VIN_MAX_BYTES]; ///< VIN, empty if not set
+    bool                               isVehicleTypeSet;            ///< True if vehicleType is set
+    le_ecall_MsdVehicleType_t          vehicleType;                 ///< Vehicle type
+    uint32_t                           msdVersion;                  ///< MSD version
+    le_ecall_SystemStandard_t          systemStandard;              ///< System standard
+    msd_VehiclePropulsionStorageType_t propulsion;                  ///< Propulsion types
+    le_result_t                        propulsionResult;            ///< Result of reading the
+                                                                    ///< propulsion types
+}
+ECallSettings_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Report state structure.
@@ -336,6 +360,14 @@ static le_event_Id_t ECallEventStateId;
 //--------------------------------------------------------------------------------------------------
 static ECall_t ECallObj;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * eCall settings.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static ECallSettings_t ECallSettings;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Safe Reference Map for eCall objects.
@@ -1148,32 +1180,7 @@ static le_result_t VehicleTypeEnumToString
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Parse the vehicle type from the config DB entry and update the corresponding MSD element.
- *
- * @return
- *      - LE_OK on success.
- *      - LE_FAULT no vehicle type found.
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t ParseAndSetVehicleType
-(
-    char* vehStr
-)
-{
-    LE_FATAL_IF((vehStr == NULL), "vehStr is NULL !");
-
-    le_ecall_MsdVehicleType_t vehType;
-    le_result_t result = VehicleTypeStringToEnum( vehStr, &vehType);
-    if (LE_OK == result)
-    {
-        ECallObj.msd.msdMsg.msdStruct.control.vehType = VehicleTypeEnumToEnumAsn1(vehType);
-    }
-    return result;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Parse the propulsion type from the config DB entry and update the corresponding MSD element.
+ * Parse the propulsion type from the config DB entry and set it in a propulsion storage type.
  *
  * @return
  *      - LE_OK on success.
@@ -1226,16 +1233,55 @@ static le_result_t ParseAndSetPropulsionType
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the propulsions type
+ * The Vehicle Identification Number is defined by iso 3833 as a 17 character
+ * alphanumeric code, which does not include the letters i, I, o, O, q, Q. Also
+ * the letters u, U, z, Z and the digit 0 are not allowed in the model year code
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int VerifyVIN
+(
+    char *vin
+)
+{
+    int ret = 0;
+    char c;
+
+    c = (char)tolower(vin[9]);
+
+    if ( ('0' == c) || ('u' == c) || ('z' == c) )
+    {
+        LE_WARN("Year digit cannot be %c", vin[9]);
+        ret = -1;
+    }
+
+    while ( (*vin) && (!ret) )
+    {
+        c= (char)tolower(*vin);
+        if ( ('i' == c) || ('o' == c) || ('q' == c) )
+        {
+            LE_WARN("%c not allowed in VIN", *vin);
+            ret = -1;
+        }
+
+        vin++;
+    }
+
+    return ret;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the propulsion types from the config tree.
  *
  * @return
  *      - LE_OK on success
  *      - LE_FAULT no valid propulsion type found
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetPropulsionType
+static le_result_t ReadPropulsionTypes
 (
-    void
+    msd_VehiclePropulsionStorageType_t* propulsionPtr   ///< [OUT] Propulsion types
 )
 {
     uint8_t i=0;
@@ -1243,7 +1289,6 @@ static le_result_t GetPropulsionType
     char configPath[LE_CFG_STR_LEN_BYTES];
     char propStr[PROPULSION_MAX_BYTES] = {0};
     le_result_t res = LE_OK;
-    msd_VehiclePropulsionStorageType_t  vehPropulsionStorageType;
 
     snprintf(configPath, sizeof(configPath), "%s/%s", CFG_MODEMSERVICE_ECALL_PATH, CFG_NODE_PROP);
     le_cfg_IteratorRef_t propCfg = le_cfg_CreateReadTxn(configPath);
@@ -1251,7 +1296,7 @@ static le_result_t GetPropulsionType
     snprintf(cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
 
     // Init propulsion type bitmask
-    memset(&vehPropulsionStorageType, 0, sizeof(vehPropulsionStorageType));
+    memset(propulsionPtr, 0, sizeof(*propulsionPtr));
 
     while (!le_cfg_IsEmpty(propCfg, cfgNodeLoc))
     {
@@ -1268,20 +1313,12 @@ static le_result_t GetPropulsionType
             break;
         }
         LE_DEBUG("eCall settings, Propulsion is %s", propStr);
-        if (ParseAndSetPropulsionType(propStr, &vehPropulsionStorageType) != LE_OK)
+        if (ParseAndSetPropulsionType(propStr, propulsionPtr) != LE_OK)
         {
             LE_ERROR("Bad propulsion type!");
             res = LE_FAULT;
             break;
         }
-        else
-        {
-            // Store propulsion type to MSD message
-            memcpy(&ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType
-                    , &vehPropulsionStorageType
-                    , sizeof(vehPropulsionStorageType));
-            res = LE_OK;
-        }
 
         i++;
         snprintf(cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
@@ -1320,145 +1357,190 @@ static msd_CoordinateSystemType_t CoordinateSystemTypeEnumToEnumAsn1
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Load the eCall settings
- *
- * @return
- *      - LE_OK on success
- *      - LE_FAULT there are missing settings
+ * Read and validate the eCall settings of the config tree.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t LoadECallSettings
+static void ReadECallSettings
 (
-    ECall_t* eCallPtr
+    ECallSettings_t* settingsPtr    ///< [OUT] eCall settings
 )
 {
-    char configPath[LE_CFG_STR_LEN_BYTES];
-    snprintf(configPath, sizeof(configPath), "%s", CFG_MODEMSERVICE_ECALL_PATH);
-
     LE_DEBUG("Start reading eCall information in ConfigDB");
 
-    le_cfg_IteratorRef_t eCallCfg = le_cfg_CreateReadTxn(configPath);
+    memset(settingsPtr, 0, sizeof(*settingsPtr));
+    settingsPtr->msdVersion = DEFAULT_MSD_VERSION;
+    settingsPtr->systemStandard = LE_ECALL_PAN_EUROPEAN;
+
+    le_cfg_IteratorRef_t eCallCfg = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_ECALL_PATH);
 
+    // Get VIN
+    if (le_cfg_NodeExists(eCallCfg, CFG_NODE_VIN))
     {
-        // Get VIN
-        if (le_cfg_NodeExists(eCallCfg, CFG_NODE_VIN))
+        char vinStr[LE_ECALL_VIN_MAX_BYTES] = {0};
+        if (le_cfg_GetString(eCallCfg, CFG_NODE_VIN, vinStr, sizeof(vinStr), "") != LE_OK)
         {
-            char vinStr[LE_ECALL_VIN_MAX_BYTES] = {0};
-            if (le_cfg_GetString(eCallCfg, CFG_NODE_VIN, vinStr, sizeof(vinStr), "") != LE_OK)
-            {
-                LE_WARN("No node value set for '%s'", CFG_NODE_VIN);
-            }
-            else if (strlen(vinStr) > 0)
-            {
-                memcpy((void *)&(eCallPtr->msd.msdMsg.msdStruct.vehIdentificationNumber),
-                       (const void *)vinStr,
-                       strlen(vinStr));
-            }
-            LE_DEBUG("eCall settings, VIN is %s", vinStr);
+            LE_WARN("No node value set for '%s'", CFG_NODE_VIN);
+        }
+        else if ((strlen(vinStr) != LE_ECALL_VIN_MAX_LEN) || VerifyVIN(vinStr))
+        {
+            LE_WARN("Bad value set for '%s' !", CFG_NODE_VIN);
         }
         else
         {
-            LE_WARN("No value set for '%s' !", CFG_NODE_VIN);
+            memcpy(settingsPtr->vin, vinStr, sizeof(settingsPtr->vin));
         }
+        LE_DEBUG("eCall settings, VIN is %s", vinStr);
+    }
+    else
+    {
+        LE_WARN("No value set for '%s' !", CFG_NODE_VIN);
+    }
 
-        // Get vehicle type
-        if (le_cfg_NodeExists(eCallCfg, CFG_NODE_VEH))
+    // Get vehicle type
+    if (le_cfg_NodeExists(eCallCfg, CFG_NODE_VEH))
+    {
+        char  vehStr[VEHICLE_TYPE_MAX_BYTES] = {0};
+        if (le_cfg_GetString(eCallCfg, CFG_NODE_VEH, vehStr, sizeof(vehStr), "") != LE_OK)
         {
-            char  vehStr[VEHICLE_TYPE_MAX_BYTES] = {0};
-            if (le_cfg_GetString(eCallCfg, CFG_NODE_VEH, vehStr, sizeof(vehStr), "") != LE_OK)
+            LE_WARN("No node value set for '%s'", CFG_NODE_VEH);
+        }
+        else if (strlen(vehStr) > 0)
+        {
+            LE_DEBUG("eCall settings, vehicle is %s", vehStr);
+            if (LE_OK == VehicleTypeStringToEnum(vehStr, &settingsPtr->vehicleType))
             {
-                LE_WARN("No node value set for '%s'", CFG_NODE_VEH);
+                settingsPtr->isVehicleTypeSet = true;
             }
-            else if (strlen(vehStr) > 0)
+            else
             {
-                LE_DEBUG("eCall settings, vehicle is %s", vehStr);
-                if (LE_OK != ParseAndSetVehicleType(vehStr))
-                {
-                    LE_WARN("Bad vehicle type!");
-                }
+                LE_WARN("Bad vehicle type!");
             }
         }
-        else
+    }
+    else
+    {
+        LE_WARN("No value set for '%s' !", CFG_NODE_VEH);
+    }
+
+    // Get MSD version
+    if (le_cfg_NodeExists(eCallCfg, CFG_NODE_MSDVERSION))
+    {
+        settingsPtr->msdVersion = le_cfg_GetInt(eCallCfg, CFG_NODE_MSDVERSION, 0);
+        LE_DEBUG("eCall settings, MSD version is %d", settingsPtr->msdVersion);
+        if (settingsPtr->msdVersion == 0)
         {
-            LE_WARN("No value set for '%s' !", CFG_NODE_VEH);
+            LE_WARN("No correct value set for '%s' ! Use the default one (%d)",
+                    CFG_NODE_MSDVERSION,
+                    DEFAULT_MSD_VERSION);
+            settingsPtr->msdVersion = DEFAULT_MSD_VERSION;
         }
+    }
+    else
+    {
+        LE_WARN("No value set for '%s' ! Use the default one (%d)",
+                CFG_NODE_MSDVERSION,
+                DEFAULT_MSD_VERSION);
+    }
 
-        // Get MSD version
-        if (le_cfg_NodeExists(eCallCfg, CFG_NODE_MSDVERSION))
+    // Get system standard
+    if (le_cfg_NodeExists(eCallCfg, CFG_NODE_SYSTEM_STD))
+    {
+        char  sysStr[SYS_STD_MAX_BYTES] = {0};
+        if (le_cfg_GetString(eCallCfg,
+                              CFG_NODE_SYSTEM_STD,
+                              sysStr,
+                              sizeof(sysStr),
+                              "PAN-EUROPEAN") != LE_OK)
         {
-            eCallPtr->msd.version = le_cfg_GetInt(eCallCfg, CFG_NODE_MSDVERSION, 0);
-            LE_DEBUG("eCall settings, MSD version is %d", eCallPtr->msd.version);
-            if (eCallPtr->msd.version == 0)
-            {
-                LE_WARN("No correct value set for '%s' ! Use the default one (%d)",
-                        CFG_NODE_MSDVERSION,
-                        DEFAULT_MSD_VERSION);
-                eCallPtr->msd.version = DEFAULT_MSD_VERSION;
-            }
+            LE_WARN("No node value set for '%s' ! Use the default one (PAN-EUROPEAN)",
+                    CFG_NODE_SYSTEM_STD);
         }
-        else
+        else if (strncmp(sysStr, "ERA-GLONASS", strlen("ERA-GLONASS")) == 0)
         {
-            LE_WARN("No value set for '%s' ! Use the default one (%d)",
-                    CFG_NODE_MSDVERSION,
-                    DEFAULT_MSD_VERSION);
-            eCallPtr->msd.version = DEFAULT_MSD_VERSION;
+            settingsPtr->systemStandard = LE_ECALL_ERA_GLONASS;
         }
-
-        // Get system standard
+        else if (strncmp(sysStr, "PAN-EUROPEAN", strlen("PAN-EUROPEAN")) != 0)
         {
-            char  sysStr[SYS_STD_MAX_BYTES] = {0};
-            bool isEraGlonass = false;
-            if (le_cfg_NodeExists(eCallCfg, CFG_NODE_SYSTEM_STD))
-            {
-                if (le_cfg_GetString(eCallCfg,
-                                      CFG_NODE_SYSTEM_STD,
-                                      sysStr,
-                                      sizeof(sysStr),
-                                      "PAN-EUROPEAN") != LE_OK)
-                {
-                    LE_WARN("No node value set for '%s' ! Use the default one (%s)",
-                            CFG_NODE_SYSTEM_STD,
-                            sysStr);
-                }
-                else if ((strncmp(sysStr, "PAN-EUROPEAN", strlen("PAN-EUROPEAN")) != 0) &&
-                         (strncmp(sysStr, "ERA-GLONASS", strlen("ERA-GLONASS")) != 0))
-                {
-                    LE_WARN("Bad value set for '%s' ! Use the default one (%s)",
-                            CFG_NODE_SYSTEM_STD,
-                            sysStr);
-                }
-                LE_DEBUG("eCall settings, system standard is %s", sysStr);
-                if (strncmp(sysStr, "ERA-GLONASS", strlen("ERA-GLONASS")) == 0)
-                {
-                    isEraGlonass = true;
-                }
-            }
-            else
-            {
-                LE_WARN("No node value set for '%s' ! Use the default one (%s)",
-                        CFG_NODE_SYSTEM_STD,
-                        sysStr);
-            }
-            if (isEraGlonass)
-            {
-                SystemStandard = PA_ECALL_ERA_GLONASS;
-            }
-            else
-            {
-                SystemStandard = PA_ECALL_PAN_EUROPEAN;
-            }
-            LE_INFO("Selected standard is %s (%d)", sysStr, SystemStandard);
-
-            if ( LE_OK != pa_ecall_UpdateSystemStandard(SystemStandard))
-            {
-               LE_INFO("Update PA system standard (%d) failed!", SystemStandard);
-            }
+            LE_WARN("Bad value set for '%s' ! Use the default one (PAN-EUROPEAN)",
+                    CFG_NODE_SYSTEM_STD);
         }
+        LE_DEBUG("eCall settings, system standard is %s", sysStr);
+    }
+    else
+    {
+        LE_WARN("No node value set for '%s' ! Use the default one (PAN-EUROPEAN)",
+                CFG_NODE_SYSTEM_STD);
     }
 
     le_cfg_CancelTxn(eCallCfg);
 
-    return GetPropulsionType();
+    settingsPtr->propulsionResult = ReadPropulsionTypes(&settingsPtr->propulsion);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the eCall settings to the static values of an MSD and to the system standard.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyECallSettings
+(
+    ECall_t* eCallPtr
+)
+{
+    if ('\0' != ECallSettings.vin[0])
+    {
+        memcpy((void *)&(eCallPtr->msd.msdMsg.msdStruct.vehIdentificationNumber),
+               (const void *)ECallSettings.vin,
+               LE_ECALL_VIN_MAX_LEN);
+    }
+
+    if (ECallSettings.isVehicleTypeSet)
+    {
+        eCallPtr->msd.msdMsg.msdStruct.control.vehType =
+                                            VehicleTypeEnumToEnumAsn1(ECallSettings.vehicleType);
+    }
+
+    eCallPtr->msd.version = ECallSettings.msdVersion;
+
+    if (LE_OK == ECallSettings.propulsionResult)
+    {
+        eCallPtr->msd.msdMsg.msdStruct.vehPropulsionStorageType = ECallSettings.propulsion;
+    }
+
+    if (LE_ECALL_ERA_GLONASS == ECallSettings.systemStandard)
+    {
+        SystemStandard = PA_ECALL_ERA_GLONASS;
+    }
+    else
+    {
+        SystemStandard = PA_ECALL_PAN_EUROPEAN;
+    }
+    LE_INFO("Selected standard is %d", SystemStandard);
+
+    if ( LE_OK != pa_ecall_UpdateSystemStandard(SystemStandard))
+    {
+       LE_INFO("Update PA system standard (%d) failed!", SystemStandard);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the eCall settings
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT there are missing settings
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadECallSettings
+(
+    ECall_t* eCallPtr
+)
+{
+    ReadECallSettings(&ECallSettings);
+    ApplyECallSettings(eCallPtr);
+
+    return ECallSettings.propulsionResult;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1569,7 +1651,9 @@ static le_result_t EncodeMsd
         }
 
         // Encode MSD message
-        if ((eCallPtr->builtMsdSize = msd_EncodeMsdMessage(&eCallPtr->msd, eCallPtr->builtMsd))
+        if ((eCallPtr->builtMsdSize = msd_EncodeMsdMessageWithTemplate(&eCallPtr->msd,
+                                                                       &eCallPtr->msdTemplate,
+                                                                       eCallPtr->builtMsd))
             == LE_FAULT)
         {
             LE_ERROR("Unable to encode the MSD! Please verify your settings in the config tree.");
@@ -1810,9 +1894,19 @@ static void ProcessECallState
         }
 
         case LE_ECALL_STATE_MSD_TX_STARTED: /* MSD transmission is started */
+        case LE_ECALL_STATE_MSD_TX_COMPLETED: /* MSD transmission is complete */
+        {
+            le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), ECallObj.triggerTime);
+
+            LE_INFO("MSD transmission %s %"PRIu64" ms after the eCall trigger",
+                    (LE_ECALL_STATE_MSD_TX_STARTED == eCallEventDataPtr->state) ?
+                        "started" : "completed",
+                    ((uint64_t)elapsed.sec * 1000) + (elapsed.usec / 1000));
+            break;
+        }
+
         case LE_ECALL_STATE_WAITING_PSAP_START_IND: /* Waiting for PSAP start indication */
         case LE_ECALL_STATE_LLNACK_RECEIVED: /* LL-NACK received */
-        case LE_ECALL_STATE_MSD_TX_COMPLETED: /* MSD transmission is complete */
         case LE_ECALL_STATE_RESET: /* eCall session has lost synchronization and starts over */
         case LE_ECALL_STATE_MSD_TX_FAILED: /* MSD transmission has failed */
         case LE_ECALL_STATE_FAILED: /* Unsuccessful eCall session */
@@ -2692,8 +2786,10 @@ le_result_t le_ecall_ExportMsd
     }
 
     if ((!eCallPtr->isMsdImported) &&
-        (eCallPtr->builtMsdSize = msd_EncodeMsdMessage(&eCallPtr->msd,
-                                                        eCallPtr->builtMsd)) == LE_FAULT)
+        (eCallPtr->builtMsdSize = msd_EncodeMsdMessageWithTemplate(&eCallPtr->msd,
+                                                                    &eCallPtr->msdTemplate,
+                                                                    eCallPtr->builtMsd))
+        == LE_FAULT)
     {
         LE_ERROR("Unable to encode the MSD!");
         return LE_NOT_FOUND;
@@ -2739,6 +2835,9 @@ le_result_t le_ecall_StartAutomatic
         return LE_BUSY;
     }
 
+    // The time to the MSD transmission is counted from here
+    ECallObj.triggerTime = le_clk_GetRelativeTime();
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -2824,6 +2923,9 @@ le_result_t le_ecall_StartManual
         return LE_BUSY;
     }
 
+    // The time to the MSD transmission is counted from here
+    ECallObj.triggerTime = le_clk_GetRelativeTime();
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -2909,6 +3011,9 @@ le_result_t le_ecall_StartTest
         return LE_BUSY;
     }
 
+    // The time to the MSD transmission is counted from here
+    ECallObj.triggerTime = le_clk_GetRelativeTime();
+
     // Hang up all the ongoing calls using the communication channel required for eCall
     if (le_mcc_HangUpAll() != LE_OK)
     {
@@ -4272,12 +4377,15 @@ le_result_t le_ecall_SetSystemStandard
     le_cfg_SetString(iteratorRef, CFG_NODE_SYSTEM_STD, standard);
     le_cfg_CommitTxn(iteratorRef);
 
+    ECallSettings.systemStandard = systemStandard;
+
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the system standard.
+ * @note If the value is not correct in the config tree, it defaults to PAN-EUROPEAN.
  *
  * @return
  *  - LE_OK on success
@@ -4290,52 +4398,14 @@ le_result_t le_ecall_GetSystemStandard
         ///< [OUT] System mode
 )
 {
-    le_cfg_IteratorRef_t iteratorRef = NULL;
-    char systemModeString[20];
-
     if (NULL == systemStandardPtr)
     {
         LE_KILL_CLIENT("systemStandardPtr is NULL.");
         return LE_FAULT;
     }
 
-    iteratorRef = le_cfg_CreateReadTxn( CFG_MODEMSERVICE_ECALL_PATH );
+    *systemStandardPtr = ECallSettings.systemStandard;
 
-    if (!le_cfg_NodeExists(iteratorRef, CFG_NODE_SYSTEM_STD))
-    {
-        LE_WARN("Node 'systemStandard' does not exist. Default to PAN EU");
-        *systemStandardPtr = LE_ECALL_PAN_EUROPEAN;
-        le_cfg_CancelTxn( iteratorRef );
-        return LE_OK;
-    }
-
-    if (LE_OVERFLOW == le_cfg_GetString(iteratorRef, CFG_NODE_SYSTEM_STD,
-        systemModeString, sizeof(systemModeString), ""))
-    {
-        LE_WARN("Node '"CFG_NODE_SYSTEM_STD"' exist, but is too long. Default to PAN EU. :%s",
-            systemModeString);
-
-        *systemStandardPtr = LE_ECALL_PAN_EUROPEAN;
-        le_cfg_CancelTxn( iteratorRef );
-        return LE_OK;
-    }
-
-    if (0 == strncmp( "PAN-EUROPEAN", systemModeString, 12))
-    {
-        *systemStandardPtr = LE_ECALL_PAN_EUROPEAN;
-    }
-    else if (0 == strncmp( "ERA-GLONASS", systemModeString, 11))
-    {
-        *systemStandardPtr = LE_ECALL_ERA_GLONASS;
-    }
-    else
-    {
-        LE_WARN("Node '"CFG_NODE_SYSTEM_STD"' exist, but does not match:%s. Default to PAN EU.",
-                systemModeString);
-        *systemStandardPtr = LE_ECALL_PAN_EUROPEAN;
-    }
-
-    le_cfg_CancelTxn( iteratorRef );
     return LE_OK;
 }
 
@@ -4360,6 +4430,8 @@ le_result_t le_ecall_SetMsdVersion
     le_cfg_SetInt(iteratorRef, CFG_NODE_MSDVERSION, msdVersion);
     le_cfg_CommitTxn(iteratorRef);
 
+    ECallSettings.msdVersion = (0 == msdVersion) ? DEFAULT_MSD_VERSION : msdVersion;
+
     LE_DEBUG("Set MsdVersion to %d", msdVersion);
 
     return LE_OK;
@@ -4382,38 +4454,13 @@ le_result_t le_ecall_GetMsdVersion
         ///< [OUT] Msd version
 )
 {
-    le_cfg_IteratorRef_t iteratorRef = NULL;
-
     if (NULL == msdVersionPtr)
     {
         LE_KILL_CLIENT("msdVersionPtr is NULL !");
         return LE_BAD_PARAMETER;
     }
 
-    iteratorRef = le_cfg_CreateReadTxn( CFG_MODEMSERVICE_ECALL_PATH );
-
-    if (le_cfg_NodeExists(iteratorRef, CFG_NODE_MSDVERSION))
-    {
-        *msdVersionPtr = le_cfg_GetInt(iteratorRef, CFG_NODE_MSDVERSION, 0);
-        LE_DEBUG("MSD version read as %d", *msdVersionPtr);
-        if (*msdVersionPtr == 0)
-        {
-            LE_WARN("No correct value set for '%s' ! Use the default one (%d)",
-                    CFG_NODE_MSDVERSION,
-                    DEFAULT_MSD_VERSION);
-
-            *msdVersionPtr = DEFAULT_MSD_VERSION;
-        }
-    }
-    else
-    {
-        LE_WARN("No config tree value set for '%s' ! Use the default one (%d)",
-                CFG_NODE_MSDVERSION,
-                DEFAULT_MSD_VERSION);
-        *msdVersionPtr = DEFAULT_MSD_VERSION;
-    }
-
-    le_cfg_CancelTxn( iteratorRef );
+    *msdVersionPtr = ECallSettings.msdVersion;
 
     return LE_OK;
 }
@@ -4454,6 +4501,9 @@ le_result_t le_ecall_SetVehicleType
     le_cfg_SetString(iteratorRef, CFG_NODE_VEH, vehStr);
     le_cfg_CommitTxn(iteratorRef);
 
+    ECallSettings.vehicleType = vehicleType;
+    ECallSettings.isVehicleTypeSet = true;
+
     return LE_OK;
 }
 
@@ -4473,91 +4523,21 @@ le_result_t le_ecall_GetVehicleType
         ///< [OUT] Vehicle type
 )
 {
-    le_result_t result = LE_FAULT;
-    le_cfg_IteratorRef_t iteratorRef = NULL;
-    char  vehStr[VEHICLE_TYPE_MAX_BYTES] = {0};
-
     if (NULL == vehicleTypePtr)
     {
         LE_KILL_CLIENT("vehicleTypePtr is NULL !");
         return LE_BAD_PARAMETER;
     }
 
-    iteratorRef = le_cfg_CreateReadTxn( CFG_MODEMSERVICE_ECALL_PATH );
-
-    // Get vehicle type
-    if (le_cfg_NodeExists(iteratorRef, CFG_NODE_VEH))
-    {
-        if (le_cfg_GetString(iteratorRef, CFG_NODE_VEH, vehStr, sizeof(vehStr), "") != LE_OK)
-        {
-            LE_WARN("No node value set for '%s'", CFG_NODE_VEH);
-        }
-        else if (strlen(vehStr) > 0)
-        {
-            le_ecall_MsdVehicleType_t vehicleType;
-            LE_DEBUG("vehicle type is %s", vehStr);
-            if (VehicleTypeStringToEnum(vehStr, &vehicleType) == LE_OK)
-            {
-                *vehicleTypePtr = vehicleType;
-                result = LE_OK;
-            }
-            else
-            {
-                LE_WARN("Bad vehicle type. No match found in vehicletype");
-                result = LE_FAULT;
-            }
-        }
-    }
-    else
+    if (!ECallSettings.isVehicleTypeSet)
     {
         LE_WARN("No value set for '%s' !", CFG_NODE_VEH);
-        result = LE_FAULT;
-
-    }
-
-    le_cfg_CancelTxn( iteratorRef );
-
-    LE_DEBUG("vehicle type is %s", vehStr);
-    return result;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * The Vehicle Identification Number is defined by iso 3833 as a 17 character
- * alphanumeric code, which does not include the letters i, I, o, O, q, Q. Also
- * the letters u, U, z, Z and the digit 0 are not allowed in the model year code
- *
- */
-//--------------------------------------------------------------------------------------------------
-static int VerifyVIN
-(
-    char *vin
-)
-{
-    int ret = 0;
-    char c;
-
-    c = (char)tolower(vin[9]);
-
-    if ( ('0' == c) || ('u' == c) || ('z' == c) )
-    {
-        LE_WARN("Year digit cannot be %c", vin[9]);
-        ret = -1;
+        return LE_FAULT;
     }
 
-    while ( (*vin) && (!ret) )
-    {
-        c= (char)tolower(*vin);
-        if ( ('i' == c) || ('o' == c) || ('q' == c) )
-        {
-            LE_WARN("%c not allowed in VIN", *vin);
-            ret = -1;
-        }
+    *vehicleTypePtr = ECallSettings.vehicleType;
 
-        vin++;
-    }
-
-    return ret;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -4595,6 +4575,8 @@ le_result_t le_ecall_SetVIN
 
     le_cfg_CommitTxn(iterator);
 
+    memcpy(ECallSettings.vin, vin, sizeof(ECallSettings.vin));
+
     return LE_OK;
 }
 
@@ -4615,8 +4597,6 @@ le_result_t le_ecall_GetVIN
     size_t vinNumElements   ///< [IN]
 )
 {
-    le_cfg_IteratorRef_t iterator;
-
     if (!vin)
     {
         LE_KILL_CLIENT("vin is NULL !");
@@ -4629,35 +4609,13 @@ le_result_t le_ecall_GetVIN
         return LE_BAD_PARAMETER;
     }
 
-    iterator = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_ECALL_PATH);
-
-    // Get VIN
-    if (!le_cfg_NodeExists(iterator, CFG_NODE_VIN))
-    {
-        LE_WARN("No node value set for '%s'", CFG_NODE_VIN);
-
-        le_cfg_CancelTxn(iterator);
-
-        return LE_NOT_FOUND;
-    }
-
-    memset(vin, 0, LE_ECALL_VIN_MAX_BYTES);
-
-    le_cfg_GetString(iterator, CFG_NODE_VIN, vin, LE_ECALL_VIN_MAX_BYTES, "");
-    if (strlen(vin) != LE_ECALL_VIN_MAX_LEN)
+    if ('\0' == ECallSettings.vin[0])
     {
-        LE_DEBUG("eCall settings, VIN is set to %s", vin);
-
-        memset(vin, 0, LE_ECALL_VIN_MAX_BYTES);
-
         LE_WARN("No node value set for '%s'", CFG_NODE_VIN);
-
-        le_cfg_CancelTxn(iterator);
-
         return LE_NOT_FOUND;
     }
 
-    le_cfg_CancelTxn(iterator);
+    memcpy(vin, ECallSettings.vin, LE_ECALL_VIN_MAX_BYTES);
 
     return LE_OK;
 }
@@ -4682,6 +4640,9 @@ le_result_t le_ecall_SetPropulsionType
     char cfgNodeLoc[8] = {0};
     char configPath[LE_CFG_STR_LEN_BYTES];
     le_result_t res = LE_OK;
+    msd_VehiclePropulsionStorageType_t propulsion;
+
+    memset(&propulsion, 0, sizeof(propulsion));
 
     snprintf(configPath, sizeof(configPath), "%s/%s", CFG_MODEMSERVICE_ECALL_PATH, CFG_NODE_PROP);
 
@@ -4696,6 +4657,7 @@ le_result_t le_ecall_SetPropulsionType
         snprintf(cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
 
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Gasoline");
+        propulsion.gasolineTankPresent = true;
         i++;
     }
 
@@ -4703,6 +4665,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Diesel");
+        propulsion.dieselTankPresent = true;
         i++;
     }
 
@@ -4710,6 +4673,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "NaturalGas");
+        propulsion.compressedNaturalGas = true;
         i++;
     }
 
@@ -4717,6 +4681,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Propane");
+        propulsion.liquidPropaneGas = true;
         i++;
     }
 
@@ -4724,6 +4689,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Electric");
+        propulsion.electricEnergyStorage = true;
         i++;
     }
 
@@ -4731,6 +4697,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Hydrogen");
+        propulsion.hydrogenStorage = true;
         i++;
     }
 
@@ -4738,6 +4705,7 @@ le_result_t le_ecall_SetPropulsionType
     {
         snprintf (cfgNodeLoc, sizeof(cfgNodeLoc), "%d", i);
         le_cfg_SetString ( iteratorRef, cfgNodeLoc, "Other");
+        propulsion.otherStorage = true;
         i++;
     }
 
@@ -4750,6 +4718,9 @@ le_result_t le_ecall_SetPropulsionType
     if (LE_OK == res)
     {
         le_cfg_CommitTxn(iteratorRef);
+
+        ECallSettings.propulsion = propulsion;
+        ECallSettings.propulsionResult = LE_OK;
     }
     else
     {
@@ -4786,43 +4757,41 @@ le_result_t le_ecall_GetPropulsionType
         return LE_BAD_PARAMETER;
     }
 
-    // GetPropulsionType reads from config tree
-    // and writes a boolean values in the MSD.
-    result = GetPropulsionType();
+    result = ECallSettings.propulsionResult;
 
     if (LE_OK == result)
     {
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.gasolineTankPresent)
+        if (ECallSettings.propulsion.gasolineTankPresent)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_GASOLINE;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.dieselTankPresent)
+        if (ECallSettings.propulsion.dieselTankPresent)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_DIESEL;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.compressedNaturalGas)
+        if (ECallSettings.propulsion.compressedNaturalGas)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_NATURALGAS;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.liquidPropaneGas)
+        if (ECallSettings.propulsion.liquidPropaneGas)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_PROPANE;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.electricEnergyStorage)
+        if (ECallSettings.propulsion.electricEnergyStorage)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_ELECTRIC;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.hydrogenStorage)
+        if (ECallSettings.propulsion.hydrogenStorage)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_HYDROGEN;
         }
 
-        if (ECallObj.msd.msdMsg.msdStruct.vehPropulsionStorageType.otherStorage)
+        if (ECallSettings.propulsion.otherStorage)
         {
             resultBitMask |=  LE_ECALL_PROPULSION_TYPE_OTHER;
         }
@@ -11,6 +11,166 @@
 #include "pa_info.h"
 #include "pa_sim.h"
 #include "sysResets.h"
+#include "le_info_local.h"
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Device identity fields that don't change while the modem is running.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    IDENTITY_IMEI,
+    IDENTITY_IMEISV,
+    IDENTITY_MODEL,
+    IDENTITY_FIRMWARE_VERSION,
+    IDENTITY_BOOTLOADER_VERSION,
+    IDENTITY_MFR_NAME,
+    IDENTITY_SKU,
+    IDENTITY_PSN,
+    IDENTITY_MAX
+}
+IdentityField_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer holding a cached identity field.  The version and model strings are the
+ * longest fields.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IDENTITY_MAX_BYTES  LE_INFO_MAX_VERS_BYTES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached copy of an identity field.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isCached;                      ///< true once value holds the field.
+    char value[IDENTITY_MAX_BYTES];     ///< The field (null-terminated).
+}
+IdentityCache_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identity fields read from the PA so far.  They are read on first use, and stay cached until
+ * the modem service restarts (which it does when the modem firmware is updated).
+ */
+//--------------------------------------------------------------------------------------------------
+static IdentityCache_t IdentityCache[IDENTITY_MAX];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an identity field from the PA.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - Any other value returned by the PA on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadIdentityField
+(
+    IdentityField_t field,      ///< [IN] The field to read.
+    char* valuePtr              ///< [OUT] The field, IDENTITY_MAX_BYTES long.
+)
+{
+    switch (field)
+    {
+        case IDENTITY_IMEI:
+            return pa_info_GetImei(valuePtr);
+
+        case IDENTITY_IMEISV:
+            return pa_info_GetImeiSv(valuePtr);
+
+        case IDENTITY_MODEL:
+            return pa_info_GetDeviceModel(valuePtr);
+
+        case IDENTITY_FIRMWARE_VERSION:
+            return pa_info_GetFirmwareVersion(valuePtr, IDENTITY_MAX_BYTES);
+
+        case IDENTITY_BOOTLOADER_VERSION:
+            return pa_info_GetBootloaderVersion(valuePtr, IDENTITY_MAX_BYTES);
+
+        case IDENTITY_MFR_NAME:
+            return pa_info_GetManufacturerName(valuePtr, IDENTITY_MAX_BYTES);
+
+        case IDENTITY_SKU:
+            return pa_info_GetSku(valuePtr, IDENTITY_MAX_BYTES);
+
+        case IDENTITY_PSN:
+            return pa_info_GetPlatformSerialNumber(valuePtr, IDENTITY_MAX_BYTES);
+
+        default:
+            LE_FATAL("Invalid identity field %d", field);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an identity field, reading it from the PA only the first time it is asked for.  Failures
+ * aren't cached, so a field that isn't available yet is read again on the next call.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the field doesn't fit in the buffer
+ *      - LE_FAULT if the buffer is empty
+ *      - Any other value returned by the PA on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetIdentityField
+(
+    IdentityField_t field,      ///< [IN] The field to get.
+    char* bufPtr,               ///< [OUT] The field (null-terminated).
+    size_t bufSize              ///< [IN] Size of the buffer.
+)
+{
+    IdentityCache_t* cachePtr = &IdentityCache[field];
+
+    if (0 == bufSize)
+    {
+        LE_ERROR("parameter error");
+        return LE_FAULT;
+    }
+
+    if (!cachePtr->isCached)
+    {
+        le_result_t result = ReadIdentityField(field, cachePtr->value);
+
+        if (LE_OK != result)
+        {
+            bufPtr[0] = '\0';
+            return result;
+        }
+
+        cachePtr->value[IDENTITY_MAX_BYTES - 1] = '\0';
+        cachePtr->isCached = true;
+    }
+
+    return le_utf8_Copy(bufPtr, cachePtr->value, bufSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Internal declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the cached identity fields, so that they are read from the PA again on next use.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_ClearIdentityCache
+(
+    void
+)
+{
+    memset(IdentityCache, 0, sizeof(IdentityCache));
+}
 
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
@@ -34,29 +194,22 @@ le_result_t le_info_GetImei
     size_t           len       ///< [IN] The length of IMEI string.
 )
 {
-    pa_info_Imei_t imei = {0};
+    le_result_t result;
 
     if (imeiPtr == NULL)
     {
         LE_KILL_CLIENT("imeiPtr is NULL !");
         return LE_FAULT;
     }
-    if (0 == len)
-    {
-        LE_ERROR("parameter error");
-        return LE_FAULT;
-    }
 
-    if(pa_info_GetImei(imei) != LE_OK)
+    result = GetIdentityField(IDENTITY_IMEI, imeiPtr, len);
+    if ((LE_OK != result) && (LE_OVERFLOW != result))
     {
         LE_ERROR("Failed to get the IMEI");
-        imeiPtr[0] = '\0';
         return LE_FAULT;
     }
-    else
-    {
-        return (le_utf8_Copy(imeiPtr, imei, len, NULL));
-    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -78,29 +231,22 @@ le_result_t le_info_GetImeiSv
     size_t imeiSvNumElements    ///< [IN] The length of IMEISV string.
 )
 {
-    pa_info_ImeiSv_t imeiSv = {0};
+    le_result_t result;
 
     if (imeiSvPtr == NULL)
     {
         LE_KILL_CLIENT("imeiSvPtr is NULL !");
         return LE_FAULT;
     }
-    if (0 == imeiSvNumElements)
-    {
-        LE_ERROR("parameter error");
-        return LE_FAULT;
-    }
 
-    if (pa_info_GetImeiSv(imeiSv) != LE_OK)
+    result = GetIdentityField(IDENTITY_IMEISV, imeiSvPtr, imeiSvNumElements);
+    if ((LE_OK != result) && (LE_OVERFLOW != result))
     {
         LE_ERROR("Failed to get the IMEISV");
-        imeiSvPtr[0] = '\0';
         return LE_FAULT;
     }
-    else
-    {
-        return (le_utf8_Copy(imeiSvPtr, imeiSv, imeiSvNumElements, NULL));
-    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -133,12 +279,7 @@ le_result_t le_info_GetFirmwareVersion
         LE_KILL_CLIENT("versionPtr is NULL !");
         return LE_FAULT;
     }
-    if (versionNumElements == 0)
-    {
-        LE_ERROR("parameter error");
-        return LE_FAULT;
-    }
-    return pa_info_GetFirmwareVersion(versionPtr, versionNumElements);
+    return GetIdentityField(IDENTITY_FIRMWARE_VERSION, versionPtr, versionNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -209,12 +350,7 @@ le_result_t le_info_GetBootloaderVersion
         LE_KILL_CLIENT("versionPtr is NULL !");
         return LE_FAULT;
     }
-    if (versionNumElements == 0)
-    {
-        LE_ERROR("parameter error");
-        return LE_FAULT;
-    }
-    return pa_info_GetBootloaderVersion(versionPtr, versionNumElements);
+    return GetIdentityField(IDENTITY_BOOTLOADER_VERSION, versionPtr, versionNumElements);
 }
 
 
@@ -237,7 +373,7 @@ le_result_t le_info_GetDeviceModel
         ///< [IN] The length of Model identity string.
 )
 {
-    pa_info_DeviceModel_t modelVersion;
+    le_result_t result;
 
     if(modelPtr == NULL)
     {
@@ -245,22 +381,14 @@ le_result_t le_info_GetDeviceModel
         return LE_FAULT;
     }
 
-    if (0 == modelNumElements)
-    {
-        LE_ERROR("parameter error");
-        return LE_FAULT;
-    }
-
-    if(pa_info_GetDeviceModel(modelVersion) != LE_OK)
+    result = GetIdentityField(IDENTITY_MODEL, modelPtr, modelNumElements);
+    if ((LE_OK != result) && (LE_OVERFLOW != result))
     {
         LE_ERROR("Failed to get the device model");
-        modelPtr[0] = '\0';
         return LE_FAULT;
     }
-    else
-    {
-        return (le_utf8_Copy(modelPtr, modelVersion, modelNumElements, NULL));
-    }
+
+    return result;
 }
 
 
@@ -504,7 +632,7 @@ le_result_t le_info_GetManufacturerName
         return LE_FAULT;
     }
 
-    return pa_info_GetManufacturerName(mfrNameStr, mfrNameStrNumElements);
+    return GetIdentityField(IDENTITY_MFR_NAME, mfrNameStr, mfrNameStrNumElements);
 }
 
 
@@ -628,7 +756,7 @@ le_result_t le_info_GetSku
         return LE_FAULT;
     }
 
-    return pa_info_GetSku(skuIdStr, skuIdStrNumElements);
+    return GetIdentityField(IDENTITY_SKU, skuIdStr, skuIdStrNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -657,8 +785,8 @@ le_result_t le_info_GetPlatformSerialNumber
         return LE_FAULT;
     }
 
-    return pa_info_GetPlatformSerialNumber(platformSerialNumberStr,
-                    platformSerialNumberStrNumElements);
+    return GetIdentityField(IDENTITY_PSN, platformSerialNumberStr,
+                            platformSerialNumberStrNumElements);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -794,3 +922,100 @@ le_result_t le_info_GetUnexpectedResetsCount
 
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the device identity fields that don't change while the modem is running, in one call.
+ *
+ * A field that can't be read is returned as an empty string.
+ *
+ * @return
+ *      - LE_OK             At least one field was retrieved.
+ *      - LE_OVERFLOW       A field doesn't fit in the buffer provided for it.
+ *      - LE_FAULT          None of the fields could be retrieved.
+ *
+ * @note If the caller passes a bad pointer into this function, it's a fatal error; the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_info_GetDeviceIdentity
+(
+    char* imeiPtr,                      ///< [OUT] IMEI string.
+    size_t imeiSize,                    ///< [IN]
+    char* imeiSvPtr,                    ///< [OUT] IMEISV string.
+    size_t imeiSvSize,                  ///< [IN]
+    char* modelPtr,                     ///< [OUT] Device model string.
+    size_t modelSize,                   ///< [IN]
+    char* firmwareVersionPtr,           ///< [OUT] Firmware version string.
+    size_t firmwareVersionSize,         ///< [IN]
+    char* bootloaderVersionPtr,         ///< [OUT] Bootloader version string.
+    size_t bootloaderVersionSize,       ///< [IN]
+    char* mfrNamePtr,                   ///< [OUT] Manufacturer name string.
+    size_t mfrNameSize,                 ///< [IN]
+    char* skuIdPtr,                     ///< [OUT] Product SKU ID string.
+    size_t skuIdSize,                   ///< [IN]
+    char* platformSerialNumberPtr,      ///< [OUT] Platform Serial Number string.
+    size_t platformSerialNumberSize     ///< [IN]
+)
+{
+    char* bufPtrs[IDENTITY_MAX] =
+    {
+        [IDENTITY_IMEI]               = imeiPtr,
+        [IDENTITY_IMEISV]             = imeiSvPtr,
+        [IDENTITY_MODEL]              = modelPtr,
+        [IDENTITY_FIRMWARE_VERSION]   = firmwareVersionPtr,
+        [IDENTITY_BOOTLOADER_VERSION] = bootloaderVersionPtr,
+        [IDENTITY_MFR_NAME]           = mfrNamePtr,
+        [IDENTITY_SKU]                = skuIdPtr,
+        [IDENTITY_PSN]                = platformSerialNumberPtr,
+    };
+    const size_t bufSizes[IDENTITY_MAX] =
+    {
+        [IDENTITY_IMEI]               = imeiSize,
+        [IDENTITY_IMEISV]             = imeiSvSize,
+        [IDENTITY_MODEL]              = modelSize,
+        [IDENTITY_FIRMWARE_VERSION]   = firmwareVersionSize,
+        [IDENTITY_BOOTLOADER_VERSION] = bootloaderVersionSize,
+        [IDENTITY_MFR_NAME]           = mfrNameSize,
+        [IDENTITY_SKU]                = skuIdSize,
+        [IDENTITY_PSN]                = platformSerialNumberSize,
+    };
+    bool isOverflow = false;
+    int numRead = 0;
+    int field;
+
+    for (field = 0; field < IDENTITY_MAX; field++)
+    {
+        if (NULL == bufPtrs[field])
+        {
+            LE_KILL_CLIENT("Identity field %d buffer is NULL!", field);
+            return LE_FAULT;
+        }
+    }
+
+    for (field = 0; field < IDENTITY_MAX; field++)
+    {
+        le_result_t result = GetIdentityField(field, bufPtrs[field], bufSizes[field]);
+
+        if (LE_OK == result)
+        {
+            numRead++;
+        }
+        else if (LE_OVERFLOW == result)
+        {
+            isOverflow = true;
+        }
+    }
+
+    if (isOverflow)
+    {
+        return LE_OVERFLOW;
+    }
+    if (0 == numRead)
+    {
+        LE_ERROR("Failed to get the device identity");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
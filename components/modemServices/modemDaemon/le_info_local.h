@@ -0,0 +1,19 @@
+/** @file le_info_local.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LEINFO_LOCAL_INCLUDE_GUARD
+#define LEGATO_LEINFO_LOCAL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the cached device identity fields, so that they are read from the PA again on next use.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_info_ClearIdentityCache
+(
+    void
+);
+
+#endif // LEGATO_LEINFO_LOCAL_INCLUDE_GUARD
@@ -11,6 +11,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_ips.h"
+#include "sampler.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -19,6 +20,14 @@
 //--------------------------------------------------------------------------------------------------
 #define BATTERY_LEVEL_MAX   100
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kind and name of the sampler source of the input voltage.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLER_KIND        "ips"
+#define SAMPLER_NAME        "inputVoltage"
+
 //--------------------------------------------------------------------------------------------------
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
@@ -38,6 +47,13 @@ static le_event_Id_t VoltageThresholdEventId;
 //--------------------------------------------------------------------------------------------------
 static uint8_t ExternalBatteryLevel = BATTERY_LEVEL_MAX + 1;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampler source of the input voltage.
+ */
+//--------------------------------------------------------------------------------------------------
+static sampler_SourceRef_t VoltageSourceRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer Input Voltage Change Handler.
@@ -72,6 +88,79 @@ static void VoltageChangeHandler
     le_event_ReportWithRefCounting(VoltageThresholdEventId, thresholdEventPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the input voltage for the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SampleInputVoltage
+(
+    const char* namePtr,    ///< [IN] Name of the source.
+    int32_t* valuePtr       ///< [OUT] The input voltage in [mV].
+)
+{
+    uint32_t inputVoltage;
+    le_result_t result = pa_ips_GetInputVoltage(&inputVoltage);
+
+    if (LE_OK == result)
+    {
+        *valuePtr = (int32_t)inputVoltage;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleThreshold handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallThresholdHandler
+(
+    sampler_Level_t level,
+    int32_t value,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_ips_SampleThresholdHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc((le_ips_SampleLevel_t)level, (uint32_t)value, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleWindow handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallWindowHandler
+(
+    int32_t minValue,
+    int32_t maxValue,
+    int32_t avgValue,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_ips_SampleWindowHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc((uint32_t)minValue, (uint32_t)maxValue, (uint32_t)avgValue, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close session handler: remove the sampling handlers of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Message session reference.
+    void* contextPtr                ///< [IN] Context pointer.
+)
+{
+    sampler_RemoveSessionMonitors(sessionRef);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
@@ -219,6 +308,110 @@ void le_ips_RemoveThresholdEventHandler
     le_event_RemoveHandler((le_event_HandlerRef_t) addHandlerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_ips_SampleThreshold'
+ *
+ * This event reports the level of the input voltage sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_ips_SampleThresholdHandlerRef_t le_ips_AddSampleThresholdHandler
+(
+    uint32_t lowThreshold,                          ///< [IN] Low threshold in [mV].
+    uint32_t highThreshold,                         ///< [IN] High threshold in [mV].
+    uint32_t hysteresis,                            ///< [IN] Hysteresis in [mV].
+    le_ips_SampleThresholdHandlerFunc_t handlerPtr, ///< [IN] The handler function.
+    void* contextPtr                                ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    if ((lowThreshold > INT32_MAX) || (highThreshold > INT32_MAX))
+    {
+        LE_ERROR("Thresholds %"PRIu32" and %"PRIu32" mV are out of range",
+                 lowThreshold, highThreshold);
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddThresholdMonitor(VoltageSourceRef,
+                                                                  (int32_t)lowThreshold,
+                                                                  (int32_t)highThreshold,
+                                                                  hysteresis,
+                                                                  CallThresholdHandler,
+                                                                  handlerPtr,
+                                                                  contextPtr,
+                                                                  le_ips_GetClientSessionRef());
+
+    return (le_ips_SampleThresholdHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_ips_SampleThreshold'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ips_RemoveSampleThresholdHandler
+(
+    le_ips_SampleThresholdHandlerRef_t handlerRef   ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_ips_SampleWindow'
+ *
+ * This event reports the minimum, maximum and average of every windowSamples samples of the
+ * input voltage sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_ips_SampleWindowHandlerRef_t le_ips_AddSampleWindowHandler
+(
+    uint32_t windowSamples,                         ///< [IN] Number of samples in a window.
+    le_ips_SampleWindowHandlerFunc_t handlerPtr,    ///< [IN] The handler function.
+    void* contextPtr                                ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddWindowMonitor(VoltageSourceRef,
+                                                               windowSamples,
+                                                               CallWindowHandler,
+                                                               handlerPtr,
+                                                               contextPtr,
+                                                               le_ips_GetClientSessionRef());
+
+    return (le_ips_SampleWindowHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_ips_SampleWindow'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ips_RemoveSampleWindowHandler
+(
+    le_ips_SampleWindowHandlerRef_t handlerRef      ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the Platform power source.
@@ -333,4 +526,7 @@ void le_ips_Init
 
     // Register a handler function for new input voltage Threshold Event
     pa_ips_AddVoltageEventHandler(VoltageChangeHandler);
+
+    VoltageSourceRef = sampler_GetSource(SAMPLER_KIND, SAMPLER_NAME, SampleInputVoltage);
+    le_msg_AddServiceCloseHandler(le_ips_GetServiceRef(), CloseSessionEventHandler, NULL);
 }
@@ -60,6 +60,7 @@ typedef struct le_mcc_Call
     int32_t                         terminationCode;   ///< Platform specific termination code
     pa_mcc_clir_t                   clirStatus;        ///< Call CLIR status
     bool                            inProgress;        ///< call in progress
+    bool                            isIncoming;        ///< incoming call
     int16_t                         refCount;          ///< ref count
     le_dls_List_t                   creatorList;       ///< Clients sessionRef list
     le_dls_Link_t                   link;              ///< link for CallList
@@ -117,6 +118,7 @@ typedef struct
 {
     le_mcc_CallEventHandlerRef_t  handlerRef;      ///< handler reference
     le_mcc_CallEventHandlerFunc_t handlerFuncPtr;  ///< handler function
+    le_mcc_CallStateHandlerFunc_t stateHandlerFuncPtr; ///< call state handler function
     void*                         userContext;     ///< user context
     SessionCtxNode_t*             sessionCtxPtr;   ///< session context relative to this handler ctx
     le_dls_Link_t                 link;            ///< link for handlerList
@@ -317,6 +319,7 @@ static le_mcc_Call_t* CreateCallObject
     callPtr->terminationCode = terminationCode;
     callPtr->clirStatus = PA_MCC_NO_CLIR;
     callPtr->inProgress = false;
+    callPtr->isIncoming = false;
     callPtr->refCount = 1;
     callPtr->creatorList=LE_DLS_LIST_INIT;
     callPtr->link = LE_DLS_LINK_INIT;
@@ -626,9 +629,22 @@ static void CallHandlers
                                             sessionCtxPtr->sessionRef,
                                             callRef);
 
-                    handlerCtxPtr->handlerFuncPtr( callRef,
-                                                   callPtr->event,
-                                                   handlerCtxPtr->userContext );
+                    if (handlerCtxPtr->stateHandlerFuncPtr)
+                    {
+                        handlerCtxPtr->stateHandlerFuncPtr( callRef,
+                                                            callPtr->event,
+                                                            callPtr->telNumber,
+                                                            callPtr->isIncoming,
+                                                            callPtr->termination,
+                                                            callPtr->terminationCode,
+                                                            handlerCtxPtr->userContext );
+                    }
+                    else
+                    {
+                        handlerCtxPtr->handlerFuncPtr( callRef,
+                                                       callPtr->event,
+                                                       handlerCtxPtr->userContext );
+                    }
                 }
             }
             else
@@ -777,6 +793,9 @@ static void NewCallEventHandler
                                         dataPtr->terminationEvent,
                                         dataPtr->terminationCode);
 
+            // A call unknown by MCC is created by the network
+            callPtr->isIncoming = ((LE_MCC_EVENT_INCOMING == dataPtr->event) ||
+                                   (LE_MCC_EVENT_WAITING == dataPtr->event));
             newCall = true;
         }
         else if (-1 == callPtr->callId)
@@ -914,6 +933,135 @@ static void CloseSessionEventHandler
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler context to the client session: either a call event handler or a call state
+ * handler.
+ *
+ * @return A reference to the new handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mcc_CallEventHandlerRef_t AddHandlerCtx
+(
+    le_mcc_CallEventHandlerFunc_t handlerFuncPtr,       ///< [IN] The event handler function.
+    le_mcc_CallStateHandlerFunc_t stateHandlerFuncPtr,  ///< [IN] The state handler function.
+    void*                         contextPtr            ///< [IN] The handlers context.
+)
+{
+    // search the sessionCtx; create it if doesn't exist
+    SessionCtxNode_t* sessionCtxPtr = GetSessionCtx(le_mcc_GetClientSessionRef());
+
+    if (!sessionCtxPtr)
+    {
+        // Create the session context
+        sessionCtxPtr = CreateSessionCtx();
+    }
+
+    // Add the handler in the list
+    HandlerCtxNode_t * handlerCtxPtr = le_mem_ForceAlloc(HandlerPool);
+    handlerCtxPtr->handlerFuncPtr = handlerFuncPtr;
+    handlerCtxPtr->stateHandlerFuncPtr = stateHandlerFuncPtr;
+    handlerCtxPtr->userContext = contextPtr;
+    handlerCtxPtr->handlerRef = le_ref_CreateRef(HandlerRefMap, handlerCtxPtr);
+    handlerCtxPtr->sessionCtxPtr = sessionCtxPtr;
+    handlerCtxPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&sessionCtxPtr->handlerList, &handlerCtxPtr->link);
+
+    return handlerCtxPtr->handlerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a handler context from its client session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveHandlerCtx
+(
+    le_mcc_CallEventHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
+)
+{
+    // Get the hander context
+    HandlerCtxNode_t* handlerCtxPtr = le_ref_Lookup(HandlerRefMap, handlerRef);
+
+    if (handlerCtxPtr == NULL)
+    {
+        LE_ERROR("Invalid reference (%p) provided!", handlerRef);
+        return;
+    }
+
+    // Invalidate the Safe Reference.
+    le_ref_DeleteRef(HandlerRefMap, handlerRef);
+
+    SessionCtxNode_t* sessionCtxPtr = handlerCtxPtr->sessionCtxPtr;
+
+    if (!sessionCtxPtr)
+    {
+        LE_ERROR("No sessionCtxPtr !!!");
+        return;
+    }
+
+    // Remove the handler node from the session context
+    le_dls_Remove(&(sessionCtxPtr->handlerList), &(handlerCtxPtr->link));
+    le_mem_Release(handlerCtxPtr);
+
+    // if no more handler, clean the session context
+    if (le_dls_NumLinks(&sessionCtxPtr->handlerList) == 0 )
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&sessionCtxPtr->callRefList);
+        bool deleteSessionCtx = true;
+
+        // Iterate on all call associated with this session
+        while( linkPtr )
+        {
+            CallRefNode_t* CallRefPtr = CONTAINER_OF( linkPtr,
+                                                      CallRefNode_t,
+                                                      link);
+            linkPtr = le_dls_PeekNext(&sessionCtxPtr->callRefList, linkPtr);
+
+            le_mcc_Call_t* callPtr = le_ref_Lookup(MccCallRefMap, CallRefPtr->callRef);
+
+            if (callPtr)
+            {
+                // If the callRef was created by another client, we need to remove a reference on this
+                // callRef
+                if ( !IsCallCreatedByClient(callPtr, sessionCtxPtr->sessionRef) )
+                {
+                    le_ref_DeleteRef(MccCallRefMap, CallRefPtr->callRef);
+                    le_dls_Remove(&sessionCtxPtr->callRefList, &(CallRefPtr->link));
+                    le_mem_Release(CallRefPtr);
+
+                    callPtr->refCount--;
+                    LE_DEBUG("Release call %p countRef %d", callPtr, callPtr->refCount);
+
+                    LE_FATAL_IF((callPtr->refCount < 0),
+                                "Error Release call %p, refCount %d",
+                                callPtr, callPtr->refCount);
+
+                    le_mem_Release(callPtr);
+                }
+                else
+                {
+                    // a call was created by this client, do not delete its session context
+                    LE_DEBUG("Delete the session context");
+                    deleteSessionCtx = false;
+                }
+            }
+            else
+            {
+                LE_ERROR("No valid callPtr !!!");
+            }
+        }
+
+        if (deleteSessionCtx)
+        {
+            le_dls_Remove(&SessionCtxList, &(sessionCtxPtr->link));
+            le_mem_Release(sessionCtxPtr);
+        }
+    }
+
+}
+
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
 //--------------------------------------------------------------------------------------------------
@@ -1525,26 +1673,7 @@ le_mcc_CallEventHandlerRef_t le_mcc_AddCallEventHandler
         return NULL;
     }
 
-    // search the sessionCtx; create it if doesn't exist
-    SessionCtxNode_t* sessionCtxPtr = GetSessionCtx(le_mcc_GetClientSessionRef());
-
-    if (!sessionCtxPtr)
-    {
-        // Create the session context
-        sessionCtxPtr = CreateSessionCtx();
-    }
-
-    // Add the handler in the list
-    HandlerCtxNode_t * handlerCtxPtr = le_mem_ForceAlloc(HandlerPool);
-    handlerCtxPtr->handlerFuncPtr = handlerFuncPtr;
-    handlerCtxPtr->userContext = contextPtr;
-    handlerCtxPtr->handlerRef = le_ref_CreateRef(HandlerRefMap, handlerCtxPtr);
-    handlerCtxPtr->sessionCtxPtr = sessionCtxPtr;
-    handlerCtxPtr->link = LE_DLS_LINK_INIT;
-
-    le_dls_Queue(&sessionCtxPtr->handlerList, &handlerCtxPtr->link);
-
-    return handlerCtxPtr->handlerRef;
+    return AddHandlerCtx(handlerFuncPtr, NULL, contextPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1560,85 +1689,50 @@ void le_mcc_RemoveCallEventHandler
     le_mcc_CallEventHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
 )
 {
-    // Get the hander context
-    HandlerCtxNode_t* handlerCtxPtr = le_ref_Lookup(HandlerRefMap, handlerRef);
-
-    if (handlerCtxPtr == NULL)
-    {
-        LE_ERROR("Invalid reference (%p) provided!", handlerRef);
-        return;
-    }
-
-    // Invalidate the Safe Reference.
-    le_ref_DeleteRef(HandlerRefMap, handlerRef);
-
-    SessionCtxNode_t* sessionCtxPtr = handlerCtxPtr->sessionCtxPtr;
+    RemoveHandlerCtx(handlerRef);
+}
 
-    if (!sessionCtxPtr)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_mcc_CallState'
+ *
+ * Register an event handler that will be notified when an event occurs on call, with the state of
+ * the call.
+ *
+ * @return A reference to the new event handler object.
+ *
+ * @note It is a fatal error if this function does succeed.  If this function fails, it will not
+ *       return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mcc_CallStateHandlerRef_t le_mcc_AddCallStateHandler
+(
+    le_mcc_CallStateHandlerFunc_t       handlerFuncPtr, ///< [IN] The event handler function.
+    void*                               contextPtr      ///< [IN] The handlers context.
+)
+{
+    if (handlerFuncPtr == NULL)
     {
-        LE_ERROR("No sessionCtxPtr !!!");
-        return;
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
     }
 
-    // Remove the handler node from the session context
-    le_dls_Remove(&(sessionCtxPtr->handlerList), &(handlerCtxPtr->link));
-    le_mem_Release(handlerCtxPtr);
-
-    // if no more handler, clean the session context
-    if (le_dls_NumLinks(&sessionCtxPtr->handlerList) == 0 )
-    {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&sessionCtxPtr->callRefList);
-        bool deleteSessionCtx = true;
-
-        // Iterate on all call associated with this session
-        while( linkPtr )
-        {
-            CallRefNode_t* CallRefPtr = CONTAINER_OF( linkPtr,
-                                                      CallRefNode_t,
-                                                      link);
-            linkPtr = le_dls_PeekNext(&sessionCtxPtr->callRefList, linkPtr);
-
-            le_mcc_Call_t* callPtr = le_ref_Lookup(MccCallRefMap, CallRefPtr->callRef);
-
-            if (callPtr)
-            {
-                // If the callRef was created by another client, we need to remove a reference on this
-                // callRef
-                if ( !IsCallCreatedByClient(callPtr, sessionCtxPtr->sessionRef) )
-                {
-                    le_ref_DeleteRef(MccCallRefMap, CallRefPtr->callRef);
-                    le_dls_Remove(&sessionCtxPtr->callRefList, &(CallRefPtr->link));
-                    le_mem_Release(CallRefPtr);
-
-                    callPtr->refCount--;
-                    LE_DEBUG("Release call %p countRef %d", callPtr, callPtr->refCount);
-
-                    LE_FATAL_IF((callPtr->refCount < 0),
-                                "Error Release call %p, refCount %d",
-                                callPtr, callPtr->refCount);
-
-                    le_mem_Release(callPtr);
-                }
-                else
-                {
-                    // a call was created by this client, do not delete its session context
-                    LE_DEBUG("Delete the session context");
-                    deleteSessionCtx = false;
-                }
-            }
-            else
-            {
-                LE_ERROR("No valid callPtr !!!");
-            }
-        }
-
-        if (deleteSessionCtx)
-        {
-            le_dls_Remove(&SessionCtxList, &(sessionCtxPtr->link));
-            le_mem_Release(sessionCtxPtr);
-        }
-    }
+    return (le_mcc_CallStateHandlerRef_t)AddHandlerCtx(NULL, handlerFuncPtr, contextPtr);
+}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the registered call state handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mcc_RemoveCallStateHandler
+(
+    le_mcc_CallStateHandlerRef_t handlerRef   ///< [IN] The handler object to remove.
+)
+{
+    RemoveHandlerCtx((le_mcc_CallEventHandlerRef_t)handlerRef);
 }
 
 //--------------------------------------------------------------------------------------------------
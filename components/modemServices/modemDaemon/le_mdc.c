@@ -8,10 +8,12 @@
  */
 
 
+#include <endian.h>
+#include <sys/mman.h>
+
 #include "legato.h"
 #include "interfaces.h"
 #include "le_print.h"
-#include "jansson.h"
 #include "mdmCfgEntries.h"
 #include "pa_mdc.h"
 #include "le_ms_local.h"
@@ -23,19 +25,29 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The file to read for the APN.
+ * The APN index files to search for the default APN.  These are compiled from the JSON APN
+ * databases at build time by components/modemServices/apnIndex/mkApnIndex.py.
  */
 //--------------------------------------------------------------------------------------------------
 #ifdef LEGATO_EMBEDDED
 #define APN_IIN_FILE    \
-    "/legato/systems/current/apps/modemService/read-only/usr/local/share/apns-iin.json"
+    "/legato/systems/current/apps/modemService/read-only/usr/local/share/apns-iin.idx"
 #define APN_MCCMNC_FILE \
-    "/legato/systems/current/apps/modemService/read-only/usr/local/share/apns-mccmnc.json"
+    "/legato/systems/current/apps/modemService/read-only/usr/local/share/apns-mccmnc.idx"
 #else
 #define APN_IIN_FILE    le_arg_GetArg(0)
 #define APN_MCCMNC_FILE le_arg_GetArg(1)
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * APN index file format (see mkApnIndex.py).  All integers are little-endian.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APN_INDEX_MAGIC         "LAPN"
+#define APN_INDEX_VERSION       1
+#define APN_INDEX_KEY_BYTES     16
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum number of profile objects supported
@@ -43,6 +55,21 @@
 //--------------------------------------------------------------------------------------------------
 #define LE_MDC_MAX_PROFILE_INDEX            16
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval in seconds between two retrievals of the data counters, while data usage handlers are
+ * registered and a data session is connected
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_USAGE_POLL_INTERVAL            10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of data usage handlers
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_USAGE_HANDLER_DEFAULT_POOL_SIZE    2
+
 //--------------------------------------------------------------------------------------------------
 /**
  * MDC command Type.
@@ -90,10 +117,90 @@ typedef struct
 }
 CmdRequest_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data counters reported to the data usage handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t rxBytes;                           ///< Received bytes since the last reset.
+    uint64_t txBytes;                           ///< Transmitted bytes since the last reset.
+}
+DataUsage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data usage handler context.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mdc_DataUsageHandlerFunc_t handlerFuncPtr;   ///< Handler function.
+    void*                         handlerCtxPtr;    ///< Handler's context.
+    uint64_t                      threshold;        ///< Bytes amount between notifications.
+    uint64_t                      notifiedBytes;    ///< Bytes amount at the last notification.
+    le_event_HandlerRef_t         handlerRef;       ///< Event handler reference.
+    le_msg_SessionRef_t           sessionRef;       ///< Client session reference.
+    le_dls_Link_t                 link;             ///< Link in the data usage handlers list.
+}
+DataUsageHandlerCtx_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * APN index file header.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     magic[4];                          ///< APN_INDEX_MAGIC.
+    uint16_t version;                           ///< APN_INDEX_VERSION.
+    uint16_t maxKeyLength;                      ///< Length of the longest key.
+    uint32_t recordCount;                       ///< Number of records following the header.
+    uint32_t stringsOffset;                     ///< Offset of the string table in the file.
+}
+ApnIndexHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * APN index record.  The records follow the header, sorted by key.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     key[APN_INDEX_KEY_BYTES];          ///< "MCC:MNC" or IIN, null-padded.
+    uint32_t order;                             ///< Position of the entry in the APN database.
+    uint32_t apnOffset;                         ///< Offset of the APN in the string table.
+}
+ApnIndexRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * APN index file mapped into memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const ApnIndexRecord_t* recordsPtr;         ///< Records, or NULL if not mapped yet.
+    size_t                  recordCount;        ///< Number of records.
+    size_t                  maxKeyLength;       ///< Length of the longest key.
+    const char*             stringsPtr;         ///< String table.
+    size_t                  stringsSize;        ///< Size of the string table.
+}
+ApnIndex_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * APN indexes, mapped the first time they are searched.
+ */
+//--------------------------------------------------------------------------------------------------
+static ApnIndex_t IinApnIndex;
+static ApnIndex_t MccMncApnIndex;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data statistics
@@ -101,6 +208,35 @@ CmdRequest_t;
 //--------------------------------------------------------------------------------------------------
 static pa_mdc_PktStatistics_t DataStatistics;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last data counters retrieved for the data usage handlers
+ */
+//--------------------------------------------------------------------------------------------------
+static DataUsage_t LastDataUsage;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID for data usage notification.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t DataUsageEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer used to retrieve the data counters for the data usage handlers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t DataUsageTimerRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool and the list for data usage handler contexts
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DataUsageHandlerPool;
+static le_dls_List_t DataUsageHandlerList = LE_DLS_LIST_INIT;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * MT-PDP change handler counter
@@ -360,202 +496,262 @@ static le_mdc_ProfileRef_t CreateModemProfile
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will attempt to read APN definition for MCC/MNC in file apnFilePtr
+ *  This function maps an APN index file into memory, if it isn't mapped already.  The mapping is
+ *  kept for the life of the process.
  *
- * @return LE_OK        Function was able to find an APN
- * @return LE_NOT_FOUND Function was not able to find an APN for this (MCC,MNC)
- * @return LE_FAULT     There was an issue with the APN source
+ * @return LE_OK        The index is mapped
+ * @return LE_FAULT     The file could not be mapped or is not a valid APN index
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t FindApnWithMccMncFromFile
+static le_result_t MapApnIndex
 (
-    const char* apnFilePtr, ///< [IN]  apn file
-    const char* mccPtr,     ///< [IN]  mcc
-    const char* mncPtr,     ///< [IN]  mnc
-    char * mccMncApnPtr,    ///< [OUT] apn for mcc/mnc
-    size_t mccMncApnSize    ///< [IN]  size of mccMncApn buffer
+    const char* apnFilePtr, ///< [IN]  apn index file
+    ApnIndex_t* indexPtr    ///< [OUT] mapped index
 )
 {
-    le_result_t result = LE_FAULT;
-    json_t *root, *apns, *apnArray;
-    json_error_t error;
-    int i;
+    if (NULL != indexPtr->recordsPtr)
+    {
+        return LE_OK;
+    }
 
-    root = json_load_file(apnFilePtr, 0, &error);
-    if (NULL == root)
+    int fd = open(apnFilePtr, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd)
     {
-        LE_WARN("Document not parsed successfully (error '%s')", error.text);
-        return result;
+        LE_WARN("Unable to open '%s' (%m)", apnFilePtr);
+        return LE_FAULT;
     }
 
-    apns = json_object_get(root, "apns");
-    if (!json_is_object(apns))
+    struct stat fileInfo;
+    if ((-1 == fstat(fd, &fileInfo)) || (fileInfo.st_size < sizeof(ApnIndexHeader_t)))
     {
-        LE_WARN("apns is not an object");
-        json_decref(root);
-        return result;
+        LE_WARN("'%s' is not a valid APN index", apnFilePtr);
+        close(fd);
+        return LE_FAULT;
     }
 
-    apnArray = json_object_get(apns, "apn");
-    if (!json_is_array(apnArray))
+    size_t fileSize = fileInfo.st_size;
+    const uint8_t* basePtr = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == basePtr)
     {
-        LE_WARN("apns is not an array");
-        json_decref(root);
-        return result;
+        LE_WARN("Unable to map '%s' (%m)", apnFilePtr);
+        return LE_FAULT;
     }
 
-    result = LE_NOT_FOUND;
+    const ApnIndexHeader_t* headerPtr = (const ApnIndexHeader_t*)basePtr;
+    size_t recordCount = le32toh(headerPtr->recordCount);
+    size_t stringsOffset = le32toh(headerPtr->stringsOffset);
 
-    for (i = 0; i < json_array_size(apnArray); i++)
+    // The string table must be null-terminated so no lookup can run off the end of the file.
+    if (   (0 != memcmp(headerPtr->magic, APN_INDEX_MAGIC, sizeof(headerPtr->magic)))
+        || (APN_INDEX_VERSION != le16toh(headerPtr->version))
+        || (stringsOffset != sizeof(ApnIndexHeader_t) + (recordCount * sizeof(ApnIndexRecord_t)))
+        || (stringsOffset >= fileSize)
+        || ('\0' != basePtr[fileSize - 1])
+       )
     {
-        json_t *data, *mcc, *mnc, *apn, *type;
-        const char* mccRead;
-        const char* mncRead;
-        const char* apnRead;
-        const char* typeRead;
+        LE_WARN("'%s' is not a valid APN index", apnFilePtr);
+        munmap((void*)basePtr, fileSize);
+        return LE_FAULT;
+    }
 
-        data = json_array_get(apnArray, i);
-        if (!json_is_object(data))
-        {
-            LE_WARN("data %d is not an object", i);
-            result = LE_FAULT;
-            break;
-        }
+    indexPtr->recordsPtr = (const ApnIndexRecord_t*)(basePtr + sizeof(ApnIndexHeader_t));
+    indexPtr->recordCount = recordCount;
+    indexPtr->maxKeyLength = le16toh(headerPtr->maxKeyLength);
+    indexPtr->stringsPtr = (const char*)basePtr + stringsOffset;
+    indexPtr->stringsSize = fileSize - stringsOffset;
+
+    return LE_OK;
+}
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function searches an APN index for a key, using a binary search.
+ *
+ * @return Pointer to the record for the key, or NULL if the key is not in the index.
+ */
+// -------------------------------------------------------------------------------------------------
+static const ApnIndexRecord_t* FindApnIndexRecord
+(
+    const ApnIndex_t* indexPtr, ///< [IN]  apn index
+    const char* keyPtr,         ///< [IN]  key to search for
+    size_t keyLength            ///< [IN]  length of the key
+)
+{
+    size_t low = 0;
+    size_t high = indexPtr->recordCount;
 
-        mcc = json_object_get(data, "@mcc");
-        mccRead = json_string_value(mcc);
+    if ((0 == keyLength) || (keyLength >= APN_INDEX_KEY_BYTES))
+    {
+        return NULL;
+    }
 
-        mnc = json_object_get(data, "@mnc");
-        mncRead = json_string_value(mnc);
+    while (low < high)
+    {
+        size_t middle = low + ((high - low) / 2);
+        const ApnIndexRecord_t* recordPtr = &indexPtr->recordsPtr[middle];
 
-        type = json_object_get(data, "@type");
-        if (!json_is_string(type))
+        // Keys are null-padded, so comparing the key's terminator as well gives an exact match.
+        int comparison = memcmp(keyPtr, recordPtr->key, keyLength);
+        if (0 == comparison)
+        {
+            comparison = ('\0' == recordPtr->key[keyLength]) ? 0 : -1;
+        }
+
+        if (0 == comparison)
+        {
+            return recordPtr;
+        }
+        else if (comparison < 0)
         {
-            // No type set for this carrier, set it to "default"
-            typeRead = "default";
+            high = middle;
         }
         else
         {
-            typeRead = json_string_value(type);
+            low = middle + 1;
         }
+    }
 
-        if (   (NULL != strstr(typeRead, "default"))    // Consider only "default" type for APN
-            && !(strcmp(mccRead, mccPtr))
-            && !(strcmp(mncRead, mncPtr))
-           )
-        {
-            apn = json_object_get(data, "@apn");
-            apnRead = json_string_value(apn);
+    return NULL;
+}
 
-            if (LE_OK != le_utf8_Copy(mccMncApnPtr, apnRead, mccMncApnSize, NULL))
-            {
-                LE_WARN("APN buffer is too small");
-                break;
-            }
-            LE_INFO("Got APN '%s' for MCC/MNC [%s/%s]", mccMncApnPtr, mccPtr, mncPtr);
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function copies the APN of an APN index record.
+ *
+ * @return LE_OK        The APN was copied
+ * @return LE_FAULT     The APN buffer is too small or the record is corrupted
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t CopyApnIndexRecordApn
+(
+    const ApnIndex_t* indexPtr,         ///< [IN]  apn index
+    const ApnIndexRecord_t* recordPtr,  ///< [IN]  record found in the index
+    char* apnPtr,                       ///< [OUT] apn
+    size_t apnSize                      ///< [IN]  size of apn buffer
+)
+{
+    size_t apnOffset = le32toh(recordPtr->apnOffset);
 
-            // @note Stop on the first JSON entry for MCC/MNC with type default:
-            // needs to be improved?
-            result = LE_OK;
-            break;
-        }
+    if (apnOffset >= indexPtr->stringsSize)
+    {
+        LE_WARN("Invalid APN offset %zu in APN index", apnOffset);
+        return LE_FAULT;
     }
 
-    json_decref(root);
-    return result;
+    if (LE_OK != le_utf8_Copy(apnPtr, indexPtr->stringsPtr + apnOffset, apnSize, NULL))
+    {
+        LE_WARN("APN buffer is too small");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
 }
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will attempt to read APN definition for ICCID in file apnFilePtr
+ *  This function will attempt to read APN definition for MCC/MNC in APN index file apnFilePtr
  *
  * @return LE_OK        Function was able to find an APN
- * @return LE_NOT_FOUND Function was not able to find an APN for this ICCID
+ * @return LE_NOT_FOUND Function was not able to find an APN for this (MCC,MNC)
  * @return LE_FAULT     There was an issue with the APN source
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t FindApnWithIccidFromFile
+static le_result_t FindApnWithMccMncFromFile
 (
-    const char* apnFilePtr, ///< [IN]  apn file
-    const char* iccidPtr,   ///< [IN]  iccid
-    char * iccidApnPtr,     ///< [OUT] apn for iccid
-    size_t iccidApnSize     ///< [IN]  size of iccidApn buffer
+    const char* apnFilePtr, ///< [IN]  apn index file
+    const char* mccPtr,     ///< [IN]  mcc
+    const char* mncPtr,     ///< [IN]  mnc
+    char * mccMncApnPtr,    ///< [OUT] apn for mcc/mnc
+    size_t mccMncApnSize    ///< [IN]  size of mccMncApn buffer
 )
 {
-    le_result_t result = LE_FAULT;
-    json_t *root, *apns, *apnArray;
-    json_error_t error;
-    int i;
+    char key[APN_INDEX_KEY_BYTES];
+    int keyLength;
 
-    root = json_load_file(apnFilePtr, 0, &error);
-    if (NULL == root)
+    if (LE_OK != MapApnIndex(apnFilePtr, &MccMncApnIndex))
     {
-        LE_WARN("Document not parsed successfully (error '%s')", error.text);
-        return result;
+        return LE_FAULT;
     }
 
-    apns = json_object_get(root, "apns");
-    if (!json_is_object(apns))
+    // Only "default" type APNs are in the index, first one in the APN database for each MCC/MNC.
+    keyLength = snprintf(key, sizeof(key), "%s:%s", mccPtr, mncPtr);
+    if ((keyLength < 0) || (keyLength >= sizeof(key)))
     {
-        LE_WARN("apns is not an object");
-        json_decref(root);
-        return result;
+        return LE_NOT_FOUND;
     }
 
-    apnArray = json_object_get(apns, "apn");
-    if (!json_is_array(apnArray))
+    const ApnIndexRecord_t* recordPtr = FindApnIndexRecord(&MccMncApnIndex, key, keyLength);
+    if (NULL == recordPtr)
     {
-        LE_WARN("apns is not an array");
-        json_decref(root);
-        return result;
+        return LE_NOT_FOUND;
+    }
+
+    if (LE_OK != CopyApnIndexRecordApn(&MccMncApnIndex, recordPtr, mccMncApnPtr, mccMncApnSize))
+    {
+        return LE_FAULT;
     }
 
-    result = LE_NOT_FOUND;
+    LE_INFO("Got APN '%s' for MCC/MNC [%s/%s]", mccMncApnPtr, mccPtr, mncPtr);
+    return LE_OK;
+}
 
-    for (i = 0; i < json_array_size(apnArray); i++)
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function will attempt to read APN definition for ICCID in APN index file apnFilePtr
+ *
+ * @return LE_OK        Function was able to find an APN
+ * @return LE_NOT_FOUND Function was not able to find an APN for this ICCID
+ * @return LE_FAULT     There was an issue with the APN source
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t FindApnWithIccidFromFile
+(
+    const char* apnFilePtr, ///< [IN]  apn index file
+    const char* iccidPtr,   ///< [IN]  iccid
+    char * iccidApnPtr,     ///< [OUT] apn for iccid
+    size_t iccidApnSize     ///< [IN]  size of iccidApn buffer
+)
+{
+    const ApnIndexRecord_t* bestRecordPtr = NULL;
+    size_t iccidLength = strlen(iccidPtr);
+    size_t keyLength;
+
+    if (LE_OK != MapApnIndex(apnFilePtr, &IinApnIndex))
+    {
+        return LE_FAULT;
+    }
+
+    // The Issuer Identification Number (IIN) is the beginning of the ICCID number and allows
+    // identifying an operator (cf. ITU Rec E.118).  Look every beginning of the ICCID up, and
+    // pick the matching IIN that comes first in the APN database.
+    for (keyLength = 1;
+         (keyLength <= iccidLength) && (keyLength <= IinApnIndex.maxKeyLength);
+         keyLength++)
     {
-        json_t *data, *iin, *apn;
-        const char* iinRead;
-        const char* apnRead;
+        const ApnIndexRecord_t* recordPtr = FindApnIndexRecord(&IinApnIndex, iccidPtr, keyLength);
 
-        data = json_array_get(apnArray, i);
-        if (!json_is_object(data))
+        if (   (NULL != recordPtr)
+            && (   (NULL == bestRecordPtr)
+                || (le32toh(recordPtr->order) < le32toh(bestRecordPtr->order)))
+           )
         {
-            LE_WARN("data %d is not an object", i);
-            result = LE_FAULT;
-            break;
+            bestRecordPtr = recordPtr;
         }
+    }
 
-        // Retrieve Issuer Identification Number (IIN), which is the beginning
-        // of the ICCID number and allows identifying an operator (cf. ITU Rec E.118)
-        iin = json_object_get(data, "@iin");
-        if (json_is_string(iin))
-        {
-            iinRead = json_string_value(iin);
+    if (NULL == bestRecordPtr)
+    {
+        return LE_NOT_FOUND;
+    }
 
-            // Check if IIN matches the beginning of ICCID
-            if (0 == strncmp(iccidPtr, iinRead, strlen(iinRead)))
-            {
-                apn = json_object_get(data, "@apn");
-                apnRead = json_string_value(apn);
-
-                if (LE_OK != le_utf8_Copy(iccidApnPtr, apnRead, iccidApnSize, NULL))
-                {
-                    LE_WARN("APN buffer is too small");
-                    break;
-                }
-                LE_INFO("Got APN '%s' for ICCID %s", iccidApnPtr, iccidPtr);
-
-                // @note Stop on the first JSON entry for IIN with type default:
-                // needs to be improved?
-                result = LE_OK;
-                break;
-            }
-        }
+    if (LE_OK != CopyApnIndexRecordApn(&IinApnIndex, bestRecordPtr, iccidApnPtr, iccidApnSize))
+    {
+        return LE_FAULT;
     }
 
-    json_decref(root);
-    return result;
+    LE_INFO("Got APN '%s' for ICCID %s", iccidApnPtr, iccidPtr);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -731,6 +927,139 @@ static le_result_t SetDataCounters
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a data session is connected on one of the profiles
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDataSessionConnected
+(
+    void
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(DataProfileRefMap);
+
+    while (LE_OK == le_ref_NextNode(iterRef))
+    {
+        le_mdc_Profile_t* profilePtr = (le_mdc_Profile_t*)le_ref_GetValue(iterRef);
+
+        if (LE_MDC_CONNECTED == profilePtr->connectionStatus)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer data usage handler: the client handler is only called if the data counters
+ * increased by its threshold since its last notification.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerDataUsageHandler
+(
+    void* reportPtr,
+    void* secondLayerHandlerFunc
+)
+{
+    DataUsage_t* usagePtr = reportPtr;
+    DataUsageHandlerCtx_t* ctxPtr = le_event_GetContextPtr();
+    uint64_t totalBytes = usagePtr->rxBytes + usagePtr->txBytes;
+
+    if (totalBytes < ctxPtr->notifiedBytes)
+    {
+        // The counters have been reset in the meantime
+        ctxPtr->notifiedBytes = 0;
+    }
+
+    if ((totalBytes - ctxPtr->notifiedBytes) >= ctxPtr->threshold)
+    {
+        le_mdc_DataUsageHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+
+        ctxPtr->notifiedBytes = totalBytes;
+        clientHandlerFunc(usagePtr->rxBytes, usagePtr->txBytes, ctxPtr->handlerCtxPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data usage timer handler: retrieve the data counters once for all the data usage handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DataUsageTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer which expired
+)
+{
+    pa_mdc_PktStatistics_t data;
+
+    // No data can be exchanged without data session, do not query the modem
+    if (!IsDataSessionConnected())
+    {
+        return;
+    }
+
+    if (LE_OK != pa_mdc_GetDataFlowStatistics(&data))
+    {
+        LE_WARN("Unable to retrieve the data counters");
+        return;
+    }
+
+    LastDataUsage.rxBytes = DataStatistics.receivedBytesCount + data.receivedBytesCount;
+    LastDataUsage.txBytes = DataStatistics.transmittedBytesCount + data.transmittedBytesCount;
+    TRACE("Data usage: rx=%"PRIu64", tx=%"PRIu64, LastDataUsage.rxBytes, LastDataUsage.txBytes);
+
+    le_event_Report(DataUsageEventId, &LastDataUsage, sizeof(LastDataUsage));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a data usage handler and stop retrieving the data counters if it was the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveDataUsageHandlerCtx
+(
+    DataUsageHandlerCtx_t* ctxPtr   ///< [IN] Data usage handler context
+)
+{
+    le_event_RemoveHandler(ctxPtr->handlerRef);
+    le_dls_Remove(&DataUsageHandlerList, &ctxPtr->link);
+    le_mem_Release(ctxPtr);
+
+    if (le_dls_IsEmpty(&DataUsageHandlerList))
+    {
+        le_timer_Stop(DataUsageTimerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function to release the data usage handlers of a closed client session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionEventHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session reference of client application.
+    void* contextPtr                ///< [IN] Context pointer got from ServiceCloseHandler.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&DataUsageHandlerList);
+
+    while (NULL != linkPtr)
+    {
+        DataUsageHandlerCtx_t* ctxPtr = CONTAINER_OF(linkPtr, DataUsageHandlerCtx_t, link);
+        linkPtr = le_dls_PeekNext(&DataUsageHandlerList, linkPtr);
+
+        if (ctxPtr->sessionRef == sessionRef)
+        {
+            LE_DEBUG("Remove data usage handler %p of session %p", ctxPtr->handlerRef, sessionRef);
+            RemoveDataUsageHandlerCtx(ctxPtr);
+        }
+    }
+}
+
 // =============================================
 //  MODULE/COMPONENT FUNCTIONS
 // =============================================
@@ -772,6 +1101,23 @@ void le_mdc_Init
     }
     GetDataCounters(&DataStatistics.receivedBytesCount, &DataStatistics.transmittedBytesCount);
 
+    // Data usage notification
+    DataUsageEventId = le_event_CreateId("DataUsageNotif", sizeof(DataUsage_t));
+    DataUsageHandlerPool = le_mem_CreatePool("DataUsageHandlerPool",
+                                             sizeof(DataUsageHandlerCtx_t));
+    le_mem_ExpandPool(DataUsageHandlerPool, DATA_USAGE_HANDLER_DEFAULT_POOL_SIZE);
+    LastDataUsage.rxBytes = DataStatistics.receivedBytesCount;
+    LastDataUsage.txBytes = DataStatistics.transmittedBytesCount;
+
+    DataUsageTimerRef = le_timer_Create("DataUsageTimer");
+    le_clk_Time_t interval = {DATA_USAGE_POLL_INTERVAL, 0};
+    le_timer_SetInterval(DataUsageTimerRef, interval);
+    le_timer_SetRepeat(DataUsageTimerRef, 0);
+    le_timer_SetHandler(DataUsageTimerRef, DataUsageTimerHandler);
+
+    // Release the data usage handlers of the closed client sessions
+    le_msg_AddServiceCloseHandler(le_mdc_GetServiceRef(), CloseSessionEventHandler, NULL);
+
     /* MT-PDP management */
     // Create an event Id for MT-PDP notification
     MtPdpEventId = le_event_CreateId("MtPdpNotif", sizeof(le_mdc_Profile_t*));
@@ -1805,6 +2151,8 @@ le_result_t le_mdc_ResetBytesCounter
         DataStatistics.receivedBytesCount = 0;
         DataStatistics.transmittedBytesCount = 0;
         SetDataCounters(DataStatistics.receivedBytesCount, DataStatistics.transmittedBytesCount);
+        LastDataUsage.rxBytes = 0;
+        LastDataUsage.txBytes = 0;
         return LE_OK;
     }
 
@@ -1864,6 +2212,94 @@ le_result_t le_mdc_StartBytesCounter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register a handler for data usage notifications. The handler is called each time the amount of
+ * received and transmitted data has increased by the given threshold since its last notification.
+ *
+ * @return
+ *      - A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note
+ *      Process exits on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mdc_DataUsageHandlerRef_t le_mdc_AddDataUsageHandler
+(
+    uint64_t threshold,                         ///< [IN] Bytes amount between notifications
+    le_mdc_DataUsageHandlerFunc_t handlerPtr,   ///< [IN] Handler function
+    void* contextPtr                            ///< [IN] Context pointer
+)
+{
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+    if (0 == threshold)
+    {
+        LE_KILL_CLIENT("Threshold is null !");
+        return NULL;
+    }
+
+    DataUsageHandlerCtx_t* ctxPtr = le_mem_ForceAlloc(DataUsageHandlerPool);
+    ctxPtr->handlerFuncPtr = handlerPtr;
+    ctxPtr->handlerCtxPtr = contextPtr;
+    ctxPtr->threshold = threshold;
+    ctxPtr->notifiedBytes = LastDataUsage.rxBytes + LastDataUsage.txBytes;
+    ctxPtr->sessionRef = le_mdc_GetClientSessionRef();
+    ctxPtr->link = LE_DLS_LINK_INIT;
+
+    ctxPtr->handlerRef = le_event_AddLayeredHandler("le_DataUsageHandler",
+                                                    DataUsageEventId,
+                                                    FirstLayerDataUsageHandler,
+                                                    (le_event_HandlerFunc_t)handlerPtr);
+    le_event_SetContextPtr(ctxPtr->handlerRef, ctxPtr);
+
+    le_dls_Queue(&DataUsageHandlerList, &ctxPtr->link);
+
+    // Start retrieving the data counters for the first handler
+    if (!le_timer_IsRunning(DataUsageTimerRef))
+    {
+        le_timer_Start(DataUsageTimerRef);
+    }
+
+    LE_DEBUG("handlerRef %p, threshold %"PRIu64, ctxPtr->handlerRef, threshold);
+
+    return (le_mdc_DataUsageHandlerRef_t)ctxPtr->handlerRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a handler for data usage notifications
+ *
+ * @note
+ *      The process exits on failure
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mdc_RemoveDataUsageHandler
+(
+    le_mdc_DataUsageHandlerRef_t handlerRef     ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&DataUsageHandlerList);
+
+    while (NULL != linkPtr)
+    {
+        DataUsageHandlerCtx_t* ctxPtr = CONTAINER_OF(linkPtr, DataUsageHandlerCtx_t, link);
+
+        if (ctxPtr->handlerRef == (le_event_HandlerRef_t)handlerRef)
+        {
+            RemoveDataUsageHandlerCtx(ctxPtr);
+            return;
+        }
+
+        linkPtr = le_dls_PeekNext(&DataUsageHandlerList, linkPtr);
+    }
+
+    LE_KILL_CLIENT("Invalid data usage handler reference %p", handlerRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the Packet Data Protocol (PDP) for the given profile.
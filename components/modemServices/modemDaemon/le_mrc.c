@@ -31,6 +31,9 @@
  */
 
 
+#include <spawn.h>
+#include <sys/wait.h>
+
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_mrc.h"
@@ -92,6 +95,21 @@
 //--------------------------------------------------------------------------------------------------
 #define MRC_MAX_SCAN    10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of Radio Access Technologies a network scan is split into: GSM, UMTS, TD-SCDMA, LTE and
+ * CDMA, i.e. the first bits of le_mrc_RatBitMask_t.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MRC_SCAN_RAT_NUM    5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default validity in seconds of the cached network scan results.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MRC_SCAN_CACHE_DEFAULT_TIMEOUT    0
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum number of Signal Metrics objects we expect to have at one time.
@@ -101,10 +119,10 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Buffer size for the 'tzoneset' command
+ * Buffer size for the time zone offset argument of the 'tzoneset' command
  */
 //--------------------------------------------------------------------------------------------------
-#define TIME_ZONE_CMD_BUF_SIZE 128
+#define TIME_ZONE_OFFSET_BUF_SIZE 12
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -129,10 +147,25 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sleep interval (nanoseconds) between 'tzoneset' lock file checks (0.5 sec)
+ * Interval (milliseconds) between 'tzoneset' lock file checks (0.5 sec)
  */
 //--------------------------------------------------------------------------------------------------
-#define TIME_ZONE_LOCK_RETRY_SLEEP_NS 500000000L
+#define TIME_ZONE_LOCK_RETRY_INTERVAL_MS 500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval (milliseconds) between two checks of the end of the 'tzoneset' command (0.1 sec)
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_ZONE_CMD_POLL_INTERVAL_MS 100
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment of the process, passed to the spawned commands.
+ */
+//--------------------------------------------------------------------------------------------------
+extern char** environ;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -298,6 +331,19 @@ typedef struct
     le_dls_Link_t       *currentLink;        // link for iterator
 } PciScanInfoList_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached results of the last network scan of one Radio Access Technology.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool          isValid;  ///< Scan results are available.
+    le_clk_Time_t time;     ///< Relative time at which the scan completed.
+    le_dls_List_t paList;   ///< List of pa_mrc_ScanInformation_t or pa_mrc_PciScanInformation_t.
+} ScanCache_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Signal Strength Indication Handler context.
@@ -367,6 +413,38 @@ typedef struct
 }
 JammingDetectionRef_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing settings of a client session for its Network Registration State handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;     ///< Message session reference.
+    uint32_t            quietPeriodMs;  ///< Quiet period before delivering a state, 0 if none.
+    uint32_t            coalescedCount; ///< Number of states dropped because a newer one came
+                                        ///  within the quiet period.
+    le_dls_List_t       handlerList;    ///< Network Registration State handlers of the session.
+}
+NetRegClient_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A client's Network Registration State handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_event_HandlerRef_t           handlerRef;     ///< Handler of the state event.
+    le_mrc_NetRegStateHandlerFunc_t handlerFunc;    ///< Client handler.
+    void*                           contextPtr;     ///< Client context.
+    NetRegClient_t*                 clientPtr;      ///< Client the handler belongs to.
+    le_timer_Ref_t                  timerRef;       ///< Quiet period timer, created when needed.
+    le_mrc_NetRegState_t            pendingState;   ///< State to deliver when the timer expires.
+    le_dls_Link_t                   link;           ///< Link in the client's handler list.
+}
+NetRegHandler_t;
+
 
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
@@ -434,6 +512,34 @@ static le_ref_MapRef_t PreferredOperatorsRefMap;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t NewNetRegStateId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the client sessions' Network Registration State coalescing settings.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t NetRegClientPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for Network Registration State handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t NetRegHandlerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of the Network Registration State coalescing settings, by client session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t NetRegClientMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe Reference Map for Network Registration State handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t NetRegHandlerRefMap;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for Listed ScanInformation.
@@ -612,6 +718,48 @@ static le_dls_List_t  JammingSessionRefList;
 // ------------------------------------------------------------------------------------------------
 static le_timer_Ref_t NetworkTimeTimerRef = NULL;
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Timer used to retry the 'tzoneset' lock file checks and to wait for the end of the command.
+ */
+// ------------------------------------------------------------------------------------------------
+static le_timer_Ref_t TimeZoneTimerRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time zone update state. Only the latest received offset is applied: an indication received
+ * while a 'tzoneset' command is running is applied once that command ends.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t TimeZoneOffset = 0;             ///< Latest time zone offset in seconds
+static bool    IsTimeZonePending = false;      ///< TimeZoneOffset is not applied yet
+static pid_t   TimeZoneCmdPid = -1;            ///< PID of the running 'tzoneset', -1 if none
+static int     TimeZoneLockChecks = 0;         ///< Number of lock file checks already done
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pools for the copies of the cached scan results given to the clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ScanInformationPool;
+static le_mem_PoolRef_t PciScanInformationPool;
+static le_mem_PoolRef_t PlmnInformationPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached results of the cellular and PCI network scans, indexed by Radio Access Technology.
+ */
+//--------------------------------------------------------------------------------------------------
+static ScanCache_t CellularScanCache[MRC_SCAN_RAT_NUM];
+static ScanCache_t PciScanCache[MRC_SCAN_RAT_NUM];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Validity of the cached network scan results.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t ScanCacheTimeout = {.sec = MRC_SCAN_CACHE_DEFAULT_TIMEOUT};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to destroy all safeRef elements in the CellInfoSafeRef list.
@@ -656,10 +804,53 @@ static void DeletePreferredOperatorsSafeRefList
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Network Registration State coalescing settings of a client session, creating them the
+ * first time.
+ */
+//--------------------------------------------------------------------------------------------------
+static NetRegClient_t* GetNetRegClient
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Session reference of client application.
+)
+{
+    NetRegClient_t* clientPtr = le_hashmap_Get(NetRegClientMap, sessionRef);
+
+    if (NULL == clientPtr)
+    {
+        clientPtr = le_mem_ForceAlloc(NetRegClientPool);
+        clientPtr->sessionRef = sessionRef;
+        clientPtr->quietPeriodMs = 0;
+        clientPtr->coalescedCount = 0;
+        clientPtr->handlerList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(NetRegClientMap, sessionRef, clientPtr);
+    }
+
+    return clientPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quiet period timer handler: deliver the latest Network Registration State to the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NetRegQuietTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Quiet period timer of the handler.
+)
+{
+    NetRegHandler_t* handlerPtr = le_timer_GetContextPtr(timerRef);
+
+    handlerPtr->handlerFunc(handlerPtr->pendingState, handlerPtr->contextPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer Network Registration State Change Handler.
  *
+ * Without a quiet period, the state is delivered at once.  Otherwise it is held until no other
+ * state has come for the quiet period, a newer state replacing the one held.
  */
 //--------------------------------------------------------------------------------------------------
 static void FirstLayerNetRegStateChangeHandler
@@ -668,10 +859,33 @@ static void FirstLayerNetRegStateChangeHandler
     void* secondLayerHandlerFunc
 )
 {
-    le_mrc_NetRegState_t*           statePtr = reportPtr;
-    le_mrc_NetRegStateHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+    le_mrc_NetRegState_t* statePtr = reportPtr;
+    NetRegHandler_t*      handlerPtr = le_event_GetContextPtr();
+    NetRegClient_t*       clientPtr = handlerPtr->clientPtr;
+
+    if (0 == clientPtr->quietPeriodMs)
+    {
+        handlerPtr->handlerFunc(*statePtr, handlerPtr->contextPtr);
+    }
+    else
+    {
+        if (NULL == handlerPtr->timerRef)
+        {
+            handlerPtr->timerRef = le_timer_Create("NetRegStateQuiet");
+            le_timer_SetHandler(handlerPtr->timerRef, NetRegQuietTimerHandler);
+            le_timer_SetContextPtr(handlerPtr->timerRef, handlerPtr);
+        }
+        else if (le_timer_IsRunning(handlerPtr->timerRef))
+        {
+            LE_DEBUG("regStat %d replaces pending regStat %d",
+                     *statePtr, handlerPtr->pendingState);
+            clientPtr->coalescedCount++;
+        }
 
-    clientHandlerFunc(*statePtr, le_event_GetContextPtr());
+        handlerPtr->pendingState = *statePtr;
+        le_timer_SetMsInterval(handlerPtr->timerRef, clientPtr->quietPeriodMs);
+        le_timer_Restart(handlerPtr->timerRef);
+    }
 
     // The reportPtr is a reference counted object, so need to release it
     le_mem_Release(reportPtr);
@@ -752,12 +966,288 @@ static void DeletePlmnSafeRefList
     PlmnInfoSafeRef_t* nodePtr;
     le_dls_Link_t *linkPtr;
 
-    while ((linkPtr=le_dls_Pop(listPtr)) != NULL)
+    while ((linkPtr=le_dls_Pop(listPtr)) != NULL)
+    {
+        nodePtr = CONTAINER_OF(linkPtr, PlmnInfoSafeRef_t, link);
+        le_ref_DeleteRef(PlmnInformationRefMap, nodePtr->safeRef);
+        le_mem_Release(nodePtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to destroy all the scan information copies of a client list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteScanInformationList
+(
+    le_dls_List_t* listPtr  ///< [IN] List of pa_mrc_ScanInformation_t
+)
+{
+    le_dls_Link_t *linkPtr;
+
+    while ((linkPtr = le_dls_Pop(listPtr)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, pa_mrc_ScanInformation_t, link));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to destroy all the PCI scan information copies of a client list, with their PLMN lists.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeletePciScanInformationList
+(
+    le_dls_List_t* listPtr  ///< [IN] List of pa_mrc_PciScanInformation_t
+)
+{
+    le_dls_Link_t *linkPtr;
+
+    while ((linkPtr = le_dls_Pop(listPtr)) != NULL)
+    {
+        pa_mrc_PciScanInformation_t* nodePtr = CONTAINER_OF(linkPtr,
+                                                            pa_mrc_PciScanInformation_t,
+                                                            link);
+        le_dls_Link_t *plmnLinkPtr;
+
+        while ((plmnLinkPtr = le_dls_Pop(&(nodePtr->plmnList))) != NULL)
+        {
+            le_mem_Release(CONTAINER_OF(plmnLinkPtr, pa_mrc_PlmnInformation_t, link));
+        }
+        le_mem_Release(nodePtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to destroy the client copies of the scan results.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteScanResults
+(
+    pa_mrc_ScanType_t scanType, ///< [IN] Scan type
+    le_dls_List_t*    listPtr   ///< [IN] List of the scan results
+)
+{
+    if (PA_MRC_SCAN_PCI == scanType)
+    {
+        DeletePciScanInformationList(listPtr);
+    }
+    else
+    {
+        DeleteScanInformationList(listPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to give back to the platform adaptor the scan results it allocated.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeletePaScanResults
+(
+    pa_mrc_ScanType_t scanType, ///< [IN] Scan type
+    le_dls_List_t*    listPtr   ///< [IN] List of the scan results
+)
+{
+    if (PA_MRC_SCAN_PCI == scanType)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(listPtr);
+
+        while (linkPtr != NULL)
+        {
+            pa_mrc_PciScanInformation_t* nodePtr = CONTAINER_OF(linkPtr,
+                                                                pa_mrc_PciScanInformation_t,
+                                                                link);
+            pa_mrc_DeletePlmnScanInformation(&(nodePtr->plmnList));
+            linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+        }
+        pa_mrc_DeletePciScanInformation(listPtr);
+    }
+    else
+    {
+        pa_mrc_DeleteScanInformation(listPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to append to a client list a copy of the scan results of the cache, so that the client
+ * can browse and delete its list independently of the cache and of the other clients.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyScanResults
+(
+    pa_mrc_ScanType_t    scanType,  ///< [IN] Scan type
+    const le_dls_List_t* srcListPtr,///< [IN] List of the cached scan results
+    le_dls_List_t*       dstListPtr ///< [OUT] List of the client
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(srcListPtr);
+
+    while (linkPtr != NULL)
+    {
+        if (PA_MRC_SCAN_PCI == scanType)
+        {
+            pa_mrc_PciScanInformation_t* srcPtr = CONTAINER_OF(linkPtr,
+                                                               pa_mrc_PciScanInformation_t,
+                                                               link);
+            pa_mrc_PciScanInformation_t* dstPtr = le_mem_ForceAlloc(PciScanInformationPool);
+            le_dls_Link_t* plmnLinkPtr = le_dls_Peek(&(srcPtr->plmnList));
+
+            dstPtr->cellId = srcPtr->cellId;
+            dstPtr->plmnList = LE_DLS_LIST_INIT;
+            dstPtr->currentLink = NULL;
+            dstPtr->safeRefPlmnInfoList = LE_DLS_LIST_INIT;
+            dstPtr->link = LE_DLS_LINK_INIT;
+
+            while (plmnLinkPtr != NULL)
+            {
+                pa_mrc_PlmnInformation_t* plmnPtr = le_mem_ForceAlloc(PlmnInformationPool);
+
+                plmnPtr->mobileCode = CONTAINER_OF(plmnLinkPtr,
+                                                   pa_mrc_PlmnInformation_t,
+                                                   link)->mobileCode;
+                plmnPtr->link = LE_DLS_LINK_INIT;
+                le_dls_Queue(&(dstPtr->plmnList), &(plmnPtr->link));
+
+                plmnLinkPtr = le_dls_PeekNext(&(srcPtr->plmnList), plmnLinkPtr);
+            }
+            le_dls_Queue(dstListPtr, &(dstPtr->link));
+        }
+        else
+        {
+            pa_mrc_ScanInformation_t* dstPtr = le_mem_ForceAlloc(ScanInformationPool);
+
+            *dstPtr = *CONTAINER_OF(linkPtr, pa_mrc_ScanInformation_t, link);
+            dstPtr->link = LE_DLS_LINK_INIT;
+            le_dls_Queue(dstListPtr, &(dstPtr->link));
+        }
+
+        linkPtr = le_dls_PeekNext(srcListPtr, linkPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to check whether the cached scan results of one RAT can be used for a scan request.
+ *
+ * They can when they are not older than the configured timeout, or when the scan completed after
+ * the request was issued: concurrent requests waiting for the same scan share its results.
+ *
+ * @return true if the cached results can be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsScanCacheValid
+(
+    const ScanCache_t* cachePtr,    ///< [IN] Cached scan results
+    le_clk_Time_t      requestTime  ///< [IN] Relative time at which the request was issued
+)
+{
+    if (!cachePtr->isValid)
+    {
+        return false;
+    }
+
+    if (!le_clk_GreaterThan(requestTime, cachePtr->time))
+    {
+        return true;
+    }
+
+    return !le_clk_GreaterThan(le_clk_Sub(le_clk_GetRelativeTime(), cachePtr->time),
+                               ScanCacheTimeout);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get the results of a network scan.
+ *
+ * The scan is performed one RAT at a time, and only for the RATs which do not have valid results
+ * in the cache. The lock is released between two RATs, so that the results of one RAT are
+ * available to the other requests as soon as its scan completes.
+ *
+ * @return
+ *      - LE_OK on success, the results are appended to the list
+ *      - LE_FAULT or the error of the platform adaptor scan otherwise, the list is left empty
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetNetworkScan
+(
+    le_mrc_RatBitMask_t ratMask,    ///< [IN] Radio Access Technology bitmask
+    pa_mrc_ScanType_t   scanType,   ///< [IN] Scan type
+    le_dls_List_t*      listPtr     ///< [OUT] List of the scan results
+)
+{
+    ScanCache_t* cachePtr = (PA_MRC_SCAN_PCI == scanType) ? PciScanCache : CellularScanCache;
+    le_clk_Time_t requestTime = le_clk_GetRelativeTime();
+    le_result_t result = LE_OK;
+    int i;
+
+    if (ratMask & LE_MRC_BITMASK_RAT_ALL)
+    {
+        ratMask = (le_mrc_RatBitMask_t)((1 << MRC_SCAN_RAT_NUM) - 1);
+    }
+
+    if ((0 == ratMask) || (ratMask >= (1 << MRC_SCAN_RAT_NUM)))
+    {
+        LE_ERROR("Invalid RAT mask 0x%X", ratMask);
+        return LE_FAULT;
+    }
+
+    for (i = 0; (i < MRC_SCAN_RAT_NUM) && (LE_OK == result); i++)
+    {
+        le_mrc_RatBitMask_t ratBit = (le_mrc_RatBitMask_t)(1 << i);
+
+        if (0 == (ratMask & ratBit))
+        {
+            continue;
+        }
+
+        LOCK();
+        if (IsScanCacheValid(&cachePtr[i], requestTime))
+        {
+            LE_DEBUG("Use the cached scan results of RAT 0x%X", ratBit);
+        }
+        else
+        {
+            le_dls_List_t paList = LE_DLS_LIST_INIT;
+
+            result = pa_mrc_PerformNetworkScan(ratBit, scanType, &paList);
+            if (LE_OK == result)
+            {
+                if (cachePtr[i].isValid)
+                {
+                    DeletePaScanResults(scanType, &(cachePtr[i].paList));
+                }
+                cachePtr[i].paList = paList;
+                cachePtr[i].time = le_clk_GetRelativeTime();
+                cachePtr[i].isValid = true;
+            }
+            else if (!le_dls_IsEmpty(&paList))
+            {
+                DeletePaScanResults(scanType, &paList);
+            }
+        }
+
+        if (LE_OK == result)
+        {
+            CopyScanResults(scanType, &(cachePtr[i].paList), listPtr);
+        }
+        UNLOCK();
+    }
+
+    if (LE_OK != result)
     {
-        nodePtr = CONTAINER_OF(linkPtr, PlmnInfoSafeRef_t, link);
-        le_ref_DeleteRef(PlmnInformationRefMap, nodePtr->safeRef);
-        le_mem_Release(nodePtr);
+        DeleteScanResults(scanType, listPtr);
     }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -967,6 +1457,33 @@ le_result_t le_mrc_TestMccMnc
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to convert a signal strength into a signal quality.
+ *
+ * @return The signal quality (0 = no signal strength, 5 = very good signal strength).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetSignalQuality
+(
+    int32_t rssi    ///< [IN] The received signal strength (in dBm).
+)
+{
+    int32_t       thresholds[] = {-113, -100, -90, -80, -65}; // TODO: Verify thresholds !
+    uint32_t      i;
+    size_t        thresholdsCount = NUM_ARRAY_MEMBERS(thresholds);
+
+    for (i=0; i<thresholdsCount; i++)
+    {
+        if (rssi <= thresholds[i])
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler to process an asynchronous command
@@ -1022,10 +1539,8 @@ static void ProcessMrcCommandEventHandler
         newScanInformationListPtr->safeRefScanInfoList = LE_DLS_LIST_INIT;
         newScanInformationListPtr->currentLink = NULL;
 
-        LOCK();
-        res = pa_mrc_PerformNetworkScan(ratMask, ((CmdRequest_t*) msgCommand)->scan.type,
-                                        &(newScanInformationListPtr->paScanInfoList));
-        UNLOCK();
+        res = GetNetworkScan(ratMask, cmdRequest->scan.type,
+                             &(newScanInformationListPtr->paScanInfoList));
 
         if (LE_OK != res)
         {
@@ -1059,15 +1574,13 @@ static void ProcessMrcCommandEventHandler
         PciScanInfoList_t* newScanInformationListPtr = NULL;
         le_mrc_PciScanInformationListRef_t scanInformationListRef = NULL;
 
-        newScanInformationListPtr = le_mem_ForceAlloc(ScanInformationListPool);
+        newScanInformationListPtr = le_mem_ForceAlloc(PciScanInformationListPool);
         newScanInformationListPtr->paPciScanInfoList = LE_DLS_LIST_INIT;
         newScanInformationListPtr->safeRefPciScanInfoList = LE_DLS_LIST_INIT;
         newScanInformationListPtr->currentLink = NULL;
 
-        LOCK();
-        res = pa_mrc_PerformNetworkScan(ratMask, ((CmdRequest_t*) msgCommand)->scan.type,
-                                        &(newScanInformationListPtr->paPciScanInfoList));
-        UNLOCK();
+        res = GetNetworkScan(ratMask, cmdRequest->scan.type,
+                             &(newScanInformationListPtr->paPciScanInfoList));
 
         if (LE_OK != res)
         {
@@ -1430,73 +1943,141 @@ static void JammingDetectionIndHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The network time indication handler.
+ * Start the 'tzoneset' command with the pending time zone offset, unless the command is locked by
+ * another process, in which case the time zone timer is started to check the lock file again.
+ *
+ * The command is started directly, without a shell, and is not waited for: the time zone timer
+ * polls for its end so that the event loop is never blocked.
  */
 //--------------------------------------------------------------------------------------------------
-static void NetworkTimeIndHandler
+static void SetTimeZone
 (
-    pa_mrc_NetworkTimeIndication_t* networkTimeIndPtr ///< [IN] Network Time data structure
+    void
 )
 {
-    char cmdLine[TIME_ZONE_CMD_BUF_SIZE];
-
-    LE_INFO("Network time Handler called with time %"PRIu64", zone %d, dst %d",
-            networkTimeIndPtr->epochTime, networkTimeIndPtr->timeZone,
-            networkTimeIndPtr->dst);
+    struct stat fileStatus;
 
-    // Converting 15-min intervals to seconds
-    int32_t timeZoneOffset = networkTimeIndPtr->timeZone * 15 * 60;
+    // Verify the process is not locked; if lock file exists, retry few times.
+    if (0 == stat(TIME_ZONE_LOCK_FILE, &fileStatus))
+    {
+        TimeZoneLockChecks++;
+        if (TimeZoneLockChecks < TIME_ZONE_LOCK_MAX_RETRY)
+        {
+            le_timer_SetMsInterval(TimeZoneTimerRef, TIME_ZONE_LOCK_RETRY_INTERVAL_MS);
+            le_timer_Start(TimeZoneTimerRef);
+        }
+        else
+        {
+            LE_ERROR("Can't set timezone, process is locked.");
+            IsTimeZonePending = false;
+        }
+        return;
+    }
 
     // syntax: tzoneset <epochTime in seconds> <TZ offset in seconds> <DST: 0 or 1 or 2 hours>
     // Passing epoch time as 0 (means "don't modify") because system clock is already set
     // to UTC time by Time Daemon, and we don't want to override it.
     // Passing DST as 0 because it is already accounted for in the timeZoneOffset.
-    snprintf(cmdLine, sizeof(cmdLine), "%s 0 %d 0",
-             TIME_ZONE_CMD_PATH,
-             timeZoneOffset);
+    char offsetStr[TIME_ZONE_OFFSET_BUF_SIZE];
+    snprintf(offsetStr, sizeof(offsetStr), "%"PRId32, TimeZoneOffset);
+    char* argv[] = {(char*)TIME_ZONE_CMD_PATH, (char*)"0", offsetStr, (char*)"0", NULL};
+
+    // The signals handled by the event loop are blocked: unblock them for the command.
+    posix_spawnattr_t attr;
+    sigset_t sigMask;
+    sigemptyset(&sigMask);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &sigMask);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    LE_INFO("Executing [%s 0 %s 0]", TIME_ZONE_CMD_PATH, offsetStr);
+    int rc = posix_spawn(&TimeZoneCmdPid, TIME_ZONE_CMD_PATH, NULL, &attr, argv, environ);
+    posix_spawnattr_destroy(&attr);
+
+    IsTimeZonePending = false;
+
+    if (0 != rc)
+    {
+        LE_ERROR("Error setting time zone: cannot start [%s]: %s", TIME_ZONE_CMD_PATH,
+                 strerror(rc));
+        TimeZoneCmdPid = -1;
+        return;
+    }
 
-    // Fork to avoid delaying the main process.
-    pid_t pid = fork();
-    LE_FATAL_IF(pid < 0, "Failed to fork child process.  %m.");
+    le_timer_SetMsInterval(TimeZoneTimerRef, TIME_ZONE_CMD_POLL_INTERVAL_MS);
+    le_timer_Start(TimeZoneTimerRef);
+}
 
-    if (pid == 0) // child process
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time zone timer handler: wait for the end of the running 'tzoneset' command, or check the lock
+ * file again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeZoneTimerHandler
+(
+    le_timer_Ref_t timerRef    ///< [IN] Timer reference
+)
+{
+    if (-1 != TimeZoneCmdPid)
     {
-        bool locked = true;
-        struct stat fileStatus;
-        int i;
-        struct timespec sleepInterval = {0, TIME_ZONE_LOCK_RETRY_SLEEP_NS};
+        int status;
+        pid_t pid = waitpid(TimeZoneCmdPid, &status, WNOHANG);
 
-        // Verify the process is not locked; if lock file exists, retry few times.
-        for (i = 0; i < TIME_ZONE_LOCK_MAX_RETRY; i++)
+        if (0 == pid)
         {
-            if (0 != stat(TIME_ZONE_LOCK_FILE, &fileStatus))
-            {
-                // file doesn't exist - process has no lock.
-                locked = false;
-                break;
-            }
-            // sleep half second between retries
-            if (0 != nanosleep(&sleepInterval, NULL))
-            {
-                LE_ERROR("Error in nanosleep");
-            }
+            // Still running.
+            le_timer_Start(timerRef);
+            return;
         }
-        if (!locked)
+
+        if (-1 == pid)
         {
-            LE_INFO("Executing [%s]", cmdLine);
-            // Use 'system()' to get back the exit code.
-            int rc = system(cmdLine);
-            if (0 != rc)
-            {
-                LE_ERROR("Error setting time zone: command [%s]: exit code %d(%#x)",
-                         cmdLine, rc, rc);
-            }
+            LE_ERROR("Failed to wait for [%s] (pid %d): %m", TIME_ZONE_CMD_PATH, TimeZoneCmdPid);
         }
-        else
+        else if (!WIFEXITED(status) || (0 != WEXITSTATUS(status)))
         {
-            LE_ERROR("Can't set timezone, process is locked.");
+            LE_ERROR("Error setting time zone: command [%s]: exit code %d(%#x)",
+                     TIME_ZONE_CMD_PATH, status, status);
+        }
+        TimeZoneCmdPid = -1;
+
+        if (!IsTimeZonePending)
+        {
+            return;
         }
-        exit(0);
+
+        // A new time zone was received while the command was running.
+        TimeZoneLockChecks = 0;
+    }
+
+    SetTimeZone();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The network time indication handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NetworkTimeIndHandler
+(
+    pa_mrc_NetworkTimeIndication_t* networkTimeIndPtr ///< [IN] Network Time data structure
+)
+{
+    LE_INFO("Network time Handler called with time %"PRIu64", zone %d, dst %d",
+            networkTimeIndPtr->epochTime, networkTimeIndPtr->timeZone,
+            networkTimeIndPtr->dst);
+
+    // Converting 15-min intervals to seconds
+    TimeZoneOffset = networkTimeIndPtr->timeZone * 15 * 60;
+    IsTimeZonePending = true;
+
+    // If a command is running or a lock file check is scheduled, the new offset is applied by the
+    // time zone timer handler.
+    if (!le_timer_IsRunning(TimeZoneTimerRef))
+    {
+        TimeZoneLockChecks = 0;
+        SetTimeZone();
     }
 }
 
@@ -1683,6 +2264,14 @@ static void CloseSessionEventHandler
     {
         StopJammingDetection();
     }
+
+    // Forget the Network Registration State coalescing settings. The session's handlers, removed
+    // separately, keep a reference to them until then.
+    NetRegClient_t* netRegClientPtr = le_hashmap_Remove(NetRegClientMap, sessionRef);
+    if (NULL != netRegClientPtr)
+    {
+        le_mem_Release(netRegClientPtr);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1781,6 +2370,28 @@ void le_mrc_Init
 
     PlmnInformationSafeRefPool = le_mem_CreatePool("PlmnInformationSafeRefPool",
                                                    sizeof(PlmnInfoSafeRef_t));
+
+    // Create the pools for the copies of the cached scan results.
+    ScanInformationPool = le_mem_CreatePool("ScanInformationPool",
+                                            sizeof(pa_mrc_ScanInformation_t));
+    le_mem_ExpandPool(ScanInformationPool, MRC_MAX_SCAN);
+
+    PciScanInformationPool = le_mem_CreatePool("PciScanInformationPool",
+                                               sizeof(pa_mrc_PciScanInformation_t));
+
+    PlmnInformationPool = le_mem_CreatePool("PlmnInformationPool",
+                                            sizeof(pa_mrc_PlmnInformation_t));
+
+    // Retrieve the validity of the cached network scan results from the configuration tree.
+    le_cfg_IteratorRef_t iteratorRef = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_MRC_PATH);
+    int32_t scanCacheTimeout = le_cfg_GetInt(iteratorRef, CFG_NODE_SCAN_CACHE_TIMEOUT,
+                                             MRC_SCAN_CACHE_DEFAULT_TIMEOUT);
+    le_cfg_CancelTxn(iteratorRef);
+    if (scanCacheTimeout > 0)
+    {
+        ScanCacheTimeout.sec = scanCacheTimeout;
+        LE_INFO("Network scan results are cached for %d seconds", scanCacheTimeout);
+    }
     // Create the pool for cells information list.
     CellListPool = le_mem_CreatePool("CellListPool", sizeof(CellList_t));
 
@@ -1831,6 +2442,15 @@ void le_mrc_Init
     // Create an event Id for new Network Registration State notification
     NewNetRegStateId = le_event_CreateIdWithRefCounting("NewNetRegState");
 
+    // Create the pools and maps for the Network Registration State handlers and their clients'
+    // coalescing settings
+    NetRegClientPool = le_mem_CreatePool("NetRegClientPool", sizeof(NetRegClient_t));
+    NetRegHandlerPool = le_mem_CreatePool("NetRegHandlerPool", sizeof(NetRegHandler_t));
+    NetRegClientMap = le_hashmap_Create("NetRegClientMap", 5,
+                                        le_hashmap_HashVoidPointer,
+                                        le_hashmap_EqualsVoidPointer);
+    NetRegHandlerRefMap = le_ref_CreateMap("NetRegHandlerRefMap", 5);
+
     // Create an event Id for RAT change notification
     RatChangeId = le_event_CreateIdWithRefCounting("RatChange");
 
@@ -1903,6 +2523,9 @@ void le_mrc_Init
     NetworkTimeTimerRef = le_timer_Create("Network time sync retry timer");
     le_timer_SetHandler(NetworkTimeTimerRef, RetrySyncNetworkTimeHandler);
 
+    TimeZoneTimerRef = le_timer_Create("Time zone update timer");
+    le_timer_SetHandler(TimeZoneTimerRef, TimeZoneTimerHandler);
+
     // If 'tzoneset' executable is available, sync the network time and timezone
     struct stat fileStatus;
     if (0 == stat(TIME_ZONE_CMD_PATH, &fileStatus))
@@ -2806,7 +3429,7 @@ le_mrc_NetRegStateEventHandlerRef_t le_mrc_AddNetRegStateEventHandler
     void*                           contextPtr      ///< [IN] The handler's context.
 )
 {
-    le_event_HandlerRef_t        handlerRef;
+    NetRegHandler_t* handlerPtr;
 
     if (handlerFuncPtr == NULL)
     {
@@ -2814,14 +3437,25 @@ le_mrc_NetRegStateEventHandlerRef_t le_mrc_AddNetRegStateEventHandler
         return NULL;
     }
 
-    handlerRef = le_event_AddLayeredHandler("NewNetRegStateHandler",
-                                            NewNetRegStateId,
-                                            FirstLayerNetRegStateChangeHandler,
-                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+    handlerPtr = le_mem_ForceAlloc(NetRegHandlerPool);
+    handlerPtr->handlerFunc = handlerFuncPtr;
+    handlerPtr->contextPtr = contextPtr;
+    handlerPtr->clientPtr = GetNetRegClient(le_mrc_GetClientSessionRef());
+    handlerPtr->timerRef = NULL;
+    handlerPtr->pendingState = LE_MRC_REG_UNKNOWN;
+    handlerPtr->link = LE_DLS_LINK_INIT;
 
-    le_event_SetContextPtr(handlerRef, contextPtr);
+    le_mem_AddRef(handlerPtr->clientPtr);
+    le_dls_Queue(&handlerPtr->clientPtr->handlerList, &handlerPtr->link);
+
+    handlerPtr->handlerRef = le_event_AddLayeredHandler("NewNetRegStateHandler",
+                                                        NewNetRegStateId,
+                                                        FirstLayerNetRegStateChangeHandler,
+                                                        (le_event_HandlerFunc_t)handlerFuncPtr);
 
-    return (le_mrc_NetRegStateEventHandlerRef_t)(handlerRef);
+    le_event_SetContextPtr(handlerPtr->handlerRef, handlerPtr);
+
+    return le_ref_CreateRef(NetRegHandlerRefMap, handlerPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2834,7 +3468,80 @@ void le_mrc_RemoveNetRegStateEventHandler
     le_mrc_NetRegStateEventHandlerRef_t    handlerRef ///< [IN] The handler reference.
 )
 {
-    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    NetRegHandler_t* handlerPtr = le_ref_Lookup(NetRegHandlerRefMap, handlerRef);
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", handlerRef);
+        return;
+    }
+
+    le_ref_DeleteRef(NetRegHandlerRefMap, handlerRef);
+    le_event_RemoveHandler(handlerPtr->handlerRef);
+
+    if (NULL != handlerPtr->timerRef)
+    {
+        le_timer_Delete(handlerPtr->timerRef);
+    }
+
+    le_dls_Remove(&handlerPtr->clientPtr->handlerList, &handlerPtr->link);
+    le_mem_Release(handlerPtr->clientPtr);
+    le_mem_Release(handlerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the quiet period of the calling client's Network Registration State handlers.
+ *
+ * A state is only delivered once no other state has come for the quiet period; the states it
+ * replaces are dropped and counted.  Setting the quiet period to 0 delivers pending states at once.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mrc_SetNetRegStateQuietPeriod
+(
+    uint32_t quietPeriodMs  ///< [IN] Quiet period in milliseconds, 0 to deliver states at once.
+)
+{
+    NetRegClient_t* clientPtr = GetNetRegClient(le_mrc_GetClientSessionRef());
+
+    LE_DEBUG("Network Registration State quiet period of session %p set to %"PRIu32" ms",
+             clientPtr->sessionRef, quietPeriodMs);
+
+    clientPtr->quietPeriodMs = quietPeriodMs;
+
+    if (0 != quietPeriodMs)
+    {
+        return;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&clientPtr->handlerList);
+    while (NULL != linkPtr)
+    {
+        NetRegHandler_t* handlerPtr = CONTAINER_OF(linkPtr, NetRegHandler_t, link);
+
+        linkPtr = le_dls_PeekNext(&clientPtr->handlerList, linkPtr);
+
+        if ((NULL != handlerPtr->timerRef) && le_timer_IsRunning(handlerPtr->timerRef))
+        {
+            le_timer_Stop(handlerPtr->timerRef);
+            handlerPtr->handlerFunc(handlerPtr->pendingState, handlerPtr->contextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of Network Registration States the calling client's handlers did not get because
+ * a newer state came within the quiet period.
+ *
+ * @return The number of coalesced states.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_mrc_GetNetRegStateCoalescedCount
+(
+    void
+)
+{
+    return GetNetRegClient(le_mrc_GetClientSessionRef())->coalescedCount;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -3082,9 +3789,6 @@ le_result_t le_mrc_GetSignalQual
 {
     le_result_t   res;
     int32_t       rssi;   // The received signal strength (in dBm).
-    int32_t       thresholds[] = {-113, -100, -90, -80, -65}; // TODO: Verify thresholds !
-    uint32_t      i=0;
-    size_t        thresholdsCount = NUM_ARRAY_MEMBERS(thresholds);
 
     if (qualityPtr == NULL)
     {
@@ -3094,18 +3798,7 @@ le_result_t le_mrc_GetSignalQual
 
     if ((res=pa_mrc_GetSignalStrength(&rssi)) == LE_OK)
     {
-        for (i=0; i<thresholdsCount; i++)
-        {
-            if (rssi <= thresholds[i])
-            {
-                *qualityPtr = i;
-                break;
-            }
-        }
-        if (i == thresholdsCount)
-        {
-            *qualityPtr = i;
-        }
+        *qualityPtr = GetSignalQuality(rssi);
 
         LE_DEBUG("pa_mrc_GetSignalStrength has returned rssi=%ddBm", rssi);
         return LE_OK;
@@ -3252,11 +3945,9 @@ le_mrc_PciScanInformationListRef_t le_mrc_PerformPciNetworkScan
     newScanInformationListPtr->paPciScanInfoList = LE_DLS_LIST_INIT;
     newScanInformationListPtr->safeRefPciScanInfoList = LE_DLS_LIST_INIT;
     newScanInformationListPtr->currentLink = NULL;
-    LOCK();
-    result = pa_mrc_PerformNetworkScan(ratMask,
-                                       PA_MRC_SCAN_PCI,
-                                       &(newScanInformationListPtr->paPciScanInfoList));
-    UNLOCK();
+    result = GetNetworkScan(ratMask,
+                            PA_MRC_SCAN_PCI,
+                            &(newScanInformationListPtr->paPciScanInfoList));
     if (result != LE_OK)
     {
         LE_ERROR("Network scan error");
@@ -3291,11 +3982,9 @@ le_mrc_ScanInformationListRef_t le_mrc_PerformCellularNetworkScan
     newScanInformationListPtr->safeRefScanInfoList = LE_DLS_LIST_INIT;
     newScanInformationListPtr->currentLink = NULL;
 
-    LOCK();
-    result = pa_mrc_PerformNetworkScan(ratMask,
-                                       PA_MRC_SCAN_PLMN,
-                                       &(newScanInformationListPtr->paScanInfoList));
-    UNLOCK();
+    result = GetNetworkScan(ratMask,
+                            PA_MRC_SCAN_PLMN,
+                            &(newScanInformationListPtr->paScanInfoList));
 
     if (result != LE_OK)
     {
@@ -3501,7 +4190,7 @@ void le_mrc_DeleteCellularNetworkScan
     }
 
     scanInformationListPtr->currentLink = NULL;
-    pa_mrc_DeleteScanInformation(&(scanInformationListPtr->paScanInfoList));
+    DeleteScanInformationList(&(scanInformationListPtr->paScanInfoList));
 
     // Delete the safe Reference list.
     DeleteSafeRefList(&(scanInformationListPtr->safeRefScanInfoList));
@@ -4491,6 +5180,118 @@ le_result_t le_mrc_GetCdmaSignalMetrics
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to get a snapshot of the signal metrics of the serving cell and of
+ * the neighboring cells in a single call.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the signal metrics of the serving cell can't be measured
+ *
+ * @note If the caller is passing a bad pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_mrc_GetSignalSnapshot
+(
+    le_mrc_ServingSignalMetrics_t* servingPtr,      ///< [OUT] Serving cell metrics
+    le_mrc_NeighborCellMetrics_t*  neighborsPtr,    ///< [OUT] Neighboring cells metrics
+    size_t*                        neighborsSizePtr ///< [INOUT] Number of neighboring cells
+)
+{
+    pa_mrc_SignalMetrics_t paMetrics;
+    le_dls_List_t          paNgbrCellInfoList = LE_DLS_LIST_INIT;
+    size_t                 ngbrCount = 0;
+
+    if ((NULL == servingPtr) || (NULL == neighborsPtr) || (NULL == neighborsSizePtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer provided!");
+        return LE_FAULT;
+    }
+
+    // The RAT, the signal quality and the metrics of the serving cell are all derived from one
+    // measure, instead of a platform adaptor request each.
+    if (LE_OK != pa_mrc_MeasureSignalMetrics(&paMetrics))
+    {
+        LE_ERROR("Unable to measure the signal metrics!");
+        *neighborsSizePtr = 0;
+        return LE_FAULT;
+    }
+
+    servingPtr->rat = paMetrics.rat;
+    servingPtr->quality = GetSignalQuality(paMetrics.ss);
+    servingPtr->ss = paMetrics.ss;
+    servingPtr->er = paMetrics.er;
+    servingPtr->ecio = INT32_MAX;
+    servingPtr->rscp = INT32_MAX;
+    servingPtr->sinr = INT32_MAX;
+    servingPtr->io = INT32_MAX;
+    servingPtr->rsrq = INT32_MAX;
+    servingPtr->rsrp = INT32_MAX;
+    servingPtr->snr = INT32_MAX;
+
+    switch (paMetrics.rat)
+    {
+        case LE_MRC_RAT_UMTS:
+            servingPtr->ecio = paMetrics.umtsMetrics.ecio;
+            servingPtr->rscp = paMetrics.umtsMetrics.rscp;
+            break;
+
+        case LE_MRC_RAT_TDSCDMA:
+            servingPtr->ecio = paMetrics.tdscdmaMetrics.ecio;
+            servingPtr->rscp = paMetrics.tdscdmaMetrics.rscp;
+            servingPtr->sinr = paMetrics.tdscdmaMetrics.sinr;
+            break;
+
+        case LE_MRC_RAT_LTE:
+            servingPtr->rsrq = paMetrics.lteMetrics.rsrq;
+            servingPtr->rsrp = paMetrics.lteMetrics.rsrp;
+            servingPtr->snr = paMetrics.lteMetrics.snr;
+            break;
+
+        case LE_MRC_RAT_CDMA:
+            servingPtr->ecio = paMetrics.cdmaMetrics.ecio;
+            servingPtr->sinr = paMetrics.cdmaMetrics.sinr;
+            servingPtr->io = paMetrics.cdmaMetrics.io;
+            break;
+
+        default:
+            break;
+    }
+
+    if (pa_mrc_GetNeighborCellsInfo(&paNgbrCellInfoList) > 0)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&paNgbrCellInfoList);
+
+        while ((NULL != linkPtr) && (ngbrCount < *neighborsSizePtr))
+        {
+            pa_mrc_CellInfo_t* cellInfoPtr = CONTAINER_OF(linkPtr, pa_mrc_CellInfo_t, link);
+            le_mrc_NeighborCellMetrics_t* ngbrPtr = &neighborsPtr[ngbrCount++];
+            bool isLte = (LE_MRC_RAT_LTE == cellInfoPtr->rat);
+
+            ngbrPtr->rat = cellInfoPtr->rat;
+            ngbrPtr->cellId = cellInfoPtr->id;
+            ngbrPtr->lac = cellInfoPtr->lac;
+            ngbrPtr->rxLevel = cellInfoPtr->rxLevel;
+            ngbrPtr->ecio = (LE_MRC_RAT_UMTS == cellInfoPtr->rat) ?
+                            cellInfoPtr->umtsEcIo : INT32_MAX;
+            ngbrPtr->intraRsrq = isLte ? cellInfoPtr->lteIntraRsrq : INT32_MAX;
+            ngbrPtr->intraRsrp = isLte ? cellInfoPtr->lteIntraRsrp : INT32_MAX;
+            ngbrPtr->interRsrq = isLte ? cellInfoPtr->lteInterRsrq : INT32_MAX;
+            ngbrPtr->interRsrp = isLte ? cellInfoPtr->lteInterRsrp : INT32_MAX;
+
+            linkPtr = le_dls_PeekNext(&paNgbrCellInfoList, linkPtr);
+        }
+
+        pa_mrc_DeleteNeighborCellsInfo(&paNgbrCellInfoList);
+    }
+
+    *neighborsSizePtr = ngbrCount;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function sets signal strength indication thresholds for a specific RAT.
@@ -5204,56 +6005,32 @@ void le_mrc_DeletePciNetworkScan
     le_mrc_PciScanInformationListRef_t  scanInformationListRef ///< [IN] list of scan information
 )
 {
-    //Delet all the plminfo list in all PciScanInformation
-    le_mrc_PciScanInformationRef_t     scanInfoRef = NULL;
-
-    scanInfoRef = le_mrc_GetFirstPciScanInfo(scanInformationListRef);
-
-    pa_mrc_PciScanInformation_t* scanInformationPtr = le_ref_Lookup(PciScanInformationRefMap,
-                                                                 scanInfoRef);
-    if (scanInformationPtr == NULL)
+    PciScanInfoList_t* scanInformationListPtr = le_ref_Lookup(PciScanInformationListRefMap,
+                                                                         scanInformationListRef);
+    if (scanInformationListPtr == NULL)
     {
         LE_KILL_CLIENT("Invalid reference (%p) provided!", scanInformationListRef);
         return;
     }
-    scanInformationPtr->currentLink = NULL;
-    pa_mrc_DeletePlmnScanInformation(&(scanInformationPtr->plmnList));
-    // Delete the safe Reference list.
-    DeletePlmnSafeRefList(&(scanInformationPtr->safeRefPlmnInfoList));
-    // Invalidate the Safe Reference.
-    le_ref_DeleteRef(PlmnInformationRefMap, scanInfoRef);
-    while ((scanInfoRef = le_mrc_GetNextPciScanInfo(scanInformationListRef)) != NULL)
+
+    // Delete the plmn safe Reference lists of all the cells.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&(scanInformationListPtr->paPciScanInfoList));
+    while (linkPtr != NULL)
     {
-        pa_mrc_PciScanInformation_t* scanInformationPtr = le_ref_Lookup(PciScanInformationRefMap,
-                                                                 scanInfoRef);
-        if (scanInformationPtr == NULL)
-        {
-            LE_KILL_CLIENT("Invalid reference (%p) provided!", scanInformationListRef);
-            return;
-        }
+        pa_mrc_PciScanInformation_t* scanInformationPtr = CONTAINER_OF(linkPtr,
+                                                                   pa_mrc_PciScanInformation_t,
+                                                                   link);
         scanInformationPtr->currentLink = NULL;
-        pa_mrc_DeletePlmnScanInformation(&(scanInformationPtr->plmnList));
-        // Delete the safe Reference list.
         DeletePlmnSafeRefList(&(scanInformationPtr->safeRefPlmnInfoList));
-        // Invalidate the Safe Reference.
-        le_ref_DeleteRef(PlmnInformationRefMap, scanInfoRef);
+        linkPtr = le_dls_PeekNext(&(scanInformationListPtr->paPciScanInfoList), linkPtr);
     }
 
-    // Delete PciScanInformation liste
-
-    PciScanInfoList_t* scanInformationListPtr = le_ref_Lookup(PciScanInformationListRefMap,
-                                                                         scanInformationListRef);
-    if (scanInformationListPtr == NULL)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", scanInformationListRef);
-        return;
-    }
     scanInformationListPtr->currentLink = NULL;
-    pa_mrc_DeletePciScanInformation(&(scanInformationListPtr->paPciScanInfoList));
+    DeletePciScanInformationList(&(scanInformationListPtr->paPciScanInfoList));
     // Delete the safe Reference list.
     DeletePciSafeRefList(&(scanInformationListPtr->safeRefPciScanInfoList));
     // Invalidate the Safe Reference.
-    le_ref_DeleteRef(PlmnInformationRefMap, scanInformationListRef);
+    le_ref_DeleteRef(PciScanInformationListRefMap, scanInformationListRef);
     le_mem_Release(scanInformationListPtr);
 }
 
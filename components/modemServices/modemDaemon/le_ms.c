@@ -21,6 +21,8 @@
 #include "le_antenna_local.h"
 #include "le_riPin_local.h"
 #include "le_lpt_local.h"
+#include "le_adc_local.h"
+#include "sampler.h"
 #include "sysResets.h"
 #include "watchdogChain.h"
 
@@ -35,6 +37,7 @@ COMPONENT_INIT
 {
     le_wdogChain_Init(MS_WDOG_COUNT);
 
+    sampler_Init();
     le_mrc_Init();
     le_sim_Init();
     le_sms_Init();
@@ -42,6 +45,7 @@ COMPONENT_INIT
     le_mcc_Init();
     le_ips_Init();
     le_temp_Init();
+    le_adc_Init();
     le_antenna_Init();
     le_riPin_Init();
     le_ecall_Init();
@@ -34,6 +34,7 @@
 #define WDOG_THREAD_NAME_MDC_COMMAND_EVENT   "MdcEventThread"
 #define WDOG_THREAD_NAME_MRC_COMMAND_PROCESS "MrcProcessThread"
 #define WDOG_THREAD_NAME_SMS_COMMAND_SENDING "SmsSendingThread"
+#define WDOG_THREAD_NAME_SIM_APDU_SENDING    "SimApduThread"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -47,6 +48,7 @@ typedef enum
     MS_WDOG_SMS_LOOP,
     MS_WDOG_MRC_LOOP,
     MS_WDOG_RIPIN_LOOP,
+    MS_WDOG_SIM_LOOP,
 #if INCLUDE_ECALL
     MS_WDOG_ECALL_LOOP,
 #endif
@@ -10,7 +10,9 @@
 #include "interfaces.h"
 #include "pa_sim.h"
 #include "le_mrc_local.h"
+#include "le_ms_local.h"
 #include "mdmCfgEntries.h"
+#include "watchdogChain.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -19,6 +21,21 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_NUM_FPLMN_LISTS 1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Maximum number of cached elementary file reads per SIM.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_NUM_EF_CACHE_ENTRIES 8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Status words of a successful SIM command.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SW1_SUCCESS 0x90
+#define SW2_SUCCESS 0x00
+
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
 //--------------------------------------------------------------------------------------------------
@@ -60,9 +77,45 @@ typedef struct le_sim_Obj
     bool             isReacheable;               ///< SIM is reachable when its state is inserted,
                                                  ///< ready or blocked
     Subscription_t   subscription;               ///< Subscription type
+    le_dls_List_t    efCacheList;                ///< Cached elementary file reads
 }
 Sim_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached read of an immutable elementary file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sim_Command_t command;                              ///< Read command
+    char             fileId[LE_SIM_FILE_ID_BYTES];         ///< File identifier
+    char             path[LE_SIM_PATH_MAX_BYTES];          ///< Path of the elementary file
+    uint8_t          p1;                                   ///< Parameter P1 of the command
+    uint8_t          p2;                                   ///< Parameter P2 of the command
+    uint8_t          p3;                                   ///< Parameter P3 of the command
+    uint8_t          response[LE_SIM_RESPONSE_MAX_BYTES];  ///< SIM response
+    size_t           responseLen;                          ///< SIM response length
+    le_dls_Link_t    link;                                 ///< Link in the SIM cache list
+}
+EfCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued APDU request.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sim_Id_t                      simId;                        ///< SIM identifier
+    uint8_t                          channel;                      ///< Logical channel number
+    uint8_t                          apdu[LE_SIM_APDU_MAX_BYTES];  ///< APDU command
+    size_t                           apduLen;                      ///< APDU command length
+    le_sim_ApduResponseHandlerFunc_t handlerFunc;                  ///< Response handler
+    void*                            contextPtr;                   ///< Handler context
+}
+ApduRequest_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SIM state event.
@@ -262,6 +315,42 @@ static le_mem_PoolRef_t FPLMNListPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t FPLMNOperatorPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the cached elementary file reads.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EfCachePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Elementary files which do not change during the life of a SIM profile, whose reads are cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const ImmutableEfList[] =
+{
+    "2FE2",     ///< EF-ICCID
+    "2F00",     ///< EF-DIR
+    "6F07",     ///< EF-IMSI
+    "6FAD",     ///< EF-AD
+    "6F46",     ///< EF-SPN
+    "6F38",     ///< EF-UST
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID for the queued APDU requests, processed by the APDU thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t ApduRequestEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex serializing the APDU exchanges of the APDU thread and of the service API.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t ApduMutexRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check if the APDU response notifies a correct execution of the APDU command with a normal ending.
@@ -426,6 +515,261 @@ static le_result_t SelectSIMCard
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an elementary file does not change during the life of a SIM profile.
+ *
+ * @return true if the reads of the file can be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsImmutableEf
+(
+    const char* fileIdPtr   ///< [IN] File identifier
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ImmutableEfList); i++)
+    {
+        if (0 == strcasecmp(fileIdPtr, ImmutableEfList[i]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush the cached elementary file reads of a SIM.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushEfCache
+(
+    Sim_t* simPtr   ///< [IN,OUT] The SIM structure
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Pop(&simPtr->efCacheList)))
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, EfCacheEntry_t, link));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush the cached reads of one elementary file of a SIM.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushEfCacheFile
+(
+    Sim_t*      simPtr,     ///< [IN,OUT] The SIM structure
+    const char* fileIdPtr   ///< [IN] File identifier
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&simPtr->efCacheList);
+
+    while (NULL != linkPtr)
+    {
+        EfCacheEntry_t* entryPtr = CONTAINER_OF(linkPtr, EfCacheEntry_t, link);
+        linkPtr = le_dls_PeekNext(&simPtr->efCacheList, linkPtr);
+
+        if (0 == strcasecmp(entryPtr->fileId, fileIdPtr))
+        {
+            le_dls_Remove(&simPtr->efCacheList, &entryPtr->link);
+            le_mem_Release(entryPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for a cached elementary file read of a SIM.
+ *
+ * @return The cached read, or NULL if the read is not cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static EfCacheEntry_t* GetEfCacheEntry
+(
+    Sim_t*           simPtr,     ///< [IN] The SIM structure
+    le_sim_Command_t command,    ///< [IN] Read command
+    const char*      fileIdPtr,  ///< [IN] File identifier
+    uint8_t          p1,         ///< [IN] Parameter P1 of the command
+    uint8_t          p2,         ///< [IN] Parameter P2 of the command
+    uint8_t          p3,         ///< [IN] Parameter P3 of the command
+    const char*      pathPtr     ///< [IN] Path of the elementary file
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&simPtr->efCacheList);
+
+    while (NULL != linkPtr)
+    {
+        EfCacheEntry_t* entryPtr = CONTAINER_OF(linkPtr, EfCacheEntry_t, link);
+
+        if (   (entryPtr->command == command)
+            && (entryPtr->p1 == p1)
+            && (entryPtr->p2 == p2)
+            && (entryPtr->p3 == p3)
+            && (0 == strcasecmp(entryPtr->fileId, fileIdPtr))
+            && (0 == strcasecmp(entryPtr->path, pathPtr)))
+        {
+            return entryPtr;
+        }
+        linkPtr = le_dls_PeekNext(&simPtr->efCacheList, linkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache an elementary file read of a SIM. The oldest cached read is dropped if the cache is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddEfCacheEntry
+(
+    Sim_t*           simPtr,         ///< [IN,OUT] The SIM structure
+    le_sim_Command_t command,        ///< [IN] Read command
+    const char*      fileIdPtr,      ///< [IN] File identifier
+    uint8_t          p1,             ///< [IN] Parameter P1 of the command
+    uint8_t          p2,             ///< [IN] Parameter P2 of the command
+    uint8_t          p3,             ///< [IN] Parameter P3 of the command
+    const char*      pathPtr,        ///< [IN] Path of the elementary file
+    const uint8_t*   responsePtr,    ///< [IN] SIM response
+    size_t           responseLen     ///< [IN] SIM response length
+)
+{
+    EfCacheEntry_t* entryPtr;
+
+    if (   (responseLen > LE_SIM_RESPONSE_MAX_BYTES)
+        || (strlen(fileIdPtr) >= LE_SIM_FILE_ID_BYTES)
+        || (strlen(pathPtr) >= LE_SIM_PATH_MAX_BYTES))
+    {
+        return;
+    }
+
+    if (le_dls_NumLinks(&simPtr->efCacheList) >= MAX_NUM_EF_CACHE_ENTRIES)
+    {
+        le_mem_Release(CONTAINER_OF(le_dls_Pop(&simPtr->efCacheList), EfCacheEntry_t, link));
+    }
+
+    entryPtr = le_mem_ForceAlloc(EfCachePool);
+    entryPtr->command = command;
+    le_utf8_Copy(entryPtr->fileId, fileIdPtr, sizeof(entryPtr->fileId), NULL);
+    le_utf8_Copy(entryPtr->path, pathPtr, sizeof(entryPtr->path), NULL);
+    entryPtr->p1 = p1;
+    entryPtr->p2 = p2;
+    entryPtr->p3 = p3;
+    memcpy(entryPtr->response, responsePtr, responseLen);
+    entryPtr->responseLen = responseLen;
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&simPtr->efCacheList, &entryPtr->link);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send an APDU to a SIM. The APDU exchanges of the service API and of the APDU thread are
+ * serialized.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      The function failed to select the SIM card for this operation.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendApdu
+(
+    le_sim_Id_t    simId,                  ///< [IN] The SIM identifier
+    uint8_t        channel,                ///< [IN] The logical channel number
+    const uint8_t* commandApduPtr,         ///< [IN] APDU command
+    size_t         commandApduNumElements, ///< [IN] APDU command size
+    uint8_t*       responseApduPtr,        ///< [OUT] SIM response
+    size_t*        responseApduNumElementsPtr ///< [INOUT] SIM response size
+)
+{
+    le_result_t result;
+
+    le_mutex_Lock(ApduMutexRef);
+
+    result = SelectSIMCard(simId);
+    if (LE_OK == result)
+    {
+        // Send APDU through opened logical channel
+        LE_DEBUG("Send APDU on logical channel %d", channel);
+        LE_DUMP(commandApduPtr, commandApduNumElements);
+        result = pa_sim_SendApdu(channel,
+                                 commandApduPtr,
+                                 commandApduNumElements,
+                                 responseApduPtr,
+                                 responseApduNumElementsPtr);
+    }
+
+    le_mutex_Unlock(ApduMutexRef);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process a queued APDU request in the APDU thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessApduRequestHandler
+(
+    void* reportPtr     ///< [IN] The queued APDU request
+)
+{
+    ApduRequest_t* requestPtr = reportPtr;
+    uint8_t        response[LE_SIM_RESPONSE_MAX_BYTES];
+    size_t         responseLen = sizeof(response);
+
+    le_result_t result = SendApdu(requestPtr->simId,
+                                  requestPtr->channel,
+                                  requestPtr->apdu,
+                                  requestPtr->apduLen,
+                                  response,
+                                  &responseLen);
+    if (LE_OK != result)
+    {
+        responseLen = 0;
+    }
+
+    requestPtr->handlerFunc(requestPtr->simId, result, response, responseLen,
+                            requestPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This thread sends the queued APDUs to the SIM, one at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SimApduThread
+(
+    void* contextPtr
+)
+{
+    le_sem_Ref_t initSemaphore = (le_sem_Ref_t)contextPtr;
+
+    le_event_AddHandler("ProcessApduRequestHandler",
+                        ApduRequestEventId,
+                        ProcessApduRequestHandler);
+
+    le_sem_Post(initSemaphore);
+
+    // Watchdog SIM loop
+    // Try to kick a couple of times before each timeout.
+    le_clk_Time_t watchdogInterval = { .sec = MS_WDOG_INTERVAL };
+    le_wdogChain_MonitorEventLoop(MS_WDOG_SIM_LOOP, watchdogInterval);
+
+    // Run the event loop
+    le_event_RunLoop();
+
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * First layer: Profile update notification handler.
@@ -786,6 +1130,7 @@ static void GetSimCardInformation
     switch(state)
     {
         case LE_SIM_ABSENT:
+            FlushEfCache(simPtr);
             simPtr->isReacheable = false;
             simPtr->ICCID[0] = '\0';
             simPtr->IMSI[0] = '\0';
@@ -796,6 +1141,7 @@ static void GetSimCardInformation
 
         case LE_SIM_INSERTED:
         case LE_SIM_BLOCKED:
+            FlushEfCache(simPtr);
             simPtr->isReacheable = true;
             simPtr->isPresent = true;
             simPtr->IMSI[0] = '\0';
@@ -1228,6 +1574,7 @@ le_result_t le_sim_Init
         SimList[i].isPresent = false;
         SimList[i].isReacheable = false;
         SimList[i].subscription = UNKNOWN_SUBSCRIPTION;
+        SimList[i].efCacheList = LE_DLS_LIST_INIT;
     }
 
     // Create FPLMN list pool
@@ -1239,6 +1586,22 @@ le_result_t le_sim_Init
     // Create the FPLMN operator memory pool
     FPLMNOperatorPool = le_mem_CreatePool("FPLMNOperatorPool", sizeof(pa_sim_FPLMNOperator_t));
 
+    // Create the pool for the cached elementary file reads
+    EfCachePool = le_mem_CreatePool("EfCachePool", sizeof(EfCacheEntry_t));
+
+    // Create the APDU thread, which sends the queued APDUs to the SIM
+    ApduMutexRef = le_mutex_CreateNonRecursive("ApduMutex");
+    ApduRequestEventId = le_event_CreateId("ApduRequestEvent", sizeof(ApduRequest_t));
+
+    // initSemaphore is used to wait for SimApduThread() execution. It ensures that the thread is
+    // ready when we exit from le_sim_Init().
+    le_sem_Ref_t initSemaphore = le_sem_Create("SimInitSem", 0);
+    le_thread_Start(le_thread_Create(WDOG_THREAD_NAME_SIM_APDU_SENDING,
+                                     SimApduThread,
+                                     (void*)initSemaphore));
+    le_sem_Wait(initSemaphore);
+    le_sem_Delete(initSemaphore);
+
     // Add a handler to the close session service.
     le_msg_AddServiceCloseHandler(le_sim_GetServiceRef(), CloseSessionEventHandler, NULL);
 
@@ -2775,6 +3138,10 @@ le_result_t le_sim_SendCommand
     size_t* responseNumElementsPtr  ///< [INOUT]
 )
 {
+    Sim_t*      simPtr;
+    bool        isCacheable;
+    le_result_t result;
+
     if ((simId >= LE_SIM_ID_MAX) ||
         (command >= LE_SIM_COMMAND_MAX) ||
         (dataNumElements > LE_SIM_DATA_MAX_BYTES) ||
@@ -2784,19 +3151,66 @@ le_result_t le_sim_SendCommand
         return LE_BAD_PARAMETER;
     }
 
-    return pa_sim_SendCommand( command,
-                               fileIdentifier,
-                               p1,
-                               p2,
-                               p3,
-                               dataPtr,
-                               dataNumElements,
-                               path,
-                               sw1Ptr,
-                               sw2Ptr,
-                               responsePtr,
-                               responseNumElementsPtr
-                             );
+    simPtr = &SimList[simId];
+    isCacheable = ((LE_SIM_READ_RECORD == command) || (LE_SIM_READ_BINARY == command))
+                  && IsImmutableEf(fileIdentifier);
+
+    if (isCacheable)
+    {
+        EfCacheEntry_t* entryPtr = GetEfCacheEntry(simPtr, command, fileIdentifier,
+                                                   p1, p2, p3, path);
+        if (entryPtr)
+        {
+            LE_DEBUG("Read of file %s found in the cache of SIM %d", fileIdentifier, simId);
+
+            if (entryPtr->responseLen > *responseNumElementsPtr)
+            {
+                return LE_OVERFLOW;
+            }
+            memcpy(responsePtr, entryPtr->response, entryPtr->responseLen);
+            *responseNumElementsPtr = entryPtr->responseLen;
+            *sw1Ptr = SW1_SUCCESS;
+            *sw2Ptr = SW2_SUCCESS;
+            return LE_OK;
+        }
+    }
+    else if ((LE_SIM_UPDATE_RECORD == command) || (LE_SIM_UPDATE_BINARY == command))
+    {
+        FlushEfCacheFile(simPtr, fileIdentifier);
+    }
+
+    le_mutex_Lock(ApduMutexRef);
+
+    result = SelectSIMCard(simId);
+    if (LE_OK == result)
+    {
+        result = pa_sim_SendCommand( command,
+                                     fileIdentifier,
+                                     p1,
+                                     p2,
+                                     p3,
+                                     dataPtr,
+                                     dataNumElements,
+                                     path,
+                                     sw1Ptr,
+                                     sw2Ptr,
+                                     responsePtr,
+                                     responseNumElementsPtr
+                                   );
+    }
+
+    le_mutex_Unlock(ApduMutexRef);
+
+    if (   isCacheable
+        && (LE_OK == result)
+        && (SW1_SUCCESS == *sw1Ptr)
+        && (SW2_SUCCESS == *sw2Ptr))
+    {
+        AddEfCacheEntry(simPtr, command, fileIdentifier, p1, p2, p3, path,
+                        responsePtr, *responseNumElementsPtr);
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -3204,19 +3618,64 @@ le_result_t le_sim_SendApduOnChannel
         return LE_BAD_PARAMETER;
     }
 
-    if (LE_OK != SelectSIMCard(simId))
+    return SendApdu(simId,
+                    channel,
+                    commandApduPtr,
+                    commandApduNumElements,
+                    responseApduPtr,
+                    responseApduNumElementsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue an APDU command to be sent on a logical channel. This function is not blocking, the
+ * response will be returned with the handler function.
+ *
+ * The handler result is:
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  A parameter is invalid.
+ *      - LE_NOT_FOUND      The function failed to select the SIM card for this operation.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sim_QueueApdu
+(
+    le_sim_Id_t simId,                           ///< [IN] The SIM identifier
+    uint8_t channel,                             ///< [IN] The logical channel number
+    const uint8_t* commandApduPtr,               ///< [IN] APDU command
+    size_t commandApduNumElements,               ///< [IN] APDU command size
+    le_sim_ApduResponseHandlerFunc_t handlerPtr, ///< [IN] Handler for the SIM response
+    void* contextPtr                             ///< [IN] Handler context
+)
+{
+    ApduRequest_t request;
+
+    if (NULL == handlerPtr)
     {
-        return LE_NOT_FOUND;
+        LE_KILL_CLIENT("handlerPtr is NULL !");
+        return;
     }
 
-    // Send APDU through opened logical channel
-    LE_DEBUG("Send APDU on logical channel %d", channel);
-    LE_DUMP(commandApduPtr, commandApduNumElements);
-    return pa_sim_SendApdu(channel,
-                           commandApduPtr,
-                           commandApduNumElements,
-                           responseApduPtr,
-                           responseApduNumElementsPtr);
+    if (   (NULL == commandApduPtr)
+        || (commandApduNumElements > LE_SIM_APDU_MAX_BYTES)
+        || (simId >= LE_SIM_ID_MAX))
+    {
+        uint8_t noResponse[1] = {0};
+
+        LE_ERROR("Invalid APDU request");
+        handlerPtr(simId, LE_BAD_PARAMETER, noResponse, 0, contextPtr);
+        return;
+    }
+
+    request.simId = simId;
+    request.channel = channel;
+    memcpy(request.apdu, commandApduPtr, commandApduNumElements);
+    request.apduLen = commandApduNumElements;
+    request.handlerFunc = handlerPtr;
+    request.contextPtr = contextPtr;
+
+    LE_DEBUG("Queue APDU on logical channel %d", channel);
+    le_event_Report(ApduRequestEventId, &request, sizeof(request));
 }
 //--------------------------------------------------------------------------------------------------
 /**
@@ -69,6 +69,13 @@
 //--------------------------------------------------------------------------------------------------
 #define SMS_MAX_SESSION 5
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of long text messages we expect to have at one time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_NUM_OF_LONG_TEXT    16
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS command Type.
@@ -112,8 +119,12 @@ typedef struct le_sms_Msg
         char          text[LE_SMS_TEXT_MAX_BYTES];         ///< SMS text.
         uint8_t       binary[LE_SMS_BINARY_MAX_BYTES];     ///< SMS binary.
     };
+    char*             longTextPtr;                         ///< SMS text longer than
+                                                           ///< LE_SMS_TEXT_MAX_LEN, or NULL.
     size_t            userdataLen;                         ///< Length of data associated with SMS.
     ///  formats text or binary
+    bool              userdataPending;                     ///< Is the user data still to be
+                                                           ///< decoded from the PDU?
     pa_sms_Protocol_t protocol;                            ///< SMS Protocol (GSM or CDMA).
     int32_t           smsUserCount;                        ///< Current sms user counter.
     bool              delAsked;                            ///< Whether the SMS deletion is asked.
@@ -192,6 +203,21 @@ typedef struct
 le_sms_MsgStats_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data structure for message sending statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t queuedCount;       ///< Number of messages waiting to be sent asynchronously.
+    uint32_t maxQueuedCount;    ///< Highest number of messages waiting to be sent asynchronously.
+    uint32_t pduCount;          ///< Number of PDUs given to the modem.
+    uint64_t sendTimeMs;        ///< Total time taken to send the PDUs, in milliseconds.
+}
+SendStats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * session context node structure used for the SessionCtxList list.
@@ -309,6 +335,13 @@ static le_mem_PoolRef_t   SessionCtxPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t   MsgRefPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for the text of long text messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   LongTextPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Safe Reference Map for handlers objects.
@@ -346,6 +379,27 @@ static le_sem_Ref_t SmsSem;
 //--------------------------------------------------------------------------------------------------
 static le_sms_MsgStats_t MessageStats;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message sending statistics, updated by both the main thread and the sending thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static SendStats_t SendStats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting SendStats.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t SendStatsMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference number of the next concatenated message, only used with SmsSem taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ConcatRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS Status Report activation state.
@@ -616,6 +670,36 @@ static void ReInitializeList
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the text of a long text message, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseLongText
+(
+    le_sms_Msg_t* msgPtr         ///< [IN] The message object.
+)
+{
+    if (msgPtr->longTextPtr)
+    {
+        le_mem_Release(msgPtr->longTextPtr);
+        msgPtr->longTextPtr = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor of message objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MsgDestructor
+(
+    void* objPtr                 ///< [IN] The message object.
+)
+{
+    ReleaseLongText((le_sms_Msg_t*)objPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create and Populate a new message object from an unknown PDU encoding.
@@ -962,6 +1046,39 @@ static le_sms_Msg_t* CreateAndPopulateMessage
     return newSmsMsgObjPtr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the user data of a message from a list, if it was not decoded yet. The decoded data is
+ * kept in the message object.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DecodePendingUserdata
+(
+    le_sms_Msg_t* msgPtr    ///< [IN] Message object pointer.
+)
+{
+    pa_sms_Message_t decodedMsg;
+
+    if (!msgPtr->userdataPending)
+    {
+        return;
+    }
+    msgPtr->userdataPending = false;
+
+    if ((smsPdu_Decode(msgPtr->pdu.protocol,
+                       msgPtr->pdu.data,
+                       msgPtr->pdu.dataLen,
+                       true,
+                       &decodedMsg) != LE_OK) ||
+        (decodedMsg.type != PA_SMS_DELIVER) ||
+        (PopulateSmsDeliver(msgPtr, &msgPtr->pdu, &decodedMsg) != LE_OK))
+    {
+        LE_WARN("Could not decode the user data of message (idx.%d)", msgPtr->storageIdx);
+        msgPtr->userdataLen = 0;
+        msgPtr->text[0] = '\0';
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieve messages from memory. A new message object is created for each retrieved message and
@@ -1017,14 +1134,14 @@ static int32_t GetMessagesFromMem
             continue;
         }
 
-        // Try to decode message.
+        // Try to decode message. The user data is only decoded when the client asks for it.
         pa_sms_Message_t messageConverted;
 
-        if (smsPdu_Decode(messagePdu.protocol,
-                          messagePdu.data,
-                          messagePdu.dataLen,
-                          true,
-                          &messageConverted) == LE_OK)
+        if (smsPdu_DecodeHeader(messagePdu.protocol,
+                                messagePdu.data,
+                                messagePdu.dataLen,
+                                true,
+                                &messageConverted) == LE_OK)
         {
             if (messageConverted.type != PA_SMS_SUBMIT)
             {
@@ -1039,6 +1156,7 @@ static int32_t GetMessagesFromMem
                 // Store sms area storage information.
                 newSmsMsgObjPtr->storage = storage;
                 newSmsMsgObjPtr->inAList = true;
+                newSmsMsgObjPtr->userdataPending = (messageConverted.type == PA_SMS_DELIVER);
 
                 // Allocate a new node message for the List SMS Message node.
                 le_sms_MsgReference_t* newReferencePtr =
@@ -1334,7 +1452,22 @@ static le_result_t EncodeMessageToPdu
             LE_DEBUG("Try to encode Text Msg %p, tel.%s, text.%s, userdataLen %zd, protocol %d",
                      msgPtr, msgPtr->tel, msgPtr->text, msgPtr->userdataLen, msgPtr->protocol);
 
-            /* @todo send split messages */
+            if (msgPtr->longTextPtr)
+            {
+                // Long texts are encoded part by part while being sent.
+                if (PA_SMS_PROTOCOL_GSM != msgPtr->protocol)
+                {
+                    LE_ERROR("Long text messages are not supported with protocol %d",
+                             msgPtr->protocol);
+                    result = LE_UNSUPPORTED;
+                }
+                else
+                {
+                    result = LE_OK;
+                }
+                break;
+            }
+
             data.messagePtr = (const uint8_t*)msgPtr->text;
             data.length = msgPtr->userdataLen;
             data.encoding = SMSPDU_7_BITS;
@@ -1911,7 +2044,8 @@ static le_result_t CheckAndEncodeMessage
     switch (msgPtr->format)
     {
         case LE_SMS_FORMAT_TEXT:
-            if ((0 == msgPtr->userdataLen) || ('\0' == msgPtr->text[0]))
+            if ((0 == msgPtr->userdataLen) ||
+                ((NULL == msgPtr->longTextPtr) && ('\0' == msgPtr->text[0])))
             {
                 LE_ERROR("Text content is invalid for Message Object %p", msgPtr);
                 return LE_FORMAT_ERROR;
@@ -1967,6 +2101,122 @@ static le_result_t CheckAndEncodeMessage
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the PDU of a message, and update the sending statistics.
+ *
+ * @return The result of pa_sms_SendPduMsg().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendPdu
+(
+    le_sms_Msg_t* msgPtr         ///< [IN] The message to send.
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    le_result_t result = pa_sms_SendPduMsg(msgPtr->protocol, msgPtr->pdu.dataLen,
+                                           msgPtr->pdu.data, &msgPtr->messageReference,
+                                           PA_SMS_SENDING_TIMEOUT, &msgPtr->pdu.errorCode);
+
+    le_clk_Time_t sendTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    le_mutex_Lock(SendStatsMutex);
+    SendStats.pduCount++;
+    SendStats.sendTimeMs += (uint64_t)sendTime.sec * 1000 + sendTime.usec / 1000;
+    le_mutex_Unlock(SendStatsMutex);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a long text message: its text is split into parts of a concatenated message, which are
+ * encoded and sent one after the other. The sending stops at the first part which fails.
+ *
+ * @return The result of pa_sms_SendPduMsg() for the last part sent, or LE_FAULT if a part can't
+ *         be encoded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendLongText
+(
+    le_sms_Msg_t* msgPtr         ///< [IN] The message to send.
+)
+{
+    const uint8_t* textPtr = (const uint8_t*)msgPtr->longTextPtr;
+    smsPdu_DataToEncode_t data;
+    size_t offset = 0;
+    size_t partCount = 0;
+    le_result_t result = LE_OK;
+
+    // All the parts carry the number of parts in their header.
+    while (offset < msgPtr->userdataLen)
+    {
+        offset += smsPdu_Get7BitsSplitLength(textPtr + offset, msgPtr->userdataLen - offset,
+                                             SMSPDU_CONCAT_7BITS_MAX_LEN);
+        partCount++;
+    }
+
+    memset(&data, 0, sizeof(data));
+    data.protocol = msgPtr->protocol;
+    data.addressPtr = msgPtr->tel;
+    data.statusReport = StatusReportActivation;
+    data.encoding = SMSPDU_7_BITS;
+    data.messageType = PA_SMS_SUBMIT;
+    data.concatCount = partCount;
+    data.concatRef = ConcatRef++;
+
+    for (offset = 0; (offset < msgPtr->userdataLen) && (LE_OK == result); offset += data.length)
+    {
+        data.messagePtr = textPtr + offset;
+        data.length = smsPdu_Get7BitsSplitLength(data.messagePtr, msgPtr->userdataLen - offset,
+                                                 SMSPDU_CONCAT_7BITS_MAX_LEN);
+        data.concatSeq++;
+
+        LE_DEBUG("Send part %d/%d of Msg %p, tel.%s, length %zd", data.concatSeq,
+                 data.concatCount, msgPtr, msgPtr->tel, data.length);
+
+        if (LE_OK != smsPdu_Encode(&data, &msgPtr->pdu))
+        {
+            LE_ERROR("Failed to encode part %d of Message Object %p", data.concatSeq, msgPtr);
+            return LE_FAULT;
+        }
+
+        result = SendPdu(msgPtr);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a message, in one PDU or in the parts of a concatenated message.
+ *
+ * @return The result of pa_sms_SendPduMsg(), or LE_FAULT if a part can't be encoded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendMessage
+(
+    le_sms_Msg_t* msgPtr         ///< [IN] The message to send.
+)
+{
+    le_result_t result;
+
+    // The parts of a concatenated message are not interleaved with other messages.
+    le_sem_Wait(SmsSem);
+    if ((LE_SMS_FORMAT_TEXT == msgPtr->format) && (msgPtr->longTextPtr))
+    {
+        result = SendLongText(msgPtr);
+    }
+    else
+    {
+        result = SendPdu(msgPtr);
+    }
+    le_sem_Post(SmsSem);
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send connection state event.
@@ -2054,6 +2304,14 @@ static le_result_t SendAsyncSMS
         msgPtr->callBackPtr = callBack;
         msgPtr->ctxPtr = context;
 
+        le_mutex_Lock(SendStatsMutex);
+        SendStats.queuedCount++;
+        if (SendStats.queuedCount > SendStats.maxQueuedCount)
+        {
+            SendStats.maxQueuedCount = SendStats.queuedCount;
+        }
+        le_mutex_Unlock(SendStatsMutex);
+
         LE_INFO("Send Send command for message (%p)", msgRef);
         le_event_Report(SmsCommandEventId, &msgCommand, sizeof(msgCommand));
     }
@@ -2082,6 +2340,10 @@ static void ProcessSmsSendingCommandHandler
     uint32_t command = ((CmdRequest_t*)msgCommand)->command;
     le_sms_MsgRef_t messageRef = ((CmdRequest_t*)msgCommand)->msgRef;
 
+    le_mutex_Lock(SendStatsMutex);
+    SendStats.queuedCount--;
+    le_mutex_Unlock(SendStatsMutex);
+
     le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, messageRef);
 
     if (NULL == msgPtr)
@@ -2094,12 +2356,9 @@ static void ProcessSmsSendingCommandHandler
     {
         case LE_SMS_CMD_TYPE_SEND:
         {
-            le_sem_Wait(SmsSem);
             LE_INFO("LE_SMS_CMD_TYPE_SEND message (%p) ", messageRef);
 
-            res = pa_sms_SendPduMsg(msgPtr->protocol, msgPtr->pdu.dataLen, msgPtr->pdu.data,
-                                    &msgPtr->messageReference, PA_SMS_SENDING_TIMEOUT,
-                                    &msgPtr->pdu.errorCode);
+            res = SendMessage(msgPtr);
             if (LE_OK == res)
             {
                 msgPtr->pdu.status = LE_SMS_SENT;
@@ -2113,7 +2372,6 @@ static void ProcessSmsSendingCommandHandler
                 msgPtr->pdu.status = LE_SMS_SENDING_FAILED;
             }
             LE_INFO("Async send command status: %d", msgPtr->pdu.status);
-            le_sem_Post(SmsSem);
             SendSmsSendingStateEvent(messageRef);
         }
         break;
@@ -2249,6 +2507,11 @@ le_result_t le_sms_Init
     // Create a pool for Message objects.
     MsgPool = le_mem_CreatePool("SmsMsgPool", sizeof(le_sms_Msg_t));
     le_mem_ExpandPool(MsgPool, MAX_NUM_OF_SMS_MSG);
+    le_mem_SetDestructor(MsgPool, MsgDestructor);
+
+    // Create a pool for the text of long text messages.
+    LongTextPool = le_mem_CreatePool("SmsLongTextPool", LE_SMS_LONG_TEXT_MAX_BYTES);
+    le_mem_ExpandPool(LongTextPool, MAX_NUM_OF_LONG_TEXT);
 
     // Create the Safe Reference Map to use for Message object Safe References.
     MsgRefMap = le_ref_CreateMap("SmsMsgMap", MAX_NUM_OF_SMS_MSG);
@@ -2293,6 +2556,7 @@ le_result_t le_sms_Init
     }
 
     SmsSem = le_sem_Create("SmsSem", 1);
+    SendStatsMutex = le_mutex_CreateNonRecursive("SmsSendStatsMutex");
 
     // Init the SMS command Event Id.
     SmsCommandEventId = le_event_CreateId("SmsSendCmd", sizeof(CmdRequest_t));
@@ -2348,6 +2612,7 @@ le_sms_MsgRef_t le_sms_Create
     msgPtr->timestamp[0] = '\0';
     msgPtr->tel[0] = '\0';
     msgPtr->text[0] = '\0';
+    msgPtr->longTextPtr = NULL;
     msgPtr->userdataLen = 0;
     msgPtr->pduReady = false;
     msgPtr->pdu.status = LE_SMS_UNSENT;
@@ -2869,6 +3134,8 @@ size_t le_sms_GetUserdataLen
         return 0;
     }
 
+    DecodePendingUserdata(msgPtr);
+
     switch (msgPtr->format)
     {
         case LE_SMS_FORMAT_TEXT:
@@ -2972,6 +3239,8 @@ le_result_t le_sms_GetUCS2
         return LE_FORMAT_ERROR;
     }
 
+    DecodePendingUserdata(msgPtr);
+
     if (msgPtr->userdataLen > (*ucs2NumElementsPtr*2))
     {
         memcpy((uint8_t *) ucs2Ptr, msgPtr->binary, (*ucs2NumElementsPtr*2));
@@ -3161,6 +3430,7 @@ le_result_t le_sms_SetText
         return LE_BAD_PARAMETER;
     }
 
+    ReleaseLongText(msgPtr);
     msgPtr->format = LE_SMS_FORMAT_TEXT;
     msgPtr->userdataLen = length;
     msgPtr->pduReady = false;
@@ -3172,6 +3442,69 @@ le_result_t le_sms_SetText
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a Text Message content which may be longer than LE_SMS_TEXT_MAX_LEN characters. A longer
+ * text is sent as a concatenated message.
+ *
+ * @return LE_NOT_PERMITTED Message is Read-Only.
+ * @return LE_BAD_PARAMETER Text message length is equal to zero.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If message is too long (max LE_SMS_LONG_TEXT_MAX_LEN digits), it is a fatal error, the
+ *       function will not return.
+ *
+ * @note If the caller is passing a bad pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_SetLongText
+(
+    le_sms_MsgRef_t       msgRef, ///< [IN] The pointer to the message data structure.
+    const char*           textPtr ///< [IN] The SMS text.
+)
+{
+    le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, msgRef);
+
+    if (msgPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", msgRef);
+        return LE_NOT_FOUND;
+    }
+
+    size_t length = strnlen(textPtr, LE_SMS_LONG_TEXT_MAX_BYTES);
+
+    if (length > (LE_SMS_LONG_TEXT_MAX_BYTES-1))
+    {
+        LE_KILL_CLIENT("strlen(text) > %d", (LE_SMS_LONG_TEXT_MAX_BYTES-1));
+        return LE_FAULT;
+    }
+    else if (length <= (LE_SMS_TEXT_MAX_BYTES-1))
+    {
+        return le_sms_SetText(msgRef, textPtr);
+    }
+
+    if(msgPtr->readonly)
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    if (NULL == msgPtr->longTextPtr)
+    {
+        msgPtr->longTextPtr = le_mem_ForceAlloc(LongTextPool);
+    }
+
+    msgPtr->format = LE_SMS_FORMAT_TEXT;
+    msgPtr->userdataLen = length;
+    msgPtr->pduReady = false;
+    msgPtr->text[0] = '\0';
+    LE_DEBUG("Copy long text, len.%zd for msgPtr.%p", length, msgPtr);
+
+    strncpy(msgPtr->longTextPtr, textPtr, LE_SMS_LONG_TEXT_MAX_BYTES);
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the binary message content.
@@ -3415,13 +3748,17 @@ le_result_t le_sms_GetText
         return LE_FORMAT_ERROR;
     }
 
-    if (strlen(msgPtr->text) > (len - 1))
+    DecodePendingUserdata(msgPtr);
+
+    const char* srcPtr = (msgPtr->longTextPtr) ? msgPtr->longTextPtr : msgPtr->text;
+
+    if (strlen(srcPtr) > (len - 1))
     {
         return LE_OVERFLOW;
     }
     else
     {
-        strncpy(textPtr, msgPtr->text, len);
+        strncpy(textPtr, srcPtr, len);
     }
     return LE_OK;
 }
@@ -3476,6 +3813,8 @@ le_result_t le_sms_GetBinary
         return LE_FORMAT_ERROR;
     }
 
+    DecodePendingUserdata(msgPtr);
+
     if (msgPtr->userdataLen > *lenPtr)
     {
         memcpy(binPtr, msgPtr->binary, *lenPtr);
@@ -3732,11 +4071,7 @@ le_result_t le_sms_Send
         LE_DEBUG("Try to send PDU Msg %p, pdu.%p, pduLen.%u with protocol %d",
                         msgPtr, msgPtr->pdu.data, msgPtr->pdu.dataLen, msgPtr->protocol);
 
-        le_sem_Wait(SmsSem);
-        result = pa_sms_SendPduMsg(msgPtr->protocol, msgPtr->pdu.dataLen, msgPtr->pdu.data,
-                                   &msgPtr->messageReference, PA_SMS_SENDING_TIMEOUT,
-                                   &msgPtr->pdu.errorCode);
-        le_sem_Post(SmsSem);
+        result = SendMessage(msgPtr);
 
         if (result < 0)
         {
@@ -4743,6 +5078,34 @@ void le_sms_ResetCount
     SetMessageCount(LE_SMS_TYPE_BROADCAST_RX, 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of the message sending queue, since the start of the service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sms_GetSendStats
+(
+    uint32_t* queuedCountPtr,       ///< [OUT] Number of messages waiting to be sent asynchronously.
+    uint32_t* maxQueuedCountPtr,    ///< [OUT] Highest number of messages waiting to be sent
+                                    ///<       asynchronously.
+    uint32_t* pduCountPtr,          ///< [OUT] Number of PDUs given to the modem.
+    uint32_t* averageSendTimePtr    ///< [OUT] Average time taken to send a PDU, in milliseconds.
+)
+{
+    if ((!queuedCountPtr) || (!maxQueuedCountPtr) || (!pduCountPtr) || (!averageSendTimePtr))
+    {
+        LE_KILL_CLIENT("NULL pointer provided!");
+        return;
+    }
+
+    le_mutex_Lock(SendStatsMutex);
+    *queuedCountPtr = SendStats.queuedCount;
+    *maxQueuedCountPtr = SendStats.maxQueuedCount;
+    *pduCountPtr = SendStats.pduCount;
+    *averageSendTimePtr = SendStats.pduCount ? (SendStats.sendTimeMs / SendStats.pduCount) : 0;
+    le_mutex_Unlock(SendStatsMutex);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enable SMS Status Report for outgoing messages.
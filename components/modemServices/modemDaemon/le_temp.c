@@ -11,6 +11,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_temp.h"
+#include "sampler.h"
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -24,6 +25,14 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_NUM_OF_SENSOR   10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kind of the sampler sources of temperature sensors.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLER_KIND        "temp"
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
@@ -225,6 +234,8 @@ static void CloseSessionEventHandler
 
     LE_DEBUG("SessionRef (%p) has been closed", sessionRef);
 
+    sampler_RemoveSessionMonitors(sessionRef);
+
     le_dls_Link_t* linkPtr = le_dls_Peek(&SessionRefList);
 
     while (linkPtr)
@@ -282,6 +293,94 @@ static void TempSensorDestructor
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a temperature sensor for the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SampleTemperature
+(
+    const char* namePtr,    ///< [IN] Name of the temperature sensor.
+    int32_t* valuePtr       ///< [OUT] Temperature in degree Celsius.
+)
+{
+    le_temp_Handle_t leHandle;
+
+    if ((LE_OK != pa_temp_GetHandle(namePtr, &leHandle)) || (NULL == leHandle))
+    {
+        return LE_FAULT;
+    }
+
+    return pa_temp_GetTemperature(((SensorCtx_t*)leHandle)->paHandle, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleThreshold handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallThresholdHandler
+(
+    sampler_Level_t level,
+    int32_t value,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_temp_SampleThresholdHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc((le_temp_SampleLevel_t)level, value, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a client's SampleWindow handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallWindowHandler
+(
+    int32_t minValue,
+    int32_t maxValue,
+    int32_t avgValue,
+    void* handlerPtr,
+    void* contextPtr
+)
+{
+    le_temp_SampleWindowHandlerFunc_t clientHandlerFunc = handlerPtr;
+
+    clientHandlerFunc(minValue, maxValue, avgValue, contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sampler source of a temperature sensor.
+ *
+ * @return The source, or NULL if the sensor reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static sampler_SourceRef_t GetSource
+(
+    le_temp_SensorRef_t sensorRef   ///< [IN] Temperature sensor reference.
+)
+{
+    char sensorName[LE_TEMP_SENSOR_NAME_MAX_BYTES];
+    SensorCtx_t* sensorCtxPtr = le_ref_Lookup(SensorRefMap, sensorRef);
+
+    if (sensorCtxPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", sensorRef);
+        return NULL;
+    }
+
+    if (LE_OK != pa_temp_GetSensorName(sensorCtxPtr->paHandle, sensorName, sizeof(sensorName)))
+    {
+        LE_ERROR("Not able to get temperature sensor name");
+        return NULL;
+    }
+
+    return sampler_GetSource(SAMPLER_KIND, sensorName, SampleTemperature);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
@@ -657,3 +756,114 @@ le_result_t le_temp_StartMonitoring
 
     return pa_temp_StartMonitoring();
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_temp_SampleThreshold'
+ *
+ * This event reports the level of the temperature sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_temp_SampleThresholdHandlerRef_t le_temp_AddSampleThresholdHandler
+(
+    le_temp_SensorRef_t sensorRef,                      ///< [IN] Temperature sensor reference.
+    int32_t lowThreshold,                               ///< [IN] Low threshold.
+    int32_t highThreshold,                              ///< [IN] High threshold.
+    uint32_t hysteresis,                                ///< [IN] Hysteresis.
+    le_temp_SampleThresholdHandlerFunc_t handlerPtr,    ///< [IN] The handler function.
+    void* contextPtr                                    ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    sampler_SourceRef_t sourceRef = GetSource(sensorRef);
+    if (NULL == sourceRef)
+    {
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddThresholdMonitor(sourceRef,
+                                                                  lowThreshold,
+                                                                  highThreshold,
+                                                                  hysteresis,
+                                                                  CallThresholdHandler,
+                                                                  handlerPtr,
+                                                                  contextPtr,
+                                                                  le_temp_GetClientSessionRef());
+
+    return (le_temp_SampleThresholdHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_temp_SampleThreshold'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_temp_RemoveSampleThresholdHandler
+(
+    le_temp_SampleThresholdHandlerRef_t handlerRef  ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_temp_SampleWindow'
+ *
+ * This event reports the minimum, maximum and average of every windowSamples samples of the
+ * temperature sampled by the service.
+ */
+//--------------------------------------------------------------------------------------------------
+le_temp_SampleWindowHandlerRef_t le_temp_AddSampleWindowHandler
+(
+    le_temp_SensorRef_t sensorRef,                      ///< [IN] Temperature sensor reference.
+    uint32_t windowSamples,                             ///< [IN] Number of samples in a window.
+    le_temp_SampleWindowHandlerFunc_t handlerPtr,       ///< [IN] The handler function.
+    void* contextPtr                                    ///< [IN] The handler's context.
+)
+{
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    sampler_SourceRef_t sourceRef = GetSource(sensorRef);
+    if (NULL == sourceRef)
+    {
+        return NULL;
+    }
+
+    sampler_MonitorRef_t monitorRef = sampler_AddWindowMonitor(sourceRef,
+                                                               windowSamples,
+                                                               CallWindowHandler,
+                                                               handlerPtr,
+                                                               contextPtr,
+                                                               le_temp_GetClientSessionRef());
+
+    return (le_temp_SampleWindowHandlerRef_t)monitorRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_temp_SampleWindow'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_temp_RemoveSampleWindowHandler
+(
+    le_temp_SampleWindowHandlerRef_t handlerRef     ///< [IN] The handler reference.
+)
+{
+    if (LE_OK != sampler_RemoveMonitor(handlerRef))
+    {
+        LE_KILL_CLIENT("Invalid handler reference (%p) provided!", handlerRef);
+    }
+}
@@ -0,0 +1,569 @@
+/**
+ * @file sampler.c
+ *
+ * Daemon-side sampling of modem values on behalf of all the clients watching them.  See sampler.h.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "sampler.h"
+#include "mdmCfgEntries.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling period used when none is configured, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PERIOD_MS       1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shortest sampling period accepted from the config tree, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_PERIOD_MS           10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a kind of source, including the null-terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KIND_MAX_BYTES          16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of sources and monitors.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HIGH_SOURCE_COUNT       8
+#define HIGH_MONITOR_COUNT      16
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampled source.  Sources are kept once created; there is one per sensor, channel or value.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct sampler_Source
+{
+    char                kind[KIND_MAX_BYTES];           ///< Kind of source.
+    char                name[SAMPLER_NAME_MAX_BYTES];   ///< Name of the source.
+    sampler_ReadFunc_t  readFunc;                       ///< Function reading the source.
+    le_timer_Ref_t      timerRef;                       ///< Sampling timer.
+    le_dls_List_t       monitorList;                    ///< Monitors of the source.
+    le_dls_Link_t       link;                           ///< Link in SourceList.
+}
+Source_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Threshold monitor state.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t                         lowThreshold;   ///< Low threshold.
+    int32_t                         highThreshold;  ///< High threshold.
+    uint32_t                        hysteresis;     ///< Hysteresis.
+    sampler_ThresholdLayerFunc_t    layerFunc;      ///< Function calling the client handler.
+    bool                            hasLevel;       ///< false until the first sample.
+    sampler_Level_t                 level;          ///< Last reported level.
+}
+ThresholdMonitor_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Window monitor state.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t                    windowSamples;  ///< Number of samples in a window.
+    sampler_WindowLayerFunc_t   layerFunc;      ///< Function calling the client handler.
+    uint32_t                    count;          ///< Samples in the current window so far.
+    int32_t                     minValue;       ///< Smallest sample of the current window.
+    int32_t                     maxValue;       ///< Largest sample of the current window.
+    int64_t                     sum;            ///< Sum of the current window's samples.
+}
+WindowMonitor_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Monitor of a source.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                    isThreshold;    ///< true for a threshold monitor, false for a window.
+    Source_t*               sourcePtr;      ///< Monitored source.
+    void*                   handlerPtr;     ///< Client handler.
+    void*                   contextPtr;     ///< Client context.
+    le_msg_SessionRef_t     sessionRef;     ///< Client session.
+    sampler_MonitorRef_t    ref;            ///< Monitor reference.
+    ThresholdMonitor_t      threshold;      ///< State of a threshold monitor.
+    WindowMonitor_t         window;         ///< State of a window monitor.
+    le_dls_Link_t           link;           ///< Link in the source's monitorList.
+}
+Monitor_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for sources.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SourcePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for monitors.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MonitorPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe reference map for monitors.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t MonitorRefMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of sources.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t SourceList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sampling period of a kind of source from the config tree.
+ *
+ * @return The sampling period, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetPeriod
+(
+    const char* kindPtr     ///< [IN] Kind of source.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    int32_t periodMs;
+
+    snprintf(path, sizeof(path), "%s/%s", CFG_MODEMSERVICE_SAMPLING_PATH, kindPtr);
+
+    le_cfg_IteratorRef_t iteratorRef = le_cfg_CreateReadTxn(path);
+    periodMs = le_cfg_GetInt(iteratorRef, CFG_NODE_SAMPLING_PERIOD, DEFAULT_PERIOD_MS);
+    le_cfg_CancelTxn(iteratorRef);
+
+    if (periodMs < MIN_PERIOD_MS)
+    {
+        LE_WARN("Sampling period %d ms of '%s' is too short, using %d ms",
+                periodMs, kindPtr, MIN_PERIOD_MS);
+        periodMs = MIN_PERIOD_MS;
+    }
+
+    return (uint32_t)periodMs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass a sample to a threshold monitor, reporting a change of level.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateThresholdMonitor
+(
+    Monitor_t* monitorPtr,  ///< [IN] The monitor.
+    int32_t value           ///< [IN] The sample.
+)
+{
+    ThresholdMonitor_t* thresholdPtr = &monitorPtr->threshold;
+    int64_t lowRelease = (int64_t)thresholdPtr->lowThreshold + thresholdPtr->hysteresis;
+    int64_t highRelease = (int64_t)thresholdPtr->highThreshold - thresholdPtr->hysteresis;
+    sampler_Level_t level = thresholdPtr->level;
+
+    if (value >= thresholdPtr->highThreshold)
+    {
+        level = SAMPLER_LEVEL_HIGH;
+    }
+    else if (value <= thresholdPtr->lowThreshold)
+    {
+        level = SAMPLER_LEVEL_LOW;
+    }
+    else if (!thresholdPtr->hasLevel)
+    {
+        level = SAMPLER_LEVEL_NORMAL;
+    }
+    else if ((SAMPLER_LEVEL_HIGH == level) && (value < highRelease))
+    {
+        level = SAMPLER_LEVEL_NORMAL;
+    }
+    else if ((SAMPLER_LEVEL_LOW == level) && (value > lowRelease))
+    {
+        level = SAMPLER_LEVEL_NORMAL;
+    }
+
+    if (thresholdPtr->hasLevel && (level == thresholdPtr->level))
+    {
+        return;
+    }
+
+    thresholdPtr->hasLevel = true;
+    thresholdPtr->level = level;
+    thresholdPtr->layerFunc(level, value, monitorPtr->handlerPtr, monitorPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass a sample to a window monitor, reporting the window when it is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateWindowMonitor
+(
+    Monitor_t* monitorPtr,  ///< [IN] The monitor.
+    int32_t value           ///< [IN] The sample.
+)
+{
+    WindowMonitor_t* windowPtr = &monitorPtr->window;
+
+    if ((0 == windowPtr->count) || (value < windowPtr->minValue))
+    {
+        windowPtr->minValue = value;
+    }
+    if ((0 == windowPtr->count) || (value > windowPtr->maxValue))
+    {
+        windowPtr->maxValue = value;
+    }
+    windowPtr->sum += value;
+    windowPtr->count++;
+
+    if (windowPtr->count < windowPtr->windowSamples)
+    {
+        return;
+    }
+
+    windowPtr->layerFunc(windowPtr->minValue,
+                         windowPtr->maxValue,
+                         (int32_t)(windowPtr->sum / windowPtr->count),
+                         monitorPtr->handlerPtr,
+                         monitorPtr->contextPtr);
+
+    windowPtr->count = 0;
+    windowPtr->sum = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling timer handler: read the source once and pass the sample to all its monitors.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Sampling timer.
+)
+{
+    Source_t* sourcePtr = le_timer_GetContextPtr(timerRef);
+    int32_t value;
+
+    if (LE_OK != sourcePtr->readFunc(sourcePtr->name, &value))
+    {
+        LE_DEBUG("Failed to sample %s '%s'", sourcePtr->kind, sourcePtr->name);
+        return;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&sourcePtr->monitorList);
+    while (linkPtr)
+    {
+        Monitor_t* monitorPtr = CONTAINER_OF(linkPtr, Monitor_t, link);
+        linkPtr = le_dls_PeekNext(&sourcePtr->monitorList, linkPtr);
+
+        if (monitorPtr->isThreshold)
+        {
+            UpdateThresholdMonitor(monitorPtr, value);
+        }
+        else
+        {
+            UpdateWindowMonitor(monitorPtr, value);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a monitor, add it to its source and start sampling the source if it was not monitored.
+ *
+ * @return The monitor.
+ */
+//--------------------------------------------------------------------------------------------------
+static Monitor_t* AddMonitor
+(
+    Source_t* sourcePtr,                ///< [IN] The source.
+    void* handlerPtr,                   ///< [IN] Client handler.
+    void* contextPtr,                   ///< [IN] Client context.
+    le_msg_SessionRef_t sessionRef      ///< [IN] Client session.
+)
+{
+    Monitor_t* monitorPtr = le_mem_ForceAlloc(MonitorPool);
+
+    memset(monitorPtr, 0, sizeof(*monitorPtr));
+    monitorPtr->sourcePtr = sourcePtr;
+    monitorPtr->handlerPtr = handlerPtr;
+    monitorPtr->contextPtr = contextPtr;
+    monitorPtr->sessionRef = sessionRef;
+    monitorPtr->ref = le_ref_CreateRef(MonitorRefMap, monitorPtr);
+    monitorPtr->link = LE_DLS_LINK_INIT;
+
+    if (le_dls_IsEmpty(&sourcePtr->monitorList))
+    {
+        uint32_t periodMs = GetPeriod(sourcePtr->kind);
+
+        LE_DEBUG("Start sampling %s '%s' every %"PRIu32" ms",
+                 sourcePtr->kind, sourcePtr->name, periodMs);
+
+        LE_ASSERT_OK(le_timer_SetMsInterval(sourcePtr->timerRef, periodMs));
+        LE_ASSERT_OK(le_timer_Start(sourcePtr->timerRef));
+    }
+
+    le_dls_Queue(&sourcePtr->monitorList, &monitorPtr->link);
+
+    return monitorPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a monitor from its source and free it, stopping the sampling if it was the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteMonitor
+(
+    Monitor_t* monitorPtr   ///< [IN] The monitor.
+)
+{
+    Source_t* sourcePtr = monitorPtr->sourcePtr;
+
+    le_dls_Remove(&sourcePtr->monitorList, &monitorPtr->link);
+    le_ref_DeleteRef(MonitorRefMap, monitorPtr->ref);
+    le_mem_Release(monitorPtr);
+
+    if (le_dls_IsEmpty(&sourcePtr->monitorList))
+    {
+        LE_DEBUG("Stop sampling %s '%s'", sourcePtr->kind, sourcePtr->name);
+        le_timer_Stop(sourcePtr->timerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+void sampler_Init
+(
+    void
+)
+{
+    SourcePool = le_mem_CreatePool("SamplerSourcePool", sizeof(Source_t));
+    le_mem_ExpandPool(SourcePool, HIGH_SOURCE_COUNT);
+
+    MonitorPool = le_mem_CreatePool("SamplerMonitorPool", sizeof(Monitor_t));
+    le_mem_ExpandPool(MonitorPool, HIGH_MONITOR_COUNT);
+
+    MonitorRefMap = le_ref_CreateMap("SamplerMonitorRefMap", HIGH_MONITOR_COUNT);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a source, creating it the first time it is asked for.
+ *
+ * @return The source, or NULL if the name is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_SourceRef_t sampler_GetSource
+(
+    const char* kindPtr,            ///< [IN] Kind of source, which selects the sampling period.
+    const char* namePtr,            ///< [IN] Name of the source, passed to readFunc.
+    sampler_ReadFunc_t readFunc     ///< [IN] Function reading the source.
+)
+{
+    Source_t* sourcePtr;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SourceList);
+    while (linkPtr)
+    {
+        sourcePtr = CONTAINER_OF(linkPtr, Source_t, link);
+        if ((0 == strcmp(sourcePtr->kind, kindPtr)) && (0 == strcmp(sourcePtr->name, namePtr)))
+        {
+            return sourcePtr;
+        }
+        linkPtr = le_dls_PeekNext(&SourceList, linkPtr);
+    }
+
+    sourcePtr = le_mem_ForceAlloc(SourcePool);
+    if (   (LE_OK != le_utf8_Copy(sourcePtr->kind, kindPtr, sizeof(sourcePtr->kind), NULL))
+        || (LE_OK != le_utf8_Copy(sourcePtr->name, namePtr, sizeof(sourcePtr->name), NULL)))
+    {
+        LE_ERROR("Source name '%s' '%s' is too long", kindPtr, namePtr);
+        le_mem_Release(sourcePtr);
+        return NULL;
+    }
+
+    sourcePtr->readFunc = readFunc;
+    sourcePtr->monitorList = LE_DLS_LIST_INIT;
+    sourcePtr->link = LE_DLS_LINK_INIT;
+    sourcePtr->timerRef = le_timer_Create("Sampler");
+    le_timer_SetRepeat(sourcePtr->timerRef, 0);
+    le_timer_SetHandler(sourcePtr->timerRef, SampleTimerHandler);
+    le_timer_SetContextPtr(sourcePtr->timerRef, sourcePtr);
+
+    le_dls_Queue(&SourceList, &sourcePtr->link);
+
+    return sourcePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a threshold monitor to a source, starting its sampling if needed.
+ *
+ * The first sample is always reported, so that the client knows the initial level.
+ *
+ * @return The monitor reference, or NULL if the thresholds are invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_MonitorRef_t sampler_AddThresholdMonitor
+(
+    sampler_SourceRef_t sourceRef,              ///< [IN] The source.
+    int32_t lowThreshold,                       ///< [IN] Low threshold.
+    int32_t highThreshold,                      ///< [IN] High threshold.
+    uint32_t hysteresis,                        ///< [IN] How far back past a threshold the value
+                                                ///       must go to be normal again.
+    sampler_ThresholdLayerFunc_t layerFunc,     ///< [IN] Function calling the client handler.
+    void* handlerPtr,                           ///< [IN] Client handler.
+    void* contextPtr,                           ///< [IN] Client context.
+    le_msg_SessionRef_t sessionRef              ///< [IN] Client session.
+)
+{
+    if (lowThreshold >= highThreshold)
+    {
+        LE_ERROR("Low threshold %d is not below high threshold %d", lowThreshold, highThreshold);
+        return NULL;
+    }
+
+    Monitor_t* monitorPtr = AddMonitor(sourceRef, handlerPtr, contextPtr, sessionRef);
+
+    monitorPtr->isThreshold = true;
+    monitorPtr->threshold.lowThreshold = lowThreshold;
+    monitorPtr->threshold.highThreshold = highThreshold;
+    monitorPtr->threshold.hysteresis = hysteresis;
+    monitorPtr->threshold.layerFunc = layerFunc;
+    monitorPtr->threshold.hasLevel = false;
+
+    return monitorPtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a window monitor to a source, starting its sampling if needed.
+ *
+ * @return The monitor reference, or NULL if the window is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_MonitorRef_t sampler_AddWindowMonitor
+(
+    sampler_SourceRef_t sourceRef,              ///< [IN] The source.
+    uint32_t windowSamples,                     ///< [IN] Number of samples in a window.
+    sampler_WindowLayerFunc_t layerFunc,        ///< [IN] Function calling the client handler.
+    void* handlerPtr,                           ///< [IN] Client handler.
+    void* contextPtr,                           ///< [IN] Client context.
+    le_msg_SessionRef_t sessionRef              ///< [IN] Client session.
+)
+{
+    if (0 == windowSamples)
+    {
+        LE_ERROR("Window has no samples");
+        return NULL;
+    }
+
+    Monitor_t* monitorPtr = AddMonitor(sourceRef, handlerPtr, contextPtr, sessionRef);
+
+    monitorPtr->isThreshold = false;
+    monitorPtr->window.windowSamples = windowSamples;
+    monitorPtr->window.layerFunc = layerFunc;
+
+    return monitorPtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a monitor, stopping the sampling of its source if it was the last one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the reference is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t sampler_RemoveMonitor
+(
+    sampler_MonitorRef_t monitorRef     ///< [IN] The monitor.
+)
+{
+    Monitor_t* monitorPtr = le_ref_Lookup(MonitorRefMap, monitorRef);
+
+    if (NULL == monitorPtr)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    DeleteMonitor(monitorPtr);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the monitors added by a client session.  To be called when the session closes.
+ */
+//--------------------------------------------------------------------------------------------------
+void sampler_RemoveSessionMonitors
+(
+    le_msg_SessionRef_t sessionRef      ///< [IN] Client session.
+)
+{
+    le_dls_Link_t* sourceLinkPtr = le_dls_Peek(&SourceList);
+
+    while (sourceLinkPtr)
+    {
+        Source_t* sourcePtr = CONTAINER_OF(sourceLinkPtr, Source_t, link);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&sourcePtr->monitorList);
+
+        while (linkPtr)
+        {
+            Monitor_t* monitorPtr = CONTAINER_OF(linkPtr, Monitor_t, link);
+            linkPtr = le_dls_PeekNext(&sourcePtr->monitorList, linkPtr);
+
+            if (monitorPtr->sessionRef == sessionRef)
+            {
+                DeleteMonitor(monitorPtr);
+            }
+        }
+
+        sourceLinkPtr = le_dls_PeekNext(&SourceList, sourceLinkPtr);
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file sampler.h
+ *
+ * Daemon-side sampling of modem values (temperatures, input voltage, ADC channels) on behalf of
+ * all the clients watching them.
+ *
+ * Each sampled value is a source.  While a source has monitors, it is read once per sampling
+ * period, whatever the number of monitors, and each sample is passed to all of them:
+ *  - a threshold monitor reports when the value goes above a high threshold or below a low
+ *    threshold, and when it comes back by more than a hysteresis;
+ *  - a window monitor reports the minimum, maximum and average of every N samples.
+ *
+ * The sampling period of a kind of source is read from the config tree, at
+ * modemService:/sampling/<kind>/period (in milliseconds), when its sampling starts.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SAMPLER_INCLUDE_GUARD
+#define LEGATO_SAMPLER_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a source name, including the null-terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLER_NAME_MAX_BYTES  128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Level of a value compared to a threshold monitor's thresholds.
+ *
+ * @note The order matches the SampleLevel enums of the le_temp, le_ips and le_adc APIs.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SAMPLER_LEVEL_LOW,      ///< Value went below the low threshold.
+    SAMPLER_LEVEL_NORMAL,   ///< Value is between the thresholds.
+    SAMPLER_LEVEL_HIGH      ///< Value went above the high threshold.
+}
+sampler_Level_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a sampled source.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct sampler_Source* sampler_SourceRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a monitor, returned to the client as its handler reference.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void* sampler_MonitorRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a source's value.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - Any other value if the value can't be read; the sample is skipped.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_result_t (*sampler_ReadFunc_t)
+(
+    const char* namePtr,    ///< [IN] Name of the source.
+    int32_t* valuePtr       ///< [OUT] The value.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a client's threshold handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*sampler_ThresholdLayerFunc_t)
+(
+    sampler_Level_t level,  ///< [IN] New level of the value.
+    int32_t value,          ///< [IN] The sample that changed the level.
+    void* handlerPtr,       ///< [IN] Client handler.
+    void* contextPtr        ///< [IN] Client context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a client's window handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*sampler_WindowLayerFunc_t)
+(
+    int32_t minValue,       ///< [IN] Smallest sample of the window.
+    int32_t maxValue,       ///< [IN] Largest sample of the window.
+    int32_t avgValue,       ///< [IN] Average of the window's samples.
+    void* handlerPtr,       ///< [IN] Client handler.
+    void* contextPtr        ///< [IN] Client context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the sampler.
+ */
+//--------------------------------------------------------------------------------------------------
+void sampler_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a source, creating it the first time it is asked for.
+ *
+ * @return The source, or NULL if the name is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_SourceRef_t sampler_GetSource
+(
+    const char* kindPtr,            ///< [IN] Kind of source, which selects the sampling period.
+    const char* namePtr,            ///< [IN] Name of the source, passed to readFunc.
+    sampler_ReadFunc_t readFunc     ///< [IN] Function reading the source.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a threshold monitor to a source, starting its sampling if needed.
+ *
+ * The first sample is always reported, so that the client knows the initial level.
+ *
+ * @return The monitor reference, or NULL if the thresholds are invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_MonitorRef_t sampler_AddThresholdMonitor
+(
+    sampler_SourceRef_t sourceRef,              ///< [IN] The source.
+    int32_t lowThreshold,                       ///< [IN] Low threshold.
+    int32_t highThreshold,                      ///< [IN] High threshold.
+    uint32_t hysteresis,                        ///< [IN] How far back past a threshold the value
+                                                ///       must go to be normal again.
+    sampler_ThresholdLayerFunc_t layerFunc,     ///< [IN] Function calling the client handler.
+    void* handlerPtr,                           ///< [IN] Client handler.
+    void* contextPtr,                           ///< [IN] Client context.
+    le_msg_SessionRef_t sessionRef              ///< [IN] Client session.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a window monitor to a source, starting its sampling if needed.
+ *
+ * @return The monitor reference, or NULL if the window is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+sampler_MonitorRef_t sampler_AddWindowMonitor
+(
+    sampler_SourceRef_t sourceRef,              ///< [IN] The source.
+    uint32_t windowSamples,                     ///< [IN] Number of samples in a window.
+    sampler_WindowLayerFunc_t layerFunc,        ///< [IN] Function calling the client handler.
+    void* handlerPtr,                           ///< [IN] Client handler.
+    void* contextPtr,                           ///< [IN] Client context.
+    le_msg_SessionRef_t sessionRef              ///< [IN] Client session.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a monitor, stopping the sampling of its source if it was the last one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the reference is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t sampler_RemoveMonitor
+(
+    sampler_MonitorRef_t monitorRef     ///< [IN] The monitor.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the monitors added by a client session.  To be called when the session closes.
+ */
+//--------------------------------------------------------------------------------------------------
+void sampler_RemoveSessionMonitors
+(
+    le_msg_SessionRef_t sessionRef      ///< [IN] Client session.
+);
+
+#endif // LEGATO_SAMPLER_INCLUDE_GUARD
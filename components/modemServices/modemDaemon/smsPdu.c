@@ -6,6 +6,7 @@
  */
 
 #include <time.h>
+#include <endian.h>
 #include "legato.h"
 #include "smsPdu.h"
 #include "cdmaPdu.h"
@@ -98,6 +99,15 @@ static const char *DtmfChars = "D1234567890*#ABC";
 #define TYPE_OF_ADDRESS_UNKNOWN         0x81
 #define TYPE_OF_ADDRESS_INTERNATIONAL   0x91
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * User Data Header of a concatenated message (cf. 3GPP TS 23.040 section 9.2.3.24.1):
+ * UDHL, IEI, IEDL, reference number, number of parts, part number.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONCAT_UDH_LEN              6
+#define UDH_IEI_CONCAT_8BIT_REF     0x00
+
 /****************************************************************************
  * This lookup table converts from ISO-8859-1 8-bit ASCII to the
  * 7 bit "default alphabet" as defined in ETSI GSM 03.38
@@ -542,24 +552,44 @@ static void DumpPdu
 {
     if ( IS_TRACE_ENABLED )
     {
-        uint32_t index = 0, i = 0;
-        char output[65] = {0};
-
+        // LE_DUMP leaves the formatting to the log buffer thread, if logging is buffered.
         LE_DEBUG("%s:",label);
-        for (i=0;i<bufferSize;i++)
-        {
-            index += snprintf(&output[index], (sizeof(output) - index), "%02X", buffer[i]);
-            if ( !((i+1)%32) )
-            {
-                LE_DEBUG("%s",output);
-                index = 0;
-            }
-        }
-        LE_DEBUG("%s",output);
+        LE_DUMP(buffer, bufferSize);
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of septets packed in a 64-bit word: 8 septets fill 7 bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEPTETS_PER_WORD    8
+#define BYTES_PER_WORD      7
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of septets unpacked at a time by Convert7BitsTo8Bits().
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEPTET_BLOCK_SIZE   64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Septets being packed into a buffer, a word at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* bufferPtr;     ///< Packed septets
+    size_t   bufferSize;    ///< Size of the buffer
+    size_t   size;          ///< Number of bytes written in the buffer
+    uint64_t word;          ///< Septets not yet written
+    uint32_t bits;          ///< Number of bits in word
+    uint32_t count;         ///< Number of septets packed
+}
+SeptetPacker_t;
+
 static inline unsigned int Read7Bits
 (
     const uint8_t* bufferPtr,
@@ -575,60 +605,248 @@ static inline unsigned int Read7Bits
     return (a|b) & 0x7F;
 }
 
-static inline void Write7Bits
+static inline unsigned int ReadCdma7Bits
 (
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
+    const uint8_t* bufferPtr,
+    uint32_t       pos
 )
 {
-    val &= 0x7F;
     uint8_t idx = pos/8;
 
+    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load 8 bytes of a buffer, whatever their alignment.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t LoadWord
+(
+    const uint8_t* bufferPtr
+)
+{
+    uint64_t word;
+
+    memcpy(&word, bufferPtr, sizeof(word));
+    return word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack GSM septets, packed from the least significant bit of each byte (3GPP TS 23.038).
+ *
+ * Eight septets are extracted from each 64-bit load, as long as the load stays within the bytes
+ * holding the septets.  The last ones are read one at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Unpack7Bits
+(
+    const uint8_t* bufferPtr,   ///< [IN] Packed septets
+    uint32_t       pos,         ///< [IN] Index of the first septet to unpack
+    uint32_t       count,       ///< [IN] Number of septets to unpack
+    uint8_t*       septetPtr    ///< [OUT] Unpacked septets
+)
+{
+    uint32_t bit = pos * 7;
+    uint32_t endByte = ((pos + count) * 7 + 7) / 8;
+    uint32_t i = 0;
+
+    while ((count - i >= SEPTETS_PER_WORD) && (bit / 8 + sizeof(uint64_t) <= endByte))
+    {
+        // At least 57 bits are left after the shift.
+        uint64_t word = le64toh(LoadWord(&bufferPtr[bit / 8])) >> (bit & 7);
+        int k;
+
+        for (k = 0; k < SEPTETS_PER_WORD; k++)
+        {
+            septetPtr[i++] = word & 0x7F;
+            word >>= 7;
+        }
+        bit += SEPTETS_PER_WORD * 7;
+    }
 
-    if (!(pos&7)) {
-        bufferPtr[idx] = val;
+    for (; i < count; i++, bit += 7)
+    {
+        septetPtr[i] = Read7Bits(bufferPtr, bit);
     }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack CDMA septets, packed from the most significant bit of each byte (C.S0015-B).
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnpackCdma7Bits
+(
+    const uint8_t* bufferPtr,   ///< [IN] Packed septets
+    uint32_t       count,       ///< [IN] Number of septets to unpack
+    uint8_t*       septetPtr    ///< [OUT] Unpacked septets
+)
+{
+    uint32_t bit = 0;
+    uint32_t endByte = (count * 7 + 7) / 8;
+    uint32_t i = 0;
+
+    while ((count - i >= SEPTETS_PER_WORD) && (bit / 8 + sizeof(uint64_t) <= endByte))
+    {
+        // The septets are in the 57 most significant bits after the shift.
+        uint64_t word = be64toh(LoadWord(&bufferPtr[bit / 8])) << (bit & 7);
+        int k;
+
+        for (k = 0; k < SEPTETS_PER_WORD; k++)
+        {
+            septetPtr[i++] = word >> 57;
+            word <<= 7;
+        }
+        bit += SEPTETS_PER_WORD * 7;
     }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<(pos&7));
-        bufferPtr[idx+1] = (val>>(8-(pos&7)));
+
+    for (; i < count; i++, bit += 7)
+    {
+        septetPtr[i] = ReadCdma7Bits(bufferPtr, bit);
     }
 }
 
-static inline unsigned int ReadCdma7Bits
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start packing septets into a buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void InitSeptetPacker
 (
-    const uint8_t* bufferPtr,
-    uint32_t       pos
+    SeptetPacker_t* packerPtr,  ///< [OUT] Packer
+    uint8_t*        bufferPtr,  ///< [IN] Buffer for the packed septets
+    size_t          bufferSize  ///< [IN] Size of the buffer
 )
 {
-    uint8_t idx = pos/8;
+    memset(packerPtr, 0, sizeof(*packerPtr));
+    packerPtr->bufferPtr = bufferPtr;
+    packerPtr->bufferSize = bufferSize;
+}
 
-    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a GSM septet.  A word is written to the buffer each time it holds 8 septets.
+ *
+ * @return LE_OK, or LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_result_t Pack7Bits
+(
+    SeptetPacker_t* packerPtr,  ///< [IN/OUT] Packer
+    uint8_t         septet      ///< [IN] Septet to append
+)
+{
+    packerPtr->word |= (uint64_t)(septet & 0x7F) << packerPtr->bits;
+    packerPtr->bits += 7;
+    packerPtr->count++;
+
+    if (packerPtr->bits == SEPTETS_PER_WORD * 7)
+    {
+        uint8_t* bytePtr = &packerPtr->bufferPtr[packerPtr->size];
+        int k;
+
+        if (packerPtr->size + BYTES_PER_WORD > packerPtr->bufferSize)
+        {
+            return LE_OVERFLOW;
+        }
+
+        for (k = 0; k < BYTES_PER_WORD; k++)
+        {
+            bytePtr[k] = packerPtr->word >> (8 * k);
+        }
+        packerPtr->size += BYTES_PER_WORD;
+        packerPtr->word = 0;
+        packerPtr->bits = 0;
+    }
+
+    return LE_OK;
 }
 
-static inline void WriteCdma7Bits
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a CDMA septet.  A word is written to the buffer each time it holds 8 septets.
+ *
+ * @return LE_OK, or LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_result_t PackCdma7Bits
 (
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
+    SeptetPacker_t* packerPtr,  ///< [IN/OUT] Packer
+    uint8_t         septet      ///< [IN] Septet to append
 )
 {
-    val &= 0x7F;
-    uint8_t idx = pos/8;
+    packerPtr->word = (packerPtr->word << 7) | (septet & 0x7F);
+    packerPtr->bits += 7;
+    packerPtr->count++;
 
-    if (!(pos&7)) {
-        bufferPtr[idx] = val << 1;
+    if (packerPtr->bits == SEPTETS_PER_WORD * 7)
+    {
+        uint8_t* bytePtr = &packerPtr->bufferPtr[packerPtr->size];
+        int k;
+
+        if (packerPtr->size + BYTES_PER_WORD > packerPtr->bufferSize)
+        {
+            return LE_OVERFLOW;
+        }
+
+        for (k = 0; k < BYTES_PER_WORD; k++)
+        {
+            bytePtr[k] = packerPtr->word >> (8 * (BYTES_PER_WORD - 1 - k));
+        }
+        packerPtr->size += BYTES_PER_WORD;
+        packerPtr->word = 0;
+        packerPtr->bits = 0;
     }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | val;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the septets left in the word of a packer, the unused bits of the last byte being 0.
+ *
+ * @return LE_OK, or LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushSeptetPacker
+(
+    SeptetPacker_t* packerPtr,  ///< [IN/OUT] Packer
+    bool            isCdma      ///< [IN] Septets are packed from the most significant bit
+)
+{
+    uint32_t byteCount = (packerPtr->bits + 7) / 8;
+    uint8_t* bytePtr = &packerPtr->bufferPtr[packerPtr->size];
+    uint32_t k;
+
+    if (packerPtr->size + byteCount > packerPtr->bufferSize)
+    {
+        return LE_OVERFLOW;
     }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val>>((pos&7)-1));
-        bufferPtr[idx+1] = ((val<<(8-((pos&7)-1)))&0xff);
+
+    if (isCdma)
+    {
+        // Align the first septet on the most significant bit of the first byte.
+        uint64_t word = packerPtr->word << (byteCount * 8 - packerPtr->bits);
+
+        for (k = 0; k < byteCount; k++)
+        {
+            bytePtr[k] = word >> (8 * (byteCount - 1 - k));
+        }
+    }
+    else
+    {
+        for (k = 0; k < byteCount; k++)
+        {
+            bytePtr[k] = packerPtr->word >> (8 * k);
+        }
     }
+    packerPtr->size += byteCount;
+    packerPtr->word = 0;
+    packerPtr->bits = 0;
+
+    return LE_OK;
 }
 
 /**
@@ -647,9 +865,10 @@ static int32_t Convert8BitsTo7Bits
     uint8_t       *a7bitsNumber ///< [OUT] number of char in &7bitsPtr
 )
 {
+    SeptetPacker_t packer;
     int read;
-    int write = 0;
-    int size = 0;
+
+    InitSeptetPacker(&packer, a7bitPtr, a7bitSize);
 
     for (read = pos; read < length+pos; ++read)
     {
@@ -658,38 +877,28 @@ static int32_t Convert8BitsTo7Bits
         /* Escape */
         if (byte >= 128)
         {
-            if (size>a7bitSize)
+            if (Pack7Bits(&packer, 0x1B) != LE_OK)
             {
                 return LE_OVERFLOW;
             }
-
-            Write7Bits(a7bitPtr, 0x1B, write*7);
-            write++;
             byte -= 128;
         }
 
-        if (size>a7bitSize)
+        if (Pack7Bits(&packer, byte) != LE_OK)
         {
             return LE_OVERFLOW;
         }
-
-        Write7Bits(a7bitPtr, byte, write*7);
-        write++;
-
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
     }
 
-    if (size>a7bitSize)
+    if (FlushSeptetPacker(&packer, false) != LE_OK)
     {
         return LE_OVERFLOW;
     }
 
     /* Number of written chars */
-    *a7bitsNumber = write;
+    *a7bitsNumber = packer.count;
 
-    return size;
+    return packer.size;
 }
 
 /**
@@ -707,73 +916,86 @@ static int32_t Convert7BitsTo8Bits
     size_t         a8bitSize     ///< [IN] 8bits array size.
 )
 {
+    uint8_t septets[SEPTET_BLOCK_SIZE];
+    bool escaped = false;
     int r;
     int w;
 
     w = 0;
-    for (r = pos; r < length+pos; r++)
+    for (r = 0; r < length; r += SEPTET_BLOCK_SIZE)
     {
-        uint8_t byte = Read7Bits(a7bitPtr, r*7);
-        byte = Ascii7to8[byte];
+        int count = min(length - r, SEPTET_BLOCK_SIZE);
+        int i;
 
-        if (byte != 27)
-        {
-            if (w < a8bitSize)
-            {
-                a8bitPtr[w] = byte;
-                w++;
-            }
-            else
-            {
-                return LE_OVERFLOW;
-            }
-        }
-        else
+        Unpack7Bits(a7bitPtr, pos + r, count, septets);
+
+        for (i = 0; i < count; i++)
         {
-            /* If we're escaped then the next byte have a special meaning. */
-            r++;
+            uint8_t byte = septets[i];
 
-            byte = Read7Bits(a7bitPtr, r*7);
-            if (w < a8bitSize)
+            if (!escaped)
             {
-                switch (byte)
+                byte = Ascii7to8[byte];
+                if (byte == 27)
+                {
+                    /* If we're escaped then the next byte have a special meaning. */
+                    escaped = true;
+                }
+                else if (w < a8bitSize)
                 {
-                    case 10:
-                        a8bitPtr[w] = 12;
-                        break;
-                    case 20:
-                        a8bitPtr[w] = '^';
-                        break;
-                    case 40:
-                        a8bitPtr[w] = '{';
-                        break;
-                    case 41:
-                        a8bitPtr[w] = '}';
-                        break;
-                    case 47:
-                        a8bitPtr[w] = '\\';
-                        break;
-                    case 60:
-                        a8bitPtr[w] = '[';
-                        break;
-                    case 61:
-                        a8bitPtr[w] = '~';
-                        break;
-                    case 62:
-                        a8bitPtr[w] = ']';
-                        break;
-                    case 64:
-                        a8bitPtr[w] = '|';
-                        break;
-                    default:
-                        a8bitPtr[w] = NPC8;
-                        break;
+                    a8bitPtr[w] = byte;
+                    w++;
+                }
+                else
+                {
+                    return LE_OVERFLOW;
                 }
-                w++;
             }
             else
             {
-                return LE_OVERFLOW;
+                escaped = false;
+
+                if (w < a8bitSize)
+                {
+                        switch (byte)
+                        {
+                            case 10:
+                                a8bitPtr[w] = 12;
+                                break;
+                            case 20:
+                                a8bitPtr[w] = '^';
+                                break;
+                            case 40:
+                                a8bitPtr[w] = '{';
+                                break;
+                            case 41:
+                                a8bitPtr[w] = '}';
+                                break;
+                            case 47:
+                                a8bitPtr[w] = '\\';
+                                break;
+                            case 60:
+                                a8bitPtr[w] = '[';
+                                break;
+                            case 61:
+                                a8bitPtr[w] = '~';
+                                break;
+                            case 62:
+                                a8bitPtr[w] = ']';
+                                break;
+                            case 64:
+                                a8bitPtr[w] = '|';
+                                break;
+                            default:
+                                a8bitPtr[w] = NPC8;
+                                break;
+                        }
+                    w++;
+                }
+                else
+                {
+                    return LE_OVERFLOW;
+                }
             }
         }
     }
@@ -1005,6 +1227,7 @@ static le_result_t DecodeUserDataField
     smsPdu_Encoding_t encoding,     ///< [IN] Encoding
     uint8_t           tpUdl,        ///< [IN] TP User Data Length
     uint8_t           tpUdhl,       ///< [IN] TP User Data Header Length
+    bool              decodeData,   ///< [IN] false to only set the format
     pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
@@ -1040,6 +1263,10 @@ static le_result_t DecodeUserDataField
         case SMSPDU_8_BITS:
             messageLen = tpUdl - tpUdhl;
             *formatPtr = LE_SMS_FORMAT_BINARY;
+            if (!decodeData)
+            {
+                break;
+            }
             if (messageLen < destDataSize)
             {
                 memcpy(destDataPtr, &dataPtr[*posPtr], messageLen);
@@ -1062,6 +1289,10 @@ static le_result_t DecodeUserDataField
             }
             *posPtr -= ((tpUdhl * 8) + 6) / 7; // translate the pos in 7bits char unit
             *formatPtr = LE_SMS_FORMAT_TEXT;
+            if (!decodeData)
+            {
+                break;
+            }
             int size = Convert7BitsTo8Bits(&dataPtr[*posPtr],
                                            0,
                                            messageLen,
@@ -1079,6 +1310,10 @@ static le_result_t DecodeUserDataField
         case SMSPDU_UCS2_16_BITS:
             messageLen = tpUdl - tpUdhl;
             *formatPtr = LE_SMS_FORMAT_UCS2;
+            if (!decodeData)
+            {
+                break;
+            }
             if (messageLen < destDataSize)
             {
                 memcpy(destDataPtr, &dataPtr[*posPtr], messageLen);
@@ -1172,9 +1407,10 @@ static le_result_t DecodeAddressField
 //--------------------------------------------------------------------------------------------------
 static le_result_t DecodePduDeliver
 (
-    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
-    uint8_t           initPos,  ///< [IN] Initial position in PDU
-    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+    const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
+    uint8_t           initPos,      ///< [IN] Initial position in PDU
+    bool              decodeData,   ///< [IN] false to leave the user data undecoded
+    pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
     le_result_t result;
@@ -1243,7 +1479,7 @@ static le_result_t DecodePduDeliver
         return LE_UNSUPPORTED;
     }
 
-    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, smsPtr);
+    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, decodeData, smsPtr);
     if (LE_OK != result)
     {
         return result;
@@ -1259,9 +1495,10 @@ static le_result_t DecodePduDeliver
 //--------------------------------------------------------------------------------------------------
 static le_result_t DecodePduSubmit
 (
-    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
-    uint8_t           initPos,  ///< [IN] Initial position in PDU
-    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+    const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
+    uint8_t           initPos,      ///< [IN] Initial position in PDU
+    bool              decodeData,   ///< [IN] false to leave the user data undecoded
+    pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
     le_result_t result;
@@ -1328,7 +1565,7 @@ static le_result_t DecodePduSubmit
         return LE_UNSUPPORTED;
     }
 
-    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, smsPtr);
+    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, decodeData, smsPtr);
     if (LE_OK != result)
     {
         return result;
@@ -1412,13 +1649,20 @@ static le_result_t EncodeMessageGsm
     pa_sms_Pdu_t*           pduPtr      ///< [OUT] Buffer for the encoded PDU
 )
 {
-    const int maxSmsLength = 160;
-    uint8_t tpUdhi = 0;
+    int maxSmsLength = 160;
+    uint8_t tpUdhi = (dataPtr->concatCount != 0);
+    int udhLen = tpUdhi ? CONCAT_UDH_LEN : 0;
     uint8_t tpDcs = 0x00;
     uint8_t tpSrr = 0x01;
     uint8_t firstByte = 0x00;
     uint8_t addressToa;
 
+    if (tpUdhi)
+    {
+        maxSmsLength = (SMSPDU_7_BITS == dataPtr->encoding) ? SMSPDU_CONCAT_7BITS_MAX_LEN :
+                                                              LE_SMS_PDU_MAX_PAYLOAD - udhLen;
+    }
+
     if (dataPtr->length > maxSmsLength)
     {
         LE_WARN("Message cannot be encoded, message with length > %d are not supported yet",
@@ -1562,11 +1806,18 @@ static le_result_t EncodeMessageGsm
 
         /* TP-UDL: User Data Length (1 byte) */
         int messageLen = min(dataPtr->length, maxSmsLength);
-        WriteByte(pduPtr->data, pos++, messageLen);
+        int udlPos = pos;
+        WriteByte(pduPtr->data, pos++, messageLen + udhLen);
 
-        if(tpUdhi)
+        if (tpUdhi)
         {
-            LE_ERROR("Udhi not supported");
+            /* TP-UDH: Concatenated short message, 8-bit reference number (6 bytes) */
+            WriteByte(pduPtr->data, pos++, CONCAT_UDH_LEN - 1);
+            WriteByte(pduPtr->data, pos++, UDH_IEI_CONCAT_8BIT_REF);
+            WriteByte(pduPtr->data, pos++, 3);
+            WriteByte(pduPtr->data, pos++, dataPtr->concatRef);
+            WriteByte(pduPtr->data, pos++, dataPtr->concatCount);
+            WriteByte(pduPtr->data, pos++, dataPtr->concatSeq);
         }
 
         /* TP-UD: User Data */
@@ -1579,7 +1830,7 @@ static le_result_t EncodeMessageGsm
                                                0,
                                                messageLen,
                                                &pduPtr->data[pos],
-                                               LE_SMS_PDU_MAX_PAYLOAD,
+                                               LE_SMS_PDU_MAX_PAYLOAD - udhLen,
                                                &newMessageLen);
                 if (size==LE_OVERFLOW)
                 {
@@ -1587,16 +1838,37 @@ static le_result_t EncodeMessageGsm
                     return LE_OVERFLOW;
                 }
 
-                // Update message length size for special char.
+                // The septets start on a septet boundary after the UDH: add the fill bits.
+                int fillBits = (7 - (udhLen * 8) % 7) % 7;
+                if (fillBits)
+                {
+                    int idx;
+
+                    for (idx = size; idx > 0; idx--)
+                    {
+                        pduPtr->data[pos + idx] = (pduPtr->data[pos + idx] << fillBits) |
+                                                  (pduPtr->data[pos + idx - 1] >> (8 - fillBits));
+                    }
+                    pduPtr->data[pos] <<= fillBits;
+                    size = (newMessageLen * 7 + fillBits + 7) / 8;
+
+                    if (udhLen + size > LE_SMS_PDU_MAX_PAYLOAD)
+                    {
+                        LE_ERROR("Overflow occurs when converting 8bits to 7bits");
+                        return LE_OVERFLOW;
+                    }
+                }
+
+                // Update message length size for special char, and the UDH in septets.
                 /* TP-UDL: User Data Length (1 byte) */
-                WriteByte(pduPtr->data, pos-1 , newMessageLen);
+                WriteByte(pduPtr->data, udlPos, newMessageLen + (udhLen * 8 + fillBits) / 7);
 
                 pos+=size;
                 break;
             }
             case SMSPDU_8_BITS:
             {
-                if (messageLen <= LE_SMS_PDU_MAX_PAYLOAD)
+                if (messageLen <= LE_SMS_PDU_MAX_PAYLOAD - udhLen)
                 {
                     memcpy(&pduPtr->data[pos], dataPtr->messagePtr, messageLen);
 
@@ -1611,7 +1883,7 @@ static le_result_t EncodeMessageGsm
             }
             case SMSPDU_UCS2_16_BITS:
             {
-                if (messageLen <= LE_SMS_PDU_MAX_PAYLOAD)
+                if (messageLen <= LE_SMS_PDU_MAX_PAYLOAD - udhLen)
                 {
                     memcpy(&pduPtr->data[pos], dataPtr->messagePtr, messageLen);
                     pos += messageLen;
@@ -1641,10 +1913,11 @@ static le_result_t EncodeMessageGsm
 //--------------------------------------------------------------------------------------------------
 static le_result_t DecodeMessageGsm
 (
-    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
-    size_t            dataSize, ///< [IN] PDU data size
-    bool              smscInfo, ///< [IN] Indicates if PDU starts with SMSC information
-    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+    const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
+    size_t            dataSize,     ///< [IN] PDU data size
+    bool              smscInfo,     ///< [IN] Indicates if PDU starts with SMSC information
+    bool              decodeData,   ///< [IN] false to leave the user data undecoded
+    pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
     le_result_t result;
@@ -1673,13 +1946,13 @@ static le_result_t DecodeMessageGsm
         case TP_MTI_SMS_DELIVER:
             smsPtr->type = PA_SMS_DELIVER;
             smsPtr->smsDeliver.option = PA_SMS_OPTIONMASK_NO_OPTION;
-            result = DecodePduDeliver(dataPtr, pos, smsPtr);
+            result = DecodePduDeliver(dataPtr, pos, decodeData, smsPtr);
             break;
 
         case TP_MTI_SMS_SUBMIT:
             smsPtr->type = PA_SMS_SUBMIT;
             smsPtr->smsSubmit.option = PA_SMS_OPTIONMASK_NO_OPTION;
-            result = DecodePduSubmit(dataPtr, pos, smsPtr);
+            result = DecodePduSubmit(dataPtr, pos, decodeData, smsPtr);
             break;
 
         case TP_MTI_SMS_STATUS_REPORT:
@@ -1846,29 +2119,27 @@ static le_result_t EncodeCdma7BitsData
     uint8_t       *a7bitsNumber ///< [OUT] number of char in 7bitsPtr
 )
 {
+    SeptetPacker_t packer;
     int read;
-    int write = 0;
-    int size = 0;
 
     memset(a7bitPtr,0,a7bitSize);
+    InitSeptetPacker(&packer, a7bitPtr, a7bitSize);
 
     for (read = 0; read < a8bitPtrSize; ++read)
     {
-        if (size>a7bitSize)
+        if (PackCdma7Bits(&packer, a8bitPtr[read]) != LE_OK)
         {
             return LE_OVERFLOW;
         }
+    }
 
-        WriteCdma7Bits(a7bitPtr, a8bitPtr[read], write*7);
-        write++;
-
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
+    if (FlushSeptetPacker(&packer, true) != LE_OK)
+    {
+        return LE_OVERFLOW;
     }
 
     /* Number of written chars */
-    *a7bitsNumber = write;
+    *a7bitsNumber = packer.count;
 
     return LE_OK;
 }
@@ -1890,24 +2161,17 @@ static le_result_t DecodeCdma7bitsData
     uint32_t      *a8bitNumber   ///< [OUT] number of char written
 )
 {
-    int read;
-    int write;
-
     memset(a8bitPtr,0,a8bitSize);
 
-    for (read = 0, write = 0; read < a7bitPtrSize; read++, write++)
+    // Septets are plain ASCII characters, they are unpacked in place.
+    UnpackCdma7Bits(a7bitPtr, min(a7bitPtrSize, a8bitSize), a8bitPtr);
+
+    if (a7bitPtrSize > a8bitSize)
     {
-        if (write < a8bitSize)
-        {
-            a8bitPtr[write] = ReadCdma7Bits(a7bitPtr, read*7);
-        }
-        else
-        {
-            return LE_OVERFLOW;
-        }
+        return LE_OVERFLOW;
     }
 
-    *a8bitNumber = write;
+    *a8bitNumber = a7bitPtrSize;
 
     return LE_OK;
 }
@@ -2301,6 +2565,7 @@ static le_result_t GetCdmaMessageData
     uint8_t         *data,          ///< [OUT] data converted
     size_t           dataSize,      ///< [IN] size of data
     uint32_t        *dataLen,       ///< [OUT] data length
+    bool             decodeData,    ///< [IN] false to only set the format
     le_sms_Format_t *format         ///< [OUT] format
 )
 {
@@ -2323,6 +2588,11 @@ static le_result_t GetCdmaMessageData
     {
         case CDMAPDU_ENCODING_7BIT_ASCII:
         {
+            *format = LE_SMS_FORMAT_TEXT;
+            if (!decodeData)
+            {
+                break;
+            }
             le_result_t result = DecodeCdma7bitsData(cdmaMessage->message.bearerData.userData.chari,
                                               cdmaMessage->message.bearerData.userData.fieldsNumber,
                                               data,
@@ -2333,11 +2603,15 @@ static le_result_t GetCdmaMessageData
                 LE_WARN("Overflow occur when decoding user data");
                 return LE_OVERFLOW;
             }
-            *format = LE_SMS_FORMAT_TEXT;
             break;
         }
         case CDMAPDU_ENCODING_OCTET:
         {
+            *format = LE_SMS_FORMAT_BINARY;
+            if (!decodeData)
+            {
+                break;
+            }
             if (cdmaMessage->message.bearerData.userData.fieldsNumber>dataSize-1)
             {
                 LE_WARN("Overflow occur when decoding user data");
@@ -2347,12 +2621,16 @@ static le_result_t GetCdmaMessageData
                    cdmaMessage->message.bearerData.userData.chari,
                    cdmaMessage->message.bearerData.userData.fieldsNumber);
             *dataLen = cdmaMessage->message.bearerData.userData.fieldsNumber;
-            *format = LE_SMS_FORMAT_BINARY;
             break;
         }
 
         case CDMAPDU_ENCODING_UNICODE:
         {
+            *format = LE_SMS_FORMAT_UCS2;
+            if (!decodeData)
+            {
+                break;
+            }
             LE_DEBUG("fieldsNumber %d/%d",
                 cdmaMessage->message.bearerData.userData.fieldsNumber,
                 (int) dataSize);
@@ -2366,7 +2644,6 @@ static le_result_t GetCdmaMessageData
                 cdmaMessage->message.bearerData.userData.chari,
                 cdmaMessage->message.bearerData.userData.fieldsNumber*2);
             *dataLen = (cdmaMessage->message.bearerData.userData.fieldsNumber*2);
-            *format = LE_SMS_FORMAT_UCS2;
         }
         break;
 
@@ -2576,9 +2853,10 @@ static le_result_t SetCdmaMessageData
 //--------------------------------------------------------------------------------------------------
 static le_result_t DecodeMessageCdma
 (
-    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
-    size_t            dataSize, ///< [IN] PDU data size
-    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+    const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
+    size_t            dataSize,     ///< [IN] PDU data size
+    bool              decodeData,   ///< [IN] false to leave the user data undecoded
+    pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
     le_result_t result = LE_OK;
@@ -2627,6 +2905,7 @@ static le_result_t DecodeMessageCdma
                                         smsPtr->smsDeliver.data,
                                         sizeof(smsPtr->smsDeliver.data),
                                         &smsPtr->smsDeliver.dataLen,
+                                        decodeData,
                                         &smsPtr->smsDeliver.format);
             if (result!=LE_OK)
             {
@@ -2649,6 +2928,7 @@ static le_result_t DecodeMessageCdma
                                         smsPtr->smsSubmit.data,
                                         sizeof(smsPtr->smsSubmit.data),
                                         &smsPtr->smsSubmit.dataLen,
+                                        decodeData,
                                         &smsPtr->smsSubmit.format);
             if (result!=LE_OK)
             {
@@ -2771,20 +3051,21 @@ le_result_t smsPdu_Initialize
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Decode the content of dataPtr.
+ * Decode the content of dataPtr, with or without the user data.
  *
  * @return LE_OK            Function succeed
  * @return LE_UNSUPPORTED   Protocol is not supported
  * @return LE_FAULT         Function failed
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t smsPdu_Decode
+static le_result_t DecodePdu
 (
-    pa_sms_Protocol_t protocol, ///< [IN] decoding protocol
-    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
-    size_t            dataSize, ///< [IN] PDU data size
-    bool              smscInfo, ///< [IN] indicates if PDU starts with SMSC information
-    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+    pa_sms_Protocol_t protocol,     ///< [IN] decoding protocol
+    const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
+    size_t            dataSize,     ///< [IN] PDU data size
+    bool              smscInfo,     ///< [IN] indicates if PDU starts with SMSC information
+    bool              decodeData,   ///< [IN] false to leave the user data undecoded
+    pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
     le_result_t result = LE_OK;
@@ -2797,7 +3078,7 @@ le_result_t smsPdu_Decode
 
     if (protocol == PA_SMS_PROTOCOL_GSM)
     {
-        result = DecodeMessageGsm(dataPtr, dataSize, smscInfo, smsPtr);
+        result = DecodeMessageGsm(dataPtr, dataSize, smscInfo, decodeData, smsPtr);
     }
     else if (protocol == PA_SMS_PROTOCOL_GW_CB)
     {
@@ -2805,7 +3086,7 @@ le_result_t smsPdu_Decode
     }
     else if ( protocol == PA_SMS_PROTOCOL_CDMA)
     {
-        result = DecodeMessageCdma(dataPtr, dataSize, smsPtr);
+        result = DecodeMessageCdma(dataPtr, dataSize, decodeData, smsPtr);
     }
     else
     {
@@ -2821,6 +3102,49 @@ le_result_t smsPdu_Decode
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the content of dataPtr.
+ *
+ * @return LE_OK            Function succeed
+ * @return LE_UNSUPPORTED   Protocol is not supported
+ * @return LE_FAULT         Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t smsPdu_Decode
+(
+    pa_sms_Protocol_t protocol, ///< [IN] decoding protocol
+    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
+    size_t            dataSize, ///< [IN] PDU data size
+    bool              smscInfo, ///< [IN] indicates if PDU starts with SMSC information
+    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+)
+{
+    return DecodePdu(protocol, dataPtr, dataSize, smscInfo, true, smsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the content of dataPtr, except the user data of SMS-DELIVER and SMS-SUBMIT messages:
+ * only their format is set, and their data length is 0.  Other messages are fully decoded.
+ *
+ * @return LE_OK            Function succeed
+ * @return LE_UNSUPPORTED   Protocol is not supported
+ * @return LE_FAULT         Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t smsPdu_DecodeHeader
+(
+    pa_sms_Protocol_t protocol, ///< [IN] decoding protocol
+    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
+    size_t            dataSize, ///< [IN] PDU data size
+    bool              smscInfo, ///< [IN] indicates if PDU starts with SMSC information
+    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+)
+{
+    return DecodePdu(protocol, dataPtr, dataSize, smscInfo, false, smsPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Encode the content of messagePtr in PDU format.
@@ -2861,3 +3185,34 @@ le_result_t smsPdu_Encode
 
     return result;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get how many characters of a text fit in a number of septets, once encoded in the 7 bits
+ * alphabet: some characters take two septets.
+ *
+ * @return The number of characters, at most length.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t smsPdu_Get7BitsSplitLength
+(
+    const uint8_t*  textPtr,    ///< [IN] Text to split
+    size_t          length,     ///< [IN] Length of the text
+    size_t          maxSeptets  ///< [IN] Number of septets available
+)
+{
+    size_t septets = 0;
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        // Escaped characters are marked by having 128 added to their value.
+        septets += (Ascii8to7[textPtr[i]] >= 128) ? 2 : 1;
+        if (septets > maxSeptets)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
@@ -26,6 +26,14 @@ typedef enum
 }
 smsPdu_Encoding_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of septets of text in a part of a concatenated message, after its User Data
+ * Header (cf. 3GPP TS 23.040 section 9.2.3.24.1).
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSPDU_CONCAT_7BITS_MAX_LEN     153
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Data used to encode the PDU.
@@ -40,6 +48,10 @@ typedef struct
     smsPdu_Encoding_t   encoding;       ///< Type of encoding to be used
     pa_sms_MsgType_t    messageType;    ///< Message Type
     bool                statusReport;   ///< Indicates if SMS Status Report is requested
+    uint8_t             concatCount;    ///< Number of parts of a concatenated message, 0 if the
+                                        ///< message is not concatenated
+    uint8_t             concatSeq;      ///< Part number in the concatenated message, from 1
+    uint8_t             concatRef;      ///< Reference number of the concatenated message
 }
 smsPdu_DataToEncode_t;
 
@@ -73,6 +85,25 @@ le_result_t smsPdu_Decode
     pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the content of dataPtr, except the user data of SMS-DELIVER and SMS-SUBMIT messages:
+ * only their format is set, and their data length is 0.  Other messages are fully decoded.
+ *
+ * @return LE_OK            Function succeed
+ * @return LE_UNSUPPORTED   Protocol is not supported
+ * @return LE_FAULT         Function failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t smsPdu_DecodeHeader
+(
+    pa_sms_Protocol_t protocol, ///< [IN] decoding protocol
+    const uint8_t*    dataPtr,  ///< [IN] PDU data to decode
+    size_t            dataSize, ///< [IN] PDU data size
+    bool              smscInfo, ///< [IN] indicates if PDU starts with SMSC information
+    pa_sms_Message_t* smsPtr    ///< [OUT] Buffer to store decoded data
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Encode the content of messagePtr in PDU format.
@@ -88,4 +119,19 @@ le_result_t smsPdu_Encode
     pa_sms_Pdu_t*           pduPtr      ///< [OUT] Buffer for the encoded PDU
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get how many characters of a text fit in a number of septets, once encoded in the 7 bits
+ * alphabet: some characters take two septets.
+ *
+ * @return The number of characters, at most length.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t smsPdu_Get7BitsSplitLength
+(
+    const uint8_t*  textPtr,    ///< [IN] Text to split
+    size_t          length,     ///< [IN] Length of the text
+    size_t          maxSeptets  ///< [IN] Number of septets available
+);
+
 #endif /* SMSPDU_H_ */
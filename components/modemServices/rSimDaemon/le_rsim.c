@@ -43,6 +43,13 @@
 //--------------------------------------------------------------------------------------------------
 #define RSIM_EVENTS_POOL_SIZE   2
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a SAP parameter value once padded to be 4-byte aligned
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAP_PADDED_LENGTH(length)   (((size_t)(length) + 3) & ~((size_t)3))
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumeration for the SAP session state
@@ -92,6 +99,9 @@ typedef struct
                                                 ///< used when connected to remote server
     uint16_t                    maxMsgSize;     ///< Maximum message size negotiated
                                                 ///< for current SAP session
+    le_clk_Time_t               apduStartTime;  ///< Reception time of the pending APDU
+    uint32_t                    apduCount;      ///< Number of APDUs received from the modem
+    uint64_t                    maxApduLatency; ///< Longest APDU round trip, in microseconds
 }
 RsimObject_t;
 
@@ -160,6 +170,25 @@ static le_thread_Ref_t MainThread;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t RsimMessagesPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool of the SAP messages sent to the remote SIM server. Messages are encoded directly in
+ * these preallocated buffers and reported with reference counting, avoiding any copy.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SapMessagesPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace reference used for controlling tracing in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_log_TraceRef_t TraceRef;
+
+/// Macro used to generate trace output in this module.
+/// Takes the same parameters as LE_DEBUG() et. al.
+#define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
+
 
 //--------------------------------------------------------------------------------------------------
 // Static functions
@@ -182,6 +211,93 @@ static void NotifySimStatus
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the time elapsed since a given relative time, in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedTimeUs
+(
+    le_clk_Time_t startTime     ///< Start time
+)
+{
+    le_clk_Time_t elapsedTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (((uint64_t)elapsedTime.sec * 1000000) + elapsedTime.usec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a SAP message from the preallocated pool and write its header
+ *
+ * @return The SAP message, holding only the SAP header
+ */
+//--------------------------------------------------------------------------------------------------
+static RsimMessage_t* SapCreateMessage
+(
+    uint8_t msgId,              ///< Message identifier
+    uint8_t parameterNumber     ///< Number of parameters of the message
+)
+{
+    RsimMessage_t* rsimMessagePtr = le_mem_ForceAlloc(SapMessagesPool);
+
+    // SAP header
+    rsimMessagePtr->message[0] = msgId;             // MsgId
+    rsimMessagePtr->message[1] = parameterNumber;   // Parameters number
+    rsimMessagePtr->message[2] = 0x00;              // Reserved
+    rsimMessagePtr->message[3] = 0x00;              // Reserved
+    rsimMessagePtr->messageSize = SAP_LENGTH_SAP_HEADER;
+
+    return rsimMessagePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a parameter to a SAP message. The parameter value is padded to be 4-byte aligned.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SapAddParameter
+(
+    RsimMessage_t* rsimMessagePtr,  ///< SAP message
+    uint8_t        parameterId,     ///< Parameter identifier
+    const uint8_t* valuePtr,        ///< Parameter value
+    uint16_t       valueLength      ///< Parameter value length
+)
+{
+    size_t paddedLength = SAP_PADDED_LENGTH(valueLength);
+    uint8_t* parameterPtr = &rsimMessagePtr->message[rsimMessagePtr->messageSize];
+
+    LE_ASSERT((rsimMessagePtr->messageSize + SAP_LENGTH_PARAM_HEADER + paddedLength)
+              <= LE_RSIM_MAX_MSG_SIZE);
+
+    // Parameter header
+    parameterPtr[0] = parameterId;                              // Parameter Id
+    parameterPtr[1] = 0x00;                                     // Reserved
+    parameterPtr[2] = ((valueLength & 0xFF00U) >> MSB_SHIFT);   // Parameter length (MSB)
+    parameterPtr[3] = (valueLength & 0x00FF);                   // Parameter length (LSB)
+
+    // Parameter value and padding
+    memcpy(&parameterPtr[SAP_LENGTH_PARAM_HEADER], valuePtr, valueLength);
+    memset(&parameterPtr[SAP_LENGTH_PARAM_HEADER + valueLength], 0, paddedLength - valueLength);
+
+    rsimMessagePtr->messageSize += SAP_LENGTH_PARAM_HEADER + paddedLength;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a SAP message by notifying it to the remote SIM server. The message is released once it
+ * has been notified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SapSendMessage
+(
+    RsimMessage_t* rsimMessagePtr   ///< SAP message
+)
+{
+    LE_DUMP(rsimMessagePtr->message, rsimMessagePtr->messageSize);
+    le_event_ReportWithRefCounting(RsimMsgEventId, rsimMessagePtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send a SAP TRANSFER_ATR_REQ message and update the SAP session sub-state
@@ -193,25 +309,14 @@ static void SendSapTransferAtrReq
 )
 {
     // Create TRANSFER_ATR_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_TRANSFER_ATR_REQ;    // MsgId (TRANSFER_ATR_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
-
-    // Set message size
-    RsimMessage.messageSize = 4;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_TRANSFER_ATR_REQ, 0);
 
     // Update SAP session sub-state
     RsimObject.sapSubState = sapSubState;
 
     // Send TRANSFER_ATR_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send TRANSFER_ATR_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -224,35 +329,9 @@ static void SendSapTransferApduReq
     pa_rsim_ApduInd_t* apduInd
 )
 {
-    // Create TRANSFER_APDU_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    size_t size = 0;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_TRANSFER_APDU_REQ;           // MsgId (TRANSFER_APDU_REQ)
-    RsimMessage.message[1] = 0x01;                                  // Parameters number
-    RsimMessage.message[2] = 0x00;                                  // Reserved
-    RsimMessage.message[3] = 0x00;                                  // Reserved
-
-    // Parameter header
-    RsimMessage.message[4] = SAP_PARAMID_COMMAND_APDU;              // Parameter Id (CommandAPDU)
-    RsimMessage.message[5] = 0x00;                                  // Reserved
-    RsimMessage.message[6] = ((apduInd->apduLength & 0xFF00U) >> MSB_SHIFT);// APDU length (MSB)
-    RsimMessage.message[7] = (apduInd->apduLength & 0x00FF);        // APDU length (LSB)
-
-    // Current message size
-    size = 8;
-
-    // Parameter value (APDU)
-    memcpy(&RsimMessage.message[size], apduInd->apduData, apduInd->apduLength);
-    size += apduInd->apduLength;
-
-    // Set message size, which should be 4-byte aligned
-    size += (4 - (size % 4));
-    RsimMessage.messageSize = size;
-
     // Check message length
+    size_t size = SAP_LENGTH_SAP_HEADER + SAP_LENGTH_PARAM_HEADER
+                  + SAP_PADDED_LENGTH(apduInd->apduLength);
     if (size > RsimObject.maxMsgSize)
     {
         LE_ERROR("SAP message too long! Size=%zu, MaxSize=%d",
@@ -263,17 +342,25 @@ static void SendSapTransferApduReq
         {
             LE_ERROR("Error when transmitting APDU response error");
         }
+        return;
     }
-    else
-    {
-        // Update SAP session sub-state
-        RsimObject.sapSubState = SAP_SESSION_CONNECTED_APDU;
 
-        // Send TRANSFER_APDU_REQ message by notifying it to the remote SIM server
-        LE_DEBUG("Send TRANSFER_APDU_REQ message:");
-        LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-        le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
-    }
+    // Create TRANSFER_APDU_REQ message to transmit
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_TRANSFER_APDU_REQ, 1);
+    SapAddParameter(rsimMessagePtr,
+                    SAP_PARAMID_COMMAND_APDU,
+                    apduInd->apduData,
+                    apduInd->apduLength);
+
+    // Update SAP session sub-state
+    RsimObject.sapSubState = SAP_SESSION_CONNECTED_APDU;
+
+    // Send TRANSFER_APDU_REQ message by notifying it to the remote SIM server
+    LE_DEBUG("Send TRANSFER_APDU_REQ message:");
+    SapSendMessage(rsimMessagePtr);
+
+    TRACE("APDU #%"PRIu32": TRANSFER_APDU_REQ sent %"PRIu64" us after the modem indication",
+          RsimObject.apduCount, GetElapsedTimeUs(RsimObject.apduStartTime));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -299,29 +386,12 @@ static le_result_t SendSapConnectReq
     }
 
     // Create CONNECT_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
+    uint8_t maxMsgSize[SAP_LENGTH_MAX_MSG_SIZE];
+    maxMsgSize[0] = ((RsimObject.maxMsgSize & 0xFF00U) >> MSB_SHIFT);   // MaxMsgSize (MSB)
+    maxMsgSize[1] = (RsimObject.maxMsgSize & 0x00FF);                   // MaxMsgSize (LSB)
 
-    // SAP header
-    RsimMessage.message[0]  = SAP_MSGID_CONNECT_REQ;                    // MsgId (CONNECT_REQ)
-    RsimMessage.message[1]  = 0x01;                                     // Parameters number
-    RsimMessage.message[2]  = 0x00;                                     // Reserved
-    RsimMessage.message[3]  = 0x00;                                     // Reserved
-
-    // Parameter header
-    RsimMessage.message[4]  = SAP_PARAMID_MAX_MSG_SIZE;                 // Parameter Id (MaxMsgSize)
-    RsimMessage.message[5]  = 0x00;                                     // Reserved
-    RsimMessage.message[6]  = 0x00;                                     // Parameter length (MSB)
-    RsimMessage.message[7]  = SAP_LENGTH_MAX_MSG_SIZE;                  // Parameter length (LSB)
-
-    // Parameter value (MaxMsgSize)
-    RsimMessage.message[8]  = ((RsimObject.maxMsgSize & 0xFF00U) >> MSB_SHIFT); // MaxMsgSize (MSB)
-    RsimMessage.message[9]  = (RsimObject.maxMsgSize & 0x00FF);                 // MaxMsgSize (LSB)
-    RsimMessage.message[10] = 0x00;                                             // Padding
-    RsimMessage.message[11] = 0x00;                                             // Padding
-
-    // Set message size
-    RsimMessage.messageSize = 12;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_CONNECT_REQ, 1);
+    SapAddParameter(rsimMessagePtr, SAP_PARAMID_MAX_MSG_SIZE, maxMsgSize, sizeof(maxMsgSize));
 
     // Start timer securing the connection establishment
     if (LE_OK != le_timer_Start(SapConnectionTimer))
@@ -334,8 +404,7 @@ static le_result_t SendSapConnectReq
 
     // Send CONNECT_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send CONNECT_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
 
     return LE_OK;
 }
@@ -362,25 +431,14 @@ static le_result_t SendSapPowerSimOffReq
     }
 
     // Create POWER_SIM_OFF_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_POWER_SIM_OFF_REQ;   // MsgId (POWER_SIM_OFF_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
-
-    // Set message size
-    RsimMessage.messageSize = 4;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_POWER_SIM_OFF_REQ, 0);
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_POWER_OFF;
 
     // Send POWER_SIM_OFF_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send POWER_SIM_OFF_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
 
     return LE_OK;
 }
@@ -410,25 +468,14 @@ static le_result_t SendSapPowerSimOnReq
     }
 
     // Create POWER_SIM_ON_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_POWER_SIM_ON_REQ;    // MsgId (POWER_SIM_ON_REQ)
-    RsimMessage.message[1] = 0x00;                          // Parameters number
-    RsimMessage.message[2] = 0x00;                          // Reserved
-    RsimMessage.message[3] = 0x00;                          // Reserved
-
-    // Set message size
-    RsimMessage.messageSize = 4;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_POWER_SIM_ON_REQ, 0);
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_POWER_ON;
 
     // Send POWER_SIM_ON_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send POWER_SIM_ON_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
 
     return LE_OK;
 }
@@ -459,25 +506,14 @@ static le_result_t SendSapResetSimReq
     }
 
     // Create RESET_SIM_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_RESET_SIM_REQ;   // MsgId (RESET_SIM_REQ)
-    RsimMessage.message[1] = 0x00;                      // Parameters number
-    RsimMessage.message[2] = 0x00;                      // Reserved
-    RsimMessage.message[3] = 0x00;                      // Reserved
-
-    // Set message size
-    RsimMessage.messageSize = 4;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_RESET_SIM_REQ, 0);
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_RESET;
 
     // Send RESET_SIM_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send RESET_SIM_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
 
     return LE_OK;
 }
@@ -493,25 +529,72 @@ static void SendSapDisconnectReq
 )
 {
     // Create DISCONNECT_REQ message to transmit
-    RsimMessage_t RsimMessage;
-    memset(&RsimMessage, 0, sizeof(RsimMessage_t));
-
-    // SAP header
-    RsimMessage.message[0] = SAP_MSGID_DISCONNECT_REQ;  // MsgId (DISCONNECT_REQ)
-    RsimMessage.message[1] = 0x00;                      // Parameters number
-    RsimMessage.message[2] = 0x00;                      // Reserved
-    RsimMessage.message[3] = 0x00;                      // Reserved
-
-    // Set message size
-    RsimMessage.messageSize = 4;
+    RsimMessage_t* rsimMessagePtr = SapCreateMessage(SAP_MSGID_DISCONNECT_REQ, 0);
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_DISCONNECT;
 
     // Send DISCONNECT_REQ message by notifying it to the remote SIM server
     LE_DEBUG("Send DISCONNECT_REQ message:");
-    LE_DUMP(RsimMessage.message, RsimMessage.messageSize);
-    le_event_Report(RsimMsgEventId, &(RsimMessage), sizeof(RsimMessage));
+    SapSendMessage(rsimMessagePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a parameter of a SAP message, checking that its header and value fit in the message.
+ *
+ * @return
+ *  - LE_OK             Parameter found, valuePtr and valueLengthPtr are set
+ *  - LE_FAULT          Message incorrectly formatted
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SapGetParameter
+(
+    const uint8_t*  messagePtr,         ///< SAP message buffer
+    size_t          messageNumElements, ///< SAP message size
+    uint8_t         parameterNumber,    ///< Parameter number in SAP message
+    uint8_t*        parameterIdPtr,     ///< [OUT] Parameter identifier
+    const uint8_t** valuePtrPtr,        ///< [OUT] Parameter value
+    uint16_t*       valueLengthPtr      ///< [OUT] Parameter value length
+)
+{
+    size_t offset = SAP_LENGTH_SAP_HEADER;
+    uint8_t i;
+
+    if ((messageNumElements < SAP_LENGTH_SAP_HEADER) || (messagePtr[1] < parameterNumber))
+    {
+        LE_ERROR("Parameter %d not found in SAP message", parameterNumber);
+        return LE_FAULT;
+    }
+
+    for (i = 1; i <= parameterNumber; i++)
+    {
+        if ((offset + SAP_LENGTH_PARAM_HEADER) > messageNumElements)
+        {
+            LE_ERROR("SAP message too short: %zu bytes", messageNumElements);
+            return LE_FAULT;
+        }
+
+        uint16_t length = (uint16_t)( ((uint16_t)(messagePtr[offset + 2] << MSB_SHIFT))
+                                      | messagePtr[offset + 3]);
+        if ((offset + SAP_LENGTH_PARAM_HEADER + length) > messageNumElements)
+        {
+            LE_ERROR("Parameter length %d exceeds SAP message size %zu",
+                     length, messageNumElements);
+            return LE_FAULT;
+        }
+
+        if (i == parameterNumber)
+        {
+            *parameterIdPtr = messagePtr[offset];
+            *valuePtrPtr = &messagePtr[offset + SAP_LENGTH_PARAM_HEADER];
+            *valueLengthPtr = length;
+        }
+
+        offset += SAP_LENGTH_PARAM_HEADER + SAP_PADDED_LENGTH(length);
+    }
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -980,6 +1063,8 @@ static le_result_t ProcessSapTransferApduResp
     le_result_t result = LE_OK;
     uint8_t resultCode = messagePtr[8];
     LE_DEBUG("TRANSFER_APDU_RESP received: ResultCode=%d", resultCode);
+    TRACE("APDU #%"PRIu32": TRANSFER_APDU_RESP received %"PRIu64" us after the modem indication",
+          RsimObject.apduCount, GetElapsedTimeUs(RsimObject.apduStartTime));
 
     // Update SAP session sub-state
     RsimObject.sapSubState = SAP_SESSION_CONNECTED_IDLE;
@@ -988,32 +1073,40 @@ static le_result_t ProcessSapTransferApduResp
     switch (resultCode)
     {
         case SAP_RESULTCODE_OK: // OK, request processed correctly
+        {
             // Check if APDU parameter (second parameter) is present and correct
+            uint8_t parameterId;
+            const uint8_t* apduPtr;
+            uint16_t apduLength;
             parameterNumber = 2;
-            if (LE_OK == SapCheckParameter(messagePtr,
-                                           messageNumElements,
-                                           SAP_PARAMID_COMMAND_APDU,
-                                           0,
-                                           parameterNumber))
+            if (   (LE_OK == SapGetParameter(messagePtr, messageNumElements, parameterNumber,
+                                             &parameterId, &apduPtr, &apduLength))
+                && (   (SAP_PARAMID_RESPONSE_APDU == parameterId)
+                    || (SAP_PARAMID_COMMAND_APDU == parameterId))
+               )
             {
-                uint8_t apduLenByte1  = 14; // APDU length MSB in the message
-                uint8_t apduLenByte2  = 15; // APDU length LSB in the message
-                uint8_t apduFirstByte = 16; // APDU buffer starts at 16th byte in the message
-                uint16_t apduLength =
-                    (uint16_t) ( ((uint16_t)(messagePtr[apduLenByte1] << MSB_SHIFT))
-                                 | messagePtr[apduLenByte2]);
                 // Transmit the APDU response to the modem
-                if (LE_OK != pa_rsim_TransferApduResp(&messagePtr[apduFirstByte], apduLength))
+                if (LE_OK != pa_rsim_TransferApduResp(apduPtr, apduLength))
                 {
                     LE_ERROR("Error when transmitting APDU response");
                     result = LE_FAULT;
                 }
+
+                uint64_t latency = GetElapsedTimeUs(RsimObject.apduStartTime);
+                if (latency > RsimObject.maxApduLatency)
+                {
+                    RsimObject.maxApduLatency = latency;
+                }
+                TRACE("APDU #%"PRIu32": %d-byte response delivered to the modem in %"PRIu64
+                      " us (max %"PRIu64" us)", RsimObject.apduCount, apduLength, latency,
+                      RsimObject.maxApduLatency);
             }
             else
             {
                 LE_ERROR("APDU missing or improperly formatted in TRANSFER_APDU_RESP message");
                 result = LE_FORMAT_ERROR;
             }
+        }
         break;
 
         case SAP_RESULTCODE_ERROR_NO_REASON:    // Error, no reason defined
@@ -1562,6 +1655,8 @@ static void FirstLayerRsimMessageHandler
     le_rsim_MessageHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
 
     clientHandlerFunc(messageEvent->message, messageEvent->messageSize, le_event_GetContextPtr());
+
+    le_mem_Release(reportPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1660,6 +1755,11 @@ static void ApduNotificationHandler
     LE_DEBUG("APDU received:");
     LE_DUMP(apduInd->apduData, apduInd->apduLength);
 
+    RsimObject.apduStartTime = le_clk_GetRelativeTime();
+    RsimObject.apduCount++;
+    TRACE("APDU #%"PRIu32": %d bytes received from the modem",
+          RsimObject.apduCount, apduInd->apduLength);
+
     // Check if state is coherent
     if (   (SAP_SESSION_CONNECTED == RsimObject.sapState)
         && (SAP_SESSION_CONNECTED_IDLE == RsimObject.sapSubState)
@@ -1724,11 +1824,18 @@ le_result_t le_rsim_Init
 {
     LE_INFO("le_rsim_Init called");
 
+    // Get a reference to the trace keyword that is used to control tracing in this module
+    TraceRef = le_log_GetTraceRef("rsim");
+
     // Store the main thread for further use
     MainThread = le_thread_GetCurrent();
 
     // Create an event Id for RSIM messages notification
-    RsimMsgEventId = le_event_CreateId("RsimMessage", sizeof(RsimMessage_t));
+    RsimMsgEventId = le_event_CreateIdWithRefCounting("RsimMessage");
+
+    // Create and expand SAP messages memory pool
+    SapMessagesPool = le_mem_CreatePool("SapMessagesPool", sizeof(RsimMessage_t));
+    le_mem_ExpandPool(SapMessagesPool, RSIM_EVENTS_POOL_SIZE);
 
     // Create and expand RSIM messages memory pool
     RsimMessagesPool = le_mem_CreatePool("RsimMessagesPool", sizeof(RsimMessageSending_t));
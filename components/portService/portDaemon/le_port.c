@@ -61,66 +61,73 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of possible mode string.
+ * Maximum number of links.
  */
 //--------------------------------------------------------------------------------------------------
-#define POSSIBLE_MODE_MAX_BYTES  10
+#define MAX_LINKS                2
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of links.
+ * Maximum length of device path string.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_LINKS                2
+#define PATH_MAX_BYTES           50
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of possible modes.
+ * Maximum number of clients
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_POSSIBLE_MODES       2
+#define MAX_CLIENTS              1
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of device path string.
+ * The timer interval to kick the watchdog chain.
  */
 //--------------------------------------------------------------------------------------------------
-#define PATH_MAX_BYTES           50
+#define MS_WDOG_INTERVAL         8
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of opentype string.
+ * Maximum length of client socket.
  */
 //--------------------------------------------------------------------------------------------------
-#define OPEN_TYPE_MAX_BYTES      20
+#define CLIENT_SOCKET_MAX_BYTES  30
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of clients
+ * Maximum length of server socket.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CLIENTS              1
+#define SERVER_SOCKET_MAX_BYTES  30
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The timer interval to kick the watchdog chain.
+ * Expected number of instances in the JSON configuration.
  */
 //--------------------------------------------------------------------------------------------------
-#define MS_WDOG_INTERVAL         8
+#define INSTANCE_MAP_SIZE        8
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of client socket.
+ * Link modes, i.e. the "possibleMode" values of a link, as a bit mask.
  */
 //--------------------------------------------------------------------------------------------------
-#define CLIENT_SOCKET_MAX_BYTES  30
+#define LINK_MODE_AT             0x01    ///< "AT": the link is given to the AT server.
+#define LINK_MODE_DATA           0x02    ///< "DATA": the link is given to the client in data mode.
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of server socket.
+ * Link opening types, i.e. the "openingType" values of a link.
  */
 //--------------------------------------------------------------------------------------------------
-#define SERVER_SOCKET_MAX_BYTES  30
+typedef enum
+{
+    OPENING_TYPE_NONE,                      ///< No opening type configured.
+    OPENING_TYPE_SERIAL_LINK,               ///< "serialLink": serial device.
+    OPENING_TYPE_UNIX_SOCKET                ///< "unixSocket": Unix socket server.
+}
+OpeningType_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -140,8 +147,8 @@ typedef struct
     le_atServer_DeviceRef_t atServerDevRef;                         ///< AT server device reference.
     char linkName[LINK_NAME_MAX_BYTES];                             ///< Link name.
     char path[PATH_MAX_BYTES];                                      ///< Path name.
-    char openingType[OPEN_TYPE_MAX_BYTES];                          ///< Device opening type.
-    char possibleMode[MAX_POSSIBLE_MODES][POSSIBLE_MODE_MAX_BYTES]; ///< Possible mode name.
+    OpeningType_t openingType;                                      ///< Device opening type.
+    uint8_t modes;                                                  ///< Possible modes, LINK_MODE_*.
     bool suspended;
 }
 LinkInformation_t;
@@ -248,6 +255,13 @@ static le_dls_List_t DeviceList;
 //--------------------------------------------------------------------------------------------------
 static le_dls_List_t InstanceContextList;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Instances by name, for the device requests.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t InstanceMap;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * JSON file descriptor.
@@ -269,13 +283,6 @@ static bool JsonParseComplete;
 //--------------------------------------------------------------------------------------------------
 static int OpenLinkNumber;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Current possible mode number.
- */
-//--------------------------------------------------------------------------------------------------
-static int PossibleModeNumber;
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Semaphore to be used for client socket connection.
@@ -338,24 +345,16 @@ static InstanceConfiguration_t* GetInstanceFromDeviceName
     const char* deviceNamePtr    ///< [IN] Device name.
 )
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&InstanceContextList);
+    InstanceConfiguration_t* instanceConfigPtr = le_hashmap_Get(InstanceMap, deviceNamePtr);
 
-    while (linkPtr)
+    if (NULL == instanceConfigPtr)
     {
-        InstanceConfiguration_t* instanceConfigPtr = CONTAINER_OF(linkPtr,
-                                                                  InstanceConfiguration_t,
-                                                                  link);
-        linkPtr = le_dls_PeekNext(&InstanceContextList, linkPtr);
-
-        if (0 == strcmp(instanceConfigPtr->instanceName, deviceNamePtr))
-        {
-            LE_DEBUG("Instance found: %p", instanceConfigPtr);
-            return instanceConfigPtr;
-        }
+        LE_ERROR("Not able to get the instance");
+        return NULL;
     }
 
-    LE_ERROR("Not able to get the instance");
-    return NULL;
+    LE_DEBUG("Instance found: %p", instanceConfigPtr);
+    return instanceConfigPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -623,16 +622,24 @@ static void OpeningTypeEventHandler
 
             LE_ASSERT(instanceConfigPtr != NULL);
 
-            if (LE_OK != le_utf8_Copy(instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]
-                                      ->openingType, memberName, OPEN_TYPE_MAX_BYTES, NULL))
+            LinkInformation_t* linkInfoPtr =
+                                   instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter];
+
+            if (0 == strcmp(memberName, "serialLink"))
             {
-                LE_ERROR("openingType is not set properly!");
-                CleanJsonConfig();
+                linkInfoPtr->openingType = OPENING_TYPE_SERIAL_LINK;
+                le_json_SetEventHandler(DeviceEventHandler);
             }
-            else
+            else if (0 == strcmp(memberName, "unixSocket"))
             {
+                linkInfoPtr->openingType = OPENING_TYPE_UNIX_SOCKET;
                 le_json_SetEventHandler(DeviceEventHandler);
             }
+            else
+            {
+                LE_ERROR("openingType '%s' is not supported!", memberName);
+                CleanJsonConfig();
+            }
             break;
         }
 
@@ -681,16 +688,21 @@ static void PossibleModeEventHandler
         case LE_JSON_STRING:
         {
             const char* memberName = le_json_GetString();
-            if (LE_OK != le_utf8_Copy(instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]
-                                      ->possibleMode[PossibleModeNumber], memberName,
-                                       POSSIBLE_MODE_MAX_BYTES, NULL))
+            LinkInformation_t* linkInfoPtr =
+                                   instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter];
+
+            if (0 == strcmp(memberName, "AT"))
             {
-                LE_ERROR("possibleMode is not set properly!");
-                CleanJsonConfig();
+                linkInfoPtr->modes |= LINK_MODE_AT;
+            }
+            else if (0 == strcmp(memberName, "DATA"))
+            {
+                linkInfoPtr->modes |= LINK_MODE_DATA;
             }
             else
             {
-                PossibleModeNumber++;
+                LE_ERROR("possibleMode '%s' is not supported!", memberName);
+                CleanJsonConfig();
             }
             break;
         }
@@ -760,9 +772,9 @@ static void DeviceEventHandler
                 instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]->dataModeSockFd = -1;
                 instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]->atServerDevRef = NULL;
                 instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]->suspended = false;
-
-                // Initialize the counter before parsing of new link.
-                PossibleModeNumber = 0;
+                instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]->openingType =
+                                                                              OPENING_TYPE_NONE;
+                instanceConfigPtr->linkInfo[instanceConfigPtr->linkCounter]->modes = 0;
 
                 if (LE_OK != le_utf8_Copy(instanceConfigPtr->linkInfo[instanceConfigPtr
                                           ->linkCounter]->linkName, linkName, LINK_NAME_MAX_BYTES,
@@ -915,7 +927,8 @@ static void MonitorSocket
 
         linkInfoPtr = (LinkInformation_t**)le_fdMonitor_GetContextPtr();
 
-        if (0 == strcmp((*linkInfoPtr)->possibleMode[0], "DATA"))
+        // Clients of the socket opened by SetDataMode get the data mode fd.
+        if (sockFd == (*linkInfoPtr)->dataModeSockFd)
         {
             LE_DEBUG("Socket opens in data mode.");
             (*linkInfoPtr)->dataModeFd = dup(clientFd);
@@ -1024,7 +1037,7 @@ static le_result_t OpenInstanceLinks
     InstanceConfiguration_t* instanceConfigPtr ///< [IN] Instance configuaration.
 )
 {
-    int i, j;
+    int i;
 
     le_dls_Link_t* linkPtr = le_dls_Peek(&(instanceConfigPtr->linkList));
 
@@ -1036,47 +1049,40 @@ static le_result_t OpenInstanceLinks
             (0 == strcmp(instanceConfigPtr->linkInfo[i]->linkName, linkListPtr->linkName)))
         {
             linkPtr = le_dls_PeekNext(&(instanceConfigPtr->linkList), linkPtr);
-            if (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "serialLink"))
+            if (0 == (instanceConfigPtr->linkInfo[i]->modes & LINK_MODE_AT))
+            {
+                continue;
+            }
+
+            if (OPENING_TYPE_SERIAL_LINK == instanceConfigPtr->linkInfo[i]->openingType)
             {
-                for (j = 0; j < MAX_POSSIBLE_MODES; j++)
+                instanceConfigPtr->linkInfo[i]->fd = OpenSerialDevice(instanceConfigPtr
+                                                     ->linkInfo[i]->path);
+
+                if (0 > instanceConfigPtr->linkInfo[i]->fd)
                 {
-                    if (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "AT"))
-                    {
-                        instanceConfigPtr->linkInfo[i]->fd = OpenSerialDevice(instanceConfigPtr
-                                                             ->linkInfo[i]->path);
-
-                        if (0 > instanceConfigPtr->linkInfo[i]->fd)
-                        {
-                            LE_ERROR("Error in opening the device '%s': %m",
-                                     instanceConfigPtr->instanceName);
-                            return LE_FAULT;
-                        }
-
-                        instanceConfigPtr->linkInfo[i]->atServerDevRef =
-                                          le_atServer_Open(dup(instanceConfigPtr->linkInfo[i]->fd));
-                        if (NULL == instanceConfigPtr->linkInfo[i]->atServerDevRef)
-                        {
-                            LE_ERROR("atServerDevRef is NULL!");
-                            return LE_FAULT;
-                        }
-                    }
+                    LE_ERROR("Error in opening the device '%s': %m",
+                             instanceConfigPtr->instanceName);
+                    return LE_FAULT;
+                }
+
+                instanceConfigPtr->linkInfo[i]->atServerDevRef =
+                                  le_atServer_Open(dup(instanceConfigPtr->linkInfo[i]->fd));
+                if (NULL == instanceConfigPtr->linkInfo[i]->atServerDevRef)
+                {
+                    LE_ERROR("atServerDevRef is NULL!");
+                    return LE_FAULT;
                 }
             }
-            else if (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "unixSocket"))
+            else if (OPENING_TYPE_UNIX_SOCKET == instanceConfigPtr->linkInfo[i]->openingType)
             {
-                for (j = 0; j < MAX_POSSIBLE_MODES; j++)
+                instanceConfigPtr->linkInfo[i]->atModeSockFd =
+                                   OpenSocket(&(instanceConfigPtr->linkInfo[i]));
+                if (0 > instanceConfigPtr->linkInfo[i]->atModeSockFd)
                 {
-                    if (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "AT"))
-                    {
-                        instanceConfigPtr->linkInfo[i]->atModeSockFd =
-                                           OpenSocket(&(instanceConfigPtr->linkInfo[i]));
-                        if (0 > instanceConfigPtr->linkInfo[i]->atModeSockFd)
-                        {
-                            LE_ERROR("Error in opening the device '%s': %m",
-                                     instanceConfigPtr->instanceName);
-                            return LE_FAULT;
-                        }
-                    }
+                    LE_ERROR("Error in opening the device '%s': %m",
+                             instanceConfigPtr->instanceName);
+                    return LE_FAULT;
                 }
             }
         }
@@ -1172,6 +1178,8 @@ static void JsonEventHandler
                 // Add instance into InstanceContextList.
                 instanceConfigurationPtr->link = LE_DLS_LINK_INIT;
                 le_dls_Queue(&InstanceContextList, &(instanceConfigurationPtr->link));
+                le_hashmap_Put(InstanceMap, instanceConfigurationPtr->instanceName,
+                               instanceConfigurationPtr);
 
                 // Switch to DeviceEventHandler to parse device information from JSON file.
                 le_json_SetEventHandler(DeviceEventHandler);
@@ -1211,10 +1219,8 @@ static bool GetAtServerDeviceRef
     for (i = 0; i < (instanceConfigPtr->linkCounter); i++)
     {
         // Check if the same link supports AT and DATA as possiblemode.
-        if (((0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[0], "AT")) &&
-            (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[1], "DATA"))) ||
-            ((0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[0], "DATA")) &&
-            (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[1], "AT"))))
+        if ((LINK_MODE_AT | LINK_MODE_DATA) ==
+            (instanceConfigPtr->linkInfo[i]->modes & (LINK_MODE_AT | LINK_MODE_DATA)))
         {
             *linkIndexPtr = i;
             allowSuspend = true;
@@ -1344,7 +1350,7 @@ le_result_t le_port_SetDataMode
 )
 {
     le_result_t result = LE_FAULT;
-    int i, j, linkIndex;
+    int i, linkIndex;
     le_atServer_DeviceRef_t atServerDeviceRef;
     le_clk_Time_t timeToWait = {10, 0};
     le_thread_Ref_t socketThreadRef;
@@ -1405,60 +1411,60 @@ le_result_t le_port_SetDataMode
     // Check all the links. Open the link which contains "DATA" as possibleMode.
     for (i = 0; i < (instanceConfigPtr->linkCounter); i++)
     {
-        for (j = 0; j < MAX_POSSIBLE_MODES; j++)
+        if (0 == (instanceConfigPtr->linkInfo[i]->modes & LINK_MODE_DATA))
         {
-            if ((0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "DATA")) &&
-               (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "serialLink")))
+            continue;
+        }
+
+        if (OPENING_TYPE_SERIAL_LINK == instanceConfigPtr->linkInfo[i]->openingType)
+        {
+            // If link is not opened in data mode then open the link in data mode.
+            if (-1 == instanceConfigPtr->linkInfo[i]->dataModeFd)
             {
-                // If link is not opened in data mode then open the link in data mode.
-                if (-1 == instanceConfigPtr->linkInfo[i]->dataModeFd)
-                {
-                    instanceConfigPtr->linkInfo[i]->dataModeFd =
-                                       OpenSerialDevice(instanceConfigPtr->linkInfo[i]->path);
-                }
+                instanceConfigPtr->linkInfo[i]->dataModeFd =
+                                   OpenSerialDevice(instanceConfigPtr->linkInfo[i]->path);
+            }
 
-                if (-1 != instanceConfigPtr->linkInfo[i]->dataModeFd)
-                {
-                    *fdPtr = dup(instanceConfigPtr->linkInfo[i]->dataModeFd);
-                }
-                else
-                {
-                    *fdPtr = -1;
-                }
+            if (-1 != instanceConfigPtr->linkInfo[i]->dataModeFd)
+            {
+                *fdPtr = dup(instanceConfigPtr->linkInfo[i]->dataModeFd);
             }
-            else if ((0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "DATA")) &&
-                     (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "unixSocket")))
+            else
             {
-                // If link is not opened in data mode then open the link in data mode.
-                if (-1 == instanceConfigPtr->linkInfo[i]->dataModeFd)
-                {
-                    // Create the socket thread which waits for the client connection request
-                    // and filled the file descriptor for data mode.
-                    socketThreadRef = le_thread_Create("SocketThread", SocketThread,
-                                                       (void*)(instanceConfigPtr->linkInfo[i]));
-                    le_thread_Start(socketThreadRef);
-
-                    // Wait for the server to accept the client connect request.
-                    result = le_sem_WaitWithTimeOut(Semaphore, timeToWait);
+                *fdPtr = -1;
+            }
+        }
+        else if (OPENING_TYPE_UNIX_SOCKET == instanceConfigPtr->linkInfo[i]->openingType)
+        {
+            // If link is not opened in data mode then open the link in data mode.
+            if (-1 == instanceConfigPtr->linkInfo[i]->dataModeFd)
+            {
+                // Create the socket thread which waits for the client connection request
+                // and filled the file descriptor for data mode.
+                socketThreadRef = le_thread_Create("SocketThread", SocketThread,
+                                                   (void*)(instanceConfigPtr->linkInfo[i]));
+                le_thread_Start(socketThreadRef);
 
-                    // Stop socket thread.
-                    le_thread_Cancel(socketThreadRef);
+                // Wait for the server to accept the client connect request.
+                result = le_sem_WaitWithTimeOut(Semaphore, timeToWait);
 
-                    if (LE_TIMEOUT == result)
-                    {
-                        return LE_FAULT;
-                    }
-                }
+                // Stop socket thread.
+                le_thread_Cancel(socketThreadRef);
 
-                if (-1 != instanceConfigPtr->linkInfo[i]->dataModeFd)
+                if (LE_TIMEOUT == result)
                 {
-                    *fdPtr = (instanceConfigPtr->linkInfo[i]->dataModeFd);
-                }
-                else
-                {
-                    *fdPtr = -1;
+                    return LE_FAULT;
                 }
             }
+
+            if (-1 != instanceConfigPtr->linkInfo[i]->dataModeFd)
+            {
+                *fdPtr = (instanceConfigPtr->linkInfo[i]->dataModeFd);
+            }
+            else
+            {
+                *fdPtr = -1;
+            }
         }
     }
 
@@ -1488,8 +1494,7 @@ le_result_t le_port_SetCommandMode
 )
 {
     le_result_t result;
-    int i, j, linkIndex;
-    bool atLinkDetect = false;
+    int i, linkIndex;
 
     if (false == JsonParseComplete)
     {
@@ -1522,39 +1527,30 @@ le_result_t le_port_SetCommandMode
     // command mode.
     for (i = 0; i < (instanceConfigPtr->linkCounter); i++)
     {
-        for (j = 0; j < MAX_POSSIBLE_MODES; j++)
+        if (instanceConfigPtr->linkInfo[i]->modes & LINK_MODE_AT)
         {
-            if (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "AT"))
+            // If link is not opened in AT mode then open the link in AT mode.
+            if (-1 == instanceConfigPtr->linkInfo[i]->fd)
             {
-                // If link is not opened in AT mode then open the link in AT mode.
-                if (-1 == instanceConfigPtr->linkInfo[i]->fd)
+                if (OPENING_TYPE_SERIAL_LINK == instanceConfigPtr->linkInfo[i]->openingType)
                 {
-                    if (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "serialLink"))
-                    {
-                        instanceConfigPtr->linkInfo[i]->fd =
-                                           OpenSerialDevice(instanceConfigPtr->linkInfo[i]->path);
-                    }
-                    else if (0 == strcmp(instanceConfigPtr->linkInfo[i]->openingType, "unixSocket"))
+                    instanceConfigPtr->linkInfo[i]->fd =
+                                       OpenSerialDevice(instanceConfigPtr->linkInfo[i]->path);
+                }
+                else if (OPENING_TYPE_UNIX_SOCKET == instanceConfigPtr->linkInfo[i]->openingType)
+                {
+                    instanceConfigPtr->linkInfo[i]->atModeSockFd =
+                                       OpenSocket(&(instanceConfigPtr->linkInfo[i]));
+                    if (0 > instanceConfigPtr->linkInfo[i]->atModeSockFd)
                     {
-                        instanceConfigPtr->linkInfo[i]->atModeSockFd =
-                                           OpenSocket(&(instanceConfigPtr->linkInfo[i]));
-                        if (0 > instanceConfigPtr->linkInfo[i]->atModeSockFd)
-                        {
-                            LE_ERROR("Error in opening the device %s %m",
-                                     instanceConfigPtr->instanceName);
-                            return LE_FAULT;
-                        }
+                        LE_ERROR("Error in opening the device %s %m",
+                                 instanceConfigPtr->instanceName);
+                        return LE_FAULT;
                     }
                 }
-
-                // One instance supports only AT link.
-                atLinkDetect = true;
-                break;
             }
-        }
 
-        if (true == atLinkDetect)
-        {
+            // One instance supports only AT link.
             break;
         }
     }
@@ -1637,7 +1633,7 @@ le_result_t le_port_Release
 )
 {
     le_result_t result;
-    int i, j, linkIndex = -1;
+    int i, linkIndex = -1;
 
     if (false == JsonParseComplete)
     {
@@ -1662,14 +1658,10 @@ le_result_t le_port_Release
 
     for (i = 0; i < (instanceConfigPtr->linkCounter); i++)
     {
-        for (j = 0; j < MAX_POSSIBLE_MODES; j++)
+        // Check if the link supports AT as possiblemode.
+        if (instanceConfigPtr->linkInfo[i]->modes & LINK_MODE_AT)
         {
-            // Check if the link supports AT as possiblemode.
-            if (0 == strcmp(instanceConfigPtr->linkInfo[i]->possibleMode[j], "AT"))
-            {
-                linkIndex = i;
-                break;
-            }
+            linkIndex = i;
         }
     }
 
@@ -1856,6 +1848,10 @@ COMPONENT_INIT
     // Link list for JSON object.
     InstanceContextList = LE_DLS_LIST_INIT;
 
+    // Instances by name.
+    InstanceMap = le_hashmap_Create("InstanceMap", INSTANCE_MAP_SIZE, le_hashmap_HashString,
+                                    le_hashmap_EqualsString);
+
     // Open the JSON file.
     JsonFd = open(JSON_CONFIG_FILE, O_RDONLY);
 
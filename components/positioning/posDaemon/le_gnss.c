@@ -9,6 +9,9 @@
 //--------------------------------------------------------------------------------------------------
 
 
+#include <sys/mman.h>
+#include <sys/uio.h>
+
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_gnss.h"
@@ -33,6 +36,48 @@
 #define LE_GNSS_NMEA_NODE_PATH                  "/dev/nmea"
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the NMEA ring buffer, shared by all the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_RING_SIZE                          16384
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay to batch the NMEA sentences of an epoch before writing them to the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_FLUSH_DELAY_MS                     50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_READER_MAX                         4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data published in the shared position sample
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define GNSS_SHARED_SAMPLE_DATA     (LE_GNSS_SAMPLE_LOCATION                | \
+                                     LE_GNSS_SAMPLE_ALTITUDE                | \
+                                     LE_GNSS_SAMPLE_ALTITUDE_ON_WGS84       | \
+                                     LE_GNSS_SAMPLE_DATE                    | \
+                                     LE_GNSS_SAMPLE_TIME                    | \
+                                     LE_GNSS_SAMPLE_EPOCH_TIME              | \
+                                     LE_GNSS_SAMPLE_GPS_TIME                | \
+                                     LE_GNSS_SAMPLE_TIME_ACCURACY           | \
+                                     LE_GNSS_SAMPLE_HORIZONTAL_SPEED        | \
+                                     LE_GNSS_SAMPLE_VERTICAL_SPEED          | \
+                                     LE_GNSS_SAMPLE_DIRECTION               | \
+                                     LE_GNSS_SAMPLE_DOP                     | \
+                                     LE_GNSS_SAMPLE_MAGNETIC_DEVIATION      | \
+                                     LE_GNSS_SAMPLE_SATELLITES_STATUS)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SV ID definitions corresponding to SBAS constellation categories
@@ -232,6 +277,23 @@ typedef struct
 }
 le_gnss_Client_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA reader structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int                 fd;             ///< File descriptor the NMEA sentences are written to.
+    uint64_t            offset;         ///< Ring offset of the next byte to write.
+    bool                isBlocked;      ///< true if waiting for the file descriptor to be writable.
+    le_fdMonitor_Ref_t  monitorRef;     ///< File descriptor monitor.
+    le_msg_SessionRef_t sessionRef;     ///< Client session, NULL for the NMEA pipe.
+    le_dls_Link_t       link;           ///< Object node link.
+}
+le_gnss_NmeaReader_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static declarations.
 //--------------------------------------------------------------------------------------------------
@@ -342,10 +404,73 @@ static le_ref_MapRef_t ClientRequestRefMap;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * NMEA pipe file descriptor
+ * NMEA pipe reader, NULL if the NMEA pipe is not opened
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_NmeaReader_t* NmeaPipeReaderPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA ring buffer, holding the last NMEA sentences for all the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+static char NmeaRing[NMEA_RING_SIZE];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Total number of bytes written to the NMEA ring buffer
  */
 //--------------------------------------------------------------------------------------------------
-static int NmeaPipeFd = -1;
+static uint64_t NmeaRingHead = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring offset of the first NMEA sentence not yet written to the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NmeaBatchOffset = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t NmeaReaderList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t NmeaReaderPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer to write the NMEA sentences batched in the ring buffer to the NMEA readers
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t NmeaFlushTimerRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shared position sample, mapped from the LE_GNSS_SHARED_SAMPLE_PATH file
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_SharedSample_t* SharedSamplePtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID for the position update notifications
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t PositionUpdateEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of position update handlers
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NumOfPositionUpdateHandlers = 0;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -449,126 +574,249 @@ static void CreateNmeaPipe
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Open the NMEA pipe
+ * Remove a NMEA reader and close its file descriptor
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t OpenNmeaPipe
+static void RemoveNmeaReader
 (
-    void
+    le_gnss_NmeaReader_t* readerPtr     ///< [IN] NMEA reader.
 )
 {
+    LE_DEBUG("Remove NMEA reader %p (fd %d)", readerPtr, readerPtr->fd);
+
+    le_fdMonitor_Delete(readerPtr->monitorRef);
+    le_dls_Remove(&NmeaReaderList, &readerPtr->link);
 
-    // Check NMEA pipe file descriptor
-    if(NmeaPipeFd != -1)
+    if (-1 == close(readerPtr->fd))
     {
-        return LE_DUPLICATE;
+        LE_ERROR("Could not close NMEA reader fd %d. errno.%d (%s)",
+                 readerPtr->fd, errno, strerror(errno));
     }
 
-    // Open NMEA pipe
-    do
+    if (readerPtr == NmeaPipeReaderPtr)
     {
-        if (((NmeaPipeFd=open(LE_GNSS_NMEA_NODE_PATH,
-                                O_WRONLY|O_APPEND|O_CLOEXEC|O_NONBLOCK)) == -1)
-            && (errno != EINTR))
+        NmeaPipeReaderPtr = NULL;
+    }
+
+    le_mem_Release(readerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the pending NMEA sentences of the ring buffer to a NMEA reader.
+ *
+ * A reader which doesn't keep up is monitored until it can be written again. If it is more than
+ * the ring buffer size late, the oldest sentences are lost for it.
+ *
+ * @return
+ *  - LE_OK     The sentences are written, or will be written once the reader is writable.
+ *  - LE_FAULT  The reader can't be written anymore.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteNmeaReader
+(
+    le_gnss_NmeaReader_t* readerPtr     ///< [IN] NMEA reader.
+)
+{
+    struct iovec iov[2];
+    uint64_t pending = NmeaRingHead - readerPtr->offset;
+
+    if (pending > NMEA_RING_SIZE)
+    {
+        LE_WARN_RATELIMITED("NMEA reader fd %d overrun, %"PRIu64" bytes lost",
+                            readerPtr->fd, pending - NMEA_RING_SIZE);
+
+        // Skip the oldest sentences and restart on a sentence boundary
+        readerPtr->offset = NmeaRingHead - NMEA_RING_SIZE;
+        while (readerPtr->offset < NmeaRingHead)
         {
-            LE_WARN_IF(errno != 6, "Open %s failure: errno.%d (%s)",
-                       LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
+            if ('\0' == NmeaRing[readerPtr->offset++ % NMEA_RING_SIZE])
+            {
+                break;
+            }
+        }
+        pending = NmeaRingHead - readerPtr->offset;
+    }
+
+    while (pending)
+    {
+        size_t start = readerPtr->offset % NMEA_RING_SIZE;
+        size_t length = ((pending < (NMEA_RING_SIZE - start)) ? pending : (NMEA_RING_SIZE - start));
+        ssize_t written;
+
+        iov[0].iov_base = &NmeaRing[start];
+        iov[0].iov_len = length;
+        iov[1].iov_base = NmeaRing;
+        iov[1].iov_len = pending - length;
+
+        written = writev(readerPtr->fd, iov, (iov[1].iov_len ? 2 : 1));
+        if (written < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                // Resume once the reader has read some sentences
+                if (!readerPtr->isBlocked)
+                {
+                    le_fdMonitor_Enable(readerPtr->monitorRef, POLLOUT);
+                    readerPtr->isBlocked = true;
+                }
+                return LE_OK;
+            }
+
+            LE_ERROR_RATELIMITED("Could not write to NMEA reader fd %d, errno.%d (%s)",
+                                 readerPtr->fd, errno, strerror(errno));
             return LE_FAULT;
         }
-    }while (NmeaPipeFd==-1);
+
+        readerPtr->offset += written;
+        pending -= written;
+    }
+
+    if (readerPtr->isBlocked)
+    {
+        le_fdMonitor_Disable(readerPtr->monitorRef, POLLOUT);
+        readerPtr->isBlocked = false;
+    }
 
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Close the NMEA pipe
+ * NMEA reader file descriptor monitor handler
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CloseNmeaPipe
+static void NmeaReaderMonitorHandler
 (
-    void
+    int   fd,       ///< [IN] File descriptor.
+    short events    ///< [IN] Bit map of events that occurred.
 )
 {
-    le_result_t retResult = LE_OK;
-    int result;
+    le_gnss_NmeaReader_t* readerPtr = le_fdMonitor_GetContextPtr();
 
-    // Check NMEA pipe file descriptor
-    if(NmeaPipeFd == -1)
+    if (events & (POLLERR | POLLHUP | POLLRDHUP))
     {
-        LE_WARN("Invalid file descriptor. File already closed");
-        return LE_DUPLICATE;
+        // The reader has closed its end
+        RemoveNmeaReader(readerPtr);
     }
-
-    // Close NMEA pipe
-    do
+    else if ((events & POLLOUT) && (LE_OK != WriteNmeaReader(readerPtr)))
     {
-        result = close(NmeaPipeFd);
+        RemoveNmeaReader(readerPtr);
     }
-    while ((result != 0) && (errno == EINTR));
+}
 
-    LE_ERROR_IF(result != 0, "Could not close %s. errno.%d (%s)",
-               LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a NMEA reader. The NMEA sentences received from now on are written to its file descriptor.
+ *
+ * @return The NMEA reader.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_NmeaReader_t* AddNmeaReader
+(
+    int                 fd,             ///< [IN] Non-blocking file descriptor to write to.
+    le_msg_SessionRef_t sessionRef      ///< [IN] Client session, NULL for the NMEA pipe.
+)
+{
+    char monitorName[32];
+    le_gnss_NmeaReader_t* readerPtr = le_mem_ForceAlloc(NmeaReaderPoolRef);
+
+    readerPtr->fd = fd;
+    readerPtr->offset = NmeaBatchOffset;
+    readerPtr->isBlocked = false;
+    readerPtr->sessionRef = sessionRef;
+    readerPtr->link = LE_DLS_LINK_INIT;
+
+    // Only the errors are monitored, until a write would block
+    snprintf(monitorName, sizeof(monitorName), "NmeaReader-%d", fd);
+    readerPtr->monitorRef = le_fdMonitor_Create(monitorName, fd, NmeaReaderMonitorHandler, 0);
+    le_fdMonitor_SetContextPtr(readerPtr->monitorRef, readerPtr);
+
+    le_dls_Queue(&NmeaReaderList, &readerPtr->link);
+
+    LE_DEBUG("Add NMEA reader %p (fd %d)", readerPtr, fd);
 
-    if(result != 0)
+    return readerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the NMEA pipe
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenNmeaPipe
+(
+    void
+)
+{
+    int fd;
+
+    // Check NMEA pipe reader
+    if (NULL != NmeaPipeReaderPtr)
     {
-        retResult = LE_FAULT;
+        return LE_DUPLICATE;
     }
-    else
+
+    // Open NMEA pipe, it fails with ENXIO as long as no process has opened it for reading
+    do
     {
-        // Release the NMEA pipe file descriptor
-        NmeaPipeFd = -1;
-    }
+        if (((fd = open(LE_GNSS_NMEA_NODE_PATH,
+                        O_WRONLY|O_APPEND|O_CLOEXEC|O_NONBLOCK)) == -1)
+            && (errno != EINTR))
+        {
+            LE_WARN_IF(errno != ENXIO, "Open %s failure: errno.%d (%s)",
+                       LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
+            return LE_FAULT;
+        }
+    }while (fd == -1);
+
+    NmeaPipeReaderPtr = AddNmeaReader(fd, NULL);
 
-    return retResult;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write the NMEA sentence to NMEA pipe
+ * Write the NMEA sentences batched in the ring buffer to all the NMEA readers
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteNmeaPipe
+static void NmeaFlushTimerHandler
 (
-    const char*  nmeaStringPtr          ///< [IN] Pointer to the NMEA sentence to write.
+    le_timer_Ref_t timerRef     ///< [IN] NMEA flush timer.
 )
 {
-    le_result_t resultNmeaPipe = LE_OK;
-    ssize_t resultWrite = 0;
-    ssize_t written = 0;
-    ssize_t stringSize = 0;
+    le_dls_Link_t* linkPtr;
+
+    // Try once per batch to open the NMEA pipe, its new reader gets the current batch
+    OpenNmeaPipe();
 
-    // Open the NMEA FIFO pipe
-    resultNmeaPipe = OpenNmeaPipe();
+    NmeaBatchOffset = NmeaRingHead;
 
-    if((resultNmeaPipe == LE_OK)||(resultNmeaPipe == LE_DUPLICATE))
+    linkPtr = le_dls_Peek(&NmeaReaderList);
+    while (NULL != linkPtr)
     {
-        written = 0;
-        stringSize = strlen(nmeaStringPtr)+1;
-        // Write to NMEA pipe
-        while (written < stringSize)
-        {
-            resultWrite = write(NmeaPipeFd, nmeaStringPtr + written, stringSize - written);
+        le_gnss_NmeaReader_t* readerPtr = CONTAINER_OF(linkPtr, le_gnss_NmeaReader_t, link);
 
-            if ((resultWrite < 0) && (errno != EINTR))
-            {
-                LE_ERROR("Could not write to %s (write error, errno.%d (%s))",
-                         LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
-                CloseNmeaPipe();
-                return LE_FAULT;
-            }
+        // Move to the next node before the reader is possibly removed
+        linkPtr = le_dls_PeekNext(&NmeaReaderList, linkPtr);
 
-            written += resultWrite;
+        if ((!readerPtr->isBlocked) && (LE_OK != WriteNmeaReader(readerPtr)))
+        {
+            RemoveNmeaReader(readerPtr);
         }
     }
-
-    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * The PA NMEA Handler.
  *
+ * The NMEA sentence, with its terminating null character, is only copied in the ring buffer: the
+ * sentences of an epoch are written in a batch to the NMEA readers by the flush timer.
  */
 //--------------------------------------------------------------------------------------------------
 static void PaNmeaHandler
@@ -576,10 +824,35 @@ static void PaNmeaHandler
     char* nmeaPtr
 )
 {
+    size_t length = strlen(nmeaPtr) + 1;
+    size_t start = NmeaRingHead % NMEA_RING_SIZE;
+
     LE_DEBUG("Handler Function called with PA NMEA %p", nmeaPtr);
 
-    // Write the NMEA sentence to the /dev/nmea device folder
-    WriteNmeaPipe(nmeaPtr);
+    if (length > NMEA_RING_SIZE)
+    {
+        LE_ERROR("NMEA sentence too long (%zu bytes)", length);
+        le_mem_Release(nmeaPtr);
+        return;
+    }
+
+    // Start a new batch
+    if (!le_timer_IsRunning(NmeaFlushTimerRef))
+    {
+        NmeaBatchOffset = NmeaRingHead;
+        le_timer_Start(NmeaFlushTimerRef);
+    }
+
+    if (length > (NMEA_RING_SIZE - start))
+    {
+        memcpy(&NmeaRing[start], nmeaPtr, NMEA_RING_SIZE - start);
+        memcpy(NmeaRing, nmeaPtr + (NMEA_RING_SIZE - start), length - (NMEA_RING_SIZE - start));
+    }
+    else
+    {
+        memcpy(&NmeaRing[start], nmeaPtr, length);
+    }
+    NmeaRingHead += length;
 
     le_mem_Release(nmeaPtr);
 }
@@ -943,6 +1216,119 @@ static le_result_t ConvertPositionData
 // APIs.
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map the shared position sample file.
+ *
+ * The content of an existing file is kept, so that the sequence counter keeps on increasing if
+ * the positioning service is restarted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenSharedSample
+(
+    void
+)
+{
+    void* addrPtr;
+    int fd = open(LE_GNSS_SHARED_SAMPLE_PATH, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+    if (-1 == fd)
+    {
+        LE_ERROR("Could not open %s. errno.%d (%s)",
+                 LE_GNSS_SHARED_SAMPLE_PATH, errno, strerror(errno));
+        return;
+    }
+
+    // The sample is readable by all the applications
+    if ((-1 == fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) ||
+        (-1 == ftruncate(fd, sizeof(le_gnss_SharedSample_t))))
+    {
+        LE_ERROR("Could not set %s. errno.%d (%s)",
+                 LE_GNSS_SHARED_SAMPLE_PATH, errno, strerror(errno));
+        close(fd);
+        return;
+    }
+
+    addrPtr = mmap(NULL, sizeof(le_gnss_SharedSample_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == addrPtr)
+    {
+        LE_ERROR("Could not map %s. errno.%d (%s)",
+                 LE_GNSS_SHARED_SAMPLE_PATH, errno, strerror(errno));
+        return;
+    }
+
+    SharedSamplePtr = (le_gnss_SharedSample_t*)addrPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Publish the last position sample in the shared position sample and notify the position update
+ * handlers.
+ *
+ * The sequence counter is odd while the sample is written, so that the readers can detect an
+ * update in progress and retry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PublishSharedSample
+(
+    void
+)
+{
+    le_gnss_PositionSampleRequest_t positionSampleRequest;
+    le_gnss_SampleRef_t positionSampleRef;
+    uint32_t sequence;
+
+    if (NULL == SharedSamplePtr)
+    {
+        return;
+    }
+
+    // The sample is converted by le_gnss_GetSample() through a temporary reference, outside of any
+    // client session: the default resolutions are applied.
+    memset(&positionSampleRequest, 0, sizeof(positionSampleRequest));
+    positionSampleRequest.positionSampleNodePtr = &LastPositionSample;
+    positionSampleRef = le_ref_CreateRef(PositionSampleMap, &positionSampleRequest);
+
+    sequence = __atomic_load_n(&SharedSamplePtr->sequence, __ATOMIC_RELAXED) | 1;
+    __atomic_store_n(&SharedSamplePtr->sequence, sequence, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    le_gnss_GetSample(positionSampleRef,
+                      GNSS_SHARED_SAMPLE_DATA,
+                      &SharedSamplePtr->sample,
+                      &SharedSamplePtr->validMask);
+
+    sequence++;
+    __atomic_store_n(&SharedSamplePtr->sequence, sequence, __ATOMIC_RELEASE);
+
+    le_ref_DeleteRef(PositionSampleMap, positionSampleRef);
+
+    if (NumOfPositionUpdateHandlers)
+    {
+        le_event_Report(PositionUpdateEventId, &sequence, sizeof(sequence));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer position update handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerPositionUpdateHandler
+(
+    void* reportPtr,
+    void* secondLayerHandlerFunc
+)
+{
+    uint32_t* sequencePtr = (uint32_t*)reportPtr;
+    le_gnss_PositionUpdateHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+
+    clientHandlerFunc(*sequencePtr, le_event_GetContextPtr());
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The PA position Handler.
@@ -971,6 +1357,9 @@ static void PaPositionHandler
     // Get the position sample data from the PA position data report
     GetPosSampleData(&LastPositionSample, positionPtr);
 
+    // Publish it for the applications reading the shared position sample
+    PublishSharedSample();
+
     if(!NumOfPositionHandlers)
     {
         LE_DEBUG("No positioning handlers, exit Handler Function");
@@ -1127,6 +1516,20 @@ static void CloseSessionEventHandler
         // Get the next value in the reference map
         result = le_ref_NextNode(iterRef);
     }
+
+    // Remove the NMEA readers opened by the client session
+    le_dls_Link_t* linkPtr = le_dls_Peek(&NmeaReaderList);
+    while (NULL != linkPtr)
+    {
+        le_gnss_NmeaReader_t* readerPtr = CONTAINER_OF(linkPtr, le_gnss_NmeaReader_t, link);
+
+        linkPtr = le_dls_PeekNext(&NmeaReaderList, linkPtr);
+
+        if (sessionRef == readerPtr->sessionRef)
+        {
+            RemoveNmeaReader(readerPtr);
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1217,6 +1620,15 @@ le_result_t gnss_Init
     // Register a signal event handler for SIGPIPE signal.
     le_sig_SetEventHandler(SIGPIPE, SigPipeHandler);
 
+    // Create a pool for NMEA reader objects
+    NmeaReaderPoolRef = le_mem_CreatePool("NmeaReaderPoolRef", sizeof(le_gnss_NmeaReader_t));
+    le_mem_ExpandPool(NmeaReaderPoolRef, NMEA_READER_MAX);
+
+    // Create the timer writing the NMEA sentences of an epoch to the NMEA readers
+    NmeaFlushTimerRef = le_timer_Create("NmeaFlushTimer");
+    le_timer_SetMsInterval(NmeaFlushTimerRef, NMEA_FLUSH_DELAY_MS);
+    le_timer_SetHandler(NmeaFlushTimerRef, NmeaFlushTimerHandler);
+
     // Create a pool for Position  Handler objects
     PositionHandlerPoolRef = le_mem_CreatePool("PositionHandlerPoolRef",
                                                sizeof(le_gnss_PositionHandler_t));
@@ -1255,6 +1667,14 @@ le_result_t gnss_Init
     memset(&LastPositionSample, 0, sizeof(LastPositionSample));
     LastPositionSample.fixState = LE_GNSS_STATE_FIX_NO_POS;
 
+    // Create the event for the position update notifications
+    PositionUpdateEventId = le_event_CreateId("PositionUpdateEventId", sizeof(uint32_t));
+    NumOfPositionUpdateHandlers = 0;
+
+    // Publish the last Position sample in the shared position sample
+    OpenSharedSample();
+    PublishSharedSample();
+
     // Subscribe to PA position Data handler
     if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
     {
@@ -1389,7 +1809,76 @@ void le_gnss_RemovePositionHandler
         } while (linkPtr != NULL);
     }
 
-    if(NumOfPositionHandlers == 0)
+    if ((0 == NumOfPositionHandlers) && (0 == NumOfPositionUpdateHandlers))
+    {
+        pa_gnss_RemovePositionDataHandler(PaHandlerRef);
+        PaHandlerRef = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for position update notifications.
+ *
+ *  - A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_gnss_PositionUpdateHandlerRef_t le_gnss_AddPositionUpdateHandler
+(
+    le_gnss_PositionUpdateHandlerFunc_t handlerPtr,     ///< [IN] The handler function.
+    void*                               contextPtr      ///< [IN] The context pointer
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("Handler function is NULL !");
+        return NULL;
+    }
+
+    // Subscribe to PA position Data handler
+    if (NULL == PaHandlerRef)
+    {
+        if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
+        {
+            LE_ERROR("Failed to add PA position Data handler!");
+        }
+        else
+        {
+            LE_DEBUG("PaHandlerRef %p subscribed", PaHandlerRef);
+        }
+    }
+
+    handlerRef = le_event_AddLayeredHandler("PositionUpdateHandler",
+                                            PositionUpdateEventId,
+                                            FirstLayerPositionUpdateHandler,
+                                            (le_event_HandlerFunc_t)handlerPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+    NumOfPositionUpdateHandlers++;
+
+    return (le_gnss_PositionUpdateHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for position update notifications.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnss_RemovePositionUpdateHandler
+(
+    le_gnss_PositionUpdateHandlerRef_t handlerRef ///< [IN] The handler reference.
+)
+{
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    NumOfPositionUpdateHandlers--;
+
+    if ((0 == NumOfPositionHandlers) && (0 == NumOfPositionUpdateHandlers))
     {
         pa_gnss_RemovePositionDataHandler(PaHandlerRef);
         PaHandlerRef = NULL;
@@ -2982,6 +3471,193 @@ le_result_t le_gnss_GetMagneticDeviation
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position sample's fix state and the selected data in a single call.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OUT_OF_RANGE  At least one of the selected data is invalid.
+ *  - LE_OK            Function succeeded, all the selected data are valid.
+ *
+ * @note The data which are not selected are set to 0. A selected data is reported valid when the
+ *       dedicated function would return LE_OK; otherwise its invalid parameters are set to the
+ *       values documented for that function (e.g. INT32_MAX for the latitude).
+ *
+ * @note If the caller is passing an invalid Position sample reference into this function,
+ *       it is a fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSample
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_SampleDataBitMask_t dataMask,
+        ///< [IN] Data to retrieve.
+
+    le_gnss_SampleData_t* samplePtr,
+        ///< [OUT] Position sample data.
+
+    le_gnss_SampleDataBitMask_t* validMaskPtr
+        ///< [OUT] Valid data among the retrieved ones.
+)
+{
+    le_result_t result;
+    le_gnss_PositionSampleRequest_t* positionSampleRequestNodePtr
+                                            = le_ref_Lookup(PositionSampleMap,positionSampleRef);
+
+    // Check position sample's reference
+    result = ValidatePositionSamplePtr(positionSampleRequestNodePtr);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if ((NULL == samplePtr) || (NULL == validMaskPtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer provided!");
+        return LE_FAULT;
+    }
+
+    memset(samplePtr, 0, sizeof(le_gnss_SampleData_t));
+    *validMaskPtr = 0;
+
+    samplePtr->fixState = positionSampleRequestNodePtr->positionSampleNodePtr->fixState;
+
+    // Each data is retrieved by its dedicated function, which applies the resolutions set by the
+    // client and the invalid values
+    if ((dataMask & LE_GNSS_SAMPLE_LOCATION) &&
+        (LE_OK == le_gnss_GetLocation(positionSampleRef,
+                                      &samplePtr->latitude,
+                                      &samplePtr->longitude,
+                                      &samplePtr->hAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_LOCATION;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_ALTITUDE) &&
+        (LE_OK == le_gnss_GetAltitude(positionSampleRef,
+                                      &samplePtr->altitude,
+                                      &samplePtr->vAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_ALTITUDE;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_ALTITUDE_ON_WGS84) &&
+        (LE_OK == le_gnss_GetAltitudeOnWgs84(positionSampleRef, &samplePtr->altitudeOnWgs84)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_ALTITUDE_ON_WGS84;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_DATE) &&
+        (LE_OK == le_gnss_GetDate(positionSampleRef,
+                                  &samplePtr->year,
+                                  &samplePtr->month,
+                                  &samplePtr->day)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_DATE;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_TIME) &&
+        (LE_OK == le_gnss_GetTime(positionSampleRef,
+                                  &samplePtr->hours,
+                                  &samplePtr->minutes,
+                                  &samplePtr->seconds,
+                                  &samplePtr->milliseconds)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_TIME;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_EPOCH_TIME) &&
+        (LE_OK == le_gnss_GetEpochTime(positionSampleRef, &samplePtr->epochTime)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_EPOCH_TIME;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_GPS_TIME) &&
+        (LE_OK == le_gnss_GetGpsTime(positionSampleRef,
+                                     &samplePtr->gpsWeek,
+                                     &samplePtr->gpsTimeOfWeek)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_GPS_TIME;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_TIME_ACCURACY) &&
+        (LE_OK == le_gnss_GetTimeAccuracy(positionSampleRef, &samplePtr->timeAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_TIME_ACCURACY;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_HORIZONTAL_SPEED) &&
+        (LE_OK == le_gnss_GetHorizontalSpeed(positionSampleRef,
+                                             &samplePtr->hSpeed,
+                                             &samplePtr->hSpeedAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_HORIZONTAL_SPEED;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_VERTICAL_SPEED) &&
+        (LE_OK == le_gnss_GetVerticalSpeed(positionSampleRef,
+                                           &samplePtr->vSpeed,
+                                           &samplePtr->vSpeedAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_VERTICAL_SPEED;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_DIRECTION) &&
+        (LE_OK == le_gnss_GetDirection(positionSampleRef,
+                                       &samplePtr->direction,
+                                       &samplePtr->directionAccuracy)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_DIRECTION;
+    }
+
+    if (dataMask & LE_GNSS_SAMPLE_DOP)
+    {
+        uint16_t* dopPtr[LE_GNSS_DOP_LAST] = { &samplePtr->pdop,
+                                              &samplePtr->hdop,
+                                              &samplePtr->vdop,
+                                              &samplePtr->gdop,
+                                              &samplePtr->tdop };
+        le_gnss_DopType_t dopType;
+        bool isDopValid = true;
+
+        for (dopType = LE_GNSS_PDOP; dopType < LE_GNSS_DOP_LAST; dopType++)
+        {
+            if (LE_OK != le_gnss_GetDilutionOfPrecision(positionSampleRef,
+                                                        dopType,
+                                                        dopPtr[dopType]))
+            {
+                isDopValid = false;
+            }
+        }
+
+        if (isDopValid)
+        {
+            *validMaskPtr |= LE_GNSS_SAMPLE_DOP;
+        }
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_MAGNETIC_DEVIATION) &&
+        (LE_OK == le_gnss_GetMagneticDeviation(positionSampleRef,
+                                               &samplePtr->magneticDeviation)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_MAGNETIC_DEVIATION;
+    }
+
+    if ((dataMask & LE_GNSS_SAMPLE_SATELLITES_STATUS) &&
+        (LE_OK == le_gnss_GetSatellitesStatus(positionSampleRef,
+                                              &samplePtr->satsInViewCount,
+                                              &samplePtr->satsTrackingCount,
+                                              &samplePtr->satsUsedCount)))
+    {
+        *validMaskPtr |= LE_GNSS_SAMPLE_SATELLITES_STATUS;
+    }
+
+    return ((*validMaskPtr == dataMask) ? LE_OK : LE_OUT_OF_RANGE);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -4317,6 +4993,63 @@ le_result_t le_gnss_GetNmeaSentences
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a NMEA stream. The NMEA sentences computed from now on are written to the returned file
+ * descriptor, as to the "/dev/nmea" named pipe.
+ *
+ * @return
+ *  - LE_OK          The NMEA stream is opened.
+ *  - LE_UNSUPPORTED The NMEA sentences are not managed by the positioning service.
+ *  - LE_FAULT       The NMEA stream could not be created.
+ *
+ * @note If the caller is passing a null pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_OpenNmeaStream
+(
+    int* fdPtr
+        ///< [OUT] File descriptor of the NMEA stream.
+)
+{
+    int pipeFds[2];
+
+    if (NULL == fdPtr)
+    {
+        LE_KILL_CLIENT("fdPtr is NULL!");
+        return LE_FAULT;
+    }
+
+    *fdPtr = -1;
+
+    if (NULL == PaNmeaHandlerRef)
+    {
+        LE_ERROR("NMEA sentences are not managed by the positioning service");
+        return LE_UNSUPPORTED;
+    }
+
+    if (-1 == pipe2(pipeFds, O_CLOEXEC | O_NONBLOCK))
+    {
+        LE_ERROR("Could not create NMEA stream. errno.%d (%s)", errno, strerror(errno));
+        return LE_FAULT;
+    }
+
+    // Only the end written by the positioning service is non-blocking
+    if (-1 == fcntl(pipeFds[0], F_SETFL, fcntl(pipeFds[0], F_GETFL) & ~O_NONBLOCK))
+    {
+        LE_ERROR("Could not set NMEA stream. errno.%d (%s)", errno, strerror(errno));
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return LE_FAULT;
+    }
+
+    AddNmeaReader(pipeFds[1], le_gnss_GetClientSessionRef());
+
+    *fdPtr = pipeFds[0];
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function returns the state of the GNSS device.
@@ -24,6 +24,7 @@
 #define SUPPOSED_AVERAGE_SPEED       50     // 50 km/h
 #define DEFAULT_ACQUISITION_RATE     1000   // one second
 #define DEFAULT_POWER_STATE          true
+#define DEFAULT_HISTORY_SIZE         300    // five minutes at the default acquisition rate
 
 
 // To compute the estimated horizontal error, we assume that the GNSS's User Equivalent Range Error
@@ -56,6 +57,19 @@
 #define SEC_TO_MSEC            1000
 #define HOURS_TO_SEC           3600
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Distance computation constants.
+ *
+ * Below SMALL_DISTANCE_DELTA (in degrees with 6 decimal places, about 11 km) the equirectangular
+ * approximation is used instead of the Haversine formula, its error is then below 0.2%.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PI                      3.14159265
+#define EARTH_RADIUS            6371      // km
+#define DEG_TO_RAD(_deg_)       ((double)(_deg_) / 1000000.0 * PI / 180)
+#define SMALL_DISTANCE_DELTA    100000
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Count of the number of activation requests that have not been released yet.
@@ -205,6 +219,12 @@ typedef struct
         int32_t  hAccuracy;         ///< Horizontal accuracy.
         bool     locationValid;     ///< If true, location is set.
         bool     altitudeValid;     ///< If true, altitude is set.
+        double   cosLatitude;       ///< Cosine of the latitude, shared by all the handlers.
+        bool     moveValid;         ///< If true, lastLat/lastLong/horizontalMove are set.
+        int32_t  lastLat;           ///< Latitude of the last computed horizontal move.
+        int32_t  lastLong;          ///< Longitude of the last computed horizontal move.
+        uint32_t horizontalMove;    ///< Last computed horizontal move in meters, reused by the
+                                    ///  handlers notified from the same position.
 }
 PositionParam_t;
 
@@ -321,6 +341,34 @@ static bool IsGNSSAvailable
 //--------------------------------------------------------------------------------------------------
 static le_pos_Resolution_t DistanceResolution = LE_POS_RES_METER;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position history ring, holding the last HistorySize fixes as received from the GNSS.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_pos_HistorySample_t* HistoryPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of fixes held by the position history, 0 if disabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HistorySize = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the last fix recorded in the position history.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HistorySequence = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GNSS handler's reference for the position history.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionHandlerRef_t HistoryGnssHandlerRef = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pos Sample destructor.
@@ -441,37 +489,50 @@ static uint32_t CalculateAcquisitionRate
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Calculate the distance in meters between two fix points (use Haversine formula).
+ * Calculate the distance in meters between a fix point and the current position.
  *
+ * The Haversine formula is used, except for small distances where the equirectangular
+ * approximation gives the same result in meters without the trigonometric functions.
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t ComputeDistance
 (
-    uint32_t latitude1,
-    uint32_t longitude1,
-    uint32_t latitude2,
-    uint32_t longitude2
+    int32_t                latitude,    ///< [IN] Latitude of the fix point.
+    int32_t                longitude,   ///< [IN] Longitude of the fix point.
+    const PositionParam_t* posParamPtr  ///< [IN] The current position.
 )
 {
-    // Haversine formula:
-    // a = sin²(Δφ/2) + cos(φ1).cos(φ2).sin²(Δλ/2)
-    // c = 2.atan2(√a, √(1−a))
-    // distance = R.c.1000 (in meters)
-    // where φ is latitude, λ is longitude, R is earth’s radius (mean radius = 6,371km)
-    #define PI 3.14159265
-
-    double R = 6371; // km
-    double dLat = ((double)latitude2-(double)latitude1)/1000000.0*PI/180;
-    double dLon = ((double)longitude2-(double)longitude1)/1000000.0*PI/180;
-    double lat1 = ((double)latitude1)/1000000.0*PI/180;
-    double lat2 = ((double)latitude2)/1000000.0*PI/180;
-    double a, c;
-
-    a = sin(dLat/2) * sin(dLat/2) + sin(dLon/2) * sin(dLon/2) * cos(lat1) * cos(lat2);
-    c = 2 * atan2(sqrt(a), sqrt(1-a));
-
-    LE_DEBUG("Computed distance is %e meters (double)", (double)(R * c * 1000));
-    return (uint32_t)(R * c * 1000);
+    double dLat = DEG_TO_RAD((double)posParamPtr->latitude - (double)latitude);
+    double dLon = DEG_TO_RAD((double)posParamPtr->longitude - (double)longitude);
+    double distance;
+
+    if ((abs(posParamPtr->latitude - latitude) < SMALL_DISTANCE_DELTA) &&
+        (abs(posParamPtr->longitude - longitude) < SMALL_DISTANCE_DELTA))
+    {
+        // Equirectangular approximation:
+        // x = Δλ.cos(φ), y = Δφ
+        // distance = R.√(x² + y²).1000 (in meters)
+        double x = dLon * posParamPtr->cosLatitude;
+
+        distance = EARTH_RADIUS * sqrt(x * x + dLat * dLat) * 1000;
+    }
+    else
+    {
+        // Haversine formula:
+        // a = sin²(Δφ/2) + cos(φ1).cos(φ2).sin²(Δλ/2)
+        // c = 2.atan2(√a, √(1−a))
+        // distance = R.c.1000 (in meters)
+        // where φ is latitude, λ is longitude, R is earth’s radius (mean radius = 6,371km)
+        double a, c;
+
+        a = sin(dLat/2) * sin(dLat/2) +
+            sin(dLon/2) * sin(dLon/2) * cos(DEG_TO_RAD(latitude)) * posParamPtr->cosLatitude;
+        c = 2 * atan2(sqrt(a), sqrt(1-a));
+        distance = EARTH_RADIUS * c * 1000;
+    }
+
+    LE_DEBUG("Computed distance is %e meters (double)", distance);
+    return (uint32_t)distance;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -511,6 +572,7 @@ static bool IsBeyondMagnitude
 /**
  * Calculate the smallest acquisition rate to use for all the registered handlers.
  *
+ * The handlers list is sorted by acquisition rate, so only its first handler is checked.
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t ComputeCommonSmallestRate
@@ -518,36 +580,52 @@ static uint32_t ComputeCommonSmallestRate
     uint32_t rate
 )
 {
-    le_pos_SampleHandler_t *posSampleHandlerNodePtr;
-    le_dls_Link_t          *linkPtr;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PosSampleHandlerList);
 
-    linkPtr = le_dls_Peek(&PosSampleHandlerList);
-    if (linkPtr != NULL)
+    if (NULL != linkPtr)
     {
-        do
+        le_pos_SampleHandler_t* posSampleHandlerNodePtr = CONTAINER_OF(linkPtr,
+                                                                       le_pos_SampleHandler_t,
+                                                                       link);
+        if (posSampleHandlerNodePtr->acquisitionRate < rate)
         {
-            // Get the node from the list
-            posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
-                                                                            le_pos_SampleHandler_t,
-                                                                            link);
-            // Check the node.
-            if (posSampleHandlerNodePtr->acquisitionRate < rate)
-            {
-                // Remove the node.
-                rate = posSampleHandlerNodePtr->acquisitionRate;
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+            rate = posSampleHandlerNodePtr->acquisitionRate;
+        }
     }
 
     return rate;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a handler to the handlers list, keeping the list sorted by acquisition rate.
+ *
+ * As the acquisition rate grows with the magnitudes, the handlers with the smallest magnitudes
+ * come first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddSampleHandler
+(
+    le_pos_SampleHandler_t* posSampleHandlerNodePtr   ///< [IN] The handler to add.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PosSampleHandlerList);
+
+    while (NULL != linkPtr)
+    {
+        le_pos_SampleHandler_t* nodePtr = CONTAINER_OF(linkPtr, le_pos_SampleHandler_t, link);
+
+        if (nodePtr->acquisitionRate > posSampleHandlerNodePtr->acquisitionRate)
+        {
+            le_dls_AddBefore(&PosSampleHandlerList, linkPtr, &(posSampleHandlerNodePtr->link));
+            return;
+        }
+        linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
+    }
+
+    le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Convert the value in the selected resolution.
@@ -645,7 +723,7 @@ static int32_t ConvertDistance
 static le_result_t ComputeMove
 (
   le_pos_SampleHandler_t *posSampleHandlerNodePtr,  ///< [IN]  The handler reference.
-  const PositionParam_t  *posParamPtr,              ///< [IN]  The position structure for the move
+  PositionParam_t        *posParamPtr,              ///< [IN]  The position structure for the move
                                                     ///        calculation.
   bool                   *hflagPtr,                 ///< [OUT] True if the horizontal distance is
                                                     ///        beyond the magnitude.
@@ -692,10 +770,21 @@ static le_result_t ComputeMove
         posSampleHandlerNodePtr->lastAlt = posParamPtr->altitude;
     }
 
-    uint32_t horizontalMove = ComputeDistance(posSampleHandlerNodePtr->lastLat,
-                                              posSampleHandlerNodePtr->lastLong,
-                                              posParamPtr->latitude,
-                                              posParamPtr->longitude);
+    // The handlers notified together share the same last position, so the horizontal move is
+    // only computed again when the last position changes.
+    if ((!posParamPtr->moveValid) ||
+        (posParamPtr->lastLat != posSampleHandlerNodePtr->lastLat) ||
+        (posParamPtr->lastLong != posSampleHandlerNodePtr->lastLong))
+    {
+        posParamPtr->lastLat = posSampleHandlerNodePtr->lastLat;
+        posParamPtr->lastLong = posSampleHandlerNodePtr->lastLong;
+        posParamPtr->horizontalMove = ComputeDistance(posSampleHandlerNodePtr->lastLat,
+                                                      posSampleHandlerNodePtr->lastLong,
+                                                      posParamPtr);
+        posParamPtr->moveValid = true;
+    }
+
+    uint32_t horizontalMove = posParamPtr->horizontalMove;
 
     uint32_t verticalMove = abs(posParamPtr->altitude - posSampleHandlerNodePtr->lastAlt);
 
@@ -843,6 +932,8 @@ static void PosSampleHandlerfunc
     posParam.hAccuracy = hAccuracy;
     posParam.locationValid = locationValid;
     posParam.altitudeValid = altitudeValid;
+    posParam.cosLatitude = (locationValid ? cos(DEG_TO_RAD(latitude)) : 0);
+    posParam.moveValid = false;
 
     do
     {
@@ -1011,6 +1102,64 @@ static void PosSampleHandlerfunc
     le_gnss_ReleaseSampleRef(positionSampleRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * GNSS position handler recording the fixes in the position history.
+ *
+ * The values are recorded as received from the GNSS, they are converted when read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PosHistoryHandlerfunc
+(
+    le_gnss_SampleRef_t positionSampleRef,
+    void* contextPtr
+)
+{
+    le_gnss_SampleData_t sample;
+    le_gnss_SampleDataBitMask_t validMask;
+    le_pos_HistorySample_t* historySamplePtr;
+
+    if (NULL == positionSampleRef)
+    {
+        LE_ERROR("positionSampleRef is Null");
+        return;
+    }
+
+    // Get all the recorded data in a single call, the invalid ones are set to their maximum value
+    if ((LE_FAULT == le_gnss_GetSample(positionSampleRef,
+                                       LE_GNSS_SAMPLE_LOCATION | LE_GNSS_SAMPLE_ALTITUDE |
+                                       LE_GNSS_SAMPLE_EPOCH_TIME |
+                                       LE_GNSS_SAMPLE_HORIZONTAL_SPEED |
+                                       LE_GNSS_SAMPLE_VERTICAL_SPEED | LE_GNSS_SAMPLE_DIRECTION,
+                                       &sample,
+                                       &validMask)) ||
+        (INT32_MAX == sample.latitude) || (INT32_MAX == sample.longitude))
+    {
+        // Only the position fixes are recorded
+        le_gnss_ReleaseSampleRef(positionSampleRef);
+        return;
+    }
+
+    le_gnss_ReleaseSampleRef(positionSampleRef);
+
+    HistorySequence++;
+    historySamplePtr = &HistoryPtr[(HistorySequence - 1) % HistorySize];
+
+    historySamplePtr->sequence = HistorySequence;
+    historySamplePtr->fixState = (le_pos_FixState_t)sample.fixState;
+    historySamplePtr->latitude = sample.latitude;
+    historySamplePtr->longitude = sample.longitude;
+    historySamplePtr->hAccuracy = sample.hAccuracy;
+    historySamplePtr->altitude = sample.altitude;
+    historySamplePtr->vAccuracy = sample.vAccuracy;
+    historySamplePtr->hSpeed = sample.hSpeed;
+    historySamplePtr->vSpeed = sample.vSpeed;
+    historySamplePtr->direction = sample.direction;
+    historySamplePtr->epochTime = ((validMask & LE_GNSS_SAMPLE_EPOCH_TIME) ? sample.epochTime : 0);
+
+    LE_DEBUG("Fix %u recorded in position history", HistorySequence);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function when an Acquition Rate change in configDB
@@ -1049,6 +1198,17 @@ static void LoadPositioningFromConfigDb
     AcqRate = le_cfg_GetInt(posCfg, CFG_NODE_RATE, DEFAULT_ACQUISITION_RATE);
     LE_DEBUG("Set acquisition rate to value %d", AcqRate);
 
+    // Create the position history
+    int32_t historySize = le_cfg_GetInt(posCfg, CFG_NODE_HISTORY_SIZE, DEFAULT_HISTORY_SIZE);
+    if (historySize > 0)
+    {
+        le_mem_PoolRef_t historyPoolRef = le_mem_CreatePool("PosHistoryPoolRef",
+                                                    historySize * sizeof(le_pos_HistorySample_t));
+        HistoryPtr = le_mem_ForceAlloc(historyPoolRef);
+        HistorySize = historySize;
+    }
+    LE_DEBUG("Set position history size to value %u", HistorySize);
+
     // Add a configDb handler to check if the acquition rate change.
     le_cfg_AddChangeHandler(CFG_POSITIONING_RATE_PATH, AcquitisionRateUpdate,NULL);
 
@@ -1252,6 +1412,13 @@ le_posCtrl_ActivationRef_t le_posCtrl_Request
             le_mem_Release(clientRequestPtr);
             return NULL;
         }
+
+        // Record the position fixes in the history while the positioning is activated
+        if ((HistorySize) && (NULL == HistoryGnssHandlerRef))
+        {
+            HistoryGnssHandlerRef = le_gnss_AddPositionHandler(PosHistoryHandlerfunc, NULL);
+            LE_ERROR_IF(NULL == HistoryGnssHandlerRef, "Failed to add position history handler!");
+        }
     }
     CurrentActivationsCount++;
 
@@ -1292,6 +1459,12 @@ void le_posCtrl_Release
             if (CurrentActivationsCount == 0)
             {
                 le_gnss_Stop();
+
+                if (NULL != HistoryGnssHandlerRef)
+                {
+                    le_gnss_RemovePositionHandler(HistoryGnssHandlerRef);
+                    HistoryGnssHandlerRef = NULL;
+                }
             }
         }
         le_ref_DeleteRef(ActivationRequestRefMap, ref);
@@ -1375,7 +1548,7 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
         }
     }
 
-    le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
+    AddSampleHandler(posSampleHandlerNodePtr);
     NumOfHandlers++;
 
     return (le_pos_MovementHandlerRef_t)posSampleHandlerNodePtr;
@@ -2766,3 +2939,88 @@ le_result_t le_pos_SetDistanceResolution
     DistanceResolution = resolution;
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position fixes recorded in the history after a given one.
+ *
+ * @return LE_OK               Function succeeded, the returned fixes are the oldest recorded
+ *                             after the given sequence number. No fix is returned if there is none.
+ * @return LE_UNSUPPORTED      The position history is disabled.
+ *
+ * @note If the caller is passing a null pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pos_GetHistory
+(
+    uint32_t since,
+        ///< [IN] Sequence number of the last fix already received, 0 to get the oldest fixes.
+
+    le_pos_HistorySample_t* samplesPtr,
+        ///< [OUT] Recorded fixes, from the oldest one.
+
+    size_t* samplesSizePtr
+        ///< [INOUT] Number of recorded fixes.
+)
+{
+    uint32_t sequence;
+    size_t count = 0;
+
+    if ((NULL == samplesPtr) || (NULL == samplesSizePtr))
+    {
+        LE_KILL_CLIENT("Invalid pointer provided!");
+        return LE_FAULT;
+    }
+
+    if (0 == HistorySize)
+    {
+        *samplesSizePtr = 0;
+        return LE_UNSUPPORTED;
+    }
+
+    // Start from the oldest fix still recorded
+    sequence = since + 1;
+    if ((HistorySequence > HistorySize) && (sequence <= (HistorySequence - HistorySize)))
+    {
+        sequence = HistorySequence - HistorySize + 1;
+    }
+
+    for (; (sequence <= HistorySequence) && (count < *samplesSizePtr); sequence++, count++)
+    {
+        const le_pos_HistorySample_t* historySamplePtr = &HistoryPtr[(sequence - 1) % HistorySize];
+        le_pos_HistorySample_t* samplePtr = &samplesPtr[count];
+
+        *samplePtr = *historySamplePtr;
+
+        // Update resolutions, as the other le_pos functions do
+        if (INT32_MAX != historySamplePtr->hAccuracy)
+        {
+            samplePtr->hAccuracy = ConvertDistance(historySamplePtr->hAccuracy, H_ACCURACY);
+        }
+        if (INT32_MAX != historySamplePtr->altitude)
+        {
+            samplePtr->altitude = ConvertDistance(historySamplePtr->altitude, ALTITUDE);
+        }
+        if (INT32_MAX != historySamplePtr->vAccuracy)
+        {
+            samplePtr->vAccuracy = ConvertDistance(historySamplePtr->vAccuracy, V_ACCURACY);
+        }
+        if (UINT32_MAX != historySamplePtr->hSpeed)
+        {
+            samplePtr->hSpeed = historySamplePtr->hSpeed/100;
+        }
+        if (INT32_MAX != historySamplePtr->vSpeed)
+        {
+            samplePtr->vSpeed = historySamplePtr->vSpeed/100;
+        }
+        if (UINT32_MAX != historySamplePtr->direction)
+        {
+            samplePtr->direction = historySamplePtr->direction/10;
+        }
+    }
+
+    *samplesSizePtr = count;
+
+    return LE_OK;
+}
@@ -52,6 +52,21 @@
 #define LEGATO_WS_NAME_LEN (sizeof(LEGATO_TAG_PREFIX) + LE_PM_TAG_LEN + LEGATO_WS_PROCNAME_LEN + 3)
 ///@}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the kernel wakeup source held while any Legato wakeup source is acquired
+ */
+//--------------------------------------------------------------------------------------------------
+#define LEGATO_WAKE_LOCK_NAME   LEGATO_TAG_PREFIX"_powerMgr"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay in ms before releasing the kernel wakeup source once all the Legato wakeup sources are
+ * released. It avoids a sysfs write for each acquisition in stay awake/relax bursts.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RELAX_HYSTERESIS_MS     200
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The timer interval to kick the watchdog chain.
@@ -69,6 +84,22 @@
 #define WAKEUP_SOURCE_DEFAULT_POOL_SIZE 64
 ///@}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client record definition
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t cookie;                         // used to validate pointer to Client_t
+    pid_t pid;                               // client pid
+    le_msg_SessionRef_t session;             // back-reference to client connect session
+    char name[LEGATO_WS_PROCNAME_LEN + 1];   // client process name
+    le_clk_Time_t heldTime;                  // time its wakeup sources were held
+}
+Client_t;
+#define PM_CLIENT_COOKIE 0x7732c691
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Wakeup source record definition
@@ -80,27 +111,15 @@ typedef struct
     char          name[LEGATO_WS_NAME_LEN];    // full wakeup source name
     uint32_t      taken;    // > 0 locked, 0 = unlocked
     pid_t         pid;      // client pid of wakeup source owner
+    Client_t      *client;  // client record of wakeup source owner
     void          *wsref;   // back-pointer to safe reference
     bool          isRef;     // true if reference counted, false if not
+    le_clk_Time_t acquiredTime; // time of the last acquisition
+    le_clk_Time_t heldTime;     // time held, not including the current acquisition
 }
 WakeupSource_t;
 #define PM_WAKEUP_SOURCE_COOKIE 0xa1f6337b
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Client record definition
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    uint32_t cookie;                         // used to validate pointer to Client_t
-    pid_t pid;                               // client pid
-    le_msg_SessionRef_t session;             // back-reference to client connect session
-    char name[LEGATO_WS_PROCNAME_LEN + 1];   // client process name
-}
-Client_t;
-#define PM_CLIENT_COOKIE 0x7732c691
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Global power manager record
@@ -116,8 +135,11 @@ static struct
     le_mem_PoolRef_t    cpool;   // memory pool for client records
     le_hashmap_Ref_t    clients; // table of client records
     bool                isFull;  // le_pm_StayAwke() fails with LE_NO_MEMORY
+    uint32_t            held;    // number of acquired wakeup sources
+    bool                isLocked;    // true if the kernel wakeup source is acquired
+    le_timer_Ref_t      relaxTimer;  // timer delaying the kernel wakeup source release
 }
-PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL, false};
+PowerManager = {-1, -1, NULL, NULL, NULL, NULL, NULL, false, 0, false, NULL};
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -171,6 +193,124 @@ static inline Client_t *to_Client_t
 #define to_Client_t(c) ((Client_t*)c)
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a time to milliseconds
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t TimeToMs
+(
+    le_clk_Time_t time
+)
+{
+    return ((uint64_t)time.sec * 1000) + (time.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Acquire the kernel wakeup source if it is not held yet, and count a new acquired wakeup source
+ *
+ * @return
+ *     - LE_OK          if the kernel wakeup source is acquired
+ *     - LE_NO_MEMORY   if the wakeup sources limit is reached
+ *     - LE_FAULT       for other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AcquireKernelWakeLock
+(
+    void
+)
+{
+    // Cancel a pending release
+    le_timer_Stop(PowerManager.relaxTimer);
+
+    if (!PowerManager.isLocked)
+    {
+        // Write to /sys/power/wake_lock
+        if (0 > write(PowerManager.wl, LEGATO_WAKE_LOCK_NAME, strlen(LEGATO_WAKE_LOCK_NAME)))
+        {
+            if (ENOSPC == errno)
+            {
+                LE_ERROR("Too many wakeup source: Cannot acquire '%s'.", LEGATO_WAKE_LOCK_NAME);
+                PowerManager.isFull = true;
+                return LE_NO_MEMORY;
+            }
+            else if (EBADF == errno)
+            {
+                LE_FATAL("Error acquiring wakeup source '%s'. Invalid file descriptor %d.",
+                         LEGATO_WAKE_LOCK_NAME, PowerManager.wl);
+            }
+            else
+            {
+                LE_CRIT("Error acquiring wakeup source '%s': %m", LEGATO_WAKE_LOCK_NAME);
+                return LE_FAULT;
+            }
+        }
+
+        PowerManager.isLocked = true;
+    }
+
+    PowerManager.held++;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a released wakeup source, and schedule the kernel wakeup source release if none is
+ * acquired anymore
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseKernelWakeLock
+(
+    void
+)
+{
+    if (0 == --PowerManager.held)
+    {
+        le_timer_Start(PowerManager.relaxTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Relax timer handler: release the kernel wakeup source if no wakeup source has been acquired
+ * during the hysteresis delay
+ */
+//--------------------------------------------------------------------------------------------------
+static void RelaxTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    if ((PowerManager.held) || (!PowerManager.isLocked))
+    {
+        return;
+    }
+
+    // write to /sys/power/wake_unlock
+    if (0 > write(PowerManager.wu, LEGATO_WAKE_LOCK_NAME, strlen(LEGATO_WAKE_LOCK_NAME)))
+    {
+        if (EINVAL == errno)
+        {
+            LE_ERROR("Wakeup source '%s' is not locked.", LEGATO_WAKE_LOCK_NAME);
+        }
+        else if (EBADF == errno)
+        {
+            LE_FATAL("Error releasing wakeup source '%s'. Invalid file descriptor %d.",
+                     LEGATO_WAKE_LOCK_NAME, PowerManager.wu);
+        }
+        else
+        {
+            LE_CRIT("Error releasing wakeup source '%s': %m", LEGATO_WAKE_LOCK_NAME);
+            return;
+        }
+    }
+
+    PowerManager.isLocked = false;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Client connect callback
@@ -214,6 +354,7 @@ static void OnClientConnect
     procStr[procLen - 1] = '\0';
     memset(c->name, 0, sizeof(c->name));
     le_utf8_Copy(c->name, procStr, sizeof(c->name), NULL);
+    c->heldTime = (le_clk_Time_t){0, 0};
 
     // Store client record in table
     if (le_hashmap_Put(PowerManager.clients, sessionRef, c))
@@ -280,6 +421,9 @@ static void OnClientDisconnect
         le_mem_Release(ws);
     }
 
+    LE_INFO("Client %s/%d held wakeup sources for %"PRIu64" ms.",
+            c->name, c->pid, TimeToMs(c->heldTime));
+
     // Free client record
     le_mem_Release(c);
 
@@ -352,6 +496,11 @@ COMPONENT_INIT
         LE_FATAL("Failed to create client hashmap");
     }
 
+    // Create the timer delaying the kernel wakeup source release
+    PowerManager.relaxTimer = le_timer_Create("PM Relax Timer");
+    le_timer_SetMsInterval(PowerManager.relaxTimer, RELAX_HYSTERESIS_MS);
+    le_timer_SetHandler(PowerManager.relaxTimer, RelaxTimerHandler);
+
     // Register client connect/disconnect handlers
     le_msg_AddServiceOpenHandler(le_pm_GetServiceRef(), OnClientConnect, NULL);
     le_msg_AddServiceCloseHandler(le_pm_GetServiceRef(), OnClientDisconnect, NULL);
@@ -450,6 +599,8 @@ le_pm_WakeupSourceRef_t le_pm_NewWakeupSource
     le_utf8_Copy(ws->name, name, sizeof(ws->name), NULL);
     ws->taken = 0;
     ws->pid = cl->pid;
+    ws->client = cl;
+    ws->heldTime = (le_clk_Time_t){0, 0};
     ws->isRef = (opts & LE_PM_REF_COUNT ? true : false);
 
     ws->wsref = le_ref_CreateRef(PowerManager.refs, ws);
@@ -515,27 +666,17 @@ le_result_t le_pm_StayAwake
         return LE_OK;
     }
 
-    // Write to /sys/power/wake_lock
-    if (0 > write(PowerManager.wl, entry->name, strlen(entry->name)))
+    // The kernel wakeup source is shared by all the acquired wakeup sources
+    le_result_t result = AcquireKernelWakeLock();
+    if (LE_OK != result)
     {
-        if (ENOSPC == errno)
-        {
-            LE_ERROR("Too many wakeup source: Cannot acquire '%s'.", entry->name);
-            PowerManager.isFull = true;
-            return LE_NO_MEMORY;
-        }
-        else if (EBADF == errno)
-        {
-            LE_FATAL("Error acquiring wakeup source '%s'. Invalid file descriptor %d.",
-                     entry->name, PowerManager.wl);
-        }
-        else
-        {
-            LE_CRIT("Error acquiring wakeup source '%s': %m", entry->name);
-            return LE_FAULT;
-        }
+        LE_ERROR("Cannot acquire '%s'.", entry->name);
+        entry->taken = 0;
+        return result;
     }
 
+    entry->acquiredTime = le_clk_GetRelativeTime();
+
     return LE_OK;
 }
 
@@ -597,25 +738,12 @@ le_result_t le_pm_Relax
         entry->taken = 0;
     }
 
-    // write to /sys/power/wake_unlock
-    if (0 > write(PowerManager.wu, entry->name, strlen(entry->name)))
-    {
-        if (EINVAL == errno)
-        {
-            LE_ERROR("Wakeup source '%s' is not locked.", entry->name);
-            return LE_NOT_FOUND;
-        }
-        else if (EBADF == errno)
-        {
-            LE_FATAL("Error releasing wakeup source '%s'. Invalid file descriptor %d.",
-                     entry->name, PowerManager.wu);
-        }
-        else
-        {
-            LE_CRIT("Error releasing wakeup source '%s': %m", entry->name);
-            return LE_FAULT;
-        }
-    }
+    // Update the time held statistics
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), entry->acquiredTime);
+    entry->heldTime = le_clk_Add(entry->heldTime, duration);
+    entry->client->heldTime = le_clk_Add(entry->client->heldTime, duration);
+
+    ReleaseKernelWakeLock();
 
     return LE_OK;
 }
@@ -646,12 +774,16 @@ bool pm_CheckWakeLock
 
         if (wakeSrc->taken)
         {
-            // Wakelock held
-            LE_DEBUG("Wakelock held(Pid: %d, Wake Source Name: %s)",
-                     wakeSrc->pid,
-                     wakeSrc->name);
+            // Wakelock held, report all the holders
+            le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), wakeSrc->acquiredTime);
+
+            LE_INFO("Wakelock held(Pid: %d, Wake Source Name: %s) for %"PRIu64" ms, "
+                    "%"PRIu64" ms in total",
+                    wakeSrc->pid,
+                    wakeSrc->name,
+                    TimeToMs(duration),
+                    TimeToMs(le_clk_Add(wakeSrc->heldTime, duration)));
             wakelockHeld = true;
-            break;
         }
     }
 
@@ -13,6 +13,11 @@
  * writes item "bar" the item will be stored as "/app/foo/bar".  Also, if a non-app user "foo"
  * writes item "bar" the item will be stored as "/foo/bar".
  *
+ * To avoid going to the platform adaptor for every request, the name of each client is looked up
+ * once per IPC session, and the most recently used items are kept in a small read cache.  Clients
+ * that enabled write-behind only update the cached copy of the items they write, which is written
+ * to secure storage when the client flushes it, disconnects, or when the flush timer expires.
+ *
  * <hr>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -25,6 +30,9 @@
 #include "limit.h"
 #include "user.h"
 #include "watchdogChain.h"
+#include "fileDescriptor.h"
+
+#include <arpa/inet.h>
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -63,6 +71,35 @@
 //--------------------------------------------------------------------------------------------------
 #define MS_WDOG_INTERVAL 8
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of items kept in the read cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_MAX_ITEMS     8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay, in seconds, after the first deferred write before the pending writes are flushed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLUSH_DELAY_SEC     30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimated maximum number of concurrent client sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CLIENT_MAP_SIZE     31
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic bytes at the start of an export stream.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EXPORT_MAGIC        "LESSEXP1"
+#define EXPORT_MAGIC_LEN    (sizeof(EXPORT_MAGIC) - 1)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Current system path.
@@ -169,6 +206,105 @@ Entry_t;
 static le_mem_PoolRef_t EntryPool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client object, cached for the IPC session of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;         ///< Session of the client, key in the client map.
+    bool isNameValid;                       ///< true once the client name has been looked up.
+    char name[LIMIT_MAX_USER_NAME_BYTES];   ///< App name or user name of the client.
+    bool isApp;                             ///< true if the client is an app.
+    bool isLimitValid;                      ///< true once the storage limit has been looked up.
+    size_t secStoreLimit;                   ///< Secure storage limit of the client, in bytes.
+    bool isWriteBehind;                     ///< true if the client's writes are deferred.
+}
+Client_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of client objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ClientPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of the client objects, by session reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ClientMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached secure storage item.
+ *
+ * @note
+ *      The cached data is not encrypted: the key would have to be kept in the memory of this same
+ *      daemon, so it would not protect the data from anyone able to read that memory.  The data is
+ *      wiped when the item is released instead.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];    ///< Full path of the item, key in the cache map.
+    uint8_t data[LE_SECSTORE_MAX_ITEM_SIZE];    ///< Data of the item.
+    size_t size;                                ///< Number of bytes of data.
+    bool isDirty;                               ///< true if the data is not in secure storage yet.
+    size_t storedSize;                          ///< Size of the item in secure storage, if dirty.
+    le_msg_SessionRef_t writerRef;              ///< Session which made the item dirty.
+    le_dls_Link_t link;                         ///< Link in the cache list, most recent first.
+}
+CacheItem_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of cached items.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CacheItemPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of the cached items, by path.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t CacheMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the cached items, from the most to the least recently used.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t CacheList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer flushing the deferred writes.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t FlushTimerRef = NULL;
+
+
+#if (SECSTOREADMIN == 1)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer holding the data of the item being exported or imported.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t TransferBuf[LE_SECSTORE_MAX_ITEM_SIZE];
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the specified system index is in the list.
@@ -574,11 +710,316 @@ static EntryIter_t* GetEntryIterPtr
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the session reference of the currently connected client.
+ *
+ * This function must be called within an IPC message handler from the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t GetClientSessionRef
+(
+    bool isGlobal                   ///< [IN] Is this an operation is the global domain?
+)
+{
+    if (isGlobal)
+    {
+        return secStoreGlobal_GetClientSessionRef();
+    }
+
+    return le_secStore_GetClientSessionRef();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the client object of a session, creating it on the first request of the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static Client_t* GetClient
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Session of the client.
+)
+{
+    Client_t* clientPtr = le_hashmap_Get(ClientMap, sessionRef);
+
+    if (clientPtr == NULL)
+    {
+        clientPtr = le_mem_ForceAlloc(ClientPool);
+        memset(clientPtr, 0, sizeof(Client_t));
+        clientPtr->sessionRef = sessionRef;
+
+        le_hashmap_Put(ClientMap, clientPtr->sessionRef, clientPtr);
+    }
+
+    return clientPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a cached item, wiping its data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseCacheItem
+(
+    CacheItem_t* itemPtr            ///< [IN] Cached item.
+)
+{
+    le_hashmap_Remove(CacheMap, itemPtr->path);
+    le_dls_Remove(&CacheList, &itemPtr->link);
+
+    memset(itemPtr, 0, sizeof(CacheItem_t));
+    le_mem_Release(itemPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a dirty cached item to secure storage.  If it cannot be written, the item is dropped.
+ *
+ * @return
+ *      LE_OK if successful, or if the item is not dirty.
+ *      LE_NO_MEMORY if there is not enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushCacheItem
+(
+    CacheItem_t* itemPtr            ///< [IN] Cached item.
+)
+{
+    if (!itemPtr->isDirty)
+    {
+        return LE_OK;
+    }
+
+    le_result_t result = pa_secStore_Write(itemPtr->path, itemPtr->data, itemPtr->size);
+
+    if (result != LE_OK)
+    {
+        LE_ERROR("Could not write deferred item '%s'. %s.", itemPtr->path, LE_RESULT_TXT(result));
+        ReleaseCacheItem(itemPtr);
+
+        return (result == LE_BAD_PARAMETER) ? LE_FAULT : result;
+    }
+
+    itemPtr->isDirty = false;
+    itemPtr->writerRef = NULL;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the dirty cached items of a session, or of all sessions, to secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      Otherwise, the result of the first item that could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushCache
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Session to flush, or NULL to flush all the sessions.
+)
+{
+    le_result_t result = LE_OK;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&CacheList);
+
+    while (linkPtr != NULL)
+    {
+        CacheItem_t* itemPtr = CONTAINER_OF(linkPtr, CacheItem_t, link);
+
+        // Flushing can release the item.
+        linkPtr = le_dls_PeekNext(&CacheList, linkPtr);
+
+        if ( itemPtr->isDirty && ((sessionRef == NULL) || (itemPtr->writerRef == sessionRef)) )
+        {
+            le_result_t flushResult = FlushCacheItem(itemPtr);
+
+            if (result == LE_OK)
+            {
+                result = flushResult;
+            }
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes all the dirty cached items to secure storage and empties the cache.  Used before
+ * accessing secure storage by path, bypassing the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#if (SECSTOREADMIN == 1)
+static void ClearCache
+(
+    void
+)
+{
+    FlushCache(NULL);
+
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Peek(&CacheList)) != NULL)
+    {
+        ReleaseCacheItem(CONTAINER_OF(linkPtr, CacheItem_t, link));
+    }
+
+    le_timer_Stop(FlushTimerRef);
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush timer handler: writes all the deferred writes to secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushTimerHandler
+(
+    le_timer_Ref_t timerRef         ///< [IN] Flush timer.
+)
+{
+    FlushCache(NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a cached item, and makes it the most recently used one.
+ *
+ * @return
+ *      The cached item, or NULL if the item is not in the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static CacheItem_t* GetCacheItem
+(
+    const char* pathPtr             ///< [IN] Full path of the item.
+)
+{
+    CacheItem_t* itemPtr = le_hashmap_Get(CacheMap, pathPtr);
+
+    if (itemPtr != NULL)
+    {
+        le_dls_Remove(&CacheList, &itemPtr->link);
+        le_dls_Stack(&CacheList, &itemPtr->link);
+    }
+
+    return itemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores the data of an item in the cache, adding the item to the cache if needed.  When the cache
+ * is full, the least recently used item is written to secure storage if needed and evicted.
+ *
+ * @return
+ *      The cached item.
+ */
+//--------------------------------------------------------------------------------------------------
+static CacheItem_t* CacheData
+(
+    const char* pathPtr,            ///< [IN] Full path of the item.
+    const uint8_t* bufPtr,          ///< [IN] Data of the item.
+    size_t bufSize                  ///< [IN] Number of bytes of data.
+)
+{
+    LE_ASSERT(bufSize <= LE_SECSTORE_MAX_ITEM_SIZE);
+
+    CacheItem_t* itemPtr = GetCacheItem(pathPtr);
+
+    if (itemPtr == NULL)
+    {
+        if (le_hashmap_Size(CacheMap) >= CACHE_MAX_ITEMS)
+        {
+            CacheItem_t* lruPtr = CONTAINER_OF(le_dls_PeekTail(&CacheList), CacheItem_t, link);
+
+            if (FlushCacheItem(lruPtr) == LE_OK)
+            {
+                ReleaseCacheItem(lruPtr);
+            }
+        }
+
+        itemPtr = le_mem_ForceAlloc(CacheItemPool);
+        memset(itemPtr, 0, sizeof(CacheItem_t));
+        LE_ASSERT(le_utf8_Copy(itemPtr->path, pathPtr, sizeof(itemPtr->path), NULL) == LE_OK);
+        itemPtr->link = LE_DLS_LINK_INIT;
+
+        le_hashmap_Put(CacheMap, itemPtr->path, itemPtr);
+        le_dls_Stack(&CacheList, &itemPtr->link);
+    }
+
+    memcpy(itemPtr->data, bufPtr, bufSize);
+    itemPtr->size = bufSize;
+
+    return itemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops the cached item of a path, if any.
+ *
+ * @return
+ *      true if the dropped item was dirty.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DropCacheItem
+(
+    const char* pathPtr             ///< [IN] Full path of the item.
+)
+{
+    CacheItem_t* itemPtr = le_hashmap_Get(CacheMap, pathPtr);
+    bool isDirty = false;
+
+    if (itemPtr != NULL)
+    {
+        isDirty = itemPtr->isDirty;
+        ReleaseCacheItem(itemPtr);
+    }
+
+    return isDirty;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called when a client of the le_secStore or the secStoreGlobal service disconnects: writes
+ * its deferred writes to secure storage and releases its client object.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CleanupClient
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    FlushCache(sessionRef);
+
+    Client_t* clientPtr = le_hashmap_Remove(ClientMap, sessionRef);
+
+    if (clientPtr != NULL)
+    {
+        le_mem_Release(clientPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the name of the currently connected client.  If the client process is part of a Legato app
  * then the name will be the name of the app.  If the client process is not part of a Legato app
- * then the name will be the process's effective user name.
+ * then the name will be the process's effective user name.  The name is only looked up on the
+ * first request of the client's session.
  *
  * This function must be called within an IPC message handler from the client.
  *
@@ -598,42 +1039,55 @@ static le_result_t GetClientName
     bool* isApp                     ///< [OUT] Set to true if the client is an app.
 )
 {
-    // Get the client's credentials.
-    pid_t pid;
-    uid_t uid;
+    Client_t* clientPtr = GetClient(le_secStore_GetClientSessionRef());
 
-    if (le_msg_GetClientUserCreds(le_secStore_GetClientSessionRef(), &uid, &pid) != LE_OK)
+    if (!clientPtr->isNameValid)
     {
-        LE_CRIT("Could not get credentials for the client.");
-        return LE_FAULT;
-    }
+        // Get the client's credentials.
+        pid_t pid;
+        uid_t uid;
 
-    // Look up the process's application name.
-    le_result_t result = le_appInfo_GetName(pid, bufPtr, bufSize);
+        if (le_msg_GetClientUserCreds(clientPtr->sessionRef, &uid, &pid) != LE_OK)
+        {
+            LE_CRIT("Could not get credentials for the client.");
+            return LE_FAULT;
+        }
 
-    if (result == LE_OK)
-    {
-        *isApp = true;
-        return LE_OK;
-    }
+        // Look up the process's application name.
+        le_result_t result = le_appInfo_GetName(pid, clientPtr->name, sizeof(clientPtr->name));
 
-    LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
+        if (result == LE_OK)
+        {
+            clientPtr->isApp = true;
+        }
+        else
+        {
+            LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
 
-    // The process was not an app.  Get the linux user name for the process.
-    result = user_GetName(uid, bufPtr, bufSize);
+            // The process was not an app.  Get the linux user name for the process.
+            result = user_GetName(uid, clientPtr->name, sizeof(clientPtr->name));
 
-    if (result == LE_OK)
-    {
-        *isApp = false;
-        return LE_OK;
-    }
+            if (result != LE_OK)
+            {
+                LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the user name.");
 
-    LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the user name.");
+                // Could not get the user name.
+                LE_CRIT("Could not get user name for pid %d (uid %d).", pid, uid);
 
-    // Could not get the user name.
-    LE_CRIT("Could not get user name for pid %d (uid %d).", pid, uid);
+                return LE_FAULT;
+            }
+
+            clientPtr->isApp = false;
+        }
 
-    return LE_FAULT;
+        clientPtr->isNameValid = true;
+    }
+
+    LE_FATAL_IF(le_utf8_Copy(bufPtr, clientPtr->name, bufSize, NULL) != LE_OK,
+                "Buffer too small to contain the client name.");
+    *isApp = clientPtr->isApp;
+
+    return LE_OK;
 }
 
 
@@ -672,7 +1126,7 @@ static void GetClientPath
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if there is enough space in the client's area of secure storage for the client to write
- * the item.
+ * the item, taking the client's deferred writes into account.
  *
  * @return
  *      LE_OK if the item would fit in the client's area of secure storage.
@@ -690,14 +1144,21 @@ static le_result_t CheckClientLimit
 )
 {
     // Get the secure storage limit for the client.
-    appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
-    if (!iter)
+    Client_t* clientPtr = GetClient(le_secStore_GetClientSessionRef());
+
+    if (!clientPtr->isLimitValid)
     {
-       LE_ERROR("iter is NULL");
-       return LE_FAULT;
+        appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
+        if (!iter)
+        {
+           LE_ERROR("iter is NULL");
+           return LE_FAULT;
+        }
+        clientPtr->secStoreLimit = appCfg_GetSecStoreLimit(iter);
+        clientPtr->isLimitValid = true;
+        appCfg_DeleteIter(iter);
     }
-    size_t secStoreLimit = appCfg_GetSecStoreLimit(iter);
-    appCfg_DeleteIter(iter);
+    size_t secStoreLimit = clientPtr->secStoreLimit;
 
     // Get the current amount of space used by the client.
     size_t usedSpace = 0;
@@ -722,6 +1183,26 @@ static le_result_t CheckClientLimit
         return result;
     }
 
+    // Account for the deferred writes which are not in the secure storage yet.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&CacheList);
+
+    while (linkPtr != NULL)
+    {
+        CacheItem_t* itemPtr = CONTAINER_OF(linkPtr, CacheItem_t, link);
+
+        if (itemPtr->isDirty && le_path_IsSubpath(clientPathPtr, itemPtr->path, "/"))
+        {
+            usedSpace = usedSpace + itemPtr->size - itemPtr->storedSize;
+
+            if (strcmp(itemPtr->path, itemPath) == 0)
+            {
+                origItemSize = itemPtr->size;
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&CacheList, linkPtr);
+    }
+
     // Calculate if replacing the item would fit within the limit.
     if (((ssize_t)(secStoreLimit - usedSpace + origItemSize - itemSize)) >= 0)
     {
@@ -857,15 +1338,57 @@ static le_result_t Write
                     "Client %s's path for item %s is too long.", clientName, name);
     }
 
+    le_msg_SessionRef_t sessionRef = GetClientSessionRef(isGlobal);
+
+    if (GetClient(sessionRef)->isWriteBehind)
+    {
+        // Only update the cached copy of the item, remembering the size of the stored item to
+        // keep track of the client's usage.
+        CacheItem_t* itemPtr = GetCacheItem(path);
+        size_t storedSize = 0;
+
+        if ((itemPtr != NULL) && itemPtr->isDirty)
+        {
+            storedSize = itemPtr->storedSize;
+        }
+        else if (itemPtr != NULL)
+        {
+            storedSize = itemPtr->size;
+        }
+        else if (pa_secStore_GetSize(path, &storedSize) != LE_OK)
+        {
+            storedSize = 0;
+        }
+
+        itemPtr = CacheData(path, bufPtr, bufNumElements);
+        itemPtr->isDirty = true;
+        itemPtr->storedSize = storedSize;
+        itemPtr->writerRef = sessionRef;
+
+        if (!le_timer_IsRunning(FlushTimerRef))
+        {
+            le_timer_Start(FlushTimerRef);
+        }
+
+        return LE_OK;
+    }
+
     // Write the item to the secure storage.
     result = pa_secStore_Write(path, bufPtr, bufNumElements);
 
-    if (result == LE_BAD_PARAMETER)
+    if (result != LE_OK)
     {
-        return LE_FAULT;
+        // The stored item is now unknown.
+        DropCacheItem(path);
+
+        return (result == LE_BAD_PARAMETER) ? LE_FAULT : result;
     }
 
-    return result;
+    CacheItem_t* itemPtr = CacheData(path, bufPtr, bufNumElements);
+    itemPtr->isDirty = false;
+    itemPtr->writerRef = NULL;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -988,8 +1511,32 @@ static le_result_t Read
                     "Client %s's path for item %s is too long.", clientName, name);
     }
 
-    // Read the item from the secure storage.
-    result = pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
+    CacheItem_t* itemPtr = GetCacheItem(path);
+
+    if (itemPtr != NULL)
+    {
+        // Read the item from the cache.
+        if (itemPtr->size <= *bufNumElementsPtr)
+        {
+            memcpy(bufPtr, itemPtr->data, itemPtr->size);
+            *bufNumElementsPtr = itemPtr->size;
+            result = LE_OK;
+        }
+        else
+        {
+            result = LE_OVERFLOW;
+        }
+    }
+    else
+    {
+        // Read the item from the secure storage.
+        result = pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
+
+        if (result == LE_OK)
+        {
+            CacheData(path, bufPtr, *bufNumElementsPtr);
+        }
+    }
 
     // If there is an error, make sure that the buffer is empty.
     if ( (LE_OK != result) && (bufNumElementsPtr > 0) )
@@ -1110,46 +1657,143 @@ le_result_t Delete
                     "Client %s's path for item %s is too long.", clientName, name);
     }
 
-    // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    // Delete the item from the cache and from the secure storage.  A deferred write of a new item
+    // is not in the secure storage yet.
+    bool isDirty = DropCacheItem(path);
+    le_result_t result = pa_secStore_Delete(path);
+
+    if ((result == LE_NOT_FOUND) && isDirty)
+    {
+        return LE_OK;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Delete
+(
+    const char* name    ///< [IN] Name of the secure storage item.
+)
+{
+    return Delete(false, name);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes an item from secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the item does not exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreGlobal_Delete
+(
+    const char* name    ///< [IN] Name of the secure storage item.
+)
+{
+    return Delete(true, name);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables or disables write-behind for the calling client.  Disabling write-behind flushes the
+ * pending writes of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetWriteBehind
+(
+    bool isGlobal,      ///< [IN] Is this an operation is the global domain?
+    bool enable         ///< [IN] true to defer the writes, false to write them through.
+)
+{
+    le_msg_SessionRef_t sessionRef = GetClientSessionRef(isGlobal);
+
+    GetClient(sessionRef)->isWriteBehind = enable;
+
+    if (!enable)
+    {
+        FlushCache(sessionRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables or disables write-behind for the calling client.  Disabling write-behind flushes the
+ * pending writes of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_secStore_SetWriteBehind
+(
+    bool enable         ///< [IN] true to defer the writes, false to write them through.
+)
+{
+    SetWriteBehind(false, enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables or disables write-behind for the calling client.  Disabling write-behind flushes the
+ * pending writes of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreGlobal_SetWriteBehind
+(
+    bool enable         ///< [IN] true to defer the writes, false to write them through.
+)
+{
+    SetWriteBehind(true, enable);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an item from secure storage.
+ * Writes the pending deferred writes of the calling client to secure storage.
  *
  * @return
- *      LE_OK if successful.
- *      LE_NOT_FOUND if the item does not exist.
+ *      LE_OK if successful, or if there was nothing to flush.
+ *      LE_NO_MEMORY if there isn't enough memory to store an item. The item is dropped.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_secStore_Delete
+le_result_t le_secStore_Flush
 (
-    const char* name    ///< [IN] Name of the secure storage item.
+    void
 )
 {
-    return Delete(false, name);
+    return FlushCache(le_secStore_GetClientSessionRef());
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes an item from secure storage.
+ * Writes the pending deferred writes of the calling client to secure storage.
  *
  * @return
- *      LE_OK if successful.
- *      LE_NOT_FOUND if the item does not exist.
+ *      LE_OK if successful, or if there was nothing to flush.
+ *      LE_NO_MEMORY if there isn't enough memory to store an item. The item is dropped.
  *      LE_UNAVAILABLE if the secure storage is currently unavailable.
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t secStoreGlobal_Delete
+le_result_t secStoreGlobal_Flush
 (
-    const char* name    ///< [IN] Name of the secure storage item.
+    void
 )
 {
-    return Delete(true, name);
+    return FlushCache(secStoreGlobal_GetClientSessionRef());
 }
 
 
@@ -1362,6 +2006,9 @@ secStoreAdmin_IterRef_t secStoreAdmin_CreateIter
         return NULL;
     }
 
+    // The deferred writes need to be in the secure storage to be listed.
+    FlushCache(NULL);
+
     // Create a snap shot of the entire list of entries for this path now so we don't need to worry
     // about concurrency issues.
     EntryIter_t* iterPtr = le_mem_ForceAlloc(EntryIterPool);
@@ -1578,6 +2225,9 @@ le_result_t secStoreAdmin_Write
         return LE_FAULT;
     }
 
+    // The cached items may be overwritten.
+    ClearCache();
+
     // Write the item to the secure storage.
     return pa_secStore_Write(path, bufPtr, bufNumElements);
 
@@ -1631,6 +2281,9 @@ le_result_t secStoreAdmin_Read
         return LE_FAULT;
     }
 
+    // The item may have a deferred write.
+    FlushCache(NULL);
+
     // Read the item from the secure storage.
     return pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
 #else
@@ -1639,6 +2292,345 @@ le_result_t secStoreAdmin_Read
 }
 
 
+#if (SECSTOREADMIN == 1)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item to an export stream.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExportItem
+(
+    int fd,                         ///< [IN] File to write to.
+    const char* pathPtr             ///< [IN] Path of the item.
+)
+{
+    size_t dataSize = sizeof(TransferBuf);
+    le_result_t result = pa_secStore_Read(pathPtr, TransferBuf, &dataSize);
+
+    if (result != LE_OK)
+    {
+        LE_ERROR("Could not read item %s.  Result code %s.", pathPtr, LE_RESULT_TXT(result));
+        return (result == LE_UNAVAILABLE) ? result : LE_FAULT;
+    }
+
+    size_t pathSize = strlen(pathPtr);
+    uint32_t header[2] = { htonl(pathSize), htonl(dataSize) };
+
+    if ( (fd_WriteSize(fd, header, sizeof(header)) != sizeof(header)) ||
+         (fd_WriteSize(fd, (void*)pathPtr, pathSize) != (ssize_t)pathSize) ||
+         (fd_WriteSize(fd, TransferBuf, dataSize) != (ssize_t)dataSize) )
+    {
+        result = LE_FAULT;
+    }
+
+    memset(TransferBuf, 0, dataSize);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recursively writes all items under a path to an export stream.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the path doesn't exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExportPath
+(
+    int fd,                         ///< [IN] File to write to.
+    char* pathPtr,                  ///< [IN] Path of SECSTOREADMIN_MAX_PATH_BYTES bytes, used to
+                                    ///       build the entry paths and restored before returning.
+    uint32_t* numItemsPtr           ///< [INOUT] Number of items exported.
+)
+{
+    EntryIter_t* iterPtr = le_mem_ForceAlloc(EntryIterPool);
+    iterPtr->entryList = LE_SLS_LIST_INIT;
+    iterPtr->currEntryPtr = NULL;
+    iterPtr->sessionRef = NULL;
+
+    le_result_t result = pa_secStore_GetEntries(pathPtr, StoreEntry, iterPtr);
+    size_t pathLen = strlen(pathPtr);
+    le_sls_Link_t* linkPtr = le_sls_Peek(&(iterPtr->entryList));
+
+    while ( (result == LE_OK) && (linkPtr != NULL) )
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+
+        if (le_path_Concat("/", pathPtr, SECSTOREADMIN_MAX_PATH_BYTES, entryPtr->path, NULL)
+            != LE_OK)
+        {
+            LE_ERROR("Path of entry %s under %s is too long.", entryPtr->path, pathPtr);
+            result = LE_FAULT;
+        }
+        else if (entryPtr->isDir)
+        {
+            result = ExportPath(fd, pathPtr, numItemsPtr);
+        }
+        else
+        {
+            result = ExportItem(fd, pathPtr);
+
+            if (result == LE_OK)
+            {
+                (*numItemsPtr)++;
+                le_wdogChain_Kick(0);
+            }
+        }
+
+        pathPtr[pathLen] = '\0';
+        linkPtr = le_sls_PeekNext(&(iterPtr->entryList), linkPtr);
+    }
+
+    DeleteIter(iterPtr);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the next item from an export stream and writes it to secure storage.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if the end of the stream was reached.
+ *      LE_FORMAT_ERROR if the stream is malformed or truncated.
+ *      LE_NO_MEMORY if there isn't enough memory to store the item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ImportItem
+(
+    int fd                          ///< [IN] File to read from.
+)
+{
+    uint32_t header[2];
+    ssize_t readSize = fd_ReadSize(fd, header, sizeof(header));
+
+    if (readSize == 0)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+    else if (readSize != sizeof(header))
+    {
+        return (readSize < 0) ? LE_FAULT : LE_FORMAT_ERROR;
+    }
+
+    uint32_t pathSize = ntohl(header[0]);
+    uint32_t dataSize = ntohl(header[1]);
+
+    if ( (pathSize > SECSTOREADMIN_MAX_PATH_SIZE) || (dataSize > sizeof(TransferBuf)) )
+    {
+        LE_ERROR("Bad item header, path size %" PRIu32 ", data size %" PRIu32 ".",
+                 pathSize, dataSize);
+        return LE_FORMAT_ERROR;
+    }
+
+    char path[SECSTOREADMIN_MAX_PATH_BYTES];
+
+    if ( (fd_ReadSize(fd, path, pathSize) != (ssize_t)pathSize) ||
+         (fd_ReadSize(fd, TransferBuf, dataSize) != (ssize_t)dataSize) )
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    path[pathSize] = '\0';
+
+    le_result_t result;
+
+    if (!IsValidPath(path, true))
+    {
+        result = LE_FORMAT_ERROR;
+    }
+    else
+    {
+        result = pa_secStore_Write(path, TransferBuf, dataSize);
+
+        if (result == LE_BAD_PARAMETER)
+        {
+            LE_ERROR("Could not write item %s.", path);
+            result = LE_FAULT;
+        }
+    }
+
+    memset(TransferBuf, 0, dataSize);
+
+    return result;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exports all items under the specified path to a file, in a single call.
+ *
+ * @note
+ *      The specified path must be an absolute path.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the path doesn't exist.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error, including an error writing to the file.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreAdmin_Export
+(
+    const char* path,
+        ///< [IN]
+        ///< Path to export the items under.
+
+    int fd,
+        ///< [IN]
+        ///< File to write the items to.
+
+    uint32_t* numItemsPtr
+        ///< [OUT]
+        ///< Number of items exported.
+)
+{
+#if (SECSTOREADMIN == 1)
+    // Check parameters.
+    if (!IsValidPath(path, false))
+    {
+        LE_KILL_CLIENT("Path is invalid.");
+        return LE_FAULT;
+    }
+
+    if (numItemsPtr == NULL)
+    {
+        LE_KILL_CLIENT("numItemsPtr is NULL.");
+        return LE_FAULT;
+    }
+
+    *numItemsPtr = 0;
+
+    if (fd < 0)
+    {
+        LE_ERROR("No file to export to.");
+        return LE_FAULT;
+    }
+
+    // The deferred writes need to be in the secure storage to be exported.
+    FlushCache(NULL);
+
+    char entryPath[SECSTOREADMIN_MAX_PATH_BYTES];
+    LE_ASSERT(le_utf8_Copy(entryPath, path, sizeof(entryPath), NULL) == LE_OK);
+
+    le_result_t result = LE_OK;
+
+    if (fd_WriteSize(fd, EXPORT_MAGIC, EXPORT_MAGIC_LEN) != EXPORT_MAGIC_LEN)
+    {
+        result = LE_FAULT;
+    }
+    else
+    {
+        result = ExportPath(fd, entryPath, numItemsPtr);
+    }
+
+    fd_Close(fd);
+
+    return result;
+#else
+    if (fd >= 0)
+    {
+        fd_Close(fd);
+    }
+
+    return LE_UNSUPPORTED;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Imports the items from a file written by secStoreAdmin_Export().  Items which already exist are
+ * overwritten.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FORMAT_ERROR if the file is not an export stream, or is truncated.
+ *      LE_NO_MEMORY if there isn't enough memory to store an item.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreAdmin_Import
+(
+    int fd,
+        ///< [IN]
+        ///< File to read the items from.
+
+    uint32_t* numItemsPtr
+        ///< [OUT]
+        ///< Number of items imported.
+)
+{
+#if (SECSTOREADMIN == 1)
+    if (numItemsPtr == NULL)
+    {
+        LE_KILL_CLIENT("numItemsPtr is NULL.");
+        return LE_FAULT;
+    }
+
+    *numItemsPtr = 0;
+
+    if (fd < 0)
+    {
+        LE_ERROR("No file to import from.");
+        return LE_FAULT;
+    }
+
+    // The cached items may be overwritten.
+    ClearCache();
+
+    char magic[EXPORT_MAGIC_LEN];
+    le_result_t result;
+
+    if ( (fd_ReadSize(fd, magic, sizeof(magic)) != sizeof(magic)) ||
+         (memcmp(magic, EXPORT_MAGIC, sizeof(magic)) != 0) )
+    {
+        result = LE_FORMAT_ERROR;
+    }
+    else
+    {
+        while ((result = ImportItem(fd)) == LE_OK)
+        {
+            (*numItemsPtr)++;
+            le_wdogChain_Kick(0);
+        }
+
+        if (result == LE_OUT_OF_RANGE)
+        {
+            result = LE_OK;
+        }
+    }
+
+    fd_Close(fd);
+
+    return result;
+#else
+    if (fd >= 0)
+    {
+        fd_Close(fd);
+    }
+
+    return LE_UNSUPPORTED;
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Copy the meta file to the specified path.
@@ -1658,6 +2650,8 @@ le_result_t secStoreAdmin_CopyMetaTo
 )
 {
 #if (SECSTOREADMIN == 1)
+    FlushCache(NULL);
+
     return pa_secStore_CopyMetaTo(path);
 #else
     return LE_UNSUPPORTED;
@@ -1695,6 +2689,9 @@ le_result_t secStoreAdmin_Delete
         return LE_FAULT;
     }
 
+    // The cached items may be deleted.
+    ClearCache();
+
     // Delete the item from the secure storage.
     return pa_secStore_Delete(path);
 #else
@@ -1741,6 +2738,9 @@ le_result_t secStoreAdmin_GetSize
         return LE_FAULT;
     }
 
+    // The deferred writes need to be in the secure storage to be accounted.
+    FlushCache(NULL);
+
     // Delete the item from the secure storage.
     size_t size = 0;
     le_result_t result = pa_secStore_GetSize(path, &size);
@@ -1808,10 +2808,34 @@ COMPONENT_INIT
 
     SystemIndexPool = le_mem_CreatePool("SystemIndexPool", sizeof(SystemsIndex_t));
 
+    ClientPool = le_mem_CreatePool("ClientPool", sizeof(Client_t));
+    ClientMap = le_hashmap_Create("ClientMap",
+                                  CLIENT_MAP_SIZE,
+                                  le_hashmap_HashVoidPointer,
+                                  le_hashmap_EqualsVoidPointer);
+
+    CacheItemPool = le_mem_CreatePool("CacheItemPool", sizeof(CacheItem_t));
+    le_mem_ExpandPool(CacheItemPool, CACHE_MAX_ITEMS);
+    CacheMap = le_hashmap_Create("CacheMap",
+                                 CACHE_MAX_ITEMS,
+                                 le_hashmap_HashString,
+                                 le_hashmap_EqualsString);
+
+    le_clk_Time_t flushDelay = { .sec = FLUSH_DELAY_SEC };
+    FlushTimerRef = le_timer_Create("SecStoreFlush");
+    le_timer_SetInterval(FlushTimerRef, flushDelay);
+    le_timer_SetHandler(FlushTimerRef, FlushTimerHandler);
+
     // Register a handler that will clean up client specific data when clients disconnect.
     le_msg_AddServiceCloseHandler(secStoreAdmin_GetServiceRef(),
                                   CleanupClientIterators,
                                   NULL);
+    le_msg_AddServiceCloseHandler(le_secStore_GetServiceRef(),
+                                  CleanupClient,
+                                  NULL);
+    le_msg_AddServiceCloseHandler(secStoreGlobal_GetServiceRef(),
+                                  CleanupClient,
+                                  NULL);
 
     // Try to kick a couple of times before each timeout.
     le_clk_Time_t watchdogInterval = { .sec = MS_WDOG_INTERVAL };
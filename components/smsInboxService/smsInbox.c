@@ -2,18 +2,29 @@
 /**
  *  SMS Inbox Server
  *
- * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to a
- * specific folder (SMSINBOX_PATH/MSG_PATH).
- *
- * Each SMS is copied into a dedicated file (named with a unique message identifier). The data
- * are stored using the Jannsson representation: Each data (imsi, SMS format, message length,
- * text/pdu, sender telephone number, timestamp, read/unread) are recorded with a key to retrieve
- * each value.
- *
- * Each application using the SMS Inbox Server possesses a configuration file in
- * SMSINBOX_PATH/CONF_PATH directory (also encoding using Jansson format): this file is used to
- * store the message identifier contained in the application mailbox. It is updated each time is new
- * SMS is received.
+ * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to the
+ * SMS Inbox store (SMSINBOX_PATH/STORE_FILE).
+ *
+ * The store is a single append-only file made of checksummed records:
+ *  - a message record holds all the data of a message (imsi, SMS format, message length,
+ *    text/binary/pdu, sender telephone number, timestamp) and the message box bitmaps telling in
+ *    which message boxes it is, and for which ones it is unread,
+ *  - a state record holds new message box bitmaps for a message, when it is read, marked unread
+ *    or deleted from a message box. A message deleted from all the message boxes is gone,
+ *  - a message box record tells which message box a bit of the bitmaps stands for.
+ *
+ * The store is read once at startup to build an in-memory index of the messages, sorted by message
+ * identifier, with the offset of their record and their bitmaps. Browsing, checking and updating
+ * the messages of a message box only uses this index, and reading a message is one read of its
+ * record. A record torn by a power cut is dropped when the store is read.
+ *
+ * When deleted messages and old states take more room than the messages themselves, the store is
+ * compacted: the live messages are written to a new file which atomically replaces the store (see
+ * @ref c_atomFile), so that a power cut leaves either the old or the new store.
+ *
+ * Former versions stored each SMS in a Jansson file in SMSINBOX_PATH/MSG_PATH, and the message
+ * identifiers of each message box in a Jansson file in SMSINBOX_PATH/CONF_PATH. These files are
+ * moved to the store and deleted.
  *
  *  Copyright (C) Sierra Wireless Inc.
  */
@@ -44,19 +55,20 @@
 #else
 #define SMSINBOX_PATH "/tmp/smsInbox/"
 #endif
-#define MSG_PATH "msg/"
-#define CONF_PATH "cfg/"
+#define STORE_FILE "store.dat"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * File extension definition.
+ * Directories and file extension of the former Jansson files.
  */
 //--------------------------------------------------------------------------------------------------
+#define MSG_PATH "msg/"
+#define CONF_PATH "cfg/"
 #define FILE_EXTENSION ".json"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Json keys.
+ * Json keys of the former Jansson files.
  */
 //--------------------------------------------------------------------------------------------------
 #define JSON_FORMAT "format"
@@ -71,6 +83,14 @@
 #define JSON_ISDELETED "isDeleted"
 #define JSON_MSGINBOX "msgInBox"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store file identification.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STORE_MAGIC   0x42534D53U
+#define STORE_VERSION 1
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum number of user applications.
@@ -94,17 +114,32 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum length of message box configuration path.
+ * Maximum number of messages in the store: each message is in at least one message box.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_MBOX_CONFIG_PATH_LEN 100
+#define MAX_STORE_MSG     (MAX_APPS * MAX_MBOX_SIZE)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of the data of a message (the largest of a text, binary or PDU message).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_DATA_BYTES    LE_SMS_PDU_MAX_BYTES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The store is compacted when it holds more than this number of bytes of deleted messages and old
+ * states, and more of them than of live messages.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_GARBAGE_BYTES (16 * 1024)
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of Message List objects we expect to have at one time.
+ * Maximum length of message box configuration path.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_NUM_OF_LIST    MAX_APPS
+#define MAX_MBOX_CONFIG_PATH_LEN 100
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -133,46 +168,129 @@ typedef uint32_t MessageId_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Browsing structure.
+ * Message box bitmap: bit i stands for the message box Apps[i].
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef uint32_t MboxMask_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store record types.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    RECORD_MBOX    = 1,     ///< Message box name, for a bit of the next bitmaps (MboxRecord_t)
+    RECORD_MESSAGE = 2,     ///< New message (MsgBuffer_t)
+    RECORD_STATE   = 3      ///< New bitmaps of a message (StateRecord_t)
+}
+RecordType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store file header.
  *
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    json_t* jsonObjPtr;
-    json_t* jsonArrayPtr;
-    uint32_t currentMessageIndex;
-    uint32_t maxIndex;
+    uint32_t magic;         ///< STORE_MAGIC
+    uint32_t version;       ///< STORE_VERSION
 }
-BrowseCtx_t;
+StoreHeader_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Entry description structure.
+ * Store record header, followed by the record payload.
  *
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    enum
-    {
-        DESC_INT,
-        DESC_STRING,
-        DESC_BOOL
-    }                               type;       ///< Union type (string or integer
-    union
-    {
-        struct
-        {
-            char*   strPtr;                     ///< String
-            size_t  lenStr;                     ///< Length of the string
-        }                  str;                 ///< Value for string
-        uint32_t           val;                 ///< Value for integer
-        bool               boolVal;             ///< Boolean value
-    }                               uVal;       ///< Union type
+    uint16_t type;          ///< Record type
+    uint16_t len;           ///< Payload length in bytes
+    uint32_t crc;           ///< CRC32 of the type, length and payload
+}
+RecordHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box record payload.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t bit;                           ///< Bit standing for the message box
+    char     name[LE_SMSINBOX_MAILBOX_LEN + 1]; ///< Message box name
+}
+MboxRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message record payload.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MessageId_t id;                                     ///< Message identifier
+    MboxMask_t  mboxMask;                               ///< Message boxes holding the message
+    MboxMask_t  unreadMask;                             ///< Message boxes where it is unread
+    uint32_t    msgLen;                                 ///< Message length
+    int32_t     format;                                 ///< Message format
+    uint32_t    dataLen;                                ///< Length of data in bytes
+    char        imsi[LE_SIM_IMSI_BYTES];                ///< IMSI of the receiver SIM
+    char        tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];    ///< Sender telephone number
+    char        timestamp[LE_SMS_TIMESTAMP_MAX_BYTES];  ///< Message time stamp
+    uint8_t     data[MAX_DATA_BYTES];                   ///< Text (without '\0'), binary or PDU
+}
+MsgBuffer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State record payload.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MessageId_t id;         ///< Message identifier
+    MboxMask_t  mboxMask;   ///< Message boxes holding the message (0 if deleted)
+    MboxMask_t  unreadMask; ///< Message boxes where the message is unread
+}
+StateRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry of a message in the store.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MessageId_t     id;         ///< Message identifier
+    uint32_t        offset;     ///< Offset of the message record in the store file
+    MboxMask_t      mboxMask;   ///< Message boxes holding the message
+    MboxMask_t      unreadMask; ///< Message boxes where the message is unread
+    uint16_t        dataLen;    ///< Length of the message data
+    le_sms_Format_t format;     ///< Message format
 }
-EntryDesc_t;
+IndexEntry_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Browsing structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MessageId_t currentMessageId;   ///< Last message returned by GetFirst/GetNext (0 if none)
+}
+BrowseCtx_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -336,1202 +454,1429 @@ static le_ref_MapRef_t ActivationRequestRefMap;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a boolean value of a key in a Jason object
- *
+ * Store file descriptor (opened in append mode), -1 if the store can't be used.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddBooleanKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    bool value          ///<[IN] Value to be added
-)
-{
-    json_t *jsonBoolPtr;
-    int ret = -1;
-
-    if ( value == true )
-    {
-        jsonBoolPtr = json_true();
-    }
-    else
-    {
-        jsonBoolPtr = json_false();
-    }
-
-    if (jsonBoolPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonBoolPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
+static int StoreFd = -1;
 
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the store file, and size of its live message records.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t StoreSize;
+static uint32_t StoreLiveSize;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the messages in the store, sorted by message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static IndexEntry_t Index[MAX_STORE_MSG];
+static uint32_t IndexCount;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add an integer value of a key in a Jason object
- *
+ * Get the bit standing for a message box in the message box bitmaps.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddIntegerKeyInJsonObject
+static MboxMask_t GetMboxBit
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    int  value          ///<[IN] Value to be added
+    const MboxCtx_t* mboxCtxPtr    ///<[IN] message box
 )
 {
-    json_t *jsonIntPtr = json_integer(value);
-    int ret = -1;
-
-    if (jsonIntPtr)
-    {
-        if (json_is_array(jsonObjPtr))
-        {
-            ret = json_array_append_new(jsonObjPtr, jsonIntPtr);
-        }
-        else
-        {
-            ret = json_object_set_new(jsonObjPtr, key, jsonIntPtr);
-        }
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
+    return (MboxMask_t)1 << (mboxCtxPtr - Apps);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a string value of a key in a Jason object
- *
+ * Get the payload length of a message record.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddStringKeyInJsonObject
+static uint32_t GetMsgPayloadLen
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    char* string        ///<[IN] String to be added
+    uint32_t dataLen    ///<[IN] Length of the message data
 )
 {
-    json_t * jsonStrPtr = json_string(string);
-    int ret = -1;
-
-    if (jsonStrPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonStrPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
+    return offsetof(MsgBuffer_t, data) + dataLen;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the SMSInbox directory path length
- *
+ * Get the size in the store of the record of an indexed message.
  */
 //--------------------------------------------------------------------------------------------------
-static uint32_t GetSMSInboxMessagePathLen
+static uint32_t GetMsgRecordSize
 (
-    void
+    const IndexEntry_t* entryPtr    ///<[IN] Index entry of the message
 )
 {
-    return 2*sizeof(MessageId_t)+strlen(SMSINBOX_PATH)+strlen(MSG_PATH)+strlen(FILE_EXTENSION)+1;
+    return sizeof(RecordHeader_t) + GetMsgPayloadLen(entryPtr->dataLen);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the SMSInbox file path
- *
+ * Compute the CRC of a record.
  */
 //--------------------------------------------------------------------------------------------------
-static void GetSMSInboxMessagePath
+static uint32_t ComputeRecordCrc
 (
-    MessageId_t messageId,  ///[IN] message identifier
-    char* pathPtr,          ///<[OUT] path of the messageId file
-    uint32_t pathLen        ///<[IN] Length of pathPtr
+    const RecordHeader_t* headerPtr,    ///<[IN] Record header (type and length)
+    const void* payloadPtr              ///<[IN] Record payload
 )
 {
-    snprintf(pathPtr, pathLen, "%s%s%08x%s", SMSINBOX_PATH, MSG_PATH,
-                                            (int) messageId,
-                                            FILE_EXTENSION);
+    le_crc_Buffer_t buffers[] =
+    {
+        { (const uint8_t*) headerPtr, offsetof(RecordHeader_t, crc) },
+        { payloadPtr, headerPtr->len },
+    };
+
+    return le_crc_Crc32Buffers(buffers, NUM_ARRAY_MEMBERS(buffers), LE_CRC_START_CRC32);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the SMSInbox configuration path length
+ * Write a buffer to a file, going on after interruptions.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
  */
 //--------------------------------------------------------------------------------------------------
-static uint32_t GetSMSInboxConfigPathLen
+static le_result_t WriteAll
 (
-    char* appNamePtr    ///<[IN] Application name
+    int fd,                 ///<[IN] File descriptor
+    const void* bufPtr,     ///<[IN] Buffer to write
+    size_t size             ///<[IN] Number of bytes to write
 )
 {
-    return strlen(appNamePtr)+strlen(SMSINBOX_PATH)+strlen(CONF_PATH)+strlen(FILE_EXTENSION)+1;
+    const uint8_t* restPtr = bufPtr;
+
+    while (size > 0)
+    {
+        ssize_t writtenSize = write(fd, restPtr, size);
+
+        if (writtenSize < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Write error: %m");
+            return LE_FAULT;
+        }
+
+        size -= writtenSize;
+        restPtr += writtenSize;
+    }
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the application's box file descriptor path
+ * Write a record to a file, in one write.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
  */
 //--------------------------------------------------------------------------------------------------
-static void GetSMSInboxConfigPath
+static le_result_t WriteRecord
 (
-    char* appNamePtr,   ///<[IN] Application name
-    char* pathPtr,      ///<[OUT] configuration file path
-    uint32_t pathLen    ///<[IN] path length
+    int fd,                     ///<[IN] File descriptor
+    RecordType_t type,          ///<[IN] Record type
+    const void* payloadPtr,     ///<[IN] Record payload
+    uint32_t len                ///<[IN] Payload length
 )
 {
-    snprintf(pathPtr, pathLen, "%s%s%s%s", SMSINBOX_PATH, CONF_PATH, appNamePtr, FILE_EXTENSION);
+    uint8_t buffer[sizeof(RecordHeader_t) + sizeof(MsgBuffer_t)];
+    RecordHeader_t* headerPtr = (RecordHeader_t*) buffer;
+
+    LE_ASSERT(len <= sizeof(MsgBuffer_t));
+
+    headerPtr->type = type;
+    headerPtr->len = len;
+    headerPtr->crc = ComputeRecordCrc(headerPtr, payloadPtr);
+    memcpy(buffer + sizeof(RecordHeader_t), payloadPtr, len);
+
+    return WriteAll(fd, buffer, sizeof(RecordHeader_t) + len);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify Json object
+ * Append a record to the store. The record is on the storage device when this function returns
+ * successfully.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyJsonObj
+static le_result_t AppendRecord
 (
-    json_t* jsonObjPtr,         ///<[IN] Json object (root object)
-    json_t* jsonValPtr,         ///<[IN] Json value to be modified
-    char*   key,                ///<[IN] Key to modify
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    RecordType_t type,          ///<[IN] Record type
+    const void* payloadPtr,     ///<[IN] Record payload
+    uint32_t len,               ///<[IN] Payload length
+    uint32_t* offsetPtr         ///<[OUT] Offset of the record in the store (can be NULL)
 )
 {
-    int res = 0;
-
-    if (jsonValPtr == NULL)
+    if (StoreFd < 0)
     {
-        LE_ERROR("NULL jsonValPtr");
+        LE_ERROR("SMS Inbox store not available");
         return LE_FAULT;
     }
 
-    switch (modifPtr->type)
+    if ((WriteRecord(StoreFd, type, payloadPtr, len) != LE_OK) || (fdatasync(StoreFd) != 0))
     {
-        case DESC_STRING:
-            // check the type
-            if (json_is_string(jsonValPtr) == false)
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_string_set(jsonValPtr, modifPtr->uVal.str.strPtr);
-            }
-        break;
-        case DESC_INT:
-            // check the type
-            if (json_is_integer(jsonValPtr) == false )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
+        LE_ERROR("Unable to append record to the SMS Inbox store: %m");
 
-            if ( res == 0 )
-            {
-                res = json_integer_set(jsonValPtr, modifPtr->uVal.val);
-            }
-        break;
-        case DESC_BOOL:
-            // check the type
-            if ( (json_is_true(jsonValPtr) != true) && (json_is_false(jsonValPtr) != true) )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if (( res == 0 ) &&
-                (AddBooleanKeyInJsonObject(jsonObjPtr, key, modifPtr->uVal.boolVal) != LE_OK))
-            {
-                res = -1;
-            }
-        break;
-        default:
-            res = -1;
-        break;
-    }
-
-    if (res < 0)
-    {
-        LE_ERROR(("Update error %d"), modifPtr->type);
+        // Drop any part of the record which could have been written
+        if (ftruncate(StoreFd, StoreSize) != 0)
+        {
+            LE_ERROR("Unable to truncate the SMS Inbox store: %m");
+        }
         return LE_FAULT;
     }
-    else
+
+    if (offsetPtr)
     {
-        LE_DEBUG("ModifyJsonObj OK");
-        return LE_OK;
+        *offsetPtr = StoreSize;
     }
+    StoreSize += sizeof(RecordHeader_t) + len;
 
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify message file
+ * Read and check a record of a file.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OUT_OF_RANGE if there is no record at this offset (end of the file)
+ *      - LE_FAULT if the record is truncated or corrupted
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyMsgEntry
+static le_result_t ReadRecord
 (
-    MessageId_t messageId,      ///<[IN] Message identifier to be modified
-    char* keyPtr[],              ///<[IN] Key to modify
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    int fd,                     ///<[IN] File descriptor
+    uint32_t offset,            ///<[IN] Offset of the record
+    RecordHeader_t* headerPtr,  ///<[OUT] Record header
+    void* payloadPtr,           ///<[OUT] Record payload
+    uint32_t payloadSize        ///<[IN] Size of the payload buffer
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res;
-    int indexKey = -1;
+    ssize_t readSize;
 
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    LE_DEBUG("ModifyMsgEntry: messageId %d, path %s",messageId, path);
-
-    json_t* jsonRootPtr = json_load_file(path, 0, &error);
-
-    if ( jsonRootPtr == NULL )
+    do
     {
-        LE_ERROR("Json decoder error %s", error.text);
-        return LE_FAULT;
+        readSize = pread(fd, headerPtr, sizeof(RecordHeader_t), offset);
     }
+    while ((readSize < 0) && (EINTR == errno));
 
-    json_t* jsonValPtr = jsonRootPtr;
-    json_t* jsonSubObjPtr = jsonRootPtr;
-
-    while ( ( json_is_object(jsonValPtr) == true ) && ( nbKey > indexKey ) )
+    if (0 == readSize)
     {
-        indexKey++;
-        jsonSubObjPtr = jsonValPtr;
-        jsonValPtr = json_object_get(jsonSubObjPtr, keyPtr[indexKey]);
+        return LE_OUT_OF_RANGE;
     }
 
-    if ( !jsonValPtr )
-    {
-        if ((indexKey > -1) && (indexKey < nbKey))
-        {
-            LE_ERROR("Unable to get the object %s", keyPtr[indexKey]);
-        }
-        else
-        {
-            LE_ERROR("IndexKey: %d is out of range", indexKey);
-        }
-
-        res = LE_FAULT;
-    }
-    else
+    if ((readSize != sizeof(RecordHeader_t)) || (headerPtr->len > payloadSize))
     {
-        if ((indexKey > -1) && (indexKey < nbKey))
-        {
-            res = ModifyJsonObj(jsonSubObjPtr, jsonValPtr, keyPtr[indexKey], modifPtr);
-        }
-        else
-        {
-            LE_ERROR("IndexKey: %d is out of range", indexKey);
-            res = LE_FAULT;
-        }
+        return LE_FAULT;
     }
 
-    if ( res == LE_OK )
+    do
     {
-        if (json_dump_file(jsonRootPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0)
-        {
-            LE_ERROR("Json error");
-            res = LE_FAULT;
-        }
+        readSize = pread(fd, payloadPtr, headerPtr->len, offset + sizeof(RecordHeader_t));
     }
-    else
+    while ((readSize < 0) && (EINTR == errno));
+
+    if ((readSize != headerPtr->len) || (headerPtr->crc != ComputeRecordCrc(headerPtr, payloadPtr)))
     {
-        LE_ERROR("Something was wrong in ModifyJsonObj");
+        return LE_FAULT;
     }
 
-    json_decref(jsonRootPtr);
-
-    return res;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Json object
+ * Read the message record of an indexed message.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ReadJsonObj
+static le_result_t ReadMessage
 (
-    json_t* jsonValPtr,         ///<[IN] Json value to be read
-    char* keyPtr[],             ///<[IN] Key to read
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr     ///<[OUT] Decoding result
+    const IndexEntry_t* entryPtr,   ///<[IN] Index entry of the message
+    MsgBuffer_t* msgPtr             ///<[OUT] Message
 )
 {
-    le_result_t res = LE_OK;
+    RecordHeader_t header;
 
-    if ( jsonValPtr == NULL )
+    if ((ReadRecord(StoreFd, entryPtr->offset, &header, msgPtr, sizeof(MsgBuffer_t)) != LE_OK) ||
+        (header.type != RECORD_MESSAGE) || (msgPtr->id != entryPtr->id))
     {
-        LE_ERROR("No information");
+        LE_ERROR("Unable to read message %08x from the SMS Inbox store", (int) entryPtr->id);
         return LE_FAULT;
     }
 
-    switch json_typeof(jsonValPtr)
-    {
-        case JSON_STRING:
-        {
-            if ( decodePtr->type != DESC_STRING )
-            {
-                LE_ERROR("Bad format %d", decodePtr->type);
-                res = LE_FAULT;
-            }
-
-            if (res == LE_OK)
-            {
-                const char* strPtr = json_string_value((const json_t *)jsonValPtr);
+    // Strings are checked here, so that they can be used as is
+    msgPtr->imsi[sizeof(msgPtr->imsi) - 1] = '\0';
+    msgPtr->tel[sizeof(msgPtr->tel) - 1] = '\0';
+    msgPtr->timestamp[sizeof(msgPtr->timestamp) - 1] = '\0';
 
-                if ( strlen(strPtr) >= decodePtr->uVal.str.lenStr )
-                {
-                    LE_ERROR("String too long");
-                    res = LE_OVERFLOW;
-                }
-                else
-                {
-                    strncpy(decodePtr->uVal.str.strPtr, strPtr, decodePtr->uVal.str.lenStr);
-                    decodePtr->uVal.str.lenStr = strlen(strPtr);
-                }
-            }
-        }
-        break;
-        case JSON_INTEGER:
-        {
-            if ( decodePtr->type != DESC_INT )
-            {
-                LE_ERROR("Bad format %d", decodePtr->type);
-                res = LE_FAULT;
-            }
-            else
-            {
-                decodePtr->uVal.val = json_integer_value((const json_t *)jsonValPtr);
-            }
-        }
-        break;
-        case JSON_TRUE:
-        case JSON_FALSE:
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the position in the index of the first message whose identifier is not lower than a given
+ * one.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FindIndexPosition
+(
+    MessageId_t messageId   ///<[IN] Message identifier
+)
+{
+    uint32_t low = 0;
+    uint32_t high = IndexCount;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (Index[middle].id < messageId)
         {
-            if ( decodePtr->type != DESC_BOOL )
-            {
-                LE_ERROR("Bad format %d", decodePtr->type);
-                res = LE_FAULT;
-            }
-            else
-            {
-                decodePtr->uVal.boolVal = json_is_true((const json_t *)jsonValPtr);
-            }
+            low = middle + 1;
         }
-        break;
-        case JSON_OBJECT:
+        else
         {
-            // if key-value is an object, read the next key
-            if (nbKey >= 1)
-            {
-                json_t* jsonSubValPtr = json_object_get(jsonValPtr, keyPtr[0]);
-
-                if ( jsonSubValPtr )
-                {
-                    res = ReadJsonObj(jsonSubValPtr, &keyPtr[1], nbKey-1,  decodePtr );
-                }
-                else
-                {
-                    LE_ERROR("Bad format");
-                    res = LE_FAULT;
-                }
-            }
-            else
-            {
-                LE_ERROR("Key error");
-                res = LE_FAULT;
-            }
+            high = middle;
         }
-        break;
-        case JSON_ARRAY:
-        case JSON_REAL:
-        case JSON_NULL:
-        default:
-            LE_ERROR("Bad json_typeof");
-            res = LE_FAULT;
-        break;
     }
 
-    return res;
+    return low;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Application's config file
+ * Look up a message in the index.
  *
+ * @return The index entry of the message, NULL if it is not in the store.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetMsgListFromMbox
+static IndexEntry_t* LookupMessage
 (
-    char* pathPtr,              ///<[IN] Application's config file path
-    json_t **jsonRootObjPtr,    ///<[OUT] json root object
-    json_t **jsonArrayPtr       ///<[OUT] messages in box list
+    MessageId_t messageId   ///<[IN] Message identifier
 )
 {
-    json_error_t error;
-    *jsonRootObjPtr = json_load_file(pathPtr, 0, &error);
+    uint32_t position = FindIndexPosition(messageId);
 
-    if ( !(*jsonRootObjPtr) )
+    if ((position < IndexCount) && (Index[position].id == messageId))
     {
-        // File doesn't exist, create objects
-        *jsonRootObjPtr = json_object();
-
-        if ( !(*jsonRootObjPtr) )
-        {
-            LE_ERROR("Json error");
-            return LE_FAULT;
-        }
+        return &Index[position];
     }
 
-    *jsonArrayPtr = json_object_get(*jsonRootObjPtr, JSON_MSGINBOX);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a message of a message box in the index.
+ *
+ * @return The index entry of the message, NULL if it is not in the message box.
+ */
+//--------------------------------------------------------------------------------------------------
+static IndexEntry_t* LookupMboxMessage
+(
+    const MboxCtx_t* mboxCtxPtr,    ///<[IN] Message box
+    MessageId_t messageId           ///<[IN] Message identifier
+)
+{
+    IndexEntry_t* entryPtr = LookupMessage(messageId);
 
-    if ( !(*jsonArrayPtr) )
+    if ((NULL == entryPtr) || !(entryPtr->mboxMask & GetMboxBit(mboxCtxPtr)))
     {
-        // Array doesn't exist, create it
-        *jsonArrayPtr = json_array();
+        LE_ERROR("Bad msg id or mbox name");
+        return NULL;
+    }
 
-        if (!(*jsonArrayPtr))
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("Json error");
-            return LE_FAULT;
-        }
+    return entryPtr;
+}
 
-        if ( json_object_set(*jsonRootObjPtr, JSON_MSGINBOX, *jsonArrayPtr) < 0 )
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the first message of a message box with an identifier not lower than a given one.
+ *
+ * @return The message identifier, 0 if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+static MessageId_t FindMboxMessage
+(
+    const MboxCtx_t* mboxCtxPtr,    ///<[IN] Message box
+    MessageId_t messageId           ///<[IN] Lowest message identifier
+)
+{
+    MboxMask_t mboxBit = GetMboxBit(mboxCtxPtr);
+    uint32_t position;
+
+    for (position = FindIndexPosition(messageId); position < IndexCount; position++)
+    {
+        if (Index[position].mboxMask & mboxBit)
         {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("Json error");
-            return LE_FAULT;
+            return Index[position].id;
         }
     }
 
-    return LE_OK;
+    return 0;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove a message from the application's cfg file
+ * Add a new message entry in the index, at its sorted position.
  *
+ * @return The new index entry, NULL if the message is already indexed or the index is full.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t DeleteMsgInAppCfg
+static IndexEntry_t* AddIndexEntry
 (
-    char *appNamePtr,               ///<[IN] application name
-    MessageId_t deleteMessageId     ///<[IN] message to delete
+    MessageId_t messageId   ///<[IN] Message identifier
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
-    json_t *jsonObjPtr;
-    json_t *jsonArrayPtr;
+    uint32_t position = FindIndexPosition(messageId);
 
-    LE_DEBUG("DeleteMessageId %d, path %s",deleteMessageId, path);
+    if ((position < IndexCount) && (Index[position].id == messageId))
+    {
+        LE_ERROR("Message %08x already in the SMS Inbox store", (int) messageId);
+        return NULL;
+    }
 
-    if (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK)
+    if (IndexCount == MAX_STORE_MSG)
     {
-       LE_ERROR("No message");
-       return LE_FAULT;
+        LE_ERROR("SMS Inbox store full");
+        return NULL;
     }
 
+    memmove(&Index[position + 1], &Index[position], (IndexCount - position) * sizeof(Index[0]));
+    IndexCount++;
+
+    memset(&Index[position], 0, sizeof(Index[0]));
+    Index[position].id = messageId;
+
+    return &Index[position];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the message box bitmaps of an indexed message, updating the message counts of the message
+ * boxes. The message is removed from the index if it isn't in any message box anymore.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetIndexEntryMasks
+(
+    IndexEntry_t* entryPtr,     ///<[IN] Index entry of the message
+    MboxMask_t mboxMask,        ///<[IN] Message boxes holding the message
+    MboxMask_t unreadMask       ///<[IN] Message boxes where the message is unread
+)
+{
     int i;
-    MessageId_t messageId;
 
-    for (i=0; i < json_array_size(jsonArrayPtr); i++)
+    for (i = 0; i < MAX_APPS; i++)
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
+        MboxMask_t mboxBit = GetMboxBit(&Apps[i]);
 
-        if (jsonIntegerPtr)
+        if ((entryPtr->mboxMask & mboxBit) && !(mboxMask & mboxBit))
         {
-            messageId = json_integer_value(jsonIntegerPtr);
-
-            if (messageId == deleteMessageId)
-            {
-                LE_DEBUG("Remove %d", (int) messageId);
-                json_array_remove(jsonArrayPtr, i);
-            }
+            Apps[i].msgCount--;
         }
-        else
+        else if (!(entryPtr->mboxMask & mboxBit) && (mboxMask & mboxBit))
         {
-            LE_ERROR("Json error");
+            Apps[i].msgCount++;
         }
     }
 
-    le_result_t res = LE_OK;
-    if ( json_dump_file(jsonObjPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
+    entryPtr->mboxMask = mboxMask;
+    entryPtr->unreadMask = unreadMask & mboxMask;
+
+    if (0 == mboxMask)
     {
-        res = LE_FAULT;
-        LE_ERROR("Json_dump_file error");
-    }
+        LE_DEBUG("Delete messageId %d", (int) entryPtr->id);
 
-    json_decref(jsonObjPtr);
+        StoreLiveSize -= GetMsgRecordSize(entryPtr);
 
-    return res;
+        IndexCount--;
+        memmove(entryPtr, entryPtr + 1, (&Index[IndexCount] - entryPtr) * sizeof(Index[0]));
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if a message belongs to a message box
+ * Fill the record of a message box, telling that its bit in the bitmaps is its index in Apps.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the message box name is too long
  */
 //--------------------------------------------------------------------------------------------------
-
-static le_result_t CheckMessageIdInMbox
+static le_result_t FillMboxRecord
 (
-    char* mboxName,
-    MessageId_t messageId
+    int mboxIdx,                ///<[IN] Index of the message box in Apps
+    MboxRecord_t* mboxPtr,      ///<[OUT] Message box record
+    uint32_t* lenPtr            ///<[OUT] Payload length
 )
 {
-    json_t *jsonRootObjPtr;
-    json_t *jsonArrayPtr;
-    uint32_t pathLen = GetSMSInboxConfigPathLen(mboxName);
-    char path[pathLen];
-    GetSMSInboxConfigPath(mboxName, path, pathLen);
+    memset(mboxPtr, 0, sizeof(MboxRecord_t));
+    mboxPtr->bit = mboxIdx;
 
-    if ( GetMsgListFromMbox(path, &jsonRootObjPtr, &jsonArrayPtr) != LE_OK )
+    if (le_utf8_Copy(mboxPtr->name, Apps[mboxIdx].namePtr, sizeof(mboxPtr->name), NULL) != LE_OK)
     {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return LE_FAULT;
+        LE_ERROR("Message box name too long: %s", Apps[mboxIdx].namePtr);
+        return LE_OVERFLOW;
     }
 
-    int i = 0;
+    *lenPtr = offsetof(MboxRecord_t, name) + strlen(mboxPtr->name);
+    return LE_OK;
+}
 
-    while (i < json_array_size(jsonArrayPtr))
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the store header and the message box records to a new store file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteStoreHeader
+(
+    int fd,                 ///<[IN] File descriptor
+    uint32_t* sizePtr       ///<[OUT] Number of bytes written
+)
+{
+    StoreHeader_t header = { .magic = STORE_MAGIC, .version = STORE_VERSION };
+    int i;
+
+    if (WriteAll(fd, &header, sizeof(header)) != LE_OK)
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-        MessageId_t msgId = 0;
+        return LE_FAULT;
+    }
+    *sizePtr = sizeof(header);
 
-        if (jsonIntegerPtr)
-        {
-            msgId = json_integer_value(jsonIntegerPtr);
-        }
-        else
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        if (Apps[i].namePtr)
         {
-            LE_ERROR("Json error");
-            json_decref(jsonRootObjPtr);
-            return LE_FAULT;
-        }
+            MboxRecord_t mbox;
+            uint32_t len;
 
-        LE_DEBUG("MessageId %d, msgId %d, i %d", messageId, msgId, i);
-        if (msgId == messageId)
-        {
-            json_decref(jsonRootObjPtr);
-            return LE_OK;
+            if ((FillMboxRecord(i, &mbox, &len) != LE_OK) ||
+                (WriteRecord(fd, RECORD_MBOX, &mbox, len) != LE_OK))
+            {
+                return LE_FAULT;
+            }
+            *sizePtr += sizeof(RecordHeader_t) + len;
         }
-
-        i++;
     }
 
-    LE_ERROR("Bad msg id or mbox name");
-    json_decref(jsonRootObjPtr);
-    return LE_FAULT;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Decode message file
+ * Compact the store: write the live messages to a new store file which atomically replaces the
+ * current one.
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure (the current store is kept)
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t DecodeMsgEntry
+static le_result_t CompactStore
 (
-    char* mboxName,                      ///<[IN] mbox name
-    MessageId_t messageId,               ///<[IN] Message identifier to decode
-    char* keyPtr[],                      ///<[IN] Key to retrieve
-    uint8_t nbKey,                       ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr              ///<[IN/OUT] Decoding result
+    void
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res = LE_OK;
+    static uint32_t newOffsets[MAX_STORE_MSG];
+    static MsgBuffer_t msg;
+    uint32_t newSize;
+    uint32_t i;
 
-    GetSMSInboxMessagePath(messageId, path, pathLen);
+    LE_INFO("Compact the SMS Inbox store: %u bytes, %u of live messages",
+            StoreSize, StoreLiveSize);
 
-    json_t* jsonRootPtr = json_load_file(path, JSON_REJECT_DUPLICATES, &error);
+    int fd = le_atomFile_Create(SMSINBOX_PATH STORE_FILE,
+                                LE_FLOCK_WRITE,
+                                LE_FLOCK_REPLACE_IF_EXIST,
+                                S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LE_ERROR("Unable to create the new SMS Inbox store");
+        return LE_FAULT;
+    }
 
-    if ( jsonRootPtr == NULL )
+    if (WriteStoreHeader(fd, &newSize) != LE_OK)
     {
-        LE_ERROR("Json decoder error %s mboxName %s", error.text, mboxName);
-        DeleteMsgInAppCfg(mboxName, messageId);
+        le_atomFile_Cancel(fd);
         return LE_FAULT;
     }
 
-    res = ReadJsonObj(jsonRootPtr, keyPtr, nbKey, decodePtr);
+    for (i = 0; i < IndexCount; i++)
+    {
+        if (ReadMessage(&Index[i], &msg) != LE_OK)
+        {
+            le_atomFile_Cancel(fd);
+            return LE_FAULT;
+        }
 
-    json_decref(jsonRootPtr);
+        msg.mboxMask = Index[i].mboxMask;
+        msg.unreadMask = Index[i].unreadMask;
 
-    return res;
+        if (WriteRecord(fd, RECORD_MESSAGE, &msg, GetMsgPayloadLen(Index[i].dataLen)) != LE_OK)
+        {
+            le_atomFile_Cancel(fd);
+            return LE_FAULT;
+        }
+
+        newOffsets[i] = newSize;
+        newSize += GetMsgRecordSize(&Index[i]);
+    }
+
+    if (le_atomFile_Close(fd) != LE_OK)
+    {
+        LE_ERROR("Unable to replace the SMS Inbox store");
+        return LE_FAULT;
+    }
+
+    // The store has been replaced: the current descriptor refers to the former file
+    close(StoreFd);
+    StoreFd = open(SMSINBOX_PATH STORE_FILE, O_RDWR | O_APPEND | O_CLOEXEC);
+    if (StoreFd < 0)
+    {
+        LE_ERROR("Unable to open the SMS Inbox store: %m");
+    }
+
+    for (i = 0; i < IndexCount; i++)
+    {
+        Index[i].offset = newOffsets[i];
+    }
+    StoreSize = newSize;
+
+    return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the store if deleted messages and old states take too much room.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStoreCompaction
+(
+    void
+)
+{
+    uint32_t garbageSize = StoreSize - StoreLiveSize;
+
+    if ((garbageSize > COMPACT_MIN_GARBAGE_BYTES) && (garbageSize > StoreLiveSize))
+    {
+        CompactStore();
+    }
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if an application requested the deletion of a message
+ * Update the message box bitmaps of a message in the store. The message is deleted when it is not
+ * in any message box anymore.
  *
+ * @note The index entry must not be used after this call.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure (the message is unchanged)
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsDeleted
+static le_result_t UpdateMessage
 (
-    MessageId_t messageId,  ///<[IN] Message identifier
-    char* appNamePtr        ///<[IN] Application name
+    IndexEntry_t* entryPtr,     ///<[IN] Index entry of the message
+    MboxMask_t mboxMask,        ///<[IN] Message boxes holding the message
+    MboxMask_t unreadMask       ///<[IN] Message boxes where the message is unread
 )
 {
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[2] = {JSON_ISDELETED, appNamePtr};
+    StateRecord_t state =
+    {
+        .id = entryPtr->id,
+        .mboxMask = mboxMask,
+        .unreadMask = unreadMask & mboxMask
+    };
 
-    if (DecodeMsgEntry(appNamePtr, messageId, key, 2, &decode) == LE_OK)
+    if ((state.mboxMask == entryPtr->mboxMask) && (state.unreadMask == entryPtr->unreadMask))
     {
-        LE_DEBUG("Decode.uVal.boolVal %d", decode.uVal.boolVal);
-        return decode.uVal.boolVal;
+        return LE_OK;
     }
-    else
+
+    if (AppendRecord(RECORD_STATE, &state, sizeof(state), NULL) != LE_OK)
     {
-        // if error, delete the message
-        return true;
+        return LE_FAULT;
     }
+
+    SetIndexEntryMasks(entryPtr, state.mboxMask, state.unreadMask);
+
+    CheckStoreCompaction();
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform the deleteion
- *
+ * Mark a message of a message box as read or unread.
  */
 //--------------------------------------------------------------------------------------------------
-static void PerformDeletion
+static void SetUnread
 (
-    MessageId_t messageId   ///<[IN] Message identifier
+    IndexEntry_t* entryPtr,         ///<[IN] Index entry of the message
+    const MboxCtx_t* mboxCtxPtr,    ///<[IN] Message box
+    bool isUnread                   ///<[IN] New status
 )
 {
-    int i;
-    bool deleted = true;
+    MboxMask_t unreadMask = entryPtr->unreadMask & ~GetMboxBit(mboxCtxPtr);
 
-    for (i=0; i < MAX_APPS; i++)
+    if (isUnread)
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            deleted &= IsDeleted(messageId, Apps[i].namePtr);
-        }
+        unreadMask |= GetMboxBit(mboxCtxPtr);
     }
 
-    // All applications mark this message to be delteted => erase physically the message
-    if (deleted)
+    if (UpdateMessage(entryPtr, entryPtr->mboxMask, unreadMask) != LE_OK)
     {
-        uint16_t pathLen = GetSMSInboxMessagePathLen();
-        char path[pathLen];
-        memset(path, 0, pathLen);
-
-        GetSMSInboxMessagePath(messageId, path, pathLen);
-
-        LE_DEBUG("Delete messageId %d, path %s",messageId, path);
-        unlink(path);
+        LE_ERROR("Unable to update message %08x", (int) entryPtr->id);
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a message in the application's cfg file
+ * Remove a message from a message box, deleting it once it is in no message box.
  *
+ * @note The index entry must not be used after this call.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddMsgInAppCfg
+static void RemoveFromMbox
 (
-    MboxCtx_t* appsPtr,         ///<[IN] application config
-    MessageId_t messageId     ///<[IN] message to add
+    IndexEntry_t* entryPtr,         ///<[IN] Index entry of the message
+    const MboxCtx_t* mboxCtxPtr     ///<[IN] Message box
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
-    char path[pathLen];
-    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
-    json_t* jsonMsgIdPtr = NULL;
-    json_t* jsonPtr;
-    json_t* jsonArrayPtr;
+    MboxMask_t mboxBit = GetMboxBit(mboxCtxPtr);
+
+    LE_DEBUG("Remove %d from %s", (int) entryPtr->id, mboxCtxPtr->namePtr);
 
-    if ( GetMsgListFromMbox (path, &jsonPtr, &jsonArrayPtr) != LE_OK )
+    if (UpdateMessage(entryPtr, entryPtr->mboxMask & ~mboxBit, entryPtr->unreadMask) != LE_OK)
     {
-        LE_ERROR("Message %s not found", path);
-        return LE_FAULT;
+        LE_ERROR("Unable to remove message %08x from %s", (int) entryPtr->id,
+                 mboxCtxPtr->namePtr);
     }
-    LE_DEBUG("Add messageId %d, path %s, array Size %zu", messageId,
-                                                          path,
-                                                          json_array_size(jsonArrayPtr) );
+}
 
-    if ( json_array_size(jsonArrayPtr) == appsPtr->inboxSize )
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make room for a new message in a message box, removing its oldest messages if it is full.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message box can't hold any message
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeRoomInMbox
+(
+    MboxCtx_t* mboxCtxPtr   ///<[IN] Message box
+)
+{
+    while (mboxCtxPtr->msgCount >= mboxCtxPtr->inboxSize)
     {
-        // delete older entry
-        jsonMsgIdPtr = json_array_get(jsonArrayPtr, 0);
-        MessageId_t messageId = 0;
+        MessageId_t oldestId = FindMboxMessage(mboxCtxPtr, 0);
+        uint32_t msgCount = mboxCtxPtr->msgCount;
 
-        if (jsonMsgIdPtr)
+        if (0 == oldestId)
         {
-            messageId = json_integer_value(jsonMsgIdPtr);
+            return LE_FAULT;
         }
 
-        if (messageId != 0)
+        RemoveFromMbox(LookupMessage(oldestId), mboxCtxPtr);
+
+        if (mboxCtxPtr->msgCount == msgCount)
         {
-            json_array_remove(jsonArrayPtr, 0);
+            return LE_FAULT;
+        }
+    }
 
-            EntryDesc_t modif;
-            modif.type = DESC_BOOL;
-            modif.uVal.boolVal = true;
-            char* key[2]={JSON_ISDELETED, appsPtr->namePtr};
+    return LE_OK;
+}
 
-            if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-            {
-                LE_ERROR("Can't modify entry %08x, path %s", (int) messageId, path);
-            }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the store, in the message boxes of its bitmap. The oldest messages of the
+ * message boxes which are full are removed from them.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_PERMITTED if no message box can hold it
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StoreMessage
+(
+    MsgBuffer_t* msgPtr     ///<[IN] Message
+)
+{
+    uint32_t offset;
+    int i;
 
-            PerformDeletion(messageId);
-        }
-        else
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        if ((msgPtr->mboxMask & GetMboxBit(&Apps[i])) && (MakeRoomInMbox(&Apps[i]) != LE_OK))
         {
-            json_decref(jsonPtr);
-            LE_ERROR("Json error");
-            return LE_FAULT;
+            LE_WARN("No room for message %08x in %s", (int) msgPtr->id, Apps[i].namePtr);
+            msgPtr->mboxMask &= ~GetMboxBit(&Apps[i]);
         }
     }
+    msgPtr->unreadMask &= msgPtr->mboxMask;
+
+    if (0 == msgPtr->mboxMask)
+    {
+        return LE_NOT_PERMITTED;
+    }
 
-    if (AddIntegerKeyInJsonObject(jsonArrayPtr, NULL, messageId) != LE_OK)
+    if ((LookupMessage(msgPtr->id) != NULL) || (IndexCount == MAX_STORE_MSG))
     {
-        json_decref(jsonPtr);
-        LE_ERROR("Json error");
+        LE_ERROR("Unable to index message %08x", (int) msgPtr->id);
         return LE_FAULT;
     }
 
-    if ( json_dump_file(jsonPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
+    if (AppendRecord(RECORD_MESSAGE, msgPtr, GetMsgPayloadLen(msgPtr->dataLen), &offset) != LE_OK)
     {
-        json_decref(jsonPtr);
-        LE_ERROR("Json error");
         return LE_FAULT;
     }
 
-    json_decref(jsonPtr);
+    IndexEntry_t* entryPtr = AddIndexEntry(msgPtr->id);
+    LE_ASSERT(entryPtr);
 
-    // Use for the first initialization
-    if (jsonArrayPtr->refcount > 0)
+    entryPtr->offset = offset;
+    entryPtr->dataLen = msgPtr->dataLen;
+    entryPtr->format = msgPtr->format;
+    StoreLiveSize += GetMsgRecordSize(entryPtr);
+    SetIndexEntryMasks(entryPtr, msgPtr->mboxMask, msgPtr->unreadMask);
+
+    if (msgPtr->id >= NextMessageId)
     {
-        json_decref(jsonArrayPtr);
+        NextMessageId = msgPtr->id + 1;
     }
 
     return LE_OK;
 }
 
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode Json file
- *
+ * Translate a bitmap read from the store into the bits of the current message boxes.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeMsgEntry
+static MboxMask_t TranslateMask
 (
-    uint32_t fd,            ///<[IN] file descriptor
-    le_sms_MsgRef_t msgRef  ///<[IN] SMS to be encoding
+    MboxMask_t storedMask,              ///<[IN] Bitmap read from the store
+    const MboxMask_t* storedBitsPtr     ///<[IN] Current bit of each bit used in the store
 )
 {
-    json_t *jsonRootPtr = json_object();
-
-    if (!jsonRootPtr)
-    {
-        LE_ERROR("Json error");
-        return LE_FAULT;
-    }
-
-    // Add imsi in json file
-    AddStringKeyInJsonObject(jsonRootPtr, JSON_IMSI, SimImsi);
-
-    // Add sms format in json file
-    le_sms_Format_t format = le_sms_GetFormat(msgRef);
-    AddIntegerKeyInJsonObject(jsonRootPtr, JSON_FORMAT, (int) format);
+    MboxMask_t mask = 0;
+    int bit;
 
-    // Unread by default for all applications
-    json_t *jsonUnreadPtr = json_object();
-    int i;
-    for (i=0; i < MAX_APPS; i++)
+    for (bit = 0; bit < MAX_APPS; bit++)
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
+        if (storedMask & ((MboxMask_t)1 << bit))
         {
-            AddBooleanKeyInJsonObject(jsonUnreadPtr, Apps[i].namePtr, true);
+            mask |= storedBitsPtr[bit];
         }
     }
 
-    json_object_set_new(jsonRootPtr, JSON_ISUNREAD, jsonUnreadPtr);
-
-    // Undeleted by default for all applications
-    json_t *jsonDeletePtr = json_object();
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonDeletePtr, Apps[i].namePtr, false);
-        }
-    }
-
-    json_object_set_new(jsonRootPtr, JSON_ISDELETED, jsonDeletePtr);
+    return mask;
+}
 
-    switch ( format )
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a record read from the store to the index.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the record is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadRecord
+(
+    const RecordHeader_t* headerPtr,    ///<[IN] Record header
+    void* payloadPtr,                   ///<[IN] Record payload
+    uint32_t offset,                    ///<[IN] Record offset
+    MboxMask_t* storedBitsPtr           ///<[IN/OUT] Current bit of each bit used in the store
+)
+{
+    switch (headerPtr->type)
     {
-        case LE_SMS_FORMAT_TEXT:
-        case LE_SMS_FORMAT_BINARY:
+        case RECORD_MBOX:
         {
-            char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
-            memset(tel, 0, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            // Add phone number
-            le_result_t result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
+            MboxRecord_t* mboxPtr = payloadPtr;
+            size_t nameLen = headerPtr->len - offsetof(MboxRecord_t, name);
+            int i;
 
-            if (result != LE_OK)
+            if ((headerPtr->len < offsetof(MboxRecord_t, name)) ||
+                (nameLen >= sizeof(mboxPtr->name)) || (mboxPtr->bit >= MAX_APPS))
             {
-                LE_ERROR("Unable to get the tel number %d", result);
+                return LE_FAULT;
             }
-            else
+            mboxPtr->name[nameLen] = '\0';
+
+            storedBitsPtr[mboxPtr->bit] = 0;
+            for (i = 0; i < MAX_APPS; i++)
             {
-                LE_DEBUG("Tel num: %s", tel);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_SENDERTEL, tel);
+                if (Apps[i].namePtr && (0 == strcmp(Apps[i].namePtr, mboxPtr->name)))
+                {
+                    storedBitsPtr[mboxPtr->bit] = GetMboxBit(&Apps[i]);
+                }
             }
+        }
+        break;
 
-            // Add timestamp
-            char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
-            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
+        case RECORD_MESSAGE:
+        {
+            MsgBuffer_t* msgPtr = payloadPtr;
 
-            if (result != LE_OK)
+            if ((headerPtr->len < offsetof(MsgBuffer_t, data)) ||
+                (headerPtr->len != GetMsgPayloadLen(msgPtr->dataLen)))
             {
-                LE_ERROR("Unable to get the timestamp %d", result);
+                return LE_FAULT;
             }
-            else
-            {
-                LE_DEBUG("Timestamp: %s", timeStamp);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_TIMESTAMP, timeStamp);
-            }
-
-            size_t len = le_sms_GetUserdataLen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-
-            // Add a character for last '\0'
-            len++;
-
-            uint8_t bin[len];
-            memset(bin, 0, len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string, 0, strLen);
-            const char* jsonKey;
 
-            if (format == LE_SMS_FORMAT_TEXT)
+            if (msgPtr->id >= NextMessageId)
             {
-                // Get text
-                result = le_sms_GetText(msgRef, (char*) bin, len);
-                jsonKey = JSON_TEXT;
+                NextMessageId = msgPtr->id + 1;
             }
-            else
+
+            MboxMask_t mboxMask = TranslateMask(msgPtr->mboxMask, storedBitsPtr);
+            if (0 == mboxMask)
             {
-                // Get binary
-                result = le_sms_GetBinary(msgRef, bin, &len);
-                jsonKey = JSON_BIN;
+                break;
             }
 
-            if (result != LE_OK)
+            IndexEntry_t* entryPtr = AddIndexEntry(msgPtr->id);
+            if (NULL == entryPtr)
             {
-                LE_ERROR("Unable to get payload %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
+                break;
             }
-            else
-            {
-                // Convert payload in string: json supports only utf-8 characters.
-                // Some extended-ASCII characters can be sent by SMS (such as character with accent)
-                // and can't be convert directly in utf-8. A convertion in string solves this issue.
-                strLen = le_hex_BinaryToString(bin, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, jsonKey, string);
 
-            }
+            entryPtr->offset = offset;
+            entryPtr->dataLen = msgPtr->dataLen;
+            entryPtr->format = msgPtr->format;
+            StoreLiveSize += GetMsgRecordSize(entryPtr);
+            SetIndexEntryMasks(entryPtr, mboxMask,
+                               TranslateMask(msgPtr->unreadMask, storedBitsPtr));
         }
         break;
 
-        case LE_SMS_FORMAT_PDU:
+        case RECORD_STATE:
         {
-            size_t len = le_sms_GetPDULen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-            // Add a character for last '\0'
-            len++;
-            uint8_t pdu[len];
-            memset(pdu, 0, len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string, 0, strLen);
-
-            // Add pdu
-            le_result_t result = le_sms_GetPDU(msgRef, pdu, &len);
+            StateRecord_t* statePtr = payloadPtr;
 
-            if (result != LE_OK)
+            if (headerPtr->len != sizeof(StateRecord_t))
             {
-                LE_ERROR("Unable to get pdu %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
+                return LE_FAULT;
             }
-            else
+
+            IndexEntry_t* entryPtr = LookupMessage(statePtr->id);
+            if (entryPtr)
             {
-                // Convert pdu in string
-                strLen = le_hex_BinaryToString(pdu, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_PDU, string);
-                LE_DEBUG("PDU format OK");
+                SetIndexEntryMasks(entryPtr,
+                                   TranslateMask(statePtr->mboxMask, storedBitsPtr),
+                                   TranslateMask(statePtr->unreadMask, storedBitsPtr));
             }
         }
         break;
-        case LE_SMS_FORMAT_UNKNOWN:
+
         default:
-            LE_ERROR("Bad format %d", format);
+            return LE_FAULT;
     }
 
-    // Write json file in the file system
-    char* jsondumpStr = json_dumps( (const json_t *) jsonRootPtr,
-                                    JSON_INDENT(1) | JSON_PRESERVE_ORDER);
-    if (!jsondumpStr)
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a directory
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MkdirCreate
+(
+    const char* path    ///<[IN] path for directory creation
+)
+{
+    int status = mkdir(path, S_IRWXU|S_IRWXG);
+    if (0 != status)
     {
-        LE_ERROR("JsondumpStr is NULL");
-        return LE_FAULT;
+        if (EEXIST != errno)
+        {
+            LE_ERROR("Unable to create directory %s: %m", path);
+            return LE_FAULT;
+        }
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the store and build the index of its messages. A torn or corrupted record, and what
+ * follows it, is dropped.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadStore
+(
+    void
+)
+{
+    static MsgBuffer_t payload;
+    MboxMask_t storedBits[MAX_APPS];
+    StoreHeader_t header;
+    RecordHeader_t recordHeader;
+    uint32_t offset;
+    le_result_t result;
+    int i;
+
+    if (LE_OK != MkdirCreate(SMSINBOX_PATH))
+    {
+        return;
     }
 
-    char* restJsondumpStr = jsondumpStr;
-    ssize_t writeSize = strlen(jsondumpStr);
-    ssize_t writtenSize;
+    StoreFd = open(SMSINBOX_PATH STORE_FILE, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC,
+                   S_IRUSR | S_IWUSR);
+    if (StoreFd < 0)
+    {
+        LE_ERROR("Unable to open the SMS Inbox store: %m");
+        return;
+    }
 
-    do
+    if ((pread(StoreFd, &header, sizeof(header), 0) != sizeof(header)) ||
+        (header.magic != STORE_MAGIC) || (header.version != STORE_VERSION))
+    {
+        LE_INFO("Create the SMS Inbox store");
+
+        if ((ftruncate(StoreFd, 0) != 0) ||
+            (WriteStoreHeader(StoreFd, &StoreSize) != LE_OK) ||
+            (fdatasync(StoreFd) != 0))
+        {
+            LE_ERROR("Unable to create the SMS Inbox store: %m");
+            close(StoreFd);
+            StoreFd = -1;
+        }
+        return;
+    }
+
+    memset(storedBits, 0, sizeof(storedBits));
+    offset = sizeof(header);
+
+    while ((result = ReadRecord(StoreFd, offset, &recordHeader, &payload, sizeof(payload)))
+           == LE_OK)
+    {
+        if (LoadRecord(&recordHeader, &payload, offset, storedBits) != LE_OK)
+        {
+            result = LE_FAULT;
+            break;
+        }
+        offset += sizeof(RecordHeader_t) + recordHeader.len;
+    }
+
+    if (LE_FAULT == result)
     {
-        writtenSize = write( fd, restJsondumpStr, writeSize );
-        if (writtenSize > 0)
+        LE_WARN("SMS Inbox store truncated at offset %u", offset);
+
+        if (ftruncate(StoreFd, offset) != 0)
         {
-            writeSize -= writtenSize;
-            restJsondumpStr += writtenSize;
+            LE_ERROR("Unable to truncate the SMS Inbox store: %m");
+        }
+    }
+
+    StoreSize = offset;
+
+    LE_INFO("%u messages in the SMS Inbox store, NextMessageId %u",
+            IndexCount, (unsigned int) NextMessageId);
+
+    // If the message boxes have changed, tell which bits the next records use for them
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        MboxRecord_t mbox;
+        uint32_t len;
+
+        if (Apps[i].namePtr && (storedBits[i] != GetMboxBit(&Apps[i])) &&
+            (FillMboxRecord(i, &mbox, &len) == LE_OK))
+        {
+            AppendRecord(RECORD_MBOX, &mbox, len, NULL);
+        }
+    }
+
+    CheckStoreCompaction();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a string of a former Jansson message file.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyJsonString
+(
+    json_t* jsonRootPtr,    ///<[IN] Json root object
+    const char* keyPtr,     ///<[IN] Key of the string
+    char* strPtr,           ///<[OUT] Copy of the string
+    size_t strSize          ///<[IN] Size of strPtr
+)
+{
+    const char* valuePtr = json_string_value(json_object_get(jsonRootPtr, keyPtr));
+
+    if (valuePtr && (le_utf8_Copy(strPtr, valuePtr, strSize, NULL) != LE_OK))
+    {
+        LE_ERROR("String too long for %s", keyPtr);
+        strPtr[0] = '\0';
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message identifier is in a former Jansson message box file.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInJsonMbox
+(
+    json_t* jsonRootPtr,    ///<[IN] Json root object of the message box file (can be NULL)
+    MessageId_t messageId   ///<[IN] Message identifier
+)
+{
+    json_t* jsonArrayPtr = json_object_get(jsonRootPtr, JSON_MSGINBOX);
+    size_t i;
+
+    for (i = 0; i < json_array_size(jsonArrayPtr); i++)
+    {
+        if (json_integer_value(json_array_get(jsonArrayPtr, i)) == messageId)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a former Jansson message file to the store.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MigrateJsonMessage
+(
+    const char* pathPtr,        ///<[IN] Message file path
+    MessageId_t messageId,      ///<[IN] Message identifier
+    json_t* jsonMboxPtr[]       ///<[IN] Json root objects of the message box files
+)
+{
+    static MsgBuffer_t msg;
+    json_error_t error;
+    const char* jsonKey;
+    int i;
+
+    json_t* jsonRootPtr = json_load_file(pathPtr, JSON_REJECT_DUPLICATES, &error);
+    if (NULL == jsonRootPtr)
+    {
+        LE_ERROR("Json decoder error %s: %s", pathPtr, error.text);
+        return;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.id = messageId;
+    msg.format = json_integer_value(json_object_get(jsonRootPtr, JSON_FORMAT));
+    msg.msgLen = json_integer_value(json_object_get(jsonRootPtr, JSON_MSGLEN));
+    CopyJsonString(jsonRootPtr, JSON_IMSI, msg.imsi, sizeof(msg.imsi));
+    CopyJsonString(jsonRootPtr, JSON_SENDERTEL, msg.tel, sizeof(msg.tel));
+    CopyJsonString(jsonRootPtr, JSON_TIMESTAMP, msg.timestamp, sizeof(msg.timestamp));
+
+    switch (msg.format)
+    {
+        case LE_SMS_FORMAT_TEXT:
+            jsonKey = JSON_TEXT;
+            break;
+        case LE_SMS_FORMAT_BINARY:
+            jsonKey = JSON_BIN;
+            break;
+        default:
+            jsonKey = JSON_PDU;
+            break;
+    }
+
+    // Payloads were stored as hexadecimal strings, texts with their last '\0'
+    const char* hexPtr = json_string_value(json_object_get(jsonRootPtr, jsonKey));
+    if (hexPtr)
+    {
+        int32_t len = le_hex_StringToBinary(hexPtr, strlen(hexPtr), msg.data, sizeof(msg.data));
+
+        if (len < 0)
+        {
+            LE_ERROR("Bad payload in %s", pathPtr);
+            len = 0;
+        }
+
+        msg.dataLen = (LE_SMS_FORMAT_TEXT == msg.format) ?
+                      strnlen((const char*) msg.data, len) : (uint32_t) len;
+    }
+
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        if (Apps[i].namePtr && IsInJsonMbox(jsonMboxPtr[i], messageId))
+        {
+            json_t* jsonDeletedPtr = json_object_get(jsonRootPtr, JSON_ISDELETED);
+            json_t* jsonUnreadPtr = json_object_get(jsonRootPtr, JSON_ISUNREAD);
+
+            if (!json_is_true(json_object_get(jsonDeletedPtr, Apps[i].namePtr)))
+            {
+                msg.mboxMask |= GetMboxBit(&Apps[i]);
+            }
+            if (json_is_true(json_object_get(jsonUnreadPtr, Apps[i].namePtr)))
+            {
+                msg.unreadMask |= GetMboxBit(&Apps[i]);
+            }
         }
     }
-    while ((writeSize > 0) && ((writtenSize >= 0) || (EINTR == errno)));
 
-    free(jsondumpStr);
     json_decref(jsonRootPtr);
 
-    return LE_OK;
+    // A message deleted from all the message boxes is not moved
+    if (StoreMessage(&msg) == LE_FAULT)
+    {
+        LE_ERROR("Message %08x not moved to the store", (int) messageId);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a new message entry
+ * Move the former Jansson files to the store, and delete them.
  *
+ * Each message is in the store before its file is deleted, and the message box files are deleted
+ * last: if this is interrupted, it is done again and the messages already moved are skipped.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateMsgEntry
+static void MigrateJsonFiles
 (
-    MessageId_t *msgPtr,    ///<[OUT] create messageId
-    int32_t *fdPtr         ///<[OUT] Created file descriptor
+    void
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
+    struct dirent **namelist;
+    json_t* jsonMboxPtr[MAX_APPS];
+    char path[PATH_MAX];
+    int nbEntries;
+    int i;
 
-    GetSMSInboxMessagePath(NextMessageId, path, pathLen);
-    LE_DEBUG("Create entry: NextMessageId %d, path %s",NextMessageId, path);
+    if (StoreFd < 0)
+    {
+        return;
+    }
 
-    *fdPtr = open( path, O_CREAT | O_RDWR | O_SYNC, S_IRUSR | S_IWUSR );
+    snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, MSG_PATH);
 
-    if (*fdPtr < 0)
+    nbEntries = scandir(path, &namelist, NULL, alphasort);
+    if (nbEntries < 0)
     {
-        LE_ERROR("No such file: %s: %m", path);
-        return LE_FAULT;
+        // Nothing to migrate
+        return;
     }
 
-    LE_DEBUG("New entry: %s", path);
+    LE_INFO("Move the SMS Inbox files to the store");
 
-    int i;
-
-    // For all the applications
+    memset(jsonMboxPtr, 0, sizeof(jsonMboxPtr));
     for (i = 0; i < MAX_APPS; i++)
     {
-        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
+        if (Apps[i].namePtr)
         {
-            AddMsgInAppCfg(&Apps[i], NextMessageId);
+            json_error_t error;
+
+            snprintf(path, sizeof(path), "%s%s%s%s", SMSINBOX_PATH, CONF_PATH, Apps[i].namePtr,
+                     FILE_EXTENSION);
+            jsonMboxPtr[i] = json_load_file(path, 0, &error);
         }
     }
 
-    *msgPtr = NextMessageId;
+    for (i = 0; i < nbEntries; i++)
+    {
+        char* endPtr;
+        MessageId_t messageId = strtoul(namelist[i]->d_name, &endPtr, 16);
 
-    NextMessageId++;
+        if ((endPtr != namelist[i]->d_name) && (0 == strcmp(endPtr, FILE_EXTENSION)))
+        {
+            snprintf(path, sizeof(path), "%s%s%s", SMSINBOX_PATH, MSG_PATH,
+                     namelist[i]->d_name);
 
-    return LE_OK;
-}
+            if (LookupMessage(messageId) == NULL)
+            {
+                MigrateJsonMessage(path, messageId, jsonMboxPtr);
+            }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Convert the file name string in hexa
- *
- * @return
- *      - Positive integer corresponding to the hexadecimal input string
- *      - -1 in case of error
- */
-//--------------------------------------------------------------------------------------------------
-static MessageId_t GetMessageId
-(
-    char* fileNamePtr  ///<[IN] file name to be converted
-)
-{
-    char *savePtr;
+            unlink(path);
+        }
 
-    if(NULL != fileNamePtr)
-    {
-        char *str = strtok_r(fileNamePtr,".", &savePtr);
+        free(namelist[i]);
+    }
+    free(namelist);
 
-        if (NULL == str)
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        if (Apps[i].namePtr)
         {
-            LE_ERROR("Unable to find . in the file name");
-            return -1;
+            json_decref(jsonMboxPtr[i]);
+
+            snprintf(path, sizeof(path), "%s%s%s%s", SMSINBOX_PATH, CONF_PATH, Apps[i].namePtr,
+                     FILE_EXTENSION);
+            unlink(path);
         }
-        return le_hex_HexaToInteger(str);
     }
-    else
+
+    snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, MSG_PATH);
+    if (rmdir(path) != 0)
     {
-        LE_ERROR("Provided file name pointer is NULL");
-        return -1;
+        LE_WARN("Unable to remove %s: %m", path);
     }
+
+    snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, CONF_PATH);
+    rmdir(path);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a directory
+ * Create a new message entry in the store
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_PERMITTED if no message box can hold it
+ *      - LE_FAULT on failure
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t MkdirCreate
+static le_result_t CreateMsgEntry
 (
-    const char* path    ///<[IN] path for directory creation
+    le_sms_MsgRef_t msgRef, ///<[IN] SMS to be stored
+    MessageId_t *msgPtr     ///<[OUT] create messageId
 )
 {
-    int status = mkdir(path, S_IRWXU|S_IRWXG);
-    if (0 != status)
+    static MsgBuffer_t msg;
+    le_result_t result;
+    int i;
+
+    memset(&msg, 0, sizeof(msg));
+
+    msg.id = NextMessageId;
+    le_utf8_Copy(msg.imsi, SimImsi, sizeof(msg.imsi), NULL);
+    msg.format = le_sms_GetFormat(msgRef);
+
+    // Unread by default for all applications
+    for (i = 0; i < MAX_APPS; i++)
     {
-        if (EEXIST != errno)
+        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
         {
-            LE_ERROR("Unable to create directory %s: %m", path);
-            return LE_FAULT;
+            msg.mboxMask |= GetMboxBit(&Apps[i]);
         }
     }
-    return LE_OK;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Init the SMSInBox directory
- *
- */
-//--------------------------------------------------------------------------------------------------
-static void InitSmsInBoxDirectory
-(
-    void
-)
-{
-    struct dirent **namelist;
-    uint32_t nbSmsEntries;
-
-    LE_DEBUG("InitSmsInBoxDirectory");
+    msg.unreadMask = msg.mboxMask;
 
-    // create directories
-    if (LE_OK != MkdirCreate(SMSINBOX_PATH))
+    switch ( msg.format )
     {
-        return;
-    }
+        case LE_SMS_FORMAT_TEXT:
+        case LE_SMS_FORMAT_BINARY:
+        {
+            result = le_sms_GetSenderTel(msgRef, msg.tel, sizeof(msg.tel));
 
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, CONF_PATH);
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get the tel number %d", result);
+                msg.tel[0] = '\0';
+            }
+            else
+            {
+                LE_DEBUG("Tel num: %s", msg.tel);
+            }
 
-    if (LE_OK != MkdirCreate(path))
-    {
-        return;
-    }
+            result = le_sms_GetTimeStamp(msgRef, msg.timestamp, sizeof(msg.timestamp));
 
-    memset(path, 0, pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get the timestamp %d", result);
+                msg.timestamp[0] = '\0';
+            }
+            else
+            {
+                LE_DEBUG("Timestamp: %s", msg.timestamp);
+            }
 
-    if (LE_OK != MkdirCreate(path))
-    {
-        return;
-    }
+            msg.msgLen = le_sms_GetUserdataLen(msgRef);
 
-    nbSmsEntries = scandir(path, &namelist, NULL, alphasort);
-    if ( nbSmsEntries > 2 )
-    {
-        uint8_t len = strlen(namelist[nbSmsEntries-1]->d_name);
-        char name[len+1];
-        MessageId_t id;
+            if (msg.format == LE_SMS_FORMAT_TEXT)
+            {
+                result = le_sms_GetText(msgRef, (char*) msg.data, sizeof(msg.data));
+                msg.dataLen = strnlen((const char*) msg.data, sizeof(msg.data));
+            }
+            else
+            {
+                size_t len = sizeof(msg.data);
 
-        memset(name, 0, len+1);
-        strncpy(name, namelist[nbSmsEntries-1]->d_name, len);
+                result = le_sms_GetBinary(msgRef, msg.data, &len);
+                msg.dataLen = len;
+            }
 
-        id = GetMessageId(name);
-        if (-1 == id)
-        {
-            LE_ERROR("Unable to get the id of %s", name);
-            return;
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get payload %d", result);
+                msg.msgLen = 0;
+                msg.dataLen = 0;
+            }
         }
+        break;
+
+        case LE_SMS_FORMAT_PDU:
+        {
+            size_t len = sizeof(msg.data);
+
+            msg.msgLen = le_sms_GetPDULen(msgRef);
 
-        NextMessageId = ++id;
+            result = le_sms_GetPDU(msgRef, msg.data, &len);
 
-        LE_DEBUG("NextMessageId %d", (int) NextMessageId);
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get pdu %d", result);
+                msg.msgLen = 0;
+                len = 0;
+            }
+            else
+            {
+                LE_DEBUG("PDU format OK");
+            }
+            msg.dataLen = len;
+        }
+        break;
+
+        case LE_SMS_FORMAT_UNKNOWN:
+        default:
+            LE_ERROR("Bad format %d", msg.format);
     }
 
-    while (nbSmsEntries--)
+    LE_DEBUG("Create entry: NextMessageId %d", NextMessageId);
+
+    result = StoreMessage(&msg);
+    if (result == LE_OK)
     {
-        free(namelist[nbSmsEntries]);
+        *msgPtr = msg.id;
     }
 
-    free(namelist);
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1545,7 +1890,6 @@ static void MoveSmsFromSimToFolder
     void
 )
 {
-    int32_t fd;
     le_result_t result = LE_OK;
 
     le_sms_MsgListRef_t msgListRef = le_sms_CreateRxMsgList();
@@ -1562,18 +1906,7 @@ static void MoveSmsFromSimToFolder
     {
         MessageId_t msgId;
 
-        result = CreateMsgEntry(&msgId, &fd);
-
-        if (result == LE_OK)
-        {
-            if ( EncodeMsgEntry(fd, smsRef) != LE_OK )
-            {
-                LE_ERROR("Encoding issue");
-            }
-
-            close(fd);
-        }
-        else
+        if (CreateMsgEntry(smsRef, &msgId) != LE_OK)
         {
             LE_ERROR("Error during new entry creation");
         }
@@ -1602,23 +1935,12 @@ static void NewSmsMsgHandler
     void*           contextPtr
 )
 {
-    int32_t fd;
     le_result_t result;
     MessageId_t msgId;
 
     LE_DEBUG("Receive new message");
 
-    result = CreateMsgEntry(&msgId, &fd);
-
-    if (result == LE_OK)
-    {
-        result = EncodeMsgEntry(fd, msgRef);
-        close(fd);
-    }
-    else
-    {
-        LE_ERROR("CreateMsgEntry error");
-    }
+    result = CreateMsgEntry(msgRef, &msgId);
 
     if (result == LE_OK)
     {
@@ -1630,7 +1952,7 @@ static void NewSmsMsgHandler
     }
     else
     {
-        LE_ERROR("EncodeMsgEntry error");
+        LE_ERROR("CreateMsgEntry error");
     }
 }
 
@@ -1820,8 +2142,9 @@ COMPONENT_INIT
     // Retrieve the smsInbox settings from the configuration tree
     LoadInboxSettings();
 
-    // Initialization of the smsInbox directory
-    InitSmsInBoxDirectory();
+    // Load the smsInbox store, and move the files of former versions into it
+    LoadStore();
+    MigrateJsonFiles();
 
     // Create an event Id for new messages
     RxMsgEventId = le_event_CreateId("RxMsgEventId", sizeof(MessageId_t));
@@ -1870,6 +2193,9 @@ SmsInbox_SessionRef_t SmsInbox_Open
 
     int i;
 
+    // Files of former versions may have been restored since the service was started
+    MigrateJsonFiles();
+
     for (i=0; i < MAX_APPS; i++)
     {
         if (Apps[i].namePtr && (strcmp(Apps[i].namePtr, mboxName) == 0))
@@ -2040,32 +2366,103 @@ void SmsInbox_DeleteMsg
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    MboxCtx_t* mboxCtxPtr = clientRequestPtr->mboxSessionPtr->mboxCtxPtr;
+    IndexEntry_t* entryPtr = LookupMboxMessage(mboxCtxPtr, msgId);
+    if (NULL == entryPtr)
     {
         LE_ERROR("Message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISDELETED, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
+    RemoveFromMbox(entryPtr, mboxCtxPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up a message of the message box of a session, and read it.
+ *
+ * @return
+ *  - The index entry of the message.
+ *  - NULL if the session reference or the message is invalid (*resultPtr is LE_BAD_PARAMETER), or
+ *    if the message can't be read (*resultPtr is LE_FAULT).
+ */
+//--------------------------------------------------------------------------------------------------
+static IndexEntry_t* ReadMboxMessage
+(
+    SmsInbox_SessionRef_t sessionRef,   ///<[IN] Session reference
+    uint32_t msgId,                     ///<[IN] Message identifier
+    MsgBuffer_t* msgPtr,                ///<[OUT] Message (can be NULL)
+    MboxCtx_t** mboxCtxPtrPtr,          ///<[OUT] Message box of the session
+    le_result_t* resultPtr              ///<[OUT] Error code
+)
+{
+    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
+    if (NULL == clientRequestPtr)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
+        *resultPtr = LE_BAD_PARAMETER;
+        return NULL;
+    }
+
+    if (clientRequestPtr->mboxSessionPtr == NULL)
+    {
+        LE_ERROR("Bad parameter");
+        *resultPtr = LE_BAD_PARAMETER;
+        return NULL;
+    }
+
+    *mboxCtxPtrPtr = clientRequestPtr->mboxSessionPtr->mboxCtxPtr;
 
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    IndexEntry_t* entryPtr = LookupMboxMessage(*mboxCtxPtrPtr, msgId);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("ModifyMsgEntry error");
+        LE_ERROR("Message not included into the mbox");
+        *resultPtr = LE_BAD_PARAMETER;
+        return NULL;
     }
 
-    if (DeleteMsgInAppCfg(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId)
-                          != LE_OK)
+    if (msgPtr && (ReadMessage(entryPtr, msgPtr) != LE_OK))
     {
-        LE_ERROR("DeleteMsgInAppCfg error");
+        *resultPtr = LE_FAULT;
+        return NULL;
     }
 
-    PerformDeletion(messageId);
+    *resultPtr = LE_OK;
+    return entryPtr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a string of a message.
+ *
+ * @return
+ *  - LE_FAULT         The message has no such string.
+ *  - LE_OVERFLOW      The string is too long for the buffer.
+ *  - LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyMsgString
+(
+    char* destPtr,          ///<[OUT] Copy of the string
+    size_t destSize,        ///<[IN] Size of destPtr
+    const char* srcPtr      ///<[IN] String of the message
+)
+{
+    if ('\0' == srcPtr[0])
+    {
+        LE_ERROR("No information");
+        return LE_FAULT;
+    }
+
+    if (le_utf8_Copy(destPtr, srcPtr, destSize, NULL) != LE_OK)
+    {
+        LE_ERROR("String too long");
+        memset(destPtr, 0, destSize);
+        return LE_OVERFLOW;
+    }
+
+    return LE_OK;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2098,28 +2495,16 @@ le_result_t SmsInbox_GetImsi
         ///< [IN]
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
-    }
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
+        return res;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-
     memset(imsiPtr, 0, imsiNumElements);
 
     if (imsiNumElements < LE_SIM_IMSI_BYTES)
@@ -2127,16 +2512,9 @@ le_result_t SmsInbox_GetImsi
         return LE_OVERFLOW;
     }
 
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = imsiPtr;
-    decode.uVal.str.lenStr = imsiNumElements;
-    char* key[1] = {JSON_IMSI};
-
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                              messageId, key, 1, &decode)) == LE_OK)
+    if ((res = CopyMsgString(imsiPtr, imsiNumElements, msg.imsi)) == LE_OK)
     {
-        SmsInbox_MarkRead(sessionRef, msgId);
+        SetUnread(entryPtr, mboxCtxPtr, false);
     }
 
     return res;
@@ -2164,41 +2542,20 @@ le_sms_Format_t SmsInbox_GetFormat
         ///< Message identifier.
 )
 {
-    // Get the message box session context
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return 0;
-    }
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (clientRequestPtr->mboxSessionPtr == NULL)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, NULL, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Bad mbox reference");
-        return 0;
+        return LE_SMSINBOX_FORMAT_UNKNOWN;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("Message not included into the mbox");
-        return 0;
-    }
+    le_sms_Format_t format = entryPtr->format;
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_FORMAT};
+    SetUnread(entryPtr, mboxCtxPtr, false);
 
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                      &decode) == LE_OK)
-    {
-        SmsInbox_MarkRead(sessionRef, msgId);
-        return decode.uVal.val;
-    }
-    else
-    {
-        return LE_SMSINBOX_FORMAT_UNKNOWN;
-    }
+    return format;
 }
 
 
@@ -2230,38 +2587,21 @@ le_result_t SmsInbox_GetSenderTel
         ///< [IN]
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
-    }
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
+        return res;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = telPtr;
-    decode.uVal.str.lenStr = telNumElements;
     memset(telPtr, 0, telNumElements);
-    char* key[1] = {JSON_SENDERTEL};
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key,
-                              1, &decode)) == LE_OK)
+    if ((res = CopyMsgString(telPtr, telNumElements, msg.tel)) == LE_OK)
     {
-        SmsInbox_MarkRead(sessionRef, msgId);
+        SetUnread(entryPtr, mboxCtxPtr, false);
     }
 
     return res;
@@ -2299,39 +2639,27 @@ le_result_t SmsInbox_GetTimeStamp
     size_t timestampNumElements
         ///< [IN]
 )
-{
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
+{
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (clientRequestPtr->mboxSessionPtr == NULL)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
+        return res;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    memset(timestampPtr, 0, timestampNumElements);
+
+    if (LE_SMS_FORMAT_PDU == entryPtr->format)
     {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
+        return LE_NOT_FOUND;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = timestampPtr;
-    decode.uVal.str.lenStr = timestampNumElements;
-    memset(timestampPtr, 0, timestampNumElements);
-    char* key[1] = {JSON_TIMESTAMP};
-    le_result_t res;
-
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                               key, 1, &decode)) == LE_OK )
+    if ((res = CopyMsgString(timestampPtr, timestampNumElements, msg.timestamp)) == LE_OK)
     {
-        SmsInbox_MarkRead(sessionRef, msgId);
+        SetUnread(entryPtr, mboxCtxPtr, false);
     }
 
     return res;
@@ -2357,46 +2685,19 @@ size_t SmsInbox_GetMsgLen
         ///< Message identifier.
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
-    }
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
+        return (LE_BAD_PARAMETER == res) ? LE_BAD_PARAMETER : 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_MSGLEN};
-    le_result_t res;
-
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                                messageId,
-                                key,
-                                1,
-                                &decode)) == LE_OK )
-    {
-        SmsInbox_MarkRead(sessionRef, msgId);
+    SetUnread(entryPtr, mboxCtxPtr, false);
 
-        return decode.uVal.val;
-    }
-    else
-    {
-        return 0;
-    }
+    return msg.msgLen;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2429,55 +2730,84 @@ le_result_t SmsInbox_GetText
         ///< [IN]
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
+
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
+        return res;
     }
 
-    if (clientRequestPtr->mboxSessionPtr == NULL)
+    memset(textPtr, 0, textNumElements);
+
+    if (LE_SMS_FORMAT_TEXT != entryPtr->format)
     {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
+        return LE_FORMAT_ERROR;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    // Room is needed for the last '\0'
+    if (msg.dataLen >= textNumElements)
     {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
+        return LE_OVERFLOW;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
+    memcpy(textPtr, msg.data, msg.dataLen);
+
+    SetUnread(entryPtr, mboxCtxPtr, false);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the binary or PDU data of a message.
+ *
+ * @return
+ *  - LE_BAD_PARAMETER The message reference is invalid.
+ *  - LE_FORMAT_ERROR  Message is not in the requested format.
+ *  - LE_OVERFLOW      Message length exceed the maximum length.
+ *  - LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetMsgData
+(
+    SmsInbox_SessionRef_t sessionRef,   ///<[IN] Session reference
+    uint32_t msgId,                     ///<[IN] Message identifier
+    le_sms_Format_t format,             ///<[IN] Requested format
+    uint8_t* dataPtr,                   ///<[OUT] Message data
+    size_t* dataNumElementsPtr          ///<[INOUT] Size of dataPtr, then length of the data
+)
+{
+    static MsgBuffer_t msg;
+    MboxCtx_t* mboxCtxPtr;
     le_result_t res;
-    size_t len = 2*textNumElements+1;
-    char tmpTextPtr[len];
-    memset(tmpTextPtr, 0, len);
-    memset(textPtr, 0, textNumElements);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpTextPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_TEXT};
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, &msg, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
+    {
+        return res;
+    }
 
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
+    memset(dataPtr, 0, *dataNumElementsPtr);
 
-    if ( res == LE_OK )
+    if (format != entryPtr->format)
     {
-        if ( le_hex_StringToBinary(tmpTextPtr,
-                                   decode.uVal.str.lenStr,
-                                   (uint8_t*) textPtr,
-                                   textNumElements ) < 0 )
-        {
-            return LE_FAULT;
-        }
+        return LE_FORMAT_ERROR;
+    }
 
-        SmsInbox_MarkRead(sessionRef, msgId);
+    if (msg.dataLen > *dataNumElementsPtr)
+    {
+        return LE_OVERFLOW;
     }
 
-    return res;
+    memcpy(dataPtr, msg.data, msg.dataLen);
+    *dataNumElementsPtr = msg.dataLen;
+
+    SetUnread(entryPtr, mboxCtxPtr, false);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2516,59 +2846,7 @@ le_result_t SmsInbox_GetBinary
         return LE_FAULT;
     }
 
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
-    }
-
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("Message not included into the mbox");
-        return LE_BAD_PARAMETER;
-    }
-
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*binNumElementsPtr)+1;
-    char tmpBinPtr[len];
-    memset(tmpBinPtr, 0, len);
-    memset(binPtr, 0, *binNumElementsPtr);
-
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpBinPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_BIN};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                         key, 1, &decode);
-
-    if ( res == LE_OK )
-    {
-        int32_t binNumElements = le_hex_StringToBinary(tmpBinPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    binPtr,
-                                                    *binNumElementsPtr);
-
-        if ( binNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *binNumElementsPtr = binNumElements;
-
-        SmsInbox_MarkRead(sessionRef, msgId);
-    }
-
-    return res;
+    return GetMsgData(sessionRef, msgId, LE_SMS_FORMAT_BINARY, binPtr, binNumElementsPtr);
 }
 
 
@@ -2610,60 +2888,7 @@ le_result_t SmsInbox_GetPdu
         return LE_FAULT;
     }
 
-    // Get the mbox session context
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad mbox reference");
-        return 0;
-    }
-
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("Message not included into the mbox");
-        return 0;
-    }
-
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*pduNumElementsPtr)+1;
-    char tmpPduPtr[len];
-    memset(tmpPduPtr, 0, len);
-    memset(pduPtr, 0, *pduNumElementsPtr);
-
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpPduPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_PDU};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
-
-    if ( res == LE_OK )
-    {
-        int32_t pduNumElements = le_hex_StringToBinary(tmpPduPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    pduPtr,
-                                                    *pduNumElementsPtr);
-
-        if ( pduNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *pduNumElementsPtr = pduNumElements;
-
-        SmsInbox_MarkRead(sessionRef, msgId);
-    }
-
-    return res;
+    return GetMsgData(sessionRef, msgId, LE_SMS_FORMAT_PDU, pduPtr, pduNumElementsPtr);
 }
 
 
@@ -2698,75 +2923,16 @@ uint32_t SmsInbox_GetFirst
         return 0;
     }
 
-    uint32_t pathLen = GetSMSInboxConfigPathLen(clientRequestPtr->
-                                                mboxSessionPtr->mboxCtxPtr->namePtr);
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    GetSMSInboxConfigPath(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, path, pathLen);
-    le_result_t res = LE_OK;
-    MessageId_t messageId=0;
+    MboxSession_t* mboxSessionPtr = clientRequestPtr->mboxSessionPtr;
 
-    if ( GetMsgListFromMbox(path,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return 0;
-    }
-
-    clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex =
-                      json_array_size(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr);
-
-    LE_DEBUG("MaxIndex %d", clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex);
-
-    if ( clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex > 0 )
-    {
-        json_t * jsonIntegerPtr =
-                 json_array_get(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr, 0);
-
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("Json error");
-            res = LE_FAULT;
-        }
+    mboxSessionPtr->browseCtx.currentMessageId = FindMboxMessage(mboxSessionPtr->mboxCtxPtr, 0);
 
-        if (messageId)
-        {
-            clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex = 1;
-        }
-        else
-        {
-            LE_ERROR("Json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (0 == mboxSessionPtr->browseCtx.currentMessageId)
     {
-        res = LE_FAULT;
         LE_DEBUG("Empty mbox");
     }
 
-    if (res == LE_FAULT)
-    {
-        if (clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr)
-        {
-            json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-        }
-
-        memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-        return 0;
-    }
-    else
-    {
-        return messageId;
-    }
-
-    return 0;
+    return mboxSessionPtr->browseCtx.currentMessageId;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2794,60 +2960,22 @@ uint32_t SmsInbox_GetNext
         return LE_BAD_PARAMETER;
     }
 
-    while(clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex !=
-          clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex)
-    {
-        LE_DEBUG("CurrentIndex %d, maxIndex %d", clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.maxIndex);
-
-        json_t * jsonIntegerPtr = json_array_get(clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.jsonArrayPtr,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex);
-
-        if (jsonIntegerPtr)
-        {
-            MessageId_t messageId = json_integer_value(jsonIntegerPtr);
-
-            if (messageId > 0)
-            {
-                clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex++;
-
-                // Check if the message exist (it may be deleted since the GetFirst call)
-                uint16_t pathLen = GetSMSInboxMessagePathLen();
-                char path[pathLen];
-                memset(path, 0, pathLen);
-                GetSMSInboxMessagePath(messageId, path, pathLen);
-                int32_t fd = open(path, O_RDWR);
-
-                if (fd >= 0)
-                {
-                    // message is still existing
-                    close(fd);
-                    return messageId;
-                }
+    MboxSession_t* mboxSessionPtr = clientRequestPtr->mboxSessionPtr;
 
-                // else continue the parsing
-            }
-            else
-            {
-                LE_ERROR("Json error");
-            }
-        }
-        else
-        {
-            LE_ERROR("Json error");
-        }
+    // Messages deleted since the previous call are skipped, as they are not in the index anymore
+    if (mboxSessionPtr->browseCtx.currentMessageId)
+    {
+        mboxSessionPtr->browseCtx.currentMessageId =
+                        FindMboxMessage(mboxSessionPtr->mboxCtxPtr,
+                                        mboxSessionPtr->browseCtx.currentMessageId + 1);
     }
 
-    // Parsing end => free the memory
-    LE_DEBUG("No more messages");
-    json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-    memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
+    if (0 == mboxSessionPtr->browseCtx.currentMessageId)
+    {
+        LE_DEBUG("No more messages");
+    }
 
-    return 0;
+    return mboxSessionPtr->browseCtx.currentMessageId;
 }
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2873,40 +3001,16 @@ bool SmsInbox_IsUnread
         ///< Message identifier.
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return LE_BAD_PARAMETER;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return LE_BAD_PARAMETER;
-    }
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, NULL, &mboxCtxPtr, &res);
+    if (NULL == entryPtr)
     {
-        LE_ERROR("Message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[] = {JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 2,
-                       &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        LE_ERROR("Error in DecodeMsgEntry");
-        return false;
-    }
+    return (entryPtr->unreadMask & GetMboxBit(mboxCtxPtr)) != 0;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2928,34 +3032,13 @@ void SmsInbox_MarkRead
         ///< Message identifier.
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return;
-    }
-
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("Message not included into the mbox");
-        return;
-    }
-
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = false;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, NULL, &mboxCtxPtr, &res);
+    if (entryPtr)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        SetUnread(entryPtr, mboxCtxPtr, false);
     }
 }
 
@@ -2978,34 +3061,13 @@ void SmsInbox_MarkUnread
         ///< Message identifier.
 )
 {
-    ClientRequest_t* clientRequestPtr = le_ref_Lookup(ActivationRequestRefMap, sessionRef);
-    if (NULL == clientRequestPtr)
-    {
-        LE_KILL_CLIENT("Invalid reference (%p) provided!", sessionRef);
-        return;
-    }
-
-    if (clientRequestPtr->mboxSessionPtr == NULL)
-    {
-        LE_ERROR("Bad parameter");
-        return;
-    }
-
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
-    {
-        LE_ERROR("Message not included into the mbox");
-        return;
-    }
-
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
+    MboxCtx_t* mboxCtxPtr;
+    le_result_t res;
 
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    IndexEntry_t* entryPtr = ReadMboxMessage(sessionRef, msgId, NULL, &mboxCtxPtr, &res);
+    if (entryPtr)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        SetUnread(entryPtr, mboxCtxPtr, true);
     }
 }
 
@@ -335,3 +335,55 @@ COMPONENT_INIT
 {
     LE_DEBUG("spiLibrary initializing");
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs a batch of SPI transfers as one message.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spiLib_Transfer
+(
+    int fd,                                 ///< [in] open file descriptor of SPI port
+    const le_spiLib_Transfer_t* transfers,  ///< [in] transfers, done in this order
+    size_t count                            ///< [in] number of transfers
+)
+{
+    struct spi_ioc_transfer tr[LE_SPILIB_MAX_TRANSFERS];
+    int transferResult;
+
+    if ((count == 0) || (count > LE_SPILIB_MAX_TRANSFERS))
+    {
+        LE_ERROR("Bad number of transfers: %zu", count);
+        return LE_BAD_PARAMETER;
+    }
+
+    memset(tr, 0, count * sizeof(tr[0]));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        tr[i].tx_buf = (unsigned long)transfers[i].writeData;
+        tr[i].rx_buf = (unsigned long)transfers[i].readData;
+        tr[i].len = transfers[i].length;
+        tr[i].cs_change = transfers[i].csChange;
+    }
+
+    LE_DEBUG("Transmitting %zu transfers", count);
+
+    transferResult = ioctl(fd, SPI_IOC_MESSAGE(count), tr);
+
+    if (transferResult < 0)
+    {
+        LE_ERROR("Transfer failed with error %d : %d (%m)", transferResult, errno);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Successful transmission of %d bytes", transferResult);
+
+    return LE_OK;
+}
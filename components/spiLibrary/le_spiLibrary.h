@@ -8,6 +8,27 @@
 #ifndef LE_SPI_LIBRARY_H
 #define LE_SPI_LIBRARY_H
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Max number of transfers done by le_spiLib_Transfer().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_SPILIB_MAX_TRANSFERS 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One transfer of a batch done by le_spiLib_Transfer().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const uint8_t* writeData; ///< tx data, or NULL to send zeros
+    uint8_t* readData;        ///< rx data, or NULL to drop the received bytes
+    size_t length;            ///< number of bytes of the transfer
+    bool csChange;            ///< deselect the slave after the transfer (before the next one)
+}
+le_spiLib_Transfer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configures the SPI bus for use with a specific device.
@@ -100,4 +121,23 @@ LE_SHARED le_result_t le_spiLib_ReadHD
     size_t* readDataLength    ///< [in/out] number of bytes in rx message
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs a batch of SPI transfers, full or half duplex, as one message.  All the transfers are
+ * given to the driver in a single call, so they follow each other without going back to user
+ * space.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER if there are no transfers, or more than LE_SPILIB_MAX_TRANSFERS
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_spiLib_Transfer
+(
+    int fd,                                 ///< [in] open file descriptor of SPI port
+    const le_spiLib_Transfer_t* transfers,  ///< [in] transfers, done in this order
+    size_t count                            ///< [in] number of transfers
+);
+
 #endif  // LE_SPI_LIBRARY_H
@@ -326,6 +326,89 @@ le_result_t le_spi_WriteReadFD
         writeDataLength) == LE_OK ? LE_OK : LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * SPI batch of Full Duplex transfers, done as one message
+ *
+ * @return
+ *      LE_OK on success, LE_BAD_PARAMETER if the lengths don't match the data, or LE_FAULT on
+ *      failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spi_Transfer
+(
+    le_spi_DeviceHandleRef_t handle, ///< [in] Handle for the SPI master to perform the batch on
+    const uint32_t* lengths,      ///< [in] Number of bytes of each transfer
+    size_t lengthsCount,          ///< [in] Number of transfers
+    bool csChange,                ///< [in] Deselect the slave between transfers
+    const uint8_t* writeData,     ///< [in] Tx data of all the transfers
+    size_t writeDataLength,       ///< [in] Number of bytes in tx data
+    uint8_t* readData,            ///< [out] Rx data of all the transfers
+    size_t* readDataLength        ///< [in/out] Number of bytes in rx data
+)
+{
+    le_spiLib_Transfer_t transfers[LE_SPI_MAX_TRANSFERS];
+    size_t offset = 0;
+
+    if (readData == NULL)
+    {
+        LE_KILL_CLIENT("readData is NULL.");
+        return LE_FAULT;
+    }
+
+    Device_t* device = le_ref_Lookup(DeviceHandleRefMap, handle);
+    if (device == NULL)
+    {
+        LE_KILL_CLIENT("Failed to lookup device from handle!");
+        return LE_FAULT;
+    }
+
+    if (!IsDeviceOwnedByCaller(device))
+    {
+        LE_KILL_CLIENT("Cannot assign handle to transfer as it is not owned by the caller");
+        return LE_FAULT;
+    }
+
+    if ((lengthsCount == 0) || (lengthsCount > LE_SPI_MAX_TRANSFERS))
+    {
+        LE_ERROR("Bad number of transfers: %zu", lengthsCount);
+        return LE_BAD_PARAMETER;
+    }
+
+    for (size_t i = 0; i < lengthsCount; i++)
+    {
+        if (lengths[i] > writeDataLength - offset)
+        {
+            LE_ERROR("Transfer lengths exceed the %zu bytes of tx data", writeDataLength);
+            return LE_BAD_PARAMETER;
+        }
+
+        transfers[i].writeData = writeData + offset;
+        transfers[i].readData = readData + offset;
+        transfers[i].length = lengths[i];
+        // No need to deselect the slave after the last transfer, it is done anyway.
+        transfers[i].csChange = csChange && (i < lengthsCount - 1);
+
+        offset += lengths[i];
+    }
+
+    if ((offset != writeDataLength) || (*readDataLength < offset))
+    {
+        LE_ERROR("Transfer lengths add up to %zu bytes, for %zu bytes of tx data and %zu of rx",
+                 offset, writeDataLength, *readDataLength);
+        return LE_BAD_PARAMETER;
+    }
+
+    if (le_spiLib_Transfer(device->fd, transfers, lengthsCount) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    *readDataLength = offset;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SPI Read for Half Duplex Communication
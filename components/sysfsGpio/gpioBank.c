@@ -0,0 +1,610 @@
+/**
+ * @file gpioBank.c
+ *
+ * GPIO Bank API implementation. It gives access to many pins through one service, on top of the
+ * same sysfs GPIO objects as the per-pin GPIO services.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "gpioSysfs.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of pins which can be given in a pin mask.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PINS 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit of a pin in a pin mask.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PIN_MASK(pinNum) (1ULL << ((pinNum) - 1))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of change handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HANDLER_COUNT 8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change handler of a client, shared by the pins it monitors.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gpioBank_ChangeHandlerFunc_t handlerPtr;   ///< Client handler.
+    void* contextPtr;                             ///< Client context pointer.
+    uint64_t pins;                                ///< Monitored pins.
+    le_msg_SessionRef_t sessionRef;               ///< Client session.
+}
+ChangeHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pins which are available and not disabled by the configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t AvailablePins;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change handler of each pin, if it is monitored through this API.
+ */
+//--------------------------------------------------------------------------------------------------
+static ChangeHandler_t* PinHandlers[MAX_PINS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the change handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t HandlerPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe references of the change handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_ref_MapRef_t HandlerRefMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether all the pins of a mask are acquired by the current client.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsAcquired
+(
+    uint64_t pins           ///< [IN] Pins to check.
+)
+{
+    le_msg_SessionRef_t sessionRef = le_gpioBank_GetClientSessionRef();
+    int pinNum;
+
+    if (pins & ~AvailablePins)
+    {
+        return false;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if (pins & PIN_MASK(pinNum))
+        {
+            gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+            if ((!gpioRef->inUse) || (gpioRef->currentSession != sessionRef))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop monitoring a pin through its change handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemovePinHandler
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    ChangeHandler_t* handlerPtr = PinHandlers[gpioRef->pinNum - 1];
+
+    if (NULL != handlerPtr)
+    {
+        gpioSysfs_RemoveChangeCallback(gpioRef, gpioRef);
+        handlerPtr->pins &= ~PIN_MASK(gpioRef->pinNum);
+        PinHandlers[gpioRef->pinNum - 1] = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a pin acquired through this API.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleasePin
+(
+    gpioSysfs_GpioRef_t gpioRef     ///< [IN] GPIO object reference
+)
+{
+    RemovePinHandler(gpioRef);
+
+    LE_INFO("Releasing GPIO %d", gpioRef->pinNum);
+    gpioRef->inUse = false;
+    gpioRef->currentSession = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * fd monitor handler of the pins monitored through this API. The GPIO object is the context of
+ * the fd monitor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InputMonitorHandler
+(
+    int fd,                 ///< [IN] fd of the value attribute of the pin.
+    short events            ///< [IN] Events on the fd.
+)
+{
+    gpioSysfs_InputMonitorHandlerFunc(le_fdMonitor_GetContextPtr(), fd, events);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change callback of the pins monitored through this API: gives the pin number to the client
+ * handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PinChangeCallback
+(
+    bool state,             ///< [IN] New state of pin.
+    void* contextPtr        ///< [IN] GPIO object reference.
+)
+{
+    gpioSysfs_GpioRef_t gpioRef = contextPtr;
+    ChangeHandler_t* handlerPtr = PinHandlers[gpioRef->pinNum - 1];
+
+    if (NULL != handlerPtr)
+    {
+        handlerPtr->handlerPtr(gpioRef->pinNum, state, handlerPtr->contextPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Acquire pins for this client. Either all the pins are acquired, or none of them.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_BAD_PARAMETER if a pin is not available.
+ *      - LE_BUSY if a pin is already used by another client.
+ *      - LE_IO_ERROR if a pin could not be exported.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBank_Acquire
+(
+    uint64_t pins           ///< [IN] Pins to acquire.
+)
+{
+    le_msg_SessionRef_t sessionRef = le_gpioBank_GetClientSessionRef();
+    uint64_t acquired = 0;
+    int pinNum;
+
+    if (pins & ~AvailablePins)
+    {
+        LE_WARN("Pins 0x%016" PRIx64 " are not available", pins & ~AvailablePins);
+        return LE_BAD_PARAMETER;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+        if ((pins & PIN_MASK(pinNum)) && gpioRef->inUse && (gpioRef->currentSession != sessionRef))
+        {
+            LE_WARN("Attempt to use GPIO %d, which is already in use", pinNum);
+            return LE_BUSY;
+        }
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+        if ((0 == (pins & PIN_MASK(pinNum))) || gpioRef->inUse)
+        {
+            continue;
+        }
+
+        if (LE_OK != gpioSysfs_Export(gpioRef))
+        {
+            LE_WARN("Unable to export GPIO %s for use", gpioRef->gpioName);
+            le_gpioBank_Release(acquired);
+            return LE_IO_ERROR;
+        }
+
+        LE_INFO("Assigning GPIO %d", pinNum);
+        gpioRef->inUse = true;
+        gpioRef->currentSession = sessionRef;
+        acquired |= PIN_MASK(pinNum);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release pins acquired by this client. Their change handlers are stopped. Pins which are not
+ * acquired by this client are ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gpioBank_Release
+(
+    uint64_t pins           ///< [IN] Pins to release.
+)
+{
+    le_msg_SessionRef_t sessionRef = le_gpioBank_GetClientSessionRef();
+    int pinNum;
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+        if ((pins & AvailablePins & PIN_MASK(pinNum)) && gpioRef->inUse &&
+            (gpioRef->currentSession == sessionRef))
+        {
+            ReleasePin(gpioRef);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure pins as input pins.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_NOT_PERMITTED if a pin is not acquired by this client.
+ *      - LE_IO_ERROR if a pin could not be configured.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBank_SetInputs
+(
+    uint64_t pins,                  ///< [IN] Pins to configure.
+    le_gpioBank_Polarity_t polarity ///< [IN] Active-high or active-low.
+)
+{
+    int pinNum;
+
+    if (!IsAcquired(pins))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if ((pins & PIN_MASK(pinNum)) &&
+            (LE_OK != gpioSysfs_SetInput(gpioSysfs_GetPin(pinNum),
+                                         (gpioSysfs_ActiveType_t)polarity)))
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configure pins as push-pull output pins.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_NOT_PERMITTED if a pin is not acquired by this client.
+ *      - LE_IO_ERROR if a pin could not be configured.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBank_SetPushPullOutputs
+(
+    uint64_t pins,                      ///< [IN] Pins to configure.
+    le_gpioBank_Polarity_t polarity,    ///< [IN] Active-high or active-low.
+    uint64_t values                     ///< [IN] Initial states, one bit per pin.
+)
+{
+    int pinNum;
+
+    if (!IsAcquired(pins))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if ((pins & PIN_MASK(pinNum)) &&
+            (LE_OK != gpioSysfs_SetPushPullOutput(gpioSysfs_GetPin(pinNum),
+                                                  (gpioSysfs_ActiveType_t)polarity,
+                                                  (values & PIN_MASK(pinNum)) != 0)))
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the state of output pins.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_NOT_PERMITTED if a pin is not acquired by this client.
+ *      - LE_IO_ERROR if a pin could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBank_Write
+(
+    uint64_t pins,          ///< [IN] Pins to write.
+    uint64_t values         ///< [IN] New states, one bit per pin.
+)
+{
+    int pinNum;
+
+    if (!IsAcquired(pins))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if ((pins & PIN_MASK(pinNum)) &&
+            (LE_OK != gpioSysfs_WriteValue(gpioSysfs_GetPin(pinNum),
+                                           (values & PIN_MASK(pinNum)) != 0)))
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the state of pins.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_NOT_PERMITTED if a pin is not acquired by this client.
+ *      - LE_IO_ERROR if a pin could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBank_Read
+(
+    uint64_t pins,          ///< [IN] Pins to read.
+    uint64_t* valuesPtr     ///< [OUT] States, one bit per pin.
+)
+{
+    int pinNum;
+
+    *valuesPtr = 0;
+
+    if (!IsAcquired(pins))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if (pins & PIN_MASK(pinNum))
+        {
+            int value = (int)gpioSysfs_ReadValue(gpioSysfs_GetPin(pinNum));
+
+            if (0 > value)
+            {
+                return LE_IO_ERROR;
+            }
+            if (SYSFS_VALUE_HIGH == value)
+            {
+                *valuesPtr |= PIN_MASK(pinNum);
+            }
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register a callback function to be called when one of some input pins changes state.
+ *
+ * @return A reference to the handler, or NULL if it could not be registered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_gpioBank_ChangeEventHandlerRef_t le_gpioBank_AddChangeEventHandler
+(
+    uint64_t pins,                              ///< [IN] Pins to monitor.
+    le_gpioBank_Edge_t trigger,                 ///< [IN] Change(s) that trigger the callback.
+    le_gpioBank_ChangeHandlerFunc_t handlerPtr, ///< [IN] The callback function.
+    void* contextPtr                            ///< [IN] Client context pointer.
+)
+{
+    ChangeHandler_t* changeHandlerPtr;
+    int pinNum;
+
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("handlerPtr is NULL!");
+        return NULL;
+    }
+
+    if (!IsAcquired(pins))
+    {
+        LE_ERROR("Pins 0x%016" PRIx64 " are not all acquired", pins);
+        return NULL;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if ((pins & PIN_MASK(pinNum)) && (NULL != gpioSysfs_GetPin(pinNum)->fdMonitor))
+        {
+            LE_ERROR("GPIO %d already has a change handler", pinNum);
+            return NULL;
+        }
+    }
+
+    changeHandlerPtr = le_mem_ForceAlloc(HandlerPool);
+    changeHandlerPtr->handlerPtr = handlerPtr;
+    changeHandlerPtr->contextPtr = contextPtr;
+    changeHandlerPtr->pins = 0;
+    changeHandlerPtr->sessionRef = le_gpioBank_GetClientSessionRef();
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+        if (0 == (pins & PIN_MASK(pinNum)))
+        {
+            continue;
+        }
+
+        if (NULL == gpioSysfs_SetChangeCallback(gpioRef,
+                                                InputMonitorHandler,
+                                                (gpioSysfs_EdgeSensivityMode_t)trigger,
+                                                PinChangeCallback,
+                                                gpioRef,
+                                                0))
+        {
+            // Undo the pins set up so far.
+            for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+            {
+                if (changeHandlerPtr->pins & PIN_MASK(pinNum))
+                {
+                    RemovePinHandler(gpioSysfs_GetPin(pinNum));
+                }
+            }
+            le_mem_Release(changeHandlerPtr);
+            return NULL;
+        }
+
+        le_fdMonitor_SetContextPtr(gpioRef->fdMonitor, gpioRef);
+        PinHandlers[pinNum - 1] = changeHandlerPtr;
+        changeHandlerPtr->pins |= PIN_MASK(pinNum);
+    }
+
+    return le_ref_CreateRef(HandlerRefMap, changeHandlerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a change handler.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gpioBank_RemoveChangeEventHandler
+(
+    le_gpioBank_ChangeEventHandlerRef_t handlerRef  ///< [IN] Reference of the handler.
+)
+{
+    ChangeHandler_t* changeHandlerPtr = le_ref_Lookup(HandlerRefMap, handlerRef);
+    int pinNum;
+
+    if ((NULL == changeHandlerPtr) ||
+        (changeHandlerPtr->sessionRef != le_gpioBank_GetClientSessionRef()))
+    {
+        LE_KILL_CLIENT("Invalid change handler reference %p", handlerRef);
+        return;
+    }
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        if (changeHandlerPtr->pins & PIN_MASK(pinNum))
+        {
+            RemovePinHandler(gpioSysfs_GetPin(pinNum));
+        }
+    }
+
+    le_ref_DeleteRef(HandlerRefMap, handlerRef);
+    le_mem_Release(changeHandlerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close session handler: releases the pins and change handlers of the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSessionHandler
+(
+    le_msg_SessionRef_t sessionRef,  ///< [IN] Client session reference.
+    void* contextPtr                 ///< [IN] Not used.
+)
+{
+    le_ref_IterRef_t iterRef;
+    int pinNum;
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        gpioSysfs_GpioRef_t gpioRef = gpioSysfs_GetPin(pinNum);
+
+        if ((AvailablePins & PIN_MASK(pinNum)) && gpioRef->inUse &&
+            (gpioRef->currentSession == sessionRef))
+        {
+            ReleasePin(gpioRef);
+        }
+    }
+
+    iterRef = le_ref_GetIterator(HandlerRefMap);
+    while (LE_OK == le_ref_NextNode(iterRef))
+    {
+        ChangeHandler_t* changeHandlerPtr = (ChangeHandler_t*)le_ref_GetValue(iterRef);
+
+        if (changeHandlerPtr->sessionRef == sessionRef)
+        {
+            le_ref_DeleteRef(HandlerRefMap, (void*)le_ref_GetSafeRef(iterRef));
+            le_mem_Release(changeHandlerPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the GPIO Bank service, for the pins which also have a GPIO service.
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioBank_Init
+(
+    void
+)
+{
+    char path[64];
+    int pinNum;
+
+    for (pinNum = 1; pinNum <= MAX_PINS; pinNum++)
+    {
+        snprintf(path, sizeof(path), "gpioService:/pins/disabled/%d", pinNum);
+        if (gpioSysfs_IsPinAvailable(pinNum) && !le_cfg_QuickGetBool(path, false))
+        {
+            AvailablePins |= PIN_MASK(pinNum);
+        }
+    }
+
+    HandlerPool = le_mem_CreatePool("GpioBankHandlers", sizeof(ChangeHandler_t));
+    le_mem_ExpandPool(HandlerPool, HANDLER_COUNT);
+    HandlerRefMap = le_ref_CreateMap("GpioBankHandlers", HANDLER_COUNT);
+
+    LE_INFO("Starting GPIO Bank Service for pins 0x%016" PRIx64, AvailablePins);
+    le_gpioBank_AdvertiseService();
+    le_msg_AddServiceCloseHandler(le_gpioBank_GetServiceRef(), CloseSessionHandler, NULL);
+}
@@ -8599,6 +8599,99 @@ le_result_t le_gpioPin64_DisableEdgeSense (void)
 //--------------------------------------------------------------------------------------------------
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the pins, by number (starting at 1).
+ */
+//--------------------------------------------------------------------------------------------------
+static const gpioSysfs_GpioRef_t Pins[] =
+{
+    &SysfsGpioPin1,
+    &SysfsGpioPin2,
+    &SysfsGpioPin3,
+    &SysfsGpioPin4,
+    &SysfsGpioPin5,
+    &SysfsGpioPin6,
+    &SysfsGpioPin7,
+    &SysfsGpioPin8,
+    &SysfsGpioPin9,
+    &SysfsGpioPin10,
+    &SysfsGpioPin11,
+    &SysfsGpioPin12,
+    &SysfsGpioPin13,
+    &SysfsGpioPin14,
+    &SysfsGpioPin15,
+    &SysfsGpioPin16,
+    &SysfsGpioPin17,
+    &SysfsGpioPin18,
+    &SysfsGpioPin19,
+    &SysfsGpioPin20,
+    &SysfsGpioPin21,
+    &SysfsGpioPin22,
+    &SysfsGpioPin23,
+    &SysfsGpioPin24,
+    &SysfsGpioPin25,
+    &SysfsGpioPin26,
+    &SysfsGpioPin27,
+    &SysfsGpioPin28,
+    &SysfsGpioPin29,
+    &SysfsGpioPin30,
+    &SysfsGpioPin31,
+    &SysfsGpioPin32,
+    &SysfsGpioPin33,
+    &SysfsGpioPin34,
+    &SysfsGpioPin35,
+    &SysfsGpioPin36,
+    &SysfsGpioPin37,
+    &SysfsGpioPin38,
+    &SysfsGpioPin39,
+    &SysfsGpioPin40,
+    &SysfsGpioPin41,
+    &SysfsGpioPin42,
+    &SysfsGpioPin43,
+    &SysfsGpioPin44,
+    &SysfsGpioPin45,
+    &SysfsGpioPin46,
+    &SysfsGpioPin47,
+    &SysfsGpioPin48,
+    &SysfsGpioPin49,
+    &SysfsGpioPin50,
+    &SysfsGpioPin51,
+    &SysfsGpioPin52,
+    &SysfsGpioPin53,
+    &SysfsGpioPin54,
+    &SysfsGpioPin55,
+    &SysfsGpioPin56,
+    &SysfsGpioPin57,
+    &SysfsGpioPin58,
+    &SysfsGpioPin59,
+    &SysfsGpioPin60,
+    &SysfsGpioPin61,
+    &SysfsGpioPin62,
+    &SysfsGpioPin63,
+    &SysfsGpioPin64,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the GPIO object of a pin.
+ *
+ * @return The GPIO object reference, or NULL if there is no such pin.
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_GpioRef_t gpioSysfs_GetPin
+(
+    int pinNum         ///< [IN] GPIO pin number (starting at 1)
+)
+{
+    if ((pinNum < 1) || (pinNum > NUM_ARRAY_MEMBERS(Pins)))
+    {
+        return NULL;
+    }
+
+    return Pins[pinNum - 1];
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The place where the component starts up.  All initialization happens here.
@@ -9694,6 +9787,9 @@ COMPONENT_INIT
         LE_INFO("Skipping starting GPIO Service for Pin 64 - pin not available or disabled by config");
     }
 
+    // Create the service for groups of pins.
+    gpioBank_Init();
+
     // Begin monitoring main event loop
     // Try to kick a couple of times before each timeout.
     le_clk_Time_t watchdogInterval = { .sec = MS_WDOG_INTERVAL };
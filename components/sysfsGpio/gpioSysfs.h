@@ -435,6 +435,57 @@ bool gpioSysfs_IsPinAvailable
     int pinNum         ///< [IN] GPIO pin number (starting at 1)
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Export a GPIO in the sysfs, if it is not exported already.
+ *
+ * @return
+ * - LE_OK if exporting was successful
+ * - LE_IO_ERROR if it failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_Export
+(
+    gpioSysfs_GpioRef_t gpioRef         ///< [IN] GPIO object reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the value of an output pin, without changing its direction.
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_IO_ERROR or LE_BAD_PARAMETER if the value could not be written
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_WriteValue
+(
+    gpioSysfs_GpioRef_t gpioRef,        ///< [IN] GPIO object reference
+    bool value                          ///< [IN] true = active, false = inactive
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the GPIO object of a pin.
+ *
+ * @return The GPIO object reference, or NULL if there is no such pin.
+ */
+//--------------------------------------------------------------------------------------------------
+gpioSysfs_GpioRef_t gpioSysfs_GetPin
+(
+    int pinNum         ///< [IN] GPIO pin number (starting at 1)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the GPIO Bank service (see gpioBank.c).
+ */
+//--------------------------------------------------------------------------------------------------
+void gpioBank_Init
+(
+    void
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The struct of Sysfs object
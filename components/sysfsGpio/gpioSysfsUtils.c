@@ -28,6 +28,48 @@
 #define MAX_PIN_NUMBER 64
 #define MIN_PIN_NUMBER 1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a GPIO attribute path, e.g. /sys/class/gpio/gpio42/active_low
+ */
+//--------------------------------------------------------------------------------------------------
+#define ATTR_PATH_MAX_BYTES 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of opened attribute files: a few attributes for each pin.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ATTR_FILE_MAP_SIZE (MAX_PIN_NUMBER * 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attribute file of a GPIO, kept open once it has been accessed so that reading or writing it
+ * again costs a single pread() or pwrite().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[ATTR_PATH_MAX_BYTES];     ///< Path of the attribute, key of AttrFileMap.
+    int readFd;                         ///< fd opened for reading, or -1.
+    int writeFd;                        ///< fd opened for writing, or -1.
+}
+AttrFile_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opened attribute files, by path.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t AttrFileMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the attribute files.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AttrFilePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Remove the change callback for the given GPIO
@@ -149,6 +191,104 @@ static le_result_t ExportGpio
     return LE_IO_ERROR;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the attribute file of a path, creating it if needed.
+ *
+ * @return The attribute file, or NULL if the path is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static AttrFile_t* GetAttrFile
+(
+    const char *path         ///< [IN] path to sysfs gpio attribute
+)
+{
+    AttrFile_t* filePtr;
+
+    if (NULL == AttrFileMap)
+    {
+        AttrFilePool = le_mem_CreatePool("GpioAttrFiles", sizeof(AttrFile_t));
+        AttrFileMap = le_hashmap_Create("GpioAttrFiles", ATTR_FILE_MAP_SIZE,
+                                        le_hashmap_HashString, le_hashmap_EqualsString);
+    }
+
+    filePtr = le_hashmap_Get(AttrFileMap, path);
+    if (NULL != filePtr)
+    {
+        return filePtr;
+    }
+
+    filePtr = le_mem_ForceAlloc(AttrFilePool);
+    if (LE_OK != le_utf8_Copy(filePtr->path, path, sizeof(filePtr->path), NULL))
+    {
+        LE_ERROR("GPIO attribute path %s is too long", path);
+        le_mem_Release(filePtr);
+        return NULL;
+    }
+    filePtr->readFd = -1;
+    filePtr->writeFd = -1;
+
+    le_hashmap_Put(AttrFileMap, filePtr->path, filePtr);
+    return filePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an fd of an attribute file, opening it if it is not already open.
+ *
+ * @return
+ * - LE_IO_ERROR if the file can't be opened
+ * - LE_BAD_PARAMETER if the path doesn't exist
+ * - LE_OK on success
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenAttrFile
+(
+    const char *path,        ///< [IN] path to sysfs gpio attribute
+    int flags,               ///< [IN] O_RDONLY or O_WRONLY
+    int *fdPtr               ///< [IN/OUT] fd of the attribute file, or -1 if not open
+)
+{
+    if (-1 != *fdPtr)
+    {
+        return LE_OK;
+    }
+
+    if (!CheckGpioPathExist(path))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    do
+    {
+        *fdPtr = open(path, flags | O_CLOEXEC);
+    }
+    while ((-1 == *fdPtr) && (EINTR == errno));
+
+    if (-1 == *fdPtr)
+    {
+        LE_ERROR("Error opening file %s: %m", path);
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close an fd of an attribute file after an error, so that it is opened again on next access.
+ * The GPIO may have been unexported and exported again since it was opened.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseAttrFile
+(
+    int *fdPtr               ///< [IN/OUT] fd of the attribute file, set to -1
+)
+{
+    close(*fdPtr);
+    *fdPtr = -1;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set sysfs GPIO signals attributes
@@ -161,6 +301,8 @@ static le_result_t ExportGpio
  * - "active_low"
  * - "pull"
  *
+ * The attribute file is kept open for the next writes.
+ *
  * @return
  * - LE_IO_ERROR if there was an error while writing the sysfs entry
  * - LE_BAD_PARAMETER if the path doesn't exist
@@ -173,44 +315,58 @@ static le_result_t WriteSysGpioSignalAttr
     const char *attr         ///< [IN] GPIO signal write attribute
 )
 {
-    FILE *fp = NULL;
+    AttrFile_t* filePtr = GetAttrFile(path);
+    size_t length = strlen(attr);
+    ssize_t written = -1;
+    int attempt;
 
-    if (!CheckGpioPathExist(path))
+    if (NULL == filePtr)
     {
-        LE_ERROR("GPIO %s does not exist (probably not exported)", path);
         return LE_BAD_PARAMETER;
     }
 
-    do
+    // A cached fd may be stale, so retry once with a freshly opened one.
+    for (attempt = 0; (attempt < 2) && (written < 0); attempt++)
     {
-        fp = fopen(path, "w");
-    }
-    while ((fp == NULL) && (errno == EINTR));
+        bool cached = (-1 != filePtr->writeFd);
+        le_result_t result = OpenAttrFile(path, O_WRONLY, &filePtr->writeFd);
 
-    if (!fp)
-    {
-        LE_ERROR("Error opening file %s for writing.\n", path);
-        return LE_IO_ERROR;
-    }
+        if (LE_BAD_PARAMETER == result)
+        {
+            LE_ERROR("GPIO %s does not exist (probably not exported)", path);
+            return result;
+        }
+        else if (LE_OK != result)
+        {
+            return result;
+        }
 
-    ssize_t written = fwrite(attr, 1, strlen(attr), fp);
-    fflush(fp);
+        do
+        {
+            written = pwrite(filePtr->writeFd, attr, length, 0);
+        }
+        while ((written < 0) && (EINTR == errno));
 
-    int fileError = ferror(fp);
-    if (fileError != 0)
-    {
-        LE_EMERG("Failed to write %s to GPIO config %s. Error %s", attr, path, strerror(fileError));
-        fclose(fp);
-        return LE_IO_ERROR;
+        if (written < 0)
+        {
+            int error = errno;
+
+            CloseAttrFile(&filePtr->writeFd);
+            if (!cached)
+            {
+                LE_EMERG("Failed to write %s to GPIO config %s. Error %s",
+                         attr, path, strerror(error));
+                return LE_IO_ERROR;
+            }
+        }
     }
 
-    if (written < strlen(attr))
+    if (written < length)
     {
         LE_EMERG("Data truncated while writing %s to GPIO config %s.", path, attr);
-        fclose(fp);
         return LE_IO_ERROR;
     }
-    fclose(fp);
+
     return LE_OK;
 }
 
@@ -226,6 +382,8 @@ static le_result_t WriteSysGpioSignalAttr
  * - "active_low"
  * - "pull"
  *
+ * The attribute file is kept open for the next reads.
+ *
  * @return
  * - LE_IO_ERROR if there was an error while reading the sysfs entry
  * - LE_BAD_PARAMETER if the path doesn't exist
@@ -239,39 +397,54 @@ static le_result_t ReadSysGpioSignalAttr
     char *attr               ///< [OUT] GPIO signal read attribute content
 )
 {
-    int i;
-    char c;
-    FILE *fp = NULL;
-    char *result = attr;
+    AttrFile_t* filePtr = GetAttrFile(path);
+    ssize_t count = -1;
+    int attempt;
 
-    if (!CheckGpioPathExist(path))
+    if (NULL == filePtr)
     {
-        LE_ERROR("File %s does not exist", path);
         return LE_BAD_PARAMETER;
     }
 
-    do
+    // A cached fd may be stale, so retry once with a freshly opened one.
+    for (attempt = 0; (attempt < 2) && (count < 0); attempt++)
     {
-        fp = fopen(path, "r");
-    }
-    while ((fp == NULL) && (errno == EINTR));
+        bool cached = (-1 != filePtr->readFd);
+        le_result_t result = OpenAttrFile(path, O_RDONLY, &filePtr->readFd);
 
-    if (!fp)
-    {
-        LE_ERROR("Error opening file %s for reading.\n", path);
-        return LE_IO_ERROR;
-    }
+        if (LE_BAD_PARAMETER == result)
+        {
+            LE_ERROR("File %s does not exist", path);
+            return result;
+        }
+        else if (LE_OK != result)
+        {
+            return result;
+        }
 
-    i = 0;
-    while (((c = fgetc(fp)) != EOF) && (i < (attr_size - 1)))
-    {
-        result[i] = c;
-        i++;
+        // sysfs attributes are read again from the start of the file.
+        do
+        {
+            count = pread(filePtr->readFd, attr, attr_size - 1, 0);
+        }
+        while ((count < 0) && (EINTR == errno));
+
+        if (count < 0)
+        {
+            int error = errno;
+
+            CloseAttrFile(&filePtr->readFd);
+            if (!cached)
+            {
+                LE_ERROR("Error reading file %s. Error %s", path, strerror(error));
+                return LE_IO_ERROR;
+            }
+        }
     }
-    result[i] = '\0';
-    fclose (fp);
 
-    LE_DEBUG("Read result: %s from %s", result, path);
+    attr[count] = '\0';
+
+    LE_DEBUG("Read result: %s from %s", attr, path);
 
     return LE_OK;
 }
@@ -304,6 +477,38 @@ static le_result_t WriteOutputValue
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Export a GPIO in the sysfs, if it is not exported already.
+ *
+ * @return
+ * - LE_OK if exporting was successful
+ * - LE_IO_ERROR if it failed
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_Export
+(
+    gpioSysfs_GpioRef_t gpioRef         ///< [IN] GPIO object reference
+)
+{
+    return ExportGpio(gpioRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the value of an output pin, without changing its direction.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_WriteValue
+(
+    gpioSysfs_GpioRef_t gpioRef,        ///< [IN] GPIO object reference
+    bool value                          ///< [IN] true = active, false = inactive
+)
+{
+    return WriteOutputValue(gpioRef, value ? SYSFS_VALUE_HIGH : SYSFS_VALUE_LOW);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rising or Falling of Edge sensitivity
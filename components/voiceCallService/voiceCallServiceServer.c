@@ -150,7 +150,7 @@ static le_hashmap_Ref_t VoiceCallCtxMap;
  * Safe Reference for Mcc Call Handler reference.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mcc_CallEventHandlerRef_t MccCallEventHandlerRef;
+static le_mcc_CallStateHandlerRef_t MccCallEventHandlerRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -215,6 +215,10 @@ static void VoiceSessionStateHandler
 (
     le_mcc_CallRef_t callRef,
     le_mcc_Event_t callEvent,
+    const char* telNumberPtr,
+    bool isIncoming,
+    le_mcc_TerminationReason_t term,
+    int32_t termCode,
     void* contextPtr
 )
 {
@@ -255,9 +259,9 @@ static void VoiceSessionStateHandler
                 // Retrieves call references.
                 newCtxPtr->mcc.callRef = callRef;
 
-                // Retrieves remote identifier.
-                le_mcc_GetRemoteTel(newCtxPtr->mcc.callRef, newCtxPtr->destination,
-                    MAX_DESTINATION_LEN_BYTE);
+                // Remote identifier is carried by the call state.
+                le_utf8_Copy(newCtxPtr->destination, telNumberPtr, MAX_DESTINATION_LEN_BYTE,
+                    NULL);
 
                 // Create an entry for reference of the link between mcc callRef and object context.
                 le_hashmap_Put(VoiceCallCtxMap, newCtxPtr->mcc.callRef, newCtxPtr);
@@ -309,9 +313,6 @@ static void VoiceSessionStateHandler
 
             if (ctxPtr)
             {
-                le_mcc_TerminationReason_t term = le_mcc_GetTerminationReason(
-                    ctxPtr->mcc.callRef);
-
                 ctxPtr->lastEvent = LE_VOICECALL_EVENT_TERMINATED;
 
                 switch (term)
@@ -605,8 +606,8 @@ le_voicecall_StateHandlerRef_t le_voicecall_AddStateHandler
 
     if ( MccCallEventHandlerRef == NULL)
     {
-        MccCallEventHandlerRef = le_mcc_AddCallEventHandler(VoiceSessionStateHandler,
-                                                                NULL);
+        MccCallEventHandlerRef = le_mcc_AddCallStateHandler(VoiceSessionStateHandler,
+                                                            NULL);
         LE_DEBUG("Mcc Call Event handler added");
     }
 
@@ -633,7 +634,7 @@ void le_voicecall_RemoveStateHandler
 
     if (MccCallEventHandlerRefCount == 0)
     {
-        le_mcc_RemoveCallEventHandler(MccCallEventHandlerRef);
+        le_mcc_RemoveCallStateHandler(MccCallEventHandlerRef);
         MccCallEventHandlerRef = NULL;
         LE_DEBUG("Mcc Call Event handler removed");
     }
@@ -13,6 +13,8 @@
 #include "interfaces.h"
 #include "watchdogChain.h"
 
+#include <sys/mman.h>
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum number of watchdogs supported by the watchdog chain.
@@ -34,6 +36,41 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_EVENT_LOOPS                  8
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The event loop checks are allowed to be late by their interval divided by this, so that they can
+ * share wake-ups with other timers.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHECK_SLACK_DIVISOR              8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The event loop checks are spaced by up to the process's watchdog timeout divided by this, so
+ * that the chain is kicked well before the watchdog expires.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHECK_TIMEOUT_DIVISOR            2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the shared memory kick slot: an array of uint64_t.  See le_wdog_OpenKickSlot().
+ */
+//--------------------------------------------------------------------------------------------------
+#define KICK_SLOT_TIME                   0
+#define KICK_SLOT_VALID                  1
+#define KICK_SLOT_BYTES                  (2 * sizeof(uint64_t))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * States of the process's kick slot.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KICK_SLOT_UNOPENED               0  ///< Not open; try to open it on the next kick.
+#define KICK_SLOT_OPENING                1  ///< Being opened by another thread.
+#define KICK_SLOT_OPEN                   2  ///< Mapped at KickSlotPtr.
+#define KICK_SLOT_UNAVAILABLE            3  ///< Not supported; always kick with le_wdog_Kick().
+
 /// Macro used to generate trace output in this module.
 /// Takes the same parameters as LE_DEBUG() et. al.
 #define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
@@ -85,6 +122,7 @@ typedef struct
 {
     uint32_t watchdog;                  ///< Watchdog to use for monitoring
     le_timer_Ref_t timer;               ///< The timer this watchdog uses
+    uint64_t checkPeriodUs;             ///< Longest time between two kicks of the event loop
     bool isConnected;                   ///< Is this thread connected to watchdog service
 }
 WatchdogObj_t;
@@ -98,8 +136,205 @@ static WatchdogObj_t* WatchdogList[MAX_WATCHDOGS];
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Timer to queue function to kick watchdog chain. If our queued function is called, it implies
- * the event loop is still running.
+ * Time of the last kick of each watchdog, in microseconds of le_clk_GetRelativeTime().  An event
+ * loop is only checked when its watchdog hasn't been kicked for a whole check period.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t KickTimeList[MAX_WATCHDOGS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Origin of the event loop checks, in microseconds of le_clk_GetRelativeTime().  The checks fall
+ * on multiples of their period from this time, so that the loops of the process are checked in
+ * the same wake-up.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t CheckOriginTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the process's kick slot.  Kicks go through the slot while it is open, so that the
+ * frequent kicks of a watchdog chain don't each need a message to the watchdog service.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t KickSlotState = KICK_SLOT_UNOPENED;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The process's kick slot, once mapped.  It is never unmapped, only replaced in place when a new
+ * slot is opened, so other threads can keep writing to it.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t* KickSlotPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in microseconds of le_clk_GetRelativeTime().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + now.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a kick slot from the watchdog service and map it.  Opening the slot kicks the watchdog.
+ *
+ * @return
+ *      - LE_OK if the slot is mapped at KickSlotPtr.
+ *      - LE_NOT_IMPLEMENTED if the watchdog service doesn't support kick slots.
+ *      - LE_FAULT for any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenKickSlot
+(
+    void
+)
+{
+    int fd = -1;
+    le_result_t result = le_wdog_OpenKickSlot(&fd);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    void* mapPtr = mmap(KickSlotPtr, KICK_SLOT_BYTES, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | ((KickSlotPtr != NULL) ? MAP_FIXED : 0), fd, 0);
+    close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_WARN("Failed to map watchdog kick slot (%m).");
+        return LE_FAULT;
+    }
+
+    KickSlotPtr = mapPtr;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick the process watchdog, through the kick slot if possible.
+ */
+//--------------------------------------------------------------------------------------------------
+static void KickProcessWatchdog
+(
+    void
+)
+{
+    uint32_t state = __atomic_load_n(&KickSlotState, __ATOMIC_ACQUIRE);
+
+    if (   (state == KICK_SLOT_OPEN)
+        && (__atomic_load_n(&(KickSlotPtr[KICK_SLOT_VALID]), __ATOMIC_ACQUIRE) != 0))
+    {
+        __atomic_store_n(&(KickSlotPtr[KICK_SLOT_TIME]), GetTimeUs(), __ATOMIC_RELEASE);
+        return;
+    }
+
+    // Open the slot if it hasn't been yet, or if the watchdog service has dropped it (as it does
+    // when the process's session closes).  Only one thread does this; the others kick by message.
+    if (   ((state == KICK_SLOT_UNOPENED) || (state == KICK_SLOT_OPEN))
+        && __sync_bool_compare_and_swap(&KickSlotState, state, KICK_SLOT_OPENING))
+    {
+        le_result_t result = OpenKickSlot();
+
+        if (result == LE_OK)
+        {
+            __atomic_store_n(&KickSlotState, KICK_SLOT_OPEN, __ATOMIC_RELEASE);
+            return;
+        }
+
+        __atomic_store_n(&KickSlotState,
+                         (result == LE_NOT_IMPLEMENTED) ? KICK_SLOT_UNAVAILABLE : state,
+                         __ATOMIC_RELEASE);
+    }
+
+    le_wdog_Kick();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the longest time between two kicks of an event loop, in microseconds: the requested interval,
+ * or a fraction of the process's watchdog timeout if that is longer.  Checking more often than that
+ * wouldn't catch a stuck loop any sooner, as the watchdog only expires at its timeout.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetCheckPeriod
+(
+    le_clk_Time_t watchdogInterval ///< Interval at which to check event loop is functioning
+)
+{
+    uint64_t periodUs = ((uint64_t)watchdogInterval.sec * 1000000) + watchdogInterval.usec;
+    uint64_t timeoutMs = 0;
+
+    if (   (le_wdog_GetWatchdogTimeout(&timeoutMs) == LE_OK)
+        && ((timeoutMs * 1000 / CHECK_TIMEOUT_DIVISOR) > periodUs))
+    {
+        periodUs = timeoutMs * 1000 / CHECK_TIMEOUT_DIVISOR;
+    }
+
+    return periodUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time of the next check of an event loop, in microseconds: the first multiple of its
+ * period after the last kick of its watchdog.  So a kick from the loop itself postpones the check.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetCheckTime
+(
+    WatchdogObj_t* watchdogPtr          ///< Watchdog of the event loop
+)
+{
+    uint64_t kickTime = __atomic_load_n(&KickTimeList[watchdogPtr->watchdog], __ATOMIC_RELAXED);
+
+    if (kickTime < CheckOriginTime)
+    {
+        kickTime = CheckOriginTime;
+    }
+
+    return CheckOriginTime +
+           (((kickTime - CheckOriginTime) / watchdogPtr->checkPeriodUs) + 1) *
+           watchdogPtr->checkPeriodUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule the next check of an event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleCheck
+(
+    WatchdogObj_t* watchdogPtr,         ///< Watchdog of the event loop
+    uint64_t now                        ///< Current time, in microseconds
+)
+{
+    uint64_t checkTime = GetCheckTime(watchdogPtr);
+    uint64_t delay = 0;
+
+    if (checkTime > now)
+    {
+        delay = checkTime - now;
+    }
+
+    le_timer_Stop(watchdogPtr->timer);
+    le_timer_SetInterval(watchdogPtr->timer,
+                         (le_clk_Time_t){ .sec = delay / 1000000, .usec = delay % 1000000 });
+    le_timer_Start(watchdogPtr->timer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer to kick watchdog chain. If our timer handler is called, it implies the event loop is still
+ * running.  The chain is not kicked if the watchdog was kicked since the check was scheduled.
  */
 //--------------------------------------------------------------------------------------------------
 static void CheckEventLoopHandler
@@ -109,6 +344,7 @@ static void CheckEventLoopHandler
 {
     WatchdogObj_t* watchdogPtr = le_timer_GetContextPtr(timerRef);
     uint32_t watchdog = watchdogPtr->watchdog;
+    uint64_t now = GetTimeUs();
 
     if (!watchdogPtr->timer)
     {
@@ -117,13 +353,21 @@ static void CheckEventLoopHandler
         return;
     }
 
-    if (IS_TRACE_ENABLED)
+    // Unless the watchdog was kicked since the check was scheduled
+    if (GetCheckTime(watchdogPtr) <= now)
     {
-        TRACE("Kicking watchdog chain: %d", watchdog);
+        if (IS_TRACE_ENABLED)
+        {
+            TRACE("Kicking watchdog chain: %d", watchdog);
+        }
+
+        // Also recorded here in case the kick can't reach the service, so that the next check is
+        // a period away.
+        __atomic_store_n(&KickTimeList[watchdog], now, __ATOMIC_RELAXED);
+        le_wdogChain_Kick(watchdog);
     }
 
-    le_wdogChain_Kick(watchdog);
-    le_timer_Restart(watchdogPtr->timer);
+    ScheduleCheck(watchdogPtr, now);
 }
 
 
@@ -150,7 +394,7 @@ void CheckChain
             TRACE("Watchdog chain is all kicked, kick watchdog.");
         }
 
-        le_wdog_Kick();
+        KickProcessWatchdog();
         __sync_and_and_fetch(&WatchdogChain, ((uint64_t)-(INT64_C(1) << MAX_WATCHDOGS)));
     }
 }
@@ -192,6 +436,9 @@ WatchdogObj_t* GetWatchdogChain
 //--------------------------------------------------------------------------------------------------
 /**
  * Begin monitoring the event loop on the current thread.
+ *
+ * The loop is checked at the longer of watchdogInterval and half the process's watchdog timeout,
+ * and not at all while its watchdog is kicked by other means.
  */
 //--------------------------------------------------------------------------------------------------
 void le_wdogChain_MonitorEventLoop
@@ -214,17 +461,6 @@ void le_wdogChain_MonitorEventLoop
         watchdogPtr->timer = NULL;
     }
 
-    if (watchdogPtr->timer == NULL)
-    {
-        char timerName[8];
-        snprintf(timerName, sizeof(timerName), "Chain%02d", watchdog);
-        watchdogPtr->timer = le_timer_Create(timerName);
-        le_timer_SetHandler(watchdogPtr->timer, CheckEventLoopHandler);
-        le_timer_SetContextPtr(watchdogPtr->timer, watchdogPtr);
-        le_timer_SetInterval(watchdogPtr->timer, watchdogInterval);
-        le_timer_SetWakeup(watchdogPtr->timer, false);
-    }
-
     if (!watchdogPtr->isConnected)
     {
         result = le_wdog_TryConnectService();
@@ -238,9 +474,30 @@ void le_wdogChain_MonitorEventLoop
         }
     }
 
+    if (watchdogPtr->timer == NULL)
+    {
+        char timerName[8];
+        snprintf(timerName, sizeof(timerName), "Chain%02d", watchdog);
+        watchdogPtr->checkPeriodUs = watchdogPtr->isConnected ?
+                                     GetCheckPeriod(watchdogInterval) :
+                                     ((uint64_t)watchdogInterval.sec * 1000000) +
+                                     watchdogInterval.usec;
+        LE_ASSERT(watchdogPtr->checkPeriodUs > 0);
+        watchdogPtr->timer = le_timer_Create(timerName);
+        le_timer_SetHandler(watchdogPtr->timer, CheckEventLoopHandler);
+        le_timer_SetContextPtr(watchdogPtr->timer, watchdogPtr);
+        le_timer_SetWakeup(watchdogPtr->timer, false);
+        le_timer_SetMsSlack(watchdogPtr->timer,
+                            watchdogPtr->checkPeriodUs / 1000 / CHECK_SLACK_DIVISOR);
+    }
+
+    // All the event loops of the process are checked on the same grid.
+    uint64_t now = GetTimeUs();
+    __sync_bool_compare_and_swap(&CheckOriginTime, 0, now);
+
     // Immediately kick watchdog, and schedule next kick.
     le_wdogChain_Kick(watchdog);
-    le_timer_Start(watchdogPtr->timer);
+    ScheduleCheck(watchdogPtr, now);
 }
 
 
@@ -278,6 +535,7 @@ void le_wdogChain_Kick
 
     uint32_t localWatchdogCount = WatchdogCount;
     LE_FATAL_IF(watchdog >= localWatchdogCount, "Trying to kick out of range watchdog");
+    __atomic_store_n(&KickTimeList[watchdog], GetTimeUs(), __ATOMIC_RELAXED);
     // Kick and start the watchdog.
     uint64_t watchdogChain = __sync_or_and_fetch(&WatchdogChain,
                                                    (UINT64_C(1) << watchdog)
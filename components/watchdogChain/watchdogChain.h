@@ -26,6 +26,9 @@ LE_SHARED void le_wdogChain_Init
 //--------------------------------------------------------------------------------------------------
 /**
  * Begin monitoring the event loop on the current thread.
+ *
+ * The loop is checked at the longer of watchdogInterval and half the process's watchdog timeout,
+ * and not at all while its watchdog is kicked by other means.
  */
 //--------------------------------------------------------------------------------------------------
 LE_SHARED void le_wdogChain_MonitorEventLoop
@@ -13,7 +13,7 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "internString.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
@@ -91,7 +91,7 @@ COMPONENT_INIT
     LE_DEBUG("** Config Tree, begin init.");
 
     // Initilize our internal subsystems.
-    dstr_Init();   // Dynamic strings.
+    istr_Init();   // Interned strings.
     rq_Init();     // Request queue.
     ni_Init();     // Node iterator.
     ti_Init();     // Tree iterator.
@@ -52,6 +52,72 @@ static ni_IteratorRef_t GetIteratorFromRef
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a sub-tree from a file descriptor onto the node at the given path, as part of the
+ *  iterator's transaction.
+ *
+ *  @return LE_OK if the import succeeded, LE_NOT_FOUND if the node could not be created, or
+ *          LE_FORMAT_ERROR if the data appears corrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ImportFromFd
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] Write iterator that is being used for the import.
+    int fid,                       ///< [IN] File descriptor to read the tree data from.
+    const char* nodePathPtr        ///< [IN] Path of the node to import onto.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t nodeRef = ni_TryCreateNode(iteratorRef, nodePathPtr);
+
+    if (nodeRef == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    LE_DEBUG("Importing config data.");
+
+    if (!tdb_ReadTreeNode(nodeRef, fid))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write the node at the given path and its children to a file descriptor, from the iterator's
+ *  transaction.
+ *
+ *  @return LE_OK if the export succeeded, LE_FAULT if the data could not be written.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ExportToFd
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] Iterator that is being used for the export.
+    int fid,                       ///< [IN] File descriptor to write the tree data to.
+    const char* nodePathPtr        ///< [IN] Path of the node to export.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("Exporting config data.");
+
+    if (tdb_WriteTreeNode(ni_GetNode(iteratorRef, nodePathPtr), fid) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Read a subset of the configuration tree from the given filePath. That tree then overwrites the
@@ -94,53 +160,90 @@ void le_cfgAdmin_ImportTree
         return;
     }
 
-    tdb_NodeRef_t nodeRef = ni_TryCreateNode(iteratorRef, nodePathPtr);
+    // Open the requested file.
+    LE_DEBUG("Opening file '%s'.", filePathPtr);
 
-    if (nodeRef == NULL)
+    int fid = -1;
+
+    do
     {
-        le_cfgAdmin_ImportTreeRespond(commandRef, LE_NOT_FOUND);
+        fid = open(filePathPtr, O_RDONLY);
     }
-    else
+    while ((fid == -1) && (errno == EINTR));
+
+    if (fid == -1)
     {
-        // Open the requested file.
-        LE_DEBUG("Opening file '%s'.", filePathPtr);
+        LE_ERROR("File '%s' could not be opened.", filePathPtr);
+        le_cfgAdmin_ImportTreeRespond(commandRef, LE_FAULT);
 
-        int fid = -1;
+        return;
+    }
+
+    // Now, attempt to import the requested data, and let the caller know we're done.
+    le_cfgAdmin_ImportTreeRespond(commandRef, ImportFromFd(iteratorRef, fid, nodePathPtr));
 
-        do
-        {
-            fid = open(filePathPtr, O_RDONLY);
-        }
-        while ((fid == -1) && (errno == EINTR));
+    // Close up the file and we're done.
+    close(fid);
+}
 
-        if (fid == -1)
-        {
-            LE_ERROR("File '%s' could not be opened.", filePathPtr);
-            le_cfgAdmin_ImportTreeRespond(commandRef, LE_FAULT);
 
-            return;
-        }
 
-        // Now, attempt to import the requested data.
-        LE_DEBUG("Importing config data.");
 
-        le_result_t result;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a subset of the configuration tree from a file descriptor supplied by the client. That
+ *  tree then overwrites the node at the given nodePath.
+ *
+ *  The whole sub-tree is transferred through the descriptor, so only this one request is needed
+ *  however large it is.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - Import was completed successfully.
+ *          - LE_NOT_FOUND     - The node could not be created.
+ *          - LE_FAULT         - No file descriptor was received.
+ *          - LE_FORMAT_ERROR  - Configuration data being imported appears corrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ImportTreeFromFd
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Write iterator that is being used for the
+                                            ///<      import.
+    int fd,                                 ///< [IN] Import the tree data from this descriptor.
+    const char* nodePathPtr                 ///< [IN] Where in the tree should this import happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Importing a tree from fd %d onto node '%s', using iterator, '%p'.",
+             fd, nodePathPtr, externalRef);
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
 
-        if (tdb_ReadTreeNode(nodeRef, fid))
-        {
-            result = LE_OK;
-        }
-        else
-        {
-            result = LE_FORMAT_ERROR;
-        }
+    if (fd < 0)
+    {
+        LE_ERROR("No file descriptor received for the import.");
+        le_cfgAdmin_ImportTreeFromFdRespond(commandRef, LE_FAULT);
 
-        // Let the caller know we're done.
-        le_cfgAdmin_ImportTreeRespond(commandRef, result);
+        return;
+    }
 
-        // Close up the file and we're done.
-        close(fid);
+    if (iteratorRef == NULL)
+    {
+        le_cfgAdmin_ImportTreeFromFdRespond(commandRef, LE_OK);
     }
+    else
+    {
+        le_cfgAdmin_ImportTreeFromFdRespond(commandRef,
+                                            ImportFromFd(iteratorRef, fd, nodePathPtr));
+    }
+
+    close(fd);
 }
 
 
@@ -203,19 +306,68 @@ void le_cfgAdmin_ExportTree
         return;
     }
 
+    le_result_t result = ExportToFd(iteratorRef, fid, nodePathPtr);
 
-    LE_DEBUG("Exporting config data.");
+    close(fid);
 
-    le_result_t result = LE_OK;
+    le_cfgAdmin_ExportTreeRespond(commandRef, result);
+}
 
-    if (tdb_WriteTreeNode(ni_GetNode(iteratorRef, nodePathPtr), fid) != LE_OK)
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Take a node given from nodePath and stream it and it's children to a file descriptor supplied
+ *  by the client.
+ *
+ *  This function uses the iterator's read transaction, and takes a snapshot of the current state of
+ *  the tree.  The whole sub-tree is transferred through the descriptor, so only this one request
+ *  is needed however large it is.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - Export was completed successfully.
+ *          - LE_FAULT         - An I/O error occurred while writing the data.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ExportTreeToFd
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator that is being used for the export.
+    int fd,                                 ///< [IN] Export the tree data to this descriptor.
+    const char* nodePathPtr                 ///< [IN] Where in the tree should this export happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Exporting a tree from node '%s' into fd %d, using iterator, '%p'.",
+             nodePathPtr, fd, externalRef);
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (fd < 0)
     {
-        result = LE_FAULT;
+        LE_ERROR("No file descriptor received for the export.");
+        le_cfgAdmin_ExportTreeToFdRespond(commandRef, LE_FAULT);
+
+        return;
     }
 
-    close(fid);
+    if (iteratorRef == NULL)
+    {
+        le_cfgAdmin_ExportTreeToFdRespond(commandRef, LE_OK);
+    }
+    else
+    {
+        le_cfgAdmin_ExportTreeToFdRespond(commandRef, ExportToFd(iteratorRef, fd, nodePathPtr));
+    }
 
-    le_cfgAdmin_ExportTreeRespond(commandRef, result);
+    close(fd);
 }
 
 
@@ -12,7 +12,6 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "treePath.h"
@@ -1197,6 +1196,61 @@ void le_cfg_SetBool
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read all of the nodes under a node in one go, packed into a buffer.
+ *
+ *  Valid for both read and write transactions.
+ *
+ *  If the path is empty, the nodes under the iterator's current node will be read.
+ *
+ *  \b Responds \b With:
+ *
+ *  This function will respond with one of the following values:
+ *
+ *          - LE_OK        - All of the remaining entries were read.
+ *          - LE_OVERFLOW  - The buffer was filled before all of the entries could be read.
+ *          - LE_NOT_FOUND - The node doesn't exist.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfg_GetSubtree
+(
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                       ///<      request.
+    le_cfg_IteratorRef_t externalRef,  ///< [IN] Iterator to use as a basis for the transaction.
+    const char* pathPtr,               ///< [IN] Absolute or relative path to read from.
+    uint32_t firstEntry,               ///< [IN] Number of entries to skip.
+    size_t dataSize                    ///< [IN] Maximum size of the result buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Reading the subtree under the iterator's <%p> current node.", externalRef);
+    LE_DEBUG_IF((pathPtr != NULL) && (strlen(pathPtr) != 0), "** Offset by \"%s\"", pathPtr);
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+    uint8_t buffer[LE_CFG_SUBTREE_BYTES];
+    size_t used = 0;
+    uint32_t entryCount = 0;
+    le_result_t result = LE_NOT_FOUND;
+
+    if (dataSize > sizeof(buffer))
+    {
+        dataSize = sizeof(buffer);
+    }
+
+    if ((NULL != pathPtr) && (NULL != iteratorRef)
+        && (false == CheckPathForSpecifier(pathPtr)))
+    {
+        used = dataSize;
+        result = ni_GetSubtree(iteratorRef, pathPtr, firstEntry, buffer, &used, &entryCount);
+    }
+
+    le_cfg_GetSubtreeRespond(commandRef, result, buffer, used, entryCount);
+}
+
+
+
+
 
 
 // -------------------------------------------------------------------------------------------------
@@ -0,0 +1,304 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file internString.c
+ *
+ *  A memory pool backed table of interned strings.
+ *
+ *  Each string is kept in a single block, allocated from a slab allocator so that the block fits
+ *  the string, and is reference counted using the memory pool's reference counts.  A hash map from
+ *  the text of each string to its block is used to find the existing copy of a string.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "internString.h"
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  An interned string.  The blocks holding these are sized to fit the text.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct IString
+{
+    size_t hash;  ///< Hash of the text.
+    char text[];  ///< The text of the string, NULL terminated.
+}
+IString_t;
+
+
+
+
+/// Size of the largest string, including its NULL terminator, that can be interned.
+#define MAX_STRING_BYTES LE_CFG_STR_LEN_BYTES
+
+
+/// Slab allocator used to manage the memory used by the interned strings.
+static le_mem_SlabRef_t StringSlabRef = NULL;
+
+
+/// Name of the interned string slab allocator.
+#define CFG_ISTR_SLAB_NAME "internString"
+
+
+/// Map of the text of each string to the string object.
+static le_hashmap_Ref_t StringMapRef = NULL;
+
+
+/// Name of the interned string map.
+#define CFG_ISTR_MAP_NAME "internStringMap"
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Called when the last reference to a string is released, to remove it from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StringDestructor
+(
+    void* objPtr  ///< [IN] The string being freed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    IString_t* stringPtr = objPtr;
+
+    le_hashmap_Remove(StringMapRef, stringPtr->text);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the interned string API and the internal memory resources it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Interned String subsystem.");
+
+    StringSlabRef = le_mem_CreateSlabAllocator(CFG_ISTR_SLAB_NAME,
+                                               sizeof(IString_t) + MAX_STRING_BYTES);
+    le_mem_SetSlabDestructor(StringSlabRef, StringDestructor);
+
+    // Most node names and values are short, so grow the smallest size class in bigger chunks.
+    le_mem_SetNumObjsToForce(le_mem_GetSlabPool(StringSlabRef, sizeof(IString_t) + 1), 100);
+
+    StringMapRef = le_hashmap_Create(CFG_ISTR_MAP_NAME,
+                                     1024,
+                                     le_hashmap_HashString,
+                                     le_hashmap_EqualsString);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a reference to the interned copy of a C-String, adding the string to the table if it isn't
+ *  already there.  Strings longer than the longest config string are truncated.
+ *
+ *  @return The reference.  It must be released with istr_Release() when no longer needed.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_New
+(
+    const char* strPtr  ///< [IN] The C-String to intern.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static char truncatedBuffer[MAX_STRING_BYTES];
+
+    LE_ASSERT(strPtr != NULL);
+
+    size_t size = strlen(strPtr) + 1;
+
+    if (size > MAX_STRING_BYTES)
+    {
+        LE_ERROR("String of %zu bytes truncated to %d bytes.", size - 1, MAX_STRING_BYTES - 1);
+
+        le_utf8_Copy(truncatedBuffer, strPtr, sizeof(truncatedBuffer), NULL);
+        strPtr = truncatedBuffer;
+        size = strlen(strPtr) + 1;
+    }
+
+    IString_t* stringPtr = le_hashmap_Get(StringMapRef, strPtr);
+
+    if (stringPtr != NULL)
+    {
+        le_mem_AddRef(stringPtr);
+        return stringPtr;
+    }
+
+    stringPtr = le_mem_ForceSlabAlloc(StringSlabRef, sizeof(IString_t) + size);
+
+    memcpy(stringPtr->text, strPtr, size);
+    stringPtr->hash = le_hashmap_HashString(stringPtr->text);
+
+    le_hashmap_Put(StringMapRef, stringPtr->text, stringPtr);
+
+    return stringPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look up a C-String in the table, without adding it.
+ *
+ *  @return The interned string, or NULL if nothing currently refers to that string.  No new
+ *          reference is taken on the string.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Find
+(
+    const char* strPtr  ///< [IN] The C-String to look for.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return le_hashmap_Get(StringMapRef, strPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Take another reference to an interned string.
+ *
+ *  @return The same string.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_AddRef
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    le_mem_AddRef(strRef);
+    return strRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to an interned string.  Once the last one is released, the string is removed
+ *  from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Release
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    le_mem_Release(strRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the text of an interned string.
+ *
+ *  @return A pointer to the text, valid for as long as a reference to the string is held.  An empty
+ *          string if the reference is NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* istr_GetCstr
+(
+    istr_Ref_t strRef  ///< [IN] The string, or NULL.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (strRef == NULL)
+    {
+        return "";
+    }
+
+    return strRef->text;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Copy the contents of an interned string into a regular C-style string.
+ *
+ *  @return LE_OK if the string fit properly within the bounds of the supplied string buffer.
+ *          LE_OVERFLOW if the string had to be truncated during the copy.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t istr_CopyToCstr
+(
+    char* destStrPtr,   ///< [OUT] The destiniation string buffer.
+    size_t destStrMax,  ///< [IN]  The maximum string the buffer can handle.
+    istr_Ref_t strRef   ///< [IN]  The interned string to copy to said buffer, or NULL.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return le_utf8_Copy(destStrPtr, istr_GetCstr(strRef), destStrMax, NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the hash of an interned string, as computed by le_hashmap_HashString().
+ *
+ *  @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetHash
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(strRef != NULL);
+
+    return strRef->hash;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Call to check the interned string if it's effectively empty.
+ *
+ *  @return A value of true if the string pointer is NULL or the data is an empty string.  False is
+ *          returned otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool istr_IsNullOrEmpty
+(
+    istr_Ref_t strRef  ///< [IN] The interned string object to check.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (strRef == NULL) || (strRef->text[0] == '\0');
+}
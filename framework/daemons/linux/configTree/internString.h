@@ -0,0 +1,172 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file internString.h
+ *
+ *  A table of interned strings.  Each distinct string is stored only once, no matter how many
+ *  references to it are taken, so interned strings can be compared by comparing their references.
+ *
+ *  Interned strings can't be modified.  To change a string, release the old reference and take one
+ *  to the new string instead.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_INTERN_STRING_INCLUDE_GUARD
+#define CFG_INTERN_STRING_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The interned string object pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct IString* istr_Ref_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Init the interned string API and the internal memory resources it depends on.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get a reference to the interned copy of a C-String, adding the string to the table if it isn't
+ *  already there.  Strings longer than the longest config string are truncated.
+ *
+ *  @return The reference.  It must be released with istr_Release() when no longer needed.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_New
+(
+    const char* strPtr  ///< [IN] The C-String to intern.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look up a C-String in the table, without adding it.
+ *
+ *  @return The interned string, or NULL if nothing currently refers to that string.  No new
+ *          reference is taken on the string.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_Find
+(
+    const char* strPtr  ///< [IN] The C-String to look for.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Take another reference to an interned string.
+ *
+ *  @return The same string.
+ */
+//--------------------------------------------------------------------------------------------------
+istr_Ref_t istr_AddRef
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Release a reference to an interned string.  Once the last one is released, the string is removed
+ *  from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+void istr_Release
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the text of an interned string.
+ *
+ *  @return A pointer to the text, valid for as long as a reference to the string is held.  An empty
+ *          string if the reference is NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* istr_GetCstr
+(
+    istr_Ref_t strRef  ///< [IN] The string, or NULL.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Copy the contents of an interned string into a regular C-style string.
+ *
+ *  @return LE_OK if the string fit properly within the bounds of the supplied string buffer.
+ *          LE_OVERFLOW if the string had to be truncated during the copy.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t istr_CopyToCstr
+(
+    char* destStrPtr,   ///< [OUT] The destiniation string buffer.
+    size_t destStrMax,  ///< [IN]  The maximum string the buffer can handle.
+    istr_Ref_t strRef   ///< [IN]  The interned string to copy to said buffer, or NULL.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the hash of an interned string, as computed by le_hashmap_HashString().
+ *
+ *  @return The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t istr_GetHash
+(
+    istr_Ref_t strRef  ///< [IN] The string.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Call to check the interned string if it's effectively empty.
+ *
+ *  @return A value of true if the string pointer is NULL or the data is an empty string.  False is
+ *          returned otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool istr_IsNullOrEmpty
+(
+    istr_Ref_t strRef  ///< [IN] The interned string object to check.
+);
+
+
+
+
+#endif
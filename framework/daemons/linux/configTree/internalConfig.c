@@ -89,6 +89,17 @@
  *  timeout then the client that owns the transaction is disconnected so that other pending
  *  transactions may continue.
  *
+ *  Trees are loaded from the filesystem when they are first read, and unloaded again once no
+ *  transaction has used them for the tree eviction timeout:
+ *
+@verbatim
+/
+  configTree/
+    treeEvictionTimeout<int> == 300
+@endverbatim
+ *
+ *  The timeout is in seconds, and defaults to 300.  A value of 0 keeps every tree loaded.
+ *
  * <HR>
  *
  *  Copyright (C) Sierra Wireless Inc.
@@ -135,6 +146,7 @@ static void OnGlobalConfigChanged
                                                      GLOBAL_CONFIG_PATH);
 
     TransactionTimeout = ni_GetNodeValueInt(iteratorRef, "transactionTimeout", 30);
+    tdb_SetTreeEvictionTimeout(ni_GetNodeValueInt(iteratorRef, "treeEvictionTimeout", 300));
     ni_Release(iteratorRef);
 }
 
@@ -12,6 +12,7 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "limit.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "internalConfig.h"
@@ -78,6 +79,112 @@ Iterator_t;
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Buffer being filled with the entries of a subtree, by ni_GetSubtree().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* bufferPtr;   ///< The buffer.
+    size_t bufferSize;    ///< Size of the buffer.
+    size_t used;          ///< Number of bytes of entries in the buffer.
+
+    uint32_t nextEntry;   ///< Index of the next entry found in the subtree.
+    uint32_t firstEntry;  ///< Entries found before this one are skipped.
+    uint32_t entryCount;  ///< Number of entries in the buffer.
+}
+SubtreeBuffer_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add entries for the children of a node, and for their children, to a subtree buffer.
+ *
+ *  @return false if the buffer filled up before all of the entries could be added.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AddSubtreeEntries
+(
+    SubtreeBuffer_t* subtreePtr,  ///< [IN] The buffer to add to.
+    tdb_NodeRef_t parentRef,      ///< [IN] The node whose children are to be added.
+    char* pathPtr,                ///< [IN] Buffer of LE_CFG_STR_LEN_BYTES holding the path of the
+                                  ///<      node, relative to the top of the subtree.
+    size_t pathLength             ///< [IN] Length of that path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static char valueBuffer[LE_CFG_STR_LEN_BYTES];
+
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(parentRef);
+
+    while (childRef != NULL)
+    {
+        // Build up the child's path on top of its parent's.
+        size_t childPathLength = pathLength;
+
+        if (pathLength > 0)
+        {
+            pathPtr[childPathLength++] = '/';
+        }
+
+        if (tdb_GetNodeName(childRef,
+                            pathPtr + childPathLength,
+                            LE_CFG_STR_LEN_BYTES - childPathLength) != LE_OK)
+        {
+            pathPtr[pathLength] = '\0';
+            LE_WARN("Skipping node under '%s', its path is too long.", pathPtr);
+
+            childRef = tdb_GetNextActiveSiblingNode(childRef);
+            continue;
+        }
+
+        childPathLength += strlen(pathPtr + childPathLength);
+
+        le_cfg_nodeType_t type = tdb_GetNodeType(childRef);
+
+        if (subtreePtr->nextEntry >= subtreePtr->firstEntry)
+        {
+            tdb_GetValueAsString(childRef, valueBuffer, sizeof(valueBuffer), "");
+
+            size_t valueLength = strlen(valueBuffer);
+            size_t entrySize = 1 + (childPathLength + 1) + (valueLength + 1);
+
+            if ((subtreePtr->used + entrySize) > subtreePtr->bufferSize)
+            {
+                return false;
+            }
+
+            uint8_t* entryPtr = subtreePtr->bufferPtr + subtreePtr->used;
+
+            entryPtr[0] = (uint8_t)type;
+            memcpy(entryPtr + 1, pathPtr, childPathLength + 1);
+            memcpy(entryPtr + 1 + childPathLength + 1, valueBuffer, valueLength + 1);
+
+            subtreePtr->used += entrySize;
+            subtreePtr->entryCount++;
+        }
+
+        subtreePtr->nextEntry++;
+
+        if (   (type == LE_CFG_TYPE_STEM)
+            && (AddSubtreeEntries(subtreePtr, childRef, pathPtr, childPathLength) == false))
+        {
+            return false;
+        }
+
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    pathPtr[pathLength] = '\0';
+    return true;
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Fetch a pointer to a printable string containing the name of a given transaction type.
@@ -212,6 +319,97 @@ static le_result_t CloneAndAppendPath
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check whether a sub-path can be walked on from the end of the iterator's path as it is, without
+ *  first being appended to a copy of the iterator's path.  That is the case if it is relative,
+ *  doesn't use "." or "..", and can't make the combined path too long.
+ *
+ *  @return True if it can, false if the sub-path has to be appended to a copy of the path.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPlainSubPath
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator to read.
+    const char* subPathPtr         ///< [IN] Optionally, a sub-path to traverse to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (subPathPtr == NULL)
+    {
+        return true;
+    }
+
+    le_pathIter_View_t pathView;
+    le_pathIter_GetView(iteratorRef->pathIterRef, &pathView);
+
+    // The combined path is never longer than the two paths with a separator between them.
+    if ((strlen(pathView.pathPtr) + 1 + strlen(subPathPtr)) >= LIMIT_MAX_PATH_BYTES)
+    {
+        return false;
+    }
+
+    le_pathIter_InitView(&pathView, subPathPtr, "/");
+
+    if (le_pathIter_ViewIsAbsolute(&pathView))
+    {
+        return false;
+    }
+
+    const char* namePtr;
+    size_t nameSize;
+
+    while (le_pathIter_ViewNext(&pathView, &namePtr, &nameSize) == LE_OK)
+    {
+        if (   ((nameSize == 1) && (namePtr[0] == '.'))
+            || ((nameSize == 2) && (memcmp(namePtr, "..", 2) == 0)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Walk the tree along the iterator's path and then along a plain sub-path (see IsPlainSubPath()),
+ *  without copying either path.
+ *
+ *  @return The node at the end of the walk, or NULL if the walk stopped short.
+ */
+//--------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t WalkPlainPath
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator to read.
+    tdb_NodeRef_t rootNodeRef,     ///< [IN] The root node of the iterator's tree.
+    const char* subPathPtr,        ///< [IN] Optionally, a sub-path to traverse to.
+    tdb_NodeRef_t (*walkFunc)(tdb_NodeRef_t, le_pathIter_View_t*)
+                                   ///< [IN] tdb_GetNode() or tdb_CreateNodePath().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_pathIter_View_t pathView;
+    le_pathIter_GetView(iteratorRef->pathIterRef, &pathView);
+
+    tdb_NodeRef_t nodeRef = walkFunc(rootNodeRef, &pathView);
+
+    if (   (nodeRef != NULL)
+        && (subPathPtr != NULL))
+    {
+        le_pathIter_InitView(&pathView, subPathPtr, "/");
+        nodeRef = walkFunc(nodeRef, &pathView);
+    }
+
+    return nodeRef;
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Init the node iterator subsystem and get it ready for use by the other subsystems in this
@@ -388,9 +586,14 @@ void ni_Commit
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (iteratorRef->type == NI_WRITE)
+    if (   (iteratorRef->type == NI_WRITE)
+        && (tdb_MergeTree(iteratorRef->treeRef) != LE_OK))
     {
-        tdb_MergeTree(iteratorRef->treeRef);
+        LE_ERROR("Changes made by user %u (%s) to tree %s conflict with changes committed by "
+                 "another transaction, and have been discarded.",
+                 tu_GetUserId(iteratorRef->userRef),
+                 tu_GetUserName(iteratorRef->userRef),
+                 tdb_GetTreeName(iteratorRef->treeRef));
     }
 }
 
@@ -610,6 +813,66 @@ void ni_ForEachIter
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move the read iterators that are active on a tree to a snapshot of the tree, so that changes
+ *  can be merged into the tree without waiting for them.  The iterators keep on reading the tree
+ *  as it was before those changes.
+ */
+// -------------------------------------------------------------------------------------------------
+void ni_SnapshotReaders
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree about to be changed, or a shadow of it.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef = tdb_GetOriginalTree(treeRef);
+
+    if (tdb_HasActiveReaders(treeRef) == false)
+    {
+        return;
+    }
+
+    tdb_TreeRef_t snapshotRef = tdb_SnapshotTree(treeRef);
+
+    if (snapshotRef == NULL)
+    {
+        return;
+    }
+
+    le_ref_IterRef_t refIterator = le_ref_GetIterator(IteratorRefMap);
+
+    while (le_ref_NextNode(refIterator) == LE_OK)
+    {
+        ni_IteratorRef_t iteratorRef = (ni_IteratorRef_t)le_ref_GetValue(refIterator);
+
+        if (   (iteratorRef != NULL)
+            && (iteratorRef->type == NI_READ)
+            && (iteratorRef->treeRef == treeRef))
+        {
+            LE_DEBUG("Moving read iterator <%p> to a snapshot of tree %s.",
+                     iteratorRef,
+                     tdb_GetTreeName(treeRef));
+
+            tdb_UnregisterIterator(treeRef, iteratorRef);
+
+            // The snapshot has a copy of every node, so find the iterator's node again in it.
+            le_pathIter_View_t pathView;
+            le_pathIter_GetView(iteratorRef->pathIterRef, &pathView);
+
+            iteratorRef->treeRef = snapshotRef;
+            iteratorRef->currentNodeRef = tdb_GetNode(tdb_GetRootNode(snapshotRef), &pathView);
+
+            tdb_RegisterIterator(snapshotRef, iteratorRef);
+        }
+    }
+
+    tdb_ReleaseTree(snapshotRef);
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Move the iterator to a different node in the current tree.
@@ -633,10 +896,10 @@ le_result_t ni_GoToNode
     if (result == LE_OK)
     {
         tdb_TreeRef_t treeRef = iteratorRef->treeRef;
+        le_pathIter_View_t pathView;
 
-        iteratorRef->currentNodeRef = tdb_GetNode(tdb_GetRootNode(treeRef),
-                                                  iteratorRef->pathIterRef);
-
+        le_pathIter_GetView(iteratorRef->pathIterRef, &pathView);
+        iteratorRef->currentNodeRef = tdb_GetNode(tdb_GetRootNode(treeRef), &pathView);
     }
 
     return result;
@@ -660,6 +923,13 @@ tdb_NodeRef_t ni_GetNode
 )
 //--------------------------------------------------------------------------------------------------
 {
+    tdb_NodeRef_t rootNodeRef = tdb_GetRootNode(iteratorRef->treeRef);
+
+    if (IsPlainSubPath(iteratorRef, subPathPtr))
+    {
+        return WalkPlainPath(iteratorRef, rootNodeRef, subPathPtr, tdb_GetNode);
+    }
+
     // Copy iterator's existing path, and append the new sub path to the copied path.  Once
     // that's done, attempt to find the requested node in the tree.  If the node still can not be
     // found, return NULL.
@@ -670,7 +940,10 @@ tdb_NodeRef_t ni_GetNode
         return NULL;
     }
 
-    tdb_NodeRef_t nodeRef = tdb_GetNode(tdb_GetRootNode(iteratorRef->treeRef), newPathRef);
+    le_pathIter_View_t pathView;
+    le_pathIter_GetView(newPathRef, &pathView);
+
+    tdb_NodeRef_t nodeRef = tdb_GetNode(rootNodeRef, &pathView);
 
     le_pathIter_Delete(newPathRef);
 
@@ -695,6 +968,22 @@ tdb_NodeRef_t ni_TryCreateNode
 )
 //--------------------------------------------------------------------------------------------------
 {
+    tdb_NodeRef_t rootNodeRef = tdb_GetRootNode(iteratorRef->treeRef);
+
+    // Attempt to find the node in the tree.  If not found attempt to create the new node in the
+    // tree.
+    if (IsPlainSubPath(iteratorRef, subPathPtr))
+    {
+        tdb_NodeRef_t nodeRef = WalkPlainPath(iteratorRef, rootNodeRef, subPathPtr, tdb_GetNode);
+
+        if (nodeRef == NULL)
+        {
+            nodeRef = WalkPlainPath(iteratorRef, rootNodeRef, subPathPtr, tdb_CreateNodePath);
+        }
+
+        return nodeRef;
+    }
+
     // Clone the iterator's original path and, if supplied, append the new sub path onto this new
     // path.
     le_pathIter_Ref_t newPathRef = NULL;
@@ -704,14 +993,15 @@ tdb_NodeRef_t ni_TryCreateNode
         return NULL;
     }
 
-    // Attempt to find the node in the tree.  If not found attempt to create the new node in the
-    // tree.
-    tdb_NodeRef_t rootNodeRef = tdb_GetRootNode(iteratorRef->treeRef);
-    tdb_NodeRef_t nodeRef = tdb_GetNode(rootNodeRef, newPathRef);
+    le_pathIter_View_t pathView;
+    le_pathIter_GetView(newPathRef, &pathView);
+
+    tdb_NodeRef_t nodeRef = tdb_GetNode(rootNodeRef, &pathView);
 
     if (nodeRef == NULL)
     {
-        nodeRef = tdb_CreateNodePath(rootNodeRef, newPathRef);
+        le_pathIter_GetView(newPathRef, &pathView);
+        nodeRef = tdb_CreateNodePath(rootNodeRef, &pathView);
     }
 
     le_pathIter_Delete(newPathRef);
@@ -1311,3 +1601,53 @@ void ni_SetNodeValueBool
         tdb_SetValueAsBool(nodeRef, value);
     }
 }
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read all of the nodes under a node into a buffer, in depth-first order.  Each entry holds the
+ *  node's type as a byte, then its path relative to the node read and its value as a string, both
+ *  NULL terminated.
+ *
+ *  @return LE_OK if all of the remaining entries were read, LE_OVERFLOW if the buffer filled up
+ *          first, or LE_NOT_FOUND if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSubtree
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    uint32_t firstEntry,           ///< [IN]     Number of entries to skip.
+    uint8_t* bufferPtr,            ///< [OUT]    The buffer to write the entries into.
+    size_t* bufferSizePtr,         ///< [IN/OUT] Size of the buffer on the way in, size of the
+                                   ///<          entries written on the way out.
+    uint32_t* entryCountPtr        ///< [OUT]    Number of entries written.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SubtreeBuffer_t subtree =
+        {
+            .bufferPtr = bufferPtr,
+            .bufferSize = *bufferSizePtr,
+            .used = 0,
+            .nextEntry = 0,
+            .firstEntry = firstEntry,
+            .entryCount = 0
+        };
+    char path[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = LE_NOT_FOUND;
+
+    tdb_NodeRef_t nodeRef = ni_GetNode(iteratorRef, pathPtr);
+
+    if (tdb_GetNodeType(nodeRef) != LE_CFG_TYPE_DOESNT_EXIST)
+    {
+        result = AddSubtreeEntries(&subtree, nodeRef, path, 0) ? LE_OK : LE_OVERFLOW;
+    }
+
+    *bufferSizePtr = subtree.used;
+    *entryCountPtr = subtree.entryCount;
+
+    return result;
+}
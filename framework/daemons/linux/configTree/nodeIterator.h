@@ -254,6 +254,21 @@ void ni_ForEachIter
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move the read iterators that are active on a tree to a snapshot of the tree, so that changes
+ *  can be merged into the tree without waiting for them.  The iterators keep on reading the tree
+ *  as it was before those changes.
+ */
+// -------------------------------------------------------------------------------------------------
+void ni_SnapshotReaders
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree about to be changed, or a shadow of it.
+);
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Move the iterator to a different node in the current tree.
@@ -612,4 +627,28 @@ void ni_SetNodeValueBool
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read all of the nodes under a node into a buffer, in depth-first order.  Each entry holds the
+ *  node's type as a byte, then its path relative to the node read and its value as a string, both
+ *  NULL terminated.
+ *
+ *  @return LE_OK if all of the remaining entries were read, LE_OVERFLOW if the buffer filled up
+ *          first, or LE_NOT_FOUND if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSubtree
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    uint32_t firstEntry,           ///< [IN]     Number of entries to skip.
+    uint8_t* bufferPtr,            ///< [OUT]    The buffer to write the entries into.
+    size_t* bufferSizePtr,         ///< [IN/OUT] Size of the buffer on the way in, size of the
+                                   ///<          entries written on the way out.
+    uint32_t* entryCountPtr        ///< [OUT]    Number of entries written.
+);
+
+
+
+
 #endif
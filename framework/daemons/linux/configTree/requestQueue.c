@@ -460,25 +460,29 @@ static void ProcessRequestQueue
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Check to see if the given tree is open for quick writes.
+ *  Check to see if the given node of a tree is open for quick writes.
  *
  *  @return True if a quick write can safely be performed.  False if not.
  */
 //--------------------------------------------------------------------------------------------------
 static bool CanQuickSet
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree to check.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree to check.
+    const char* pathPtr     ///< [IN] Path to the node to be written.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If there are active readers or writers on the tree then a quick write should be defered.
-    if (   (tdb_HasActiveReaders(treeRef) == false)
-        && (tdb_GetActiveWriteIter(treeRef) == NULL))
+    // If there is an active writer on the node's part of the tree then a quick write should be
+    // defered.
+    if (tdb_IsSubtreeWriteLocked(treeRef, pathPtr))
     {
-        return true;
+        return false;
     }
 
-    return false;
+    // Active readers carry on with a snapshot of the tree, unless the tree couldn't be snapshotted.
+    ni_SnapshotReaders(treeRef);
+
+    return tdb_HasActiveReaders(treeRef) == false;
 }
 
 
@@ -571,16 +575,14 @@ void rq_HandleCreateTxnRequest
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ni_IteratorRef_t writeIteratorRef = tdb_GetActiveWriteIter(treeRef);
-
+    // Writes wait for the writers on overlapping parts of the tree, reads only wait for commits.
     if (   (iterType == NI_READ)
-        && (writeIteratorRef != NULL)
-        && (ni_IsClosed(writeIteratorRef)))
+        && (tdb_HasClosedWriters(treeRef)))
     {
         QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
     }
     else if (   (iterType == NI_WRITE)
-             && (writeIteratorRef != NULL))
+             && (tdb_IsSubtreeWriteLocked(treeRef, pathPtr)))
     {
         QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
     }
@@ -623,6 +625,13 @@ void rq_HandleCommitTxnRequest
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Move any active readers to a snapshot of the tree, so that the commit doesn't have to wait
+    // for them to finish.
+    if (ni_IsWriteable(iteratorRef))
+    {
+        ni_SnapshotReaders(ni_GetTree(iteratorRef));
+    }
+
     if (ni_IsWriteable(iteratorRef) == false)
     {
         // Kill the iterator but do not try to comit it.
@@ -702,7 +711,7 @@ void rq_HandleQuickDeleteNode
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_DELETE_NODE,
                                                       userRef,
@@ -752,7 +761,7 @@ void rq_HandleQuickSetEmpty
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_EMPTY,
                                                       userRef,
@@ -848,7 +857,7 @@ void rq_HandleQuickSetString
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_STRING,
                                                       userRef,
@@ -935,7 +944,7 @@ void rq_HandleQuickSetInt
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_INT,
                                                       userRef,
@@ -1018,7 +1027,7 @@ void rq_HandleQuickSetFloat
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_FLOAT,
                                                       userRef,
@@ -1101,7 +1110,7 @@ void rq_HandleQuickSetBool
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (CanQuickSet(treeRef, pathPtr) == false)
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_BOOL,
                                                       userRef,
@@ -21,7 +21,7 @@
                                   |
                                   +--> Request Queue
                                   |
-                                  +--> Write Iterator Reference
+                                  +--> Write Lock List --*--> Write Iterator Reference
                                   |
                                   +--> Read Iterator Count
 
@@ -30,13 +30,18 @@
  *  The Tree Collection holds Tree objects. There's one Tree object for each configuration tree.
  *  They are indexed by tree name.
  *
- *  Each Tree object has a single "root" Node.
+ *  Each Tree object has a single "root" Node.  A Tree object is created as soon as its tree is
+ *  named, but the tree isn't loaded from the filesystem until its root Node is first read.  Trees
+ *  that no transaction has used for the tree eviction timeout are unloaded again, as long as all
+ *  of their contents are safely in the tree file and its delta log.
  *
  *  Each Node can have either a value or a list of child Nodes.
  *
  *  When a write transaction is started for a Tree, the iterator reference for that transaction
- *  is recorded in the Tree object.  When the transaction is committed or cancelled, that reference
- *  is cleared out.
+ *  is recorded in the Tree object's Write Lock List, along with the path the transaction started
+ *  at.  The transaction locks the subtree at that path, so other writes to that subtree, or to the
+ *  nodes above it, are queued until the transaction is committed or cancelled and its lock is
+ *  removed.  Writes to other subtrees can go ahead at the same time.
  *
  *  When a read transaction is started for a Tree, the count of read iterators in that Tree is
  *  incremented.  When it ends, the count is decremented.
@@ -65,45 +70,58 @@
  *  in it are applied to the "original" tree that the shadow tree was shadowing.  This process is
  *  called "merging".
  *
- *  Shadow Trees don't have handlers, request queues, write iterator references or read iterator
+ *  As other write transactions may have been committed to the tree since the shadow tree was
+ *  created, the changes are checked for conflicts with them before they are merged.  Each merge
+ *  increments the tree's generation, and stamps the nodes that it changes with the new generation.
+ *  A shadow tree records the generation of the tree it was created from.  Changing a node that has
+ *  since been stamped again or removed from the tree is a conflict, and the whole commit is then
+ *  discarded.  The original nodes that shadow nodes refer to are kept alive by those shadow nodes,
+ *  even after being removed from the tree.
+ *
+ *  Shadow Trees don't have handlers, request queues, write locks or read iterator
  *  counts.
  *
+ *  <b>Snapshots:</b>
+ *
+ *  Read transactions don't hold up commits.  When a change is about to be merged into a tree that
+ *  has read transactions active on it, a "Snapshot" of the tree is made: a copy of its nodes, in
+ *  which the parts of the tree still to be loaded from the tree file are shared with the tree.
+ *  The read iterators are moved over to the snapshot, and see the tree as it was when they started
+ *  until they are released.  The snapshot is freed along with the last of them.
+ *
  *  <b>Event Handler Registration:</b>
  *
  *  The config tree allows clients to register callbacks to be notified if certian sections of a
  *  configuration tree is modified.
  *
- *  The way this works is that a global hash map of registrations is maintained.  With the hash being
- *  generated from the path to the tree and node of interest.  So, if an program was interested in
- *  watching the apps collection in the system tree it would use the path:
+ *  The way this works is that registrations are kept in a tree of their own, the "Registration
+ *  Trie", with one level per path segment.  The top level holds a registration object for each tree
+ *  name, and each registration object holds one for each of the node names below it that something
+ *  has been registered on.  So, if an program was interested in watching the apps collection in the
+ *  system tree it would use the path:
  *
  *  @verbatim system:/apps @endverbatim
  *
- *  For each unique path a registration object is created, and that registration object will hold a
- *  list of event handlers for the node.
+ *  Which would be found in the registration object named "apps" under the one named "system".
+ *  Each registration object will hold a list of event handlers for the node.
  *
  * @verbatim
 
-    +------------------------+
-    | HandlerRegistrationMap |
-    +------------------------+
+    +--------------------------+
+    | TreeRegistrationList     |
+    +--------------------------+
       |
-      | Hash of 'system:/apps'  +--------------+
-      *------------------------>| Registration |
-                                +--------------+
+      | 'system'  +--------------+  List of handlers  +---------+
+      *---------->| Registration |--------------------| Handler |
+                  +--------------+                    +---------+
+                      |                                  |
+                      | 'apps'  +--------------+         +- Function Pointer
+                      *-------->| Registration |         +- Context Pointer
+                                +--------------+         +- Other data...
                                     |
                                     |  List of handlers  +---------+
                                     +--------------------| Handler |
                                     |                    +---------+
-                                    |                       |
-                                    |                       +- Function Pointer
-                                    |                       +- Context Pointer
-                                    |                       +- Other data...
-                                    |
-                                    |                    +---------+
-                                    +--------------------| Handler |
-                                    |                    +---------+
-                                    |
                                     .
                                     .
                                     .
@@ -113,27 +131,62 @@
  *  The system also employs the use of SafeRefs to keep track of each registered handler so that a
  *  handler can quickly and easily remove a handler as required.
  *
- *  When a merge occurs each modified node path is checked against the registration map.  If there
- *  is a registration object for that node each of the registered handlers is invoked.
+ *  When a merge occurs, the registration trie is walked down alongside the tree nodes being
+ *  merged.  Below a node that has no registration object, nothing can be registered, so the rest
+ *  of that branch of the merge doesn't need to look for any.  The registrations that are hit are
+ *  queued up, each one once no matter how many of the nodes below it have changed, and once the
+ *  merge is complete each queued registration's handlers are called once.
  *
- *  Handlers are registered in this hash map so that the target node doesn't need to actually exist
+ *  Handlers are registered in this trie so that the target node doesn't need to actually exist
  *  in order to have a handler registed for it.  In fact, a handler will be called when a node is
  *  deleted and when it is recreated.
  *
+ *  <b>Tree Files:</b>
+ *
+ *  Each tree is saved to its own file, in a compact binary format.  The file holds a record for
+ *  each node, with the children of a stem stored as consecutive records after the stem's own, and
+ *  a table of the node names and values, each distinct string being stored only once.  A checksum
+ *  covers the whole file.
+ *
+ *  A tree file is mapped read-only into memory when its tree is loaded, and only the root node is
+ *  created at first.  The children of a stem are created from their records the first time they're
+ *  needed.
+ *
+ *  Files in the older text format, which is still used to import and export trees, are converted
+ *  to the binary format when they're loaded.
+ *
+ *  <b>Delta Logs:</b>
+ *
+ *  Rewriting the whole tree file on every commit costs as much for a one value change as for a
+ *  full import.  So instead, the changes a commit merges into a tree are appended to the tree's
+ *  delta log, "<tree>.delta", next to its tree file.  Each entry in the log records the path of a
+ *  node that was set or deleted, with its new value, and has its own checksum.  The entries of
+ *  each commit are followed by a commit marker, so a commit that was only partly written when the
+ *  system went down is dropped when the log is replayed.
+ *
+ *  The log starts with the checksum of the tree file it applies to.  When a tree is loaded, its log
+ *  is replayed on top of its tree file, and a log for some other version of the tree file is thrown
+ *  away.  Once the log grows past DELTA_LOG_COMPACT_BYTES, the next commit writes out a new tree
+ *  file instead and the log is started over.
+ *
  *  Copyright (C) Sierra Wireless Inc.
  *
  */
 // -------------------------------------------------------------------------------------------------
 
 #include "legato.h"
+#include <sys/mman.h>
 #include "limit.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "internString.h"
 #include "treePath.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "sysPaths.h"
+#include "file.h"
+#include "cfgTreeFile.h"
+#include "user.h"
 
 
 
@@ -148,6 +201,49 @@
 
 
 
+/// Number of children a node needs before its children are indexed by name.
+#define CHILD_INDEX_THRESHOLD 16
+
+
+
+/// Number of hash buckets in a child index.  Must be a power of two.
+#define CHILD_INDEX_BUCKET_COUNT 128
+
+
+
+/// Size of the buffers used to write the records and the string table of a binary tree file.
+#define BIN_TREE_WRITE_BUFFER_BYTES 4096
+
+
+
+/// Most apps whose "system:/apps/<app>" snapshots are republished one by one after a commit to the
+/// system tree.  If a commit changes more apps than this, all of their snapshots are republished.
+#define SNAPSHOT_MAX_CHANGED_APPS 8
+
+
+
+/// Magic number at the start of a delta log.
+#define DELTA_LOG_MAGIC "LCFD"
+
+
+
+/// Version of the delta log format.
+#define DELTA_LOG_VERSION 1
+
+
+
+/// Size a delta log can grow to before the next commit rewrites the whole tree file instead.
+#define DELTA_LOG_COMPACT_BYTES (64 * 1024)
+
+
+
+/// Flags of a delta log entry.
+#define DELTA_RENAMED   0x1     ///< The node was renamed from the entry's old name.
+#define DELTA_CLEARED   0x2     ///< The node's value or children were cleared.
+#define DELTA_HAS_VALUE 0x4     ///< The entry holds the node's new value.
+
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -156,19 +252,17 @@
 //--------------------------------------------------------------------------------------------------
 typedef struct Registration
 {
-    char registrationPath[CFG_MAX_PATH_SIZE];  ///< Path to the node being watched.  This *must*
-                                               ///<   also include the tree name.
-    bool triggered;                            ///< Has this registration been triggered for
-                                               ///<   callback?
+    char name[LE_CFG_NAME_LEN_BYTES];     ///< Name of the node being watched, or of the tree for
+                                          ///<   the top level of the trie.
+    struct Registration* parentPtr;       ///< The registration above this one, NULL at the top
+                                          ///<   level.
+    le_dls_List_t childList;              ///< Registrations for the nodes below this one.
+    le_dls_Link_t siblingLink;            ///< Link in the parent's list of children.
 
-    union
-    {
-        le_dls_List_t handlerList;   ///< List of handlers to watch the specified node.
-        le_sls_Link_t link;          ///< When a client session is destroyed, all of it's handlers
-                                     ///<   are automatically removed.  If a registration object is
-                                     ///<   determined to be no longer required, this link is used
-                                     ///<   to queue the registration object for deletion.
-    };
+    bool triggered;                       ///< Has this registration been triggered for callback?
+    le_sls_Link_t triggeredLink;          ///< Link in the list of triggered registrations.
+
+    le_dls_List_t handlerList;            ///< List of handlers to watch the specified node.
 }
 Registration_t;
 
@@ -204,26 +298,6 @@ Handler_t;
 
 
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Context structure used during handler cleanup.  Handler cleanup happens when a configAPI session
- *  closes and we need to make sure that registered handlers are not leaked.
- *
- *  This structure is passed to the hashmap for each handler so that it can take care of the cleanup
- *  duties.
- */
-// -------------------------------------------------------------------------------------------------
-typedef struct CleanUpContext
-{
-    le_msg_SessionRef_t sessionRef;  ///< Reference to the session that had closed.
-    le_sls_List_t deleteQueue;       ///< Queue of Registration_t object to release as a result of
-                                     ///<   session being closed.
-}
-CleanUpContext_t;
-
-
-
-
 // -------------------------------------------------------------------------------------------------
 /**
  *  Flags that can be set on a node to allow the code to keep track of the various changes as
@@ -258,14 +332,27 @@ typedef struct Node
     tdb_NodeRef_t shadowRef;         ///< If this node is shadowing another then the pointer to
                                      ///<   that shadowed node is here.
 
-    dstr_Ref_t nameRef;              ///< The name of this node.
+    istr_Ref_t nameRef;              ///< The name of this node.
 
     le_dls_Link_t siblingList;       ///< The linked list of node siblings.  All of the nodes
                                      ///<   in this list have the same parent node.
 
+    size_t nameHash;                 ///< Hash of the node's name, while it is in its parent's
+                                     ///<   child index.
+    struct Node* nextInBucketRef;    ///< Next node in the same bucket of the parent's child index.
+    struct ChildIndex* childIndexPtr;///< Index of this node's children by name, or NULL if the
+                                     ///<   node doesn't have enough children to need one.
+
+    struct TreeImage* imagePtr;      ///< Image of the tree file that this node's children are
+                                     ///<   still to be loaded from, or NULL if they're loaded.
+    uint32_t imageRecord;            ///< Index of this node's record in that image.
+
+    uint32_t generation;             ///< Generation of the tree when a commit last changed this
+                                     ///<   node.  Only used in original trees.
+
     union
     {
-        dstr_Ref_t valueRef;         ///< The value of the node.  This is only valid if the
+        istr_Ref_t valueRef;         ///< The value of the node.  This is only valid if the
                                      ///<   node is not a stem.
 
         le_dls_List_t children;      ///< The linked list of children belonging to this node.
@@ -277,6 +364,22 @@ Node_t;
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Hash index of a node's children by name.  The sibling list still holds the children in order,
+ *  the index only speeds up finding a child by its name.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct ChildIndex
+{
+    Node_t* buckets[CHILD_INDEX_BUCKET_COUNT];  ///< Chains of children, linked through their
+                                                ///<   nextInBucketRef, by name hash.
+}
+ChildIndex_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Structure used to keep track of the trees loaded in the configTree daemon.
@@ -291,28 +394,215 @@ typedef struct Tree
     struct Tree* originalTreeRef;         ///< If non-NULL then this points back to the original
                                           ///<   tree this one is shadowing.
 
+    bool isSnapshot;                      ///< If true, this is a frozen copy of a tree, kept for
+                                          ///<   the read transactions that were active on the
+                                          ///<   tree when a change was made to it.
+
     char name[MAX_TREE_NAME_BYTES];       ///< The name of this tree.
 
     int revisionId;                       ///< The current revision,
                                           ///<   0 - Unknonwn.
                                           ///<   1, 2, 3 is one of the rock, paper, scissors revs.
 
-    Node_t* rootNodeRef;                  ///< The root node of this tree.
+    Node_t* rootNodeRef;                  ///< The root node of this tree.  NULL while the tree
+                                          ///<   isn't loaded.
+    le_clk_Time_t lastAccessTime;         ///< When a transaction was last started or finished on
+                                          ///<   this tree.
 
     ssize_t activeReadCount;              ///< Count of reads that are currently active on
                                           ///<   this tree.
-    ni_IteratorRef_t activeWriteIterRef;  ///< The parent write iterator that's active on
-                                          ///<   this tree.  NULL if there are no writes
-                                          ///<   pending.
+    le_dls_List_t writeLockList;          ///< The write iterators that are active on this tree,
+                                          ///<   with the subtrees they've locked.
+
+    uint32_t generation;                  ///< Number of commits merged into this tree.  For a
+                                          ///<   shadow tree, the generation of the original tree
+                                          ///<   when the shadow was created.
 
     le_sls_List_t requestList;            ///< Each tree maintains it's own list of pending
                                           ///<   requests.
+
+    bool canLogDeltas;                    ///< true if the tree file is in the binary format and
+                                          ///<   up to date, apart from the tree's delta log.
+    uint32_t baseCrc;                     ///< Checksum of that tree file.
+    off_t deltaLogSize;                   ///< Size of the tree's delta log, 0 if there's none.
 }
 Tree_t;
 
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A write transaction's lock on a subtree.  Write transactions on subtrees that don't overlap can
+ *  be active on a tree at the same time.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;              ///< Link in the tree's list of write locks.
+    ni_IteratorRef_t iteratorRef;    ///< The write iterator holding the lock.
+    char path[CFG_MAX_PATH_SIZE];    ///< Absolute path of the locked subtree.
+}
+WriteLock_t;
+
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apps whose "system:/apps/<app>" subtree is changed by a commit to the system tree.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isAll;             ///< true if any app may have been changed.
+    size_t count;           ///< Number of names in the list.
+    char names[SNAPSHOT_MAX_CHANGED_APPS][LE_CFG_NAME_LEN_BYTES];  ///< Names of the changed apps.
+}
+ChangedApps_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A binary tree file, mapped read-only into memory.  Nodes whose children haven't been loaded yet
+ *  hold a reference to the image.  Tree files are only ever replaced, never modified, so the
+ *  mapping stays valid until the last of those references is released.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct TreeImage
+{
+    void* mapPtr;                       ///< Address of the mapping.
+    size_t mapSize;                     ///< Size of the mapping, in bytes.
+    const BinTreeRecord_t* recordsPtr;  ///< The node records.
+    const char* stringsPtr;             ///< The string table.
+}
+TreeImage_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Buffered writer for a section of a binary tree file, or for entries appended to a delta log.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int descriptor;                              ///< The file being written.
+    off_t offset;                                ///< File offset the buffer will be written at.
+    size_t used;                                 ///< Number of bytes in the buffer.
+    le_result_t result;                          ///< LE_IO_ERROR once a write has failed.
+    uint8_t buffer[BIN_TREE_WRITE_BUFFER_BYTES]; ///< Data to write.
+}
+BinWriter_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A string written to the string table of the binary tree file being written.  The string isn't
+ *  copied, it's read back from the node it was taken from when needed.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;     ///< Link in the list of strings written so far.
+    size_t hash;            ///< Hash of the string.
+    tdb_NodeRef_t nodeRef;  ///< The node the string was taken from.
+    bool isValue;           ///< true if the string is the node's value, false if it's the name.
+    uint32_t offset;        ///< Offset of the string in the string table.
+}
+BinString_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header at the start of a delta log.
+ *
+ *  A delta log holds the changes committed to a tree since its tree file was last written, so that
+ *  a commit doesn't have to rewrite the whole file.  The header is followed by entries, each one
+ *  recording a change the merge made to a node.  The changes of each commit are followed by a
+ *  commit entry, changes without one are ignored.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[4];          ///< DELTA_LOG_MAGIC.
+    uint16_t version;       ///< DELTA_LOG_VERSION.
+    uint16_t reserved;      ///< Always zero.
+    uint32_t baseCrc;       ///< Checksum from the header of the tree file the log applies to.
+}
+DeltaLogHeader_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Kinds of delta log entries.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef enum
+{
+    DELTA_DELETE,       ///< A node was removed.
+    DELTA_SET,          ///< A node was created, renamed or given a new value.
+    DELTA_COMMIT        ///< End of the changes of a commit.
+}
+DeltaOp_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header of a delta log entry.  It is followed by the path of the node, its old name and its new
+ *  value, as null-terminated strings that are empty when not needed.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t size;          ///< Size of the entry, after this field and the next.
+    uint32_t crc;           ///< CRC32 of the entry, after this field.
+    uint8_t op;             ///< One of DeltaOp_t.
+    uint8_t type;           ///< The node's new BinNodeType_t, if it has a new value.
+    uint8_t flags;          ///< DELTA_RENAMED, DELTA_CLEARED and DELTA_HAS_VALUE.
+    uint8_t reserved;       ///< Always zero.
+}
+DeltaEntryHeader_t;
+
+
+
+/// Largest possible size of a delta log entry.
+#define DELTA_ENTRY_MAX_BYTES \
+    (sizeof(DeltaEntryHeader_t) + CFG_MAX_PATH_SIZE + LE_CFG_NAME_LEN_BYTES + LE_CFG_STR_LEN_BYTES)
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  State of a binary tree file being written.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    BinWriter_t records;        ///< Writer for the node records.
+    BinWriter_t strings;        ///< Writer for the string table.
+    uint32_t recordCount;       ///< Number of records written so far.
+    uint32_t stringsSize;       ///< Size of the string table so far.
+    le_sls_List_t stringList;   ///< The strings written so far.
+}
+BinTreeWriter_t;
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Types of lexical tokens that can be found in configuration data files.
@@ -341,6 +631,62 @@ static le_mem_PoolRef_t NodePoolRef = NULL;
 
 
 
+/// The memory pool responsible for child indexes.
+static le_mem_PoolRef_t ChildIndexPoolRef = NULL;
+
+/// The name of the memory pool that handles child indexes.
+#define CFG_CHILD_INDEX_POOL_NAME "childIndexPool"
+
+
+
+/// The node types that the types of the nodes in a binary tree file stand for.
+static const le_cfg_nodeType_t NodeTypesOfBinTypes[BIN_NODE_TYPE_COUNT] =
+    {
+        [BIN_NODE_EMPTY] = LE_CFG_TYPE_EMPTY,
+        [BIN_NODE_STRING] = LE_CFG_TYPE_STRING,
+        [BIN_NODE_BOOL] = LE_CFG_TYPE_BOOL,
+        [BIN_NODE_INT] = LE_CFG_TYPE_INT,
+        [BIN_NODE_FLOAT] = LE_CFG_TYPE_FLOAT,
+        [BIN_NODE_STEM] = LE_CFG_TYPE_STEM
+    };
+
+
+
+/// Writer for the delta log entries of the commit being merged.
+static BinWriter_t DeltaWriter;
+
+/// true while the changes of the commit being merged are being written to a delta log.
+static bool IsLoggingDeltas = false;
+
+/// Generation of the tree that the commit being merged is creating.
+static uint32_t MergeGeneration = 0;
+
+
+
+/// The memory pool responsible for mapped tree file images.
+static le_mem_PoolRef_t TreeImagePoolRef = NULL;
+
+/// The name of the memory pool that handles mapped tree file images.
+#define CFG_TREE_IMAGE_POOL_NAME "treeImagePool"
+
+
+
+/// The memory pool for the strings of the binary tree file being written.
+static le_mem_PoolRef_t BinStringPoolRef = NULL;
+
+/// The name of the memory pool for the strings of the binary tree file being written.
+#define CFG_BIN_STRING_POOL_NAME "binStringPool"
+
+
+
+/// Strings of the binary tree file being written, so that each one is only written once.
+static le_hashmap_Ref_t BinStringMapRef = NULL;
+
+/// Name of the binary tree file string map.
+#define CFG_BIN_STRING_MAP_NAME "binStringMap"
+
+
+
 /// The collection of configuration trees managed by the system.
 static le_hashmap_Ref_t TreeCollectionRef = NULL;
 
@@ -357,11 +703,33 @@ static le_mem_PoolRef_t TreePoolRef = NULL;
 
 
 
-/// Hash map to keep track of event registrations based on the registered node path.
-static le_hashmap_Ref_t HandlerRegistrationMap = NULL;
+/// Pool from which the write locks are allocated.
+static le_mem_PoolRef_t WriteLockPoolRef = NULL;
+
+/// Name of the write lock pool.
+#define CFG_WRITE_LOCK_POOL_NAME "writeLockPool"
+
+
+
+/// Timer that periodically unloads the trees that haven't been used for a while.
+static le_timer_Ref_t EvictionTimerRef = NULL;
+
+/// How long, in seconds, a tree can go unused before being unloaded, or 0 to never unload trees.
+static time_t EvictionTimeout = 0;
+
+
 
-/// Name of the registration hash map.
-#define CFG_HANDLER_REG_NAME "handlerLookupMap"
+/// Have the "system:/apps/<app>" snapshots been published since the daemon started?
+static bool AreAppSnapshotsPublished = false;
+
+
+
+/// Top level of the registration trie, a registration object for each tree that has handlers
+/// registered on it.
+static le_dls_List_t TreeRegistrationList = LE_DLS_LIST_INIT;
+
+/// Registrations that have been triggered by the merge in progress.
+static le_sls_List_t TriggeredList = LE_SLS_LIST_INIT;
 
 
 
@@ -544,29 +912,26 @@ static void ClearDeletedFlag
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node and fill out it's default information.
+ *  Get the name of a node.  Shadow nodes that haven't been renamed have the name of the node they
+ *  shadow.
  *
- *  @return The newly created node.
+ *  @return The interned name, or NULL if the node doesn't have one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewNode
+static istr_Ref_t GetNameRef
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Create a new blank node.
-    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
-
-    newNodeRef->parentRef = NULL;
-    newNodeRef->type = LE_CFG_TYPE_EMPTY;
-    ClearFlags(newNodeRef);
-    newNodeRef->shadowRef = NULL;
-    newNodeRef->nameRef = NULL;
-    newNodeRef->siblingList = LE_DLS_LINK_INIT;
-    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
+    if (   (IsShadow(nodeRef))
+        && (nodeRef->nameRef == NULL)
+        && (nodeRef->shadowRef != NULL))
+    {
+        return nodeRef->shadowRef->nameRef;
+    }
 
-    return newNodeRef;
+    return nodeRef->nameRef;
 }
 
 
@@ -574,104 +939,70 @@ static tdb_NodeRef_t NewNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  The node destructor function.  This will take care of freeing a node's string values and any
- *  children it may have.  Called automaticly by the memory system when a node is released.
+ *  Add a node to its parent's child index, if the parent has one.  The node is filed under its
+ *  current name.
  */
 // -------------------------------------------------------------------------------------------------
-static void NodeDestructor
+static void IndexNode
 (
-    void* objectPtr  ///< [IN] The generic object to free.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
-
-    if (nodeRef->nameRef)
+    if (   (nodeRef->parentRef == NULL)
+        || (nodeRef->parentRef->childIndexPtr == NULL))
     {
-        dstr_Release(nodeRef->nameRef);
+        return;
     }
 
-    switch (nodeRef->type)
-    {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            // Nothing to do here.
-            break;
+    ChildIndex_t* indexPtr = nodeRef->parentRef->childIndexPtr;
+    istr_Ref_t nameRef = GetNameRef(nodeRef);
 
-        case LE_CFG_TYPE_STRING:
-        case LE_CFG_TYPE_BOOL:
-        case LE_CFG_TYPE_INT:
-        case LE_CFG_TYPE_FLOAT:
-            if (nodeRef->info.valueRef)
-            {
-                dstr_Release(nodeRef->info.valueRef);
-            }
-            break;
+    nodeRef->nameHash = (nameRef != NULL) ? istr_GetHash(nameRef) : le_hashmap_HashString("");
 
-        case LE_CFG_TYPE_STEM:
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+    Node_t** bucketPtr = &indexPtr->buckets[nodeRef->nameHash & (CHILD_INDEX_BUCKET_COUNT - 1)];
 
-                while (childRef != NULL)
-                {
-                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
-
-                    le_mem_Release(childRef);
-                    childRef = nextChildRef;
-                }
-            }
-            break;
-    }
-
-    if (nodeRef->parentRef != NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
-        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
-        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
-
-        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
-    }
-}
+    nodeRef->nextInBucketRef = *bucketPtr;
+    *bucketPtr = nodeRef;
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
- *
- *  @return A new node that shadows the existing node.
+ *  Remove a node from its parent's child index, if the parent has one.  Must be called before the
+ *  node's name changes, or the node leaves its parent.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewShadowNode
+static void UnindexNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to remove.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Allocate a new blank node.
-    tdb_NodeRef_t newShadowRef = NewNode();
-
-    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
-    // be creating a shadow node for which no original exists.  Which is the case when creating a
-    // new path that didn't exist in the original tree.
-    if (nodeRef != NULL)
+    if (   (nodeRef->parentRef == NULL)
+        || (nodeRef->parentRef->childIndexPtr == NULL))
     {
-        newShadowRef->type = nodeRef->type;
-        newShadowRef->flags = nodeRef->flags;
-        newShadowRef->shadowRef = nodeRef;
+        return;
+    }
 
-        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
-        // same with this new node.
-        if (   (nodeRef->parentRef != NULL)
-            && (IsDeleted(nodeRef->parentRef)))
+    ChildIndex_t* indexPtr = nodeRef->parentRef->childIndexPtr;
+    Node_t** linkPtr = &indexPtr->buckets[nodeRef->nameHash & (CHILD_INDEX_BUCKET_COUNT - 1)];
+
+    while (*linkPtr != NULL)
+    {
+        if (*linkPtr == nodeRef)
         {
-            SetDeletedFlag(newShadowRef);
+            *linkPtr = nodeRef->nextInBucketRef;
+            nodeRef->nextInBucketRef = NULL;
+            return;
         }
+
+        linkPtr = &(*linkPtr)->nextInBucketRef;
     }
 
-    SetShadowFlag(newShadowRef);
-    return newShadowRef;
+    LE_FATAL("Node missing from its parent's child index.");
 }
 
 
@@ -679,48 +1010,28 @@ static tdb_NodeRef_t NewShadowNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new node and insert it into the given node's children collection.
- *
- *  @return The newly create node, already inserted into the supplied node's child collection.
+ *  Index the children of a node by name.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewChildNode
+static void BuildChildIndex
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node whose children are to be indexed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node is currently empty, then turn it into a stem.
-    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
-    {
-        nodeRef->type = LE_CFG_TYPE_STEM;
-    }
-
-    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
-
-    // Create a new node.  Then set it's parent to the given node
-    tdb_NodeRef_t newRef = NewNode();
+    LE_ASSERT(nodeRef->childIndexPtr == NULL);
 
-    newRef->parentRef = nodeRef;
-    newRef->type = LE_CFG_TYPE_EMPTY;
+    nodeRef->childIndexPtr = le_mem_ForceAlloc(ChildIndexPoolRef);
+    memset(nodeRef->childIndexPtr, 0, sizeof(ChildIndex_t));
 
-    // Get the new node to inheret the parent's shadow and deletion flags.
-    if (IsShadow(nodeRef))
-    {
-        SetShadowFlag(newRef);
-        SetDeletedFlag(newRef);
-    }
+    // Walk the list backwards, so that each bucket ends up in sibling order.
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&nodeRef->info.children);
 
-    if (IsDeleted(nodeRef))
+    while (linkPtr != NULL)
     {
-        SetDeletedFlag(newRef);
+        IndexNode(CONTAINER_OF(linkPtr, Node_t, siblingList));
+        linkPtr = le_dls_PeekPrev(&nodeRef->info.children, linkPtr);
     }
-
-    // Now make sure to add the new child node to the end of the parents collection.
-    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
-
-    // Finally return the newly created node to the caller.
-    return newRef;
 }
 
 
@@ -728,59 +1039,41 @@ static tdb_NodeRef_t NewChildNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to shadow a node's collection of children.
+ *  Drop the child index of a node, if it has one.  Called when the node's children are cleared.
  */
 // -------------------------------------------------------------------------------------------------
-static void ShadowChildren
+static void DropChildIndex
 (
-    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node whose child index is to be dropped.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the parent node isn't a stem then there isn't much else to do here.
-    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
-    {
-        return;
-    }
-
-    // Does this node have any children currently?  If yes, then we don't need to do anything else.
-    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
-    {
-        return;
-    }
-
-    // Has this node been modified?  If so, then the shadow children may have been cleared from
-    // this collection.
-    if (IsModified(shadowParentRef) == true)
+    if (nodeRef->childIndexPtr != NULL)
     {
-        return;
+        le_mem_Release(nodeRef->childIndexPtr);
+        nodeRef->childIndexPtr = NULL;
     }
+}
 
-    // This node has no shadow children.  So what we do now is check the original node... Does it
-    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
-    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
-    // this piecemeal and possibly out of order.
-    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
-
-    if (   (originalRef == NULL)
-        || (originalRef->type != LE_CFG_TYPE_STEM))
-    {
-        return;
-    }
 
-    // Simply iterate through the original collection and add a new shadow child to our own
-    // collection.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
 
-    while (originalChildRef != NULL)
-    {
-        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
-        newShadowRef->parentRef = shadowParentRef;
 
-        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a node to the end of a parent node's child collection.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddChild
+(
+    tdb_NodeRef_t parentRef,  ///< [IN] The parent node.
+    tdb_NodeRef_t childRef    ///< [IN] The new child, with its parentRef already set.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(childRef->parentRef == parentRef);
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
+    le_dls_Queue(&parentRef->info.children, &childRef->siblingList);
+    IndexNode(childRef);
 }
 
 
@@ -788,24 +1081,24 @@ static void ShadowChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Search up through a node tree until we find the root node.
+ *  Replace one of a node's strings with the interned copy of a new one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetRootParentNode
+static void SetString
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
+    istr_Ref_t* stringRefPtr,  ///< [IN/OUT] The node's string, or NULL if it doesn't have one.
+    const char* newPtr         ///< [IN]     The new string.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t parentRef = NULL;
+    istr_Ref_t newRef = istr_New(newPtr);
 
-    while (nodeRef != NULL)
+    if (*stringRefPtr != NULL)
     {
-        parentRef = nodeRef;
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        istr_Release(*stringRefPtr);
     }
 
-    return parentRef;
+    *stringRefPtr = newRef;
 }
 
 
@@ -813,53 +1106,35 @@ static tdb_NodeRef_t GetRootParentNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to look for a named child in a given node's child collection.
+ *  Allocate a new node and fill out it's default information.
  *
- *  @return Reference to the found child node, or NULL if a node was not found.
+ *  @return The newly created node.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetNamedChild
+static tdb_NodeRef_t NewNode
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is this one of the "special" names?
-    if (strcmp(nameRef, ".") == 0)
-    {
-        return nodeRef;
-    }
-
-    if (strcmp(nameRef, "..") == 0)
-    {
-        return nodeRef->parentRef;
-    }
-
-    // If the current node isn't a stem, then this node can't have any children.
-    if (nodeRef->type != LE_CFG_TYPE_STEM)
-    {
-        return NULL;
-    }
-
-    // Search the child list for a node with the given name.
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
-    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (currentRef != NULL)
-    {
-        tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
-
-        if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
-        {
-            return currentRef;
-        }
+    // Create a new blank node.
+    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
-    }
+    newNodeRef->parentRef = NULL;
+    newNodeRef->type = LE_CFG_TYPE_EMPTY;
+    ClearFlags(newNodeRef);
+    newNodeRef->shadowRef = NULL;
+    newNodeRef->nameRef = NULL;
+    newNodeRef->siblingList = LE_DLS_LINK_INIT;
+    newNodeRef->nameHash = 0;
+    newNodeRef->nextInBucketRef = NULL;
+    newNodeRef->childIndexPtr = NULL;
+    newNodeRef->imagePtr = NULL;
+    newNodeRef->imageRecord = 0;
+    newNodeRef->generation = 0;
+    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
 
-    // Looks like there was no node to return.
-    return NULL;
+    return newNodeRef;
 }
 
 
@@ -867,46 +1142,37 @@ static tdb_NodeRef_t GetNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to create a named child in a nodes child collection.  However, this function will only
- *  create nodes on shadow trees.
+ *  Get the type a node is stored as in binary tree files and delta logs.
  *
- *  @return Reference to newly created child node, or NULL if it can not be created.
+ *  @return The binary node type.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t CreateNamedChild
+static BinNodeType_t ToBinNodeType
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    le_cfg_nodeType_t type  ///< [IN] The node's type.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t childRef = NULL;
-
-    if (IsShadow(nodeRef) == true)
+    switch (type)
     {
-        // If the node isn't a stem, then convert it into an empty one now.
-        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
-        {
-            tdb_SetEmpty(nodeRef);
-            nodeRef->type = LE_CFG_TYPE_STEM;
-            nodeRef->info.children = LE_DLS_LIST_INIT;
-        }
+        case LE_CFG_TYPE_STRING:
+            return BIN_NODE_STRING;
 
-        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
-        childRef = NewChildNode(nodeRef);
-        SetDeletedFlag(childRef);
+        case LE_CFG_TYPE_BOOL:
+            return BIN_NODE_BOOL;
 
-        // Set the name of the new node, if that fails then the user had given us a bad name for the
-        // new node.  So in that case free the node and return NULL.
-        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
-        {
-            le_mem_Release(childRef);
-            childRef = NULL;
-        }
-    }
+        case LE_CFG_TYPE_INT:
+            return BIN_NODE_INT;
 
-    return childRef;
+        case LE_CFG_TYPE_FLOAT:
+            return BIN_NODE_FLOAT;
+
+        case LE_CFG_TYPE_STEM:
+            return BIN_NODE_STEM;
+
+        default:
+            return BIN_NODE_EMPTY;
+    }
 }
 
 
@@ -914,34 +1180,21 @@ static tdb_NodeRef_t CreateNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a given node exists within a node's child collection.
- *
- *  @return True if the given node exists within the parent node's collection.  False if not.
+ *  Release a node's reference to the tree file image that its children were still to be loaded
+ *  from, if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static bool NodeExists
+static void ReleaseImage
 (
-    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
-    const char* namePtr       ///< [IN] The name to search for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node in question.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
-    char currentName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (currentRef != NULL)
+    if (nodeRef->imagePtr != NULL)
     {
-        tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
-
-        if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
-        {
-            return true;
-        }
-
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+        le_mem_Release(nodeRef->imagePtr);
+        nodeRef->imagePtr = NULL;
     }
-
-    return false;
 }
 
 
@@ -949,28 +1202,45 @@ static bool NodeExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node type and see if it should have a string value.
- *
- *  @return True if the given node could hold a string value.  False if not.
+ *  Give a new node the type and value of a record in a tree file image.  If the record is a stem,
+ *  its children are only loaded when they're first needed.
  */
 // -------------------------------------------------------------------------------------------------
-static bool IsStringType
+static void SetNodeFromRecord
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+    tdb_NodeRef_t nodeRef,   ///< [IN] The node to update.
+    TreeImage_t* imagePtr,   ///< [IN] The image holding the record.
+    uint32_t recordIndex     ///< [IN] Index of the record in the image.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+    const BinTreeRecord_t* recordPtr = &imagePtr->recordsPtr[recordIndex];
 
-    if (   (type == LE_CFG_TYPE_STRING)
-        || (type == LE_CFG_TYPE_BOOL)
-        || (type == LE_CFG_TYPE_INT)
-        || (type == LE_CFG_TYPE_FLOAT))
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_EMPTY);
+    LE_ASSERT(nodeRef->imagePtr == NULL);
+
+    nodeRef->type = NodeTypesOfBinTypes[recordPtr->type];
+
+    switch (recordPtr->type)
     {
-        return true;
-    }
+        case BIN_NODE_EMPTY:
+            break;
 
-    return false;
+        case BIN_NODE_STEM:
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+
+            if (recordPtr->childCount > 0)
+            {
+                le_mem_AddRef(imagePtr);
+                nodeRef->imagePtr = imagePtr;
+                nodeRef->imageRecord = recordIndex;
+            }
+            break;
+
+        default:
+            nodeRef->info.valueRef = istr_New(imagePtr->stringsPtr + recordPtr->dataOffset);
+            break;
+    }
 }
 
 
@@ -978,34 +1248,41 @@ static bool IsStringType
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will copy a string value from an original tree node into a node that has shadowed
- *  it.
+ *  If a node's children are still to be loaded from a tree file image, load them now.
  */
 // -------------------------------------------------------------------------------------------------
-static void PropagateValue
+static void LoadChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node whose children are needed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node doesn't even have a ref to an original node, then there's nothing left to do
-    // here.
-    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
+    TreeImage_t* imagePtr = nodeRef->imagePtr;
 
-    if (shadowRef == NULL)
+    if (imagePtr == NULL)
     {
         return;
     }
 
-    // Ok, figure out the type for this node.  If it has a value, and the original
-    if (   (IsStringType(nodeRef) == true)
-        && (IsStringType(shadowRef) == true)
-        && (nodeRef->info.valueRef == NULL)
-        && (shadowRef->info.valueRef != NULL))
+    nodeRef->imagePtr = NULL;
+
+    const BinTreeRecord_t* recordPtr = &imagePtr->recordsPtr[nodeRef->imageRecord];
+
+    for (uint32_t i = 0; i < recordPtr->childCount; i++)
     {
-        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
-        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+        uint32_t childIndex = recordPtr->dataOffset + i;
+        const char* namePtr = imagePtr->stringsPtr + imagePtr->recordsPtr[childIndex].nameOffset;
+
+        tdb_NodeRef_t childRef = NewNode();
+
+        childRef->parentRef = nodeRef;
+        childRef->nameRef = istr_New(namePtr);
+        SetNodeFromRecord(childRef, imagePtr, childIndex);
+
+        AddChild(nodeRef, childRef);
     }
+
+    le_mem_Release(imagePtr);
 }
 
 
@@ -1013,116 +1290,102 @@ static void PropagateValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow node with the original it represents.
+ *  Take a node out of its parent's collection of children, and drop the parent's reference to it.
+ *  The node is kept around, detached from the tree, while a shadow node still refers to it.
  */
 // -------------------------------------------------------------------------------------------------
-static void MergeNode
+static void RemoveNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to remove.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
-
-    // If this shadow node for some reason doesn't have a ref check for an original version of it in
-    // the original tree.  This shadow node may have been destroyed and re-created loosing this
-    // link.
-    if (nodeRef->shadowRef == NULL)
-    {
-        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
-
-        if (shadowedParentRef != NULL)
-        {
-            char name[LE_CFG_NAME_LEN_BYTES] = "";
+    LE_ASSERT(nodeRef->parentRef != NULL);
+    LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
 
-            tdb_GetNodeName(nodeRef, name, sizeof(name));
-            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
-        }
-    }
+    UnindexNode(nodeRef);
+    le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+    nodeRef->parentRef = NULL;
 
-    // If this node has been marked as deleted, then simply drop the original node and move on.
-    if (IsDeleted(nodeRef))
-    {
-        if (   (nodeRef->shadowRef != NULL)
-            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
-        {
-            le_mem_Release(nodeRef->shadowRef);
-        }
-        else
-        {
-            // We delete every node but the root node.  Since this is the root node, we just need
-            // to clear it out.
-            tdb_SetEmpty(nodeRef->shadowRef);
-        }
+    le_mem_Release(nodeRef);
+}
 
-        return;
-    }
 
-    // If the original node doesn't exist, create it now.
-    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-    if (originalRef == NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef != NULL);
-        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
 
-        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
-    }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  The node destructor function.  This will take care of freeing a node's string values and any
+ *  children it may have.  Called automaticly by the memory system when a node is released.
+ */
+// -------------------------------------------------------------------------------------------------
+static void NodeDestructor
+(
+    void* objectPtr  ///< [IN] The generic object to free.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
 
-    ClearModifiedFlag(originalRef);
+    // Children that haven't been loaded don't need to be loaded just to be freed.
+    ReleaseImage(nodeRef);
 
-    // If the name has been changed, then copy it over now.
-    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
+    if (nodeRef->nameRef)
     {
-        if (originalRef->nameRef != NULL)
-        {
-            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
-        }
-        else
-        {
-            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
-        }
+        istr_Release(nodeRef->nameRef);
     }
 
-    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
-    // then clear out the original node.  If the types have changed, then clear out the original so
-    // that we can properly populate it again.
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
-
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != originalRef->type))
+    switch (nodeRef->type)
     {
-        tdb_SetEmpty(originalRef);
-    }
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            // Nothing to do here.
+            break;
 
-    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
-    // that it isn't a stem.  If not, then copy over the string value.
-    if (   (nodeType != LE_CFG_TYPE_EMPTY)
-        && (nodeType != LE_CFG_TYPE_STEM))
-    {
-        if (nodeRef->info.valueRef != NULL)
-        {
-            if (originalRef->info.valueRef != NULL)
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            if (nodeRef->info.valueRef)
             {
-                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
+                istr_Release(nodeRef->info.valueRef);
             }
-            else
+            break;
+
+        case LE_CFG_TYPE_STEM:
             {
-                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
+                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+                while (childRef != NULL)
+                {
+                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+
+                    RemoveNode(childRef);
+                    childRef = nextChildRef;
+                }
             }
+            break;
+    }
 
-            // Propigate over the type as that may have changed, like going from an int value to a
-            // bool value.
+    DropChildIndex(nodeRef);
 
-            originalRef->type = nodeRef->type;
-        }
+    // A shadow node keeps the node it shadows alive, in case a commit of another transaction
+    // removes that node from the original tree.
+    if (   (IsShadow(nodeRef))
+        && (nodeRef->shadowRef != NULL))
+    {
+        le_mem_Release(nodeRef->shadowRef);
     }
 
-    // Now at this point, if both the original and the shadow node are stems, we'll let the function
-    // InternalMergeTree take care of the children, (if any.)
+    if (nodeRef->parentRef != NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
+        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
+        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
 
-    // If the original has been cleared out, we can still just rely on InternalMergeTree to
-    // propigate over the new nodes.
+        UnindexNode(nodeRef);
+        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+    }
 }
 
 
@@ -1130,77 +1393,100 @@ static void MergeNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
- *  given path, nothing happens.
+ *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
+ *
+ *  @return A new node that shadows the existing node.
  */
 // -------------------------------------------------------------------------------------------------
-static void TriggerCallbacks
+static tdb_NodeRef_t NewShadowNode
 (
-    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Read the path out of the buffer.
-    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
-    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
-    {
-        LE_ERROR("Callback path buffer overflow.");
-        return;
-    }
-
-    // Try to find a registration object for this path.  If one is found, flag it for calling once
-    // the merge is complete.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
+    // Allocate a new blank node.
+    tdb_NodeRef_t newShadowRef = NewNode();
 
-    if (foundRegistrationPtr != NULL)
+    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
+    // be creating a shadow node for which no original exists.  Which is the case when creating a
+    // new path that didn't exist in the original tree.
+    if (nodeRef != NULL)
     {
-        foundRegistrationPtr->triggered = true;
+        newShadowRef->type = nodeRef->type;
+        newShadowRef->flags = nodeRef->flags;
+        newShadowRef->shadowRef = nodeRef;
+        le_mem_AddRef(nodeRef);
+
+        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
+        // same with this new node.
+        if (   (nodeRef->parentRef != NULL)
+            && (IsDeleted(nodeRef->parentRef)))
+        {
+            SetDeletedFlag(newShadowRef);
+        }
     }
-}
 
+    SetShadowFlag(newShadowRef);
+    return newShadowRef;
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Go through all of the registered event callbacks, and fire the call backs for each of the
- *  registrations that has been makred as triggered.
+ *  Make a copy of a node, and of all of its children.  Children that are still to be loaded from a
+ *  tree file image aren't copied, the copy loads them from the same image when they are needed.
  *
- *  Once this is done, the triggered flag is cleared for next time.
+ *  @return The new copy of the node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireTriggeredCallbacks
+static tdb_NodeRef_t CopyNode
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to copy.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Go through the registration map.
-    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
+    tdb_NodeRef_t copyRef = NewNode();
+
+    copyRef->type = nodeRef->type;
+
+    if (nodeRef->nameRef != NULL)
+    {
+        copyRef->nameRef = istr_AddRef(nodeRef->nameRef);
+    }
 
-    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
-        // For each registration, check to see if it was triggered.
-        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
+        copyRef->info.children = LE_DLS_LIST_INIT;
 
-        if (registrationPtr->triggered)
+        if (nodeRef->imagePtr != NULL)
+        {
+            le_mem_AddRef(nodeRef->imagePtr);
+            copyRef->imagePtr = nodeRef->imagePtr;
+            copyRef->imageRecord = nodeRef->imageRecord;
+        }
+        else
         {
-            // This registration has been triggered, so call all of the handlers attached to it.
-            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+            tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
-            while (linkPtr != NULL)
+            while (childRef != NULL)
             {
-                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+                tdb_NodeRef_t childCopyRef = CopyNode(childRef);
 
-                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
-                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
-            }
+                childCopyRef->parentRef = copyRef;
+                AddChild(copyRef, childCopyRef);
 
-            // Now that that's done, clear the triggered flag.
-            registrationPtr->triggered = false;
+                childRef = tdb_GetNextSiblingNode(childRef);
+            }
         }
     }
+    else if (nodeRef->info.valueRef != NULL)
+    {
+        copyRef->info.valueRef = istr_AddRef(nodeRef->info.valueRef);
+    }
+
+    return copyRef;
 }
 
 
@@ -1208,39 +1494,52 @@ static void FireTriggeredCallbacks
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node to see if it was renamed.
+ *  Create a new node and insert it into the given node's children collection.
  *
- *  @return True if the node was renamed within this transaction.  False if not.
+ *  @return The newly create node, already inserted into the supplied node's child collection.
  */
 // -------------------------------------------------------------------------------------------------
-static bool WasRenamed
+static tdb_NodeRef_t NewChildNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (IsModified(nodeRef) == false)
+    // Make sure the new child ends up after any children still to be loaded.
+    LoadChildren(nodeRef);
+
+    // If the node is currently empty, then turn it into a stem.
+    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
     {
-        // The node wasn't even modified, so it can not have been renamed.
-        return false;
+        nodeRef->type = LE_CFG_TYPE_STEM;
+        DropChildIndex(nodeRef);
     }
 
-    if (nodeRef->shadowRef == NULL)
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+
+    // Create a new node.  Then set it's parent to the given node
+    tdb_NodeRef_t newRef = NewNode();
+
+    newRef->parentRef = nodeRef;
+    newRef->type = LE_CFG_TYPE_EMPTY;
+
+    // Get the new node to inheret the parent's shadow and deletion flags.
+    if (IsShadow(nodeRef))
     {
-        // If the node doesn't have a shadow reference, then most likely this is a new node and not
-        // a rename of an existing one.
-        return false;
+        SetShadowFlag(newRef);
+        SetDeletedFlag(newRef);
     }
 
-    if (nodeRef->nameRef == NULL)
+    if (IsDeleted(nodeRef))
     {
-        // The shadow node does not have a local copy of a name, so it can not have been renamed.
-        // It must have been modified for other reasons.
-        return false;
+        SetDeletedFlag(newRef);
     }
 
-    // Looks like the node has a new name.
-    return true;
+    // Now make sure to add the new child node to the end of the parents collection.
+    AddChild(nodeRef, newRef);
+
+    // Finally return the newly created node to the caller.
+    return newRef;
 }
 
 
@@ -1248,100 +1547,59 @@ static bool WasRenamed
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the original non-shadow node to see if it will need to be cleared during the merge.
- *
- *  @return True if the merge will clear out the original value.  False if not.
+ *  Called to shadow a node's collection of children.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OriginalToBeCleared
+static void ShadowChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
-
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    // If the parent node isn't a stem then there isn't much else to do here.
+    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
     {
-        return true;
+        return;
     }
 
-    return false;
-}
-
-
-
-
-// -------------------------------------------------------------------------------------------------
-/**
- *  Append the name of a node onto the end of a path object.
- */
-// -------------------------------------------------------------------------------------------------
-static void AppendNodeName
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-    le_result_t result = le_pathIter_Append(pathRef, nodeName);
-
-    LE_WARN_IF(result != LE_OK,
-               "Could not append node '%s' onto the update callback tracking path.  "
-               "Reason: %d, '%s'.",
-               nodeName,
-               result,
-               LE_RESULT_TXT(result));
-}
-
-
+    // Does this node have any children currently?  If yes, then we don't need to do anything else.
+    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
+    {
+        return;
+    }
 
+    // Has this node been modified?  If so, then the shadow children may have been cleared from
+    // this collection.
+    if (IsModified(shadowParentRef) == true)
+    {
+        return;
+    }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Create a new config path for the tree name given.
- *
- *  @return A new config path, rooted on the given tree.
- */
-// -------------------------------------------------------------------------------------------------
-static le_pathIter_Ref_t CreateBasePath
-(
-    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
+    // This node has no shadow children.  So what we do now is check the original node... Does it
+    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
+    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
+    // this piecemeal and possibly out of order.
+    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
 
-    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
-    return le_pathIter_CreateForUnix(basePath);
-}
+    if (   (originalRef == NULL)
+        || (originalRef->type != LE_CFG_TYPE_STEM))
+    {
+        return;
+    }
 
+    // Simply iterate through the original collection and add a new shadow child to our own
+    // collection.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
 
+    while (originalChildRef != NULL)
+    {
+        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
+        newShadowRef->parentRef = shadowParentRef;
 
+        AddChild(shadowParentRef, newShadowRef);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Generate a config path to the given node.
- */
-// -------------------------------------------------------------------------------------------------
-static void GeneratePath
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    if (nodeRef == NULL)
-    {
-        return;
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
     }
-
-    GeneratePath(pathRef, nodeRef->parentRef);
-    AppendNodeName(pathRef, nodeRef);
 }
 
 
@@ -1349,36 +1607,24 @@ static void GeneratePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Trigger callbacks for this node and all of it's children.
+ *  Search up through a node tree until we find the root node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireAllChildren
+static tdb_NodeRef_t GetRootParentNode
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Add this node to the path we're using to find registered callbacks.
-    AppendNodeName(pathRef, nodeRef);
+    tdb_NodeRef_t parentRef = NULL;
 
-    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
-    // there are no callbacks registered for those nodes, then nothing will happen.
-    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    while (nodeRef != NULL)
     {
-        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
-
-        while (childRef != NULL)
-        {
-            FireAllChildren(pathRef, childRef);
-            childRef = tdb_GetNextSiblingNode(childRef);
-        }
+        parentRef = nodeRef;
+        nodeRef = tdb_GetNodeParent(nodeRef);
     }
 
-    // Like with the children, try to do the same for this node.  Then remove this node from the
-    // tracking path.
-    TriggerCallbacks(pathRef);
-    le_pathIter_Truncate(pathRef);
+    return parentRef;
 }
 
 
@@ -1386,82 +1632,85 @@ static void FireAllChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check a given shadow node and the original node it's shadowing.  If the original has children
- *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
- *  about to go away.
- *
- *  The algorithm employed by this function is as follows:
- *
- *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
- *         mark all of the children as deleted.  (This is done with the expectation that the
- *         original tree does not have nodes with the deleted flag set.)
- *
- *      2. Go through the shadow collection, and any shadow children that have links to the original
- *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *  Search a node's child collection for a child with the given name.  Nodes with many children
+ *  get their children indexed by name the first time they are searched.
  *
- *      3. Travers the original children one more time.  For any node that is still marked as
- *         deleted we queue up an event handler.  As this node has been removed from the colection
- *         and will be removed as part of the final merge.  The delete flag is also cleared at this
- *         step to ensure that there are no external side effects.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireLostChildren
+static tdb_NodeRef_t FindChild
 (
-    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t parentRef,  ///< [IN] The node to search.
+    const char* namePtr       ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is the original a stem?  If no, then done.
-    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
+    // Getting the first child also pulls in the children of a shadowed node, which has to be done
+    // before their names are looked up.
+    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
 
-    if (originalRef->type != LE_CFG_TYPE_STEM)
+    // Unnamed nodes aren't unique, so they are always looked for in sibling order.
+    if (namePtr[0] == '\0')
     {
-        return;
+        while (   (currentRef != NULL)
+               && (istr_IsNullOrEmpty(GetNameRef(currentRef)) == false))
+        {
+            currentRef = tdb_GetNextSiblingNode(currentRef);
+        }
+
+        return currentRef;
     }
 
-    // Mark all originals deleted.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+    // Names are interned, so if nothing has this name, no child can have it, and otherwise the
+    // children's names only need to be compared with the interned one.
+    istr_Ref_t nameRef = istr_Find(namePtr);
 
-    while (originalChildRef != NULL)
+    if (nameRef == NULL)
     {
-        // Children in the original tree shouldn't currently be marked as deleted.
-        LE_ASSERT(IsDeleted(originalChildRef) == false);
-
-        SetDeletedFlag(originalChildRef);
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        return NULL;
     }
 
-    // Follow through all of the shadow links and unmark deletions.
-    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    if (parentRef->childIndexPtr != NULL)
     {
-        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
+        size_t hash = istr_GetHash(nameRef);
 
-        while (shadowChildRef != NULL)
+        currentRef = parentRef->childIndexPtr->buckets[hash & (CHILD_INDEX_BUCKET_COUNT - 1)];
+
+        while (currentRef != NULL)
         {
-            if (shadowChildRef->shadowRef != NULL)
+            if (GetNameRef(currentRef) == nameRef)
             {
-                ClearDeletedFlag(shadowChildRef->shadowRef);
+                return currentRef;
             }
 
-            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+            currentRef = currentRef->nextInBucketRef;
         }
+
+        return NULL;
     }
 
-    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
-    // in order to leave everything as it was.
-    originalChildRef = tdb_GetFirstChildNode(originalRef);
+    size_t childCount = 0;
 
-    while (originalChildRef != NULL)
+    while (currentRef != NULL)
     {
-        if (IsDeleted(originalChildRef) == true)
+        if (GetNameRef(currentRef) == nameRef)
         {
-            FireAllChildren(pathRef, originalChildRef);
-            ClearDeletedFlag(originalChildRef);
+            return currentRef;
         }
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        childCount++;
+        currentRef = tdb_GetNextSiblingNode(currentRef);
+    }
+
+    // The whole collection was walked without finding the name.  If it is big, index it so that
+    // the next search doesn't have to do that again.
+    if (   (childCount >= CHILD_INDEX_THRESHOLD)
+        && (parentRef->childIndexPtr == NULL))
+    {
+        BuildChildIndex(parentRef);
     }
+
+    return NULL;
 }
 
 
@@ -1469,93 +1718,36 @@ static void FireLostChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *  Called to look for a named child in a given node's child collection.
  *
- *  @return True if the given node or any if it's children have been modified.  False if not.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static bool InternalMergeTree
+static tdb_NodeRef_t GetNamedChild
 (
-    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
-    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
-    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
-                                ///<      children, regardless of wether or not this node has been
-                                ///<      directly modified?
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool isModified = IsModified(nodeRef);
-    bool renamed = WasRenamed(nodeRef);
-
-    // If this node was renamed, then all children also need to be triggered as well.
-    forceFire = renamed || forceFire;
-
-    // If this node has been renamed, marked as deleted or set empty, then all of the children need
-    // notifications fired on the original nodes.
-    if (   (renamed == true)
-        || (IsDeleted(nodeRef) == true)
-        || (OriginalToBeCleared(nodeRef) == true))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        if (nodeRef->shadowRef != NULL)
-        {
-            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
-            FireAllChildren(originalPathRef, nodeRef->shadowRef);
-        }
-
-        le_pathIter_Delete(originalPathRef);
-    }
-    else if (   (isModified == true)
-             && (nodeRef->type == LE_CFG_TYPE_STEM))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        GeneratePath(originalPathRef, nodeRef->shadowRef);
-        FireLostChildren(originalPathRef, nodeRef);
-
-        le_pathIter_Delete(originalPathRef);
-    }
-
-    AppendNodeName(pathRef, nodeRef);
-
-    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
-    // track of whether any of those children have been modified as well.
-    if (isModified)
-    {
-        MergeNode(nodeRef);
-    }
-
-    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
-        && (IsDeleted(nodeRef) == false))
+    // Is this one of the "special" names?
+    if (strcmp(nameRef, ".") == 0)
     {
-        nodeRef = tdb_GetFirstChildNode(nodeRef);
-
-        while (nodeRef != NULL)
-        {
-            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
-
-            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
-            nodeRef = nextNodeRef;
-        }
+        return nodeRef;
     }
 
-    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
-    // be registered.
-    if (isModified || forceFire)
+    if (strcmp(nameRef, "..") == 0)
     {
-        TriggerCallbacks(pathRef);
+        return nodeRef->parentRef;
     }
 
-    // Now remove this node from the tracking path and let our caller know if any modifications have
-    // happened at this level or lower.
-    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
+    // If the current node isn't a stem, then this node can't have any children.
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
     {
-        le_pathIter_Truncate(pathRef);
+        return NULL;
     }
 
-    return isModified;
+    return FindChild(nodeRef, nameRef);
 }
 
 
@@ -1563,31 +1755,46 @@ static bool InternalMergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new tree object and set it to default values.
+ *  Called to create a named child in a nodes child collection.  However, this function will only
+ *  create nodes on shadow trees.
  *
- *  @return A ref to the newly created tree object.
+ *  @return Reference to newly created child node, or NULL if it can not be created.
  */
 // -------------------------------------------------------------------------------------------------
-tdb_TreeRef_t NewTree
+static tdb_NodeRef_t CreateNamedChild
 (
-    const char* treeNameRef,   ///< [IN] The name of the new tree.
-    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
+    tdb_NodeRef_t childRef = NULL;
 
-    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+    if (IsShadow(nodeRef) == true)
+    {
+        // If the node isn't a stem, then convert it into an empty one now.
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
+        {
+            tdb_SetEmpty(nodeRef);
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+        }
 
-    treeRef->isDeletePending = false;
-    treeRef->originalTreeRef = NULL;
-    treeRef->revisionId = 0;
-    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
-    treeRef->activeReadCount = 0;
-    treeRef->activeWriteIterRef = NULL;
-    treeRef->requestList = LE_SLS_LIST_INIT;
+        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
+        childRef = NewChildNode(nodeRef);
+        SetDeletedFlag(childRef);
 
-    return treeRef;
+        // Set the name of the new node, if that fails then the user had given us a bad name for the
+        // new node.  So in that case free the node and return NULL.
+        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+        {
+            RemoveNode(childRef);
+            childRef = NULL;
+        }
+    }
+
+    return childRef;
 }
 
 
@@ -1595,67 +1802,48 @@ tdb_TreeRef_t NewTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Destructor called when a tree object is to be freed from memory.
+ *  Check to see if a given node exists within a node's child collection.
+ *
+ *  @return True if the given node exists within the parent node's collection.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void TreeDestructor
+static bool NodeExists
 (
-    void* objectPtr  ///< The memory object to destruct.
+    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
-
-    // Kill the root node.
-    le_mem_Release(treeRef->rootNodeRef);
-    treeRef->rootNodeRef = NULL;
-
-    // Sanity check, is the tree actually ready to clean up?
-    LE_ASSERT(treeRef->activeReadCount == 0);
-    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
-}
+    return FindChild(parentRef, namePtr) != NULL;
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a path to a tree file with the given revision id.
+ *  Check the given node type and see if it should have a string value.
  *
- *  @return A stringBuffer backed string containing the full path to the tree file.
+ *  @return True if the given node could hold a string value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void GetTreePath
+static bool IsStringType
 (
-    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
-    int revisionId,           ///< [IN] Generate a name based on the tree revision.
-    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
-    size_t pathSize           ///< [IN] Size of the path buffer.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // paper    --> rock       1 -> 2
-    // rock     --> scissors   2 -> 3
-    // scissors --> paper      3 -> 1
-
-    static const char* revNames[] = { "paper", "rock", "scissors" };
-    int printSize;
-
-    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
-
-    printSize = snprintf(pathBuffer,
-                         pathSize,
-                         "%s/%s.%s",
-                         CFG_TREE_PATH,
-                         treeNameRef,
-                         revNames[revisionId - 1]);
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
-    if (printSize >= pathSize)
+    if (   (type == LE_CFG_TYPE_STRING)
+        || (type == LE_CFG_TYPE_BOOL)
+        || (type == LE_CFG_TYPE_INT)
+        || (type == LE_CFG_TYPE_FLOAT))
     {
-       LE_ERROR("Unable to store config tree path in buffer");
-       pathBuffer[0] = '\0';
+        return true;
     }
+
+    return false;
 }
 
 
@@ -1663,57 +1851,34 @@ static void GetTreePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a configTree file at the given revision already exists in the filesystem.
- *
- *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
- *
- *  @return True if the named file exists, false otherwise.
+ *  This function will copy a string value from an original tree node into a node that has shadowed
+ *  it.
  */
 // -------------------------------------------------------------------------------------------------
-static bool TreeFileExists
+static void PropagateValue
 (
-    const char* treeNameRef,  ///< [IN] Name of the tree to check.
-    int revisionId            ///< [IN] The revision of the tree to check against.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
-
-    // Make sure this part was successful.
-    if (fullPath[0] == '\0')
-    {
-        return false;
-    }
-
-    // stat() the file to see if it exists and get its size.
-    struct stat s;
-    if (stat(fullPath, &s) == -1)
-    {
-        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
-        return false;
-    }
+    // If the node doesn't even have a ref to an original node, then there's nothing left to do
+    // here.
+    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
 
-    // Make sure it's a regular file.
-    if (!S_ISREG(s.st_mode))
+    if (shadowRef == NULL)
     {
-        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+        return;
     }
 
-    // If it's zero size, delete it and report that it doesn't exist.
-    if (s.st_size == 0)
+    // Ok, figure out the type for this node.  If it has a value, and the original
+    if (   (IsStringType(nodeRef) == true)
+        && (IsStringType(shadowRef) == true)
+        && (nodeRef->info.valueRef == NULL)
+        && (shadowRef->info.valueRef != NULL))
     {
-        if (unlink(fullPath) == -1)
-        {
-            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
-        }
-
-        return false;
+        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
+        nodeRef->info.valueRef = istr_AddRef(shadowRef->info.valueRef);
     }
-
-    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
-
-    return true;
 }
 
 
@@ -1721,52 +1886,43 @@ static bool TreeFileExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- * Check the filesystem and get the current "valid" version of the file and update the tree object
- * with that version number.
+ *  Write data to a file at a given offset.  This function will record any faults to the system log.
  *
- * If there are two files for a given tree, we use the older one.  The idea being, if there are
- * two versions of the same file in the filesystem then there was a system failure during a save
- * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
- * unless the size of the older file is zero, which can happen if deletion of that file is
- * interrupted.
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static void UpdateRevision
+static le_result_t WriteFileAt
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+    int descriptor,       ///< [IN] The file being written to.
+    off_t offset,         ///< [IN] Where to write the data.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int newRevision = 0;
+    const uint8_t* bytePtr = dataPtr;
 
-    if (TreeFileExists(treeRef->name, 1))
-    {
-        if (TreeFileExists(treeRef->name, 3))
-        {
-            newRevision = 3;
-        }
-        else
-        {
-            newRevision = 1;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 3))
+    while (dataSize > 0)
     {
-        if (TreeFileExists(treeRef->name, 2))
-        {
-            newRevision = 2;
-        }
-        else
+        ssize_t written = pwrite(descriptor, bytePtr, dataSize, offset);
+
+        if (written == -1)
         {
-            newRevision = 3;
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LE_EMERG("Failed to write to config tree file (%m).");
+            return LE_IO_ERROR;
         }
-    }
-    else if (TreeFileExists(treeRef->name, 2))
-    {
-        newRevision = 2;
+
+        bytePtr += written;
+        offset += written;
+        dataSize -= written;
     }
 
-    treeRef->revisionId = newRevision;
+    return LE_OK;
 }
 
 
@@ -1774,19 +1930,21 @@ static void UpdateRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Peek into the input stream one character ahead.
+ *  Start writing a section of a binary tree file or of a delta log.
  */
 // -------------------------------------------------------------------------------------------------
-static signed char PeekChar
+static void InitBinWriter
 (
-    FILE* filePtr  ///< [IN] The file stream to peek into.
+    BinWriter_t* writerPtr,  ///< [IN] The writer.
+    int descriptor,          ///< [IN] The file being written.
+    off_t offset             ///< [IN] File offset to start writing at.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char next = fgetc(filePtr);
-    ungetc(next, filePtr);
-
-    return next;
+    writerPtr->descriptor = descriptor;
+    writerPtr->offset = offset;
+    writerPtr->used = 0;
+    writerPtr->result = LE_OK;
 }
 
 
@@ -1794,45 +1952,26 @@ static signed char PeekChar
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
- *
- *  @return LE_OK if the whitespace is skiped and there is still more file to read.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  Write out the data buffered by a writer.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipWhiteSpace
+static void FlushBinWriter
 (
-    FILE* filePtr  ///< [IN] The file stream to seek through.
+    BinWriter_t* writerPtr  ///< [IN] The writer.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool done = false;
-    bool isEof = false;
-
-    while (done == false)
+    if (   (writerPtr->used > 0)
+        && (writerPtr->result == LE_OK))
     {
-        switch (PeekChar(filePtr))
-        {
-            case '\n':
-            case '\r':
-            case '\t':
-            case ' ':
-                // Eat the character.
-                fgetc(filePtr);
-                break;
-
-            case EOF:
-                done = true;
-                isEof = true;
-                break;
-
-            default:
-                done = true;
-                break;
-        }
+        writerPtr->result = WriteFileAt(writerPtr->descriptor,
+                                        writerPtr->offset,
+                                        writerPtr->buffer,
+                                        writerPtr->used);
     }
 
-    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+    writerPtr->offset += writerPtr->used;
+    writerPtr->used = 0;
 }
 
 
@@ -1840,32 +1979,38 @@ static le_result_t SkipWhiteSpace
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean literal from the input file.
- *
- *  @return LE_OK if the literal could be read.
- *          LE_FORMAT_ERROR if the literal could not be read.
+ *  Append data to the section being written.
  */
 // -------------------------------------------------------------------------------------------------
-static bool ReadBoolToken
+static void WriteBin
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    BinWriter_t* writerPtr,  ///< [IN] The writer.
+    const void* dataPtr,     ///< [IN] The data to write.
+    size_t dataSize          ///< [IN] Size of the data.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next = fgetc(filePtr);
+    const uint8_t* bytePtr = dataPtr;
 
-    if (   (next == 't')
-        || (next == 'f'))
+    while (dataSize > 0)
     {
-        stringPtr[0] = next;
-        stringPtr[1] = 0;
+        size_t chunkSize = sizeof(writerPtr->buffer) - writerPtr->used;
 
-        return LE_OK;
-    }
+        if (chunkSize > dataSize)
+        {
+            chunkSize = dataSize;
+        }
 
-    return LE_FORMAT_ERROR;
+        memcpy(writerPtr->buffer + writerPtr->used, bytePtr, chunkSize);
+        writerPtr->used += chunkSize;
+        bytePtr += chunkSize;
+        dataSize -= chunkSize;
+
+        if (writerPtr->used == sizeof(writerPtr->buffer))
+        {
+            FlushBinWriter(writerPtr);
+        }
+    }
 }
 
 
@@ -1873,67 +2018,43 @@ static bool ReadBoolToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
- *  character is found.
+ *  Get the path of a node within its tree.  The path of the root node is empty, the path of any
+ *  other node is its parent's followed by a '/' and its name.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  @return LE_OK if the path was copied, LE_OVERFLOW if the buffer is too small.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadTextLiteral
+static le_result_t GetNodePath
 (
-    FILE* filePtr,        ///< [IN]  The file we're reading from.
-    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
-    signed char terminal  ///< [IN]  The terminal character we're searching for.
+    tdb_NodeRef_t nodeRef,  ///< [IN]  The node in question.
+    char* pathPtr,          ///< [OUT] Buffer to hold the path.
+    size_t pathSize         ///< [IN]  Size of the buffer.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-    size_t count = 0;
-
-    char* oldPtr = stringPtr;
-
-    while ((next = fgetc(filePtr)) != terminal)
+    if (nodeRef->parentRef == NULL)
     {
-        if (next == EOF)
-        {
-            LE_ERROR("Missing end specifier, ']' in int value.");
-            return LE_FORMAT_ERROR;
-        }
-
-        if (next == '\\')
-        {
-            next = fgetc(filePtr);
-
-            if (next == EOF)
-            {
-                LE_ERROR("Unexpected EOF after finding \\ character.");
-                return LE_FORMAT_ERROR;
-            }
-        }
-
-        if (count >= (stringSize - 1))
-        {
-            *stringPtr = 0;
+        pathPtr[0] = '\0';
+        return LE_OK;
+    }
 
-            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
-                     oldPtr,
-                     strlen(oldPtr),
-                     stringSize);
+    le_result_t result = GetNodePath(nodeRef->parentRef, pathPtr, pathSize);
 
-            return LE_FORMAT_ERROR;
-        }
+    if (result != LE_OK)
+    {
+        return result;
+    }
 
-        *stringPtr = next;
+    size_t length = strlen(pathPtr);
 
-        ++stringPtr;
-        ++count;
+    if ((length + 1) >= pathSize)
+    {
+        return LE_OVERFLOW;
     }
 
-    *stringPtr = 0;
+    pathPtr[length] = '/';
 
-    return LE_OK;
+    return tdb_GetNodeName(nodeRef, pathPtr + length + 1, pathSize - length - 1);
 }
 
 
@@ -1941,25 +2062,48 @@ static le_result_t ReadTextLiteral
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read an integer token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Append an entry to the delta log being written.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadIntToken
+static void WriteDeltaEntry
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    DeltaOp_t op,               ///< [IN] Kind of entry.
+    BinNodeType_t type,         ///< [IN] New type of the node.
+    uint8_t flags,              ///< [IN] Flags of the entry.
+    const char* pathPtr,        ///< [IN] Path of the node.
+    const char* oldNamePtr,     ///< [IN] Old name of the node, if it was renamed.
+    const char* valuePtr        ///< [IN] New value of the node, if it has one.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+    DeltaEntryHeader_t header;
 
-    // TODO: Validate the int string.
+    memset(&header, 0, sizeof(header));
+    header.op = op;
+    header.type = type;
+    header.flags = flags;
 
-    return result;
+    le_crc_Buffer_t buffers[] =
+        {
+            { &header.op, sizeof(header) - offsetof(DeltaEntryHeader_t, op) },
+            { (const uint8_t*)pathPtr, strlen(pathPtr) + 1 },
+            { (const uint8_t*)oldNamePtr, strlen(oldNamePtr) + 1 },
+            { (const uint8_t*)valuePtr, strlen(valuePtr) + 1 }
+        };
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(buffers); i++)
+    {
+        header.size += buffers[i].size;
+    }
+
+    header.crc = le_crc_Crc32Buffers(buffers, NUM_ARRAY_MEMBERS(buffers), LE_CRC_START_CRC32);
+
+    WriteBin(&DeltaWriter, &header, sizeof(header));
+
+    for (size_t i = 1; i < NUM_ARRAY_MEMBERS(buffers); i++)
+    {
+        WriteBin(&DeltaWriter, buffers[i].addressPtr, buffers[i].size);
+    }
 }
 
 
@@ -1967,25 +2111,50 @@ static le_result_t ReadIntToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a floating point token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Record a change that the merge made to a node of the original tree, if the changes of the
+ *  commit are being written to a delta log.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadFloatToken
+static void LogDelta
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    DeltaOp_t op,               ///< [IN] DELTA_DELETE or DELTA_SET.
+    tdb_NodeRef_t nodeRef,      ///< [IN] The original node, before it's deleted or once it's set.
+    uint8_t flags,              ///< [IN] Flags of the entry.
+    const char* oldNamePtr      ///< [IN] Old name of the node, if it was renamed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+    static char pathBuffer[CFG_MAX_PATH_SIZE] = "";
+    static char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
 
-    // TODO: Validate the float string.
+    if (   (IsLoggingDeltas == false)
+        || (DeltaWriter.result != LE_OK))
+    {
+        return;
+    }
 
-    return result;
+    // If the path doesn't fit in an entry, the commit will rewrite the tree file instead.
+    if (GetNodePath(nodeRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    {
+        DeltaWriter.result = LE_OVERFLOW;
+        return;
+    }
+
+    BinNodeType_t type = BIN_NODE_EMPTY;
+    valueBuffer[0] = '\0';
+
+    if ((flags & DELTA_HAS_VALUE) != 0)
+    {
+        type = ToBinNodeType(nodeRef->type);
+        tdb_GetValueAsString(nodeRef, valueBuffer, sizeof(valueBuffer), "");
+    }
+
+    WriteDeltaEntry(op,
+                    type,
+                    flags,
+                    pathBuffer,
+                    (oldNamePtr != NULL) ? oldNamePtr : "",
+                    valueBuffer);
 }
 
 
@@ -1993,95 +2162,138 @@ static le_result_t ReadFloatToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a string from the config tree file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Merge a shadow node with the original it represents.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadStringToken
+static void MergeNode
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+    LE_ASSERT(nodeRef != NULL);
 
-    // TODO: Validate the literal string.
+    // If this shadow node for some reason doesn't have a ref check for an original version of it in
+    // the original tree.  This shadow node may have been destroyed and re-created loosing this
+    // link.
+    if (nodeRef->shadowRef == NULL)
+    {
+        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
 
-    return result;
-}
+        if (shadowedParentRef != NULL)
+        {
+            char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+            tdb_GetNodeName(nodeRef, name, sizeof(name));
+            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+
+            if (nodeRef->shadowRef != NULL)
+            {
+                le_mem_AddRef(nodeRef->shadowRef);
+            }
+        }
+    }
 
+    // If this node has been marked as deleted, then simply drop the original node and move on.
+    if (IsDeleted(nodeRef))
+    {
+        if (nodeRef->shadowRef != NULL)
+        {
+            LogDelta(DELTA_DELETE, nodeRef->shadowRef, 0, NULL);
+        }
 
+        if (   (nodeRef->shadowRef != NULL)
+            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
+        {
+            RemoveNode(nodeRef->shadowRef);
+        }
+        else
+        {
+            // We delete every node but the root node.  Since this is the root node, we just need
+            // to clear it out.
+            tdb_SetEmpty(nodeRef->shadowRef);
+        }
 
+        return;
+    }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Read a token from the input stream.
- *
- *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
- *          before a token could be finished.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t ReadToken
-(
-    FILE* filePtr,         ///< [IN]  The file we're reading from.
-    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
-    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    *stringPtr = 0;
+    // If the original node doesn't exist, create it now.
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-    if (SkipWhiteSpace(filePtr) != LE_OK)
+    if (originalRef == NULL)
     {
-        return LE_OUT_OF_RANGE;
+        LE_ASSERT(nodeRef->parentRef != NULL);
+        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
+
+        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
+        le_mem_AddRef(originalRef);
     }
 
-    signed char next;
+    ClearModifiedFlag(originalRef);
+    originalRef->generation = MergeGeneration;
 
-    while ((next = fgetc(filePtr)) != EOF)
+    uint8_t deltaFlags = 0;
+    char oldName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    // If the name has been changed, then copy it over now.
+    if (istr_IsNullOrEmpty(nodeRef->nameRef) == false)
     {
-        switch (next)
+        UnindexNode(originalRef);
+
+        if (originalRef->nameRef != NULL)
         {
-            case '~':
-                *typePtr = TT_EMPTY_VALUE;
-                return LE_OK;
+            tdb_GetNodeName(originalRef, oldName, sizeof(oldName));
+            deltaFlags |= DELTA_RENAMED;
 
-            case '!':
-                *typePtr = TT_BOOL_VALUE;
-                return ReadBoolToken(filePtr, stringPtr, stringSize);
+            istr_Release(originalRef->nameRef);
+        }
 
-            case '[':
-                *typePtr = TT_INT_VALUE;
-                return ReadIntToken(filePtr, stringPtr, stringSize);
+        originalRef->nameRef = istr_AddRef(nodeRef->nameRef);
 
-            case '(':
-                *typePtr = TT_FLOAT_VALUE;
-                return ReadFloatToken(filePtr, stringPtr, stringSize);
+        IndexNode(originalRef);
+    }
 
-            case '\"':
-                *typePtr = TT_STRING_VALUE;
-                return ReadStringToken(filePtr, stringPtr, stringSize);
+    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
+    // then clear out the original node.  If the types have changed, then clear out the original so
+    // that we can properly populate it again.
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-            case '{':
-                *typePtr = TT_OPEN_GROUP;
-                return LE_OK;
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != originalRef->type))
+    {
+        tdb_SetEmpty(originalRef);
+        deltaFlags |= DELTA_CLEARED;
+    }
 
-            case '}':
-                *typePtr = TT_CLOSE_GROUP;
-                return LE_OK;
+    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
+    // that it isn't a stem.  If not, then copy over the string value.
+    if (   (nodeType != LE_CFG_TYPE_EMPTY)
+        && (nodeType != LE_CFG_TYPE_STEM))
+    {
+        if (nodeRef->info.valueRef != NULL)
+        {
+            if (originalRef->info.valueRef != NULL)
+            {
+                istr_Release(originalRef->info.valueRef);
+            }
 
-            default:
-                LE_ERROR("Unexpected character in input stream.");
-                return LE_FORMAT_ERROR;
+            originalRef->info.valueRef = istr_AddRef(nodeRef->info.valueRef);
+
+            // Propigate over the type as that may have changed, like going from an int value to a
+            // bool value.
+
+            originalRef->type = nodeRef->type;
+            deltaFlags |= DELTA_HAS_VALUE;
         }
     }
 
-    return LE_OUT_OF_RANGE;
+    LogDelta(DELTA_SET, originalRef, deltaFlags, oldName);
+
+    // Now at this point, if both the original and the shadow node are stems, we'll let the function
+    // InternalMergeTree take care of the children, (if any.)
+
+    // If the original has been cleared out, we can still just rely on InternalMergeTree to
+    // propigate over the new nodes.
 }
 
 
@@ -2089,83 +2301,107 @@ static le_result_t ReadToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write data to the output stream.  This function will record any faults to the system log.
+ *  Check whether a node is still part of the tree with the given root node, or if it has been
+ *  removed from it.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @return True if the node is in the tree, false if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteFile
+static bool IsInTree
 (
-    FILE* filePtr,        ///< [IN] The file being written to.
-    const void* dataPtr,  ///< [IN] The data being written to the file.
-    size_t dataSize       ///< [IN] The amount of data being written.
+    tdb_NodeRef_t nodeRef,     ///< [IN] The node to check.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] Root node of the tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
-
-    if (ferror(filePtr) != 0)
-    {
-        LE_EMERG("Failed to write to config tree file.");
-        return LE_IO_ERROR;
-    }
-
-    if (written < dataSize)
+    while (nodeRef->parentRef != NULL)
     {
-        LE_EMERG("Data truncated while writing to configuration file.");
-        return LE_IO_ERROR;
+        nodeRef = nodeRef->parentRef;
     }
 
-    return LE_OK;
+    return nodeRef == rootNodeRef;
 }
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write a string token to the output stream.  This function will write the string and escape all
- *  control characters as it does so.
+ *  Check the changes made in a shadow tree against the changes that other transactions committed
+ *  to the original tree since the shadow tree was created.  A change conflicts if the original
+ *  node it applies to has been changed or removed by one of those commits, or if it adds a node
+ *  where another commit has either added one of the same name or removed the parent node.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  Only the shadow nodes that exist are checked.  Children that were never shadowed were never
+ *  changed either.
+ *
+ *  @return True if the node, or any of its children, has a conflicting change.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteStringValue
+static bool HasConflict
 (
-    FILE* filePtr,         ///< [IN] The file to write to.
-    char startChar,        ///< [IN] The delimiter to use.
-    char endChar,          ///< [IN] The closing delimiter to use.
-    const char* stringPtr  ///< [IN] The actual string to write.
+    tdb_NodeRef_t nodeRef,         ///< [IN] Shadow node to check.
+    tdb_NodeRef_t rootNodeRef,     ///< [IN] Root node of the original tree.
+    uint32_t baseGeneration        ///< [IN] Generation of the original tree when the shadow tree
+                                   ///<      was created.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = LE_OK;
-
-    result = WriteFile(filePtr, &startChar, 1);
-
-    while (   (*stringPtr != 0)
-           && (result == LE_OK))
+    if (IsModified(nodeRef))
     {
-        if (   (*stringPtr == '\"')
-            || (*stringPtr == '\\'))
+        // Find the original that the merge will update, the same way that MergeNode does.
+        tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+        tdb_NodeRef_t originalParentRef = NULL;
+
+        if (   (originalRef == NULL)
+            && (nodeRef->parentRef != NULL))
         {
-            result = WriteFile(filePtr, "\\", 1);
+            originalParentRef = nodeRef->parentRef->shadowRef;
+
+            if (originalParentRef != NULL)
+            {
+                char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+                tdb_GetNodeName(nodeRef, name, sizeof(name));
+                originalRef = GetNamedChild(originalParentRef, name);
+            }
         }
 
-        if (result == LE_OK)
+        if (originalRef != NULL)
         {
-            result = WriteFile(filePtr, stringPtr, 1);
+            if (   (IsInTree(originalRef, rootNodeRef) == false)
+                || (originalRef->generation > baseGeneration))
+            {
+                return true;
+            }
         }
+        else if (   (originalParentRef != NULL)
+                 && (IsInTree(originalParentRef, rootNodeRef) == false))
+        {
+            return true;
+        }
+    }
 
-        stringPtr++;
+    // The children of a deleted node are not merged.
+    if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+        || (IsDeleted(nodeRef)))
+    {
+        return false;
     }
 
-    if (result == LE_OK)
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+    while (linkPtr != NULL)
     {
-        char strBuffer[2] = { endChar, ' ' };
-        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+        if (HasConflict(CONTAINER_OF(linkPtr, Node_t, siblingList), rootNodeRef, baseGeneration))
+        {
+            return true;
+        }
+
+        linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
     }
 
-    return result;
+    return false;
 }
 
 
@@ -2173,139 +2409,3038 @@ static le_result_t WriteStringValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a node value from the given file.  If the value is a collection, then read in those nodes
- *  too.
+ *  Search a list of registration objects for the one with the given name.
  *
- *  @return LE_OK if the read is successful.
- *          LE_FORMAT_ERROR if parse errors are encountered.
- *          LE_NOT_FOUND if the end of file is reached.
+ *  @return The registration object, or NULL if there isn't one.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalReadNode
+static Registration_t* FindRegistration
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
-    FILE* filePtr,          ///< [IN] The file we're reading the value from.
-    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+    le_dls_List_t* listPtr,  ///< [IN] List of registrations to search.
+    const char* namePtr      ///< [IN] The name of the node or tree being looked for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_dls_Link_t* linkPtr = le_dls_Peek(listPtr);
+
+    while (linkPtr != NULL)
+    {
+        Registration_t* registrationPtr = CONTAINER_OF(linkPtr, Registration_t, siblingLink);
+
+        if (strcmp(registrationPtr->name, namePtr) == 0)
+        {
+            return registrationPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the registration object for a node, given the registration object of the node's parent.
+ *
+ *  The root node of a tree is represented by the registration object of the tree itself, so the
+ *  "parent" registration given for a root node is returned as is.
+ *
+ *  @return The registration object, or NULL if nothing is registered on or below the node.
+ */
+// -------------------------------------------------------------------------------------------------
+static Registration_t* FindNodeRegistration
+(
+    Registration_t* parentRegistrationPtr,  ///< [IN] Registration of the node's parent, if any.
+    tdb_NodeRef_t nodeRef                   ///< [IN] The node to look up.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (   (parentRegistrationPtr == NULL)
+        || (nodeRef->parentRef == NULL))
+    {
+        return parentRegistrationPtr;
+    }
+
+    if (le_dls_IsEmpty(&parentRegistrationPtr->childList))
+    {
+        return NULL;
+    }
+
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+    return FindRegistration(&parentRegistrationPtr->childList, nodeName);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called to flag the callbacks of a registration for calling once the merge is complete.  Nothing
+ *  happens if there's no registration, or if it has already been flagged.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TriggerCallbacks
+(
+    Registration_t* registrationPtr  ///< [IN] The registration to trigger, if any.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (   (registrationPtr != NULL)
+        && (registrationPtr->triggered == false)
+        && (le_dls_IsEmpty(&registrationPtr->handlerList) == false))
+    {
+        registrationPtr->triggered = true;
+        registrationPtr->triggeredLink = LE_SLS_LINK_INIT;
+        le_sls_Queue(&TriggeredList, &registrationPtr->triggeredLink);
+    }
+}
+
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Go through the registrations that have been triggered, and fire the call backs for each of them.
+ *
+ *  Once this is done, the triggered flags are cleared for next time.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireTriggeredCallbacks
+(
+    void
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* triggeredLinkPtr = NULL;
+
+    while ((triggeredLinkPtr = le_sls_Pop(&TriggeredList)) != NULL)
+    {
+        Registration_t* registrationPtr = CONTAINER_OF(triggeredLinkPtr,
+                                                       Registration_t,
+                                                       triggeredLink);
+
+        // This registration has been triggered, so call all of the handlers attached to it.
+        registrationPtr->triggered = false;
+
+        le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+        while (linkPtr != NULL)
+        {
+            Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+
+            handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
+            linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+        }
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the given node to see if it was renamed.
+ *
+ *  @return True if the node was renamed within this transaction.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool WasRenamed
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (IsModified(nodeRef) == false)
+    {
+        // The node wasn't even modified, so it can not have been renamed.
+        return false;
+    }
+
+    if (nodeRef->shadowRef == NULL)
+    {
+        // If the node doesn't have a shadow reference, then most likely this is a new node and not
+        // a rename of an existing one.
+        return false;
+    }
+
+    if (nodeRef->nameRef == NULL)
+    {
+        // The shadow node does not have a local copy of a name, so it can not have been renamed.
+        // It must have been modified for other reasons.
+        return false;
+    }
+
+    // Looks like the node has a new name.
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the original non-shadow node to see if it will need to be cleared during the merge.
+ *
+ *  @return True if the merge will clear out the original value.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OriginalToBeCleared
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Trigger callbacks for this node and all of it's children.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireAllChildren
+(
+    Registration_t* registrationPtr,  ///< [IN] Registration of the node, if any.
+    tdb_NodeRef_t nodeRef             ///< [IN] Node and any children to trigger callbacks for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If nothing is registered on this node or below it, then there is nothing to do.
+    if (registrationPtr == NULL)
+    {
+        return;
+    }
+
+    TriggerCallbacks(registrationPtr);
+
+    // If the node is a stem then look up the children that have registrations of their own, and
+    // do the same for them.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->childList);
+
+        while (linkPtr != NULL)
+        {
+            Registration_t* childRegistrationPtr = CONTAINER_OF(linkPtr,
+                                                                Registration_t,
+                                                                siblingLink);
+            tdb_NodeRef_t childRef = FindChild(nodeRef, childRegistrationPtr->name);
+
+            if (childRef != NULL)
+            {
+                FireAllChildren(childRegistrationPtr, childRef);
+            }
+
+            linkPtr = le_dls_PeekNext(&registrationPtr->childList, linkPtr);
+        }
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check a given shadow node and the original node it's shadowing.  If the original has children
+ *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
+ *  about to go away.
+ *
+ *  The algorithm employed by this function is as follows:
+ *
+ *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
+ *         mark all of the children as deleted.  (This is done with the expectation that the
+ *         original tree does not have nodes with the deleted flag set.)
+ *
+ *      2. Go through the shadow collection, and any shadow children that have links to the original
+ *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *
+ *      3. Travers the original children one more time.  For any node that is still marked as
+ *         deleted we queue up an event handler.  As this node has been removed from the colection
+ *         and will be removed as part of the final merge.  The delete flag is also cleared at this
+ *         step to ensure that there are no external side effects.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireLostChildren
+(
+    Registration_t* registrationPtr,  ///< [IN] Registration of the node.
+    tdb_NodeRef_t shadowNodeRef       ///< [IN] Node and any children to merge.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Is the original a stem?  If no, then done.
+    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
+
+    if (originalRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
+
+    // Mark all originals deleted.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        // Children in the original tree shouldn't currently be marked as deleted.
+        LE_ASSERT(IsDeleted(originalChildRef) == false);
+
+        SetDeletedFlag(originalChildRef);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+
+    // Follow through all of the shadow links and unmark deletions.
+    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
+
+        while (shadowChildRef != NULL)
+        {
+            if (shadowChildRef->shadowRef != NULL)
+            {
+                ClearDeletedFlag(shadowChildRef->shadowRef);
+            }
+
+            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+        }
+    }
+
+    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
+    // in order to leave everything as it was.
+    originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        if (IsDeleted(originalChildRef) == true)
+        {
+            FireAllChildren(FindNodeRegistration(registrationPtr, originalChildRef),
+                            originalChildRef);
+            ClearDeletedFlag(originalChildRef);
+        }
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *
+ *  @return True if the given node or any if it's children have been modified.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool InternalMergeTree
+(
+    Registration_t* parentRegistrationPtr,  ///< [IN] Registration of the parent of the current
+                                            ///<      node, or of the tree for the root node.
+    tdb_NodeRef_t nodeRef,                  ///< [IN] Node and any children to merge.
+    bool forceFire                          ///< [IN] Should update handlers be fired for this node
+                                            ///<      and all it's children, regardless of wether
+                                            ///<      or not this node has been directly modified?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool isModified = IsModified(nodeRef);
+    bool renamed = WasRenamed(nodeRef);
+
+    // Look up the registration under the node's new name, before it's merged.
+    Registration_t* registrationPtr = FindNodeRegistration(parentRegistrationPtr, nodeRef);
+
+    // If this node was renamed, then all children also need to be triggered as well.
+    forceFire = renamed || forceFire;
+
+    // If this node has been renamed, marked as deleted or set empty, then all of the children need
+    // notifications fired on the original nodes.
+    if (   (renamed == true)
+        || (IsDeleted(nodeRef) == true)
+        || (OriginalToBeCleared(nodeRef) == true))
+    {
+        if (nodeRef->shadowRef != NULL)
+        {
+            FireAllChildren(FindNodeRegistration(parentRegistrationPtr, nodeRef->shadowRef),
+                            nodeRef->shadowRef);
+        }
+    }
+    else if (   (isModified == true)
+             && (nodeRef->type == LE_CFG_TYPE_STEM)
+             && (registrationPtr != NULL)
+             && (le_dls_IsEmpty(&registrationPtr->childList) == false))
+    {
+        FireLostChildren(registrationPtr, nodeRef);
+    }
+
+    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
+    // track of whether any of those children have been modified as well.
+    if (isModified)
+    {
+        MergeNode(nodeRef);
+    }
+
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
+    {
+        nodeRef = tdb_GetFirstChildNode(nodeRef);
+
+        while (nodeRef != NULL)
+        {
+            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
+
+            isModified = InternalMergeTree(registrationPtr, nodeRef, forceFire) || isModified;
+            nodeRef = nextNodeRef;
+        }
+    }
+
+    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
+    // be registered.
+    if (isModified || forceFire)
+    {
+        TriggerCallbacks(registrationPtr);
+    }
+
+    // Let our caller know if any modifications have happened at this level or lower.
+    return isModified;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new tree object and set it to default values.
+ *
+ *  @return A ref to the newly created tree object.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t NewTree
+(
+    const char* treeNameRef,   ///< [IN] The name of the new tree.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
+
+    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+
+    treeRef->isDeletePending = false;
+    treeRef->originalTreeRef = NULL;
+    treeRef->isSnapshot = false;
+    treeRef->revisionId = 0;
+    treeRef->rootNodeRef = rootNodeRef;
+    treeRef->lastAccessTime = le_clk_GetRelativeTime();
+    treeRef->activeReadCount = 0;
+    treeRef->writeLockList = LE_DLS_LIST_INIT;
+    treeRef->generation = 0;
+    treeRef->requestList = LE_SLS_LIST_INIT;
+    treeRef->canLogDeltas = false;
+    treeRef->baseCrc = 0;
+    treeRef->deltaLogSize = 0;
+
+    return treeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree object is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+
+    // Kill the root node, if the tree is loaded.
+    if (treeRef->rootNodeRef != NULL)
+    {
+        le_mem_Release(treeRef->rootNodeRef);
+        treeRef->rootNodeRef = NULL;
+    }
+
+    // Sanity check, is the tree actually ready to clean up?
+    LE_ASSERT(treeRef->activeReadCount == 0);
+    LE_ASSERT(le_dls_IsEmpty(&treeRef->writeLockList) == true);
+    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a tree file with the given revision id.
+ *
+ *  @return A stringBuffer backed string containing the full path to the tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetTreePath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // paper    --> rock       1 -> 2
+    // rock     --> scissors   2 -> 3
+    // scissors --> paper      3 -> 1
+
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    int printSize;
+
+    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+
+    printSize = snprintf(pathBuffer,
+                         pathSize,
+                         "%s/%s.%s",
+                         CFG_TREE_PATH,
+                         treeNameRef,
+                         revNames[revisionId - 1]);
+
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree path in buffer");
+       pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check to see if a configTree file at the given revision already exists in the filesystem.
+ *
+ *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *
+ *  @return True if the named file exists, false otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool TreeFileExists
+(
+    const char* treeNameRef,  ///< [IN] Name of the tree to check.
+    int revisionId            ///< [IN] The revision of the tree to check against.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+
+    // Make sure this part was successful.
+    if (fullPath[0] == '\0')
+    {
+        return false;
+    }
+
+    // stat() the file to see if it exists and get its size.
+    struct stat s;
+    if (stat(fullPath, &s) == -1)
+    {
+        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        return false;
+    }
+
+    // Make sure it's a regular file.
+    if (!S_ISREG(s.st_mode))
+    {
+        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+    }
+
+    // If it's zero size, delete it and report that it doesn't exist.
+    if (s.st_size == 0)
+    {
+        if (unlink(fullPath) == -1)
+        {
+            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
+        }
+
+        return false;
+    }
+
+    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Check the filesystem and get the current "valid" version of the file and update the tree object
+ * with that version number.
+ *
+ * If there are two files for a given tree, we use the older one.  The idea being, if there are
+ * two versions of the same file in the filesystem then there was a system failure during a save
+ * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
+ * unless the size of the older file is zero, which can happen if deletion of that file is
+ * interrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void UpdateRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int newRevision = 0;
+
+    if (TreeFileExists(treeRef->name, 1))
+    {
+        if (TreeFileExists(treeRef->name, 3))
+        {
+            newRevision = 3;
+        }
+        else
+        {
+            newRevision = 1;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 3))
+    {
+        if (TreeFileExists(treeRef->name, 2))
+        {
+            newRevision = 2;
+        }
+        else
+        {
+            newRevision = 3;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 2))
+    {
+        newRevision = 2;
+    }
+
+    treeRef->revisionId = newRevision;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Peek into the input stream one character ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+static signed char PeekChar
+(
+    FILE* filePtr  ///< [IN] The file stream to peek into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char next = fgetc(filePtr);
+    ungetc(next, filePtr);
+
+    return next;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *
+ *  @return LE_OK if the whitespace is skiped and there is still more file to read.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipWhiteSpace
+(
+    FILE* filePtr  ///< [IN] The file stream to seek through.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool done = false;
+    bool isEof = false;
+
+    while (done == false)
+    {
+        switch (PeekChar(filePtr))
+        {
+            case '\n':
+            case '\r':
+            case '\t':
+            case ' ':
+                // Eat the character.
+                fgetc(filePtr);
+                break;
+
+            case EOF:
+                done = true;
+                isEof = true;
+                break;
+
+            default:
+                done = true;
+                break;
+        }
+    }
+
+    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a boolean literal from the input file.
+ *
+ *  @return LE_OK if the literal could be read.
+ *          LE_FORMAT_ERROR if the literal could not be read.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadBoolToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next = fgetc(filePtr);
+
+    if (   (next == 't')
+        || (next == 'f'))
+    {
+        stringPtr[0] = next;
+        stringPtr[1] = 0;
+
+        return LE_OK;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
+ *  character is found.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTextLiteral
+(
+    FILE* filePtr,        ///< [IN]  The file we're reading from.
+    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
+    signed char terminal  ///< [IN]  The terminal character we're searching for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next;
+    size_t count = 0;
+
+    char* oldPtr = stringPtr;
+
+    while ((next = fgetc(filePtr)) != terminal)
+    {
+        if (next == EOF)
+        {
+            LE_ERROR("Missing end specifier, ']' in int value.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (next == '\\')
+        {
+            next = fgetc(filePtr);
+
+            if (next == EOF)
+            {
+                LE_ERROR("Unexpected EOF after finding \\ character.");
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        if (count >= (stringSize - 1))
+        {
+            *stringPtr = 0;
+
+            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
+                     oldPtr,
+                     strlen(oldPtr),
+                     stringSize);
+
+            return LE_FORMAT_ERROR;
+        }
+
+        *stringPtr = next;
+
+        ++stringPtr;
+        ++count;
+    }
+
+    *stringPtr = 0;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an integer token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadIntToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+
+    // TODO: Validate the int string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a floating point token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadFloatToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+
+    // TODO: Validate the float string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a string from the config tree file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadStringToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+
+    // TODO: Validate the literal string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a token from the input stream.
+ *
+ *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
+ *          before a token could be finished.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadToken
+(
+    FILE* filePtr,         ///< [IN]  The file we're reading from.
+    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
+    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *stringPtr = 0;
+
+    if (SkipWhiteSpace(filePtr) != LE_OK)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != EOF)
+    {
+        switch (next)
+        {
+            case '~':
+                *typePtr = TT_EMPTY_VALUE;
+                return LE_OK;
+
+            case '!':
+                *typePtr = TT_BOOL_VALUE;
+                return ReadBoolToken(filePtr, stringPtr, stringSize);
+
+            case '[':
+                *typePtr = TT_INT_VALUE;
+                return ReadIntToken(filePtr, stringPtr, stringSize);
+
+            case '(':
+                *typePtr = TT_FLOAT_VALUE;
+                return ReadFloatToken(filePtr, stringPtr, stringSize);
+
+            case '\"':
+                *typePtr = TT_STRING_VALUE;
+                return ReadStringToken(filePtr, stringPtr, stringSize);
+
+            case '{':
+                *typePtr = TT_OPEN_GROUP;
+                return LE_OK;
+
+            case '}':
+                *typePtr = TT_CLOSE_GROUP;
+                return LE_OK;
+
+            default:
+                LE_ERROR("Unexpected character in input stream.");
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OUT_OF_RANGE;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write data to the output stream.  This function will record any faults to the system log.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteFile
+(
+    FILE* filePtr,        ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+
+    if (ferror(filePtr) != 0)
+    {
+        LE_EMERG("Failed to write to config tree file.");
+        return LE_IO_ERROR;
+    }
+
+    if (written < dataSize)
+    {
+        LE_EMERG("Data truncated while writing to configuration file.");
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a string token to the output stream.  This function will write the string and escape all
+ *  control characters as it does so.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteStringValue
+(
+    FILE* filePtr,         ///< [IN] The file to write to.
+    char startChar,        ///< [IN] The delimiter to use.
+    char endChar,          ///< [IN] The closing delimiter to use.
+    const char* stringPtr  ///< [IN] The actual string to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    result = WriteFile(filePtr, &startChar, 1);
+
+    while (   (*stringPtr != 0)
+           && (result == LE_OK))
+    {
+        if (   (*stringPtr == '\"')
+            || (*stringPtr == '\\'))
+        {
+            result = WriteFile(filePtr, "\\", 1);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, stringPtr, 1);
+        }
+
+        stringPtr++;
+    }
+
+    if (result == LE_OK)
+    {
+        char strBuffer[2] = { endChar, ' ' };
+        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value from the given file.  If the value is a collection, then read in those nodes
+ *  too.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if parse errors are encountered.
+ *          LE_NOT_FOUND if the end of file is reached.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalReadNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
+    FILE* filePtr,          ///< [IN] The file we're reading the value from.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    TokenType_t tokenType;
+
+    // Try to read this node's value.
+    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    {
+        LE_ERROR("Unexpected EOF or bad token in file.");
+        return LE_FORMAT_ERROR;
+    }
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (tokenType)
+    {
+        case TT_BOOL_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_BOOL;
+            break;
+
+        case TT_INT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_INT;
+            break;
+
+        case TT_FLOAT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_FLOAT;
+            break;
+
+        case TT_STRING_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            break;
+
+        case TT_EMPTY_VALUE:
+            // The node has already been cleared, so there's nothing left to do but make sure that
+            // the node exists.
+            ClearDeletedFlag(nodeRef);
+            break;
+
+        case TT_OPEN_GROUP:
+            while (tokenType != TT_CLOSE_GROUP)
+            {
+                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+                {
+                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+
+                if (tokenType == TT_STRING_VALUE)
+                {
+                    size_t strLen = le_utf8_NumBytes(stringBuffer);
+                    size_t newPathLen = pathLen + 1 + strLen;
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
+                                 stringBuffer,
+                                 strLen,
+                                 (size_t)LE_CFG_STR_LEN);
+
+                        return LE_FORMAT_ERROR;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                            return LE_FORMAT_ERROR;
+                        }
+
+                        LE_DEBUG("New node, %s", stringBuffer);
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        return result;
+                    }
+                }
+                else if (tokenType == TT_CLOSE_GROUP)
+                {
+                    break;
+                }
+                else
+                {
+                    LE_ERROR("Unexpected token in found while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+            }
+            break;
+
+        case TT_CLOSE_GROUP:
+        default:
+            LE_ERROR("Unexpected token found.");
+            return LE_FORMAT_ERROR;
+    }
+
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
+
+    tdb_EnsureExists(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a file in the filesystem.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalWriteNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
+    FILE* filePtr           ///< [IN] The file being written to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If there is no node to write, or if the node is marked as having been deleted...  Then write
+    // a blank node.
+    if (   (nodeRef == NULL)
+        || (IsDeleted(nodeRef) == true))
+    {
+        return WriteFile(filePtr, "~ ", 2);
+    }
+
+    // Get the node's value as a string.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = LE_OK;
+
+    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+
+    // Now, depending on the type of node, write out any required format information.
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            result = WriteFile(filePtr, "~ ", 2);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            {
+                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
+                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+            }
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
+            break;
+
+        // Looks like this node is a collection, so write out it's child nodes now.
+        case LE_CFG_TYPE_STEM:
+            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                while (   (childRef != NULL)
+                       && (result == LE_OK))
+                {
+                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
+                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+
+                    if (result == LE_OK)
+                    {
+                        result = InternalWriteNode(childRef, filePtr);
+                    }
+
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                if (result == LE_OK)
+                {
+                    result = WriteFile(filePtr, "} ", 2);
+                }
+            }
+            break;
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Fetch the text of a string written to the binary tree file being written.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetBinString
+(
+    const BinString_t* stringPtr,  ///< [IN]  The string.
+    char* bufferPtr,               ///< [OUT] Buffer to hold the text.
+    size_t bufferSize              ///< [IN]  Size of the buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (stringPtr->isValue)
+    {
+        tdb_GetValueAsString(stringPtr->nodeRef, bufferPtr, bufferSize, "");
+    }
+    else
+    {
+        tdb_GetNodeName(stringPtr->nodeRef, bufferPtr, bufferSize);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Hash function for the binary tree file string map.
+ *
+ *  @return The hash of the string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t HashBinString
+(
+    const void* keyPtr  ///< [IN] The BinString_t to hash.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    return ((const BinString_t*)keyPtr)->hash;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Equality function for the binary tree file string map.
+ *
+ *  @return true if both strings hold the same text.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool EqualsBinString
+(
+    const void* firstKeyPtr,  ///< [IN] The first BinString_t.
+    const void* secondKeyPtr  ///< [IN] The second BinString_t.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char firstBuffer[LE_CFG_STR_LEN_BYTES];
+    static char secondBuffer[LE_CFG_STR_LEN_BYTES];
+
+    const BinString_t* firstPtr = firstKeyPtr;
+    const BinString_t* secondPtr = secondKeyPtr;
+
+    if (firstPtr->hash != secondPtr->hash)
+    {
+        return false;
+    }
+
+    GetBinString(firstPtr, firstBuffer, sizeof(firstBuffer));
+    GetBinString(secondPtr, secondBuffer, sizeof(secondBuffer));
+
+    return strcmp(firstBuffer, secondBuffer) == 0;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a node's name or value to the string table of the binary tree file being written, unless
+ *  the same string is already there.
+ *
+ *  @return The offset of the string in the string table.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t WriteBinString
+(
+    BinTreeWriter_t* writerPtr,  ///< [IN] The tree file being written.
+    tdb_NodeRef_t nodeRef,       ///< [IN] The node the string is taken from.
+    bool isValue                 ///< [IN] true to write the node's value, false for its name.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    BinString_t probe = { .nodeRef = nodeRef, .isValue = isValue };
+
+    GetBinString(&probe, stringBuffer, sizeof(stringBuffer));
+    probe.hash = le_hashmap_HashString(stringBuffer);
+
+    BinString_t* stringPtr = le_hashmap_Get(BinStringMapRef, &probe);
+
+    if (stringPtr == NULL)
+    {
+        size_t size = strlen(stringBuffer) + 1;
+
+        stringPtr = le_mem_ForceAlloc(BinStringPoolRef);
+        *stringPtr = probe;
+        stringPtr->link = LE_SLS_LINK_INIT;
+        stringPtr->offset = writerPtr->stringsSize;
+
+        le_sls_Queue(&writerPtr->stringList, &stringPtr->link);
+        le_hashmap_Put(BinStringMapRef, stringPtr, stringPtr);
+
+        WriteBin(&writerPtr->strings, stringBuffer, size);
+        writerPtr->stringsSize += size;
+    }
+
+    return stringPtr->offset;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Count the nodes below a node that are to be written to a tree file.
+ *
+ *  @return The number of the node's active children, grandchildren and so on.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t CountDescendants
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    uint32_t count = 0;
+
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
+    {
+        tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+        while (childRef != NULL)
+        {
+            count += 1 + CountDescendants(childRef);
+            childRef = tdb_GetNextActiveSiblingNode(childRef);
+        }
+    }
+
+    return count;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Count the active children of a node.
+ *
+ *  @return The number of children to be written to a tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t CountChildren
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    uint32_t count = 0;
+
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
+    {
+        tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+        while (childRef != NULL)
+        {
+            count++;
+            childRef = tdb_GetNextActiveSiblingNode(childRef);
+        }
+    }
+
+    return count;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append the record of a node to the binary tree file being written.
+ */
+// -------------------------------------------------------------------------------------------------
+static void WriteBinRecord
+(
+    BinTreeWriter_t* writerPtr,  ///< [IN] The tree file being written.
+    tdb_NodeRef_t nodeRef,       ///< [IN] The node to write.
+    uint32_t firstChildIndex     ///< [IN] Index the record of the node's first child will have.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    BinTreeRecord_t record;
+
+    memset(&record, 0, sizeof(record));
+    record.nameOffset = WriteBinString(writerPtr, nodeRef, false);
+
+    record.type = IsDeleted(nodeRef) ? BIN_NODE_EMPTY : ToBinNodeType(nodeRef->type);
+
+    if (record.type == BIN_NODE_STEM)
+    {
+        record.childCount = CountChildren(nodeRef);
+        record.dataOffset = (record.childCount > 0) ? firstChildIndex : 0;
+    }
+    else if (record.type != BIN_NODE_EMPTY)
+    {
+        record.dataOffset = WriteBinString(writerPtr, nodeRef, true);
+    }
+
+    WriteBin(&writerPtr->records, &record, sizeof(record));
+    writerPtr->recordCount++;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append the records of a node's children to the binary tree file being written, followed by the
+ *  records of their own children, and so on.
+ *
+ *  @return The number of records written.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t WriteBinChildren
+(
+    BinTreeWriter_t* writerPtr,  ///< [IN] The tree file being written.
+    tdb_NodeRef_t nodeRef,       ///< [IN] The node whose children are to be written.
+    uint32_t firstChildIndex     ///< [IN] Index of the record of the node's first child.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(writerPtr->recordCount == firstChildIndex);
+
+    // The children's records come first.  The records below each child follow, in order, so every
+    // child's own children start right after everything below its older siblings.
+    uint32_t nextIndex = firstChildIndex + CountChildren(nodeRef);
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        WriteBinRecord(writerPtr, childRef, nextIndex);
+        nextIndex += CountDescendants(childRef);
+
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    nextIndex = writerPtr->recordCount;
+    childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        nextIndex += WriteBinChildren(writerPtr, childRef, nextIndex);
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    return nextIndex - firstChildIndex;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree to a file in the binary tree file format.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteBinaryTree
+(
+    tdb_NodeRef_t rootRef,  ///< [IN]  Root node of the tree to write.
+    int descriptor,         ///< [IN]  The file to write to, which must be empty.
+    uint32_t* crcPtr        ///< [OUT] Checksum of the file written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static BinTreeWriter_t writer;
+
+    uint32_t recordCount = 1 + CountDescendants(rootRef);
+    off_t stringsOffset = sizeof(BinTreeHeader_t) + ((off_t)recordCount * sizeof(BinTreeRecord_t));
+
+    InitBinWriter(&writer.records, descriptor, sizeof(BinTreeHeader_t));
+    InitBinWriter(&writer.strings, descriptor, stringsOffset);
+    writer.recordCount = 0;
+    writer.stringsSize = 0;
+    writer.stringList = LE_SLS_LIST_INIT;
+
+    WriteBinRecord(&writer, rootRef, 1);
+    WriteBinChildren(&writer, rootRef, 1);
+
+    LE_ASSERT(writer.recordCount == recordCount);
+
+    FlushBinWriter(&writer.records);
+    FlushBinWriter(&writer.strings);
+
+    // The strings are only needed while the file is being written.
+    le_hashmap_RemoveAll(BinStringMapRef);
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&writer.stringList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, BinString_t, link));
+    }
+
+    le_result_t result = writer.records.result;
+
+    if (result == LE_OK)
+    {
+        result = writer.strings.result;
+    }
+
+    // Now that the whole file is out, read it back to compute its checksum and write the header.
+    BinTreeHeader_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BIN_TREE_MAGIC, sizeof(header.magic));
+    header.version = BIN_TREE_VERSION;
+    header.recordSize = sizeof(BinTreeRecord_t);
+    header.recordCount = recordCount;
+    header.stringsSize = writer.stringsSize;
+    header.crc = LE_CRC_START_CRC32;
+
+    off_t offset = sizeof(BinTreeHeader_t);
+    off_t endOffset = stringsOffset + writer.stringsSize;
+
+    while (   (result == LE_OK)
+           && (offset < endOffset))
+    {
+        ssize_t bytesRead = pread(descriptor,
+                                  writer.records.buffer,
+                                  sizeof(writer.records.buffer),
+                                  offset);
+
+        if ((bytesRead == -1) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        if (bytesRead <= 0)
+        {
+            LE_EMERG("Failed to read back config tree file (%m).");
+            result = LE_IO_ERROR;
+        }
+        else
+        {
+            header.crc = le_crc_Crc32(writer.records.buffer, bytesRead, header.crc);
+            offset += bytesRead;
+        }
+    }
+
+    if (result == LE_OK)
+    {
+        result = WriteFileAt(descriptor, 0, &header, sizeof(header));
+    }
+
+    *crcPtr = header.crc;
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree file image is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeImageDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    TreeImage_t* imagePtr = objectPtr;
+
+    if (munmap(imagePtr->mapPtr, imagePtr->mapSize) == -1)
+    {
+        LE_ERROR("Failed to unmap config tree file (%m).");
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check whether a tree file is in the binary format.
+ *
+ *  @return true if the file starts with the binary tree file magic number.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsBinaryTreeFile
+(
+    int descriptor  ///< [IN] The tree file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char magic[sizeof(((BinTreeHeader_t*)NULL)->magic)];
+    ssize_t bytesRead;
+
+    do
+    {
+        bytesRead = pread(descriptor, magic, sizeof(magic), 0);
+    }
+    while ((bytesRead == -1) && (errno == EINTR));
+
+    return    (bytesRead == sizeof(magic))
+           && (memcmp(magic, BIN_TREE_MAGIC, sizeof(magic)) == 0);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check that the records of a tree file image only refer to records and strings within the image,
+ *  and that child records always follow their parent's.
+ *
+ *  @return true if the image can be loaded.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool CheckTreeImage
+(
+    const TreeImage_t* imagePtr,  ///< [IN] The image to check.
+    uint32_t recordCount,         ///< [IN] Number of records in the image.
+    uint32_t stringsSize          ///< [IN] Size of the string table.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Every string in the table is terminated if the last one is.
+    if (   (stringsSize == 0)
+        || (imagePtr->stringsPtr[stringsSize - 1] != '\0'))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < recordCount; i++)
+    {
+        const BinTreeRecord_t* recordPtr = &imagePtr->recordsPtr[i];
+
+        if (   (recordPtr->type >= BIN_NODE_TYPE_COUNT)
+            || (recordPtr->nameOffset >= stringsSize)
+            || (strlen(imagePtr->stringsPtr + recordPtr->nameOffset) >= LE_CFG_NAME_LEN_BYTES))
+        {
+            return false;
+        }
+
+        if (recordPtr->type == BIN_NODE_STEM)
+        {
+            if (   (recordPtr->childCount > 0)
+                && (   (recordPtr->dataOffset <= i)
+                    || (((uint64_t)recordPtr->dataOffset + recordPtr->childCount) > recordCount)))
+            {
+                return false;
+            }
+        }
+        else if (recordPtr->type != BIN_NODE_EMPTY)
+        {
+            if (   (recordPtr->dataOffset >= stringsSize)
+                || (strlen(imagePtr->stringsPtr + recordPtr->dataOffset) >= LE_CFG_STR_LEN_BYTES))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Map a binary tree file into memory, and check its contents.
+ *
+ *  @return The image of the file, or NULL if the file couldn't be mapped or is corrupt.
+ */
+// -------------------------------------------------------------------------------------------------
+static TreeImage_t* MapTreeImage
+(
+    int descriptor,      ///< [IN] The tree file.
+    const char* pathPtr  ///< [IN] Path to the file, for error messages.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    struct stat fileStat;
+
+    if (fstat(descriptor, &fileStat) == -1)
+    {
+        LE_ERROR("Could not stat configuration tree file: %s, reason: %m", pathPtr);
+        return NULL;
+    }
+
+    if (fileStat.st_size < (off_t)sizeof(BinTreeHeader_t))
+    {
+        LE_ERROR("Configuration tree file %s is truncated.", pathPtr);
+        return NULL;
+    }
+
+    void* mapPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Could not map configuration tree file: %s, reason: %m", pathPtr);
+        return NULL;
+    }
+
+    TreeImage_t* imagePtr = le_mem_ForceAlloc(TreeImagePoolRef);
+
+    imagePtr->mapPtr = mapPtr;
+    imagePtr->mapSize = fileStat.st_size;
+    imagePtr->recordsPtr = (const BinTreeRecord_t*)((uint8_t*)mapPtr + sizeof(BinTreeHeader_t));
+    imagePtr->stringsPtr = NULL;
+
+    const BinTreeHeader_t* headerPtr = mapPtr;
+
+    if (   (headerPtr->version != BIN_TREE_VERSION)
+        || (headerPtr->recordSize != sizeof(BinTreeRecord_t)))
+    {
+        LE_ERROR("Configuration tree file %s has unsupported version %u.",
+                 pathPtr,
+                 headerPtr->version);
+        le_mem_Release(imagePtr);
+        return NULL;
+    }
+
+    uint64_t stringsOffset =   sizeof(BinTreeHeader_t)
+                             + ((uint64_t)headerPtr->recordCount * sizeof(BinTreeRecord_t));
+
+    if (   (headerPtr->recordCount == 0)
+        || ((stringsOffset + headerPtr->stringsSize) != (uint64_t)fileStat.st_size))
+    {
+        LE_ERROR("Configuration tree file %s has the wrong size.", pathPtr);
+        le_mem_Release(imagePtr);
+        return NULL;
+    }
+
+    imagePtr->stringsPtr = (const char*)mapPtr + stringsOffset;
+
+    uint32_t crc = le_crc_Crc32((uint8_t*)mapPtr + sizeof(BinTreeHeader_t),
+                                fileStat.st_size - sizeof(BinTreeHeader_t),
+                                LE_CRC_START_CRC32);
+
+    if (   (crc != headerPtr->crc)
+        || (CheckTreeImage(imagePtr, headerPtr->recordCount, headerPtr->stringsSize) == false))
+    {
+        LE_ERROR("Configuration tree file %s is corrupt.", pathPtr);
+        le_mem_Release(imagePtr);
+        return NULL;
+    }
+
+    return imagePtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Calculate the number of bytes required to store a node path, including seperators and a trailing
+ *  NULL.
+ *
+ *  @return The amount of bytes required to store the whole path string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ComputePathLength
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = 0;
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    while (nodeRef != NULL)
+    {
+        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+
+        // Add this path segment's length to our running total, along with the required path
+        // seperator.
+        pathLen += 1 + le_utf8_NumBytes(nodeName);
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    // Don't forget to include a spot for the trailing NULL.
+    return pathLen + 1;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Bump up the version id of this tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void IncrementRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef->revisionId++;
+
+    if (treeRef->revisionId > 3)
+    {
+        treeRef->revisionId = 1;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call this function to delete a tree file from the filesystem.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteTreeFile
+(
+    const char* filePathPtr  ///< Path to the tree file in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+
+    if (unlink(filePathPtr) != 0)
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create the path to the delta log of a tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetDeltaLogPath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree.
+    char* pathBuffer,         ///< [IN] Buffer to hold the path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (snprintf(pathBuffer, pathSize, "%s/%s.delta", CFG_TREE_PATH, treeNameRef) >= pathSize)
+    {
+        LE_ERROR("Unable to store config tree delta log path in buffer");
+        pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Remove the delta log of a tree, if there is one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteDeltaLog
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    GetDeltaLogPath(treeRef->name, pathBuffer, sizeof(pathBuffer));
+
+    if (   (pathBuffer[0] != '\0')
+        && (unlink(pathBuffer) == -1)
+        && (errno != ENOENT))
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", pathBuffer);
+    }
+
+    treeRef->deltaLogSize = 0;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get ready to write the changes of a commit to a tree's delta log, as they're merged.
+ *
+ *  @return true if the changes are going to the delta log, false if the whole tree file needs to
+ *          be rewritten instead.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool StartDeltaLog
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree the commit is being merged into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Once the log has grown large enough, compact it by rewriting the tree file.
+    if (   (treeRef->canLogDeltas == false)
+        || (treeRef->deltaLogSize >= DELTA_LOG_COMPACT_BYTES))
+    {
+        return false;
+    }
+
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    GetDeltaLogPath(treeRef->name, pathBuffer, sizeof(pathBuffer));
+
+    if (pathBuffer[0] == '\0')
+    {
+        return false;
+    }
+
+    int flags = O_WRONLY | O_CREAT;
+
+    if (treeRef->deltaLogSize == 0)
+    {
+        flags |= O_TRUNC;
+    }
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(pathBuffer, flags, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    if (fileRef == -1)
+    {
+        if (errno != EROFS)
+        {
+            LE_ERROR("Failed to open config delta log '%s' (%m).", pathBuffer);
+        }
+
+        return false;
+    }
+
+    InitBinWriter(&DeltaWriter, fileRef, treeRef->deltaLogSize);
+
+    if (treeRef->deltaLogSize == 0)
+    {
+        DeltaLogHeader_t header;
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, DELTA_LOG_MAGIC, sizeof(header.magic));
+        header.version = DELTA_LOG_VERSION;
+        header.baseCrc = treeRef->baseCrc;
+
+        WriteBin(&DeltaWriter, &header, sizeof(header));
+    }
+
+    IsLoggingDeltas = true;
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Finish writing the changes of a commit to a tree's delta log.
+ *
+ *  @return true if the changes are in the log, false if the whole tree file needs to be rewritten
+ *          instead.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool FinishDeltaLog
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree the commit has been merged into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(IsLoggingDeltas);
+
+    WriteDeltaEntry(DELTA_COMMIT, BIN_NODE_EMPTY, 0, "", "", "");
+    FlushBinWriter(&DeltaWriter);
+
+    IsLoggingDeltas = false;
+
+    bool isLogged = (DeltaWriter.result == LE_OK);
+
+    if (isLogged)
+    {
+        treeRef->deltaLogSize = DeltaWriter.offset;
+    }
+
+    if (close(DeltaWriter.descriptor) == -1)
+    {
+        LE_EMERG("An error occurred while closing the delta log: %s", strerror(errno));
+    }
+
+    return isLogged;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an entry from a delta log and check it.
+ *
+ *  @return The size of the entry, including its header, or 0 if there is no complete and valid
+ *          entry at the given offset.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ReadDeltaEntry
+(
+    int descriptor,     ///< [IN]  The delta log.
+    off_t offset,       ///< [IN]  Offset of the entry.
+    uint8_t* entryPtr   ///< [OUT] Buffer of DELTA_ENTRY_MAX_BYTES to hold the entry.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t bytesRead;
+
+    do
+    {
+        bytesRead = pread(descriptor, entryPtr, DELTA_ENTRY_MAX_BYTES, offset);
+    }
+    while ((bytesRead == -1) && (errno == EINTR));
+
+    if (bytesRead < (ssize_t)sizeof(DeltaEntryHeader_t))
+    {
+        return 0;
+    }
+
+    const DeltaEntryHeader_t* headerPtr = (const DeltaEntryHeader_t*)entryPtr;
+    size_t bodyOffset = offsetof(DeltaEntryHeader_t, op);
+    size_t entrySize = bodyOffset + headerPtr->size;
+
+    if (   (headerPtr->size < (sizeof(DeltaEntryHeader_t) - bodyOffset))
+        || (entrySize > (size_t)bytesRead)
+        || (le_crc_Crc32(entryPtr + bodyOffset, headerPtr->size, LE_CRC_START_CRC32)
+                != headerPtr->crc)
+        || (headerPtr->op > DELTA_COMMIT)
+        || (headerPtr->type >= BIN_NODE_TYPE_COUNT))
+    {
+        return 0;
+    }
+
+    // The entry must hold exactly three strings.
+    size_t stringCount = 0;
+
+    for (size_t i = sizeof(DeltaEntryHeader_t); i < entrySize; i++)
+    {
+        if (entryPtr[i] == '\0')
+        {
+            stringCount++;
+        }
+    }
+
+    if (   (stringCount != 3)
+        || (entryPtr[entrySize - 1] != '\0'))
+    {
+        return 0;
+    }
+
+    return entrySize;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find a node from its path, as returned by GetNodePath().
+ *
+ *  @return The node, or NULL if it doesn't exist and wasn't to be created.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t FindNodeByPath
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] Root node of the tree.
+    const char* pathPtr,    ///< [IN] Path of the node.
+    bool create             ///< [IN] Create the node, and its parents, if they don't exist.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+    tdb_NodeRef_t nodeRef = rootRef;
+
+    while (   (nodeRef != NULL)
+           && (*pathPtr == '/'))
+    {
+        pathPtr++;
+
+        size_t length = strcspn(pathPtr, "/");
+
+        if (length >= sizeof(name))
+        {
+            return NULL;
+        }
+
+        memcpy(name, pathPtr, length);
+        name[length] = '\0';
+        pathPtr += length;
+
+        tdb_NodeRef_t childRef = GetNamedChild(nodeRef, name);
+
+        if (   (childRef == NULL)
+            && (create))
+        {
+            if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+                && (nodeRef->type != LE_CFG_TYPE_EMPTY))
+            {
+                tdb_SetEmpty(nodeRef);
+                ClearModifiedFlag(nodeRef);
+            }
+
+            childRef = NewChildNode(nodeRef);
+
+            UnindexNode(childRef);
+            childRef->nameRef = istr_New(name);
+            IndexNode(childRef);
+        }
+
+        nodeRef = childRef;
+    }
+
+    return nodeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply a change recorded in a delta log to a tree, the same way the merge applied it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ApplyDeltaEntry
+(
+    tdb_NodeRef_t rootRef,      ///< [IN] Root node of the tree.
+    const uint8_t* entryPtr     ///< [IN] The entry.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const DeltaEntryHeader_t* headerPtr = (const DeltaEntryHeader_t*)entryPtr;
+    const char* pathPtr = (const char*)entryPtr + sizeof(DeltaEntryHeader_t);
+    const char* oldNamePtr = pathPtr + strlen(pathPtr) + 1;
+    const char* valuePtr = oldNamePtr + strlen(oldNamePtr) + 1;
+
+    tdb_NodeRef_t nodeRef;
+
+    if (headerPtr->op == DELTA_DELETE)
+    {
+        nodeRef = FindNodeByPath(rootRef, pathPtr, false);
+
+        if (nodeRef == rootRef)
+        {
+            tdb_SetEmpty(nodeRef);
+            ClearModifiedFlag(nodeRef);
+        }
+        else if (nodeRef != NULL)
+        {
+            RemoveNode(nodeRef);
+        }
+
+        return;
+    }
+
+    if ((headerPtr->flags & DELTA_RENAMED) != 0)
+    {
+        // The path holds the new name, the node is still under its old one.
+        char parentPath[CFG_MAX_PATH_SIZE] = "";
+        const char* lastSeparatorPtr = strrchr(pathPtr, '/');
+
+        if (lastSeparatorPtr == NULL)
+        {
+            return;
+        }
+
+        memcpy(parentPath, pathPtr, lastSeparatorPtr - pathPtr);
+        parentPath[lastSeparatorPtr - pathPtr] = '\0';
+
+        tdb_NodeRef_t parentRef = FindNodeByPath(rootRef, parentPath, false);
+        nodeRef = (parentRef != NULL) ? GetNamedChild(parentRef, oldNamePtr) : NULL;
+
+        if (nodeRef == NULL)
+        {
+            LE_WARN("Node '%s' of delta log not found.", pathPtr);
+            return;
+        }
+
+        UnindexNode(nodeRef);
+        SetString(&nodeRef->nameRef, lastSeparatorPtr + 1);
+        IndexNode(nodeRef);
+    }
+    else
+    {
+        nodeRef = FindNodeByPath(rootRef, pathPtr, true);
+
+        if (nodeRef == NULL)
+        {
+            LE_WARN("Node '%s' of delta log could not be created.", pathPtr);
+            return;
+        }
+    }
+
+    if ((headerPtr->flags & DELTA_CLEARED) != 0)
+    {
+        tdb_SetEmpty(nodeRef);
+    }
+
+    if ((headerPtr->flags & DELTA_HAS_VALUE) != 0)
+    {
+        if (nodeRef->type == LE_CFG_TYPE_STEM)
+        {
+            tdb_SetEmpty(nodeRef);
+        }
+
+        SetString(&nodeRef->info.valueRef, valuePtr);
+
+        nodeRef->type = NodeTypesOfBinTypes[headerPtr->type];
+    }
+
+    ClearModifiedFlag(nodeRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply the changes in a tree's delta log to the tree, once it has been loaded from its tree file.
+ *  A log that doesn't apply to that tree file is thrown away.  So are changes from a commit that
+ *  didn't make it to the log completely.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReplayDeltaLog
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree, as loaded from its tree file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static uint8_t entryBuffer[DELTA_ENTRY_MAX_BYTES];
+
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    GetDeltaLogPath(treeRef->name, pathBuffer, sizeof(pathBuffer));
+
+    treeRef->deltaLogSize = 0;
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(pathBuffer, O_RDONLY);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    if (fileRef == -1)
+    {
+        LE_ERROR_IF(errno != ENOENT, "Could not open config delta log: %s, reason: %m", pathBuffer);
+        return;
+    }
+
+    DeltaLogHeader_t header;
+    ssize_t bytesRead;
+
+    do
+    {
+        bytesRead = pread(fileRef, &header, sizeof(header), 0);
+    }
+    while ((bytesRead == -1) && (errno == EINTR));
+
+    if (   (bytesRead != sizeof(header))
+        || (memcmp(header.magic, DELTA_LOG_MAGIC, sizeof(header.magic)) != 0)
+        || (header.version != DELTA_LOG_VERSION)
+        || (header.baseCrc != treeRef->baseCrc))
+    {
+        LE_WARN("Discarding config delta log %s, it doesn't apply to the tree file.", pathBuffer);
+        close(fileRef);
+        DeleteDeltaLog(treeRef);
+        return;
+    }
+
+    // Find the end of the last commit that's complete in the log, then apply everything up to it.
+    off_t endOffset = sizeof(header);
+    off_t offset = endOffset;
+    size_t entrySize;
+
+    while ((entrySize = ReadDeltaEntry(fileRef, offset, entryBuffer)) > 0)
+    {
+        offset += entrySize;
+
+        if (((const DeltaEntryHeader_t*)entryBuffer)->op == DELTA_COMMIT)
+        {
+            endOffset = offset;
+        }
+    }
+
+    offset = sizeof(header);
+
+    while (offset < endOffset)
+    {
+        entrySize = ReadDeltaEntry(fileRef, offset, entryBuffer);
+        LE_ASSERT(entrySize > 0);
+
+        if (((const DeltaEntryHeader_t*)entryBuffer)->op != DELTA_COMMIT)
+        {
+            ApplyDeltaEntry(treeRef->rootNodeRef, entryBuffer);
+        }
+
+        offset += entrySize;
+    }
+
+    struct stat fileStat;
+
+    if (   (fstat(fileRef, &fileStat) == 0)
+        && (fileStat.st_size > endOffset))
+    {
+        LE_WARN("Dropping incomplete commit from config delta log %s.", pathBuffer);
+        LE_ERROR_IF((truncate(pathBuffer, endOffset) == -1) && (errno != EROFS),
+                    "Could not truncate config delta log: %s, reason: %m",
+                    pathBuffer);
+    }
+
+    close(fileRef);
+
+    treeRef->deltaLogSize = endOffset;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree to the next revision of its tree file, in the binary format.  Once that has
+ *  been written, the previous revision is removed.
+ */
+// -------------------------------------------------------------------------------------------------
+static void SaveTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to save.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Increment revision of the tree and open a tree file for writing.
+    int oldId = treeRef->revisionId;
+
+    IncrementRevision(treeRef);
+
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeRef->name, treeRef->revisionId, filePath, sizeof(filePath));
+
+    LE_DEBUG("Attempting to serialize the tree to '%s'.", filePath);
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    // Until a tree file has been written, there's nothing for a delta log to apply to.
+    treeRef->canLogDeltas = false;
+
+    if ((-1 == fileRef) && (EROFS == errno))
+    {
+        // In case we are R/O for the config tree, we discard the update to flash
+        return;
+    }
+
+    if (fileRef == -1)
+    {
+        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
+        LE_EMERG("Changes have been made in memory, however they could not be committed to the "
+                 "filesystem!!");
+        return;
+    }
+
+    // We have a tree file to write to, so stream the new tree to it then close the output file.
+    uint32_t crc = 0;
+    le_result_t writeResult = WriteBinaryTree(treeRef->rootNodeRef, fileRef, &crc);
+    int retVal = -1;
+
+    retVal = close(fileRef);
+
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+
+    // Finally remove the old version of the tree file, if there is one.
+    if (writeResult == LE_OK)
+    {
+        if (   (oldId != 0)
+            && (TreeFileExists(treeRef->name, oldId)))
+        {
+            GetTreePath(treeRef->name, oldId, filePath, sizeof(filePath));
+            DeleteTreeFile(filePath);
+        }
+
+        // The new tree file holds every change in the delta log, so start a new log against it.
+        DeleteDeltaLog(treeRef);
+        treeRef->baseCrc = crc;
+        treeRef->canLogDeltas = true;
+    }
+    else
+    {
+        // The write failed, delete the new file we attempted to create.
+        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
+        DeleteTreeFile(filePath);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a published config snapshot.
+ *
+ *  @return LE_OK if successful, LE_OVERFLOW if the path doesn't fit in the buffer.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t GetSnapshotPath
+(
+    const char* dirPtr,       ///< [IN]  Directory of the snapshot.
+    const char* prefixPtr,    ///< [IN]  Prefix of the file name, "" for the snapshot itself.
+    const char* namePtr,      ///< [IN]  Name of the app the snapshot is for.
+    char* pathBuffer,         ///< [OUT] Buffer to hold the new path.
+    size_t pathSize           ///< [IN]  Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (snprintf(pathBuffer, pathSize, "%s/%s%s", dirPtr, prefixPtr, namePtr) >= pathSize)
+    {
+        LE_ERROR("Unable to store config snapshot path in buffer");
+        return LE_OVERFLOW;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Delete the published config snapshot of an app, if there is one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveSnapshot
+(
+    const char* dirPtr,   ///< [IN] Directory of the snapshot.
+    const char* namePtr   ///< [IN] Name of the app the snapshot is for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char path[LE_CFG_STR_LEN_BYTES] = "";
+
+    if (   (GetSnapshotPath(dirPtr, "", namePtr, path, sizeof(path)) == LE_OK)
+        && (unlink(path) == -1)
+        && (errno != ENOENT))
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", path);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Publish a read-only snapshot of a node and everything below it, in the binary tree file format,
+ *  for an app's processes to map into memory.  The snapshot is readable by the app's group only,
+ *  and atomically replaces the previous one, so that the processes which already mapped that one
+ *  keep a consistent view.
+ *
+ *  Nothing is published if there's no app of that name.
+ */
+// -------------------------------------------------------------------------------------------------
+static void PublishSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to publish.
+    const char* dirPtr,     ///< [IN] Directory to publish the snapshot in.
+    const char* namePtr     ///< [IN] Name of the app the snapshot is for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    gid_t gid;
+
+    if (user_GetAppGid(namePtr, &gid) != LE_OK)
+    {
+        return;
+    }
+
+    char path[LE_CFG_STR_LEN_BYTES] = "";
+    char tempPath[LE_CFG_STR_LEN_BYTES] = "";
+
+    if (   (GetSnapshotPath(dirPtr, "", namePtr, path, sizeof(path)) != LE_OK)
+        || (GetSnapshotPath(dirPtr, ".", namePtr, tempPath, sizeof(tempPath)) != LE_OK))
+    {
+        return;
+    }
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(tempPath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IRGRP);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    if (fileRef == -1)
+    {
+        LE_ERROR("Failed to open config snapshot '%s' (%m).", tempPath);
+        return;
+    }
+
+    le_result_t result = LE_OK;
+    uint32_t crc = 0;
+
+    if (fchown(fileRef, 0, gid) == -1)
+    {
+        LE_ERROR("Failed to set the group of config snapshot '%s' (%m).", tempPath);
+        result = LE_FAULT;
+    }
+    else
+    {
+        result = WriteBinaryTree(nodeRef, fileRef, &crc);
+    }
+
+    if (close(fileRef) == -1)
+    {
+        LE_ERROR("An error occurred while closing config snapshot '%s' (%m).", tempPath);
+        result = LE_FAULT;
+    }
+
+    if (   (result == LE_OK)
+        && (rename(tempPath, path) == -1))
+    {
+        LE_ERROR("Failed to rename '%s' (%m).", tempPath);
+        result = LE_FAULT;
+    }
+
+    if (result != LE_OK)
+    {
+        unlink(tempPath);
+
+        // Processes can't be left reading a stale snapshot, they'll read the tree instead.
+        RemoveSnapshot(dirPtr, namePtr);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the "system:/apps" node of the system tree.
+ *
+ *  @return The node, or NULL if there is no such node.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetAppsNode
+(
+    tdb_TreeRef_t systemTreeRef  ///< [IN] The system tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t appsRef = FindChild(systemTreeRef->rootNodeRef, "apps");
+
+    if (   (appsRef == NULL)
+        || (appsRef->type != LE_CFG_TYPE_STEM))
+    {
+        return NULL;
+    }
+
+    return appsRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Publish or remove the "system:/apps/<app>" snapshot of an app, according to whether the app has
+ *  a node in the system tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void PublishAppSnapshot
+(
+    tdb_NodeRef_t appsRef,  ///< [IN] The "system:/apps" node, or NULL if there isn't one.
+    const char* namePtr     ///< [IN] Name of the app.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t appRef = (appsRef != NULL) ? FindChild(appsRef, namePtr) : NULL;
+
+    if (   (appRef != NULL)
+        && (appRef->type == LE_CFG_TYPE_STEM))
+    {
+        PublishSnapshot(appRef, CFG_APP_SNAPSHOT_PATH, namePtr);
+    }
+    else
+    {
+        RemoveSnapshot(CFG_APP_SNAPSHOT_PATH, namePtr);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Publish the "system:/apps/<app>" snapshot of every app, and remove the snapshots of the apps
+ *  that no longer have a node in the system tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void PublishAllAppSnapshots
+(
+    tdb_TreeRef_t systemTreeRef  ///< [IN] The system tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t appsRef = GetAppsNode(systemTreeRef);
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+    if (appsRef != NULL)
+    {
+        tdb_NodeRef_t appRef = tdb_GetFirstActiveChildNode(appsRef);
+
+        while (appRef != NULL)
+        {
+            if (   (appRef->type == LE_CFG_TYPE_STEM)
+                && (tdb_GetNodeName(appRef, name, sizeof(name)) == LE_OK))
+            {
+                PublishSnapshot(appRef, CFG_APP_SNAPSHOT_PATH, name);
+            }
+
+            appRef = tdb_GetNextActiveSiblingNode(appRef);
+        }
+    }
+
+    DIR* dirPtr = opendir(CFG_APP_SNAPSHOT_PATH);
+
+    if (dirPtr == NULL)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", CFG_APP_SNAPSHOT_PATH);
+        return;
+    }
+
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        if (   (entryPtr->d_name[0] != '.')
+            && (le_utf8_Copy(name, entryPtr->d_name, sizeof(name), NULL) == LE_OK)
+            && (   (appsRef == NULL)
+                || (FindChild(appsRef, name) == NULL)))
+        {
+            RemoveSnapshot(CFG_APP_SNAPSHOT_PATH, name);
+        }
+    }
+
+    closedir(dirPtr);
+
+    AreAppSnapshotsPublished = true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check whether a shadow node, or any of the shadow nodes below it, has been changed.  Only the
+ *  nodes already shadowed are checked, the others can't have been changed.
+ *
+ *  @return true if a change was found.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool HasShadowChanges
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (   (IsModified(nodeRef))
+        || (IsDeleted(nodeRef)))
+    {
+        return true;
+    }
+
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+        while (linkPtr != NULL)
+        {
+            if (HasShadowChanges(CONTAINER_OF(linkPtr, Node_t, siblingList)))
+            {
+                return true;
+            }
+
+            linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+        }
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find a shadow node's child, among the children already shadowed.
+ *
+ *  @return The child, or NULL if it hasn't been shadowed.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t FindShadowChild
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The shadow node to search.
+    const char* namePtr     ///< [IN] Name of the child.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return NULL;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+    while (linkPtr != NULL)
+    {
+        tdb_NodeRef_t childRef = CONTAINER_OF(linkPtr, Node_t, siblingList);
+
+        if (strcmp(istr_GetCstr(GetNameRef(childRef)), namePtr) == 0)
+        {
+            return childRef;
+        }
+
+        linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add an app to the apps changed by a commit to the system tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddChangedApp
+(
+    ChangedApps_t* changedAppsPtr,  ///< [IN] The changed apps.
+    istr_Ref_t nameRef              ///< [IN] Name of the app.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (istr_IsNullOrEmpty(nameRef))
+    {
+        return;
+    }
+
+    if (changedAppsPtr->count >= SNAPSHOT_MAX_CHANGED_APPS)
+    {
+        changedAppsPtr->isAll = true;
+        return;
+    }
+
+    istr_CopyToCstr(changedAppsPtr->names[changedAppsPtr->count],
+                    sizeof(changedAppsPtr->names[0]),
+                    nameRef);
+    changedAppsPtr->count++;
+}
 
-    TokenType_t tokenType;
 
-    // Try to read this node's value.
-    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the apps whose "system:/apps/<app>" subtree is changed by a commit to the system tree.  This
+ *  has to be done before the changes are merged, while the shadow nodes still flag them.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetChangedApps
+(
+    tdb_NodeRef_t shadowRootRef,    ///< [IN]  Root node of the shadow tree being committed.
+    ChangedApps_t* changedAppsPtr   ///< [OUT] The changed apps.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    changedAppsPtr->isAll = false;
+    changedAppsPtr->count = 0;
+
+    if (   (IsModified(shadowRootRef))
+        || (IsDeleted(shadowRootRef)))
     {
-        LE_ERROR("Unexpected EOF or bad token in file.");
-        return LE_FORMAT_ERROR;
+        changedAppsPtr->isAll = true;
+        return;
     }
 
-    tdb_SetEmpty(nodeRef);
+    tdb_NodeRef_t appsRef = FindShadowChild(shadowRootRef, "apps");
 
-    switch (tokenType)
+    if (appsRef == NULL)
     {
-        case TT_BOOL_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_BOOL;
-            break;
+        return;
+    }
 
-        case TT_INT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_INT;
-            break;
+    if (   (IsModified(appsRef))
+        || (IsDeleted(appsRef)))
+    {
+        changedAppsPtr->isAll = true;
+        return;
+    }
 
-        case TT_FLOAT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_FLOAT;
-            break;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&appsRef->info.children);
 
-        case TT_STRING_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            break;
+    while (   (linkPtr != NULL)
+           && (changedAppsPtr->isAll == false))
+    {
+        tdb_NodeRef_t appRef = CONTAINER_OF(linkPtr, Node_t, siblingList);
 
-        case TT_EMPTY_VALUE:
-            // The node has already been cleared, so there's nothing left to do but make sure that
-            // the node exists.
-            ClearDeletedFlag(nodeRef);
-            break;
+        if (HasShadowChanges(appRef))
+        {
+            // A renamed app leaves a snapshot under its old name.
+            AddChangedApp(changedAppsPtr, GetNameRef(appRef));
 
-        case TT_OPEN_GROUP:
-            while (tokenType != TT_CLOSE_GROUP)
+            if (WasRenamed(appRef))
             {
-                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
-                {
-                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
+                AddChangedApp(changedAppsPtr, appRef->shadowRef->nameRef);
+            }
+        }
 
-                if (tokenType == TT_STRING_VALUE)
-                {
-                    size_t strLen = le_utf8_NumBytes(stringBuffer);
-                    size_t newPathLen = pathLen + 1 + strLen;
+        linkPtr = le_dls_PeekNext(&appsRef->info.children, linkPtr);
+    }
+}
 
-                    if (newPathLen > LE_CFG_STR_LEN)
-                    {
-                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
-                                 stringBuffer,
-                                 strLen,
-                                 (size_t)LE_CFG_STR_LEN);
 
-                        return LE_FORMAT_ERROR;
-                    }
 
-                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
 
-                    if (childRef == NULL)
-                    {
-                        childRef = NewChildNode(nodeRef);
-                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
-                        {
-                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
-                            return LE_FORMAT_ERROR;
-                        }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Republish the config snapshots affected by a commit to a tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void PublishChangedSnapshots
+(
+    tdb_TreeRef_t treeRef,                  ///< [IN] The tree the commit was merged into.
+    const ChangedApps_t* changedAppsPtr     ///< [IN] For the system tree, the changed apps.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (strcmp(treeRef->name, "system") != 0)
+    {
+        PublishSnapshot(treeRef->rootNodeRef, CFG_TREE_SNAPSHOT_PATH, treeRef->name);
+    }
+    else if (changedAppsPtr->isAll)
+    {
+        PublishAllAppSnapshots(treeRef);
+    }
+    else
+    {
+        tdb_NodeRef_t appsRef = GetAppsNode(treeRef);
 
-                        LE_DEBUG("New node, %s", stringBuffer);
-                    }
+        for (size_t i = 0; i < changedAppsPtr->count; i++)
+        {
+            PublishAppSnapshot(appsRef, changedAppsPtr->names[i]);
+        }
+    }
+}
 
-                    tdb_EnsureExists(childRef);
 
-                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
 
-                    if (result != LE_OK)
-                    {
-                        return result;
-                    }
-                }
-                else if (tokenType == TT_CLOSE_GROUP)
-                {
-                    break;
-                }
-                else
-                {
-                    LE_ERROR("Unexpected token in found while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
-            }
-            break;
 
-        case TT_CLOSE_GROUP:
-        default:
-            LE_ERROR("Unexpected token found.");
-            return LE_FORMAT_ERROR;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Import a tree staged by the start program when the current system was installed.
+ *
+ *  Rather than copying all of the previous system's trees before the framework starts, the start
+ *  program links their files into CFG_TREE_PATH/import/<tree>/, and each tree is imported when it
+ *  is first opened.  The staged files replace any files the tree already had.  They are copied, so
+ *  that the previous system's files are never modified.
+ *
+ *  If interrupted, the import starts over the next time the tree is opened.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ImportTree
+(
+    const char* treeNameRef  ///< [IN] The name of the tree to import.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static const char* extensions[] = { "paper", "rock", "scissors", "delta" };
+
+    char importDir[LE_CFG_STR_LEN_BYTES] = "";
+    char doneDir[LE_CFG_STR_LEN_BYTES] = "";
+
+    if (   (snprintf(importDir, sizeof(importDir), "%s/import/%s",
+                     CFG_TREE_PATH, treeNameRef) >= sizeof(importDir))
+        || (snprintf(doneDir, sizeof(doneDir), "%s/import/.%s",
+                     CFG_TREE_PATH, treeNameRef) >= sizeof(doneDir)))
+    {
+        LE_ERROR("Unable to store config tree import path in buffer");
+        return;
     }
 
-    if (IsShadow(nodeRef) == false)
+    // Finish off an import interrupted after its files were copied.
+    le_dir_RemoveRecursive(doneDir);
+
+    if (!le_dir_IsDir(importDir))
     {
-        ClearModifiedFlag(nodeRef);
+        return;
     }
-    else
+
+    LE_INFO("Importing configuration tree '%s' from the previous system.", treeNameRef);
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(extensions); i++)
     {
-        SetModifiedFlag(nodeRef);
+        char srcPath[LE_CFG_STR_LEN_BYTES] = "";
+        char destPath[LE_CFG_STR_LEN_BYTES] = "";
+
+        if (   (snprintf(srcPath, sizeof(srcPath), "%s/%s.%s",
+                         importDir, treeNameRef, extensions[i]) >= sizeof(srcPath))
+            || (snprintf(destPath, sizeof(destPath), "%s/%s.%s",
+                         CFG_TREE_PATH, treeNameRef, extensions[i]) >= sizeof(destPath)))
+        {
+            LE_ERROR("Unable to store config tree import path in buffer");
+            return;
+        }
+
+        if ((unlink(destPath) == -1) && (errno != ENOENT))
+        {
+            LE_ERROR("File delete failure, '%s', reason '%m'.", destPath);
+        }
+
+        if (   (access(srcPath, F_OK) == 0)
+            && (file_Copy(srcPath, destPath, NULL) != LE_OK))
+        {
+            LE_EMERG("Failed to import config tree file '%s'.", srcPath);
+            return;
+        }
     }
 
-    tdb_EnsureExists(nodeRef);
+    // Everything is in place, so mark the import as done before removing the staged files.
+    if (rename(importDir, doneDir) == -1)
+    {
+        LE_ERROR("Failed to rename '%s' (%m).", importDir);
+        le_dir_RemoveRecursive(importDir);
+        return;
+    }
 
-    return LE_OK;
+    le_dir_RemoveRecursive(doneDir);
 }
 
 
@@ -2313,88 +5448,118 @@ static le_result_t InternalReadNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Serialize a tree node and it's children to a file in the filesystem.
- *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  Attempt to load a configuration tree from a config file.  This function will look for the latest
+ *  valid version of the config file and load that one.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalWriteNode
+static void LoadTree
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
-    FILE* filePtr           ///< [IN] The file being written to.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If there is no node to write, or if the node is marked as having been deleted...  Then write
-    // a blank node.
-    if (   (nodeRef == NULL)
-        || (IsDeleted(nodeRef) == true))
+    // If we don't know the revision then hunt it out from the filesystem.
+    if (treeRef->revisionId == 0)
     {
-        return WriteFile(filePtr, "~ ", 2);
+        UpdateRevision(treeRef);
     }
 
-    // Get the node's value as a string.
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
-    le_result_t result = LE_OK;
-
-    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+    // If this tree has no root, create it now.
+    if (treeRef->rootNodeRef == NULL)
+    {
+        treeRef->rootNodeRef = NewNode();
+    }
 
-    // Now, depending on the type of node, write out any required format information.
-    switch (nodeRef->type)
+    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
+    if (treeRef->revisionId != 0)
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            result = WriteFile(filePtr, "~ ", 2);
-            break;
+        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
 
-        case LE_CFG_TYPE_BOOL:
-            {
-                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
-                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
-            }
-            break;
+        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
 
-        case LE_CFG_TYPE_STRING:
-            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-            break;
+        int fileRef = -1;
 
-        case LE_CFG_TYPE_INT:
-            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
-            break;
+        do
+        {
+            fileRef = open(pathPtr, O_RDONLY);
+        }
+        while ((fileRef == -1) && (errno == EINTR));
 
-        case LE_CFG_TYPE_FLOAT:
-            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
-            break;
+        tdb_EnsureExists(treeRef->rootNodeRef);
 
-        // Looks like this node is a collection, so write out it's child nodes now.
-        case LE_CFG_TYPE_STEM:
-            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+        if (fileRef == -1)
+        {
+            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+        }
+        else if (IsBinaryTreeFile(fileRef))
+        {
+            // Only the root node is loaded now, the rest of the tree is loaded from the mapped
+            // image as it is needed.
+            TreeImage_t* imagePtr = MapTreeImage(fileRef, pathPtr);
 
-                while (   (childRef != NULL)
-                       && (result == LE_OK))
-                {
-                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
-                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            close(fileRef);
 
-                    if (result == LE_OK)
-                    {
-                        result = InternalWriteNode(childRef, filePtr);
-                    }
+            if (imagePtr != NULL)
+            {
+                SetNodeFromRecord(treeRef->rootNodeRef, imagePtr, 0);
 
-                    childRef = tdb_GetNextActiveSiblingNode(childRef);
-                }
+                // Commits made since the tree file was written are in the delta log.
+                treeRef->baseCrc = ((const BinTreeHeader_t*)imagePtr->mapPtr)->crc;
+                treeRef->canLogDeltas = true;
+                le_mem_Release(imagePtr);
 
-                if (result == LE_OK)
+                ReplayDeltaLog(treeRef);
+
+                if (treeRef->deltaLogSize >= DELTA_LOG_COMPACT_BYTES)
                 {
-                    result = WriteFile(filePtr, "} ", 2);
+                    SaveTree(treeRef);
                 }
             }
-            break;
+        }
+        else
+        {
+            bool isParsed = tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef);
+
+            close(fileRef);
+
+            if (isParsed == false)
+            {
+                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
+                le_mem_Release(treeRef->rootNodeRef);
+                treeRef->rootNodeRef = NewNode();
+            }
+            else
+            {
+                // This tree file is in the old text format, so convert it now.
+                LE_INFO("Converting configuration tree file %s to the binary format.", pathPtr);
+                SaveTree(treeRef);
+            }
+        }
     }
 
-    return result;
+    // The published snapshots are only missing after a restart of the framework.  They're kept up
+    // to date by the commits after that, so they don't need publishing every time a tree is loaded.
+    if (strcmp(treeRef->name, "system") == 0)
+    {
+        if (AreAppSnapshotsPublished == false)
+        {
+            PublishAllAppSnapshots(treeRef);
+        }
+    }
+    else
+    {
+        char snapshotPath[LE_CFG_STR_LEN_BYTES] = "";
+
+        if (   (GetSnapshotPath(CFG_TREE_SNAPSHOT_PATH, "", treeRef->name,
+                                snapshotPath, sizeof(snapshotPath)) == LE_OK)
+            && (access(snapshotPath, F_OK) == -1))
+        {
+            PublishSnapshot(treeRef->rootNodeRef, CFG_TREE_SNAPSHOT_PATH, treeRef->name);
+        }
+    }
 }
 
 
@@ -2402,33 +5567,23 @@ static le_result_t InternalWriteNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Calculate the number of bytes required to store a node path, including seperators and a trailing
- *  NULL.
+ *  Get the root node of a tree, loading the tree from the filesystem first if it isn't loaded yet.
  *
- *  @return The amount of bytes required to store the whole path string.
+ *  @return The root node.
  */
 // -------------------------------------------------------------------------------------------------
-static size_t ComputePathLength
+static tdb_NodeRef_t GetLoadedRootNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    size_t pathLen = 0;
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (nodeRef != NULL)
+    if (treeRef->rootNodeRef == NULL)
     {
-        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-
-        // Add this path segment's length to our running total, along with the required path
-        // seperator.
-        pathLen += 1 + le_utf8_NumBytes(nodeName);
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        LoadTree(treeRef);
     }
 
-    // Don't forget to include a spot for the trailing NULL.
-    return pathLen + 1;
+    return treeRef->rootNodeRef;
 }
 
 
@@ -2436,21 +5591,36 @@ static size_t ComputePathLength
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Bump up the version id of this tree.
+ *  Check whether a tree can be unloaded.  It has to be idle, and everything in memory has to be on
+ *  the filesystem too, so that none of it is lost when the tree is loaded again.
+ *
+ *  @return True if the tree can be unloaded, false if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void IncrementRevision
+static bool CanEvictTree
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree to check.
+    le_clk_Time_t now       ///< [IN] The current time.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    treeRef->revisionId++;
+    le_clk_Time_t idleTime = le_clk_Sub(now, treeRef->lastAccessTime);
 
-    if (treeRef->revisionId > 3)
+    if (   (treeRef->rootNodeRef == NULL)
+        || (treeRef->isDeletePending)
+        || (treeRef->activeReadCount != 0)
+        || (le_dls_IsEmpty(&treeRef->writeLockList) == false)
+        || (le_sls_IsEmpty(&treeRef->requestList) == false)
+        || (idleTime.sec < EvictionTimeout))
     {
-        treeRef->revisionId = 1;
+        return false;
     }
+
+    // The tree file and delta log are up to date when new changes can be logged, otherwise the
+    // last save failed.  A tree that has never been saved can only be dropped if it's empty.
+    return    (treeRef->canLogDeltas)
+           || (   (treeRef->revisionId == 0)
+               && (tdb_IsNodeEmpty(treeRef->rootNodeRef)));
 }
 
 
@@ -2458,62 +5628,34 @@ static void IncrementRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to load a configuration tree from a config file.  This function will look for the latest
- *  valid version of the config file and load that one.
+ *  Called periodically to unload the trees that haven't been used for the eviction timeout.  The
+ *  tree objects stay in the collection, and the trees are loaded again when next used.
  */
 // -------------------------------------------------------------------------------------------------
-static void LoadTree
+static void OnEvictionTimer
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+    le_timer_Ref_t timerRef  ///< [IN] The eviction timer.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If we don't know the revision then hunt it out from the filesystem.
-    if (treeRef->revisionId == 0)
-    {
-        UpdateRevision(treeRef);
-    }
-
-    // If this tree has no root, create it now.
-    if (treeRef->rootNodeRef == NULL)
-    {
-        treeRef->rootNodeRef = NewNode();
-    }
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(TreeCollectionRef);
 
-    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
-    if (treeRef->revisionId != 0)
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
     {
-        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
-        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
-
-        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
-
-        int fileRef = -1;
+        tdb_TreeRef_t treeRef = (tdb_TreeRef_t)le_hashmap_GetValue(iterRef);
 
-        do
+        if (CanEvictTree(treeRef, now))
         {
-            fileRef = open(pathPtr, O_RDONLY);
-        }
-        while ((fileRef == -1) && (errno == EINTR));
-
-        tdb_EnsureExists(treeRef->rootNodeRef);
+            LE_DEBUG("** Unloading unused configuration tree, '%s'.", treeRef->name);
 
-        if (fileRef == -1)
-        {
-            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
-                     pathPtr,
-                     strerror(errno));
-        }
-        else
-        {
-            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
-            {
-                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
-                le_mem_Release(treeRef->rootNodeRef);
-                treeRef->rootNodeRef = NewNode();
-            }
+            le_mem_Release(treeRef->rootNodeRef);
+            treeRef->rootNodeRef = NULL;
 
-            close(fileRef);
+            // These are worked out again when the tree is loaded.
+            treeRef->canLogDeltas = false;
+            treeRef->baseCrc = 0;
+            treeRef->deltaLogSize = 0;
         }
     }
 }
@@ -2552,55 +5694,29 @@ static void RemoveHandler
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function is called by the hash map ForEach function, which is invoked when a session closed
- *  event occurs.
- *
- *  This function takes care of cleaning out orphaned event handlers from the registration objects
- *  currently stored in the registration hash map.  If a given registration handler is no longer
- *  required then the object itself is queued for deletion.  It is queued and not deleted in place
- *  because the hash map does not support deleting objects in the middle of an iteration.
- *
- *  @return True.  This function always returns true to indicate that iteration should continue
- *          until the end of the hash map.
+ *  Remove a registration object from the trie, and free it.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OnHandlerRegistrationCleanup
+static void RemoveRegistration
 (
-    const void* keyPtr,    ///< [IN] The key used by this hash entry.
-    const void* valuePtr,  ///< [IN] The registration object.
-    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+    Registration_t* registrationPtr  ///< [IN] The registration, with no handlers or children.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Convert our pointers into something useable.
-    Registration_t* registrationPtr = (Registration_t*)valuePtr;
-    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
-
-    // Go through this registration object's list of update handlers and check to see if they were
-    // registered on the target session.  If so, free them from the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    LE_ASSERT(le_dls_IsEmpty(&registrationPtr->handlerList));
+    LE_ASSERT(le_dls_IsEmpty(&registrationPtr->childList));
+    LE_ASSERT(registrationPtr->triggered == false);
 
-    while (linkPtr != NULL)
+    if (registrationPtr->parentPtr != NULL)
     {
-        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
-
-        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
-        {
-            RemoveHandler(registrationPtr, handlerObjectPtr);
-        }
+        le_dls_Remove(&registrationPtr->parentPtr->childList, &registrationPtr->siblingLink);
     }
-
-    // Now, check to see if there are any handlers left in this object.  If the registration object
-    // is empty, then queue it for deletion.
-    if (le_dls_IsEmpty(&registrationPtr->handlerList))
+    else
     {
-        registrationPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+        le_dls_Remove(&TreeRegistrationList, &registrationPtr->siblingLink);
     }
 
-    // We want to continue iterating through the collection.
-    return true;
+    le_mem_Release(registrationPtr);
 }
 
 
@@ -2608,20 +5724,77 @@ static bool OnHandlerRegistrationCleanup
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this function to delete a tree file from the filesystem.
+ *  Remove a registration object if it no longer has any handlers or children, and do the same for
+ *  the registration objects above it in the trie.
  */
 // -------------------------------------------------------------------------------------------------
-static void DeleteTreeFile
+static void ReleaseUnusedRegistrations
 (
-    const char* filePathPtr  ///< Path to the tree file in question.
+    Registration_t* registrationPtr  ///< [IN] The registration object to start from.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+    while (   (registrationPtr != NULL)
+           && le_dls_IsEmpty(&registrationPtr->handlerList)
+           && le_dls_IsEmpty(&registrationPtr->childList))
+    {
+        Registration_t* parentPtr = registrationPtr->parentPtr;
 
-    if (unlink(filePathPtr) != 0)
+        RemoveRegistration(registrationPtr);
+        registrationPtr = parentPtr;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Called when a session closes, to take care of cleaning out orphaned event handlers from a list
+ *  of registration objects and all of the registrations below them.  Registration objects that end
+ *  up with no handlers or children are removed.
+ */
+// -------------------------------------------------------------------------------------------------
+static void CleanUpRegistrations
+(
+    le_dls_List_t* listPtr,         ///< [IN] The list of registration objects to clean up.
+    le_msg_SessionRef_t sessionRef  ///< [IN] The session that closed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* registrationLinkPtr = le_dls_Peek(listPtr);
+
+    while (registrationLinkPtr != NULL)
     {
-        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+        Registration_t* registrationPtr = CONTAINER_OF(registrationLinkPtr,
+                                                       Registration_t,
+                                                       siblingLink);
+        registrationLinkPtr = le_dls_PeekNext(listPtr, registrationLinkPtr);
+
+        CleanUpRegistrations(&registrationPtr->childList, sessionRef);
+
+        // Go through this registration object's list of update handlers and check to see if they
+        // were registered on the target session.  If so, free them from the list.
+        le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+        while (linkPtr != NULL)
+        {
+            Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+            linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+
+            if (handlerObjectPtr->sessionRef == sessionRef)
+            {
+                RemoveHandler(registrationPtr, handlerObjectPtr);
+            }
+        }
+
+        // Now, check to see if there is anything left in this object.  If not, it's no longer
+        // needed.
+        if (   le_dls_IsEmpty(&registrationPtr->handlerList)
+            && le_dls_IsEmpty(&registrationPtr->childList))
+        {
+            RemoveRegistration(registrationPtr);
+        }
     }
 }
 
@@ -2642,14 +5815,14 @@ static void DeleteTreeFile
 // -------------------------------------------------------------------------------------------------
 static tdb_NodeRef_t GetPathBaseNodeRef
 (
-    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+    tdb_NodeRef_t nodeRef,                  ///< [IN] The base node to start from.
+    const le_pathIter_View_t* nodePathPtr   ///< [IN] The path we're searching for in the tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
     // If the path is absolute and the node we were given is NOT the root node of it's tree, find
     // the root node of the tree.  Otherwise just return the node reference we were given.
-    if (   (le_pathIter_IsAbsolute(nodePathRef))
+    if (   (le_pathIter_ViewIsAbsolute(nodePathPtr))
         && (nodeRef->parentRef != NULL))
     {
         nodeRef = GetRootParentNode(nodeRef);
@@ -2661,6 +5834,46 @@ static tdb_NodeRef_t GetPathBaseNodeRef
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move on to the next node name in a path, and copy it into a name buffer so that it is null
+ *  terminated and can be looked up.
+ *
+ *  @return LE_OK if a name was found, LE_NOT_FOUND if there are no more names in the path, or
+ *          LE_OVERFLOW if the name is too long to be a node name.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t GetNextPathName
+(
+    le_pathIter_View_t* nodePathPtr,  ///< [IN/OUT] The path being walked.
+    char* nameBufferPtr               ///< [OUT] Buffer of LE_CFG_NAME_LEN_BYTES to hold the name.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const char* namePtr;
+    size_t nameSize;
+
+    le_result_t result = le_pathIter_ViewNext(nodePathPtr, &namePtr, &nameSize);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (nameSize >= LE_CFG_NAME_LEN_BYTES)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(nameBufferPtr, namePtr, nameSize);
+    nameBufferPtr[nameSize] = '\0';
+
+    return LE_OK;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Create a new C style file pointer from the POSIX file descriptor.
@@ -2734,6 +5947,88 @@ static void CloseFilePtr
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check whether two subtrees overlap, that is whether one of them contains the other.
+ *
+ *  @return True if they overlap, false if they are disjoint.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool PathsOverlap
+(
+    const char* firstPathPtr,  ///< [IN] Absolute path of the first subtree.
+    const char* secondPathPtr  ///< [IN] Absolute path of the second subtree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t firstLength = strlen(firstPathPtr);
+    size_t secondLength = strlen(secondPathPtr);
+
+    // Ignore the trailing separators, so that the root path is empty.
+    while ((firstLength > 0) && (firstPathPtr[firstLength - 1] == '/'))
+    {
+        firstLength--;
+    }
+
+    while ((secondLength > 0) && (secondPathPtr[secondLength - 1] == '/'))
+    {
+        secondLength--;
+    }
+
+    // Make the first path the shorter one, then check if it's a prefix of the other.
+    if (firstLength > secondLength)
+    {
+        const char* pathPtr = firstPathPtr;
+        size_t length = firstLength;
+
+        firstPathPtr = secondPathPtr;
+        firstLength = secondLength;
+        secondPathPtr = pathPtr;
+        secondLength = length;
+    }
+
+    return (strncmp(firstPathPtr, secondPathPtr, firstLength) == 0)
+           && (   (secondPathPtr[firstLength] == '/')
+               || (firstLength == secondLength));
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the write lock held by an iterator.
+ *
+ *  @return The write lock, or NULL if the iterator doesn't hold one.
+ */
+// -------------------------------------------------------------------------------------------------
+static WriteLock_t* FindWriteLock
+(
+    tdb_TreeRef_t treeRef,        ///< [IN] The tree to search.
+    ni_IteratorRef_t iteratorRef  ///< [IN] The write iterator.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&treeRef->writeLockList);
+
+    while (linkPtr != NULL)
+    {
+        WriteLock_t* lockPtr = CONTAINER_OF(linkPtr, WriteLock_t, link);
+
+        if (lockPtr->iteratorRef == iteratorRef)
+        {
+            return lockPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&treeRef->writeLockList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Initialize the tree DB subsystem, and automaticly load the system tree from the filesystem.
@@ -2745,43 +6040,106 @@ void tdb_Init
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Initialize Tree DB subsystem.");
+    LE_DEBUG("** Initialize Tree DB subsystem.");
+
+    // Initialize the memory pools.
+    NodePoolRef = le_mem_CreatePool(CFG_NODE_POOL_NAME, sizeof(Node_t));
+    le_mem_SetDestructor(NodePoolRef, NodeDestructor);
+    le_mem_SetNumObjsToForce(NodePoolRef, 50);    // Grow in chunks of 50 blocks.
+
+    ChildIndexPoolRef = le_mem_CreatePool(CFG_CHILD_INDEX_POOL_NAME, sizeof(ChildIndex_t));
+
+    // For now (until pool config is added to the framework), set a minimum size.
+    if (le_mem_GetObjectCount(NodePoolRef) != 0)
+    {
+        LE_WARN("TODO: Remove this code.");
+    }
+    else
+    {
+        le_mem_ExpandPool(NodePoolRef, 1000);
+    }
+
+
+    TreePoolRef = le_mem_CreatePool(CFG_TREE_POOL_NAME, sizeof(Tree_t));
+    le_mem_SetDestructor(TreePoolRef, TreeDestructor);
+    WriteLockPoolRef = le_mem_CreatePool(CFG_WRITE_LOCK_POOL_NAME, sizeof(WriteLock_t));
+    TreeCollectionRef = le_hashmap_Create(CFG_TREE_COLLECTION_NAME,
+                                          31,
+                                          le_hashmap_HashString,
+                                          le_hashmap_EqualsString);
+
+    HandlerSafeRefMap = le_ref_CreateMap(CFG_HANDLER_REF_MAP, 5);
+
+    TreeImagePoolRef = le_mem_CreatePool(CFG_TREE_IMAGE_POOL_NAME, sizeof(TreeImage_t));
+    le_mem_SetDestructor(TreeImagePoolRef, TreeImageDestructor);
+
+    BinStringPoolRef = le_mem_CreatePool(CFG_BIN_STRING_POOL_NAME, sizeof(BinString_t));
+    BinStringMapRef = le_hashmap_Create(CFG_BIN_STRING_MAP_NAME,
+                                        127,
+                                        HashBinString,
+                                        EqualsBinString);
+
+    HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
+    RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
+
+    // Make room for the config snapshots, which are published as the trees are loaded.
+    static const char* snapshotDirs[] = { CFG_TREE_SNAPSHOT_PATH, CFG_APP_SNAPSHOT_PATH };
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(snapshotDirs); i++)
+    {
+        LE_ERROR_IF(le_dir_MakePath(snapshotDirs[i],
+                                    S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) != LE_OK,
+                    "Failed to create config snapshot directory '%s'.", snapshotDirs[i]);
+    }
+
+    // Preload the system tree.
+    tdb_GetRootNode(tdb_GetTree("system"));
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Set how long a tree can go without being used before it is unloaded from memory.  Unloaded
+ *  trees are loaded again from the filesystem when next read.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_SetTreeEvictionTimeout
+(
+    time_t timeout  ///< [IN] The timeout in seconds, or 0 to keep all trees loaded.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (timeout == EvictionTimeout)
+    {
+        return;
+    }
 
-    // Initialize the memory pools.
-    NodePoolRef = le_mem_CreatePool(CFG_NODE_POOL_NAME, sizeof(Node_t));
-    le_mem_SetDestructor(NodePoolRef, NodeDestructor);
-    le_mem_SetNumObjsToForce(NodePoolRef, 50);    // Grow in chunks of 50 blocks.
+    LE_DEBUG("** Setting the tree eviction timeout to %d seconds.", (int)timeout);
 
-    // For now (until pool config is added to the framework), set a minimum size.
-    if (le_mem_GetObjectCount(NodePoolRef) != 0)
+    EvictionTimeout = timeout;
+
+    if (EvictionTimerRef == NULL)
     {
-        LE_WARN("TODO: Remove this code.");
+        EvictionTimerRef = le_timer_Create("Tree Eviction Timer");
+
+        LE_ASSERT(le_timer_SetHandler(EvictionTimerRef, OnEvictionTimer) == LE_OK);
+        LE_ASSERT(le_timer_SetWakeup(EvictionTimerRef, false) == LE_OK);
+        LE_ASSERT(le_timer_SetRepeat(EvictionTimerRef, 0) == LE_OK);
     }
     else
     {
-        le_mem_ExpandPool(NodePoolRef, 1000);
+        le_timer_Stop(EvictionTimerRef);
     }
 
+    if (timeout > 0)
+    {
+        le_clk_Time_t interval = { .sec = timeout, .usec = 0 };
 
-    TreePoolRef = le_mem_CreatePool(CFG_TREE_POOL_NAME, sizeof(Tree_t));
-    le_mem_SetDestructor(TreePoolRef, TreeDestructor);
-    TreeCollectionRef = le_hashmap_Create(CFG_TREE_COLLECTION_NAME,
-                                          31,
-                                          le_hashmap_HashString,
-                                          le_hashmap_EqualsString);
-
-    HandlerRegistrationMap = le_hashmap_Create(CFG_HANDLER_REG_NAME,
-                                               31,
-                                               le_hashmap_HashString,
-                                               le_hashmap_EqualsString);
-
-    HandlerSafeRefMap = le_ref_CreateMap(CFG_HANDLER_REF_MAP, 5);
-
-    HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
-    RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
-
-    // Preload the system tree.
-    tdb_GetTree("system");
+        LE_ASSERT(le_timer_SetInterval(EvictionTimerRef, interval) == LE_OK);
+        LE_ASSERT(le_timer_Start(EvictionTimerRef) == LE_OK);
+    }
 }
 
 
@@ -2805,11 +6163,13 @@ tdb_TreeRef_t tdb_GetTree
 
     if (treeRef == NULL)
     {
-        // Looks like we don't so create an object for it, and add it to our map.
+        // Looks like we don't so create an object for it, and add it to our map.  The tree itself
+        // isn't loaded until its nodes are first read, only its revision is found now.
         treeRef = NewTree(treeNamePtr, NULL);
         le_hashmap_Put(TreeCollectionRef, treeRef->name, treeRef);
 
-        LoadTree(treeRef);
+        ImportTree(treeNamePtr);
+        UpdateRevision(treeRef);
     }
 
     // Finally return the tree we have to the user.
@@ -2835,7 +6195,7 @@ void tdb_DeleteTree
 {
     // Check to see if there are any active iterators on the tree.  If there are, simply mark the
     // tree for deletion for now.
-    if (   (tdb_GetActiveWriteIter(treeRef) == NULL)
+    if (   (tdb_HasActiveWriters(treeRef) == false)
         && (tdb_HasActiveReaders(treeRef) == 0)
         && (le_sls_IsEmpty(&treeRef->requestList)))
     {
@@ -2854,6 +6214,9 @@ void tdb_DeleteTree
             }
         }
 
+        DeleteDeltaLog(treeRef);
+        RemoveSnapshot(CFG_TREE_SNAPSHOT_PATH, treeRef->name);
+
         LE_ASSERT(le_hashmap_Remove(TreeCollectionRef, treeRef->name) == treeRef);
         le_mem_Release(treeRef);
     }
@@ -2903,8 +6266,10 @@ tdb_TreeRef_t tdb_ShadowTree
 // -------------------------------------------------------------------------------------------------
 {
     LE_ASSERT(treeRef->originalTreeRef == NULL);
-    tdb_TreeRef_t shadowRef = NewTree(treeRef->name, NewShadowNode(treeRef->rootNodeRef));
+    tdb_TreeRef_t shadowRef = NewTree(treeRef->name,
+                                      NewShadowNode(GetLoadedRootNode(treeRef)));
     shadowRef->originalTreeRef = treeRef;
+    shadowRef->generation = treeRef->generation;
 
     return shadowRef;
 }
@@ -2912,6 +6277,68 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Make a snapshot of a tree: a copy of the tree as it is now, that isn't affected by the changes
+ *  later merged into the tree.  The read transactions active on a tree are moved to a snapshot
+ *  before a change is merged into the tree, so that they don't have to hold up the change.
+ *
+ *  The snapshot is released once the caller has released it and all of the iterators registered
+ *  on it have been released.
+ *
+ *  @return Pointer to the new snapshot tree, or NULL if the tree is waiting to be deleted.  (The
+ *          deletion waits for the tree's readers to finish, so they are left where they are.)
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_SnapshotTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to take a snapshot of.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef->originalTreeRef == NULL);
+    LE_ASSERT(treeRef->isSnapshot == false);
+
+    if (treeRef->isDeletePending)
+    {
+        return NULL;
+    }
+
+    tdb_TreeRef_t snapshotRef = NewTree(treeRef->name, CopyNode(GetLoadedRootNode(treeRef)));
+    snapshotRef->isSnapshot = true;
+
+    return snapshotRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the tree that a shadow tree was created from.
+ *
+ *  @return The tree being shadowed, or the tree itself if it isn't a shadow tree.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_GetOriginalTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef != NULL);
+
+    if (treeRef->originalTreeRef != NULL)
+    {
+        return treeRef->originalTreeRef;
+    }
+
+    return treeRef;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -2946,7 +6373,33 @@ tdb_NodeRef_t tdb_GetRootNode
 // -------------------------------------------------------------------------------------------------
 {
     LE_ASSERT(treeRef != NULL);
-    return treeRef->rootNodeRef;
+    return GetLoadedRootNode(treeRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call to check for any active write iterators on the tree.
+ *
+ *  @return True if there are active write iterators on the tree, False otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_HasActiveWriters
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef != NULL);
+
+    if (treeRef->originalTreeRef != NULL)
+    {
+        treeRef = treeRef->originalTreeRef;
+    }
+
+    return le_dls_IsEmpty(&treeRef->writeLockList) == false;
 }
 
 
@@ -2954,13 +6407,13 @@ tdb_NodeRef_t tdb_GetRootNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Get a pointer to the write iterator that's active on the current tree.
+ *  Call to check for write iterators on the tree that have been closed, but not yet released.
+ *  Their commits are waiting for the tree's readers to finish.
  *
- *  @return A pointer to the write iterator currently active on the tree.  NULL if there isn't an
- *          iterator on the tree.
+ *  @return True if there are closed write iterators on the tree, False otherwise.
  */
 // -------------------------------------------------------------------------------------------------
-ni_IteratorRef_t tdb_GetActiveWriteIter
+bool tdb_HasClosedWriters
 (
     tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
 )
@@ -2970,10 +6423,80 @@ ni_IteratorRef_t tdb_GetActiveWriteIter
 
     if (treeRef->originalTreeRef != NULL)
     {
-        return treeRef->originalTreeRef->activeWriteIterRef;
+        treeRef = treeRef->originalTreeRef;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&treeRef->writeLockList);
+
+    while (linkPtr != NULL)
+    {
+        if (ni_IsClosed(CONTAINER_OF(linkPtr, WriteLock_t, link)->iteratorRef))
+        {
+            return true;
+        }
+
+        linkPtr = le_dls_PeekNext(&treeRef->writeLockList, linkPtr);
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check whether a write iterator on the tree has locked a subtree that overlaps with the subtree
+ *  at the given path.  A write iterator locks the subtree it was created on.
+ *
+ *  @return True if a write to the subtree has to wait for an active write iterator to finish,
+ *          False if it can go ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_IsSubtreeWriteLocked
+(
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree object to read.
+    const char* pathPtr     ///< [IN] Path to the subtree, relative to the root of the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef != NULL);
+
+    if (treeRef->originalTreeRef != NULL)
+    {
+        treeRef = treeRef->originalTreeRef;
+    }
+
+    if (le_dls_IsEmpty(&treeRef->writeLockList))
+    {
+        return false;
+    }
+
+    // A bad path is treated as the whole tree.  The write is rejected once it gets to go ahead.
+    char fullPath[CFG_MAX_PATH_SIZE] = "/";
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix("/");
+
+    if (   (le_pathIter_Append(pathRef, pathPtr) != LE_OK)
+        || (le_pathIter_GetPath(pathRef, fullPath, sizeof(fullPath)) != LE_OK))
+    {
+        LE_ASSERT(le_utf8_Copy(fullPath, "/", sizeof(fullPath), NULL) == LE_OK);
+    }
+
+    le_pathIter_Delete(pathRef);
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&treeRef->writeLockList);
+
+    while (linkPtr != NULL)
+    {
+        if (PathsOverlap(CONTAINER_OF(linkPtr, WriteLock_t, link)->path, fullPath))
+        {
+            return true;
+        }
+
+        linkPtr = le_dls_PeekNext(&treeRef->writeLockList, linkPtr);
     }
 
-    return treeRef->activeWriteIterRef;
+    return false;
 }
 
 
@@ -3007,7 +6530,8 @@ bool tdb_HasActiveReaders
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Register an iterator on the given tree.
+ *  Register an iterator on the given tree.  An iterator registered on a snapshot holds a reference
+ *  to the snapshot, which it gives up when the tree is released.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_RegisterIterator
@@ -3020,16 +6544,34 @@ void tdb_RegisterIterator
     LE_ASSERT(treeRef != NULL);
     LE_ASSERT(iteratorRef != NULL);
 
+    if (treeRef->isSnapshot)
+    {
+        LE_ASSERT(ni_IsWriteable(iteratorRef) == false);
+        le_mem_AddRef(treeRef);
+    }
+
     if (treeRef->originalTreeRef != NULL)
     {
         treeRef = treeRef->originalTreeRef;
     }
 
+    treeRef->lastAccessTime = le_clk_GetRelativeTime();
+
     if (ni_IsWriteable(iteratorRef))
     {
-        LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-        treeRef->activeWriteIterRef = iteratorRef;
-        LE_ASSERT(treeRef->activeWriteIterRef != NULL);
+        // The iterator locks the subtree it starts on.
+        WriteLock_t* lockPtr = le_mem_ForceAlloc(WriteLockPoolRef);
+
+        lockPtr->link = LE_DLS_LINK_INIT;
+        lockPtr->iteratorRef = iteratorRef;
+
+        if (ni_GetPathForNode(iteratorRef, NULL, lockPtr->path, sizeof(lockPtr->path)) != LE_OK)
+        {
+            LE_ASSERT(le_utf8_Copy(lockPtr->path, "/", sizeof(lockPtr->path), NULL) == LE_OK);
+        }
+
+        LE_ASSERT(FindWriteLock(treeRef, iteratorRef) == NULL);
+        le_dls_Queue(&treeRef->writeLockList, &lockPtr->link);
     }
     else
     {
@@ -3060,16 +6602,20 @@ void tdb_UnregisterIterator
         treeRef = treeRef->originalTreeRef;
     }
 
+    treeRef->lastAccessTime = le_clk_GetRelativeTime();
+
     if (ni_IsWriteable(iteratorRef))
     {
-        LE_FATAL_IF(treeRef->activeWriteIterRef != iteratorRef,
+        WriteLock_t* lockPtr = FindWriteLock(treeRef, iteratorRef);
+
+        LE_FATAL_IF(lockPtr == NULL,
                     "Internal error, unregistering write iterator <%p>, "
-                    "but tree had write iterator <%p> registered on tree <%p>.",
+                    "but it wasn't registered on tree <%p>.",
                     iteratorRef,
-                    treeRef->activeWriteIterRef,
                     treeRef);
 
-        treeRef->activeWriteIterRef = NULL;
+        le_dls_Remove(&treeRef->writeLockList, &lockPtr->link);
+        le_mem_Release(lockPtr);
     }
     else
     {
@@ -3116,83 +6662,75 @@ le_sls_List_t* tdb_GetRequestQueue
 /**
  *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
  *  updated tree is serialized to the filesystem.
+ *
+ *  Other transactions may have been committed to the tree since the shadow tree was created.  If
+ *  any of them changed the nodes that this one changes, nothing is merged.
+ *
+ *  @return LE_OK if the changes were merged, LE_BUSY if they conflict with changes committed by
+ *          another transaction.
  */
 // -------------------------------------------------------------------------------------------------
-void tdb_MergeTree
+le_result_t tdb_MergeTree
 (
     tdb_TreeRef_t shadowTreeRef  ///< [IN] Merge the nodes from this tree into their base tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
-    // iterator to track the merge and allow for update handlers to be called.
-    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
-    le_pathIter_Ref_t pathRef = CreateBasePath(shadowTreeRef->originalTreeRef->name);
-
-    InternalMergeTree(shadowTreeRef->originalTreeRef->name, pathRef, nodeRef, false);
-    le_pathIter_Delete(pathRef);
-
-    // Now, go through and call the triggered callbacks.
-    FireTriggeredCallbacks();
-
-    // Now increment revision of the tree and open a tree file for writing.
+    // Get our shadow tree's root node and merge it's changes into the real tree.  The tree's
+    // registrations are followed along with the merge to find the update handlers to call.
     tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
-    int oldId = originalTreeRef->revisionId;
+    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
 
-    IncrementRevision(originalTreeRef);
+    // If nothing else has been committed since the shadow tree was created, there can't be a
+    // conflict.
+    if (   (shadowTreeRef->generation != originalTreeRef->generation)
+        && (HasConflict(nodeRef, originalTreeRef->rootNodeRef, shadowTreeRef->generation)))
+    {
+        return LE_BUSY;
+    }
 
-    char filePath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(originalTreeRef->name, originalTreeRef->revisionId, filePath, sizeof(filePath));
+    originalTreeRef->generation++;
+    originalTreeRef->lastAccessTime = le_clk_GetRelativeTime();
+    MergeGeneration = originalTreeRef->generation;
 
-    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
+    Registration_t* registrationPtr = FindRegistration(&TreeRegistrationList,
+                                                       originalTreeRef->name);
 
-    int fileRef = -1;
+    // The apps whose config snapshots are affected have to be found while the changes are still
+    // flagged in the shadow tree.
+    ChangedApps_t changedApps = { .isAll = false, .count = 0 };
 
-    do
+    if (strcmp(originalTreeRef->name, "system") == 0)
     {
-        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        GetChangedApps(nodeRef, &changedApps);
     }
-    while (   (fileRef == -1)
-           && (errno == EINTR));
 
-    if ((-1 == fileRef) && (EROFS == errno))
-    {
-        // In case we are R/O for the config tree, we discard the update to flash
-        return;
-    }
+    // The changes are appended to the tree's delta log as they are merged.  If that can't be done,
+    // the whole tree is written out to a new tree file instead.
+    bool isLogged = StartDeltaLog(originalTreeRef);
 
-    if (fileRef == -1)
+    bool isModified = InternalMergeTree(registrationPtr, nodeRef, false);
+
+    if (isLogged)
     {
-        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
-        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
-                 "filesystem!!");
-        return;
+        isLogged = FinishDeltaLog(originalTreeRef);
     }
 
-    // We have a tree file to write to, so stream the new tree to it then close the output file.
-    le_result_t writeResult = tdb_WriteTreeNode(originalTreeRef->rootNodeRef, fileRef);
-    int retVal = -1;
-
-    retVal = close(fileRef);
-
-    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+    // Now, go through and call the triggered callbacks.
+    FireTriggeredCallbacks();
 
-    // Finally remove the old version of the tree file, if there is one.
-    if (writeResult == LE_OK)
+    // Now write the updated tree out to the filesystem.
+    if (isLogged == false)
     {
-        if (   (oldId != 0)
-            && (TreeFileExists(originalTreeRef->name, oldId)))
-        {
-            GetTreePath(originalTreeRef->name, oldId, filePath, sizeof(filePath));
-            DeleteTreeFile(filePath);
-        }
+        SaveTree(originalTreeRef);
     }
-    else
+
+    if (isModified)
     {
-        // The write failed, delete the new file we attempted to create.
-        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
-        DeleteTreeFile(filePath);
+        PublishChangedSnapshots(originalTreeRef, &changedApps);
     }
+
+    return LE_OK;
 }
 
 
@@ -3211,7 +6749,8 @@ void tdb_ReleaseTree
 {
     LE_ASSERT(treeRef != NULL);
 
-    if (treeRef->originalTreeRef != NULL)
+    if (   (treeRef->originalTreeRef != NULL)
+        || (treeRef->isSnapshot))
     {
         le_mem_Release(treeRef);
     }
@@ -3334,29 +6873,28 @@ le_result_t tdb_WriteTreeNode
 // -------------------------------------------------------------------------------------------------
 tdb_NodeRef_t tdb_GetNode
 (
-    tdb_NodeRef_t baseNodeRef,     ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+    tdb_NodeRef_t baseNodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_View_t* nodePathPtr    ///< [IN] The path we're searching for in the tree.  The
+                                       ///<      view is walked to its end.
 )
 // -------------------------------------------------------------------------------------------------
 {
     LE_ASSERT(baseNodeRef != NULL);
-    LE_ASSERT(nodePathRef != NULL);
+    LE_ASSERT(nodePathPtr != NULL);
 
     // Check to see if we're starting at the given node, or that node's root node.
-    tdb_NodeRef_t currentRef = GetPathBaseNodeRef(baseNodeRef, nodePathRef);
+    tdb_NodeRef_t currentRef = GetPathBaseNodeRef(baseNodeRef, nodePathPtr);
 
     // Now start moving along the path, moving the current node along as we go.  The called function
     // also deals with . and .. names in the path as well, returning the current and parent nodes
     // respectivly.
     char nameRef[LE_CFG_NAME_LEN_BYTES] = "";
 
-    le_result_t result = le_pathIter_GoToStart(nodePathRef);
+    le_result_t result = GetNextPathName(nodePathPtr, nameRef);
 
     while (   (result != LE_NOT_FOUND)
            && (currentRef != NULL))
     {
-        result = le_pathIter_GetCurrentNode(nodePathRef, nameRef, sizeof(nameRef));
-
         if (result == LE_OVERFLOW)
         {
             LE_ERROR("Path segment overflow on path.");
@@ -3365,7 +6903,7 @@ tdb_NodeRef_t tdb_GetNode
         else if (result == LE_OK)
         {
             currentRef = GetNamedChild(currentRef, nameRef);
-            result = le_pathIter_GoToNext(nodePathRef);
+            result = GetNextPathName(nodePathPtr, nameRef);
         }
     }
 
@@ -3385,29 +6923,28 @@ tdb_NodeRef_t tdb_GetNode
 // -------------------------------------------------------------------------------------------------
 tdb_NodeRef_t tdb_CreateNodePath
 (
-    tdb_NodeRef_t baseNodeRef,     ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're creating within the tree.
+    tdb_NodeRef_t baseNodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_View_t* nodePathPtr    ///< [IN] The path we're creating within the tree.  The
+                                       ///<      view is walked to its end.
 )
 // -------------------------------------------------------------------------------------------------
 {
     LE_ASSERT(baseNodeRef != NULL);
-    LE_ASSERT(nodePathRef != NULL);
+    LE_ASSERT(nodePathPtr != NULL);
 
     // Check to see if we're starting at the given node, or that node's root node.
-    tdb_NodeRef_t currentRef = GetPathBaseNodeRef(baseNodeRef, nodePathRef);
+    tdb_NodeRef_t currentRef = GetPathBaseNodeRef(baseNodeRef, nodePathPtr);
 
     // Now start moving along the path, moving the current node along as we go.  The called function
     // also deals with . and .. names in the path as well, returning the current and parent nodes
     // respectivly.
     char nameRef[LE_CFG_NAME_LEN_BYTES] = "";
 
-    le_result_t result = le_pathIter_GoToStart(nodePathRef);
+    le_result_t result = GetNextPathName(nodePathPtr, nameRef);
 
     while (   (result != LE_NOT_FOUND)
            && (currentRef != NULL))
     {
-        result = le_pathIter_GetCurrentNode(nodePathRef, nameRef, sizeof(nameRef));
-
         if (result == LE_OK)
         {
             tdb_NodeRef_t childRef = GetNamedChild(currentRef, nameRef);
@@ -3418,7 +6955,7 @@ tdb_NodeRef_t tdb_CreateNodePath
             }
 
             currentRef = childRef;
-            result = le_pathIter_GoToNext(nodePathRef);
+            result = GetNextPathName(nodePathPtr, nameRef);
         }
         else if (result == LE_OVERFLOW)
         {
@@ -3487,19 +7024,12 @@ le_result_t tdb_GetNodeName
     // NULL.  The reason that the name may be NULL is because the client never changed the name of
     // the node.  So, we just get the name from the original node, saving memory.  However, nodes
     // like the root node of a tree also do not have names.
-    dstr_Ref_t nameRef = nodeRef->nameRef;
-
-    if (   (IsShadow(nodeRef))
-        && (nodeRef->nameRef == NULL)
-        && (nodeRef->shadowRef != NULL))
-    {
-        nameRef = nodeRef->shadowRef->nameRef;
-    }
+    istr_Ref_t nameRef = GetNameRef(nodeRef);
 
     // If the node has a name, copy it into the user buffer now.
     if (nameRef != NULL)
     {
-        return dstr_CopyToCstr(stringPtr, maxSize, nameRef, NULL);
+        return istr_CopyToCstr(stringPtr, maxSize, nameRef);
     }
 
     return LE_OK;
@@ -3557,14 +7087,11 @@ le_result_t tdb_SetNodeName
 
     // Copy over the new name.  Note that we don't care if this node is a shadow node.  Coping over
     // the name is taken care of as part of the merge process.
-    if (nodeRef->nameRef == NULL)
-    {
-        nodeRef->nameRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
-    {
-        dstr_CopyFromCstr(nodeRef->nameRef, stringPtr);
-    }
+    UnindexNode(nodeRef);
+
+    SetString(&nodeRef->nameRef, stringPtr);
+
+    IndexNode(nodeRef);
 
     // If this is a shadow node and this is the change that modified it, then try to get it's
     // children now.  This is done so that later when this node is merged the merge code doesn't end
@@ -3679,6 +7206,12 @@ void tdb_SetEmpty
         return;
     }
 
+    // Callers may reuse the child collection for a value even if there are (deleted) children left
+    // in it, so the index can't be trusted after this.  Children that haven't been loaded yet
+    // are simply forgotten.
+    DropChildIndex(nodeRef);
+    ReleaseImage(nodeRef);
+
     le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
     // If the node is already empty then there isn't much left to do.
@@ -3697,9 +7230,7 @@ void tdb_SetEmpty
         {
             tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
 
-            // We don't remove the child from the list explicitly, because the destructor will take
-            // care of that for us.
-            le_mem_Release(childRef);
+            RemoveNode(childRef);
             childRef = nextChildRef;
         }
 
@@ -3708,7 +7239,7 @@ void tdb_SetEmpty
     else if (nodeRef->info.valueRef)
     {
         // It's a string value, so free it now.
-        dstr_Release(nodeRef->info.valueRef);
+        istr_Release(nodeRef->info.valueRef);
         nodeRef->info.valueRef = NULL;
     }
 
@@ -3757,7 +7288,7 @@ void tdb_DeleteNode
     }
     else
     {
-        le_mem_Release(nodeRef);
+        RemoveNode(nodeRef);
     }
 }
 
@@ -3800,6 +7331,8 @@ tdb_NodeRef_t tdb_GetFirstChildNode
 {
     LE_ASSERT(nodeRef != NULL);
 
+    LoadChildren(nodeRef);
+
     // Is this the type of node that has children?
     if (   (   (nodeRef->type != LE_CFG_TYPE_STEM)
             || (le_dls_IsEmpty(&nodeRef->info.children) == true))
@@ -3957,13 +7490,13 @@ le_result_t tdb_GetValueAsString
         if (IsShadow(nodeRef))
         {
             LE_ASSERT(nodeRef->shadowRef != NULL);
-            return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->shadowRef->info.valueRef, NULL);
+            return istr_CopyToCstr(stringPtr, maxSize, nodeRef->shadowRef->info.valueRef);
         }
 
         return LE_OK;
     }
 
-    return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->info.valueRef, NULL);
+    return istr_CopyToCstr(stringPtr, maxSize, nodeRef->info.valueRef);
 }
 
 
@@ -3995,14 +7528,7 @@ void tdb_SetValueAsString
     // Mark this as a string node, and copy over the value.
     nodeRef->type = LE_CFG_TYPE_STRING;
 
-    if (nodeRef->info.valueRef == NULL)
-    {
-        nodeRef->info.valueRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
-    {
-        dstr_CopyFromCstr(nodeRef->info.valueRef, stringPtr);
-    }
+    SetString(&nodeRef->info.valueRef, stringPtr);
 
     // Make sure the system knows this node has been modified so that it can be included for merging
     // into the original tree.  Also, make sure that this node and it's parents are not marked as
@@ -4284,26 +7810,54 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
         return NULL;
     }
 
-    // Find the registration object for the given node, if it currently exists.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, newPathBuffer);
+    // Walk down the registration trie, from the tree's registration object to the one for the
+    // given node, creating any that don't exist yet.
+    char nameBuffer[LE_CFG_NAME_LEN_BYTES] = { 0 };
+    tp_GetTreeName(nameBuffer, newPathBuffer);
+
+    le_pathIter_View_t pathView;
+    le_pathIter_InitView(&pathView, tp_GetPathOnly(newPathBuffer), "/");
 
-    if (foundRegistrationPtr == NULL)
+    le_dls_List_t* listPtr = &TreeRegistrationList;
+    Registration_t* parentPtr = NULL;
+    Registration_t* foundRegistrationPtr = NULL;
+
+    do
     {
-        // Looks like a registration object hasn't been created yet.  So, do so now and add it to
-        // our map.
-        foundRegistrationPtr = le_mem_ForceAlloc(RegistrationPool);
+        foundRegistrationPtr = FindRegistration(listPtr, nameBuffer);
+
+        if (foundRegistrationPtr == NULL)
+        {
+            foundRegistrationPtr = le_mem_ForceAlloc(RegistrationPool);
+
+            LE_ASSERT(le_utf8_Copy(foundRegistrationPtr->name,
+                                   nameBuffer,
+                                   sizeof(foundRegistrationPtr->name),
+                                   NULL) == LE_OK);
+            foundRegistrationPtr->parentPtr = parentPtr;
+            foundRegistrationPtr->childList = LE_DLS_LIST_INIT;
+            foundRegistrationPtr->siblingLink = LE_DLS_LINK_INIT;
+            foundRegistrationPtr->triggered = false;
+            foundRegistrationPtr->triggeredLink = LE_SLS_LINK_INIT;
+            foundRegistrationPtr->handlerList = LE_DLS_LIST_INIT;
+
+            le_dls_Queue(listPtr, &foundRegistrationPtr->siblingLink);
+        }
+
+        // The first node name follows the tree name.
+        result = GetNextPathName(&pathView, nameBuffer);
 
-        foundRegistrationPtr->triggered = false;
+        parentPtr = foundRegistrationPtr;
+        listPtr = &foundRegistrationPtr->childList;
+    }
+    while (result == LE_OK);
 
-        foundRegistrationPtr->handlerList = LE_DLS_LIST_INIT;
-        le_utf8_Copy(foundRegistrationPtr->registrationPath,
-                     newPathBuffer,
-                     sizeof(foundRegistrationPtr->registrationPath),
-                     NULL);
+    if (result == LE_OVERFLOW)
+    {
+        LE_ERROR("Change registration path error, node name too long.");
 
-        le_hashmap_Put(HandlerRegistrationMap,
-                       foundRegistrationPtr->registrationPath,
-                       foundRegistrationPtr);
+        ReleaseUnusedRegistrations(foundRegistrationPtr);
+        return NULL;
     }
 
     // Add this handler to the registration object to keep track of it for later.
@@ -4348,12 +7902,8 @@ void tdb_RemoveChangeHandler
         // Remove the handler object from the registration object's list.
         RemoveHandler(registrationPtr, handlerObjectPtr);
 
-        // If there are no more handlers in this registration object, kill the object.
-        if (le_dls_IsEmpty(&registrationPtr->handlerList))
-        {
-            le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-            le_mem_Release(registrationPtr);
-        }
+        // Kill off the registration objects that are no longer needed.
+        ReleaseUnusedRegistrations(registrationPtr);
     }
 }
 
@@ -4372,20 +7922,6 @@ void tdb_CleanUpHandlers
 //--------------------------------------------------------------------------------------------------
 {
     // Go through all of the registration objects and their registered event handlers.  Remove any
-    // that belong to the given session.  If the reg object is rendered empty by this, then queue
-    // up that object in the supplied delete queue.
-    CleanUpContext_t cleanUpContext = { sessionRef, LE_SLS_LIST_INIT };
-    le_hashmap_ForEach(HandlerRegistrationMap, OnHandlerRegistrationCleanup, &cleanUpContext);
-
-    // Now.  Go through the cleanUpContext delete queue and remove the registration object found
-    // within.
-    le_sls_Link_t* linkPtr = NULL;
-
-    while ((linkPtr = le_sls_Pop(&cleanUpContext.deleteQueue)) != NULL)
-    {
-        Registration_t* registrationPtr = CONTAINER_OF(linkPtr, Registration_t, link);
-
-        le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-        le_mem_Release(registrationPtr);
-    }
+    // that belong to the given session, along with any registration objects left empty.
+    CleanUpRegistrations(&TreeRegistrationList, sessionRef);
 }
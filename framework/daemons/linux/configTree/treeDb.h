@@ -60,6 +60,20 @@ void tdb_Init
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Set how long a tree can go without being used before it is unloaded from memory.  Unloaded
+ *  trees are loaded again from the filesystem when next read.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_SetTreeEvictionTimeout
+(
+    time_t timeout  ///< [IN] The timeout in seconds, or 0 to keep all trees loaded.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Get the named tree.
@@ -121,6 +135,41 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Make a snapshot of a tree: a copy of the tree as it is now, that isn't affected by the changes
+ *  later merged into the tree.
+ *
+ *  The snapshot is released once the caller has released it and all of the iterators registered
+ *  on it have been released.
+ *
+ *  @return Pointer to the new snapshot tree, or NULL if the tree is waiting to be deleted.  (The
+ *          deletion waits for the tree's readers to finish, so they are left where they are.)
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_SnapshotTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to take a snapshot of.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the tree that a shadow tree was created from.
+ *
+ *  @return The tree being shadowed, or the tree itself if it isn't a shadow tree.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_GetOriginalTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -153,13 +202,12 @@ tdb_NodeRef_t tdb_GetRootNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Get a pointer to the write iterator that's active on the current tree.
+ *  Call to check for any active write iterators on the tree.
  *
- *  @return A pointer to the write iterator currently active on the tree.  NULL if there isn't an
- *          iterator on the tree.
+ *  @return True if there are active write iterators on the tree, False otherwise.
  */
 // -------------------------------------------------------------------------------------------------
-ni_IteratorRef_t tdb_GetActiveWriteIter
+bool tdb_HasActiveWriters
 (
     tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
 );
@@ -167,6 +215,40 @@ ni_IteratorRef_t tdb_GetActiveWriteIter
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call to check for write iterators on the tree that have been closed, but not yet released.
+ *  Their commits are waiting for the tree's readers to finish.
+ *
+ *  @return True if there are closed write iterators on the tree, False otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_HasClosedWriters
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to read.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check whether a write iterator on the tree has locked a subtree that overlaps with the subtree
+ *  at the given path.  A write iterator locks the subtree it was created on.
+ *
+ *  @return True if a write to the subtree has to wait for an active write iterator to finish,
+ *          False if it can go ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_IsSubtreeWriteLocked
+(
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree object to read.
+    const char* pathPtr     ///< [IN] Path to the subtree, relative to the root of the tree.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Call to check for any active read iterator's on the tree.
@@ -184,7 +266,8 @@ bool tdb_HasActiveReaders
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Register an iterator on the given tree.
+ *  Register an iterator on the given tree.  An iterator registered on a snapshot holds a reference
+ *  to the snapshot, which it gives up when the tree is released.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_RegisterIterator
@@ -229,9 +312,15 @@ le_sls_List_t* tdb_GetRequestQueue
 /**
  *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
  *  updated tree is serialized to the filesystem.
+ *
+ *  Other transactions may have been committed to the tree since the shadow tree was created.  If
+ *  any of them changed the nodes that this one changes, nothing is merged.
+ *
+ *  @return LE_OK if the changes were merged, LE_BUSY if they conflict with changes committed by
+ *          another transaction.
  */
 // -------------------------------------------------------------------------------------------------
-void tdb_MergeTree
+le_result_t tdb_MergeTree
 (
     tdb_TreeRef_t shadowTreeRef  ///< [IN] Merge the ndoes from this tree into their base tree.
 );
@@ -297,8 +386,9 @@ le_result_t tdb_WriteTreeNode
 // -------------------------------------------------------------------------------------------------
 tdb_NodeRef_t tdb_GetNode
 (
-    tdb_NodeRef_t baseNodeRef,     ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+    tdb_NodeRef_t baseNodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_View_t* nodePathPtr    ///< [IN] The path we're searching for in the tree.  The
+                                       ///<      view is walked to its end.
 );
 
 
@@ -313,8 +403,9 @@ tdb_NodeRef_t tdb_GetNode
 // -------------------------------------------------------------------------------------------------
 tdb_NodeRef_t tdb_CreateNodePath
 (
-    tdb_NodeRef_t baseNodeRef,     ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're creating within the tree.
+    tdb_NodeRef_t baseNodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_View_t* nodePathPtr    ///< [IN] The path we're creating within the tree.  The
+                                       ///<      view is walked to its end.
 );
 
 
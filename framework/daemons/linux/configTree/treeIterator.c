@@ -315,6 +315,46 @@ static void FindFileTrees
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Find the trees staged for import from the previous system, which exist even if they haven't
+ *  been opened, and so imported, yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FindImportedTrees
+(
+    ti_TreeIteratorRef_t treeIteratorPtr  ///< [IN] The iterator to populate with tree info.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DIR* dirPtr = opendir(CFG_TREE_PATH "/import");
+
+    if (dirPtr == NULL)
+    {
+        return;
+    }
+
+    struct dirent* dirEntryPtr;
+
+    while ((dirEntryPtr = readdir(dirPtr)) != NULL)
+    {
+        // Skip ".", ".." and imports that are being finished.
+        if (dirEntryPtr->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        if (strlen(dirEntryPtr->d_name) < MAX_TREE_NAME_BYTES)
+        {
+            InsertTreeName(treeIteratorPtr, dirEntryPtr->d_name);
+        }
+    }
+
+    closedir(dirPtr);
+}
+
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -360,9 +400,11 @@ le_cfgAdmin_IteratorRef_t ti_CreateIterator
     iteratorPtr->treeList = LE_DLS_LIST_INIT;
     iteratorPtr->currentItemPtr = NULL;
 
-    // Gather all in memory trees, then gather all of the unloaded trees from the filesystem.
+    // Gather all in memory trees, then gather all of the unloaded trees from the filesystem,
+    // including those still waiting to be imported from the previous system.
     FindLoadedTrees(iteratorPtr);
     FindFileTrees(iteratorPtr);
+    FindImportedTrees(iteratorPtr);
 
     // Now, move the iterator to the first item.
     iteratorPtr->currentItemPtr = NULL;
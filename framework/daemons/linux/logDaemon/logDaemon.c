@@ -59,15 +59,29 @@
  * running process that belongs to an IPC session reference when the IPC system reports that
  * a session closed.  This is how the Log Control Daemon finds out that a client process died.
  *
+ * Log control tools that stream log messages each have a Stream object on the Stream List,
+ * holding their filters.  Each Log Session's stream level is the lowest level that any stream
+ * matching it wants, and is pushed to the client, which only sends the messages at or above that
+ * level.  The Log Control Daemon then applies the rest of the filters (regular expression
+ * included) before forwarding the messages to the log control tools.
+ *
+ * If the LE_LOG_PERSIST environment variable is set to a level name, the Log Control Daemon also
+ * keeps a stream of its own for all processes and components at that level, with no log control
+ * tool, and stores the messages it gets, along with the apps' standard output and error, in
+ * persistent log storage (see logPersist.h).
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
 #include "legato.h"
 #include "log.h"
 #include "logDaemon.h"
+#include "logPersist.h"
 #include "limit.h"
 #include "fileDescriptor.h"
 
+#include <regex.h>
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -205,6 +219,41 @@ TraceName_t;
 static le_mem_PoolRef_t TraceNamePoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * How long (in milliseconds) to wait for running processes to report their hot call sites to
+ * a log control tool's "hot" request.  Processes that don't report in time are left out.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOT_SITES_TIMEOUT_MS 2000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Objects of this type keep track of a log control tool's request for the hot call sites of
+ * running processes, while waiting for the processes to report them.
+ *
+ * The log control tool's IPC session holds a reference, as does each process that hasn't
+ * reported yet.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t toolIpcSessionRef;  ///< Log control tool's IPC session (NULL when done).
+    size_t              pendingCount;       ///< Number of processes that haven't reported yet.
+    le_timer_Ref_t      timerRef;           ///< Timer that gives up on the pending processes.
+}
+HotSitesQuery_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Hot Sites Query objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t HotSitesQueryPoolRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Objects of this type keep track of the log filtering state of a single running process.
@@ -223,6 +272,9 @@ typedef struct
     pid_t               pid;            ///< The process ID.
     le_msg_SessionRef_t ipcSessionRef;  ///< Reference to the IPC session connected to this process.
     le_dls_List_t       logSessionList; ///< List of log sessions in this process.
+    HotSitesQuery_t*    hotSitesQueryPtr; ///< Query waiting for this process's hot call sites
+                                          ///  (or NULL).
+    uint32_t            sentGeneration; ///< Settings Generation last pushed to this process.
 /* TODO: Implement shared memory.
     void*               sharedMemAddr;  ///< Address of base of memory region shared with
                                         ///  this process.
@@ -239,6 +291,16 @@ RunningProcess_t;
 static le_mem_PoolRef_t RunningProcessPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings Generation.  Incremented every time a log session's level is changed.  Each running
+ * process is only sent the levels of the log sessions that have changed since the generation
+ * it was last sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SettingsGeneration = 0;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log Session objects are used to store the log session details for a single, active log session
@@ -251,7 +313,9 @@ typedef struct
     le_dls_Link_t       link;               ///< Link in the Running Process's log session list.
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];  ///< The component name.
     le_log_Level_t      level;              ///< This session's log level.
+    uint32_t            generation;         ///< Settings Generation when the level last changed.
     le_dls_List_t       traceList;          ///< List of Trace objects for this log session.
+    le_log_Level_t      streamLevel;        ///< Lowest level streamed (-1 = not streamed).
 }
 LogSession_t;
 
@@ -291,6 +355,61 @@ Trace_t;
 static le_mem_PoolRef_t TracePoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream objects hold the filters of a log control tool that is streaming log messages.
+ *
+ * These objects are kept on the Stream List until the log control tool's IPC session closes.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;               ///< Link in the Stream List.
+    le_msg_SessionRef_t toolIpcSessionRef;  ///< Log control tool's IPC session (NULL for the
+                                            ///  Persist Stream).
+    char processName[LIMIT_MAX_PROCESS_NAME_BYTES];     ///< Process name, or "*" for all.
+    pid_t               pid;                ///< Process ID, or -1 if identified by name.
+    char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES]; ///< Component name, or "*" for all.
+    le_log_Level_t      level;              ///< Lowest level of the messages streamed.
+    bool                hasPattern;         ///< true if messages must match the pattern.
+    regex_t             pattern;            ///< Compiled regular expression (if hasPattern).
+}
+Stream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Stream objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StreamPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of Stream objects for all the log control tools that are streaming log messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t StreamList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the environment variable holding the lowest level of the messages to put in persistent
+ * log storage.  Persistent log storage is off if it isn't set.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PERSIST_ENV_VAR "LE_LOG_PERSIST"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream whose messages go to persistent log storage, or NULL if persistent log storage is off.
+ */
+//--------------------------------------------------------------------------------------------------
+static Stream_t* PersistStreamPtr = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum length of the data portion in a command packet.
@@ -730,6 +849,8 @@ static RunningProcess_t* CreateRunningProcess
 
     objPtr->pid = pid;
     objPtr->ipcSessionRef = ipcSessionRef;
+    objPtr->hotSitesQueryPtr = NULL;
+    objPtr->sentGeneration = SettingsGeneration;
 //    objPtr->sharedMemAddr = NULL;   // TODO: Implement shared memory.
 
     le_hashmap_Put(ProcessIdMapRef, &objPtr->pid, objPtr);
@@ -802,7 +923,9 @@ static LogSession_t* CreateLogSession
     }
 
     objPtr->level = -1;     // Indicates unknown state.
+    objPtr->generation = 0;
     objPtr->traceList = LE_DLS_LIST_INIT;
+    objPtr->streamLevel = -1;
     // TODO: implement shared memory.
 
     objPtr->link = LE_DLS_LINK_INIT;
@@ -957,6 +1080,17 @@ static bool ParseCmdPacket
         return true;
     }
 
+    // The hot call sites report has only command data.
+    if (commandCode == LOG_CMD_REPORT_HOT_SITES)
+    {
+        if (cmdDataPtrPtr)
+        {
+            *cmdDataPtrPtr = packetPtr;
+        }
+
+        return true;
+    }
+
     // Get the process name.
     if (processNamePtr)
     {
@@ -991,9 +1125,9 @@ static bool ParseCmdPacket
         }
     }
 
-    if (commandCode == LOG_CMD_FORGET_PROCESS)
+    if ((commandCode == LOG_CMD_FORGET_PROCESS) || (commandCode == LOG_CMD_LIST_HOT_SITES))
     {
-        // The forget process command has only a process name argument
+        // The forget process and hot call sites commands have only a process name argument
         // (terminated by '/' for consistency with other commands).
         return true;
     }
@@ -1099,49 +1233,267 @@ static void SendToLogTool
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sends a client an update to its log session settings.
+ * Sets a log session's level.  The client is not updated until SendLevelSettings() is called for
+ * its running process.
  **/
 //--------------------------------------------------------------------------------------------------
-static void UpdateClientSessionSettings
+static void SetSessionLevel
 (
-    RunningProcess_t* runningProcObjPtr,
-    LogSession_t* logSessionPtr
+    LogSession_t* logSessionPtr,
+    le_log_Level_t level                    ///< [IN] New level, or -1 to leave it as it is.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((level != (le_log_Level_t)-1) && (level != logSessionPtr->level))
+    {
+        logSessionPtr->level = level;
+        logSessionPtr->generation = ++SettingsGeneration;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch of componentName=level entries being packed into as few messages as possible for a client.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    RunningProcess_t*   runningProcObjPtr;  ///< Running process the batch is sent to.
+    char                command;            ///< LOG_CMD_SET_LEVELS or LOG_CMD_SET_STREAM_LEVELS.
+    le_msg_MessageRef_t msgRef;             ///< Message being filled, or NULL if none yet.
+    char*               payloadPtr;         ///< Payload of the message being filled.
+    size_t              maxSize;            ///< Size of the payload buffer.
+    size_t              packetLength;       ///< Number of bytes filled in so far.
+}
+LevelBatch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a componentName=level entry to a batch, sending what the batch holds so far if the entry
+ * doesn't fit.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AddToLevelBatch
+(
+    LevelBatch_t* batchPtr,
+    const char* componentName,
+    const char* levelStr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_msg_MessageRef_t msgRef;
-    char* payloadPtr;
-    size_t maxSize;
-    size_t byteCount;
+    size_t entrySize = strlen(componentName) + 1 + strlen(levelStr);
+
+    // Send what we have so far if this one doesn't fit.
+    if ((batchPtr->msgRef != NULL) && (batchPtr->packetLength + 1 + entrySize >= batchPtr->maxSize))
+    {
+        le_msg_Send(batchPtr->msgRef);
+        batchPtr->msgRef = NULL;
+    }
+
+    if (batchPtr->msgRef == NULL)
+    {
+        batchPtr->msgRef = le_msg_CreateMsg(batchPtr->runningProcObjPtr->ipcSessionRef);
+        batchPtr->payloadPtr = le_msg_GetPayloadPtr(batchPtr->msgRef);
+        batchPtr->maxSize = le_msg_GetMaxPayloadSize(batchPtr->msgRef);
+
+        batchPtr->payloadPtr[0] = batchPtr->command;
+        batchPtr->packetLength = 1;
+    }
 
-    // First send the level update, if it's not -1 (default).
-    if (logSessionPtr->level != (le_log_Level_t)-1)
+    size_t byteCount = snprintf(batchPtr->payloadPtr + batchPtr->packetLength,
+                                batchPtr->maxSize - batchPtr->packetLength,
+                                "%s%s=%s",
+                                (batchPtr->packetLength > 1) ? "/" : "",
+                                componentName,
+                                levelStr);
+
+    if (byteCount >= batchPtr->maxSize - batchPtr->packetLength)
+    {
+        LE_CRIT("Message too long (%zu bytes) to send to component '%s' in process '%s' (pid %d).",
+                byteCount,
+                componentName,
+                batchPtr->runningProcObjPtr->procNameObjPtr->name,
+                batchPtr->runningProcObjPtr->pid);
+        batchPtr->payloadPtr[batchPtr->packetLength] = '\0';
+    }
+    else
     {
-        msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
-        payloadPtr = le_msg_GetPayloadPtr(msgRef);
-        maxSize = le_msg_GetMaxPayloadSize(msgRef);
+        batchPtr->packetLength += byteCount;
+    }
+}
 
-        byteCount = snprintf(payloadPtr,
-                             maxSize,
-                             "%c%s/%s",
-                             LOG_CMD_SET_LEVEL,
-                             logSessionPtr->componentName,
-                             GetLevelString(logSessionPtr->level));
 
-        if (byteCount >= maxSize)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the last message of a batch, if it holds any entries.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void FlushLevelBatch
+(
+    LevelBatch_t* batchPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (batchPtr->msgRef != NULL)
+    {
+        if (batchPtr->packetLength > 1)
         {
-            LE_CRIT("Message too long (%zu bytes) to send to component '%s' in process '%s' (pid %d).",
-                    byteCount,
-                    logSessionPtr->componentName,
-                    runningProcObjPtr->procNameObjPtr->name,
-                    runningProcObjPtr->pid);
-            le_msg_ReleaseMsg(msgRef);
+            le_msg_Send(batchPtr->msgRef);
         }
         else
         {
-            le_msg_Send(msgRef);
+            le_msg_ReleaseMsg(batchPtr->msgRef);
+        }
+
+        batchPtr->msgRef = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a client the levels of all its log sessions that have changed since it was last updated.
+ * The levels are batched into as few messages as possible.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SendLevelSettings
+(
+    RunningProcess_t* runningProcObjPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LevelBatch_t batch = { .runningProcObjPtr = runningProcObjPtr,
+                           .command = LOG_CMD_SET_LEVELS,
+                           .msgRef = NULL };
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&runningProcObjPtr->logSessionList);
+    while (linkPtr != NULL)
+    {
+        LogSession_t* logSessionPtr = CONTAINER_OF(linkPtr, LogSession_t, link);
+
+        linkPtr = le_dls_PeekNext(&runningProcObjPtr->logSessionList, linkPtr);
+
+        // Skip sessions that haven't changed since the last time.
+        if (logSessionPtr->generation <= runningProcObjPtr->sentGeneration)
+        {
+            continue;
+        }
+
+        AddToLevelBatch(&batch, logSessionPtr->componentName, GetLevelString(logSessionPtr->level));
+    }
+
+    FlushLevelBatch(&batch);
+
+    runningProcObjPtr->sentGeneration = SettingsGeneration;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a stream wants the messages of a given component in a running process.
+ *
+ * @return  true if the stream matches.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool StreamMatches
+(
+    const Stream_t* streamPtr,
+    const RunningProcess_t* runningProcObjPtr,
+    const char* componentName
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (streamPtr->pid > 0)
+    {
+        if (streamPtr->pid != runningProcObjPtr->pid)
+        {
+            return false;
+        }
+    }
+    else if (   (strcmp(streamPtr->processName, "*") != 0)
+             && (strcmp(streamPtr->processName, runningProcObjPtr->procNameObjPtr->name) != 0) )
+    {
+        return false;
+    }
+
+    return (   (strcmp(streamPtr->componentName, "*") == 0)
+            || (strcmp(streamPtr->componentName, componentName) == 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a client the stream levels of all its log sessions whose stream level changed since the
+ * streams were last started or stopped.  The levels are batched into as few messages as possible.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateStreamLevels
+(
+    RunningProcess_t* runningProcObjPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LevelBatch_t batch = { .runningProcObjPtr = runningProcObjPtr,
+                           .command = LOG_CMD_SET_STREAM_LEVELS,
+                           .msgRef = NULL };
+
+    le_dls_Link_t* sessionLinkPtr = le_dls_Peek(&runningProcObjPtr->logSessionList);
+    while (sessionLinkPtr != NULL)
+    {
+        LogSession_t* logSessionPtr = CONTAINER_OF(sessionLinkPtr, LogSession_t, link);
+
+        sessionLinkPtr = le_dls_PeekNext(&runningProcObjPtr->logSessionList, sessionLinkPtr);
+
+        // The stream level is the lowest level wanted by any of the matching streams.
+        le_log_Level_t level = -1;
+
+        le_dls_Link_t* streamLinkPtr = le_dls_Peek(&StreamList);
+        while (streamLinkPtr != NULL)
+        {
+            Stream_t* streamPtr = CONTAINER_OF(streamLinkPtr, Stream_t, link);
+
+            if (   StreamMatches(streamPtr, runningProcObjPtr, logSessionPtr->componentName)
+                && ((level == (le_log_Level_t)-1) || (streamPtr->level < level)) )
+            {
+                level = streamPtr->level;
+            }
+
+            streamLinkPtr = le_dls_PeekNext(&StreamList, streamLinkPtr);
+        }
+
+        if (level != logSessionPtr->streamLevel)
+        {
+            logSessionPtr->streamLevel = level;
+
+            AddToLevelBatch(&batch,
+                            logSessionPtr->componentName,
+                            (level == (le_log_Level_t)-1) ? LOG_STREAM_OFF_STR
+                                                          : GetLevelString(level));
         }
     }
+
+    FlushLevelBatch(&batch);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates the stream levels of all running processes after a stream was started or stopped.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateAllStreamLevels
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(ProcessIdMapRef);
+    while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+    {
+        UpdateStreamLevels(le_hashmap_GetValue(iteratorRef));
+    }
 }
 
 
@@ -1209,9 +1561,9 @@ static void CopyComponentSettings
     ComponentName_t*    compNameObjPtr
 )
 {
-    logSessionPtr->level = compNameObjPtr->level;
+    SetSessionLevel(logSessionPtr, compNameObjPtr->level);
 
-    UpdateClientSessionSettings(runningProcObjPtr, logSessionPtr);
+    SendLevelSettings(runningProcObjPtr);
 
     // For all enabled traces for the component name.
     le_dls_Link_t* linkPtr = le_dls_Peek(&compNameObjPtr->enabledTracesList);
@@ -1441,49 +1793,134 @@ static void RegComponent
 
         UpdateProcCompSettings(runningProcObjPtr, logSessionPtr, procNameObjPtr, componentName);
     }
+
+    // Start streaming the new component's messages if a log control tool is waiting for them.
+    if (!le_dls_IsEmpty(&StreamList))
+    {
+        UpdateStreamLevels(runningProcObjPtr);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handle the closing of a client IPC session, which signals the death of a process.
+ * Finishes a hot call sites query by closing the log control tool's IPC session.  Processes that
+ * haven't reported yet are ignored when they do.
  **/
 //--------------------------------------------------------------------------------------------------
-static void ClientIpcSessionClosed
+static void FinishHotSitesQuery
 (
-    le_msg_SessionRef_t ipcSessionRef,
-    void* contextPtr    // not used.
+    HotSitesQuery_t* queryPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr;
+    if (queryPtr->toolIpcSessionRef != NULL)
+    {
+        le_msg_SessionRef_t toolIpcSessionRef = queryPtr->toolIpcSessionRef;
 
-    RunningProcess_t* runningProcObjPtr = FindProcessByIpcSession(ipcSessionRef);
+        queryPtr->toolIpcSessionRef = NULL;
+        le_timer_Stop(queryPtr->timerRef);
 
-    if (runningProcObjPtr == NULL)
+        // Clear the session context first, so the session close handler leaves the query alone.
+        le_msg_SetSessionContextPtr(toolIpcSessionRef, NULL);
+        le_msg_CloseSession(toolIpcSessionRef);
+
+        // Release the log control tool's reference.
+        le_mem_Release(queryPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Passes a running process's hot call sites on to the log control tool that asked for them.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void CompleteHotSitesReport
+(
+    RunningProcess_t* runningProcObjPtr,
+    const char* reportPtr                   ///< [IN] Report from the process, or NULL if the
+                                            ///       process went away before reporting.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    HotSitesQuery_t* queryPtr = runningProcObjPtr->hotSitesQueryPtr;
+
+    if (queryPtr == NULL)
     {
-        // This can happen if a client connects, but gets killed before it registers any
-        // log sessions.
-        LE_DEBUG("Unknown IPC session (%p) closed.", ipcSessionRef);
+        LE_DEBUG("Unexpected hot call sites report from pid %d.", runningProcObjPtr->pid);
         return;
     }
 
-    ProcessName_t* procNameObjPtr = runningProcObjPtr->procNameObjPtr;
-
-    LE_DEBUG("Process named '%s' with pid %d disconnected.",
-             procNameObjPtr->name,
-             runningProcObjPtr->pid);
+    runningProcObjPtr->hotSitesQueryPtr = NULL;
 
-    // Remove the process from the PID and IPC Session hash maps.
-    le_hashmap_Remove(ProcessIdMapRef, &runningProcObjPtr->pid);
-    le_hashmap_Remove(IpcSessionMapRef, &ipcSessionRef);
+    if ((queryPtr->toolIpcSessionRef != NULL) && (reportPtr != NULL))
+    {
+        char message[64];
 
-    // Delete all the log sessions for this process.
+        snprintf(message, sizeof(message), "  pid %d", runningProcObjPtr->pid);
+        SendToLogTool(queryPtr->toolIpcSessionRef, message);
 
-    LE_CRIT_IF(le_dls_IsEmpty(&runningProcObjPtr->logSessionList),
-               "Empty session list for process '%s' with pid %d!",
-               procNameObjPtr->name,
-               runningProcObjPtr->pid);
+        SendToLogTool(queryPtr->toolIpcSessionRef,
+                      (reportPtr[0] != '\0') ? reportPtr : "    (no rate-limited messages)");
+    }
+
+    queryPtr->pendingCount--;
+    if (queryPtr->pendingCount == 0)
+    {
+        FinishHotSitesQuery(queryPtr);
+    }
+
+    le_mem_Release(queryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the closing of a client IPC session, which signals the death of a process.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ClientIpcSessionClosed
+(
+    le_msg_SessionRef_t ipcSessionRef,
+    void* contextPtr    // not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    RunningProcess_t* runningProcObjPtr = FindProcessByIpcSession(ipcSessionRef);
+
+    if (runningProcObjPtr == NULL)
+    {
+        // This can happen if a client connects, but gets killed before it registers any
+        // log sessions.
+        LE_DEBUG("Unknown IPC session (%p) closed.", ipcSessionRef);
+        return;
+    }
+
+    ProcessName_t* procNameObjPtr = runningProcObjPtr->procNameObjPtr;
+
+    LE_DEBUG("Process named '%s' with pid %d disconnected.",
+             procNameObjPtr->name,
+             runningProcObjPtr->pid);
+
+    // If a log control tool is waiting for this process's hot call sites, stop waiting.
+    if (runningProcObjPtr->hotSitesQueryPtr != NULL)
+    {
+        CompleteHotSitesReport(runningProcObjPtr, NULL);
+    }
+
+    // Remove the process from the PID and IPC Session hash maps.
+    le_hashmap_Remove(ProcessIdMapRef, &runningProcObjPtr->pid);
+    le_hashmap_Remove(IpcSessionMapRef, &ipcSessionRef);
+
+    // Delete all the log sessions for this process.
+
+    LE_CRIT_IF(le_dls_IsEmpty(&runningProcObjPtr->logSessionList),
+               "Empty session list for process '%s' with pid %d!",
+               procNameObjPtr->name,
+               runningProcObjPtr->pid);
 
     while ((linkPtr = le_dls_Pop(&runningProcObjPtr->logSessionList)) != NULL)
     {
@@ -1540,11 +1977,9 @@ static void SetForRunningProcess
 
             if (levelPtr != NULL)
             {
-                logSessionObjPtr->level = *levelPtr;
+                SetSessionLevel(logSessionObjPtr, *levelPtr);
             }
 
-            UpdateClientSessionSettings(runningProcObjPtr, logSessionObjPtr);
-
             linkPtr = le_dls_PeekNext(&runningProcObjPtr->logSessionList, linkPtr);
         }
     }
@@ -1553,16 +1988,14 @@ static void SetForRunningProcess
     {
         // Find that session and apply the setting to it.
         LogSession_t* logSessionObjPtr = FindLogSession(runningProcObjPtr, componentName);
-        if (logSessionObjPtr != NULL)
+        if ((logSessionObjPtr != NULL) && (levelPtr != NULL))
         {
-            if (levelPtr != NULL)
-            {
-                logSessionObjPtr->level = *levelPtr;
-            }
-
-            UpdateClientSessionSettings(runningProcObjPtr, logSessionObjPtr);
+            SetSessionLevel(logSessionObjPtr, *levelPtr);
         }
     }
+
+    // Send all the changes to the process at once.
+    SendLevelSettings(runningProcObjPtr);
 }
 
 
@@ -2458,6 +2891,466 @@ static void ForgetProcess
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a hot call sites query times out.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void HotSitesTimerExpired
+(
+    le_timer_Ref_t timerRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    HotSitesQuery_t* queryPtr = le_timer_GetContextPtr(timerRef);
+    char message[128];
+
+    snprintf(message,
+             sizeof(message),
+             "***ERROR: %zu process(es) did not report their hot call sites in time.",
+             queryPtr->pendingCount);
+    SendToLogTool(queryPtr->toolIpcSessionRef, message);
+
+    FinishHotSitesQuery(queryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asks a running process to report its hot call sites.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void RequestHotSites
+(
+    RunningProcess_t* runningProcObjPtr,
+    HotSitesQuery_t* queryPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    HotSitesQuery_t* oldQueryPtr = runningProcObjPtr->hotSitesQueryPtr;
+
+    if (oldQueryPtr == NULL)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
+        char* payloadPtr = le_msg_GetPayloadPtr(msgRef);
+
+        payloadPtr[0] = LOG_CMD_LIST_HOT_SITES;
+        payloadPtr[1] = '\0';
+
+        le_msg_Send(msgRef);
+    }
+    // A process is only asked by one log control tool at a time.
+    else if (oldQueryPtr->toolIpcSessionRef != NULL)
+    {
+        char message[128];
+
+        snprintf(message,
+                 sizeof(message),
+                 "***ERROR: pid %d is busy with another request.",
+                 runningProcObjPtr->pid);
+        SendToLogTool(queryPtr->toolIpcSessionRef, message);
+        return;
+    }
+    // If the tool that asked before has given up, the report will go to this one instead.
+    else
+    {
+        runningProcObjPtr->hotSitesQueryPtr = NULL;
+        le_mem_Release(oldQueryPtr);
+    }
+
+    le_mem_AddRef(queryPtr);
+    runningProcObjPtr->hotSitesQueryPtr = queryPtr;
+    queryPtr->pendingCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asks running processes to report their hot call sites to a log control tool.  The processes are
+ * identified by PID, by process name, or by "*" for all processes.
+ *
+ * @note    The log control tool's IPC session is closed once all the processes have reported
+ *          (or the request times out).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ListHotSites
+(
+    const char* processName,
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char message[128];
+
+    HotSitesQuery_t* queryPtr = le_mem_ForceAlloc(HotSitesQueryPoolRef);
+    queryPtr->toolIpcSessionRef = toolIpcSessionRef;
+    queryPtr->pendingCount = 0;
+    queryPtr->timerRef = le_timer_Create("HotSites");
+    le_timer_SetMsInterval(queryPtr->timerRef, HOT_SITES_TIMEOUT_MS);
+    le_timer_SetHandler(queryPtr->timerRef, HotSitesTimerExpired);
+    le_timer_SetContextPtr(queryPtr->timerRef, queryPtr);
+
+    pid_t pid = StringToPid(processName);
+    if (pid > 0)
+    {
+        RunningProcess_t* runningProcObjPtr = le_hashmap_Get(ProcessIdMapRef, &pid);
+        if (runningProcObjPtr == NULL)
+        {
+            snprintf(message, sizeof(message), "***ERROR: PID %d not found.", pid);
+            LE_WARN("%s", message);
+            SendToLogTool(toolIpcSessionRef, message);
+        }
+        else
+        {
+            RequestHotSites(runningProcObjPtr, queryPtr);
+        }
+    }
+    else if (strcmp(processName, "*") == 0)
+    {
+        le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(ProcessIdMapRef);
+        while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+        {
+            RequestHotSites(le_hashmap_GetValue(iteratorRef), queryPtr);
+        }
+    }
+    else
+    {
+        ProcessName_t* procNameObjPtr = FindProcessName(processName);
+        le_dls_Link_t* linkPtr = NULL;
+
+        if (procNameObjPtr != NULL)
+        {
+            linkPtr = le_dls_Peek(&procNameObjPtr->runningProcessesList);
+        }
+
+        if (linkPtr == NULL)
+        {
+            snprintf(message, sizeof(message), "***ERROR: No process named '%s'.", processName);
+            LE_WARN("%s", message);
+            SendToLogTool(toolIpcSessionRef, message);
+        }
+
+        while (linkPtr != NULL)
+        {
+            RequestHotSites(CONTAINER_OF(linkPtr, RunningProcess_t, link), queryPtr);
+
+            linkPtr = le_dls_PeekNext(&procNameObjPtr->runningProcessesList, linkPtr);
+        }
+    }
+
+    if (queryPtr->pendingCount == 0)
+    {
+        FinishHotSitesQuery(queryPtr);
+    }
+    else
+    {
+        SendToLogTool(toolIpcSessionRef, "Messages (logged + suppressed), suppressed, call site:");
+
+        le_msg_SetSessionContextPtr(toolIpcSessionRef, queryPtr);
+        le_timer_Start(queryPtr->timerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts streaming the log messages of a process/component to a log control tool.  The processes
+ * are identified by PID, by process name, or by "*" for all processes, and the components by name
+ * or by "*" for all components.
+ *
+ * @return  true if the stream was started, false if the request was rejected (in which case an
+ *          error message has been sent to the log control tool).
+ *
+ * @note    The log control tool's IPC session is kept open until the tool closes it.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StartStream
+(
+    const char* processName,
+    const char* componentName,
+    const char* streamDataPtr,              ///< [IN] Level string, optionally followed by '/' and
+                                            ///       an extended regular expression.
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char message[128];
+    char levelStr[16] = "";
+    size_t numBytes = 0;
+
+    // The level goes up to the first '/'; the pattern (which may contain '/') is everything after.
+    if (le_utf8_CopyUpToSubStr(levelStr, streamDataPtr, "/", sizeof(levelStr), &numBytes) != LE_OK)
+    {
+        levelStr[0] = '\0';
+    }
+
+    le_log_Level_t level = log_StrToSeverityLevel(levelStr);
+    if (level == (le_log_Level_t)-1)
+    {
+        snprintf(message, sizeof(message), "***ERROR: Invalid log level '%s'.", levelStr);
+        LE_WARN("%s", message);
+        SendToLogTool(toolIpcSessionRef, message);
+        return false;
+    }
+
+    pid_t pid = StringToPid(processName);
+    if ((pid > 0) && (FindProcessByPid(pid) == NULL))
+    {
+        snprintf(message, sizeof(message), "***ERROR: PID %d not found.", pid);
+        LE_WARN("%s", message);
+        SendToLogTool(toolIpcSessionRef, message);
+        return false;
+    }
+
+    Stream_t* streamPtr = le_mem_ForceAlloc(StreamPoolRef);
+
+    streamPtr->hasPattern = (streamDataPtr[numBytes] == '/');
+    if (streamPtr->hasPattern)
+    {
+        int errCode = regcomp(&streamPtr->pattern,
+                              streamDataPtr + numBytes + 1,
+                              REG_EXTENDED | REG_NOSUB);
+        if (errCode != 0)
+        {
+            char errorStr[64];
+
+            regerror(errCode, &streamPtr->pattern, errorStr, sizeof(errorStr));
+            snprintf(message, sizeof(message), "***ERROR: Invalid pattern (%s).", errorStr);
+            LE_WARN("%s", message);
+            SendToLogTool(toolIpcSessionRef, message);
+
+            le_mem_Release(streamPtr);
+            return false;
+        }
+    }
+
+    streamPtr->link = LE_DLS_LINK_INIT;
+    streamPtr->toolIpcSessionRef = toolIpcSessionRef;
+    LE_ASSERT(le_utf8_Copy(streamPtr->processName,
+                           processName,
+                           sizeof(streamPtr->processName),
+                           NULL) == LE_OK);
+    streamPtr->pid = (pid > 0) ? pid : -1;
+    LE_ASSERT(le_utf8_Copy(streamPtr->componentName,
+                           componentName,
+                           sizeof(streamPtr->componentName),
+                           NULL) == LE_OK);
+    streamPtr->level = level;
+
+    le_dls_Queue(&StreamList, &streamPtr->link);
+
+    LE_DEBUG("Streaming '%s/%s' at level %s to log control tool session %p.",
+             processName,
+             componentName,
+             levelStr,
+             toolIpcSessionRef);
+
+    UpdateAllStreamLevels();
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops all the streams of a log control tool.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void StopStreams
+(
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isStopped = false;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&StreamList);
+    while (linkPtr != NULL)
+    {
+        Stream_t* streamPtr = CONTAINER_OF(linkPtr, Stream_t, link);
+
+        linkPtr = le_dls_PeekNext(&StreamList, linkPtr);
+
+        if (streamPtr->toolIpcSessionRef == toolIpcSessionRef)
+        {
+            le_dls_Remove(&StreamList, &streamPtr->link);
+
+            if (streamPtr->hasPattern)
+            {
+                regfree(&streamPtr->pattern);
+            }
+            le_mem_Release(streamPtr);
+
+            isStopped = true;
+        }
+    }
+
+    if (isStopped)
+    {
+        UpdateAllStreamLevels();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forwards a log message streamed by a client to the log control tools whose streams match it.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ForwardStreamMsg
+(
+    le_msg_SessionRef_t ipcSessionRef,      ///< [IN] Client's IPC session.
+    const char* packetPtr                   ///< [IN] The stream message packet.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RunningProcess_t* runningProcObjPtr = FindProcessByIpcSession(ipcSessionRef);
+
+    if (runningProcObjPtr == NULL)
+    {
+        LE_DEBUG("Log message streamed by unregistered client.");
+        return;
+    }
+
+    // Skip the command code, then get the component name and the level digit.
+    char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
+    size_t numBytes = 0;
+
+    packetPtr++;
+
+    if (   (le_utf8_CopyUpToSubStr(componentName, packetPtr, "/", sizeof(componentName), &numBytes)
+            != LE_OK)
+        || (packetPtr[numBytes] != '/')
+        || (packetPtr[numBytes + 1] < '0' + LE_LOG_DEBUG)
+        || (packetPtr[numBytes + 1] > '0' + LE_LOG_EMERG) )
+    {
+        LE_ERROR("Malformed streamed log message from pid %d.", runningProcObjPtr->pid);
+        return;
+    }
+
+    le_log_Level_t level = packetPtr[numBytes + 1] - '0';
+    const char* msgPtr = packetPtr + numBytes + 2;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&StreamList);
+    while (linkPtr != NULL)
+    {
+        Stream_t* streamPtr = CONTAINER_OF(linkPtr, Stream_t, link);
+
+        if (   (level >= streamPtr->level)
+            && StreamMatches(streamPtr, runningProcObjPtr, componentName)
+            && (   !streamPtr->hasPattern
+                || (regexec(&streamPtr->pattern, msgPtr, 0, NULL, 0) == 0) ) )
+        {
+            if (streamPtr == PersistStreamPtr)
+            {
+                logPersist_Write(level, msgPtr);
+            }
+            else
+            {
+                SendToLogTool(streamPtr->toolIpcSessionRef, msgPtr);
+            }
+        }
+
+        linkPtr = le_dls_PeekNext(&StreamList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts persistent log storage and the Persist Stream that feeds it, if the PERSIST_ENV_VAR
+ * environment variable is set.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void StartPersistStream
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* levelStr = getenv(PERSIST_ENV_VAR);
+
+    if (levelStr == NULL)
+    {
+        return;
+    }
+
+    le_log_Level_t level = log_StrToSeverityLevel(levelStr);
+    if (level == (le_log_Level_t)-1)
+    {
+        LE_ERROR("Invalid log level '%s' in %s.", levelStr, PERSIST_ENV_VAR);
+        return;
+    }
+
+    le_result_t result = logPersist_Init();
+    if (result != LE_OK)
+    {
+        LE_ERROR("Persistent log storage is not available (%s).", LE_RESULT_TXT(result));
+        return;
+    }
+
+    Stream_t* streamPtr = le_mem_ForceAlloc(StreamPoolRef);
+
+    streamPtr->link = LE_DLS_LINK_INIT;
+    streamPtr->toolIpcSessionRef = NULL;
+    LE_ASSERT(le_utf8_Copy(streamPtr->processName, "*", sizeof(streamPtr->processName), NULL)
+              == LE_OK);
+    streamPtr->pid = -1;
+    LE_ASSERT(le_utf8_Copy(streamPtr->componentName, "*", sizeof(streamPtr->componentName), NULL)
+              == LE_OK);
+    streamPtr->level = level;
+    streamPtr->hasPattern = false;
+
+    le_dls_Queue(&StreamList, &streamPtr->link);
+
+    PersistStreamPtr = streamPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the closing of a log control tool's IPC session.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ControlToolIpcSessionClosed
+(
+    le_msg_SessionRef_t ipcSessionRef,
+    void* contextPtr    // not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Stop streaming to the tool, if it was streaming.
+    StopStreams(ipcSessionRef);
+
+    // If the tool went away while waiting for hot call sites, the query is abandoned.
+    HotSitesQuery_t* queryPtr = le_msg_GetSessionContextPtr(ipcSessionRef);
+
+    if (queryPtr != NULL)
+    {
+        queryPtr->toolIpcSessionRef = NULL;
+        le_timer_Stop(queryPtr->timerRef);
+
+        le_mem_Release(queryPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor for Hot Sites Query objects.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void HotSitesQueryDestructor
+(
+    void* objPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_timer_Delete(((HotSitesQuery_t*)objPtr)->timerRef);
+}
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process a message received from a connected log session client.
@@ -2478,6 +3371,14 @@ static void ClientMsgReceiveHandler
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
     const char* commandDataPtr;
 
+    // Streamed log messages have no process name, and are the most frequent messages by far.
+    if (rxBuffPtr[0] == LOG_CMD_STREAM_MSG)
+    {
+        ForwardStreamMsg(ipcSessionRef, rxBuffPtr);
+        le_msg_ReleaseMsg(msgRef);
+        return;
+    }
+
     // Parse the packet to get the process and component names.
     if (ParseCmdPacket(rxBuffPtr, &command, processName, componentName, &commandDataPtr))
     {
@@ -2491,11 +3392,27 @@ static void ClientMsgReceiveHandler
 
                 return;
 
+            case LOG_CMD_REPORT_HOT_SITES:
+            {
+                RunningProcess_t* runningProcObjPtr = FindProcessByIpcSession(ipcSessionRef);
+
+                if (runningProcObjPtr != NULL)
+                {
+                    CompleteHotSitesReport(runningProcObjPtr, commandDataPtr);
+                }
+
+                break;
+            }
+
             case LOG_CMD_SET_LEVEL:
+            case LOG_CMD_SET_LEVELS:
+            case LOG_CMD_SET_STREAM_LEVELS:
             case LOG_CMD_ENABLE_TRACE:
             case LOG_CMD_DISABLE_TRACE:
             case LOG_CMD_LIST_COMPONENTS:
             case LOG_CMD_FORGET_PROCESS:
+            case LOG_CMD_LIST_HOT_SITES:
+            case LOG_CMD_STREAM:
 
                 LE_ERROR("Client attempted to issue a log control command (%c)!", command);
 
@@ -2566,6 +3483,8 @@ static void ControlToolMsgReceiveHandler
                 break;
 
             case LOG_CMD_REG_COMPONENT:
+            case LOG_CMD_REPORT_HOT_SITES:
+            case LOG_CMD_STREAM_MSG:
 
                 LE_ERROR("Unexpected command '%c' from log control tool.", command);
 
@@ -2583,6 +3502,25 @@ static void ControlToolMsgReceiveHandler
 
                 break;
 
+            case LOG_CMD_LIST_HOT_SITES:
+
+                // The session is closed once the processes have reported.
+                ListHotSites(processName, ipcSessionRef);
+                le_msg_ReleaseMsg(msgRef);
+
+                return;
+
+            case LOG_CMD_STREAM:
+
+                // The session is kept open until the log control tool closes it.
+                if (StartStream(processName, componentName, commandDataPtr, ipcSessionRef))
+                {
+                    le_msg_ReleaseMsg(msgRef);
+                    return;
+                }
+
+                break;
+
             default:
 
                 LE_ERROR("Unknown command byte '%c' received from log control tool.", command);
@@ -2657,6 +3595,15 @@ static void LogFdMessages
         // TODO: Don't log the app name for now so that it matches all the other log formats.  Add
         //       the app name to all log messages at the same time.
         log_LogGenericMsg(fdLogPtr->level, fdLogPtr->procName, fdLogPtr->pid, msg);
+
+        if ((PersistStreamPtr != NULL) && (c > 0) && (fdLogPtr->level >= PersistStreamPtr->level))
+        {
+            char persistMsg[MAX_MSG_SIZE + LIMIT_MAX_PROCESS_NAME_BYTES + 32];
+
+            snprintf(persistMsg, sizeof(persistMsg), "%s | %s[%d] | %.*s",
+                     GetLevelString(fdLogPtr->level), fdLogPtr->procName, fdLogPtr->pid, c, msg);
+            logPersist_Write(fdLogPtr->level, persistMsg);
+        }
     }
 
     if ( (events & POLLRDHUP) || (events & POLLERR) || (events & POLLHUP) )
@@ -2801,6 +3748,9 @@ COMPONENT_INIT
     LogSessionPoolRef = le_mem_CreatePool("LogSession", sizeof(LogSession_t));
     TracePoolRef = le_mem_CreatePool("Traces", sizeof(Trace_t));
     FdLogPoolRef = le_mem_CreatePool("FdLogs", sizeof(FdLog_t));
+    HotSitesQueryPoolRef = le_mem_CreatePool("HotSitesQuery", sizeof(HotSitesQuery_t));
+    StreamPoolRef = le_mem_CreatePool("Streams", sizeof(Stream_t));
+    le_mem_SetDestructor(HotSitesQueryPoolRef, HotSitesQueryDestructor);
 
     // Tune the pools' initial sizes to reduce warnings in the log at start-up.
     // TODO: Make this configurable.
@@ -2817,14 +3767,14 @@ COMPONENT_INIT
                                           MAX_EXPECTED_PROCESSES,
                                           le_hashmap_HashString,
                                           le_hashmap_EqualsString);
-    IpcSessionMapRef  = le_hashmap_Create("IPCSession",
-                                          MAX_EXPECTED_PROCESSES,
-                                          IpcSessionHash,
-                                          IpcSessionEquals);
-    ProcessIdMapRef   = le_hashmap_Create("ProcessID",
-                                          MAX_EXPECTED_PROCESSES,
-                                          ProcessIdHash,
-                                          ProcessIdEquals);
+    IpcSessionMapRef  = le_hashmap_CreateFlat("IPCSession",
+                                              MAX_EXPECTED_PROCESSES,
+                                              IpcSessionHash,
+                                              IpcSessionEquals);
+    ProcessIdMapRef   = le_hashmap_CreateFlat("ProcessID",
+                                              MAX_EXPECTED_PROCESSES,
+                                              ProcessIdHash,
+                                              ProcessIdEquals);
 
     // Get a reference to the Log Control Protocol identification.
     le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID,
@@ -2839,8 +3789,12 @@ COMPONENT_INIT
     // Create and advertise the log control service (the one the control tool uses).
     serviceRef = le_msg_CreateService(protocolRef, LOG_CONTROL_SERVICE_NAME);
     le_msg_SetServiceRecvHandler(serviceRef, ControlToolMsgReceiveHandler, NULL);
+    le_msg_AddServiceCloseHandler(serviceRef, ControlToolIpcSessionClosed, NULL);
     le_msg_AdvertiseService(serviceRef);
 
+    // Clients get the Persist Stream's levels when they register.
+    StartPersistStream();
+
     // Close the fd that we inherited from the Supervisor.  This will let the Supervisor know that
     // we are initialized.  Then re-open it to /dev/null so that it cannot be reused later.
     FILE* filePtr;
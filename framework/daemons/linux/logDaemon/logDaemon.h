@@ -31,6 +31,12 @@
  * session with the log control tool when it finishes processing the command.
  * Response strings that contain error messages always start with a "*".
  *
+ * A log tool can also stream log messages, in which case its IPC session stays open and the
+ * Log Control Daemon sends it one printable string per matching log message.  The Log Control
+ * Daemon tells the log clients the lowest level at which each of their components' messages
+ * matches a stream, and the clients only send it those messages, so the components nobody
+ * streams don't pay anything for it.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -88,12 +94,30 @@
 #define LOG_CMD_DISABLE_TRACE           'd' // CommandData = keyword string
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logging commands that can be sent from the log daemon to the components only.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_CMD_SET_LEVELS              'L' // No ComponentName.  CommandData = list of
+                                            // componentName=level entries separated by '/'
+#define LOG_CMD_SET_STREAM_LEVELS       'M' // No ProcessName or ComponentName.  CommandData =
+                                            // list of componentName=level entries separated by
+                                            // '/', where level may be LOG_STREAM_OFF_STR
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Logging commands that can be sent from the components to the log daemon only.
  */
 //--------------------------------------------------------------------------------------------------
 #define LOG_CMD_REG_COMPONENT           'r' // CommandData = string containing the process ID.
+#define LOG_CMD_REPORT_HOT_SITES        's' // No ProcessName or ComponentName.
+                                            // CommandData = printable list of the process's
+                                            // busiest rate-limited call sites, one per line
+#define LOG_CMD_STREAM_MSG              'm' // No ProcessName.  CommandData = one digit giving
+                                            // the message's le_log_Level_t, then the formatted
+                                            // message
 
 
 //--------------------------------------------------------------------------------------------------
@@ -103,6 +127,10 @@
 //--------------------------------------------------------------------------------------------------
 #define LOG_CMD_LIST_COMPONENTS         'c' // No ProcessName, ComponentName, or CommandData
 #define LOG_CMD_FORGET_PROCESS          'x' // No ComponentName or CommandData
+#define LOG_CMD_LIST_HOT_SITES          'h' // No ComponentName or CommandData
+                                            // (also sent to the components, without ProcessName)
+#define LOG_CMD_STREAM                  'S' // CommandData = level string, optionally followed
+                                            // by '/' and an extended regular expression
 
 
 // =======================================================
@@ -116,6 +144,9 @@
 #define LOG_SET_LEVEL_INFO_STR  "INFO"
 #define LOG_SET_LEVEL_DEBUG_STR "DEBUG"
 
+/// Stream level of a component whose messages aren't streamed (SET_STREAM_LEVELS commands only).
+#define LOG_STREAM_OFF_STR      "OFF"
+
 
 // =========================================================================
 //  LOG OUTPUT LOCATION NAMES (CommandData part of SET_OUTPUT_LOC commands)
@@ -0,0 +1,503 @@
+/** @file logPersist.c
+ *
+ * Implementation of the Log Control Daemon's persistent log storage.  See logPersist.h.
+ *
+ * The compression is done with zlib, which the daemon is only linked with when built with
+ * LEGATO_LOG_PERSIST=1.  Otherwise persistent log storage is not available.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "logPersist.h"
+#include "fileDescriptor.h"
+
+#ifdef LOG_PERSIST
+
+#include <zlib.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a block of messages, before compression.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BLOCK_BYTES             (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size a segment may grow to, compressed, before a new one is started.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SEGMENT_BYTES       (256 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of segments kept, the current one included.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SEGMENTS            8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time after which a partly filled block is written out, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLUSH_INTERVAL_MS       5000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Base 2 logarithm of the compression window size.  A small window keeps the compressor's memory
+ * use down, and log lines mostly repeat text from the lines just before them anyway.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WINDOW_BITS             12
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Messages waiting to be compressed.
+ */
+//--------------------------------------------------------------------------------------------------
+static char Block[BLOCK_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes used in the block.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t BlockUsed = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the first message in the block.
+ */
+//--------------------------------------------------------------------------------------------------
+static time_t BlockStartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compressed data buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t OutBuf[4096];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compressor state, reset for each block.
+ */
+//--------------------------------------------------------------------------------------------------
+static z_stream Deflater;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of the current segment, and of the oldest one that may still exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static unsigned int SegmentNum = 0;
+static unsigned int OldestSegmentNum = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Current segment and index files, or -1 if persistent log storage is not running.
+ */
+//--------------------------------------------------------------------------------------------------
+static int SegmentFd = -1;
+static int IndexFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes written to the current segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SegmentBytes = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer that writes out partly filled blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t FlushTimer;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the path of one of a segment's files.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    char* pathPtr,              ///< [OUT] Buffer for the path.
+    size_t pathSize,            ///< [IN] Size of the buffer.
+    unsigned int segmentNum,    ///< [IN] Segment number.
+    const char* extPtr          ///< [IN] "gz" or "idx".
+)
+{
+    LE_ASSERT(snprintf(pathPtr, pathSize, LOG_PERSIST_DIR "/%u.%s", segmentNum, extPtr)
+              < pathSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes the current segment, if any, and creates the next one.  Deletes the segments that are
+ * too old to be kept.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartSegment
+(
+    void
+)
+{
+    char path[PATH_MAX];
+
+    if (SegmentFd != -1)
+    {
+        fd_Close(SegmentFd);
+        fd_Close(IndexFd);
+        SegmentFd = -1;
+        IndexFd = -1;
+
+        SegmentNum++;
+    }
+
+    while (SegmentNum - OldestSegmentNum >= MAX_SEGMENTS)
+    {
+        GetSegmentPath(path, sizeof(path), OldestSegmentNum, "gz");
+        unlink(path);
+        GetSegmentPath(path, sizeof(path), OldestSegmentNum, "idx");
+        unlink(path);
+
+        OldestSegmentNum++;
+    }
+
+    GetSegmentPath(path, sizeof(path), SegmentNum, "gz");
+    SegmentFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (SegmentFd == -1)
+    {
+        LE_ERROR("Failed to create log segment '%s' (%m).", path);
+        return LE_FAULT;
+    }
+
+    GetSegmentPath(path, sizeof(path), SegmentNum, "idx");
+    IndexFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (IndexFd == -1)
+    {
+        LE_ERROR("Failed to create log segment index '%s' (%m).", path);
+        fd_Close(SegmentFd);
+        SegmentFd = -1;
+        return LE_FAULT;
+    }
+
+    SegmentBytes = 0;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compresses the block onto the end of the current segment and indexes it, then starts a new
+ * segment if the current one is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteBlock
+(
+    void
+)
+{
+    le_timer_Stop(FlushTimer);
+
+    if ((BlockUsed == 0) || (SegmentFd == -1))
+    {
+        BlockUsed = 0;
+        return;
+    }
+
+    size_t blockOffset = SegmentBytes;
+    int result;
+
+    Deflater.next_in = (Bytef*)Block;
+    Deflater.avail_in = BlockUsed;
+
+    do
+    {
+        Deflater.next_out = OutBuf;
+        Deflater.avail_out = sizeof(OutBuf);
+
+        result = deflate(&Deflater, Z_FINISH);
+        LE_ASSERT(result != Z_STREAM_ERROR);
+
+        size_t outBytes = sizeof(OutBuf) - Deflater.avail_out;
+        if (fd_WriteSize(SegmentFd, OutBuf, outBytes) != outBytes)
+        {
+            LE_ERROR("Failed to write log segment %u (%m).", SegmentNum);
+            break;
+        }
+        SegmentBytes += outBytes;
+    }
+    while (result != Z_STREAM_END);
+
+    LE_ASSERT(deflateReset(&Deflater) == Z_OK);
+    BlockUsed = 0;
+
+    char indexLine[48];
+    int len = snprintf(indexLine, sizeof(indexLine), "%ld %zu\n", (long)BlockStartTime, blockOffset);
+    if (fd_WriteSize(IndexFd, indexLine, len) != len)
+    {
+        LE_ERROR("Failed to write log segment index %u (%m).", SegmentNum);
+    }
+
+    if (SegmentBytes >= MAX_SEGMENT_BYTES)
+    {
+        StartSegment();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out the block when it has been partly filled for a while.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushTimerExpired
+(
+    le_timer_Ref_t timerRef
+)
+{
+    WriteBlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out everything at exit, such as when the Supervisor stops the framework.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushAtExit
+(
+    void
+)
+{
+    logPersist_Flush();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes persistent log storage and starts a new segment.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_IMPLEMENTED if the daemon was built without persistent log storage.
+ *      - LE_FAULT if the segment files can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logPersist_Init
+(
+    void
+)
+{
+    if (le_dir_MakePath(LOG_PERSIST_DIR, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Failed to create directory '%s'.", LOG_PERSIST_DIR);
+        return LE_FAULT;
+    }
+
+    // Carry on numbering from the newest segment left by earlier runs.
+    DIR* dirPtr = opendir(LOG_PERSIST_DIR);
+    if (dirPtr == NULL)
+    {
+        LE_ERROR("Failed to open directory '%s' (%m).", LOG_PERSIST_DIR);
+        return LE_FAULT;
+    }
+
+    bool isFound = false;
+    unsigned int newestNum = 0;
+    unsigned int oldestNum = 0;
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        unsigned int num;
+        char ext[4];
+
+        if (   (sscanf(entryPtr->d_name, "%u.%3s", &num, ext) == 2)
+            && (strcmp(ext, "gz") == 0) )
+        {
+            if (!isFound || (num > newestNum))
+            {
+                newestNum = num;
+            }
+            if (!isFound || (num < oldestNum))
+            {
+                oldestNum = num;
+            }
+            isFound = true;
+        }
+    }
+
+    closedir(dirPtr);
+
+    SegmentNum = isFound ? newestNum + 1 : 0;
+    OldestSegmentNum = isFound ? oldestNum : 0;
+
+    LE_ASSERT(deflateInit2(&Deflater,
+                           Z_DEFAULT_COMPRESSION,
+                           Z_DEFLATED,
+                           WINDOW_BITS + 16,    // + 16 = gzip format.
+                           MAX_MEM_LEVEL / 2,
+                           Z_DEFAULT_STRATEGY) == Z_OK);
+
+    FlushTimer = le_timer_Create("LogPersistFlush");
+    le_timer_SetMsInterval(FlushTimer, FLUSH_INTERVAL_MS);
+    le_timer_SetHandler(FlushTimer, FlushTimerExpired);
+
+    if (StartSegment() != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    atexit(FlushAtExit);
+
+    LE_INFO("Storing logs in '%s', starting with segment %u.", LOG_PERSIST_DIR, SegmentNum);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores a log message.  CRITICAL and EMERGENCY messages are written out to flash at once, with
+ * everything stored before them, since they often come just before a reboot.  Other messages are
+ * written out when their block is full or a few seconds after being stored.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Write
+(
+    le_log_Level_t level,       ///< [IN] Severity level of the message.
+    const char* msgPtr          ///< [IN] The message, without a trailing newline.
+)
+{
+    if (SegmentFd == -1)
+    {
+        return;
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    char prefix[32];
+    size_t prefixLen = snprintf(prefix, sizeof(prefix), "%ld.%06ld ",
+                                (long)now.tv_sec, (long)now.tv_usec);
+
+    // Messages longer than a block are truncated.
+    size_t msgLen = strnlen(msgPtr, BLOCK_BYTES - prefixLen - 1);
+
+    if (BlockUsed + prefixLen + msgLen + 1 > sizeof(Block))
+    {
+        WriteBlock();
+    }
+
+    if (BlockUsed == 0)
+    {
+        BlockStartTime = now.tv_sec;
+        le_timer_Start(FlushTimer);
+    }
+
+    memcpy(Block + BlockUsed, prefix, prefixLen);
+    memcpy(Block + BlockUsed + prefixLen, msgPtr, msgLen);
+    BlockUsed += prefixLen + msgLen;
+    Block[BlockUsed++] = '\n';
+
+    if (level >= LE_LOG_CRIT)
+    {
+        logPersist_Flush();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out the messages stored so far and flushes them to flash.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Flush
+(
+    void
+)
+{
+    WriteBlock();
+
+    if (SegmentFd != -1)
+    {
+        fdatasync(SegmentFd);
+        fdatasync(IndexFd);
+    }
+}
+
+
+#else // LOG_PERSIST
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes persistent log storage and starts a new segment.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_IMPLEMENTED if the daemon was built without persistent log storage.
+ *      - LE_FAULT if the segment files can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logPersist_Init
+(
+    void
+)
+{
+    return LE_NOT_IMPLEMENTED;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores a log message.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Write
+(
+    le_log_Level_t level,       ///< [IN] Severity level of the message.
+    const char* msgPtr          ///< [IN] The message, without a trailing newline.
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out the messages stored so far and flushes them to flash.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Flush
+(
+    void
+)
+{
+}
+
+
+#endif // LOG_PERSIST
@@ -0,0 +1,75 @@
+/** @file logPersist.h
+ *
+ * Persistent log storage of the Log Control Daemon.
+ *
+ * The log messages the daemon receives are appended to compressed, size-bounded segment files in
+ * @ref LOG_PERSIST_DIR, so that the log history survives faults and reboots without having to be
+ * dumped at the time of the fault.
+ *
+ * Messages are collected into blocks.  Each block is compressed into a gzip member of its own and
+ * appended to the current segment file, "<n>.gz", so a whole segment can be read with zcat.  For
+ * each block, a line "<seconds> <offset>\n" is appended to the segment's index file, "<n>.idx",
+ * giving the time (in seconds since the Epoch) of the block's first message and the offset of the
+ * block in the segment.  Reading from that offset, e.g. with "tail -c +<offset+1> <n>.gz | zcat",
+ * gives the messages logged since that time.  Each message is one line, prefixed with the time it
+ * was received at, as "<seconds>.<microseconds> ".
+ *
+ * A new segment is started each time the daemon starts and each time the current one is full, and
+ * the oldest segments are deleted to keep their number bounded.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LOG_PERSIST_INCLUDE_GUARD
+#define LEGATO_LOG_PERSIST_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory the log segments are stored in.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_PERSIST_DIR     "/legato/logs"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes persistent log storage and starts a new segment.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_IMPLEMENTED if the daemon was built without persistent log storage.
+ *      - LE_FAULT if the segment files can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logPersist_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores a log message.  CRITICAL and EMERGENCY messages are written out to flash at once, with
+ * everything stored before them, since they often come just before a reboot.  Other messages are
+ * written out when their block is full or a few seconds after being stored.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Write
+(
+    le_log_Level_t level,       ///< [IN] Severity level of the message.
+    const char* msgPtr          ///< [IN] The message, without a trailing newline.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out the messages stored so far and flushes them to flash.
+ */
+//--------------------------------------------------------------------------------------------------
+void logPersist_Flush
+(
+    void
+);
+
+
+#endif // LEGATO_LOG_PERSIST_INCLUDE_GUARD
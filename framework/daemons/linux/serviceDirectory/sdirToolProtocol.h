@@ -45,6 +45,26 @@ typedef enum
     LE_SDTP_MSGID_BIND,             ///< Create one binding.  The payload is the binding details.
                                     ///  If the Service Directory runs into an error, it will
                                     ///  drop the connection to the sdir tool without responding.
+
+    LE_SDTP_MSGID_BIND_ALL,         ///< Replace all bindings with a new set of bindings.  Payload is
+                                    ///  a file descriptor from which an array of
+                                    ///  le_sdtp_Binding_t records can be read, up to end-of-file.
+                                    ///  This is equivalent to an LE_SDTP_MSGID_UNBIND_ALL
+                                    ///  followed by one LE_SDTP_MSGID_BIND per record, but takes
+                                    ///  a single round trip.  If a record is invalid, the Service
+                                    ///  Directory will drop the connection to the sdir tool
+                                    ///  without responding.
+
+    LE_SDTP_MSGID_BIND_USER,        ///< Replace the bindings of one user's client interfaces,
+                                    ///  leaving the other users' bindings alone.  The user ID is
+                                    ///  in the client field, and the payload is a file descriptor
+                                    ///  like that of LE_SDTP_MSGID_BIND_ALL.  Each record's client
+                                    ///  or server must be that user, so records can also bind
+                                    ///  other users' client interfaces to the user's services.
+
+    LE_SDTP_MSGID_UNBIND_USER,      ///< Delete the bindings of one user's client interfaces and
+                                    ///  all bindings to that user's services.  The user ID is in
+                                    ///  the client field.
 }
 le_sdtp_MsgType_t;
 
@@ -65,4 +85,20 @@ typedef struct
 le_sdtp_Msg_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binding record, as read from the file descriptor passed in an LE_SDTP_MSGID_BIND_ALL or
+ * LE_SDTP_MSGID_BIND_USER message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uid_t client;               ///< Unix user ID of the client.
+    uid_t server;               ///< Unix user ID of the server.
+    char clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Client's interface name.
+    char serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Server's interface name.
+}
+le_sdtp_Binding_t;
+
+
 #endif // SDIR_TOOL_PROTOCOL_H_INCLUDE_GUARD
@@ -87,7 +87,9 @@ User List ------> User --+---> Name               |        |        |
  * connections to servers.  Client Connections keep track of connections to clients.
  *
  * Client Connection objects and Server Connection objects are created when clients and servers
- * connect to the Service Directory.
+ * connect to the Service Directory.  Connections are accepted in batches each time a listening
+ * socket becomes readable, so a mass reconnect (e.g., after a framework daemon restarts) doesn't
+ * cost an event loop iteration per connection.
  *
  * Client Connection objects are deleted when the client disconnects or its connection is passed
  * to a server.
@@ -114,10 +116,14 @@ User List ------> User --+---> Name               |        |        |
  * object is not found for that service name on that User, the new one is is added to the list.
  * Otherwise, the new server connection is dropped.
  *
- * When a new Server Connection is added to a Service List, all users' Binding Lists are
- * searched for matching bindings, and if any that match have non-empty Waiting Clients Lists,
- * all those Client Connections are removed from those lists and dispatched to the new Server
- * Connection.
+ * When a new Server Connection is added to a Service List, the bindings that refer to that
+ * service are checked, and if any have non-empty Waiting Clients Lists, all those Client
+ * Connections are removed from those lists and dispatched to the new Server Connection.
+ *
+ * So that none of these searches have to walk lists, Users are indexed by UID in the User Map,
+ * Server Connections by (server User, service name) in the Service Map, and Bindings both by
+ * (client User, client interface name) in the Binding Map and by (server User, service name) in
+ * the Binding Target Map.  The lists are still kept for listing the contents in order.
  *
  * When a Binding is added, it is added to the client's User object's Binding List.  That user's
  * Unbound Clients List will then be checked for matches to the new binding, and if any are found,
@@ -206,18 +212,50 @@ User List ------> User --+---> Name               |        |        |
 #include "fileDescriptor.h"
 #include "limit.h"
 #include "user.h"
+#include "bootTrace.h"
 
 // =======================================
 //  PRIVATE DATA
 // =======================================
 
+//--------------------------------------------------------------------------------------------------
+/// Expected number of entries in each of the lookup maps (users, services, and bindings).
+//--------------------------------------------------------------------------------------------------
+#define LOOKUP_MAP_SIZE 127
+
+
 //--------------------------------------------------------------------------------------------------
 /// The maximum number of backlogged connection requests that will be queued up for either the
 /// Client Socket or the Server Socket.  If the Service Directory gets this far behind in accepting
 /// connections, then the next client or server that attempts to connect will get a failure
-/// indication from the OS.
+/// indication from the OS.  When a framework daemon restarts, all its clients reconnect at once,
+/// so this is sized for a few hundred processes (the kernel may cap it at net.core.somaxconn).
+//--------------------------------------------------------------------------------------------------
+#define MAX_CONNECT_REQUEST_BACKLOG 512
+
+
+//--------------------------------------------------------------------------------------------------
+/// The maximum number of connections accepted from the Client Socket or the Server Socket each time
+/// it is reported readable.  Accepting a batch per event saves a trip through the event loop per
+/// connection when many processes connect at once, while the limit keeps a burst of connections
+/// from starving the connections already accepted.
+//--------------------------------------------------------------------------------------------------
+#define MAX_ACCEPTS_PER_EVENT 32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to look up an interface belonging to a user, i.e., a service in the Service Map, a
+ * binding in the Binding Map, or a binding target in the Binding Target Map.  It points into the
+ * object it indexes, so it lives exactly as long as that object.
+ */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CONNECT_REQUEST_BACKLOG 100
+typedef struct
+{
+    const struct User* userPtr;         ///< User that the interface belongs to.
+    const char*        interfaceName;   ///< Interface name.
+}
+InterfaceKey_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -226,7 +264,7 @@ User List ------> User --+---> Name               |        |        |
  * User List.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct User
 {
     le_dls_Link_t   link;               ///< Used to link into the User List.
     uid_t           uid;                ///< Unique Unix user ID.
@@ -250,6 +288,12 @@ static le_mem_PoolRef_t UserPoolRef;
 static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/// The User Map, which indexes User objects by UID.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t UserMapRef;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -260,6 +304,7 @@ static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 typedef struct
 {
     le_dls_Link_t               link;           ///< Used to link onto user's Service List.
+    InterfaceKey_t              key;            ///< Key in the Service Map (once advertised).
     int                         fd;             ///< Fd of the connection socket.
     le_fdMonitor_Ref_t          fdMonitorRef;   ///< FD Monitor object monitoring this connection.
     User_t*                     userPtr;        ///< Pointer to the User object for the client uid.
@@ -275,6 +320,41 @@ ServerConnection_t;
 static le_mem_PoolRef_t ServerConnectionPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/// The Service Map, which indexes the Server Connections on all Users' Service Lists by
+/// (server User, service name).
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ServiceMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Collects the Binding objects that refer to the same (server User, service name).  Objects of
+ * this type are allocated from the Binding Target Pool and kept in the Binding Target Map, and
+ * exist only while at least one Binding refers to them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    InterfaceKey_t  key;                ///< Key in the Binding Target Map.
+    char            serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Service name
+    le_dls_List_t   bindingList;        ///< List of Bindings that refer to this service.
+}
+BindingTarget_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Pool from which Binding Target objects are allocated.
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BindingTargetPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/// The Binding Target Map, which indexes Binding Target objects by (server User, service name).
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BindingTargetMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a binding from a user's client interface to a service.  Objects of this type are
@@ -284,6 +364,9 @@ static le_mem_PoolRef_t ServerConnectionPoolRef;
 typedef struct
 {
     le_dls_Link_t       link;               ///< Used to link into the User's Binding List.
+    le_dls_Link_t       targetLink;         ///< Used to link into the Binding Target's list.
+    InterfaceKey_t      key;                ///< Key in the Binding Map.
+    BindingTarget_t*    targetPtr;          ///< Ptr to the Binding Target whose list I'm in.
     User_t*             clientUserPtr;      ///< Ptr to the client User whose Binding List I'm in.
     User_t*             serverUserPtr;      ///< Ptr to the User who serves the service.
     char                clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Client I/F name
@@ -300,6 +383,13 @@ Binding_t;
 static le_mem_PoolRef_t BindingPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/// The Binding Map, which indexes the Bindings on all Users' Binding Lists by
+/// (client User, client interface name).
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BindingMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumeration of the different states that a client connection can be in.
@@ -329,7 +419,10 @@ typedef struct
     User_t*                 userPtr;        ///< Pointer to the User object for the client uid.
     pid_t                   pid;            ///< Process ID of client process.
     svcdir_InterfaceDetails_t interface;    ///< Interface details (protocol & interface name)
+    bool                    isConnector;    ///< true = client asked for a connector, not a session.
     Binding_t*              bindingPtr;     ///< Ptr to Binding whose Waiting Clients List we are on
+    bool                    isWaiting;      ///< true = client is blocked waiting for the service.
+    le_clk_Time_t           waitStartTime;  ///< When the client started waiting for the service.
 }
 ClientConnection_t;
 
@@ -369,6 +462,48 @@ static le_fdMonitor_Ref_t ServerSocketMonitorRef;
 //  FUNCTIONS
 // =======================================
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for Interface Keys.
+ *
+ * @return The hash value.
+ **/
+//--------------------------------------------------------------------------------------------------
+static size_t HashInterfaceKey
+(
+    const void* keyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* interfaceKeyPtr = keyPtr;
+
+    return le_hashmap_HashString(interfaceKeyPtr->interfaceName)
+           ^ le_hashmap_HashVoidPointer(interfaceKeyPtr->userPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for Interface Keys.
+ *
+ * @return true if the keys refer to the same interface of the same user.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool EqualsInterfaceKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* firstPtr = firstKeyPtr;
+    const InterfaceKey_t* secondPtr = secondKeyPtr;
+
+    return (   (firstPtr->userPtr == secondPtr->userPtr)
+            && (strcmp(firstPtr->interfaceName, secondPtr->interfaceName) == 0) );
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -399,8 +534,9 @@ static User_t* CreateUser
     userPtr->serviceList = LE_DLS_LIST_INIT;
     userPtr->unboundClientsList = LE_DLS_LIST_INIT;
 
-    // Add it to the User List.
+    // Add it to the User List and the User Map.
     le_dls_Queue(&UserList, &userPtr->link);
+    le_hashmap_Put(UserMapRef, &userPtr->uid, userPtr);
 
     return userPtr;
 }
@@ -408,7 +544,7 @@ static User_t* CreateUser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches the User List for a particular Unix user ID.  If found, increments the reference count
+ * Looks up a particular Unix user ID in the User Map.  If found, increments the reference count
  * on that object.  If not found, creates a new User object.
  *
  * @return Pointer to the User object.
@@ -420,19 +556,12 @@ static User_t* GetUser
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&UserList);
+    User_t* userPtr = le_hashmap_Get(UserMapRef, &uid);
 
-    while (linkPtr != NULL)
+    if (userPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(linkPtr, User_t, link);
-
-        if (userPtr->uid == uid)
-        {
-            le_mem_AddRef(userPtr);
-            return userPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&UserList, linkPtr);
+        le_mem_AddRef(userPtr);
+        return userPtr;
     }
 
     return CreateUser(uid);
@@ -453,14 +582,15 @@ static void UserDestructor
 {
     User_t* userPtr = objPtr;
 
-    // Remove the User object from the User List.
+    // Remove the User object from the User List and the User Map.
     le_dls_Remove(&UserList, &userPtr->link);
+    le_hashmap_Remove(UserMapRef, &userPtr->uid);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a (client) User's Binding List for a particular client-side interface name.
+ * Looks up a (client) User's binding for a particular client-side interface name.
  *
  * @return Pointer to the Binding object or NULL if not found.
  **/
@@ -472,21 +602,9 @@ static Binding_t* FindBinding
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->bindingList);
-
-    while (linkPtr != NULL)
-    {
-        Binding_t* bindingPtr = CONTAINER_OF(linkPtr, Binding_t, link);
-
-        if (strcmp(bindingPtr->clientInterfaceName, interfaceName) == 0)
-        {
-            return bindingPtr;
-        }
+    InterfaceKey_t key = { .userPtr = userPtr, .interfaceName = interfaceName };
 
-        linkPtr = le_dls_PeekNext(&userPtr->bindingList, linkPtr);
-    }
-
-    return NULL;
+    return le_hashmap_Get(BindingMapRef, &key);
 }
 
 
@@ -597,7 +715,7 @@ static le_result_t ReceiveMessage
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a User's Service List for a particular service name.
+ * Looks up a particular service name among the services served up by a User.
  *
  * @return Pointer to the Server Connection object for the matching service.
  **/
@@ -609,21 +727,67 @@ static ServerConnection_t* FindService
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->serviceList);
+    InterfaceKey_t key = { .userPtr = userPtr, .interfaceName = serviceName };
 
-    while (linkPtr != NULL)
+    return le_hashmap_Get(ServiceMapRef, &key);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Binding Target for a given service, creating it if it doesn't exist yet.
+ *
+ * @return Pointer to the Binding Target object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static BindingTarget_t* GetBindingTarget
+(
+    const User_t* serverUserPtr,    ///< [in] Ptr to the User object of the server.
+    const char* serviceName         ///< [in] Service name string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    InterfaceKey_t key = { .userPtr = serverUserPtr, .interfaceName = serviceName };
+
+    BindingTarget_t* targetPtr = le_hashmap_Get(BindingTargetMapRef, &key);
+
+    if (targetPtr == NULL)
     {
-        ServerConnection_t* serverConnectionPtr = CONTAINER_OF(linkPtr, ServerConnection_t, link);
+        targetPtr = le_mem_ForceAlloc(BindingTargetPoolRef);
 
-        if (strcmp(serverConnectionPtr->interface.interfaceName, serviceName) == 0)
-        {
-            return serverConnectionPtr;
-        }
+        // Note: we know the interface name is a valid length.
+        le_utf8_Copy(targetPtr->serverInterfaceName,
+                     serviceName,
+                     sizeof(targetPtr->serverInterfaceName),
+                     NULL);
+        targetPtr->key.userPtr = serverUserPtr;
+        targetPtr->key.interfaceName = targetPtr->serverInterfaceName;
+        targetPtr->bindingList = LE_DLS_LIST_INIT;
 
-        linkPtr = le_dls_PeekNext(&userPtr->serviceList, linkPtr);
+        le_hashmap_Put(BindingTargetMapRef, &targetPtr->key, targetPtr);
     }
 
-    return NULL;
+    return targetPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the Binding Target for a given service.
+ *
+ * @return Pointer to the Binding Target object, or NULL if no Binding refers to the service.
+ **/
+//--------------------------------------------------------------------------------------------------
+static BindingTarget_t* FindBindingTarget
+(
+    const User_t* serverUserPtr,    ///< [in] Ptr to the User object of the server.
+    const char* serviceName         ///< [in] Service name string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    InterfaceKey_t key = { .userPtr = serverUserPtr, .interfaceName = serviceName };
+
+    return le_hashmap_Get(BindingTargetMapRef, &key);
 }
 
 
@@ -738,20 +902,41 @@ static le_result_t DispatchToServer
 
     else
     {
-        // Send the client connection fd to the server.
+        // Send the client connection fd to the server, telling it what the connection is for.
+        svcdir_ConnectionType_t connectionType = clientConnectionPtr->isConnector ?
+                                                                    SVCDIR_CONNECTION_CONNECTOR :
+                                                                    SVCDIR_CONNECTION_SESSION;
         le_result_t result = unixSocket_SendMsg(serverConnectionPtr->fd,
-                                                NULL,   // dataPtr
-                                                0,      // dataSize
+                                                &connectionType,
+                                                sizeof(connectionType),
                                                 clientConnectionPtr->fd, // fdToSend
                                                 false); // sendCredentials
 
         if (result == LE_OK)
         {
-            LE_DEBUG("Client (uid %u '%s', pid %d) connected to server (uid %u '%s', pid %d) for "
-                        "service '%s' (protocol ID = '%s').",
+            // Record how long the client was blocked, waiting for the service to be advertised.
+            if (clientConnectionPtr->isWaiting)
+            {
+                char name[LIMIT_MAX_USER_NAME_BYTES + LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];
+
+                snprintf(name,
+                         sizeof(name),
+                         "%s.%s",
+                         clientConnectionPtr->userPtr->name,
+                         clientConnectionPtr->interface.interfaceName);
+
+                bootTrace_Record(clientConnectionPtr->pid,
+                                 "bindingWait",
+                                 name,
+                                 clientConnectionPtr->waitStartTime);
+            }
+
+            LE_DEBUG("Client (uid %u '%s', pid %d) connected %s to server (uid %u '%s', pid %d) "
+                        "for service '%s' (protocol ID = '%s').",
                      clientConnectionPtr->userPtr->uid,
                      clientConnectionPtr->userPtr->name,
                      clientConnectionPtr->pid,
+                     clientConnectionPtr->isConnector ? "connector" : "session",
                      serverConnectionPtr->userPtr->uid,
                      serverConnectionPtr->userPtr->name,
                      serverConnectionPtr->pid,
@@ -812,6 +997,12 @@ static void FollowBinding
     // client connection how it is (in the WAITING state).
     else if (shouldWait)
     {
+        if (clientConnectionPtr->isWaiting == false)
+        {
+            clientConnectionPtr->isWaiting = true;
+            clientConnectionPtr->waitStartTime = le_clk_GetRelativeTime();
+        }
+
         LE_DEBUG("Client user %s (uid %u) pid %d interface '%s' is waiting for"
                     " server user %s (%u) to advertise service '%s'.",
                  clientConnectionPtr->userPtr->name,
@@ -917,8 +1108,16 @@ static void CreateBinding
     bindingPtr->serverConnectionPtr = NULL;
     bindingPtr->waitingClientsList = LE_DLS_LIST_INIT;
 
-    // Add the Binding to the client User's Binding List.
+    // Add the Binding to the client User's Binding List and to the Binding Map.
     le_dls_Queue(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    bindingPtr->key.userPtr = clientUserPtr;
+    bindingPtr->key.interfaceName = bindingPtr->clientInterfaceName;
+    le_hashmap_Put(BindingMapRef, &bindingPtr->key, bindingPtr);
+
+    // Add the Binding to the list of bindings that refer to its destination service.
+    bindingPtr->targetLink = LE_DLS_LINK_INIT;
+    bindingPtr->targetPtr = GetBindingTarget(serverUserPtr, serverInterfaceName);
+    le_dls_Queue(&bindingPtr->targetPtr->bindingList, &bindingPtr->targetLink);
 
     // Look for a server serving the binding's destination service.
     bindingPtr->serverConnectionPtr = FindService(bindingPtr->serverUserPtr, serverInterfaceName);
@@ -1001,51 +1200,42 @@ static void ResolveBindingsToServer
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+    BindingTarget_t* targetPtr = FindBindingTarget(connectionPtr->userPtr,
+                                                   connectionPtr->interface.interfaceName);
+    if (targetPtr == NULL)
+    {
+        return;
+    }
 
-    while (userLinkPtr != NULL)
+    // For each of the bindings pointing at the new server's service,
+    le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&targetPtr->bindingList);
+    while (bindingLinkPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+        Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, targetLink);
 
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
-        {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+        bindingPtr->serverConnectionPtr = connectionPtr;
 
-            // If the binding is pointing at the new server's service,
-            if (   (connectionPtr->userPtr == bindingPtr->serverUserPtr)
-                && (0 == strcmp(connectionPtr->interface.interfaceName,
-                                bindingPtr->serverInterfaceName))  )
+        // While there's still a client connection on the Waiting Clients List, get
+        // a pointer to the first one, without removing it from the list, then try
+        // to dispatch that client to the server.
+        le_dls_Link_t* clientLinkPtr;
+        while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
+        {
+            ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                   ClientConnection_t,
+                                                                   link);
+            if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
             {
-                bindingPtr->serverConnectionPtr = connectionPtr;
-
-                // While there's still a client connection on the Waiting Clients List, get
-                // a pointer to the first one, without removing it from the list, then try
-                // to dispatch that client to the server.
-                le_dls_Link_t* clientLinkPtr;
-                while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
-                {
-                    ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                                           ClientConnection_t,
-                                                                           link);
-                    if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
-                    {
-                        // Server went down.  Client was left on the Waiting Clients List.
-                        // Server Connection destructor was run and it disconnected itself
-                        // from the Binding object.
-                        return;
-                    }
-                    // NOTE: If the server didn't go down, then the Client Connection has been
-                    // deleted and its destructor removed it from the Waiting Clients List.
-                }
+                // Server went down.  Client was left on the Waiting Clients List.
+                // Server Connection destructor was run and it disconnected itself
+                // from the Binding object.
+                return;
             }
-
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+            // NOTE: If the server didn't go down, then the Client Connection has been
+            // deleted and its destructor removed it from the Waiting Clients List.
         }
 
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+        bindingLinkPtr = le_dls_PeekNext(&targetPtr->bindingList, bindingLinkPtr);
     }
 }
 
@@ -1079,8 +1269,11 @@ static void ProcessAdvertisementFromServer
     // connection to the service list.
     else
     {
-        // Add the object to the User's Service List.
+        // Add the object to the User's Service List and to the Service Map.
         le_dls_Queue(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+        connectionPtr->key.userPtr = connectionPtr->userPtr;
+        connectionPtr->key.interfaceName = connectionPtr->interface.interfaceName;
+        le_hashmap_Put(ServiceMapRef, &connectionPtr->key, connectionPtr);
 
         LE_DEBUG("Server (uid %u '%s', pid %d) now serving service '%s' (%s).",
                  connectionPtr->userPtr->uid,
@@ -1250,7 +1443,10 @@ static void ClientReadHandler
         memcpy(&(clientConnectionPtr->interface),
                &(msg.interface),
                sizeof(clientConnectionPtr->interface));
-        ProcessOpenRequestFromClient(clientConnectionPtr, msg.shouldWait);
+        clientConnectionPtr->isConnector = msg.isConnector;
+
+        // Connectors are only worth having if the service can be reached right now.
+        ProcessOpenRequestFromClient(clientConnectionPtr, msg.shouldWait && !msg.isConnector);
     }
     // If an error occurred on the receive,
     else
@@ -1319,7 +1515,9 @@ static void CreateClientConnection
     connectionPtr->fd = fd;
     connectionPtr->userPtr = GetUser(uid);
     connectionPtr->pid = pid;
+    connectionPtr->isConnector = false;
     connectionPtr->bindingPtr = NULL;
+    connectionPtr->isWaiting = false;
 
     // Haven't received ID yet, so clear it out.
     memset(&connectionPtr->interface, 0, sizeof(connectionPtr->interface));
@@ -1389,63 +1587,6 @@ static void ClientConnectionDestructor
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Handler function that gets called when a client connects to the Client socket.
- */
-//--------------------------------------------------------------------------------------------------
-static void ClientConnectHandler
-(
-    int fd,     ///< [in] File descriptor of the socket that has received a connection request.
-    short events    ///< [in] Event set (bit map).  Should be only POLLIN.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    if (events & ~POLLIN)
-    {
-        LE_CRIT("Unexpected fd event(s): 0x%hX", events);
-    }
-
-    // Accept the connection, setting the connection to be non-blocking.
-    fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK);
-
-    if (fd < 0)
-    {
-        LE_CRIT("Failed to accept client connection. Errno %d (%m).", errno);
-    }
-    else
-    {
-        struct ucred credentials;
-
-        socklen_t credentialsSize = sizeof(credentials);
-
-        // Get the remote process's credentials.
-        if (0 != getsockopt(fd,
-                            SOL_SOCKET,
-                            SO_PEERCRED,
-                            &credentials,
-                            &credentialsSize) )
-        {
-            LE_ERROR("Failed to obtain credentials from client.  Errno = %d (%m)", errno);
-            fd_Close(fd);
-        }
-        else
-        {
-            LE_DEBUG("Client connected:  pid = %d;  uid = %d;  gid = %d.",
-                     credentials.pid,
-                     credentials.uid,
-                     credentials.gid);
-
-            // Create a Connection object to use to track this connection.
-            CreateClientConnection(fd, credentials.uid, credentials.pid);
-
-            // Now we wait for the client to send us the session details (or disconnect).
-            // When that happens, our client fd event handler functions will be called.
-        }
-    }
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function that gets called when a connection to a server experiences an error.
@@ -1641,20 +1782,16 @@ static void ServerConnectionDestructor
 {
     ServerConnection_t* connectionPtr = objPtr;
 
-    // Disassociate the Server Connection object from all Binding objects that refer to it...
-
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
-
-    while (userLinkPtr != NULL)
+    // Disassociate the Server Connection object from all Binding objects that refer to it.
+    // Only bindings that refer to its service can be associated with it.
+    BindingTarget_t* targetPtr = FindBindingTarget(connectionPtr->userPtr,
+                                                   connectionPtr->interface.interfaceName);
+    if (targetPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
-
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
+        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&targetPtr->bindingList);
         while (bindingLinkPtr != NULL)
         {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, targetLink);
 
             // If the binding is associated with the deleted server connection,
             if (connectionPtr == bindingPtr->serverConnectionPtr)
@@ -1662,10 +1799,8 @@ static void ServerConnectionDestructor
                 bindingPtr->serverConnectionPtr = NULL;
             }
 
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+            bindingLinkPtr = le_dls_PeekNext(&targetPtr->bindingList, bindingLinkPtr);
         }
-
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
     }
 
     if (connectionPtr->interface.interfaceName[0] == '\0')
@@ -1690,6 +1825,7 @@ static void ServerConnectionDestructor
         if (le_dls_IsInList(&connectionPtr->userPtr->serviceList, &connectionPtr->link))
         {
             le_dls_Remove(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+            le_hashmap_Remove(ServiceMapRef, &connectionPtr->key);
         }
     }
 
@@ -1712,30 +1848,40 @@ static void ServerConnectionDestructor
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handler function that gets called when a server connects to the Server socket.
+ * Accepts the connections waiting on the Client Socket or the Server Socket, up to
+ * MAX_ACCEPTS_PER_EVENT of them, and creates a Client or Server Connection object for each.
  */
 //--------------------------------------------------------------------------------------------------
-static void ServerConnectHandler
+static void AcceptConnections
 (
-    int fd,     ///< [in] File descriptor of the socket that has received a connection request.
-    short events    ///< [in] Event set (bit map).  Should be only POLLIN.
+    int listenFd,       ///< [in] File descriptor of the (non-blocking) listening socket.
+    bool isServer       ///< [in] true = Server Socket, false = Client Socket.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (events & ~POLLIN)
+    const char* peerType = isServer ? "server" : "client";
+    int i;
+
+    for (i = 0; i < MAX_ACCEPTS_PER_EVENT; i++)
     {
-        LE_CRIT("Unexpected fd event(s): 0x%hX", events);
-    }
+        // Accept the connection, setting the connection to be non-blocking.
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
 
-    // Accept the connection, setting the connection to be non-blocking.
-    fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0)
+        {
+            if ((errno == EINTR) || (errno == ECONNABORTED))
+            {
+                continue;
+            }
+
+            // No more connections waiting.
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                LE_CRIT("Failed to accept %s connection. Errno %d (%m).", peerType, errno);
+            }
+            return;
+        }
 
-    if (fd < 0)
-    {
-        LE_CRIT("Failed to accept server connection. Errno %d (%m).", errno);
-    }
-    else
-    {
         struct ucred credentials;
         socklen_t credentialsSize = sizeof(credentials);
 
@@ -1746,23 +1892,74 @@ static void ServerConnectHandler
                             &credentials,
                             &credentialsSize) )
         {
-            LE_ERROR("Failed to obtain credentials from server.  Errno = %d (%m)", errno);
+            LE_ERROR("Failed to obtain credentials from %s.  Errno = %d (%m)", peerType, errno);
             fd_Close(fd);
+            continue;
+        }
+
+        LE_DEBUG("%s connected:  pid = %d;  uid = %u;  gid = %u.",
+                 isServer ? "Server" : "Client",
+                 credentials.pid,
+                 credentials.uid,
+                 credentials.gid);
+
+        // Create a Connection object to use to track this connection.
+        // Now we wait for the process to send us the session details (or disconnect).
+        // When that happens, our fd event handler functions will be called.
+        if (isServer)
+        {
+            CreateServerConnection(fd, credentials.uid, credentials.pid);
         }
         else
         {
-            LE_DEBUG("Server connected:  pid = %d;  uid = %u;  gid = %u.",
-                     credentials.pid,
-                     credentials.uid,
-                     credentials.gid);
+            CreateClientConnection(fd, credentials.uid, credentials.pid);
+        }
+    }
 
-            // Create a Connection object to use to track this connection.
-            CreateServerConnection(fd, credentials.uid, credentials.pid);
+    // More connections may be waiting.  The socket is still readable, so this handler will be
+    // called again once the events already pending have been handled.
+}
 
-            // Now we wait for the server to send us the session details (or disconnect).
-            // When that happens, our server fd event handler functions will be called.
-        }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function that gets called when clients connect to the Client socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClientConnectHandler
+(
+    int fd,     ///< [in] File descriptor of the socket that has received a connection request.
+    short events    ///< [in] Event set (bit map).  Should be only POLLIN.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (events & ~POLLIN)
+    {
+        LE_CRIT("Unexpected fd event(s): 0x%hX", events);
     }
+
+    AcceptConnections(fd, false /* isServer */);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function that gets called when servers connect to the Server socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerConnectHandler
+(
+    int fd,     ///< [in] File descriptor of the socket that has received a connection request.
+    short events    ///< [in] Event set (bit map).  Should be only POLLIN.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (events & ~POLLIN)
+    {
+        LE_CRIT("Unexpected fd event(s): 0x%hX", events);
+    }
+
+    AcceptConnections(fd, true /* isServer */);
 }
 
 
@@ -1780,8 +1977,19 @@ static void BindingDestructor
 {
     Binding_t* bindingPtr = objPtr;
 
-    // Remove the Binding object from the User's Binding List.
+    // Remove the Binding object from the User's Binding List and the Binding Map.
     le_dls_Remove(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    le_hashmap_Remove(BindingMapRef, &bindingPtr->key);
+
+    // Remove it from its Binding Target's list, and delete the Binding Target if nothing else
+    // refers to the service.
+    le_dls_Remove(&bindingPtr->targetPtr->bindingList, &bindingPtr->targetLink);
+    if (le_dls_IsEmpty(&bindingPtr->targetPtr->bindingList))
+    {
+        le_hashmap_Remove(BindingTargetMapRef, &bindingPtr->targetPtr->key);
+        le_mem_Release(bindingPtr->targetPtr);
+    }
+    bindingPtr->targetPtr = NULL;
 
     // While the list of waiting clients is not empty, pop one off and process it.
     le_dls_Link_t* linkPtr;
@@ -2443,43 +2651,282 @@ static void SdirToolUnbindAll
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handles a "Bind" request from the 'sdir' tool.
+ * Validates a binding received from the 'sdir' tool and creates it.  If the binding is invalid,
+ * the connection to the 'sdir' tool is dropped.
+ *
+ * @return true if the binding was created, false if it was invalid.
  */
 //--------------------------------------------------------------------------------------------------
-static void SdirToolBind
+static bool SdirToolCreateBinding
 (
-    const le_sdtp_Msg_t* msgPtr   ///< [in] Pointer to the request message payload.
+    uid_t client,                       ///< [in] Client's user ID.
+    const char* clientInterfaceName,    ///< [in] Client's interface name (may be unterminated).
+    uid_t server,                       ///< [in] Server's user ID.
+    const char* serverInterfaceName     ///< [in] Server's interface name (may be unterminated).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    size_t len = strnlen(msgPtr->clientInterfaceName, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
+    size_t len = strnlen(clientInterfaceName, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
     if (len == 0)
     {
         LE_KILL_CLIENT("Client interface name empty.");
+        return false;
     }
     else if (len == LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
     {
         LE_KILL_CLIENT("Client interface name not null terminated!");
+        return false;
     }
-    else
+
+    len = strnlen(serverInterfaceName, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
+    if (len == 0)
+    {
+        LE_KILL_CLIENT("Server interface name empty.");
+        return false;
+    }
+    else if (len == LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+    {
+        LE_KILL_CLIENT("Server interface name not null terminated!");
+        return false;
+    }
+
+    CreateBinding(client, clientInterfaceName, server, serverInterfaceName);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a "Bind" request from the 'sdir' tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolBind
+(
+    const le_sdtp_Msg_t* msgPtr   ///< [in] Pointer to the request message payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SdirToolCreateBinding(msgPtr->client,
+                          msgPtr->clientInterfaceName,
+                          msgPtr->server,
+                          msgPtr->serverInterfaceName);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the bindings of one user's client interfaces and, optionally, the bindings of other
+ * users' client interfaces to that user's services.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnbindUser
+(
+    uid_t uid,              ///< [in] The user ID.
+    bool includeServices    ///< [in] true = also delete the bindings to the user's services.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    User_t* userPtr = le_hashmap_Get(UserMapRef, &uid);
+
+    if (userPtr == NULL)
+    {
+        // No binding refers to this user.
+        return;
+    }
+
+    // Make sure the User object doesn't go away while its bindings are deleted.
+    le_mem_AddRef(userPtr);
+
+    le_dls_Link_t* bindingLinkPtr;
+
+    while ((bindingLinkPtr = le_dls_Peek(&userPtr->bindingList)) != NULL)
     {
-        len = strnlen(msgPtr->serverInterfaceName, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
-        if (len == 0)
+        // The destructor will remove it from the User's Binding List, etc.
+        le_mem_Release(CONTAINER_OF(bindingLinkPtr, Binding_t, link));
+    }
+
+    if (includeServices)
+    {
+        le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+
+        while (userLinkPtr != NULL)
         {
-            LE_KILL_CLIENT("Server interface name empty.");
+            User_t* clientUserPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+            le_mem_AddRef(clientUserPtr);
+
+            bindingLinkPtr = le_dls_Peek(&clientUserPtr->bindingList);
+
+            while (bindingLinkPtr != NULL)
+            {
+                Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+
+                // Move on now, in case the binding gets deleted.
+                bindingLinkPtr = le_dls_PeekNext(&clientUserPtr->bindingList, bindingLinkPtr);
+
+                if (bindingPtr->serverUserPtr == userPtr)
+                {
+                    le_mem_Release(bindingPtr);
+                }
+            }
+
+            userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+
+            le_mem_Release(clientUserPtr);
+        }
+    }
+
+    le_mem_Release(userPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the bindings read from a file descriptor received from the 'sdir' tool, then closes it.
+ * If a record is invalid, the connection to the 'sdir' tool is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolLoadBindings
+(
+    int fd,                 ///< [in] The file descriptor to read the binding records from.
+    const uid_t* uidPtr     ///< [in] If not NULL, the user each record's client or server must be.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Read the records a batch at a time to keep the number of system calls down.
+    le_sdtp_Binding_t records[32];
+    size_t count = 0;
+
+    for (;;)
+    {
+        ssize_t bytesRead = fd_ReadSize(fd, records, sizeof(records));
+
+        if (bytesRead < 0)
+        {
+            LE_KILL_CLIENT("Failed to read bindings after %zu records.", count);
+            break;
         }
-        else if (len == LIMIT_MAX_IPC_INTERFACE_NAME_BYTES)
+        if ((bytesRead % sizeof(records[0])) != 0)
         {
-            LE_KILL_CLIENT("Server interface name not null terminated!");
+            LE_KILL_CLIENT("Truncated binding record after %zu records.",
+                           count + (bytesRead / sizeof(records[0])));
+            break;
         }
-        else
+
+        size_t recordCount = bytesRead / sizeof(records[0]);
+        size_t j;
+
+        for (j = 0; j < recordCount; j++)
         {
-            CreateBinding(msgPtr->client,
-                          msgPtr->clientInterfaceName,
-                          msgPtr->server,
-                          msgPtr->serverInterfaceName);
+            if (   (uidPtr != NULL)
+                && (records[j].client != *uidPtr)
+                && (records[j].server != *uidPtr) )
+            {
+                LE_KILL_CLIENT("Binding record %zu doesn't involve user %u.", count + j, *uidPtr);
+                break;
+            }
+
+            if (!SdirToolCreateBinding(records[j].client,
+                                       records[j].clientInterfaceName,
+                                       records[j].server,
+                                       records[j].serverInterfaceName))
+            {
+                break;
+            }
         }
+        count += j;
+
+        // A short read means end-of-file was reached.
+        if ((j < recordCount) || (recordCount < NUM_ARRAY_MEMBERS(records)))
+        {
+            break;
+        }
+    }
+
+    LE_DEBUG("Loaded %zu bindings.", count);
+
+    fd_Close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a "Bind All" request from the 'sdir' tool.  Deletes all existing bindings and then
+ * creates the bindings read from a file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolBindAll
+(
+    int fd      ///< [in] The file descriptor to read the binding records from.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (fd == -1)
+    {
+        LE_KILL_CLIENT("No binding fd provided.");
+        return;
+    }
+
+    SdirToolUnbindAll();
+
+    SdirToolLoadBindings(fd, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a "Bind User" request from the 'sdir' tool.  Deletes the bindings of one user's client
+ * interfaces and then creates the bindings read from a file descriptor.  The bindings of other
+ * users are left alone, except where a record replaces one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolBindUser
+(
+    uid_t uid,  ///< [in] The user ID.
+    int fd      ///< [in] The file descriptor to read the binding records from.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (fd == -1)
+    {
+        LE_KILL_CLIENT("No binding fd provided.");
+        return;
+    }
+
+    // The framework's own bindings are hard-coded, and root's can only be reloaded all at once.
+    if (uid == 0)
+    {
+        LE_KILL_CLIENT("Can't reload the bindings of the root user on their own.");
+        fd_Close(fd);
+        return;
     }
+
+    UnbindUser(uid, false /* includeServices */);
+
+    SdirToolLoadBindings(fd, &uid);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles an "Unbind User" request from the 'sdir' tool.  Deletes the bindings of one user's
+ * client interfaces and the bindings to that user's services.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolUnbindUser
+(
+    uid_t uid   ///< [in] The user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (uid == 0)
+    {
+        LE_KILL_CLIENT("Can't unbind the root user.");
+        return;
+    }
+
+    UnbindUser(uid, true /* includeServices */);
 }
 
 
@@ -2519,6 +2966,21 @@ static void SdirToolRecv
             SdirToolBind(msgPtr);
             break;
 
+        case LE_SDTP_MSGID_BIND_ALL:
+
+            SdirToolBindAll(le_msg_GetFd(msgRef));
+            break;
+
+        case LE_SDTP_MSGID_BIND_USER:
+
+            SdirToolBindUser(msgPtr->client, le_msg_GetFd(msgRef));
+            break;
+
+        case LE_SDTP_MSGID_UNBIND_USER:
+
+            SdirToolUnbindUser(msgPtr->client);
+            break;
+
         default:
             LE_KILL_CLIENT("Invalid message ID %d.", msgPtr->msgType);
             break;
@@ -2566,6 +3028,7 @@ COMPONENT_INIT
     ServerConnectionPoolRef = le_mem_CreatePool("Server Connection", sizeof(ServerConnection_t));
     UserPoolRef = le_mem_CreatePool("User", sizeof(User_t));
     BindingPoolRef = le_mem_CreatePool("Binding", sizeof(Binding_t));
+    BindingTargetPoolRef = le_mem_CreatePool("Binding Target", sizeof(BindingTarget_t));
 
     /// Expand the pools to their expected maximum sizes.
     /// @todo Make this configurable.
@@ -2573,6 +3036,25 @@ COMPONENT_INIT
     le_mem_ExpandPool(ServerConnectionPoolRef, 30);
     le_mem_ExpandPool(UserPoolRef, 30);
     le_mem_ExpandPool(BindingPoolRef, 30);
+    le_mem_ExpandPool(BindingTargetPoolRef, 30);
+
+    // Create the lookup maps.
+    UserMapRef = le_hashmap_Create("Users",
+                                   LOOKUP_MAP_SIZE,
+                                   le_hashmap_HashUInt32,
+                                   le_hashmap_EqualsUInt32);
+    ServiceMapRef = le_hashmap_Create("Services",
+                                      LOOKUP_MAP_SIZE,
+                                      HashInterfaceKey,
+                                      EqualsInterfaceKey);
+    BindingMapRef = le_hashmap_Create("Bindings",
+                                      LOOKUP_MAP_SIZE,
+                                      HashInterfaceKey,
+                                      EqualsInterfaceKey);
+    BindingTargetMapRef = le_hashmap_Create("Binding Targets",
+                                            LOOKUP_MAP_SIZE,
+                                            HashInterfaceKey,
+                                            EqualsInterfaceKey);
 
     // Register destructor functions.
     le_mem_SetDestructor(ClientConnectionPoolRef, ClientConnectionDestructor);
@@ -2594,6 +3076,10 @@ COMPONENT_INIT
     ClientSocketFd = OpenSocket(STRINGIZE(LE_SVCDIR_CLIENT_SOCKET_NAME));
     ServerSocketFd = OpenSocket(STRINGIZE(LE_SVCDIR_SERVER_SOCKET_NAME));
 
+    // Connections are accepted in batches, until accept() would block.
+    fd_SetNonBlocking(ClientSocketFd);
+    fd_SetNonBlocking(ServerSocketFd);
+
     // Start listening for connection attempts.
     ClientSocketMonitorRef = le_fdMonitor_Create("Client Socket",
                                                  ClientSocketFd,
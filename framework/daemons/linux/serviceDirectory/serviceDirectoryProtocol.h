@@ -5,6 +5,7 @@
  * @ref serviceDirectoryProtocol_SocketsAndCredentials <br>
  * @ref serviceDirectoryProtocol_Servers <br>
  * @ref serviceDirectoryProtocol_Clients <br>
+ * @ref serviceDirectoryProtocol_Connectors <br>
  * @ref serviceDirectoryProtocol_Packing
  *
  * @section serviceDirectoryProtocol_Intro Introduction
@@ -40,9 +41,11 @@
  *       are connected to the service.
  *
  * When a client connects to a service, the Service Directory will send the server a file descriptor
- * of a Unix Domain SOCK_SEQPACKET socket that is connected to the client.  The server should then
- * send a welcome message (LE_OK) to the client over that connection and switch to using the
- * protocol that it advertised for that service.
+ * of a Unix Domain SOCK_SEQPACKET socket that is connected to the client, along with a
+ * svcdir_ConnectionType_t saying what the client wants that connection to be used for.  For an
+ * ordinary session, the server should then send a welcome message (LE_OK) to the client over that
+ * connection and switch to using the protocol that it advertised for that service.  For a
+ * connector, see @ref serviceDirectoryProtocol_Connectors.
  *
  * @note This implies a pair of connected sockets per session.
  *
@@ -85,6 +88,24 @@
  * @note The client socket is a named socket, rather than an abstract socket because this allows
  *       file system permissions to be used to prevent DoS attacks on this socket.
  *
+ * @section serviceDirectoryProtocol_Connectors Connectors
+ *
+ * A client that expects to open sessions on the same interface many times can ask the Service
+ * Directory for a "connector" instead of a session, by setting isConnector in its open request.
+ * The Service Directory resolves the binding exactly as it would for a session (except that it
+ * never waits), and dispatches the connection to the server.  The server sends a welcome
+ * message (LE_OK) over the connector, but does not treat it as a session.
+ *
+ * From then on, the client can open a session without involving the Service Directory by creating
+ * a connected pair of SOCK_SEQPACKET sockets and sending one of them to the server over the
+ * connector.  The server handles the received socket exactly as if the Service Directory had
+ * dispatched it as a session, except that it drops sockets whose peer is not running as the same
+ * user as the connector's peer.
+ *
+ * The server closes its connectors when it stops advertising the service, so the client falls back
+ * to going through the Service Directory.  Bindings changed after the connector was created do
+ * not affect it.
+ *
  * @section serviceDirectoryProtocol_Packing Byte Ordering and Packing
  *
  * This protocol only goes between processes on the same host, so there's no need to do
@@ -160,8 +181,28 @@ typedef struct
                             ///         the service at this time.
                             ///  false = fail immediately if either a binding or advertisement is
                             ///         missing at this time.
+    bool isConnector;       ///< true = ask for a connector rather than a session
+                            ///         (see @ref serviceDirectoryProtocol_Connectors).  shouldWait
+                            ///         is ignored (treated as false) for connectors.
 }
 svcdir_OpenRequest_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection type.
+ *
+ * Sent by the Service Directory to the server along with the file descriptor of each client
+ * connection it dispatches to that server.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SVCDIR_CONNECTION_SESSION,      ///< The connection is a session.
+    SVCDIR_CONNECTION_CONNECTOR     ///< The connection is a connector, over which the client will
+                                    ///  send the sockets of further sessions.
+}
+svcdir_ConnectionType_t;
+
+
 #endif // LEGATO_SERVICE_DIRECTORY_PROTOCOL_INCLUDE_GUARD
@@ -38,6 +38,7 @@
 #include "sysPaths.h"
 #include "sysStatus.h"
 #include "ima.h"
+#include "bootTrace.h"
 #include <mntent.h>
 #include <linux/limits.h>
 #include <dlfcn.h>
@@ -126,9 +127,13 @@ static const char CurrentSystemDir[] = "/legato/systems/current";
 static const char AppsDir[] = "/legato/apps";
 static const char SystemsUnpackDir[] = "/legato/systems/unpack";
 static const char AppsUnpackDir[] = "/legato/apps/unpack";
+static const char TrashDir[] = "/legato/systems/.trash";
 static const char OldFwDir[] = "/mnt/flash/opt/legato";
 
 static const char LdconfigNotDoneMarkerFile[] = "/legato/systems/needs_ldconfig";
+static const char LdconfigLibsFile[] = "/legato/systems/ldconfig_libs";
+static const char LdSoCacheFile[] = "/etc/ld.so.cache";
+static const char CurrentLibDir[] = "/legato/systems/current/lib";
 static const char GoldenVersionFile[] = "/mnt/legato/system/version";
 static const char CurrentVersionFile[] = "/legato/systems/current/version";
 
@@ -152,6 +157,21 @@ static const uint32_t BrownoutVoltageLimit = 3525;
 //--------------------------------------------------------------------------------------------------
 static void* ModemPASoPtr;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process deleting the contents of the trash directory in the background, or -1 if none is
+ * running.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t TrashCleanerPid = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Niceness of the trash cleaner, so that it only uses the CPU and flash left over by the framework.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRASH_CLEANER_NICE_LEVEL    19
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handle the event during PA initialization
@@ -431,6 +451,134 @@ static void RecursiveDelete
                path);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the trash cleaner to finish, if it is running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitForTrashCleaner
+(
+    void
+)
+{
+    if (TrashCleanerPid != -1)
+    {
+        LE_INFO("Waiting for the trash to be emptied.");
+
+        if ((waitpid(TrashCleanerPid, NULL, 0) == -1) && (errno != ECHILD))
+        {
+            LE_ERROR("waitpid() failed for the trash cleaner: %m");
+        }
+
+        TrashCleanerPid = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a file or directory out of the way by moving it into the trash directory, to be deleted in
+ * the background by StartTrashCleaner() once the framework is starting.  A rename is a single
+ * metadata update, whereas deleting a whole system tree one file at a time can take many seconds.
+ *
+ * Falls back to deleting it right away if it can't be moved (e.g., it is a mount point).
+ */
+//--------------------------------------------------------------------------------------------------
+static void MoveToTrash
+(
+    const char* path
+)
+{
+    static unsigned int trashCount = 0;
+    struct stat pathStat;
+
+    if ((lstat(path, &pathStat) == -1) && (errno == ENOENT))
+    {
+        return;
+    }
+
+    // Don't add to the trash while it is being emptied.
+    WaitForTrashCleaner();
+
+    le_result_t result = dir_MakeSmack(TrashDir, S_IRWXU, "framework");
+    if ((result == LE_OK) || (result == LE_DUPLICATE))
+    {
+        char trashPath[PATH_MAX];
+
+        // Entries may be left over from a cleaner interrupted by a reboot, so skip the names that
+        // are taken.
+        do
+        {
+            LE_ASSERT(snprintf(trashPath, sizeof(trashPath), "%s/%u", TrashDir, trashCount++)
+                      < sizeof(trashPath));
+        }
+        while (lstat(trashPath, &pathStat) == 0);
+
+        if (rename(path, trashPath) == 0)
+        {
+            return;
+        }
+
+        LE_WARN("Cannot move '%s' to the trash (%m). Deleting it now.", path);
+    }
+    else
+    {
+        LE_WARN("Cannot create '%s'. Deleting '%s' now.", TrashDir, path);
+    }
+
+    RecursiveDelete(path);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * If there is anything in the trash, delete it in a low priority child process.
+ *
+ * Called once the Supervisor has been started, so that deleting old systems doesn't delay the
+ * framework start-up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTrashCleaner
+(
+    void
+)
+{
+    if (TrashCleanerPid != -1)
+    {
+        // Still emptying the trash from a previous start of the framework?
+        if (waitpid(TrashCleanerPid, NULL, WNOHANG) == 0)
+        {
+            return;
+        }
+
+        TrashCleanerPid = -1;
+    }
+
+    if (!DirExists(TrashDir))
+    {
+        return;
+    }
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        // I'm the child.
+        if (setpriority(PRIO_PROCESS, 0, TRASH_CLEANER_NICE_LEVEL) == -1)
+        {
+            LE_WARN("Could not lower the priority of the trash cleaner: %m");
+        }
+
+        _exit(le_dir_RemoveRecursive(TrashDir) == LE_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    else if (pid == -1)
+    {
+        LE_ERROR("Could not start the trash cleaner: %m");
+    }
+    else
+    {
+        TrashCleanerPid = pid;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete the unpack dir and its contents.
@@ -443,7 +591,7 @@ static void DeleteSystemUnpack
     void
 )
 {
-    RecursiveDelete(SystemsUnpackDir);
+    MoveToTrash(SystemsUnpackDir);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -456,7 +604,7 @@ static void DeleteAppsUnpack
     void
 )
 {
-    RecursiveDelete(AppsUnpackDir);
+    MoveToTrash(AppsUnpackDir);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -794,7 +942,79 @@ static void MakeUnpackDirFromGolden
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy the previous system's configuration trees into the new system config directory.
+ * Check whether a file in a system's config directory is part of a configuration tree, i.e., one
+ * of its revisions (<tree>.paper, <tree>.rock or <tree>.scissors) or its delta log (<tree>.delta).
+ *
+ * @return The length of the tree name, or 0 if the file isn't part of a tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetConfigTreeNameLen
+(
+    const char* fileName
+)
+{
+    const char* dotPtr = strrchr(fileName, '.');
+
+    if (   (dotPtr == NULL)
+        || (dotPtr == fileName)
+        || (   (strcmp(dotPtr, ".paper") != 0)
+            && (strcmp(dotPtr, ".rock") != 0)
+            && (strcmp(dotPtr, ".scissors") != 0)
+            && (strcmp(dotPtr, ".delta") != 0)))
+    {
+        return 0;
+    }
+
+    return dotPtr - fileName;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stage a configuration tree file of the previous system for import by the Config Tree, by
+ * hard-linking it into <config>/import/<tree>/.  The Config Tree moves a tree's staged files into
+ * place when the tree is first opened, so only the trees that are actually used get copied, and
+ * not before the framework is running.
+ *
+ * The hard link keeps the file alive if the previous system is deleted.  It is copied instead if
+ * it can't be linked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StageConfigTreeFile
+(
+    const char* srcPath,    ///< [IN] Path of the tree file in the previous system.
+    const char* destDir,    ///< [IN] Config directory of the new system.
+    const char* fileName,   ///< [IN] Name of the tree file.
+    size_t treeNameLen      ///< [IN] Length of the tree name at the start of fileName.
+)
+{
+    char importDir[PATH_MAX];
+    char destPath[PATH_MAX];
+
+    LE_ASSERT(snprintf(importDir, sizeof(importDir), "%s/import", destDir) < sizeof(importDir));
+    MakeDir(importDir);
+
+    LE_ASSERT(snprintf(importDir, sizeof(importDir), "%s/import/%.*s",
+                       destDir, (int)treeNameLen, fileName)
+              < sizeof(importDir));
+    MakeDir(importDir);
+
+    LE_ASSERT(snprintf(destPath, sizeof(destPath), "%s/%s", importDir, fileName)
+              < sizeof(destPath));
+
+    if (   (link(srcPath, destPath) != 0)
+        && (file_Copy(srcPath, destPath, NULL) != LE_OK))
+    {
+        LE_ERROR("Could not import config tree file '%s'.", srcPath);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import the previous system's configuration into the new system config directory.  The
+ * configuration trees are staged to be imported by the Config Tree when they are first opened;
+ * anything else is copied now.
  */
 //--------------------------------------------------------------------------------------------------
 static void ImportOldConfigTrees
@@ -805,6 +1025,7 @@ static void ImportOldConfigTrees
 {
     if (oldIndex > -1)
     {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
         char srcDir[PATH_MAX];
         char destDir[PATH_MAX];
 
@@ -822,14 +1043,92 @@ static void ImportOldConfigTrees
         LE_ASSERT(snprintf(srcDir, sizeof(srcDir), "%s/%d/config", SystemsDir, oldIndex)
                   < sizeof(srcDir));
 
-        file_CopyRecursive(srcDir, destDir, NULL);
+        DIR* d = opendir(srcDir);
+
+        if (d == NULL)
+        {
+            LE_ERROR("Cannot open directory '%s': %m", srcDir);
+            return;
+        }
+
+        for (;;)
+        {
+            errno = 0;
+            struct dirent* entry = readdir(d);
+
+            if (entry == NULL)
+            {
+                if (errno != 0)
+                {
+                    LE_ERROR("Failed to read directory entry from '%s': %m", srcDir);
+                }
+
+                break;
+            }
+
+            if (entry->d_name[0] == '.')
+            {
+                continue;
+            }
+
+            char srcPath[PATH_MAX];
+            char destPath[PATH_MAX];
+            struct stat srcStat;
+
+            LE_ASSERT(snprintf(srcPath, sizeof(srcPath), "%s/%s", srcDir, entry->d_name)
+                      < sizeof(srcPath));
+            LE_ASSERT(snprintf(destPath, sizeof(destPath), "%s/%s", destDir, entry->d_name)
+                      < sizeof(destPath));
+
+            if (lstat(srcPath, &srcStat) != 0)
+            {
+                LE_ERROR("Error when trying to lstat '%s'. (%m)", srcPath);
+                continue;
+            }
+
+            size_t treeNameLen = GetConfigTreeNameLen(entry->d_name);
+
+            if (S_ISREG(srcStat.st_mode) && (treeNameLen > 0))
+            {
+                StageConfigTreeFile(srcPath, destDir, entry->d_name, treeNameLen);
+            }
+            else if (S_ISLNK(srcStat.st_mode))
+            {
+                char linkBuffer[PATH_MAX];
+                ssize_t bytesRead = readlink(srcPath, linkBuffer, sizeof(linkBuffer) - 1);
+
+                if (bytesRead < 0)
+                {
+                    LE_ERROR("Failed to read symlink '%s'. (%m)", srcPath);
+                    continue;
+                }
+                linkBuffer[bytesRead] = '\0';
+
+                if (symlink(linkBuffer, destPath) != 0)
+                {
+                    LE_ERROR("Failed to create symlink '%s' to '%s'. (%m)", destPath, linkBuffer);
+                }
+            }
+            else if (file_CopyRecursive(srcPath, destPath, NULL) != LE_OK)
+            {
+                LE_ERROR("Could not copy '%s' to '%s'.", srcPath, destPath);
+            }
+        }
+
+        if (closedir(d))
+        {
+            LE_ERROR("Could not close '%s': %m", srcDir);
+        }
+
+        bootTrace_Record(getpid(), "phase", "ImportOldConfigTrees", startTime);
     }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Delete all systems except for the current one.
+ * Delete all systems except for the current one.  The systems are moved to the trash and deleted
+ * in the background.
  */
 //--------------------------------------------------------------------------------------------------
 static void DeleteAllButCurrent
@@ -882,7 +1181,7 @@ static void DeleteAllButCurrent
             // sandboxed apps were created.
             fs_TryLazyUmount(path);
 
-            RecursiveDelete(path);
+            MoveToTrash(path);
         }
     }
 
@@ -911,7 +1210,7 @@ static void Rename
         {
             // The old name is a non empty directory. Blow it away.
             LE_WARN("Destination '%s' exists. Deleting it.", toName);
-            RecursiveDelete(toName);
+            MoveToTrash(toName);
 
             // Try again.
             if (rename(fromName, toName) == -1)
@@ -928,6 +1227,65 @@ static void Rename
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Describe what the dynamic linker's cache was built from: the names of the current system's
+ * libraries, which are all the cache knows about them, and the identity of the cache file itself,
+ * which changes when the root file system (and its cache) is updated.
+ *
+ * The library names are combined with a sum of their hashes, so their order doesn't matter.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetLdSoCacheFingerprint
+(
+    char* buffer,   ///< [OUT] Fingerprint string.
+    size_t size     ///< Size of the buffer in bytes.
+)
+{
+    uint64_t hashSum = 0;
+    unsigned int numLibs = 0;
+
+    DIR* d = opendir(CurrentLibDir);
+
+    if (d != NULL)
+    {
+        struct dirent* entry;
+
+        while ((entry = readdir(d)) != NULL)
+        {
+            // 64-bit FNV-1a hash of the name.
+            uint64_t hash = 14695981039346656037ULL;
+            const char* charPtr;
+
+            for (charPtr = entry->d_name; *charPtr != '\0'; charPtr++)
+            {
+                hash = (hash ^ (uint8_t)*charPtr) * 1099511628211ULL;
+            }
+
+            hashSum += hash;
+            numLibs++;
+        }
+
+        closedir(d);
+    }
+
+    struct stat cacheStat;
+
+    if (stat(LdSoCacheFile, &cacheStat) != 0)
+    {
+        memset(&cacheStat, 0, sizeof(cacheStat));
+    }
+
+    LE_ASSERT(snprintf(buffer, size, "%u %016llx %llu %lld %lld",
+                       numLibs,
+                       (unsigned long long)hashSum,
+                       (unsigned long long)cacheStat.st_ino,
+                       (long long)cacheStat.st_size,
+                       (long long)cacheStat.st_mtime)
+              < size);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * create the ld.so.cache for the new install (or reversion).
@@ -938,8 +1296,25 @@ static void UpdateLdSoCache
     const char* systemPath
 )
 {
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
     int rc = 0;
     const char* text;
+    char fingerprint[100];
+    char lastFingerprint[100];
+
+    // Selecting another system only requires a new cache if the library names differ, because
+    // the cache maps them to paths under /legato/systems/current/lib, which don't change.
+    GetLdSoCacheFingerprint(fingerprint, sizeof(fingerprint));
+
+    if (   (ReadFromFile(LdconfigLibsFile, lastFingerprint, sizeof(lastFingerprint)) > 0)
+        && (strcmp(fingerprint, lastFingerprint) == 0))
+    {
+        LE_INFO("Libraries unchanged; ld.so.cache is up to date.");
+        unlink(LdconfigNotDoneMarkerFile);
+        bootTrace_Record(getpid(), "phase", "UpdateLdSoCache", startTime);
+        return;
+    }
+
     // create marker file to say we are doing ldconfig
     text = "start_ldconfig";
     // If this fails, try to limp along anyway.
@@ -967,8 +1342,14 @@ static void UpdateLdSoCache
     // If this fails, the system probably won't work, but not much we can do but try.
     if (0 == WEXITSTATUS(rc))
     {
+        // Remember what the new cache was built from, so it isn't rebuilt needlessly.
+        GetLdSoCacheFingerprint(fingerprint, sizeof(fingerprint));
+        (void)WriteToFile(LdconfigLibsFile, fingerprint, strlen(fingerprint));
+
         unlink(LdconfigNotDoneMarkerFile);
     }
+
+    bootTrace_Record(getpid(), "phase", "UpdateLdSoCache", startTime);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1458,6 +1839,10 @@ static int TryToRun
     LE_FATAL_IF(freopen("/dev/null", "r", stdin) == NULL,
                 "Failed to redirect stdin to /dev/null.  %m.");
 
+    // Now that the Supervisor is on its way, delete whatever was replaced or removed while
+    // selecting the system.
+    StartTrashCleaner();
+
     // Wait for the Supervisor to exit.
     int result;
     pid_t p = waitpid(supervisorPid, &result, 0);
@@ -1906,7 +2291,7 @@ static int InstallGolden
     // Make sure there's nothing in the way.
     char path[PATH_MAX];
     CreateSystemPathName(goldenIndex, path, sizeof(path));
-    RecursiveDelete(path);
+    MoveToTrash(path);
 
     // If there is a current system directory, rename it to its index.
     if (currentIndex > -1)
@@ -2135,13 +2520,13 @@ static void CheckAndInstallCurrentSystem
             {
                 case STATUS_BAD:
                     // System bad. Delete and roll-back (here newestIndex < currentIndex).
-                    RecursiveDelete(path);
+                    MoveToTrash(path);
                     break;
 
                 case STATUS_TRYABLE:
                     // System try-able. Grab config tree from current system and delete it.
                     ImportOldConfigTrees(currentIndex, newestIndex);
-                    RecursiveDelete(path);
+                    MoveToTrash(path);
                     break;
 
                 case STATUS_GOOD:
@@ -2206,11 +2591,18 @@ int main
 
     while(1)
     {
+        // Each start of the framework gets a trace of its own.
+        bootTrace_Reset();
+
         if (!isReadOnly)
         {
             // Verify and install the current system.
             // R/O system are always ready. So, nothing to do for them.
+            le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
             CheckAndInstallCurrentSystem();
+
+            bootTrace_Record(getpid(), "phase", "CheckAndInstallCurrentSystem", startTime);
         }
 
         // Run the current system.
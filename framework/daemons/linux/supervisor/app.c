@@ -61,6 +61,7 @@
 #include "file.h"
 #include "ima.h"
 #include "kernelModules.h"
+#include "appSettings.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -354,6 +355,10 @@ typedef struct app_Ref
     le_sls_List_t   additionalLinks;    // List of additional links that are temporarily added to
                                         // the app.
     le_sls_List_t   reqModuleName;      // List of required kernel module names
+    bool            sandboxCached;      // true if the SMACK rules and app area set up by the last
+                                        // start are kept for the next start.
+    uint32_t        sandboxCfgCrc;      // CRC of the app's config when they were set up.
+    appSettings_Ref_t settingsRef;      // The app's settings blob, NULL if it doesn't have one.
 }
 App_t;
 
@@ -693,6 +698,7 @@ static le_result_t GetDevID
 //--------------------------------------------------------------------------------------------------
 static le_result_t SetDevicePermissions
 (
+    smack_RuleBatch_t* rulesPtr,    ///< [IN] Batch to add the SMACK rule to.
     const char* appSmackLabelPtr,   ///< [IN] SMACK label of the app.
     const char* devPathPtr,         ///< [IN] Source path.
     const char* permPtr             ///< [IN] Permissions.
@@ -725,7 +731,7 @@ static le_result_t SetDevicePermissions
     }
 
     // Set the SMACK rule to allow the app to access the device.
-    smack_SetRule(appSmackLabelPtr, permPtr, devLabel);
+    smack_AddRule(rulesPtr, appSmackLabelPtr, permPtr, devLabel);
 
     return LE_OK;
 }
@@ -742,7 +748,8 @@ static le_result_t SetDevicePermissions
 //--------------------------------------------------------------------------------------------------
 static le_result_t SetCfgDevicePermissions
 (
-    app_Ref_t appRef                ///< [IN] The application.
+    app_Ref_t appRef,               ///< [IN] The application.
+    smack_RuleBatch_t* rulesPtr     ///< [IN] Batch to add the SMACK rules to.
 )
 {
     // Create an iterator for the app.
@@ -772,7 +779,7 @@ static le_result_t SetCfgDevicePermissions
             char permStr[MAX_DEVICE_PERM_STR_BYTES];
             GetCfgPermissions(appCfg, permStr, sizeof(permStr));
 
-            if (SetDevicePermissions(appLabel, srcPath, permStr) != LE_OK)
+            if (SetDevicePermissions(rulesPtr, appLabel, srcPath, permStr) != LE_OK)
             {
                 LE_ERROR("Failed to set permissions (%s) for app '%s' on device '%s'.",
                          permStr,
@@ -801,7 +808,8 @@ static le_result_t SetCfgDevicePermissions
 static void SetSmackRulesForBindings
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application.
-    const char* appLabelPtr             ///< [IN] Smack label for the app.
+    const char* appLabelPtr,            ///< [IN] Smack label for the app.
+    smack_RuleBatch_t* rulesPtr         ///< [IN] Batch to add the SMACK rules to.
 )
 {
     // Create a config read transaction to the bindings section for the application.
@@ -829,8 +837,8 @@ static void SetSmackRulesForBindings
             // Set the SMACK label to/from the server.
             // +x is needed as few servers (powerManager & watchdog) need to know the
             // name of their clients and go in to /proc/{pid} of the client.
-            smack_SetRule(appLabelPtr, "rwx", serverLabel);
-            smack_SetRule(serverLabel, "rwx", appLabelPtr);
+            smack_AddRule(rulesPtr, appLabelPtr, "rwx", serverLabel);
+            smack_AddRule(rulesPtr, serverLabel, "rwx", appLabelPtr);
         }
     } while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
 
@@ -846,7 +854,8 @@ static void SetSmackRulesForBindings
 static void SetDefaultSmackRules
 (
     app_Ref_t appRef,                   ///< [IN] App reference.
-    const char* appLabelPtr             ///< [IN] Smack label for the app.
+    const char* appLabelPtr,            ///< [IN] Smack label for the app.
+    smack_RuleBatch_t* rulesPtr         ///< [IN] Batch to add the SMACK rules to.
 )
 {
 #define NUM_PERMISSONS      7
@@ -877,34 +886,34 @@ static void SetDefaultSmackRules
         char dirLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
         smack_GetAppAccessLabel(appRef->name, mode, dirLabel, sizeof(dirLabel));
 
-        smack_SetRule(appLabelPtr, permissionStr[i], dirLabel);
+        smack_AddRule(rulesPtr, appLabelPtr, permissionStr[i], dirLabel);
 
         // framework and admin need to have that priviledge as well
-        smack_SetRule("framework", permissionStr[i], dirLabel);
-        smack_SetRule("admin", permissionStr[i], dirLabel);
+        smack_AddRule(rulesPtr, "framework", permissionStr[i], dirLabel);
+        smack_AddRule(rulesPtr, "admin", permissionStr[i], dirLabel);
     }
 
     // Set default permissions between the app and the framework.
     // Give watchdog acces to read the procName from applications
-    smack_SetRule("framework", "rwx", appLabelPtr);
+    smack_AddRule(rulesPtr, "framework", "rwx", appLabelPtr);
 
     if (ima_IsEnabled())
     {
-        smack_SetRule(appLabelPtr, "rx", IMA_SMACK_LABEL);
+        smack_AddRule(rulesPtr, appLabelPtr, "rx", IMA_SMACK_LABEL);
     }
-    smack_SetRule(appLabelPtr, "rwx", "framework");
+    smack_AddRule(rulesPtr, appLabelPtr, "rwx", "framework");
 
     // Set default permissions to allow the app to access the syslog.
-    smack_SetRule(appLabelPtr, "w", "syslog");
-    smack_SetRule("syslog", "w", appLabelPtr);
+    smack_AddRule(rulesPtr, appLabelPtr, "w", "syslog");
+    smack_AddRule(rulesPtr, "syslog", "w", appLabelPtr);
 
     // admin gets access to app labels.
-    smack_SetRule("admin", "rwx", appLabelPtr);
+    smack_AddRule(rulesPtr, "admin", "rwx", appLabelPtr);
 
     // Give unsandboxed apps access to "_"
     if (!appRef->sandboxed)
     {
-        smack_SetRule(appLabelPtr, "rwx", "_");
+        smack_AddRule(rulesPtr, appLabelPtr, "rwx", "_");
     }
 
     static char* frameworkAppList[] =
@@ -939,13 +948,13 @@ static void SetDefaultSmackRules
     {
         if (0 == strcmp(frameworkAppList[i], appLabelPtr))
         {
-            smack_SetRule(frameworkAppList[i], "rwx", "qmuxd");
-            smack_SetRule("qmuxd", "rwx", frameworkAppList[i]);
+            smack_AddRule(rulesPtr, frameworkAppList[i], "rwx", "qmuxd");
+            smack_AddRule(rulesPtr, "qmuxd", "rwx", frameworkAppList[i]);
 
             // Give app.fwupdateService r access to admin (pipe) in order to perform update
             if (0 == strcmp(frameworkAppList[i], "app.fwupdateService"))
             {
-                smack_SetRule(frameworkAppList[i], "r", "admin");
+                smack_AddRule(rulesPtr, frameworkAppList[i], "r", "admin");
             }
         }
     }
@@ -1359,18 +1368,23 @@ static le_result_t SetSmackRules
     char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
     smack_GetAppLabel(appRef->name, appLabel, sizeof(appLabel));
 
-    SetDefaultSmackRules(appRef, appLabel);
+    // Load the rules several at a time rather than one by one.
+    smack_RuleBatch_t rules = SMACK_RULE_BATCH_INIT;
 
-    SetSmackRulesForBindings(appRef, appLabel);
+    SetDefaultSmackRules(appRef, appLabel, &rules);
+
+    SetSmackRulesForBindings(appRef, appLabel, &rules);
 
     le_result_t result = SetPermissionForRequired(appRef);
 
-    if (result != LE_OK)
+    if (result == LE_OK)
     {
-        return result;
+        result = SetCfgDevicePermissions(appRef, &rules);
     }
 
-    return SetCfgDevicePermissions(appRef);
+    smack_CommitRules(&rules);
+
+    return result;
 }
 
 
@@ -3004,6 +3018,7 @@ void app_Init
     ReqModStringPool = le_mem_CreatePool("Required Modules", sizeof(ModNameNode_t));
 
     proc_Init();
+    appSettings_Init();
 
     // Create the appsWriteable area.
     if (le_dir_MakePath(APPS_WRITEABLE_DIR, S_IRUSR | S_IXUSR | S_IROTH | S_IXOTH) != LE_OK)
@@ -3160,6 +3175,9 @@ app_Ref_t app_Create
     appPtr->additionalLinks = LE_SLS_LIST_INIT;
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
+    appPtr->sandboxCached = false;
+    appPtr->sandboxCfgCrc = 0;
+    appPtr->settingsRef = NULL;
 
     LE_INFO("Creating app '%s'", appPtr->name);
 
@@ -3193,6 +3211,10 @@ app_Ref_t app_Create
         goto failed;
     }
 
+    // Map the app's settings blob, if it has one, so its static settings can be read without
+    // going through the config tree.
+    appPtr->settingsRef = appSettings_Load(appPtr->installDirPath);
+
     // Use the app's writeable files' directory path as the its working directory.
     appPtr->workingDir[0] = '\0';
     if (LE_OK != le_path_Concat("/",
@@ -3355,11 +3377,113 @@ void app_Delete
         le_timer_Delete(appRef->killTimer);
     }
 
+    if (appRef->settingsRef != NULL)
+    {
+        appSettings_Unload(appRef->settingsRef);
+    }
+
     // Release app.
     le_mem_Release(appRef);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes a CRC of everything under the app's node in the config tree, so that a restart can tell
+ * whether the app's config has changed since its sandbox was set up.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the config could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetAppConfigCrc
+(
+    app_Ref_t appRef,                   ///< [IN] Reference to the application.
+    uint32_t* crcPtr                    ///< [OUT] The CRC.
+)
+{
+    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+    uint8_t data[LE_CFG_SUBTREE_BYTES];
+    uint32_t firstEntry = 0;
+    uint32_t crc = LE_CRC_START_CRC32;
+    le_result_t result;
+
+    do
+    {
+        size_t dataSize = sizeof(data);
+        uint32_t entryCount = 0;
+
+        result = le_cfg_GetSubtree(appCfg, "", firstEntry, data, &dataSize, &entryCount);
+
+        if ( ((result != LE_OK) && (result != LE_OVERFLOW)) ||
+             ((result == LE_OVERFLOW) && (entryCount == 0)) )
+        {
+            le_cfg_CancelTxn(appCfg);
+            return LE_FAULT;
+        }
+
+        crc = le_crc_Crc32(data, dataSize, crc);
+        firstEntry += entryCount;
+    }
+    while (result == LE_OVERFLOW);
+
+    le_cfg_CancelTxn(appCfg);
+
+    *crcPtr = crc;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up the app's SMACK rules and execution area, or reuses the ones set up by the app's last
+ * start if its config hasn't changed since.  Keeping them saves a crash-looping app from re-reading
+ * its requirements and redoing its bind mounts, links, device permissions and SMACK rules on every
+ * restart.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetupSandbox
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+)
+{
+    uint32_t cfgCrc = 0;
+    bool haveCrc = (GetAppConfigCrc(appRef, &cfgCrc) == LE_OK);
+
+    if (appRef->sandboxCached && haveCrc && (cfgCrc == appRef->sandboxCfgCrc))
+    {
+        LE_INFO("Config of app '%s' unchanged, reusing its sandbox.", appRef->name);
+        return LE_OK;
+    }
+
+    if (appRef->sandboxCached)
+    {
+        // Drop the rules granted by the old config before setting the new ones.
+        CleanupAppSmackSettings(appRef);
+        appRef->sandboxCached = false;
+    }
+
+    // Set SMACK rules for this app.
+    // Setup the runtime area in the file system.
+    if ( (SetSmackRules(appRef) != LE_OK) ||
+         (SetupAppArea(appRef) != LE_OK) )
+    {
+        LE_ERROR("Failed to set Smack rules or set up app area.");
+        return LE_FAULT;
+    }
+
+    appRef->sandboxCached = haveCrc;
+    appRef->sandboxCfgCrc = cfgCrc;
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts an application.
@@ -3401,16 +3525,13 @@ le_result_t app_Start
 
     appRef->state = APP_STATE_RUNNING;
 
-    // Set SMACK rules for this app.
-    // Setup the runtime area in the file system.
-    if ( (SetSmackRules(appRef) != LE_OK) ||
-         (SetupAppArea(appRef) != LE_OK) )
+    if (SetupSandbox(appRef) != LE_OK)
     {
-        LE_ERROR("Failed to set Smack rules or set up app area.");
         return LE_FAULT;
     }
 
-    // Create /tmp for sandboxed apps and link in /tmp files.
+    // Create /tmp for sandboxed apps and link in /tmp files.  This is done on every start so that
+    // each run of the app gets a clean /tmp.
     if (appRef->sandboxed)
     {
         // Get the SMACK label for the folders we create.
@@ -3501,7 +3622,7 @@ void app_Stop
 {
     LE_INFO("Stopping app '%s'", appRef->name);
 
-    CleanupAppSmackSettings(appRef);
+    // The app's SMACK rules are kept in case it is restarted.  See app_ReleaseSandbox().
 
     if (appRef->state == APP_STATE_STOPPED)
     {
@@ -3634,6 +3755,44 @@ bool app_HasTopLevelProc
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a line for each of an application's processes to a snapshot file, in the format described
+ * by le_appInfo_GetSnapshot():
+ *
+ *      proc NAME PID STATE FAULT_COUNT
+ */
+//--------------------------------------------------------------------------------------------------
+void app_WriteProcSnapshot
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    FILE* filePtr                       ///< [IN] Snapshot file to write to.
+)
+{
+    le_dls_List_t* listPtrs[] = { &(appRef->procs), &(appRef->auxProcs) };
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(listPtrs); i++)
+    {
+        le_dls_Link_t* procLinkPtr = le_dls_Peek(listPtrs[i]);
+
+        while (procLinkPtr != NULL)
+        {
+            ProcContainer_t* procContainerPtr = CONTAINER_OF(procLinkPtr, ProcContainer_t, link);
+            proc_Ref_t procRef = procContainerPtr->procRef;
+
+            fprintf(filePtr, "proc %s %d %s %" PRIu32 "\n",
+                    proc_GetName(procRef),
+                    (int)proc_GetPID(procRef),
+                    (proc_GetState(procRef) == PROC_STATE_RUNNING) ? "running" : "stopped",
+                    proc_GetFaultCount(procRef));
+
+            procLinkPtr = le_dls_PeekNext(listPtrs[i], procLinkPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's name.
@@ -3754,6 +3913,24 @@ const char* app_GetConfigPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an application's settings blob.
+ *
+ * @return
+ *      The application's settings blob.
+ *      NULL if the application doesn't have one.
+ */
+//--------------------------------------------------------------------------------------------------
+appSettings_Ref_t app_GetSettings
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    return appRef->settingsRef;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's supplementary groups list.
@@ -4521,7 +4698,11 @@ le_result_t app_SetDevPerm
     char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
     smack_GetAppLabel(app_GetName(appRef), appLabel, sizeof(appLabel));
 
-    le_result_t result = SetDevicePermissions(appLabel, pathPtr, permissionPtr);
+    smack_RuleBatch_t rules = SMACK_RULE_BATCH_INIT;
+
+    le_result_t result = SetDevicePermissions(&rules, appLabel, pathPtr, permissionPtr);
+
+    smack_CommitRules(&rules);
 
     if (result != LE_OK)
     {
@@ -4575,6 +4756,47 @@ void app_SetBlockCallback
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the system calls that stop the tracer of each app process that is blocked on startup (see
+ * app_SetBlockCallback()).
+ *
+ * @note The list is not copied; it must stay valid until it is cleared.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_SetTraceSysCalls
+(
+    app_Ref_t appRef,                           ///< [IN] App reference.
+    const int32_t* sysCallsPtr,                 ///< [IN] System call numbers.  NULL to clear.
+    size_t numSysCalls                          ///< [IN] Number of system calls.
+)
+{
+    // Set the system calls for each process in the app.
+    le_dls_Link_t* procLinkPtr = le_dls_Peek(&(appRef->procs));
+
+    while (procLinkPtr != NULL)
+    {
+        ProcContainer_t* procContainerPtr = CONTAINER_OF(procLinkPtr, ProcContainer_t, link);
+
+        proc_SetTraceSysCalls(procContainerPtr->procRef, sysCallsPtr, numSysCalls);
+
+        procLinkPtr = le_dls_PeekNext(&(appRef->procs), procLinkPtr);
+    }
+
+    // Set the system calls for each aux process in the app.
+    procLinkPtr = le_dls_Peek(&(appRef->auxProcs));
+
+    while (procLinkPtr != NULL)
+    {
+        ProcContainer_t* procContainerPtr = CONTAINER_OF(procLinkPtr, ProcContainer_t, link);
+
+        proc_SetTraceSysCalls(procContainerPtr->procRef, sysCallsPtr, numSysCalls);
+
+        procLinkPtr = le_dls_PeekNext(&(appRef->auxProcs), procLinkPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unblocks a process that was blocked on startup.
@@ -4624,6 +4846,25 @@ bool app_HasConfRunningProc
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the SMACK rules kept from the app's last start.  Called once an app has stopped and
+ * is not about to be restarted.  The next start will set up the app's sandbox from scratch.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_ReleaseSandbox
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    if (appRef->sandboxCached)
+    {
+        CleanupAppSmackSettings(appRef);
+        appRef->sandboxCached = false;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Performs tasks after an app has been stopped.
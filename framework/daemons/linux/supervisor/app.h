@@ -9,6 +9,7 @@
 #define LEGATO_SRC_APP_INCLUDE_GUARD
 
 #include "watchdogAction.h"
+#include "appSettings.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -232,6 +233,21 @@ bool app_HasTopLevelProc
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a line for each of an application's processes to a snapshot file, in the format described
+ * by le_appInfo_GetSnapshot():
+ *
+ *      proc NAME PID STATE FAULT_COUNT
+ */
+//--------------------------------------------------------------------------------------------------
+void app_WriteProcSnapshot
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    FILE* filePtr                       ///< [IN] Snapshot file to write to.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's name.
@@ -330,6 +346,21 @@ const char* app_GetConfigPath
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an application's settings blob.
+ *
+ * @return
+ *      The application's settings blob.
+ *      NULL if the application doesn't have one.
+ */
+//--------------------------------------------------------------------------------------------------
+appSettings_Ref_t app_GetSettings
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's supplementary groups list.
@@ -659,6 +690,22 @@ void app_SetBlockCallback
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the system calls that stop the tracer of each app process that is blocked on startup (see
+ * app_SetBlockCallback()).
+ *
+ * @note The list is not copied; it must stay valid until it is cleared.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_SetTraceSysCalls
+(
+    app_Ref_t appRef,                           ///< [IN] App reference.
+    const int32_t* sysCallsPtr,                 ///< [IN] System call numbers.  NULL to clear.
+    size_t numSysCalls                          ///< [IN] Number of system calls.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unblocks a process that was blocked on startup.
@@ -690,6 +737,18 @@ bool app_HasConfRunningProc
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the SMACK rules kept from the app's last start.  Called once an app has stopped and
+ * is not about to be restarted.  The next start will set up the app's sandbox from scratch.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_ReleaseSandbox
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Performs tasks after an app has been stopped.
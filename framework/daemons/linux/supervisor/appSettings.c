@@ -0,0 +1,458 @@
+//--------------------------------------------------------------------------------------------------
+/** @file appSettings.c
+ *
+ * Reads the settings blobs generated by the build tools for each app.
+ *
+ * All integers in a settings blob are little-endian.  The blob is made of:
+ *
+ *  - a 16-byte header: the magic number "LESB", the format version (uint32, 1), the number of
+ *    entries (uint32) and the offset from the start of the file of the string table (uint32);
+ *  - the entries, sorted by key (byte-wise), 16 bytes each: the offset of the key in the string
+ *    table (uint32), the value type (uint32) and the value (int64; 0 or 1 for a boolean, the offset
+ *    of the string in the string table for a string);
+ *  - the string table: NUL-terminated strings.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "appSettings.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include <endian.h>
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the settings blob file in an app's install directory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SETTINGS_FILE_NAME              "settings.bin"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings blob magic number and the format version that we understand.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SETTINGS_MAGIC                  "LESB"
+#define SETTINGS_VERSION                1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value types in a settings blob.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SETTING_TYPE_INT                0
+#define SETTING_TYPE_BOOL               1
+#define SETTING_TYPE_STRING             2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings blob header, as it is laid out in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char        magic[4];
+    uint32_t    version;
+    uint32_t    entryCount;
+    uint32_t    stringsOffset;
+}
+__attribute__((packed)) BlobHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings blob entry, as it is laid out in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    keyOffset;
+    uint32_t    type;
+    int64_t     value;
+}
+__attribute__((packed)) BlobEntry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A loaded settings blob.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct appSettings_Blob
+{
+    void*               mappingPtr;     // Memory mapping of the whole file.
+    size_t              size;           // Size of the file.
+    const BlobEntry_t*  entriesPtr;     // Entries, sorted by key.
+    uint32_t            entryCount;     // Number of entries.
+    const char*         stringsPtr;     // String table.
+    size_t              stringsSize;    // Size of the string table.
+}
+Blob_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of settings blob objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BlobPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a mapped settings blob is well formed and fills in the blob object's pointers into
+ * it.
+ *
+ * @return
+ *      true if the blob is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseBlob
+(
+    Blob_t* blobPtr                     ///< [IN] Blob with its mapping and size set.
+)
+{
+    const BlobHeader_t* headerPtr = blobPtr->mappingPtr;
+
+    if (blobPtr->size < sizeof(BlobHeader_t))
+    {
+        return false;
+    }
+
+    if (   (memcmp(headerPtr->magic, SETTINGS_MAGIC, sizeof(headerPtr->magic)) != 0)
+        || (le32toh(headerPtr->version) != SETTINGS_VERSION) )
+    {
+        return false;
+    }
+
+    uint64_t entryCount = le32toh(headerPtr->entryCount);
+    uint64_t stringsOffset = le32toh(headerPtr->stringsOffset);
+
+    if (   (stringsOffset != sizeof(BlobHeader_t) + (entryCount * sizeof(BlobEntry_t)))
+        || (stringsOffset > blobPtr->size) )
+    {
+        return false;
+    }
+
+    blobPtr->entriesPtr = (const BlobEntry_t*)(headerPtr + 1);
+    blobPtr->entryCount = entryCount;
+    blobPtr->stringsPtr = (const char*)blobPtr->mappingPtr + stringsOffset;
+    blobPtr->stringsSize = blobPtr->size - stringsOffset;
+
+    // Every string offset is checked to be inside the string table when it is used, so making sure
+    // the table ends with a NUL is enough to keep string reads inside the mapping.
+    if (   (blobPtr->stringsSize > 0)
+        && (blobPtr->stringsPtr[blobPtr->stringsSize - 1] != '\0') )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a string from a blob's string table.
+ *
+ * @return
+ *      The string, or NULL if the offset is out of the string table.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetString
+(
+    const Blob_t* blobPtr,
+    uint64_t offset
+)
+{
+    if (offset >= blobPtr->stringsSize)
+    {
+        return NULL;
+    }
+
+    return blobPtr->stringsPtr + offset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up an entry by key, with a binary search.
+ *
+ * @return
+ *      The entry, or NULL if it was not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static const BlobEntry_t* FindEntry
+(
+    const Blob_t* blobPtr,
+    const char* keyPtr
+)
+{
+    size_t low = 0;
+    size_t high = blobPtr->entryCount;
+
+    while (low < high)
+    {
+        size_t mid = low + ((high - low) / 2);
+        const BlobEntry_t* entryPtr = &blobPtr->entriesPtr[mid];
+
+        const char* entryKeyPtr = GetString(blobPtr, le32toh(entryPtr->keyOffset));
+        if (entryKeyPtr == NULL)
+        {
+            LE_ERROR("Corrupted settings blob.");
+            return NULL;
+        }
+
+        int cmp = strcmp(keyPtr, entryKeyPtr);
+
+        if (cmp == 0)
+        {
+            return entryPtr;
+        }
+        else if (cmp < 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up an entry by key and checks its type.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not of the requested type.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetValue
+(
+    appSettings_Ref_t settingsRef,
+    const char* keyPtr,
+    uint32_t type,
+    int64_t* valuePtr
+)
+{
+    const BlobEntry_t* entryPtr = FindEntry(settingsRef, keyPtr);
+
+    if (entryPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (le32toh(entryPtr->type) != type)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    *valuePtr = (int64_t)le64toh(entryPtr->value);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the settings blob module.  Must be called before any other function in this API.
+ */
+//--------------------------------------------------------------------------------------------------
+void appSettings_Init
+(
+    void
+)
+{
+    BlobPool = le_mem_CreatePool("App Settings", sizeof(Blob_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads an application's settings blob.
+ *
+ * @return
+ *      Reference to the settings blob.
+ *      NULL if the app doesn't have a settings blob or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+appSettings_Ref_t appSettings_Load
+(
+    const char* installDirPath      ///< [IN] Path to the app's install directory.
+)
+{
+    char filePath[LIMIT_MAX_PATH_BYTES] = "";
+
+    if (le_path_Concat("/", filePath, sizeof(filePath), installDirPath, SETTINGS_FILE_NAME, NULL)
+        != LE_OK)
+    {
+        LE_ERROR("Path to settings blob in '%s' is too long.", installDirPath);
+        return NULL;
+    }
+
+    int fd = open(filePath, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        // Apps built by older tools don't have a settings blob.
+        LE_ERROR_IF(errno != ENOENT, "Could not open '%s'.  %m.", filePath);
+        return NULL;
+    }
+
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) == -1)
+    {
+        LE_ERROR("Could not stat '%s'.  %m.", filePath);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    if (fileStat.st_size < (off_t)sizeof(BlobHeader_t))
+    {
+        LE_ERROR("Settings blob '%s' is truncated.", filePath);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    void* mappingPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    fd_Close(fd);
+
+    if (mappingPtr == MAP_FAILED)
+    {
+        LE_ERROR("Could not map '%s'.  %m.", filePath);
+        return NULL;
+    }
+
+    Blob_t* blobPtr = le_mem_ForceAlloc(BlobPool);
+    blobPtr->mappingPtr = mappingPtr;
+    blobPtr->size = fileStat.st_size;
+
+    if (!ParseBlob(blobPtr))
+    {
+        LE_ERROR("Settings blob '%s' is invalid.", filePath);
+        appSettings_Unload(blobPtr);
+        return NULL;
+    }
+
+    return blobPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unloads a settings blob.
+ */
+//--------------------------------------------------------------------------------------------------
+void appSettings_Unload
+(
+    appSettings_Ref_t settingsRef   ///< [IN] Settings blob to unload.
+)
+{
+    LE_ERROR_IF(munmap(settingsRef->mappingPtr, settingsRef->size) == -1,
+                "Could not unmap settings blob.  %m.");
+
+    le_mem_Release(settingsRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an integer setting.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not an integer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetInt
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    int64_t* valuePtr               ///< [OUT] Value of the setting.
+)
+{
+    return GetValue(settingsRef, keyPtr, SETTING_TYPE_INT, valuePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a boolean setting.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not a boolean.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetBool
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    bool* valuePtr                  ///< [OUT] Value of the setting.
+)
+{
+    int64_t value;
+    le_result_t result = GetValue(settingsRef, keyPtr, SETTING_TYPE_BOOL, &value);
+
+    if (result == LE_OK)
+    {
+        *valuePtr = (value != 0);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a string setting.  The string is in the blob's memory mapping, so it remains valid until
+ * the blob is unloaded.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not a string.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetString
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    const char** valuePtrPtr        ///< [OUT] Value of the setting.
+)
+{
+    int64_t offset;
+    le_result_t result = GetValue(settingsRef, keyPtr, SETTING_TYPE_STRING, &offset);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    const char* valuePtr = GetString(settingsRef, offset);
+    if (valuePtr == NULL)
+    {
+        LE_ERROR("Corrupted settings blob.");
+        return LE_FORMAT_ERROR;
+    }
+
+    *valuePtrPtr = valuePtr;
+
+    return LE_OK;
+}
@@ -0,0 +1,123 @@
+//--------------------------------------------------------------------------------------------------
+/** @file appSettings.h
+ *
+ * API for reading an application's settings blob.
+ *
+ * The build tools write a read-only copy of an application's static settings (limits, start-up
+ * mode, process fault actions, ...) to a file called "settings.bin" next to the app's
+ * "info.properties".  It holds the same values as the app's node in the config tree as generated
+ * from the .adef, but can be read through a memory mapping instead of a config tree transaction.
+ *
+ * Settings are looked up by their path relative to the app's node in the config tree, like
+ * "maxThreads" or "procs/myProc/maxFileBytes".
+ *
+ * Apps built by older tools don't have a settings blob, so callers must fall back to the config
+ * tree when there isn't one, or when a setting is missing from it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+#ifndef LEGATO_SRC_APP_SETTINGS_INCLUDE_GUARD
+#define LEGATO_SRC_APP_SETTINGS_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a loaded settings blob.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct appSettings_Blob* appSettings_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the settings blob module.  Must be called before any other function in this API.
+ */
+//--------------------------------------------------------------------------------------------------
+void appSettings_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads an application's settings blob.
+ *
+ * @return
+ *      Reference to the settings blob.
+ *      NULL if the app doesn't have a settings blob or it is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+appSettings_Ref_t appSettings_Load
+(
+    const char* installDirPath      ///< [IN] Path to the app's install directory.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unloads a settings blob.
+ */
+//--------------------------------------------------------------------------------------------------
+void appSettings_Unload
+(
+    appSettings_Ref_t settingsRef   ///< [IN] Settings blob to unload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an integer setting.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not an integer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetInt
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    int64_t* valuePtr               ///< [OUT] Value of the setting.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a boolean setting.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not a boolean.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetBool
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    bool* valuePtr                  ///< [OUT] Value of the setting.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a string setting.  The string is in the blob's memory mapping, so it remains valid until
+ * the blob is unloaded.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the setting is not in the blob.
+ *      LE_FORMAT_ERROR if the setting is not a string.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t appSettings_GetString
+(
+    appSettings_Ref_t settingsRef,  ///< [IN] Settings blob.
+    const char* keyPtr,             ///< [IN] Path of the setting relative to the app's node.
+    const char** valuePtrPtr        ///< [OUT] Value of the setting.
+);
+
+
+#endif  // LEGATO_SRC_APP_SETTINGS_INCLUDE_GUARD
@@ -63,6 +63,7 @@
 #include "legato.h"
 #include "apps.h"
 #include "app.h"
+#include "proc.h"
 #include "interfaces.h"
 #include "limit.h"
 #include "wait.h"
@@ -73,6 +74,8 @@
 #include "cgroups.h"
 #include "file.h"
 #include "installer.h"
+#include "bootTrace.h"
+#include "usageHistory.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -174,8 +177,12 @@ typedef struct AppContainer
                                           ///< this app. NULL if not connected client.
     le_appCtrl_TraceAttachHandlerFunc_t traceAttachHandler; ///< Client's trace attach handler.
     void* traceAttachContextPtr;          ///< Context for the client's trace attach handler.
+    int32_t traceSysCalls[LE_APPCTRL_MAX_TRACE_SYS_CALLS]; ///< System calls that stop the tracer.
     le_timer_Ref_t CheckAppStopTimer;     ///< Timer for waiting APP stop
     int AppStopTryCount;                  ///< Counter number for retrying to mark the stopped APP
+    FaultAction_t pendingFaultAction;     ///< Fault action for the app's processes that have died
+                                          ///< since the faults were last handled.
+    le_dls_Link_t faultLink;              ///< Link in the list of apps with pending faults.
 }
 AppContainer_t;
 
@@ -220,6 +227,14 @@ static le_dls_List_t ActiveAppsList = LE_DLS_LIST_INIT;
 static le_dls_List_t InactiveAppsList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the app containers with fault actions pending (see apps_HandlePendingFaults()).
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t FaultedAppsList = LE_DLS_LIST_INIT;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Application Process object container.
@@ -250,6 +265,69 @@ static le_mem_PoolRef_t AppProcContainerPool;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t AppProcMap;
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The maximum number of apps that are auto-started in one go, before the Supervisor goes back to
+ * its event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AUTO_START_BATCH_SIZE               8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An app waiting to be auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;                           ///< Link in the auto-start list.
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; ///< Name of the app.
+    size_t          serverCount;                    ///< Number of apps waiting to be auto-started
+                                                    ///  that this app has client bindings to.
+    le_sls_List_t   clientList;                     ///< Apps waiting on this app to be started.
+}
+AutoStartApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An entry in an auto-start app's list of the apps that are waiting for it to be started.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t   link;                           ///< Link in the server app's client list.
+    AutoStartApp_t* clientPtr;                      ///< The client app.
+}
+AutoStartClient_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools for the auto-start apps and their client list entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AutoStartAppPool;
+static le_mem_PoolRef_t AutoStartClientPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apps waiting to be auto-started, in the order they are listed in the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t AutoStartList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * When the auto-start of the apps began.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t AutoStartTime;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Timeout value for waiting processes to exit for an app.
@@ -373,6 +451,9 @@ static void DeactivateAppContainer
 
     LE_INFO("Application '%s' has stopped.", app_GetName(appContainerPtr->appRef));
 
+    // The app isn't being restarted, so don't keep its sandbox's SMACK rules.
+    app_ReleaseSandbox(appContainerPtr->appRef);
+
     appContainerPtr->stopHandler = NULL;
 
     le_dls_Queue(&InactiveAppsList, &(appContainerPtr->link));
@@ -536,13 +617,23 @@ static AppContainer_t* GetActiveAppWithProc
     pid_t pid
 )
 {
+    // Running processes are indexed by PID, so only the app the process is part of needs to be
+    // looked for, rather than the process in every app.
+    proc_Ref_t procRef = proc_FindByPID(pid);
+
+    if (procRef == NULL)
+    {
+        return NULL;
+    }
+
+    app_Ref_t appRef = proc_GetApp(procRef);
     le_dls_Link_t* appLinkPtr = le_dls_Peek(&ActiveAppsList);
 
     while (appLinkPtr != NULL)
     {
         AppContainer_t* appContainerPtr = CONTAINER_OF(appLinkPtr, AppContainer_t, link);
 
-        if (app_HasTopLevelProc(appContainerPtr->appRef, pid))
+        if (appContainerPtr->appRef == appRef)
         {
             return appContainerPtr;
         }
@@ -632,6 +723,8 @@ static le_result_t CreateApp
     containerPtr->traceAttachContextPtr = NULL;
     containerPtr->CheckAppStopTimer = NULL;
     containerPtr->AppStopTryCount = 0;
+    containerPtr->pendingFaultAction = FAULT_ACTION_NONE;
+    containerPtr->faultLink = LE_DLS_LINK_INIT;
 
     // Add this app to the inactive list.
     le_dls_Queue(&InactiveAppsList, &(containerPtr->link));
@@ -750,15 +843,252 @@ static le_result_t LaunchApp
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handle application fault.  Gets the application fault action for the process that terminated
- * and handle the fault.
+ * Gets an app from the auto-start list.
  *
  * @return
- *      LE_OK if the fault was handled.
- *      LE_FAULT if the fault could not be handled.
+ *      A pointer to the app, or NULL if the app isn't waiting to be auto-started.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t HandleAppFault
+static AutoStartApp_t* GetAutoStartApp
+(
+    const char* appNamePtr      ///< [IN] Name of the application.
+)
+{
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&AutoStartList);
+
+    while (appLinkPtr != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        if (strcmp(appPtr->name, appNamePtr) == 0)
+        {
+            return appPtr;
+        }
+
+        appLinkPtr = le_dls_PeekNext(&AutoStartList, appLinkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that an auto-start app has to be started after an app that it has bindings to.  Nothing
+ * is recorded if the server app isn't being auto-started, or is the client app itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddAutoStartDependency
+(
+    AutoStartApp_t* clientPtr,  ///< [IN] The client app.
+    const char* serverNamePtr   ///< [IN] Name of the app the client binds to.
+)
+{
+    AutoStartApp_t* serverPtr = GetAutoStartApp(serverNamePtr);
+
+    if ((serverPtr == NULL) || (serverPtr == clientPtr))
+    {
+        return;
+    }
+
+    // Apps often have several bindings to the same server, only count the server once.
+    le_sls_Link_t* linkPtr = le_sls_Peek(&serverPtr->clientList);
+
+    while (linkPtr != NULL)
+    {
+        if (CONTAINER_OF(linkPtr, AutoStartClient_t, link)->clientPtr == clientPtr)
+        {
+            return;
+        }
+
+        linkPtr = le_sls_PeekNext(&serverPtr->clientList, linkPtr);
+    }
+
+    AutoStartClient_t* entryPtr = le_mem_ForceAlloc(AutoStartClientPool);
+
+    entryPtr->link = LE_SLS_LINK_INIT;
+    entryPtr->clientPtr = clientPtr;
+
+    le_sls_Queue(&serverPtr->clientList, &entryPtr->link);
+    clientPtr->serverCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an auto-start app's bindings from the config tree, and records which of the other
+ * auto-start apps it has to be started after.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadAutoStartDependencies
+(
+    AutoStartApp_t* appPtr      ///< [IN] The app.
+)
+{
+    le_cfg_IteratorRef_t bindCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
+
+    le_cfg_GoToNode(bindCfg, appPtr->name);
+    le_cfg_GoToNode(bindCfg, "bindings");
+
+    if (le_cfg_GoToFirstChild(bindCfg) == LE_OK)
+    {
+        do
+        {
+            char serverName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if (   (le_cfg_GetString(bindCfg, "app", serverName, sizeof(serverName), "") == LE_OK)
+                && (serverName[0] != '\0'))
+            {
+                AddAutoStartDependency(appPtr, serverName);
+            }
+        }
+        while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(bindCfg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes an app from the auto-start list, and releases it and its client list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteAutoStartApp
+(
+    AutoStartApp_t* appPtr      ///< [IN] The app.
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&appPtr->clientList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, AutoStartClient_t, link));
+    }
+
+    le_dls_Remove(&AutoStartList, &appPtr->link);
+    le_mem_Release(appPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Launches an auto-start app, and removes it from the auto-start list.  The apps that were
+ * waiting on it are released to be started.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LaunchAutoStartApp
+(
+    AutoStartApp_t* appPtr      ///< [IN] The app.
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    // No need to check the return code because there is nothing we can do about errors.  The
+    // app's clients are started either way.
+    LaunchApp(appPtr->name);
+
+    bootTrace_Record(getpid(), "app", appPtr->name, startTime);
+
+    le_sls_Link_t* linkPtr = le_sls_Peek(&appPtr->clientList);
+
+    while (linkPtr != NULL)
+    {
+        CONTAINER_OF(linkPtr, AutoStartClient_t, link)->clientPtr->serverCount--;
+
+        linkPtr = le_sls_PeekNext(&appPtr->clientList, linkPtr);
+    }
+
+    DeleteAutoStartApp(appPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Launches the next batch of auto-start apps.  The apps that aren't waiting for any server app
+ * are launched, in config tree order, up to AUTO_START_BATCH_SIZE of them.  The apps they release
+ * are launched in a later batch.  The Supervisor's event loop runs between batches, so that it
+ * keeps handling events while a large number of apps are being started.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LaunchAutoStartBatch
+(
+    void* param1Ptr,            ///< [IN] Not used.
+    void* param2Ptr             ///< [IN] Not used.
+)
+{
+    AutoStartApp_t* batch[AUTO_START_BATCH_SIZE];
+    size_t batchCount = 0;
+
+    // Pick the batch before launching any of it, so none of the apps released by this batch are
+    // launched until the next one.
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&AutoStartList);
+
+    while ((appLinkPtr != NULL) && (batchCount < AUTO_START_BATCH_SIZE))
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        if (appPtr->serverCount == 0)
+        {
+            batch[batchCount++] = appPtr;
+        }
+
+        appLinkPtr = le_dls_PeekNext(&AutoStartList, appLinkPtr);
+    }
+
+    // If all of the remaining apps are waiting on each other, their bindings form a loop.  Break it
+    // by launching the first of them.
+    if ((batchCount == 0) && (le_dls_IsEmpty(&AutoStartList) == false))
+    {
+        batch[batchCount++] = CONTAINER_OF(le_dls_Peek(&AutoStartList), AutoStartApp_t, link);
+
+        LE_WARN("Apps have circular bindings, starting '%s' before the apps it binds to.",
+                batch[0]->name);
+    }
+
+    for (size_t i = 0; i < batchCount; i++)
+    {
+        LaunchAutoStartApp(batch[i]);
+    }
+
+    if (le_dls_IsEmpty(&AutoStartList) == false)
+    {
+        le_event_QueueFunction(LaunchAutoStartBatch, NULL, NULL);
+    }
+    else
+    {
+        bootTrace_Record(getpid(), "phase", "apps_AutoStart", AutoStartTime);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancels the auto-start of the apps that haven't been launched yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelAutoStart
+(
+    void
+)
+{
+    le_dls_Link_t* appLinkPtr;
+
+    while ((appLinkPtr = le_dls_Peek(&AutoStartList)) != NULL)
+    {
+        DeleteAutoStartApp(CONTAINER_OF(appLinkPtr, AutoStartApp_t, link));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the fault action for a process of an app that terminated, to be taken by
+ * apps_HandlePendingFaults() along with those of any other processes of the app that terminated at
+ * the same time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordAppFault
 (
     AppContainer_t* appContainerPtr,    ///< [IN] Application container reference.
     pid_t procPid,                      ///< [IN] Pid of the process that changed state.
@@ -770,6 +1100,45 @@ static le_result_t HandleAppFault
 
     app_SigChildHandler(appContainerPtr->appRef, procPid, procExitStatus, &faultAction);
 
+    if (faultAction == FAULT_ACTION_IGNORE)
+    {
+        return;
+    }
+
+    // Keep the action that would have won had they been taken one after the other: a reboot
+    // overrides everything, and an app that is both stopped and restarted ends up restarted.
+    FaultAction_t pendingAction = appContainerPtr->pendingFaultAction;
+
+    if (   (pendingAction == FAULT_ACTION_REBOOT)
+        || ((pendingAction == FAULT_ACTION_RESTART_APP) && (faultAction == FAULT_ACTION_STOP_APP)))
+    {
+        faultAction = pendingAction;
+    }
+
+    appContainerPtr->pendingFaultAction = faultAction;
+
+    if (!le_dls_IsInList(&FaultedAppsList, &(appContainerPtr->faultLink)))
+    {
+        le_dls_Queue(&FaultedAppsList, &(appContainerPtr->faultLink));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle application fault.
+ *
+ * @return
+ *      LE_OK if the fault was handled.
+ *      LE_FAULT if the fault could not be handled.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HandleAppFault
+(
+    AppContainer_t* appContainerPtr,    ///< [IN] Application container reference.
+    FaultAction_t faultAction           ///< [IN] Fault action to take.
+)
+{
     // Handle the fault.
     switch (faultAction)
     {
@@ -848,6 +1217,47 @@ static void DeletesInactiveApp
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the usage history of an app that has been uninstalled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ForgetAppUsage
+(
+    const char* appName,  ///< App being removed.
+    void* contextPtr      ///< Context for this function.  Not used.
+)
+{
+    usageHist_Forget(appName);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a usage sample of every running app.  Called by the usage sampling timer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleAppUsage
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&ActiveAppsList);
+
+    while (appLinkPtr != NULL)
+    {
+        AppContainer_t* appContainerPtr = CONTAINER_OF(appLinkPtr, AppContainer_t, link);
+
+        if (app_GetState(appContainerPtr->appRef) == APP_STATE_RUNNING)
+        {
+            usageHist_Sample(app_GetName(appContainerPtr->appRef));
+        }
+
+        appLinkPtr = le_dls_PeekNext(&ActiveAppsList, appLinkPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes all inactive app objects.
@@ -1198,6 +1608,7 @@ static void ReleaseAppRef
     app_SetRunForAllProcs(appContainerPtr->appRef, true);
     app_RemoveAllLinks(appContainerPtr->appRef);
     app_SetBlockCallback(appContainerPtr->appRef, NULL, NULL);
+    app_SetTraceSysCalls(appContainerPtr->appRef, NULL, 0);
 
     // Remove the safe ref.
     le_ref_DeleteRef(AppMap, appSafeRef);
@@ -1277,6 +1688,8 @@ void apps_Init
     // Create memory pools.
     AppContainerPool = le_mem_CreatePool("appContainers", sizeof(AppContainer_t));
     AppProcContainerPool = le_mem_CreatePool("appProcContainers", sizeof(AppProcContainer_t));
+    AutoStartAppPool = le_mem_CreatePool("autoStartApps", sizeof(AutoStartApp_t));
+    AutoStartClientPool = le_mem_CreatePool("autoStartClients", sizeof(AutoStartClient_t));
 
     AppProcMap = le_ref_CreateMap("AppProcs", 5);
     AppMap = le_ref_CreateMap("App", 5);
@@ -1284,6 +1697,18 @@ void apps_Init
 
     le_instStat_AddAppUninstallEventHandler(DeletesInactiveApp, NULL);
     le_instStat_AddAppInstallEventHandler(DeletesInactiveApp, NULL);
+    le_instStat_AddAppUninstallEventHandler(ForgetAppUsage, NULL);
+
+    // Sample the usage of the running apps on a coarse timer.
+    usageHist_Init();
+
+    le_timer_Ref_t usageTimer = le_timer_Create("AppUsageSampler");
+    le_clk_Time_t usageInterval = { .sec = USAGE_HIST_INTERVAL_SEC, .usec = 0 };
+
+    LE_ASSERT(le_timer_SetInterval(usageTimer, usageInterval) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(usageTimer, 0) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(usageTimer, SampleAppUsage) == LE_OK);
+    LE_ASSERT(le_timer_Start(usageTimer) == LE_OK);
 
     le_msg_AddServiceCloseHandler(le_appProc_GetServiceRef(), DeleteClientAppProcs, NULL);
 
@@ -1313,6 +1738,9 @@ void apps_Shutdown
     void
 )
 {
+    // Don't start any more apps.
+    CancelAutoStart();
+
     // Deletes all inactive apps first.
     DeletesAllInactiveApp();
 
@@ -1368,6 +1796,11 @@ void apps_SetShutdownHandler
 //--------------------------------------------------------------------------------------------------
 /**
  * Start all applications marked as 'auto' start.
+ *
+ * An app that has bindings to other auto-start apps is started after those apps, so that their
+ * services are already being offered when it starts.  Otherwise, apps are started in the order
+ * they are listed in the config tree.  The apps are launched in batches from the event loop, so
+ * this returns before all of them have been launched.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
@@ -1375,6 +1808,8 @@ void apps_AutoStart
     void
 )
 {
+    AutoStartTime = le_clk_GetRelativeTime();
+
     // Read the list of applications from the config tree.
     le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
 
@@ -1401,17 +1836,36 @@ void apps_AutoStart
                          "Max app name in bytes, %d.  Application not launched.",
                          appName, LIMIT_MAX_APP_NAME_BYTES);
             }
-            else
+            else if (GetAutoStartApp(appName) == NULL)
             {
-                // Launch the application now.  No need to check the return code because there is
-                // nothing we can do about errors.
-                LaunchApp(appName);
+                // Add the application to the list of apps to launch.
+                AutoStartApp_t* appPtr = le_mem_ForceAlloc(AutoStartAppPool);
+
+                appPtr->link = LE_DLS_LINK_INIT;
+                LE_ASSERT(le_utf8_Copy(appPtr->name, appName, sizeof(appPtr->name), NULL) == LE_OK);
+                appPtr->serverCount = 0;
+                appPtr->clientList = LE_SLS_LIST_INIT;
+
+                le_dls_Queue(&AutoStartList, &appPtr->link);
             }
         }
     }
     while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
 
     le_cfg_CancelTxn(appCfg);
+
+    // Now that all of the apps are known, work out which of them have to wait for the others.
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&AutoStartList);
+
+    while (appLinkPtr != NULL)
+    {
+        ReadAutoStartDependencies(CONTAINER_OF(appLinkPtr, AutoStartApp_t, link));
+
+        appLinkPtr = le_dls_PeekNext(&AutoStartList, appLinkPtr);
+    }
+
+    // Launch the first batch now, the rest follow from the event loop.
+    LaunchAutoStartBatch(NULL, NULL);
 }
 
 
@@ -1425,11 +1879,10 @@ void apps_AutoStart
  *      otherwise the child will be reaped by the Supervisor's SIGCHILD handler.
  *
  * @return
- *      LE_OK if the signal was handled without incident.
+ *      LE_OK if the child was reaped.  Any fault action it calls for is taken by
+ *      apps_HandlePendingFaults().
  *      LE_NOT_FOUND if the pid is not a configured application process.  The child will not be
  *      reaped.
- *      LE_FAULT if the signal indicates a failure of one of the applications which requires a
- *               system restart.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t apps_SigChildHandler
@@ -1448,8 +1901,48 @@ le_result_t apps_SigChildHandler
     // Reap the child now.
     int status = wait_ReapChild(pid);
 
-    // Handle any faults that the child process state change my have caused.
-    return HandleAppFault(appContainerPtr, pid, status);
+    // Record any faults that the child process state change my have caused.  They are handled
+    // once all of the children that have changed state have been reaped.
+    RecordAppFault(appContainerPtr, pid, status);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes the fault actions recorded by apps_SigChildHandler().  Each app's action is only taken
+ * once, however many of its processes faulted.  This should be called from the Supervisor's
+ * SIGCHILD handler, once it has called apps_SigChildHandler() for all of the children that have
+ * changed state.
+ *
+ * @return
+ *      LE_OK if the faults were handled.
+ *      LE_FAULT if one of the faults requires a system restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t apps_HandlePendingFaults
+(
+    void
+)
+{
+    le_result_t result = LE_OK;
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&FaultedAppsList)) != NULL)
+    {
+        AppContainer_t* appContainerPtr = CONTAINER_OF(linkPtr, AppContainer_t, faultLink);
+        FaultAction_t faultAction = appContainerPtr->pendingFaultAction;
+
+        appContainerPtr->pendingFaultAction = FAULT_ACTION_NONE;
+
+        if (HandleAppFault(appContainerPtr, faultAction) != LE_OK)
+        {
+            result = LE_FAULT;
+        }
+    }
+
+    return result;
 }
 
 
@@ -2005,6 +2498,48 @@ void le_appCtrl_TraceUnblock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the system calls that stop the app's traced processes.  Must be called before the app is
+ * started, and only has an effect on the processes that are blocked for a Trace Attach Handler.
+ *
+ * @note If the caller is passing an invalid reference to the app, it is a fatal error,
+ *       the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_appCtrl_SetTraceSysCalls
+(
+    le_appCtrl_ServerCmdRef_t _cmdRef,
+    le_appCtrl_AppRef_t appRef,
+    const int32_t* sysCallsPtr,
+    size_t sysCallsSize
+)
+{
+    AppContainer_t* appContainerPtr = le_ref_Lookup(AppMap, appRef);
+
+    if (appContainerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid application reference.");
+        return;
+    }
+
+    if (sysCallsSize > NUM_ARRAY_MEMBERS(appContainerPtr->traceSysCalls))
+    {
+        LE_KILL_CLIENT("Too many system calls (%zu).", sysCallsSize);
+        return;
+    }
+
+    // Keep a copy, as the processes only refer to the list.
+    memcpy(appContainerPtr->traceSysCalls, sysCallsPtr, sysCallsSize * sizeof(int32_t));
+
+    app_SetTraceSysCalls(appContainerPtr->appRef,
+                         (sysCallsSize > 0) ? appContainerPtr->traceSysCalls : NULL,
+                         sysCallsSize);
+
+    le_appCtrl_SetTraceSysCallsRespond(_cmdRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts an app.  This function is called by the event loop when a separate process requests to
@@ -2350,6 +2885,192 @@ le_result_t le_appInfo_GetHash
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the recent history of the CPU and memory used by an application, oldest sample first.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if there are no samples for the application.
+ *
+ * @note If the application name pointer is null or if its string is empty or of bad format it is a
+ *       fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_appInfo_GetUsageHistory
+(
+    const char* appName,
+        ///< [IN]
+        ///< Application name.
+
+    uint32_t* sampleTimePtr,
+        ///< [OUT]
+        ///< Time of each sample, in seconds since boot.
+
+    size_t* sampleTimeNumElementsPtr,
+        ///< [INOUT]
+
+    uint32_t* cpuPermillePtr,
+        ///< [OUT]
+        ///< CPU used since the previous sample, in tenths of a percent of one CPU.
+
+    size_t* cpuPermilleNumElementsPtr,
+        ///< [INOUT]
+
+    uint64_t* memUsedPtr,
+        ///< [OUT]
+        ///< Memory used, in bytes.
+
+    size_t* memUsedNumElementsPtr
+        ///< [INOUT]
+)
+{
+    if (!IsAppNameValid(appName))
+    {
+        LE_KILL_CLIENT("Invalid app name.");
+        return LE_NOT_FOUND;
+    }
+
+    size_t numSamples = *sampleTimeNumElementsPtr;
+
+    if (*cpuPermilleNumElementsPtr < numSamples)
+    {
+        numSamples = *cpuPermilleNumElementsPtr;
+    }
+
+    if (*memUsedNumElementsPtr < numSamples)
+    {
+        numSamples = *memUsedNumElementsPtr;
+    }
+
+    le_result_t result = usageHist_Get(appName, sampleTimePtr, cpuPermillePtr, memUsedPtr,
+                                       &numSamples);
+
+    *sampleTimeNumElementsPtr = numSamples;
+    *cpuPermilleNumElementsPtr = numSamples;
+    *memUsedNumElementsPtr = numSamples;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a snapshot line for an installed application, and for each of its processes if it is
+ * active.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteAppSnapshot
+(
+    const char* appNamePtr,         ///< [IN] Name of the application.
+    FILE* filePtr                   ///< [IN] Snapshot file to write to.
+)
+{
+    AppContainer_t* appContainerPtr = GetActiveApp(appNamePtr);
+
+    if (appContainerPtr == NULL)
+    {
+        fprintf(filePtr, "app %s stopped -1\n", appNamePtr);
+        return;
+    }
+
+    app_Ref_t appRef = appContainerPtr->appRef;
+    bool isRunning = (app_GetState(appRef) == APP_STATE_RUNNING);
+    ssize_t memUsed = isRunning ? cgrp_GetMemUsed(appNamePtr) : -1;
+
+    fprintf(filePtr, "app %s %s %zd\n",
+            appNamePtr,
+            isRunning ? "running" : "stopped",
+            (memUsed < 0) ? (ssize_t)-1 : memUsed);
+
+    app_WriteProcSnapshot(appRef, filePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a snapshot of all installed applications and their processes.  See le_appInfo.api for the
+ * format of the snapshot.
+ *
+ * @return
+ *      LE_OK if the snapshot was taken.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_appInfo_GetSnapshot
+(
+    int* snapshotFdPtr
+        ///< [OUT]
+        ///< File holding the snapshot.
+)
+{
+    if (snapshotFdPtr == NULL)
+    {
+        LE_KILL_CLIENT("snapshotFdPtr is NULL.");
+        return LE_FAULT;
+    }
+
+    *snapshotFdPtr = -1;
+
+    // The file is unlinked, so it goes away once the client closes it.
+    FILE* filePtr = tmpfile();
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Could not create snapshot file.  %m.");
+        return LE_FAULT;
+    }
+
+    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
+
+    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    {
+        do
+        {
+            char appName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if (le_cfg_GetNodeName(appCfg, "", appName, sizeof(appName)) == LE_OK)
+            {
+                WriteAppSnapshot(appName, filePtr);
+            }
+        }
+        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(appCfg);
+
+    le_result_t result = LE_FAULT;
+
+    if ((fflush(filePtr) == 0) && (ferror(filePtr) == 0))
+    {
+        int fd = dup(fileno(filePtr));
+
+        if ((fd != -1) && (lseek(fd, 0, SEEK_SET) == 0))
+        {
+            *snapshotFdPtr = fd;
+            result = LE_OK;
+        }
+        else
+        {
+            LE_ERROR("Could not prepare snapshot file.  %m.");
+
+            if (fd != -1)
+            {
+                close(fd);
+            }
+        }
+    }
+    else
+    {
+        LE_ERROR("Could not write snapshot file.  %m.");
+    }
+
+    fclose(filePtr);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * A watchdog has timed out. This function determines the watchdogAction to take and applies it.
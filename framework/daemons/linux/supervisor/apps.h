@@ -76,10 +76,9 @@ void apps_SetShutdownHandler
  *      child will remain unreaped.
  *
  * @return
- *      LE_OK if the signal was handled without incident.
+ *      LE_OK if the child was reaped.  Any fault action it calls for is taken by
+ *      apps_HandlePendingFaults().
  *      LE_NOT_FOUND if the pid is not an application process.  The child will not be reaped.
- *      LE_FAULT if the signal indicates a failure of one of the applications which requires a
- *               system restart.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t apps_SigChildHandler
@@ -88,6 +87,24 @@ le_result_t apps_SigChildHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes the fault actions recorded by apps_SigChildHandler().  Each app's action is only taken
+ * once, however many of its processes faulted.  This should be called from the Supervisor's
+ * SIGCHILD handler, once it has called apps_SigChildHandler() for all of the children that have
+ * changed state.
+ *
+ * @return
+ *      LE_OK if the faults were handled.
+ *      LE_FAULT if one of the faults requires a system restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t apps_HandlePendingFaults
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Verify that all devices in our sandboxed applications match with the device outside the sandbox.
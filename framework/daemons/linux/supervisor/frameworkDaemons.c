@@ -14,6 +14,7 @@
 #include "smack.h"
 #include "sysPaths.h"
 #include "wait.h"
+#include "bootTrace.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -101,6 +102,7 @@ static void LoadIpcBindingConfig
     void
 )
 {
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
 
     // Fork a process.
     pid_t pid = fork();
@@ -153,6 +155,8 @@ static void LoadIpcBindingConfig
         LE_FATAL("Couldn't load IPC binding config. `sdir load` failed for an unknown reason (status = %d).",
             status);
     }
+
+    bootTrace_Record(getpid(), "phase", "LoadIpcBindingConfig", startTime);
 }
 
 
@@ -211,6 +215,7 @@ static void StartDaemon
 )
 {
     const char* daemonNamePtr = le_path_GetBasenamePtr(daemonPtr->path, "/");
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
 
     // Create a synchronization pipe.
     int syncPipeFd[2];
@@ -291,6 +296,8 @@ static void StartDaemon
     fd_Close(syncPipeFd[0]);
 
     LE_INFO("Started system process '%s' with PID: %d.", daemonNamePtr, pid);
+
+    bootTrace_Record(pid, "daemon", daemonNamePtr, startTime);
 }
 
 
@@ -13,6 +13,7 @@
 #include "kernelModules.h"
 #include "le_cfg_interface.h"
 #include "supervisor.h"
+#include "bootTrace.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -51,7 +52,8 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Module insert command and format, arguments are module path and module params
+ * Module insert command and format, arguments are module path and module params.
+ * Only used if the finit_module() system call can't be.
  */
 //--------------------------------------------------------------------------------------------------
 #define INSMOD_COMMAND "/sbin/insmod"
@@ -60,7 +62,25 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Module remove command and format, argument is module name
+ * Size of the buffer used to pass a module's parameters to finit_module().  Modules with longer
+ * parameter lists are handed to insmod instead.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KMODULE_MAX_PARAMS_BYTES 4096
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of independent modules that are loaded at the same time during start-up.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KMODULE_MAX_PARALLEL_LOADS 4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Module remove command and format, argument is module name.
+ * Only used if the delete_module() system call can't be.
  */
 //--------------------------------------------------------------------------------------------------
 #define RMMOD_COMMAND "/sbin/rmmod"
@@ -100,6 +120,7 @@ typedef struct
     bool               isOptional;                           // is the module required or optional
     le_dls_Link_t      dependencyLink;                       // link object for dependency list
     le_dls_Link_t      alphabeticalLink;                     // link object for alphabetical list
+    le_dls_Link_t      pendingLink;                          // link object for start-up list
     le_sls_Link_t      cyclicDepLink;                        // link object for cyclic dep list
     uint32_t           useCount;                             // Counter of usage, safe to remove
                                                              // module when counter is 0
@@ -751,6 +772,7 @@ static void ModuleInsert(char *modName)
     m->isOptional = false;
     m->dependencyLink = LE_DLS_LINK_INIT;
     m->alphabeticalLink = LE_DLS_LINK_INIT;
+    m->pendingLink = LE_DLS_LINK_INIT;
     m->isRequiredModule = false;
     m->isCyclicDependency = false;
     m->visited = false;
@@ -848,6 +870,206 @@ static le_result_t TraverseDependencyInsert
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load a kernel module's .ko file directly with the finit_module() system call.
+ *
+ * Does not use any Legato API other than logging, so it is safe to call from a worker thread.
+ *
+ * @return
+ *      - LE_OK if the module is loaded (or was already loaded).
+ *      - LE_UNSUPPORTED if finit_module() can't be used for this module; use insmod instead.
+ *      - LE_FAULT if the kernel refused the module.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadModuleFile(KModuleObj_t *mod)
+{
+#ifdef SYS_finit_module
+    char params[KMODULE_MAX_PARAMS_BYTES] = "";
+    size_t length = 0;
+    int i;
+    int fd;
+    int rc;
+
+    /* The kernel expects the "<name>=<value>" parameters in one space separated string */
+    for (i = 2; i < mod->argc; i++)
+    {
+        int n = snprintf(params + length, sizeof(params) - length, "%s%s",
+                         (length > 0) ? " " : "", mod->argv[i]);
+        if ((n < 0) || ((size_t)n >= sizeof(params) - length))
+        {
+            LE_DEBUG("Parameters of module '%s' too long for finit_module()", mod->name);
+            return LE_UNSUPPORTED;
+        }
+        length += n;
+    }
+
+    fd = open(mod->path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        LE_CRIT("Failed to open module file '%s'. (%m)", mod->path);
+        return LE_FAULT;
+    }
+
+    rc = syscall(SYS_finit_module, fd, params, 0);
+    int err = errno;
+    fd_Close(fd);
+
+    if (rc == 0)
+    {
+        return LE_OK;
+    }
+
+    errno = err;
+    switch (err)
+    {
+        case EEXIST:
+            LE_INFO("Module '%s' is already loaded.", mod->name);
+            return LE_OK;
+
+        case ENOSYS:
+            return LE_UNSUPPORTED;
+
+        default:
+            LE_CRIT("Failed to load module '%s'. (%m)", mod->name);
+            return LE_FAULT;
+    }
+#else
+    (void)mod;
+    return LE_UNSUPPORTED;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread main function that loads one kernel module during start-up.
+ *
+ * @return The le_result_t of LoadModuleFile(), cast to a pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LoadModuleThread(void* contextPtr)
+{
+    return (void*)(intptr_t)LoadModuleFile(contextPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load a kernel module with insmod.  Only used when finit_module() can't be.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExecuteInsmod(KModuleObj_t *mod)
+{
+    mod->argv[0] = INSMOD_COMMAND;
+    return ExecuteCommand(mod->argv, mod->argc);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install a kernel module by running its install script, and check that it came up.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RunInstallScript(KModuleObj_t *mod)
+{
+    char *scriptargv[3];
+    ModuleLoadStatus_t loadStatusProcMod;
+
+    scriptargv[0] =  mod->installScript;
+    scriptargv[1] =  mod->path;
+    scriptargv[2] =  NULL;
+
+    if (ExecuteCommand(scriptargv, 2) != LE_OK)
+    {
+        LE_CRIT("Install script '%s' execution failed", mod->installScript);
+        return LE_FAULT;
+    }
+
+    /* Read module load status from /proc/modules */
+    loadStatusProcMod =  CheckProcModules(mod->name);
+    if (loadStatusProcMod != STATUS_INSTALLED)
+    {
+        LE_INFO("Module '%s' not in 'Live' state, wait for 10 seconds.", mod->name);
+        sleep(10);
+
+        /* If the module is not in live state, wait for 10 seconds to see if the
+         * module recovers to live state, otherwise restart the system.
+         */
+        if (loadStatusProcMod != STATUS_INSTALLED)
+        {
+            LE_CRIT("Module '%s' not in 'Live' state.", mod->name);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the outcome of an attempt to install a kernel module.
+ *
+ * @return LE_OK if the module was installed or is optional, otherwise the failed result.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompleteInstall
+(
+    KModuleObj_t *mod,
+    le_result_t result,
+    le_clk_Time_t startTime
+)
+{
+    if (result != LE_OK)
+    {
+        if (mod->isOptional)
+        {
+            LE_INFO("Ignoring failure. "
+                     "Module '%s' failed to load and is an optional module.", mod->name);
+            return LE_OK;
+        }
+        LE_CRIT("Module '%s' failed to load.", mod->name);
+        return result;
+    }
+
+    mod->moduleLoadStatus = STATUS_INSTALLED;
+    LE_INFO("New kernel module '%s'", mod->name);
+
+    bootTrace_Record(getpid(), "kernelModule", mod->name, startTime);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install a single kernel module whose dependencies are already installed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t InstallModule(KModuleObj_t *mod)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    le_result_t result;
+
+    /* If install script is provided, execute the script otherwise load the module */
+    if (strcmp(mod->installScript, "") != 0)
+    {
+        result = RunInstallScript(mod);
+    }
+    else
+    {
+        result = LoadModuleFile(mod);
+        if (result == LE_UNSUPPORTED)
+        {
+            result = ExecuteInsmod(mod);
+        }
+    }
+
+    return CompleteInstall(mod, result, startTime);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * insmod the kernel module
@@ -860,9 +1082,6 @@ static le_result_t InstallEachKernelModule(KModuleObj_t *m, bool enableUseCount)
     /* The ordered list of required kernel modules to install */
     le_dls_List_t ModuleInsertList = LE_DLS_LIST_INIT;
 
-    ModuleLoadStatus_t loadStatusProcMod;
-    char *scriptargv[3];
-
     result = TraverseDependencyInsert(&ModuleInsertList, m, enableUseCount);
     if (result != LE_OK)
     {
@@ -887,69 +1106,11 @@ static le_result_t InstallEachKernelModule(KModuleObj_t *m, bool enableUseCount)
 
         if (mod->moduleLoadStatus != STATUS_INSTALLED)
         {
-            /* If install script is provided, execute the script otherwise execute insmod */
-            if (strcmp(mod->installScript, "") != 0)
-            {
-                scriptargv[0] =  mod->installScript;
-                scriptargv[1] =  mod->path;
-                scriptargv[2] =  NULL;
-
-                result = ExecuteCommand(scriptargv, 2);
-                if (result != LE_OK)
-                {
-                    LE_CRIT("Install script '%s' execution failed", mod->installScript);
-
-                    if (mod->isOptional)
-                    {
-                        continue;
-                    }
-                    return result;
-                }
-
-                /* Read module load status from /proc/modules */
-                loadStatusProcMod =  CheckProcModules(mod->name);
-                if (loadStatusProcMod != STATUS_INSTALLED)
-                {
-                    LE_INFO("Module '%s' not in 'Live' state, wait for 10 seconds.", mod->name);
-                    sleep(10);
-
-                    /* If the module is not in live state, wait for 10 seconds to see if the
-                     * module recovers to live state, otherwise restart the system.
-                     */
-                    if (loadStatusProcMod != STATUS_INSTALLED)
-                    {
-                        if (mod->isOptional)
-                        {
-                            LE_INFO(
-                                "Module '%s' not in 'Live' state and is optional. "
-                                "Skip restarting system.",
-                                mod->name);
-                            continue;
-                        }
-
-                        LE_CRIT("Module '%s' not in 'Live' state. Restart system ...", mod->name);
-                        return LE_FAULT;
-                    }
-                }
-            }
-            else
+            result = InstallModule(mod);
+            if (result != LE_OK)
             {
-                mod->argv[0] = INSMOD_COMMAND;
-                result = ExecuteCommand(mod->argv, mod->argc);
-                if (result != LE_OK)
-                {
-                    if (mod->isOptional)
-                    {
-                        LE_INFO("Ignoring failure. "
-                                 "Module '%s' failed to load and is an optional module.", mod->name);
-                        continue;
-                    }
-                    return result;
-                }
+                return result;
             }
-
-            mod->moduleLoadStatus = STATUS_INSTALLED;
-            LE_INFO("New kernel module '%s'", mod->name);
         }
     }
     return LE_OK;
@@ -1039,9 +1200,103 @@ static void setIsRequiredModule()
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether all of a module's required modules are out of the start-up pending list, so the
+ * module can be loaded now.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsModuleReady(KModuleObj_t *m, le_dls_List_t *pendingListPtr)
+{
+    le_sls_Link_t* modNameLinkPtr = le_sls_Peek(&(m->reqModuleName));
+
+    while (modNameLinkPtr != NULL)
+    {
+        ModNameNode_t* modNameNodePtr = CONTAINER_OF(modNameLinkPtr, ModNameNode_t, link);
+        KModuleObj_t* reqModPtr = le_hashmap_Get(KModuleHandler.moduleTable,
+                                                 modNameNodePtr->modName);
+
+        if ((reqModPtr != NULL) && le_dls_IsInList(pendingListPtr, &(reqModPtr->pendingLink)))
+        {
+            return false;
+        }
+
+        modNameLinkPtr = le_sls_PeekNext(&(m->reqModuleName), modNameLinkPtr);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Install a batch of modules that don't depend on each other.  Modules loaded with finit_module()
+ * are loaded concurrently, each in its own worker thread, so that slow module init functions
+ * overlap.  Install scripts and insmod are run from the Supervisor's main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t InstallModuleBatch(KModuleObj_t *batch[], size_t count)
+{
+    le_thread_Ref_t threads[KMODULE_MAX_PARALLEL_LOADS] = {NULL};
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    le_result_t result = LE_OK;
+    size_t i;
+
+    if (count == 1)
+    {
+        return InstallModule(batch[0]);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (strcmp(batch[i]->installScript, "") == 0)
+        {
+            threads[i] = le_thread_Create(batch[i]->name, LoadModuleThread, batch[i]);
+            le_thread_SetJoinable(threads[i]);
+            le_thread_Start(threads[i]);
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        le_result_t loadResult;
+
+        if (threads[i] == NULL)
+        {
+            loadResult = RunInstallScript(batch[i]);
+        }
+        else
+        {
+            void* threadResultPtr;
+
+            LE_ASSERT_OK(le_thread_Join(threads[i], &threadResultPtr));
+            loadResult = (le_result_t)(intptr_t)threadResultPtr;
+
+            if (loadResult == LE_UNSUPPORTED)
+            {
+                loadResult = ExecuteInsmod(batch[i]);
+            }
+        }
+
+        /* Keep going so every thread is joined, but report the first failure. */
+        loadResult = CompleteInstall(batch[i], loadResult, startTime);
+        if (result == LE_OK)
+        {
+            result = loadResult;
+        }
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Iterate through the module table and install kernel module
+ *
+ * The dependencies of all automatically loaded modules are first resolved into a single pending
+ * list.  Modules are then loaded in rounds: each round takes up to KMODULE_MAX_PARALLEL_LOADS
+ * pending modules whose required modules have all been handled, and loads them concurrently.
  */
 //--------------------------------------------------------------------------------------------------
 static void installModules()
@@ -1049,6 +1304,7 @@ static void installModules()
     KModuleObj_t *modPtr;
     le_result_t result;
     le_dls_Link_t* linkPtr;
+    le_dls_List_t pendingList = LE_DLS_LIST_INIT;
 
     /* Traverse linked list in alphabetical order of module name and traverse dependencies. */
     linkPtr = le_dls_Peek(&ModuleAlphaOrderList);
@@ -1056,6 +1312,7 @@ static void installModules()
     {
         modPtr = CONTAINER_OF(linkPtr, KModuleObj_t, alphabeticalLink);
         LE_ASSERT(modPtr != NULL);
+        linkPtr = le_dls_PeekNext(&ModuleAlphaOrderList, linkPtr);
 
         /*
          * Skip if the modules are loaded manually via app or if it is a required module.
@@ -1064,19 +1321,80 @@ static void installModules()
          */
         if (modPtr->isLoadManual)
         {
-            linkPtr = le_dls_PeekNext(&ModuleAlphaOrderList, linkPtr);
             continue;
         }
 
-        result = InstallEachKernelModule(modPtr, true);
+        le_dls_List_t moduleInsertList = LE_DLS_LIST_INIT;
+        le_dls_Link_t* depLinkPtr;
+
+        result = TraverseDependencyInsert(&moduleInsertList, modPtr, true);
+
+        while ((depLinkPtr = le_dls_Pop(&moduleInsertList)) != NULL)
+        {
+            KModuleObj_t *mod = CONTAINER_OF(depLinkPtr, KModuleObj_t, dependencyLink);
+
+            if ((result == LE_OK) &&
+                (mod->moduleLoadStatus != STATUS_INSTALLED) &&
+                !le_dls_IsInList(&pendingList, &(mod->pendingLink)))
+            {
+                le_dls_Queue(&pendingList, &(mod->pendingLink));
+            }
+        }
+
         if (result != LE_OK)
         {
+            /* If the module is marked optional, ignore fault, otherwise take fault action. */
+            if (modPtr->isOptional)
+            {
+                LE_WARN("Traversing module '%s' dependencies failed, ignore as module is optional",
+                        modPtr->name);
+                continue;
+            }
+
             LE_ERROR("Error in installing module %s. Restarting system ...", modPtr->name);
             framework_Reboot();
-            break;
+            return;
         }
+    }
 
-        linkPtr = le_dls_PeekNext(&ModuleAlphaOrderList, linkPtr);
+    while (!le_dls_IsEmpty(&pendingList))
+    {
+        KModuleObj_t *batch[KMODULE_MAX_PARALLEL_LOADS];
+        size_t count = 0;
+        size_t i;
+
+        linkPtr = le_dls_Peek(&pendingList);
+        while ((linkPtr != NULL) && (count < KMODULE_MAX_PARALLEL_LOADS))
+        {
+            modPtr = CONTAINER_OF(linkPtr, KModuleObj_t, pendingLink);
+
+            if (IsModuleReady(modPtr, &pendingList))
+            {
+                batch[count++] = modPtr;
+            }
+
+            linkPtr = le_dls_PeekNext(&pendingList, linkPtr);
+        }
+
+        if (count == 0)
+        {
+            LE_ERROR("Unable to resolve kernel module load order. Restarting system ...");
+            framework_Reboot();
+            return;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            le_dls_Remove(&pendingList, &(batch[i]->pendingLink));
+        }
+
+        result = InstallModuleBatch(batch, count);
+        if (result != LE_OK)
+        {
+            LE_ERROR("Error in installing kernel modules. Restarting system ...");
+            framework_Reboot();
+            return;
+        }
     }
 }
 
@@ -1245,6 +1563,62 @@ static void TraverseDependencyRemove
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unload a kernel module directly with the delete_module() system call.
+ *
+ * @return
+ *      - LE_OK if the module is unloaded (or wasn't loaded).
+ *      - LE_UNSUPPORTED if delete_module() isn't available; use rmmod instead.
+ *      - LE_FAULT if the kernel refused to unload the module.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UnloadModule(KModuleObj_t *mod)
+{
+#ifdef SYS_delete_module
+    le_result_t result = LE_OK;
+    char *kernelName = StripExtensionName(mod->name);
+    char *p;
+
+    /* The kernel knows modules by their file name, less ".ko", with dashes as underscores */
+    for (p = kernelName; *p != '\0'; p++)
+    {
+        if (*p == '-')
+        {
+            *p = '_';
+        }
+    }
+
+    LE_INFO("Unload module '%s'", kernelName);
+
+    if (syscall(SYS_delete_module, kernelName, O_NONBLOCK) != 0)
+    {
+        switch (errno)
+        {
+            case ENOENT:
+                LE_WARN("Module '%s' is not loaded.", kernelName);
+                break;
+
+            case ENOSYS:
+                result = LE_UNSUPPORTED;
+                break;
+
+            default:
+                LE_CRIT("Failed to unload module '%s'. (%m)", kernelName);
+                result = LE_FAULT;
+                break;
+        }
+    }
+
+    le_mem_Release(kernelName);
+    return result;
+#else
+    (void)mod;
+    return LE_UNSUPPORTED;
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * rmmod the kernel module
@@ -1299,12 +1673,16 @@ static le_result_t RemoveEachKernelModule(KModuleObj_t *m, bool enableUseCount)
             }
             else
             {
-                /* Populate argv for rmmod. rmmod does not take any parameters. */
-                rmmodargv[0] = RMMOD_COMMAND;
-                rmmodargv[1] = mod->name;
-                rmmodargv[2] = NULL;
+                result = UnloadModule(mod);
+                if (result == LE_UNSUPPORTED)
+                {
+                    /* Populate argv for rmmod. rmmod does not take any parameters. */
+                    rmmodargv[0] = RMMOD_COMMAND;
+                    rmmodargv[1] = mod->name;
+                    rmmodargv[2] = NULL;
 
-                result = ExecuteCommand(rmmodargv, 2);
+                    result = ExecuteCommand(rmmodargv, 2);
+                }
                 if (result != LE_OK)
                 {
                     return result;
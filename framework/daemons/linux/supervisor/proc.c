@@ -25,6 +25,11 @@
 #include "interfaces.h"
 #include "sysStatus.h"
 
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sys/prctl.h>
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -146,6 +151,7 @@ typedef struct proc_Ref
     app_Ref_t appRef;               ///< Reference to the app that we are part of.
     pid_t   pid;                    ///< The pid of the process.
     time_t  faultTime;              ///< The time of the last fault.
+    uint32_t faultCount;            ///< Number of faults since the process was created.
     bool    cmdKill;                ///< true if the process was killed by proc_Stop().
     int     stdInFd;                ///< Fd to direct standard in to.  If -1 then use /dev/null.
     int     stdOutFd;               ///< Fd to direct standard out to.  If -1 then use /dev/null.
@@ -164,6 +170,8 @@ typedef struct proc_Ref
     proc_BlockCallback_t  blockCallback;  ///< Callback function to indicate when the process is
                                           ///  has been blocked after the fork but before the exec.
     void* blockContextPtr;          ///< Context pointer for the blockCallback.
+    const int32_t* traceSysCallsPtr;///< System calls that stop the tracer of a blocked process.
+    size_t  numTraceSysCalls;       ///< Number of system calls in traceSysCallsPtr.  0 if none.
 }
 Process_t;
 
@@ -213,6 +221,15 @@ static le_mem_PoolRef_t PriorityPool;
 static le_mem_PoolRef_t ArgsPool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of the pids of running processes to their process objects.  The key is the process object's
+ * own pid field, so a process must be removed from the map before its pid is changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t PidMap;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Nice level definitions for the different Legato priority levels.
@@ -236,6 +253,105 @@ typedef struct
 EnvVar_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a "name=value" environment string passed to exec.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ENV_STRING_BYTES    (LIMIT_MAX_ENV_VAR_NAME_BYTES + LIMIT_MAX_PATH_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The executable search path used if the process's environment doesn't set PATH.  This is the
+ * default used by execvp().
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SEARCH_PATH     "/bin:/usr/bin"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the stack a child process runs on between clone() and exec().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LAUNCH_STACK_BYTES      (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Audit architecture of the system calls the seccomp trace filter applies to.  On architectures
+ * not listed here the filter doesn't check the architecture.
+ */
+//--------------------------------------------------------------------------------------------------
+#if defined(__aarch64__)
+#define TRACE_FILTER_AUDIT_ARCH         AUDIT_ARCH_AARCH64
+#elif defined(__arm__) && defined(__ARMEL__)
+#define TRACE_FILTER_AUDIT_ARCH         AUDIT_ARCH_ARM
+#elif defined(__x86_64__)
+#define TRACE_FILTER_AUDIT_ARCH         AUDIT_ARCH_X86_64
+#elif defined(__i386__)
+#define TRACE_FILTER_AUDIT_ARCH         AUDIT_ARCH_I386
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of instructions in the seccomp trace filter: the architecture check, one
+ * instruction per traced system call and the two return instructions.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACE_FILTER_MAX_INSTRUCTIONS   (LE_APPCTRL_MAX_TRACE_SYS_CALLS + 5)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Everything a child process needs between being created and exec'ing its program.  It is all
+ * gathered by the Supervisor beforehand, so that the child only makes system calls and never
+ * touches the Supervisor's own state (config, IPC, memory pools, logging).
+ *
+ * A child created with clone(CLONE_VM) runs in the Supervisor's memory, so it reads this directly
+ * from the Supervisor's stack and writes any error message back into it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    proc_Ref_t  procRef;                                ///< The process being started.
+    char**      argsPtr;                                ///< Executable path, then argv for exec.
+    char*       envPtr[LIMIT_MAX_NUM_ENV_VARS + 1];     ///< Environment for exec, NULL terminated.
+    char        envStrings[LIMIT_MAX_NUM_ENV_VARS][ENV_STRING_BYTES]; ///< Buffers for envPtr.
+    const char* searchPathPtr;                          ///< PATH used to find the executable.
+    char        smackLabel[LIMIT_MAX_SMACK_LABEL_BYTES];///< SMACK label for the process.
+    const char* workingDirPtr;                          ///< Working directory (sandbox root).
+    bool        isSandboxed;                            ///< true if the app is sandboxed.
+    uid_t       uid;                                    ///< User ID for a sandboxed process.
+    gid_t       gid;                                    ///< Group ID for a sandboxed process.
+    gid_t       groups[LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS]; ///< Supplementary groups list.
+    size_t      numGroups;                              ///< Number of supplementary groups.
+    int         syncPipeFd[2];                          ///< Closed by the parent to let the child
+                                                        ///  continue after the parent's setup.
+    int         blockPipeFd[2];                         ///< Blocks the child before exec, or -1.
+    int         statusPipeFd[2];                        ///< Close-on-exec pipe the child writes to
+                                                        ///  if it fails to start, or -1.
+    int         logStdOutPipe[2];                       ///< Log pipe for standard out, or -1.
+    int         logStdErrPipe[2];                       ///< Log pipe for standard error, or -1.
+    struct sock_filter traceFilter[TRACE_FILTER_MAX_INSTRUCTIONS]; ///< Seccomp trace filter.
+    struct sock_fprog traceFilterProg;                  ///< Program for traceFilter.  Its length
+                                                        ///  is 0 if no filter is to be installed.
+    char        errorMsg[LIMIT_MAX_PATH_BYTES];         ///< Why the child failed to start.
+}
+Launch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stack for children created with clone(CLONE_VM).  Only one is needed because the Supervisor
+ * waits for each such child to exec before starting another.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t LaunchStack[LAUNCH_STACK_BYTES] __attribute__((aligned(16)));
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Definitions for the read and write ends of a pipe.
@@ -383,6 +499,25 @@ void proc_Init
     PathPool = le_mem_CreatePool("Paths", LIMIT_MAX_PATH_BYTES);
     PriorityPool = le_mem_CreatePool("Priority", LIMIT_MAX_PRIORITY_NAME_BYTES);
     ArgsPool = le_mem_CreatePool("Args", sizeof(Arg_t));
+    PidMap = le_hashmap_Create("ProcPids", 31, le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that a process is no longer running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ForgetPid
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+)
+{
+    if (procRef->pid != -1)
+    {
+        le_hashmap_Remove(PidMap, &procRef->pid);
+        procRef->pid = -1;
+    }
 }
 
 
@@ -450,6 +585,7 @@ proc_Ref_t proc_Create
     // Initialize all other parameters.
     procPtr->appRef = appRef;
     procPtr->faultTime = 0;
+    procPtr->faultCount = 0;
     procPtr->pid = -1;  // Processes that are not running are assigned -1 as its pid.
     procPtr->cmdKill = false;
 
@@ -466,6 +602,8 @@ proc_Ref_t proc_Create
     procPtr->blockPipe = -1;
     procPtr->blockCallback = NULL;
     procPtr->blockContextPtr = NULL;
+    procPtr->traceSysCallsPtr = NULL;
+    procPtr->numTraceSysCalls = 0;
 
     // Get watchdog action & fault action from config tree now, if this process has a config
     // tree entry.
@@ -516,6 +654,8 @@ void proc_Delete
     proc_Ref_t procRef              ///< [IN] The process to start.
 )
 {
+    ForgetPid(procRef);
+
     // Delete arguments override list.
     proc_ClearArgs(procRef);
 
@@ -713,41 +853,77 @@ static le_result_t GetEnvironmentVariables
 
     if (procRef->cfgPathPtr != NULL)
     {
+        // Read the whole list of variables in as few requests as possible, rather than making
+        // several requests per variable.
         le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-        le_cfg_GoToNode(procCfg, CFG_NODE_ENV_VARS);
+        uint8_t data[LE_CFG_SUBTREE_BYTES];
+        uint32_t firstEntry = 0;
+        le_result_t result;
 
-        if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
+        do
         {
-            LE_WARN("No environment variables for process '%s'.", procRef->namePtr);
+            size_t dataSize = sizeof(data);
+            uint32_t entryCount = 0;
 
-            le_cfg_CancelTxn(procCfg);
-            return 0;
-        }
+            result = le_cfg_GetSubtree(procCfg, CFG_NODE_ENV_VARS, firstEntry,
+                                       data, &dataSize, &entryCount);
 
-        int i = 0;
-        for (i = 0; i < maxNumEnvVars; i++)
-        {
-            if ( (le_cfg_GetNodeName(procCfg, "", envVars[i].name, LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
-                 (le_cfg_GetString(procCfg, "", envVars[i].value, LIMIT_MAX_PATH_BYTES, "") != LE_OK) )
-            {
-                le_cfg_CancelTxn(procCfg);
-                goto errorReading;
-            }
-
-            if (le_cfg_GoToNextSibling(procCfg) != LE_OK)
+            if ((result != LE_OK) && (result != LE_OVERFLOW))
             {
                 break;
             }
-            else if (i >= maxNumEnvVars-1)
+
+            if ((result == LE_OVERFLOW) && (entryCount == 0))
             {
+                // A single entry doesn't fit in the buffer.
                 le_cfg_CancelTxn(procCfg);
                 goto errorReading;
             }
+
+            size_t offset = 0;
+            uint32_t entry;
+
+            for (entry = 0; entry < entryCount; entry++)
+            {
+                // Each entry is a type byte, a relative path and a value, both null-terminated.
+                const char* namePtr = (const char*)&data[offset + 1];
+                const char* valuePtr = namePtr + strlen(namePtr) + 1;
+                offset = (valuePtr + strlen(valuePtr) + 1) - (const char*)data;
+
+                // Only direct children of the list are variables.
+                if (strchr(namePtr, '/') != NULL)
+                {
+                    continue;
+                }
+
+                if (numEnvVars >= maxNumEnvVars)
+                {
+                    le_cfg_CancelTxn(procCfg);
+                    goto errorReading;
+                }
+
+                if ( (le_utf8_Copy(envVars[numEnvVars].name, namePtr,
+                                   LIMIT_MAX_ENV_VAR_NAME_BYTES, NULL) != LE_OK) ||
+                     (le_utf8_Copy(envVars[numEnvVars].value, valuePtr,
+                                   LIMIT_MAX_PATH_BYTES, NULL) != LE_OK) )
+                {
+                    le_cfg_CancelTxn(procCfg);
+                    goto errorReading;
+                }
+
+                numEnvVars++;
+            }
+
+            firstEntry += entryCount;
         }
+        while (result == LE_OVERFLOW);
 
         le_cfg_CancelTxn(procCfg);
 
-        numEnvVars = i + 1;
+        if (numEnvVars == 0)
+        {
+            LE_WARN("No environment variables for process '%s'.", procRef->namePtr);
+        }
     }
     // If the config path is NULL (likely because the process is auxiliary and thus "unconfigured"),
     // then default PATH is provided depending on the app is sandboxed or not. This default PATH is
@@ -796,29 +972,43 @@ errorReading:
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sets the environment variable for the calling process.
+ * Builds the environment the process will be exec'ed with, and finds the executable search path
+ * in it.  Only the variables in the list are included; nothing is inherited from the Supervisor.
  *
- * @note Kills the calling process if there is an error.
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if a variable is too long.
  */
 //--------------------------------------------------------------------------------------------------
-static void SetEnvironmentVariables
+static le_result_t BuildEnvironment
 (
+    Launch_t* launchPtr,    ///< [IN,OUT] The launch to build the environment for.
     EnvVar_t envVars[],     ///< [IN] The list of environment variables.
     int numEnvVars          ///< [IN] The number environment variables in the list.
 )
 {
-#define OVER_WRITE_ENV_VAR      1
-
-    // Erase entire environment list.
-    LE_ASSERT(clearenv() == 0);
+    launchPtr->searchPathPtr = DEFAULT_SEARCH_PATH;
 
-    // Set the environment variables list.
     int i;
     for (i = 0; i < numEnvVars; i++)
     {
-        // Set the environment variable, overwriting anything that was previously there.
-        LE_ASSERT(setenv(envVars[i].name, envVars[i].value, OVER_WRITE_ENV_VAR) == 0);
+        if (snprintf(launchPtr->envStrings[i], ENV_STRING_BYTES, "%s=%s",
+                     envVars[i].name, envVars[i].value) >= ENV_STRING_BYTES)
+        {
+            return LE_OVERFLOW;
+        }
+
+        launchPtr->envPtr[i] = launchPtr->envStrings[i];
+
+        if (strcmp(envVars[i].name, "PATH") == 0)
+        {
+            launchPtr->searchPathPtr = envVars[i].value;
+        }
     }
+
+    launchPtr->envPtr[numEnvVars] = NULL;
+
+    return LE_OK;
 }
 
 
@@ -967,25 +1157,55 @@ static le_result_t GetArgs
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records why a child process failed to start.  Called only in the child, which may be sharing
+ * the Supervisor's memory, so it must not log.  errno is preserved.
+ *
+ * @return LE_FAULT.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ChildError
+(
+    Launch_t* launchPtr,            ///< [IN] The launch that failed.
+    const char* formatPtr,          ///< [IN] printf style format of the message.
+    ...
+)
+{
+    int savedErrno = errno;
+    va_list args;
+
+    va_start(args, formatPtr);
+    vsnprintf(launchPtr->errorMsg, sizeof(launchPtr->errorMsg), formatPtr, args);
+    va_end(args);
+
+    errno = savedErrno;
+    return LE_FAULT;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configure non-sandboxed processes.
  */
 //--------------------------------------------------------------------------------------------------
-static void ConfigNonSandboxedProcess
+static le_result_t ConfigNonSandboxedProcess
 (
-    const char* workingDirPtr       ///< [IN] The path to the process's working directory.
+    Launch_t* launchPtr             ///< [IN] The launch to configure the process for.
 )
 {
     // Set the working directory for this process.
-    if (chdir(workingDirPtr) != 0)
+    if (chdir(launchPtr->workingDirPtr) != 0)
     {
-        LE_FATAL("Could not change working directory to '%s'.  %m", workingDirPtr);
+        return ChildError(launchPtr, "Could not change working directory to '%s'.  %m",
+                          launchPtr->workingDirPtr);
     }
 
     // NOTE: For now, at least, we run all unsandboxed apps as root to prevent major permissions
     //       issues when trying to perform system operations, such as changing routing tables.
     //       Consider using non-root users with capabilities later for another security layer.
+
+    return LE_OK;
 }
 
 
@@ -1033,8 +1253,9 @@ static void SendStdPipeToLogDaemon
  * always closed afterwards.
  */
 //--------------------------------------------------------------------------------------------------
-static void RedirectStdStream
+static le_result_t RedirectStdStream
 (
+    Launch_t* launchPtr,    ///< [IN] The launch the stream belongs to.
     int fd,                 ///< [IN] Fd to redirect to.
     int logPipe[2],         ///< [IN] Log standard out pipe.
     int streamNum           ///< [IN] Either STDOUT_FILENO or STDERR_FILENO.
@@ -1044,18 +1265,25 @@ static void RedirectStdStream
     {
         // Duplicate the fd onto the process' standard stream.  Leave the original fd open so it can
         // be re-used later.
-        LE_FATAL_IF(dup2(fd, streamNum) == -1, "Could not duplicate fd.  %m.");
+        if (dup2(fd, streamNum) == -1)
+        {
+            return ChildError(launchPtr, "Could not duplicate fd.  %m.");
+        }
     }
     else
     {
         // Duplicate the write end of the log pipe onto the process' standard stream.
-        LE_FATAL_IF(dup2(logPipe[WRITE_PIPE], streamNum) == -1,
-                    "Could not duplicate fd.  %m.");
+        if (dup2(logPipe[WRITE_PIPE], streamNum) == -1)
+        {
+            return ChildError(launchPtr, "Could not duplicate fd.  %m.");
+        }
 
         // Close the two ends of the pipe because we don't need them.
-        fd_Close(logPipe[READ_PIPE]);
-        fd_Close(logPipe[WRITE_PIPE]);
+        close(logPipe[READ_PIPE]);
+        close(logPipe[WRITE_PIPE]);
     }
+
+    return LE_OK;
 }
 
 
@@ -1066,22 +1294,32 @@ static void RedirectStdStream
  * pipes.  The log pipes are always closed afterwards.
  */
 //--------------------------------------------------------------------------------------------------
-static void RedirectStdStreams
+static le_result_t RedirectStdStreams
 (
-    proc_Ref_t procRef,         ///< [IN] Process reference.
-    int stdOutLogPipe[2],       ///< [IN] Log standard out pipe.
-    int stdErrLogPipe[2]        ///< [IN] Log standard in pipe.
+    Launch_t* launchPtr         ///< [IN] The launch to redirect the streams for.
 )
 {
-    RedirectStdStream(procRef->stdErrFd, stdErrLogPipe, STDERR_FILENO);
-    RedirectStdStream(procRef->stdOutFd, stdOutLogPipe, STDOUT_FILENO);
+    proc_Ref_t procRef = launchPtr->procRef;
+
+    if ( (RedirectStdStream(launchPtr, procRef->stdErrFd, launchPtr->logStdErrPipe,
+                            STDERR_FILENO) != LE_OK) ||
+         (RedirectStdStream(launchPtr, procRef->stdOutFd, launchPtr->logStdOutPipe,
+                            STDOUT_FILENO) != LE_OK) )
+    {
+        return LE_FAULT;
+    }
 
     if (procRef->stdInFd >= 0)
     {
         // Duplicate the fd onto the process' standard in.  Leave the original fd open so it can
         // be re-used later.
-        LE_FATAL_IF(dup2(procRef->stdInFd, STDIN_FILENO) == -1, "Could not duplicate fd.  %m.");
+        if (dup2(procRef->stdInFd, STDIN_FILENO) == -1)
+        {
+            return ChildError(launchPtr, "Could not duplicate fd.  %m.");
+        }
     }
+
+    return LE_OK;
 }
 
 
@@ -1132,42 +1370,57 @@ static void CreateLogPipe
 /**
  * Confines the calling process into the sandbox.  The current working directory will be set to "/"
  * relative to the sandbox.
- *
- * @note Kills the calling process if there is an error.
  */
 //--------------------------------------------------------------------------------------------------
-static void ConfineProcInSandbox
+static le_result_t ConfineProcInSandbox
 (
-    const char* sandboxRootPtr, ///< [IN] Path to the sandbox root.
-    uid_t uid,                  ///< [IN] The user ID the process should be set to.
-    gid_t gid,                  ///< [IN] The group ID the process should be set to.
-    const gid_t* groupsPtr,     ///< [IN] List of supplementary groups for this process.
-    size_t numGroups            ///< [IN] The number of groups in the supplementary groups list.
+    Launch_t* launchPtr             ///< [IN] The launch with the sandbox root and credentials.
 )
 {
+    const char* sandboxRootPtr = launchPtr->workingDirPtr;
+
     // @Note: The order of the following statements is important and should not be changed carelessly.
 
     // Change working directory.
-    LE_FATAL_IF(chdir(sandboxRootPtr) != 0,
-                "Could not change working directory to '%s'.  %m", sandboxRootPtr);
+    if (chdir(sandboxRootPtr) != 0)
+    {
+        return ChildError(launchPtr, "Could not change working directory to '%s'.  %m",
+                          sandboxRootPtr);
+    }
 
     // Chroot to the sandbox.
-    LE_FATAL_IF(chroot(sandboxRootPtr) != 0, "Could not chroot to '%s'.  %m", sandboxRootPtr);
+    if (chroot(sandboxRootPtr) != 0)
+    {
+        return ChildError(launchPtr, "Could not chroot to '%s'.  %m", sandboxRootPtr);
+    }
 
     // Clear our supplementary groups list.
-    LE_FATAL_IF(setgroups(0, NULL) == -1, "Could not set the supplementary groups list.  %m.");
+    if (setgroups(0, NULL) == -1)
+    {
+        return ChildError(launchPtr, "Could not set the supplementary groups list.  %m.");
+    }
 
     // Populate our supplementary groups list with the provided list.
-    LE_FATAL_IF(setgroups(numGroups, groupsPtr) == -1,
-                "Could not set the supplementary groups list.  %m.");
+    if (setgroups(launchPtr->numGroups, launchPtr->groups) == -1)
+    {
+        return ChildError(launchPtr, "Could not set the supplementary groups list.  %m.");
+    }
 
     // Set our process's primary group ID.
-    LE_FATAL_IF(setgid(gid) == -1, "Could not set the group ID.  %m.");
+    if (setgid(launchPtr->gid) == -1)
+    {
+        return ChildError(launchPtr, "Could not set the group ID.  %m.");
+    }
 
     // Set our process's user ID.  This sets all of our user IDs (real, effective, saved).  This
     // call also clears all cababilities.  This function in particular MUST be called after all
     // the previous system calls because once we make this call we will lose root priviledges.
-    LE_FATAL_IF(setuid(uid) == -1, "Could not set the user ID.  %m.");
+    if (setuid(launchPtr->uid) == -1)
+    {
+        return ChildError(launchPtr, "Could not set the user ID.  %m.");
+    }
+
+    return LE_OK;
 }
 
 
@@ -1181,13 +1434,14 @@ static void ConfineProcInSandbox
  * When this function exits both ends of the pipe are closed.
  */
 //--------------------------------------------------------------------------------------------------
-static void BlockOnPipe
+static le_result_t BlockOnPipe
 (
+    Launch_t* launchPtr,    ///< [IN] The launch being synchronized.
     int pipeFd[2]           ///< [IN]
 )
 {
     // Don't need the write end of the pipe.
-    fd_Close(pipeFd[WRITE_PIPE]);
+    close(pipeFd[WRITE_PIPE]);
 
     // Perform a blocking read on the read end of the pipe.  Once the other end of the pipe is
     // closed this function will exit.
@@ -1197,11 +1451,391 @@ static void BlockOnPipe
     {
         numBytesRead = read(pipeFd[READ_PIPE], &dummyBuf, 1);
     }
-    while ( ((numBytesRead == -1)  && (errno == EINTR)) || (numBytesRead != 0) );
+    while ( ((numBytesRead == -1) && (errno == EINTR)) || (numBytesRead > 0) );
+
+    if (numBytesRead == -1)
+    {
+        return ChildError(launchPtr, "Could not read pipe.  %m.");
+    }
+
+    close(pipeFd[READ_PIPE]);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resets the calling process's signal handlers to their defaults and unblocks all signals.
+ *
+ * The handlers must be reset before signals are unblocked, because a child created with
+ * clone(CLONE_VM) would otherwise run the Supervisor's handlers in the Supervisor's memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetSignals
+(
+    void
+)
+{
+    struct sigaction action;
+    int sigNum;
+
+    for (sigNum = 1; sigNum < NSIG; sigNum++)
+    {
+        if ( (sigaction(sigNum, NULL, &action) == 0) &&
+             (action.sa_handler != SIG_DFL) && (action.sa_handler != SIG_IGN) )
+        {
+            action.sa_handler = SIG_DFL;
+            action.sa_flags = 0;
+            sigaction(sigNum, &action, NULL);
+        }
+    }
+
+    // Unblock all signals that might have been blocked.
+    sigset_t sigSet;
+    sigfillset(&sigSet);
+    pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes all file descriptors in the calling process except for the standard ones and the one
+ * specified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseNonStdFds
+(
+    int keepFd              ///< [IN] Fd to leave open, or -1.
+)
+{
+    int maxNumFds = sysconf(_SC_OPEN_MAX);
+    if (maxNumFds == -1)
+    {
+        maxNumFds = LIMIT_MAX_NUM_PROCESS_FD;
+    }
+
+    int fd;
+    for (fd = 3; fd < maxNumFds; fd++)
+    {
+        if (fd != keepFd)
+        {
+            close(fd);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Execs the process's program, searching the launch's search path the same way execvp() would
+ * if the executable path doesn't contain a slash.  Only returns if the exec failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExecProgram
+(
+    Launch_t* launchPtr             ///< [IN] The launch to exec.
+)
+{
+    const char* filePtr = launchPtr->argsPtr[0];
+    char** argvPtr = &(launchPtr->argsPtr[1]);
+
+    if ( (filePtr[0] == '\0') || (strchr(filePtr, '/') != NULL) )
+    {
+        execve(filePtr, argvPtr, launchPtr->envPtr);
+        return;
+    }
+
+    char path[LIMIT_MAX_PATH_BYTES];
+    const char* dirPtr = launchPtr->searchPathPtr;
+    bool accessDenied = false;
+
+    while (1)
+    {
+        const char* endPtr = strchrnul(dirPtr, ':');
+        int dirLen = endPtr - dirPtr;
+
+        // An empty entry in the search path means the current directory.
+        if (snprintf(path, sizeof(path), "%.*s%s%s",
+                     dirLen, dirPtr, (dirLen > 0) ? "/" : "", filePtr) < sizeof(path))
+        {
+            execve(path, argvPtr, launchPtr->envPtr);
+
+            if (errno == EACCES)
+            {
+                accessDenied = true;
+            }
+            else if ( (errno != ENOENT) && (errno != ENOTDIR) )
+            {
+                return;
+            }
+        }
+
+        if (*endPtr == '\0')
+        {
+            break;
+        }
+        dirPtr = endPtr + 1;
+    }
+
+    errno = accessDenied ? EACCES : ENOENT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Installs the seccomp trace filter prepared for the calling child process, if any.
+ *
+ * Without CAP_SYS_ADMIN, which a sandboxed process has dropped by now, a filter can only be
+ * installed once the process's "no new privileges" flag is set, so set it if need be.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t InstallTraceFilter
+(
+    Launch_t* launchPtr             ///< [IN] The launch to install the filter for.
+)
+{
+    if (launchPtr->traceFilterProg.len == 0)
+    {
+        return LE_OK;
+    }
+
+    if (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &launchPtr->traceFilterProg) == 0)
+    {
+        return LE_OK;
+    }
+
+    if ( (errno == EACCES) &&
+         (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0) &&
+         (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &launchPtr->traceFilterProg) == 0) )
+    {
+        return LE_OK;
+    }
+
+    return ChildError(launchPtr, "Could not install the system call trace filter.  %m.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up the calling child process and execs its program.  Only makes system calls on the
+ * prepared launch, so that it is safe to run in a child sharing the Supervisor's memory.
+ *
+ * @return LE_FAULT, with the reason in the launch's error message.  Only returns on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RunChild
+(
+    Launch_t* launchPtr             ///< [IN] The launch to run.
+)
+{
+    // Wait for the parent to allow us to continue by blocking on the read pipe until it
+    // is closed.
+    if (BlockOnPipe(launchPtr, launchPtr->syncPipeFd) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // The parent has allowed us to continue.
+    if (launchPtr->statusPipeFd[READ_PIPE] != -1)
+    {
+        close(launchPtr->statusPipeFd[READ_PIPE]);
+    }
+
+    // Redirect the process's standard streams.
+    if (RedirectStdStreams(launchPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Set the process's SMACK label.
+    if (smack_TrySetMyLabel(launchPtr->smackLabel) != LE_OK)
+    {
+        return ChildError(launchPtr, "Could not set SMACK label '%s'.  %m.",
+                          launchPtr->smackLabel);
+    }
+
+    // Set the umask so that files are not accidentally created with global permissions.
+    umask(S_IRWXG | S_IRWXO);
+
+    ResetSignals();
+
+    // Setup the process environment.
+    if (launchPtr->isSandboxed)
+    {
+        if (ConfineProcInSandbox(launchPtr) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+    else if (ConfigNonSandboxedProcess(launchPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if (launchPtr->blockPipeFd[READ_PIPE] != -1)
+    {
+        proc_Ref_t procRef = launchPtr->procRef;
+
+        // Call the block callback function.
+        procRef->blockCallback(getpid(), procRef->namePtr, procRef->blockContextPtr);
+
+        if (BlockOnPipe(launchPtr, launchPtr->blockPipeFd) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        // The tracer has attached by now, so the traced system calls can be made to stop it.
+        if (InstallTraceFilter(launchPtr) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    // Close all non-standard file descriptors.
+    CloseNonStdFds(launchPtr->statusPipeFd[WRITE_PIPE]);
+
+    // Launch the child program.  This should not return unless there was an error.
+    ExecProgram(launchPtr);
+
+    return ChildError(launchPtr, "Could not exec '%s'.  %m.", launchPtr->argsPtr[0]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a child created with clone(CLONE_VM).  It runs on LaunchStack in the
+ * Supervisor's memory until it execs.  If it fails, it notifies the parent through the status pipe
+ * and exits without running any of the Supervisor's exit handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CloneChildMain
+(
+    void* contextPtr                ///< [IN] The launch.
+)
+{
+    Launch_t* launchPtr = contextPtr;
+
+    RunChild(launchPtr);
+
+    char failed = 1;
+    while ( (write(launchPtr->statusPipeFd[WRITE_PIPE], &failed, 1) == -1) && (errno == EINTR) );
+
+    _exit(EXIT_FAILURE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the seccomp filter that makes the process's traced system calls stop its tracer
+ * (SECCOMP_RET_TRACE) and lets all other system calls through.  Leaves the filter empty if the
+ * process isn't blocked for a tracer or has no traced system calls.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildTraceFilter
+(
+    Launch_t* launchPtr,            ///< [OUT] The launch to build the filter for.
+    proc_Ref_t procRef              ///< [IN] The process to start.
+)
+{
+    struct sock_filter* filterPtr = launchPtr->traceFilter;
+    size_t numSysCalls = procRef->numTraceSysCalls;
+    size_t i;
+
+    launchPtr->traceFilterProg.len = 0;
+    launchPtr->traceFilterProg.filter = filterPtr;
+
+    if ( (procRef->blockCallback == NULL) || (numSysCalls == 0) )
+    {
+        return;
+    }
+
+    LE_ASSERT(numSysCalls <= LE_APPCTRL_MAX_TRACE_SYS_CALLS);
+
+#ifdef TRACE_FILTER_AUDIT_ARCH
+    // Let through the system calls made with another architecture's numbers.
+    *filterPtr++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+                                                offsetof(struct seccomp_data, arch));
+    *filterPtr++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                                                TRACE_FILTER_AUDIT_ARCH, 0, numSysCalls + 1);
+#endif
+
+    *filterPtr++ = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+                                                offsetof(struct seccomp_data, nr));
+
+    for (i = 0; i < numSysCalls; i++)
+    {
+        // On a match, jump over the remaining comparisons and the allow instruction.
+        *filterPtr++ = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                                                    procRef->traceSysCallsPtr[i],
+                                                    numSysCalls - i, 0);
+    }
 
-    LE_FATAL_IF(numBytesRead == -1, "Could not read pipe.  %m.");
+    *filterPtr++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+    *filterPtr++ = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_TRACE);
 
-    fd_Close(pipeFd[READ_PIPE]);
+    launchPtr->traceFilterProg.len = filterPtr - launchPtr->traceFilter;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gathers everything the child process needs up to its exec, so that the child doesn't need to
+ * read the config or touch the app objects.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareLaunch
+(
+    Launch_t* launchPtr,            ///< [OUT] The launch to prepare.
+    proc_Ref_t procRef,             ///< [IN] The process to start.
+    EnvVar_t envVars[],             ///< [IN] The process's environment variables.
+    int numEnvVars,                 ///< [IN] The number of environment variables.
+    char* argsPtr[]                 ///< [IN] The executable path and arguments.
+)
+{
+    app_Ref_t appRef = procRef->appRef;
+
+    launchPtr->procRef = procRef;
+    launchPtr->argsPtr = argsPtr;
+    launchPtr->errorMsg[0] = '\0';
+
+    if (BuildEnvironment(launchPtr, envVars, numEnvVars) != LE_OK)
+    {
+        LE_ERROR("Environment variable too long for process '%s'.", procRef->namePtr);
+        return LE_FAULT;
+    }
+
+    smack_GetAppLabel(app_GetName(appRef), launchPtr->smackLabel, sizeof(launchPtr->smackLabel));
+
+    BuildTraceFilter(launchPtr, procRef);
+
+    launchPtr->workingDirPtr = app_GetWorkingDir(appRef);
+    launchPtr->isSandboxed = app_GetIsSandboxed(appRef);
+
+    if (launchPtr->isSandboxed)
+    {
+        launchPtr->uid = app_GetUid(appRef);
+        launchPtr->gid = app_GetGid(appRef);
+
+        // Get the app's supplementary groups list.
+        launchPtr->numGroups = LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS;
+
+        if (app_GetSupplementaryGroups(appRef, launchPtr->groups, &launchPtr->numGroups) != LE_OK)
+        {
+            LE_ERROR("Supplementary groups list is too small.");
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
 }
 
 
@@ -1210,6 +1844,12 @@ static void BlockOnPipe
  * Starts a process.  If the process belongs to a sandboxed app the process will run in its sandbox,
  * otherwise the process will run in its working directory as root.
  *
+ * The child is created with clone(CLONE_VM), sharing the Supervisor's memory until it execs, so
+ * that the Supervisor's page tables don't need to be copied for every launch.  The child does
+ * only per-process system calls; everything it needs is prepared beforehand.  Processes that must
+ * be blocked before they exec (see proc_SetBlockCallback()) are still fork()'ed, because they stay
+ * around in that state indefinitely.
+ *
  * @return
  *      LE_OK if successful.
  *      LE_FAULT if there was an error.
@@ -1240,19 +1880,6 @@ le_result_t proc_Start
         return LE_FAULT;
     }
 
-    // Create a pipe for parent/child synchronization.
-    int syncPipeFd[2];
-    LE_FATAL_IF(pipe(syncPipeFd) == -1, "Could not create synchronization pipe.  %m.");
-
-    // Create a pipe that can be used to block the child after the fork and initialization but
-    // before the exec() call.
-    int blockPipeFd[2] = {-1, -1};
-
-    if (procRef->blockCallback != NULL)
-    {
-        LE_FATAL_IF(pipe(blockPipeFd) == -1, "Could not create block pipe.  %m.");
-    }
-
     // @Note The current IPC system does not support forking so any reads to the config DB must be
     //       done in the parent process.
 
@@ -1278,105 +1905,82 @@ le_result_t proc_Start
         return LE_FAULT;
     }
 
-    // Create pipes for the process's standard error and standard out streams.
-    int logStdOutPipe[2];
-    int logStdErrPipe[2];
-    CreateLogPipe(procRef, logStdOutPipe, STDOUT_FILENO);
-    CreateLogPipe(procRef, logStdErrPipe, STDERR_FILENO);
-
-    // Create the child process
-    pid_t pID = fork();
+    Launch_t launch;
 
-    if (pID < 0)
+    if (PrepareLaunch(&launch, procRef, envVars, numEnvVars, argsPtr) != LE_OK)
     {
-        LE_EMERG("Failed to fork.  %m.");
+        LE_ERROR("Process '%s' cannot be started.", procRef->namePtr);
         return LE_FAULT;
     }
 
-    if (pID == 0)
-    {
-        // Wait for the parent to allow us to continue by blocking on the read pipe until it
-        // is closed.
-        BlockOnPipe(syncPipeFd);
-
-        // The parent has allowed us to continue.
-
-        // Redirect the process's standard streams.
-        RedirectStdStreams(procRef, logStdOutPipe, logStdErrPipe);
-
-        // Set the process's SMACK label.
-        char smackLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
-        smack_GetAppLabel(app_GetName(procRef->appRef), smackLabel, sizeof(smackLabel));
+    // Create a pipe for parent/child synchronization.
+    LE_FATAL_IF(pipe(launch.syncPipeFd) == -1, "Could not create synchronization pipe.  %m.");
 
-        smack_SetMyLabel(smackLabel);
+    // Create a pipe that can be used to block the child after the fork and initialization but
+    // before the exec() call.  Otherwise, create a pipe that is closed when the child execs, so
+    // the parent can wait for the child to stop using its memory.
+    launch.blockPipeFd[READ_PIPE] = launch.blockPipeFd[WRITE_PIPE] = -1;
+    launch.statusPipeFd[READ_PIPE] = launch.statusPipeFd[WRITE_PIPE] = -1;
 
-        // Set the umask so that files are not accidentally created with global permissions.
-        umask(S_IRWXG | S_IRWXO);
+    if (procRef->blockCallback != NULL)
+    {
+        LE_FATAL_IF(pipe(launch.blockPipeFd) == -1, "Could not create block pipe.  %m.");
+    }
+    else
+    {
+        LE_FATAL_IF(pipe2(launch.statusPipeFd, O_CLOEXEC) == -1,
+                    "Could not create status pipe.  %m.");
+    }
 
-        // Unblock all signals that might have been blocked.
-        sigset_t sigSet;
-        LE_ASSERT(0 == sigfillset(&sigSet));
-        LE_ASSERT(0 == pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL));
+    // Create pipes for the process's standard error and standard out streams.
+    CreateLogPipe(procRef, launch.logStdOutPipe, STDOUT_FILENO);
+    CreateLogPipe(procRef, launch.logStdErrPipe, STDERR_FILENO);
 
-        SetEnvironmentVariables(envVars, numEnvVars);
+    // Create the child process
+    pid_t pID;
 
-        // Setup the process environment.
-        if (app_GetIsSandboxed(procRef->appRef))
-        {
-            // Get the app's supplementary groups list.
-            gid_t groups[LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS];
-            size_t numGroups = LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS;
-
-            LE_FATAL_IF(app_GetSupplementaryGroups(procRef->appRef, groups, &numGroups) != LE_OK,
-                        "Supplementary groups list is too small.");
-
-            // Sandbox the process.
-            ConfineProcInSandbox(app_GetWorkingDir(procRef->appRef),
-                                app_GetUid(procRef->appRef),
-                                app_GetGid(procRef->appRef),
-                                groups,
-                                numGroups);
-        }
-        else
-        {
-            ConfigNonSandboxedProcess(app_GetWorkingDir(procRef->appRef));
-        }
+    if (procRef->blockCallback == NULL)
+    {
+        pID = clone(CloneChildMain, LaunchStack + sizeof(LaunchStack), CLONE_VM | SIGCHLD,
+                    &launch);
+    }
+    else
+    {
+        pID = fork();
 
-        if (procRef->blockCallback != NULL)
+        if (pID == 0)
         {
-            // Call the block callback function.
-            procRef->blockCallback(getpid(), procRef->namePtr, procRef->blockContextPtr);
+            RunChild(&launch);
 
-            BlockOnPipe(blockPipeFd);
+            // The program could not be started.  Log an error message.
+            log_ReInit();
+            LE_FATAL("%s", launch.errorMsg);
         }
+    }
 
-        // Launch the child program.  This should not return unless there was an error.
-        LE_INFO("Execing '%s'", argsPtr[0]);
-
-        // Close all non-standard file descriptors.
-        fd_CloseAllNonStd();
-
-        execvp(argsPtr[0], &(argsPtr[1]));
-
-        // Store the errno returned by exec().
-        int execErrno = errno;
-
-        // The program could not be started.  Log an error message.
-        log_ReInit();
-        LE_FATAL("Could not exec '%s'.  %s.", argsPtr[0], strerror(execErrno));
+    if (pID < 0)
+    {
+        LE_EMERG("Failed to fork.  %m.");
+        return LE_FAULT;
     }
 
     procRef->pid = pID;
+    le_hashmap_Put(PidMap, &procRef->pid, procRef);
 
     // Don't need this end of the pipe.
-    fd_Close(syncPipeFd[READ_PIPE]);
+    fd_Close(launch.syncPipeFd[READ_PIPE]);
+
+    if (launch.statusPipeFd[WRITE_PIPE] != -1)
+    {
+        fd_Close(launch.statusPipeFd[WRITE_PIPE]);
+    }
 
     // Set the scheduling priority for the child process while the child process is blocked.
     SetSchedulingPriority(procRef);
 
     // Send standard pipes to the log daemon so they will show up in the logs.
-    SendStdPipeToLogDaemon(procRef, logStdErrPipe, STDERR_FILENO);
-    SendStdPipeToLogDaemon(procRef, logStdOutPipe, STDOUT_FILENO);
+    SendStdPipeToLogDaemon(procRef, launch.logStdErrPipe, STDERR_FILENO);
+    SendStdPipeToLogDaemon(procRef, launch.logStdOutPipe, STDOUT_FILENO);
 
     // Set the resource limits for the child process while the child process is blocked.
     if (resLim_SetProcLimits(procRef) != LE_OK)
@@ -1387,18 +1991,39 @@ le_result_t proc_Start
     }
 
     LE_INFO("Starting process '%s' with pid %d", procRef->namePtr, procRef->pid);
+    LE_INFO("Execing '%s'", argsPtr[0]);
 
     // Unblock the child process.
-    fd_Close(syncPipeFd[WRITE_PIPE]);
+    fd_Close(launch.syncPipeFd[WRITE_PIPE]);
+
+    if (launch.statusPipeFd[READ_PIPE] != -1)
+    {
+        // Wait for the child to exec (or exit), after which it no longer uses our memory.
+        char failed;
+        ssize_t numBytesRead;
+
+        do
+        {
+            numBytesRead = read(launch.statusPipeFd[READ_PIPE], &failed, 1);
+        }
+        while ((numBytesRead == -1) && (errno == EINTR));
+
+        fd_Close(launch.statusPipeFd[READ_PIPE]);
+
+        if (numBytesRead > 0)
+        {
+            LE_ERROR("Process '%s' failed to start.  %s", procRef->namePtr, launch.errorMsg);
+        }
+    }
 
     // Check if the child process should be blocked.
     if (procRef->blockCallback != NULL)
     {
         // Don't need the read end of this pipe.
-        fd_Close(blockPipeFd[READ_PIPE]);
+        fd_Close(launch.blockPipeFd[READ_PIPE]);
 
         // Store the write end in the process's data struct.
-        procRef->blockPipe = blockPipeFd[WRITE_PIPE];
+        procRef->blockPipe = launch.blockPipeFd[WRITE_PIPE];
     }
 
     return LE_OK;
@@ -1466,6 +2091,41 @@ pid_t proc_GetPID
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the running process with a given PID.
+ *
+ * @return
+ *      The process reference if found.
+ *      NULL if no process object is running with that PID.
+ */
+//--------------------------------------------------------------------------------------------------
+proc_Ref_t proc_FindByPID
+(
+    pid_t pid                      ///< [IN] The PID.
+)
+{
+    return le_hashmap_Get(PidMap, &pid);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of times the process has faulted since it was created.
+ *
+ * @return
+ *      The process's fault count.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t proc_GetFaultCount
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+)
+{
+    return procRef->faultCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's name.
@@ -1500,6 +2160,23 @@ const char* proc_GetAppName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the application that this process belongs to.
+ *
+ * @return
+ *      The application reference.
+ */
+//--------------------------------------------------------------------------------------------------
+app_Ref_t proc_GetApp
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+)
+{
+    return procRef->appRef;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's config path.
@@ -1874,6 +2551,27 @@ void proc_SetBlockCallback
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the system calls that stop the tracer of the process, if it is blocked on startup for one
+ * (see proc_SetBlockCallback()).  A seccomp filter returning SECCOMP_RET_TRACE for these system
+ * calls is installed in the process once it is unblocked, before it execs.
+ *
+ * @note The list is not copied; it must stay valid until it is cleared or the process is started.
+ */
+//--------------------------------------------------------------------------------------------------
+void proc_SetTraceSysCalls
+(
+    proc_Ref_t procRef,                     ///< [IN] The process reference.
+    const int32_t* sysCallsPtr,             ///< [IN] System call numbers.  NULL to clear.
+    size_t numSysCalls                      ///< [IN] Number of system calls.
+)
+{
+    procRef->traceSysCallsPtr = sysCallsPtr;
+    procRef->numTraceSysCalls = (sysCallsPtr == NULL) ? 0 : numSysCalls;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unblocks a process that was blocked on startup.
@@ -1912,7 +2610,7 @@ void proc_SetRun
  * Called to capture any extra data that may help indicate what contributed to the fault that caused
  * the given process to fail.
  *
- * This function calls a shell script that will save a dump of the system log and any core files
+ * This function starts a script that will save a dump of the system log and any core files
  * that have been generated into a known location.
  */
 //--------------------------------------------------------------------------------------------------
@@ -1922,28 +2620,7 @@ static void CaptureDebugData
     bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
 )
 {
-    char command[LIMIT_MAX_PATH_BYTES];
-    int s = snprintf(command,
-                     sizeof(command),
-                     "/legato/systems/current/bin/saveLogs %s %s %s",
-                     app_GetName(procRef->appRef),
-                     procRef->namePtr,
-                     isRebooting ? "REBOOT" : "");
-
-    if (s >= sizeof(command))
-    {
-        LE_FATAL("Could not create command, buffer is too small.  "
-                 "Buffer is %zd bytes but needs to be %d bytes.",
-                 sizeof(command),
-                 s);
-    }
-
-    int r = system(command);
-
-    if (!WIFEXITED(r) || (WEXITSTATUS(r) != EXIT_SUCCESS))
-    {
-        LE_ERROR("Could not save log and core file.");
-    }
+    framework_SaveLogs(app_GetName(procRef->appRef), procRef->namePtr, isRebooting);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2033,7 +2710,7 @@ FaultAction_t proc_SigChildHandler
         procRef->cmdKill = false;
 
         // Remember that this process is dead.
-        procRef->pid = -1;
+        ForgetPid(procRef);
 
         return FAULT_ACTION_NONE;
     }
@@ -2043,6 +2720,7 @@ FaultAction_t proc_SigChildHandler
 
     // Record the fault time.
     procRef->faultTime = (le_clk_GetAbsoluteTime()).sec;
+    procRef->faultCount++;
 
     if (WIFEXITED(procExitStatus))
     {
@@ -2071,7 +2749,7 @@ FaultAction_t proc_SigChildHandler
     }
 
     // Record the fact that the process is dead.
-    procRef->pid = -1;
+    ForgetPid(procRef);
 
     // If the process has reached its fault limit, take action to stop
     // the apparently futile attempts to start this thing.
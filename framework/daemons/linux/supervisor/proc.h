@@ -151,6 +151,35 @@ pid_t proc_GetPID
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the running process with a given PID.
+ *
+ * @return
+ *      The process reference if found.
+ *      NULL if no process object is running with that PID.
+ */
+//--------------------------------------------------------------------------------------------------
+proc_Ref_t proc_FindByPID
+(
+    pid_t pid                      ///< [IN] The PID.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of times the process has faulted since it was created.
+ *
+ * @return
+ *      The process's fault count.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t proc_GetFaultCount
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's name.
@@ -179,6 +208,20 @@ const char* proc_GetAppName
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the application that this process belongs to.
+ *
+ * @return
+ *      The application reference.
+ */
+//--------------------------------------------------------------------------------------------------
+app_Ref_t proc_GetApp
+(
+    proc_Ref_t procRef             ///< [IN] The process reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the process's config path.
@@ -379,6 +422,23 @@ void proc_SetBlockCallback
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the system calls that stop the tracer of the process, if it is blocked on startup for one
+ * (see proc_SetBlockCallback()).  A seccomp filter returning SECCOMP_RET_TRACE for these system
+ * calls is installed in the process once it is unblocked, before it execs.
+ *
+ * @note The list is not copied; it must stay valid until it is cleared or the process is started.
+ */
+//--------------------------------------------------------------------------------------------------
+void proc_SetTraceSysCalls
+(
+    proc_Ref_t procRef,                     ///< [IN] The process reference.
+    const int32_t* sysCallsPtr,             ///< [IN] System call numbers.  NULL to clear.
+    size_t numSysCalls                      ///< [IN] Number of system calls.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unblocks a process that was blocked on startup.
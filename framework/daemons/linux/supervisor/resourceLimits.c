@@ -12,6 +12,7 @@
 #include "limit.h"
 #include "user.h"
 #include "cgroups.h"
+#include "appSettings.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -217,6 +218,84 @@ static int GetCfgResourceLimit
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a resource limit value of an application or of one of its processes.  The value is taken
+ * from the application's settings blob if it has one, so that the config tree only needs to be
+ * read for applications built by tools that don't generate it.
+ *
+ * @return
+ *      The resource limit if it is valid.  If the configured value is invalid the default value is
+ *      returned.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetResourceLimit
+(
+    app_Ref_t appRef,               // The application.
+    const char* cfgPath,            // Config path of the application or of one of its processes.
+    le_cfg_IteratorRef_t* cfgPtr,   // The iterator to use to read the config tree at cfgPath.  It
+                                    // is created the first time it is needed and must be cancelled
+                                    // by the caller if it is not NULL.
+    const char* nodeName,           // The name of the node in the config tree that holds the value.
+    int defaultValue                // The default value to use if the config value is invalid.
+)
+{
+    appSettings_Ref_t settingsRef = app_GetSettings(appRef);
+
+    // Settings blob keys are config paths relative to the application's node.
+    const char* appCfgPath = app_GetConfigPath(appRef);
+    size_t appCfgPathLen = strlen(appCfgPath);
+
+    if (   (settingsRef != NULL)
+        && (strncmp(cfgPath, appCfgPath, appCfgPathLen) == 0)
+        && ((cfgPath[appCfgPathLen] == '\0') || (cfgPath[appCfgPathLen] == '/')) )
+    {
+        const char* relPathPtr = cfgPath + appCfgPathLen;
+        if (relPathPtr[0] == '/')
+        {
+            relPathPtr++;
+        }
+
+        char key[LIMIT_MAX_PATH_BYTES];
+        int64_t value;
+
+        if (   ((size_t)snprintf(key, sizeof(key), "%s%s%s",
+                                 relPathPtr, (relPathPtr[0] == '\0') ? "" : "/", nodeName)
+                < sizeof(key))
+            && (appSettings_GetInt(settingsRef, key, &value) == LE_OK)
+            && (value >= 0)
+            && (value <= INT_MAX) )
+        {
+            return (int)value;
+        }
+    }
+
+    if (*cfgPtr == NULL)
+    {
+        *cfgPtr = le_cfg_CreateReadTxn(cfgPath);
+    }
+
+    return GetCfgResourceLimit(*cfgPtr, nodeName, defaultValue);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancels an iterator created by GetResourceLimit(), if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelResourceLimitTxn
+(
+    le_cfg_IteratorRef_t cfg        // The iterator, or NULL.
+)
+{
+    if (cfg != NULL)
+    {
+        le_cfg_CancelTxn(cfg);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the sandboxed application's tmpfs file system limit.
@@ -230,13 +309,14 @@ rlim_t resLim_GetSandboxedAppTmpfsLimit
     app_Ref_t appRef                ///< [IN] The application to set resource limits for.
 )
 {
-    // Create a config iterator to get the file system limit from the config tree.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    le_cfg_IteratorRef_t appCfg = NULL;
 
-    // Get the resource limit from the config tree.
-    int fileSysLimit = GetCfgResourceLimit(appCfg,
-                                           CFG_NODE_LIMIT_MAX_FILE_SYSTEM_BYTES,
-                                           DEFAULT_LIMIT_MAX_FILE_SYSTEM_BYTES);
+    // Get the resource limit.
+    int fileSysLimit = GetResourceLimit(appRef,
+                                        app_GetConfigPath(appRef),
+                                        &appCfg,
+                                        CFG_NODE_LIMIT_MAX_FILE_SYSTEM_BYTES,
+                                        DEFAULT_LIMIT_MAX_FILE_SYSTEM_BYTES);
 
     if (fileSysLimit == 0)
     {
@@ -248,7 +328,7 @@ rlim_t resLim_GetSandboxedAppTmpfsLimit
         fileSysLimit = DEFAULT_LIMIT_MAX_FILE_SYSTEM_BYTES;
     }
 
-    le_cfg_CancelTxn(appCfg);
+    CancelResourceLimitTxn(appCfg);
 
     return (rlim_t)fileSysLimit;
 }
@@ -293,15 +373,16 @@ maximum allowed value.", resourceName, MAX_LIMIT_FILE_DESCRIPTORS);
 static void SetRLimit
 (
     pid_t pid,                      // The pid of the process to set the limit for.
-    le_cfg_IteratorRef_t procCfg,   // The iterator for the process.  This iterator is owned by
-                                    // the caller and should not be deleted in this function.
+    app_Ref_t appRef,               // The application the process belongs to.
+    const char* cfgPath,            // Config path of the application or of the process.
+    le_cfg_IteratorRef_t* cfgPtr,   // The iterator to read cfgPath with (see GetResourceLimit()).
     const char* resourceName,       // The resource name in the config tree.
     int resourceID,                 // The resource ID that setrlimit() expects.
     int defaultValue                // The default value for this resource limit.
 )
 {
-    // Get the limit value from the config tree.
-    int limit = GetCfgResourceLimit(procCfg, resourceName, defaultValue);
+    // Get the limit value.
+    int limit = GetResourceLimit(appRef, cfgPath, cfgPtr, resourceName, defaultValue);
 
     SetRLimitValue(pid, resourceName, resourceID, limit);
 }
@@ -349,31 +430,32 @@ le_result_t resLim_SetAppLimits
         }
     }
 
-    // Create a config iterator for this app.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    const char* appCfgPath = app_GetConfigPath(appRef);
+    le_cfg_IteratorRef_t appCfg = NULL;
 
-    // Get the cpu share value from the config.
-    int cpuShare = GetCfgResourceLimit(appCfg, CFG_NODE_LIMIT_CPU_SHARE, DEFAULT_LIMIT_CPU_SHARE);
+    // Get the cpu share value.
+    int cpuShare = GetResourceLimit(appRef, appCfgPath, &appCfg,
+                                    CFG_NODE_LIMIT_CPU_SHARE, DEFAULT_LIMIT_CPU_SHARE);
 
     // Set the cpu limit.
     if (cgrp_cpu_SetShare(appNamePtr, cpuShare) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        CancelResourceLimitTxn(appCfg);
         return LE_FAULT;
     }
 
     // Set the memory limit.
-    int maxMemoryBytes = GetCfgResourceLimit(appCfg,
-                                             CFG_NODE_LIMIT_MAX_MEMORY_BYTES,
-                                             DEFAULT_LIMIT_MAX_MEMORY_BYTES);
+    int maxMemoryBytes = GetResourceLimit(appRef, appCfgPath, &appCfg,
+                                          CFG_NODE_LIMIT_MAX_MEMORY_BYTES,
+                                          DEFAULT_LIMIT_MAX_MEMORY_BYTES);
 
     if (cgrp_mem_SetLimit(appNamePtr, maxMemoryBytes / 1024) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        CancelResourceLimitTxn(appCfg);
         return LE_FAULT;
     }
 
-    le_cfg_CancelTxn(appCfg);
+    CancelResourceLimitTxn(appCfg);
     return LE_OK;
 }
 
@@ -395,43 +477,51 @@ le_result_t resLim_SetProcLimits
 {
     pid_t pid = proc_GetPID(procRef);
 
-    // Create an iterator for this process.
     if (proc_GetConfigPath(procRef) != NULL)
     {
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(proc_GetConfigPath(procRef));
+        app_Ref_t appRef = proc_GetApp(procRef);
+        const char* procCfgPath = proc_GetConfigPath(procRef);
+        le_cfg_IteratorRef_t procCfg = NULL;
 
         // Set the process resource limits.
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_CORE_DUMP_FILE_BYTES, RLIMIT_CORE,
+        SetRLimit(pid, appRef, procCfgPath, &procCfg,
+                  CFG_NODE_LIMIT_MAX_CORE_DUMP_FILE_BYTES, RLIMIT_CORE,
                   DEFAULT_LIMIT_MAX_CORE_DUMP_FILE_BYTES);
 
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_FILE_BYTES, RLIMIT_FSIZE,
+        SetRLimit(pid, appRef, procCfgPath, &procCfg,
+                  CFG_NODE_LIMIT_MAX_FILE_BYTES, RLIMIT_FSIZE,
                   DEFAULT_LIMIT_MAX_FILE_BYTES);
 
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_LOCKED_MEMORY_BYTES, RLIMIT_MEMLOCK,
+        SetRLimit(pid, appRef, procCfgPath, &procCfg,
+                  CFG_NODE_LIMIT_MAX_LOCKED_MEMORY_BYTES, RLIMIT_MEMLOCK,
                   DEFAULT_LIMIT_MAX_LOCKED_MEMORY_BYTES);
 
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_FILE_DESCRIPTORS, RLIMIT_NOFILE,
+        SetRLimit(pid, appRef, procCfgPath, &procCfg,
+                  CFG_NODE_LIMIT_MAX_FILE_DESCRIPTORS, RLIMIT_NOFILE,
                   DEFAULT_LIMIT_MAX_FILE_DESCRIPTORS);
 
+        CancelResourceLimitTxn(procCfg);
+
         // Set the application limits.
         //
         // @note Even though these are application limits they still need to be set for the process
         //       because Linux rlimits are applied to individual processes.
+        const char* appCfgPath = app_GetConfigPath(appRef);
+        le_cfg_IteratorRef_t appCfg = NULL;
 
-        // Goto the application config path from the process config path.
-        le_cfg_GoToParent(procCfg);
-        le_cfg_GoToParent(procCfg);
-
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_MQUEUE_BYTES, RLIMIT_MSGQUEUE,
+        SetRLimit(pid, appRef, appCfgPath, &appCfg,
+                  CFG_NODE_LIMIT_MAX_MQUEUE_BYTES, RLIMIT_MSGQUEUE,
                   DEFAULT_LIMIT_MAX_MQUEUE_BYTES);
 
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_THREADS, RLIMIT_NPROC,
+        SetRLimit(pid, appRef, appCfgPath, &appCfg,
+                  CFG_NODE_LIMIT_MAX_THREADS, RLIMIT_NPROC,
                   DEFAULT_LIMIT_MAX_THREADS);
 
-        SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_QUEUED_SIGNALS, RLIMIT_SIGPENDING,
+        SetRLimit(pid, appRef, appCfgPath, &appCfg,
+                  CFG_NODE_LIMIT_MAX_QUEUED_SIGNALS, RLIMIT_SIGPENDING,
                   DEFAULT_LIMIT_MAX_QUEUED_SIGNALS);
 
-        le_cfg_CancelTxn(procCfg);
+        CancelResourceLimitTxn(appCfg);
     }
     else
     {
@@ -465,16 +555,9 @@ le_result_t resLim_SetProcLimits
                         DEFAULT_LIMIT_MAX_QUEUED_SIGNALS);
     }
 
-    // Add the process to its app's cgroups in each of the cgroup subsystems.
-    cgrp_SubSys_t subSys = 0;
-    for (; subSys < CGRP_NUM_SUBSYSTEMS; subSys++)
-    {
-        // Do not add realtime processes to the cpu cgroup.
-        if ( (subSys != CGRP_SUBSYS_CPU) || (!proc_IsRealtime(procRef)) )
-        {
-            LE_ASSERT(cgrp_AddProc(subSys, proc_GetAppName(procRef), pid) == LE_OK);
-        }
-    }
+    // Add the process to its app's cgroups in each of the cgroup subsystems.  Do not add realtime
+    // processes to the cpu cgroup.
+    LE_ASSERT(cgrp_AddProcToAll(proc_GetAppName(procRef), pid, !proc_IsRealtime(procRef)) == LE_OK);
 
     return LE_OK;
 }
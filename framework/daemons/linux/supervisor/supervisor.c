@@ -199,6 +199,7 @@
 //--------------------------------------------------------------------------------------------------
 
 
+#include <spawn.h>
 #include "legato.h"
 #include "interfaces.h"
 #include "limit.h"
@@ -220,6 +221,7 @@
 #include "sysStatus.h"
 #include "ima.h"
 #include "fs.h"
+#include "bootTrace.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -238,6 +240,30 @@
 #define BOOT_CFG_PATH "/"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Script that saves the system log and the core files for future diagnosis.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAVE_LOGS_PATH "/legato/systems/current/bin/saveLogs"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment variable that turns on the Log Control Daemon's persistent log storage.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_PERSIST_ENV_VAR "LE_LOG_PERSIST"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment of the process, passed to the spawned commands.
+ */
+//--------------------------------------------------------------------------------------------------
+extern char** environ;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Location in boot configuration path to store user defined value for minimum allowable time (in
@@ -425,19 +451,25 @@ static void StartFramework
     alarm(30);
 
     // Start all framework daemons.
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
     fwDaemons_Start();
+    bootTrace_Record(getpid(), "phase", "fwDaemons_Start", startTime);
 
     // Connect to the services we need from the framework daemons.
     LE_DEBUG("---- Connecting to services ----");
+    startTime = le_clk_GetRelativeTime();
     le_cfg_ConnectService();
     logFd_ConnectService();
     le_instStat_ConnectService();
+    bootTrace_Record(getpid(), "phase", "ConnectServices", startTime);
 
     // Cancel the start-up watchdog timer.
     alarm(0);
 
     // Insert kernel modules
+    startTime = le_clk_GetRelativeTime();
     kernelModules_Insert();
+    bootTrace_Record(getpid(), "phase", "kernelModules_Insert", startTime);
 
     // Advertise services.
     LE_DEBUG("---- Advertising the Supervisor's APIs ----");
@@ -452,8 +484,10 @@ static void StartFramework
     le_kernelModule_AdvertiseService();
 
     // Initialize the apps sub system.
+    startTime = le_clk_GetRelativeTime();
     apps_Init();
     apps_VerifyAppWriteableDeviceFiles();
+    bootTrace_Record(getpid(), "phase", "apps_Init", startTime);
 
     State = STATE_NORMAL;
 
@@ -699,27 +733,95 @@ void framework_Reboot
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Called to capture any extra data that may help indicate what contributed to the fault that
- * caused the framework to fail.
+ * Save a dump of the system log and any core files that have been generated into a known location,
+ * by running the saveLogs script.
  *
- * This function calls a shell script that will save a dump of the system log and any core files
- * that have been generated into a known location.
+ * The script is started directly, without a shell.  If the system is going to reboot, this
+ * function waits for the end of the script so that the data is saved before the reboot.
+ * Otherwise it returns right away and the script is reaped as an unconfigured child by the SIGCHLD
+ * handler.
+ *
+ * Nothing is done if the Log Control Daemon keeps the log history in persistent log storage: the
+ * fault has already been logged there, and critical messages are flushed to flash as they arrive.
  */
 //--------------------------------------------------------------------------------------------------
-static void CaptureDebugData
+void framework_SaveLogs
 (
-    void
+    const char* appNamePtr,         ///< [IN] Name of the app that failed.
+    const char* procNamePtr,        ///< [IN] Name of the process that failed.
+    bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
 )
 {
-    int r = system("/legato/systems/current/bin/saveLogs framework unknown REBOOT");
+    if (getenv(LOG_PERSIST_ENV_VAR) != NULL)
+    {
+        LE_CRIT("Fault in '%s/%s'%s.  See the persistent log.",
+                appNamePtr, procNamePtr, isRebooting ? ", rebooting" : "");
+        return;
+    }
+
+    char* argv[] = { (char*)SAVE_LOGS_PATH,
+                     (char*)appNamePtr,
+                     (char*)procNamePtr,
+                     isRebooting ? "REBOOT" : "",
+                     NULL };
+
+    // The signals handled by the event loop are blocked: unblock them for the script.
+    posix_spawnattr_t attr;
+    sigset_t sigMask;
+    sigemptyset(&sigMask);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &sigMask);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid;
+    int r = posix_spawn(&pid, SAVE_LOGS_PATH, NULL, &attr, argv, environ);
+
+    posix_spawnattr_destroy(&attr);
+
+    if (r != 0)
+    {
+        LE_ERROR("Could not save log and core file.  Failed to start '%s' (%s).",
+                 SAVE_LOGS_PATH, strerror(r));
+        return;
+    }
 
-    if (!WIFEXITED(r) || (WEXITSTATUS(r) != EXIT_SUCCESS))
+    if (!isRebooting)
+    {
+        LE_INFO("Saving log and core file of '%s/%s' (pid %d).", appNamePtr, procNamePtr, pid);
+        return;
+    }
+
+    int status;
+    pid_t waitPid;
+
+    do
+    {
+        waitPid = waitpid(pid, &status, 0);
+    }
+    while ((waitPid == -1) && (errno == EINTR));
+
+    if ((waitPid == -1) || !WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
     {
         LE_ERROR("Could not save log and core file.");
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called to capture any extra data that may help indicate what contributed to the fault that
+ * caused the framework to fail.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CaptureDebugData
+(
+    void
+)
+{
+    framework_SaveLogs("framework", "unknown", true);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The signal event handler function for SIGCHLD called from the Legato event loop.
@@ -738,6 +840,9 @@ static void CaptureDebugData
  * framework daemon SIGCHILD handler for identification and processing.  The lower layer handlers
  * are assumed to reap the child only if it is going to handle the process death.  If neither the
  * apps or framework daemons recognize the child then we must reap it here.
+ *
+ * The fault actions for app processes are taken once all of the children have been reaped, so
+ * that an app many of whose processes died at once is only restarted or stopped once.
  */
 //--------------------------------------------------------------------------------------------------
 static void SigChildHandler
@@ -761,12 +866,6 @@ static void SigChildHandler
         // Send the pid to the apps SIGCHILD handler for processing.
         le_result_t result = apps_SigChildHandler(pid);
 
-        if (result == LE_FAULT)
-        {
-            // There was an app fault that could not be handled so restart the framework.
-            framework_Reboot();
-        }
-
         if (result == LE_NOT_FOUND)
         {
             // Send the pid to the framework daemon's SIGCHILD handler for processing.
@@ -781,12 +880,19 @@ static void SigChildHandler
             {
                 // The child is neither an application process nor a framework daemon.
                 // Reap the child now.
-                LE_INFO("Reaping unconfigured child process %d.", pid);
+                int status = wait_ReapChild(pid);
 
-                wait_ReapChild(pid);
+                LE_INFO("Reaped unconfigured child process %d (status %#x).", pid, status);
             }
         }
     }
+
+    // Take the fault actions for the app processes that died, once per app.
+    if (apps_HandlePendingFaults() == LE_FAULT)
+    {
+        // There was an app fault that could not be handled so restart the framework.
+        framework_Reboot();
+    }
 }
 
 
@@ -852,28 +958,32 @@ static void SetupSmackOnlyCap
     void
 )
 {
+    smack_RuleBatch_t rules = SMACK_RULE_BATCH_INIT;
+
     // Set correct smack permissions for admin (Bug where onlycap label does not have CAP_MAC_OVERRIDE)
-    smack_SetRule("admin", "rwx", "_");
+    smack_AddRule(&rules, "admin", "rwx", "_");
 
     // Set correct smack permissions for app.tools and framework
-    smack_SetRule("admin", "rwx", "app.tools");
-    smack_SetRule("admin", "rwx", "framework");
+    smack_AddRule(&rules, "admin", "rwx", "app.tools");
+    smack_AddRule(&rules, "admin", "rwx", "framework");
 
     // Set correct smack permissions for syslog
-    smack_SetRule("_", "rw", "syslog");
-    smack_SetRule("admin", "rw", "syslog");
-    smack_SetRule("framework", "rw", "syslog");
+    smack_AddRule(&rules, "_", "rw", "syslog");
+    smack_AddRule(&rules, "admin", "rw", "syslog");
+    smack_AddRule(&rules, "framework", "rw", "syslog");
 
     // Set correct smack label for /home directory
     smack_SetLabel("/home", "_");
 
     // Framework app needs read/execute access to admin.
     // e.g. configTree needs access to *.cfg files and logDaemon needs read access to admin (fds)
-    smack_SetRule("framework", "rx", "admin");
+    smack_AddRule(&rules, "framework", "rx", "admin");
 
     // Framework needs write access to '_' label. e.g. configEcm needs write permission to /etc/legato
     // framework needs wx access to tmpfs
-    smack_SetRule("framework", "rwx", "_");
+    smack_AddRule(&rules, "framework", "rwx", "_");
+
+    smack_CommitRules(&rules);
 
     // Set correct smack label for /data
     smack_SetLabel("/data", "framework");
@@ -890,21 +1000,23 @@ static void SetupSmackOnlyCap
 
     // apps advertise before changing it's own label. When it advertises, app runs as '_' and tries
     // to communicate with serviceDirectory
-    smack_SetRule("_", "rwx", "framework");
+    smack_AddRule(&rules, "_", "rwx", "framework");
 
     // _appStopClient needs write access to admin. Apparently kernel calls this and we can't change
     // the extended attribute in the case it's from RW legato.
     // dropbear needs access to resources in /etc/dropbear
-    smack_SetRule("_", "rwx", "admin");
+    smack_AddRule(&rules, "_", "rwx", "admin");
 
     // Set correct smack permissions for sdir tool. When command like 'sdir list' is invoked,
     // the serviceDirectory needs rw to the /dev/pts/0 (terminal). The terminal can be running
     // in either '_' (console) or 'admin' (ssh).
-    smack_SetRule("framework", "rwx", "admin");
+    smack_AddRule(&rules, "framework", "rwx", "admin");
 
     // Set correct permissions for qmuxd
-    smack_SetRule("qmuxd", "rwx", "_");
-    smack_SetRule("_", "rwx", "qmuxd");
+    smack_AddRule(&rules, "qmuxd", "rwx", "_");
+    smack_AddRule(&rules, "_", "rwx", "qmuxd");
+
+    smack_CommitRules(&rules);
 
 #if DISABLE_SMACK_ONLYCAP != 0
     LE_INFO("SMACK onlycap disabled");
@@ -32,4 +32,18 @@ bool framework_IsStopping
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the system log and the core files of a failed process for future diagnosis.  Only waits for
+ * the data to be saved if the system is rebooting.
+ */
+//--------------------------------------------------------------------------------------------------
+void framework_SaveLogs
+(
+    const char* appNamePtr,         ///< [IN] Name of the app that failed.
+    const char* procNamePtr,        ///< [IN] Name of the process that failed.
+    bool isRebooting                ///< [IN] Is the supervisor going to reboot the system?
+);
+
+
 #endif // LEGATO_SRC_SUPERVISOR_INCLUDE_GUARD
@@ -0,0 +1,233 @@
+//--------------------------------------------------------------------------------------------------
+/** @file usageHistory.c
+ *
+ * Records the history of the CPU and memory used by applications.  See usageHistory.h.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "limit.h"
+#include "cgroups.h"
+#include "usageHistory.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples kept per application.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_SAMPLES                     LE_APPINFO_MAX_USAGE_SAMPLES
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimated number of applications, used to size the history map.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EST_NUM_APPS                    31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A sample.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time;                  ///< Time of the sample, in seconds since boot.
+    uint32_t cpuPermille;           ///< CPU used since the previous sample, in 0.1% of one CPU.
+    uint64_t memUsed;               ///< Memory used, in bytes.
+}
+Sample_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * History of an application.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char appName[LIMIT_MAX_APP_NAME_BYTES];   ///< Name of the application.  Key in the map.
+    le_clk_Time_t lastTime;         ///< Time of the last CPU reading.
+    uint64_t lastCpuTime;           ///< Last CPU reading, in nanoseconds.
+    bool hasLastCpuTime;            ///< true if lastTime and lastCpuTime are valid.
+    size_t next;                    ///< Index of the slot the next sample goes in.
+    size_t count;                   ///< Number of valid samples.
+    Sample_t samples[NUM_SAMPLES];  ///< Ring of samples.
+}
+History_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of application histories.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t HistoryPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Application histories, by application name.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t HistoryMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the usage history.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Init
+(
+    void
+)
+{
+    HistoryPool = le_mem_CreatePool("UsageHistory", sizeof(History_t));
+    HistoryMap = le_hashmap_Create("UsageHistory",
+                                   EST_NUM_APPS,
+                                   le_hashmap_HashString,
+                                   le_hashmap_EqualsString);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a sample of the CPU and memory used by an application and adds it to its history.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Sample
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+)
+{
+    History_t* histPtr = le_hashmap_Get(HistoryMap, appNamePtr);
+
+    if (histPtr == NULL)
+    {
+        histPtr = le_mem_ForceAlloc(HistoryPool);
+        memset(histPtr, 0, sizeof(*histPtr));
+
+        if (le_utf8_Copy(histPtr->appName, appNamePtr, sizeof(histPtr->appName), NULL) != LE_OK)
+        {
+            le_mem_Release(histPtr);
+            return;
+        }
+
+        le_hashmap_Put(HistoryMap, histPtr->appName, histPtr);
+    }
+
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    uint64_t cpuTime;
+    uint32_t cpuPermille = 0;
+
+    if (cgrp_GetCpuTime(appNamePtr, &cpuTime) == LE_OK)
+    {
+        // The counter starts again from zero when the app is restarted.
+        if (histPtr->hasLastCpuTime && (cpuTime >= histPtr->lastCpuTime))
+        {
+            le_clk_Time_t elapsed = le_clk_Sub(now, histPtr->lastTime);
+            uint64_t elapsedNs = (uint64_t)elapsed.sec * 1000000000 + (uint64_t)elapsed.usec * 1000;
+
+            if (elapsedNs > 0)
+            {
+                cpuPermille = (uint32_t)((cpuTime - histPtr->lastCpuTime) * 1000 / elapsedNs);
+            }
+        }
+
+        histPtr->lastTime = now;
+        histPtr->lastCpuTime = cpuTime;
+        histPtr->hasLastCpuTime = true;
+    }
+    else
+    {
+        histPtr->hasLastCpuTime = false;
+    }
+
+    ssize_t memUsed = cgrp_GetMemUsed(appNamePtr);
+
+    Sample_t* samplePtr = &histPtr->samples[histPtr->next];
+
+    samplePtr->time = now.sec;
+    samplePtr->cpuPermille = cpuPermille;
+    samplePtr->memUsed = (memUsed > 0) ? memUsed : 0;
+
+    histPtr->next = (histPtr->next + 1) % NUM_SAMPLES;
+
+    if (histPtr->count < NUM_SAMPLES)
+    {
+        histPtr->count++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the history of an application, e.g., because it has been uninstalled.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Forget
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+)
+{
+    History_t* histPtr = le_hashmap_Remove(HistoryMap, appNamePtr);
+
+    if (histPtr != NULL)
+    {
+        le_mem_Release(histPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the history of an application, oldest sample first.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if there are no samples for the application.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t usageHist_Get
+(
+    const char* appNamePtr,         ///< [IN] Name of the application.
+    uint32_t* timePtr,              ///< [OUT] Time of each sample, in seconds since boot.
+    uint32_t* cpuPermillePtr,       ///< [OUT] CPU used since the previous sample, in tenths of a
+                                    ///        percent of one CPU.
+    uint64_t* memUsedPtr,           ///< [OUT] Memory used, in bytes.
+    size_t* numSamplesPtr           ///< [IN/OUT] Size of the arrays, then number of samples.
+)
+{
+    const History_t* histPtr = le_hashmap_Get(HistoryMap, appNamePtr);
+
+    if ((histPtr == NULL) || (histPtr->count == 0))
+    {
+        *numSamplesPtr = 0;
+        return LE_NOT_FOUND;
+    }
+
+    // Return the most recent samples that fit.
+    size_t count = (histPtr->count < *numSamplesPtr) ? histPtr->count : *numSamplesPtr;
+    size_t index = (histPtr->next + NUM_SAMPLES - count) % NUM_SAMPLES;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        const Sample_t* samplePtr = &histPtr->samples[index];
+
+        timePtr[i] = samplePtr->time;
+        cpuPermillePtr[i] = samplePtr->cpuPermille;
+        memUsedPtr[i] = samplePtr->memUsed;
+
+        index = (index + 1) % NUM_SAMPLES;
+    }
+
+    *numSamplesPtr = count;
+
+    return LE_OK;
+}
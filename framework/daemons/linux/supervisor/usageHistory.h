@@ -0,0 +1,79 @@
+//--------------------------------------------------------------------------------------------------
+/** @file usageHistory.h
+ *
+ * API for recording the history of the CPU and memory used by applications.
+ *
+ * The Supervisor samples every running application's cgroups every USAGE_HIST_INTERVAL_SEC
+ * seconds.  The last LE_APPINFO_MAX_USAGE_SAMPLES samples of each application are kept in a
+ * fixed ring, so the history costs a constant amount of memory per application and a couple of
+ * small file reads per sample.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_USAGE_HISTORY_INCLUDE_GUARD
+#define LEGATO_SRC_USAGE_HISTORY_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval between samples, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define USAGE_HIST_INTERVAL_SEC         10
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the usage history.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a sample of the CPU and memory used by an application and adds it to its history.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Sample
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the history of an application, e.g., because it has been uninstalled.
+ */
+//--------------------------------------------------------------------------------------------------
+void usageHist_Forget
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the history of an application, oldest sample first.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if there are no samples for the application.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t usageHist_Get
+(
+    const char* appNamePtr,         ///< [IN] Name of the application.
+    uint32_t* timePtr,              ///< [OUT] Time of each sample, in seconds since boot.
+    uint32_t* cpuPermillePtr,       ///< [OUT] CPU used since the previous sample, in tenths of a
+                                    ///        percent of one CPU.
+    uint64_t* memUsedPtr,           ///< [OUT] Memory used, in bytes.
+    size_t* numSamplesPtr           ///< [IN/OUT] Size of the arrays, then number of samples.
+);
+
+
+#endif // LEGATO_SRC_USAGE_HISTORY_INCLUDE_GUARD
@@ -401,6 +401,34 @@ static le_result_t SetPermAppWritableDir
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the sdir tool to update the Service Directory's bindings for one app, or for the whole
+ * system if no app name is given.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReloadBindings
+(
+    const char* commandPtr,     ///< [IN] "load" or "unload".
+    const char* appNamePtr      ///< [IN] Name of the app, or NULL for all apps and users.
+)
+{
+    char command[LIMIT_MAX_PATH_BYTES + LIMIT_MAX_APP_NAME_BYTES];
+
+    LE_ASSERT(snprintf(command,
+                       sizeof(command),
+                       "/legato/systems/current/bin/sdir %s %s",
+                       commandPtr,
+                       (appNamePtr == NULL) ? "" : appNamePtr) < sizeof(command));
+
+    int result = system(command);
+    if (!WIFEXITED(result) || (WEXITSTATUS(result) != EXIT_SUCCESS))
+    {
+        LE_ERROR("'%s' failed.", command);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Perform an application upgrade.
@@ -780,8 +808,8 @@ le_result_t app_InstallIndividual
     }
 
 
-    // Reload the bindings configuration
-    system("/legato/systems/current/bin/sdir load");
+    // Reload the app's bindings, and those of other apps to its services.
+    ReloadBindings("load", appNamePtr);
 
     ExecPostinstallHook(appMd5Ptr);
 
@@ -851,12 +879,25 @@ le_result_t app_RemoveIndividual
     // Make sure that the application isn't running when we attempt to uninstall it.
     supCtrl_StopApp(appNamePtr);
 
+    // Drop the app's bindings while its user still exists.  Those of an unsandboxed app belong to
+    // the root user, so they can only be dropped by reloading all the bindings once it is gone.
+    char path[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(path, sizeof(path), "%s/sandboxed", appNamePtr) < sizeof(path));
+    bool isSandboxed = le_cfg_GetBool(i, path, true);
+
+    if (isSandboxed)
+    {
+        ReloadBindings("unload", appNamePtr);
+    }
+
     PerformAppDelete(appHash, appNamePtr, i);
 
     system_UnlinkApp("current", delAppName);
 
-    // Reload the bindings configuration
-    system("/legato/systems/current/bin/sdir load");
+    if (!isSandboxed)
+    {
+        ReloadBindings("load", NULL);
+    }
 
     sysStatus_MarkTried();
 
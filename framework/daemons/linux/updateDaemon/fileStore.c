@@ -0,0 +1,653 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file fileStore.c
+ *
+ * Content-addressed store of the files of installed apps.
+ *
+ * Every regular file extracted into an app by the in-process extractor is also hard linked into
+ * the store, at
+ *
+ * @verbatim
+   /legato/appFiles/<appName>/<size>/<hash>-<mode>
+   @endverbatim
+ *
+ * where <hash> is a hash of the file's contents and <mode> its permissions (in octal).  When a
+ * later version of the app is extracted, each file's contents are compared, as they arrive, with
+ * the stored files of the same size and permissions.  If one matches all the way through, the new
+ * app's file is hard linked to it and nothing is written.  Only once the contents differ from all
+ * of them is the file created, starting with the bytes that matched so far (copied from a stored
+ * file).
+ *
+ * Stored files are compared byte for byte, so the hash only has to tell files of the same size
+ * apart; it is not relied upon for identity.  The store is divided by app because the Update
+ * Daemon gives each app's files the app's own SMACK label, which a shared inode can only have
+ * one of.
+ *
+ * A stored file that no app links to any more has a link count of 1, and is removed by
+ * fileStore_RemoveUnused().
+ *
+ * Everything except fileStore_RemoveUnused() runs on the extractor's worker thread.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "fileStore.h"
+#include "fileDescriptor.h"
+
+#include <dirent.h>
+#include <fts.h>
+
+
+/// Directory the store is kept in.  It must be in the same file system as /legato/apps.
+#define STORE_PATH "/legato/appFiles"
+
+/// Maximum number of stored files a new file is compared with.
+#define MAX_CANDIDATES 8
+
+/// Size of the buffer stored file contents are read into.
+#define COMPARE_BUFFER_BYTES (64 * 1024)
+
+/// FNV-1a offset basis and prime, used to hash file contents a 64-bit word at a time.
+#define HASH_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define HASH_PRIME 0x100000001b3ULL
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A stored file that the file being extracted has matched so far.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int fd;                                 ///< Stored file, open for reading.
+    char path[LIMIT_MAX_PATH_BYTES];        ///< Stored file's path.
+}
+Candidate_t;
+
+
+/// Candidates the file being extracted still matches.
+static Candidate_t Candidates[MAX_CANDIDATES];
+static size_t NumCandidates = 0;
+
+/// Store directory for files of the same area, size and permissions as the one being extracted.
+static char SizeDirPath[LIMIT_MAX_PATH_BYTES];
+
+/// Path, permissions and size of the file being extracted.
+static char FilePath[LIMIT_MAX_PATH_BYTES];
+static mode_t FileMode;
+static uint64_t FileSize;
+
+/// The file being extracted (-1 while it still matches a candidate, or until it is created).
+static int FileFd = -1;
+
+/// # of bytes of the file that have been extracted so far.
+static uint64_t Offset;
+
+/// Hash of the file's contents so far, and the bytes of the last (incomplete) word.
+static uint64_t Hash;
+static uint8_t HashWord[sizeof(uint64_t)];
+static size_t HashWordBytes;
+
+/// Buffer stored files are read into.
+static uint8_t CompareBuffer[COMPARE_BUFFER_BYTES];
+
+/// Buffer an extracted file is read back into, to compare it with a stored file.
+static uint8_t FileBuffer[COMPARE_BUFFER_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add bytes to the hash of the file's contents.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateHash
+(
+    const uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t word;
+
+    while (length > 0)
+    {
+        if ((HashWordBytes == 0) && (length >= sizeof(word)))
+        {
+            memcpy(&word, dataPtr, sizeof(word));
+            dataPtr += sizeof(word);
+            length -= sizeof(word);
+        }
+        else
+        {
+            HashWord[HashWordBytes++] = *dataPtr++;
+            length--;
+
+            if (HashWordBytes < sizeof(word))
+            {
+                continue;
+            }
+
+            memcpy(&word, HashWord, sizeof(word));
+            HashWordBytes = 0;
+        }
+
+        Hash = (Hash ^ word) * HASH_PRIME;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a candidate and remove it from the list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropCandidate
+(
+    size_t index
+)
+//--------------------------------------------------------------------------------------------------
+{
+    fd_Close(Candidates[index].fd);
+    Candidates[index] = Candidates[--NumCandidates];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write all of a buffer to the file being extracted.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteToFile
+(
+    const uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (length > 0)
+    {
+        ssize_t writeResult = write(FileFd, dataPtr, length);
+
+        if (writeResult >= 0)
+        {
+            dataPtr += writeResult;
+            length -= writeResult;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Failed to write '%s' (%m).", FilePath);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a stored file has the given bytes at the current offset.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsMatch
+(
+    int fd,
+    const uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t offset = Offset;
+
+    while (length > 0)
+    {
+        size_t count = (length < sizeof(CompareBuffer)) ? length : sizeof(CompareBuffer);
+        ssize_t readResult = pread(fd, CompareBuffer, count, offset);
+
+        if ((readResult != (ssize_t)count) || (memcmp(CompareBuffer, dataPtr, count) != 0))
+        {
+            return false;
+        }
+
+        dataPtr += count;
+        length -= count;
+        offset += count;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the file being extracted, and copy into it the bytes that matched a stored file so far.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateFile
+(
+    int storedFd,           ///< Stored file to copy from (-1 if nothing to copy).
+    uint64_t length         ///< # of bytes to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t offset = 0;
+
+    FileFd = open(FilePath, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (FileFd == -1)
+    {
+        LE_ERROR("Failed to create '%s' (%m).", FilePath);
+        return LE_FAULT;
+    }
+
+    while (offset < length)
+    {
+        size_t count = sizeof(CompareBuffer);
+        if (count > length - offset)
+        {
+            count = length - offset;
+        }
+
+        if (pread(storedFd, CompareBuffer, count, offset) != (ssize_t)count)
+        {
+            LE_ERROR("Failed to read stored copy of '%s' (%m).", FilePath);
+            return LE_FAULT;
+        }
+
+        if (WriteToFile(CompareBuffer, count) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        offset += count;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the stored files of the same size and permissions as the file being extracted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FindCandidates
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char suffix[16];
+    size_t suffixLength = snprintf(suffix, sizeof(suffix), "-%04o", (unsigned int)FileMode);
+    DIR* dirPtr = opendir(SizeDirPath);
+    struct dirent* entryPtr;
+
+    if (dirPtr == NULL)
+    {
+        return;
+    }
+
+    while ((NumCandidates < MAX_CANDIDATES) && ((entryPtr = readdir(dirPtr)) != NULL))
+    {
+        size_t nameLength = strlen(entryPtr->d_name);
+        Candidate_t* candidatePtr = &Candidates[NumCandidates];
+        struct stat st;
+
+        if ((nameLength <= suffixLength) ||
+            (strcmp(entryPtr->d_name + nameLength - suffixLength, suffix) != 0) ||
+            (snprintf(candidatePtr->path, sizeof(candidatePtr->path), "%s/%s",
+                      SizeDirPath, entryPtr->d_name) >= (int)sizeof(candidatePtr->path)))
+        {
+            continue;
+        }
+
+        candidatePtr->fd = open(candidatePtr->path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (candidatePtr->fd == -1)
+        {
+            continue;
+        }
+
+        if ((fstat(candidatePtr->fd, &st) != 0) || !S_ISREG(st.st_mode) ||
+            ((uint64_t)st.st_size != FileSize) || ((st.st_mode & 07777) != FileMode))
+        {
+            fd_Close(candidatePtr->fd);
+            continue;
+        }
+
+        NumCandidates++;
+    }
+
+    closedir(dirPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the file that has just been written has the same contents as a stored file.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameAsStored
+(
+    const char* storedPath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int storedFd = open(storedPath, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    int fileFd = open(FilePath, O_RDONLY | O_CLOEXEC);
+    bool isSame = (storedFd != -1) && (fileFd != -1);
+    ssize_t readResult = 0;
+
+    Offset = 0;
+
+    while (isSame && ((readResult = read(fileFd, FileBuffer, sizeof(FileBuffer))) > 0))
+    {
+        isSame = IsMatch(storedFd, FileBuffer, readResult);
+        Offset += readResult;
+    }
+
+    if (storedFd != -1)
+    {
+        fd_Close(storedFd);
+    }
+    if (fileFd != -1)
+    {
+        fd_Close(fileFd);
+    }
+
+    return isSame && (readResult == 0) && (Offset == FileSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the file that has just been written to the store.  If a stored file with the same hash
+ * exists but wasn't compared against (there were too many candidates), and has the same
+ * contents, the new file is replaced with a link to it instead.
+ *
+ * Failures are only warned about, since the file itself has been extracted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToStore
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char storedPath[LIMIT_MAX_PATH_BYTES];
+    char tempPath[LIMIT_MAX_PATH_BYTES];
+
+    if (HashWordBytes > 0)
+    {
+        uint64_t word = 0;
+
+        memcpy(&word, HashWord, HashWordBytes);
+        Hash = (Hash ^ word) * HASH_PRIME;
+    }
+
+    if ((snprintf(storedPath, sizeof(storedPath), "%s/%016" PRIx64 "-%04o",
+                  SizeDirPath, Hash, (unsigned int)FileMode) >= (int)sizeof(storedPath)) ||
+        (snprintf(tempPath, sizeof(tempPath), "%s.tmp", FilePath) >= (int)sizeof(tempPath)))
+    {
+        return;
+    }
+
+    if (le_dir_MakePath(SizeDirPath, S_IRWXU) != LE_OK)
+    {
+        LE_WARN("Failed to create '%s'.", SizeDirPath);
+    }
+    else if (link(FilePath, storedPath) == 0)
+    {
+        LE_DEBUG("Added '%s' to the file store.", FilePath);
+    }
+    else if (errno != EEXIST)
+    {
+        LE_WARN("Failed to add '%s' to the file store (%m).", FilePath);
+    }
+    else if (IsSameAsStored(storedPath))
+    {
+        // Replace the file atomically, so it is never missing.
+        if ((link(storedPath, tempPath) == 0) && (rename(tempPath, FilePath) != 0))
+        {
+            (void)unlink(tempPath);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a name can be used for an area of the store.  Areas are named after apps.
+ *
+ * @return true if the name is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+bool fileStore_IsValidArea
+(
+    const char* areaNamePtr         ///< [IN] Area name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (areaNamePtr[0] != '\0') && (areaNamePtr[0] != '.') &&
+           (strchr(areaNamePtr, '/') == NULL) && (strlen(areaNamePtr) < LIMIT_MAX_APP_NAME_BYTES);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a regular file whose contents may already be in the store.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_Begin
+(
+    const char* areaNamePtr,        ///< [IN] Store area to look in and add to (the app's name).
+    const char* pathPtr,            ///< [IN] Path to extract the file to.
+    mode_t mode,                    ///< [IN] The file's permissions.
+    uint64_t size                   ///< [IN] The file's size (must be more than 0).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT((FileFd == -1) && (NumCandidates == 0) && (size > 0));
+    LE_ASSERT(fileStore_IsValidArea(areaNamePtr));
+
+    LE_ASSERT(le_utf8_Copy(FilePath, pathPtr, sizeof(FilePath), NULL) == LE_OK);
+    FileMode = mode;
+    FileSize = size;
+    Offset = 0;
+    Hash = HASH_OFFSET_BASIS;
+    HashWordBytes = 0;
+
+    LE_ASSERT(snprintf(SizeDirPath, sizeof(SizeDirPath), "%s/%s/%" PRIu64,
+                       STORE_PATH, areaNamePtr, size) < (int)sizeof(SizeDirPath));
+
+    FindCandidates();
+
+    if (NumCandidates == 0)
+    {
+        return CreateFile(-1, 0);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract the next bytes of the file started with fileStore_Begin().
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_Write
+(
+    const uint8_t* dataPtr,         ///< [IN] The bytes.
+    size_t length                   ///< [IN] # of bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    UpdateHash(dataPtr, length);
+
+    if (FileFd == -1)
+    {
+        size_t i = NumCandidates;
+
+        while (i-- > 0)
+        {
+            if (!IsMatch(Candidates[i].fd, dataPtr, length))
+            {
+                // If this was the last candidate, it still has the bytes matched until now.
+                if ((NumCandidates == 1) && (CreateFile(Candidates[i].fd, Offset) != LE_OK))
+                {
+                    return LE_FAULT;
+                }
+
+                DropCandidate(i);
+            }
+        }
+
+        if (FileFd == -1)
+        {
+            Offset += length;
+            return LE_OK;
+        }
+    }
+
+    Offset += length;
+
+    return WriteToFile(dataPtr, length);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish extracting the file started with fileStore_Begin().
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_End
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    LE_ASSERT(Offset == FileSize);
+
+    if (FileFd == -1)
+    {
+        // All of the file matched a stored copy, so link to it.  If the copy has been removed
+        // from the store since it was opened, write the file from it instead.
+        if (link(Candidates[0].path, FilePath) == 0)
+        {
+            LE_DEBUG("'%s' is unchanged.", FilePath);
+        }
+        else
+        {
+            result = CreateFile(Candidates[0].fd, FileSize);
+        }
+
+        while (NumCandidates > 0)
+        {
+            DropCandidate(0);
+        }
+
+        if (FileFd == -1)
+        {
+            return result;
+        }
+    }
+
+    if ((result == LE_OK) && (fchmod(FileFd, FileMode) != 0))
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", FilePath);
+        result = LE_FAULT;
+    }
+
+    fd_Close(FileFd);
+    FileFd = -1;
+
+    if (result == LE_OK)
+    {
+        AddToStore();
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give up extracting the file started with fileStore_Begin().  Safe to call if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+void fileStore_Abort
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (NumCandidates > 0)
+    {
+        DropCandidate(0);
+    }
+
+    if (FileFd != -1)
+    {
+        fd_Close(FileFd);
+        FileFd = -1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the stored files that no installed app uses any more, and the directories left empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void fileStore_RemoveUnused
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char* pathArrayPtr[] = { STORE_PATH, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        return;
+    }
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_F:
+                if ((entPtr->fts_statp->st_nlink == 1) && (unlink(entPtr->fts_accpath) != 0))
+                {
+                    LE_WARN("Failed to remove '%s' (%m).", entPtr->fts_path);
+                }
+                break;
+
+            case FTS_DP:
+                // Ignore failures; the directory is just still in use.
+                if (entPtr->fts_level > 0)
+                {
+                    (void)rmdir(entPtr->fts_accpath);
+                }
+                break;
+        }
+    }
+
+    fts_close(ftsPtr);
+}
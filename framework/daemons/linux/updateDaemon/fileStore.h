@@ -0,0 +1,103 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file fileStore.h
+ *
+ * Content-addressed store of the files of installed apps.  It lets the in-process tarball
+ * extractor (untar.c) hard link files that haven't changed since an earlier version of an app,
+ * instead of writing them again.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_FILE_STORE_H_INCLUDE_GUARD
+#define LEGATO_FILE_STORE_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a name can be used for an area of the store.  Areas are named after apps.
+ *
+ * @return true if the name is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+bool fileStore_IsValidArea
+(
+    const char* areaNamePtr         ///< [IN] Area name.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a regular file whose contents may already be in the store.  Nothing is
+ * written to the file system until the contents turn out to differ from every stored file of the
+ * same size and permissions.
+ *
+ * Anything at the file's path must have been removed, and its parent directories created.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ *
+ * @note Only one file can be extracted at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_Begin
+(
+    const char* areaNamePtr,        ///< [IN] Store area to look in and add to (the app's name).
+    const char* pathPtr,            ///< [IN] Path to extract the file to.
+    mode_t mode,                    ///< [IN] The file's permissions.
+    uint64_t size                   ///< [IN] The file's size (must be more than 0).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract the next bytes of the file started with fileStore_Begin().
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_Write
+(
+    const uint8_t* dataPtr,         ///< [IN] The bytes.
+    size_t length                   ///< [IN] # of bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish extracting the file started with fileStore_Begin(), once all its bytes have been given
+ * to fileStore_Write().  The file is either linked to a stored copy, or has been written and is
+ * added to the store.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t fileStore_End
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give up extracting the file started with fileStore_Begin().  Safe to call if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+void fileStore_Abort
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the stored files that no installed app uses any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void fileStore_RemoveUnused
+(
+    void
+);
+
+
+#endif // LEGATO_FILE_STORE_H_INCLUDE_GUARD
@@ -20,6 +20,7 @@
 #include "file.h"
 #include "system.h"
 #include "installer.h"
+#include "fileStore.h"
 #include "sysPaths.h"
 #include "sysStatus.h"
 #include "smack.h"
@@ -146,6 +147,24 @@ const char* system_CurrentAppsDir = CURRENT_SYSTEM_PATH "/apps";
 static const char* CurrentAppsWriteableDir = CURRENT_SYSTEM_PATH "/appsWriteable";
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Absolute file system path to the manifest of a delta system update, once unpacked.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* DeltaManifestPath = UNPACK_BASE_PATH "/delta.manifest";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directories of a system whose files are never written to once it is installed.  The unchanged
+ * files of a delta system update that are in these are hard linked from the current system,
+ * others are copied.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* DeltaLinkableDirs[] = { "bin/", "lib/", "modules/", NULL };
+
+
 // People should really use the const variables, so undefine the macros.
 #undef UNPACK_BASE_PATH
 
@@ -734,6 +753,249 @@ le_result_t system_CopyAppConfig
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a file listed in the manifest of a delta system update can be hard linked from the
+ * current system.
+ *
+ * @return true if it can be linked, false if it must be copied.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsDeltaLinkable
+(
+    const char* filePathPtr     ///< [IN] Path of the file, relative to the system directory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int i;
+
+    for (i = 0; DeltaLinkableDirs[i] != NULL; i++)
+    {
+        if (strncmp(filePathPtr, DeltaLinkableDirs[i], strlen(DeltaLinkableDirs[i])) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a path from the manifest of a delta system update stays inside the system directory.
+ *
+ * @return true if the path is valid.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsDeltaPathValid
+(
+    const char* filePathPtr     ///< [IN] Path of the file, relative to the system directory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t len = strlen(filePathPtr);
+
+    return (len > 0)
+        && (filePathPtr[0] != '/')
+        && (strcmp(filePathPtr, "..") != 0)
+        && (strncmp(filePathPtr, "../", 3) != 0)
+        && (strstr(filePathPtr, "/../") == NULL)
+        && ((len < 3) || (strcmp(filePathPtr + len - 3, "/..") != 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a file of a delta system update has the size and CRC32 given by the manifest.
+ *
+ * @return
+ *      - LE_OK if it does.
+ *      - LE_FORMAT_ERROR if it doesn't.
+ *      - LE_FAULT if the file can't be read.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckDeltaFile
+(
+    const char* pathPtr,        ///< [IN] Absolute path of the file.
+    uint64_t size,              ///< [IN] Expected size.
+    uint32_t crc                ///< [IN] Expected CRC32.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint8_t buffer[4096];
+    uint32_t fileCrc = LE_CRC_START_CRC32;
+    uint64_t fileSize = 0;
+    ssize_t len;
+
+    int fd = open(pathPtr, O_RDONLY);
+
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", pathPtr);
+        return LE_FAULT;
+    }
+
+    while ((len = fd_ReadSize(fd, buffer, sizeof(buffer))) > 0)
+    {
+        fileCrc = le_crc_Crc32(buffer, len, fileCrc);
+        fileSize += len;
+    }
+
+    fd_Close(fd);
+
+    if (len < 0)
+    {
+        LE_ERROR("Failed to read '%s' (%m).", pathPtr);
+        return LE_FAULT;
+    }
+
+    // The manifest has standard CRC32s, le_crc_Crc32() leaves out their final inversion.
+    fileCrc = ~fileCrc;
+
+    if ((fileSize != size) || (fileCrc != crc))
+    {
+        LE_ERROR("'%s' doesn't match the delta manifest (size %" PRIu64 ", CRC32 %08" PRIx32
+                 "; expected %" PRIu64 ", %08" PRIx32 ").",
+                 pathPtr, fileSize, fileCrc, size, crc);
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Complete the unpack of a delta system update.  The payload of a delta only has the files that
+ * changed since the current system, plus a manifest ("delta.manifest") listing every regular file
+ * of the new system as "<crc32> <size> <path>".  Each listed file that is not in the payload is
+ * taken from the current system, then every listed file is checked against the manifest.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the manifest is missing or bad, or a file doesn't match it.
+ *      - LE_FAULT on any other error.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t system_ApplyDelta
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char line[LIMIT_MAX_PATH_BYTES + 32];
+    char unpackPath[PATH_MAX];
+    char currentPath[PATH_MAX];
+    char dirPath[PATH_MAX];
+    unsigned int shipped = 0, linked = 0, copied = 0;
+    le_result_t result;
+
+    int fd = open(DeltaManifestPath, O_RDONLY);
+
+    if (fd == -1)
+    {
+        LE_ERROR("Delta system update has no manifest (%m).");
+        return LE_FORMAT_ERROR;
+    }
+
+    while ((result = fd_ReadLine(fd, line, sizeof(line))) == LE_OK)
+    {
+        uint32_t crc;
+        uint64_t size;
+        int pathOffset = -1;
+        struct stat st;
+
+        if (   (sscanf(line, "%8" SCNx32 " %" SCNu64 " %n", &crc, &size, &pathOffset) != 2)
+            || (pathOffset < 0)
+            || (!IsDeltaPathValid(line + pathOffset)) )
+        {
+            LE_ERROR("Bad delta manifest line '%s'.", line);
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        const char* filePathPtr = line + pathOffset;
+
+        LE_ASSERT(snprintf(unpackPath, sizeof(unpackPath),
+                           "%s/%s", system_UnpackPath, filePathPtr) < sizeof(unpackPath));
+
+        if (lstat(unpackPath, &st) == 0)
+        {
+            // The file changed since the current system, it is in the payload.
+            shipped++;
+        }
+        else if (errno != ENOENT)
+        {
+            LE_ERROR("Failed to stat '%s' (%m).", unpackPath);
+            result = LE_FAULT;
+            break;
+        }
+        else
+        {
+            LE_ASSERT(snprintf(currentPath, sizeof(currentPath),
+                               "%s/%s", CURRENT_SYSTEM_PATH, filePathPtr) < sizeof(currentPath));
+
+            if (   (le_path_GetDir(unpackPath, "/", dirPath, sizeof(dirPath)) != LE_OK)
+                || (le_dir_MakePath(dirPath, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != LE_OK) )
+            {
+                LE_ERROR("Failed to create the directory of '%s'.", unpackPath);
+                result = LE_FAULT;
+                break;
+            }
+
+            if (IsDeltaLinkable(filePathPtr))
+            {
+                if (link(currentPath, unpackPath) != 0)
+                {
+                    LE_ERROR("Failed to link '%s' to '%s' (%m).", unpackPath, currentPath);
+                    result = (errno == ENOENT) ? LE_FORMAT_ERROR : LE_FAULT;
+                    break;
+                }
+                linked++;
+            }
+            else
+            {
+                result = file_Copy(currentPath, unpackPath, NULL);
+                if (result != LE_OK)
+                {
+                    LE_ERROR("Failed to copy '%s' to '%s' (%s).",
+                             currentPath, unpackPath, LE_RESULT_TXT(result));
+                    result = (result == LE_NOT_FOUND) ? LE_FORMAT_ERROR : LE_FAULT;
+                    break;
+                }
+                copied++;
+            }
+        }
+
+        result = CheckDeltaFile(unpackPath, size, crc);
+        if (result != LE_OK)
+        {
+            break;
+        }
+    }
+
+    fd_Close(fd);
+
+    if (result == LE_OVERFLOW)
+    {
+        LE_ERROR("Delta manifest line too long.");
+        return LE_FORMAT_ERROR;
+    }
+    if (result != LE_OUT_OF_RANGE)
+    {
+        return (result == LE_FORMAT_ERROR) ? LE_FORMAT_ERROR : LE_FAULT;
+    }
+
+    file_Delete(DeltaManifestPath);
+
+    LE_INFO("Delta system update: %u files changed, %u linked and %u copied from current system.",
+            shipped, linked, copied);
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Complete a system update and move the system from unpack into current.
@@ -1088,6 +1350,9 @@ void system_RemoveUnusedApps
     }
 
     fts_close(ftsPtr);
+
+    // Stored app files that were only used by the removed apps can go too.
+    fileStore_RemoveUnused();
 }
 
 
@@ -1114,9 +1379,11 @@ bool system_AppUsedInAnySystem
         switch (entPtr->fts_info)
         {
             case FTS_D:
-                if (entPtr->fts_level > 3)
+                if (   (entPtr->fts_level > 3)
+                    || ((entPtr->fts_level == 1) && (entPtr->fts_name[0] == '.')))
                 {
-                    // We don't need to go past the apps directory.
+                    // We don't need to go past the apps directory, nor into hidden directories
+                    // such as the trash, whose contents are being deleted by the start program.
                     fts_set(ftsPtr, entPtr, FTS_SKIP);
                 }
                 break;
@@ -191,6 +191,23 @@ le_result_t system_CopyAppConfig
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Complete the unpack of a delta system update, by taking the files that didn't change from the
+ * current system and checking all the files against the delta's manifest.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the manifest is missing or bad, or a file doesn't match it.
+ *      - LE_FAULT on any other error.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t system_ApplyDelta
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Complete a system update and move the system from unpack into current.
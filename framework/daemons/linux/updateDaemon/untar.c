@@ -0,0 +1,1600 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.c
+ *
+ * In-process tarball extractor used by the Update Unpacker.
+ *
+ * The Update Unpacker writes an update pack section's payload into a pipe, and a worker thread
+ * reads it from the other end, decompresses it and extracts the tar entries into the unpack
+ * directory.  This saves forking tar and bzip2 processes for every app and system in an update.
+ *
+ * Plain tarballs are always supported.  bzip2, xz and Zstandard decompression are each compiled
+ * in only if the Update Daemon is built with the matching library (-DUNTAR_BZIP2, -DUNTAR_XZ,
+ * -DUNTAR_ZSTD); the Update Unpacker falls back to an external tar for the others.
+ *
+ * The ustar format is supported, with the GNU long name and pax extended header extensions
+ * (including extended attributes) that GNU tar and bsdtar use for long paths.  As with the
+ * "xmop" options given to tar, entries get the permissions in the tarball but are owned by the
+ * Update Daemon (root), and their modification times are not restored.
+ *
+ * All the state below, except for the worker thread bookkeeping, is only used by the worker
+ * thread while an extraction is running.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "untar.h"
+#include "fileStore.h"
+#include "fileDescriptor.h"
+
+#include <sys/xattr.h>
+
+#ifdef UNTAR_BZIP2
+#include <bzlib.h>
+#endif
+#ifdef UNTAR_XZ
+#include <lzma.h>
+#endif
+#ifdef UNTAR_ZSTD
+#include <zstd.h>
+#endif
+
+
+/// Size of a tar header, and the unit entry data is padded to.
+#define TAR_BLOCK_BYTES 512
+
+/// Size of the buffer compressed bytes are read into from the pipe.
+#define INPUT_BUFFER_BYTES (64 * 1024)
+
+/// Size of the buffer decompressed bytes are written to before they are extracted.
+#define OUTPUT_BUFFER_BYTES (64 * 1024)
+
+/// Largest GNU long name or pax extended header that can be handled.
+#define META_BUFFER_BYTES (4 * LIMIT_MAX_PATH_BYTES)
+
+/// Prefix of the pax header keywords that carry extended attributes.
+#define PAX_XATTR_PREFIX "SCHILY.xattr."
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of a ustar header block.  None of the strings are necessarily null-terminated, and the
+ * numbers are octal strings (or GNU base-256 numbers for large sizes).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[100];         ///< Entry name, or the last part of it if prefix is used.
+    char mode[8];           ///< Permission bits.
+    char uid[8];            ///< Owner user ID (ignored).
+    char gid[8];            ///< Owner group ID (ignored).
+    char size[12];          ///< Number of data bytes following the header.
+    char mtime[12];         ///< Modification time (ignored).
+    char checksum[8];       ///< Sum of the header bytes, with this field taken as spaces.
+    char typeFlag;          ///< Type of entry.
+    char linkName[100];     ///< Target of a hard or symbolic link.
+    char magic[6];          ///< "ustar" for ustar and GNU headers.
+    char version[2];        ///< Format version (ignored).
+    char userName[32];      ///< Owner user name (ignored).
+    char groupName[32];     ///< Owner group name (ignored).
+    char devMajor[8];       ///< Device major number (ignored).
+    char devMinor[8];       ///< Device minor number (ignored).
+    char prefix[155];       ///< Leading directories of the entry name (ustar only).
+    char padding[12];       ///< Pads the header to TAR_BLOCK_BYTES.
+}
+TarHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Where the next bytes of the (decompressed) tarball go.
+ */
+//--------------------------------------------------------------------------------------------------
+static enum
+{
+    SINK_HEADER,    ///< Into HeaderBlock, until a whole header has been collected.
+    SINK_FILE,      ///< Into the regular file being extracted.
+    SINK_META,      ///< Into MetaBuffer (a GNU long name or a pax extended header).
+    SINK_SKIP,      ///< Nowhere (data that isn't needed, or padding).
+    SINK_END        ///< Nowhere, because the end of the archive has been reached.
+}
+Sink;
+
+/// The directory being extracted into.
+static char DirPath[LIMIT_MAX_PATH_BYTES];
+
+/// How the tarball is compressed.
+static untar_Encoding_t Encoding;
+
+/// File store area regular files are extracted through (empty if the store isn't used).
+static char StoreArea[LIMIT_MAX_APP_NAME_BYTES];
+
+/// Read end of the pipe the tarball arrives on (-1 if not extracting).
+static int ReadFd = -1;
+
+/// The header being collected, and how many of its bytes have been collected so far.
+static uint8_t HeaderBlock[TAR_BLOCK_BYTES];
+static size_t HeaderBytes;
+
+/// # of bytes left to go into the current sink (unless it is SINK_HEADER or SINK_END).
+static uint64_t BytesLeft;
+
+/// # of padding bytes to skip once the current entry's data has been handled.
+static size_t PaddingBytes;
+
+/// The regular file being extracted (-1 if none, or if it is extracted through the file store),
+/// whether it is extracted through the file store, its path and its permissions.
+static int FileFd = -1;
+static bool IsStoreFile = false;
+static char FilePath[LIMIT_MAX_PATH_BYTES];
+static mode_t FileMode;
+
+/// The GNU long name or pax extended header being collected, its type flag and its size so far.
+static char MetaBuffer[META_BUFFER_BYTES];
+static char MetaType;
+static size_t MetaBytes;
+
+/// Metadata for the next entry, from GNU long name ('L' and 'K') and pax ('x') headers.
+static char LongName[LIMIT_MAX_PATH_BYTES];
+static char LongLinkName[LIMIT_MAX_PATH_BYTES];
+static char PaxBuffer[META_BUFFER_BYTES];
+static size_t PaxBytes;
+
+/// true once the metadata above has been used by an entry, so it has to be discarded before
+/// the next one.
+static bool MetaUsed;
+
+/// Buffers the worker thread decompresses through.
+static uint8_t InputBuffer[INPUT_BUFFER_BYTES];
+static uint8_t OutputBuffer[OUTPUT_BUFFER_BYTES];
+
+#ifdef UNTAR_BZIP2
+/// bzip2 decompression stream.
+static bz_stream Bzip2Stream;
+#endif
+#ifdef UNTAR_XZ
+/// xz decompression stream.
+static lzma_stream XzStream = LZMA_STREAM_INIT;
+#endif
+#ifdef UNTAR_ZSTD
+/// Zstandard decompression stream.
+static ZSTD_DStream* ZstdStreamPtr = NULL;
+#endif
+
+/// The worker thread (NULL if not extracting), and the thread that started it.
+static le_thread_Ref_t WorkerThread = NULL;
+static le_thread_Ref_t StartThread = NULL;
+
+/// Function to call when the extraction finishes.
+static untar_DoneHandler_t DoneHandler = NULL;
+
+/// Incremented for every extraction, so that the completion of a stopped one can be ignored.
+static unsigned int Generation = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a numeric header field.  These are octal, optionally padded with leading spaces and
+ * terminated by a space or null, except that GNU tar uses a big-endian base-256 number flagged
+ * by 0x80 in the first byte for values too large for octal.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the field isn't a valid number.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseNumber
+(
+    const char* fieldPtr,
+    size_t fieldSize,
+    uint64_t* valuePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = (const uint8_t*)fieldPtr;
+    uint64_t value = 0;
+    size_t i = 0;
+
+    if (bytePtr[0] == 0x80)
+    {
+        for (i = 1; i < fieldSize; i++)
+        {
+            if ((value >> 56) != 0)
+            {
+                return LE_FORMAT_ERROR;
+            }
+            value = (value << 8) | bytePtr[i];
+        }
+    }
+    else
+    {
+        while ((i < fieldSize) && (fieldPtr[i] == ' '))
+        {
+            i++;
+        }
+        for (; (i < fieldSize) && (fieldPtr[i] != '\0') && (fieldPtr[i] != ' '); i++)
+        {
+            if ((fieldPtr[i] < '0') || (fieldPtr[i] > '7') || ((value >> 61) != 0))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            value = (value << 3) | (fieldPtr[i] - '0');
+        }
+    }
+
+    *valuePtr = value;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a header block's checksum.
+ *
+ * @return true if the checksum is right.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsChecksumValid
+(
+    const TarHeader_t* headerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = (const uint8_t*)headerPtr;
+    size_t checksumOffset = offsetof(TarHeader_t, checksum);
+    uint64_t expected;
+    uint64_t sum = 0;
+    size_t i;
+
+    if (ParseNumber(headerPtr->checksum, sizeof(headerPtr->checksum), &expected) != LE_OK)
+    {
+        return false;
+    }
+
+    for (i = 0; i < TAR_BLOCK_BYTES; i++)
+    {
+        if ((i >= checksumOffset) && (i < checksumOffset + sizeof(headerPtr->checksum)))
+        {
+            sum += ' ';
+        }
+        else
+        {
+            sum += bytePtr[i];
+        }
+    }
+
+    return (sum == expected);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a header block is all zeros, which marks the end of the archive.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsZeroBlock
+(
+    const uint8_t* blockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i < TAR_BLOCK_BYTES; i++)
+    {
+        if (blockPtr[i] != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next record of the pending pax extended header.  The records were checked and their
+ * keywords and values null-terminated when the header was collected (see CheckPaxHeader()).
+ *
+ * @return true if a record was found, false if there are no more.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool NextPaxRecord
+(
+    size_t* offsetPtr,          ///< [IN,OUT] Offset of the record in PaxBuffer (start at 0).
+    const char** keyPtrPtr,     ///< [OUT] The record's keyword.
+    const char** valuePtrPtr,   ///< [OUT] The record's value.
+    size_t* valueLengthPtr      ///< [OUT] Length of the value (it may contain nulls).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (*offsetPtr >= PaxBytes)
+    {
+        return false;
+    }
+
+    char* recordPtr = PaxBuffer + *offsetPtr;
+    size_t recordLength = strtoul(recordPtr, NULL, 10);
+
+    *keyPtrPtr = strchr(recordPtr, ' ') + 1;
+    *valuePtrPtr = *keyPtrPtr + strlen(*keyPtrPtr) + 1;
+    *valueLengthPtr = (recordPtr + recordLength - 1) - *valuePtrPtr;
+    *offsetPtr += recordLength;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the format of a pax extended header collected in MetaBuffer and move it to PaxBuffer for
+ * the next entry.  Each record is "<length> <keyword>=<value>\n"; the '=' and the newline are
+ * replaced with nulls.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the header is malformed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckPaxHeader
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+
+    while (offset < MetaBytes)
+    {
+        char* recordPtr = MetaBuffer + offset;
+        char* endPtr;
+        unsigned long recordLength = strtoul(recordPtr, &endPtr, 10);
+
+        if ((endPtr == recordPtr) || (*endPtr != ' ') || (recordLength > MetaBytes - offset) ||
+            (recordPtr[recordLength - 1] != '\n'))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        char* equalsPtr = memchr(endPtr, '=', recordPtr + recordLength - endPtr);
+        if (equalsPtr == NULL)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        *equalsPtr = '\0';
+        recordPtr[recordLength - 1] = '\0';
+        offset += recordLength;
+    }
+
+    memcpy(PaxBuffer, MetaBuffer, MetaBytes);
+    PaxBytes = MetaBytes;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the extended attributes in the pending pax header to a newly extracted entry.  Failures
+ * are only warned about, as tar does.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyXattrs
+(
+    int fd,                 ///< The entry's fd, or -1 to use its path.
+    const char* pathPtr     ///< The entry's path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+    const char* keyPtr;
+    const char* valuePtr;
+    size_t valueLength;
+
+    while (NextPaxRecord(&offset, &keyPtr, &valuePtr, &valueLength))
+    {
+        if (strncmp(keyPtr, PAX_XATTR_PREFIX, sizeof(PAX_XATTR_PREFIX) - 1) == 0)
+        {
+            const char* namePtr = keyPtr + sizeof(PAX_XATTR_PREFIX) - 1;
+            int result = (fd != -1) ? fsetxattr(fd, namePtr, valuePtr, valueLength, 0)
+                                    : lsetxattr(pathPtr, namePtr, valuePtr, valueLength, 0);
+            if (result != 0)
+            {
+                LE_WARN("Failed to set attribute '%s' on '%s' (%m).", namePtr, pathPtr);
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the pending pax header has extended attributes for the entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasXattrs
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+    const char* keyPtr;
+    const char* valuePtr;
+    size_t valueLength;
+
+    while (NextPaxRecord(&offset, &keyPtr, &valuePtr, &valueLength))
+    {
+        if (strncmp(keyPtr, PAX_XATTR_PREFIX, sizeof(PAX_XATTR_PREFIX) - 1) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turn an entry name from the tarball into a path in the directory being extracted into.  Names
+ * that are absolute or contain ".." are refused, so nothing can be extracted outside it.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the name is refused.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeEntryPath
+(
+    const char* namePtr,    ///< [IN] Entry name.
+    char* pathPtr           ///< [OUT] Path (LIMIT_MAX_PATH_BYTES long).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char name[LIMIT_MAX_PATH_BYTES];
+    const char* componentPtr;
+    size_t length;
+
+    while (strncmp(namePtr, "./", 2) == 0)
+    {
+        namePtr += 2;
+    }
+
+    if ((namePtr[0] == '/') || (le_utf8_Copy(name, namePtr, sizeof(name), NULL) != LE_OK))
+    {
+        LE_ERROR("Refusing to extract '%s'.", namePtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    length = strlen(name);
+    while ((length > 0) && (name[length - 1] == '/'))
+    {
+        name[--length] = '\0';
+    }
+
+    for (componentPtr = name; *componentPtr != '\0'; )
+    {
+        const char* endPtr = strchrnul(componentPtr, '/');
+
+        if ((endPtr - componentPtr == 2) && (strncmp(componentPtr, "..", 2) == 0))
+        {
+            LE_ERROR("Refusing to extract '%s'.", name);
+            return LE_FORMAT_ERROR;
+        }
+
+        componentPtr = (*endPtr == '/') ? endPtr + 1 : endPtr;
+    }
+
+    LE_ASSERT(le_utf8_Copy(pathPtr, DirPath, LIMIT_MAX_PATH_BYTES, NULL) == LE_OK);
+
+    if ((strcmp(name, "") != 0) && (strcmp(name, ".") != 0) &&
+        (le_path_Concat("/", pathPtr, LIMIT_MAX_PATH_BYTES, name, (char*)NULL) != LE_OK))
+    {
+        LE_ERROR("Path of '%s' is too long.", name);
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure all of an entry's parent directories exist and are real directories, not symlinks
+ * (which could lead outside the directory being extracted into).  Missing ones are created.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareParents
+(
+    char* pathPtr           ///< [IN] Path of the entry, below DirPath.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char* separatorPtr = pathPtr + strlen(DirPath);
+
+    // The directory being extracted into has no parents to prepare.
+    if (*separatorPtr == '\0')
+    {
+        return LE_OK;
+    }
+
+    while ((separatorPtr = strchr(separatorPtr + 1, '/')) != NULL)
+    {
+        struct stat st;
+        le_result_t result = LE_OK;
+
+        *separatorPtr = '\0';
+
+        if (lstat(pathPtr, &st) == 0)
+        {
+            if (!S_ISDIR(st.st_mode))
+            {
+                LE_ERROR("'%s' is not a directory.", pathPtr);
+                result = LE_FAULT;
+            }
+        }
+        else if ((errno != ENOENT) || (mkdir(pathPtr, 0755) != 0))
+        {
+            LE_ERROR("Failed to create directory '%s' (%m).", pathPtr);
+            result = LE_FAULT;
+        }
+
+        *separatorPtr = '/';
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepare to create a non-directory entry: create its parents and remove anything already
+ * at its path.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareEntry
+(
+    char* pathPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (PrepareParents(pathPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if ((unlink(pathPtr) != 0) && (errno != ENOENT))
+    {
+        LE_ERROR("Failed to replace '%s' (%m).", pathPtr);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write all of a buffer to the regular file being extracted.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteToFile
+(
+    const uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (IsStoreFile)
+    {
+        return fileStore_Write(dataPtr, length);
+    }
+
+    while (length > 0)
+    {
+        ssize_t writeResult = write(FileFd, dataPtr, length);
+
+        if (writeResult >= 0)
+        {
+            dataPtr += writeResult;
+            length -= writeResult;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Failed to write '%s' (%m).", FilePath);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish extracting a regular file.  Its attributes and permissions are set once all its data
+ * has been written, so that writing doesn't clear set-user-ID bits or invalidate signatures.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CloseFile
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    if (IsStoreFile)
+    {
+        IsStoreFile = false;
+        return fileStore_End();
+    }
+
+    ApplyXattrs(FileFd, FilePath);
+
+    if (fchmod(FileFd, FileMode) != 0)
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", FilePath);
+        result = LE_FAULT;
+    }
+
+    fd_Close(FileFd);
+    FileFd = -1;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the GNU long name or pax extended header that has been collected in MetaBuffer.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if it is malformed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FinishMeta
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (MetaType == 'x')
+    {
+        return CheckPaxHeader();
+    }
+
+    char* destPtr = (MetaType == 'L') ? LongName : LongLinkName;
+    size_t length = strnlen(MetaBuffer, MetaBytes);
+
+    if (length >= LIMIT_MAX_PATH_BYTES)
+    {
+        LE_ERROR("Tarball entry name is too long.");
+        return LE_FORMAT_ERROR;
+    }
+
+    memcpy(destPtr, MetaBuffer, length);
+    destPtr[length] = '\0';
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when the current sink has had all its bytes.  Moves on to the padding after the entry's
+ * data, then to the next header.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FinishData
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    if (Sink == SINK_FILE)
+    {
+        result = CloseFile();
+    }
+    else if (Sink == SINK_META)
+    {
+        result = FinishMeta();
+    }
+
+    BytesLeft = PaddingBytes;
+    PaddingBytes = 0;
+    Sink = (BytesLeft > 0) ? SINK_SKIP : SINK_HEADER;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Direct an entry's data into a sink.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartData
+(
+    int sink,               ///< Where the data goes (SINK_FILE, SINK_META or SINK_SKIP).
+    uint64_t size           ///< # of data bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Sink = sink;
+    BytesLeft = size;
+    PaddingBytes = (TAR_BLOCK_BYTES - (size % TAR_BLOCK_BYTES)) % TAR_BLOCK_BYTES;
+    MetaBytes = 0;
+
+    return (size == 0) ? FinishData() : LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a header string field that may not be null-terminated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyField
+(
+    char* destPtr,          ///< [OUT] Buffer (LIMIT_MAX_PATH_BYTES long).
+    const char* fieldPtr,
+    size_t fieldSize
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t length = strnlen(fieldPtr, fieldSize);
+
+    memcpy(destPtr, fieldPtr, length);
+    destPtr[length] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the file system object for an entry.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExtractEntry
+(
+    char typeFlag,
+    const char* namePtr,
+    const char* linkNamePtr,
+    mode_t mode,
+    uint64_t size
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    char targetPath[LIMIT_MAX_PATH_BYTES];
+
+    if (MakeEntryPath(namePtr, path) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    switch (typeFlag)
+    {
+        case '0':
+        case '7':
+        case '\0':
+
+            if (PrepareEntry(path) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            // Files with extended attributes (e.g. signatures) are never shared.
+            if ((StoreArea[0] != '\0') && (size > 0) && !HasXattrs())
+            {
+                if (fileStore_Begin(StoreArea, path, mode, size) != LE_OK)
+                {
+                    fileStore_Abort();
+                    return LE_FAULT;
+                }
+                IsStoreFile = true;
+            }
+            else
+            {
+                FileFd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+                if (FileFd == -1)
+                {
+                    LE_ERROR("Failed to create '%s' (%m).", path);
+                    return LE_FAULT;
+                }
+            }
+
+            LE_ASSERT(le_utf8_Copy(FilePath, path, sizeof(FilePath), NULL) == LE_OK);
+            FileMode = mode;
+
+            return StartData(SINK_FILE, size);
+
+        case '5':
+        {
+            struct stat st;
+
+            if (PrepareParents(path) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            if ((mkdir(path, mode) != 0) &&
+                ((errno != EEXIST) || (lstat(path, &st) != 0) || !S_ISDIR(st.st_mode)))
+            {
+                LE_ERROR("Failed to create directory '%s' (%m).", path);
+                return LE_FAULT;
+            }
+
+            // mkdir() applies the umask, so set the permissions explicitly.
+            if (chmod(path, mode) != 0)
+            {
+                LE_ERROR("Failed to set permissions of '%s' (%m).", path);
+                return LE_FAULT;
+            }
+
+            ApplyXattrs(-1, path);
+            break;
+        }
+
+        case '1':
+
+            if ((MakeEntryPath(linkNamePtr, targetPath) != LE_OK) ||
+                (PrepareEntry(path) != LE_OK))
+            {
+                return LE_FAULT;
+            }
+
+            if (link(targetPath, path) != 0)
+            {
+                LE_ERROR("Failed to link '%s' to '%s' (%m).", path, targetPath);
+                return LE_FAULT;
+            }
+            break;
+
+        case '2':
+
+            if (PrepareEntry(path) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            if (symlink(linkNamePtr, path) != 0)
+            {
+                LE_ERROR("Failed to create symlink '%s' (%m).", path);
+                return LE_FAULT;
+            }
+
+            ApplyXattrs(-1, path);
+            break;
+
+        default:
+
+            LE_WARN("Skipping '%s' (unsupported entry type '%c').", path, typeFlag);
+            break;
+    }
+
+    return StartData(SINK_SKIP, size);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the header that has been collected in HeaderBlock.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ProcessHeader
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const TarHeader_t* headerPtr = (const TarHeader_t*)HeaderBlock;
+    char name[LIMIT_MAX_PATH_BYTES];
+    char linkName[LIMIT_MAX_PATH_BYTES];
+    uint64_t mode;
+    uint64_t size;
+
+    if (IsZeroBlock(HeaderBlock))
+    {
+        Sink = SINK_END;
+        return LE_OK;
+    }
+
+    if (!IsChecksumValid(headerPtr) ||
+        (ParseNumber(headerPtr->mode, sizeof(headerPtr->mode), &mode) != LE_OK) ||
+        (ParseNumber(headerPtr->size, sizeof(headerPtr->size), &size) != LE_OK))
+    {
+        LE_ERROR("Corrupt tarball header.");
+        return LE_FAULT;
+    }
+
+    if (MetaUsed)
+    {
+        LongName[0] = '\0';
+        LongLinkName[0] = '\0';
+        PaxBytes = 0;
+        MetaUsed = false;
+    }
+
+    switch (headerPtr->typeFlag)
+    {
+        case 'L':
+        case 'K':
+        case 'x':
+
+            if (size > sizeof(MetaBuffer))
+            {
+                LE_ERROR("Tarball extended header is too long (%" PRIu64 " bytes).", size);
+                return LE_FAULT;
+            }
+            MetaType = headerPtr->typeFlag;
+            return StartData(SINK_META, size);
+
+        case 'g':
+
+            // Global pax headers only carry comments and defaults we don't use.
+            return StartData(SINK_SKIP, size);
+    }
+
+    if (LongName[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(name, LongName, sizeof(name), NULL) == LE_OK);
+    }
+    else if ((strncmp(headerPtr->magic, "ustar", 5) == 0) && (headerPtr->prefix[0] != '\0'))
+    {
+        snprintf(name, sizeof(name), "%.*s/%.*s",
+                 (int)strnlen(headerPtr->prefix, sizeof(headerPtr->prefix)), headerPtr->prefix,
+                 (int)strnlen(headerPtr->name, sizeof(headerPtr->name)), headerPtr->name);
+    }
+    else
+    {
+        CopyField(name, headerPtr->name, sizeof(headerPtr->name));
+    }
+
+    if (LongLinkName[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(linkName, LongLinkName, sizeof(linkName), NULL) == LE_OK);
+    }
+    else
+    {
+        CopyField(linkName, headerPtr->linkName, sizeof(headerPtr->linkName));
+    }
+
+    // pax extended header records override the header's fields.
+    size_t offset = 0;
+    const char* keyPtr;
+    const char* valuePtr;
+    size_t valueLength;
+
+    while (NextPaxRecord(&offset, &keyPtr, &valuePtr, &valueLength))
+    {
+        char* destPtr = NULL;
+
+        if (strcmp(keyPtr, "path") == 0)
+        {
+            destPtr = name;
+        }
+        else if (strcmp(keyPtr, "linkpath") == 0)
+        {
+            destPtr = linkName;
+        }
+        else if (strcmp(keyPtr, "size") == 0)
+        {
+            size = strtoull(valuePtr, NULL, 10);
+        }
+
+        if ((destPtr != NULL) &&
+            (le_utf8_Copy(destPtr, valuePtr, LIMIT_MAX_PATH_BYTES, NULL) != LE_OK))
+        {
+            LE_ERROR("Tarball entry name is too long.");
+            return LE_FAULT;
+        }
+    }
+
+    MetaUsed = true;
+
+    return ExtractEntry(headerPtr->typeFlag, name, linkName, mode & 07777, size);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract the next bytes of the (decompressed) tarball.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExtractBytes
+(
+    const uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while ((length > 0) && (Sink != SINK_END))
+    {
+        size_t count = length;
+
+        if (Sink == SINK_HEADER)
+        {
+            if (count > TAR_BLOCK_BYTES - HeaderBytes)
+            {
+                count = TAR_BLOCK_BYTES - HeaderBytes;
+            }
+
+            memcpy(HeaderBlock + HeaderBytes, dataPtr, count);
+            HeaderBytes += count;
+
+            if (HeaderBytes == TAR_BLOCK_BYTES)
+            {
+                HeaderBytes = 0;
+
+                if (ProcessHeader() != LE_OK)
+                {
+                    return LE_FAULT;
+                }
+            }
+        }
+        else
+        {
+            if (count > BytesLeft)
+            {
+                count = BytesLeft;
+            }
+
+            if (Sink == SINK_FILE)
+            {
+                if (WriteToFile(dataPtr, count) != LE_OK)
+                {
+                    return LE_FAULT;
+                }
+            }
+            else if (Sink == SINK_META)
+            {
+                memcpy(MetaBuffer + MetaBytes, dataPtr, count);
+                MetaBytes += count;
+            }
+
+            BytesLeft -= count;
+
+            if ((BytesLeft == 0) && (FinishData() != LE_OK))
+            {
+                return LE_FAULT;
+            }
+        }
+
+        dataPtr += count;
+        length -= count;
+    }
+
+    return LE_OK;
+}
+
+
+#ifdef UNTAR_BZIP2
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress and extract bytes of a bzip2 compressed tarball.  Several concatenated bzip2
+ * streams (as written by parallel compressors such as pbzip2) are handled.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DecodeBzip2
+(
+    uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Bzip2Stream.next_in = (char*)dataPtr;
+    Bzip2Stream.avail_in = length;
+
+    do
+    {
+        Bzip2Stream.next_out = (char*)OutputBuffer;
+        Bzip2Stream.avail_out = sizeof(OutputBuffer);
+
+        int result = BZ2_bzDecompress(&Bzip2Stream);
+        if ((result != BZ_OK) && (result != BZ_STREAM_END))
+        {
+            LE_ERROR("bzip2 decompression failed (%d).", result);
+            return LE_FAULT;
+        }
+
+        if (ExtractBytes(OutputBuffer, sizeof(OutputBuffer) - Bzip2Stream.avail_out) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        if (result == BZ_STREAM_END)
+        {
+            char* nextInPtr = Bzip2Stream.next_in;
+            unsigned int availIn = Bzip2Stream.avail_in;
+
+            BZ2_bzDecompressEnd(&Bzip2Stream);
+            LE_ASSERT(BZ2_bzDecompressInit(&Bzip2Stream, 0, 0) == BZ_OK);
+            Bzip2Stream.next_in = nextInPtr;
+            Bzip2Stream.avail_in = availIn;
+        }
+    }
+    while (((Bzip2Stream.avail_in > 0) || (Bzip2Stream.avail_out == 0)) && (Sink != SINK_END));
+
+    return LE_OK;
+}
+#endif
+
+
+#ifdef UNTAR_XZ
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress and extract bytes of an xz compressed tarball.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DecodeXz
+(
+    uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    XzStream.next_in = dataPtr;
+    XzStream.avail_in = length;
+
+    do
+    {
+        XzStream.next_out = OutputBuffer;
+        XzStream.avail_out = sizeof(OutputBuffer);
+
+        lzma_ret result = lzma_code(&XzStream, LZMA_RUN);
+        if ((result != LZMA_OK) && (result != LZMA_STREAM_END) && (result != LZMA_BUF_ERROR))
+        {
+            LE_ERROR("xz decompression failed (%d).", result);
+            return LE_FAULT;
+        }
+
+        if (ExtractBytes(OutputBuffer, sizeof(OutputBuffer) - XzStream.avail_out) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        // LZMA_BUF_ERROR just means no progress could be made with the input given so far.
+        if (result != LZMA_OK)
+        {
+            break;
+        }
+    }
+    while (((XzStream.avail_in > 0) || (XzStream.avail_out == 0)) && (Sink != SINK_END));
+
+    return LE_OK;
+}
+#endif
+
+
+#ifdef UNTAR_ZSTD
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress and extract bytes of a Zstandard compressed tarball.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DecodeZstd
+(
+    uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ZSTD_inBuffer input = { dataPtr, length, 0 };
+    ZSTD_outBuffer output;
+
+    do
+    {
+        output.dst = OutputBuffer;
+        output.size = sizeof(OutputBuffer);
+        output.pos = 0;
+
+        size_t result = ZSTD_decompressStream(ZstdStreamPtr, &output, &input);
+        if (ZSTD_isError(result))
+        {
+            LE_ERROR("zstd decompression failed (%s).", ZSTD_getErrorName(result));
+            return LE_FAULT;
+        }
+
+        if (ExtractBytes(OutputBuffer, output.pos) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+    while (((input.pos < input.size) || (output.pos == output.size)) && (Sink != SINK_END));
+
+    return LE_OK;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up the decompressor for the tarball's encoding.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartDecoder
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (Encoding)
+    {
+#ifdef UNTAR_BZIP2
+        case UNTAR_ENCODING_BZIP2:
+            memset(&Bzip2Stream, 0, sizeof(Bzip2Stream));
+            LE_ASSERT(BZ2_bzDecompressInit(&Bzip2Stream, 0, 0) == BZ_OK);
+            break;
+#endif
+#ifdef UNTAR_XZ
+        case UNTAR_ENCODING_XZ:
+            LE_ASSERT(lzma_stream_decoder(&XzStream, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK);
+            break;
+#endif
+#ifdef UNTAR_ZSTD
+        case UNTAR_ENCODING_ZSTD:
+            ZstdStreamPtr = ZSTD_createDStream();
+            LE_ASSERT(ZstdStreamPtr != NULL);
+            LE_ASSERT(!ZSTD_isError(ZSTD_initDStream(ZstdStreamPtr)));
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress and extract the next bytes read from the pipe.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Decode
+(
+    uint8_t* dataPtr,
+    size_t length
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (Encoding)
+    {
+#ifdef UNTAR_BZIP2
+        case UNTAR_ENCODING_BZIP2:
+            return DecodeBzip2(dataPtr, length);
+#endif
+#ifdef UNTAR_XZ
+        case UNTAR_ENCODING_XZ:
+            return DecodeXz(dataPtr, length);
+#endif
+#ifdef UNTAR_ZSTD
+        case UNTAR_ENCODING_ZSTD:
+            return DecodeZstd(dataPtr, length);
+#endif
+        default:
+            return ExtractBytes(dataPtr, length);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the decompressor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopDecoder
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (Encoding)
+    {
+#ifdef UNTAR_BZIP2
+        case UNTAR_ENCODING_BZIP2:
+            BZ2_bzDecompressEnd(&Bzip2Stream);
+            break;
+#endif
+#ifdef UNTAR_XZ
+        case UNTAR_ENCODING_XZ:
+            lzma_end(&XzStream);
+            break;
+#endif
+#ifdef UNTAR_ZSTD
+        case UNTAR_ENCODING_ZSTD:
+            ZSTD_freeDStream(ZstdStreamPtr);
+            ZstdStreamPtr = NULL;
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the whole tarball from the pipe and extract it.  Everything after the end of the archive
+ * is read and ignored, so the writer never blocks.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Extract
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    StartDecoder();
+
+    while (result == LE_OK)
+    {
+        ssize_t readResult = read(ReadFd, InputBuffer, sizeof(InputBuffer));
+
+        if (readResult > 0)
+        {
+            if (Sink != SINK_END)
+            {
+                result = Decode(InputBuffer, readResult);
+            }
+        }
+        else if (readResult == 0)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Failed to read tarball (%m).");
+            result = LE_FAULT;
+        }
+    }
+
+    if ((result == LE_OK) && (Sink != SINK_END))
+    {
+        LE_ERROR("Tarball is truncated.");
+        result = LE_FAULT;
+    }
+
+    if (FileFd != -1)
+    {
+        fd_Close(FileFd);
+        FileFd = -1;
+    }
+
+    fileStore_Abort();
+    IsStoreFile = false;
+
+    StopDecoder();
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called on the thread that started an extraction when the worker thread has finished it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportDone
+(
+    void* generationPtr,    ///< The extraction's Generation.
+    void* resultPtr         ///< The extraction's le_result_t.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Ignore extractions that have been stopped.
+    if ((WorkerThread == NULL) || ((uintptr_t)generationPtr != Generation))
+    {
+        return;
+    }
+
+    LE_ASSERT(le_thread_Join(WorkerThread, NULL) == LE_OK);
+    WorkerThread = NULL;
+
+    DoneHandler((le_result_t)(intptr_t)resultPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* generationPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = Extract();
+
+    // Closing the pipe makes the writer fail instead of blocking if the extraction failed early.
+    fd_Close(ReadFd);
+    ReadFd = -1;
+
+    le_event_QueueFunctionToThread(StartThread, ReportDone, generationPtr,
+                                   (void*)(intptr_t)result);
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up an encoding by the name used for it in update pack JSON headers.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the name is not a known encoding.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_GetEncoding
+(
+    const char* namePtr,                ///< [IN] Encoding name, e.g. "xz".
+    untar_Encoding_t* encodingPtr       ///< [OUT] The encoding.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const char* const names[] =
+    {
+        [UNTAR_ENCODING_NONE] = "none",
+        [UNTAR_ENCODING_BZIP2] = "bzip2",
+        [UNTAR_ENCODING_XZ] = "xz",
+        [UNTAR_ENCODING_ZSTD] = "zstd",
+    };
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(names); i++)
+    {
+        if (strcmp(namePtr, names[i]) == 0)
+        {
+            *encodingPtr = i;
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether tarballs with a given encoding can be extracted in-process.
+ *
+ * @return true if untar_Start() can be used for the encoding.
+ */
+//--------------------------------------------------------------------------------------------------
+bool untar_IsSupported
+(
+    untar_Encoding_t encoding           ///< [IN] The encoding.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (encoding)
+    {
+        case UNTAR_ENCODING_NONE:
+            return true;
+#ifdef UNTAR_BZIP2
+        case UNTAR_ENCODING_BZIP2:
+            return true;
+#endif
+#ifdef UNTAR_XZ
+        case UNTAR_ENCODING_XZ:
+            return true;
+#endif
+#ifdef UNTAR_ZSTD
+        case UNTAR_ENCODING_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a tarball into a directory.
+ *
+ * @return The (blocking) fd to write the tarball to.
+ */
+//--------------------------------------------------------------------------------------------------
+int untar_Start
+(
+    const char* dirPath,                ///< [IN] Directory to extract into (must exist).
+    const char* storeAreaPtr,           ///< [IN] File store area (app name), or NULL for none.
+    untar_Encoding_t encoding,          ///< [IN] How the tarball is compressed.
+    untar_DoneHandler_t handler         ///< [IN] Called when the extraction has finished.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fds[2];
+
+    LE_ASSERT(WorkerThread == NULL);
+    LE_ASSERT(untar_IsSupported(encoding));
+    LE_FATAL_IF(le_utf8_Copy(DirPath, dirPath, sizeof(DirPath), NULL) != LE_OK,
+                "Unpack path '%s' is too long.", dirPath);
+    LE_FATAL_IF(pipe2(fds, O_CLOEXEC) == -1, "Can't create pipe. errno: %d (%m)", errno);
+
+    StoreArea[0] = '\0';
+    if ((storeAreaPtr != NULL) && fileStore_IsValidArea(storeAreaPtr))
+    {
+        LE_ASSERT(le_utf8_Copy(StoreArea, storeAreaPtr, sizeof(StoreArea), NULL) == LE_OK);
+    }
+
+    Encoding = encoding;
+    ReadFd = fds[0];
+    Sink = SINK_HEADER;
+    HeaderBytes = 0;
+    BytesLeft = 0;
+    PaddingBytes = 0;
+    LongName[0] = '\0';
+    LongLinkName[0] = '\0';
+    PaxBytes = 0;
+    MetaUsed = false;
+
+    DoneHandler = handler;
+    StartThread = le_thread_GetCurrent();
+    Generation++;
+
+    WorkerThread = le_thread_Create("untar", WorkerMain, (void*)(uintptr_t)Generation);
+    le_thread_SetJoinable(WorkerThread);
+    le_thread_Start(WorkerThread);
+
+    return fds[1];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for an extraction to stop, without calling its completion handler.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Stop
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (WorkerThread != NULL)
+    {
+        // The pipe's write end has been closed, so the worker thread will see the end of the
+        // tarball (or has already failed) and exit.
+        LE_ASSERT(le_thread_Join(WorkerThread, NULL) == LE_OK);
+        WorkerThread = NULL;
+    }
+}
@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.h
+ *
+ * In-process tarball extractor used by the Update Unpacker.  It unpacks an update pack payload
+ * on a worker thread instead of forking tar and bzip2 processes.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UNTAR_H_INCLUDE_GUARD
+#define LEGATO_UNTAR_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How the tarball in an update pack section is compressed.  This is given by the optional
+ * "encoding" member of the section's JSON header, and is bzip2 if there isn't one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    UNTAR_ENCODING_NONE,    ///< Plain tarball ("none").
+    UNTAR_ENCODING_BZIP2,   ///< bzip2 compressed tarball ("bzip2").
+    UNTAR_ENCODING_XZ,      ///< xz compressed tarball ("xz").
+    UNTAR_ENCODING_ZSTD,    ///< Zstandard compressed tarball ("zstd").
+}
+untar_Encoding_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called on the thread that started the extraction when it finishes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*untar_DoneHandler_t)
+(
+    le_result_t result      ///< LE_OK if the whole tarball was extracted, LE_FAULT otherwise.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up an encoding by the name used for it in update pack JSON headers.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the name is not a known encoding.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_GetEncoding
+(
+    const char* namePtr,                ///< [IN] Encoding name, e.g. "xz".
+    untar_Encoding_t* encodingPtr       ///< [OUT] The encoding.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether tarballs with a given encoding can be extracted in-process.  This depends on
+ * which decompression libraries the Update Daemon was built with.  Other encodings have to be
+ * unpacked with an external tar.
+ *
+ * @return true if untar_Start() can be used for the encoding.
+ */
+//--------------------------------------------------------------------------------------------------
+bool untar_IsSupported
+(
+    untar_Encoding_t encoding           ///< [IN] The encoding.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a tarball into a directory.  The tarball is written to the returned fd, and is
+ * decompressed and extracted on a worker thread.  Closing the fd marks the end of the tarball.
+ *
+ * The owners and modification times of entries are not restored, their permissions are.
+ *
+ * If a file store area is given, regular files are extracted through the file store (see
+ * fileStore.h), so files already stored in that area are linked instead of written again.
+ *
+ * @return The (blocking) fd to write the tarball to.
+ *
+ * @note Only one tarball can be extracted at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+int untar_Start
+(
+    const char* dirPath,                ///< [IN] Directory to extract into (must exist).
+    const char* storeAreaPtr,           ///< [IN] File store area (app name), or NULL for none.
+    untar_Encoding_t encoding,          ///< [IN] How the tarball is compressed.
+    untar_DoneHandler_t handler         ///< [IN] Called when the extraction has finished.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for an extraction to stop, without calling its completion handler.  The fd returned by
+ * untar_Start() must have been closed already.  Does nothing if no extraction is running.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Stop
+(
+    void
+);
+
+
+#endif // LEGATO_UNTAR_H_INCLUDE_GUARD
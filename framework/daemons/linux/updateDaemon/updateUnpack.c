@@ -5,7 +5,8 @@
  * Implementation of the Update Pack parser.  This file parses an update pack, and drives the
  * rest of the update based on the contents of the update pack.
  *
- * This is single-threaded, event-driven code that shares the main thread's event loop.
+ * This is single-threaded, event-driven code that shares the main thread's event loop.  Payload
+ * tarballs are extracted by a worker thread (see untar.c) or by an external tar process.
  *
  * Copyright (C) Sierra Wireless Inc.
  */
@@ -19,6 +20,9 @@
 #include "fileDescriptor.h"
 #include "system.h"
 #include "app.h"
+#include "untar.h"
+
+#include <sys/ioctl.h>
 
 
 /// An MD5 hash string is 32 characters long, plus a null terminator.
@@ -55,6 +59,12 @@ static char AppName[LIMIT_MAX_APP_NAME_BYTES];
 /// The MD5 hash obtained from a JSON header.
 static char Md5[MD5_STRING_BYTES]; ///< The system's MD5 hash.
 
+/// MD5 hash of the system a delta system update applies to, or empty if it is a full update.
+static char DeltaFromMd5[MD5_STRING_BYTES];
+
+/// How the payload is compressed, from the JSON header's optional "encoding" member.
+static untar_Encoding_t Encoding;
+
 /// # of bytes of payload following the JSON.
 static size_t PayloadSize;
 
@@ -64,6 +74,15 @@ static size_t PayloadBytesCopied;
 /// Percentage complete on current task.
 static unsigned int PercentDone;
 
+/// Size of the buffer payload bytes are read into when they can't be spliced.
+#define COPY_BUFFER_BYTES (64 * 1024)
+
+/// Buffer payload bytes are read into when they can't be spliced, or when they are discarded.
+static uint8_t CopyBuffer[COPY_BUFFER_BYTES] __attribute__((aligned(64)));
+
+/// false if splice() doesn't work for the input fd, so payload is copied through CopyBuffer.
+static bool CanSplice = true;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -182,6 +201,9 @@ static void Reset
         PipelineFd = -1;
     }
 
+    // Wait for an in-process extraction to notice its input has gone.
+    untar_Stop();
+
     // Delete the pipeline.
     if (Pipeline != NULL)
     {
@@ -358,6 +380,8 @@ static void StartParsing
     Command[0] = '\0';
     AppName[0] = '\0';
     Md5[0] = '\0';
+    DeltaFromMd5[0] = '\0';
+    Encoding = UNTAR_ENCODING_BZIP2;
     PayloadSize = 0;
 
     // Set the state
@@ -370,38 +394,15 @@ static void StartParsing
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Completion callback for "tar xj" operation.
+ * Called when a payload tarball has been successfully unpacked.
  */
 //--------------------------------------------------------------------------------------------------
-static void UntarDone
+static void PayloadUnpacked
 (
-    pipeline_Ref_t pipeline,
-    int status
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    pipeline_Delete(Pipeline);
-    Pipeline = NULL;
-
-    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
-    {
-        if (WIFEXITED(status))
-        {
-            LE_ERROR("Payload unpack pipeline failed with exit code: %d", WEXITSTATUS(status));
-        }
-        else if (WIFSIGNALED(status))
-        {
-            LE_ERROR("Payload unpack pipeline killed by signal: %d", WTERMSIG(status));
-        }
-        else
-        {
-            LE_ERROR("Payload unpack pipeline died for unknown reason (status: %d)", status);
-        }
-
-        HandleInternalError();
-        return;
-    }
-
     // If this update pack contains changes to individual apps,
     if (Type == TYPE_APP_UPDATE)
     {
@@ -418,6 +419,23 @@ static void UntarDone
         // systems.
         if (strcmp(Command, "updateSystem") == 0)
         {
+            // A delta only brings the files that changed, take the others from the current system.
+            if (DeltaFromMd5[0] != '\0')
+            {
+                le_result_t result = system_ApplyDelta();
+
+                if (result == LE_FORMAT_ERROR)
+                {
+                    HandleFormatError();
+                    return;
+                }
+                else if (result != LE_OK)
+                {
+                    HandleInternalError();
+                    return;
+                }
+            }
+
             system_RemoveUnusedApps();
         }
         // After the unpack of one of the apps, we rename the app to the appropriate location
@@ -436,6 +454,66 @@ static void UntarDone
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for "tar x" operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UntarDone
+(
+    pipeline_Ref_t pipeline,
+    int status
+)
+//--------------------------------------------------------------------------------------------------
+{
+    pipeline_Delete(Pipeline);
+    Pipeline = NULL;
+
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+    {
+        if (WIFEXITED(status))
+        {
+            LE_ERROR("Payload unpack pipeline failed with exit code: %d", WEXITSTATUS(status));
+        }
+        else if (WIFSIGNALED(status))
+        {
+            LE_ERROR("Payload unpack pipeline killed by signal: %d", WTERMSIG(status));
+        }
+        else
+        {
+            LE_ERROR("Payload unpack pipeline died for unknown reason (status: %d)", status);
+        }
+
+        HandleInternalError();
+        return;
+    }
+
+    PayloadUnpacked();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for an in-process extraction.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InProcessUntarDone
+(
+    le_result_t result
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (result != LE_OK)
+    {
+        LE_ERROR("Failed to extract payload.");
+        HandleInternalError();
+        return;
+    }
+
+    PayloadUnpacked();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Completion callback for skip forward operation that is done instead of an app unpack + install
@@ -470,10 +548,102 @@ static void SkipForwardDone
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read bytes from the input fd, retrying if interrupted by a signal.
+ *
+ * @return The number of bytes read, 0 at end of input, or -1 on error (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadInput
+(
+    void* bufferPtr,
+    size_t bytesToRead
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t readResult;
+    do
+    {
+        readResult = read(InputFd, bufferPtr, bytesToRead);
+    }
+    while ((readResult == -1) && (errno == EINTR));
+
+    return readResult;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write all of a buffer to the pipeline's input fd.
+ *
+ * @return LE_OK, or LE_FAULT on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteToPipeline
+(
+    const void* bufferPtr,
+    size_t bytesToWrite
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t bytesWritten = 0;
+
+    while (bytesWritten < bytesToWrite)
+    {
+        ssize_t writeResult = write(PipelineFd,
+                                    (const uint8_t*)bufferPtr + bytesWritten,
+                                    bytesToWrite - bytesWritten);
+        if (writeResult >= 0)
+        {
+            bytesWritten += writeResult;
+        }
+        else if (errno != EINTR)    // Retry if interrupted by a signal
+        {
+            LE_ERROR("Failed to write to output stream (%m)");
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move bytes from the input fd to the pipeline's input pipe with splice(), so that they are not
+ * copied through this process.
+ *
+ * @return The number of bytes moved, or -1 on error (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t SpliceToPipeline
+(
+    size_t bytesToMove
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t spliceResult;
+    do
+    {
+        spliceResult = splice(InputFd, NULL, PipelineFd, NULL, bytesToMove,
+                              SPLICE_F_MOVE | SPLICE_F_MORE);
+    }
+    while ((spliceResult == -1) && (errno == EINTR));
+
+    return spliceResult;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Copy bytes from the input fd to the pipeline's input fd until the input fd's read buffer is
  * empty or we have copied all the payload bytes.
+ *
+ * Bytes are spliced into the pipeline when the input fd supports it.  splice() would block on an
+ * empty input pipe even though the fd is non-blocking (SPLICE_F_NONBLOCK would avoid that, but
+ * would also stop it waiting for room in the pipeline), so only the bytes that are known to be
+ * available are spliced.  When none are, read() is used to find out whether more are coming.
  */
 //--------------------------------------------------------------------------------------------------
 static void CopyBytesToPipeline
@@ -482,28 +652,47 @@ static void CopyBytesToPipeline
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
-
     // Keep copying as much as we can until we've copied all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
-        // Compute the number of bytes to read.
-        size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
+        // Compute the number of bytes to copy.
+        size_t bytesToCopy = PayloadSize - PayloadBytesCopied;
+        ssize_t bytesCopied;
+        int available = 0;
+
+        if (CanSplice && (ioctl(InputFd, FIONREAD, &available) == 0) && (available > 0))
         {
-            bytesToRead = sizeof(buffer);
-        }
+            if (bytesToCopy > (size_t)available)
+            {
+                bytesToCopy = available;
+            }
 
-        // Read the bytes, retrying if interrupted by a signal.
-        ssize_t readResult;
-        do
+            bytesCopied = SpliceToPipeline(bytesToCopy);
+
+            if ((bytesCopied == -1) && ((errno == EINVAL) || (errno == ENOSYS)))
+            {
+                LE_INFO("Can't splice the input stream (%m); copying it instead.");
+                CanSplice = false;
+                continue;
+            }
+        }
+        else
         {
-            readResult = read(InputFd, buffer, bytesToRead);
+            if (bytesToCopy > sizeof(CopyBuffer))
+            {
+                bytesToCopy = sizeof(CopyBuffer);
+            }
+
+            bytesCopied = ReadInput(CopyBuffer, bytesToCopy);
+
+            if ((bytesCopied > 0) && (WriteToPipeline(CopyBuffer, bytesCopied) != LE_OK))
+            {
+                goto error;
+            }
         }
-        while ((readResult == -1) && (errno == EINTR));
 
         // Handle errors
-        if (readResult == -1)
+        if (bytesCopied == -1)
         {
             // EWOULDBLOCK indicates that there are currently no more bytes available to be
             // read from the fd, but more will probably become available later.
@@ -514,12 +703,12 @@ static void CopyBytesToPipeline
                 break;
             }
 
-            LE_ERROR("Failed to read from input stream (%m).");
+            LE_ERROR("Failed to copy from input stream (%m).");
             goto error;
         }
 
         // Handle end of file.
-        if (readResult == 0)
+        if (bytesCopied == 0)
         {
             LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
                      PayloadBytesCopied,
@@ -527,32 +716,8 @@ static void CopyBytesToPipeline
             goto error;
         }
 
-        // Write the bytes that we read.
-        ssize_t bytesWritten = 0;
-        ssize_t writeResult;
-        do
-        {
-            writeResult = write(PipelineFd, buffer + bytesWritten, readResult - bytesWritten);
-
-            // If some bytes were written, remember how many bytes, so we don't try to write the
-            // same bytes again if we have more to write.
-            if (writeResult > 0)
-            {
-                bytesWritten += writeResult;
-            }
-        }
-        while (   ((writeResult == -1) && (errno == EINTR)) // Retry if interrupted by a signal
-               || ((writeResult != -1) && (bytesWritten < readResult))  ); // Continue if not done
-
-        // Check for errors.
-        if (writeResult == -1)
-        {
-            LE_ERROR("Failed to write to output stream (%m)");
-            goto error;
-        }
-
         // Update the static progress variables and report progress to the client.
-        PayloadBytesCopied += readResult;
+        PayloadBytesCopied += bytesCopied;
         PercentDone = (100 * PayloadBytesCopied) / PayloadSize;
         ReportProgress();
     }
@@ -588,25 +753,18 @@ static void DiscardPayloadBytes
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
-
     // Keep reading as much as we can until we've read all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
         // Compute the number of bytes to read.
         size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
+        if (bytesToRead > sizeof(CopyBuffer))
         {
-            bytesToRead = sizeof(buffer);
+            bytesToRead = sizeof(CopyBuffer);
         }
 
         // Read the bytes, retrying if interrupted by a signal.
-        ssize_t readResult;
-        do
-        {
-            readResult = read(InputFd, buffer, bytesToRead);
-        }
-        while ((readResult == -1) && (errno == EINTR));
+        ssize_t readResult = ReadInput(CopyBuffer, bytesToRead);
 
         // Handle errors
         if (readResult == -1)
@@ -704,9 +862,30 @@ static int Untar
     // This ensures that we don't keep copies of things like the pipeline input write pipe open.
     fd_CloseAllNonStd();
 
-    // Try bsdtar first.  If that fails, fallback to tar.
-    execl("/usr/bin/bsdtar", "bsdtar", "xjmop", "-f", "-", "-C", unpackDir, (char*)NULL);
-    execl("/bin/tar", "tar", "xjop", "-C", unpackDir, (char*)NULL);
+    // Try bsdtar first.  If that fails, fallback to tar.  bsdtar detects the compression itself,
+    // tar has to be told.
+    switch (Encoding)
+    {
+        case UNTAR_ENCODING_BZIP2:
+            execl("/usr/bin/bsdtar", "bsdtar", "xjmop", "-f", "-", "-C", unpackDir, (char*)NULL);
+            execl("/bin/tar", "tar", "xjop", "-C", unpackDir, (char*)NULL);
+            break;
+
+        case UNTAR_ENCODING_XZ:
+            execl("/usr/bin/bsdtar", "bsdtar", "xmop", "-f", "-", "-C", unpackDir, (char*)NULL);
+            execl("/bin/tar", "tar", "xJop", "-C", unpackDir, (char*)NULL);
+            break;
+
+        case UNTAR_ENCODING_ZSTD:
+            execl("/usr/bin/bsdtar", "bsdtar", "xmop", "-f", "-", "-C", unpackDir, (char*)NULL);
+            execl("/bin/tar", "tar", "--zstd", "-xop", "-C", unpackDir, (char*)NULL);
+            break;
+
+        case UNTAR_ENCODING_NONE:
+            execl("/usr/bin/bsdtar", "bsdtar", "xmop", "-f", "-", "-C", unpackDir, (char*)NULL);
+            execl("/bin/tar", "tar", "xop", "-C", unpackDir, (char*)NULL);
+            break;
+    }
 
     LE_FATAL("Failed to exec tar (%m)");
 }
@@ -727,11 +906,23 @@ static void StartUntar
 
     PayloadBytesCopied = 0;
 
-    // Create a pipeline: PipelineFd -> tar
-    Pipeline = pipeline_Create();
-    PipelineFd = pipeline_CreateInputPipe(Pipeline);
-    pipeline_Append(Pipeline, Untar, (void*)dirPath);
-    pipeline_Start(Pipeline, UntarDone);
+    if (untar_IsSupported(Encoding))
+    {
+        // Extract on a worker thread: PipelineFd -> untar.  App files go through the file
+        // store, so those that haven't changed since an earlier version aren't written again.
+        PipelineFd = untar_Start(dirPath,
+                                 (strcmp(Command, "updateApp") == 0) ? AppName : NULL,
+                                 Encoding,
+                                 InProcessUntarDone);
+    }
+    else
+    {
+        // Create a pipeline: PipelineFd -> tar
+        Pipeline = pipeline_Create();
+        PipelineFd = pipeline_CreateInputPipe(Pipeline);
+        pipeline_Append(Pipeline, Untar, (void*)dirPath);
+        pipeline_Start(Pipeline, UntarDone);
+    }
 
     fd_SetNonBlocking(InputFd);
 
@@ -801,6 +992,39 @@ static void StartFirmwareUpdate
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a delta system update applies to the current system.
+ *
+ * @return true if it does.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDeltaFromCurrentSystem
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char currentMd5[LIMIT_MD5_STR_BYTES];
+
+    if (system_GetSystemHash(system_Index(), currentMd5) != LE_OK)
+    {
+        LE_ERROR("Can't apply a delta system update, the current system's MD5 hash is unknown.");
+        return false;
+    }
+
+    if (strcmp(currentMd5, DeltaFromMd5) != 0)
+    {
+        LE_ERROR("Malformed update pack (delta from system %s, but current system is %s)",
+                 DeltaFromMd5,
+                 currentMd5);
+        return false;
+    }
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handle the end of a JSON header.
@@ -832,6 +1056,10 @@ static void JsonDone
             LE_ERROR("Malformed update pack (system update payload missing)");
             HandleFormatError();
         }
+        else if ((DeltaFromMd5[0] != '\0') && !IsDeltaFromCurrentSystem())
+        {
+            HandleFormatError();
+        }
         // If everything looks good...
         else
         {
@@ -1068,6 +1296,21 @@ static void Md5EventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * "deltaFromMd5" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeltaFromMd5EventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, DeltaFromMd5, sizeof(DeltaFromMd5), "delta base MD5 hash");
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * "version" member parsing event function.
@@ -1095,6 +1338,29 @@ static void VersionEventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * "encoding" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EncodingEventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char encoding[16];
+
+    StringMemberEventHandler(event, encoding, sizeof(encoding), "encoding");
+
+    if ((State == STATE_PARSING_JSON) && (untar_GetEncoding(encoding, &Encoding) != LE_OK))
+    {
+        LE_ERROR("Malformed update pack (unknown encoding '%s').", encoding);
+        HandleFormatError();
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * "size" member parsing event function.
@@ -1191,6 +1457,14 @@ static void JsonEventHandler
             {
                 le_json_SetEventHandler(SizeEventHandler);
             }
+            else if (strcmp(memberName, "encoding") == 0)
+            {
+                le_json_SetEventHandler(EncodingEventHandler);
+            }
+            else if (strcmp(memberName, "deltaFromMd5") == 0)
+            {
+                le_json_SetEventHandler(DeltaFromMd5EventHandler);
+            }
             else
             {
                 LE_ERROR("Malformed update pack (unexpected object member '%s').", memberName);
@@ -1235,6 +1509,7 @@ void updateUnpack_Start
 
     InputFd = fd;
     InputFdClosed = false; // reset InputFdClosed since it's initialized.
+    CanSplice = true;
     ProgressFunc = progressFunc;
     PercentDone = 0;
 
@@ -84,6 +84,14 @@
  * special value often you might want to reconsider whether you really want to use a watchdog timer
  * for your process.
  *
+ * Processes that kick often can open a shared memory kick slot with le_wdog_OpenKickSlot() and
+ * then kick by storing the time in it, without sending a message.  The slot is not read on every
+ * kick.  Instead, when a watchdog's timer expires its slot is checked first, and if the process
+ * kicked since the timer was last started the timer is restarted for the rest of the timeout,
+ * counted from that kick.  A watchdog that has a slot but whose timer is not running (e.g., it was
+ * set to LE_WDOG_TIMEOUT_NEVER) is started again by a single coarse timer that scans the slots;
+ * see KICK_SLOT_SCAN_INTERVAL.
+ *
  * LE_WDOG_TIMEOUT_NOW could be used in development to see how the app responds to a timeout
  * situation though it could also be abused as a way to restart the app for some reason.
  *
@@ -109,6 +117,23 @@
 #include "fileDescriptor.h"
 #include "pa_wdog.h"
 
+#include <sys/mman.h>
+
+// Older C libraries don't provide the memfd and file sealing definitions even when the kernel
+// supports them, so fall back to the values from the kernel's UAPI headers.
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS         1033
+#endif
+#ifndef F_SEAL_SEAL
+#define F_SEAL_SEAL         0x0001
+#define F_SEAL_SHRINK       0x0002
+#define F_SEAL_GROW         0x0004
+#endif
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC         0x0001U
+#define MFD_ALLOW_SEALING   0x0002U
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The name of the node in the config tree that contains the list of all apps.
@@ -203,6 +228,23 @@
 //--------------------------------------------------------------------------------------------------
 #define NO_PROC      -1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of a shared memory kick slot: an array of uint64_t.  See le_wdog_OpenKickSlot().
+ */
+//--------------------------------------------------------------------------------------------------
+#define KICK_SLOT_TIME      0   ///< Time of the last kick, in us of le_clk_GetRelativeTime().
+#define KICK_SLOT_VALID     1   ///< Non-zero while the watchdog daemon is using the slot.
+#define KICK_SLOT_BYTES     (2 * sizeof(uint64_t))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How often the kick slots of watchdogs whose timers are not running are checked (in
+ * milliseconds).  Running watchdogs check their slot when their timer expires.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KICK_SLOT_SCAN_INTERVAL 1000
+
 //--------------------------------------------------------------------------------------------------
 /**
  * System framework configuration
@@ -240,6 +282,8 @@ typedef struct
                                         ///< beyond it's maximum period by being treated as a
                                         ///< non-mandatory watchdog.
     le_timer_Ref_t timer;               ///< The timer this watchdog uses
+    uint64_t* kickSlotPtr;              ///< The process's shared memory kick slot, or NULL
+    uint64_t lastKickUs;                ///< Time the timer was last (re)started by a kick, in us
 }
 WatchdogObj_t;
 
@@ -287,6 +331,50 @@ static le_hashmap_Ref_t MandatoryWatchdogRefs;  ///< The container used to track
 
 static le_timer_Ref_t DefaultExternalWdogTimer; ///< Default external wdog timer
 
+static le_timer_Ref_t KickSlotScanTimer;        ///< Scans the kick slots of stopped watchdogs
+static size_t NumKickSlots;                     ///< Number of open kick slots
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in microseconds of the relative clock, the clock kick slots are written
+ * with.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetRelativeTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + now.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop using a watchdog's kick slot, and tell the process so it goes back to kicking with
+ * le_wdog_Kick().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseKickSlot
+(
+    WatchdogObj_t* dogPtr
+)
+{
+    if (dogPtr->kickSlotPtr != NULL)
+    {
+        __atomic_store_n(&(dogPtr->kickSlotPtr[KICK_SLOT_VALID]), 0, __ATOMIC_RELEASE);
+        munmap(dogPtr->kickSlotPtr, KICK_SLOT_BYTES);
+        dogPtr->kickSlotPtr = NULL;
+
+        NumKickSlots--;
+        if (NumKickSlots == 0)
+        {
+            le_timer_Stop(KickSlotScanTimer);
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Remove the watchdog from our container, free the timer it contains and then free the storage
@@ -303,6 +391,7 @@ static void DeleteWatchdog
     {
         // All good. The dog was in the hash
         LE_DEBUG("Cleaning up watchdog resources for %d", deadDogPtr->procId);
+        CloseKickSlot(deadDogPtr);
         // Give the watchdog one more kick if it hasn't had one, then release it.
         // This allows mandatory watchdogs (which still exist in the MandatoryWatchdogRefs
         // one more kick to restart before they're considered expired.
@@ -464,6 +553,96 @@ static le_result_t GetAppNameFromPid
     return le_utf8_Copy(appName, (token + 1), appNameNumElements, NULL);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Construct le_clk_Time_t object that will give an interval of the provided number
+ *  of milliseconds.
+ *
+ *      @return the constructed le_clk_Time_t
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t MakeTimerInterval
+(
+    uint64_t milliseconds
+)
+{
+    le_clk_Time_t interval;
+
+    interval.sec = milliseconds / 1000;
+    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
+
+    return interval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a process has kicked its watchdog through its kick slot since the watchdog's timer
+ * was last started, and if so restart the timer for the rest of the kick timeout, counted from
+ * that kick.
+ *
+ * @return true if the watchdog was kicked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckKickSlot
+(
+    WatchdogObj_t* dogPtr
+)
+{
+    if (dogPtr->kickSlotPtr == NULL)
+    {
+        return false;
+    }
+
+    uint64_t kickUs = __atomic_load_n(&(dogPtr->kickSlotPtr[KICK_SLOT_TIME]), __ATOMIC_ACQUIRE);
+
+    if (kickUs <= dogPtr->lastKickUs)
+    {
+        return false;
+    }
+
+    uint64_t nowUs = GetRelativeTimeUs();
+    uint64_t elapsedMs = (kickUs < nowUs) ? ((nowUs - kickUs) / 1000) : 0;
+    uint64_t timeoutMs = (dogPtr->kickTimeoutInterval.sec * 1000) +
+                         (dogPtr->kickTimeoutInterval.usec / 1000);
+
+    dogPtr->lastKickUs = kickUs;
+    le_timer_Stop(dogPtr->timer);
+
+    if (!le_clk_Equal(dogPtr->kickTimeoutInterval, MakeTimerInterval(LE_WDOG_TIMEOUT_NEVER)))
+    {
+        // If the kick was so long ago that the timeout has already passed, expire right away.
+        uint64_t remainingMs = (elapsedMs < timeoutMs) ? (timeoutMs - elapsedMs) : 1;
+
+        LE_ASSERT(LE_OK == le_timer_SetInterval(dogPtr->timer, MakeTimerInterval(remainingMs)));
+        le_timer_Start(dogPtr->timer);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the kick slot of a watchdog whose timer is not running.  Called for each watchdog by
+ * le_hashmap_ForEach().
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ScanKickSlot
+(
+    const void* keyPtr,
+    const void* valuePtr,
+    void* contextPtr
+)
+{
+    WatchdogObj_t* dogPtr = (WatchdogObj_t*)valuePtr;
+
+    if ((dogPtr->kickSlotPtr != NULL) && !le_timer_IsRunning(dogPtr->timer))
+    {
+        CheckKickSlot(dogPtr);
+    }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The handler for all time outs. No registered application wants to see us get here.
@@ -479,6 +658,13 @@ static void WatchdogHandleExpiry
 )
 {
     WatchdogObj_t* watchDogPtr = le_timer_GetContextPtr(timerRef);
+
+    // The process may have kicked through its kick slot since the timer was started.
+    if (CheckKickSlot(watchDogPtr))
+    {
+        return;
+    }
+
     if (watchDogPtr->procId == NO_PROC)
     {
         // Mandatory watchdog expired without the process restarting.  Restart Legato.
@@ -525,27 +711,6 @@ static void WatchdogHandleExpiry
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Construct le_clk_Time_t object that will give an interval of the provided number
- *  of milliseconds.
- *
- *      @return the constructed le_clk_Time_t
- */
-//--------------------------------------------------------------------------------------------------
-static le_clk_Time_t MakeTimerInterval
-(
-    uint64_t milliseconds
-)
-{
-    le_clk_Time_t interval;
-
-    interval.sec = milliseconds / 1000;
-    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
-
-    return interval;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Check a regular watchdog is running.
@@ -825,6 +990,8 @@ static void InitNewWatchdog
     newDogPtr->procId = clientPid;
     newDogPtr->kickTimeoutInterval = kickTimeoutInterval;
     newDogPtr->maxKickTimeoutInterval = maxKickTimeoutInterval;
+    newDogPtr->kickSlotPtr = NULL;
+    newDogPtr->lastKickUs = 0;
 
     if (le_clk_GreaterThan(newDogPtr->kickTimeoutInterval, newDogPtr->maxKickTimeoutInterval))
     {
@@ -979,6 +1146,8 @@ static void CleanupWdog
 {
     WatchdogObj_t* deadDogPtr = objectPtr;
 
+    CloseKickSlot(deadDogPtr);
+
     // If this watchdog has a timer, delete it.
     if (deadDogPtr->timer)
     {
@@ -1038,6 +1207,8 @@ static void ResetClientWatchdog
     if (watchDogPtr != NULL)
     {
         le_timer_Stop(watchDogPtr->timer);
+        // Kicks made through the kick slot before now are superseded by this one.
+        watchDogPtr->lastKickUs = GetRelativeTimeUs();
         if (timeout == TIMEOUT_KICK)
         {
             timeoutValue = watchDogPtr->kickTimeoutInterval;
@@ -1133,6 +1304,98 @@ void le_wdog_Kick
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan the kick slots of watchdogs whose timers are not running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void KickSlotScanHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_hashmap_ForEach(WatchdogRefsContainer, ScanKickSlot, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a shared memory kick slot for the client process, so that it can kick its watchdog without
+ * sending a message each time.  Opening the slot kicks the watchdog.
+ *
+ * @return
+ *      - LE_OK                 The slot was opened.
+ *      - LE_NOT_IMPLEMENTED    Shared memory kick slots are not supported.
+ *      - LE_FAULT              The slot could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wdog_OpenKickSlot
+(
+    int* slotFdPtr
+        ///< [OUT] Shared memory file holding the kick slot
+)
+{
+    if (slotFdPtr == NULL)
+    {
+        LE_KILL_CLIENT("slotFdPtr is NULL.");
+        return LE_FAULT;
+    }
+
+    *slotFdPtr = -1;
+
+#ifdef __NR_memfd_create
+    WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
+    if (watchDogPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    int fd = syscall(__NR_memfd_create, "wdogKickSlot", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+    {
+        if (errno == ENOSYS)
+        {
+            return LE_NOT_IMPLEMENTED;
+        }
+        LE_ERROR("memfd_create() failed (%m).");
+        return LE_FAULT;
+    }
+
+    // Seal the size so the client can't truncate the file under our mapping.
+    uint64_t* slotPtr = MAP_FAILED;
+    if (   (ftruncate(fd, KICK_SLOT_BYTES) != 0)
+        || (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+        || ((slotPtr = mmap(NULL, KICK_SLOT_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0))
+                == MAP_FAILED))
+    {
+        LE_ERROR("Failed to create kick slot (%m).");
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    // Replace any slot the process opened before.
+    CloseKickSlot(watchDogPtr);
+
+    slotPtr[KICK_SLOT_TIME] = 0;
+    __atomic_store_n(&(slotPtr[KICK_SLOT_VALID]), 1, __ATOMIC_RELEASE);
+    watchDogPtr->kickSlotPtr = slotPtr;
+
+    NumKickSlots++;
+    if (!le_timer_IsRunning(KickSlotScanTimer))
+    {
+        le_timer_Start(KickSlotScanTimer);
+    }
+
+    ResetClientWatchdog(TIMEOUT_KICK);
+
+    *slotFdPtr = fd;
+    return LE_OK;
+#else
+    return LE_NOT_IMPLEMENTED;
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the watchdog timeout configured for this process
@@ -1526,6 +1789,13 @@ COMPONENT_INIT
     le_timer_SetRepeat(DefaultExternalWdogTimer, 0); // repeat indefinitely
     le_timer_SetWakeup(DefaultExternalWdogTimer, false);
     le_timer_Start(DefaultExternalWdogTimer);
+
+    // Create the timer that scans kick slots; it only runs while there are slots open.
+    KickSlotScanTimer = le_timer_Create("KickSlotScanTimer");
+    le_timer_SetMsInterval(KickSlotScanTimer, KICK_SLOT_SCAN_INTERVAL);
+    le_timer_SetHandler(KickSlotScanTimer, KickSlotScanHandler);
+    le_timer_SetRepeat(KickSlotScanTimer, 0); // repeat indefinitely
+    le_timer_SetWakeup(KickSlotScanTimer, false);
     pa_wdog_Init();
 
     LE_INFO("The watchdog service is ready");
@@ -0,0 +1,247 @@
+/**
+ * @page c_arena Arena Allocator API
+ *
+ * @ref le_arena.h "API Reference"
+ *
+ * <HR>
+ *
+ * An arena (also known as a region) hands out memory for many small objects that all go away at
+ * the same time, such as the objects built up while handling one request.  Allocating from an arena
+ * just moves a pointer along a chunk of memory, with no locking, reference counting or per-object
+ * header, and all the objects are freed together by resetting the arena.  Individual objects can't
+ * be released.
+ *
+ * Arenas are not thread safe.  Each arena must only be used by one thread at a time.
+ *
+ *
+ * @section arena_create Setting Up an Arena
+ *
+ * An arena is a plain structure that can be declared as a variable or embedded in another
+ * structure.  It is initialized with le_arena_Init(), which takes the memory pool its chunks
+ * come from.  The pool's object size is the chunk size.  Passing NULL uses a pool of
+ * @ref LE_ARENA_DEFAULT_CHUNK_BYTES byte chunks shared by all arenas in the process.  Chunk pools
+ * show up in the Inspect tool like any other pool.
+ *
+ * No memory is taken from the pool until the first allocation.
+ *
+ *
+ * @section arena_alloc Allocating
+ *
+ * le_arena_TryAlloc() and le_arena_ForceAlloc() allocate a block from the arena, aligned for
+ * integer, floating point and pointer types.  Like the @ref mem_allocating "memory pool" functions
+ * of the same name, the Try version returns NULL if the chunk pool is exhausted and the Force
+ * version expands it.  The contents of the block are undefined.  le_arena_StrDup() copies a string
+ * into the arena.
+ *
+ * Blocks too big to share a chunk with other blocks are allocated from the heap on their own and
+ * freed when the arena is reset.
+ *
+ *
+ * @section arena_reset Resetting and Rewinding
+ *
+ * le_arena_Reset() frees everything allocated from the arena at once.  The arena keeps its chunks
+ * so that they can be filled again without going back to the chunk pool, which makes resetting
+ * and refilling an arena for each request cheap.  le_arena_Free() also gives the chunks back to the
+ * chunk pool.
+ *
+ * Objects that are created and destroyed in last-in-first-out order, like the levels of a
+ * recursive parser, can be freed more selectively: le_arena_GetMark() records how much of the
+ * arena is in use, and le_arena_Rewind() frees everything allocated after the mark.
+ *
+ * @code
+ * static le_arena_Arena_t RequestArena;
+ *
+ * COMPONENT_INIT
+ * {
+ *     le_arena_Init(&RequestArena, NULL);
+ * }
+ *
+ * static void HandleRequest(const char* requestPtr)
+ * {
+ *     Request_t* reqPtr = le_arena_ForceAlloc(&RequestArena, sizeof(Request_t));
+ *
+ *     reqPtr->namePtr = le_arena_StrDup(&RequestArena, requestPtr);
+ *     ...
+ *
+ *     le_arena_Reset(&RequestArena);
+ * }
+ * @endcode
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/** @file le_arena.h
+ *
+ * Legato @ref c_arena include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_ARENA_INCLUDE_GUARD
+#define LEGATO_ARENA_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the chunks in the pool used by arenas that aren't given a chunk pool of their own.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_ARENA_DEFAULT_CHUNK_BYTES    4096
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk of memory an arena allocates from.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_arena_Chunk le_arena_Chunk_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An arena.  See @ref c_arena.
+ *
+ * @warning The members must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mem_PoolRef_t    chunkPool;          ///< Pool the chunks come from.
+    le_arena_Chunk_t*   firstChunkPtr;      ///< First chunk, or NULL if none has been taken yet.
+    le_arena_Chunk_t*   currentChunkPtr;    ///< Chunk being allocated from, or NULL if none.
+    size_t              offset;             ///< Bytes in use in the current chunk.
+    le_arena_Chunk_t*   largeBlocksPtr;     ///< Blocks allocated on their own, newest first.
+}
+le_arena_Arena_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How much of an arena is in use.  See le_arena_GetMark().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_arena_Chunk_t*   chunkPtr;           ///< Chunk being allocated from.
+    size_t              offset;             ///< Bytes in use in that chunk.
+    le_arena_Chunk_t*   largeBlocksPtr;     ///< Newest block allocated on its own.
+}
+le_arena_Mark_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty arena.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Init
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    le_mem_PoolRef_t    chunkPool   ///< [IN] Pool to take chunks from, or NULL to use the default
+                                    ///       chunk pool.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena.
+ *
+ * @return Pointer to the block, or NULL if the chunk pool is exhausted.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_TryAlloc
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size        ///< [IN] Size of the block, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena, expanding the chunk pool if it is exhausted.
+ *
+ * @return Pointer to the block.
+ *
+ * @note The process exits if the memory can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_ForceAlloc
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size        ///< [IN] Size of the block, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a string into an arena.
+ *
+ * @return Pointer to the copy.
+ *
+ * @note The process exits if the memory can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_arena_StrDup
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    const char*         strPtr      ///< [IN] String to copy.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records how much of an arena is in use, so that it can be rewound to this point with
+ * le_arena_Rewind().
+ *
+ * @return The mark.
+ */
+//--------------------------------------------------------------------------------------------------
+le_arena_Mark_t le_arena_GetMark
+(
+    const le_arena_Arena_t* arenaPtr    ///< [IN] The arena.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena since a mark was taken.
+ *
+ * @warning The mark must not be older than the last reset, or than another mark that has already
+ *          been rewound to.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Rewind
+(
+    le_arena_Arena_t*       arenaPtr,   ///< [IN] The arena.
+    const le_arena_Mark_t*  markPtr     ///< [IN] Mark returned by le_arena_GetMark().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena, keeping its chunks for later allocations.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Reset
+(
+    le_arena_Arena_t*   arenaPtr    ///< [IN] The arena.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena and gives its chunks back to the chunk pool.  The arena
+ * can be used again afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Free
+(
+    le_arena_Arena_t*   arenaPtr    ///< [IN] The arena.
+);
+
+
+#endif // LEGATO_ARENA_INCLUDE_GUARD
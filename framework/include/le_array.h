@@ -0,0 +1,730 @@
+/**
+ * @page c_array Array Containers API
+ *
+ * @ref le_array.h "API Reference"
+ *
+ * <HR>
+ *
+ * The array containers keep their elements in a single contiguous block of memory, rather than in
+ * separately allocated nodes like the @ref c_doublyLinkedList and @ref c_singlyLinkedList.
+ * Walking through contiguous elements makes good use of the CPU cache, and finding an element by
+ * index, by priority or by key doesn't require scanning the whole container.  In exchange,
+ * elements are copied into the container (rather than linked into it) and move around in memory
+ * when the container grows or changes, so pointers to elements are only valid until the container
+ * is next modified.
+ *
+ * Four containers are provided:
+ *  - @ref array_vector "vectors" (@c le_vec_), growable arrays;
+ *  - @ref array_ring "ring buffers" (@c le_ring_), growable first-in-first-out queues;
+ *  - @ref array_heap "heaps" (@c le_heap_), priority queues;
+ *  - @ref array_map "array maps" (@c le_amap_), maps kept sorted by key.
+ *
+ *
+ * @section array_storage Storage
+ *
+ * A container's elements are stored in a block allocated from a @ref mem_slabs "slab allocator"
+ * given to the container when it is initialized.  When the container is full, it moves its
+ * elements to a block from the next size class up and releases the old one.  The size classes are
+ * ordinary memory pools, so the memory used by containers shows up in the Inspect tool under the
+ * slab allocator's name, and can be reserved up front with le_mem_ExpandSlabAllocator().  The
+ * largest container is limited by the slab allocator's maximum object size.
+ *
+ * Any number of containers can share a slab allocator.
+ *
+ * The containers are plain structures that can be declared as variables or embedded in other
+ * structures.  They must be initialized with their @c Init function before use, and their storage
+ * is released with their @c Free function.  <b> The members of the container structures must not be
+ * accessed directly. </b>
+ *
+ * The containers are not thread safe.
+ *
+ *
+ * @section array_vector Vectors
+ *
+ * A vector is an array that grows as elements are added.  Elements are accessed by index with
+ * le_vec_Get().  le_vec_Append() and le_vec_Insert() make room for a new element (zero-filled) and
+ * return a pointer to it, to be filled in by the caller.
+ *
+ * @code
+ * static le_vec_Vector_t Samples;
+ *
+ * COMPONENT_INIT
+ * {
+ *     le_mem_SlabRef_t slab = le_mem_CreateSlabAllocator("Samples", 4096);
+ *     le_vec_Init(&Samples, slab, sizeof(Sample_t));
+ * }
+ *
+ * static void AddSample(const Sample_t* samplePtr)
+ * {
+ *     *(Sample_t*)le_vec_Append(&Samples) = *samplePtr;
+ * }
+ *
+ * static void PrintSamples(void)
+ * {
+ *     size_t i;
+ *     for (i = 0; i < le_vec_NumElems(&Samples); i++)
+ *     {
+ *         PrintSample(le_vec_Get(&Samples, i));
+ *     }
+ * }
+ * @endcode
+ *
+ *
+ * @section array_ring Ring Buffers
+ *
+ * A ring buffer is a first-in-first-out queue.  Elements are added at the back with
+ * le_ring_PushBack() and removed from the front with le_ring_PopFront().  Unlike a vector, removing
+ * from the front doesn't move the other elements.
+ *
+ *
+ * @section array_heap Heaps
+ *
+ * A heap is a priority queue: le_heap_Pop() always removes the element that comes first according
+ * to the compare function the heap was initialized with.  Adding and removing elements take time
+ * proportional to the logarithm of the number of elements.  Elements that compare equal are not
+ * removed in any particular order.
+ *
+ * @code
+ * static int CompareDeadlines(const void* aPtr, const void* bPtr)
+ * {
+ *     return le_clk_GreaterThan(((const Job_t*)aPtr)->deadline, ((const Job_t*)bPtr)->deadline)
+ *            - le_clk_GreaterThan(((const Job_t*)bPtr)->deadline, ((const Job_t*)aPtr)->deadline);
+ * }
+ *
+ * le_heap_Init(&Jobs, slab, sizeof(Job_t), CompareDeadlines);
+ * le_heap_Push(&Jobs, &job);
+ * ...
+ * Job_t nextJob;
+ * if (le_heap_Pop(&Jobs, &nextJob))
+ * {
+ *     ...
+ * }
+ * @endcode
+ *
+ *
+ * @section array_map Array Maps
+ *
+ * An array map holds elements sorted by a key stored in the elements, and finds them by binary
+ * search.  It uses less memory than a @ref c_hashmap "hash map" and can be iterated in key order
+ * with le_amap_GetAt(), but adding and removing elements moves the elements after them, so it is
+ * best suited to maps that are searched much more often than they are changed.
+ *
+ * The compare function is given a key and an element.  le_amap_Insert() returns the element with
+ * the given key, or makes room for a new element (zero-filled) at the right place for the key.
+ * The caller must then store the key in the new element.
+ *
+ * @code
+ * static int CompareId(const void* keyPtr, const void* elemPtr)
+ * {
+ *     uint32_t id = *(const uint32_t*)keyPtr;
+ *     uint32_t elemId = ((const Field_t*)elemPtr)->id;
+ *
+ *     return (id > elemId) - (id < elemId);
+ * }
+ *
+ * bool isNew;
+ * Field_t* fieldPtr = le_amap_Insert(&Fields, &id, &isNew);
+ * if (isNew)
+ * {
+ *     fieldPtr->id = id;
+ * }
+ * @endcode
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/** @file le_array.h
+ *
+ * Legato @ref c_array include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_ARRAY_INCLUDE_GUARD
+#define LEGATO_ARRAY_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A vector.  See @ref array_vector.
+ *
+ * @warning The members must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mem_SlabRef_t    slab;       ///< Slab allocator the storage comes from.
+    uint8_t*            elemsPtr;   ///< Storage, or NULL if none has been allocated yet.
+    size_t              elemSize;   ///< Size of an element, in bytes.
+    size_t              numElems;   ///< Number of elements in the vector.
+    size_t              capacity;   ///< Number of elements the storage can hold.
+}
+le_vec_Vector_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A ring buffer.  See @ref array_ring.
+ *
+ * @warning The members must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mem_SlabRef_t    slab;       ///< Slab allocator the storage comes from.
+    uint8_t*            elemsPtr;   ///< Storage, or NULL if none has been allocated yet.
+    size_t              elemSize;   ///< Size of an element, in bytes.
+    size_t              head;       ///< Index in the storage of the front element.
+    size_t              numElems;   ///< Number of elements in the ring buffer.
+    size_t              capacity;   ///< Number of elements the storage can hold.
+}
+le_ring_Buffer_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for heap compare functions.
+ *
+ * @return
+ *      Less than zero if the first element must come out of the heap before the second one,
+ *      greater than zero if it must come out after, and zero if it doesn't matter.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef int (*le_heap_CompareFunc_t)
+(
+    const void* firstElemPtr,
+    const void* secondElemPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A heap.  See @ref array_heap.
+ *
+ * @warning The members must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_vec_Vector_t         vec;            ///< The elements, in heap order.
+    le_heap_CompareFunc_t   compareFunc;    ///< Function that orders the elements.
+}
+le_heap_Heap_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for array map compare functions.
+ *
+ * @return
+ *      Less than zero if the key comes before the element's key, greater than zero if it comes
+ *      after, and zero if the keys are equal.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef int (*le_amap_CompareFunc_t)
+(
+    const void* keyPtr,
+    const void* elemPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An array map.  See @ref array_map.
+ *
+ * @warning The members must not be accessed directly.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_vec_Vector_t         vec;            ///< The elements, in key order.
+    le_amap_CompareFunc_t   compareFunc;    ///< Function that compares keys with elements.
+}
+le_amap_Map_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Vectors.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty vector.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Init
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator to allocate the storage from.
+    size_t              elemSize    ///< [IN] Size of an element, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure a vector can hold at least a given number of elements without growing.
+ *
+ * @note The process exits if the storage would be larger than the slab allocator's maximum object
+ *       size.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Reserve
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              numElems    ///< [IN] Number of elements.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a zero-filled element at the end of a vector.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the vector can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_vec_Append
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inserts a zero-filled element in a vector, moving the elements at and after the index up by one.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the index is greater than the number of elements, or if the vector
+ *       can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_vec_Insert
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              index       ///< [IN] Index of the new element.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes an element from a vector, moving the elements after it down by one.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Remove
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              index       ///< [IN] Index of the element.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a vector, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Clear
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a vector and releases its storage.  The vector can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Free
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of elements in a vector.
+ *
+ * @return Number of elements.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t le_vec_NumElems
+(
+    const le_vec_Vector_t*  vecPtr  ///< [IN] The vector.
+)
+{
+    return vecPtr->numElems;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an element of a vector.
+ *
+ * @return Pointer to the element, valid until the vector is next modified.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void* le_vec_Get
+(
+    const le_vec_Vector_t*  vecPtr, ///< [IN] The vector.
+    size_t                  index   ///< [IN] Index of the element.
+)
+{
+    LE_ASSERT(index < vecPtr->numElems);
+
+    return vecPtr->elemsPtr + (index * vecPtr->elemSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Ring buffers.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty ring buffer.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Init
+(
+    le_ring_Buffer_t*   ringPtr,    ///< [IN] The ring buffer.
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator to allocate the storage from.
+    size_t              elemSize    ///< [IN] Size of an element, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a zero-filled element at the back of a ring buffer.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the ring buffer can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_PushBack
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element at the front of a ring buffer.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if the ring buffer was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_ring_PopFront
+(
+    le_ring_Buffer_t*   ringPtr,    ///< [IN] The ring buffer.
+    void*               destPtr     ///< [OUT] Where to copy the element, or NULL to discard it.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an element of a ring buffer.  Index 0 is the front element.
+ *
+ * @return Pointer to the element, valid until the ring buffer is next modified.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_Get
+(
+    const le_ring_Buffer_t* ringPtr,    ///< [IN] The ring buffer.
+    size_t                  index       ///< [IN] Index of the element.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the front element of a ring buffer without removing it.
+ *
+ * @return Pointer to the element, or NULL if the ring buffer is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_PeekFront
+(
+    const le_ring_Buffer_t* ringPtr     ///< [IN] The ring buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a ring buffer, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Clear
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a ring buffer and releases its storage.  The ring buffer can be
+ * used again afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Free
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of elements in a ring buffer.
+ *
+ * @return Number of elements.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t le_ring_NumElems
+(
+    const le_ring_Buffer_t* ringPtr     ///< [IN] The ring buffer.
+)
+{
+    return ringPtr->numElems;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Heaps.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty heap.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Init
+(
+    le_heap_Heap_t*         heapPtr,        ///< [IN] The heap.
+    le_mem_SlabRef_t        slab,           ///< [IN] Slab allocator to allocate the storage from.
+    size_t                  elemSize,       ///< [IN] Size of an element, in bytes.
+    le_heap_CompareFunc_t   compareFunc     ///< [IN] Function that orders the elements.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a copy of an element to a heap.
+ *
+ * @note The process exits if the heap can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Push
+(
+    le_heap_Heap_t*     heapPtr,    ///< [IN] The heap.
+    const void*         elemPtr     ///< [IN] Element to copy into the heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the element that comes first in a heap without removing it.
+ *
+ * @return Pointer to the element, or NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_heap_Peek
+(
+    const le_heap_Heap_t*   heapPtr     ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element that comes first in a heap.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if the heap was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_heap_Pop
+(
+    le_heap_Heap_t*     heapPtr,    ///< [IN] The heap.
+    void*               destPtr     ///< [OUT] Where to copy the element, or NULL to discard it.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a heap, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Clear
+(
+    le_heap_Heap_t*     heapPtr     ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a heap and releases its storage.  The heap can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Free
+(
+    le_heap_Heap_t*     heapPtr     ///< [IN] The heap.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of elements in a heap.
+ *
+ * @return Number of elements.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t le_heap_NumElems
+(
+    const le_heap_Heap_t*   heapPtr     ///< [IN] The heap.
+)
+{
+    return heapPtr->vec.numElems;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Array maps.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty array map.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Init
+(
+    le_amap_Map_t*          mapPtr,         ///< [IN] The array map.
+    le_mem_SlabRef_t        slab,           ///< [IN] Slab allocator to allocate the storage from.
+    size_t                  elemSize,       ///< [IN] Size of an element, in bytes.
+    le_amap_CompareFunc_t   compareFunc     ///< [IN] Function that compares keys with elements.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the element with a given key in an array map.
+ *
+ * @return Pointer to the element, or NULL if there is none.  The pointer is valid until the map is
+ *         next modified.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_amap_Find
+(
+    const le_amap_Map_t*    mapPtr,     ///< [IN] The array map.
+    const void*             keyPtr      ///< [IN] The key.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the element with a given key in an array map, or inserts a zero-filled element where an
+ * element with that key belongs.  The caller must store the key in a new element.
+ *
+ * @return Pointer to the element, valid until the map is next modified.
+ *
+ * @note The process exits if the map can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_amap_Insert
+(
+    le_amap_Map_t*      mapPtr,     ///< [IN] The array map.
+    const void*         keyPtr,     ///< [IN] The key.
+    bool*               isNewPtr    ///< [OUT] Set to true if the element was inserted, false if it
+                                    ///        was already there.  Can be NULL.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element with a given key from an array map.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if there was no element with that key.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_amap_Remove
+(
+    le_amap_Map_t*      mapPtr,     ///< [IN] The array map.
+    const void*         keyPtr      ///< [IN] The key.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from an array map, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Clear
+(
+    le_amap_Map_t*      mapPtr      ///< [IN] The array map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from an array map and releases its storage.  The map can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Free
+(
+    le_amap_Map_t*      mapPtr      ///< [IN] The array map.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of elements in an array map.
+ *
+ * @return Number of elements.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t le_amap_NumElems
+(
+    const le_amap_Map_t*    mapPtr      ///< [IN] The array map.
+)
+{
+    return mapPtr->vec.numElems;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an element of an array map by its position in key order.
+ *
+ * @return Pointer to the element, valid until the map is next modified.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void* le_amap_GetAt
+(
+    const le_amap_Map_t*    mapPtr,     ///< [IN] The array map.
+    size_t                  index       ///< [IN] Index of the element.
+)
+{
+    return le_vec_Get(&mapPtr->vec, index);
+}
+
+
+#endif // LEGATO_ARRAY_INCLUDE_GUARD
@@ -162,6 +162,31 @@
  * le_atomFile_TryOpenStream(), le_atomFile_TryCreateStream() and le_atomFile_TryDelete() are their
  * non-blocking counterparts.
  *
+ * @section c_atomFile_journal Journal
+ *
+ * Rewriting a whole file to change a few bytes of it is expensive, both in time and in flash wear.
+ * @c le_atomFile_WriteJournal() atomically writes data at an offset in a file (or at its end, with
+ * @ref LE_ATOMFILE_JOURNAL_APPEND) by appending a small checksummed record to a journal kept next
+ * to the file, and only syncing that record to disk.  A record cut short by a power-cut is
+ * detected and discarded, so each write is either entirely done or not done at all.
+ *
+ * The records are applied to the file, atomically, when the journal grows large (in a background
+ * thread), when the file is next opened or created through this API, or when
+ * @c le_atomFile_CompactJournal() is called.  Reading the file directly, without this API, only
+ * shows the records applied so far.
+ *
+ * @code
+ *
+ *      // Update a 4-byte counter at offset 16 of an existing file.
+ *      uint32_t counter = 42;
+ *
+ *      if (le_atomFile_WriteJournal("./myfile.dat", 16, &counter, sizeof(counter)) != LE_OK)
+ *      {
+ *          // Print error message.
+ *      }
+ *
+ * @endcode
+ *
  * @section c_atomFile_threading Multiple Threads
  *
  * All the functions in this API are thread-safe and reentrant.
@@ -588,4 +613,53 @@ le_result_t le_atomFile_TryDelete
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offset passed to le_atomFile_WriteJournal() to write at the end of the file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_ATOMFILE_JOURNAL_APPEND  (-1)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Atomically writes data to a file by appending a record to its journal, rather than rewriting the
+ * whole file.  The data is on the storage device when this function returns successfully.  The
+ * journal is applied to the file when it grows too large, when the file is next opened or
+ * created, or when le_atomFile_CompactJournal() is called.
+ *
+ * This is a blocking call. It will block until it can lock the target file.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the file does not exist.
+ *      LE_OVERFLOW if the data is too big for one record.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atomFile_WriteJournal
+(
+    const char* pathNamePtr,            ///< [IN] Path of the file to write to
+    int64_t offset,                     ///< [IN] Offset to write at, or LE_ATOMFILE_JOURNAL_APPEND
+    const void* dataPtr,                ///< [IN] Data to write
+    size_t dataSize                     ///< [IN] Number of bytes to write
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies the records in the journal of a file to it, atomically, and deletes the journal.
+ *
+ * This is a blocking call. It will block until it can lock the target file.
+ *
+ * @return
+ *      LE_OK if successful (or if there was no journal).
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atomFile_CompactJournal
+(
+    const char* pathNamePtr             ///< [IN] Path of the file
+);
+
 #endif //LEGATO_ATOMIC_INCLUDE_GUARD
@@ -19,6 +19,12 @@
  * switches to use malloc/free per-block.  This way, tools like valgrind can be used on a Legato
  * executable.
  *
+ * @section bld_cfg_mem_checks_disable LE_MEM_CHECKS_DISABLE
+ *
+ * When @c LE_MEM_CHECKS_DISABLE is defined, the memory pool guard bands and free block fill
+ * checks are compiled out completely, so memory blocks carry no checking overhead at all and the
+ * @c LE_MEM_CHECK environment variable is ignored.  See @ref mem_diagnostics.
+ *
  * @section bld_cfg_disable_SMACK LE_SMACK_DISABLE
  *
  * Legato provides the ability to disable the SMACK API. We don’t recommend disabling SMACK:
@@ -53,6 +59,32 @@
  * against SEGV. However this handler relies on undefined behaviour of sigsetjmp(), so is more
  * risky.
  *
+ * @section bld_cfg_tracepoints_enable LE_TRACEPOINTS_ENABLE
+ *
+ * When @c LE_TRACEPOINTS_ENABLE is defined, the framework writes an event to the ftrace
+ * @c trace_marker file whenever it dispatches an IPC message, runs an event or file descriptor
+ * handler, expires a timer or expands a memory pool.  The events use the atrace text format, so
+ * a trace captured with trace-cmd or Perfetto shows them as slices and counters lined up with the
+ * kernel's scheduling events.  When it is not defined, the tracepoints are compiled out entirely.
+ *
+ * @section bld_cfg_mutex_diagnostics_disable LE_MUTEX_DIAGNOSTICS_DISABLE
+ *
+ * When @c LE_MUTEX_DIAGNOSTICS_DISABLE is defined, le_mutex_Lock(), le_mutex_TryLock() and
+ * le_mutex_Unlock() no longer record which thread holds each mutex and which threads are waiting
+ * for it, and the non-recursive mutexes no longer check for errors such as re-locking or
+ * unlocking by another thread.  Uncontended locking and unlocking then cost about as much as a
+ * bare pthreads mutex.  The @ref toolsTarget_inspect tool still lists the mutexes, but can't show
+ * their state.  Meant for production builds; leave it undefined while developing.
+ *
+ * @section bld_cfg_event_loop_io_uring LE_EVENT_LOOP_IO_URING
+ *
+ * When @c LE_EVENT_LOOP_IO_URING is defined, each thread's event loop submits the epoll_ctl()
+ * calls for the File Descriptor Monitors changed while handling events (see @ref c_fdMonitor) as
+ * one batch through an io_uring(7) ring, instead of making one system call per FD Monitor.  This
+ * needs Linux 5.6 or later and kernel headers that provide @c <linux/io_uring.h>; threads fall
+ * back to plain epoll_ctl() calls if the running kernel doesn't support it.  File descriptor
+ * readiness is still detected using epoll(7).  epoll(7) alone is used by default.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -82,9 +114,30 @@
 
 
 
+// Uncomment this define to compile out memory pool guard bands and free block checks.
+//#define LE_MEM_CHECKS_DISABLE
+
+
+
 // Uncomment this define to disable the "2nd SEGV handler" protection in ShowStackSignalHandler().
 //#define LE_SEGV_HANDLER_DISABLE
 
 
 
+// Uncomment this define to compile in the framework's tracepoints, which write IPC, event handler,
+// timer and memory pool events to the ftrace trace_marker file (see liblegato/linux/tracepoint.h).
+//#define LE_TRACEPOINTS_ENABLE
+
+
+
+// Uncomment this define to compile out the mutex lock and unlock bookkeeping and error checks.
+//#define LE_MUTEX_DIAGNOSTICS_DISABLE
+
+
+
+// Uncomment this define to batch the event loop's epoll_ctl() calls through io_uring(7).
+//#define LE_EVENT_LOOP_IO_URING
+
+
+
 #endif
@@ -0,0 +1,177 @@
+/**
+ * @page c_cfgSnapshot Config Snapshot API
+ *
+ * @ref le_cfgSnapshot.h "API Reference"
+ *
+ * <HR>
+ *
+ * Reading config through the @ref api_config "Config Tree API" costs a round trip to the Config
+ * Tree daemon for every transaction and every value read.  Apps that read many settings, or
+ * read them often, can read them from a config snapshot instead.
+ *
+ * Each time a change is committed to an app's config tree, or to the app's settings under
+ * "system:/apps/<app>", the Config Tree daemon writes out a read-only copy of them in RAM, which
+ * only the app's own group can read.  le_cfgSnapshot_Open() maps such a copy into the process's
+ * memory, after which values are read directly from the mapping, without any IPC.  A snapshot is
+ * a consistent view of the config at the time it was opened, like a read transaction that never
+ * times out.  To see later changes, close it and open it again.
+ *
+ * Snapshots are not available in every process: the base path must be in the app's own config
+ * tree or under "system:/apps/<app>", and sandboxed apps can't see the snapshot files.
+ * le_cfgSnapshot_Open() returns NULL when no snapshot is available, so code that uses snapshots
+ * must fall back to the Config Tree API.
+ *
+ * @code
+ * le_cfgSnapshot_Ref_t snapshotRef = le_cfgSnapshot_Open("/settings");
+ *
+ * if (snapshotRef != NULL)
+ * {
+ *     rate = le_cfgSnapshot_GetInt(snapshotRef, "rate", DEFAULT_RATE);
+ *     le_cfgSnapshot_Close(snapshotRef);
+ * }
+ * else
+ * {
+ *     rate = le_cfg_QuickGetInt("/settings/rate", DEFAULT_RATE);
+ * }
+ * @endcode
+ *
+ * Paths passed to the value functions are relative to the snapshot's base path.  The values read
+ * follow the same rules as the matching Config Tree API functions: the default value is returned
+ * if the node doesn't exist or holds a value of another type, except that integers and floating
+ * point values are converted to each other.
+ *
+ * A snapshot is never modified once it is open, so it can be read from any number of threads.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/** @file le_cfgSnapshot.h
+ *
+ * Legato @ref c_cfgSnapshot include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_CFG_SNAPSHOT_INCLUDE_GUARD
+#define LEGATO_CFG_SNAPSHOT_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an open config snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_cfgSnapshot* le_cfgSnapshot_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a snapshot of the config at a given path.
+ *
+ * The path is written as for le_cfg_CreateReadTxn().  Snapshots are available for paths in the
+ * calling app's own config tree, such as "/settings", and for paths under "system:/apps/<app>",
+ * where <app> is the calling app.
+ *
+ * @return Reference to the snapshot, or NULL if no snapshot is available for the path.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfgSnapshot_Ref_t le_cfgSnapshot_Open
+(
+    const char* basePathPtr         ///< [IN] Path to the node the snapshot's paths are relative to.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfgSnapshot_Close
+(
+    le_cfgSnapshot_Ref_t snapshotRef    ///< [IN] The snapshot.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a node exists in a snapshot.
+ *
+ * @return true if the node exists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_cfgSnapshot_NodeExists
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr                 ///< [IN] Path to the node, relative to the base path.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as a string.  Values of any type can be read as strings.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_OVERFLOW if the string was truncated to fit in the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_cfgSnapshot_GetString
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    char* bufferPtr,                    ///< [OUT] Buffer to copy the value to.
+    size_t bufferSize,                  ///< [IN] Size of the buffer, in bytes.
+    const char* defaultValuePtr         ///< [IN] Value to copy if the node has no value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as an integer.  Floating point values are rounded.
+ *
+ * @return The value, or the default value if the node has no integer or floating point value.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfgSnapshot_GetInt
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    int32_t defaultValue                ///< [IN] Value to return if the node has no such value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as a floating point number.  Integer values are converted.
+ *
+ * @return The value, or the default value if the node has no floating point or integer value.
+ */
+//--------------------------------------------------------------------------------------------------
+double le_cfgSnapshot_GetFloat
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    double defaultValue                 ///< [IN] Value to return if the node has no such value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's boolean value.
+ *
+ * @return The value, or the default value if the node has no boolean value.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_cfgSnapshot_GetBool
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    bool defaultValue                   ///< [IN] Value to return if the node has no such value.
+);
+
+
+#endif  // LEGATO_CFG_SNAPSHOT_INCLUDE_GUARD
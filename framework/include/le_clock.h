@@ -32,6 +32,16 @@
  * is stored.  The relative time between these two events can always be calculated as B-A, and will
  * always be an accurate measure of the relative time between these two events.
  *
+ * Getting the relative time can take a system call on some kernels.  Code that reads the time very
+ * often and doesn't need microsecond accuracy has two cheaper options:
+ *  - @ref le_clk_GetDispatchTime() returns the relative time at which the thread's event loop
+ *    called the running event handler, timer handler or queued function.  It is recorded by the
+ *    event loop anyway, so all the handler's calls share one reading of the clock.  Outside of a
+ *    handler it returns the current relative time.
+ *  - @ref le_clk_GetCoarseTime() returns a monotonic time that is only updated once per kernel
+ *    tick (typically 1 to 10 ms), and never takes a system call.  It doesn't include the time the
+ *    processor is suspended, so it must only be compared with other coarse times.
+ *
  *
  * @section clk_values Operations on Time Values
  *
@@ -147,6 +157,39 @@ le_clk_Time_t le_clk_GetRelativeTime(void);
 le_clk_Time_t le_clk_GetAbsoluteTime(void);
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a low resolution monotonic time from a fixed but unspecified starting point.  It is only
+ * updated once per kernel tick, but is much cheaper to get than the relative time.
+ *
+ * @return
+ *      Coarse time in seconds/microseconds
+ *
+ * @note
+ *      Coarse time doesn't include time that the processor is suspended, and its starting point
+ *      isn't the same as the relative time's.  Only compare it with other coarse times.
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetCoarseTime(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time at which the calling thread's event loop called the running event
+ * handler, timer handler or queued function.  This doesn't read the clock, so it is cheap to call
+ * repeatedly, but it doesn't advance while the handler runs.
+ *
+ * @return
+ *      Relative time in seconds/microseconds.  If no handler is running, the current relative
+ *      time.
+ *
+ * @note
+ *      Must be called from a Legato thread.
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetDispatchTime(void);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add two time values together, and return the result.
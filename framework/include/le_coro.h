@@ -0,0 +1,251 @@
+/**
+ * @page c_coro Coroutine API
+ *
+ * @ref le_coro.h "API Reference"
+ *
+ * <HR>
+ *
+ * A coroutine is a function that runs on the event loop of a thread and can wait for things to
+ * happen in the middle of its code, without blocking the thread.  While a coroutine waits, the
+ * thread's event loop carries on running handlers and other coroutines.  An operation made of
+ * several asynchronous steps, which would otherwise be written as a state machine driven by
+ * callbacks, can be written as one straight-line function instead.
+ *
+ * Coroutines are cheap: each one has its own small stack, but no thread of its own, so thousands
+ * of them can wait at the same time in a single thread.  The coroutines of a thread never run at
+ * the same time, and only switch when a coroutine waits or ends, so data shared only by the
+ * coroutines and handlers of one thread needs no locking.
+ *
+ *
+ * @section coro_create Creating and Starting a Coroutine
+ *
+ * le_coro_Create() creates a coroutine that will run a given function with a given context
+ * pointer.  Its stack size can be changed with le_coro_SetStackSize() before it is started, down to
+ * @ref LE_CORO_MIN_STACK_SIZE bytes; by default it is @ref LE_CORO_DEFAULT_STACK_SIZE bytes.
+ * le_coro_Start() queues the coroutine to the calling thread's event loop.  It starts running the
+ * next time the event loop gets to it, always on that thread, and ends when its function returns.
+ *
+ * The calling thread must run a Legato event loop.
+ *
+ *
+ * @section coro_await Waiting
+ *
+ * A coroutine can wait for:
+ *  - a length of time, with le_coro_Sleep();
+ *  - a file descriptor to become ready, with le_coro_AwaitFd();
+ *  - anything else, with le_coro_Await(), until some other code calls le_coro_Resume().
+ *
+ * le_coro_Await() is how a coroutine waits for an asynchronous operation to complete.  The
+ * completion callback of the operation is given the coroutine's reference, from
+ * le_coro_GetCurrent(), as its context, and resumes the coroutine with the operation's result:
+ *
+ * @code
+ * static void ConnectHandler(le_result_t result, void* contextPtr)
+ * {
+ *     le_coro_Resume(contextPtr, (void*)(intptr_t)result);
+ * }
+ *
+ * static void Session(void* contextPtr)
+ * {
+ *     le_foo_Connect(ConnectHandler, le_coro_GetCurrent());
+ *
+ *     le_result_t result = (le_result_t)(intptr_t)le_coro_Await();
+ *
+ *     while (result == LE_OK)
+ *     {
+ *         le_coro_Sleep(1000);
+ *         result = SendReport();
+ *     }
+ * }
+ *
+ * COMPONENT_INIT
+ * {
+ *     le_coro_Start(le_coro_Create("session", Session, NULL));
+ * }
+ * @endcode
+ *
+ * le_coro_Resume() can be called from any thread.  The coroutine continues on its own thread, the
+ * next time the event loop gets to it.  If the coroutine is resumed before it gets to
+ * le_coro_Await() (for example, because the callback was called before the asynchronous function
+ * returned), le_coro_Await() returns at once.  A coroutine must be resumed exactly once for every
+ * time it waits.
+ *
+ * Waiting is only possible in a coroutine.  Blocking calls, such as synchronous IPC calls, still
+ * block the whole thread when made from a coroutine.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+//--------------------------------------------------------------------------------------------------
+/** @file le_coro.h
+ *
+ * Legato @ref c_coro include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_CORO_INCLUDE_GUARD
+#define LEGATO_CORO_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default size of a coroutine's stack, in bytes.  Only the part of the stack a coroutine actually
+ * uses takes up memory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_CORO_DEFAULT_STACK_SIZE  (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest stack size, in bytes, that le_coro_SetStackSize() accepts.  It is the same on every
+ * platform.  A coroutine given a stack this small should not make deeply nested calls or use large
+ * local variables.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_CORO_MIN_STACK_SIZE      (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_coro* le_coro_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of a coroutine's function.  The coroutine ends when the function returns.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_coro_Func_t)
+(
+    void* contextPtr    ///< [IN] The context pointer passed to le_coro_Create().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a coroutine.  It doesn't run until it is started with le_coro_Start().
+ *
+ * @return Reference to the coroutine.
+ *
+ * @note The process exits if the coroutine can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_coro_Ref_t le_coro_Create
+(
+    const char*     name,           ///< [IN] Name of the coroutine, for diagnostics.
+    le_coro_Func_t  func,           ///< [IN] Function to run.
+    void*           contextPtr      ///< [IN] Value to pass to the function.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the stack size of a coroutine that hasn't been started yet.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_OVERFLOW if the stack size requested is smaller than @ref LE_CORO_MIN_STACK_SIZE.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_coro_SetStackSize
+(
+    le_coro_Ref_t   coroRef,        ///< [IN] The coroutine.
+    size_t          size            ///< [IN] Stack size, in bytes.  May be rounded up to the
+                                    ///       nearest virtual memory page size.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a coroutine on the calling thread's event loop.
+ *
+ * @note The process exits if the coroutine's stack can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Start
+(
+    le_coro_Ref_t   coroRef         ///< [IN] The coroutine.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the coroutine that is running.
+ *
+ * @return Reference to the coroutine, or NULL if not called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+le_coro_Ref_t le_coro_GetCurrent
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits until the running coroutine is resumed by le_coro_Resume().
+ *
+ * @return The value passed to le_coro_Resume().
+ *
+ * @note Must only be called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_coro_Await
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes a coroutine that is waiting in le_coro_Await(), or that will be.  Can be called from any
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Resume
+(
+    le_coro_Ref_t   coroRef,        ///< [IN] The coroutine.
+    void*           resultPtr       ///< [IN] Value for le_coro_Await() to return.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a length of time.
+ *
+ * @note Must only be called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Sleep
+(
+    uint32_t        ms              ///< [IN] Time to wait, in milliseconds.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a file descriptor to become ready.
+ *
+ * @return The events that occurred, as for a @ref c_fdMonitor handler.  POLLHUP, POLLERR and
+ *         POLLRDHUP are reported even if not asked for.
+ *
+ * @note Must only be called from a coroutine.  The file descriptor must not have a File
+ *       Descriptor Monitor on the calling thread, including one for another waiting coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+short le_coro_AwaitFd
+(
+    int             fd,             ///< [IN] The file descriptor.
+    short           events          ///< [IN] Events to wait for (POLLIN, POLLPRI, POLLOUT).
+);
+
+
+#endif  // LEGATO_CORO_INCLUDE_GUARD
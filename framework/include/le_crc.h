@@ -12,6 +12,7 @@
  * @section Crc32 Computing a CRC32
  *
  *   - @c le_crc_Crc32() - Compute the CRC32 of a memory buffer
+ *   - @c le_crc_Crc32Buffers() - Compute the CRC32 of a list of memory buffers
  *
  * The CRC32 is computed by the function @ref le_crc_Crc32. It takes a base buffer address, a length
  * and a CRC32. When the CRC32 is expected to be first computed, the value @ref LE_CRC_START_CRC32
@@ -20,38 +21,30 @@
  * @note It is possible to compute a "global" CRC32 of a huge amount of data by splitting into small
  * blocks and continue computing the CRC32 on each one.
  *
- * This code compute the whole CRC32 of amount of data splitted into an array of small blocks:
+ * Data split over several buffers can also be handled in one call with @ref le_crc_Crc32Buffers,
+ * which gives the same result as calling @ref le_crc_Crc32 on each buffer in turn:
  * @code
- * #define MAX_BLOCKS 4  // Maximum number of blocks
- *
- * typedef struct
- * {
- *     size_t   blockSize;  // size of the block
- *     uint8_t *blockPtr;   // pointer of the data
- * }
- * block_t;
- *
- * uint32_t ComputeArrayCRC32
+ * uint32_t ComputeMessageCRC32
  * (
- *     block_t blockArray[]
+ *     const uint8_t* headerPtr,
+ *     size_t         headerSize,
+ *     const uint8_t* bodyPtr,
+ *     size_t         bodySize
  * )
  * {
- *     uint32_t crc = LE_CRC_START_CRC32;  // New CRC initialized
- *     int iBlock;
- *
- *     for (iBlock = 0; iBlock < MAX_BLOCKS; iBlock++)
+ *     le_crc_Buffer_t buffers[] =
  *     {
- *         if (blockArray[iBlock].blockPtr)
- *         {
- *             crc = le_crc_Crc32(blockArray[iBlock].blockPtr,
- *                                blockArray[iBlock].blockSize,
- *                                crc);
- *         }
- *     }
- *     return crc;
+ *         { headerPtr, headerSize },
+ *         { bodyPtr, bodySize }
+ *     };
+ *
+ *     return le_crc_Crc32Buffers(buffers, NUM_ARRAY_MEMBERS(buffers), LE_CRC_START_CRC32);
  * }
  * @endcode
  *
+ * The CRC32 is computed eight bytes at a time using lookup tables, or with the CRC32
+ * instructions on ARMv8 CPUs that have them.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -81,6 +74,18 @@
 //--------------------------------------------------------------------------------------------------
 #define LE_CRC_START_CRC32         0xFFFFFFFFU
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * One buffer of a list passed to le_crc_Crc32Buffers().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const uint8_t* addressPtr;  ///< Start of the buffer (NULL buffers are skipped).
+    size_t         size;        ///< Number of bytes in the buffer.
+}
+le_crc_Buffer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to calculate a CRC-32
@@ -96,4 +101,20 @@ uint32_t le_crc_Crc32
     uint32_t crc        ///< [IN] Starting CRC seed
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to calculate a CRC-32 over a list of buffers, as if they were one
+ * contiguous buffer.
+ *
+ * @return
+ *      - 32-bit CRC
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_crc_Crc32Buffers
+(
+    const le_crc_Buffer_t* buffersPtr,  ///< [IN] Array of buffers
+    size_t                 count,       ///< [IN] Number of buffers in the array
+    uint32_t               crc          ///< [IN] Starting CRC seed
+);
+
 #endif // LEGATO_CRC_INCLUDE_GUARD
@@ -459,6 +459,12 @@
  * deregisters any handlers and deletes the thread's Event Loop, its Event
  * Queue, and any event reports still in that Event Queue.
  *
+ * An Event Loop processes at most 64 event reports (queued functions and handler calls) before
+ * checking its file descriptors again, so a flood of event reports can't hold up fd events for
+ * long.  This limit can be changed for a process by setting the @c LE_EVENT_REPORT_BUDGET
+ * environment variable (e.g., in the @c envVars section of its .adef).  Setting it to 0 removes
+ * the limit.
+ *
  * @section c_event_integratingLegacyPosix Integrating with Legacy POSIX Code
  *
  * Many legacy programs written on top of POSIX APIs will have previously built their own event loop
@@ -487,8 +493,12 @@
  * For example, the keyword "P/T/events" controls logging for a thread named "T" running inside
  * a process named "P".
  *
+ * The inspect tool's "threads" view shows, for each thread, how many event reports it has
+ * processed, how many are queued now and at most, and how long its handlers have run in total and
+ * at most for a single call.
+ *
  * @todo Add a reference to the Process Inspector and its capabilities for inspecting Event Queues,
- * Event Loops, Handlers and Event Report statistics.
+ * Event Loops and Handlers.
 
  * <HR>
  *
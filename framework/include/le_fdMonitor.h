@@ -202,6 +202,47 @@ static void ConnectionEventHandler(int fd, int event)
  * If events occur on different fds at the same time, the order in which the handlers
  * are called is implementation-dependent.
  *
+ * Enabling and disabling events is cheap: the changes are only passed to the kernel once the
+ * thread goes back to its Event Loop, so an event that is enabled and disabled again several
+ * times by the same handler costs nothing more than one that is changed once.
+ *
+ *
+ * @section c_fdMonitorEdgeTriggered Edge-Triggered Monitoring
+ *
+ * By default, the handler is called for as long as an enabled event's trigger condition is true
+ * (e.g., for as long as there is data available to be read).  le_fdMonitor_SetEdgeTriggered()
+ * makes the handler only get called when the condition becomes true (e.g., when new data
+ * arrives).  This saves handler calls on busy fds, but the handler must then drain the fd: read
+ * (or write) until the call fails with @c EAGAIN (so the fd must be non-blocking), as it won't be
+ * called again for data that was already there when it returned.
+ *
+ * @code
+static void SocketHandler(int fd, short events)
+{
+    if (events & POLLIN)
+    {
+        char buff[MY_BUFF_SIZE];
+        ssize_t bytesRead;
+
+        while ((bytesRead = read(fd, buff, sizeof(buff))) > 0)
+        {
+            ...
+        }
+
+        if ((bytesRead < 0) && (errno != EAGAIN))
+        {
+            ...
+        }
+    }
+    ...
+}
+ * @endcode
+ *
+ * Enabling an event in edge-triggered mode while its condition is already true reports it once.
+ *
+ * Edge-triggered mode has no effect on fds that don't support epoll(), such as regular files (see
+ * @ref c_fdTypes_files), which are always reported as ready.
+ *
  *
  * @section c_fdMonitorHandlerContext Handler Function Context
  *
@@ -443,6 +484,22 @@ void le_fdMonitor_SetDeferrable
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets if events on a given fd are reported only when they happen (edge-triggered), in which case
+ * the handler must read or write until the fd would block, or for as long as their trigger
+ * condition is true (level-triggered, the default).
+ *
+ * See @ref c_fdMonitorEdgeTriggered.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_fdMonitor_SetEdgeTriggered
+(
+    le_fdMonitor_Ref_t monitorRef,      ///< [in] Reference to the File Descriptor Monitor object.
+    bool               isEdgeTriggered  ///< [in] true (edge-triggered) or false (level-triggered).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the Context Pointer for File Descriptor Monitor's handler function.  This can be retrieved
@@ -20,6 +20,18 @@
  * - move a file with le_fs_Move()
  * - recursively deletes a folder with le_fs_RemoveDirRecursive()
  * - checks whether a regular file exists le_fs_Exists()
+ * - buffer the writes to a file with le_fs_SetWriteBuffer()
+ * - write out the buffered data of a file with le_fs_Flush()
+ *
+ * @section c_fs_buffering Write Buffering
+ *
+ * By default, every le_fs_Write() goes straight to the file.  Apps that write many small records
+ * can set up a write buffer with le_fs_SetWriteBuffer(): writes are then collected in memory and
+ * only written to the file once the buffer is full, when le_fs_Flush() is called, before the file
+ * is read or seeked, and when it is closed.  The same call chooses when the file is synced to
+ * storage (see @ref le_fs_SyncPolicy_t).
+ *
+ * @note Sizes returned by le_fs_GetSize() don't include data still waiting in a write buffer.
  *
  *
  * <HR>
@@ -46,6 +58,13 @@
 //--------------------------------------------------------------------------------------------------
 #define LE_FS_PATH_MAX_LEN    PATH_MAX
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a file's write buffer, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_FS_WRITE_BUFFER_MAX_SIZE 4096
+
 //--------------------------------------------------------------------------------------------------
 /**
  * File access modes used when opening a file.
@@ -78,6 +97,20 @@ typedef enum
 le_fs_Position_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * When data written to a file is synced to storage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LE_FS_SYNC_NEVER    = 0,    ///< Leave it to the kernel (default)
+    LE_FS_SYNC_ON_FLUSH = 1,    ///< Every time data is written to the file
+    LE_FS_SYNC_ON_CLOSE = 2     ///< When the file is closed
+}
+le_fs_SyncPolicy_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference of a file
@@ -109,7 +142,7 @@ le_result_t le_fs_Open
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is called to close an opened file.
+ * This function is called to close an opened file.  Buffered data is written out first.
  *
  * @return
  *  - LE_OK         The function succeeded.
@@ -121,6 +154,43 @@ le_result_t le_fs_Close
     le_fs_FileRef_t fileRef ///< [IN] File reference
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to set up write buffering and the sync policy of an opened file.
+ *
+ * Writes smaller than the buffer size are kept in memory until adding the next one would overflow
+ * the buffer.  Data already buffered is written out first.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_FAULT          The data already buffered could not be written out.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_SetWriteBuffer
+(
+    le_fs_FileRef_t fileRef,        ///< [IN] File reference
+    size_t bufferSize,              ///< [IN] Write buffer size (up to LE_FS_WRITE_BUFFER_MAX_SIZE),
+                                    ///<      0 to disable buffering
+    le_fs_SyncPolicy_t syncPolicy   ///< [IN] When to sync the file to storage
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to write out the data buffered for an opened file.  The file is then
+ * synced to storage if its sync policy is LE_FS_SYNC_ON_FLUSH.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_Flush
+(
+    le_fs_FileRef_t fileRef ///< [IN] File reference
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is called to read the requested data length from an opened file.
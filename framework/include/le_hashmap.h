@@ -15,13 +15,35 @@
  * type of key that you intend to store. It's unwise to mix types in a single table because
  * implementation of the table has no way to detect this behaviour.
  *
- * Choose the initial size should carefully as the index size remains fixed. The best
- * choice for the initial size is a prime number slightly larger than the
- * maximum expected capacity. If a too small size is chosen, there will be an
- * increase in collisions that degrade performance over time.
+ * The capacity passed to le_hashmap_Create() is the number of keys the map is expected to
+ * hold.  The map starts with enough buckets for that many keys and, if more keys than that are
+ * put into it, it grows by doubling its number of buckets.  Growing is done incrementally: the
+ * existing keys are moved into the new buckets a few at a time by later calls to
+ * le_hashmap_Put(), le_hashmap_Get(), le_hashmap_Remove() and similar functions, so no single
+ * call has to move the whole map.  Choosing a capacity close to the expected number of keys still
+ * saves the cost of growing, but a too small capacity no longer degrades performance over time.
+ *
+ * While an iteration is in progress (see @ref c_hashmap_iterating), keys are not moved between
+ * buckets, and growing is put off until the iteration has finished.
  *
  * All hashmaps have names for diagnostic purposes.
  *
+ * @subsection c_hashmap_flat Flat HashMaps
+ *
+ * @c le_hashmap_CreateFlat() creates a hashmap that is used through exactly the same functions,
+ * but stores its key and value pointers directly in one array of slots (open addressing with
+ * linear probing), instead of allocating a list entry for each key.  A separate byte per slot
+ * holds a few bits of the key's hash, so a lookup usually only reads that byte array and the one
+ * slot holding the key.  This suits maps of small keys, such as integers or pointers, that are
+ * looked up often.
+ *
+ * Flat maps differ from other maps in a few ways:
+ *  - Growing a flat map rebuilds its whole slot array in one go, rather than incrementally.
+ *  - Removing keys leaves markers in the slot array that are only cleared when it is rebuilt.
+ *  - If so many keys are added during an iteration that the map has to grow before the
+ *    iteration finishes, the iterator goes back to the start of the map, and keys already seen
+ *    will be seen again.
+ *
  * @section c_hashmap_insert Adding key-value pairs
  *
  * Key-value pairs are added using le_hashmap_Put(). For example:
@@ -119,6 +141,10 @@
  * le_hashmap_GetKey, and le_hashmap_GetValue will return NULL until either,
  * le_hashmap_NextNode, or le_hashmap_PrevNode are called.
  *
+ * The map will not grow while the iterator is part-way through it, so an iteration that is
+ * abandoned before le_hashmap_NextNode() returns LE_NOT_FOUND holds off growing until the map is
+ * next iterated to the end (or le_hashmap_RemoveAll() is called).
+ *
  * For example (assuming a table of string/string):
  *
  * @code
@@ -241,7 +267,7 @@ typedef bool (*le_hashmap_ForEachHandler_t)
  * Create a HashMap.
  *
  * If you create a hashmap with a smaller capacity than you actually use, then
- * the map will continue to work, but performance will degrade the more you put in the map.
+ * the map will grow to fit, moving its keys into the larger bucket array a few at a time.
  *
  * @return  Returns a reference to the map.
  *
@@ -251,7 +277,25 @@ typedef bool (*le_hashmap_ForEachHandler_t)
 le_hashmap_Ref_t le_hashmap_Create
 (
     const char*                nameStr,          ///< [in] Name of the HashMap
-    size_t                     capacity,         ///< [in] Size of the hashmap
+    size_t                     capacity,         ///< [in] Expected number of keys in the hashmap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a flat HashMap, which stores its keys and values inline in an open-addressed array
+ * rather than in a list per bucket. See @ref c_hashmap_flat.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateFlat
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected number of keys in the hashmap
     le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
 );
@@ -498,6 +542,11 @@ le_result_t le_hashmap_GetFirstNode
  * if new keys have been added to the map.
  * If NULL is passed as the nextValuePtr then only the key will be returned.
  *
+ * @note If the map is growing, any other call on the map (including le_hashmap_Get()) may move
+ *       keys between buckets, so a walk done with le_hashmap_GetFirstNode() and this function
+ *       can then skip or repeat keys.  Use le_hashmap_GetIterator() for a walk that must see
+ *       each key exactly once.
+ *
  * @return  LE_OK if the next node is returned. If the keyPtr is not found in the
  *          map then LE_BAD_PARAMETER is returned. LE_NOT_FOUND is returned if the passed
  *          in key is the last one in the map.
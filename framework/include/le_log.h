@@ -102,6 +102,49 @@
  * LE_WARN_IF(result == -1, "Failed to send message to server.  Errno = %m.");
  * @endcode
  *
+ * @subsection c_log_rate_limiting Rate-Limited Logging
+ *
+ * Error paths that can be hit over and over (e.g., a failing read in a polling loop) can flood
+ * the log.  These macros take the same arguments as the basic macros, but each call site is given
+ * its own token bucket:
+ *
+ *  - @ref LE_DEBUG_RATELIMITED(formatString, ...)
+ *  - @ref LE_INFO_RATELIMITED(formatString, ...)
+ *  - @ref LE_WARN_RATELIMITED(formatString, ...)
+ *  - @ref LE_ERROR_RATELIMITED(formatString, ...)
+ *  - @ref LE_CRIT_RATELIMITED(formatString, ...)
+ *
+ * A call site may log a burst of @ref LE_LOG_RATELIMIT_BURST messages, after which it may log
+ * that many messages every @ref LE_LOG_RATELIMIT_INTERVAL_MS milliseconds.  Other messages are
+ * counted and dropped, and the next message logged from the call site is preceded by a
+ * "N messages from here suppressed." line.  Both defaults can be overridden in a component's
+ * @c cflags.
+ *
+ * @code
+ * LE_ERROR_RATELIMITED("Read from '%s' failed.  %m.", devicePath);
+ * @endcode
+ *
+ * The call sites that have logged the most messages in a running process (and how many of those
+ * were suppressed) can be listed using the log control tool's @c hot command.
+ *
+ * @subsection c_log_static_filter Compile-Time Filtering
+ *
+ * Every logging call site costs a filter level check at run time, even when its messages are
+ * filtered out.  Messages below a given severity level can be removed from a component
+ * altogether, at compile time, by defining @c LE_LOG_LEVEL_STATIC_FILTER in the component's
+ * @c cflags:
+ *
+ * @code
+ * cflags:
+ * {
+ *     -DLE_LOG_LEVEL_STATIC_FILTER=LE_LOG_INFO
+ * }
+ * @endcode
+ *
+ * The same can be done for everything built by mk using @c -C @c -DLE_LOG_LEVEL_STATIC_FILTER=...
+ * Messages logged below that level can't be turned back on using the log control tool.
+ * @ref LE_DUMP is logged at DEBUG level, and trace messages are not affected.
+ *
  * @subsection c_log_loging_fatals Fatal Errors
  *
  * There are some special logging macros intended for fatal errors:
@@ -232,6 +275,12 @@ $ log trace foo myProc/myComp
  * called "myProc":
  * @verbatim
 $ log stoptrace foo myProc/myComp
+@endverbatim
+ *
+ * To list the busiest rate-limited call sites (see @ref c_log_rate_limiting) in processes called
+ * "myProc":
+ * @verbatim
+$ log hot myProc
 @endverbatim
  *
  * With all of the above examples "*" can be used in place of the process name or a component
@@ -278,6 +327,24 @@ $ export LE_LOG_LEVEL=DEBUG
  * For example,
  * @verbatim
 $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
+@endverbatim
+ *
+ * @subsubsection c_log_control_env_buffer LE_LOG_BUFFER_SLOTS
+ *
+ * @c LE_LOG_BUFFER_SLOTS enables buffered logging for the process, and sets the number of log
+ * messages that can be waiting to be written out.  When enabled, the logging macros don't format
+ * messages or write them to the log themselves.  They copy the format string pointer and the
+ * arguments into a lock-free ring buffer, and a background thread in the same process formats
+ * and writes them out.  Messages at CRITICAL and EMERGENCY level are still written out right
+ * away (along with any messages logged before them), as are all messages while the buffer
+ * is full.
+ *
+ * @warning With buffered logging, the format string passed to the logging macros must remain
+ *          valid after the call (e.g., a string literal).  String arguments are copied.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_BUFFER_SLOTS=256
 @endverbatim
  *
  * @subsection c_log_control_functions Programmatic Log Control
@@ -425,6 +492,32 @@ void _le_LogData
     const unsigned int lineNumber       // The line number in the source file that logged the message.
 );
 
+typedef struct _le_log_RateLimit
+{
+    const char* fileNamePtr;            // The name of the source file of the call site.
+    unsigned int lineNumber;            // The line number of the call site.
+    unsigned int burst;                 // Number of messages allowed per interval.
+    unsigned int intervalMs;            // Interval length (in ms).
+    const char* functionNamePtr;        // The name of the function of the call site.
+    uint64_t credit;                    // Token bucket level (intervalMs per message).
+    uint32_t lastRefillMs;              // When the token bucket was last refilled.
+    uint32_t suppressedCount;           // Messages suppressed since the last one logged.
+    uint32_t contendedCount;            // Messages dropped while the call site was locked.
+    uint64_t hitCount;                  // Total number of messages logged or suppressed.
+    uint64_t suppressedTotal;           // Total number of messages suppressed.
+    bool isLocked;                      // Set while a thread is updating the call site.
+    bool isRegistered;                  // true once the call site is in the process's list.
+    struct _le_log_RateLimit* nextPtr;  // Next call site in the process's list.
+}
+_le_log_RateLimit_t;
+
+bool _le_log_CheckRateLimit
+(
+    _le_log_RateLimit_t* rateLimitPtr,
+    const char* functionNamePtr,
+    uint32_t* suppressedCountPtr
+);
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -456,14 +549,31 @@ LE_SHARED le_log_Level_t* LE_LOG_LEVEL_FILTER_PTR;
 /// @endcond
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lowest severity level compiled into the current source file.  Messages logged at a lower level
+ * are removed at compile time, along with the evaluation of their arguments.
+ *
+ * Defaults to LE_LOG_DEBUG (nothing is removed).  Can be set (e.g., to LE_LOG_INFO) for a
+ * component using the cflags section of its .cdef, or for a whole build using mk's -C option.
+ * See @ref c_log_static_filter.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LE_LOG_LEVEL_STATIC_FILTER
+#define LE_LOG_LEVEL_STATIC_FILTER  LE_LOG_DEBUG
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Internal macro to filter out messages that do not meet the current filtering level.
+ *
+ * The static filter check is a constant expression, so calls below it are compiled out.
  */
 //--------------------------------------------------------------------------------------------------
 #define _LE_LOG_MSG(level, formatString, ...) \
     do { \
-        if ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (level >= *LE_LOG_LEVEL_FILTER_PTR)) \
+        if (((level) >= LE_LOG_LEVEL_STATIC_FILTER) && \
+            ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (level >= *LE_LOG_LEVEL_FILTER_PTR))) \
             _le_log_Send(level, NULL, LE_LOG_SESSION, STRINGIZE(LE_FILENAME), __func__, __LINE__, \
                     formatString, ##__VA_ARGS__); \
     } while(0)
@@ -481,7 +591,12 @@ LE_SHARED le_log_Level_t* LE_LOG_LEVEL_FILTER_PTR;
 /** @copydoc LE_LOG_DEBUG */
 #define LE_DEBUG(formatString, ...)     _LE_LOG_MSG(LE_LOG_DEBUG, formatString, ##__VA_ARGS__)
 /** @copydoc LE_LOG_DATA */
-#define LE_DUMP(dataPtr, dataLength)    _le_LogData(dataPtr, dataLength, STRINGIZE(LE_FILENAME), __func__, __LINE__)
+#define LE_DUMP(dataPtr, dataLength) \
+    do { \
+        if ((LE_LOG_DEBUG >= LE_LOG_LEVEL_STATIC_FILTER) && \
+            ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (LE_LOG_DEBUG >= *LE_LOG_LEVEL_FILTER_PTR))) \
+            _le_LogData(dataPtr, dataLength, STRINGIZE(LE_FILENAME), __func__, __LINE__); \
+    } while(0)
 /** @copydoc LE_LOG_INFO */
 #define LE_INFO(formatString, ...)      _LE_LOG_MSG(LE_LOG_INFO, formatString, ##__VA_ARGS__)
 /** @copydoc LE_LOG_WARN */
@@ -525,6 +640,83 @@ LE_SHARED le_log_Level_t* LE_LOG_LEVEL_FILTER_PTR;
         if (condition) { _LE_LOG_MSG(LE_LOG_EMERG, formatString, ##__VA_ARGS__); }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages a rate-limited call site may log in a burst, before it is throttled down to
+ * that many messages per @ref LE_LOG_RATELIMIT_INTERVAL_MS.  Can be overridden for a component
+ * using the cflags section of its .cdef.  See @ref c_log_rate_limiting.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LE_LOG_RATELIMIT_BURST
+#define LE_LOG_RATELIMIT_BURST          10
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length (in milliseconds) of the interval over which a rate-limited call site's burst of
+ * messages is replenished.  See @ref c_log_rate_limiting.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LE_LOG_RATELIMIT_INTERVAL_MS
+#define LE_LOG_RATELIMIT_INTERVAL_MS    5000
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Internal macro to log a message through the call site's token bucket.  The first message logged
+ * after some have been suppressed is preceded by a count of the suppressed messages.
+ */
+//--------------------------------------------------------------------------------------------------
+#define _LE_LOG_MSG_RATELIMITED(level, formatString, ...) \
+    do { \
+        if (((level) >= LE_LOG_LEVEL_STATIC_FILTER) && \
+            ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (level >= *LE_LOG_LEVEL_FILTER_PTR))) \
+        { \
+            static _le_log_RateLimit_t _le_log_RateLimit = \
+                { STRINGIZE(LE_FILENAME), __LINE__, \
+                  LE_LOG_RATELIMIT_BURST, LE_LOG_RATELIMIT_INTERVAL_MS }; \
+            uint32_t _le_log_SuppressedCount; \
+            if (_le_log_CheckRateLimit(&_le_log_RateLimit, __func__, &_le_log_SuppressedCount)) \
+            { \
+                if (_le_log_SuppressedCount > 0) \
+                    _le_log_Send(level, NULL, LE_LOG_SESSION, STRINGIZE(LE_FILENAME), __func__, \
+                            __LINE__, "%u messages from here suppressed.", \
+                            (unsigned int)_le_log_SuppressedCount); \
+                _le_log_Send(level, NULL, LE_LOG_SESSION, STRINGIZE(LE_FILENAME), __func__, \
+                        __LINE__, formatString, ##__VA_ARGS__); \
+            } \
+        } \
+    } while(0)
+
+
+//--------------------------------------------------------------------------------------------------
+/** @internal
+ * The following macros are used to send log messages at different severity levels, from call
+ * sites that may log repeatedly (e.g., on every iteration of an error path).  Each call site is
+ * rate-limited separately.  See @ref c_log_rate_limiting.
+ *
+ * Accepts printf-style arguments, consisting of a format string followed by zero or more parameters
+ * to be printed (depending on the contents of the format string).
+ */
+//--------------------------------------------------------------------------------------------------
+
+/** @ref LE_DEBUG, rate-limited. */
+#define LE_DEBUG_RATELIMITED(formatString, ...) \
+        _LE_LOG_MSG_RATELIMITED(LE_LOG_DEBUG, formatString, ##__VA_ARGS__)
+/** @ref LE_INFO, rate-limited. */
+#define LE_INFO_RATELIMITED(formatString, ...) \
+        _LE_LOG_MSG_RATELIMITED(LE_LOG_INFO, formatString, ##__VA_ARGS__)
+/** @ref LE_WARN, rate-limited. */
+#define LE_WARN_RATELIMITED(formatString, ...) \
+        _LE_LOG_MSG_RATELIMITED(LE_LOG_WARN, formatString, ##__VA_ARGS__)
+/** @ref LE_ERROR, rate-limited. */
+#define LE_ERROR_RATELIMITED(formatString, ...) \
+        _LE_LOG_MSG_RATELIMITED(LE_LOG_ERR, formatString, ##__VA_ARGS__)
+/** @ref LE_CRIT, rate-limited. */
+#define LE_CRIT_RATELIMITED(formatString, ...) \
+        _LE_LOG_MSG_RATELIMITED(LE_LOG_CRIT, formatString, ##__VA_ARGS__)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log fatal errors by killing the calling process after logging the message at EMERGENCY
@@ -683,14 +875,20 @@ static inline le_log_Level_t le_log_GetFilterLevel
     void
 )
 {
+    le_log_Level_t level = LE_LOG_INFO; // Default.
+
     if (LE_LOG_LEVEL_FILTER_PTR != NULL)
     {
-        return *LE_LOG_LEVEL_FILTER_PTR;
+        level = *LE_LOG_LEVEL_FILTER_PTR;
     }
-    else
+
+    // Messages below the static filter level have been compiled out.
+    if (level < LE_LOG_LEVEL_STATIC_FILTER)
     {
-        return LE_LOG_INFO; // Default.
+        level = LE_LOG_LEVEL_STATIC_FILTER;
     }
+
+    return level;
 }
 
 
@@ -233,6 +233,10 @@
  *  - Number of allocations.
  *  - Number of currently free objects.
  *  - Number of overflows (times that le_mem_ForceAlloc() had to expand the pool).
+ *  - Number of times an operation on the pool had to wait for another thread to release the
+ *    memory pool lock, which shows where threads contend.
+ *  - Mean allocation latency, measured on one allocation in 64.
+ *  - Time covered by the counters, so allocation and lock wait rates can be derived.
  *
  * Statistics (and other pool properties) can be checked using functions:
  *  - @c le_mem_GetStats()
@@ -252,7 +256,21 @@
  *
  * @section mem_diagnostics Diagnostics
  *
- * The memory system also supports two different forms of diagnostics.  Both are enabled by defining
+ * By default, each memory block has a guard band before and after the object, filled with a
+ * known pattern that is checked whenever the block is allocated, released or referenced, to catch
+ * code writing outside of its objects.  The level of checking is selected for each process when
+ * it starts, using the @c LE_MEM_CHECK environment variable (which can be set for an app's
+ * processes using the @c envVars section of its .adef file):
+ *  - @c none - No checking at all, and no per-block overhead.
+ *  - @c guard - Guard band checking (the default).
+ *  - @c full - Guard band checking, and released objects are filled with a pattern that is
+ *    checked when they are allocated again, to catch objects being modified after they were
+ *    released.
+ *
+ * Building the framework with @c LE_MEM_CHECKS_DISABLE defined (see @ref c_le_build_cfg)
+ * compiles the checks out entirely.
+ *
+ * The memory system also supports two other forms of diagnostics.  Both are enabled by defining
  * special preprocessor macros when building the framework.
  *
  * The first of which is @c LE_MEM_TRACE.  When you define @c LE_MEM_TRACE every pool is given a
@@ -348,9 +366,21 @@
  *
  * Where clients dynamically start and stop during runtime in response
  * to external events (e.g., when someone is using the device's Web UI), we still have
- * a problem because we can't @a shrink pools or delete pools when clients go away.  This is where
+ * a problem because we can't delete pools when clients go away.  This is where
  * @ref mem_sub_pools is useful.
  *
+ * Pools can, however, give memory back to the system.  The objects added by each expansion of a
+ * pool are allocated together, as a chunk, and when none of the objects in a chunk are in use,
+ * the chunk can be freed.  Calling @c le_mem_Compact() frees all of a pool's idle chunks.
+ * Alternatively, @c le_mem_SetMaxIdleBlocks() sets the number of free objects above which the
+ * pool frees idle chunks by itself, as objects are released.  Since chunks can only be freed as a
+ * whole, a pool can be left with more free objects than requested, especially if it was expanded
+ * by large amounts at a time.  Objects that are held in a sub-pool, or that were released
+ * recently and are still cached by the releasing thread, keep their chunk from being freed.
+ *
+ * @note Sub-pools can't be compacted, but the chunks their objects came from can be freed
+ *       by compacting the super-pool once the sub-pool is deleted.
+ *
  * @section mem_sub_pools Sub-Pools
  *
  * Essentially, a Sub-Pool is a memory pool that gets its blocks from another pool (the super-pool).
@@ -384,6 +414,40 @@
  * @note You can't create sub-pools of sub-pools (i.e., sub-pools that get their blocks from another
  * sub-pool).
  *
+ * @section mem_slabs Slab Allocators
+ *
+ * Every block in a memory pool is the same size, so pools holding variable-size objects such as
+ * strings or buffers must be sized for the largest possible object, wasting memory on all the
+ * smaller ones.  A slab allocator solves this by managing a set of memory pools (called
+ * size classes) whose object sizes are successive powers of two, up to a maximum object size
+ * specified when the allocator is created.  Each allocation request is given a block from the
+ * smallest size class that can hold the requested number of bytes.
+ *
+ * @code
+ * le_mem_SlabRef_t StringSlab;
+ *
+ * COMPONENT_INIT
+ * {
+ *     StringSlab = le_mem_CreateSlabAllocator("Strings", MAX_STRING_BYTES);
+ *     le_mem_ExpandSlabAllocator(StringSlab, 32, 20); // Room for 20 strings of up to 32 bytes.
+ * }
+ *
+ * static char* CopyString(const char* strPtr)
+ * {
+ *     char* copyPtr = le_mem_ForceSlabAlloc(StringSlab, strlen(strPtr) + 1);
+ *     strcpy(copyPtr, strPtr);
+ *     return copyPtr;
+ * }
+ * @endcode
+ *
+ * Objects allocated from a slab allocator are just like objects allocated from a pool: they are
+ * reference counted, and are released using @c le_mem_Release().  @c le_mem_SlabStrDup() is also
+ * provided to copy a string into a block that fits.
+ *
+ * The size classes are ordinary memory pools, named after the slab allocator and their object
+ * size, so they show up in the Inspect tool and their statistics can be fetched using
+ * @c le_mem_GetSlabPool().  @c le_mem_GetSlabStats() gives the totals across all size classes.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -447,6 +511,12 @@ typedef struct
     size_t      numOverflows;       ///< Number of times le_mem_ForceAlloc() had to expand the pool.
     uint64_t    numAllocs;          ///< Number of times an object has been allocated from this pool.
     size_t      numFree;            ///< Number of free objects currently available in this pool.
+    uint64_t    numLockWaits;       ///< Number of times an operation on this pool had to wait for
+                                    ///  another thread to release the memory pool lock.
+    uint64_t    allocLatencyNs;     ///< Mean duration of an allocation, in nanoseconds, measured
+                                    ///  on a sample of the allocations (0 if none sampled yet).
+    uint64_t    statsPeriodMs;      ///< Time since the pool was created or its stats were last
+                                    ///  reset, which numAllocs and numLockWaits cover, in ms.
 }
 le_mem_PoolStats_t;
 
@@ -667,6 +737,44 @@ void le_mem_SetNumObjsToForce
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the memory of a pool's idle chunks (chunks whose objects are all free) back to the
+ * system.  See @ref mem_pool_sizes.
+ *
+ * @return
+ *      Number of free objects that were removed from the pool.
+ *
+ * @note
+ *      Must not be called on a sub-pool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_mem_Compact
+(
+    le_mem_PoolRef_t    pool        ///< [IN] Pool to compact.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the maximum number of free objects to keep in a pool.  When the pool has more free objects
+ * than this, it releases idle chunks back to the system, as long as that doesn't leave it with
+ * fewer free objects than this.  See @ref mem_pool_sizes.
+ *
+ * @note
+ *      The default is SIZE_MAX, which means that memory is never released automatically.
+ *
+ * @note
+ *      Must not be called on a sub-pool.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetMaxIdleBlocks
+(
+    le_mem_PoolRef_t    pool,           ///< [IN] Pool to set the maximum for.
+    size_t              maxIdleBlocks   ///< [IN] Maximum number of free objects to keep.
+);
+
+
 #ifndef LE_MEM_TRACE
     //----------------------------------------------------------------------------------------------
     /**
@@ -964,4 +1072,190 @@ void le_mem_DeleteSubPool
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Objects of this type are used to refer to a slab allocator created using
+ * le_mem_CreateSlabAllocator().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mem_Slab* le_mem_SlabRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/** @cond HIDDEN_IN_USER_DOCS
+ *
+ * Internal function used to implement le_mem_CreateSlabAllocator() with automatic component
+ * scoping of pool names.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SlabRef_t _le_mem_CreateSlabAllocator
+(
+    const char* componentName,  ///< [IN] Name of the component.
+    const char* name,           ///< [IN] Name of the slab allocator inside the component.
+    size_t      maxObjSize      ///< [IN] Size of the largest object that can be allocated (in
+                                ///       bytes).
+);
+/// @endcond
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an empty slab allocator.
+ *
+ * See @ref mem_slabs for more information.
+ *
+ * @return
+ *      Reference to the slab allocator.
+ *
+ * @note
+ *      On failure, the process exits, so you don't have to worry about checking the returned
+ *      reference for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_mem_SlabRef_t le_mem_CreateSlabAllocator
+(
+    const char* name,       ///< [IN] Name of the slab allocator (used to name its size classes).
+    size_t      maxObjSize  ///< [IN] Size of the largest object that can be allocated (in bytes).
+)
+{
+    return _le_mem_CreateSlabAllocator(STRINGIZE(LE_COMPONENT_NAME), name, maxObjSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expands the size class of a slab allocator that is used for objects of a given size.
+ *
+ * @return  Reference to the slab allocator (the same value passed into it).
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          reference for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SlabRef_t le_mem_ExpandSlabAllocator
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator to be expanded.
+    size_t              objSize,    ///< [IN] Object size (in bytes) whose size class is expanded.
+    size_t              numObjects  ///< [IN] Number of objects to add to the size class.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attempts to allocate an object of a given size from a slab allocator.
+ *
+ * @return
+ *      Pointer to the allocated object, or NULL if the size class doesn't have any free objects
+ *      to allocate.
+ *
+ * @note    The process exits if the size is larger than the slab allocator's maximum object size.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_TrySlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator from which the object is to be allocated.
+    size_t              objSize     ///< [IN] Size of the object (in bytes).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a slab allocator or logs a fatal error and terminates
+ * the process if the size class doesn't have any free objects to allocate.
+ *
+ * @return Pointer to the allocated object.
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          pointer for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_AssertSlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator from which the object is to be allocated.
+    size_t              objSize     ///< [IN] Size of the object (in bytes).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a slab allocator or logs a warning and expands the
+ * size class if it doesn't have any free objects to allocate.
+ *
+ * @return  Pointer to the allocated object.
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          pointer for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_ForceSlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator from which the object is to be allocated.
+    size_t              objSize     ///< [IN] Size of the object (in bytes).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a string into a block allocated from a slab allocator that is just big enough to hold
+ * it.  Expands the size class if necessary.
+ *
+ * @return  Pointer to the copy.  Release it using le_mem_Release().
+ *
+ * @note    On failure, the process exits, so you don't have to worry about checking the returned
+ *          pointer for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_mem_SlabStrDup
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator from which the copy is to be allocated.
+    const char*         strPtr      ///< [IN] String to copy.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size class (memory pool) of a slab allocator that is used for objects of a given size.
+ * This can be used to fetch the statistics of the size class, or to set the number of objects that
+ * le_mem_ForceSlabAlloc() adds to it when it is empty.
+ *
+ * @return
+ *      Reference to the size class's memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_PoolRef_t le_mem_GetSlabPool
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Object size (in bytes).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the destructor function for all the size classes of a slab allocator.
+ *
+ * See @ref mem_destructors for more information.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetSlabDestructor
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    le_mem_Destructor_t destructor  ///< [IN] Destructor function.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches the statistics for a slab allocator, totalled across all of its size classes.
+ *
+ * @return
+ *      Nothing.  Uses output parameter instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_GetSlabStats
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator where stats are to be fetched.
+    le_mem_PoolStats_t* statsPtr    ///< [OUT] Pointer to where the stats will be stored.
+);
+
+
 #endif // LEGATO_MEM_INCLUDE_GUARD
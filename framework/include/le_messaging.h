@@ -92,8 +92,10 @@
  * @section c_messagingClientUsage Client Usage Model
  *
  * @ref c_messagingClientSending <br>
+ * @ref c_messagingClientBatching <br>
  * @ref c_messagingClientReceiving <br>
  * @ref c_messagingClientClosing <br>
+ * @ref c_messagingClientReopening <br>
  * @ref c_messagingClientMultithreading <br>
  * @ref c_messagingClientExample
  *
@@ -182,6 +184,25 @@
  *     le_msg_ReleaseMsg(responseMsgRef);
  * @endcode
  *
+ * @subsection c_messagingClientBatching Batching Requests
+ *
+ * When a client needs the results of several requests at once, it can send them all in a single
+ * batch with le_msg_RequestSyncResponseBatch().  All the requests are written to the socket
+ * together before the client blocks, so the server can answer them back-to-back and the whole
+ * batch costs one round trip instead of one per request.  Each entry of the array is replaced by
+ * its response message (or NULL), and each response must be released as usual.
+ *
+ * @code
+ *     le_msg_MessageRef_t msgRefs[3] = { locationMsgRef, altitudeMsgRef, timeMsgRef };
+ *
+ *     le_msg_RequestSyncResponseBatch(msgRefs, 3);
+ * @endcode
+ *
+ * Generated client code exposes this through a Batch variant of each API function that doesn't
+ * take a handler (e.g., le_gnss_BatchGetAltitude() for le_gnss_GetAltitude()).  These queue the
+ * request instead of sending it, and the generated SendBatch function (e.g., le_gnss_SendBatch())
+ * sends everything queued by the calling thread and fills in the results and outputs.
+ *
  * @subsection c_messagingClientReceiving Receiving a Non-Response Message
  *
  * When a server sends a message to the client that is not a response to a request from the client,
@@ -266,6 +287,25 @@
  * @note If the client closes the session, the client-side session close handler will not be called,
  * even if one is registered.
  *
+ * @subsection c_messagingClientReopening Reopening Sessions Quickly
+ *
+ * Opening a session normally takes a trip through the Service Directory, which looks up the
+ * client interface's binding and hands the connection to the server.  A client that opens
+ * sessions on the same interface over and over can call le_msg_CacheServerEndpoint() on one of
+ * its sessions before opening it.  The next time a session on that interface opens
+ * synchronously, the framework also keeps a connection to the server (a "connector"), and later
+ * sessions on the interface are then opened directly with the server over it.
+ *
+ * @code
+ *     sessionRef = le_msg_CreateSession(protocolRef, MY_INTERFACE_NAME);
+ *     le_msg_CacheServerEndpoint(sessionRef);
+ *     le_msg_OpenSessionSync(sessionRef);
+ * @endcode
+ *
+ * The connector lives until the process exits or the server stops advertising the service, at
+ * which point sessions go through the Service Directory again.  It bypasses the binding lookup,
+ * so changes to the interface's binding don't affect sessions opened through it.
+ *
  * @subsection c_messagingClientMultithreading Multithreading
  *
  * The Low-Level Messaging API is thread safe, but not async safe.
@@ -590,6 +630,15 @@
  * To work around this, you could move the service to another thread that that runs the Legato event
  * loop.
  *
+ * A server whose requests can take a long time to handle (e.g., a network scan) would block all of
+ * its other clients while doing so.  To avoid this, it can call le_msg_SetServiceThreadPool()
+ * before advertising the service.  The receive handler is then called by a pool of worker threads
+ * instead of the server thread.  Each session sticks to one worker, so the messages from one client
+ * are still handled one at a time, in the order they were sent, but different clients are served
+ * in parallel.  The receive handler must then be safe to run in several threads at once.
+ * Responses and other messages sent to a client from a worker thread are handed over to the server
+ * thread for sending.  Session open and close handlers are still called by the server thread.
+ *
  * @subsection c_messagingServerExample Sample Code
  *
  * @code
@@ -638,6 +687,51 @@
  * }
  * @endcode
  *
+ * @section c_messagingLocal In-Process Messaging
+ *
+ * When a client and its server live in the same process, there is no need to send their messages
+ * through sockets.  Sessions with a service in the same process are connected directly to the
+ * server-side session: a message sent by one end is handed to the other end's thread as a queued
+ * function, without any system calls.  Messages from the server, and full-size messages from the
+ * client that don't need a response, are handed over without being copied.  Requests are copied
+ * into a full-size message, so the server can build its response in the same buffer as usual.
+ *
+ * If a client thread does a synchronous request-response transaction with a server in that same
+ * thread, the server's receive handler is called directly.  The handler must respond before it
+ * returns, otherwise the transaction terminates without a response.
+ *
+ * The mk tools call le_msg_AddLocalBinding() at start-up for each client-side interface of an
+ * executable that is bound to a server-side interface of that same executable.  Sessions on those
+ * client interfaces are then connected in-process whenever the service has been advertised in the
+ * process, and go through the Service Directory when it hasn't.  Nothing changes in the client or
+ * server code.
+ *
+ * A service can also be made available only to clients in the same process, without the Service
+ * Directory, using le_msg_InitLocalService().  Its messages are allocated from a memory pool
+ * provided by the server, each block of which must be big enough for #LE_MSG_LOCAL_HEADER_SIZE
+ * bytes plus the largest message payload.  Clients open sessions with it using sessions created
+ * by le_msg_CreateLocalSession().  A session opened with le_msg_OpenSession() or
+ * le_msg_OpenSessionSync() before the service is advertised waits for the advertisement.
+ *
+ * @code
+ * static le_msg_LocalService_t MyService;
+ *
+ * // Server side.
+ * le_mem_PoolRef_t poolRef = le_mem_CreatePool("MyServiceMsgs",
+ *                                              LE_MSG_LOCAL_HEADER_SIZE + sizeof(MyMessage_t));
+ * le_msg_ServiceRef_t serviceRef = le_msg_InitLocalService(&MyService, "MyService", poolRef);
+ * le_msg_SetServiceRecvHandler(serviceRef, RequestMsgHandlerFunc, NULL);
+ * le_msg_AdvertiseService(serviceRef);
+ *
+ * // Client side.
+ * le_msg_SessionRef_t sessionRef = le_msg_CreateLocalSession(&MyService);
+ * le_msg_OpenSessionSync(sessionRef);
+ * @endcode
+ *
+ * Sessions with a local service have no socket, so file descriptors sent over them are passed
+ * along as they are, and the client credentials reported to the server are those of the process
+ * itself.
+ *
  * @section c_messagingStartUp Start Up Sequencing
  *
  * Worthy of special mention is the fact that the low-level messaging system can be used to
@@ -679,6 +773,15 @@
  * From this, they obtain a protocol reference that they provide to sessions when they create
  * them.
  *
+ * A message doesn't have to be as big as the largest message in the protocol, though.  Messages
+ * are allocated from a set of size-classed pools, and le_msg_CreateSizedMsg() creates a message
+ * whose payload buffer is only as big as the sender needs.  le_msg_SetPayloadSize() tells the
+ * Messaging API how much of the payload buffer is actually in use, so that only that much is
+ * sent.  On the client side, received messages are only as big as what was sent; on the server
+ * side, requests are always received into a full-size buffer, because the response is built in the
+ * same buffer.  Any part of a received payload buffer that was not sent is zeroed.  The code
+ * generated from .api files does all of this automatically.
+ *
  * @section c_messagingSecurity Security
  *
  * Security is provided in the form of authentication and access control.
@@ -762,6 +865,31 @@
  * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  They can be exploited and used to break out of
  * chroot() jails.
  *
+ * @section c_messagingSharedBuffers Sending Large Buffers
+ *
+ * Large buffers don't have to be copied through the message payload.  le_msg_SetSharedBuffer()
+ * copies a buffer into an anonymous shared memory file (memfd), seals it so it can no longer be
+ * written, resized or resealed, and attaches its file descriptor to the message.  The receiver
+ * calls le_msg_GetSharedBuffer() to map the buffer read-only, straight out of the sender's copy,
+ * and le_msg_ReleaseSharedBuffer() when it is done with it.  Because the buffer travels as the
+ * message's file descriptor, it can't be combined with le_msg_SetFd() on the same message.
+ *
+ * In .api files, this is what the @c shared parameter type generates:
+ *
+ * @code
+ * FUNCTION Write
+ * (
+ *     shared data[1048576] IN
+ * );
+ * @endcode
+ *
+ * The generated C function takes the same <c>const uint8_t* dataPtr, size_t dataSize</c> pair as
+ * a @c uint8 array parameter, but the buffer does not count toward the message's maximum payload
+ * size.  On the server side, @c dataPtr points into the shared mapping, which is released as soon
+ * as the server function returns, so it must not be kept.  A @c shared parameter must be an IN
+ * parameter, can't be used in handlers or structures, and can't be combined with a @c file IN
+ * parameter on the same function.
+ *
  * @section c_messagingFutureEnhancements Future Enhancements
  *
  * As an optimization to reduce the number of copies in cases where the sender of a message
@@ -868,6 +996,26 @@ typedef struct le_msg_Message* le_msg_MessageRef_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct le_msg_SessionEventHandler* le_msg_SessionEventHandlerRef_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes that each block of a local service's message pool needs in addition to the
+ * largest message payload.  See le_msg_InitLocalService().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_MSG_LOCAL_HEADER_SIZE    (10 * sizeof(void*))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A service that can only be used by clients in the same process.  Set up using
+ * le_msg_InitLocalService().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_ServiceRef_t serviceRef;     ///< The service (NULL until initialized).
+}
+le_msg_LocalService_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function prototype for handlers that take session references as their arguments.
@@ -993,6 +1141,23 @@ le_msg_SessionRef_t le_msg_CreateSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a session with a service that can only be used by clients in the same process.
+ *
+ * @note    As for le_msg_CreateSession(), the session must then be opened.  See
+ *          @ref c_messagingLocal.
+ *
+ * @return  Session reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_msg_CreateLocalSession
+(
+    le_msg_LocalService_t*  servicePtr      ///< [in] Service initialized using
+                                            ///       le_msg_InitLocalService().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets an opaque context value (void pointer) that can be retrieved from that session later using
@@ -1082,6 +1247,22 @@ void le_msg_SetSessionCloseHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keeps a connection to the server of a session's client interface once a session on that
+ * interface has opened synchronously, so that later sessions on the interface (including ones
+ * created after this session is deleted) open directly with the server, without going through
+ * the Service Directory.  See @ref c_messagingClientReopening.
+ *
+ * @note This is a client-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_CacheServerEndpoint
+(
+    le_msg_SessionRef_t             sessionRef  ///< [in] Reference to the session.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Opens a session with a service, providing a function to be called-back when the session is
@@ -1263,6 +1444,25 @@ le_msg_MessageRef_t le_msg_CreateMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to be sent over a given session, with a payload buffer of a given size
+ * instead of the protocol's maximum message size.
+ *
+ * @return  Message reference.
+ *
+ * @note
+ * - Function never returns on failure, there's no need to check the return code.
+ * - The payload size must not be larger than the protocol's maximum message size.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateSizedMsg
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t              payloadSize ///< [in] Size of the payload buffer, in bytes.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds to the reference count on a message object.
@@ -1332,6 +1532,21 @@ size_t le_msg_GetMaxPayloadSize
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets how many bytes at the start of the message payload buffer are to be sent.  By default the
+ * whole payload buffer is sent.
+ *
+ * @note This can't be larger than le_msg_GetMaxPayloadSize().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of payload bytes to send.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -1363,6 +1578,56 @@ int le_msg_GetFd
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a buffer into a sealed shared memory file and attaches it to the message as the
+ * message's file descriptor.  An empty buffer sends nothing.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_IMPLEMENTED if the kernel doesn't support memfd_create().
+ *  - LE_NO_MEMORY if the shared memory could not be allocated.
+ *  - LE_FAULT for any other failure.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t le_msg_SetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    const void*         dataPtr,    ///< [in] Buffer to send.
+    size_t              size        ///< [in] Number of bytes in the buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a buffer sent with le_msg_SetSharedBuffer() read-only.  If the message carries no file
+ * descriptor, *dataPtrPtr is set to NULL and *sizePtr to 0.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FAULT if the file descriptor is not a sealed shared buffer or could not be mapped.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t le_msg_GetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    const void**        dataPtrPtr, ///< [out] Set to the address of the mapped buffer.
+    size_t*             sizePtr     ///< [out] Set to the number of bytes in the buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a buffer mapped by le_msg_GetSharedBuffer().
+ **/
+//--------------------------------------------------------------------------------------------------
+void le_msg_ReleaseSharedBuffer
+(
+    const void* dataPtr,    ///< [in] Buffer address returned by le_msg_GetSharedBuffer().
+    size_t      size        ///< [in] Buffer size returned by le_msg_GetSharedBuffer().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message.  No response expected.
@@ -1443,6 +1708,27 @@ le_msg_MessageRef_t le_msg_RequestSyncResponse
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Requests responses from a server by sending it several requests at once.  All the requests are
+ * sent before the calling thread blocks, and the function returns once every transaction has
+ * either been answered or terminated without a response.
+ *
+ * Each entry in the array is replaced by a reference to the response to that request, or NULL if
+ * the transaction terminated without a response.  The request references are released.
+ *
+ * @note
+ *        - All the requests must belong to the same session.
+ *        - The same restrictions as for le_msg_RequestSyncResponse() apply.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_RequestSyncResponseBatch
+(
+    le_msg_MessageRef_t*    msgRefs,    ///< [in,out] Requests in; responses (or NULL) out.
+    size_t                  msgCount    ///< [in] Number of entries in the array.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a response back to the client that send the request message.
@@ -1480,6 +1766,45 @@ le_msg_ServiceRef_t le_msg_CreateService
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes a service that can only be used by clients in the same process.  Clients open
+ * sessions with it using le_msg_CreateLocalSession(), without going through the Service Directory.
+ *
+ * The service's protocol is identified by the service name.  Its largest message payload is the
+ * pool's object size minus #LE_MSG_LOCAL_HEADER_SIZE, and all messages of the service are
+ * allocated from the pool.
+ *
+ * The service is attached to the first thread that sets its handlers or advertises it, so it
+ * can be initialized before its server thread is started.
+ *
+ * @return  Service reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_msg_InitLocalService
+(
+    le_msg_LocalService_t*  servicePtr,     ///< [out] Service to initialize.
+    const char*             name,           ///< [in] Service name.
+    le_mem_PoolRef_t        messagePoolRef  ///< [in] Pool to allocate the messages from.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Declares that a client-side interface is bound to a server-side interface offered in the same
+ * process, so that sessions on the client interface can be connected in-process once the service
+ * is advertised.  See @ref c_messagingLocal.
+ *
+ * @note    This is normally called by the startup code generated by the mk tools.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_AddLocalBinding
+(
+    const char* clientInterfaceName,    ///< [in] Name of the client-side interface.
+    const char* serverInterfaceName     ///< [in] Name of the server-side interface.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes a service. Any open sessions will be terminated.
@@ -1551,6 +1876,25 @@ void le_msg_SetServiceRecvHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a pool of worker threads that handle the messages received from clients of a service,
+ * instead of the service's server thread.
+ *
+ * Each session is assigned to one worker when it opens, so messages from the same client are
+ * still handled in order, while messages from different clients are handled in parallel.
+ *
+ * @note    Server-only function.  Must be called by the server thread, at most once, before the
+ *          service is advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceThreadPool
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              threadCount ///< [in] Number of worker threads (1 or more).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -44,6 +44,14 @@
  * Functions for creating mutexes:
  *  - @c le_mutex_CreateRecursive() - creates a recursive mutex.
  *  - @c le_mutex_CreateNonRecursive() - creates a non-recursive mutex.
+ *  - @c le_mutex_CreateAdaptive() - creates a non-recursive mutex that spins for a short while
+ *       before sleeping when it is already held.
+ *
+ * An adaptive mutex is faster than a plain non-recursive one when it protects critical sections
+ * that are short (a few hundred instructions) and is contended between threads running on
+ * different CPU cores, because the thread waiting for it usually gets it without going to sleep
+ * and being woken up again.  On a single-core system, or for long critical sections, the spinning
+ * only wastes CPU time, so use a non-recursive mutex instead.
  *
  * All mutexes have names, required for diagnostic purposes.  See
  * @ref c_mutex_diagnostics below.
@@ -70,6 +78,13 @@
  * that currently exist inside a given process.  The state of each mutex can be
  * seen, including a list of any threads that might be waiting for that mutex.
  *
+ * Keeping track of this costs a few extra memory accesses and a lock on every le_mutex_Lock() and
+ * le_mutex_Unlock() call.  In a framework built with @c LE_MUTEX_DIAGNOSTICS_DISABLE (see
+ * @ref bld_cfg_mutex_diagnostics_disable), locking and unlocking are straight calls to the
+ * underlying POSIX mutex, whose uncontended path is a single atomic operation, and the inspect tool
+ * only lists the mutexes.  Errors such as unlocking a mutex held by another thread are then no
+ * longer detected.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -123,6 +138,21 @@ le_mutex_Ref_t le_mutex_CreateNonRecursive
     const char* nameStr     ///< [in] Name of the mutex
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an Adaptive mutex: a non-recursive mutex that spins for a short while before sleeping
+ * when it is held by another thread.  Meant for short critical sections.
+ *
+ * @return  Returns a reference to the mutex.
+ *
+ * @note Terminates the process on failure, no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mutex_Ref_t le_mutex_CreateAdaptive
+(
+    const char* nameStr     ///< [in] Name of the mutex
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete a mutex.
@@ -16,6 +16,10 @@
  *   - Packing arrays of the above types
  *   - Packing strings.
  * It also supports unpacking any of the above.
+ *
+ * Integers, chars, doubles, results and on/off values are packed as a straight copy of their
+ * memory, so arrays of them are packed in a single copy by le_pack_PackUint8Array(),
+ * le_pack_PackInt32Array(), etc. rather than element by element.
  */
 
 #ifndef LE_PACK_H_INCLUDE_GUARD
@@ -510,6 +514,101 @@ static inline bool le_pack_PackArrayHeader
         }                                                               \
     } while (0)
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array of elements that are packed as a straight copy of their memory into a buffer,
+ * incrementing the buffer pointer and decrementing the available size.  The whole array is
+ * copied at once, rather than element by element.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ *
+ * @note Users of this API should generally use the typed functions (le_pack_PackUint8Array(),
+ * etc.) instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackBlockArray
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    const void *arrayPtr,
+    size_t elementSize,
+    size_t arrayCount,
+    size_t arrayMaxCount
+)
+{
+    if (!le_pack_PackArrayHeader(bufferPtr, sizePtr, arrayPtr, elementSize,
+                                 arrayCount, arrayMaxCount))
+    {
+        return false;
+    }
+
+    if (arrayCount > 0)
+    {
+        memcpy(*bufferPtr, arrayPtr, arrayCount*elementSize);
+    }
+
+    *bufferPtr = *bufferPtr + arrayCount*elementSize;
+    *sizePtr -= arrayMaxCount*elementSize;
+
+    return true;
+}
+
+// Packing an array of simple values is the same regardless of type.  The typed functions give
+// better verification that we're only packing the types we expect.
+#define LE_PACK_DECLARE_PACK_ARRAY(typeName, type)                      \
+    static inline bool le_pack_Pack##typeName##Array                    \
+    (                                                                   \
+        uint8_t **bufferPtr,                                            \
+        size_t *sizePtr,                                                \
+        const type *arrayPtr,                                           \
+        size_t arrayCount,                                              \
+        size_t arrayMaxCount                                            \
+    )                                                                   \
+    {                                                                   \
+        return le_pack_PackBlockArray(bufferPtr, sizePtr, arrayPtr, sizeof(type), \
+                                      arrayCount, arrayMaxCount);       \
+    }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array of simple values into a buffer in a single copy, incrementing the buffer pointer
+ * and decrementing the available size.  Produces the same result as LE_PACK_PACKARRAY with the
+ * matching single value pack function.
+ *
+ * @code
+ * static inline bool le_pack_PackUint8Array
+ * (
+ *     uint8_t **bufferPtr,
+ *     size_t *sizePtr,
+ *     const uint8_t *arrayPtr,
+ *     size_t arrayCount,
+ *     size_t arrayMaxCount
+ * );
+ * @endcode
+ *
+ * And likewise for Uint16, Uint32, Uint64, Int8, Int16, Int32, Int64, Char, Double, Result and
+ * OnOff.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_PACK_DECLARE_PACK_ARRAY(Uint8, uint8_t)
+LE_PACK_DECLARE_PACK_ARRAY(Uint16, uint16_t)
+LE_PACK_DECLARE_PACK_ARRAY(Uint32, uint32_t)
+LE_PACK_DECLARE_PACK_ARRAY(Uint64, uint64_t)
+LE_PACK_DECLARE_PACK_ARRAY(Int8, int8_t)
+LE_PACK_DECLARE_PACK_ARRAY(Int16, int16_t)
+LE_PACK_DECLARE_PACK_ARRAY(Int32, int32_t)
+LE_PACK_DECLARE_PACK_ARRAY(Int64, int64_t)
+LE_PACK_DECLARE_PACK_ARRAY(Char, char)
+LE_PACK_DECLARE_PACK_ARRAY(Double, double)
+LE_PACK_DECLARE_PACK_ARRAY(Result, le_result_t)
+LE_PACK_DECLARE_PACK_ARRAY(OnOff, le_onoff_t)
+
+#undef LE_PACK_DECLARE_PACK_ARRAY
+
 //--------------------------------------------------------------------------------------------------
 // Unpack functions
 //--------------------------------------------------------------------------------------------------
@@ -1006,4 +1105,100 @@ static inline bool le_pack_UnpackArrayHeader
     LE_PACK_UNPACKARRAY((bufferPtr), (sizePtr), (arrayPtr), (arrayCountPtr), \
                         (arrayMaxCount), (unpackFunc), (resultPtr))
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array of elements that are packed as a straight copy of their memory from a buffer,
+ * incrementing the buffer pointer and decrementing the available size.  The whole array is
+ * copied at once, rather than element by element.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ *
+ * @note Users of this API should generally use the typed functions (le_pack_UnpackUint8Array(),
+ * etc.) instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackBlockArray
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    void *arrayPtr,
+    size_t elementSize,
+    size_t *arrayCountPtr,
+    size_t arrayMaxCount
+)
+{
+    if (!le_pack_UnpackArrayHeader(bufferPtr, sizePtr, arrayPtr, elementSize,
+                                   arrayCountPtr, arrayMaxCount))
+    {
+        return false;
+    }
+
+    if (*arrayCountPtr > 0)
+    {
+        memcpy(arrayPtr, *bufferPtr, (*arrayCountPtr)*elementSize);
+    }
+
+    *bufferPtr = *bufferPtr + (*arrayCountPtr)*elementSize;
+    *sizePtr -= arrayMaxCount*elementSize;
+
+    return true;
+}
+
+// Unpacking an array of simple values is the same regardless of type.  The typed functions give
+// better verification that we're only unpacking the types we expect.
+#define LE_PACK_DECLARE_UNPACK_ARRAY(typeName, type)                    \
+    static inline bool le_pack_Unpack##typeName##Array                  \
+    (                                                                   \
+        uint8_t **bufferPtr,                                            \
+        size_t *sizePtr,                                                \
+        type *arrayPtr,                                                 \
+        size_t *arrayCountPtr,                                          \
+        size_t arrayMaxCount                                            \
+    )                                                                   \
+    {                                                                   \
+        return le_pack_UnpackBlockArray(bufferPtr, sizePtr, arrayPtr, sizeof(type), \
+                                        arrayCountPtr, arrayMaxCount);  \
+    }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array of simple values from a buffer in a single copy, incrementing the buffer pointer
+ * and decrementing the available size.  Produces the same result as LE_PACK_UNPACKARRAY with the
+ * matching single value unpack function.
+ *
+ * @code
+ * static inline bool le_pack_UnpackUint8Array
+ * (
+ *     uint8_t **bufferPtr,
+ *     size_t *sizePtr,
+ *     uint8_t *arrayPtr,
+ *     size_t *arrayCountPtr,
+ *     size_t arrayMaxCount
+ * );
+ * @endcode
+ *
+ * And likewise for Uint16, Uint32, Uint64, Int8, Int16, Int32, Int64, Char, Double, Result and
+ * OnOff.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_PACK_DECLARE_UNPACK_ARRAY(Uint8, uint8_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Uint16, uint16_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Uint32, uint32_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Uint64, uint64_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Int8, int8_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Int16, int16_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Int32, int32_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Int64, int64_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(Char, char)
+LE_PACK_DECLARE_UNPACK_ARRAY(Double, double)
+LE_PACK_DECLARE_UNPACK_ARRAY(Result, le_result_t)
+LE_PACK_DECLARE_UNPACK_ARRAY(OnOff, le_onoff_t)
+
+#undef LE_PACK_DECLARE_UNPACK_ARRAY
+
 #endif /* LE_PACK_H_INCLUDE_GUARD */
@@ -81,6 +81,34 @@
  * @note @c le_pathIter_GetNextNode() and @c le_pathIter_GetPreviousNode() treat consecutive
  *       separators as a single separator.
  *
+ * @section c_pathIter_view Walking a Path Without an Iterator Object
+ *
+ * To simply walk the nodes of a path string, a path view can be used instead of an iterator
+ * object.  A view is a small structure, normally on the stack, that refers to the path string
+ * rather than holding a copy of it, so it doesn't need to be created or deleted.  Each node is
+ * given as a pointer into the path and a size, rather than being copied out.
+ *
+ * @code
+ *
+ * le_pathIter_View_t view;
+ * const char* nodePtr;
+ * size_t nodeSize;
+ *
+ * le_pathIter_InitView(&view, myPathPtr, "/");
+ *
+ * while (le_pathIter_ViewNext(&view, &nodePtr, &nodeSize) == LE_OK)
+ * {
+ *     printf("%.*s\n", (int)nodeSize, nodePtr);
+ * }
+ *
+ * @endcode
+ *
+ * le_pathIter_GetView() gives a view of the path held by an iterator object.
+ *
+ * Unlike an iterator object, a view doesn't normalize the path, so parent and current node
+ * specifiers (such as ".." and ".") are given like any other node.  Consecutive separators are
+ * still treated as a single separator.  The path must not be changed while it is being viewed.
+ *
  * @section c_pathIter_absoluteRelative Absolute versus Relative Paths
  *
  * Absolute paths begin with one or more separators.  Relative paths do not begin with a separator.
@@ -433,4 +461,79 @@ bool le_pathIter_IsEmpty
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A view of a path string, used to walk the nodes of the path without copying it.  See
+ * @ref c_pathIter_view.  The members may be read, but should only be changed by the
+ * le_pathIter_*View* functions.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* pathPtr;        ///< The path being viewed.
+    const char* separatorPtr;   ///< The path separator.
+    size_t separatorSize;       ///< Size of the separator in bytes.
+    size_t position;            ///< Offset in the path of the rest of the path to walk.
+}
+le_pathIter_View_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a view of a path string, ready to walk its nodes from the start.  Neither the path
+ * nor the separator are copied, so they must stay as they are for as long as the view is used.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pathIter_InitView
+(
+    le_pathIter_View_t* viewPtr,    ///< [OUT] The view to initialize.
+    const char* pathPtr,            ///< [IN] The path to view.
+    const char* separatorPtr        ///< [IN] Path separator.  Can not be NULL or empty.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a view of the path held by an iterator object, ready to walk its nodes from the
+ * start.  The view may only be used until the iterator's path is changed or the iterator is
+ * deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pathIter_GetView
+(
+    le_pathIter_Ref_t iterRef,      ///< [IN] The iterator object to view.
+    le_pathIter_View_t* viewPtr     ///< [OUT] The view to initialize.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is the viewed path absolute?
+ *
+ * @return True if the path begins with a separator, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_pathIter_ViewIsAbsolute
+(
+    const le_pathIter_View_t* viewPtr   ///< [IN] The view to read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move on to the next node of the viewed path.  The node isn't copied, nor null-terminated.
+ *
+ * @return
+ *      LE_OK if a node was found.
+ *      LE_NOT_FOUND if there are no more nodes in the path.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pathIter_ViewNext
+(
+    le_pathIter_View_t* viewPtr,    ///< [IN/OUT] The view to update.
+    const char** nodePtrPtr,        ///< [OUT] Start of the node in the path.
+    size_t* nodeSizePtr             ///< [OUT] Size of the node in bytes.
+);
+
+
 #endif  // LEGATO_PATH_ITER_INCLUDE_GUARD
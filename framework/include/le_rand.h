@@ -11,6 +11,10 @@
  * The random numbers returned by this API may be used for cryptographic purposes such as encryption
  * keys, initialization vectors, etc.
  *
+ * Small requests are served from a per-thread generator, seeded and periodically reseeded from
+ * the kernel's entropy pool, so they don't need a system call.  A forked child process never gets
+ * the same random numbers as its parent.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -56,6 +56,11 @@
  * created by calling @c le_ref_CreateMap().  It takes a single argument, the maximum number
  * of mappings expected to track of at any time.
  *
+ * The Reference Map keeps its mappings in an array of slots, sized for that many mappings to
+ * begin with and grown if more are needed.  A Safe Reference holds the index of its slot and a
+ * count of how many times the slot has been reused, so looking up or deleting a Safe Reference
+ * takes the same short time however many mappings the map holds.
+ *
  * @section c_safeRef_multithreading Multithreading
  *
  * This API's functions are reentrant, but not thread safe. If there's the slightest
@@ -0,0 +1,166 @@
+/** @page c_threadPool Thread Pool API
+ *
+ * @ref le_threadPool.h "API Reference"
+ *
+ * <HR>
+ *
+ * A thread pool runs short pieces of work (tasks) on a fixed set of worker threads, so that a
+ * thread running an event loop can get blocking or CPU-heavy work done without creating a thread
+ * for each piece of work, and without blocking its event loop.
+ *
+ * @section c_threadPool_create Creating a Thread Pool
+ *
+ * le_threadPool_Create() creates a pool and starts its worker threads.  Like other Legato objects,
+ * thread pools have names, which are used for diagnostics (see @ref c_threadPool_diagnostics).
+ *
+ * @code
+ * static le_threadPool_Ref_t PoolRef;
+ *
+ * COMPONENT_INIT
+ * {
+ *     PoolRef = le_threadPool_Create("hashers", 4);
+ * }
+ * @endcode
+ *
+ * @section c_threadPool_submit Submitting Tasks
+ *
+ * le_threadPool_Submit() queues a task: a work function, a context pointer passed to it, and an
+ * optional completion function.  The work function runs on one of the pool's workers.  When it
+ * returns, the completion function is queued to the event loop of the thread that submitted the
+ * task (see le_event_QueueFunctionToThread()) and receives the context pointer and the value
+ * returned by the work function.  The submitting thread must therefore be running an event loop
+ * if it passes a completion function.
+ *
+ * @code
+ * static void* HashFile(void* contextPtr)
+ * {
+ *     // Runs on a worker thread; can block.
+ *     ...
+ *     return digestPtr;
+ * }
+ *
+ * static void HashDone(void* contextPtr, void* resultPtr)
+ * {
+ *     // Runs on the thread that called le_threadPool_Submit().
+ *     ...
+ * }
+ *
+ * le_threadPool_Submit(PoolRef, HashFile, HashDone, filePathPtr);
+ * @endcode
+ *
+ * Each worker has its own task queue.  Tasks submitted by a worker itself (e.g., a task that
+ * splits its work into smaller tasks) go onto that worker's queue, and it runs the most recently
+ * queued one first, while its data is still in the cache.  Tasks submitted by other threads are
+ * spread over the workers' queues in turn.  A worker whose queue is empty takes (steals) the
+ * oldest task from another worker's queue, so that no worker is idle while tasks are waiting.
+ *
+ * There is no ordering between tasks: they may run in any order and in parallel.
+ *
+ * @section c_threadPool_delete Deleting a Thread Pool
+ *
+ * le_threadPool_Delete() waits for the tasks already submitted to run, then stops and joins the
+ * workers.  Completion functions that were already queued still run.  It must not be called from
+ * one of the pool's workers.
+ *
+ * @section c_threadPool_diagnostics Diagnostics
+ *
+ * The command-line @ref toolsTarget_inspect tool can be used to list the thread pools that exist
+ * inside a given process, with the number of tasks submitted, completed and stolen, the number of
+ * tasks waiting, and the time the workers have spent running tasks.
+ *
+ * <HR>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+/** @file le_threadPool.h
+ *
+ * Legato @ref c_threadPool include file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_THREAD_POOL_INCLUDE_GUARD
+#define LEGATO_THREAD_POOL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a thread pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_threadPool* le_threadPool_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that does the work of a task.  Runs on one of the pool's worker threads.
+ *
+ * @return  Value passed to the task's completion function.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void* (*le_threadPool_WorkFunc_t)
+(
+    void* contextPtr    ///< [IN] Context pointer given when the task was submitted.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called when a task is done.  Runs on the thread that submitted the task.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*le_threadPool_CompletionFunc_t)
+(
+    void* contextPtr,   ///< [IN] Context pointer given when the task was submitted.
+    void* resultPtr     ///< [IN] Value returned by the task's work function.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a thread pool and starts its worker threads.
+ *
+ * @return  A reference to the thread pool.
+ *
+ * @note Terminates the process on failure, no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_threadPool_Ref_t le_threadPool_Create
+(
+    const char* name,       ///< [IN] Name of the pool (will be copied, so can be temporary).
+    size_t numWorkers       ///< [IN] Number of worker threads (at least 1).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submits a task to a thread pool.
+ *
+ * If a completion function is given, the calling thread must be running an event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Submit
+(
+    le_threadPool_Ref_t poolRef,                    ///< [IN] The thread pool.
+    le_threadPool_WorkFunc_t workFunc,              ///< [IN] Function that does the work.
+    le_threadPool_CompletionFunc_t completionFunc,  ///< [IN] Function to call on the calling
+                                                    ///<      thread when done, or NULL.
+    void* contextPtr                                ///< [IN] Passed to both functions.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a thread pool once the tasks already submitted to it have run.  Blocks until its worker
+ * threads have stopped.
+ *
+ * @warning Must not be called by one of the pool's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Delete
+(
+    le_threadPool_Ref_t poolRef     ///< [IN] The thread pool.
+);
+
+
+#endif // LEGATO_THREAD_POOL_INCLUDE_GUARD
@@ -70,6 +70,17 @@
  * The number of times that a timer has expired can be retrieved by le_timer_GetExpiryCount(). This
  * count is independent of whether there is an expiry handler for the timer.
  *
+ * @section le_timer_slack Timer Slack
+ *
+ * Every time a timer expires, the thread (and possibly the whole system) has to wake up.  For
+ * timers that don't need to expire at a precise time, such as periodic housekeeping or watchdog
+ * kicks, le_timer_SetSlack() or le_timer_SetMsSlack() can be used to allow the timer to expire up
+ * to a given amount of time late.  A thread's timers that become due within each other's slack
+ * are then all handled by a single wake-up.  The slack is zero by default.
+ *
+ * Slack only delays the call to the expiry handler.  A repeating timer's expiry times are still
+ * spaced by its interval, so the slack doesn't accumulate from one expiry to the next.
+ *
  * @section le_timer_thread Thread Support
  *
  * A timer should only be used by the thread that created it. It's not safe for a thread to use
@@ -110,6 +121,8 @@
  *     - le_timer_GetTimeRemaining()
  *     - le_timer_GetMsTimeRemaining()
  *     - le_timer_SetWakeup()
+ *     - le_timer_SetSlack()
+ *     - le_timer_SetMsSlack()
  *
  * @section timer_troubleshooting Troubleshooting
  *
@@ -311,6 +324,45 @@ le_result_t le_timer_SetRepeat
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, so that its expiry can be handled together with
+ * other timers.  See @ref le_timer_slack.  The default is no slack.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetSlack
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set slack for this timer object
+    le_clk_Time_t slack          ///< [IN] Maximum time by which the expiry can be delayed
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, in milliseconds.  See le_timer_SetSlack().
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsSlack
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set slack for this timer object
+    uint32_t slack               ///< [IN] Maximum time by which the expiry can be delayed (ms)
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configure if timer expiry will wake up a suspended system.
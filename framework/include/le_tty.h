@@ -27,6 +27,13 @@
  * failed with LE_UNSUPPORTED, use @c le_tty_GetBaudRate() to retrieve the real
  * value sets by the driver.
  *
+ * - Baud rates which are not listed by #tty_Speed_t (e.g. 3686400 bits/s) are set with
+ * @c le_tty_SetCustomBaudRate() and retrieved with @c le_tty_GetCustomBaudRate().
+ *
+ * - Setting the low latency mode of the driver is done with @c le_tty_SetLowLatency(). It is
+ * recommended for high baud rates, where the received bytes must be pushed to the reader as soon
+ * as they arrive to avoid overruns.
+ *
  * - Setting framing on serial port is done with @c le_tty_SetFraming().
  * Parity value can be :
  *  - "N" for No parity
@@ -60,6 +67,16 @@
  * To switch between 'cannonical' and 'raw' mode, just call @c le_tty_SetCanonical() and
  * @c le_tty_SetRaw() respectively
  *
+ * For a high speed link, the typical settings are raw mode with numChars > 0, so that a read
+ * returns a batch of bytes rather than each byte, hardware flow control, and low latency mode:
+ *
+ * @code
+ * le_tty_SetCustomBaudRate(fd, 3000000);
+ * le_tty_SetFlowControl(fd, LE_TTY_FLOW_CONTROL_HARDWARE);
+ * le_tty_SetRaw(fd, 64, 1);
+ * le_tty_SetLowLatency(fd, true);
+ * @endcode
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -261,4 +278,58 @@ le_result_t le_tty_SetRaw
                     ///<      The timeout value is given with 1 decimal places.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set baud rate of serial port to any value, including the ones which are not listed by
+ * #tty_Speed_t.  The driver may round the baud rate to the closest one it can generate.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if value cannot be set
+ *  - LE_NOT_FOUND if value is not supported
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetCustomBaudRate
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t baudRate       ///< [IN] Baud rate, in bits/s
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get baud rate of serial port, in bits/s.  Unlike le_tty_GetBaudRate(), it also gets the baud
+ * rates which are not listed by #tty_Speed_t.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_GetCustomBaudRate
+(
+    int fd,                     ///< [IN] File Descriptor
+    uint32_t *inRatePtr,        ///< [OUT] input baud rate
+    uint32_t *outRatePtr        ///< [OUT] output baud rate
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the low latency mode of a serial port.  In low latency mode, the driver pushes
+ * the received bytes to the reader as soon as they arrive instead of deferring it, at the cost of
+ * CPU load.  This is recommended for high baud rates, where deferred pushes can overrun the UART.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support the low latency mode
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetLowLatency
+(
+    int fd,             ///< [IN] File Descriptor
+    bool isEnabled      ///< [IN] Enable the low latency mode?
+);
+
 #endif // LEGATO_TTY_H_INCLUDE_GUARD
@@ -12,8 +12,12 @@
  *
  * @subpage c_le_build_cfg <br>
  * @subpage c_basics <br>
+ * @subpage c_arena <br>
  * @subpage c_args <br>
+ * @subpage c_array <br>
  * @subpage c_atomFile <br>
+ * @subpage c_cfgSnapshot <br>
+ * @subpage c_coro <br>
  * @subpage c_crc <br>
  * @subpage c_dir <br>
  * @subpage c_doublyLinkedList <br>
@@ -39,6 +43,7 @@
  * @subpage c_singlyLinkedList <br>
  * @subpage c_clock <br>
  * @subpage c_threading <br>
+ * @subpage c_threadPool <br>
  * @subpage c_timer <br>
  * @subpage c_test <br>
  * @subpage c_utf8 <br>
@@ -199,11 +204,15 @@ extern "C" {
 #include "le_utf8.h"
 #include "le_log.h"
 #include "le_mem.h"
+#include "le_array.h"
+#include "le_arena.h"
 #include "le_mutex.h"
 #include "le_clock.h"
 #include "le_semaphore.h"
 #include "le_safeRef.h"
 #include "le_thread.h"
+#include "le_threadPool.h"
+#include "le_coro.h"
 #include "le_eventLoop.h"
 #include "le_fdMonitor.h"
 #include "le_hashmap.h"
@@ -223,6 +232,7 @@ extern "C" {
 #include "le_atomFile.h"
 #include "le_crc.h"
 #include "le_fs.h"
+#include "le_cfgSnapshot.h"
 #include "le_rand.h"
 
 #ifdef __cplusplus
@@ -12,6 +12,10 @@ package io.legato;
 
 import java.io.FileDescriptor;
 import java.math.BigInteger;
+import java.nio.Buffer;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -19,6 +23,10 @@ import java.math.BigInteger;
  *
  * The get and set methods act as a streaming operation. The buffer maintains an
  * internal pointer that is updated as values are read and written.
+ *
+ * The payload is accessed through a direct {@link ByteBuffer} mapped onto the message's memory,
+ * so that a whole message is packed and unpacked in Java; only the file descriptor accessors
+ * cross into native code.  The buffer is only valid as long as the message it was obtained from.
  */
 // --------------------------------------------------------------------------------------------------
 public class MessageBuffer implements AutoCloseable {
@@ -28,43 +36,15 @@ public class MessageBuffer implements AutoCloseable {
 	private Message hostMessage;
 
 	/**
-	 * The current buffer insertion location. Reads and writes start from and update
-	 * this location.
+	 * The message's payload, in the byte order of the native code on the other side.
 	 */
-	private int location;
+	private ByteBuffer payload;
 
-	// ----------------------------------------------------------------------------------------------
 	/**
-	 * Package internal class used to keep track of the amount of bytes variable
-	 * length data structures require when being written into the data buffer.
+	 * The current buffer insertion location. Reads and writes start from and update
+	 * this location.
 	 */
-	// ----------------------------------------------------------------------------------------------
-	class LocationValue {
-		/**
-		 * The message object that owns this buffer.
-		 */
-		public final int bytesUsed;
-
-		/**
-		 * The message object that owns this buffer.
-		 */
-		public final Object value;
-
-		// ------------------------------------------------------------------------------------------
-		/**
-		 * Construct a new location value.
-		 *
-		 * @param newBytesUsed
-		 *            The number of bytes needed to store the object.
-		 * @param newValue
-		 *            The object itself.
-		 */
-		// ------------------------------------------------------------------------------------------
-		LocationValue(int newBytesUsed, Object newValue) {
-			bytesUsed = newBytesUsed;
-			value = newValue;
-		}
-	}
+	private int location;
 
 	// ----------------------------------------------------------------------------------------------
 	/**
@@ -77,6 +57,11 @@ public class MessageBuffer implements AutoCloseable {
 	// ----------------------------------------------------------------------------------------------
 	MessageBuffer(Message message) {
 		hostMessage = message;
+		payload = LegatoJni.GetPayloadBuffer(message.getRef());
+		if (payload == null) {
+			throw new IllegalStateException("Direct buffer access is not supported by the JVM");
+		}
+		payload.order(ByteOrder.nativeOrder());
 		location = 0;
 	}
 
@@ -88,6 +73,7 @@ public class MessageBuffer implements AutoCloseable {
 	@Override
 	public void close() {
 		hostMessage = null;
+		payload = null;
 		location = 0;
 	}
 
@@ -100,6 +86,19 @@ public class MessageBuffer implements AutoCloseable {
 		location = 0;
 	}
 
+	// ----------------------------------------------------------------------------------------------
+	/**
+	 * Move the payload's own position to a given offset, for the bulk get and put operations.
+	 *
+	 * @param offset
+	 *            The new position of the payload.
+	 */
+	// ----------------------------------------------------------------------------------------------
+	private void seek(int offset) {
+		// Going through Buffer keeps the code compatible with the Java 8 runtime.
+		((Buffer) payload).position(offset);
+	}
+
 	// ----------------------------------------------------------------------------------------------
 	/**
 	 * Read a boolean value from the message buffer.
@@ -108,7 +107,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public boolean readBool() {
-		boolean result = LegatoJni.GetMessageBool(hostMessage.getRef(), location);
+		boolean result = (payload.get(location) != 0);
 		location += 1;
 
 		return result;
@@ -123,7 +122,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeBool(boolean newValue) {
-		LegatoJni.SetMessageBool(hostMessage.getRef(), location, newValue);
+		payload.put(location, (byte) (newValue ? 1 : 0));
 		location += 1;
 	}
 
@@ -158,7 +157,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public byte readByte() {
-		byte result = LegatoJni.GetMessageByte(hostMessage.getRef(), location);
+		byte result = payload.get(location);
 		location += 1;
 
 		return result;
@@ -173,7 +172,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeByte(byte newValue) {
-		LegatoJni.SetMessageByte(hostMessage.getRef(), location, newValue);
+		payload.put(location, newValue);
 		location += 1;
 	}
 
@@ -185,7 +184,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public short readShort() {
-		short result = LegatoJni.GetMessageShort(hostMessage.getRef(), location);
+		short result = payload.getShort(location);
 		location += 2;
 
 		return result;
@@ -200,7 +199,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeShort(Short newValue) {
-		LegatoJni.SetMessageShort(hostMessage.getRef(), location, newValue);
+		payload.putShort(location, newValue);
 		location += 2;
 	}
 
@@ -212,7 +211,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public int readInt() {
-		int result = LegatoJni.GetMessageInt(hostMessage.getRef(), location);
+		int result = payload.getInt(location);
 		location += 4;
 
 		return result;
@@ -227,7 +226,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeInt(int newValue) {
-		LegatoJni.SetMessageInt(hostMessage.getRef(), location, newValue);
+		payload.putInt(location, newValue);
 		location += 4;
 	}
 
@@ -239,7 +238,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public long readLong() {
-		long result = LegatoJni.GetMessageLong(hostMessage.getRef(), location);
+		long result = payload.getLong(location);
 		location += 8;
 
 		return result;
@@ -254,7 +253,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeLong(long newValue) {
-		LegatoJni.SetMessageLong(hostMessage.getRef(), location, newValue);
+		payload.putLong(location, newValue);
 		location += 8;
 	}
 
@@ -266,7 +265,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public double readDouble() {
-		double result = LegatoJni.GetMessageDouble(hostMessage.getRef(), location);
+		double result = payload.getDouble(location);
 		location += 8;
 
 		return result;
@@ -281,7 +280,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeDouble(double newValue) {
-		LegatoJni.SetMessageDouble(hostMessage.getRef(), location, newValue);
+		payload.putDouble(location, newValue);
 		location += 8;
 	}
 
@@ -294,10 +293,14 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public String readString() {
-		LocationValue result = LegatoJni.GetMessageString(hostMessage.getRef(), location);
+		// The string's size is packed first, then the string itself without its terminator.
+		byte[] bytes = new byte[payload.getInt(location)];
 
-		location += result.bytesUsed;
-		return (String) result.value;
+		seek(location + 4);
+		payload.get(bytes);
+		location += 4 + bytes.length;
+
+		return new String(bytes, StandardCharsets.UTF_8);
 	}
 
 	// ----------------------------------------------------------------------------------------------
@@ -309,7 +312,12 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public void writeString(String strValue, int maxSize) {
-		location += LegatoJni.SetMessageString(hostMessage.getRef(), location, strValue, maxSize);
+		byte[] bytes = strValue.getBytes(StandardCharsets.UTF_8);
+
+		payload.putInt(location, bytes.length);
+		seek(location + 4);
+		payload.put(bytes);
+		location += 4 + bytes.length;
 	}
 
 	// ----------------------------------------------------------------------------------------------
@@ -320,7 +328,7 @@ public class MessageBuffer implements AutoCloseable {
 	 */
 	// ----------------------------------------------------------------------------------------------
 	public long readLongRef() {
-		long result = Integer.toUnsignedLong(LegatoJni.GetMessageInt(hostMessage.getRef(), location));
+		long result = Integer.toUnsignedLong(payload.getInt(location));
 		location += 4;
 
 		return result;
@@ -339,7 +347,7 @@ public class MessageBuffer implements AutoCloseable {
 			throw new IllegalArgumentException("Illegal reference");
 		}
 
-		LegatoJni.SetMessageInt(hostMessage.getRef(), location, (int) longRef);
+		payload.putInt(location, (int) longRef);
 		location += 4;
 	}
 
@@ -379,49 +379,6 @@ static void InternalComponentInit
 
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  Construct a location value for returning a value and a size, (in bytes,) of that value.
- */
-//--------------------------------------------------------------------------------------------------
-static jobject NewLocationValue
-(
-    JNIEnv* envPtr,     ///< [IN] The Java environment to work out of.
-    jobject parentPtr,  ///< [IN] Location value is a nested class of MessageBuffer, so it's
-                        ///<      constructor can take a pointer to that parent object.
-    jint byteSize,      ///< [IN] The size in bytes of the value in question.
-    jstring valuePtr    ///< [IN] The value itself.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    // Look up the class info, and find it's constructor.
-    jclass classPtr = (*envPtr)->FindClass(envPtr, "io/legato/MessageBuffer$LocationValue");
-    if (classPtr == NULL)
-    {
-        (*envPtr)->ExceptionDescribe(envPtr);
-        (*envPtr)->ExceptionClear(envPtr);
-        return NULL;
-    }
-
-    jmethodID constructorPtr =
-                          (*envPtr)->GetMethodID(envPtr,
-                                                 classPtr,
-                                                 "<init>",
-                                                 "(Lio/legato/MessageBuffer;ILjava/lang/Object;)V");
-    if (constructorPtr == NULL)
-    {
-        (*envPtr)->ExceptionDescribe(envPtr);
-        (*envPtr)->ExceptionClear(envPtr);
-        return NULL;
-    }
-
-    // Now construct the new object, and call the constructor we picked out.
-    return (*envPtr)->NewObject(envPtr, classPtr, constructorPtr, parentPtr, byteSize, valuePtr);
-}
-
-
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  *  Init the C layer of the of the Legato interface.
@@ -1387,454 +1344,26 @@ JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageFd
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean value from the message.
- *
- *  @return A boolean read from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jboolean JNICALL Java_io_legato_LegatoJni_GetMessageBool
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    bool test = *((bool*)&msgBufferPtr[bufferPosition]);
-
-    if (test)
-    {
-        return JNI_TRUE;
-    }
-
-    return JNI_FALSE;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a boolean value into the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageBool
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jboolean value        ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    *((jshort*)&msgBufferPtr[bufferPosition]) = value == JNI_FALSE ? false : true;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read a single byte from the message.
- *
- *  @return The byte read from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jbyte JNICALL Java_io_legato_LegatoJni_GetMessageByte
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return (jbyte)msgBufferPtr[bufferPosition];
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a byte into the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageByte
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jbyte value           ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    msgBufferPtr[bufferPosition] = (uint8_t)value;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read a two byte short from the message.
- *
- *  @return The short value read from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jshort JNICALL Java_io_legato_LegatoJni_GetMessageShort
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return *((jshort*)&msgBufferPtr[bufferPosition]);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a two byte short into a message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageShort
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jshort value          ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    *((jshort*)&msgBufferPtr[bufferPosition]) = value;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read a 4 byte integer from the message.
- *
- *  @return An integer read from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jint JNICALL Java_io_legato_LegatoJni_GetMessageInt
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return *((jint*)&msgBufferPtr[bufferPosition]);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a 4 byte integer into the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageInt
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jint value            ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    *((jint*)&msgBufferPtr[bufferPosition]) = value;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read an 8 byte long from the message.
+ *  Map the message's payload memory into a direct byte buffer, so that Java packs and unpacks the
+ *  whole message without crossing into native code for each value.
  *
- *  @return The long value read from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jlong JNICALL Java_io_legato_LegatoJni_GetMessageLong
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return *((jlong*)&msgBufferPtr[bufferPosition]);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write an 8 byte long value into a message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageLong
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jlong value           ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    *((jlong*)&msgBufferPtr[bufferPosition]) = value;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read an 8 byte floating point value from the message.
+ *  @note The byte buffer is only valid until the message is released.
  *
- *  @return The double value read from the message.
+ *  @return A java.nio.ByteBuffer covering the whole payload, or NULL if JNI direct buffer access is
+ *          not supported.
  */
 //--------------------------------------------------------------------------------------------------
-JNIEXPORT jdouble JNICALL Java_io_legato_LegatoJni_GetMessageDouble
+JNIEXPORT jobject JNICALL Java_io_legato_LegatoJni_GetPayloadBuffer
 (
     JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
     jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return *((jdouble*)&msgBufferPtr[bufferPosition]);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write an 8 byte double into a message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageDouble
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jdouble value         ///< [IN] The value to write.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    *((jdouble*)&msgBufferPtr[bufferPosition]) = value;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read a string from the message.  Return a string and the number of bytes actually read.
- *
- *  @return An io.legato.MessageBuffer.LocationValue that holds the string and number of bytes read
- *          from the message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jobject JNICALL Java_io_legato_LegatoJni_GetMessageString
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The Java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    char* msgBufferPtr = (char*)le_msg_GetPayloadPtr(nRef) + bufferPosition;
-
-    uint32_t strSize;
-    const uint32_t sizeOfStrSize = sizeof(strSize);
-
-    memcpy(&strSize, msgBufferPtr, sizeOfStrSize);
-    msgBufferPtr += sizeOfStrSize;
-
-    jstring newStr;
-
-    if (strSize > 0)
-    {
-        // TODO: Check for realistic size.
-        char* charBuffer = malloc(strSize + 1);
-        if (!charBuffer)
-        {
-           return 0;
-        }
-
-        memcpy(charBuffer, msgBufferPtr, strSize);
-        charBuffer[strSize] = 0;
-
-        newStr = (*envPtr)->NewStringUTF(envPtr, charBuffer);
-
-        free(charBuffer);
-    }
-    else
-    {
-        newStr = (*envPtr)->NewStringUTF(envPtr, "");
-    }
-
-    return NewLocationValue(envPtr,
-                            NULL,
-                            strSize + sizeOfStrSize,
-                            newStr);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a string value into a message.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jint JNICALL Java_io_legato_LegatoJni_SetMessageString
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jstring value,        ///< [IN] The value to write.
-    jint maxByteSize      ///< [IN] The maximum string size to write to the buffer.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    const char* rawStrPtr = (*envPtr)->GetStringUTFChars(envPtr, value, NULL);
-
-    if (rawStrPtr == NULL)
-    {
-        return 0;
-    }
-
-    msgBufferPtr += bufferPosition;
-
-    uint32_t strSize = strlen(rawStrPtr);
-    const uint32_t sizeOfStrSize = sizeof(strSize);
-
-    // Always pack the string size first, and then the string itself.
-    memcpy(msgBufferPtr, &strSize, sizeOfStrSize);
-    msgBufferPtr += sizeOfStrSize;
-
-    memcpy(msgBufferPtr, rawStrPtr, strSize);
-
-    return sizeOfStrSize + strSize;
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Read a reference value from the message.
- *
- *  @note References are system dependent, (either 32 or 64 bits.)  However Java is system agnostic,
- *        so we always convert a reference into a long, but we only use the appropriate amount of
- *        bytes from the buffer.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT jlong JNICALL Java_io_legato_LegatoJni_GetMessageLongRef
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition   ///< [IN] Where in the message buffer to read the value from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
-
-    return *((intptr_t*)&msgBufferPtr[bufferPosition]);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Write a Legato reference to a message.
- *
- *  @note References are system dependent, (either 32 or 64 bits.)  However Java is system agnostic,
- *        so we always read a reference from a long, but we only use the appropriate amount of bytes
- *        from the buffer.
- */
-//--------------------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_io_legato_LegatoJni_SetMessageLongRef
-(
-    JNIEnv* envPtr,       ///< [IN] The Java environment to work out of.
-    jclass callClassPtr,  ///< [IN] The java class that called this function.
-    jlong messageRef,     ///< [IN] Reference to the message.
-    jint bufferPosition,  ///< [IN] Where in the message buffer to read the value from.
-    jlong value           ///< [IN] The value to write.
+    jlong messageRef      ///< [IN] Reference to the message.
 )
 //--------------------------------------------------------------------------------------------------
 {
     le_msg_MessageRef_t nRef = (le_msg_MessageRef_t)(intptr_t)messageRef;
-    uint8_t* msgBufferPtr = (uint8_t*)le_msg_GetPayloadPtr(nRef);
 
-    *((intptr_t*)&msgBufferPtr[bufferPosition]) = value;
+    return (*envPtr)->NewDirectByteBuffer(envPtr,
+                                          le_msg_GetPayloadPtr(nRef),
+                                          (jlong)le_msg_GetMaxPayloadSize(nRef));
 }
@@ -0,0 +1,884 @@
+//--------------------------------------------------------------------------------------------------
+/** @file array.c
+ *
+ * Implementation of the @ref c_array.
+ *
+ * All the containers keep their elements in a block allocated from a slab allocator.  When a
+ * container is full, its elements are moved to a block twice the size and the old block is
+ * released.  The capacity of a container is whatever fits in the block it got, which is the full
+ * size of the slab allocator's size class, not just the size that was asked for.
+ *
+ * Heaps and array maps are vectors kept in a particular order.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest number of elements to allocate storage for.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_CAPACITY    4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates storage for at least a given number of elements.
+ *
+ * @return Pointer to the storage.  *capacityPtr is set to the number of elements it can hold.
+ *
+ * @note The process exits if the storage would be larger than the slab allocator's maximum object
+ *       size.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* AllocStorage
+(
+    le_mem_SlabRef_t    slab,           ///< [IN] Slab allocator.
+    size_t              elemSize,       ///< [IN] Size of an element.
+    size_t              minCapacity,    ///< [IN] Number of elements needed.
+    size_t*             capacityPtr     ///< [OUT] Number of elements the storage can hold.
+)
+{
+    LE_FATAL_IF(minCapacity > SIZE_MAX / elemSize,
+                "Array of %zu elements of %zu bytes is too large.",
+                minCapacity,
+                elemSize);
+
+    size_t numBytes = minCapacity * elemSize;
+    uint8_t* storagePtr = le_mem_ForceSlabAlloc(slab, numBytes);
+
+    *capacityPtr = le_mem_GetObjectSize(le_mem_GetSlabPool(slab, numBytes)) / elemSize;
+
+    return storagePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Works out how many elements to grow a container to so it can hold at least a given number.
+ *
+ * @return The new capacity.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GrownCapacity
+(
+    size_t  capacity,       ///< [IN] Current capacity.
+    size_t  minCapacity     ///< [IN] Number of elements needed.
+)
+{
+    size_t newCapacity = (capacity < MIN_CAPACITY) ? MIN_CAPACITY : capacity;
+
+    while ((newCapacity < minCapacity) && (newCapacity <= SIZE_MAX / 2))
+    {
+        newCapacity *= 2;
+    }
+
+    return (newCapacity < minCapacity) ? minCapacity : newCapacity;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure a vector has room for at least a given number of elements, doubling its storage as
+ * many times as needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowVector
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              minCapacity ///< [IN] Number of elements needed.
+)
+{
+    if (minCapacity <= vecPtr->capacity)
+    {
+        return;
+    }
+
+    size_t capacity;
+    uint8_t* newElemsPtr = AllocStorage(vecPtr->slab,
+                                        vecPtr->elemSize,
+                                        GrownCapacity(vecPtr->capacity, minCapacity),
+                                        &capacity);
+
+    if (vecPtr->elemsPtr != NULL)
+    {
+        memcpy(newElemsPtr, vecPtr->elemsPtr, vecPtr->numElems * vecPtr->elemSize);
+        le_mem_Release(vecPtr->elemsPtr);
+    }
+
+    vecPtr->elemsPtr = newElemsPtr;
+    vecPtr->capacity = capacity;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty vector.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Init
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator to allocate the storage from.
+    size_t              elemSize    ///< [IN] Size of an element, in bytes.
+)
+{
+    LE_ASSERT(vecPtr != NULL);
+    LE_ASSERT(slab != NULL);
+    LE_ASSERT(elemSize > 0);
+
+    vecPtr->slab = slab;
+    vecPtr->elemsPtr = NULL;
+    vecPtr->elemSize = elemSize;
+    vecPtr->numElems = 0;
+    vecPtr->capacity = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure a vector can hold at least a given number of elements without growing.
+ *
+ * @note The process exits if the storage would be larger than the slab allocator's maximum object
+ *       size.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Reserve
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              numElems    ///< [IN] Number of elements.
+)
+{
+    GrowVector(vecPtr, numElems);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a zero-filled element at the end of a vector.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the vector can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_vec_Append
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+)
+{
+    return le_vec_Insert(vecPtr, vecPtr->numElems);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inserts a zero-filled element in a vector, moving the elements at and after the index up by one.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the index is greater than the number of elements, or if the vector
+ *       can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_vec_Insert
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              index       ///< [IN] Index of the new element.
+)
+{
+    LE_ASSERT(index <= vecPtr->numElems);
+
+    GrowVector(vecPtr, vecPtr->numElems + 1);
+
+    uint8_t* elemPtr = vecPtr->elemsPtr + (index * vecPtr->elemSize);
+
+    memmove(elemPtr + vecPtr->elemSize,
+            elemPtr,
+            (vecPtr->numElems - index) * vecPtr->elemSize);
+    memset(elemPtr, 0, vecPtr->elemSize);
+
+    vecPtr->numElems++;
+
+    return elemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes an element from a vector, moving the elements after it down by one.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Remove
+(
+    le_vec_Vector_t*    vecPtr,     ///< [IN] The vector.
+    size_t              index       ///< [IN] Index of the element.
+)
+{
+    LE_ASSERT(index < vecPtr->numElems);
+
+    uint8_t* elemPtr = vecPtr->elemsPtr + (index * vecPtr->elemSize);
+
+    vecPtr->numElems--;
+
+    memmove(elemPtr,
+            elemPtr + vecPtr->elemSize,
+            (vecPtr->numElems - index) * vecPtr->elemSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a vector, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Clear
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+)
+{
+    vecPtr->numElems = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a vector and releases its storage.  The vector can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_vec_Free
+(
+    le_vec_Vector_t*    vecPtr      ///< [IN] The vector.
+)
+{
+    if (vecPtr->elemsPtr != NULL)
+    {
+        le_mem_Release(vecPtr->elemsPtr);
+    }
+
+    vecPtr->elemsPtr = NULL;
+    vecPtr->numElems = 0;
+    vecPtr->capacity = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the address in a ring buffer's storage of the element at a given index from the front.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t* RingElem
+(
+    const le_ring_Buffer_t* ringPtr,    ///< [IN] The ring buffer.
+    size_t                  index       ///< [IN] Index of the element from the front.
+)
+{
+    size_t slot = ringPtr->head + index;
+
+    if (slot >= ringPtr->capacity)
+    {
+        slot -= ringPtr->capacity;
+    }
+
+    return ringPtr->elemsPtr + (slot * ringPtr->elemSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty ring buffer.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Init
+(
+    le_ring_Buffer_t*   ringPtr,    ///< [IN] The ring buffer.
+    le_mem_SlabRef_t    slab,       ///< [IN] Slab allocator to allocate the storage from.
+    size_t              elemSize    ///< [IN] Size of an element, in bytes.
+)
+{
+    LE_ASSERT(ringPtr != NULL);
+    LE_ASSERT(slab != NULL);
+    LE_ASSERT(elemSize > 0);
+
+    ringPtr->slab = slab;
+    ringPtr->elemsPtr = NULL;
+    ringPtr->elemSize = elemSize;
+    ringPtr->head = 0;
+    ringPtr->numElems = 0;
+    ringPtr->capacity = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a zero-filled element at the back of a ring buffer.
+ *
+ * @return Pointer to the new element.
+ *
+ * @note The process exits if the ring buffer can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_PushBack
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+)
+{
+    if (ringPtr->numElems == ringPtr->capacity)
+    {
+        size_t capacity;
+        uint8_t* newElemsPtr = AllocStorage(ringPtr->slab,
+                                            ringPtr->elemSize,
+                                            GrownCapacity(ringPtr->capacity,
+                                                          ringPtr->numElems + 1),
+                                            &capacity);
+
+        if (ringPtr->elemsPtr != NULL)
+        {
+            // Straighten out the elements, so the front element is at the start of the new storage.
+            size_t firstPart = ringPtr->capacity - ringPtr->head;
+            if (firstPart > ringPtr->numElems)
+            {
+                firstPart = ringPtr->numElems;
+            }
+
+            memcpy(newElemsPtr,
+                   ringPtr->elemsPtr + (ringPtr->head * ringPtr->elemSize),
+                   firstPart * ringPtr->elemSize);
+            memcpy(newElemsPtr + (firstPart * ringPtr->elemSize),
+                   ringPtr->elemsPtr,
+                   (ringPtr->numElems - firstPart) * ringPtr->elemSize);
+
+            le_mem_Release(ringPtr->elemsPtr);
+        }
+
+        ringPtr->elemsPtr = newElemsPtr;
+        ringPtr->capacity = capacity;
+        ringPtr->head = 0;
+    }
+
+    uint8_t* elemPtr = RingElem(ringPtr, ringPtr->numElems);
+
+    memset(elemPtr, 0, ringPtr->elemSize);
+    ringPtr->numElems++;
+
+    return elemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element at the front of a ring buffer.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if the ring buffer was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_ring_PopFront
+(
+    le_ring_Buffer_t*   ringPtr,    ///< [IN] The ring buffer.
+    void*               destPtr     ///< [OUT] Where to copy the element, or NULL to discard it.
+)
+{
+    if (ringPtr->numElems == 0)
+    {
+        return false;
+    }
+
+    if (destPtr != NULL)
+    {
+        memcpy(destPtr, RingElem(ringPtr, 0), ringPtr->elemSize);
+    }
+
+    ringPtr->head++;
+    if (ringPtr->head == ringPtr->capacity)
+    {
+        ringPtr->head = 0;
+    }
+    ringPtr->numElems--;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an element of a ring buffer.  Index 0 is the front element.
+ *
+ * @return Pointer to the element, valid until the ring buffer is next modified.
+ *
+ * @note The process exits if there is no element at the index.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_Get
+(
+    const le_ring_Buffer_t* ringPtr,    ///< [IN] The ring buffer.
+    size_t                  index       ///< [IN] Index of the element.
+)
+{
+    LE_ASSERT(index < ringPtr->numElems);
+
+    return RingElem(ringPtr, index);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the front element of a ring buffer without removing it.
+ *
+ * @return Pointer to the element, or NULL if the ring buffer is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_ring_PeekFront
+(
+    const le_ring_Buffer_t* ringPtr     ///< [IN] The ring buffer.
+)
+{
+    if (ringPtr->numElems == 0)
+    {
+        return NULL;
+    }
+
+    return RingElem(ringPtr, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a ring buffer, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Clear
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+)
+{
+    ringPtr->head = 0;
+    ringPtr->numElems = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a ring buffer and releases its storage.  The ring buffer can be
+ * used again afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_ring_Free
+(
+    le_ring_Buffer_t*   ringPtr     ///< [IN] The ring buffer.
+)
+{
+    if (ringPtr->elemsPtr != NULL)
+    {
+        le_mem_Release(ringPtr->elemsPtr);
+    }
+
+    ringPtr->elemsPtr = NULL;
+    ringPtr->head = 0;
+    ringPtr->numElems = 0;
+    ringPtr->capacity = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Swaps two elements of the same size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SwapElems
+(
+    uint8_t*    aPtr,       ///< [IN] First element.
+    uint8_t*    bPtr,       ///< [IN] Second element.
+    size_t      elemSize    ///< [IN] Size of an element.
+)
+{
+    uint8_t buffer[64];
+
+    while (elemSize > 0)
+    {
+        size_t chunkSize = (elemSize < sizeof(buffer)) ? elemSize : sizeof(buffer);
+
+        memcpy(buffer, aPtr, chunkSize);
+        memcpy(aPtr, bPtr, chunkSize);
+        memcpy(bPtr, buffer, chunkSize);
+
+        aPtr += chunkSize;
+        bPtr += chunkSize;
+        elemSize -= chunkSize;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty heap.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Init
+(
+    le_heap_Heap_t*         heapPtr,        ///< [IN] The heap.
+    le_mem_SlabRef_t        slab,           ///< [IN] Slab allocator to allocate the storage from.
+    size_t                  elemSize,       ///< [IN] Size of an element, in bytes.
+    le_heap_CompareFunc_t   compareFunc     ///< [IN] Function that orders the elements.
+)
+{
+    LE_ASSERT(heapPtr != NULL);
+    LE_ASSERT(compareFunc != NULL);
+
+    le_vec_Init(&heapPtr->vec, slab, elemSize);
+    heapPtr->compareFunc = compareFunc;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a copy of an element to a heap.
+ *
+ * @note The process exits if the heap can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Push
+(
+    le_heap_Heap_t*     heapPtr,    ///< [IN] The heap.
+    const void*         elemPtr     ///< [IN] Element to copy into the heap.
+)
+{
+    size_t elemSize = heapPtr->vec.elemSize;
+    size_t index = heapPtr->vec.numElems;
+
+    memcpy(le_vec_Append(&heapPtr->vec), elemPtr, elemSize);
+
+    // Move the new element up until its parent comes before it.
+    uint8_t* elemsPtr = heapPtr->vec.elemsPtr;
+
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        uint8_t* childPtr = elemsPtr + (index * elemSize);
+        uint8_t* parentPtr = elemsPtr + (parent * elemSize);
+
+        if (heapPtr->compareFunc(childPtr, parentPtr) >= 0)
+        {
+            break;
+        }
+
+        SwapElems(childPtr, parentPtr, elemSize);
+        index = parent;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the element that comes first in a heap without removing it.
+ *
+ * @return Pointer to the element, or NULL if the heap is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_heap_Peek
+(
+    const le_heap_Heap_t*   heapPtr     ///< [IN] The heap.
+)
+{
+    if (heapPtr->vec.numElems == 0)
+    {
+        return NULL;
+    }
+
+    return heapPtr->vec.elemsPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element that comes first in a heap.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if the heap was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_heap_Pop
+(
+    le_heap_Heap_t*     heapPtr,    ///< [IN] The heap.
+    void*               destPtr     ///< [OUT] Where to copy the element, or NULL to discard it.
+)
+{
+    size_t numElems = heapPtr->vec.numElems;
+    size_t elemSize = heapPtr->vec.elemSize;
+    uint8_t* elemsPtr = heapPtr->vec.elemsPtr;
+
+    if (numElems == 0)
+    {
+        return false;
+    }
+
+    if (destPtr != NULL)
+    {
+        memcpy(destPtr, elemsPtr, elemSize);
+    }
+
+    // Move the last element to the top, then down until both its children come after it.
+    numElems--;
+    heapPtr->vec.numElems = numElems;
+
+    if (numElems == 0)
+    {
+        return true;
+    }
+
+    memcpy(elemsPtr, elemsPtr + (numElems * elemSize), elemSize);
+
+    size_t index = 0;
+
+    for (;;)
+    {
+        size_t first = index;
+        size_t left = (2 * index) + 1;
+        size_t right = left + 1;
+
+        if ((left < numElems)
+            && (heapPtr->compareFunc(elemsPtr + (left * elemSize),
+                                     elemsPtr + (first * elemSize)) < 0))
+        {
+            first = left;
+        }
+
+        if ((right < numElems)
+            && (heapPtr->compareFunc(elemsPtr + (right * elemSize),
+                                     elemsPtr + (first * elemSize)) < 0))
+        {
+            first = right;
+        }
+
+        if (first == index)
+        {
+            break;
+        }
+
+        SwapElems(elemsPtr + (index * elemSize), elemsPtr + (first * elemSize), elemSize);
+        index = first;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a heap, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Clear
+(
+    le_heap_Heap_t*     heapPtr     ///< [IN] The heap.
+)
+{
+    le_vec_Clear(&heapPtr->vec);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from a heap and releases its storage.  The heap can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_heap_Free
+(
+    le_heap_Heap_t*     heapPtr     ///< [IN] The heap.
+)
+{
+    le_vec_Free(&heapPtr->vec);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for a key in an array map by binary search.
+ *
+ * @return
+ *      true if an element with the key was found, in which case *indexPtr is its index.
+ *      false if not, in which case *indexPtr is the index where it belongs.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SearchMap
+(
+    const le_amap_Map_t*    mapPtr,     ///< [IN] The array map.
+    const void*             keyPtr,     ///< [IN] The key.
+    size_t*                 indexPtr    ///< [OUT] Index of the element.
+)
+{
+    size_t low = 0;
+    size_t high = mapPtr->vec.numElems;
+
+    while (low < high)
+    {
+        size_t middle = low + ((high - low) / 2);
+        int result = mapPtr->compareFunc(keyPtr,
+                                         mapPtr->vec.elemsPtr + (middle * mapPtr->vec.elemSize));
+
+        if (result == 0)
+        {
+            *indexPtr = middle;
+            return true;
+        }
+        else if (result < 0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    *indexPtr = low;
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty array map.  No storage is allocated until the first element is added.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Init
+(
+    le_amap_Map_t*          mapPtr,         ///< [IN] The array map.
+    le_mem_SlabRef_t        slab,           ///< [IN] Slab allocator to allocate the storage from.
+    size_t                  elemSize,       ///< [IN] Size of an element, in bytes.
+    le_amap_CompareFunc_t   compareFunc     ///< [IN] Function that compares keys with elements.
+)
+{
+    LE_ASSERT(mapPtr != NULL);
+    LE_ASSERT(compareFunc != NULL);
+
+    le_vec_Init(&mapPtr->vec, slab, elemSize);
+    mapPtr->compareFunc = compareFunc;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the element with a given key in an array map.
+ *
+ * @return Pointer to the element, or NULL if there is none.  The pointer is valid until the map is
+ *         next modified.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_amap_Find
+(
+    const le_amap_Map_t*    mapPtr,     ///< [IN] The array map.
+    const void*             keyPtr      ///< [IN] The key.
+)
+{
+    size_t index;
+
+    if (!SearchMap(mapPtr, keyPtr, &index))
+    {
+        return NULL;
+    }
+
+    return mapPtr->vec.elemsPtr + (index * mapPtr->vec.elemSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the element with a given key in an array map, or inserts a zero-filled element where an
+ * element with that key belongs.  The caller must store the key in a new element.
+ *
+ * @return Pointer to the element, valid until the map is next modified.
+ *
+ * @note The process exits if the map can't grow any more.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_amap_Insert
+(
+    le_amap_Map_t*      mapPtr,     ///< [IN] The array map.
+    const void*         keyPtr,     ///< [IN] The key.
+    bool*               isNewPtr    ///< [OUT] Set to true if the element was inserted, false if it
+                                    ///        was already there.  Can be NULL.
+)
+{
+    size_t index;
+    bool isFound = SearchMap(mapPtr, keyPtr, &index);
+
+    if (isNewPtr != NULL)
+    {
+        *isNewPtr = !isFound;
+    }
+
+    if (isFound)
+    {
+        return mapPtr->vec.elemsPtr + (index * mapPtr->vec.elemSize);
+    }
+
+    return le_vec_Insert(&mapPtr->vec, index);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the element with a given key from an array map.
+ *
+ * @return
+ *      true if an element was removed.
+ *      false if there was no element with that key.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_amap_Remove
+(
+    le_amap_Map_t*      mapPtr,     ///< [IN] The array map.
+    const void*         keyPtr      ///< [IN] The key.
+)
+{
+    size_t index;
+
+    if (!SearchMap(mapPtr, keyPtr, &index))
+    {
+        return false;
+    }
+
+    le_vec_Remove(&mapPtr->vec, index);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from an array map, keeping its storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Clear
+(
+    le_amap_Map_t*      mapPtr      ///< [IN] The array map.
+)
+{
+    le_vec_Clear(&mapPtr->vec);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the elements from an array map and releases its storage.  The map can be used again
+ * afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_amap_Free
+(
+    le_amap_Map_t*      mapPtr      ///< [IN] The array map.
+)
+{
+    le_vec_Free(&mapPtr->vec);
+}
@@ -11,6 +11,11 @@
 
 #include "legato.h"
 
+#if defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * CRC table
@@ -84,6 +89,186 @@ static const unsigned int Crc32Table[256] =
     0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D      /* 0xFC */
 };
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slice-by-8 tables.  SliceTable[0] is Crc32Table, and SliceTable[k][i] is the CRC of byte i
+ * followed by k zero bytes, so that eight input bytes can be folded into the CRC with eight
+ * independent table lookups.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SliceTable[8][256];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function used to compute CRCs over more than a few bytes.  Selected once, when the tables are
+ * built.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t (*Crc32BlockFunc)(const uint8_t* addressPtr, size_t size, uint32_t crc);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Inputs shorter than this are handled by the byte loop.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CRC32_BLOCK_MIN_BYTES   16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes a CRC-32 one byte at a time.
+ *
+ * @return
+ *      - 32-bit CRC
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t Crc32Bytes
+(
+    const uint8_t* addressPtr,  ///< [IN] Input buffer
+    size_t         size,        ///< [IN] Number of bytes to read
+    uint32_t       crc          ///< [IN] Starting CRC seed
+)
+{
+    for (; size > 0 ; size--)
+    {
+        // byte loop
+        crc = (((crc >> 8) & 0x00FFFFFF) ^ Crc32Table[(crc ^ *addressPtr++) & 0x000000FF]);
+    }
+    return crc;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes a CRC-32 eight bytes at a time using the slice-by-8 tables.
+ *
+ * @return
+ *      - 32-bit CRC
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Crc32SliceBy8
+(
+    const uint8_t* addressPtr,  ///< [IN] Input buffer
+    size_t         size,        ///< [IN] Number of bytes to read
+    uint32_t       crc          ///< [IN] Starting CRC seed
+)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Align the input so that the 32-bit loads below are cheap.
+    while ((size > 0) && (((uintptr_t)addressPtr & 0x3) != 0))
+    {
+        crc = (crc >> 8) ^ Crc32Table[(crc ^ *addressPtr++) & 0xFF];
+        size--;
+    }
+
+    for (; size >= 8; size -= 8)
+    {
+        uint32_t one;
+        uint32_t two;
+
+        memcpy(&one, addressPtr, sizeof(one));
+        memcpy(&two, addressPtr + 4, sizeof(two));
+        addressPtr += 8;
+
+        one ^= crc;
+        crc = SliceTable[7][one & 0xFF] ^
+              SliceTable[6][(one >> 8) & 0xFF] ^
+              SliceTable[5][(one >> 16) & 0xFF] ^
+              SliceTable[4][one >> 24] ^
+              SliceTable[3][two & 0xFF] ^
+              SliceTable[2][(two >> 8) & 0xFF] ^
+              SliceTable[1][(two >> 16) & 0xFF] ^
+              SliceTable[0][two >> 24];
+    }
+#endif
+
+    return Crc32Bytes(addressPtr, size, crc);
+}
+
+
+#if defined(__aarch64__)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes a CRC-32 using the ARMv8 CRC32 instructions, which implement the same (reflected
+ * 0xEDB88320) polynomial as the tables.
+ *
+ * @return
+ *      - 32-bit CRC
+ */
+//--------------------------------------------------------------------------------------------------
+__attribute__((target("+crc")))
+static uint32_t Crc32Armv8
+(
+    const uint8_t* addressPtr,  ///< [IN] Input buffer
+    size_t         size,        ///< [IN] Number of bytes to read
+    uint32_t       crc          ///< [IN] Starting CRC seed
+)
+{
+    while ((size > 0) && (((uintptr_t)addressPtr & 0x7) != 0))
+    {
+        crc = __builtin_aarch64_crc32b(crc, *addressPtr++);
+        size--;
+    }
+
+    for (; size >= 8; size -= 8)
+    {
+        uint64_t word;
+
+        memcpy(&word, addressPtr, sizeof(word));
+        addressPtr += 8;
+        crc = __builtin_aarch64_crc32x(crc, word);
+    }
+
+    for (; size > 0; size--)
+    {
+        crc = __builtin_aarch64_crc32b(crc, *addressPtr++);
+    }
+
+    return crc;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the slice-by-8 tables and picks the fastest CRC implementation for this CPU.
+ *
+ * This runs as a constructor rather than from the framework initialization because the host tools
+ * (e.g. the patch tools) compile this file in without the rest of the framework.
+ */
+//--------------------------------------------------------------------------------------------------
+__attribute__((constructor)) static void InitCrc32
+(
+    void
+)
+{
+    int i;
+    int k;
+
+    for (i = 0; i < 256; i++)
+    {
+        SliceTable[0][i] = Crc32Table[i];
+    }
+    for (k = 1; k < 8; k++)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            uint32_t prev = SliceTable[k - 1][i];
+            SliceTable[k][i] = (prev >> 8) ^ Crc32Table[prev & 0xFF];
+        }
+    }
+
+    Crc32BlockFunc = Crc32SliceBy8;
+
+#if defined(__aarch64__) && defined(HWCAP_CRC32)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+    {
+        Crc32BlockFunc = Crc32Armv8;
+    }
+#endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to calculate a CRC-32
@@ -99,10 +284,38 @@ uint32_t le_crc_Crc32
     uint32_t crc        ///< [IN] Starting CRC seed
 )
 {
-    for (; size > 0 ; size--)
+    if ((size < CRC32_BLOCK_MIN_BYTES) || (Crc32BlockFunc == NULL))
     {
-        // byte loop
-        crc = (((crc >> 8) & 0x00FFFFFF) ^ Crc32Table[(crc ^ *addressPtr++) & 0x000000FF]);
+        return Crc32Bytes(addressPtr, size, crc);
+    }
+    return Crc32BlockFunc(addressPtr, size, crc);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to calculate a CRC-32 over a list of buffers, as if they were one
+ * contiguous buffer.
+ *
+ * @return
+ *      - 32-bit CRC
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_crc_Crc32Buffers
+(
+    const le_crc_Buffer_t* buffersPtr,  ///< [IN] Array of buffers
+    size_t                 count,       ///< [IN] Number of buffers in the array
+    uint32_t               crc          ///< [IN] Starting CRC seed
+)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (buffersPtr[i].addressPtr != NULL)
+        {
+            crc = le_crc_Crc32((uint8_t*)buffersPtr[i].addressPtr, buffersPtr[i].size, crc);
+        }
     }
     return crc;
 }
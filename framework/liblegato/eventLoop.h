@@ -12,6 +12,9 @@
 #ifndef LEGATO_SRC_EVENTLOOP_H_INCLUDE_GUARD
 #define LEGATO_SRC_EVENTLOOP_H_INCLUDE_GUARD
 
+#include "limit.h"
+#include "ioUring.h"
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -38,6 +41,66 @@ typedef enum
 event_LoopState_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's Event Queue.
+ *
+ * This is an intrusive, lock-free, multiple-producer, single-consumer queue of Event Report links.
+ * Any thread can add to the tail without taking a lock, but only the thread that owns the queue
+ * removes from the head.  The queue always holds at least one link: when it would otherwise be
+ * empty, the stub link is put back on it as a placeholder.
+ *
+ * @note tailPtr and count are accessed using atomic operations.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t*      tailPtr;            ///< Last link added.  Swapped in by producers.
+    le_sls_Link_t*      headPtr;            ///< Oldest link.  Only used by the owning thread.
+    le_sls_Link_t       stub;               ///< Placeholder link.
+    size_t              count;              ///< Number of Event Reports on the queue.
+}
+event_Queue_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event Loop statistics, kept per thread.
+ *
+ * maxQueueDepth is updated atomically by the threads adding to the queue.  The rest are only
+ * updated by the thread that owns the queue.  These are read by the inspect tool from outside the
+ * process.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t            reportCount;        ///< Number of Event Reports processed.
+    size_t              maxQueueDepth;      ///< Largest number of Event Reports ever queued.
+    le_clk_Time_t       handlerTime;        ///< Total time spent running handlers and queued
+                                            ///< functions.
+    le_clk_Time_t       maxHandlerTime;     ///< Longest time spent in one handler or queued
+                                            ///< function call.
+}
+event_Stats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of a single handler (event handler or FD Monitor handler).
+ *
+ * These are only updated by the thread that runs the handler, and are read by the inspect tool
+ * from outside the process.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t            callCount;          ///< Number of times the handler was called.
+    le_clk_Time_t       totalTime;          ///< Total time spent in the handler.
+    le_clk_Time_t       maxTime;            ///< Longest time spent in one call of the handler.
+}
+event_HandlerStats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event Loop's per-thread record.
@@ -51,20 +114,68 @@ event_LoopState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_sls_List_t       eventQueue;         ///< The thread's event queue.
+    event_Queue_t       eventQueue;         ///< The thread's event queue.
     le_dls_List_t       handlerList;        ///< List of handlers registered with this thread.
     le_dls_List_t       fdMonitorList;      ///< List of FD Monitors created by this thread.
-    int                 epollFd;            ///< epoll(7) file descriptor.
-    int                 eventQueueFd;       ///< eventfd(2) file descriptor for the Event Queue.
+    le_dls_List_t       fdMonitorUpdateList;///< FD Monitors whose epoll(7) flags have changed
+                                            ///< since they were last given to epoll_ctl().
+    int                 epollFd;            ///< epoll(7) file descriptor, or -1 if not created
+                                            ///< yet (see event_GetEpollFd()).
+#ifdef LE_EVENT_LOOP_IO_URING
+    ioUring_Ring_t      ioUring;            ///< Ring used to submit batches of epoll_ctl()
+                                            ///< calls (created when first needed).
+    bool                isIoUringDisabled;  ///< true if the ring couldn't be used.
+#endif
+    int                 eventQueueFd;       ///< eventfd(2) file descriptor for the Event Queue,
+                                            ///< or -1 if not created yet.  Read atomically by
+                                            ///< other threads.
     void*               contextPtr;         ///< Context pointer from last Handler called.
+    le_clk_Time_t       dispatchTime;       ///< Relative time at which the last handler or
+                                            ///< queued function was called.
+    unsigned int        dispatchDepth;      ///< Number of handler calls in progress (more than
+                                            ///< one if a handler runs le_event_ServiceLoop()).
     event_LoopState_t   state;              ///< Current state of the event loop.
     uint64_t            liveEventCount;     ///< Number of events ready for dequeing.  Ensures
                                             ///< balance between queued events and monitored fds
                                             ///< in le_event_ServiceLoop().
+    event_Stats_t       stats;              ///< Statistics for the inspect tool.
 }
 event_PerThreadRec_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler object.
+ *
+ * This stores the registration information for a handler function.  They are allocated from the
+ * Handler Pool and are stored on a thread's Handler List.
+ *
+ * @warning These can be accessed by multiple threads, and are in both the Event List structure
+ *          and the Per-Thread structure.  Great care must be taken to prevent races when accessing
+ *          these objects (use the Mutex).
+ *
+ * @note    The lifecycle of these objects is such that once they have been created, only their
+ *          list links and statistics can be changed, until they are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t           eventLink;  ///< Used to link onto an event's Handler List.
+    le_dls_Link_t           threadLink; ///< Used to link onto a thread's Handler List.
+    event_PerThreadRec_t*   threadRecPtr;///< Ptr to per-thread rec of thread that will run this.
+    struct Event*           eventPtr;   ///< Ptr to the Event obj for the event that this handles.
+    void*                   contextPtr; ///< The context pointer for this handler.
+    void*                   safeRef;    ///< Safe Reference for this object.
+    char                    name[LIMIT_MAX_EVENT_HANDLER_NAME_BYTES];///< UTF-8 name of the handler.
+
+    le_event_LayeredHandlerFunc_t   firstLayerFunc;     ///< First-layer handler function.
+    void*                           secondLayerFunc;    ///< Second-layer handler function.
+
+    event_HandlerStats_t    stats;      ///< Statistics for the inspect tool.
+}
+Handler_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the Event Loop module.
@@ -95,6 +206,23 @@ void event_InitThread
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the epoll(7) file descriptor of a thread's Event Loop.  It is created, along with the Event
+ * Queue's eventfd, the first time the thread needs it, so that threads that never run an Event
+ * Loop or monitor a file descriptor don't hold on to either.
+ *
+ * @warning Must only be called by the thread that owns the per-thread record.
+ *
+ * @return The file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+int event_GetEpollFd
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Defer the component initializer for later execution.
@@ -140,6 +268,46 @@ void event_SetCurrentContextPtr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a handler's statistics after it has been called.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_RecordHandlerCall
+(
+    event_HandlerStats_t* statsPtr,     ///< [in] The handler's statistics.
+    le_clk_Time_t elapsed               ///< [in] Time spent in the call.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time at which the calling thread's Event Loop called the handler or queued
+ * function that is running.
+ *
+ * @return  true if a handler or queued function is running, false if not (timePtr is not set).
+ */
+//--------------------------------------------------------------------------------------------------
+bool event_GetDispatchTime
+(
+    le_clk_Time_t* timePtr              ///< [out] Time at which the handler was called.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the handler list change counter; mainly for the Inspect tool.
+ *
+ * The counter is incremented each time a handler is added to or removed from any thread's Handler
+ * List.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** event_GetHandlerListChgCntRef
+(
+    void
+);
+
+
 
 
 #endif // LEGATO_SRC_EVENTLOOP_H_INCLUDE_GUARD
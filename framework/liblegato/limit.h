@@ -137,6 +137,15 @@
 #define LIMIT_MAX_TIMER_NAME_BYTES              (LIMIT_MAX_TIMER_NAME_LEN + 1)
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum string length and byte storage size of thread pool names.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LIMIT_MAX_THREAD_POOL_NAME_LEN          31
+#define LIMIT_MAX_THREAD_POOL_NAME_BYTES        (LIMIT_MAX_THREAD_POOL_NAME_LEN + 1)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum string length and byte storage size of memory pool names (excluding the component
@@ -0,0 +1,413 @@
+//--------------------------------------------------------------------------------------------------
+/** @file arena.c
+ *
+ * Implementation of the @ref c_arena.
+ *
+ * An arena's chunks are kept on a singly linked list in the order they were taken from the chunk
+ * pool.  Blocks are carved out of the current chunk; when it is full, allocation moves on to the
+ * next chunk on the list, taking a new one from the pool only at the end of the list.  Resetting or
+ * rewinding an arena just moves the current position back, leaving the chunks after it on the list
+ * to be filled again.
+ *
+ * Blocks bigger than a quarter of a chunk's payload would waste too much of the chunks they don't
+ * fit in, so they are allocated from the heap on their own and kept on a separate list, newest
+ * first, to be freed when the arena is reset or rewound past them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "arena.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Union of the types whose alignment arena blocks must meet.  This matches the alignment of the
+ * blocks the chunks are carved from, so that block addresses don't depend on a chunk's address.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef union
+{
+    long long   ll;
+    double      d;
+    void*       p;
+}
+MaxAlign_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Alignment of the blocks handed out by an arena.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALIGNMENT   __alignof__(MaxAlign_t)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rounds a size up to a multiple of the block alignment.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALIGN_UP(size)  (((size) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of every chunk and every block allocated on its own.
+ */
+//--------------------------------------------------------------------------------------------------
+struct le_arena_Chunk
+{
+    le_arena_Chunk_t*   nextPtr;    ///< Next chunk (or the next older block allocated on its own).
+    size_t              size;       ///< Number of bytes after the header.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the chunk header, rounded up so that the payload is aligned.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_BYTES    ALIGN_UP(sizeof(le_arena_Chunk_t))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the start of the payload of a chunk.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PAYLOAD(chunkPtr)   ((uint8_t*)(chunkPtr) + HEADER_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool used by arenas that aren't given a chunk pool of their own.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DefaultChunkPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block on its own from the heap and puts it on the arena's list of such blocks.
+ *
+ * @return Pointer to the block, or NULL if the heap is exhausted and isForced is false.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocLarge
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size,       ///< [IN] Size of the block (already aligned).
+    bool                isForced    ///< [IN] true if the process must exit on failure.
+)
+{
+    le_arena_Chunk_t* blockPtr = NULL;
+
+    if (size <= SIZE_MAX - HEADER_BYTES)
+    {
+        blockPtr = malloc(HEADER_BYTES + size);
+    }
+
+    if (blockPtr == NULL)
+    {
+        LE_FATAL_IF(isForced, "Failed to allocate %zu bytes from arena.", size);
+        return NULL;
+    }
+
+    blockPtr->size = size;
+    blockPtr->nextPtr = arenaPtr->largeBlocksPtr;
+    arenaPtr->largeBlocksPtr = blockPtr;
+
+    return PAYLOAD(blockPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena when it doesn't fit in the rest of the current chunk.
+ *
+ * @return Pointer to the block, or NULL if memory is exhausted and isForced is false.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocSlow
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size,       ///< [IN] Size of the block (already aligned).
+    bool                isForced    ///< [IN] true if the chunk pool must be expanded if exhausted.
+)
+{
+    size_t payloadBytes = le_mem_GetObjectSize(arenaPtr->chunkPool) - HEADER_BYTES;
+
+    if (size > payloadBytes / 4)
+    {
+        return AllocLarge(arenaPtr, size, isForced);
+    }
+
+    // Move on to the next chunk on the list, or take a new one from the pool.
+    le_arena_Chunk_t* chunkPtr = (arenaPtr->currentChunkPtr == NULL) ?
+                                 arenaPtr->firstChunkPtr : arenaPtr->currentChunkPtr->nextPtr;
+
+    if (chunkPtr == NULL)
+    {
+        chunkPtr = isForced ? le_mem_ForceAlloc(arenaPtr->chunkPool)
+                            : le_mem_TryAlloc(arenaPtr->chunkPool);
+        if (chunkPtr == NULL)
+        {
+            return NULL;
+        }
+
+        chunkPtr->nextPtr = NULL;
+        chunkPtr->size = payloadBytes;
+
+        if (arenaPtr->currentChunkPtr == NULL)
+        {
+            arenaPtr->firstChunkPtr = chunkPtr;
+        }
+        else
+        {
+            arenaPtr->currentChunkPtr->nextPtr = chunkPtr;
+        }
+    }
+
+    arenaPtr->currentChunkPtr = chunkPtr;
+    arenaPtr->offset = size;
+
+    return PAYLOAD(chunkPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena.
+ *
+ * @return Pointer to the block, or NULL if memory is exhausted and isForced is false.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void* Alloc
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size,       ///< [IN] Size of the block.
+    bool                isForced    ///< [IN] true if the chunk pool must be expanded if exhausted.
+)
+{
+    LE_ASSERT(arenaPtr != NULL);
+
+    if (size > SIZE_MAX - ALIGNMENT)
+    {
+        LE_FATAL_IF(isForced, "Failed to allocate %zu bytes from arena.", size);
+        return NULL;
+    }
+
+    // Zero-sized blocks still get a unique address.
+    size = (size == 0) ? ALIGNMENT : ALIGN_UP(size);
+
+    le_arena_Chunk_t* chunkPtr = arenaPtr->currentChunkPtr;
+
+    if ((chunkPtr != NULL) && (size <= chunkPtr->size - arenaPtr->offset))
+    {
+        void* blockPtr = PAYLOAD(chunkPtr) + arenaPtr->offset;
+        arenaPtr->offset += size;
+        return blockPtr;
+    }
+
+    return AllocSlow(arenaPtr, size, isForced);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the arena allocator's default chunk pool.  This function is meant to be called from
+ * Legato's internal init.
+ */
+//--------------------------------------------------------------------------------------------------
+void arena_Init
+(
+    void
+)
+{
+    DefaultChunkPool = le_mem_CreatePool("Arena Chunk", LE_ARENA_DEFAULT_CHUNK_BYTES);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an empty arena.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Init
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    le_mem_PoolRef_t    chunkPool   ///< [IN] Pool to take chunks from, or NULL to use the default
+                                    ///       chunk pool.
+)
+{
+    LE_ASSERT(arenaPtr != NULL);
+
+    if (chunkPool == NULL)
+    {
+        chunkPool = DefaultChunkPool;
+    }
+
+    LE_FATAL_IF(le_mem_GetObjectSize(chunkPool) < HEADER_BYTES + (4 * ALIGNMENT),
+                "Arena chunk size %zu is too small.",
+                le_mem_GetObjectSize(chunkPool));
+
+    arenaPtr->chunkPool = chunkPool;
+    arenaPtr->firstChunkPtr = NULL;
+    arenaPtr->currentChunkPtr = NULL;
+    arenaPtr->offset = 0;
+    arenaPtr->largeBlocksPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena.
+ *
+ * @return Pointer to the block, or NULL if the chunk pool is exhausted.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_TryAlloc
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size        ///< [IN] Size of the block, in bytes.
+)
+{
+    return Alloc(arenaPtr, size, false);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a block from an arena, expanding the chunk pool if it is exhausted.
+ *
+ * @return Pointer to the block.
+ *
+ * @note The process exits if the memory can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_arena_ForceAlloc
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    size_t              size        ///< [IN] Size of the block, in bytes.
+)
+{
+    return Alloc(arenaPtr, size, true);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a string into an arena.
+ *
+ * @return Pointer to the copy.
+ *
+ * @note The process exits if the memory can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_arena_StrDup
+(
+    le_arena_Arena_t*   arenaPtr,   ///< [IN] The arena.
+    const char*         strPtr      ///< [IN] String to copy.
+)
+{
+    size_t size = strlen(strPtr) + 1;
+    char* copyPtr = Alloc(arenaPtr, size, true);
+
+    memcpy(copyPtr, strPtr, size);
+
+    return copyPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records how much of an arena is in use, so that it can be rewound to this point with
+ * le_arena_Rewind().
+ *
+ * @return The mark.
+ */
+//--------------------------------------------------------------------------------------------------
+le_arena_Mark_t le_arena_GetMark
+(
+    const le_arena_Arena_t* arenaPtr    ///< [IN] The arena.
+)
+{
+    le_arena_Mark_t mark =
+    {
+        .chunkPtr = arenaPtr->currentChunkPtr,
+        .offset = arenaPtr->offset,
+        .largeBlocksPtr = arenaPtr->largeBlocksPtr
+    };
+
+    return mark;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena since a mark was taken.
+ *
+ * @warning The mark must not be older than the last reset, or than another mark that has already
+ *          been rewound to.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Rewind
+(
+    le_arena_Arena_t*       arenaPtr,   ///< [IN] The arena.
+    const le_arena_Mark_t*  markPtr     ///< [IN] Mark returned by le_arena_GetMark().
+)
+{
+    while (arenaPtr->largeBlocksPtr != markPtr->largeBlocksPtr)
+    {
+        le_arena_Chunk_t* blockPtr = arenaPtr->largeBlocksPtr;
+
+        LE_ASSERT(blockPtr != NULL);
+
+        arenaPtr->largeBlocksPtr = blockPtr->nextPtr;
+        free(blockPtr);
+    }
+
+    arenaPtr->currentChunkPtr = markPtr->chunkPtr;
+    arenaPtr->offset = markPtr->offset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena, keeping its chunks for later allocations.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Reset
+(
+    le_arena_Arena_t*   arenaPtr    ///< [IN] The arena.
+)
+{
+    static const le_arena_Mark_t emptyMark = { NULL, 0, NULL };
+
+    le_arena_Rewind(arenaPtr, &emptyMark);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees everything allocated from an arena and gives its chunks back to the chunk pool.  The arena
+ * can be used again afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_arena_Free
+(
+    le_arena_Arena_t*   arenaPtr    ///< [IN] The arena.
+)
+{
+    le_arena_Reset(arenaPtr);
+
+    while (arenaPtr->firstChunkPtr != NULL)
+    {
+        le_arena_Chunk_t* chunkPtr = arenaPtr->firstChunkPtr;
+
+        arenaPtr->firstChunkPtr = chunkPtr->nextPtr;
+        le_mem_Release(chunkPtr);
+    }
+}
@@ -18,6 +18,12 @@
  * during the re-naming should keep the original file intact. All the aforementioned steps are
  * followed in this API implementation,
  *
+ * Small changes can instead be appended to a journal kept next to the file as records carrying
+ * the offset, the data and a CRC.  Only the record is synced, and a record cut short by a crash
+ * fails its CRC check and is ignored.  The records are applied to the file with the steps above
+ * when the journal grows large (in a background thread), and before the file is opened again, so
+ * that the file seen through this API always includes them.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -51,6 +57,38 @@
 #define LOCK_FILE_TEMP_DIR        "/tmp/"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extension used for journal file
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_FILE_EXTENSION    ".journal~~"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the first field of every journal record ("LJRN")
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_RECORD_MAGIC      0x4E524A4CU
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a journal above which its records are applied to the file in the background
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_COMPACT_THRESHOLD (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer used to check and apply journal records
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_COPY_BUFFER_BYTES 1024
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect shared data structures in this module.
@@ -82,6 +120,24 @@ typedef struct
 FileAccess_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a journal record.  The header is followed by the data to write to the file.
+ *
+ * Records are appended to the journal in native byte order; the journal never leaves the device.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                       ///< JOURNAL_RECORD_MAGIC.
+    uint32_t size;                        ///< Number of data bytes.
+    uint64_t offset;                      ///< Offset in the file to write the data at.
+    uint32_t crc;                         ///< CRC-32 of the header (this field zeroed) and data.
+    uint32_t reserved;                    ///< Zero.
+}
+JournalRecordHeader_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pool to allocate FileAccess_t objects.
@@ -98,6 +154,22 @@ static le_mem_PoolRef_t FileAccessPool;
 static le_dls_List_t FileAccessList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool to allocate the file paths queued to the compaction thread.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t JournalPathPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that applies journals in the background.  Started the first time it is needed.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t CompactionThreadRef = NULL;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -336,7 +408,7 @@ static le_result_t CheckIfRegFileExist
 //--------------------------------------------------------------------------------------------------
 /**
  * Open lock file for the file which will do atomic operation. If there is no lock file, this
- * function will create and open lock file
+ * function will create and open lock file. Journal records left for the file are not applied.
  *
  * @return
  *      A file descriptor for doing atomic operation.
@@ -344,7 +416,7 @@ static le_result_t CheckIfRegFileExist
  *      LE_FAULT if there was an error.
  **/
 //--------------------------------------------------------------------------------------------------
-static int OpenLockFile
+static int AcquireLockFile
 (
     const char* pathNamePtr,             ///< [IN] Path of the file for which lockfile should be open
     le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
@@ -370,157 +442,854 @@ static int OpenLockFile
                                     LE_FLOCK_OPEN_IF_EXIST,
                                     S_IRUSR | S_IWUSR);
     }
-
-    return lockFd;
+
+    return lockFd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates temporary file for doing all intermediate operations. This function is used to create
+ * temporary file when original file exists. File permissions are copied from the original file.
+ *
+ * @return
+ *      A file descriptor for doing atomic operation.
+ *      LE_NOT_FOUND if the file does not exist.
+ *      LE_FAULT if there was an error.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int CreateTempFromOriginal
+(
+    const char* origPathPtr,             ///< [IN] Path to original file.
+    const char* tempPathPtr,             ///< [IN] Path to temporary file.
+    le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
+    bool copy                            ///< [IN] Whether content of original file should be copied
+                                         ///<      to temporary file.
+)
+{
+    // Delete the temporary file if exists.
+    unlink(tempPathPtr);
+
+    // File permission mode in temporary file should be same as original file, so set the
+    // processor umask to 0.
+    mode_t old_mode = umask((mode_t)0);
+    int tempfd;
+
+    if (copy)
+    {
+        // Copy the contents to temporary file.
+        if (file_Copy(origPathPtr, tempPathPtr, NULL) == LE_OK)
+        {
+            // Temp file already exists. So opening should be fine.
+            tempfd = le_flock_Open(tempPathPtr, accessMode);
+        }
+        else
+        {
+            tempfd = LE_FAULT;
+        }
+    }
+    else
+    {
+        // Temp file doesn't exist, so create it with original file permission
+        struct stat fileStatus;
+
+        // Get the original file permission mode and create a temp file with same permission mode.
+        if (stat(origPathPtr, &fileStatus) == 0)
+        {
+            tempfd = le_flock_Create(tempPathPtr,
+                                     accessMode,
+                                     LE_FLOCK_REPLACE_IF_EXIST,
+                                     fileStatus.st_mode);
+        }
+        else
+        {
+            LE_CRIT("Error when trying to stat '%s'. (%m)", origPathPtr);
+            tempfd = LE_FAULT;
+        }
+    }
+
+    umask(old_mode);
+
+    return tempfd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates temporary file stream for doing all intermediate operations. This function is used to
+ * create temporary file when original file exists. File permissions are copied from the original
+ * file.
+ *
+ * If there was an error NULL is returned and resultPtr is set to:
+ *      LE_NOT_FOUND if file doesn't exists.
+ *      LE_FAULT if there was an error.
+ *
+ * @return
+ *      Buffered file stream handle to the file if successful.
+ *      NULL if there was an error.
+ **/
+//--------------------------------------------------------------------------------------------------
+static FILE* CreateTempStreamFromOriginal
+(
+    const char* origPathPtr,             ///< [IN] Path to original file.
+    const char* tempPathPtr,             ///< [IN] Path to temporary file.
+    le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
+    bool copy,                           ///< [IN] Whether content of original file should be copied
+                                         ///<      to temporary file.
+    le_result_t* resultPtr               ///< [OUT] A pointer to result code
+)
+{
+    // Delete the temporary file if exists.
+    unlink(tempPathPtr);
+
+    // File permission mode in temporary file should be same as original file, so set the
+    // processor umask to 0.
+    mode_t old_mode = umask((mode_t)0);
+    FILE* file;
+
+    if (copy)
+    {
+        // Copy the contents to temporary file.
+        if (file_Copy(origPathPtr, tempPathPtr, NULL) == LE_OK)
+        {
+            // Temp file already exists. So opening should be fine.
+            file = le_flock_OpenStream(tempPathPtr, accessMode, resultPtr);
+        }
+        else
+        {
+            if (resultPtr != NULL)
+            {
+                *resultPtr = LE_FAULT;
+            }
+            file = NULL;
+        }
+    }
+    else
+    {
+        // Temp file doesn't exist, so create it with original file permission
+        struct stat fileStatus;
+
+        // Get the original file permission mode and create a temp file with same permission mode.
+        if (stat(origPathPtr, &fileStatus) == 0)
+        {
+            file = le_flock_CreateStream(tempPathPtr,
+                                         accessMode,
+                                         LE_FLOCK_REPLACE_IF_EXIST,
+                                         fileStatus.st_mode,
+                                         resultPtr);
+        }
+        else
+        {
+            LE_CRIT("Error when trying to stat '%s'. (%m)", origPathPtr);
+
+            if (resultPtr != NULL)
+            {
+                *resultPtr = LE_FAULT;
+            }
+            file = NULL;
+        }
+    }
+
+    umask(old_mode);
+
+    return file;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sync the directory containing a file to disk
+ *
+ * @return
+ *      LE_OK if successful
+ *      LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncDir
+(
+    const char* filePath                ///< [IN] Path to a file in the directory.
+)
+{
+     char dirName[PATH_MAX];
+
+     // Get containing directory
+     LE_ASSERT_OK(le_path_GetDir(filePath, "/", dirName, sizeof(dirName)));
+
+     // le_path_GetDir returns file name when no path is specified.
+     if (!le_dir_IsDir(dirName))
+     {
+         dirName[0] = '.';
+         dirName[1] = 0;
+     }
+
+     int dirFd;
+     do
+     {
+         // Directory can be opened with read-only flag
+         dirFd = open(dirName, O_RDONLY);
+     }
+     while ( (dirFd == -1) && (errno == EINTR) );
+
+     if (dirFd == -1)
+     {
+         LE_CRIT("Failed to open directory '%s' (%m).", dirName);
+         return LE_FAULT;
+     }
+
+     // Now do a sync on directory
+     if (fsync(dirFd) == -1)
+     {
+         LE_CRIT("Failed to do fsync on directory: '%s' (%m).", dirName);
+         fd_Close(dirFd);
+         return LE_FAULT;
+     }
+
+     fd_Close(dirFd);
+
+     return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sync files to disk
+ *
+ * @return
+ *      LE_OK if successful
+ *      LE_FAULT if failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncFile
+(
+    FileAccess_t* accessPtr,            ///< [IN] Object containing files to be Sync-ed
+    const char* tempFilePath            ///< [IN] Path to temporary file.
+)
+{
+    // Do a fsync to ensure write to temporary file goes to storage device.
+     if (fsync(accessPtr->tempFd) == -1)
+     {
+         LE_CRIT("Failed to do fsync on file '%s' (%m).", tempFilePath);
+         return LE_FAULT;
+     }
+
+     if (SyncDir(accessPtr->filePath) != LE_OK)
+     {
+         return LE_FAULT;
+     }
+
+     if (rename(tempFilePath, accessPtr->filePath))
+     {
+         LE_CRIT("Failed rename '%s' to '%s' (%m).", tempFilePath, accessPtr->filePath);
+         return LE_FAULT;
+     }
+
+     return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads up to a given number of bytes from a file at a given offset, retrying on interruption.
+ *
+ * @return
+ *      Number of bytes read (less than requested at the end of the file), or -1 on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadAt
+(
+    int fd,                 ///< [IN] File to read from.
+    void* bufPtr,           ///< [OUT] Buffer to read into.
+    size_t size,            ///< [IN] Number of bytes to read.
+    off_t offset            ///< [IN] Offset to read from.
+)
+{
+    size_t readLen = 0;
+
+    while (readLen < size)
+    {
+        ssize_t rc = pread(fd, (uint8_t*)bufPtr + readLen, size - readLen, offset + readLen);
+
+        if (rc > 0)
+        {
+            readLen += rc;
+        }
+        else if (rc == 0)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+
+    return readLen;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a number of bytes to a file at a given offset, retrying on interruption and short writes.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAt
+(
+    int fd,                 ///< [IN] File to write to.
+    const void* bufPtr,     ///< [IN] Data to write.
+    size_t size,            ///< [IN] Number of bytes to write.
+    off_t offset            ///< [IN] Offset to write at.
+)
+{
+    size_t writtenLen = 0;
+
+    while (writtenLen < size)
+    {
+        ssize_t rc = pwrite(fd, (const uint8_t*)bufPtr + writtenLen, size - writtenLen,
+                            offset + writtenLen);
+
+        if (rc > 0)
+        {
+            writtenLen += rc;
+        }
+        else if ((rc == 0) || (errno != EINTR))
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the CRC of a journal record.  The CRC covers the header, with its crc field zeroed,
+ * and the data.
+ *
+ * @return
+ *      The CRC.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeRecordCrc
+(
+    const JournalRecordHeader_t* headerPtr,     ///< [IN] Record header.
+    const void* dataPtr,                        ///< [IN] The first dataSize bytes of record data.
+    size_t dataSize,                            ///< [IN] Number of data bytes.
+    uint32_t crc                                ///< [IN] CRC of the preceding bytes, if continuing.
+)
+{
+    if (headerPtr != NULL)
+    {
+        JournalRecordHeader_t header = *headerPtr;
+
+        header.crc = 0;
+        crc = le_crc_Crc32((uint8_t*)&header, sizeof(header), LE_CRC_START_CRC32);
+    }
+
+    return le_crc_Crc32((uint8_t*)dataPtr, dataSize, crc);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Walks the records of a journal, checking their CRCs, and optionally writes the data of the
+ * valid ones to a file.  The walk stops at the first record that is incomplete or corrupted,
+ * which is what is left of an append cut short by a crash.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WalkJournal
+(
+    int journalFd,          ///< [IN] Journal file.
+    off_t validEnd,         ///< [IN] Offset to stop at, or -1 to walk the whole journal.
+    int targetFd,           ///< [IN] File to apply the records to, or -1 to only check them.
+    off_t* validEndPtr,     ///< [OUT] Offset just after the last valid record (can be NULL).
+    uint64_t* dataEndPtr    ///< [OUT] Largest offset written by a valid record (can be NULL).
+)
+{
+    uint8_t buffer[JOURNAL_COPY_BUFFER_BYTES];
+    off_t recordOffset = 0;
+    uint64_t dataEnd = 0;
+
+    while ((validEnd < 0) || (recordOffset < validEnd))
+    {
+        JournalRecordHeader_t header;
+        ssize_t readLen = ReadAt(journalFd, &header, sizeof(header), recordOffset);
+
+        if (readLen < 0)
+        {
+            LE_CRIT("Failed to read journal (%m).");
+            return LE_FAULT;
+        }
+        if ((readLen != sizeof(header)) || (header.magic != JOURNAL_RECORD_MAGIC))
+        {
+            break;
+        }
+
+        // Check the whole record before applying any of it.
+        off_t dataOffset = recordOffset + sizeof(header);
+        uint32_t crc = ComputeRecordCrc(&header, NULL, 0, 0);
+        uint32_t pos;
+
+        for (pos = 0; pos < header.size; pos += readLen)
+        {
+            size_t chunkLen = header.size - pos;
+
+            if (chunkLen > sizeof(buffer))
+            {
+                chunkLen = sizeof(buffer);
+            }
+
+            readLen = ReadAt(journalFd, buffer, chunkLen, dataOffset + pos);
+            if (readLen < 0)
+            {
+                LE_CRIT("Failed to read journal (%m).");
+                return LE_FAULT;
+            }
+            if ((size_t)readLen != chunkLen)
+            {
+                break;
+            }
+            crc = ComputeRecordCrc(NULL, buffer, chunkLen, crc);
+        }
+        if ((pos != header.size) || (crc != header.crc))
+        {
+            break;
+        }
+
+        if (targetFd >= 0)
+        {
+            for (pos = 0; pos < header.size; pos += readLen)
+            {
+                size_t chunkLen = header.size - pos;
+
+            if (chunkLen > sizeof(buffer))
+            {
+                chunkLen = sizeof(buffer);
+            }
+
+                readLen = ReadAt(journalFd, buffer, chunkLen, dataOffset + pos);
+                if (((size_t)readLen != chunkLen) ||
+                    (WriteAt(targetFd, buffer, chunkLen, header.offset + pos) != LE_OK))
+                {
+                    LE_CRIT("Failed to apply journal record (%m).");
+                    return LE_FAULT;
+                }
+            }
+        }
+
+        if (header.offset + header.size > dataEnd)
+        {
+            dataEnd = header.offset + header.size;
+        }
+        recordOffset = dataOffset + header.size;
+    }
+
+    if (validEndPtr != NULL)
+    {
+        *validEndPtr = recordOffset;
+    }
+    if (dataEndPtr != NULL)
+    {
+        *dataEndPtr = dataEnd;
+    }
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a file has journal records waiting to be applied to it.
+ *
+ * @return
+ *      true if there is a non-empty journal for the file.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasJournal
+(
+    const char* pathNamePtr             ///< [IN] Path of the file.
+)
+{
+    char journalPath[PATH_MAX];
+    struct stat journalStatus;
+
+    GetFilePath(pathNamePtr, JOURNAL_FILE_EXTENSION, journalPath, sizeof(journalPath));
+
+    return (stat(journalPath, &journalStatus) == 0) && (journalStatus.st_size > 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies the journal records of a file to it and deletes the journal.  The file is rewritten
+ * atomically, like when committing a file opened for writing.
+ *
+ * Replaying a record writes the same bytes at the same offset, so a crash after the file is
+ * replaced but before the journal is deleted only leads to the records being applied again.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_WOULD_BLOCK if there is already an incompatible lock on the file.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CompactJournal
+(
+    const char* pathNamePtr,            ///< [IN] Path of the file.
+    bool blocking                       ///< [IN] true if blocking, false if non-blocking.
+)
+{
+    char journalPath[PATH_MAX];
+    GetFilePath(pathNamePtr, JOURNAL_FILE_EXTENSION, journalPath, sizeof(journalPath));
+
+    int lockFd = AcquireLockFile(pathNamePtr, LE_FLOCK_WRITE, blocking);
+
+    if (lockFd < 0)
+    {
+        return lockFd;
+    }
+
+    le_result_t result = LE_OK;
+    int journalFd;
+
+    do
+    {
+        journalFd = open(journalPath, O_RDONLY | O_CLOEXEC);
+    }
+    while ((journalFd == -1) && (errno == EINTR));
+
+    if (journalFd == -1)
+    {
+        // Someone else compacted it first.
+        le_flock_Close(lockFd);
+        return (errno == ENOENT) ? LE_OK : LE_FAULT;
+    }
+
+    off_t validEnd;
+
+    if (WalkJournal(journalFd, -1, -1, &validEnd, NULL) != LE_OK)
+    {
+        result = LE_FAULT;
+    }
+    else if (validEnd > 0)
+    {
+        int fd = blocking ? le_flock_Open(pathNamePtr, LE_FLOCK_WRITE) :
+                            le_flock_TryOpen(pathNamePtr, LE_FLOCK_WRITE);
+
+        if (fd < 0)
+        {
+            result = (fd == LE_WOULD_BLOCK) ? LE_WOULD_BLOCK : LE_FAULT;
+        }
+        else
+        {
+            FileAccess_t access;
+            char tempFilePath[PATH_MAX];
+
+            GetFilePath(pathNamePtr, TEMP_FILE_EXTENSION, tempFilePath, sizeof(tempFilePath));
+            LE_ASSERT_OK(le_utf8_Copy(access.filePath, pathNamePtr, sizeof(access.filePath), NULL));
+            access.tempFd = CreateTempFromOriginal(pathNamePtr,
+                                                   tempFilePath,
+                                                   LE_FLOCK_READ_AND_WRITE,
+                                                   true);
+
+            if (access.tempFd < 0)
+            {
+                result = LE_FAULT;
+            }
+            else
+            {
+                result = WalkJournal(journalFd, validEnd, access.tempFd, NULL, NULL);
+
+                if (result == LE_OK)
+                {
+                    result = SyncFile(&access, tempFilePath);
+                }
+                else
+                {
+                    DeleteFile(tempFilePath);
+                }
+                le_flock_Close(access.tempFd);
+            }
+
+            le_flock_Close(fd);
+        }
+    }
+
+    fd_Close(journalFd);
+
+    if (result == LE_OK)
+    {
+        result = DeleteFile(journalPath);
+    }
+
+    le_flock_Close(lockFd);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies a file's journal in the compaction thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactInBackground
+(
+    void* pathNamePtr,                  ///< [IN] Path of the file (from the JournalPathPool).
+    void* unusedPtr
+)
+{
+    if (CompactJournal(pathNamePtr, true) != LE_OK)
+    {
+        LE_WARN("Failed to compact journal of '%s'.", (char*)pathNamePtr);
+    }
+
+    le_mem_Release(pathNamePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the compaction thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompactionThreadMain
+(
+    void* readySemPtr                   ///< [IN] Semaphore to post once the thread is ready.
+)
+{
+    le_sem_Post(readySemPtr);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queues a file's journal to be compacted by the compaction thread, starting the thread if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueCompaction
+(
+    const char* pathNamePtr             ///< [IN] Path of the file.
+)
+{
+    LOCK
+
+    if (CompactionThreadRef == NULL)
+    {
+        le_sem_Ref_t readySemRef = le_sem_Create("atomFileCompactReady", 0);
+
+        CompactionThreadRef = le_thread_Create("atomFileCompact",
+                                               CompactionThreadMain,
+                                               readySemRef);
+        le_thread_Start(CompactionThreadRef);
+
+        le_sem_Wait(readySemRef);
+        le_sem_Delete(readySemRef);
+    }
+
+    UNLOCK
+
+    char* pathCopyPtr = le_mem_ForceAlloc(JournalPathPool);
+
+    LE_ASSERT_OK(le_utf8_Copy(pathCopyPtr, pathNamePtr, PATH_MAX, NULL));
+    le_event_QueueFunctionToThread(CompactionThreadRef, CompactInBackground, pathCopyPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open and lock the lock file for the file which will do atomic operation, after applying any
+ * journal records left for the file, so that it is seen with all its committed changes.
+ *
+ * @return
+ *      A file descriptor for doing atomic operation.
+ *      LE_WOULD_BLOCK if there is already an incompatible lock on the file.
+ *      LE_FAULT if there was an error.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int OpenLockFile
+(
+    const char* pathNamePtr,             ///< [IN] Path of the file for which lockfile should be open
+    le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
+    bool blocking                        ///< [IN] true if blocking, false if non-blocking.
+)
+{
+    for (;;)
+    {
+        int lockFd = AcquireLockFile(pathNamePtr, accessMode, blocking);
+
+        // Journal records are only checked for with the lock held, so none can be appended
+        // between the check and the file being opened.
+        if ((lockFd < 0) || !HasJournal(pathNamePtr))
+        {
+            return lockFd;
+        }
+
+        le_flock_Close(lockFd);
+
+        le_result_t result = CompactJournal(pathNamePtr, blocking);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates temporary file for doing all intermediate operations. This function is used to create
- * temporary file when original file exists. File permissions are copied from the original file.
+ * Appends a record to the journal of a file.
  *
  * @return
- *      A file descriptor for doing atomic operation.
+ *      LE_OK if successful.
  *      LE_NOT_FOUND if the file does not exist.
+ *      LE_OVERFLOW if the data is too big for one record.
  *      LE_FAULT if there was an error.
- **/
+ */
 //--------------------------------------------------------------------------------------------------
-static int CreateTempFromOriginal
+static le_result_t WriteJournal
 (
-    const char* origPathPtr,             ///< [IN] Path to original file.
-    const char* tempPathPtr,             ///< [IN] Path to temporary file.
-    le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
-    bool copy                            ///< [IN] Whether content of original file should be copied
-                                         ///<      to temporary file.
+    const char* pathNamePtr,            ///< [IN] Path of the file.
+    int64_t offset,                     ///< [IN] Offset to write at, or LE_ATOMFILE_JOURNAL_APPEND.
+    const void* dataPtr,                ///< [IN] Data to write.
+    size_t dataSize                     ///< [IN] Number of bytes to write.
 )
 {
-    // Delete the temporary file if exists.
-    unlink(tempPathPtr);
+    LE_ASSERT(pathNamePtr != NULL);
+    LE_ASSERT(pathNamePtr[0] != '\0');
+    LE_ASSERT((dataPtr != NULL) || (dataSize == 0));
 
-    // File permission mode in temporary file should be same as original file, so set the
-    // processor umask to 0.
-    mode_t old_mode = umask((mode_t)0);
-    int tempfd;
+    if ((offset < 0) && (offset != LE_ATOMFILE_JOURNAL_APPEND))
+    {
+        LE_CRIT("Invalid journal write offset %" PRId64 " for '%s'.", offset, pathNamePtr);
+        return LE_FAULT;
+    }
+    if (dataSize > UINT32_MAX)
+    {
+        return LE_OVERFLOW;
+    }
 
-    if (copy)
+    char journalPath[PATH_MAX];
+    GetFilePath(pathNamePtr, JOURNAL_FILE_EXTENSION, journalPath, sizeof(journalPath));
+
+    int lockFd = AcquireLockFile(pathNamePtr, LE_FLOCK_WRITE, true);
+
+    if (lockFd < 0)
     {
-        // Copy the contents to temporary file.
-        if (file_Copy(origPathPtr, tempPathPtr, NULL) == LE_OK)
-        {
-            // Temp file already exists. So opening should be fine.
-            tempfd = le_flock_Open(tempPathPtr, accessMode);
-        }
-        else
-        {
-            tempfd = LE_FAULT;
-        }
+        return LE_FAULT;
     }
-    else
+
+    // Lock the original file as well, to keep out le_flock users, like le_atomFile_Open() does.
+    int fd = le_flock_Open(pathNamePtr, LE_FLOCK_WRITE);
+
+    if (fd < 0)
     {
-        // Temp file doesn't exist, so create it with original file permission
-        struct stat fileStatus;
+        le_flock_Close(lockFd);
+        return (fd == LE_NOT_FOUND) ? LE_NOT_FOUND : LE_FAULT;
+    }
 
-        // Get the original file permission mode and create a temp file with same permission mode.
-        if (stat(origPathPtr, &fileStatus) == 0)
-        {
-            tempfd = le_flock_Create(tempPathPtr,
-                                     accessMode,
-                                     LE_FLOCK_REPLACE_IF_EXIST,
-                                     fileStatus.st_mode);
-        }
-        else
+    le_result_t result = LE_FAULT;
+    struct stat fileStatus;
+    bool isNewJournal = false;
+    off_t validEnd;
+    uint64_t dataEnd;
+    int journalFd;
+
+    if (fstat(fd, &fileStatus) != 0)
+    {
+        LE_CRIT("Error when trying to stat '%s'. (%m)", pathNamePtr);
+        goto closeFile;
+    }
+
+    do
+    {
+        journalFd = open(journalPath, O_RDWR | O_CLOEXEC);
+        if ((journalFd == -1) && (errno == ENOENT))
         {
-            LE_CRIT("Error when trying to stat '%s'. (%m)", origPathPtr);
-            tempfd = LE_FAULT;
+            journalFd = open(journalPath, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+            isNewJournal = (journalFd != -1);
         }
     }
+    while ((journalFd == -1) && (errno == EINTR));
 
-    umask(old_mode);
-
-    return tempfd;
-}
+    if (journalFd == -1)
+    {
+        LE_CRIT("Failed to open journal '%s' (%m).", journalPath);
+        goto closeFile;
+    }
 
+    if (isNewJournal && (fchmod(journalFd, fileStatus.st_mode & 07777) != 0))
+    {
+        LE_CRIT("Failed to set permissions of journal '%s' (%m).", journalPath);
+        goto closeJournal;
+    }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Creates temporary file stream for doing all intermediate operations. This function is used to
- * create temporary file when original file exists. File permissions are copied from the original
- * file.
- *
- * If there was an error NULL is returned and resultPtr is set to:
- *      LE_NOT_FOUND if file doesn't exists.
- *      LE_FAULT if there was an error.
- *
- * @return
- *      Buffered file stream handle to the file if successful.
- *      NULL if there was an error.
- **/
-//--------------------------------------------------------------------------------------------------
-static FILE* CreateTempStreamFromOriginal
-(
-    const char* origPathPtr,             ///< [IN] Path to original file.
-    const char* tempPathPtr,             ///< [IN] Path to temporary file.
-    le_flock_AccessMode_t accessMode,    ///< [IN] The access mode to open the file with.
-    bool copy,                           ///< [IN] Whether content of original file should be copied
-                                         ///<      to temporary file.
-    le_result_t* resultPtr               ///< [OUT] A pointer to result code
-)
-{
-    // Delete the temporary file if exists.
-    unlink(tempPathPtr);
+    // Drop whatever is left of an append cut short by a crash, so that the new record isn't
+    // hidden behind it.
+    if (WalkJournal(journalFd, -1, -1, &validEnd, &dataEnd) != LE_OK)
+    {
+        goto closeJournal;
+    }
+    if (ftruncate(journalFd, validEnd) != 0)
+    {
+        LE_CRIT("Failed to truncate journal '%s' (%m).", journalPath);
+        goto closeJournal;
+    }
 
-    // File permission mode in temporary file should be same as original file, so set the
-    // processor umask to 0.
-    mode_t old_mode = umask((mode_t)0);
-    FILE* file;
+    JournalRecordHeader_t header =
+    {
+        .magic = JOURNAL_RECORD_MAGIC,
+        .size = dataSize,
+        .offset = (offset != LE_ATOMFILE_JOURNAL_APPEND) ? (uint64_t)offset :
+                  ((uint64_t)fileStatus.st_size > dataEnd) ? (uint64_t)fileStatus.st_size : dataEnd,
+        .crc = 0
+    };
+    header.crc = ComputeRecordCrc(&header, dataPtr, dataSize, 0);
+
+    if ((WriteAt(journalFd, &header, sizeof(header), validEnd) != LE_OK) ||
+        (WriteAt(journalFd, dataPtr, dataSize, validEnd + sizeof(header)) != LE_OK))
+    {
+        LE_CRIT("Failed to write journal '%s' (%m).", journalPath);
+        goto closeJournal;
+    }
 
-    if (copy)
+    // The record is committed once it is on the storage device.  A new journal also needs its
+    // directory entry to be.
+    if (fdatasync(journalFd) != 0)
     {
-        // Copy the contents to temporary file.
-        if (file_Copy(origPathPtr, tempPathPtr, NULL) == LE_OK)
-        {
-            // Temp file already exists. So opening should be fine.
-            file = le_flock_OpenStream(tempPathPtr, accessMode, resultPtr);
-        }
-        else
-        {
-            if (resultPtr != NULL)
-            {
-                *resultPtr = LE_FAULT;
-            }
-            file = NULL;
-        }
+        LE_CRIT("Failed to do fdatasync on journal '%s' (%m).", journalPath);
+        goto closeJournal;
     }
-    else
+    if (isNewJournal && (SyncDir(pathNamePtr) != LE_OK))
     {
-        // Temp file doesn't exist, so create it with original file permission
-        struct stat fileStatus;
+        goto closeJournal;
+    }
 
-        // Get the original file permission mode and create a temp file with same permission mode.
-        if (stat(origPathPtr, &fileStatus) == 0)
-        {
-            file = le_flock_CreateStream(tempPathPtr,
-                                         accessMode,
-                                         LE_FLOCK_REPLACE_IF_EXIST,
-                                         fileStatus.st_mode,
-                                         resultPtr);
-        }
-        else
-        {
-            LE_CRIT("Error when trying to stat '%s'. (%m)", origPathPtr);
+    result = LE_OK;
 
-            if (resultPtr != NULL)
-            {
-                *resultPtr = LE_FAULT;
-            }
-            file = NULL;
-        }
+    if (validEnd + sizeof(header) + dataSize >= JOURNAL_COMPACT_THRESHOLD)
+    {
+        QueueCompaction(pathNamePtr);
     }
 
-    umask(old_mode);
+closeJournal:
+    fd_Close(journalFd);
 
-    return file;
+closeFile:
+    le_flock_Close(fd);
+    le_flock_Close(lockFd);
+
+    return result;
 }
 
 
@@ -771,74 +1540,6 @@ static int Create
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Sync files to disk
- *
- * @return
- *      LE_OK if successful
- *      LE_FAULT if failed.
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t SyncFile
-(
-    FileAccess_t* accessPtr,            ///< [IN] Object containing files to be Sync-ed
-    const char* tempFilePath            ///< [IN] Path to temporary file.
-)
-{
-    // Do a fsync to ensure write to temporary file goes to storage device.
-     if (fsync(accessPtr->tempFd) == -1)
-     {
-         LE_CRIT("Failed to do fsync on file '%s' (%m).", tempFilePath);
-         return LE_FAULT;
-     }
-
-     char dirName[PATH_MAX];
-
-     // Get containing directory
-     LE_ASSERT_OK(le_path_GetDir(accessPtr->filePath, "/", dirName, sizeof(dirName)));
-
-     // le_path_GetDir returns file name when no path is specified.
-     if (!le_dir_IsDir(dirName))
-     {
-         dirName[0] = '.';
-         dirName[1] = 0;
-     }
-
-     int dirFd;
-     do
-     {
-         // Directory can be opened with read-only flag
-         dirFd = open(dirName, O_RDONLY);
-     }
-     while ( (dirFd == -1) && (errno == EINTR) );
-
-     if (dirFd == -1)
-     {
-         LE_CRIT("Failed to open directory '%s' (%m).", dirName);
-         return LE_FAULT;
-     }
-
-     // Now do a sync on directory
-     if (fsync(dirFd) == -1)
-     {
-         LE_CRIT("Failed to do fsync on directory: '%s' (%m).", dirName);
-         fd_Close(dirFd);
-         return LE_FAULT;
-     }
-
-     fd_Close(dirFd);
-
-     if (rename(tempFilePath, accessPtr->filePath))
-     {
-         LE_CRIT("Failed rename '%s' to '%s' (%m).", tempFilePath, accessPtr->filePath);
-         return LE_FAULT;
-     }
-
-     return LE_OK;
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Commit or cancel all changes done on the file.
@@ -938,9 +1639,10 @@ static le_result_t Delete
     //    1. Lock the lockfile.
     //    2. Lock the original file.
     //    3. Rename original file to a temporary file
-    //    4. Unlink the temporary file and unlock lockfile.
+    //    4. Unlink the temporary file and the journal and unlock lockfile.
 
-    int lockFd = OpenLockFile(pathNamePtr, LE_FLOCK_APPEND, blocking);
+    // No need to apply the journal of a file that is going away.
+    int lockFd = AcquireLockFile(pathNamePtr, LE_FLOCK_APPEND, blocking);
 
     if (lockFd < 0)
     {
@@ -975,6 +1677,10 @@ static le_result_t Delete
 
     DeleteFile(tempFilePath);
 
+    char journalPath[PATH_MAX];
+    GetFilePath(pathNamePtr, JOURNAL_FILE_EXTENSION, journalPath, sizeof(journalPath));
+    DeleteFile(journalPath);
+
     le_flock_Close(fd);
 
     // Note: Don't unlink the lockfile, it may lead to race condition (e.g. process B opens lockfile
@@ -1746,6 +2452,54 @@ le_result_t le_atomFile_TryDelete
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Atomically writes data to a file by appending a record to its journal, rather than rewriting the
+ * whole file.  The data is on the storage device when this function returns successfully.  The
+ * journal is applied to the file when it grows too large, when the file is next opened or
+ * created, or when le_atomFile_CompactJournal() is called.
+ *
+ * This is a blocking call. It will block until it can lock the target file.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the file does not exist.
+ *      LE_OVERFLOW if the data is too big for one record.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atomFile_WriteJournal
+(
+    const char* pathNamePtr,            ///< [IN] Path of the file to write to
+    int64_t offset,                     ///< [IN] Offset to write at, or LE_ATOMFILE_JOURNAL_APPEND
+    const void* dataPtr,                ///< [IN] Data to write
+    size_t dataSize                     ///< [IN] Number of bytes to write
+)
+{
+    return WriteJournal(pathNamePtr, offset, dataPtr, dataSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies the records in the journal of a file to it, atomically, and deletes the journal.
+ *
+ * This is a blocking call. It will block until it can lock the target file.
+ *
+ * @return
+ *      LE_OK if successful (or if there was no journal).
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_atomFile_CompactJournal
+(
+    const char* pathNamePtr             ///< [IN] Path of the file
+)
+{
+    return CompactJournal(pathNamePtr, true);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the atomic file access internal memory pools.  This function is meant to be called
@@ -1760,4 +2514,5 @@ void atomFile_Init
     // Initialize pools
     FileAccessPool = le_mem_CreatePool("AtomicFileAccessPool",
                                         sizeof(FileAccess_t));
+    JournalPathPool = le_mem_CreatePool("AtomicFileJournalPathPool", PATH_MAX);
 }
@@ -0,0 +1,116 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file bootTrace.c
+ *
+ * Implementation of the boot trace records.  Several processes append to the same file, so each
+ * record is written with a single write() to a file opened in append mode.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bootTrace.h"
+#include "fileDescriptor.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a single record, including the newline.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_BYTES                    256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a new boot trace, discarding the records of the previous one.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Reset
+(
+    void
+)
+{
+    // The runtime directory may not exist yet this early in the start-up.
+    (void)le_dir_Make("/tmp/legato", S_IRWXU | S_IXOTH);
+
+    int fd;
+
+    do
+    {
+        fd = open(BOOT_TRACE_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        LE_WARN("Could not create the boot trace file, '%s'.  %m.", BOOT_TRACE_FILE);
+        return;
+    }
+
+    fd_Close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records a start-up step that began at a given time and has just finished.  Errors are ignored,
+ * the trace is only a diagnostic aid.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Record
+(
+    pid_t pid,                  ///< [IN] Process that the step belongs to.
+    const char* categoryPtr,    ///< [IN] Category of the step, e.g., "daemon" or "app".
+    const char* namePtr,        ///< [IN] Name of the step.
+    le_clk_Time_t startTime     ///< [IN] Relative time (le_clk_GetRelativeTime()) the step began.
+)
+{
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    char record[MAX_RECORD_BYTES];
+
+    int len = snprintf(record,
+                       sizeof(record),
+                       "%d\t%" PRIu64 "\t%" PRIu64 "\t%s\t%s\n",
+                       (int)pid,
+                       (uint64_t)startTime.sec * 1000000 + startTime.usec,
+                       (uint64_t)duration.sec * 1000000 + duration.usec,
+                       categoryPtr,
+                       namePtr);
+
+    if ((len < 0) || (len >= sizeof(record)))
+    {
+        return;
+    }
+
+    // Only append to a trace that's been started.
+    int fd;
+
+    do
+    {
+        fd = open(BOOT_TRACE_FILE, O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        return;
+    }
+
+    struct stat fileStat;
+
+    if ((fstat(fd, &fileStat) == 0) && (fileStat.st_size + len <= BOOT_TRACE_MAX_BYTES))
+    {
+        ssize_t written;
+
+        do
+        {
+            written = write(fd, record, len);
+        }
+        while ((written == -1) && (errno == EINTR));
+    }
+
+    fd_Close(fd);
+}
@@ -0,0 +1,64 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file bootTrace.h
+ *
+ * Boot tracing.  The framework processes that take part in starting the system record how long
+ * each step of the start-up took in the boot trace file.  The 'bootTrace' target tool converts
+ * the file to a Chrome trace.
+ *
+ * Each record is one line of tab separated fields: the pid of the process the record is for, the
+ * start time and the duration of the step in microseconds, the category of the step and its name.
+ * The start times are read from the monotonic clock, so records from all processes line up.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_BOOT_TRACE_INCLUDE_GUARD
+#define LEGATO_BOOT_TRACE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the boot trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_FILE                     "/tmp/legato/bootTrace"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the boot trace file.  Records are dropped once the file is this big, so that
+ * steps recorded after start-up is over can't fill the file system.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_MAX_BYTES                (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a new boot trace, discarding the records of the previous one.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Reset
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records a start-up step that began at a given time and has just finished.  Errors are ignored,
+ * the trace is only a diagnostic aid.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Record
+(
+    pid_t pid,                  ///< [IN] Process that the step belongs to.
+    const char* categoryPtr,    ///< [IN] Category of the step, e.g., "daemon" or "app".
+    const char* namePtr,        ///< [IN] Name of the step.
+    le_clk_Time_t startTime     ///< [IN] Relative time (le_clk_GetRelativeTime()) the step began.
+);
+
+
+#endif // LEGATO_BOOT_TRACE_INCLUDE_GUARD
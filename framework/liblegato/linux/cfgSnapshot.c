@@ -0,0 +1,656 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgSnapshot.c
+ *
+ * Implementation of the @ref c_cfgSnapshot.
+ *
+ * Snapshots are binary tree files (see cfgTreeFile.h) published by the Config Tree daemon in
+ * @ref CFG_TREE_SNAPSHOT_PATH and @ref CFG_APP_SNAPSHOT_PATH.  A snapshot file is mapped into
+ * memory whole, and nodes are looked up by walking down the records from the base node, one path
+ * segment at a time.
+ *
+ * The daemon replaces snapshot files by renaming a new file over the old one, so an open mapping
+ * never changes and the file's checksum doesn't need to be checked.  The records are not checked
+ * when the file is opened, because that would take as long as reading the whole tree.  Instead,
+ * every record and string offset is checked as it is used.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "cfgSnapshot.h"
+#include "cfgTreeFile.h"
+#include "limit.h"
+#include "sysPaths.h"
+#include "user.h"
+#include "fileDescriptor.h"
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index used for nodes that don't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NO_RECORD   UINT32_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An open snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_cfgSnapshot
+{
+    void*                   mapPtr;         ///< Start of the mapped file.
+    size_t                  mapSize;        ///< Size of the mapped file, in bytes.
+    const BinTreeRecord_t*  recordsPtr;     ///< The node records.
+    uint32_t                recordCount;    ///< Number of node records.
+    const char*             stringsPtr;     ///< The string table.
+    uint32_t                stringsSize;    ///< Size of the string table, in bytes.
+    uint32_t                baseIndex;      ///< Record of the base node, or NO_RECORD if the base
+                                            ///  node doesn't exist.
+}
+Snapshot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool the snapshot objects are allocated from.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SnapshotPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps a snapshot's file when the snapshot is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SnapshotDestructor
+(
+    void* objPtr    ///< [IN] The snapshot.
+)
+{
+    Snapshot_t* snapshotPtr = objPtr;
+
+    if (munmap(snapshotPtr->mapPtr, snapshotPtr->mapSize) == -1)
+    {
+        LE_ERROR("Failed to unmap config snapshot (%m).");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a record of a snapshot.
+ *
+ * @return The record, or NULL if the index is out of range or the record's type is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static const BinTreeRecord_t* GetRecord
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    uint32_t index                  ///< [IN] Index of the record.
+)
+{
+    if (index >= snapshotPtr->recordCount)
+    {
+        return NULL;
+    }
+
+    const BinTreeRecord_t* recordPtr = &snapshotPtr->recordsPtr[index];
+
+    if (recordPtr->type >= BIN_NODE_TYPE_COUNT)
+    {
+        return NULL;
+    }
+
+    return recordPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a string from a snapshot's string table.  The table always ends with a terminator, so the
+ * string is terminated if it starts within the table.
+ *
+ * @return The string, or NULL if the offset is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetString
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    uint32_t offset                 ///< [IN] Offset of the string in the string table.
+)
+{
+    if (offset >= snapshotPtr->stringsSize)
+    {
+        return NULL;
+    }
+
+    return snapshotPtr->stringsPtr + offset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds a child of a node by name.
+ *
+ * @return Index of the child's record, or NO_RECORD if there is no such child.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FindChild
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    uint32_t index,                 ///< [IN] Index of the parent node's record.
+    const char* namePtr,            ///< [IN] Name of the child, not necessarily terminated.
+    size_t nameLen                  ///< [IN] Length of the name.
+)
+{
+    const BinTreeRecord_t* recordPtr = GetRecord(snapshotPtr, index);
+
+    if (   (recordPtr == NULL)
+        || (recordPtr->type != BIN_NODE_STEM)
+        || (recordPtr->childCount > snapshotPtr->recordCount))
+    {
+        return NO_RECORD;
+    }
+
+    uint32_t childIndex = recordPtr->dataOffset;
+    uint32_t endIndex = childIndex + recordPtr->childCount;
+
+    if (   (endIndex < childIndex)
+        || (endIndex > snapshotPtr->recordCount))
+    {
+        return NO_RECORD;
+    }
+
+    for (; childIndex < endIndex; childIndex++)
+    {
+        const BinTreeRecord_t* childPtr = &snapshotPtr->recordsPtr[childIndex];
+        const char* childNamePtr = GetString(snapshotPtr, childPtr->nameOffset);
+
+        if (   (childNamePtr != NULL)
+            && (strncmp(childNamePtr, namePtr, nameLen) == 0)
+            && (childNamePtr[nameLen] == '\0'))
+        {
+            return childIndex;
+        }
+    }
+
+    return NO_RECORD;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds a node by path.  Empty path segments and "." are skipped.
+ *
+ * @return Index of the node's record, or NO_RECORD if there is no such node.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FindNode
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    uint32_t index,                 ///< [IN] Index of the record of the node the path starts at.
+    const char* pathPtr             ///< [IN] Path to the node.
+)
+{
+    if (pathPtr == NULL)
+    {
+        return index;
+    }
+
+    while ((index != NO_RECORD) && (*pathPtr != '\0'))
+    {
+        size_t segmentLen = strcspn(pathPtr, "/");
+
+        if (   (segmentLen > 0)
+            && ((segmentLen != 1) || (pathPtr[0] != '.')))
+        {
+            index = FindChild(snapshotPtr, index, pathPtr, segmentLen);
+        }
+
+        pathPtr += segmentLen;
+
+        if (*pathPtr == '/')
+        {
+            pathPtr++;
+        }
+    }
+
+    return index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds a node by path, relative to a snapshot's base node.
+ *
+ * @return The node's record, or NULL if there is no such node.
+ */
+//--------------------------------------------------------------------------------------------------
+static const BinTreeRecord_t* FindRecord
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr                 ///< [IN] Path to the node, relative to the base path.
+)
+{
+    LE_ASSERT(snapshotRef != NULL);
+
+    if (snapshotRef->baseIndex == NO_RECORD)
+    {
+        return NULL;
+    }
+
+    return GetRecord(snapshotRef, FindNode(snapshotRef, snapshotRef->baseIndex, pathPtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the value of a node, as stored.
+ *
+ * @return The value string, or NULL if the node has no value or its value is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetValue
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const BinTreeRecord_t* recordPtr    ///< [IN] The node's record.
+)
+{
+    if (   (recordPtr->type == BIN_NODE_EMPTY)
+        || (recordPtr->type == BIN_NODE_STEM))
+    {
+        return NULL;
+    }
+
+    return GetString(snapshotRef, recordPtr->dataOffset);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a snapshot file and checks its header.
+ *
+ * @return The snapshot, or NULL if the file doesn't exist, can't be read or is corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+static Snapshot_t* MapSnapshot
+(
+    const char* filePathPtr     ///< [IN] Path to the snapshot file.
+)
+{
+    int fd = open(filePathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        LE_DEBUG("No config snapshot at '%s' (%m).", filePathPtr);
+        return NULL;
+    }
+
+    struct stat fileStat;
+    void* mapPtr = MAP_FAILED;
+
+    if (fstat(fd, &fileStat) == -1)
+    {
+        LE_ERROR("Could not stat config snapshot '%s' (%m).", filePathPtr);
+    }
+    else if (fileStat.st_size < (off_t)sizeof(BinTreeHeader_t))
+    {
+        LE_ERROR("Config snapshot '%s' is truncated.", filePathPtr);
+    }
+    else
+    {
+        mapPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapPtr == MAP_FAILED)
+        {
+            LE_ERROR("Could not map config snapshot '%s' (%m).", filePathPtr);
+        }
+    }
+
+    // The mapping stays valid after the file is closed.
+    fd_Close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    Snapshot_t* snapshotPtr = le_mem_ForceAlloc(SnapshotPool);
+
+    snapshotPtr->mapPtr = mapPtr;
+    snapshotPtr->mapSize = fileStat.st_size;
+    snapshotPtr->baseIndex = NO_RECORD;
+
+    const BinTreeHeader_t* headerPtr = mapPtr;
+    uint64_t stringsOffset =   sizeof(BinTreeHeader_t)
+                             + ((uint64_t)headerPtr->recordCount * sizeof(BinTreeRecord_t));
+
+    if (   (memcmp(headerPtr->magic, BIN_TREE_MAGIC, sizeof(headerPtr->magic)) != 0)
+        || (headerPtr->version != BIN_TREE_VERSION)
+        || (headerPtr->recordSize != sizeof(BinTreeRecord_t))
+        || (headerPtr->recordCount == 0)
+        || (headerPtr->stringsSize == 0)
+        || ((stringsOffset + headerPtr->stringsSize) != (uint64_t)fileStat.st_size)
+        || (((const char*)mapPtr)[fileStat.st_size - 1] != '\0'))
+    {
+        LE_ERROR("Config snapshot '%s' is corrupt or has an unsupported version.", filePathPtr);
+        le_mem_Release(snapshotPtr);
+        return NULL;
+    }
+
+    snapshotPtr->recordsPtr = (const BinTreeRecord_t*)((const uint8_t*)mapPtr
+                                                       + sizeof(BinTreeHeader_t));
+    snapshotPtr->recordCount = headerPtr->recordCount;
+    snapshotPtr->stringsPtr = (const char*)mapPtr + stringsOffset;
+    snapshotPtr->stringsSize = headerPtr->stringsSize;
+
+    return snapshotPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a name can be used as a snapshot file name.  Snapshot files being written start
+ * with a '.'.
+ *
+ * @return true if the name is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidName
+(
+    const char* namePtr,    ///< [IN] The name, not necessarily terminated.
+    size_t nameLen          ///< [IN] Length of the name.
+)
+{
+    return    (nameLen > 0)
+           && (nameLen < LIMIT_MAX_APP_NAME_BYTES)
+           && (namePtr[0] != '.')
+           && (memchr(namePtr, '/', nameLen) == NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the config snapshot reader's memory pool.  This function is meant to be called from
+ * Legato's internal init.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_Init
+(
+    void
+)
+{
+    SnapshotPool = le_mem_CreatePool("Config Snapshot", sizeof(Snapshot_t));
+    le_mem_SetDestructor(SnapshotPool, SnapshotDestructor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a snapshot of the config at a given path.
+ *
+ * The path is written as for le_cfg_CreateReadTxn().  Snapshots are available for paths in the
+ * calling app's own config tree, such as "/settings", and for paths under "system:/apps/<app>",
+ * where <app> is the calling app.
+ *
+ * @return Reference to the snapshot, or NULL if no snapshot is available for the path.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfgSnapshot_Ref_t le_cfgSnapshot_Open
+(
+    const char* basePathPtr         ///< [IN] Path to the node the snapshot's paths are relative to.
+)
+{
+    LE_ASSERT(basePathPtr != NULL);
+
+    char treeName[LIMIT_MAX_APP_NAME_BYTES];
+    const char* colonPtr = strchr(basePathPtr, ':');
+    const char* pathPtr = basePathPtr;
+
+    if (colonPtr != NULL)
+    {
+        size_t nameLen = colonPtr - basePathPtr;
+
+        if (IsValidName(basePathPtr, nameLen) == false)
+        {
+            return NULL;
+        }
+
+        memcpy(treeName, basePathPtr, nameLen);
+        treeName[nameLen] = '\0';
+        pathPtr = colonPtr + 1;
+    }
+    else if (user_GetAppName(geteuid(), treeName, sizeof(treeName)) != LE_OK)
+    {
+        // Processes that don't belong to an app have no config tree of their own to snapshot.
+        return NULL;
+    }
+
+    char filePath[LIMIT_MAX_PATH_BYTES];
+    int len;
+
+    if (strcmp(treeName, "system") == 0)
+    {
+        // Only the "/apps/<app>" subtrees of the system tree are published.
+        pathPtr += strspn(pathPtr, "/");
+
+        if (strncmp(pathPtr, "apps/", 5) != 0)
+        {
+            return NULL;
+        }
+
+        pathPtr += 5;
+
+        size_t appNameLen = strcspn(pathPtr, "/");
+
+        if (IsValidName(pathPtr, appNameLen) == false)
+        {
+            return NULL;
+        }
+
+        len = snprintf(filePath, sizeof(filePath), "%s/%.*s",
+                       CFG_APP_SNAPSHOT_PATH, (int)appNameLen, pathPtr);
+        pathPtr += appNameLen;
+    }
+    else
+    {
+        len = snprintf(filePath, sizeof(filePath), "%s/%s", CFG_TREE_SNAPSHOT_PATH, treeName);
+    }
+
+    LE_ASSERT((len >= 0) && ((size_t)len < sizeof(filePath)));
+
+    Snapshot_t* snapshotPtr = MapSnapshot(filePath);
+
+    if (snapshotPtr != NULL)
+    {
+        snapshotPtr->baseIndex = FindNode(snapshotPtr, 0, pathPtr);
+    }
+
+    return snapshotPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfgSnapshot_Close
+(
+    le_cfgSnapshot_Ref_t snapshotRef    ///< [IN] The snapshot.
+)
+{
+    LE_ASSERT(snapshotRef != NULL);
+
+    le_mem_Release(snapshotRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a node exists in a snapshot.
+ *
+ * @return true if the node exists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_cfgSnapshot_NodeExists
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr                 ///< [IN] Path to the node, relative to the base path.
+)
+{
+    return FindRecord(snapshotRef, pathPtr) != NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as a string.  Values of any type can be read as strings.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_OVERFLOW if the string was truncated to fit in the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_cfgSnapshot_GetString
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    char* bufferPtr,                    ///< [OUT] Buffer to copy the value to.
+    size_t bufferSize,                  ///< [IN] Size of the buffer, in bytes.
+    const char* defaultValuePtr         ///< [IN] Value to copy if the node has no value.
+)
+{
+    const BinTreeRecord_t* recordPtr = FindRecord(snapshotRef, pathPtr);
+    const char* valuePtr = (recordPtr != NULL) ? GetValue(snapshotRef, recordPtr) : NULL;
+
+    return le_utf8_Copy(bufferPtr,
+                        (valuePtr != NULL) ? valuePtr : defaultValuePtr,
+                        bufferSize,
+                        NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as an integer.  Floating point values are rounded.
+ *
+ * @return The value, or the default value if the node has no integer or floating point value.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfgSnapshot_GetInt
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    int32_t defaultValue                ///< [IN] Value to return if the node has no such value.
+)
+{
+    const BinTreeRecord_t* recordPtr = FindRecord(snapshotRef, pathPtr);
+
+    if (recordPtr == NULL)
+    {
+        return defaultValue;
+    }
+
+    const char* valuePtr = GetValue(snapshotRef, recordPtr);
+
+    if (valuePtr == NULL)
+    {
+        return defaultValue;
+    }
+
+    switch (recordPtr->type)
+    {
+        case BIN_NODE_INT:
+            return atoi(valuePtr);
+
+        case BIN_NODE_FLOAT:
+            {
+                double value = atof(valuePtr);
+                return (int32_t)(value >= 0.0 ? value + 0.5 : value - 0.5);
+            }
+
+        default:
+            return defaultValue;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's value as a floating point number.  Integer values are converted.
+ *
+ * @return The value, or the default value if the node has no floating point or integer value.
+ */
+//--------------------------------------------------------------------------------------------------
+double le_cfgSnapshot_GetFloat
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    double defaultValue                 ///< [IN] Value to return if the node has no such value.
+)
+{
+    const BinTreeRecord_t* recordPtr = FindRecord(snapshotRef, pathPtr);
+
+    if (recordPtr == NULL)
+    {
+        return defaultValue;
+    }
+
+    const char* valuePtr = GetValue(snapshotRef, recordPtr);
+
+    if (valuePtr == NULL)
+    {
+        return defaultValue;
+    }
+
+    switch (recordPtr->type)
+    {
+        case BIN_NODE_INT:
+            return atoi(valuePtr);
+
+        case BIN_NODE_FLOAT:
+            return atof(valuePtr);
+
+        default:
+            return defaultValue;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a node's boolean value.
+ *
+ * @return The value, or the default value if the node has no boolean value.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_cfgSnapshot_GetBool
+(
+    le_cfgSnapshot_Ref_t snapshotRef,   ///< [IN] The snapshot.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the base path.
+    bool defaultValue                   ///< [IN] Value to return if the node has no such value.
+)
+{
+    const BinTreeRecord_t* recordPtr = FindRecord(snapshotRef, pathPtr);
+
+    if (   (recordPtr == NULL)
+        || (recordPtr->type != BIN_NODE_BOOL))
+    {
+        return defaultValue;
+    }
+
+    const char* valuePtr = GetValue(snapshotRef, recordPtr);
+
+    if (valuePtr == NULL)
+    {
+        return defaultValue;
+    }
+
+    return strcmp(valuePtr, "f") != 0;
+}
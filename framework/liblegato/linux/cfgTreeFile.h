@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgTreeFile.h
+ *
+ * Binary config tree file format, shared by the Config Tree daemon, which writes the tree files
+ * and the config snapshots, and by the config snapshot reader of le_cfgSnapshot.h.
+ *
+ * This file exposes interfaces that are for use by other modules inside the framework
+ * implementation, but must not be used outside of the framework implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_SRC_CFG_TREE_FILE_INCLUDE_GUARD
+#define LEGATO_SRC_CFG_TREE_FILE_INCLUDE_GUARD
+
+
+/// Magic number at the start of a binary tree file.  No text tree file can start with it.
+#define BIN_TREE_MAGIC "LCFB"
+
+
+
+/// Version of the binary tree file format.
+#define BIN_TREE_VERSION 1
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header at the start of a binary tree file.  All of the integers in the file are stored in the
+ *  byte order of the device.
+ *
+ *  The header is followed by the node records, root node first, and then by the string table.  The
+ *  children of a stem are stored as consecutive records, which always come after the stem's own.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[4];          ///< BIN_TREE_MAGIC.
+    uint16_t version;       ///< BIN_TREE_VERSION.
+    uint16_t recordSize;    ///< Size of each node record, in bytes.
+    uint32_t recordCount;   ///< Number of node records.
+    uint32_t stringsSize;   ///< Size of the string table, in bytes.
+    uint32_t crc;           ///< CRC32 of the records and the string table.
+    uint32_t reserved;      ///< Always zero.
+}
+BinTreeHeader_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Types of the nodes stored in a binary tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef enum
+{
+    BIN_NODE_EMPTY,     ///< Node without any value.
+    BIN_NODE_STRING,    ///< UTF-8 text string.
+    BIN_NODE_BOOL,      ///< Boolean value.
+    BIN_NODE_INT,       ///< Signed integer.
+    BIN_NODE_FLOAT,     ///< Floating point number.
+    BIN_NODE_STEM,      ///< Collection of child nodes.
+    BIN_NODE_TYPE_COUNT
+}
+BinNodeType_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Node record in a binary tree file.  Names and values are stored in the string table, once for
+ *  every distinct string.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t nameOffset;    ///< Offset of the node's name in the string table.
+    uint32_t dataOffset;    ///< Offset of the node's value in the string table or, for a stem,
+                            ///<   index of the record of its first child.
+    uint32_t childCount;    ///< Number of children of a stem.
+    uint8_t type;           ///< One of BinNodeType_t.
+    uint8_t reserved[3];    ///< Always zero.
+}
+BinTreeRecord_t;
+
+
+#endif  // LEGATO_SRC_CFG_TREE_FILE_INCLUDE_GUARD
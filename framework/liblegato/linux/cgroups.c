@@ -12,6 +12,7 @@
 #include "fileDescriptor.h"
 #include "fileSystem.h"
 #include "killProc.h"
+#include <sys/vfs.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -71,6 +72,43 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 #define FREEZE_STATE_FILENAME       "freezer.state"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cgroup v2 (unified hierarchy) files used instead of the ones above.  In the unified hierarchy
+ * there is a single directory per cgroup, shared by all sub-systems, and the freezer is part of
+ * the cgroup core rather than a sub-system.
+ */
+//--------------------------------------------------------------------------------------------------
+#define V2_THREADS_FILENAME         "cgroup.threads"
+#define V2_CPU_WEIGHT_FILENAME      "cpu.weight"
+#define V2_MEM_LIMIT_FILENAME       "memory.max"
+#define V2_MEM_USED_FILENAME        "memory.current"
+#define V2_MEM_MAX_USED_FILENAME    "memory.peak"
+#define V2_CPU_STAT_FILENAME        "cpu.stat"
+#define V2_CPU_USAGE_KEY            "usage_usec "
+#define V2_FREEZE_FILENAME          "cgroup.freeze"
+#define V2_EVENTS_FILENAME          "cgroup.events"
+#define V2_SUBTREE_CONTROL_FILENAME "cgroup.subtree_control"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Controllers enabled for the children of the unified hierarchy's root.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* V2Controllers[] = {"+cpu", "+memory"};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File system magic number of a cgroup v2 mount.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef CGROUP2_SUPER_MAGIC
+#define CGROUP2_SUPER_MAGIC         0x63677270
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum digits in a cgroup integer value.
@@ -87,6 +125,251 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 #define MAX_FREEZE_STATE_BYTES      20
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes read from a cgroup v2 cgroup.events file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_EVENTS_BYTES            100
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimated number of cgroups with cached file descriptors.  One per running app.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CGRP_FDS_TABLE_SIZE         31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File descriptors held open for a cgroup created with cgrp_Create(), so that files in its
+ * directories can be opened with openat() instead of walking the whole path each time, and so
+ * that processes can be added without opening cgroup.procs for every one of them.
+ *
+ * The fds are indexed by hierarchy (see HierarchyIndex()).  In the unified hierarchy only index 0
+ * is used.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_PATH_BYTES];    ///< Name of the cgroup.  Key in CgrpFdsTable.
+    int dirFd[CGRP_NUM_SUBSYSTEMS];     ///< The cgroup's directory in each hierarchy, or -1.
+    int procsFd[CGRP_NUM_SUBSYSTEMS];   ///< The cgroup's procs file opened for writing, or -1.
+}
+CgrpFds_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Table of CgrpFds_t, keyed by cgroup name.  Created on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t CgrpFdsTable = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of CgrpFds_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CgrpFdsPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the cgroup root is a cgroup v2 (unified hierarchy) mount.  If it is, the system's
+ * unified hierarchy is used as is; otherwise Legato mounts one hierarchy per sub-system.
+ *
+ * @return
+ *      true if the unified hierarchy is used.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsUnified
+(
+    void
+)
+{
+    static int isUnified = -1;
+
+    if (isUnified < 0)
+    {
+        struct statfs fsInfo;
+
+        isUnified = (statfs(ROOT_PATH, &fsInfo) == 0) && (fsInfo.f_type == CGROUP2_SUPER_MAGIC);
+    }
+
+    return isUnified;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the index of the hierarchy a sub-system is attached to.
+ */
+//--------------------------------------------------------------------------------------------------
+static int HierarchyIndex
+(
+    cgrp_SubSys_t subsystem         ///< [IN] Sub-system.
+)
+{
+    return IsUnified() ? 0 : subsystem;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the path to a cgroup's directory, or to a file in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetCgrpPath
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    const char* fileNamePtr,        ///< [IN] Name of the file, or NULL for the directory.
+    char* pathPtr,                  ///< [OUT] Buffer to store the path in.
+    size_t pathSize                 ///< [IN] Size of the buffer.
+)
+{
+    LE_ASSERT(le_utf8_Copy(pathPtr, ROOT_PATH, pathSize, NULL) == LE_OK);
+
+    if (!IsUnified())
+    {
+        LE_ASSERT(le_path_Concat("/", pathPtr, pathSize, SubSysName[subsystem],
+                                 (char*)NULL) == LE_OK);
+    }
+
+    LE_ASSERT(le_path_Concat("/", pathPtr, pathSize, cgroupNamePtr, fileNamePtr,
+                             (char*)NULL) == LE_OK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the cached file descriptors of a cgroup.
+ *
+ * @return
+ *      The cached file descriptors, or NULL if the cgroup has none.
+ */
+//--------------------------------------------------------------------------------------------------
+static CgrpFds_t* GetCgrpFds
+(
+    const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
+)
+{
+    if (CgrpFdsTable == NULL)
+    {
+        return NULL;
+    }
+
+    return le_hashmap_Get(CgrpFdsTable, cgroupNamePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens and caches the directory of a cgroup that was just created.  Failing to do so is not an
+ * error; the cgroup's files are then opened by path.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CacheCgrpDir
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    const char* dirPathPtr          ///< [IN] Path to the cgroup's directory.
+)
+{
+    if (CgrpFdsTable == NULL)
+    {
+        CgrpFdsPool = le_mem_CreatePool("CgroupFds", sizeof(CgrpFds_t));
+        CgrpFdsTable = le_hashmap_Create("CgroupFds", CGRP_FDS_TABLE_SIZE,
+                                         le_hashmap_HashString, le_hashmap_EqualsString);
+    }
+
+    CgrpFds_t* fdsPtr = le_hashmap_Get(CgrpFdsTable, cgroupNamePtr);
+
+    if (fdsPtr == NULL)
+    {
+        fdsPtr = le_mem_ForceAlloc(CgrpFdsPool);
+
+        if (le_utf8_Copy(fdsPtr->name, cgroupNamePtr, sizeof(fdsPtr->name), NULL) != LE_OK)
+        {
+            le_mem_Release(fdsPtr);
+            return;
+        }
+
+        int i;
+        for (i = 0; i < CGRP_NUM_SUBSYSTEMS; i++)
+        {
+            fdsPtr->dirFd[i] = -1;
+            fdsPtr->procsFd[i] = -1;
+        }
+
+        le_hashmap_Put(CgrpFdsTable, fdsPtr->name, fdsPtr);
+    }
+
+    int index = HierarchyIndex(subsystem);
+
+    if (fdsPtr->dirFd[index] < 0)
+    {
+        fdsPtr->dirFd[index] = open(dirPathPtr, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (fdsPtr->dirFd[index] < 0)
+        {
+            LE_WARN("Could not open cgroup directory '%s'.  %m.", dirPathPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes the cached file descriptors of a cgroup in one hierarchy, and drops the cgroup from the
+ * cache once it has none left.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseCgrpFds
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
+)
+{
+    CgrpFds_t* fdsPtr = GetCgrpFds(cgroupNamePtr);
+
+    if (fdsPtr == NULL)
+    {
+        return;
+    }
+
+    int index = HierarchyIndex(subsystem);
+
+    if (fdsPtr->procsFd[index] >= 0)
+    {
+        fd_Close(fdsPtr->procsFd[index]);
+        fdsPtr->procsFd[index] = -1;
+    }
+
+    if (fdsPtr->dirFd[index] >= 0)
+    {
+        fd_Close(fdsPtr->dirFd[index]);
+        fdsPtr->dirFd[index] = -1;
+    }
+
+    int i;
+    for (i = 0; i < CGRP_NUM_SUBSYSTEMS; i++)
+    {
+        if (fdsPtr->dirFd[i] >= 0)
+        {
+            return;
+        }
+    }
+
+    le_hashmap_Remove(CgrpFdsTable, fdsPtr->name);
+    le_mem_Release(fdsPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if all cgroup subsystems are mounted.
@@ -162,6 +445,31 @@ void cgrp_Init
     void
 )
 {
+    // Use the system's unified hierarchy if it has one, and enable the controllers used for apps.
+    if (IsUnified())
+    {
+        char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
+        LE_ASSERT(le_path_Concat("/", path, sizeof(path), V2_SUBTREE_CONTROL_FILENAME,
+                                 (char*)NULL) == LE_OK);
+
+        int fd = open(path, O_WRONLY | O_CLOEXEC);
+        LE_FATAL_IF(fd < 0, "Could not open '%s'.  %m.", path);
+
+        size_t i;
+        for (i = 0; i < NUM_ARRAY_MEMBERS(V2Controllers); i++)
+        {
+            if (write(fd, V2Controllers[i], strlen(V2Controllers[i])) < 0)
+            {
+                LE_WARN("Could not enable cgroup controller '%s'.  %m.", V2Controllers[i] + 1);
+            }
+        }
+
+        fd_Close(fd);
+
+        LE_INFO("Using the cgroup v2 unified hierarchy.");
+        return;
+    }
+
     // Setup the cgroup root directory if it does not already exist.
     if (!fs_IsMounted(ROOT_NAME, ROOT_PATH))
     {
@@ -190,7 +498,7 @@ void cgrp_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Opens a cgroup file.
+ * Opens a cgroup file.  The file is opened relative to the cgroup's cached directory if it has one.
  *
  * @return
  *      The file descriptor of the cgroup's tasks file if successful.
@@ -206,13 +514,31 @@ static int OpenCgrpFile
 
 )
 {
+    int fd;
+    CgrpFds_t* fdsPtr = GetCgrpFds(cgroupNamePtr);
+
+    if ((fdsPtr != NULL) && (fdsPtr->dirFd[HierarchyIndex(subsystem)] >= 0))
+    {
+        do
+        {
+            fd = openat(fdsPtr->dirFd[HierarchyIndex(subsystem)], fileNamePtr,
+                        accessMode | O_CLOEXEC);
+        }
+        while ((fd < 0) && (errno == EINTR));
+
+        if (fd < 0)
+        {
+            LE_ERROR("Could not open file '%s' in cgroup '%s'.  %m.", fileNamePtr, cgroupNamePtr);
+        }
+
+        return fd;
+    }
+
     // Create the path to the cgroup file.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             fileNamePtr, (char*)NULL) == LE_OK);
+    char path[LIMIT_MAX_PATH_BYTES];
+    GetCgrpPath(subsystem, cgroupNamePtr, fileNamePtr, path, sizeof(path));
 
     // Open the cgroup file.
-    int fd;
 
     do
     {
@@ -231,11 +557,8 @@ static int OpenCgrpFile
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Writes a string to a cgroup file.  Overwrites what is currently in the file.
- *
- * @note  Certain file types cannot accept certain types of data, and the write may fail with a
- *        specific errno value.  If the write fails with errno ESRCH this function will return
- *        LE_OUT_OF_RANGE.
+ * Writes a string to an opened cgroup file.  Each write to a cgroup file is handled on its own, so
+ * the same fd can be written to repeatedly.
  *
  * @return
  *      LE_OK if successful.
@@ -243,11 +566,11 @@ static int OpenCgrpFile
  *      LE_FAULT if there was some other error.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteToFile
+static le_result_t WriteToFd
 (
-    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    int fd,                         ///< [IN] File descriptor of the opened cgroup file.
     const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
-    const char* fileNamePtr,        ///< [IN] File to write to.
+    const char* fileNamePtr,        ///< [IN] Name of the file, for error messages.
     const char* string              ///< [IN] String to write into the file.
 )
 {
@@ -255,14 +578,6 @@ static le_result_t WriteToFile
     size_t len = strlen(string);
     LE_ASSERT(len > 0);
 
-    // Open the file.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, fileNamePtr, O_WRONLY);
-
-    if (fd < 0)
-    {
-        return LE_FAULT;
-    }
-
     // Write the string to the file.
     le_result_t result = LE_OK;
     ssize_t numBytesWritten = 0;
@@ -288,6 +603,42 @@ static le_result_t WriteToFile
         }
     }
 
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a string to a cgroup file.  Overwrites what is currently in the file.
+ *
+ * @note  Certain file types cannot accept certain types of data, and the write may fail with a
+ *        specific errno value.  If the write fails with errno ESRCH this function will return
+ *        LE_OUT_OF_RANGE.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if an attempt was made to write a value that the file cannot accept.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteToFile
+(
+    cgrp_SubSys_t subsystem,        ///< [IN] Sub-system of the cgroup.
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    const char* fileNamePtr,        ///< [IN] File to write to.
+    const char* string              ///< [IN] String to write into the file.
+)
+{
+    // Open the file.
+    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, fileNamePtr, O_WRONLY);
+
+    if (fd < 0)
+    {
+        return LE_FAULT;
+    }
+
+    le_result_t result = WriteToFd(fd, cgroupNamePtr, fileNamePtr, string);
+
     fd_Close(fd);
 
     return result;
@@ -454,13 +805,19 @@ le_result_t cgrp_Create
 )
 {
     // Create the path to the cgroup.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             (char*)NULL) == LE_OK);
+    char path[LIMIT_MAX_PATH_BYTES];
+    GetCgrpPath(subsystem, cgroupNamePtr, NULL, path, sizeof(path));
 
     // Create the cgroup.
     le_result_t result = le_dir_Make(path, S_IRWXU);
 
+    if ((result == LE_DUPLICATE) && IsUnified() && (subsystem != CGRP_SUBSYS_CPU))
+    {
+        // In the unified hierarchy the cgroup's one directory is created for the cpu sub-system
+        // and shared by the others.
+        result = LE_OK;
+    }
+
     if (result == LE_DUPLICATE)
     {
         LE_WARN("Cgroup %s already exists.", path);
@@ -472,6 +829,8 @@ le_result_t cgrp_Create
         return LE_FAULT;
     }
 
+    CacheCgrpDir(subsystem, cgroupNamePtr, path);
+
     return LE_OK;
 }
 
@@ -498,10 +857,73 @@ le_result_t cgrp_AddProc
 
     LE_ASSERT(snprintf(pidStr, sizeof(pidStr), "%d", pidToAdd) < sizeof(pidStr));
 
-    // Write the pid to the file.
+    // Write the pid to the cgroup's procs file, keeping it open for the next process.
+    CgrpFds_t* fdsPtr = GetCgrpFds(cgroupNamePtr);
+    int index = HierarchyIndex(subsystem);
+
+    if ((fdsPtr != NULL) && (fdsPtr->dirFd[index] >= 0))
+    {
+        if (fdsPtr->procsFd[index] < 0)
+        {
+            fdsPtr->procsFd[index] = OpenCgrpFile(subsystem, cgroupNamePtr, PROCS_FILENAME,
+                                                  O_WRONLY);
+
+            if (fdsPtr->procsFd[index] < 0)
+            {
+                return LE_FAULT;
+            }
+        }
+
+        return WriteToFd(fdsPtr->procsFd[index], cgroupNamePtr, PROCS_FILENAME, pidStr);
+    }
+
     return WriteToFile(subsystem, cgroupNamePtr, PROCS_FILENAME, pidStr);
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a process to the cgroups of the same name in all sub-systems.  In the unified hierarchy
+ * this is a single write, because the sub-systems share one cgroup.
+ *
+ * @note In the unified hierarchy the process can't be left out of the cpu sub-system, so
+ *       includeCpu is ignored.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if the process doesn't exist.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_AddProcToAll
+(
+    const char* cgroupNamePtr,      ///< Name of the cgroups to add the process to.
+    pid_t pidToAdd,                 ///< PID of the process to add.
+    bool includeCpu                 ///< false to leave the process out of the cpu sub-system.
+)
+{
+    if (IsUnified())
+    {
+        return cgrp_AddProc(CGRP_SUBSYS_CPU, cgroupNamePtr, pidToAdd);
+    }
+
+    cgrp_SubSys_t subSys = 0;
+    for (; subSys < CGRP_NUM_SUBSYSTEMS; subSys++)
+    {
+        if ((subSys != CGRP_SUBSYS_CPU) || includeCpu)
+        {
+            le_result_t result = cgrp_AddProc(subSys, cgroupNamePtr, pidToAdd);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reads a list of tids/pids from an open file descriptor.  The number of pids in the file may be
@@ -568,7 +990,8 @@ ssize_t cgrp_GetThreadList
 )
 {
     // Open the cgroup's tasks file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, TASKS_FILENAME, O_RDONLY);
+    int fd = OpenCgrpFile(subsystem, cgroupNamePtr,
+                          IsUnified() ? V2_THREADS_FILENAME : TASKS_FILENAME, O_RDONLY);
 
     if (fd < 0)
     {
@@ -696,7 +1119,8 @@ bool cgrp_IsEmpty
 )
 {
     // Open the cgroup's tasks file for reading.
-    int fd = OpenCgrpFile(subsystem, cgroupNamePtr, TASKS_FILENAME, O_RDONLY);
+    int fd = OpenCgrpFile(subsystem, cgroupNamePtr,
+                          IsUnified() ? V2_THREADS_FILENAME : TASKS_FILENAME, O_RDONLY);
 
     if (fd < 0)
     {
@@ -743,10 +1167,17 @@ le_result_t cgrp_Delete
     const char* cgroupNamePtr       ///< Name of the cgroup to delete.
 )
 {
+    CloseCgrpFds(subsystem, cgroupNamePtr);
+
+    if (IsUnified() && (subsystem != CGRP_SUBSYS_CPU))
+    {
+        // The cgroup's one directory is removed with the cpu sub-system.
+        return LE_OK;
+    }
+
     // Create the path to the cgroup.
-    char path[LIMIT_MAX_PATH_BYTES] = ROOT_PATH;
-    LE_ASSERT(le_path_Concat("/", path, sizeof(path), SubSysName[subsystem], cgroupNamePtr,
-                             (char*)NULL) == LE_OK);
+    char path[LIMIT_MAX_PATH_BYTES];
+    GetCgrpPath(subsystem, cgroupNamePtr, NULL, path, sizeof(path));
 
     // Attempt to remove the cgroup directory.
     if (rmdir(path) != 0)
@@ -834,12 +1265,23 @@ le_result_t cgrp_cpu_SetShare
                                     ///  details.
 )
 {
+    const char* fileNamePtr = CPU_SHARES_FILENAME;
+
+    if (IsUnified())
+    {
+        // Map shares [2, 262144] onto weights [1, 10000], the same way the kernel does for
+        // cgroup v1 compatibility.  The default 1024 shares maps to the default weight of 100.
+        share = (share < 2) ? 2 : (share > 262144) ? 262144 : share;
+        share = 1 + ((share - 2) * 9999) / 262142;
+        fileNamePtr = V2_CPU_WEIGHT_FILENAME;
+    }
+
     // Convert the value to a string.
     char shareStr[MAX_DIGITS];
     LE_ASSERT(snprintf(shareStr, sizeof(shareStr), "%zd", share) < sizeof(shareStr));
 
     // Write the share value to the file.
-    if (WriteToFile(CGRP_SUBSYS_CPU, cgroupNamePtr, CPU_SHARES_FILENAME, shareStr) != LE_OK)
+    if (WriteToFile(CGRP_SUBSYS_CPU, cgroupNamePtr, fileNamePtr, shareStr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -871,7 +1313,9 @@ le_result_t cgrp_mem_SetLimit
     LE_ASSERT(snprintf(limitStr, sizeof(limitStr), "%zd", limit * 1024) < sizeof(limitStr));
 
     // Write the limit to the file.
-    if (WriteToFile(CGRP_SUBSYS_MEM, cgroupNamePtr, MEM_LIMIT_FILENAME, limitStr) != LE_OK)
+    const char* fileNamePtr = IsUnified() ? V2_MEM_LIMIT_FILENAME : MEM_LIMIT_FILENAME;
+
+    if (WriteToFile(CGRP_SUBSYS_MEM, cgroupNamePtr, fileNamePtr, limitStr) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -881,7 +1325,7 @@ le_result_t cgrp_mem_SetLimit
 
     if (GetValue(CGRP_SUBSYS_MEM,
                  cgroupNamePtr,
-                 MEM_LIMIT_FILENAME,
+                 fileNamePtr,
                  readLimitStr,
                  sizeof(readLimitStr)) != LE_OK)
     {
@@ -915,7 +1359,12 @@ le_result_t cgrp_frz_Freeze
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME, "FROZEN") != LE_OK)
+    le_result_t result = IsUnified() ?
+                         WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, V2_FREEZE_FILENAME, "1") :
+                         WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME,
+                                     "FROZEN");
+
+    if (result != LE_OK)
     {
         return LE_FAULT;
     }
@@ -941,7 +1390,12 @@ le_result_t cgrp_frz_Thaw
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
-    if (WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME, "THAWED") != LE_OK)
+    le_result_t result = IsUnified() ?
+                         WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, V2_FREEZE_FILENAME, "0") :
+                         WriteToFile(CGRP_SUBSYS_FREEZE, cgroupNamePtr, FREEZE_STATE_FILENAME,
+                                     "THAWED");
+
+    if (result != LE_OK)
     {
         return LE_FAULT;
     }
@@ -964,6 +1418,20 @@ cgrp_FreezeState_t cgrp_frz_GetState
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 )
 {
+    if (IsUnified())
+    {
+        // The cgroup is frozen once cgroup.events reports "frozen 1"; until then it is freezing.
+        char eventsStr[MAX_EVENTS_BYTES] = {0};
+
+        if (GetValue(CGRP_SUBSYS_FREEZE, cgroupNamePtr, V2_EVENTS_FILENAME,
+                     eventsStr, sizeof(eventsStr)) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        return (strstr(eventsStr, "frozen 1") != NULL) ? CGRP_FROZEN : CGRP_THAWED;
+    }
+
     char stateStr[MAX_FREEZE_STATE_BYTES] = {0};
 
     le_result_t result = GetValue(CGRP_SUBSYS_FREEZE,
@@ -1013,7 +1481,7 @@ ssize_t cgrp_GetMemUsed
 
     if (GetValue(CGRP_SUBSYS_MEM,
                  cgroupNamePtr,
-                 "memory.memsw.usage_in_bytes",
+                 IsUnified() ? V2_MEM_USED_FILENAME : "memory.memsw.usage_in_bytes",
                  buffer,
                  sizeof(buffer)) == LE_OK)
     {
@@ -1046,7 +1514,7 @@ ssize_t cgrp_GetMaxMemUsed
 
     if (GetValue(CGRP_SUBSYS_MEM,
                  cgroupNamePtr,
-                 "memory.memsw.max_usage_in_bytes",
+                 IsUnified() ? V2_MEM_MAX_USED_FILENAME : "memory.memsw.max_usage_in_bytes",
                  buffer,
                  sizeof(buffer)) == LE_OK)
     {
@@ -1062,3 +1530,61 @@ ssize_t cgrp_GetMaxMemUsed
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total CPU time used by the tasks in a cgroup.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_GetCpuTime
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* cpuTimePtr            ///< [OUT] CPU time used, in nanoseconds.
+)
+{
+    char buffer[256] = {0};
+    const char* valuePtr = buffer;
+    uint64_t scale = 1;
+
+    if (IsUnified())
+    {
+        // The usage is the first line of cpu.stat, in microseconds.  The rest of the file may not
+        // fit in the buffer, which is fine.
+        if (GetValue(CGRP_SUBSYS_CPU, cgroupNamePtr, V2_CPU_STAT_FILENAME,
+                     buffer, sizeof(buffer)) == LE_FAULT)
+        {
+            return LE_FAULT;
+        }
+
+        valuePtr = strstr(buffer, V2_CPU_USAGE_KEY);
+
+        if (valuePtr == NULL)
+        {
+            return LE_FAULT;
+        }
+
+        valuePtr += sizeof(V2_CPU_USAGE_KEY) - 1;
+        scale = 1000;
+    }
+    else if (GetValue(CGRP_SUBSYS_CPU, cgroupNamePtr, "cpuacct.usage",
+                      buffer, sizeof(buffer)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    char* endPtr;
+    errno = 0;
+    unsigned long long value = strtoull(valuePtr, &endPtr, 10);
+
+    if ((errno != 0) || (endPtr == valuePtr))
+    {
+        return LE_FAULT;
+    }
+
+    *cpuTimePtr = (uint64_t)value * scale;
+
+    return LE_OK;
+}
@@ -43,6 +43,11 @@
  * words there is a one-to-one mapping of hierarchy and sub-systems so the terms hierarchy and
  * sub-system will be used interchangeably henceforth.
  *
+ * If the system has already mounted the cgroup v2 unified hierarchy at /sys/fs/cgroup, that is
+ * used instead.  There is then a single cgroup per name, shared by all sub-systems: creating or
+ * adding a process to it for one sub-system does so for all of them, and it is removed when it is
+ * deleted for the cpu sub-system.  The same functions are used in both cases.
+ *
  *
  * @section c_cgrp_init Initialization
  *
@@ -84,12 +89,15 @@
  *
  * Processes that are forked by other processes always inherit the cgroup of their parent.
  *
+ * To add a process to the cgroups of the same name in every sub-system at once use
+ * cgrp_AddProcToAll().  The cgroup's procs files are kept open between processes.
+ *
  * When a process dies it is automatically removed from all cgroups it belongs to.
  *
  * @section c_cgrp_delete Deleting cgroups
  *
  * To delete a cgroup call cgrp_Delete().  Cgroups can only be deleted if they do not contain any
- * processes.
+ * processes.  This also closes the file descriptors kept open for the cgroup.
  *
  *
  * @section c_cgrp_threadSafety Thread Safety
@@ -189,6 +197,28 @@ le_result_t cgrp_AddProc
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a process to the cgroups of the same name in all sub-systems.  In the unified hierarchy
+ * this is a single write, because the sub-systems share one cgroup.
+ *
+ * @note In the unified hierarchy the process can't be left out of the cpu sub-system, so
+ *       includeCpu is ignored.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if the process doesn't exist.
+ *      LE_FAULT if there was some other error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_AddProcToAll
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroups to add the process to.
+    pid_t pidToAdd,                 ///< [IN] PID of the process to add.
+    bool includeCpu                 ///< [IN] false to leave the process out of the cpu sub-system.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a list of threads that are in a cgroup.  The number of threads in the cgroup may be
@@ -435,4 +465,19 @@ ssize_t cgrp_GetMaxMemUsed
     const char* cgroupNamePtr       ///< [IN] Name of the cgroup.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total CPU time used by the tasks in a cgroup.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_GetCpuTime
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* cpuTimePtr            ///< [OUT] CPU time used, in nanoseconds.
+);
+
 #endif // LEGATO_SRC_CGROUPS_INCLUDE_GUARD
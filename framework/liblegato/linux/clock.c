@@ -7,6 +7,7 @@
 
 #include "legato.h"
 #include "timer.h"
+#include "eventLoop.h"
 
 
 // Microseconds should be less than this value.
@@ -121,6 +122,56 @@ le_clk_Time_t le_clk_GetAbsoluteTime(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a low resolution monotonic time, which is cheaper to get than the relative time.
+ *
+ * @return
+ *      The coarse time in seconds/microseconds
+ *
+ * @note
+ *      - CLOCK_MONOTONIC_COARSE is always served from the vDSO, without a system call.
+ *      - It is a fatal error if the coarse time cannot be returned
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetCoarseTime(void)
+{
+    struct timespec systemTime;
+    le_clk_Time_t coarseTime;
+
+    if (0 > clock_gettime(CLOCK_MONOTONIC_COARSE, &systemTime))
+    {
+        LE_FATAL("clock_gettime() failed. errno = %d (%m)", errno);
+    }
+
+    coarseTime.sec = systemTime.tv_sec;
+    coarseTime.usec = systemTime.tv_nsec/1000;
+
+    return coarseTime;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time at which the calling thread's event loop called the running handler.
+ *
+ * @return
+ *      The relative time in seconds/microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+le_clk_Time_t le_clk_GetDispatchTime(void)
+{
+    le_clk_Time_t dispatchTime;
+
+    if (event_GetDispatchTime(&dispatchTime))
+    {
+        return dispatchTime;
+    }
+
+    return le_clk_GetRelativeTime();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add two time values together, and return the result.
@@ -0,0 +1,564 @@
+//--------------------------------------------------------------------------------------------------
+/** @file coro.c
+ *
+ * Implementation of the @ref c_coro.
+ *
+ * Each coroutine has its own stack, mapped when it is started, with a guard page below it so that
+ * a stack overflow faults instead of silently corrupting memory.  Switching between the event loop
+ * and a coroutine is done with swapcontext().
+ *
+ * A coroutine only ever runs from a function queued to its thread's event loop, RunCoroutine(),
+ * which switches to the coroutine and gets control back when the coroutine waits or ends.  Resuming
+ * a coroutine just queues RunCoroutine() again, so it continues from the event loop of its own
+ * thread, whatever thread resumed it and whatever that thread was doing at the time.
+ *
+ * The state of every coroutine is protected by a single mutex, because le_coro_Resume() can be
+ * called from any thread.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "coro.h"
+#include <sys/mman.h>
+#include <ucontext.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum coroutine name size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CORO_NAME_SIZE  24
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coroutine object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_coro
+{
+    char            name[MAX_CORO_NAME_SIZE];   ///< Name, for diagnostics.
+    le_coro_Func_t  func;                       ///< Function to run.
+    void*           contextPtr;                 ///< Value to pass to the function.
+    le_thread_Ref_t threadRef;                  ///< Thread the coroutine runs on.
+    size_t          stackSize;                  ///< Size of the stack, not counting the guard page.
+    void*           mapPtr;                     ///< Start of the guard page and stack, or NULL.
+
+    /// Coroutine state.
+    enum
+    {
+        CORO_STATE_NEW,         ///< Not yet started.
+        CORO_STATE_RUNNING,     ///< Running, or queued to run.
+        CORO_STATE_WAITING,     ///< Waiting in le_coro_Await().
+        CORO_STATE_DONE         ///< Function has returned.
+    }
+    state;
+
+    bool            isResumePending;            ///< Resumed before waiting.
+    void*           resultPtr;                  ///< Value for le_coro_Await() to return.
+    ucontext_t      context;                    ///< The coroutine's saved context.
+    ucontext_t      callerContext;              ///< Context of RunCoroutine() while switched out.
+}
+Coro_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool the coroutine objects are allocated from.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CoroPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the thread-local data item holding the running coroutine, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t CurrentCoroKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Protects the state of all the coroutines.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Virtual memory page size.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PageSize;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Locks the mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void Lock
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlocks the mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void Unlock
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps a coroutine's stack when the coroutine is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoroDestructor
+(
+    void* objPtr    ///< [IN] The coroutine.
+)
+{
+    Coro_t* coroPtr = objPtr;
+
+    if (   (coroPtr->mapPtr != NULL)
+        && (munmap(coroPtr->mapPtr, PageSize + coroPtr->stackSize) == -1))
+    {
+        LE_ERROR("Failed to unmap stack of coroutine '%s' (%m).", coroPtr->name);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the running coroutine, which must exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static Coro_t* GetCurrent
+(
+    const char* funcNamePtr     ///< [IN] Name of the calling function, for the error message.
+)
+{
+    Coro_t* coroPtr = pthread_getspecific(CurrentCoroKey);
+
+    LE_FATAL_IF(coroPtr == NULL, "%s() called outside of a coroutine.", funcNamePtr);
+
+    return coroPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Entry point of every coroutine, running on the coroutine's own stack.  When it returns,
+ * swapcontext() returns in RunCoroutine().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoroMain
+(
+    void
+)
+{
+    Coro_t* coroPtr = pthread_getspecific(CurrentCoroKey);
+
+    coroPtr->func(coroPtr->contextPtr);
+
+    Lock();
+    coroPtr->state = CORO_STATE_DONE;
+    Unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs a coroutine until it waits or ends.  Queued to the coroutine's thread's event loop to start
+ * or resume it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunCoroutine
+(
+    void* param1Ptr,    ///< [IN] The coroutine.
+    void* param2Ptr     ///< [IN] Not used.
+)
+{
+    Coro_t* coroPtr = param1Ptr;
+    void* prevCoroPtr = pthread_getspecific(CurrentCoroKey);
+
+    LE_ASSERT(pthread_setspecific(CurrentCoroKey, coroPtr) == 0);
+    LE_ASSERT(swapcontext(&coroPtr->callerContext, &coroPtr->context) == 0);
+    LE_ASSERT(pthread_setspecific(CurrentCoroKey, prevCoroPtr) == 0);
+
+    Lock();
+    bool isDone = (coroPtr->state == CORO_STATE_DONE);
+    Unlock();
+
+    // Once the function has returned, nothing can refer to the coroutine any more.
+    if (isDone)
+    {
+        LE_DEBUG("Coroutine '%s' has ended.", coroPtr->name);
+        le_mem_Release(coroPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes a waiting coroutine at once, from a handler running on its thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResumeNow
+(
+    Coro_t* coroPtr,    ///< [IN] The coroutine.
+    void* resultPtr     ///< [IN] Value for le_coro_Await() to return.
+)
+{
+    Lock();
+
+    LE_FATAL_IF(coroPtr->state != CORO_STATE_WAITING,
+                "Coroutine '%s' resumed while not waiting.",
+                coroPtr->name);
+
+    coroPtr->state = CORO_STATE_RUNNING;
+    coroPtr->resultPtr = resultPtr;
+
+    Unlock();
+
+    RunCoroutine(coroPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes the coroutine waiting for a timer to expire in le_coro_Sleep().
+ */
+//--------------------------------------------------------------------------------------------------
+static void SleepTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] The timer.
+)
+{
+    le_coro_Resume(le_timer_GetContextPtr(timerRef), NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes the coroutine waiting for a file descriptor in le_coro_AwaitFd().
+ *
+ * The coroutine is resumed from the handler rather than from the event queue, so that it deletes
+ * the File Descriptor Monitor before the event loop can call this handler again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AwaitFdHandler
+(
+    int fd,         ///< [IN] The file descriptor.
+    short events    ///< [IN] The events that occurred.
+)
+{
+    ResumeNow(le_fdMonitor_GetContextPtr(), (void*)(intptr_t)events);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the coroutine module.  This function is meant to be called from Legato's internal
+ * init.
+ */
+//--------------------------------------------------------------------------------------------------
+void coro_Init
+(
+    void
+)
+{
+    CoroPool = le_mem_CreatePool("Coroutine", sizeof(Coro_t));
+    le_mem_SetDestructor(CoroPool, CoroDestructor);
+
+    LE_ASSERT(pthread_key_create(&CurrentCoroKey, NULL) == 0);
+
+    PageSize = sysconf(_SC_PAGESIZE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a coroutine.  It doesn't run until it is started with le_coro_Start().
+ *
+ * @return Reference to the coroutine.
+ *
+ * @note The process exits if the coroutine can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_coro_Ref_t le_coro_Create
+(
+    const char*     name,           ///< [IN] Name of the coroutine, for diagnostics.
+    le_coro_Func_t  func,           ///< [IN] Function to run.
+    void*           contextPtr      ///< [IN] Value to pass to the function.
+)
+{
+    LE_ASSERT(func != NULL);
+
+    Coro_t* coroPtr = le_mem_ForceAlloc(CoroPool);
+
+    memset(coroPtr, 0, sizeof(*coroPtr));
+
+    if (le_utf8_Copy(coroPtr->name, name, sizeof(coroPtr->name), NULL) == LE_OVERFLOW)
+    {
+        LE_WARN("Coroutine name '%s' truncated to '%s'.", name, coroPtr->name);
+    }
+
+    coroPtr->func = func;
+    coroPtr->contextPtr = contextPtr;
+    coroPtr->stackSize = LE_CORO_DEFAULT_STACK_SIZE;
+    coroPtr->state = CORO_STATE_NEW;
+
+    return coroPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the stack size of a coroutine that hasn't been started yet.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_OVERFLOW if the stack size requested is smaller than LE_CORO_MIN_STACK_SIZE.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_coro_SetStackSize
+(
+    le_coro_Ref_t   coroRef,        ///< [IN] The coroutine.
+    size_t          size            ///< [IN] Stack size, in bytes.  May be rounded up to the
+                                    ///       nearest virtual memory page size.
+)
+{
+    LE_ASSERT(coroRef != NULL);
+
+    LE_FATAL_IF(coroRef->state != CORO_STATE_NEW,
+                "Attempt to set stack size of running coroutine '%s'.",
+                coroRef->name);
+
+    if (size < LE_CORO_MIN_STACK_SIZE)
+    {
+        return LE_OVERFLOW;
+    }
+
+    coroRef->stackSize = (size + PageSize - 1) & ~(PageSize - 1);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a coroutine on the calling thread's event loop.
+ *
+ * @note The process exits if the coroutine's stack can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Start
+(
+    le_coro_Ref_t   coroRef         ///< [IN] The coroutine.
+)
+{
+    LE_ASSERT(coroRef != NULL);
+
+    LE_FATAL_IF(coroRef->state != CORO_STATE_NEW,
+                "Coroutine '%s' started twice.",
+                coroRef->name);
+
+    // Stack pages are only backed by memory once they are touched.
+    void* mapPtr = mmap(NULL,
+                        PageSize + coroRef->stackSize,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                        -1,
+                        0);
+
+    LE_FATAL_IF(mapPtr == MAP_FAILED,
+                "Failed to map stack of coroutine '%s' (%m).",
+                coroRef->name);
+
+    coroRef->mapPtr = mapPtr;
+
+    LE_FATAL_IF(mprotect(mapPtr, PageSize, PROT_NONE) == -1,
+                "Failed to protect stack guard page of coroutine '%s' (%m).",
+                coroRef->name);
+
+    LE_ASSERT(getcontext(&coroRef->context) == 0);
+
+    coroRef->context.uc_stack.ss_sp = (uint8_t*)mapPtr + PageSize;
+    coroRef->context.uc_stack.ss_size = coroRef->stackSize;
+    coroRef->context.uc_link = &coroRef->callerContext;
+
+    makecontext(&coroRef->context, CoroMain, 0);
+
+    coroRef->threadRef = le_thread_GetCurrent();
+    coroRef->state = CORO_STATE_RUNNING;
+
+    le_event_QueueFunction(RunCoroutine, coroRef, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the coroutine that is running.
+ *
+ * @return Reference to the coroutine, or NULL if not called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+le_coro_Ref_t le_coro_GetCurrent
+(
+    void
+)
+{
+    return pthread_getspecific(CurrentCoroKey);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits until the running coroutine is resumed by le_coro_Resume().
+ *
+ * @return The value passed to le_coro_Resume().
+ *
+ * @note Must only be called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_coro_Await
+(
+    void
+)
+{
+    Coro_t* coroPtr = GetCurrent(__func__);
+
+    Lock();
+
+    if (coroPtr->isResumePending)
+    {
+        coroPtr->isResumePending = false;
+        Unlock();
+
+        return coroPtr->resultPtr;
+    }
+
+    // If another thread resumes the coroutine as soon as the mutex is unlocked, RunCoroutine()
+    // is queued to this thread, so it can't run until the switch below is done.
+    coroPtr->state = CORO_STATE_WAITING;
+    Unlock();
+
+    LE_ASSERT(swapcontext(&coroPtr->context, &coroPtr->callerContext) == 0);
+
+    return coroPtr->resultPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes a coroutine that is waiting in le_coro_Await(), or that will be.  Can be called from any
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Resume
+(
+    le_coro_Ref_t   coroRef,        ///< [IN] The coroutine.
+    void*           resultPtr       ///< [IN] Value for le_coro_Await() to return.
+)
+{
+    LE_ASSERT(coroRef != NULL);
+
+    Lock();
+
+    LE_FATAL_IF(   (coroRef->state == CORO_STATE_NEW)
+                || (coroRef->state == CORO_STATE_DONE)
+                || coroRef->isResumePending,
+                "Coroutine '%s' resumed while not waiting.",
+                coroRef->name);
+
+    coroRef->resultPtr = resultPtr;
+
+    if (coroRef->state == CORO_STATE_WAITING)
+    {
+        coroRef->state = CORO_STATE_RUNNING;
+        Unlock();
+
+        le_event_QueueFunctionToThread(coroRef->threadRef, RunCoroutine, coroRef, NULL);
+    }
+    else
+    {
+        coroRef->isResumePending = true;
+        Unlock();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a length of time.
+ *
+ * @note Must only be called from a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_coro_Sleep
+(
+    uint32_t        ms              ///< [IN] Time to wait, in milliseconds.
+)
+{
+    Coro_t* coroPtr = GetCurrent(__func__);
+
+    le_timer_Ref_t timerRef = le_timer_Create(coroPtr->name);
+
+    LE_ASSERT(le_timer_SetMsInterval(timerRef, ms) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(timerRef, SleepTimerHandler) == LE_OK);
+    LE_ASSERT(le_timer_SetContextPtr(timerRef, coroPtr) == LE_OK);
+    LE_ASSERT(le_timer_Start(timerRef) == LE_OK);
+
+    le_coro_Await();
+
+    le_timer_Delete(timerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a file descriptor to become ready.
+ *
+ * @return The events that occurred, as for a @ref c_fdMonitor handler.  POLLHUP, POLLERR and
+ *         POLLRDHUP are reported even if not asked for.
+ *
+ * @note Must only be called from a coroutine.  The file descriptor must not have a File
+ *       Descriptor Monitor on the calling thread, including one for another waiting coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+short le_coro_AwaitFd
+(
+    int             fd,             ///< [IN] The file descriptor.
+    short           events          ///< [IN] Events to wait for (POLLIN, POLLPRI, POLLOUT).
+)
+{
+    Coro_t* coroPtr = GetCurrent(__func__);
+
+    le_fdMonitor_Ref_t monitorRef = le_fdMonitor_Create(coroPtr->name, fd, AwaitFdHandler, events);
+
+    le_fdMonitor_SetContextPtr(monitorRef, coroPtr);
+
+    short readyEvents = (short)(intptr_t)le_coro_Await();
+
+    le_fdMonitor_Delete(monitorRef);
+
+    return readyEvents;
+}
@@ -0,0 +1,29 @@
+//--------------------------------------------------------------------------------------------------
+/** @file coro.h
+ *
+ * Legato coroutine inter-module include file.
+ *
+ * This file exposes interfaces that are for use by other modules inside the framework
+ * implementation, but must not be used outside of the framework implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_SRC_CORO_INCLUDE_GUARD
+#define LEGATO_SRC_CORO_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the coroutine module.  This function is meant to be called from Legato's internal
+ * init.
+ */
+//--------------------------------------------------------------------------------------------------
+void coro_Init
+(
+    void
+);
+
+
+#endif  // LEGATO_SRC_CORO_INCLUDE_GUARD
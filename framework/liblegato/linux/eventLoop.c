@@ -65,20 +65,32 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
- * will return immediately, reporting that there is something to read from that fd.
+ * The Event Queue is a lock-free queue that any thread can add to (see event_Queue_t), with an
+ * atomic count of the Event Reports on it.  Whenever an Event Report is added to a thread's
+ * empty Event Queue (the count goes from 0 to 1), the number 1 is written to that thread's
+ * eventfd, which makes epoll_wait() return, reporting that there is something to read from that
+ * fd.  Adding to a queue that isn't empty doesn't touch the eventfd, so a thread that floods
+ * another with reports doesn't make a system call for each one.  The thread reads the eventfd
+ * (resetting it to zero) when epoll_wait() reports it, and it never goes back to waiting in
+ * epoll_wait() while the count is not zero, so no wake-up can be missed.
  *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
- * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
- * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
+ * that epoll_wait() reports.  If epoll_wait() reports an event on any fd other than the eventfd,
  * FD Event Reports are created and pushed onto Event Queues according to what handlers are
- * registered for those events.  All pending Event Reports are processed until the Event Queue is
- * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
- * overhead in times of heavy load.  Unfortunately, it also means that if event handlers always add
- * new events to the queue, then epoll_wait() will never be called and therefore fd events will
- * never be detected.)
+ * registered for those events.  Then Event Reports are popped off the Event Queue and processed.
+ *
+ * Only the reports already on the queue when processing starts, and at most a budget's worth
+ * of them, are processed before returning to epoll_wait().  Draining several reports per
+ * epoll_wait() saves system call overhead in times of heavy load, while the budget bounds how
+ * long fd events can wait behind a steady stream of reports.  If reports are left on the queue,
+ * epoll_wait() is called with a zero timeout, so fd events are picked up and the remaining
+ * reports are processed straight after.
+ *
+ * The budget is read from the LE_EVENT_REPORT_BUDGET environment variable at start-up.  Zero means
+ * no limit (all live events are processed each time).
+ *
+ * Each thread also keeps statistics (see event_Stats_t) on the reports it processes, which can be
+ * viewed using the inspect tool.
  *
  * ----
  *
@@ -86,7 +98,8 @@
  *
  * Everything can be shared between multiple threads, and therefore must be protected from
  * multithreaded race conditions.  A Mutex is provided for that purpose, and it can be locked
- * and unlocked using the functions Lock() and Unlock().
+ * and unlocked using the functions Lock() and Unlock().  The exception is the Event Queue,
+ * which is lock-free, so that queueing a function to another thread doesn't need the Mutex.
  *
  * ----
  *
@@ -99,6 +112,7 @@
 #include "fdMonitor.h"
 #include "limit.h"
 #include "fileDescriptor.h"
+#include "tracepoint.h"
 
 #include <pthread.h>
 #include <sys/eventfd.h>
@@ -110,6 +124,12 @@
 /// Maximum number of events that can be received from epoll_wait() at one time.
 #define MAX_EPOLL_EVENTS 32
 
+/// Default maximum number of Event Reports to process between calls to epoll_wait().
+#define DEFAULT_REPORT_BUDGET 64
+
+/// Name of the environment variable that overrides the default report budget.
+#define REPORT_BUDGET_ENV_VAR "LE_EVENT_REPORT_BUDGET"
+
 /// The default number of objects in the process-wide Queued Function Report Pool, from which
 /// Queued Function reports are allocated.
 /// @todo Make this configurable.
@@ -144,7 +164,7 @@
  * @note    These objects are never deleted.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Event
 {
     le_sls_Link_t       link;                   ///< Used to link into the Event List.
     void*               id;                     ///< The Event ID (safe ref) assigned to this event.
@@ -184,43 +204,21 @@ static le_sls_List_t EventList = LE_SLS_LIST_INIT;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handler object.
- *
- * This stores the registration information for a handler function.  They are allocated from the
- * Handler Pool and are stored on a thread's Handler List.
- *
- * @warning These can be accessed by multiple threads, and are in both the Event List structure
- *          and the Per-Thread structure.  Great care must be taken to prevent races when accessing
- *          these objects (use the Mutex).
+ * Handler Pool
  *
- * @note    The lifecycle of these objects is such that once they have been created, only their
- *          list links can be changed, until they are deleted.
+ * This is the pool from which Handler objects are allocated.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    le_dls_Link_t           eventLink;  ///< Used to link onto an event's Handler List.
-    le_dls_Link_t           threadLink; ///< Used to link onto a thread's Handler List.
-    event_PerThreadRec_t*   threadRecPtr;///< Ptr to per-thread rec of thread that will run this.
-    Event_t*                eventPtr;   ///< Ptr to the Event obj for the event that this handles.
-    void*                   contextPtr; ///< The context pointer for this handler.
-    void*                   safeRef;    ///< Safe Reference for this object.
-    char                    name[LIMIT_MAX_EVENT_HANDLER_NAME_BYTES];///< UTF-8 name of the handler.
-
-    le_event_LayeredHandlerFunc_t   firstLayerFunc;     ///< First-layer handler function.
-    void*                           secondLayerFunc;    ///< Second-layer handler function.
-}
-Handler_t;
+static le_mem_PoolRef_t HandlerPool;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handler Pool
- *
- * This is the pool from which Handler objects are allocated.
+ * A counter that increments every time a change is made to a thread's Handler List.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t HandlerPool;
+static size_t HandlerListChangeCount = 0;
+static size_t* HandlerListChangeCountRef = &HandlerListChangeCount;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -335,6 +333,17 @@ static le_ref_MapRef_t HandlerRefMap;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mutex.
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of Event Reports that a thread will process before going back to epoll_wait()
+ * to check for fd events.  0 = no limit.
+ *
+ * This is set once, in event_Init(), before any other threads are started.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ReportBudget = DEFAULT_REPORT_BUDGET;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Guards against thread cancellation and locks the mutex.
@@ -479,6 +488,7 @@ static void DeleteHandler
 {
     le_dls_Remove(&handlerPtr->eventPtr->handlerList, &handlerPtr->eventLink);
     le_dls_Remove(&handlerPtr->threadRecPtr->handlerList, &handlerPtr->threadLink);
+    HandlerListChangeCount++;
     le_ref_DeleteRef(HandlerRefMap, handlerPtr->safeRef);
     le_mem_Release(handlerPtr);
 }
@@ -488,7 +498,7 @@ static void DeleteHandler
 /**
  * Write to a thread's Event File Descriptor.  This increments it by one.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * This must be done whenever an Event Report is pushed onto the thread's empty Event Queue.
  */
 //--------------------------------------------------------------------------------------------------
 static void WriteEventFd
@@ -526,9 +536,10 @@ static void WriteEventFd
 //--------------------------------------------------------------------------------------------------
 /**
  * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
+ * the number of event reports added to the Event Queue since the last read) and resets the
+ * Event FD value to zero.
  *
- * @return The number of Event Reports on the thread's Event Queue.
+ * @return The number of Event Reports added to the thread's Event Queue (may be zero).
  */
 //--------------------------------------------------------------------------------------------------
 static uint64_t ReadEventFd
@@ -547,27 +558,226 @@ static uint64_t ReadEventFd
         {
             return readBuff;
         }
-        else
+        else if (readSize == -1)
         {
-            if ((readSize == -1) && (errno != EINTR))
+            // The eventfd is non-blocking, so EAGAIN just means nothing new has been queued.
+            if (errno == EAGAIN)
             {
-                LE_FATAL("read() failed with errno %d (%m).", errno);
+                return 0;
             }
-            else
+            else if (errno != EINTR)
             {
-                LE_FATAL("read() returned %zd! (expected %zd)", readSize, sizeof(readBuff));
+                LE_FATAL("read() failed with errno %d (%m).", errno);
             }
         }
+        else
+        {
+            LE_FATAL("read() returned %zd! (expected %zd)", readSize, sizeof(readBuff));
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize an Event Queue as empty (holding only its stub link).
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitQueue
+(
+    event_Queue_t* queuePtr     ///< [in] Ptr to the queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    queuePtr->stub = LE_SLS_LINK_INIT;
+    queuePtr->headPtr = &queuePtr->stub;
+    queuePtr->count = 0;
+    __atomic_store_n(&queuePtr->tailPtr, &queuePtr->stub, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a link to the tail of an Event Queue.  Can be called by any thread, without locking.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushToQueue
+(
+    event_Queue_t* queuePtr,    ///< [in] Ptr to the queue.
+    le_sls_Link_t* linkPtr      ///< [in] Ptr to the link to add.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    __atomic_store_n(&linkPtr->nextPtr, NULL, __ATOMIC_RELAXED);
+
+    // Make the new link the tail, then attach it to the old tail.  Until the second step is done,
+    // the consumer will see the queue end at the old tail.
+    le_sls_Link_t* prevPtr = __atomic_exchange_n(&queuePtr->tailPtr, linkPtr, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prevPtr->nextPtr, linkPtr, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the link at the head of an Event Queue.  Must only be called by the thread that owns
+ * the queue.
+ *
+ * @return Ptr to the link, or NULL if the queue is empty or a link is still being added to it
+ *         by another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_Link_t* PopFromQueue
+(
+    event_Queue_t* queuePtr     ///< [in] Ptr to the queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* headPtr = queuePtr->headPtr;
+    le_sls_Link_t* nextPtr = __atomic_load_n(&headPtr->nextPtr, __ATOMIC_ACQUIRE);
+
+    // Skip over the stub, if it is at the head.
+    if (headPtr == &queuePtr->stub)
+    {
+        if (nextPtr == NULL)
+        {
+            return NULL;
+        }
+
+        queuePtr->headPtr = nextPtr;
+        headPtr = nextPtr;
+        nextPtr = __atomic_load_n(&headPtr->nextPtr, __ATOMIC_ACQUIRE);
+    }
+
+    if (nextPtr != NULL)
+    {
+        queuePtr->headPtr = nextPtr;
+        return headPtr;
+    }
+
+    // The head is the last link in the queue, unless another thread is part way through adding
+    // one after it.  To remove the last link, the stub has to be put back behind it first.
+    if (headPtr != __atomic_load_n(&queuePtr->tailPtr, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    PushToQueue(queuePtr, &queuePtr->stub);
+
+    nextPtr = __atomic_load_n(&headPtr->nextPtr, __ATOMIC_ACQUIRE);
+    if (nextPtr != NULL)
+    {
+        queuePtr->headPtr = nextPtr;
+        return headPtr;
     }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of Event Reports on a thread's Event Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetQueueCount
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return __atomic_load_n(&perThreadRecPtr->eventQueue.count, __ATOMIC_ACQUIRE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an Event Report to the end of a thread's Event Queue and, if the queue was empty, wake up
+ * that thread's Event Loop.
+ *
+ * Can be called by any thread, with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReport
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the thread's per-thread record.
+    Report_t* reportObjPtr                  ///< [in] Ptr to the report to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PushToQueue(&perThreadRecPtr->eventQueue, &reportObjPtr->link);
+
+    // Count the report only once it is on the queue, so that the owning thread never finds the
+    // count at zero with a report it hasn't been woken up for.
+    size_t depth = __atomic_add_fetch(&perThreadRecPtr->eventQueue.count, 1, __ATOMIC_SEQ_CST);
+
+    size_t maxDepth = __atomic_load_n(&perThreadRecPtr->stats.maxQueueDepth, __ATOMIC_RELAXED);
+    while ((depth > maxDepth) &&
+           !__atomic_compare_exchange_n(&perThreadRecPtr->stats.maxQueueDepth,
+                                        &maxDepth,
+                                        depth,
+                                        false,
+                                        __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED))
+    {
+        // maxDepth has been updated to the latest value.  Try again.
+    }
+
+    // If the thread hasn't created its eventfd yet, it isn't waiting for anything, and it will
+    // find the report when it does (see CreateFds()).
+    if (   (depth == 1)
+        && (__atomic_load_n(&perThreadRecPtr->eventQueueFd, __ATOMIC_SEQ_CST) != -1))
+    {
+        // Increment the eventfd for the thread's Event Queue.
+        // This will wake up the thread and tell it that it has something on its Event Queue.
+        // write() is a cancellation point, and being cancelled after the report was counted
+        // but before the thread was woken up would leave the report stranded.
+        int oldState;
+        int err = pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+        LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+
+        WriteEventFd(perThreadRecPtr);
+
+        err = pthread_setcancelstate(oldState, &oldState);
+        LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the calling thread's statistics after a handler or queued function has been called.
+ *
+ * @return  The time spent in the call.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t RecordHandlerTime
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the calling thread's per-thread record.
+    le_clk_Time_t startTime                 ///< [in] Relative time at which the call started.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    event_Stats_t* statsPtr = &perThreadRecPtr->stats;
+
+    statsPtr->handlerTime = le_clk_Add(statsPtr->handlerTime, elapsed);
+    if (le_clk_GreaterThan(elapsed, statsPtr->maxHandlerTime))
+    {
+        statsPtr->maxHandlerTime = elapsed;
+    }
+
+    return elapsed;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Process one event report from the calling thread's Event Queue.
+ *
+ * @return  true if a report was processed, false if there was none ready on the queue.
  **/
 //--------------------------------------------------------------------------------------------------
-static void ProcessOneEventReport
+static bool ProcessOneEventReport
 (
     event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
 )
@@ -576,19 +786,21 @@ static void ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    int oldState;
 
-    int oldState = Lock();
-
-    // Pop an Event Report off the head of the Event Queue (inside a critical section).
-    linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
-
-    Unlock(oldState);
+    // Pop an Event Report off the head of the Event Queue.  No lock is needed for this, because
+    // only this thread removes things from its queue.
+    linkPtr = PopFromQueue(&perThreadRecPtr->eventQueue);
 
     if (linkPtr == NULL)
     {
-        return;
+        return false;
     }
 
+    __atomic_sub_fetch(&perThreadRecPtr->eventQueue.count, 1, __ATOMIC_ACQ_REL);
+
+    perThreadRecPtr->stats.reportCount++;
+
     // Convert the link pointer into a pointer to the Report base class.
     reportObjPtr = CONTAINER_OF(linkPtr, Report_t, link);
 
@@ -600,8 +812,15 @@ static void ProcessOneEventReport
         queuedFuncReportPtr = CONTAINER_OF(reportObjPtr, QueuedFunctionReport_t, baseClass);
 
         // Call the function.
+        TRACEPOINT_BEGIN("queued %p", queuedFuncReportPtr->function);
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+        perThreadRecPtr->dispatchTime = startTime;
+        perThreadRecPtr->dispatchDepth++;
         queuedFuncReportPtr->function(queuedFuncReportPtr->param1Ptr,
                                       queuedFuncReportPtr->param2Ptr);
+        perThreadRecPtr->dispatchDepth--;
+        RecordHandlerTime(perThreadRecPtr, startTime);
+        TRACEPOINT_END();
 
     }
     // If it's a publish-subscribe event report,
@@ -649,10 +868,24 @@ static void ProcessOneEventReport
                 reportPtr = pubSubReportPtr->payload;
             }
 
+            // Hold a reference to the Handler object so its statistics can be updated even if
+            // the handler removes itself.
+            le_mem_AddRef(handlerPtr);
+
             Unlock(oldState);  // Unlock the mutex before calling the handler function.
-                               // Don't access the Handler object anymore after this.
+                               // Don't access anything but the Handler's statistics after this.
 
+            TRACEPOINT_BEGIN("event %s", handlerPtr->name);
+            le_clk_Time_t startTime = le_clk_GetRelativeTime();
+            perThreadRecPtr->dispatchTime = startTime;
+            perThreadRecPtr->dispatchDepth++;
             firstLayerFunc(reportPtr, secondLayerFunc);
+            perThreadRecPtr->dispatchDepth--;
+            event_RecordHandlerCall(&handlerPtr->stats, RecordHandlerTime(perThreadRecPtr,
+                                                                          startTime));
+            TRACEPOINT_END();
+
+            le_mem_Release(handlerPtr);
         }
     }
 
@@ -660,12 +893,17 @@ static void ProcessOneEventReport
 
     // We are done with this report.
     le_mem_Release(reportObjPtr);
+
+    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Process Event Reports from the calling thread's Event Queue until the queue is empty.
+ * Process up to the report budget's worth of Event Reports from the calling thread's Event Queue.
+ *
+ * Reports that don't fit in the budget are left for the next call, after the Event Loop has
+ * checked for fd events.
  */
 //--------------------------------------------------------------------------------------------------
 static void ProcessEventReports
@@ -674,17 +912,26 @@ static void ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = ReadEventFd(perThreadRecPtr);
+    uint64_t numReports = GetQueueCount(perThreadRecPtr);
+    if ((ReportBudget != 0) && (numReports > ReportBudget))
+    {
+        numReports = ReportBudget;
+    }
 
     // Process only those event reports that are already on the queue.  Anything reported by the
     // event handlers will have to wait until next time ProcessEventReports() is called.
-    // This approach ensures that event handlers that re-queue events to the event
-    // queue don't cause fd events to be starved.
+    // This approach, along with the budget, ensures that event handlers that re-queue events to
+    // the event queue and bursts of reports from other threads don't cause fd events to be
+    // starved.
+    //
+    // If a report can't be popped, another thread is part way through queueing it.  Leave it for
+    // next time rather than spinning here.
     for (; numReports > 0; numReports--)
     {
-        ProcessOneEventReport(perThreadRecPtr);
+        if (!ProcessOneEventReport(perThreadRecPtr))
+        {
+            break;
+        }
     }
 }
 
@@ -718,7 +965,7 @@ static void PubSubHandlerFunc
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
  * could belong to some other thread).
  *
- * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ * The mutex doesn't need to be locked.
  */
 //--------------------------------------------------------------------------------------------------
 static void QueueFunction
@@ -740,11 +987,8 @@ static void QueueFunction
     reportPtr->param1Ptr = param1Ptr;
     reportPtr->param2Ptr = param2Ptr;
 
-    // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
-
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
-    WriteEventFd(perThreadRecPtr);
+    // Queue it to the Event Queue and notify the Event Loop that there is something on the queue.
+    QueueReport(perThreadRecPtr, &reportPtr->baseClass);
 }
 
 
@@ -808,11 +1052,101 @@ void event_Init
     // Get a reference to the trace keyword that is used to control tracing in this module.
     TraceRef = le_log_GetTraceRef("eventLoop");
 
+    // Check for an override of the report budget.
+    const char* budgetStr = getenv(REPORT_BUDGET_ENV_VAR);
+    if (budgetStr != NULL)
+    {
+        int32_t budget;
+        if ((le_utf8_ParseInt(&budget, budgetStr) == LE_OK) && (budget >= 0))
+        {
+            ReportBudget = budget;
+        }
+        else
+        {
+            LE_WARN("Invalid event report budget '%s' in %s.", budgetStr, REPORT_BUDGET_ENV_VAR);
+        }
+    }
+
     // Initialize the FD Monitor module.
     fdMon_Init();
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the epoll fd of the calling thread's Event Loop and the eventfd of its Event Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateFds
+(
+    event_PerThreadRec_t* recPtr    ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Create the epoll file descriptor for this thread.  This will be used to monitor for
+    // events on various file descriptors.
+    recPtr->epollFd = epoll_create1(0);
+    LE_FATAL_IF(recPtr->epollFd < 0, "epoll_create1(0) failed with errno %d (%m).", errno);
+
+    // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
+    // are Event Reports on the Event Queue.
+    // It is non-blocking so that reading it when nothing new has been queued is harmless.
+    int eventQueueFd = eventfd(0, EFD_NONBLOCK);
+    LE_FATAL_IF(eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
+
+    // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLWAKEUP;
+    ev.data.ptr = NULL;     // This being set to NULL is what tells the main event loop that this
+                            // is the Event Queue FD, rather than another FD that is being
+                            // monitored.
+    if (epoll_ctl(recPtr->epollFd, EPOLL_CTL_ADD, eventQueueFd, &ev) == -1)
+    {
+        LE_FATAL(   "epoll_ctl(ADD) failed for fd %d. errno = %d (%m)",
+                    eventQueueFd,
+                    errno);
+    }
+
+    // Let the threads that queue reports see the eventfd.  Reports queued before now couldn't
+    // wake this thread up, so if there are any, do it for them.  QueueReport() counts its report
+    // before it checks for the eventfd, and this checks the count after publishing the eventfd, so
+    // one or the other is sure to write to it.
+    __atomic_store_n(&recPtr->eventQueueFd, eventQueueFd, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&recPtr->eventQueue.count, __ATOMIC_SEQ_CST) > 0)
+    {
+        WriteEventFd(recPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the epoll(7) file descriptor of a thread's Event Loop.  It is created, along with the Event
+ * Queue's eventfd, the first time the thread needs it, so that threads that never run an Event
+ * Loop or monitor a file descriptor don't hold on to either.
+ *
+ * @warning Must only be called by the thread that owns the per-thread record.
+ *
+ * @return The file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+int event_GetEpollFd
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (perThreadRecPtr->epollFd == -1)
+    {
+        CreateFds(perThreadRecPtr);
+    }
+
+    return perThreadRecPtr->epollFd;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the Event Loop for a given thread.
@@ -838,36 +1172,20 @@ void event_InitThread
     event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
 
     // Initialize the various thread-specific lists and queues.
-    recPtr->eventQueue = LE_SLS_LIST_INIT;
+    InitQueue(&recPtr->eventQueue);
     recPtr->handlerList = LE_DLS_LIST_INIT;
     recPtr->fdMonitorList = LE_DLS_LIST_INIT;
 
-    // Create the epoll file descriptor for this thread.  This will be used to monitor for
-    // events on various file descriptors.
-    recPtr->epollFd = epoll_create1(0);
-    LE_FATAL_IF(recPtr->epollFd < 0, "epoll_create1(0) failed with errno %d (%m).", errno);
-
-    // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
-    // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
-    LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
-
-    // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
-    struct epoll_event ev;
-    memset(&ev, 0, sizeof(ev));
-    ev.events = EPOLLIN | EPOLLWAKEUP;
-    ev.data.ptr = NULL;     // This being set to NULL is what tells the main event loop that this
-                            // is the Event Queue FD, rather than another FD that is being
-                            // monitored.
-    if (epoll_ctl(recPtr->epollFd, EPOLL_CTL_ADD, recPtr->eventQueueFd, &ev) == -1)
-    {
-        LE_FATAL(   "epoll_ctl(ADD) failed for fd %d. errno = %d (%m)",
-                    recPtr->eventQueueFd,
-                    errno);
-    }
+    // The epoll fd and the eventfd are only created when the thread first needs them.
+    recPtr->epollFd = -1;
+    recPtr->eventQueueFd = -1;
 
     // Set the context pointer to NULL for safety's sake.
     recPtr->contextPtr = NULL;
+    recPtr->dispatchDepth = 0;
+
+    recPtr->liveEventCount = 0;
+    memset(&recPtr->stats, 0, sizeof(recPtr->stats));
 
     // Initialize the FD Monitor module's thread-specific stuff.
     fdMon_InitThread(recPtr);
@@ -946,7 +1264,7 @@ void event_DestructThread
     fdMon_DestructThread(perThreadRecPtr);
 
     // Discard everything on the Event Queue.
-    while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
+    while (NULL != (singleLinkPtr = PopFromQueue(&perThreadRecPtr->eventQueue)))
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
 
@@ -963,11 +1281,12 @@ void event_DestructThread
         le_mem_Release(reportPtr);
     }
 
-    // Close the epoll file descriptor.
-    fd_Close(perThreadRecPtr->epollFd);
-
-    // Close the eventfd for the Event Queue.
-    fd_Close(perThreadRecPtr->eventQueueFd);
+    // Close the epoll file descriptor and the eventfd for the Event Queue, if they were created.
+    if (perThreadRecPtr->epollFd != -1)
+    {
+        fd_Close(perThreadRecPtr->epollFd);
+        fd_Close(perThreadRecPtr->eventQueueFd);
+    }
 }
 
 
@@ -991,6 +1310,67 @@ void event_SetCurrentContextPtr
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time at which the calling thread's Event Loop called the handler or queued
+ * function that is running.
+ *
+ * @return  true if a handler or queued function is running, false if not (timePtr is not set).
+ */
+//--------------------------------------------------------------------------------------------------
+bool event_GetDispatchTime
+(
+    le_clk_Time_t* timePtr              ///< [out] Time at which the handler was called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
+
+    if (perThreadRecPtr->dispatchDepth == 0)
+    {
+        return false;
+    }
+
+    *timePtr = perThreadRecPtr->dispatchTime;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a handler's statistics after it has been called.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_RecordHandlerCall
+(
+    event_HandlerStats_t* statsPtr,     ///< [in] The handler's statistics.
+    le_clk_Time_t elapsed               ///< [in] Time spent in the call.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    statsPtr->callCount++;
+    statsPtr->totalTime = le_clk_Add(statsPtr->totalTime, elapsed);
+    if (le_clk_GreaterThan(elapsed, statsPtr->maxTime))
+    {
+        statsPtr->maxTime = elapsed;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the handler list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** event_GetHandlerListChgCntRef
+(
+    void
+)
+{
+    return (&HandlerListChangeCountRef);
+}
+
+
 // ==============================================
 //  PUBLIC API FUNCTIONS
 // ==============================================
@@ -1113,6 +1493,7 @@ le_event_HandlerRef_t le_event_AddLayeredHandler
     handlerPtr->contextPtr = NULL;
     handlerPtr->firstLayerFunc = firstLayerFunc;
     handlerPtr->secondLayerFunc = secondLayerFunc;
+    memset(&handlerPtr->stats, 0, sizeof(handlerPtr->stats));
     if (le_utf8_Copy(handlerPtr->name, name, sizeof(handlerPtr->name), NULL) == LE_OVERFLOW)
     {
         LE_WARN("Event handler name '%s' truncated to '%s'.", name, handlerPtr->name);
@@ -1120,6 +1501,7 @@ le_event_HandlerRef_t le_event_AddLayeredHandler
 
     // Put it on the Thread's Handler List.
     le_dls_Queue(&threadRecPtr->handlerList, &handlerPtr->threadLink);
+    HandlerListChangeCount++;
 
     // NOTE: We are about to access structures that are shared by multiple threads.
     // Protect this critical section using the mutex.
@@ -1221,11 +1603,7 @@ void le_event_Report
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
         memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
-
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        QueueReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1282,11 +1660,7 @@ void le_event_ReportWithRefCounting
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
-
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        QueueReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1366,11 +1740,7 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
-
     QueueFunction(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
-
-    Unlock(oldState);
 }
 
 
@@ -1389,11 +1759,7 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
-
     QueueFunction(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
-
-    Unlock(oldState);
 }
 
 
@@ -1417,7 +1783,7 @@ void le_event_RunLoop
 //--------------------------------------------------------------------------------------------------
 {
     event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
-    int epollFd = perThreadRecPtr->epollFd;
+    int epollFd = event_GetEpollFd(perThreadRecPtr);
     struct epoll_event epollEventList[MAX_EPOLL_EVENTS];
 
     // Make sure nobody calls this function more than once in the same thread.
@@ -1430,8 +1796,13 @@ void le_event_RunLoop
     for (;;)
     {
         // Wait for something to happen on one of the file descriptors that we are monitoring
-        // using our epoll fd.
-        int result = epoll_wait(epollFd, epollEventList, NUM_ARRAY_MEMBERS(epollEventList), -1);
+        // using our epoll fd.  If there are reports on the Event Queue already (because the report
+        // budget ran out, or reports were added while we were busy) just poll, so we can get back
+        // to processing them.  The eventfd is only written when the queue becomes non-empty, so
+        // waiting now could mean waiting forever.
+        int timeout = (GetQueueCount(perThreadRecPtr) > 0) ? 0 : -1;
+        fdMon_FlushUpdates(perThreadRecPtr);
+        int result = epoll_wait(epollFd, epollEventList, NUM_ARRAY_MEMBERS(epollEventList), timeout);
 
         // If something happened on one or more of the monitored file descriptors,
         if (result > 0)
@@ -1449,16 +1820,26 @@ void le_event_RunLoop
                 // Get the pointer that we registered with epoll_ctl(2) along with this fd.
                 // The value of this pointer will either be NULL or a Safe Reference for an
                 // FD Monitor object.  If it is NULL, then the Event Queue's eventfd is the
-                // fd that experienced the event.
+                // fd that experienced the event, so reset it.
                 void* safeRef = epollEventList[i].data.ptr;
 
                 if (safeRef != NULL)
                 {
                     fdMon_Report(safeRef, epollEventList[i].events);
                 }
+                else
+                {
+                    ReadEventFd(perThreadRecPtr);
+                }
             }
 
-            // Process all the Event Reports on the Event Queue.
+            // Process the Event Reports on the Event Queue.
+            ProcessEventReports(perThreadRecPtr);
+        }
+        // Otherwise, if we were just polling and nothing happened on the fds, carry on with the
+        // reports on the queue.
+        else if ((result == 0) && (timeout == 0))
+        {
             ProcessEventReports(perThreadRecPtr);
         }
         // Otherwise, if an epoll_wait() reported an error, hopefully it's just an interruption
@@ -1502,7 +1883,7 @@ int le_event_GetFd
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return thread_GetEventRecPtr()->epollFd;
+    return event_GetEpollFd(thread_GetEventRecPtr());
 }
 
 
@@ -1528,21 +1909,26 @@ le_result_t le_event_ServiceLoop
 //--------------------------------------------------------------------------------------------------
 {
     event_PerThreadRec_t* perThreadRecPtr = thread_GetEventRecPtr();
-    int epollFd = perThreadRecPtr->epollFd;
+    int epollFd = event_GetEpollFd(perThreadRecPtr);
     struct epoll_event epollEventList[MAX_EPOLL_EVENTS];
 
     LE_DEBUG("perThreadRecPtr->liveEventCount is" "%" PRIu64, perThreadRecPtr->liveEventCount);
 
     // If there are still live events remaining in the queue, process a single event, then return
+    // (after passing on any fd event flag changes made by the handler, as the caller is about to
+    // poll our epoll fd).
     if (perThreadRecPtr->liveEventCount > 0)
     {
         perThreadRecPtr->liveEventCount--;
         ProcessOneEventReport(perThreadRecPtr); // This function assumes the mutex is NOT locked.
+        fdMon_FlushUpdates(perThreadRecPtr);
         return LE_OK;
     }
 
     int result;
 
+    fdMon_FlushUpdates(perThreadRecPtr);
+
     do
     {
         // If no events on the queue, try to refill the event queue.
@@ -1575,13 +1961,18 @@ le_result_t le_event_ServiceLoop
             // Get the pointer that we registered with epoll_ctl(2) along with this fd.
             // The value of this pointer will either be NULL or a Safe Reference for an
             // FD Monitor object.  If it is NULL, then the Event Queue's eventfd is the
-            // fd that experienced the event, which we will deal with later in this function.
+            // fd that experienced the event, so reset it so epoll stops telling us about it
+            // until the queue goes from empty to non-empty again.
             void* safeRef = epollEventList[i].data.ptr;
 
             if (safeRef != NULL)
             {
                 fdMon_Report(safeRef, epollEventList[i].events);
             }
+            else
+            {
+                ReadEventFd(perThreadRecPtr);
+            }
         }
     }
     // Otherwise, check if an epoll_wait() reported an error.
@@ -1593,17 +1984,17 @@ le_result_t le_event_ServiceLoop
     // Otherwise, if epoll_wait() returned zero, then either this function was called without
     // waiting for the eventfd to be readable, or the eventfd was readable momentarily, but
     // something changed between the time the application code detected the readable condition
-    // and now that made the eventfd not readable anymore.
+    // and now that made the eventfd not readable anymore.  There may still be reports on the queue
+    // that were added while it wasn't empty, though, which won't have made the eventfd readable,
+    // so we must not report LE_WOULD_BLOCK while there are any.
     else
     {
         LE_DEBUG("epoll_wait() returned zero.");
-
-        return LE_WOULD_BLOCK;
     }
 
-    // Read the eventfd to reset it to zero so epoll stops telling us about it until more
-    // are added.
-    perThreadRecPtr->liveEventCount = ReadEventFd(perThreadRecPtr);
+    // Only the reports on the queue now are live.  Reports added after this will have to wait
+    // until these have been processed, so fds get checked in between.
+    perThreadRecPtr->liveEventCount = GetQueueCount(perThreadRecPtr);
 
     LE_DEBUG("perThreadRecPtr->liveEventCount is" "%" PRIu64, perThreadRecPtr->liveEventCount);
 
@@ -1612,6 +2003,7 @@ le_result_t le_event_ServiceLoop
     {
         perThreadRecPtr->liveEventCount--;
         ProcessOneEventReport(perThreadRecPtr);
+        fdMon_FlushUpdates(perThreadRecPtr);
         return LE_OK;
     }
     else
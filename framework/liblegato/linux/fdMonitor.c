@@ -29,6 +29,24 @@
  *      deleted and still has at least one of EPOLLIN or EPOLLOUT enabled.
  *  - When le_fdMonitor_Enable() is called for an FD Monitor from outside that FD Monitor's handler.
  *
+ * @section fdMonitor_Updates   Event Flag Updates
+ *
+ * le_fdMonitor_Enable(), le_fdMonitor_Disable(), etc. only change the FD Monitor's epoll(7) flags
+ * and put it on the thread's <b> FD Monitor Update List </b>.  The Event Loop calls
+ * fdMon_FlushUpdates() before it calls epoll_wait() (or returns to the code that polls its fd,
+ * see le_event_ServiceLoop()), which calls epoll_ctl() for each FD Monitor on the list whose
+ * flags are not the ones last given to epoll_ctl().  So flags flipped many times while handling
+ * events (e.g., POLLOUT by the messaging sessions) cost at most one system call, and none at all if
+ * they end up back where they were.  Events reported by epoll_wait() for flags that have been
+ * cleared in the meantime are masked out by DispatchToHandler().
+ *
+ * When the framework is built with @c LE_EVENT_LOOP_IO_URING (see
+ * @ref bld_cfg_event_loop_io_uring) and several FD Monitors have changed, the epoll_ctl() calls are
+ * instead submitted as IORING_OP_EPOLL_CTL operations through a per-thread io_uring(7) ring, so
+ * they all cost a single system call.  Readiness is still detected by epoll_wait(), so handlers
+ * see exactly the same events either way.  If the kernel doesn't support this, the thread falls
+ * back to plain epoll_ctl() calls.
+ *
  * @section fdMonitor_Threads Threads
  *
  * Only the thread that creates an FD Monitor is allowed to perform operations on that FD Monitor,
@@ -46,19 +64,27 @@
 #include "thread.h"
 #include "fdMonitor.h"
 #include "limit.h"
+#include "tracepoint.h"
 
 #include <pthread.h>
 
 
-/// Maximum number of bytes in a File Descriptor Monitor's name, including the null terminator.
-#define MAX_FD_MONITOR_NAME_BYTES  LIMIT_MAX_MEM_POOL_NAME_BYTES
-
 /// The number of objects in the process-wide FD Monitor Pool, from which all FD Monitor
 /// objects are allocated.
 /// @todo Make this configurable.
 #define DEFAULT_FD_MONITOR_POOL_SIZE 10
 
 
+#ifdef LE_EVENT_LOOP_IO_URING
+/// Number of entries in a thread's io_uring(7) submission ring, which is also the largest number
+/// of epoll_ctl() operations submitted with one system call.
+#define IO_URING_BATCH_SIZE 32
+
+/// Smallest number of changed FD Monitors for which the io_uring(7) ring is used.
+#define IO_URING_MIN_BATCH 2
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Thread-specific data key for the FD Monitor Ptr of the currently running fd event handler.
@@ -71,39 +97,21 @@ static pthread_key_t FDMonitorPtrKey;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * File Descriptor Monitor
+ * FD Monitor Pool
  *
- * These keep track of file descriptors that are being monitored by a particular thread.
- * They are allocated from a per-thread FD Monitor Sub-Pool and are kept on the thread's
- * FD Monitor List.  In addition, each has a Safe Reference created from the
- * FD Monitor Reference Map.
+ * This is the main pool of FD Monitor objects from which FD Monitor objects are allocated.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct FdMonitor
-{
-    le_dls_Link_t           link;               ///< Used to link onto a thread's FD Monitor List.
-    int                     fd;                 ///< File descriptor being monitored.
-    uint32_t                epollEvents;        ///< epoll(7) flags for events being monitored.
-    bool                    isAlwaysReady;      ///< Don't use epoll(7).  Treat as always ready.
-    le_fdMonitor_Ref_t safeRef;            ///< Safe Reference for this object.
-    event_PerThreadRec_t*   threadRecPtr;       ///< Ptr to per-thread data for monitoring thread.
-
-    le_fdMonitor_HandlerFunc_t  handlerFunc;    ///< Handler function.
-    void*                       contextPtr;     ///< The context pointer for this handler.
-
-    char        name[MAX_FD_MONITOR_NAME_BYTES];            ///< UTF-8 name of this object.
-}
-FdMonitor_t;
+static le_mem_PoolRef_t FdMonitorPool;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * FD Monitor Pool
- *
- * This is the main pool of FD Monitor objects from which FD Monitor objects are allocated.
+ * A counter that increments every time a change is made to a thread's FD Monitor List.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t FdMonitorPool;
+static size_t FdMonitorListChangeCount = 0;
+static size_t* FdMonitorListChangeCountRef = &FdMonitorListChangeCount;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -362,8 +370,16 @@ static void DeleteFdMonitor
 
     LE_ASSERT(perThreadRecPtr == fdMonitorPtr->threadRecPtr);
 
-    // Remove the FD Monitor from the thread's FD Monitor List.
+    // Remove the FD Monitor from the thread's FD Monitor List, and from its FD Monitor Update
+    // List if it has changes waiting to be passed to epoll(7).
     le_dls_Remove(&perThreadRecPtr->fdMonitorList, &fdMonitorPtr->link);
+    FdMonitorListChangeCount++;
+
+    if (fdMonitorPtr->isUpdatePending)
+    {
+        le_dls_Remove(&perThreadRecPtr->fdMonitorUpdateList, &fdMonitorPtr->updateLink);
+        fdMonitorPtr->isUpdatePending = false;
+    }
 
     LOCK
 
@@ -449,7 +465,12 @@ static void DispatchToHandler
     event_SetCurrentContextPtr(fdMonitorPtr->contextPtr);
 
     // Call the handler function.
+    TRACEPOINT_BEGIN("fd %s", fdMonitorPtr->name);
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
     fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, pollEvents);
+    event_RecordHandlerCall(&fdMonitorPtr->stats,
+                            le_clk_Sub(le_clk_GetRelativeTime(), startTime));
+    TRACEPOINT_END();
 
     // Clear the thread-specific pointer to the FD Monitor.
     LE_ASSERT(pthread_setspecific(FDMonitorPtrKey, NULL) == 0);
@@ -470,20 +491,15 @@ static void DispatchToHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Update the epoll(7) FD for a given FD Monitor object.
+ * Give an FD Monitor object's epoll(7) flags to the thread's epoll(7) FD.
  **/
 //--------------------------------------------------------------------------------------------------
-static void UpdateEpollFd
+static void WriteEpollEvents
 (
     FdMonitor_t*    monitorPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (monitorPtr->isAlwaysReady)
-    {
-        return;
-    }
-
     struct epoll_event ev;
     memset(&ev, 0, sizeof(ev));
     ev.events = monitorPtr->epollEvents;
@@ -509,7 +525,174 @@ static void UpdateEpollFd
                     errno);
         }
     }
+
+    monitorPtr->registeredEvents = monitorPtr->epollEvents;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the epoll(7) FD for a given FD Monitor object.  This is deferred until the thread goes
+ * back to its Event Loop (see fdMon_FlushUpdates()).
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateEpollFd
+(
+    FdMonitor_t*    monitorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((monitorPtr->isAlwaysReady) || (monitorPtr->isUpdatePending))
+    {
+        return;
+    }
+
+    le_dls_Queue(&monitorPtr->threadRecPtr->fdMonitorUpdateList, &monitorPtr->updateLink);
+    monitorPtr->isUpdatePending = true;
+}
+
+
+#ifdef LE_EVENT_LOOP_IO_URING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass the changes on the thread's FD Monitor Update List to epoll(7) as IORING_OP_EPOLL_CTL
+ * operations, submitted to the thread's io_uring(7) ring in batches of up to IO_URING_BATCH_SIZE
+ * with one system call per batch.
+ *
+ * Does nothing if fewer than IO_URING_MIN_BATCH FD Monitors have changed, or if the ring can't be
+ * used (e.g., the kernel doesn't support io_uring or IORING_OP_EPOLL_CTL), in which case the
+ * caller makes the epoll_ctl() calls itself.
+ *
+ * @return  true if the FD Monitor Update List has been flushed.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool FlushUpdatesThroughRing
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_List_t* listPtr = &perThreadRecPtr->fdMonitorUpdateList;
+    ioUring_Ring_t* ringPtr = &perThreadRecPtr->ioUring;
+    le_dls_Link_t* linkPtr;
+    size_t changedCount = 0;
+
+    if (perThreadRecPtr->isIoUringDisabled)
+    {
+        return false;
+    }
+
+    // A single epoll_ctl() call costs as much as the io_uring_enter() call would.
+    linkPtr = le_dls_Peek(listPtr);
+    while ((linkPtr != NULL) && (changedCount < IO_URING_MIN_BATCH))
+    {
+        FdMonitor_t* monitorPtr = CONTAINER_OF(linkPtr, FdMonitor_t, updateLink);
+
+        if (monitorPtr->epollEvents != monitorPtr->registeredEvents)
+        {
+            changedCount++;
+        }
+
+        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+    }
+
+    if (changedCount < IO_URING_MIN_BATCH)
+    {
+        return false;
+    }
+
+    // The ring is only created by threads that need it.
+    if (ringPtr->fd < 0)
+    {
+        le_result_t result = ioUring_Create(ringPtr, IO_URING_BATCH_SIZE);
+
+        if (result != LE_OK)
+        {
+            LE_INFO("io_uring not available (%s). Using epoll_ctl() for FD Monitor updates.",
+                    LE_RESULT_TXT(result));
+            perThreadRecPtr->isIoUringDisabled = true;
+            return false;
+        }
+    }
+
+    // The epoll_event structures only need to live until io_uring_enter() returns, because the
+    // kernel copies them when it consumes the submission queue entries.
+    struct epoll_event events[IO_URING_BATCH_SIZE];
+
+    for (;;)
+    {
+        size_t batchCount = 0;
+
+        while ((batchCount < IO_URING_BATCH_SIZE) && ((linkPtr = le_dls_Pop(listPtr)) != NULL))
+        {
+            FdMonitor_t* monitorPtr = CONTAINER_OF(linkPtr, FdMonitor_t, updateLink);
+
+            monitorPtr->isUpdatePending = false;
+
+            if (monitorPtr->epollEvents == monitorPtr->registeredEvents)
+            {
+                continue;
+            }
+
+            // The ring is empty between batches, and is as big as a batch.
+            struct io_uring_sqe* sqePtr = ioUring_GetSqe(ringPtr);
+            LE_ASSERT(sqePtr != NULL);
+
+            memset(&events[batchCount], 0, sizeof(events[batchCount]));
+            events[batchCount].events = monitorPtr->epollEvents;
+            events[batchCount].data.ptr = monitorPtr->safeRef;
+
+            sqePtr->opcode = IORING_OP_EPOLL_CTL;
+            sqePtr->fd = perThreadRecPtr->epollFd;
+            sqePtr->off = monitorPtr->fd;
+            sqePtr->len = EPOLL_CTL_MOD;
+            sqePtr->addr = (uintptr_t)&events[batchCount];
+            sqePtr->user_data = (uintptr_t)monitorPtr;
+
+            monitorPtr->registeredEvents = monitorPtr->epollEvents;
+
+            batchCount++;
+        }
+
+        if (batchCount == 0)
+        {
+            return true;
+        }
+
+        TRACE("Submitting %zu epoll_ctl() operations through io_uring.", batchCount);
+
+        // epoll_ctl() operations complete as they are submitted, so this doesn't block.
+        if (ioUring_Submit(ringPtr, batchCount) != LE_OK)
+        {
+            LE_FATAL("io_uring_enter() failed. errno = %d (%m).", errno);
+        }
+
+        struct io_uring_cqe* cqePtr;
+
+        while ((cqePtr = ioUring_PeekCqe(ringPtr)) != NULL)
+        {
+            FdMonitor_t* monitorPtr = (FdMonitor_t*)(uintptr_t)cqePtr->user_data;
+            int result = cqePtr->res;
+
+            ioUring_ConsumeCqe(ringPtr);
+
+            if (result < 0)
+            {
+                // Kernels older than 5.6 don't know IORING_OP_EPOLL_CTL.
+                if ((result == -EINVAL) || (result == -EOPNOTSUPP))
+                {
+                    LE_INFO("io_uring can't do epoll_ctl(). Using epoll_ctl() for FD Monitor"
+                            " updates.");
+                    perThreadRecPtr->isIoUringDisabled = true;
+                }
+
+                // Retry with epoll_ctl(), which also reports real failures the usual way.
+                WriteEpollEvents(monitorPtr);
+            }
+        }
+    }
 }
+#endif
 
 
 
@@ -563,6 +746,11 @@ void fdMon_InitThread
 //--------------------------------------------------------------------------------------------------
 {
     perThreadRecPtr->fdMonitorList = LE_DLS_LIST_INIT;
+    perThreadRecPtr->fdMonitorUpdateList = LE_DLS_LIST_INIT;
+#ifdef LE_EVENT_LOOP_IO_URING
+    perThreadRecPtr->ioUring = (ioUring_Ring_t)IO_URING_RING_INIT;
+    perThreadRecPtr->isIoUringDisabled = false;
+#endif
 }
 
 
@@ -585,6 +773,44 @@ void fdMon_Report
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass the changes made to the calling thread's FD Monitors' event flags since the last call to
+ * epoll(7).
+ *
+ * This is called by the Event Loop before it waits for fd events, so that many changes made to
+ * an FD Monitor while handling events result in at most one epoll_ctl() call.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_FlushUpdates
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+#ifdef LE_EVENT_LOOP_IO_URING
+    if (FlushUpdatesThroughRing(perThreadRecPtr))
+    {
+        return;
+    }
+#endif
+
+    while ((linkPtr = le_dls_Pop(&perThreadRecPtr->fdMonitorUpdateList)) != NULL)
+    {
+        FdMonitor_t* monitorPtr = CONTAINER_OF(linkPtr, FdMonitor_t, updateLink);
+
+        monitorPtr->isUpdatePending = false;
+
+        if (monitorPtr->epollEvents != monitorPtr->registeredEvents)
+        {
+            WriteEpollEvents(monitorPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete all FD Monitor objects for the calling thread.
@@ -605,6 +831,24 @@ void fdMon_DestructThread
         FdMonitor_t* fdMonitorPtr = CONTAINER_OF(linkPtr, FdMonitor_t, link);
         DeleteFdMonitor(fdMonitorPtr);
     }
+
+#ifdef LE_EVENT_LOOP_IO_URING
+    ioUring_Destroy(&perThreadRecPtr->ioUring);
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the FD Monitor list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** fdMon_GetFdMonitorListChgCntRef
+(
+    void
+)
+{
+    return (&FdMonitorListChangeCountRef);
 }
 
 
@@ -661,10 +905,14 @@ le_fdMonitor_Ref_t le_fdMonitor_Create
     fdMonitorPtr->link = LE_DLS_LINK_INIT;
     fdMonitorPtr->fd = fd;
     fdMonitorPtr->epollEvents = PollToEPoll(events) | EPOLLWAKEUP;  // Non-deferrable by default.
+    fdMonitorPtr->registeredEvents = fdMonitorPtr->epollEvents;
+    fdMonitorPtr->updateLink = LE_DLS_LINK_INIT;
+    fdMonitorPtr->isUpdatePending = false;
     fdMonitorPtr->isAlwaysReady = false;
     fdMonitorPtr->threadRecPtr = perThreadRecPtr;
     fdMonitorPtr->handlerFunc = handlerFunc;
     fdMonitorPtr->contextPtr = NULL;
+    memset(&fdMonitorPtr->stats, 0, sizeof(fdMonitorPtr->stats));
 
     // Copy the name into it.
     if (le_utf8_Copy(fdMonitorPtr->name, name, sizeof(fdMonitorPtr->name), NULL) == LE_OVERFLOW)
@@ -679,13 +927,14 @@ le_fdMonitor_Ref_t le_fdMonitor_Create
 
     // Add it to the thread's FD Monitor list.
     le_dls_Queue(&perThreadRecPtr->fdMonitorList, &fdMonitorPtr->link);
+    FdMonitorListChangeCount++;
 
     // Tell epoll(7) to start monitoring this fd.
     struct epoll_event ev;
     memset(&ev, 0, sizeof(ev));
     ev.events = fdMonitorPtr->epollEvents;
     ev.data.ptr = fdMonitorPtr->safeRef;
-    if (epoll_ctl(perThreadRecPtr->epollFd, EPOLL_CTL_ADD, fd, &ev) == -1)
+    if (epoll_ctl(event_GetEpollFd(perThreadRecPtr), EPOLL_CTL_ADD, fd, &ev) == -1)
     {
         if (errno == EPERM)
         {
@@ -886,6 +1135,49 @@ void le_fdMonitor_SetDeferrable
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets if events on a given fd are reported only when they happen (edge-triggered), in which case
+ * the handler must read or write until the fd would block, or for as long as their trigger
+ * condition is true (level-triggered, the default).
+ */
+//--------------------------------------------------------------------------------------------------
+void le_fdMonitor_SetEdgeTriggered
+(
+    le_fdMonitor_Ref_t monitorRef,      ///< [in] Reference to the File Descriptor Monitor object.
+    bool               isEdgeTriggered  ///< [in] true (edge-triggered) or false (level-triggered).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Look up the File Descriptor Monitor object using the safe reference provided.
+    // Note that the safe reference map is shared by all threads in the process, so it
+    // must be protected using the mutex.  The File Descriptor Monitor objects, on the other
+    // hand, are only allowed to be accessed by the one thread that created them, so it is
+    // safe to unlock the mutex after doing the safe reference lookup.
+    LOCK
+    FdMonitor_t* monitorPtr = le_ref_Lookup(FdMonitorRefMap, monitorRef);
+    UNLOCK
+
+    LE_FATAL_IF(monitorPtr == NULL, "File Descriptor Monitor %p doesn't exist!", monitorRef);
+    LE_FATAL_IF(thread_GetEventRecPtr() != monitorPtr->threadRecPtr,
+                "FD Monitor '%s' (fd %d) is owned by another thread.",
+                monitorPtr->name,
+                monitorPtr->fd);
+
+    // Set/clear the EPOLLET flag in the FD Monitor's epoll(7) flags set.
+    if (isEdgeTriggered)
+    {
+        monitorPtr->epollEvents |= EPOLLET;
+    }
+    else
+    {
+        monitorPtr->epollEvents &= ~EPOLLET;
+    }
+
+    UpdateEpollFd(monitorPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the Context Pointer for File Descriptor Monitor's handler function.  This can be retrieved
@@ -1014,3 +1306,4 @@ void le_fdMonitor_Delete
 
     DeleteFdMonitor(monitorPtr);
 }
+
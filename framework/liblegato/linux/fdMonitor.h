@@ -25,6 +25,43 @@
 #endif
 
 
+/// Maximum number of bytes in a File Descriptor Monitor's name, including the null terminator.
+#define MAX_FD_MONITOR_NAME_BYTES  LIMIT_MAX_MEM_POOL_NAME_BYTES
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File Descriptor Monitor
+ *
+ * These keep track of file descriptors that are being monitored by a particular thread.
+ * They are allocated from a per-thread FD Monitor Sub-Pool and are kept on the thread's
+ * FD Monitor List.  In addition, each has a Safe Reference created from the
+ * FD Monitor Reference Map.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct FdMonitor
+{
+    le_dls_Link_t           link;               ///< Used to link onto a thread's FD Monitor List.
+    int                     fd;                 ///< File descriptor being monitored.
+    uint32_t                epollEvents;        ///< epoll(7) flags for events being monitored.
+    uint32_t                registeredEvents;   ///< epoll(7) flags last given to epoll_ctl().
+    le_dls_Link_t           updateLink;         ///< Used to link onto a thread's FD Monitor
+                                                ///< Update List.
+    bool                    isUpdatePending;    ///< true if on the thread's FD Monitor Update List.
+    bool                    isAlwaysReady;      ///< Don't use epoll(7).  Treat as always ready.
+    le_fdMonitor_Ref_t      safeRef;            ///< Safe Reference for this object.
+    event_PerThreadRec_t*   threadRecPtr;       ///< Ptr to per-thread data for monitoring thread.
+
+    le_fdMonitor_HandlerFunc_t  handlerFunc;    ///< Handler function.
+    void*                       contextPtr;     ///< The context pointer for this handler.
+
+    char        name[MAX_FD_MONITOR_NAME_BYTES];            ///< UTF-8 name of this object.
+
+    event_HandlerStats_t    stats;              ///< Statistics for the inspect tool.
+}
+FdMonitor_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the FD Monitor module.
@@ -68,6 +105,21 @@ void fdMon_Report
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pass the changes made to the calling thread's FD Monitors' event flags since the last call to
+ * epoll(7).
+ *
+ * This is called by the Event Loop before it waits for fd events, so that many changes made to
+ * an FD Monitor while handling events result in at most one epoll_ctl() call.
+ */
+//--------------------------------------------------------------------------------------------------
+void fdMon_FlushUpdates
+(
+    event_PerThreadRec_t* perThreadRecPtr
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete all FD Monitor objects for the calling thread.
@@ -78,4 +130,18 @@ void fdMon_DestructThread
     event_PerThreadRec_t* perThreadRecPtr
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the FD Monitor list change counter; mainly for the Inspect tool.
+ *
+ * The counter is incremented each time an FD Monitor is added to or removed from any thread's
+ * FD Monitor List.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** fdMon_GetFdMonitorListChgCntRef
+(
+    void
+);
+
 #endif // LEGATO_FD_MONITOR_H_INCLUDE_GUARD
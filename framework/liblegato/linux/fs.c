@@ -35,11 +35,29 @@
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_fs_FileRef_t fileRef;  ///< The file reference to exchange with clients
-    int fd;                   ///< The file descriptor
+    le_fs_FileRef_t fileRef;        ///< The file reference to exchange with clients
+    int fd;                         ///< The file descriptor
+    uint8_t* writeBufPtr;           ///< Data not yet written to the file (NULL if unbuffered)
+    size_t writeBufLen;             ///< Number of bytes waiting in the write buffer
+    size_t writeBufThreshold;       ///< Buffered data is written out before it exceeds this size
+    le_fs_SyncPolicy_t syncPolicy;  ///< When to sync the file to storage
+    bool needsSync;                 ///< Data was written to the file since it was last synced
 }
 File_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle on the directory of the most recently opened file, so that opening more files in the
+ * same directory doesn't walk the whole path again.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[PATH_MAX];    ///< Directory path relative to the prefix, with a trailing '/'.
+    int fd;                 ///< O_PATH descriptor of the directory, or -1 if nothing is cached.
+}
+DirCache_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Default prefixes path used by the daemon. If NULL, the daemon will reject all open/rename/delete
@@ -62,6 +80,21 @@ static le_mem_PoolRef_t FsFileRefPool;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t FsFileRefMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool to store the write buffers of buffered files
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FsWriteBufferPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cached directory handle, and the mutex that protects it.
+ */
+//--------------------------------------------------------------------------------------------------
+static DirCache_t DirCache = { .path = "", .fd = -1 };
+static pthread_mutex_t DirCacheMutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mutex.
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function adds the prefix to the filePath to access
@@ -134,6 +167,192 @@ static le_result_t MkDirTree
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forgets the cached directory handle.  Must be called whenever a directory may have been moved or
+ * removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateDirCache
+(
+    void
+)
+{
+    LE_ASSERT(0 == pthread_mutex_lock(&DirCacheMutex));
+
+    if (-1 != DirCache.fd)
+    {
+        close(DirCache.fd);
+        DirCache.fd = -1;
+    }
+    DirCache.path[0] = '\0';
+
+    LE_ASSERT(0 == pthread_mutex_unlock(&DirCacheMutex));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a handle on the directory a file is in, creating the directory tree if needed.  The handle
+ * is cached, so it must not be closed by the caller.
+ *
+ * @note DirCacheMutex must be held by the caller for as long as the handle is used.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_OVERFLOW       The directory path is too long.
+ *  - LE_NOT_FOUND      A directory in the path does not exist
+ *  - LE_NOT_PERMITTED  Access denied to a directory in the path
+ *  - LE_UNSUPPORTED    The prefix cannot be added and the function is unusable
+ *  - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetDirFd
+(
+    const char* filePathPtr,  ///< [IN]  File path
+    size_t dirLen,            ///< [IN]  Length of the directory part of the path, including the '/'
+    bool create,              ///< [IN]  Create the directories that don't exist
+    int* fdPtr                ///< [OUT] Directory handle
+)
+{
+    char path[PATH_MAX];
+    int fd;
+
+    if ((-1 != DirCache.fd) &&
+        (dirLen == strlen(DirCache.path)) &&
+        (0 == strncmp(DirCache.path, filePathPtr, dirLen)))
+    {
+        *fdPtr = DirCache.fd;
+        return LE_OK;
+    }
+
+    if (NULL == FsPrefixPtr)
+    {
+        return LE_UNSUPPORTED;
+    }
+    if ((dirLen >= sizeof(DirCache.path)) ||
+        (snprintf(path, sizeof(path), "%s%.*s", FsPrefixPtr, (int)dirLen, filePathPtr)
+            >= (int)sizeof(path)))
+    {
+        return LE_OVERFLOW;
+    }
+
+    fd = open(path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if ((-1 == fd) && (ENOENT == errno) && create)
+    {
+        if (LE_OK != MkDirTree(filePathPtr))
+        {
+            return LE_FAULT;
+        }
+        fd = open(path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    }
+
+    if (-1 == fd)
+    {
+        if (ENOENT == errno)
+        {
+            return LE_NOT_FOUND;
+        }
+        else if (EACCES == errno)
+        {
+            return LE_NOT_PERMITTED;
+        }
+        return LE_FAULT;
+    }
+
+    if (-1 != DirCache.fd)
+    {
+        close(DirCache.fd);
+    }
+    memcpy(DirCache.path, filePathPtr, dirLen);
+    DirCache.path[dirLen] = '\0';
+    DirCache.fd = fd;
+
+    *fdPtr = fd;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Syncs the data written to a file to storage, if there is any.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncFile
+(
+    File_t* filePtr     ///< [IN] File to sync
+)
+{
+    if (!filePtr->needsSync)
+    {
+        return LE_OK;
+    }
+
+    if (-1 == fdatasync(filePtr->fd))
+    {
+        LE_ERROR("Failed to sync descriptor %d: %m", filePtr->fd);
+        return LE_FAULT;
+    }
+
+    filePtr->needsSync = false;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out the data waiting in the write buffer of a file.  Whatever could not be written stays
+ * in the buffer.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushWriteBuffer
+(
+    File_t* filePtr     ///< [IN] File to flush
+)
+{
+    size_t writtenLen = 0;
+    le_result_t result = LE_OK;
+
+    while (writtenLen < filePtr->writeBufLen)
+    {
+        ssize_t rc = write(filePtr->fd,
+                           filePtr->writeBufPtr + writtenLen,
+                           filePtr->writeBufLen - writtenLen);
+        if (rc > 0)
+        {
+            writtenLen += rc;
+        }
+        else if ((-1 == rc) && (EINTR == errno))
+        {
+            continue;
+        }
+        else
+        {
+            LE_ERROR("Failed to write buffered data to descriptor %d: %m", filePtr->fd);
+            result = LE_FAULT;
+            break;
+        }
+    }
+
+    if (writtenLen > 0)
+    {
+        filePtr->writeBufLen -= writtenLen;
+        memmove(filePtr->writeBufPtr, filePtr->writeBufPtr + writtenLen, filePtr->writeBufLen);
+        filePtr->needsSync = true;
+    }
+
+    if ((LE_OK == result) && (LE_FS_SYNC_ON_FLUSH == filePtr->syncPolicy))
+    {
+        result = SyncFile(filePtr);
+    }
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor function that runs when a file ref is deallocated
@@ -150,6 +369,11 @@ static void FsFileRefDestructor
     {
         // Release the reference
         le_ref_DeleteRef(FsFileRefMap, filePtr->fileRef);
+
+        if (NULL != filePtr->writeBufPtr)
+        {
+            le_mem_Release(filePtr->writeBufPtr);
+        }
     }
 }
 
@@ -179,8 +403,11 @@ le_result_t le_fs_Open
 )
 {
     mode_t mode = 0;
-    int fd;
-    char path[PATH_MAX];
+    int fd = -1;
+    int dirFd;
+    int openErrno = 0;
+    const char* baseNamePtr;
+    le_result_t result;
 
     // Check whether input is null. filePathPtr can be null as it is a pointer (i.e. pointer to
     // const char).
@@ -236,21 +463,33 @@ le_result_t le_fs_Open
         mode |= O_SYNC;
     }
 
-    if ((mode & O_CREAT) && (LE_OK != MkDirTree(filePathPtr)))
+    // Open the file relative to its directory, which is usually already cached.
+    baseNamePtr = strrchr(filePathPtr, '/') + 1;
+
+    LE_ASSERT(0 == pthread_mutex_lock(&DirCacheMutex));
+    result = GetDirFd(filePathPtr, baseNamePtr - filePathPtr, (mode & O_CREAT), &dirFd);
+    if (LE_OK == result)
     {
-        return LE_FAULT;
+        fd = openat(dirFd, ('\0' == *baseNamePtr) ? "." : baseNamePtr, mode, S_IRUSR | S_IWUSR);
+        openErrno = errno;
     }
+    LE_ASSERT(0 == pthread_mutex_unlock(&DirCacheMutex));
 
-    if (NULL == BuildPathName(path, PATH_MAX, filePathPtr))
+    if (LE_OK != result)
     {
-        return LE_UNSUPPORTED;
+        return result;
     }
 
-    fd = open(path, mode, S_IRUSR | S_IWUSR);
+    errno = openErrno;
     if (-1 < fd)
     {
         File_t* tmpFilePtr = le_mem_ForceAlloc(FsFileRefPool);
         tmpFilePtr->fd = fd;
+        tmpFilePtr->writeBufPtr = NULL;
+        tmpFilePtr->writeBufLen = 0;
+        tmpFilePtr->writeBufThreshold = 0;
+        tmpFilePtr->syncPolicy = LE_FS_SYNC_NEVER;
+        tmpFilePtr->needsSync = false;
         tmpFilePtr->fileRef = le_ref_CreateRef(FsFileRefMap, tmpFilePtr);
         *fileRefPtr = (le_fs_FileRef_t)(tmpFilePtr->fileRef);
         return LE_OK;
@@ -271,7 +510,9 @@ le_result_t le_fs_Open
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is called to close an opened file.
+ * This function is called to close an opened file.  Buffered data is written out first.
+ *
+ * @note The file is closed even if its buffered data could not be written out.
  *
  * @return
  *  - LE_OK         The function succeeded.
@@ -284,6 +525,7 @@ le_result_t le_fs_Close
 )
 {
     File_t* filePtr;
+    le_result_t result = LE_OK;
     int rc;
 
     filePtr = le_ref_Lookup(FsFileRefMap, fileRef);
@@ -291,6 +533,16 @@ le_result_t le_fs_Close
     {
         return LE_BAD_PARAMETER;
     }
+
+    if (NULL != filePtr->writeBufPtr)
+    {
+        result = FlushWriteBuffer(filePtr);
+    }
+    if ((LE_OK == result) && (LE_FS_SYNC_NEVER != filePtr->syncPolicy))
+    {
+        result = SyncFile(filePtr);
+    }
+
     rc = close(filePtr->fd);
     if (!rc)
     {
@@ -300,7 +552,103 @@ le_result_t le_fs_Close
     {
         LE_ERROR("Failed to close descriptor %d: %m", filePtr->fd);
     }
-    return (!rc) ? LE_OK : LE_FAULT;
+    return ((!rc) && (LE_OK == result)) ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to set up write buffering and the sync policy of an opened file.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_FAULT          The data already buffered could not be written out.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_SetWriteBuffer
+(
+    le_fs_FileRef_t fileRef,        ///< [IN] File reference
+    size_t bufferSize,              ///< [IN] Write buffer size, 0 to disable buffering
+    le_fs_SyncPolicy_t syncPolicy   ///< [IN] When to sync the file to storage
+)
+{
+    File_t* filePtr;
+
+    filePtr = le_ref_Lookup(FsFileRefMap, fileRef);
+    if (NULL == filePtr)
+    {
+        LE_ERROR("fileRef is invalid");
+        return LE_BAD_PARAMETER;
+    }
+    if (bufferSize > LE_FS_WRITE_BUFFER_MAX_SIZE)
+    {
+        LE_ERROR("Write buffer size %zu is larger than %d", bufferSize,
+                 LE_FS_WRITE_BUFFER_MAX_SIZE);
+        return LE_BAD_PARAMETER;
+    }
+    if ((LE_FS_SYNC_NEVER != syncPolicy) &&
+        (LE_FS_SYNC_ON_FLUSH != syncPolicy) &&
+        (LE_FS_SYNC_ON_CLOSE != syncPolicy))
+    {
+        LE_ERROR("Wrong sync policy %d", syncPolicy);
+        return LE_BAD_PARAMETER;
+    }
+
+    // Write out what was buffered with the old settings.
+    if ((NULL != filePtr->writeBufPtr) && (LE_OK != FlushWriteBuffer(filePtr)))
+    {
+        return LE_FAULT;
+    }
+
+    if ((0 == bufferSize) && (NULL != filePtr->writeBufPtr))
+    {
+        le_mem_Release(filePtr->writeBufPtr);
+        filePtr->writeBufPtr = NULL;
+    }
+    else if ((0 != bufferSize) && (NULL == filePtr->writeBufPtr))
+    {
+        filePtr->writeBufPtr = le_mem_ForceAlloc(FsWriteBufferPool);
+    }
+
+    filePtr->writeBufThreshold = bufferSize;
+    filePtr->syncPolicy = syncPolicy;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called to write out the data buffered for an opened file.  The file is then
+ * synced to storage if its sync policy is LE_FS_SYNC_ON_FLUSH.
+ *
+ * @return
+ *  - LE_OK             The function succeeded.
+ *  - LE_BAD_PARAMETER  A parameter is invalid.
+ *  - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_fs_Flush
+(
+    le_fs_FileRef_t fileRef     ///< [IN] File reference
+)
+{
+    File_t* filePtr;
+
+    filePtr = le_ref_Lookup(FsFileRefMap, fileRef);
+    if (NULL == filePtr)
+    {
+        LE_ERROR("fileRef is invalid");
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL != filePtr->writeBufPtr)
+    {
+        return FlushWriteBuffer(filePtr);
+    }
+    if (LE_FS_SYNC_ON_FLUSH == filePtr->syncPolicy)
+    {
+        return SyncFile(filePtr);
+    }
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -349,6 +697,13 @@ le_result_t le_fs_Read
     {
         return LE_BAD_PARAMETER;
     }
+
+    // Buffered data must reach the file before reading it back.
+    if ((0 != filePtr->writeBufLen) && (LE_OK != FlushWriteBuffer(filePtr)))
+    {
+        return LE_FAULT;
+    }
+
     do
     {
         rc = read(filePtr->fd, bufPtr, *bufNumElementsPtr);
@@ -407,6 +762,26 @@ le_result_t le_fs_Write
         return LE_OK;
     }
 
+    if (NULL != filePtr->writeBufPtr)
+    {
+        if (filePtr->writeBufLen + bufNumElements > filePtr->writeBufThreshold)
+        {
+            le_result_t result = FlushWriteBuffer(filePtr);
+            if (LE_OK != result)
+            {
+                return result;
+            }
+        }
+
+        // Data that doesn't fill the buffer waits there; anything larger is written straight out.
+        if (bufNumElements < filePtr->writeBufThreshold)
+        {
+            memcpy(filePtr->writeBufPtr + filePtr->writeBufLen, bufPtr, bufNumElements);
+            filePtr->writeBufLen += bufNumElements;
+            return LE_OK;
+        }
+    }
+
     do
     {
         rc = write(filePtr->fd, bufPtr, bufNumElements);
@@ -417,11 +792,16 @@ le_result_t le_fs_Write
     {
         return LE_FAULT;
     }
+    filePtr->needsSync = true;
 
     if (rc != bufNumElements)
     {
         return LE_UNDERFLOW;
     }
+    if (LE_FS_SYNC_ON_FLUSH == filePtr->syncPolicy)
+    {
+        return SyncFile(filePtr);
+    }
     return LE_OK;
 }
 
@@ -476,6 +856,13 @@ le_result_t le_fs_Seek
     {
         return LE_BAD_PARAMETER;
     }
+
+    // Buffered data goes at the position it was written at, not where the file is seeked to.
+    if ((0 != filePtr->writeBufLen) && (LE_OK != FlushWriteBuffer(filePtr)))
+    {
+        return LE_FAULT;
+    }
+
     rc = lseek(filePtr->fd, (off_t)offset, whence);
 
     if (-1 == rc)
@@ -688,6 +1075,9 @@ le_result_t le_fs_RemoveDirRecursive
         return LE_UNSUPPORTED;
     }
 
+    // The cached directory may be in the tree being removed.
+    InvalidateDirCache();
+
     return le_dir_RemoveRecursive(path);
 }
 
@@ -757,6 +1147,9 @@ le_result_t le_fs_Move
         return LE_UNSUPPORTED;
     }
 
+    // A directory may be moved, leaving the cached handle pointing at its new location.
+    InvalidateDirCache();
+
     rc = rename(srcPath, destPath);
     if ((-1 == rc) && (ENOENT == errno))
     {
@@ -844,6 +1237,8 @@ end:
     le_mem_ExpandPool (FsFileRefPool, FS_MAX_FILE_REF);
     le_mem_SetDestructor(FsFileRefPool, FsFileRefDestructor);
 
+    FsWriteBufferPool = le_mem_CreatePool("FsWriteBufferPool", LE_FS_WRITE_BUFFER_MAX_SIZE);
+
     // Create the Safe Reference Map to use for data profile object Safe References.
     FsFileRefMap = le_ref_CreateMap("FsFileRefMap", FS_MAX_FILE_REF);
 }
@@ -140,6 +140,594 @@ static inline bool EqualKeys
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of old buckets moved into the new bucket array by each step of an incremental
+ * rehash.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REHASH_BUCKETS_PER_STEP 2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of empty old buckets skipped over by each step of an incremental rehash.  This
+ * bounds the time taken by a step when the old bucket array is sparse.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REHASH_EMPTY_BUCKETS_PER_STEP 16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the map's buckets may be rearranged right now.
+ *
+ * Entries must not be moved between buckets while the map is being iterated over, because the
+ * iterator (or le_hashmap_ForEach) keeps its position as a bucket index and a link in that
+ * bucket's list.
+ *
+ * @param map A pointer to the hashmap instance
+ * @return  Returns true if the buckets may be rearranged
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsRehashAllowed(Hashmap_t* map) {
+    return (!map->isIterating) && (map->forEachDepth == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total number of buckets in the map, counting the old bucket array too if a rehash is
+ * in progress.  Old buckets come first, so a bucket index in this range can be passed to
+ * GetBucket().
+ *
+ * @param map A pointer to the hashmap instance
+ * @return  Returns the number of buckets
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t GetTotalBucketCount(Hashmap_t* map) {
+    return map->oldBucketCount + map->bucketCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a bucket by its index in the range returned by GetTotalBucketCount().
+ *
+ * @param map A pointer to the hashmap instance
+ * @param index The bucket index
+ * @return  Returns a pointer to the bucket's list of entries
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_dls_List_t* GetBucket(Hashmap_t* map, size_t index) {
+    if (index < map->oldBucketCount) {
+        return &(map->oldBucketsPtr[index]);
+    }
+    return &(map->bucketsPtr[index - map->oldBucketCount]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a bucket array with all buckets empty.
+ *
+ * @param bucketCount The number of buckets
+ * @return  Returns a pointer to the bucket array
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t* CreateBuckets(size_t bucketCount) {
+    // It is ok to use malloc here: bucket arrays are only created when a map is created or grows,
+    // and their size depends on the map's contents.
+    le_dls_List_t* bucketsPtr = malloc(bucketCount * sizeof(le_dls_List_t));
+    LE_ASSERT(bucketsPtr);
+
+    size_t i;
+    for (i = 0; i < bucketCount; i++)
+    {
+        bucketsPtr[i] = LE_DLS_LIST_INIT;
+    }
+
+    return bucketsPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Invalidates the map's iterator, so that its next move starts again from the beginning of the
+ * map.  This must be done whenever the buckets are rearranged.
+ *
+ * @param map A pointer to the hashmap instance
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetIterator(Hashmap_t* map) {
+    map->iteratorPtr->isValueValid = false;
+    map->iteratorPtr->currentIndex = -1;
+    map->iteratorPtr->currentListPtr = NULL;
+    map->iteratorPtr->currentLinkPtr = NULL;
+    map->iteratorPtr->currentEntryPtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a few old buckets' entries into the new bucket array, if a rehash is in progress.
+ * When the last old bucket has been moved, the old bucket array is freed.
+ *
+ * Spreading the rehash over a number of calls means that no single call to the API has to move
+ * every entry in the map.
+ *
+ * @param map A pointer to the hashmap instance
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RehashStep(Hashmap_t* map) {
+    if ((map->oldBucketsPtr == NULL) || !IsRehashAllowed(map)) {
+        return;
+    }
+
+    ResetIterator(map);
+
+    size_t movedCount = 0;
+    size_t emptyCount = 0;
+
+    while ((map->rehashIndex < map->oldBucketCount) &&
+           (movedCount < REHASH_BUCKETS_PER_STEP) &&
+           (emptyCount < REHASH_EMPTY_BUCKETS_PER_STEP))
+    {
+        le_dls_List_t* oldListPtr = &(map->oldBucketsPtr[map->rehashIndex]);
+        le_dls_Link_t* theLinkPtr = le_dls_Pop(oldListPtr);
+
+        if (theLinkPtr == NULL) {
+            emptyCount++;
+        }
+        else {
+            while (theLinkPtr != NULL) {
+                Entry_t* entryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+                size_t index = CalculateIndex(map->bucketCount, entryPtr->hash);
+
+                le_dls_Queue(&(map->bucketsPtr[index]), theLinkPtr);
+
+                theLinkPtr = le_dls_Pop(oldListPtr);
+            }
+            movedCount++;
+        }
+
+        map->rehashIndex++;
+    }
+
+    if (map->rehashIndex == map->oldBucketCount) {
+        free(map->oldBucketsPtr);
+        map->oldBucketsPtr = NULL;
+        map->oldBucketCount = 0;
+        map->rehashIndex = 0;
+
+        HASHMAP_TRACE(
+            map,
+            "Hashmap %s: Rehash complete, bucket count now %zu",
+            map->nameStr,
+            map->bucketCount
+        );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts growing the map if it has become too full.  The map doubles its bucket count, and the
+ * entries in the old buckets are then moved across by RehashStep() a few buckets at a time.
+ *
+ * @param map A pointer to the hashmap instance
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowIfNeeded(Hashmap_t* map) {
+    // Keep to the same 0.75 load factor that the map was created with.  Only one rehash can be
+    // in progress at a time; RehashStep() moves buckets fast enough that the previous one will
+    // normally be finished long before the map is full again.
+    if ((map->oldBucketsPtr != NULL) ||
+        (map->size <= (map->bucketCount * 3 / 4)) ||
+        !IsRehashAllowed(map))
+    {
+        return;
+    }
+
+    ResetIterator(map);
+
+    map->oldBucketsPtr = map->bucketsPtr;
+    map->oldBucketCount = map->bucketCount;
+    map->rehashIndex = 0;
+
+    map->bucketCount *= 2;
+    map->bucketsPtr = CreateBuckets(map->bucketCount);
+
+    HASHMAP_TRACE(
+        map,
+        "Hashmap %s: Growing to %zu buckets for %zu entries",
+        map->nameStr,
+        map->bucketCount,
+        map->size
+    );
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the entry for a key, in the new bucket array and, if a rehash is in progress, in the
+ * old bucket array.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param keyPtr A pointer to the key to look up
+ * @param hash The hash of the key
+ * @param listHeadPtrPtr If not NULL, set to the bucket holding the entry, if it is found
+ * @return  Returns a pointer to the entry, or NULL if the key is not in the map
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* FindEntry
+(
+    Hashmap_t* map,
+    const void* keyPtr,
+    size_t hash,
+    le_dls_List_t** listHeadPtrPtr
+)
+{
+    size_t index = CalculateIndex(map->bucketCount, hash);
+    le_dls_List_t* listHeadPtr = &(map->bucketsPtr[index]);
+
+    HASHMAP_TRACE(
+        map,
+        "Hashmap %s: Generated index of %zu for hash %zu",
+        map->nameStr,
+        index,
+        hash
+    );
+
+    // Old buckets below the rehash index have already been emptied into the new array.
+    size_t oldIndex = 0;
+    bool checkOld = false;
+    if (map->oldBucketsPtr != NULL) {
+        oldIndex = CalculateIndex(map->oldBucketCount, hash);
+        checkOld = (oldIndex >= map->rehashIndex);
+    }
+
+    while (true) {
+        HASHMAP_TRACE(
+            map,
+            "Hashmap %s: Looked up list contains %zu links",
+            map->nameStr,
+            le_dls_NumLinks(listHeadPtr)
+        );
+
+        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+
+        while (theLinkPtr != NULL) {
+            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+            if (EqualKeys(currentEntryPtr->keyPtr,
+                              currentEntryPtr->hash,
+                              keyPtr,
+                              hash,
+                              map->equalsFuncPtr)
+                              )
+            {
+                if (listHeadPtrPtr != NULL) {
+                    *listHeadPtrPtr = listHeadPtr;
+                }
+                return currentEntryPtr;
+            }
+            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        }
+
+        if (!checkOld) {
+            return NULL;
+        }
+
+        listHeadPtr = &(map->oldBucketsPtr[oldIndex]);
+        checkOld = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Control byte values for the slots of a flat hashmap.  A slot holding an entry has a control
+ * byte with the top bit clear, holding 7 bits of the entry's hash (see FlatHashTag()).
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLAT_CTRL_EMPTY     0x80    ///< Slot has never held an entry since the last rehash.
+#define FLAT_CTRL_DELETED   0xFE    ///< Slot held an entry that has since been removed.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest number of slots in a flat hashmap.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLAT_MIN_SLOT_COUNT 8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a flat hashmap slot's control byte shows that the slot holds an entry.
+ *
+ * @param ctrl The control byte
+ * @return  Returns true if the slot holds an entry
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool FlatIsFull(uint8_t ctrl) {
+    return ((ctrl & 0x80) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the slot at which to start probing for a hash in a flat hashmap.  The hash is spread by a
+ * Fibonacci multiply and the top bits are used, so that keys which differ only in their high bits
+ * (e.g. pointers) still land on different slots.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param hash The hash to use
+ * @return  Returns the index of the first slot to probe
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t FlatHomeIndex(Hashmap_t* map, size_t hash) {
+    return (size_t)(((uint64_t)hash * UINT64_C(0x9E3779B97F4A7C15)) >> map->slotShift);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the 7-bit tag stored in the control byte of a slot holding an entry with a given hash.
+ * Comparing tags first means the key itself is only looked at (and the equality function only
+ * called) for about 1 in 128 of the other entries probed past.
+ *
+ * @param hash The hash to use
+ * @return  Returns the tag
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t FlatHashTag(size_t hash) {
+    return (uint8_t)(hash & 0x7F);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates the slot and control byte arrays of a flat hashmap, with every slot empty.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param slotCount The number of slots (must be a power of 2)
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlatAllocSlots(Hashmap_t* map, size_t slotCount) {
+    // Both arrays are allocated as a single block, slots first to keep them aligned.
+    map->slotsPtr = malloc(slotCount * (sizeof(FlatSlot_t) + sizeof(uint8_t)));
+    LE_ASSERT(map->slotsPtr);
+    map->ctrlPtr = (uint8_t*)(map->slotsPtr + slotCount);
+    memset(map->ctrlPtr, FLAT_CTRL_EMPTY, slotCount);
+
+    map->bucketCount = slotCount;
+    map->deletedCount = 0;
+
+    map->slotShift = 64;
+    while (slotCount > 1) {
+        map->slotShift--;
+        slotCount >>= 1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the slot holding a key in a flat hashmap.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param keyPtr A pointer to the key to look up
+ * @param hash The hash of the key
+ * @return  Returns the index of the slot, or -1 if the key is not in the map
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t FlatFind(Hashmap_t* map, const void* keyPtr, size_t hash) {
+    size_t mask = map->bucketCount - 1;
+    size_t index = FlatHomeIndex(map, hash);
+    uint8_t tag = FlatHashTag(hash);
+
+    // There is always at least one empty slot, so this terminates.
+    while (map->ctrlPtr[index] != FLAT_CTRL_EMPTY) {
+        if (map->ctrlPtr[index] == tag) {
+            const void* slotKeyPtr = map->slotsPtr[index].keyPtr;
+            if ((slotKeyPtr == keyPtr) || map->equalsFuncPtr(slotKeyPtr, keyPtr)) {
+                return (ssize_t)index;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores an entry in a flat hashmap that is known not to already hold the key, in the first free
+ * slot along the key's probe sequence.  Does not update the map's size.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param keyPtr A pointer to the key
+ * @param hash The hash of the key
+ * @param valuePtr A pointer to the value
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlatInsertNew(Hashmap_t* map, const void* keyPtr, size_t hash, const void* valuePtr) {
+    size_t mask = map->bucketCount - 1;
+    size_t index = FlatHomeIndex(map, hash);
+
+    while (FlatIsFull(map->ctrlPtr[index])) {
+        index = (index + 1) & mask;
+    }
+
+    if (map->ctrlPtr[index] == FLAT_CTRL_DELETED) {
+        map->deletedCount--;
+    }
+
+    map->ctrlPtr[index] = FlatHashTag(hash);
+    map->slotsPtr[index].keyPtr = keyPtr;
+    map->slotsPtr[index].valuePtr = valuePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rebuilds a flat hashmap's slot array, dropping the deleted slot markers and, if the map is
+ * more than about half full, doubling the number of slots.
+ *
+ * @param map A pointer to the hashmap instance
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlatRehash(Hashmap_t* map) {
+    FlatSlot_t* oldSlotsPtr = map->slotsPtr;
+    uint8_t* oldCtrlPtr = map->ctrlPtr;
+    size_t oldSlotCount = map->bucketCount;
+
+    size_t newSlotCount = oldSlotCount;
+    if (map->size >= (oldSlotCount * 3 / 8)) {
+        newSlotCount *= 2;
+    }
+
+    FlatAllocSlots(map, newSlotCount);
+
+    size_t i;
+    for (i = 0; i < oldSlotCount; i++) {
+        if (FlatIsFull(oldCtrlPtr[i])) {
+            const void* keyPtr = oldSlotsPtr[i].keyPtr;
+            FlatInsertNew(map, keyPtr, HashKey(map, keyPtr), oldSlotsPtr[i].valuePtr);
+        }
+    }
+
+    free(oldSlotsPtr);
+
+    HASHMAP_TRACE(
+        map,
+        "Hashmap %s: Rehashed %zu entries into %zu slots",
+        map->nameStr,
+        map->size,
+        map->bucketCount
+    );
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure a flat hashmap has room for one more entry.
+ *
+ * The map is rehashed once its used and deleted slots pass a 0.75 load factor.  While the map is
+ * being iterated over, the rehash is held off until the map is 7/8 full, as it moves entries to
+ * different slots.  Past that, the rehash is done anyway and the iterator is reset.
+ *
+ * @param map A pointer to the hashmap instance
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlatReserve(Hashmap_t* map) {
+    size_t usedCount = map->size + map->deletedCount + 1;
+
+    if (usedCount <= (map->bucketCount * 3 / 4)) {
+        return;
+    }
+
+    if (!IsRehashAllowed(map)) {
+        if (usedCount < (map->bucketCount * 7 / 8)) {
+            return;
+        }
+
+        LE_WARN("Hashmap %s: Rehashing during an iteration.", map->nameStr);
+    }
+
+    ResetIterator(map);
+    FlatRehash(map);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a flat hashmap's iterator to the next slot holding an entry, starting at a given slot.
+ *
+ * @param iteratorRef The iterator
+ * @param index The slot to start looking at
+ * @return  Returns LE_OK if an entry was found, otherwise LE_NOT_FOUND
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlatNextNode(le_hashmap_It_Ref_t iteratorRef, int32_t index) {
+    Hashmap_t* map = iteratorRef->theMapPtr;
+
+    for (; index < (int32_t)map->bucketCount; index++) {
+        if (FlatIsFull(map->ctrlPtr[index])) {
+            iteratorRef->currentIndex = index;
+            iteratorRef->isValueValid = true;
+            return LE_OK;
+        }
+    }
+
+    // At the end without finding another entry, need to invalidate the iterator
+    iteratorRef->currentIndex = (int32_t)map->bucketCount;
+    iteratorRef->isValueValid = false;
+    map->isIterating = false;
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a flat hashmap's iterator to the previous slot holding an entry, starting at a given
+ * slot.
+ *
+ * @param iteratorRef The iterator
+ * @param index The slot to start looking at
+ * @return  Returns LE_OK if an entry was found, otherwise LE_NOT_FOUND
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlatPrevNode(le_hashmap_It_Ref_t iteratorRef, int32_t index) {
+    Hashmap_t* map = iteratorRef->theMapPtr;
+
+    for (; index >= 0; index--) {
+        if (FlatIsFull(map->ctrlPtr[index])) {
+            iteratorRef->currentIndex = index;
+            iteratorRef->isValueValid = true;
+            return LE_OK;
+        }
+    }
+
+    // At the beginning, without finding another entry, need to invalidate the iterator.
+    iteratorRef->isValueValid = false;
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the key and value of the first entry in a flat hashmap at or after a given slot.
+ *
+ * @param map A pointer to the hashmap instance
+ * @param index The slot to start looking at
+ * @param keyPtrPtr Set to the entry's key
+ * @param valuePtrPtr If not NULL, set to the entry's value
+ * @return  Returns LE_OK if an entry was found, otherwise LE_NOT_FOUND
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlatGetNodeFrom
+(
+    Hashmap_t* map,
+    size_t index,
+    void** keyPtrPtr,
+    void** valuePtrPtr
+)
+{
+    for (; index < map->bucketCount; index++) {
+        if (FlatIsFull(map->ctrlPtr[index])) {
+            *keyPtrPtr = (void*)map->slotsPtr[index].keyPtr;
+            if (valuePtrPtr != NULL) {
+                *valuePtrPtr = (void*)map->slotsPtr[index].valuePtr;
+            }
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a HashMap
@@ -193,21 +781,75 @@ le_hashmap_Ref_t le_hashmap_Create
                                                                mapRef->bucketCount / 2);
     le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
 
-    mapRef->bucketsPtr = malloc(mapRef->bucketCount * sizeof(le_dls_List_t));
-    LE_ASSERT(mapRef->bucketsPtr);
-    mapRef->chainLengthPtr = malloc(mapRef->bucketCount * sizeof(size_t));
-    LE_ASSERT(mapRef->chainLengthPtr);
-    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
-    LE_ASSERT(mapRef->iteratorPtr);
+    mapRef->bucketsPtr = CreateBuckets(mapRef->bucketCount);
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
+
+    mapRef->oldBucketsPtr = NULL;
+    mapRef->oldBucketCount = 0;
+    mapRef->rehashIndex = 0;
+    mapRef->isIterating = false;
+    mapRef->forEachDepth = 0;
+
+    mapRef->isFlat = false;
+    mapRef->slotsPtr = NULL;
+    mapRef->ctrlPtr = NULL;
+    mapRef->deletedCount = 0;
+    mapRef->slotShift = 0;
+
+    mapRef->size = 0;
+
+    mapRef->hashFuncPtr = hashFunc;
+    mapRef->equalsFuncPtr = equalsFunc;
+    mapRef->nameStr = nameStr;
+
+    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
+    mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->isValueValid = true;
+
+    return mapRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a flat HashMap, which keeps its keys and values in a single array of slots instead of in
+ * a list per bucket.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateFlat
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    LE_ASSERT(hashFunc);
+    LE_ASSERT(equalsFunc);
+
+    // It is ok to use malloc here as we will not be destroying the map
+    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
+    LE_ASSERT(mapRef);
+    memset(mapRef, 0, sizeof(Hashmap_t));
 
-    uint32_t i = 0;
-    for (i=0; i<mapRef->bucketCount; i++)
-    {
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
+    mapRef->traceRef = NULL;
+    mapRef->isFlat = true;
+
+    // Same 0.75 load factor as the chained map, counting deleted slots as used.
+    size_t minimumSlotCount = capacity * 4 / 3;
+    size_t slotCount = FLAT_MIN_SLOT_COUNT;
+    while (slotCount <= minimumSlotCount) {
+        // Slot count must be power of 2.
+        slotCount <<= 1;
     }
+    FlatAllocSlots(mapRef, slotCount);
 
-    mapRef->size = 0;
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
 
     mapRef->hashFuncPtr = hashFunc;
     mapRef->equalsFuncPtr = equalsFunc;
@@ -237,98 +879,77 @@ void* le_hashmap_Put
     const void* valuePtr       ///< [in] Pointer to the value to be stored
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        (int)hash
-    );
-
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-
-    if (le_dls_NumLinks(listHeadPtr) == 0)
+    if (mapRef->isFlat)
     {
-        Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-        LE_ASSERT(newEntryPtr);
+        size_t hash = HashKey(mapRef, keyPtr);
+        ssize_t index = FlatFind(mapRef, keyPtr, hash);
+
+        // Replace existing value if the key is already in the map.
+        if (index >= 0)
+        {
+            const void* oldValue = mapRef->slotsPtr[index].valuePtr;
+            mapRef->slotsPtr[index].valuePtr = valuePtr;
+            return (void *)oldValue;
+        }
 
-        le_dls_Stack(listHeadPtr, &(newEntryPtr->entryListLink));
+        FlatReserve(mapRef);
+        FlatInsertNew(mapRef, keyPtr, hash, valuePtr);
         mapRef->size++;
 
         HASHMAP_TRACE(
             mapRef,
-            "Hashmap %s: Added first entry to bucket. Total map size now %zu",
+            "Hashmap %s: Added entry. Map size now %zu",
             mapRef->nameStr,
             mapRef->size
         );
 
-        mapRef->chainLengthPtr[index]++;
-
         return NULL;
     }
-    else
-    {
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
-        while (true) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+    RehashStep(mapRef);
 
-            // Replace existing value if the keys match.
-            if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-            {
-                const void* oldValue = currentEntryPtr->valuePtr;
-                currentEntryPtr->valuePtr = valuePtr;
+    size_t hash = HashKey(mapRef, keyPtr);
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
+    // Replace existing value if the key is already in the map.
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, hash, NULL);
+    if (currentEntryPtr != NULL)
+    {
+        const void* oldValue = currentEntryPtr->valuePtr;
+        currentEntryPtr->valuePtr = valuePtr;
 
-                return (void *)oldValue;
-            }
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
+            mapRef->nameStr,
+            mapRef->size
+        );
 
-            // Add a new entry if we are at the tail
-            if (le_dls_PeekNext(listHeadPtr, theLinkPtr) == NULL) {
-                Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-                LE_ASSERT(newEntryPtr);
+        return (void *)oldValue;
+    }
 
-                le_dls_Queue(listHeadPtr, &(newEntryPtr->entryListLink));
-                mapRef->size++;
+    // Otherwise add a new entry at the tail of its bucket.  New entries always go into the new
+    // bucket array, even if a rehash is in progress.
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Added entry to bucket at tail. Map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
+    Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
+    LE_ASSERT(newEntryPtr);
 
-                mapRef->chainLengthPtr[index]++;
+    le_dls_Queue(listHeadPtr, &(newEntryPtr->entryListLink));
+    mapRef->size++;
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Bucket now contains %zu entries (%zu)",
-                    mapRef->nameStr,
-                    le_dls_NumLinks(listHeadPtr),
-                    mapRef->chainLengthPtr[index]
-                );
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Added entry to bucket %zu, which now contains %zu entries. Map size now %zu",
+        mapRef->nameStr,
+        index,
+        le_dls_NumLinks(listHeadPtr),
+        mapRef->size
+    );
 
-                return NULL;
-            }
+    GrowIfNeeded(mapRef);
 
-            // Move to next entry.
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-        }
-    }
+    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -346,43 +967,24 @@ void* le_hashmap_Get
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (mapRef->isFlat)
+    {
+        ssize_t index = FlatFind(mapRef, keyPtr, HashKey(mapRef, keyPtr));
+        return (index < 0) ? NULL : (void*)(mapRef->slotsPtr[index].valuePtr);
+    }
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+    RehashStep(mapRef);
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Returning found value for key",
-                mapRef->nameStr
-            );
-            return (void*)(currentEntryPtr->valuePtr);
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+    if (currentEntryPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning found value for key",
+            mapRef->nameStr
+        );
+        return (void*)(currentEntryPtr->valuePtr);
     }
 
     HASHMAP_TRACE(
@@ -408,43 +1010,24 @@ void* le_hashmap_GetStoredKey
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved.
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (mapRef->isFlat)
+    {
+        ssize_t index = FlatFind(mapRef, keyPtr, HashKey(mapRef, keyPtr));
+        return (index < 0) ? NULL : (void*)(mapRef->slotsPtr[index].keyPtr);
+    }
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+    RehashStep(mapRef);
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Returning original key",
-                mapRef->nameStr
-            );
-            return (void*)(currentEntryPtr->keyPtr);
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+    if (currentEntryPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning original key",
+            mapRef->nameStr
+        );
+        return (void*)(currentEntryPtr->keyPtr);
     }
 
     HASHMAP_TRACE(
@@ -473,50 +1056,64 @@ void* le_hashmap_Remove
    const void* keyPtr       ///< [in] Pointer to the key to be removed
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (mapRef->isFlat)
+    {
+        ssize_t index = FlatFind(mapRef, keyPtr, HashKey(mapRef, keyPtr));
+        if (index < 0)
+        {
+            return NULL;
+        }
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        // Entries are never moved on removal, so an iteration in progress is not disturbed.
+        if (mapRef->iteratorPtr->currentIndex == index)
+        {
+            mapRef->iteratorPtr->isValueValid = false;
+        }
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        // If the next slot is empty, no probe sequence continues past this one, so it can be
+        // made empty too.  Otherwise it must be marked deleted so that lookups probe past it.
+        size_t nextIndex = ((size_t)index + 1) & (mapRef->bucketCount - 1);
+        if (mapRef->ctrlPtr[nextIndex] == FLAT_CTRL_EMPTY)
         {
-            if (mapRef->iteratorPtr->currentLinkPtr == theLinkPtr)
-            {
-                le_hashmap_PrevNode(mapRef->iteratorPtr);
-                mapRef->iteratorPtr->isValueValid = false;
-            }
+            mapRef->ctrlPtr[index] = FLAT_CTRL_EMPTY;
+        }
+        else
+        {
+            mapRef->ctrlPtr[index] = FLAT_CTRL_DELETED;
+            mapRef->deletedCount++;
+        }
+        mapRef->size--;
 
-            void* value = (void*)(currentEntryPtr->valuePtr);
-            le_dls_Remove(listHeadPtr, theLinkPtr);
-            le_mem_Release( currentEntryPtr );
-            mapRef->size--;
-            mapRef->chainLengthPtr[index]--;
+        return (void*)(mapRef->slotsPtr[index].valuePtr);
+    }
 
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Removing key from map",
-                mapRef->nameStr
-            );
+    RehashStep(mapRef);
 
-            return value;
+    le_dls_List_t* listHeadPtr;
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), &listHeadPtr);
+
+    if (currentEntryPtr != NULL)
+    {
+        le_dls_Link_t* theLinkPtr = &(currentEntryPtr->entryListLink);
+
+        if (mapRef->iteratorPtr->currentLinkPtr == theLinkPtr)
+        {
+            le_hashmap_PrevNode(mapRef->iteratorPtr);
+            mapRef->iteratorPtr->isValueValid = false;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+
+        void* value = (void*)(currentEntryPtr->valuePtr);
+        le_dls_Remove(listHeadPtr, theLinkPtr);
+        le_mem_Release( currentEntryPtr );
+        mapRef->size--;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Removing key from map",
+            mapRef->nameStr
+        );
+
+        return value;
     }
 
     HASHMAP_TRACE(
@@ -577,38 +1174,22 @@ bool le_hashmap_ContainsKey
     const void* keyPtr        ///< [in] Pointer to the key to be searched for
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (mapRef->isFlat)
+    {
+        return (FlatFind(mapRef, keyPtr, HashKey(mapRef, keyPtr)) >= 0);
+    }
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    RehashStep(mapRef);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Key found",
-                mapRef->nameStr
-            );
+    if (FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL) != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key found",
+            mapRef->nameStr
+        );
 
-            return true;
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        return true;
     }
 
     HASHMAP_TRACE(
@@ -635,15 +1216,20 @@ void le_hashmap_RemoveAll
 )
 {
     // Reset the iterator
-    mapRef->iteratorPtr->isValueValid = false;
-    mapRef->iteratorPtr->currentIndex = -1;
-    mapRef->iteratorPtr->currentListPtr = NULL;
-    mapRef->iteratorPtr->currentLinkPtr = NULL;
-    mapRef->iteratorPtr->currentEntryPtr = NULL;
+    ResetIterator(mapRef);
+    mapRef->isIterating = false;
+
+    if (mapRef->isFlat)
+    {
+        memset(mapRef->ctrlPtr, FLAT_CTRL_EMPTY, mapRef->bucketCount);
+        mapRef->deletedCount = 0;
+        mapRef->size = 0;
+        return;
+    }
 
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
+    size_t i;
+    for (i = 0; i < GetTotalBucketCount(mapRef); i++) {
+        le_dls_List_t* listHeadPtr = GetBucket(mapRef, i);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         while (theLinkPtr != NULL) {
@@ -653,11 +1239,18 @@ void le_hashmap_RemoveAll
             le_dls_Remove(listHeadPtr, linkPtrToRemove);
             le_mem_Release( currentEntryPtr );
         }
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
+        *listHeadPtr = LE_DLS_LIST_INIT;
     }
     mapRef->size=0;
 
+    // With nothing left to move, any rehash in progress is finished.
+    if (mapRef->oldBucketsPtr != NULL) {
+        free(mapRef->oldBucketsPtr);
+        mapRef->oldBucketsPtr = NULL;
+        mapRef->oldBucketCount = 0;
+        mapRef->rehashIndex = 0;
+    }
+
     HASHMAP_TRACE(
        mapRef,
        "Hashmap %s: All entries deleted from map",
@@ -682,29 +1275,60 @@ bool le_hashmap_ForEach
     void* context                            ///< [in] Pointer to a context to be supplied to the callback
 )
 {
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
+    bool result = true;
+    size_t i;
+
+    // Hold off rehashing while the callback runs, in case it looks things up in the map.
+    mapRef->forEachDepth++;
+
+    if (mapRef->isFlat)
+    {
+        for (i = 0; i < mapRef->bucketCount; i++) {
+            if (FlatIsFull(mapRef->ctrlPtr[i]) &&
+                !forEachFn(mapRef->slotsPtr[i].keyPtr, mapRef->slotsPtr[i].valuePtr, context))
+            {
+                // Despite stopping early, all elements may have been examined.
+                void* keyPtr;
+                result = (FlatGetNodeFrom(mapRef, i + 1, &keyPtr, NULL) != LE_OK);
+                break;
+            }
+        }
+
+        mapRef->forEachDepth--;
+        return result;
+    }
+
+    for (i = 0; (i < GetTotalBucketCount(mapRef)) && result; i++) {
+        le_dls_List_t* listHeadPtr = GetBucket(mapRef, i);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         while (theLinkPtr != NULL) {
             Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
             if (!forEachFn(currentEntryPtr->keyPtr, currentEntryPtr->valuePtr, context)) {
                 // Check to see if this is the last element, and return false if not.
-                if (le_dls_PeekNext(listHeadPtr, theLinkPtr) != NULL) { return false; }
-                uint32_t j;
-                for (j = i; j < mapRef->bucketCount; ++j)
+                if (le_dls_PeekNext(listHeadPtr, theLinkPtr) != NULL) {
+                    result = false;
+                    break;
+                }
+                size_t j;
+                for (j = i; j < GetTotalBucketCount(mapRef); ++j)
                 {
-                    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[j]);
-                    if (le_dls_Peek(listHeadPtr)) { return false; }
+                    if (le_dls_Peek(GetBucket(mapRef, j))) {
+                        result = false;
+                        break;
+                    }
                 }
-                return true;   // Despite stopping early, all elements have been examined.
+                // Despite stopping early, all elements have been examined.
+                i = GetTotalBucketCount(mapRef);
+                break;
             }
             theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
         }
     }
 
-    return true;
+    mapRef->forEachDepth--;
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -726,6 +1350,8 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 {
     // Set the counter to -1 so that we know the iterator is at the start
     mapRef->iteratorPtr->currentIndex = -1;
+    // Hold off rehashing until the iteration reaches the end of the map
+    mapRef->isIterating = true;
     // Mark the iterator as valid
     mapRef->iteratorPtr->isValueValid = true;
 
@@ -753,9 +1379,15 @@ le_result_t le_hashmap_NextNode
     if (le_hashmap_isEmpty(iteratorRef->theMapPtr))
     {
         iteratorRef->isValueValid = false;
+        iteratorRef->theMapPtr->isIterating = false;
         return LE_NOT_FOUND;
     }
 
+    if (iteratorRef->theMapPtr->isFlat)
+    {
+        return FlatNextNode(iteratorRef, iteratorRef->currentIndex + 1);
+    }
+
     le_dls_Link_t* theLinkPtr = NULL;
 
     // -1 indicates the iterator is new
@@ -769,10 +1401,11 @@ le_result_t le_hashmap_NextNode
         // Find the next list head
         for (
                iteratorRef->currentIndex = iteratorRef->currentIndex + 1;
-               iteratorRef->currentIndex < iteratorRef->theMapPtr->bucketCount;
+               iteratorRef->currentIndex < GetTotalBucketCount(iteratorRef->theMapPtr);
                iteratorRef->currentIndex++ )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucket(iteratorRef->theMapPtr,
+                                                   iteratorRef->currentIndex);
             theLinkPtr = le_dls_Peek(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -809,6 +1442,7 @@ le_result_t le_hashmap_NextNode
 
     // At the end without finding another entry, need to invalidate the iterator
     iteratorRef->isValueValid = false;
+    iteratorRef->theMapPtr->isIterating = false;
     return LE_NOT_FOUND;
 }
 
@@ -840,8 +1474,19 @@ le_result_t le_hashmap_PrevNode
         return LE_NOT_FOUND;
     }
 
-    le_dls_Link_t* theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr,
-                                                iteratorRef->currentLinkPtr);
+    if (iteratorRef->theMapPtr->isFlat)
+    {
+        return FlatPrevNode(iteratorRef, iteratorRef->currentIndex - 1);
+    }
+
+    le_dls_Link_t* theLinkPtr = NULL;
+
+    // If the iterator has gone past the end of the map then step back onto the last entry,
+    // otherwise check if the current entry is at the start of a list.
+    if (iteratorRef->currentIndex < (int32_t)GetTotalBucketCount(iteratorRef->theMapPtr))
+    {
+        theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
+    }
 
     if (NULL == theLinkPtr)
     {
@@ -851,7 +1496,8 @@ le_result_t le_hashmap_PrevNode
                iteratorRef->currentIndex >= 0;
                iteratorRef->currentIndex-- )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucket(iteratorRef->theMapPtr,
+                                                   iteratorRef->currentIndex);
             theLinkPtr = le_dls_PeekTail(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -907,6 +1553,11 @@ const void* le_hashmap_GetKey
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (iteratorRef->theMapPtr->isFlat)
+    {
+        return iteratorRef->theMapPtr->slotsPtr[iteratorRef->currentIndex].keyPtr;
+    }
+
     return iteratorRef->currentEntryPtr->keyPtr;
 }
 
@@ -926,6 +1577,11 @@ void* le_hashmap_GetValue
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
     // Need to cast away the const
+    if (iteratorRef->theMapPtr->isFlat)
+    {
+        return (void*)iteratorRef->theMapPtr->slotsPtr[iteratorRef->currentIndex].valuePtr;
+    }
+
     return (void*)iteratorRef->currentEntryPtr->valuePtr;
 }
 
@@ -962,14 +1618,19 @@ le_result_t le_hashmap_GetFirstNode
         return LE_BAD_PARAMETER;
     }
 
+    if (mapRef->isFlat)
+    {
+        return FlatGetNodeFrom(mapRef, 0, firstKeyPtr, firstValuePtr);
+    }
+
     // Find the first list head
     size_t index = 0;
     for (
            ;
-           index < mapRef->bucketCount;
+           index < GetTotalBucketCount(mapRef);
            index++ )
     {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+        le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         if (NULL != theLinkPtr)
@@ -1017,78 +1678,75 @@ le_result_t le_hashmap_GetNodeAfter
 
     // Find the node pointed to by the key
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+    if (mapRef->isFlat)
+    {
+        ssize_t index = FlatFind(mapRef, keyPtr, hash);
+        if (index < 0)
+        {
+            // The original key was never found
+            return LE_BAD_PARAMETER;
+        }
+        return FlatGetNodeFrom(mapRef, (size_t)index + 1, nextKeyPtr, nextValuePtr);
+    }
+    le_dls_List_t* listHeadPtr;
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, hash, &listHeadPtr);
+
+    if (currentEntryPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Found value for key",
+            mapRef->nameStr
+        );
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        // Work out where the bucket holding the key is in the iteration order.
+        size_t index;
+        if ((mapRef->oldBucketsPtr != NULL) &&
+            (listHeadPtr >= mapRef->oldBucketsPtr) &&
+            (listHeadPtr < mapRef->oldBucketsPtr + mapRef->oldBucketCount))
+        {
+            index = listHeadPtr - mapRef->oldBucketsPtr;
+        }
+        else
+        {
+            index = mapRef->oldBucketCount + (listHeadPtr - mapRef->bucketsPtr);
+        }
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        // Now find the next node, if there is one
+        le_dls_Link_t* theLinkPtr = le_dls_PeekNext(listHeadPtr,
+                                                    &(currentEntryPtr->entryListLink));
+        if (NULL == theLinkPtr)
         {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Found value for key",
-                mapRef->nameStr
-            );
-            // Now find the next node, if there is one
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            if (NULL == theLinkPtr)
+            // Find the next list head
+            for (
+                   index++;
+                   index < GetTotalBucketCount(mapRef);
+                   index++ )
             {
-                // Find the next list head
-                for (
-                       index++;
-                       index < mapRef->bucketCount;
-                       index++ )
+                listHeadPtr = GetBucket(mapRef, index);
+                theLinkPtr = le_dls_Peek(listHeadPtr);
+
+                if (NULL != theLinkPtr)
                 {
-                    listHeadPtr = &(mapRef->bucketsPtr[index]);
-                    theLinkPtr = le_dls_Peek(listHeadPtr);
-
-                    if (NULL != theLinkPtr)
-                    {
-                        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                        *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                        if (NULL != nextValuePtr)
-                        {
-                            *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                        }
-                        return LE_OK;
-                    }
+                    break;
                 }
-                // There was no list head - we are off the end of the map
-                return LE_NOT_FOUND;
             }
-            else
+
+            if (NULL == theLinkPtr)
             {
-                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                if (NULL != nextValuePtr)
-                {
-                    *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                }
-                return LE_OK;
+                // There was no list head - we are off the end of the map
+                return LE_NOT_FOUND;
             }
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+
+        currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+        *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
+        if (NULL != nextValuePtr)
+        {
+            *nextValuePtr = (void *)currentEntryPtr->valuePtr;
+        }
+        return LE_OK;
     }
 
     // The original key was never found
@@ -1112,9 +1770,22 @@ size_t le_hashmap_CountCollisions
 )
 {
     size_t i, collCount = 0;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        if (mapRef->chainLengthPtr[i] > 1) {
-            collCount += mapRef->chainLengthPtr[i] - 1;
+
+    // In a flat map, count the entries that could not be stored in their first choice of slot.
+    if (mapRef->isFlat) {
+        for (i = 0; i < mapRef->bucketCount; i++) {
+            if (FlatIsFull(mapRef->ctrlPtr[i]) &&
+                (FlatHomeIndex(mapRef, HashKey(mapRef, mapRef->slotsPtr[i].keyPtr)) != i)) {
+                collCount++;
+            }
+        }
+        return collCount;
+    }
+
+    for (i = 0; i < GetTotalBucketCount(mapRef); i++) {
+        size_t chainLength = le_dls_NumLinks(GetBucket(mapRef, i));
+        if (chainLength > 1) {
+            collCount += chainLength - 1;
         }
     }
     return collCount;
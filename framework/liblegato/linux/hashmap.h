@@ -34,7 +34,17 @@ typedef struct le_hashmap_It {
 HashmapIt_t;
 
 /**
- *  The hashmap itself
+ * A slot in a flat hashmap
+ */
+typedef struct {
+    const void* keyPtr;
+    const void* valuePtr;
+}
+FlatSlot_t;
+
+/**
+ *  The hashmap itself.  In a flat map (created by le_hashmap_CreateFlat()), bucketCount is the
+ *  number of slots and the bucket and entry pool fields are unused.
  */
 typedef struct le_hashmap {
     size_t bucketCount;
@@ -43,7 +53,16 @@ typedef struct le_hashmap {
     size_t size;
     le_mem_PoolRef_t entryPoolRef;
     le_dls_List_t* bucketsPtr;
-    size_t* chainLengthPtr;
+    le_dls_List_t* oldBucketsPtr;   ///< Buckets being rehashed into bucketsPtr, or NULL if none.
+    size_t oldBucketCount;          ///< Number of buckets in oldBucketsPtr (0 if none).
+    size_t rehashIndex;             ///< Next old bucket to be moved into bucketsPtr.
+    bool isIterating;               ///< true while the map's iterator is part-way through it.
+    uint32_t forEachDepth;          ///< Number of le_hashmap_ForEach() calls in progress.
+    bool isFlat;                    ///< true if the map uses open addressing.
+    FlatSlot_t* slotsPtr;           ///< Flat map's entries, one per slot.
+    uint8_t* ctrlPtr;               ///< Flat map's control byte for each slot.
+    size_t deletedCount;            ///< Number of flat map slots marked deleted.
+    unsigned int slotShift;         ///< 64 - log2 of the flat map's slot count.
     const char* nameStr;
     HashmapIt_t* iteratorPtr;
     le_log_TraceRef_t traceRef;
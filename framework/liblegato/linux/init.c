@@ -8,11 +8,14 @@
 #include "legato.h"
 
 #include "mem.h"
+#include "arena.h"
 #include "hashmap.h"
 #include "safeRef.h"
 #include "messaging.h"
 #include "log.h"
 #include "thread.h"
+#include "threadPool.h"
+#include "coro.h"
 #include "signals.h"
 #include "eventLoop.h"
 #include "timer.h"
@@ -23,6 +26,7 @@
 #include "pipeline.h"
 #include "atomFile.h"
 #include "fs.h"
+#include "cfgSnapshot.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -52,6 +56,7 @@ __attribute__((constructor)) void _legato_InitFramework
 
     mem_Init();
     log_Init();        // Uses memory pools.
+    arena_Init();      // Uses memory pools.
     sig_Init();        // Uses memory pools.
     safeRef_Init();    // Uses memory pools and hash maps.
     pathIter_Init();   // Uses memory pools and safe references.
@@ -59,6 +64,8 @@ __attribute__((constructor)) void _legato_InitFramework
     sem_Init();        // Uses memory pools.
     thread_Init();     // Uses memory pools and safe references.
     event_Init();      // Uses thread API.
+    threadPool_Init(); // Uses memory pools.
+    coro_Init();       // Uses memory pools.
     timer_Init();      // Uses event loop.
     msg_Init();        // Uses event loop.
     kill_Init();       // Uses memory pools and timers.
@@ -67,6 +74,7 @@ __attribute__((constructor)) void _legato_InitFramework
     pipeline_Init();   // Uses memory pools and FD Monitors.
     atomFile_Init();   // Uses memory pools.
     fs_Init();         // Uses memory pools and safe references.
+    cfgSnapshot_Init(); // Uses memory pools.
 
     // This must be called last, because it calls several subsystems to perform the
     // thread-specific initialization for the main thread.
@@ -0,0 +1,303 @@
+//--------------------------------------------------------------------------------------------------
+/** @file ioUring.c
+ *
+ * Minimal io_uring(7) ring wrapper.  See ioUring.h.
+ *
+ * The rings are shared with the kernel, so the indexes the kernel writes (the submission ring head
+ * and the completion ring tail) are read with acquire semantics, and the ones we write (the
+ * submission ring tail and the completion ring head) are written with release semantics.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "ioUring.h"
+#include "fileDescriptor.h"
+
+#ifdef LE_EVENT_LOOP_IO_URING
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * io_uring_setup(2) system call.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Setup
+(
+    unsigned int numEntries,
+    struct io_uring_params* paramsPtr
+)
+{
+    return (int)syscall(__NR_io_uring_setup, numEntries, paramsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * io_uring_enter(2) system call.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Enter
+(
+    int fd,
+    unsigned int toSubmit,
+    unsigned int minComplete,
+    unsigned int flags
+)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an io_uring(7) instance and map its rings.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_IMPLEMENTED if the kernel doesn't support io_uring (or it is not allowed).
+ *      - LE_FAULT on any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ioUring_Create
+(
+    ioUring_Ring_t* ringPtr,        ///< [out] Ring to initialize.
+    unsigned int    numEntries      ///< [in] Number of submission queue entries.
+)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ringPtr, 0, sizeof(*ringPtr));
+
+    ringPtr->fd = Setup(numEntries, &params);
+    if (ringPtr->fd < 0)
+    {
+        if ((errno == ENOSYS) || (errno == EPERM))
+        {
+            return LE_NOT_IMPLEMENTED;
+        }
+
+        LE_ERROR("io_uring_setup() failed. errno = %d (%m).", errno);
+        return LE_FAULT;
+    }
+
+    ringPtr->numEntries = params.sq_entries;
+    ringPtr->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ringPtr->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ringPtr->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Newer kernels map both rings with a single mmap().
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ringPtr->cqRingSize > ringPtr->sqRingSize)
+        {
+            ringPtr->sqRingSize = ringPtr->cqRingSize;
+        }
+        ringPtr->cqRingSize = ringPtr->sqRingSize;
+    }
+
+    ringPtr->sqRingPtr = mmap(NULL, ringPtr->sqRingSize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ringPtr->fd, IORING_OFF_SQ_RING);
+    if (ringPtr->sqRingPtr == MAP_FAILED)
+    {
+        goto mapFailed;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ringPtr->cqRingPtr = ringPtr->sqRingPtr;
+    }
+    else
+    {
+        ringPtr->cqRingPtr = mmap(NULL, ringPtr->cqRingSize, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, ringPtr->fd, IORING_OFF_CQ_RING);
+        if (ringPtr->cqRingPtr == MAP_FAILED)
+        {
+            munmap(ringPtr->sqRingPtr, ringPtr->sqRingSize);
+            goto mapFailed;
+        }
+    }
+
+    ringPtr->sqesPtr = mmap(NULL, ringPtr->sqesSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ringPtr->fd, IORING_OFF_SQES);
+    if (ringPtr->sqesPtr == MAP_FAILED)
+    {
+        if (ringPtr->cqRingPtr != ringPtr->sqRingPtr)
+        {
+            munmap(ringPtr->cqRingPtr, ringPtr->cqRingSize);
+        }
+        munmap(ringPtr->sqRingPtr, ringPtr->sqRingSize);
+        goto mapFailed;
+    }
+
+    uint8_t* sqPtr = ringPtr->sqRingPtr;
+    ringPtr->sqHeadPtr = (unsigned int*)(sqPtr + params.sq_off.head);
+    ringPtr->sqTailPtr = (unsigned int*)(sqPtr + params.sq_off.tail);
+    ringPtr->sqMaskPtr = (unsigned int*)(sqPtr + params.sq_off.ring_mask);
+    ringPtr->sqArrayPtr = (unsigned int*)(sqPtr + params.sq_off.array);
+
+    uint8_t* cqPtr = ringPtr->cqRingPtr;
+    ringPtr->cqHeadPtr = (unsigned int*)(cqPtr + params.cq_off.head);
+    ringPtr->cqTailPtr = (unsigned int*)(cqPtr + params.cq_off.tail);
+    ringPtr->cqMaskPtr = (unsigned int*)(cqPtr + params.cq_off.ring_mask);
+    ringPtr->cqesPtr = (struct io_uring_cqe*)(cqPtr + params.cq_off.cqes);
+
+    ringPtr->pendingCount = 0;
+
+    return LE_OK;
+
+mapFailed:
+
+    LE_ERROR("Failed to map io_uring rings. errno = %d (%m).", errno);
+    fd_Close(ringPtr->fd);
+    ringPtr->fd = -1;
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap and close a ring.  Does nothing if the ring was never created.
+ */
+//--------------------------------------------------------------------------------------------------
+void ioUring_Destroy
+(
+    ioUring_Ring_t* ringPtr
+)
+{
+    if (ringPtr->fd < 0)
+    {
+        return;
+    }
+
+    munmap(ringPtr->sqesPtr, ringPtr->sqesSize);
+    if (ringPtr->cqRingPtr != ringPtr->sqRingPtr)
+    {
+        munmap(ringPtr->cqRingPtr, ringPtr->cqRingSize);
+    }
+    munmap(ringPtr->sqRingPtr, ringPtr->sqRingSize);
+
+    fd_Close(ringPtr->fd);
+    ringPtr->fd = -1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next free submission queue entry, cleared.  The entry is submitted by the next call to
+ * ioUring_Submit().
+ *
+ * @return  Pointer to the entry, or NULL if the submission ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+struct io_uring_sqe* ioUring_GetSqe
+(
+    ioUring_Ring_t* ringPtr
+)
+{
+    unsigned int head = __atomic_load_n(ringPtr->sqHeadPtr, __ATOMIC_ACQUIRE);
+    unsigned int tail = *ringPtr->sqTailPtr + ringPtr->pendingCount;
+
+    if (tail - head >= ringPtr->numEntries)
+    {
+        return NULL;
+    }
+
+    unsigned int index = tail & *ringPtr->sqMaskPtr;
+    struct io_uring_sqe* sqePtr = &ringPtr->sqesPtr[index];
+
+    memset(sqePtr, 0, sizeof(*sqePtr));
+    ringPtr->sqArrayPtr[index] = index;
+    ringPtr->pendingCount++;
+
+    return sqePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit the pending submission queue entries and wait for at least a given number of completions,
+ * with a single io_uring_enter() call (retried if interrupted by a signal).
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT on failure (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ioUring_Submit
+(
+    ioUring_Ring_t* ringPtr,
+    unsigned int    minComplete     ///< [in] Number of completions to wait for.
+)
+{
+    // Publish the new entries to the kernel.
+    __atomic_store_n(ringPtr->sqTailPtr,
+                     *ringPtr->sqTailPtr + ringPtr->pendingCount,
+                     __ATOMIC_RELEASE);
+    ringPtr->pendingCount = 0;
+
+    for (;;)
+    {
+        // Entries the kernel hasn't consumed yet (all of them, unless a previous attempt was
+        // interrupted part way through).
+        unsigned int toSubmit = *ringPtr->sqTailPtr
+                              - __atomic_load_n(ringPtr->sqHeadPtr, __ATOMIC_ACQUIRE);
+
+        if (Enter(ringPtr->fd,
+                  toSubmit,
+                  minComplete,
+                  (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0) >= 0)
+        {
+            return LE_OK;
+        }
+
+        if (errno != EINTR)
+        {
+            return LE_FAULT;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest completion queue entry that hasn't been consumed yet.
+ *
+ * @return  Pointer to the entry, or NULL if there are none.  The entry stays valid until
+ *          ioUring_ConsumeCqe() is called.
+ */
+//--------------------------------------------------------------------------------------------------
+struct io_uring_cqe* ioUring_PeekCqe
+(
+    ioUring_Ring_t* ringPtr
+)
+{
+    unsigned int head = *ringPtr->cqHeadPtr;
+
+    if (head == __atomic_load_n(ringPtr->cqTailPtr, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    return &ringPtr->cqesPtr[head & *ringPtr->cqMaskPtr];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give the entry returned by ioUring_PeekCqe() back to the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+void ioUring_ConsumeCqe
+(
+    ioUring_Ring_t* ringPtr
+)
+{
+    __atomic_store_n(ringPtr->cqHeadPtr, *ringPtr->cqHeadPtr + 1, __ATOMIC_RELEASE);
+}
+
+#endif // LE_EVENT_LOOP_IO_URING
@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------------------------------------
+/** @file ioUring.h
+ *
+ * Minimal io_uring(7) submission/completion ring wrapper, used by the Event Loop to submit
+ * batches of operations with a single system call.  Only built when @c LE_EVENT_LOOP_IO_URING is
+ * defined (see @ref bld_cfg_event_loop_io_uring).
+ *
+ * Talks to the kernel through the raw system calls, so it doesn't need liburing.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_IO_URING_H_INCLUDE_GUARD
+#define LEGATO_IO_URING_H_INCLUDE_GUARD
+
+#ifdef LE_EVENT_LOOP_IO_URING
+
+#include <linux/io_uring.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An io_uring(7) instance: the ring fd and the parts of the submission and completion rings that
+ * are mapped into the process.
+ *
+ * A ring is only ever used by the thread that created it, so none of this is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int                     fd;             ///< Ring fd, or -1 if the ring hasn't been created.
+    unsigned int            numEntries;     ///< Number of entries in the submission ring.
+    unsigned int            pendingCount;   ///< SQEs filled in but not yet submitted.
+
+    unsigned int*           sqHeadPtr;      ///< Submission ring head (written by the kernel).
+    unsigned int*           sqTailPtr;      ///< Submission ring tail (written by us).
+    unsigned int*           sqMaskPtr;      ///< Submission ring index mask.
+    unsigned int*           sqArrayPtr;     ///< Submission ring's array of SQE indexes.
+    struct io_uring_sqe*    sqesPtr;        ///< Submission queue entries.
+
+    unsigned int*           cqHeadPtr;      ///< Completion ring head (written by us).
+    unsigned int*           cqTailPtr;      ///< Completion ring tail (written by the kernel).
+    unsigned int*           cqMaskPtr;      ///< Completion ring index mask.
+    struct io_uring_cqe*    cqesPtr;        ///< Completion queue entries.
+
+    void*                   sqRingPtr;      ///< Mapping of the submission ring.
+    size_t                  sqRingSize;     ///< Size of the submission ring mapping.
+    void*                   cqRingPtr;      ///< Mapping of the completion ring (may be the same
+                                            ///< as the submission ring's).
+    size_t                  cqRingSize;     ///< Size of the completion ring mapping.
+    size_t                  sqesSize;       ///< Size of the submission queue entries mapping.
+}
+ioUring_Ring_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializer for a ring that hasn't been created yet.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IO_URING_RING_INIT { .fd = -1 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an io_uring(7) instance and map its rings.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_IMPLEMENTED if the kernel doesn't support io_uring (or it is not allowed).
+ *      - LE_FAULT on any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ioUring_Create
+(
+    ioUring_Ring_t* ringPtr,        ///< [out] Ring to initialize.
+    unsigned int    numEntries      ///< [in] Number of submission queue entries.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap and close a ring.  Does nothing if the ring was never created.
+ */
+//--------------------------------------------------------------------------------------------------
+void ioUring_Destroy
+(
+    ioUring_Ring_t* ringPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next free submission queue entry, cleared.  The entry is submitted by the next call to
+ * ioUring_Submit().
+ *
+ * @return  Pointer to the entry, or NULL if the submission ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+struct io_uring_sqe* ioUring_GetSqe
+(
+    ioUring_Ring_t* ringPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit the pending submission queue entries and wait for at least a given number of completions,
+ * with a single io_uring_enter() call (retried if interrupted by a signal).
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FAULT on failure (errno is set).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ioUring_Submit
+(
+    ioUring_Ring_t* ringPtr,
+    unsigned int    minComplete     ///< [in] Number of completions to wait for.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest completion queue entry that hasn't been consumed yet.
+ *
+ * @return  Pointer to the entry, or NULL if there are none.  The entry stays valid until
+ *          ioUring_ConsumeCqe() is called.
+ */
+//--------------------------------------------------------------------------------------------------
+struct io_uring_cqe* ioUring_PeekCqe
+(
+    ioUring_Ring_t* ringPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give the entry returned by ioUring_PeekCqe() back to the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+void ioUring_ConsumeCqe
+(
+    ioUring_Ring_t* ringPtr
+);
+
+#endif // LE_EVENT_LOOP_IO_URING
+
+#endif // LEGATO_IO_URING_H_INCLUDE_GUARD
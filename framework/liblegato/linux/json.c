@@ -8,11 +8,21 @@
 
 #include "legato.h"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 
 /// Maximum number of bytes allowed in a string value, object member name, or number's text
 /// including the null terminator.
 #define MAX_STRING_BYTES 1024
 
+/// Number of bytes read from the file descriptor at a time, when it is safe to read ahead.
+#define READ_CHUNK_BYTES 1024
+
+/// Size of the chunks Context records are allocated from.  Enough for several levels of nesting.
+#define CONTEXT_CHUNK_BYTES 512
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -56,8 +66,12 @@ typedef struct le_json_ParsingSession
 
     int fd;                         ///< File descriptor to read the JSON document from.
     le_fdMonitor_Ref_t fdMonitor;   ///< File Descriptor Monitor used to monitor the fd.
-    size_t bytesRead;               ///< # of bytes read from the file descriptor.
+    size_t bytesRead;               ///< # of bytes of the document processed so far.
+    size_t bytesFetched;            ///< # of bytes read from the file descriptor.
     size_t line;                    ///< Line number of the JSON document (starts at 1).
+    bool canReadAhead;              ///< true if fd is a regular file, so bytes read past the end
+                                    ///  of the document can be given back using lseek().
+    char readBuffer[READ_CHUNK_BYTES]; ///< Chunk of the document most recently read from the fd.
 
     le_json_ErrorHandler_t errorHandler; ///< Function to call when errors happen.
     void* opaquePtr;                ///< Client's opaque pointer passed to le_json_Parse().
@@ -65,6 +79,7 @@ typedef struct le_json_ParsingSession
     le_thread_DestructorRef_t threadDestructor; ///< Ref to thread death destructor for this parser.
 
     le_sls_List_t contextStack;     ///< Stack of Context records.
+    le_arena_Arena_t contextArena;  ///< Arena the Context records are allocated from.
 }
 Parser_t;
 
@@ -74,7 +89,9 @@ Parser_t;
  * Context record.  Keeps track of the event handler function and opaque pointer that belongs
  * to a given parsing context.
  *
- * These are allocated from the Context Pool and are kept on a Parser instance's Context Stack.
+ * These are allocated from a Parser instance's Context Arena and are kept on its Context Stack.
+ * Contexts are pushed and popped in LIFO order, so popping one just rewinds the arena to where it
+ * was before the context was allocated.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
@@ -84,6 +101,8 @@ typedef struct
     le_json_ContextType_t type;     ///< Type of JSON syntax structure being parsed.
 
     le_json_EventHandler_t  eventHandler;   ///< Called when parsing events happen in this context.
+
+    le_arena_Mark_t arenaMark;      ///< Context Arena usage before this record was allocated.
 }
 Context_t;
 
@@ -91,8 +110,8 @@ Context_t;
 // Memory pool reference for the pool that parser instance records are allocated from.
 static le_mem_PoolRef_t ParserPool;
 
-// Memory pool reference for the pool that context records are allocated from.
-static le_mem_PoolRef_t ContextPool;
+// Memory pool reference for the pool that the Context Arenas' chunks are allocated from.
+static le_mem_PoolRef_t ContextChunkPool;
 
 
 /// Thread-local data key for use by the event and error handler functions.
@@ -132,6 +151,20 @@ static void StopParsing
         parserPtr->next = EXPECT_NOTHING;
         le_fdMonitor_Delete(parserPtr->fdMonitor);
         parserPtr->fdMonitor = NULL;
+
+        // Give back anything that was read past the point where parsing stopped, so whoever
+        // reads the fd next picks up right after the document.
+        if (parserPtr->bytesFetched > parserPtr->bytesRead)
+        {
+            off_t offset = (off_t)parserPtr->bytesRead - (off_t)parserPtr->bytesFetched;
+
+            if (lseek(parserPtr->fd, offset, SEEK_CUR) == -1)
+            {
+                LE_WARN("Failed to give back %zu bytes read past the end of the document (%m).",
+                        parserPtr->bytesFetched - parserPtr->bytesRead);
+            }
+            parserPtr->bytesFetched = parserPtr->bytesRead;
+        }
     }
 }
 
@@ -152,12 +185,8 @@ static void ParserDestructor
 
     StopParsing(parserPtr);
 
-    le_sls_Link_t* linkPtr;
-
-    while ((linkPtr = le_sls_Pop(&parserPtr->contextStack)) != NULL)
-    {
-        le_mem_Release(CONTAINER_OF(linkPtr, Context_t, link));
-    }
+    parserPtr->contextStack = LE_SLS_LIST_INIT;
+    le_arena_Free(&parserPtr->contextArena);
 
     le_thread_RemoveDestructor(parserPtr->threadDestructor);
 }
@@ -179,7 +208,7 @@ void json_Init
     // Create the memory pools.
     ParserPool = le_mem_CreatePool("JSON Parser", sizeof(Parser_t));
     le_mem_SetDestructor(ParserPool, ParserDestructor);
-    ContextPool = le_mem_CreatePool("JSON Context", sizeof(Context_t));
+    ContextChunkPool = le_mem_CreatePool("JSON Context", CONTEXT_CHUNK_BYTES);
 
     // Initialize the thread-local data key.
     pthread_key_create(&HandlerKey, NULL);
@@ -352,8 +381,10 @@ static void PushContext
 )
 //--------------------------------------------------------------------------------------------------
 {
-    Context_t* contextPtr = le_mem_ForceAlloc(ContextPool);
+    le_arena_Mark_t mark = le_arena_GetMark(&parserPtr->contextArena);
+    Context_t* contextPtr = le_arena_ForceAlloc(&parserPtr->contextArena, sizeof(Context_t));
 
+    contextPtr->arenaMark = mark;
     contextPtr->link = LE_SLS_LINK_INIT;
     contextPtr->type = type;
     contextPtr->eventHandler = eventHandler;
@@ -382,7 +413,8 @@ static void PopContext
     {
         // Pop the top one and release it.
         le_sls_Link_t* linkPtr = le_sls_Pop(&parserPtr->contextStack);
-        le_mem_Release(CONTAINER_OF(linkPtr, Context_t, link));
+        le_arena_Mark_t mark = CONTAINER_OF(linkPtr, Context_t, link)->arenaMark;
+        le_arena_Rewind(&parserPtr->contextArena, &mark);
 
         // Check the new context
         le_json_ContextType_t context = GetContext(parserPtr)->type;
@@ -613,7 +645,7 @@ static void ParseString
     if (c == '"')
     {
         // It's not string terminating if it is escaped.
-        if ((parserPtr->bytesRead == 0) || (parserPtr->buffer[parserPtr->bytesRead - 1] != '\\'))
+        if ((parserPtr->numBytes == 0) || (parserPtr->buffer[parserPtr->numBytes - 1] != '\\'))
         {
             // Make we have a valid UTF-8 string.
             if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
@@ -851,9 +883,163 @@ static void ProcessChar
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the end of a run of plain string characters.  The run ends at the first '"' (which must
+ * go through ParseString() to check for termination) or newline (which must be counted).
+ *
+ * Whole 16-byte chunks are compared at once using NEON on ARM targets, or 8-byte words otherwise.
+ *
+ * @return The number of bytes at the start of the chunk that can be copied straight into the
+ *         value buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FindStringRunEnd
+(
+    const char* dataPtr,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i = 0;
+
+#if defined(__ARM_NEON)
+
+    const uint8x16_t quotes = vdupq_n_u8('"');
+    const uint8x16_t newlines = vdupq_n_u8('\n');
+
+    for (; (i + 16) <= numBytes; i += 16)
+    {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)(dataPtr + i));
+        uint8x16_t matches = vorrq_u8(vceqq_u8(chunk, quotes), vceqq_u8(chunk, newlines));
+
+        // Narrow the 0x00/0xFF byte matches down to a 64-bit mask with 4 bits per byte.
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+
+        if (mask != 0)
+        {
+            return i + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+
+#else
+
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highBits = 0x8080808080808080ULL;
+
+    for (; (i + sizeof(uint64_t)) <= numBytes; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, dataPtr + i, sizeof(word));
+
+        // A byte of (word ^ pattern) is zero where the word's byte matches the pattern.
+        uint64_t quotes = word ^ (ones * '"');
+        uint64_t newlines = word ^ (ones * '\n');
+
+        if (  (((quotes - ones) & ~quotes) | ((newlines - ones) & ~newlines)) & highBits)
+        {
+            break;
+        }
+    }
+
+#endif
+
+    // Find the exact position within the last (partial) chunk.
+    while ((i < numBytes) && (dataPtr[i] != '"') && (dataPtr[i] != '\n'))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processes a chunk of the JSON document.
+ *
+ * Whitespace between tokens is skipped and runs of plain string characters are copied into the
+ * value buffer in bulk.  Everything else is fed to ProcessChar() one character at a time.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessChunk
+(
+    Parser_t* parserPtr,
+    const char* dataPtr,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i = 0;
+
+    while ((i < numBytes) && NotStopped(parserPtr))
+    {
+        switch (parserPtr->next)
+        {
+            case EXPECT_STRING:
+            {
+                // Leave room for the null terminator.  If the buffer is full, let AddToBuffer()
+                // report the error.
+                size_t room = sizeof(parserPtr->buffer) - 1 - parserPtr->numBytes;
+                size_t count = FindStringRunEnd(dataPtr + i,
+                                                (numBytes - i) < room ? (numBytes - i) : room);
+
+                memcpy(parserPtr->buffer + parserPtr->numBytes, dataPtr + i, count);
+                parserPtr->numBytes += count;
+                parserPtr->bytesRead += count;
+                i += count;
+                break;
+            }
+
+            case EXPECT_NUMBER:
+            case EXPECT_TRUE:
+            case EXPECT_FALSE:
+            case EXPECT_NULL:
+            case EXPECT_NOTHING:
+
+                break;
+
+            default:
+
+                // All other states throw away whitespace.
+                while ((i < numBytes) && isspace(dataPtr[i]))
+                {
+                    if (dataPtr[i] == '\n')
+                    {
+                        parserPtr->line++;
+                    }
+                    parserPtr->bytesRead++;
+                    i++;
+                }
+                break;
+        }
+
+        if (i < numBytes)
+        {
+            char c = dataPtr[i];
+
+            i++;
+            parserPtr->bytesRead++;
+            if (c == '\n')
+            {
+                parserPtr->line++;
+            }
+            ProcessChar(parserPtr, c);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read data from the JSON document file descriptor and process it.
+ *
+ * The caller may go on reading from the same fd after the end of the JSON document (e.g., the
+ * update pack payload that follows its JSON header), so the parser must never consume more than
+ * the document.  Regular files are read a chunk at a time and any bytes left over when parsing
+ * stops are given back by seeking backwards (see StopParsing()).  Anything else is read one byte at a time.
  */
 //--------------------------------------------------------------------------------------------------
 static void ReadData
@@ -863,13 +1049,14 @@ static void ReadData
 )
 //--------------------------------------------------------------------------------------------------
 {
+    size_t readSize = parserPtr->canReadAhead ? sizeof(parserPtr->readBuffer) : 1;
+
     while (NotStopped(parserPtr))
     {
-        char c;
         ssize_t bytesRead;
         do
         {
-            bytesRead = read(fd, &c, 1);
+            bytesRead = read(fd, parserPtr->readBuffer, readSize);
         }
         while ((bytesRead == -1) && (errno == EINTR));
 
@@ -914,12 +1101,9 @@ static void ReadData
         }
         else
         {
-            parserPtr->bytesRead++;
-            if (c == '\n')
-            {
-                parserPtr->line++;
-            }
-            ProcessChar(parserPtr, c);
+            // If parsing stops part way through the chunk, StopParsing() gives back the rest.
+            parserPtr->bytesFetched += bytesRead;
+            ProcessChunk(parserPtr, parserPtr->readBuffer, bytesRead);
         }
     }
 }
@@ -996,11 +1180,17 @@ le_json_ParsingSessionRef_t le_json_Parse
     parserPtr->numBytes = 0;
 
     parserPtr->fd = fd;
-    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
-    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
     parserPtr->bytesRead = 0;
+    parserPtr->bytesFetched = 0;
     parserPtr->line = 1;
 
+    // Only regular files can safely be read ahead of the parser (see ReadData()).
+    struct stat fileInfo;
+    parserPtr->canReadAhead = ((fstat(fd, &fileInfo) == 0) && S_ISREG(fileInfo.st_mode));
+
+    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+
     parserPtr->errorHandler = errorHandler;
     parserPtr->opaquePtr = opaquePtr;
 
@@ -1008,6 +1198,7 @@ le_json_ParsingSessionRef_t le_json_Parse
     parserPtr->threadDestructor = le_thread_AddDestructor(ThreadDeathHandler, parserPtr);
 
     parserPtr->contextStack = LE_SLS_LIST_INIT;
+    le_arena_Init(&parserPtr->contextArena, ContextChunkPool);
 
     // Create the top-level context and push it onto the context stack.
     PushContext(parserPtr, LE_JSON_CONTEXT_DOC, eventHandler);
@@ -9,18 +9,11 @@
 
 #include "legato.h"
 #include "log.h"
+#include "logBuffer.h"
 #include "logDaemon/logDaemon.h"
 #include "limit.h"
 #include "messagingSession.h"
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Maximum length of log messages.
- */
-//--------------------------------------------------------------------------------------------------
-#define MAX_MSG_SIZE            256
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Log severity strings.
@@ -64,6 +57,8 @@ typedef struct le_log_Session
                                         ///  Log messages with severity less than this are ignored.
     le_sls_List_t keywordList;          ///< The list of keywords for this component.
     le_sls_Link_t link;                 ///< The link used for linking with the SessionList.
+    le_log_Level_t streamLevel;         ///< Lowest severity of the messages streamed to the Log
+                                        ///  Control Daemon (-1 if none are).
 }
 LogSession_t;
 
@@ -94,7 +89,8 @@ static LogSession_t DefaultLogSession =    {
                                             .componentNamePtr="<invalid>",
                                             .level=LOG_DEFAULT_LOG_FILTER,
                                             .keywordList=LE_SLS_LIST_INIT,
-                                            .link=LE_SLS_LINK_INIT
+                                            .link=LE_SLS_LINK_INIT,
+                                            .streamLevel=-1
                                         };
 
 
@@ -129,6 +125,44 @@ static le_mem_PoolRef_t KeywordMemPool;
 static le_msg_SessionRef_t IpcSessionRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that opened the IPC session with the Log Control Daemon.  Only this thread may send
+ * messages over the session, so the log messages streamed from other threads are queued to it.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t IpcThreadRef;
+
+/// pthread ID of the IPC thread, which can be compared from any thread, Legato or not.
+static pthread_t IpcPthread;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of log sessions whose messages are streamed to the Log Control Daemon.  Read without
+ * locking, so the processes nobody is streaming from don't pay anything for the feature.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int StreamedSessionCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of streamed log messages waiting to be sent by the IPC thread.  Messages logged
+ * by other threads while that many are waiting are not streamed.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MAX_PENDING_STREAM_MSGS     64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of streamed log messages waiting to be sent by the IPC thread.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int PendingStreamMsgCount = 0;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Trace reference used for controlling tracing in this module.
@@ -141,6 +175,24 @@ static le_log_TraceRef_t TraceRef;
 #define TRACE(...) LE_TRACE(TraceRef, ##__VA_ARGS__)
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the rate-limited call sites in this process that have been hit at least once.  A call
+ * site is pushed onto the list (without locking) the first time it is hit, and is never removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static _le_log_RateLimit_t* RateLimitListPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of call sites reported to the Log Control Daemon by a "hot call sites" request.
+ * Fewer may be reported if they don't fit in a log command packet.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_HOT_SITES   8
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * POSIX threads "Fast" mutex used to protect structures in this module from multi-threaded
@@ -382,6 +434,116 @@ static void SetLogLevelFilter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the log level filters for a batch of components, from a list of componentName=level entries
+ * separated by slashes.  All the levels are applied while holding the mutex once.
+ *
+ * @note The list is modified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetLogLevelFilters
+(
+    char* settingsPtr               // The list of component settings.
+)
+{
+    char* savePtr;
+    char* entryPtr = strtok_r(settingsPtr, "/", &savePtr);
+
+    Lock();
+
+    while (entryPtr != NULL)
+    {
+        char* levelPtr = strchr(entryPtr, '=');
+
+        if (levelPtr == NULL)
+        {
+            LE_ERROR("Malformed level setting '%s'.", entryPtr);
+        }
+        else
+        {
+            *levelPtr = '\0';
+            levelPtr++;
+
+            int level = log_StrToSeverityLevel(levelPtr);
+            LogSession_t* sessionPtr = GetSession(entryPtr);
+
+            if ((level != -1) && (sessionPtr != NULL))
+            {
+                sessionPtr->level = level;
+            }
+        }
+
+        entryPtr = strtok_r(NULL, "/", &savePtr);
+    }
+
+    Unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the stream levels for a batch of components, from a list of componentName=level entries
+ * separated by slashes.  A level of LOG_STREAM_OFF_STR stops streaming the component's messages.
+ *
+ * @note The list is modified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetStreamLevels
+(
+    char* settingsPtr               // The list of component settings.
+)
+{
+    char* savePtr;
+    char* entryPtr = strtok_r(settingsPtr, "/", &savePtr);
+
+    Lock();
+
+    while (entryPtr != NULL)
+    {
+        char* levelPtr = strchr(entryPtr, '=');
+
+        if (levelPtr == NULL)
+        {
+            LE_ERROR("Malformed stream level setting '%s'.", entryPtr);
+        }
+        else
+        {
+            *levelPtr = '\0';
+            levelPtr++;
+
+            le_log_Level_t level = -1;
+            LogSession_t* sessionPtr = GetSession(entryPtr);
+
+            if (strcmp(levelPtr, LOG_STREAM_OFF_STR) != 0)
+            {
+                level = log_StrToSeverityLevel(levelPtr);
+            }
+
+            if (sessionPtr != NULL)
+            {
+                if (   (sessionPtr->streamLevel == (le_log_Level_t)-1)
+                    && (level != (le_log_Level_t)-1) )
+                {
+                    __atomic_add_fetch(&StreamedSessionCount, 1, __ATOMIC_RELAXED);
+                }
+                else if (   (sessionPtr->streamLevel != (le_log_Level_t)-1)
+                         && (level == (le_log_Level_t)-1) )
+                {
+                    __atomic_sub_fetch(&StreamedSessionCount, 1, __ATOMIC_RELAXED);
+                }
+
+                sessionPtr->streamLevel = level;
+            }
+        }
+
+        entryPtr = strtok_r(NULL, "/", &savePtr);
+    }
+
+    Unlock();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a log session.
@@ -402,6 +564,7 @@ static LogSession_t* CreateSession
     logSessionPtr->level = DefaultLogSession.level;
     logSessionPtr->keywordList = LE_SLS_LIST_INIT;
     logSessionPtr->link = LE_SLS_LINK_INIT;
+    logSessionPtr->streamLevel = -1;
 
     Lock();
 
@@ -618,6 +781,85 @@ static bool ParseCmdPacket
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reports the rate-limited call sites that have logged the most messages in this process to the
+ * Log Control Daemon, busiest first.  Each line of the report holds the number of messages logged
+ * or suppressed at a call site, the number suppressed, and the location of the call site.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportHotSites
+(
+    void
+)
+{
+    _le_log_RateLimit_t* hotSites[MAX_HOT_SITES];
+    size_t numHotSites = 0;
+
+    // Keep the busiest call sites seen so far, sorted by hit count.
+    // NOTE: The counters may be changing while we read them, but that's good enough for this.
+    _le_log_RateLimit_t* sitePtr = __atomic_load_n(&RateLimitListPtr, __ATOMIC_ACQUIRE);
+    for (; sitePtr != NULL; sitePtr = sitePtr->nextPtr)
+    {
+        size_t i = numHotSites;
+
+        if (numHotSites < MAX_HOT_SITES)
+        {
+            numHotSites++;
+        }
+        else if (sitePtr->hitCount <= hotSites[MAX_HOT_SITES - 1]->hitCount)
+        {
+            continue;
+        }
+        else
+        {
+            i = MAX_HOT_SITES - 1;
+        }
+
+        while ((i > 0) && (hotSites[i - 1]->hitCount < sitePtr->hitCount))
+        {
+            hotSites[i] = hotSites[i - 1];
+            i--;
+        }
+        hotSites[i] = sitePtr;
+    }
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(IpcSessionRef);
+    char* packetPtr = le_msg_GetPayloadPtr(msgRef);
+    size_t maxSize = le_msg_GetMaxPayloadSize(msgRef);
+    size_t packetLength = 0;
+
+    packetPtr[packetLength++] = LOG_CMD_REPORT_HOT_SITES;
+    packetPtr[packetLength] = '\0';
+
+    // Only report as many call sites as fit in whole.
+    size_t i;
+    for (i = 0; i < numHotSites; i++)
+    {
+        sitePtr = hotSites[i];
+
+        int n = snprintf(packetPtr + packetLength,
+                         maxSize - packetLength,
+                         "%s%10" PRIu64 " %10" PRIu64 "  %s:%u %s()",
+                         (i == 0) ? "" : "\n",
+                         sitePtr->hitCount,
+                         sitePtr->suppressedTotal,
+                         sitePtr->fileNamePtr,
+                         sitePtr->lineNumber,
+                         sitePtr->functionNamePtr);
+        if ((n < 0) || (n >= maxSize - packetLength))
+        {
+            packetPtr[packetLength] = '\0';
+            break;
+        }
+
+        packetLength += n;
+    }
+
+    le_msg_Send(msgRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Processes a remote logging command.  This function should be called by the event loop when there
@@ -636,6 +878,27 @@ static void ProcessLogCmd
     char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
     const char* commandDataPtr;
 
+    // The hot call sites request and batched level settings apply to the whole process, so they
+    // have no component name.
+    if (cmdPacketPtr[0] == LOG_CMD_LIST_HOT_SITES)
+    {
+        ReportHotSites();
+        le_msg_ReleaseMsg(msgRef);
+        return;
+    }
+    if (cmdPacketPtr[0] == LOG_CMD_SET_LEVELS)
+    {
+        SetLogLevelFilters(cmdPacketPtr + 1);
+        le_msg_ReleaseMsg(msgRef);
+        return;
+    }
+    if (cmdPacketPtr[0] == LOG_CMD_SET_STREAM_LEVELS)
+    {
+        SetStreamLevels(cmdPacketPtr + 1);
+        le_msg_ReleaseMsg(msgRef);
+        return;
+    }
+
     // Parse the packet.
     if (ParseCmdPacket(cmdPacketPtr, &command, componentName, &commandDataPtr))
     {
@@ -737,6 +1000,242 @@ static void RegisterWithLogControlDaemon
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hex dump cells for each byte value ("00 " to "FF "), and the printable equivalent of each byte
+ * value, for _le_LogData().
+ */
+//--------------------------------------------------------------------------------------------------
+static char DumpHexStr[256][4];
+static char DumpCharStr[256][2];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format of a hex dump line: 16 hex cells, a separator at column 49, and 16 characters starting
+ * at column 51.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DUMP_CELLS  "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s"
+#define DUMP_FORMAT DUMP_CELLS " : " DUMP_CELLS
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills in the hex dump tables.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitDumpTables
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < 256; i++)
+    {
+        snprintf(DumpHexStr[i], sizeof(DumpHexStr[i]), "%02X ", i);
+        DumpCharStr[i][0] = isprint(i) ? i : '.';
+        DumpCharStr[i][1] = '\0';
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Converts the legato log levels to the syslog priority levels.
+ *
+ * @return
+ *      Syslog priority level.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifdef LEGATO_EMBEDDED
+
+static int ConvertToSyslogLevel
+(
+    le_log_Level_t legatoLevel
+)
+{
+    switch (legatoLevel)
+    {
+        case LE_LOG_DEBUG:
+            return LOG_DEBUG;
+
+        case LE_LOG_INFO:
+            return LOG_INFO;
+
+        case LE_LOG_WARN:
+            return LOG_WARNING;
+
+        case LE_LOG_ERR:
+            return LOG_ERR;
+
+        case LE_LOG_CRIT:
+            return LOG_CRIT;
+
+        default:
+            return LOG_EMERG;
+    }
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a streamed log message to the Log Control Daemon.  Runs in the IPC thread, for messages
+ * logged by other threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendStreamMsg
+(
+    void* msgRefPtr,        ///< [IN] The message.
+    void* unusedPtr         ///< [IN] Not used.
+)
+{
+    __atomic_sub_fetch(&PendingStreamMsgCount, 1, __ATOMIC_RELAXED);
+
+    le_msg_Send(msgRefPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Streams a log message to the Log Control Daemon, if a log control tool is streaming the
+ * component's messages at this level.
+ *
+ * The framework's own messages are never streamed, as they may be logged by the messaging and
+ * event loop code that streaming relies on.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StreamMsg
+(
+    le_log_Level_t level,               ///< [IN] Severity level (-1 for a trace message).
+    const char* levelPtr,               ///< [IN] Severity level or trace keyword string.
+    const char* procNamePtr,            ///< [IN] Process name.
+    const char* compNamePtr,            ///< [IN] Component name.
+    const char* threadNamePtr,          ///< [IN] Name of the thread that logged the message.
+    const char* fileNamePtr,            ///< [IN] Base name of the source file.
+    const char* functionNamePtr,        ///< [IN] Name of the function that logged the message.
+    unsigned int lineNumber,            ///< [IN] Line number in the source file.
+    const char* msgPtr                  ///< [IN] The formatted user message.
+)
+{
+    if (   (__atomic_load_n(&StreamedSessionCount, __ATOMIC_RELAXED) == 0)
+        || (IpcSessionRef == NULL) )
+    {
+        return;
+    }
+
+    // Trace messages are streamed as debug messages.
+    if (level == (le_log_Level_t)-1)
+    {
+        level = LE_LOG_DEBUG;
+    }
+
+    Lock();
+    LogSession_t* sessionPtr = GetSession(compNamePtr);
+    bool isStreamed = (   (sessionPtr != NULL)
+                       && (sessionPtr != LE_LOG_SESSION)
+                       && (sessionPtr->streamLevel != (le_log_Level_t)-1)
+                       && (level >= sessionPtr->streamLevel) );
+    Unlock();
+
+    if (!isStreamed)
+    {
+        return;
+    }
+
+    bool isIpcThread = pthread_equal(pthread_self(), IpcPthread);
+
+    if (!isIpcThread)
+    {
+        if (__atomic_add_fetch(&PendingStreamMsgCount, 1, __ATOMIC_RELAXED)
+            > MAX_PENDING_STREAM_MSGS)
+        {
+            __atomic_sub_fetch(&PendingStreamMsgCount, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(IpcSessionRef);
+    char* packetPtr = le_msg_GetPayloadPtr(msgRef);
+    size_t maxSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    // Messages that don't fit are truncated.
+    snprintf(packetPtr, maxSize, "%c%s/%d%s | %s[%d]/%s T=%s | %s %s() %d | %s",
+             LOG_CMD_STREAM_MSG, compNamePtr, level,
+             levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, fileNamePtr,
+             functionNamePtr, lineNumber, msgPtr);
+
+    if (isIpcThread)
+    {
+        le_msg_Send(msgRef);
+    }
+    else
+    {
+        le_event_QueueFunctionToThread(IpcThreadRef, SendStreamMsg, msgRef, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a formatted log message out to the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteMsg
+(
+    le_log_Level_t level,               ///< [IN] Severity level (-1 for a trace message).
+    const char* levelPtr,               ///< [IN] Severity level or trace keyword string.
+    const char* compNamePtr,            ///< [IN] Component name.
+    const char* threadNamePtr,          ///< [IN] Name of the thread that logged the message.
+    const char* fileNamePtr,            ///< [IN] Base name of the source file.
+    const char* functionNamePtr,        ///< [IN] Name of the function that logged the message.
+    unsigned int lineNumber,            ///< [IN] Line number in the source file.
+    const struct timespec* timePtr,     ///< [IN] When the message was logged.
+    const char* msgPtr                  ///< [IN] The formatted user message.
+)
+{
+    // Get the process name.
+    const char* procNamePtr = le_arg_GetProgramName();
+    if (procNamePtr == NULL)
+    {
+        procNamePtr = "n/a";
+    }
+
+    // If running on an embedded target, write the message out to the log.
+#ifdef LEGATO_EMBEDDED
+
+    (void)timePtr;
+
+    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, fileNamePtr,
+           functionNamePtr, lineNumber, msgPtr);
+
+    // If running on a PC, write the message to standard error with a timestamp added.
+#else
+
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if (ctime_r(&timePtr->tv_sec, timeStamp) != NULL)
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
+            fileNamePtr, functionNamePtr, lineNumber, msgPtr);
+
+#endif
+
+    StreamMsg(level, levelPtr, procNamePtr, compNamePtr, threadNamePtr, fileNamePtr,
+              functionNamePtr, lineNumber, msgPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.
@@ -771,6 +1270,11 @@ void log_Init
 
     // Set the syslog format.
     openlog("Legato", 0, LOG_USER);
+
+    InitDumpTables();
+
+    // Set up the log record ring buffer, if it's been enabled.
+    logBuffer_Init(WriteMsg);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -807,6 +1311,8 @@ void log_ConnectToControlDaemon
     le_msg_ProtocolRef_t protocolRef;
     protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID, LOG_MAX_CMD_PACKET_BYTES);
     IpcSessionRef = le_msg_CreateSession(protocolRef, LOG_CLIENT_SERVICE_NAME);
+    IpcThreadRef = le_thread_GetCurrent();
+    IpcPthread = pthread_self();
 
     // Note: the process's main thread will always run the log command message receive handler.
     le_msg_SetSessionRecvHandler(IpcSessionRef, ProcessLogCmd, NULL);
@@ -978,45 +1484,6 @@ const char* log_SeverityLevelToStr
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Converts the legato log levels to the syslog priority levels.
- *
- * @return
- *      Syslog priority level.
- */
-//--------------------------------------------------------------------------------------------------
-#ifdef LEGATO_EMBEDDED
-
-static int ConvertToSyslogLevel
-(
-    le_log_Level_t legatoLevel
-)
-{
-    switch (legatoLevel)
-    {
-        case LE_LOG_DEBUG:
-            return LOG_DEBUG;
-
-        case LE_LOG_INFO:
-            return LOG_INFO;
-
-        case LE_LOG_WARN:
-            return LOG_WARNING;
-
-        case LE_LOG_ERR:
-            return LOG_ERR;
-
-        case LE_LOG_CRIT:
-            return LOG_CRIT;
-
-        default:
-            return LOG_EMERG;
-    }
-}
-#endif
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Builds the log message and sends it to the logging system.
@@ -1077,18 +1544,39 @@ void _le_log_Send
     // Get the file name.
     char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
 
+    // If messages are being buffered, let the log buffer thread format and write this one out.
+    // Urgent messages are written out right away (after everything that was logged before
+    // them), since the process may be about to die.
+    if (logBuffer_IsEnabled())
+    {
+        if ((level < LE_LOG_CRIT) || (level > LE_LOG_EMERG))
+        {
+            va_list varParams;
+            va_start(varParams, formatPtr);
+
+            bool isBuffered = logBuffer_Write(level, levelPtr, compNamePtr, baseFileNamePtr,
+                                              functionNamePtr, lineNumber, savedErrno,
+                                              formatPtr, varParams);
+            va_end(varParams);
+
+            if (isBuffered)
+            {
+                errno = savedErrno;
+                return;
+            }
+        }
+
+        logBuffer_Flush();
+    }
+
     // Get the thread name.
     const char* threadNamePtr = le_thread_GetMyName();
 
-    // Get the process name.
-    const char* procNamePtr = le_arg_GetProgramName();
-    if (procNamePtr == NULL)
-    {
-        procNamePtr = "n/a";
-    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
 
     // Get the user message.
-    char msg[MAX_MSG_SIZE] = "";
+    char msg[LOG_MAX_MSG_SIZE] = "";
 
     va_list varParams;
     va_start(varParams, formatPtr);
@@ -1102,33 +1590,8 @@ void _le_log_Send
 
     va_end(varParams);
 
-    // If running on an embedded target, write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
-           functionNamePtr, lineNumber, msg);
-
-    // If running on a PC, write the message to standard error with a timestamp added.
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
-
-    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
-            baseFileNamePtr, functionNamePtr, lineNumber, msg);
-
-#endif
+    WriteMsg(level, levelPtr, compNamePtr, threadNamePtr, baseFileNamePtr, functionNamePtr,
+             lineNumber, &now, msg);
 }
 
 
@@ -1258,6 +1721,9 @@ void _le_log_SetFilterLevel
 //--------------------------------------------------------------------------------------------------
 /**
  * Log data block. Provides a hex dump for debug
+ *
+ * Each line is logged as a set of string arguments picked from tables rather than being formatted
+ * here, so that with buffered logging the formatting is done by the log buffer thread.
  */
 //--------------------------------------------------------------------------------------------------
 void _le_LogData
@@ -1270,8 +1736,8 @@ void _le_LogData
 )
 {
     int i, j, numColumns;
-    char c;
-    char buffer[100];   // enough to hold 16 printed bytes, plus ASCII equivalents
+    const char* hexPtr[16];
+    const char* charPtr[16];
 
     for ( i=0; i<dataLength; i+=16 )
     {
@@ -1281,35 +1747,124 @@ void _le_LogData
             numColumns = 16;
         }
 
-        // Print the data as numbers
-        for(j=0; j<numColumns; j++)
+        for (j = 0; j < 16; j++)
         {
-            sprintf( &buffer[j*3], "%02X ", dataPtr[i+j] );
+            if (j < numColumns)
+            {
+                hexPtr[j] = DumpHexStr[dataPtr[i+j]];
+                charPtr[j] = DumpCharStr[dataPtr[i+j]];
+            }
+            else
+            {
+                // Pad with spaces, so the separator stays at column 49.
+                hexPtr[j] = "   ";
+                charPtr[j] = "";
+            }
         }
 
-        // Print extra spaces, if needed, plus separator at column 49
-        sprintf( &buffer[numColumns*3], "%*c: ", (16-numColumns)*3+1, ' ' );
+        _le_log_Send(LE_LOG_DEBUG, NULL, LE_LOG_SESSION, filenamePtr, functionNamePtr,
+                     lineNumber, DUMP_FORMAT,
+                     hexPtr[0], hexPtr[1], hexPtr[2], hexPtr[3],
+                     hexPtr[4], hexPtr[5], hexPtr[6], hexPtr[7],
+                     hexPtr[8], hexPtr[9], hexPtr[10], hexPtr[11],
+                     hexPtr[12], hexPtr[13], hexPtr[14], hexPtr[15],
+                     charPtr[0], charPtr[1], charPtr[2], charPtr[3],
+                     charPtr[4], charPtr[5], charPtr[6], charPtr[7],
+                     charPtr[8], charPtr[9], charPtr[10], charPtr[11],
+                     charPtr[12], charPtr[13], charPtr[14], charPtr[15]);
+    }
+}
 
-        // Print the data as characters, starting at column 51
-        for(j=0; j<numColumns; j++)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates a rate-limited call site's token bucket and counters, and decides whether the message
+ * being logged there should be written out or suppressed.
+ *
+ * A message costs intervalMs tokens, and the bucket is refilled with burst tokens per millisecond,
+ * up to burst messages' worth.  If another thread is updating the same call site at the time, the
+ * message is suppressed rather than waiting for it.
+ *
+ * @return
+ *      true if the message should be logged.
+ *      false if it should be suppressed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool _le_log_CheckRateLimit
+(
+    _le_log_RateLimit_t* rateLimitPtr,  ///< [IN] The call site's rate limiting state.
+    const char* functionNamePtr,        ///< [IN] The name of the function of the call site.
+    uint32_t* suppressedCountPtr        ///< [OUT] Number of messages suppressed at this call site
+                                        ///        since the last one was logged.  Only set if
+                                        ///        true is returned.
+)
+{
+    if (__atomic_test_and_set(&rateLimitPtr->isLocked, __ATOMIC_ACQUIRE))
+    {
+        __atomic_add_fetch(&rateLimitPtr->contendedCount, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    uint32_t nowMs = (uint32_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+
+    uint64_t maxCredit = (uint64_t)rateLimitPtr->burst * rateLimitPtr->intervalMs;
+
+    // The first time the call site is hit, fill its bucket and add it to the list of call sites.
+    if (!rateLimitPtr->isRegistered)
+    {
+        rateLimitPtr->functionNamePtr = functionNamePtr;
+        rateLimitPtr->credit = maxCredit;
+        rateLimitPtr->isRegistered = true;
+
+        rateLimitPtr->nextPtr = __atomic_load_n(&RateLimitListPtr, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&RateLimitListPtr,
+                                            &rateLimitPtr->nextPtr,
+                                            rateLimitPtr,
+                                            true,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED))
         {
-            c = dataPtr[i+j];
-            if ( ! isprint(c) )
-            {
-                c = '.';
-            }
-            sprintf( &buffer[51+j], "%c", c );
+            // nextPtr has been updated to the new head of the list.  Try again.
         }
-
-        do
+    }
+    else
+    {
+        rateLimitPtr->credit += (uint64_t)(nowMs - rateLimitPtr->lastRefillMs)
+                              * rateLimitPtr->burst;
+        if (rateLimitPtr->credit > maxCredit)
         {
-            if ((LE_LOG_LEVEL_FILTER_PTR == NULL) || (LE_LOG_DEBUG >= *LE_LOG_LEVEL_FILTER_PTR))
-            {
-                _le_log_Send(LE_LOG_DEBUG, NULL, LE_LOG_SESSION, filenamePtr, functionNamePtr,
-                             lineNumber, "%s", buffer);
-            }
-        } while(0);
+            rateLimitPtr->credit = maxCredit;
+        }
     }
+    rateLimitPtr->lastRefillMs = nowMs;
+
+    // Messages dropped because the call site was locked count as suppressed.
+    uint32_t contendedCount = __atomic_exchange_n(&rateLimitPtr->contendedCount,
+                                                  0,
+                                                  __ATOMIC_RELAXED);
+    rateLimitPtr->hitCount += contendedCount + 1;
+    rateLimitPtr->suppressedCount += contendedCount;
+    rateLimitPtr->suppressedTotal += contendedCount;
+
+    bool isAllowed = (rateLimitPtr->credit >= rateLimitPtr->intervalMs);
+
+    if (isAllowed)
+    {
+        rateLimitPtr->credit -= rateLimitPtr->intervalMs;
+        *suppressedCountPtr = rateLimitPtr->suppressedCount;
+        rateLimitPtr->suppressedCount = 0;
+    }
+    else
+    {
+        rateLimitPtr->suppressedCount++;
+        rateLimitPtr->suppressedTotal++;
+    }
+
+    __atomic_clear(&rateLimitPtr->isLocked, __ATOMIC_RELEASE);
+
+    return isAllowed;
 }
 
 
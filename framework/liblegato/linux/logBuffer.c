@@ -0,0 +1,1148 @@
+/** @file logBuffer.c
+ *
+ * Binary log record ring buffer.  See logBuffer.h for an overview.
+ *
+ * The ring buffer is a bounded multi-producer queue of fixed-size records.  Each record slot
+ * carries a sequence number that tells producers and the consumer whose turn it is to use the
+ * slot, so producers only need a compare-and-swap on the head index to claim a slot, and no
+ * locks or system calls.
+ *
+ * Rather than formatting the message, the producer walks the format string and copies each
+ * argument it refers to into the record (strings by value, since they may not outlive the call).
+ * The consumer walks the format string again, formatting one conversion at a time.  Messages
+ * that use conversions that can't be captured this way (e.g., positional arguments or wide
+ * strings), or whose arguments don't fit in a record, are formatted into the record by the
+ * producer instead.
+ *
+ * Records are consumed by a background thread, started the first time a message is buffered,
+ * or by any thread that calls logBuffer_Flush().  The consumer side is serialized by a mutex.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "log.h"
+#include "logBuffer.h"
+#include "thread.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the environment variable that sets the number of records in the ring buffer.
+ * The ring buffer is disabled if this is not set, or is zero.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SLOTS_ENV_VAR               "LE_LOG_BUFFER_SLOTS"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of records in the ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SLOTS                   65536
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of each record used to hold the message arguments (or the formatted message).
+ */
+//--------------------------------------------------------------------------------------------------
+#define ARG_DATA_BYTES              320
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest conversion specification that can be captured (e.g., "%-08.3lld").
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SPEC_BYTES              32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of argument consumed by a conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ARG_NONE,           ///< No argument (%% or %m).
+    ARG_INT,            ///< int (including char and short, which are promoted).
+    ARG_LONG,           ///< long
+    ARG_LLONG,          ///< long long
+    ARG_INTMAX,         ///< intmax_t
+    ARG_SIZE,           ///< size_t
+    ARG_PTRDIFF,        ///< ptrdiff_t
+    ARG_DOUBLE,         ///< double (including float, which is promoted).
+    ARG_LDOUBLE,        ///< long double
+    ARG_PTR,            ///< void*
+    ARG_STR,            ///< char* (copied into the record).
+    ARG_UNSUPPORTED     ///< Can't be captured.
+}
+ArgType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A parsed conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* startPtr;       ///< The '%'.
+    const char* endPtr;         ///< Just past the conversion character.
+    const char* widthPtr;       ///< Start of the field width (or '*').
+    const char* precisionPtr;   ///< Start of the precision, after the '.' (NULL if none).
+    const char* lengthPtr;      ///< Start of the length modifier and conversion character.
+    bool widthIsArg;            ///< true if the field width is given by an int argument.
+    bool precisionIsArg;        ///< true if the precision is given by an int argument.
+    int precision;              ///< Precision, if not given by an argument (-1 if none).
+    ArgType_t type;             ///< Type of argument consumed by the conversion.
+}
+Spec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A log message record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t seq;                             ///< Sequence number of the slot.
+    le_log_Level_t level;                   ///< Severity level (-1 for a trace message).
+    bool isFormatted;                       ///< true if data holds the formatted message.
+    int errNum;                             ///< errno value to use for %m.
+    unsigned int lineNumber;                ///< Line number in the source file.
+    const char* levelPtr;                   ///< Severity level or trace keyword string.
+    const char* compNamePtr;                ///< Component name.
+    const char* fileNamePtr;                ///< Base name of the source file.
+    const char* functionNamePtr;            ///< Function name.
+    const char* formatPtr;                  ///< User message format.
+    struct timespec time;                   ///< When the message was logged.
+    char threadName[MAX_THREAD_NAME_SIZE];  ///< Name of the thread that logged the message.
+    uint8_t data[ARG_DATA_BYTES];           ///< Captured arguments or formatted message.
+}
+Record_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The ring buffer of records.  NULL if disabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static Record_t* RecordsPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records in the ring buffer (a power of two), minus one.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SlotMask;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the next record to be claimed by a producer.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Head;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the next record to be consumed.  Protected by ConsumerMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Tail;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex that serializes the consumers of records.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t ConsumerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore that the log buffer thread waits on when there are no records to consume.
+ */
+//--------------------------------------------------------------------------------------------------
+static sem_t WakeUpSem;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if the log buffer thread is (about to be) waiting on the WakeUpSem.  Producers only post
+ * the semaphore if this is set, so they don't make a system call for every message.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsThreadAsleep;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the log buffer thread has been started.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsThreadStarted;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that writes formatted messages out to the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static logBuffer_WriteFunc_t WriteFunc;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parses a conversion specification.
+ *
+ * @return  Pointer to the character just after the specification.  The type is ARG_UNSUPPORTED
+ *          if the specification can't be captured.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* ParseSpec
+(
+    const char* ptr,        ///< [IN] The '%' that starts the specification.
+    Spec_t* specPtr         ///< [OUT] The parsed specification.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    specPtr->startPtr = ptr;
+    specPtr->widthIsArg = false;
+    specPtr->precisionIsArg = false;
+    specPtr->precisionPtr = NULL;
+    specPtr->precision = -1;
+    specPtr->type = ARG_UNSUPPORTED;
+
+    ptr++;
+
+    // Flags.
+    while ((*ptr != '\0') && (strchr("-+ #0'I", *ptr) != NULL))
+    {
+        ptr++;
+    }
+
+    // Field width.
+    specPtr->widthPtr = ptr;
+    if (*ptr == '*')
+    {
+        specPtr->widthIsArg = true;
+        ptr++;
+    }
+    else
+    {
+        while (isdigit((unsigned char)*ptr))
+        {
+            ptr++;
+        }
+    }
+
+    // Precision.
+    if (*ptr == '.')
+    {
+        ptr++;
+        specPtr->precisionPtr = ptr;
+        if (*ptr == '*')
+        {
+            specPtr->precisionIsArg = true;
+            ptr++;
+        }
+        else
+        {
+            specPtr->precision = 0;
+            while (isdigit((unsigned char)*ptr))
+            {
+                specPtr->precision = (specPtr->precision * 10) + (*ptr - '0');
+                ptr++;
+            }
+        }
+    }
+
+    // Length modifier.
+    specPtr->lengthPtr = ptr;
+    ArgType_t intType = ARG_INT;
+    bool isLongDouble = false;
+    bool isWide = false;
+
+    switch (*ptr)
+    {
+        case 'h':
+            ptr += (ptr[1] == 'h') ? 2 : 1;
+            break;
+
+        case 'l':
+            if (ptr[1] == 'l')
+            {
+                intType = ARG_LLONG;
+                ptr += 2;
+            }
+            else
+            {
+                intType = ARG_LONG;
+                isWide = true;
+                ptr++;
+            }
+            break;
+
+        case 'q':
+            intType = ARG_LLONG;
+            ptr++;
+            break;
+
+        case 'L':
+            intType = ARG_LLONG;
+            isLongDouble = true;
+            ptr++;
+            break;
+
+        case 'j':
+            intType = ARG_INTMAX;
+            ptr++;
+            break;
+
+        case 'z':
+        case 'Z':
+            intType = ARG_SIZE;
+            ptr++;
+            break;
+
+        case 't':
+            intType = ARG_PTRDIFF;
+            ptr++;
+            break;
+    }
+
+    // Conversion character.
+    switch (*ptr)
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            specPtr->type = intType;
+            break;
+
+        case 'c':
+            specPtr->type = isWide ? ARG_UNSUPPORTED : ARG_INT;
+            break;
+
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            specPtr->type = isLongDouble ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+
+        case 's':
+            specPtr->type = isWide ? ARG_UNSUPPORTED : ARG_STR;
+            break;
+
+        case 'p':
+            specPtr->type = ARG_PTR;
+            break;
+
+        case 'm':
+        case '%':
+            specPtr->type = ARG_NONE;
+            break;
+    }
+
+    if (*ptr != '\0')
+    {
+        ptr++;
+    }
+
+    specPtr->endPtr = ptr;
+
+    // Positional arguments ("%1$d") aren't supported.
+    if (   ((specPtr->endPtr - specPtr->startPtr) >= MAX_SPEC_BYTES)
+        || (memchr(specPtr->startPtr, '$', specPtr->endPtr - specPtr->startPtr) != NULL) )
+    {
+        specPtr->type = ARG_UNSUPPORTED;
+    }
+
+    return ptr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a value into the record's argument data.
+ *
+ * @return  false if it doesn't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool PutValue
+(
+    Record_t* recPtr,
+    size_t* offsetPtr,
+    const void* valuePtr,
+    size_t size
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((*offsetPtr + size) > sizeof(recPtr->data))
+    {
+        return false;
+    }
+
+    memcpy(recPtr->data + *offsetPtr, valuePtr, size);
+    *offsetPtr += size;
+
+    return true;
+}
+
+
+/// Copies an argument of a given type into the record, bailing out if it doesn't fit.
+#define PUT_ARG(type)                                                                   \
+    {                                                                                   \
+        type value = va_arg(args, type);                                                \
+        if (!PutValue(recPtr, &offset, &value, sizeof(value)))                          \
+        {                                                                               \
+            return false;                                                               \
+        }                                                                               \
+    }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies the arguments referred to by the message format into a record.
+ *
+ * @return  false if they can't be captured (the va_list is left in an undefined state).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CaptureArgs
+(
+    Record_t* recPtr,
+    const char* formatPtr,
+    va_list args
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+    const char* ptr = formatPtr;
+
+    while ((ptr = strchr(ptr, '%')) != NULL)
+    {
+        Spec_t spec;
+        ptr = ParseSpec(ptr, &spec);
+
+        int precision = spec.precision;
+
+        if (spec.type == ARG_UNSUPPORTED)
+        {
+            return false;
+        }
+
+        if (spec.widthIsArg)
+        {
+            PUT_ARG(int);
+        }
+
+        if (spec.precisionIsArg)
+        {
+            precision = va_arg(args, int);
+            if (!PutValue(recPtr, &offset, &precision, sizeof(precision)))
+            {
+                return false;
+            }
+        }
+
+        switch (spec.type)
+        {
+            case ARG_NONE:
+                break;
+
+            case ARG_INT:
+                PUT_ARG(int);
+                break;
+
+            case ARG_LONG:
+                PUT_ARG(long);
+                break;
+
+            case ARG_LLONG:
+                PUT_ARG(long long);
+                break;
+
+            case ARG_INTMAX:
+                PUT_ARG(intmax_t);
+                break;
+
+            case ARG_SIZE:
+                PUT_ARG(size_t);
+                break;
+
+            case ARG_PTRDIFF:
+                PUT_ARG(ptrdiff_t);
+                break;
+
+            case ARG_DOUBLE:
+                PUT_ARG(double);
+                break;
+
+            case ARG_LDOUBLE:
+                PUT_ARG(long double);
+                break;
+
+            case ARG_PTR:
+                PUT_ARG(void*);
+                break;
+
+            case ARG_STR:
+            {
+                const char* strPtr = va_arg(args, const char*);
+                if (strPtr == NULL)
+                {
+                    strPtr = "(null)";
+                }
+
+                // Only copy as much as will be printed.  The string needn't be null-terminated
+                // if a precision is given.
+                size_t room = sizeof(recPtr->data) - offset;
+                size_t maxLen = ((precision >= 0) && ((size_t)precision < room)) ? precision
+                                                                                    : room;
+                size_t len = strnlen(strPtr, maxLen);
+
+                if (len >= room)
+                {
+                    return false;
+                }
+
+                memcpy(recPtr->data + offset, strPtr, len);
+                recPtr->data[offset + len] = '\0';
+                offset += len + 1;
+                break;
+            }
+
+            case ARG_UNSUPPORTED:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a value from a record's argument data.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void GetValue
+(
+    const Record_t* recPtr,
+    size_t* offsetPtr,
+    void* valuePtr,
+    size_t size
+)
+//--------------------------------------------------------------------------------------------------
+{
+    memcpy(valuePtr, recPtr->data + *offsetPtr, size);
+    *offsetPtr += size;
+}
+
+
+/// Formats a conversion with an argument of a given type read from the record.
+#define FORMAT_ARG(type)                                                                \
+    {                                                                                   \
+        type value;                                                                     \
+        GetValue(recPtr, &offset, &value, sizeof(value));                               \
+        n = snprintf(bufPtr + len, bufSize - len, specStr, value);                      \
+    }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats the user message of a record whose arguments were captured by CaptureArgs().
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatRecord
+(
+    const Record_t* recPtr,
+    char* bufPtr,
+    size_t bufSize
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+    size_t len = 0;
+    const char* ptr = recPtr->formatPtr;
+
+    bufPtr[0] = '\0';
+
+    while (len < (bufSize - 1))
+    {
+        // Copy the literal text up to the next conversion.
+        const char* specStartPtr = strchrnul(ptr, '%');
+        size_t literalLen = specStartPtr - ptr;
+
+        if (literalLen > (bufSize - 1 - len))
+        {
+            literalLen = bufSize - 1 - len;
+        }
+        memcpy(bufPtr + len, ptr, literalLen);
+        len += literalLen;
+        bufPtr[len] = '\0';
+
+        if (*specStartPtr == '\0')
+        {
+            break;
+        }
+
+        Spec_t spec;
+        ptr = ParseSpec(specStartPtr, &spec);
+
+        // Rebuild the specification with any field width or precision arguments filled in.
+        char specStr[MAX_SPEC_BYTES * 2];
+        size_t specLen = spec.widthPtr - spec.startPtr;
+        memcpy(specStr, spec.startPtr, specLen);
+
+        if (spec.widthIsArg)
+        {
+            int width;
+            GetValue(recPtr, &offset, &width, sizeof(width));
+            specLen += snprintf(specStr + specLen, sizeof(specStr) - specLen, "%d", width);
+        }
+        else
+        {
+            const char* widthEndPtr = (spec.precisionPtr != NULL) ? spec.precisionPtr - 1
+                                                                  : spec.lengthPtr;
+            memcpy(specStr + specLen, spec.widthPtr, widthEndPtr - spec.widthPtr);
+            specLen += widthEndPtr - spec.widthPtr;
+        }
+
+        if (spec.precisionIsArg)
+        {
+            int precision;
+            GetValue(recPtr, &offset, &precision, sizeof(precision));
+
+            // A negative precision is taken as if it were omitted.
+            if (precision >= 0)
+            {
+                specLen += snprintf(specStr + specLen, sizeof(specStr) - specLen, ".%d",
+                                    precision);
+            }
+        }
+        else if (spec.precisionPtr != NULL)
+        {
+            specStr[specLen++] = '.';
+            memcpy(specStr + specLen, spec.precisionPtr, spec.lengthPtr - spec.precisionPtr);
+            specLen += spec.lengthPtr - spec.precisionPtr;
+        }
+
+        memcpy(specStr + specLen, spec.lengthPtr, spec.endPtr - spec.lengthPtr);
+        specLen += spec.endPtr - spec.lengthPtr;
+        specStr[specLen] = '\0';
+
+        int n = 0;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+        switch (spec.type)
+        {
+            case ARG_NONE:
+                errno = recPtr->errNum;
+                n = snprintf(bufPtr + len, bufSize - len, specStr, 0);
+                break;
+
+            case ARG_INT:
+                FORMAT_ARG(int);
+                break;
+
+            case ARG_LONG:
+                FORMAT_ARG(long);
+                break;
+
+            case ARG_LLONG:
+                FORMAT_ARG(long long);
+                break;
+
+            case ARG_INTMAX:
+                FORMAT_ARG(intmax_t);
+                break;
+
+            case ARG_SIZE:
+                FORMAT_ARG(size_t);
+                break;
+
+            case ARG_PTRDIFF:
+                FORMAT_ARG(ptrdiff_t);
+                break;
+
+            case ARG_DOUBLE:
+                FORMAT_ARG(double);
+                break;
+
+            case ARG_LDOUBLE:
+                FORMAT_ARG(long double);
+                break;
+
+            case ARG_PTR:
+                FORMAT_ARG(void*);
+                break;
+
+            case ARG_STR:
+            {
+                const char* strPtr = (const char*)(recPtr->data + offset);
+                offset += strlen(strPtr) + 1;
+                n = snprintf(bufPtr + len, bufSize - len, specStr, strPtr);
+                break;
+            }
+
+            case ARG_UNSUPPORTED:
+                // Can't happen; CaptureArgs() would have failed.
+                break;
+        }
+#pragma GCC diagnostic pop
+
+        if (n > 0)
+        {
+            len += n;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Consumes all the records that are ready, writing them out.
+ *
+ * @note    Must be called with the ConsumerMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConsumeRecords
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char msg[LOG_MAX_MSG_SIZE];
+
+    for (;;)
+    {
+        Record_t* recPtr = &RecordsPtr[Tail & SlotMask];
+
+        if (__atomic_load_n(&recPtr->seq, __ATOMIC_ACQUIRE) != (Tail + 1))
+        {
+            // Empty, or the next record is still being written.
+            return;
+        }
+
+        const char* msgPtr = msg;
+
+        if (recPtr->isFormatted)
+        {
+            msgPtr = (const char*)recPtr->data;
+        }
+        else
+        {
+            FormatRecord(recPtr, msg, sizeof(msg));
+        }
+
+        WriteFunc(recPtr->level,
+                  recPtr->levelPtr,
+                  recPtr->compNamePtr,
+                  recPtr->threadName,
+                  recPtr->fileNamePtr,
+                  recPtr->functionNamePtr,
+                  recPtr->lineNumber,
+                  &recPtr->time,
+                  msgPtr);
+
+        // Hand the slot back to the producers, for use one lap later.
+        __atomic_store_n(&recPtr->seq, Tail + SlotMask + 1, __ATOMIC_RELEASE);
+        Tail++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether the next record is ready to be consumed.
+ *
+ * @note    Must be called with the ConsumerMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRecordReady
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (__atomic_load_n(&RecordsPtr[Tail & SlotMask].seq, __ATOMIC_ACQUIRE) == (Tail + 1));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the log buffer thread.  Writes out records as they are added.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LogBufferThreadMain
+(
+    void* contextPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    (void)contextPtr;
+
+    // This thread doesn't handle signals.  (It may have been started before the process got a
+    // chance to block the signals it handles through the Signal Events API.)
+    sigset_t sigSet;
+    sigfillset(&sigSet);
+    pthread_sigmask(SIG_BLOCK, &sigSet, NULL);
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ConsumerMutex);
+
+        ConsumeRecords();
+
+        // Tell the producers to wake this thread up, then check one last time for records
+        // published before they could see that.
+        __atomic_store_n(&IsThreadAsleep, true, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        bool isReady = IsRecordReady();
+
+        pthread_mutex_unlock(&ConsumerMutex);
+
+        // If a producer has already cleared the flag, it has posted (or will post) the semaphore.
+        if (!isReady || !__atomic_exchange_n(&IsThreadAsleep, false, __ATOMIC_SEQ_CST))
+        {
+            while ((sem_wait(&WakeUpSem) != 0) && (errno == EINTR))
+            {
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the log buffer thread, if it isn't running already.
+ *
+ * @return  false if the thread couldn't be started.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StartThread
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isStarted = false;
+
+    if (!__atomic_compare_exchange_n(&IsThreadStarted, &isStarted, true, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return true;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    int result = pthread_create(&thread, &attr, LogBufferThreadMain, NULL);
+
+    pthread_attr_destroy(&attr);
+
+    if (result != 0)
+    {
+        __atomic_store_n(&IsThreadStarted, false, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    pthread_setname_np(thread, "logBuffer");
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called before the process forks.  Writes out everything buffered so far, and keeps other
+ * threads from consuming records until the fork is done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrepareFork
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    pthread_mutex_lock(&ConsumerMutex);
+    ConsumeRecords();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the parent process after a fork.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParentAfterFork
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    pthread_mutex_unlock(&ConsumerMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the child process after a fork.  Anything left in the ring buffer belongs to the
+ * parent, and the log buffer thread wasn't copied, so start over with an empty ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChildAfterFork
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i <= SlotMask; i++)
+    {
+        RecordsPtr[i].seq = i;
+    }
+
+    Head = 0;
+    Tail = 0;
+    IsThreadStarted = false;
+    IsThreadAsleep = false;
+    sem_init(&WakeUpSem, 0, 0);
+
+    pthread_mutex_unlock(&ConsumerMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out anything left in the ring buffer when the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushAtExit
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    logBuffer_Flush();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the Log Buffer module.  The ring buffer is only created if it has been enabled
+ * through the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBuffer_Init
+(
+    logBuffer_WriteFunc_t writeFunc     ///< [IN] Function that writes formatted messages out.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv(SLOTS_ENV_VAR);
+    int32_t slotCount;
+
+    WriteFunc = writeFunc;
+
+    if (envStrPtr == NULL)
+    {
+        return;
+    }
+
+    if ((le_utf8_ParseInt(&slotCount, envStrPtr) != LE_OK) || (slotCount < 0))
+    {
+        LE_WARN("Invalid log buffer size '%s' in %s.", envStrPtr, SLOTS_ENV_VAR);
+        return;
+    }
+
+    if (slotCount == 0)
+    {
+        return;
+    }
+
+    if (slotCount > MAX_SLOTS)
+    {
+        slotCount = MAX_SLOTS;
+    }
+
+    // Round up to a power of two.
+    size_t size = 1;
+    while (size < (size_t)slotCount)
+    {
+        size <<= 1;
+    }
+
+    Record_t* recordsPtr = malloc(size * sizeof(Record_t));
+    if (recordsPtr == NULL)
+    {
+        LE_WARN("Unable to allocate a log buffer of %zu records.", size);
+        return;
+    }
+
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        recordsPtr[i].seq = i;
+    }
+
+    SlotMask = size - 1;
+    sem_init(&WakeUpSem, 0, 0);
+
+    LE_ASSERT(pthread_atfork(PrepareFork, ParentAfterFork, ChildAfterFork) == 0);
+    atexit(FlushAtExit);
+
+    RecordsPtr = recordsPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether log messages are being buffered.
+ *
+ * @return true if the ring buffer is in use.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBuffer_IsEnabled
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (RecordsPtr != NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a record for a log message to the ring buffer.  The message is formatted later, by the
+ * process's log buffer thread.
+ *
+ * @warning The level and component name strings, the file and function names and the format
+ *          string must stay valid for the lifetime of the process.  String arguments are copied.
+ *
+ * @return
+ *      true if the message was buffered.
+ *      false if the ring buffer is full (or disabled), in which case the caller must write the
+ *      message out itself.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBuffer_Write
+(
+    le_log_Level_t level,               ///< [IN] Severity level (-1 for a trace message).
+    const char* levelPtr,               ///< [IN] Severity level or trace keyword string.
+    const char* compNamePtr,            ///< [IN] Component name.
+    const char* fileNamePtr,            ///< [IN] Base name of the source file.
+    const char* functionNamePtr,        ///< [IN] Name of the function that logged the message.
+    unsigned int lineNumber,            ///< [IN] Line number in the source file.
+    int errNum,                         ///< [IN] errno value to use for %m.
+    const char* formatPtr,              ///< [IN] The user message format.
+    va_list args                        ///< [IN] The user message arguments.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((RecordsPtr == NULL) || !StartThread())
+    {
+        return false;
+    }
+
+    // Claim the slot at the head of the ring.
+    size_t pos = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+    Record_t* recPtr;
+
+    for (;;)
+    {
+        recPtr = &RecordsPtr[pos & SlotMask];
+        intptr_t diff = (intptr_t)__atomic_load_n(&recPtr->seq, __ATOMIC_ACQUIRE) - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&Head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Full.
+            return false;
+        }
+        else
+        {
+            pos = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+        }
+    }
+
+    recPtr->level = level;
+    recPtr->levelPtr = levelPtr;
+    recPtr->compNamePtr = compNamePtr;
+    recPtr->fileNamePtr = fileNamePtr;
+    recPtr->functionNamePtr = functionNamePtr;
+    recPtr->lineNumber = lineNumber;
+    recPtr->errNum = errNum;
+    recPtr->formatPtr = formatPtr;
+    clock_gettime(CLOCK_REALTIME, &recPtr->time);
+    le_utf8_Copy(recPtr->threadName, le_thread_GetMyName(), sizeof(recPtr->threadName), NULL);
+
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    recPtr->isFormatted = !CaptureArgs(recPtr, formatPtr, argsCopy);
+    va_end(argsCopy);
+
+    if (recPtr->isFormatted)
+    {
+        size_t size = (sizeof(recPtr->data) < LOG_MAX_MSG_SIZE) ? sizeof(recPtr->data)
+                                                                : LOG_MAX_MSG_SIZE;
+        errno = errNum;
+        vsnprintf((char*)recPtr->data, size, formatPtr, args);
+    }
+
+    // Publish the record.
+    __atomic_store_n(&recPtr->seq, pos + 1, __ATOMIC_RELEASE);
+
+    // Wake up the log buffer thread if it's waiting.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&IsThreadAsleep, __ATOMIC_RELAXED)
+        && __atomic_exchange_n(&IsThreadAsleep, false, __ATOMIC_SEQ_CST))
+    {
+        sem_post(&WakeUpSem);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out all the messages in the ring buffer from the calling thread.  Called before writing
+ * out a message directly, so that messages aren't written out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBuffer_Flush
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (RecordsPtr == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&ConsumerMutex);
+    ConsumeRecords();
+    pthread_mutex_unlock(&ConsumerMutex);
+}
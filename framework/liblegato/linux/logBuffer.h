@@ -0,0 +1,105 @@
+/** @file logBuffer.h
+ *
+ * Log Buffer module's intra-framework header file.
+ *
+ * When enabled, log messages are not formatted and written out by the thread that logs them.
+ * Instead, that thread copies the format string pointer, the raw arguments, a timestamp and its
+ * name into a binary record in a lock-free ring buffer, and a background thread in the same
+ * process formats the records and writes them to the log.  This keeps vsnprintf() and syslog()
+ * off the logging thread's path.
+ *
+ * The ring buffer is enabled by setting the LE_LOG_BUFFER_SLOTS environment variable to the
+ * number of records it should hold (rounded up to a power of two).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LOG_BUFFER_INCLUDE_GUARD
+#define LOG_BUFFER_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that writes a formatted message out to the log.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logBuffer_WriteFunc_t)
+(
+    le_log_Level_t level,               ///< [IN] Severity level (-1 for a trace message).
+    const char* levelPtr,               ///< [IN] Severity level or trace keyword string.
+    const char* compNamePtr,            ///< [IN] Component name.
+    const char* threadNamePtr,          ///< [IN] Name of the thread that logged the message.
+    const char* fileNamePtr,            ///< [IN] Base name of the source file.
+    const char* functionNamePtr,        ///< [IN] Name of the function that logged the message.
+    unsigned int lineNumber,            ///< [IN] Line number in the source file.
+    const struct timespec* timePtr,     ///< [IN] When the message was logged.
+    const char* msgPtr                  ///< [IN] The formatted user message.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the Log Buffer module.  The ring buffer is only created if it has been enabled
+ * through the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBuffer_Init
+(
+    logBuffer_WriteFunc_t writeFunc     ///< [IN] Function that writes formatted messages out.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether log messages are being buffered.
+ *
+ * @return true if the ring buffer is in use.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBuffer_IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a record for a log message to the ring buffer.  The message is formatted later, by the
+ * process's log buffer thread.
+ *
+ * @warning The level and component name strings, the file and function names and the format
+ *          string must stay valid for the lifetime of the process.  String arguments are copied.
+ *
+ * @return
+ *      true if the message was buffered.
+ *      false if the ring buffer is full (or disabled), in which case the caller must write the
+ *      message out itself.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logBuffer_Write
+(
+    le_log_Level_t level,               ///< [IN] Severity level (-1 for a trace message).
+    const char* levelPtr,               ///< [IN] Severity level or trace keyword string.
+    const char* compNamePtr,            ///< [IN] Component name.
+    const char* fileNamePtr,            ///< [IN] Base name of the source file.
+    const char* functionNamePtr,        ///< [IN] Name of the function that logged the message.
+    unsigned int lineNumber,            ///< [IN] Line number in the source file.
+    int errNum,                         ///< [IN] errno value to use for %m.
+    const char* formatPtr,              ///< [IN] The user message format.
+    va_list args                        ///< [IN] The user message arguments.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out all the messages in the ring buffer from the calling thread.  Called before writing
+ * out a message directly, so that messages aren't written out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+void logBuffer_Flush
+(
+    void
+);
+
+
+#endif // LOG_BUFFER_INCLUDE_GUARD
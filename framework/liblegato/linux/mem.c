@@ -7,8 +7,9 @@
  * object, the number of blocks and objects in a memory pool are always the same.
  *
  * Memory for the memory blocks (including the user object) is allocated from system
- * memory when a memory pool is expanded.  Memory blocks are never released back to system memory.
- * Instead, when they are "free", they are kept on their pool's "free list".  The free list is
+ * memory when a memory pool is expanded.  Memory blocks are not released back to system memory
+ * when they are freed.  Instead, when they are "free", they are kept on their pool's "free list".
+ * The free list is
  * O(1) for both insertion and removal.  It is treated as a stack, in that blocks are popped from
  * the head of the free list when they are allocated and pushed back onto the head of the free
  * list when they are deallocated.  The hope is that this will speed things up by utilizing the
@@ -30,6 +31,41 @@
  * delete a sub-pool while there are still blocks allocated from it.  The sub-pool itself is then
  * removed from the list of pools and released back into the pool of sub-pools.
  *
+ * CHUNKS
+ * ======
+ *
+ * All the blocks added to a pool by a single expansion are allocated from system memory
+ * together, as one "chunk".  Each block records the chunk it came from, and each chunk counts
+ * how many of its blocks are on its pool's free list.  When all of a chunk's blocks are on the
+ * free list, the chunk is "idle" and can be released back to system memory, either explicitly
+ * (le_mem_Compact) or automatically when the pool has more free blocks than the maximum set by
+ * le_mem_SetMaxIdleBlocks.  Blocks in thread caches or in sub-pools are not on the free list,
+ * so they keep their chunks from being released.
+ *
+ * PER-THREAD BLOCK CACHES
+ * =======================
+ *
+ * To keep threads from contending on the module's mutex, each thread keeps a small cache of free
+ * blocks for the few pools it has most recently used.  Allocations pop blocks from the calling
+ * thread's cache and releases push them back onto it.  The pool's free list (and therefore the
+ * module mutex) is only touched when a cache needs to be refilled from, or flushed back to, the
+ * pool, which is done in batches of CACHE_BATCH_SIZE blocks.
+ *
+ * Each cache has its own mutex, which is only ever contended when another thread finds its own
+ * cache and the pool's free list empty and needs to take a block cached by another thread, or
+ * when a sub-pool is deleted and its blocks must be collected from all of the caches.  When a
+ * thread exits, all the blocks in its cache are returned to their pools.
+ *
+ * Blocks held in a thread cache are free (their reference count is zero), so they are counted as
+ * free in the pool statistics.  The statistics, and the blocks' reference counts, are updated
+ * using atomic operations so that they stay accurate without holding the module mutex.
+ *
+ * LOCK ORDERING
+ * -------------
+ *
+ * When more than one of these is held, they must be acquired in this order: CacheListMutex, a
+ * thread cache's mutex, then the module mutex (Mutex).
+ *
  * GUARD BANDS
  * ===========
  *
@@ -39,25 +75,50 @@
  * is unlikely to occur in normal data.  Whenever a block is allocated or released, the
  * guard bands are checked for corruption and any corruption is reported.
  *
+ * When "FILL_DELETED_AND_CHECK_ALLOCATED" is also defined, the user object part of free blocks
+ * can be filled with another pattern, which is checked when the block is allocated again, to
+ * catch objects being modified after they were released.
+ *
+ * Both are defined unless LE_MEM_CHECKS_DISABLE is defined in le_build_config.h, but whether or
+ * not they are used is decided at start-up, by reading the LE_MEM_CHECK environment variable
+ * (see CheckLevel).  Because the position of the user object in a block depends on whether
+ * there are guard bands, this is done once for the whole process, before any pool is created.
+ *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 #include "legato.h"
 #include "mem.h"
 #include "limit.h"
+#include "tracepoint.h"
 
-#define USE_GUARD_BAND
-#define FILL_DELETED_AND_CHECK_ALLOCATED
+#ifndef LE_MEM_CHECKS_DISABLE
+    #define USE_GUARD_BAND
+    #define FILL_DELETED_AND_CHECK_ALLOCATED
+#endif
 
 #define NUM_GUARD_BAND_WORDS 8
 #define GUARD_WORD ((uint32_t)0xDEADBEEF)
 #define GUARD_BAND_SIZE (sizeof(GUARD_WORD) * NUM_GUARD_BAND_WORDS)
 
+/// Byte value that free blocks' user objects are filled with at the full checking level.
+#define FREE_FILL_BYTE ((uint8_t)0xA5)
+
+/// Name of the environment variable used to select the checking level.
+#define CHECK_LEVEL_ENV_VAR "LE_MEM_CHECK"
+
 
 /// The maximum total pool name size, including the component prefix, which is a component
 /// name plus a '.' separator ("myComp.myPool") and the null terminator.
 #define MAX_POOL_NAME_BYTES (LIMIT_MAX_COMPONENT_NAME_LEN + 1 + LIMIT_MAX_MEM_POOL_NAME_BYTES)
 
+/// The object size of the smallest size class of a slab allocator.
+#define MIN_SLAB_CLASS_SIZE             16
+
+/// The maximum number of size classes in a slab allocator.  The largest object size supported by
+/// a slab allocator is MIN_SLAB_CLASS_SIZE << (MAX_SLAB_CLASSES - 1).
+#define MAX_SLAB_CLASSES                16
+
 /// The default number of Sub Pool objects in the Sub Pools Pool.
 /// @todo Make this configurable.
 #define DEFAULT_SUB_POOLS_POOL_SIZE     8
@@ -71,6 +132,40 @@
 #define DEFAULT_NUM_BLOCKS_TO_FORCE     1
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of different pools that can have blocks in a single thread's block cache at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_CACHE_SLOTS                 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of blocks moved at once between a pool's free list and a thread's block cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_BATCH_SIZE                8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The maximum number of free blocks of a single pool that a thread's block cache will hold.  When
+ * a release would go over this, a batch of blocks is flushed back onto the pool's free list.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_MAX_BLOCKS                (2 * CACHE_BATCH_SIZE)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One allocation in this many has its duration measured, for the allocation latency statistics.
+ * Must be a power of two.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALLOC_LATENCY_SAMPLE_PERIOD     64
+
+
 #ifdef LE_MEM_TRACE
     #undef le_mem_TryAlloc
     #undef le_mem_AssertAlloc
@@ -86,6 +181,63 @@
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory block checking levels.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    CHECK_LEVEL_NONE,           ///< "none": No checking.  No per-block overhead.
+    CHECK_LEVEL_GUARD_BANDS,    ///< "guard": Guard bands are checked on allocation and release.
+    CHECK_LEVEL_FULL            ///< "full": Guard bands are checked, and released objects are
+                                ///  filled with a pattern that is checked on allocation.
+}
+CheckLevel_t;
+
+
+#ifdef USE_GUARD_BAND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * The checking level of this process.  Defaults to guard bands, and is set by mem_Init() from
+     * the LE_MEM_CHECK environment variable.
+     */
+    //----------------------------------------------------------------------------------------------
+    static CheckLevel_t CheckLevel = CHECK_LEVEL_GUARD_BANDS;
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Size of each of the two guard bands in every block (0 if guard bands are not used).
+     */
+    //----------------------------------------------------------------------------------------------
+    static size_t GuardBandSize = GUARD_BAND_SIZE;
+
+    #define GUARD_BAND_OFFSET   GuardBandSize
+#else
+    // Compile the checks out completely.
+    #define CheckLevel          CHECK_LEVEL_NONE
+    #define GUARD_BAND_OFFSET   ((size_t)0)
+#endif
+
+
+#ifndef LE_MEM_VALGRIND
+//--------------------------------------------------------------------------------------------------
+/**
+ * Definition of a chunk of memory blocks.  The chunk's blocks follow this header in memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct MemChunk
+{
+    le_dls_Link_t   link;           ///< This chunk's link in its pool's list of chunks.
+    MemPool_t*      poolPtr;        ///< The pool that the chunk was added to (never a sub-pool).
+    size_t          numBlocks;      ///< Number of blocks in the chunk.
+    size_t          numFreeBlocks;  ///< Number of the chunk's blocks on its pool's free list.
+    bool            isReleasing;    ///< true if the chunk is about to be released.
+}
+MemChunk_t;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Definition of a memory block.
@@ -96,19 +248,37 @@ typedef struct
     #ifndef LE_MEM_VALGRIND
         le_sls_Link_t link;         ///< This block's link in the memory pool.
                                     ///  NOTE: Only used while free.
+        MemChunk_t* chunkPtr;       ///< The chunk that this block was allocated in.
     #endif
 
     MemPool_t* poolPtr;         ///< A pointer to the pool (or sub-pool) that this block belongs to.
 
     size_t refCount;            ///< The number of external references to this memory block's
-                                ///     user object. (0 = free)
+                                ///     user object. (0 = free)  Only accessed atomically.
 
     uint8_t  data[];            ///< This block's data content (Has a guard band at the
-                                ///     start and end if USE_GUARD_BAND is defined).
+                                ///     start and end if guard bands are being used).
 }
 MemBlock_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Definition of a slab allocator.
+ *
+ * Size class i holds objects of size MIN_SLAB_CLASS_SIZE << i, except for the last one, which
+ * holds objects of the slab allocator's maximum object size.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_mem_Slab
+{
+    size_t              maxObjSize;                     ///< Size of the largest object.
+    size_t              numClasses;                     ///< Number of size classes.
+    le_mem_PoolRef_t    classPools[MAX_SLAB_CLASSES];   ///< The size classes' pools.
+}
+MemSlab_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Local list of all memory pools created with le_mem_CreatePool and le_mem_CreateSubPool
@@ -143,6 +313,64 @@ static le_mem_PoolRef_t SubPoolsPool;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
+#ifndef LE_MEM_VALGRIND
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A slot in a thread's block cache.  Holds free blocks belonging to a single pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MemPool_t*      poolPtr;        ///< The pool that the cached blocks belong to (NULL if unused).
+    le_sls_List_t   freeList;       ///< List of cached free blocks.
+    size_t          numBlocks;      ///< Number of blocks on the free list.
+}
+CacheSlot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's block cache.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;                   ///< This cache's link in the CacheList.
+    pthread_mutex_t mutex;                  ///< Protects the slots.  Normally only ever locked by
+                                            ///  the thread that owns the cache.
+    size_t          nextVictim;             ///< Index of the next slot to evict when all are used.
+    CacheSlot_t     slots[NUM_CACHE_SLOTS]; ///< The cache slots.
+}
+ThreadCache_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of all the thread caches in this process.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t CacheList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex used to protect the CacheList.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t CacheListMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to store a pointer to the calling thread's block cache in thread-local storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t CacheKey;
+
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exposing the memory pool list; mainly for the Inspect tool.
@@ -199,6 +427,47 @@ static inline void Unlock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Locks the mutex for an operation on a given pool, counting in the pool's stats the times it
+ * has to wait for another thread to unlock it.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void LockPool
+(
+    MemPool_t*  poolPtr     ///< [IN] The pool.
+)
+{
+    int result = pthread_mutex_trylock(&Mutex);
+
+    if (result != 0)
+    {
+        LE_ASSERT(result == EBUSY);
+
+        __atomic_add_fetch(&(poolPtr->numLockWaits), 1, __ATOMIC_RELAXED);
+        Lock();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the current CLOCK_MONOTONIC time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t GetMonotonicNs
+(
+    void
+)
+{
+    struct timespec now;
+
+    LE_ASSERT(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+
 #ifdef USE_GUARD_BAND
 
     //----------------------------------------------------------------------------------------------
@@ -217,255 +486,986 @@ static inline void Unlock
         uint32_t* guardBandWordPtr = (uint32_t*)(blockHeaderPtr->data);
         for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
         {
-            *guardBandWordPtr = GUARD_WORD;
+            *guardBandWordPtr = GUARD_WORD;
+        }
+
+        // There's another guard band at the end of the data section.
+        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
+                                        + blockHeaderPtr->poolPtr->blockSize
+                                        - GUARD_BAND_SIZE );
+        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        {
+            *guardBandWordPtr = GUARD_WORD;
+        }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Checks the integrity of the guard bands in a memory block's data payload section.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void CheckGuardBands
+    (
+        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+    )
+    {
+        int i;
+
+        // There's a guard band at the start of the data section.
+        uint32_t* guardBandWordPtr = (uint32_t*)(blockHeaderPtr->data);
+        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        {
+            if (*guardBandWordPtr != GUARD_WORD)
+            {
+                LE_EMERG("Memory corruption detected at address %p before object allocated"
+                                                                                " from pool '%s'.",
+                         guardBandWordPtr,
+                         blockHeaderPtr->poolPtr->name);
+                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
+                         GUARD_WORD,
+                         *guardBandWordPtr);
+            }
+        }
+
+        // There's another guard band at the end of the data section.
+        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
+                                        + blockHeaderPtr->poolPtr->blockSize
+                                        - GUARD_BAND_SIZE);
+        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        {
+            if (*guardBandWordPtr != GUARD_WORD)
+            {
+                LE_EMERG("Memory corruption detected at address %p at end of object allocated"
+                                                                                " from pool '%s'.",
+                         guardBandWordPtr,
+                         blockHeaderPtr->poolPtr->name);
+                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
+                         GUARD_WORD,
+                         *guardBandWordPtr);
+            }
+        }
+    }
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a pointer to the user object in a memory block.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void* GetUserPtr
+(
+    MemBlock_t* blockPtr    ///< [IN] Pointer to the block.
+)
+{
+    return blockPtr->data + GUARD_BAND_OFFSET;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a pointer to the memory block that contains a user object.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline MemBlock_t* GetBlockPtr
+(
+    void*   objPtr          ///< [IN] Pointer to the user object.
+)
+{
+    return CONTAINER_OF(((uint8_t*)objPtr) - GUARD_BAND_OFFSET, MemBlock_t, data);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the integrity of a memory block's guard bands, if guard bands are being used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CheckBlock
+(
+    MemBlock_t* blockPtr    ///< [IN] Pointer to the block.
+)
+{
+    #ifdef USE_GUARD_BAND
+        if (CheckLevel != CHECK_LEVEL_NONE)
+        {
+            CheckGuardBands(blockPtr);
+        }
+    #endif
+}
+
+
+#ifdef FILL_DELETED_AND_CHECK_ALLOCATED
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Fills a free memory block's user object with the free fill pattern.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FillFreeBlock
+    (
+        MemBlock_t* blockPtr    ///< [IN] Pointer to the block.
+    )
+    {
+        memset(GetUserPtr(blockPtr), FREE_FILL_BYTE, blockPtr->poolPtr->userDataSize);
+    }
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Checks that a free memory block's user object still holds the free fill pattern.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void CheckFreeBlockFill
+    (
+        MemBlock_t* blockPtr    ///< [IN] Pointer to the block.
+    )
+    {
+        uint8_t* bytePtr = GetUserPtr(blockPtr);
+        size_t i;
+
+        for (i = 0; i < blockPtr->poolPtr->userDataSize; i++)
+        {
+            if (bytePtr[i] != FREE_FILL_BYTE)
+            {
+                LE_EMERG("Memory corruption detected at address %p in free object from pool '%s'.",
+                         &(bytePtr[i]),
+                         blockPtr->poolPtr->name);
+                LE_FATAL("Object was modified after it was released (byte %zu is 0x%02X).",
+                         i,
+                         bytePtr[i]);
+            }
+        }
+    }
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the checking level to use from the environment.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitCheckLevel
+(
+    void
+)
+{
+    #ifdef USE_GUARD_BAND
+        const char* envStrPtr = getenv(CHECK_LEVEL_ENV_VAR);
+
+        if (envStrPtr == NULL)
+        {
+            return;
+        }
+
+        if (strcmp(envStrPtr, "none") == 0)
+        {
+            CheckLevel = CHECK_LEVEL_NONE;
+        }
+        else if (strcmp(envStrPtr, "guard") == 0)
+        {
+            CheckLevel = CHECK_LEVEL_GUARD_BANDS;
+        }
+        else if (strcmp(envStrPtr, "full") == 0)
+        {
+            #ifdef FILL_DELETED_AND_CHECK_ALLOCATED
+                CheckLevel = CHECK_LEVEL_FULL;
+            #else
+                CheckLevel = CHECK_LEVEL_GUARD_BANDS;
+            #endif
+        }
+        else
+        {
+            LE_WARN("Invalid memory checking level '%s' in %s.", envStrPtr, CHECK_LEVEL_ENV_VAR);
+        }
+
+        GuardBandSize = (CheckLevel == CHECK_LEVEL_NONE ? 0 : GUARD_BAND_SIZE);
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes a memory pool.
+ *
+ * @warning Called without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitPool
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] The pool to initialize.
+    const char*      componentName, ///< [IN] Name of the component.
+    const char*         name,       ///< [IN] Name of the pool inside the component.
+    size_t              objSize     ///< [IN] The size of the individual objects to be allocated
+                                    ///       from this pool in bytes.
+)
+{
+    // Construct the component-scoped pool name.
+    size_t nameSize = snprintf(pool->name, sizeof(pool->name), "%s.%s", componentName, name);
+    if (nameSize >= sizeof(pool->name))
+    {
+        LE_DEBUG("Memory pool name '%s.%s' is truncated to '%s'", componentName, name, pool->name);
+    }
+
+    // Compute the total block size.
+    size_t blockSize = sizeof(MemBlock_t) + objSize;
+
+    // Add guard bands around the user data in every block (if they are being used).
+    blockSize += (GUARD_BAND_OFFSET * 2);
+
+    // Round up the block size to the nearest multiple of the processor word size.
+    size_t remainder = blockSize % sizeof(void*);
+    if (remainder != 0)
+    {
+        blockSize += (sizeof(void*) - remainder);
+    }
+
+    pool->poolLink = LE_DLS_LINK_INIT;
+
+    #ifndef LE_MEM_VALGRIND
+        pool->freeList = LE_SLS_LIST_INIT;
+        pool->numFreeBlocks = 0;
+        pool->chunkList = LE_DLS_LIST_INIT;
+        pool->numIdleChunks = 0;
+        pool->maxIdleBlocks = SIZE_MAX;
+    #endif
+
+    pool->userDataSize = objSize;
+    pool->blockSize = blockSize;
+    pool->destructor = NULL;
+    pool->superPoolPtr = NULL;
+    pool->numAllocations = 0;
+    pool->numOverflows = 0;
+    pool->totalBlocks = 0;
+    pool->numBlocksInUse = 0;
+    pool->maxNumBlocksUsed = 0;
+    pool->numBlocksToForce = DEFAULT_NUM_BLOCKS_TO_FORCE;
+    pool->numLockWaits = 0;
+    pool->numLatencySamples = 0;
+    pool->allocLatencySumNs = 0;
+    pool->statsResetTimeNs = GetMonotonicNs();
+
+    #ifdef LE_MEM_TRACE
+        pool->memTrace = NULL;
+
+        if (LE_LOG_SESSION != NULL)
+        {
+            pool->memTrace = le_log_GetTraceRef(pool->name);
+            LE_DEBUG("Tracing enabled for pool '%s'.", pool->name);
+        }
+    #endif
+}
+
+
+#ifndef LE_MEM_VALGRIND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pushes a block onto a pool's free list.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void PushFreeBlock
+    (
+        MemPool_t*  poolPtr,    ///< [IN] The pool (or sub-pool) whose free list to push onto.
+        MemBlock_t* blockPtr    ///< [IN] The block.
+    )
+    {
+        MemChunk_t* chunkPtr = blockPtr->chunkPtr;
+
+        le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+        poolPtr->numFreeBlocks++;
+
+        // Blocks on a sub-pool's free list don't count as free in their chunks.
+        if (chunkPtr->poolPtr == poolPtr)
+        {
+            chunkPtr->numFreeBlocks++;
+
+            if (chunkPtr->numFreeBlocks == chunkPtr->numBlocks)
+            {
+                poolPtr->numIdleChunks++;
+            }
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pops a block off a pool's free list.
+     *
+     * @return Pointer to the block, or NULL if the free list is empty.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static MemBlock_t* PopFreeBlock
+    (
+        MemPool_t*  poolPtr     ///< [IN] The pool (or sub-pool) whose free list to pop from.
+    )
+    {
+        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(poolPtr->freeList));
+
+        if (blockLinkPtr == NULL)
+        {
+            return NULL;
+        }
+
+        MemBlock_t* blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+        MemChunk_t* chunkPtr = blockPtr->chunkPtr;
+
+        poolPtr->numFreeBlocks--;
+
+        if (chunkPtr->poolPtr == poolPtr)
+        {
+            if (chunkPtr->numFreeBlocks == chunkPtr->numBlocks)
+            {
+                poolPtr->numIdleChunks--;
+            }
+
+            chunkPtr->numFreeBlocks--;
+        }
+
+        return blockPtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Releases idle chunks of a pool back to system memory, as long as the pool is left with at
+     * least a given number of free blocks.
+     *
+     * @return The number of blocks released.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static size_t CompactPool
+    (
+        MemPool_t*  poolPtr,        ///< [IN] The pool.  Must not be a sub-pool.
+        size_t      minFreeBlocks   ///< [IN] Minimum number of free blocks to leave in the pool.
+    )
+    {
+        if (poolPtr->numIdleChunks == 0)
+        {
+            return 0;
+        }
+
+        // Pick the chunks to release.
+        size_t numFreeBlocks = poolPtr->numFreeBlocks;
+        size_t numReleased = 0;
+
+        le_dls_Link_t* linkPtr = le_dls_Peek(&(poolPtr->chunkList));
+
+        while (linkPtr != NULL)
+        {
+            MemChunk_t* chunkPtr = CONTAINER_OF(linkPtr, MemChunk_t, link);
+
+            // Note: The blocks of an idle chunk are all on the free list, so this can't wrap.
+            chunkPtr->isReleasing = (   (chunkPtr->numFreeBlocks == chunkPtr->numBlocks)
+                                     && (numFreeBlocks - numReleased - chunkPtr->numBlocks
+                                         >= minFreeBlocks) );
+
+            if (chunkPtr->isReleasing)
+            {
+                numReleased += chunkPtr->numBlocks;
+            }
+
+            linkPtr = le_dls_PeekNext(&(poolPtr->chunkList), linkPtr);
+        }
+
+        if (numReleased == 0)
+        {
+            return 0;
+        }
+
+        // Take the released chunks' blocks off the free list, keeping the others in order.
+        le_sls_List_t keptList = LE_SLS_LIST_INIT;
+        le_sls_Link_t* blockLinkPtr;
+
+        while ((blockLinkPtr = le_sls_Pop(&(poolPtr->freeList))) != NULL)
+        {
+            MemBlock_t* blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+
+            if (!blockPtr->chunkPtr->isReleasing)
+            {
+                le_sls_Queue(&keptList, blockLinkPtr);
+            }
+        }
+
+        poolPtr->freeList = keptList;
+        poolPtr->numFreeBlocks -= numReleased;
+        poolPtr->totalBlocks -= numReleased;
+
+        // Release the chunks.
+        linkPtr = le_dls_Peek(&(poolPtr->chunkList));
+
+        while (linkPtr != NULL)
+        {
+            MemChunk_t* chunkPtr = CONTAINER_OF(linkPtr, MemChunk_t, link);
+
+            linkPtr = le_dls_PeekNext(&(poolPtr->chunkList), linkPtr);
+
+            if (chunkPtr->isReleasing)
+            {
+                le_dls_Remove(&(poolPtr->chunkList), &(chunkPtr->link));
+                poolPtr->numIdleChunks--;
+                free(chunkPtr);
+            }
+        }
+
+        LE_DEBUG("Released %zu free blocks of memory pool '%s' (%zu blocks left).",
+                 numReleased,
+                 poolPtr->name,
+                 poolPtr->totalBlocks);
+
+        return numReleased;
+    }
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the specified number of blocks from the source pool to the destination pool.
+ *
+ * @note
+ *      Does not update the total number of blocks for either pool.
+ *
+ * @note
+ *      Assumes that the mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MoveBlocks
+(
+    le_mem_PoolRef_t    destPool,   ///< [IN] The pool to move the blocks to.
+    le_mem_PoolRef_t    srcPool,    ///< [IN] The pool to get the blocks from.
+    size_t              numBlocks   ///< [IN] The maximum number of blocks to move.
+)
+{
+    #ifndef LE_MEM_VALGRIND
+        size_t i = 0;
+        while (i < numBlocks)
+        {
+            MemBlock_t* blockPtr = PopFreeBlock(srcPool);
+
+            if (blockPtr == NULL)
+            {
+                LE_FATAL("Asked to move %zu blocks from pool '%s' to pool '%s', "
+                         "but only %zu were available.",
+                         numBlocks,
+                         srcPool->name,
+                         destPool->name,
+                         i);
+            }
+
+            // Add the block to the destination pool.
+            PushFreeBlock(destPool, blockPtr);
+
+            // Update the blocks parent pool.
+            blockPtr->poolPtr = destPool;
+
+            i++;
+        }
+    #endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a new pool block.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitBlock
+(
+    le_mem_PoolRef_t pool,       ///< [IN] The pool the new block belongs to.
+    MemBlock_t* newBlockPtr      ///< [IN] The block being initialized.
+)
+{
+    // Initialize the block.
+    #ifndef LE_MEM_VALGRIND
+        newBlockPtr->link = LE_SLS_LINK_INIT;
+    #endif
+
+    newBlockPtr->refCount = 0;
+    newBlockPtr->poolPtr = pool;
+
+    #ifdef USE_GUARD_BAND
+        if (CheckLevel != CHECK_LEVEL_NONE)
+        {
+            InitGuardBands(newBlockPtr);
+        }
+    #endif
+
+    #ifdef FILL_DELETED_AND_CHECK_ALLOCATED
+        if (CheckLevel == CHECK_LEVEL_FULL)
+        {
+            FillFreeBlock(newBlockPtr);
+        }
+    #endif
+}
+
+
+#ifndef LE_MEM_VALGRIND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Allocates a chunk of new blocks and adds them to the pool.
+     *
+     * @note
+     *      Updates the pools total number of blocks.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void AddBlocks
+    (
+        le_mem_PoolRef_t    pool,       ///< [IN] The pool to be expanded.
+        size_t              numBlocks   ///< [IN] The number of blocks to add to the pool.
+    )
+    {
+        size_t i;
+        size_t blockSize = pool->blockSize;
+        size_t mallocSize = sizeof(MemChunk_t) + numBlocks * blockSize;
+
+        // Allocate the chunk.
+        MemChunk_t* chunkPtr = malloc(mallocSize);
+
+        LE_ASSERT(chunkPtr);
+
+        chunkPtr->link = LE_DLS_LINK_INIT;
+        chunkPtr->poolPtr = pool;
+        chunkPtr->numBlocks = numBlocks;
+        chunkPtr->numFreeBlocks = 0;
+        chunkPtr->isReleasing = false;
+        le_dls_Queue(&(pool->chunkList), &(chunkPtr->link));
+
+        // The blocks follow the chunk header.
+        MemBlock_t* newBlockPtr = (MemBlock_t*)(chunkPtr + 1);
+
+        for (i = 0; i < numBlocks; i++)
+        {
+            InitBlock(pool, newBlockPtr);
+            newBlockPtr->chunkPtr = chunkPtr;
+            PushFreeBlock(pool, newBlockPtr);
+
+            newBlockPtr = (MemBlock_t*)(((uint8_t*)newBlockPtr) + blockSize);
+        }
+
+        // Update the pool.
+        pool->totalBlocks += numBlocks;
+    }
+#endif
+
+
+#ifndef LE_MEM_VALGRIND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves blocks from a thread cache slot back onto its pool's free list.
+     *
+     * @note
+     *      Assumes that the cache's mutex is locked, but the module mutex is not.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FlushSlot
+    (
+        CacheSlot_t*    slotPtr,    ///< [IN] The slot to flush.
+        size_t          numBlocks   ///< [IN] The maximum number of blocks to flush.
+    )
+    {
+        MemPool_t* poolPtr = slotPtr->poolPtr;
+
+        if (numBlocks > slotPtr->numBlocks)
+        {
+            numBlocks = slotPtr->numBlocks;
+        }
+
+        slotPtr->numBlocks -= numBlocks;
+
+        LockPool(poolPtr);
+
+        while (numBlocks > 0)
+        {
+            PushFreeBlock(poolPtr,
+                          CONTAINER_OF(le_sls_Pop(&(slotPtr->freeList)), MemBlock_t, link));
+            numBlocks--;
+        }
+
+        // Give idle chunks back to the system if the pool has too many free blocks.
+        if ((poolPtr->numFreeBlocks > poolPtr->maxIdleBlocks) && (poolPtr->superPoolPtr == NULL))
+        {
+            CompactPool(poolPtr, poolPtr->maxIdleBlocks);
+        }
+
+        Unlock();
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves up to a batch of blocks from a pool's free list into a thread cache slot.
+     *
+     * @note
+     *      Assumes that the cache's mutex is locked, but the module mutex is not.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void RefillSlot
+    (
+        CacheSlot_t*    slotPtr     ///< [IN] The slot to refill.
+    )
+    {
+        MemPool_t* poolPtr = slotPtr->poolPtr;
+
+        LockPool(poolPtr);
+
+        size_t i;
+        for (i = 0; i < CACHE_BATCH_SIZE; i++)
+        {
+            MemBlock_t* blockPtr = PopFreeBlock(poolPtr);
+
+            if (blockPtr == NULL)
+            {
+                break;
+            }
+
+            le_sls_Stack(&(slotPtr->freeList), &(blockPtr->link));
+        }
+
+        Unlock();
+
+        slotPtr->numBlocks += i;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Called when a thread exits to give the blocks in its cache back to their pools.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void DeleteThreadCache
+    (
+        void* objPtr    ///< [IN] Pointer to the thread's cache.
+    )
+    {
+        ThreadCache_t* cachePtr = objPtr;
+
+        // Once the cache is off the list, no other thread can get at it.
+        LE_ASSERT(pthread_mutex_lock(&CacheListMutex) == 0);
+        le_dls_Remove(&CacheList, &(cachePtr->link));
+        LE_ASSERT(pthread_mutex_unlock(&CacheListMutex) == 0);
+
+        size_t i;
+        for (i = 0; i < NUM_CACHE_SLOTS; i++)
+        {
+            if (cachePtr->slots[i].poolPtr != NULL)
+            {
+                FlushSlot(&(cachePtr->slots[i]), cachePtr->slots[i].numBlocks);
+            }
+        }
+
+        LE_ASSERT(pthread_mutex_destroy(&(cachePtr->mutex)) == 0);
+        free(cachePtr);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the calling thread's block cache, creating it if the thread doesn't have one yet.
+     *
+     * @return Pointer to the cache.
+     */
+    //----------------------------------------------------------------------------------------------
+    static ThreadCache_t* GetThreadCache
+    (
+        void
+    )
+    {
+        ThreadCache_t* cachePtr = pthread_getspecific(CacheKey);
+
+        if (cachePtr == NULL)
+        {
+            // Can't come from a memory pool, because it is needed to allocate from a memory pool.
+            cachePtr = calloc(1, sizeof(ThreadCache_t));
+            LE_ASSERT(cachePtr);
+
+            LE_ASSERT(pthread_mutex_init(&(cachePtr->mutex), NULL) == 0);
+            cachePtr->link = LE_DLS_LINK_INIT;
+
+            LE_ASSERT(pthread_mutex_lock(&CacheListMutex) == 0);
+            le_dls_Queue(&CacheList, &(cachePtr->link));
+            LE_ASSERT(pthread_mutex_unlock(&CacheListMutex) == 0);
+
+            LE_ASSERT(pthread_setspecific(CacheKey, cachePtr) == 0);
+        }
+
+        return cachePtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the slot in a thread cache that holds blocks for a given pool.  If no slot is assigned
+     * to the pool yet, a slot is assigned to it, evicting the blocks of another pool if necessary.
+     *
+     * @return Pointer to the slot.
+     *
+     * @note
+     *      Assumes that the cache's mutex is locked, but the module mutex is not.
+     */
+    //----------------------------------------------------------------------------------------------
+    static CacheSlot_t* GetCacheSlot
+    (
+        ThreadCache_t*  cachePtr,   ///< [IN] The thread's cache.
+        MemPool_t*      poolPtr     ///< [IN] The pool.
+    )
+    {
+        CacheSlot_t* freeSlotPtr = NULL;
+
+        size_t i;
+        for (i = 0; i < NUM_CACHE_SLOTS; i++)
+        {
+            CacheSlot_t* slotPtr = &(cachePtr->slots[i]);
+
+            if (slotPtr->poolPtr == poolPtr)
+            {
+                return slotPtr;
+            }
+
+            if ((slotPtr->poolPtr == NULL) && (freeSlotPtr == NULL))
+            {
+                freeSlotPtr = slotPtr;
+            }
         }
 
-        // There's another guard band at the end of the data section.
-        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
-                                        + blockHeaderPtr->poolPtr->blockSize
-                                        - GUARD_BAND_SIZE );
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        if (freeSlotPtr == NULL)
         {
-            *guardBandWordPtr = GUARD_WORD;
+            // All slots are in use, so give the blocks in one of them back to their pool.
+            freeSlotPtr = &(cachePtr->slots[cachePtr->nextVictim]);
+            cachePtr->nextVictim = (cachePtr->nextVictim + 1) % NUM_CACHE_SLOTS;
+
+            FlushSlot(freeSlotPtr, freeSlotPtr->numBlocks);
         }
+
+        freeSlotPtr->poolPtr = poolPtr;
+        freeSlotPtr->freeList = LE_SLS_LIST_INIT;
+        freeSlotPtr->numBlocks = 0;
+
+        return freeSlotPtr;
     }
 
+
     //----------------------------------------------------------------------------------------------
     /**
-     * Checks the integrity of the guard bands in a memory block's data payload section.
+     * Takes a free block of a given pool from another thread's cache.  Used when the pool's free
+     * list and the calling thread's cache are both empty.
+     *
+     * @return Pointer to the block, or NULL if no other thread has a free block of this pool.
+     *
+     * @note
+     *      Assumes that no mutexes are locked.
      */
     //----------------------------------------------------------------------------------------------
-    static void CheckGuardBands
+    static MemBlock_t* StealCachedBlock
     (
-        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+        ThreadCache_t*  ownCachePtr,    ///< [IN] The calling thread's cache.
+        MemPool_t*      poolPtr         ///< [IN] The pool.
     )
     {
-        int i;
+        le_sls_Link_t* blockLinkPtr = NULL;
 
-        // There's a guard band at the start of the data section.
-        uint32_t* guardBandWordPtr = (uint32_t*)(blockHeaderPtr->data);
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
-        {
-            if (*guardBandWordPtr != GUARD_WORD)
-            {
-                LE_EMERG("Memory corruption detected at address %p before object allocated"
-                                                                                " from pool '%s'.",
-                         guardBandWordPtr,
-                         blockHeaderPtr->poolPtr->name);
-                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
-                         GUARD_WORD,
-                         *guardBandWordPtr);
-            }
-        }
+        LE_ASSERT(pthread_mutex_lock(&CacheListMutex) == 0);
 
-        // There's another guard band at the end of the data section.
-        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
-                                        + blockHeaderPtr->poolPtr->blockSize
-                                        - GUARD_BAND_SIZE);
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        le_dls_Link_t* linkPtr = le_dls_Peek(&CacheList);
+
+        while ((linkPtr != NULL) && (blockLinkPtr == NULL))
         {
-            if (*guardBandWordPtr != GUARD_WORD)
+            ThreadCache_t* cachePtr = CONTAINER_OF(linkPtr, ThreadCache_t, link);
+
+            if (cachePtr != ownCachePtr)
             {
-                LE_EMERG("Memory corruption detected at address %p at end of object allocated"
-                                                                                " from pool '%s'.",
-                         guardBandWordPtr,
-                         blockHeaderPtr->poolPtr->name);
-                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
-                         GUARD_WORD,
-                         *guardBandWordPtr);
+                LE_ASSERT(pthread_mutex_lock(&(cachePtr->mutex)) == 0);
+
+                size_t i;
+                for (i = 0; i < NUM_CACHE_SLOTS; i++)
+                {
+                    CacheSlot_t* slotPtr = &(cachePtr->slots[i]);
+
+                    if ((slotPtr->poolPtr == poolPtr) && (slotPtr->numBlocks > 0))
+                    {
+                        blockLinkPtr = le_sls_Pop(&(slotPtr->freeList));
+                        slotPtr->numBlocks--;
+                        break;
+                    }
+                }
+
+                LE_ASSERT(pthread_mutex_unlock(&(cachePtr->mutex)) == 0);
             }
+
+            linkPtr = le_dls_PeekNext(&CacheList, linkPtr);
         }
-    }
 
-#endif
+        LE_ASSERT(pthread_mutex_unlock(&CacheListMutex) == 0);
 
+        if (blockLinkPtr == NULL)
+        {
+            return NULL;
+        }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Initializes a memory pool.
- *
- * @warning Called without the mutex locked.
- */
-//--------------------------------------------------------------------------------------------------
-static void InitPool
-(
-    le_mem_PoolRef_t    pool,       ///< [IN] The pool to initialize.
-    const char*      componentName, ///< [IN] Name of the component.
-    const char*         name,       ///< [IN] Name of the pool inside the component.
-    size_t              objSize     ///< [IN] The size of the individual objects to be allocated
-                                    ///       from this pool in bytes.
-)
-{
-    // Construct the component-scoped pool name.
-    size_t nameSize = snprintf(pool->name, sizeof(pool->name), "%s.%s", componentName, name);
-    if (nameSize >= sizeof(pool->name))
-    {
-        LE_DEBUG("Memory pool name '%s.%s' is truncated to '%s'", componentName, name, pool->name);
+        return CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
     }
 
-    // Compute the total block size.
-    size_t blockSize = sizeof(MemBlock_t) + objSize;
-
-    #ifdef USE_GUARD_BAND
-    {
-        // Add guard bands around the user data in every block.
-        blockSize += (GUARD_BAND_SIZE * 2);
-    }
-    #endif
 
-    // Round up the block size to the nearest multiple of the processor word size.
-    size_t remainder = blockSize % sizeof(void*);
-    if (remainder != 0)
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets a free block from a pool, using the calling thread's cache if possible.
+     *
+     * @return Pointer to the block, or NULL if the pool doesn't have any free blocks.
+     *
+     * @note
+     *      Assumes that no mutexes are locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static MemBlock_t* GetFreeBlock
+    (
+        MemPool_t*      poolPtr     ///< [IN] The pool.
+    )
     {
-        blockSize += (sizeof(void*) - remainder);
-    }
+        ThreadCache_t* cachePtr = GetThreadCache();
+        le_sls_Link_t* blockLinkPtr;
 
-    pool->poolLink = LE_DLS_LINK_INIT;
+        LE_ASSERT(pthread_mutex_lock(&(cachePtr->mutex)) == 0);
 
-    #ifndef LE_MEM_VALGRIND
-        pool->freeList = LE_SLS_LIST_INIT;
-    #endif
+        CacheSlot_t* slotPtr = GetCacheSlot(cachePtr, poolPtr);
 
-    pool->userDataSize = objSize;
-    pool->blockSize = blockSize;
-    pool->destructor = NULL;
-    pool->superPoolPtr = NULL;
-    pool->numAllocations = 0;
-    pool->numOverflows = 0;
-    pool->totalBlocks = 0;
-    pool->numBlocksInUse = 0;
-    pool->maxNumBlocksUsed = 0;
-    pool->numBlocksToForce = DEFAULT_NUM_BLOCKS_TO_FORCE;
+        if (slotPtr->numBlocks == 0)
+        {
+            RefillSlot(slotPtr);
+        }
 
-    #ifdef LE_MEM_TRACE
-        pool->memTrace = NULL;
+        blockLinkPtr = le_sls_Pop(&(slotPtr->freeList));
 
-        if (LE_LOG_SESSION != NULL)
+        if (blockLinkPtr != NULL)
         {
-            pool->memTrace = le_log_GetTraceRef(pool->name);
-            LE_DEBUG("Tracing enabled for pool '%s'.", pool->name);
+            slotPtr->numBlocks--;
         }
-    #endif
-}
-
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Moves the specified number of blocks from the source pool to the destination pool.
- *
- * @note
- *      Does not update the total number of blocks for either pool.
- *
- * @note
- *      Assumes that the mutex is locked.
- */
-//--------------------------------------------------------------------------------------------------
-static void MoveBlocks
-(
-    le_mem_PoolRef_t    destPool,   ///< [IN] The pool to move the blocks to.
-    le_mem_PoolRef_t    srcPool,    ///< [IN] The pool to get the blocks from.
-    size_t              numBlocks   ///< [IN] The maximum number of blocks to move.
-)
-{
-    #ifndef LE_MEM_VALGRIND
-        // Get the first block to move.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(srcPool->freeList));
+        LE_ASSERT(pthread_mutex_unlock(&(cachePtr->mutex)) == 0);
 
-        size_t i = 0;
-        while (i < numBlocks)
+        if (blockLinkPtr == NULL)
         {
-            if (blockLinkPtr == NULL)
-            {
-                LE_FATAL("Asked to move %zu blocks from pool '%s' to pool '%s', "
-                         "but only %zu were available.",
-                         numBlocks,
-                         srcPool->name,
-                         destPool->name,
-                         i);
-            }
+            // Other threads might still be holding free blocks in their caches.
+            return StealCachedBlock(cachePtr, poolPtr);
+        }
 
-            // Add the block to the destination pool.
-            le_sls_Stack(&(destPool->freeList), blockLinkPtr);
+        return CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+    }
 
-            // Update the blocks parent pool.
-            MemBlock_t* blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
-            blockPtr->poolPtr = destPool;
 
-            // Get the next block.
-            blockLinkPtr = le_sls_Pop(&(srcPool->freeList));
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Puts a free block into the calling thread's cache.
+     *
+     * @note
+     *      Assumes that no mutexes are locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void PutFreeBlock
+    (
+        MemBlock_t*     blockPtr    ///< [IN] The block.
+    )
+    {
+        ThreadCache_t* cachePtr = GetThreadCache();
 
-            i++;
-        }
-    #endif
-}
+        LE_ASSERT(pthread_mutex_lock(&(cachePtr->mutex)) == 0);
 
+        CacheSlot_t* slotPtr = GetCacheSlot(cachePtr, blockPtr->poolPtr);
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Initialize a new pool block.
- */
-//--------------------------------------------------------------------------------------------------
-static void InitBlock
-(
-    le_mem_PoolRef_t pool,       ///< [IN] The pool the new block belongs to.
-    MemBlock_t* newBlockPtr      ///< [IN] The block being initialized.
-)
-{
-    // Initialize the block.
-    #ifndef LE_MEM_VALGRIND
-        // Add the block to the pool's free list.
-        newBlockPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Stack(&(pool->freeList), &(newBlockPtr->link));
-    #endif
+        le_sls_Stack(&(slotPtr->freeList), &(blockPtr->link));
+        slotPtr->numBlocks++;
 
-    newBlockPtr->refCount = 0;
-    newBlockPtr->poolPtr = pool;
+        if (slotPtr->numBlocks > CACHE_MAX_BLOCKS)
+        {
+            FlushSlot(slotPtr, CACHE_BATCH_SIZE);
+        }
 
-    #ifdef USE_GUARD_BAND
-        InitGuardBands(newBlockPtr);
-    #endif
-}
+        LE_ASSERT(pthread_mutex_unlock(&(cachePtr->mutex)) == 0);
+    }
 
 
-#ifndef LE_MEM_VALGRIND
     //----------------------------------------------------------------------------------------------
     /**
-     * Creates blocks and adds them to the pool.
-     *
-     * @note
-     *      Updates the pools total number of blocks.
+     * Moves all the blocks of a given pool held in any thread's cache back onto the pool's free
+     * list.
      *
      * @note
-     *      Assumes that the mutex is locked.
+     *      Assumes that no mutexes are locked.
      */
     //----------------------------------------------------------------------------------------------
-    static void AddBlocks
+    static void DrainCaches
     (
-        le_mem_PoolRef_t    pool,       ///< [IN] The pool to be expanded.
-        size_t              numBlocks   ///< [IN] The number of blocks to add to the pool.
+        MemPool_t*      poolPtr     ///< [IN] The pool.
     )
     {
-        size_t i;
-        size_t blockSize = pool->blockSize;
-        size_t mallocSize = numBlocks * blockSize;
-
-        // Allocate the chunk.
-        MemBlock_t* newBlockPtr = malloc(mallocSize);
+        LE_ASSERT(pthread_mutex_lock(&CacheListMutex) == 0);
 
-        LE_ASSERT(newBlockPtr);
+        le_dls_Link_t* linkPtr = le_dls_Peek(&CacheList);
 
-        for (i = 0; i < numBlocks; i++)
+        while (linkPtr != NULL)
         {
-            InitBlock(pool, newBlockPtr);
-            newBlockPtr = (MemBlock_t*)(((uint8_t*)newBlockPtr) + blockSize);
+            ThreadCache_t* cachePtr = CONTAINER_OF(linkPtr, ThreadCache_t, link);
+
+            LE_ASSERT(pthread_mutex_lock(&(cachePtr->mutex)) == 0);
+
+            size_t i;
+            for (i = 0; i < NUM_CACHE_SLOTS; i++)
+            {
+                CacheSlot_t* slotPtr = &(cachePtr->slots[i]);
+
+                if (slotPtr->poolPtr == poolPtr)
+                {
+                    FlushSlot(slotPtr, slotPtr->numBlocks);
+                    slotPtr->poolPtr = NULL;
+                }
+            }
+
+            LE_ASSERT(pthread_mutex_unlock(&(cachePtr->mutex)) == 0);
+
+            linkPtr = le_dls_PeekNext(&CacheList, linkPtr);
         }
 
-        // Update the pool.
-        pool->totalBlocks += numBlocks;
+        LE_ASSERT(pthread_mutex_unlock(&CacheListMutex) == 0);
     }
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates the maximum number of blocks used in a pool, given its current number of blocks in use.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void UpdateMaxNumBlocksUsed
+(
+    MemPool_t*  poolPtr,        ///< [IN] The pool.
+    size_t      numBlocksInUse  ///< [IN] The pool's current number of blocks in use.
+)
+{
+    size_t maxNumBlocksUsed = __atomic_load_n(&(poolPtr->maxNumBlocksUsed), __ATOMIC_RELAXED);
+
+    while (   (numBlocksInUse > maxNumBlocksUsed)
+           && !__atomic_compare_exchange_n(&(poolPtr->maxNumBlocksUsed),
+                                           &maxNumBlocksUsed,
+                                           numBlocksInUse,
+                                           true,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+    {
+        // maxNumBlocksUsed now has the latest value, so try again.
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log an error message if there is another pool with the same name as a given pool.
@@ -513,6 +1513,15 @@ void mem_Init
     // NOTE: No need to lock the mutex because this function should be called when there is still
     //       only one thread running.
 
+    // This must be done before any pool is created, because it affects the layout of the blocks.
+    InitCheckLevel();
+
+    #ifndef LE_MEM_VALGRIND
+        // Create the thread-local data key used to find each thread's block cache.  Each thread's
+        // cache is flushed back into the pools when the thread dies.
+        LE_ASSERT(pthread_key_create(&CacheKey, DeleteThreadCache) == 0);
+    #endif
+
     // Create a memory for all sub-pools.
     SubPoolsPool = le_mem_CreatePool("SubPools", sizeof(MemPool_t));
     le_mem_ExpandPool(SubPoolsPool, DEFAULT_SUB_POOLS_POOL_SIZE);
@@ -530,20 +1539,9 @@ void mem_Init
         void*   objPtr  ///< [IN] Pointer to the object we're finding a pool for.
     )
     {
-        MemBlock_t* blockPtr;
-
-        // Get the block from the object pointer.
-        #ifdef USE_GUARD_BAND
-            uint8_t* dataPtr = objPtr;
-            dataPtr -= GUARD_BAND_SIZE;
-            blockPtr = CONTAINER_OF(dataPtr, MemBlock_t, data);
-        #else
-            blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
-        #endif
+        MemBlock_t* blockPtr = GetBlockPtr(objPtr);
 
-        #ifdef USE_GUARD_BAND
-            CheckGuardBands(blockPtr);
-        #endif
+        CheckBlock(blockPtr);
 
         return blockPtr->poolPtr;
     }
@@ -672,13 +1670,20 @@ le_mem_PoolRef_t le_mem_ExpandPool
     #ifndef LE_MEM_VALGRIND
         LE_ASSERT(pool);
 
+        if (pool->superPoolPtr)
+        {
+            // Put the super-pool's free blocks that are sitting in thread caches back on its free
+            // list, so they can be moved into the sub-pool instead of growing the super-pool.
+            DrainCaches(pool->superPoolPtr);
+        }
+
         Lock();
 
         if (pool->superPoolPtr)
         {
             // This is a sub-pool so the memory blocks to create must come from the super-pool.
             // Check that there are enough blocks in the superpool.
-            ssize_t numBlocksToAdd = numObjects - le_sls_NumLinks(&(pool->superPoolPtr->freeList));
+            ssize_t numBlocksToAdd = numObjects - pool->superPoolPtr->numFreeBlocks;
 
             if (numBlocksToAdd > 0)
             {
@@ -693,12 +1698,10 @@ le_mem_PoolRef_t le_mem_ExpandPool
             pool->totalBlocks = pool->totalBlocks + numObjects;
 
             // Update the super-pool's block use counts.
-            pool->superPoolPtr->numBlocksInUse += numObjects;
-
-            if (pool->superPoolPtr->numBlocksInUse > pool->superPoolPtr->maxNumBlocksUsed)
-            {
-                pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
-            }
+            UpdateMaxNumBlocksUsed(pool->superPoolPtr,
+                                   __atomic_add_fetch(&(pool->superPoolPtr->numBlocksInUse),
+                                                      numObjects,
+                                                      __ATOMIC_RELAXED));
         }
         else
         {
@@ -706,6 +1709,8 @@ le_mem_PoolRef_t le_mem_ExpandPool
             AddBlocks(pool, numObjects);
         }
 
+        TRACEPOINT_COUNTER(pool->totalBlocks, "pool %s", pool->name);
+
         Unlock();
     #endif
 
@@ -731,18 +1736,15 @@ void* le_mem_TryAlloc
 
     MemBlock_t* blockPtr = NULL;
     void* userPtr = NULL;
-
-    Lock();
-
-    #ifndef LE_MEM_VALGRIND
-        // Pop a link off the pool.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
-
-        if (blockLinkPtr != NULL)
-        {
-            // Get the block from the block link.
-            blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
-        }
+
+    // Sample the duration of one allocation in ALLOC_LATENCY_SAMPLE_PERIOD.  Threads allocating
+    // at the same time may both sample, which doesn't matter for statistics.
+    bool isSampled = ((__atomic_load_n(&(pool->numAllocations), __ATOMIC_RELAXED) &
+                       (ALLOC_LATENCY_SAMPLE_PERIOD - 1)) == 0);
+    uint64_t startNs = (isSampled ? GetMonotonicNs() : 0);
+
+    #ifndef LE_MEM_VALGRIND
+        blockPtr = GetFreeBlock(pool);
     #else
         blockPtr = malloc(pool->blockSize);
 
@@ -754,27 +1756,32 @@ void* le_mem_TryAlloc
 
     if (blockPtr != NULL)
     {
-        // Update the pool and the block.
-        pool->numAllocations++;
-        pool->numBlocksInUse++;
-
-        if (pool->numBlocksInUse > pool->maxNumBlocksUsed)
+        if (isSampled)
         {
-            pool->maxNumBlocksUsed = pool->numBlocksInUse;
+            __atomic_add_fetch(&(pool->allocLatencySumNs), GetMonotonicNs() - startNs,
+                               __ATOMIC_RELAXED);
+            __atomic_add_fetch(&(pool->numLatencySamples), 1, __ATOMIC_RELAXED);
         }
 
-        blockPtr->refCount = 1;
+        // Update the pool and the block.
+        __atomic_add_fetch(&(pool->numAllocations), 1, __ATOMIC_RELAXED);
+        UpdateMaxNumBlocksUsed(pool,
+                               __atomic_add_fetch(&(pool->numBlocksInUse), 1, __ATOMIC_RELAXED));
 
-        // Return the user object in the block.
-        #ifdef USE_GUARD_BAND
-            CheckGuardBands(blockPtr);
-            userPtr = blockPtr->data + GUARD_BAND_SIZE;
-        #else
-            userPtr = blockPtr->data;
+        __atomic_store_n(&(blockPtr->refCount), 1, __ATOMIC_RELAXED);
+
+        CheckBlock(blockPtr);
+
+        #ifdef FILL_DELETED_AND_CHECK_ALLOCATED
+            if (CheckLevel == CHECK_LEVEL_FULL)
+            {
+                CheckFreeBlockFill(blockPtr);
+            }
         #endif
-    }
 
-    Unlock();
+        // Return the user object in the block.
+        userPtr = GetUserPtr(blockPtr);
+    }
 
     return userPtr;
 }
@@ -832,7 +1839,7 @@ void* le_mem_ForceAlloc
             // Expand the pool.
             le_mem_ExpandPool(pool, pool->numBlocksToForce);
 
-            Lock();
+            LockPool(pool);
             pool->numOverflows++;
 
             // log a warning.
@@ -876,6 +1883,77 @@ void le_mem_SetNumObjsToForce
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the memory of all the pool's fully idle chunks back to the system.
+ *
+ * @return
+ *      The number of free objects that were removed from the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_mem_Compact
+(
+    le_mem_PoolRef_t    pool        ///< [IN] The pool to compact.
+)
+{
+    LE_ASSERT(pool != NULL);
+
+    size_t numReleased = 0;
+
+    #ifndef LE_MEM_VALGRIND
+        LE_FATAL_IF(pool->superPoolPtr != NULL, "Sub-pool '%s' can't be compacted.", pool->name);
+
+        // Blocks in thread caches keep their chunks from being released, so put them back first.
+        DrainCaches(pool);
+
+        Lock();
+        numReleased = CompactPool(pool, 0);
+        Unlock();
+    #endif
+
+    return numReleased;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the maximum number of free objects kept in a pool.  When objects are released into a pool
+ * that has more free objects than this, its fully idle chunks are given back to the system until
+ * the pool is down to this many free objects (or has no more idle chunks).
+ *
+ * @note
+ *      The default is to never give memory back to the system.  Passing SIZE_MAX restores this.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetMaxIdleBlocks
+(
+    le_mem_PoolRef_t    pool,           ///< [IN] The pool.
+    size_t              maxIdleBlocks   ///< [IN] The maximum number of free objects to keep.
+)
+{
+    LE_ASSERT(pool != NULL);
+
+    #ifndef LE_MEM_VALGRIND
+        LE_FATAL_IF(pool->superPoolPtr != NULL,
+                    "Can't set the maximum idle blocks of sub-pool '%s'.",
+                    pool->name);
+
+        Lock();
+
+        pool->maxIdleBlocks = maxIdleBlocks;
+
+        if (pool->numFreeBlocks > maxIdleBlocks)
+        {
+            CompactPool(pool, maxIdleBlocks);
+        }
+
+        Unlock();
+    #else
+        (void)maxIdleBlocks;
+    #endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Releases an object.  If the object's reference count has reached zero, it will be destructed
@@ -896,59 +1974,46 @@ void le_mem_Release
     void*   objPtr  ///< [IN] Pointer to the object to be released.
 )
 {
-    MemBlock_t* blockPtr;
-
     // Get the block from the object pointer.
-    #ifdef USE_GUARD_BAND
-        uint8_t* dataPtr = objPtr;
-        dataPtr -= GUARD_BAND_SIZE;
-        blockPtr = CONTAINER_OF(dataPtr, MemBlock_t, data);
-    #else
-        blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
-    #endif
+    MemBlock_t* blockPtr = GetBlockPtr(objPtr);
 
-    #ifdef USE_GUARD_BAND
-        CheckGuardBands(blockPtr);
-    #endif
+    CheckBlock(blockPtr);
 
-    Lock();
+    size_t refCount = __atomic_fetch_sub(&(blockPtr->refCount), 1, __ATOMIC_ACQ_REL);
 
-    switch (blockPtr->refCount)
+    switch (refCount)
     {
         case 1:
         {
             MemPool_t* poolPtr = blockPtr->poolPtr;
 
-            // The reference count has reached zero.
-            blockPtr->refCount = 0;
-
-            // Call the destructor, if there is one.
-            if (poolPtr->destructor)
+            // The reference count has reached zero, so call the destructor, if there is one.
+            // Note that no mutex is held while it runs, so it is free to use the memory pools.
+            le_mem_Destructor_t destructor = poolPtr->destructor;
+            if (destructor)
             {
-                // Make sure that the destructor is not called with the mutex locked, because
-                // it is not a recursive mutex and therefore will deadlock if locked again by
-                // the same thread.  Also, fetch the destructor function address before unlocking
-                // the mutex so that we don't touch the pool object while the mutex is unlocked.
-                le_mem_Destructor_t destructor = poolPtr->destructor;
-                Unlock();
                 destructor(objPtr);
-
-                // Re-lock the mutex now so that it is safe to access the pool object again.
-                Lock();
             }
 
+            #ifdef FILL_DELETED_AND_CHECK_ALLOCATED
+                if (CheckLevel == CHECK_LEVEL_FULL)
+                {
+                    FillFreeBlock(blockPtr);
+                }
+            #endif
+
             #ifndef LE_MEM_VALGRIND
                 // Release the memory back into the pool.
                 // Note that we don't do this before calling the destructor because the destructor
                 // still needs to access it, but after it goes back on the free list, it could get
                 // reallocated by another thread (or even the destructor itself) and have its
                 // contents clobbered.
-                le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+                PutFreeBlock(blockPtr);
             #else
                 free(blockPtr);
             #endif
 
-            poolPtr->numBlocksInUse--;
+            __atomic_sub_fetch(&(poolPtr->numBlocksInUse), 1, __ATOMIC_RELAXED);
 
             break;
         }
@@ -960,10 +2025,9 @@ void le_mem_Release
                      blockPtr->poolPtr->name);
 
         default:
-            blockPtr->refCount--;
+            // Someone else still holds a reference.
+            break;
     }
-
-    Unlock();
 }
 
 
@@ -982,22 +2046,11 @@ void le_mem_AddRef
     void*   objPtr  ///< [IN] Pointer to the object.
 )
 {
-    #ifdef USE_GUARD_BAND
-        objPtr = (((uint8_t*)objPtr) - GUARD_BAND_SIZE);
-    #endif
-    MemBlock_t* memBlockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
-
-    #ifdef USE_GUARD_BAND
-        CheckGuardBands(memBlockPtr);
-    #endif
-
-    Lock();
+    MemBlock_t* memBlockPtr = GetBlockPtr(objPtr);
 
-    LE_ASSERT(memBlockPtr->refCount != 0);
+    CheckBlock(memBlockPtr);
 
-    memBlockPtr->refCount++;
-
-    Unlock();
+    LE_ASSERT(__atomic_fetch_add(&(memBlockPtr->refCount), 1, __ATOMIC_RELAXED) != 0);
 }
 
 
@@ -1016,12 +2069,9 @@ size_t le_mem_GetRefCount
     void*   objPtr  ///< [IN] Pointer to the object.
 )
 {
-    #ifdef USE_GUARD_BAND
-        objPtr = (((uint8_t*)objPtr) - GUARD_BAND_SIZE);
-    #endif
-    MemBlock_t* memBlockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
+    MemBlock_t* memBlockPtr = GetBlockPtr(objPtr);
 
-    return memBlockPtr->refCount;
+    return __atomic_load_n(&(memBlockPtr->refCount), __ATOMIC_RELAXED);
 }
 
 
@@ -1067,11 +2117,21 @@ void le_mem_GetStats
 
     Lock();
 
-    statsPtr->numAllocs = pool->numAllocations;
+    size_t numBlocksInUse = __atomic_load_n(&(pool->numBlocksInUse), __ATOMIC_RELAXED);
+
+    // Note that free blocks held in thread caches are counted as free.
+    statsPtr->numAllocs = __atomic_load_n(&(pool->numAllocations), __ATOMIC_RELAXED);
     statsPtr->numOverflows = pool->numOverflows;
-    statsPtr->numFree = pool->totalBlocks - pool->numBlocksInUse;
-    statsPtr->numBlocksInUse = pool->numBlocksInUse;
-    statsPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+    statsPtr->numFree = pool->totalBlocks - numBlocksInUse;
+    statsPtr->numBlocksInUse = numBlocksInUse;
+    statsPtr->maxNumBlocksUsed = __atomic_load_n(&(pool->maxNumBlocksUsed), __ATOMIC_RELAXED);
+    statsPtr->numLockWaits = __atomic_load_n(&(pool->numLockWaits), __ATOMIC_RELAXED);
+
+    uint64_t numLatencySamples = __atomic_load_n(&(pool->numLatencySamples), __ATOMIC_RELAXED);
+    statsPtr->allocLatencyNs = (numLatencySamples == 0) ? 0 :
+        __atomic_load_n(&(pool->allocLatencySumNs), __ATOMIC_RELAXED) / numLatencySamples;
+
+    statsPtr->statsPeriodMs = (GetMonotonicNs() - pool->statsResetTimeNs) / 1000000;
 
     Unlock();
 }
@@ -1093,8 +2153,12 @@ void le_mem_ResetStats
     LE_ASSERT(pool != NULL);
 
     Lock();
-    pool->numAllocations = 0;
+    __atomic_store_n(&(pool->numAllocations), 0, __ATOMIC_RELAXED);
     pool->numOverflows = 0;
+    __atomic_store_n(&(pool->numLockWaits), 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&(pool->numLatencySamples), 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&(pool->allocLatencySumNs), 0, __ATOMIC_RELAXED);
+    pool->statsResetTimeNs = GetMonotonicNs();
     Unlock();
 }
 
@@ -1352,12 +2416,17 @@ void le_mem_DeleteSubPool
 {
     LE_ASSERT(subPool != NULL);
 
+    #ifndef LE_MEM_VALGRIND
+        // Collect the sub-pool's free blocks from the thread caches.
+        DrainCaches(subPool);
+    #endif
+
     Lock();
 
     // Make sure all sub-pool objects are free.
     le_mem_PoolRef_t superPool = subPool->superPoolPtr;
 
-    LE_FATAL_IF(subPool->numBlocksInUse != 0,
+    LE_FATAL_IF(__atomic_load_n(&(subPool->numBlocksInUse), __ATOMIC_RELAXED) != 0,
                 "Subpool '%s' deleted while %zu blocks remain allocated.",
                 subPool->name,
                 subPool->numBlocksInUse);
@@ -1368,7 +2437,7 @@ void le_mem_DeleteSubPool
     MoveBlocks(superPool, subPool, numBlocks);
 
     // Update the superPool's block use count.
-    superPool->numBlocksInUse -= numBlocks;
+    __atomic_sub_fetch(&(superPool->numBlocksInUse), numBlocks, __ATOMIC_RELAXED);
 
     // Remove the sub-pool from the list of sub-pools.
     PoolListChangeCount++;
@@ -1381,3 +2450,279 @@ void le_mem_DeleteSubPool
 }
 
 
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size class of a slab allocator to use for objects of a given size.
+ *
+ * @return
+ *      Reference to the size class's pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t GetSlabClassPool
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Object size (in bytes).
+)
+{
+    LE_ASSERT(slab != NULL);
+
+    LE_FATAL_IF(objSize > slab->maxObjSize,
+                "Object size %zu is larger than the maximum size (%zu) of slab allocator '%s'.",
+                objSize,
+                slab->maxObjSize,
+                slab->classPools[slab->numClasses - 1]->name);
+
+    size_t classIndex = 0;
+
+    while ((MIN_SLAB_CLASS_SIZE << classIndex) < objSize)
+    {
+        classIndex++;
+    }
+
+    return slab->classPools[classIndex];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an empty slab allocator.
+ *
+ * @return
+ *      A reference to the slab allocator.
+ *
+ * @note
+ *      On failure, the process exits, so you don't have to worry about checking the returned
+ *      reference for validity.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SlabRef_t _le_mem_CreateSlabAllocator
+(
+    const char*     componentName,  ///< [IN] Name of the component.
+    const char*     name,           ///< [IN] Name of the slab allocator inside the component.
+    size_t          maxObjSize      ///< [IN] Size of the largest object that can be allocated.
+)
+{
+    LE_FATAL_IF(   (maxObjSize == 0)
+                || (maxObjSize > ((size_t)MIN_SLAB_CLASS_SIZE << (MAX_SLAB_CLASSES - 1))),
+                "Invalid maximum object size %zu for slab allocator '%s'.",
+                maxObjSize,
+                name);
+
+    le_mem_SlabRef_t newSlab = malloc(sizeof(MemSlab_t));
+
+    // Crash if we can't create the slab allocator.
+    LE_ASSERT(newSlab);
+
+    newSlab->maxObjSize = maxObjSize;
+    newSlab->numClasses = 0;
+
+    size_t classSize;
+
+    do
+    {
+        classSize = MIN_SLAB_CLASS_SIZE << newSlab->numClasses;
+
+        if (classSize > maxObjSize)
+        {
+            classSize = maxObjSize;
+        }
+
+        // Put the size first, so that it doesn't get lost if the name gets truncated.
+        char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES];
+        (void)snprintf(poolName, sizeof(poolName), "%zuB.%s", classSize, name);
+
+        newSlab->classPools[newSlab->numClasses] = _le_mem_CreatePool(componentName,
+                                                                      poolName,
+                                                                      classSize);
+        newSlab->numClasses++;
+    }
+    while (classSize < maxObjSize);
+
+    return newSlab;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expands the size class of a slab allocator that is used for objects of a given size.
+ *
+ * @return  A reference to the slab allocator (the same value passed into it).
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_SlabRef_t le_mem_ExpandSlabAllocator
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator to be expanded.
+    size_t              objSize,    ///< [IN] Object size whose size class is expanded.
+    size_t              numObjects  ///< [IN] The number of objects to add to the size class.
+)
+{
+    le_mem_ExpandPool(GetSlabClassPool(slab, objSize), numObjects);
+
+    return slab;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attempts to allocate an object of a given size from a slab allocator.
+ *
+ * @return
+ *      A pointer to the allocated object, or NULL if the size class doesn't have any free objects
+ *      to allocate.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_TrySlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Size of the object.
+)
+{
+    return le_mem_TryAlloc(GetSlabClassPool(slab, objSize));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a slab allocator or logs a fatal error and terminates
+ * the process if the size class doesn't have any free objects to allocate.
+ *
+ * @return A pointer to the allocated object.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_AssertSlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Size of the object.
+)
+{
+    return le_mem_AssertAlloc(GetSlabClassPool(slab, objSize));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates an object of a given size from a slab allocator or logs a warning and expands the
+ * size class if it doesn't have any free objects to allocate.
+ *
+ * @return  A pointer to the allocated object.
+ */
+//--------------------------------------------------------------------------------------------------
+void* le_mem_ForceSlabAlloc
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Size of the object.
+)
+{
+    return le_mem_ForceAlloc(GetSlabClassPool(slab, objSize));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a string into a block allocated from a slab allocator that is just big enough to hold
+ * it.
+ *
+ * @return  Pointer to the copy.
+ */
+//--------------------------------------------------------------------------------------------------
+char* le_mem_SlabStrDup
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    const char*         strPtr      ///< [IN] String to copy.
+)
+{
+    size_t size = strlen(strPtr) + 1;
+    char* copyPtr = le_mem_ForceSlabAlloc(slab, size);
+
+    memcpy(copyPtr, strPtr, size);
+
+    return copyPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size class (memory pool) of a slab allocator that is used for objects of a given size.
+ *
+ * @return
+ *      Reference to the size class's memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mem_PoolRef_t le_mem_GetSlabPool
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    size_t              objSize     ///< [IN] Object size.
+)
+{
+    return GetSlabClassPool(slab, objSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the destructor function for all the size classes of a slab allocator.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_SetSlabDestructor
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    le_mem_Destructor_t destructor  ///< [IN] The destructor function.
+)
+{
+    LE_ASSERT(slab != NULL);
+
+    size_t i;
+    for (i = 0; i < slab->numClasses; i++)
+    {
+        le_mem_SetDestructor(slab->classPools[i], destructor);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches the statistics for a slab allocator, totalled across all of its size classes.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_GetSlabStats
+(
+    le_mem_SlabRef_t    slab,       ///< [IN] The slab allocator.
+    le_mem_PoolStats_t* statsPtr    ///< [OUT] Pointer to where the stats will be stored.
+)
+{
+    LE_ASSERT( (slab != NULL) && (statsPtr != NULL) );
+
+    memset(statsPtr, 0, sizeof(*statsPtr));
+
+    double latencySum = 0;
+
+    size_t i;
+    for (i = 0; i < slab->numClasses; i++)
+    {
+        le_mem_PoolStats_t classStats;
+
+        le_mem_GetStats(slab->classPools[i], &classStats);
+
+        statsPtr->numBlocksInUse += classStats.numBlocksInUse;
+        statsPtr->maxNumBlocksUsed += classStats.maxNumBlocksUsed;
+        statsPtr->numOverflows += classStats.numOverflows;
+        statsPtr->numAllocs += classStats.numAllocs;
+        statsPtr->numFree += classStats.numFree;
+        statsPtr->numLockWaits += classStats.numLockWaits;
+
+        // Allocations are sampled uniformly, so weigh each class's latency by its allocations.
+        latencySum += (double)classStats.allocLatencyNs * (double)classStats.numAllocs;
+
+        if (classStats.statsPeriodMs > statsPtr->statsPeriodMs)
+        {
+            statsPtr->statsPeriodMs = classStats.statsPeriodMs;
+        }
+    }
+
+    if (statsPtr->numAllocs > 0)
+    {
+        statsPtr->allocLatencyNs = (uint64_t)(latencySum / (double)statsPtr->numAllocs);
+    }
+}
@@ -26,7 +26,14 @@ typedef struct le_mem_Pool
     struct le_mem_Pool* superPoolPtr;   ///< A pointer to our super pool if we are a sub-pool. NULL
                                         ///  if we are not a sub-pool.
     #ifndef LE_MEM_VALGRIND
-        le_sls_List_t freeList;         ///< List of free memory blocks.
+        le_sls_List_t freeList;         ///< List of free memory blocks (not including free
+                                        ///  blocks held in the threads' block caches).
+        size_t numFreeBlocks;           ///< Number of blocks on the free list.
+        le_dls_List_t chunkList;        ///< List of chunks of blocks allocated for this pool
+                                        ///  (always empty for sub-pools).
+        size_t numIdleChunks;           ///< Number of chunks with all their blocks on the free list.
+        size_t maxIdleBlocks;           ///< Number of free blocks above which fully idle chunks
+                                        ///  are released to the system (SIZE_MAX = never).
     #endif
 
     size_t userDataSize;                ///< Size of the object requested by the client in bytes.
@@ -40,6 +47,12 @@ typedef struct le_mem_Pool
     size_t maxNumBlocksUsed;            ///< Maximum number of allocated blocks at any one time.
     size_t numBlocksToForce;            ///< Number of blocks that is added when Force Alloc
                                         ///  expands the pool.
+    uint64_t numLockWaits;              ///< Number of times an operation on this pool had to
+                                        ///  wait for the memory pool lock.
+    uint64_t numLatencySamples;         ///< Number of allocations whose duration was sampled.
+    uint64_t allocLatencySumNs;         ///< Total duration of the sampled allocations (ns).
+    uint64_t statsResetTimeNs;          ///< CLOCK_MONOTONIC time at which the stats were last
+                                        ///  reset (ns).
     #ifdef LE_MEM_TRACE
         le_log_TraceRef_t memTrace;     ///< If tracing is enabled, keeps track of a trace object
                                         ///  for this pool.
@@ -14,7 +14,10 @@
 #include "serviceDirectory/serviceDirectoryProtocol.h"
 #include "messagingInterface.h"
 #include "messagingSession.h"
+#include "messagingProtocol.h"
+#include "messagingMessage.h"
 #include "fileDescriptor.h"
+#include "tracepoint.h"
 
 
 // =======================================
@@ -31,6 +34,9 @@
 /// Highest number of Client Interfaces that are expected to be referred to in a single process.
 #define MAX_EXPECTED_CLIENT_INTERFACES    32
 
+/// Highest number of local bindings that are expected to be declared in a single process.
+#define MAX_EXPECTED_LOCAL_BINDINGS   32
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hashmap in which Service objects are kept.
@@ -89,6 +95,57 @@ static le_mem_PoolRef_t ClientInterfacePoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  HandlerEventPoolRef;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server-side end of a connector, over which a client sends the sockets of the sessions it opens
+ * with a service, instead of going through the Service Directory.  Kept on the Service object's
+ * Connector List.  See @ref serviceDirectoryProtocol_Connectors.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t           link;           ///< Used to link onto the Service's Connector List.
+    msgInterface_Service_t* servicePtr;     ///< Service that sessions are handed off to.
+    int                     fd;             ///< Connector socket (-1 once deleted).
+    le_fdMonitor_Ref_t      fdMonitorRef;   ///< FD Monitor watching the connector socket.
+    uid_t                   clientUid;      ///< User ID of the client process at the other end.
+}
+Connector_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Connector objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ConnectorPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binding of a client-side interface to a server-side interface offered in the same process.
+ * Kept in the Local Binding Map, keyed by client interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char clientName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];    ///< Client-side interface name.
+    char serverName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];    ///< Server-side interface name.
+}
+LocalBinding_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Local Binding objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LocalBindingPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hashmap in which Local Binding objects are kept.  Bindings are never removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t LocalBindingMapRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect data structures in this module from multi-threaded race conditions.
@@ -233,12 +290,21 @@ static msgInterface_Service_t* CreateService
     servicePtr->recvHandler = NULL;
     servicePtr->recvContextPtr = NULL;
 
+    servicePtr->workerCount = 0;
+    servicePtr->nextWorker = 0;
+    memset(&servicePtr->stats, 0, sizeof(servicePtr->stats));
+
     // Initialize the close handlers dls
     servicePtr->closeListPtr = LE_DLS_LIST_INIT;
 
     // Initialize the open handlers dls
     servicePtr->openListPtr = LE_DLS_LIST_INIT;
 
+    servicePtr->connectorList = LE_DLS_LIST_INIT;
+
+    servicePtr->isLocal = false;
+    servicePtr->localWaitList = LE_DLS_LIST_INIT;
+
     ServiceObjMapChangeCount++;
     le_hashmap_Put(ServiceMapRef, &servicePtr->interface.id, servicePtr);
 
@@ -269,6 +335,9 @@ static msgInterface_ClientInterface_t* CreateClientInterface
                   LE_MSG_INTERFACE_CLIENT,
                   (msgInterface_Interface_t*)clientPtr);
 
+    clientPtr->cacheEndpoint = false;
+    clientPtr->connectorFd = -1;
+
     ClientInterfaceMapChangeCount++;
     le_hashmap_Put(ClientInterfaceMapRef, &clientPtr->interface.id, clientPtr);
 
@@ -424,36 +493,257 @@ static void ClientInterfaceDestructor
 
     ClientInterfaceMapChangeCount++;
     le_hashmap_Remove(ClientInterfaceMapRef, &clientPtr->interface.id);
+
+    if (clientPtr->connectorFd >= 0)
+    {
+        fd_Close(clientPtr->connectorFd);
+        clientPtr->connectorFd = -1;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attaches a local service to the calling thread, if it isn't attached to a thread yet.  Local
+ * services are initialized without a server thread, so they can be set up before the thread that
+ * serves them runs.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClaimLocalService
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (servicePtr->isLocal)
+    {
+        LOCK
+
+        if (servicePtr->serverThread == NULL)
+        {
+            servicePtr->serverThread = le_thread_GetCurrent();
+        }
+
+        UNLOCK
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the server side of a connector.  The Connector object itself stays allocated until the
+ * last reference to it is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteConnector
+(
+    Connector_t* connectorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (connectorPtr->fd >= 0)
+    {
+        le_fdMonitor_Delete(connectorPtr->fdMonitorRef);
+        connectorPtr->fdMonitorRef = NULL;
+
+        fd_Close(connectorPtr->fd);
+        connectorPtr->fd = -1;
+
+        le_dls_Remove(&connectorPtr->servicePtr->connectorList, &connectorPtr->link);
+
+        le_mem_Release(connectorPtr);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Calls a Service's server's "open" handler if there is one registered.
+ * Gets the user ID of the process at the other end of a connected socket.
  *
- * @note    This only gets called by the server thread for the service.
+ * @return LE_OK if successful, LE_FAULT if the fd is not a connected Unix domain socket.
  */
 //--------------------------------------------------------------------------------------------------
-static void CallOpenHandler
+static le_result_t GetPeerUid
 (
-    le_msg_ServiceRef_t serviceRef,
-    le_msg_SessionRef_t sessionRef
+    int fd,             ///< [IN] Connected socket.
+    uid_t* uidPtr       ///< [OUT] Where the user ID will be put.
 )
 //--------------------------------------------------------------------------------------------------
- {
-    // If there is a Close Handler registered, call it now.
-    le_dls_Link_t* openLinkPtr = le_dls_Peek(&serviceRef->openListPtr);
+{
+    struct ucred credentials;
+    socklen_t credSize = sizeof(credentials);
 
-    while (openLinkPtr)
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &credSize) != 0)
     {
-        SessionEventHandler_t* openEventPtr = CONTAINER_OF(openLinkPtr, SessionEventHandler_t, link);
+        return LE_FAULT;
+    }
 
-        if (openEventPtr->handler != NULL)
+    *uidPtr = credentials.uid;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives session sockets from a connector and opens server-side sessions for them.
+ *
+ * @return true if the connector is still open, false if it was deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ConnectorReadable
+(
+    Connector_t* connectorPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_Service_t* servicePtr = connectorPtr->servicePtr;
+
+    // The open handler could hide the service, which deletes the connector, so hold onto the
+    // object until we are done with it.
+    le_mem_AddRef(connectorPtr);
+
+    while (connectorPtr->fd >= 0)
+    {
+        int sessionFd;
+
+        le_result_t result = unixSocket_ReceiveMsg(connectorPtr->fd,
+                                                   NULL,   // dataBuffPtr
+                                                   0,      // dataBuffSize
+                                                   &sessionFd,
+                                                   NULL);  // credPtr
+        if (result == LE_WOULD_BLOCK)
         {
-            openEventPtr->handler(sessionRef, openEventPtr->contextPtr);
+            break;
         }
 
-        openLinkPtr = le_dls_PeekNext(&serviceRef->openListPtr, openLinkPtr);
+        if ((result != LE_OK) || (sessionFd < 0))
+        {
+            if (result != LE_CLOSED)
+            {
+                LE_ERROR("Bad connector message for service (%s:%s) (%s). Dropping connector.",
+                         servicePtr->interface.id.name,
+                         le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef),
+                         LE_RESULT_TXT(result));
+            }
+            DeleteConnector(connectorPtr);
+            break;
+        }
+
+        // Only accept sessions with the client the Service Directory gave us the connector for.
+        uid_t uid;
+        if ((GetPeerUid(sessionFd, &uid) != LE_OK) || (uid != connectorPtr->clientUid))
+        {
+            LE_ERROR("Dropping session handed to service (%s:%s) by a connector for another user.",
+                     servicePtr->interface.id.name,
+                     le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+            fd_Close(sessionFd);
+            continue;
+        }
+
+        le_msg_SessionRef_t sessionRef = msgSession_CreateServerSideSession(servicePtr,
+                                                                            sessionFd);
+        if (sessionRef != NULL)
+        {
+            msgInterface_CallOpenHandler(servicePtr, sessionRef);
+        }
+    }
+
+    bool isOpen = (connectorPtr->fd >= 0);
+
+    le_mem_Release(connectorPtr);
+
+    return isOpen;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles events detected on the file descriptor of a connector.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ConnectorEventHandler
+(
+    int     fd,
+    short   events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Connector_t* connectorPtr = le_fdMonitor_GetContextPtr();
+
+    // Sockets sent just before the client went away are still worth opening.
+    if ((events & POLLIN) && !ConnectorReadable(connectorPtr))
+    {
+        return;
+    }
+
+    if (events & (POLLHUP | POLLRDHUP | POLLERR))
+    {
+        DeleteConnector(connectorPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the server side of a connector that the Service Directory has dispatched to a service.
+ *
+ * @note Closes the file descriptor on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateConnector
+(
+    msgInterface_Service_t* servicePtr,
+    int                     fd          ///< [IN] File descriptor of socket connected to client.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uid_t clientUid;
+    le_result_t response = LE_OK;
+
+    // Send a Hello message (LE_OK) to the client, so it knows it can use the connector.
+    if (   (GetPeerUid(fd, &clientUid) != LE_OK)
+        || (unixSocket_SendDataMsg(fd, &response, sizeof(response)) != LE_OK) )
+    {
+        fd_Close(fd);
+        return;
+    }
+
+    fd_SetNonBlocking(fd);
+
+    Connector_t* connectorPtr = le_mem_ForceAlloc(ConnectorPoolRef);
+
+    connectorPtr->link = LE_DLS_LINK_INIT;
+    connectorPtr->servicePtr = servicePtr;
+    connectorPtr->fd = fd;
+    connectorPtr->clientUid = clientUid;
+    connectorPtr->fdMonitorRef = le_fdMonitor_Create(servicePtr->interface.id.name,
+                                                     fd,
+                                                     ConnectorEventHandler,
+                                                     POLLIN);
+    le_fdMonitor_SetContextPtr(connectorPtr->fdMonitorRef, connectorPtr);
+
+    le_dls_Queue(&servicePtr->connectorList, &connectorPtr->link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes all of a Service's connectors, so that clients go back to the Service Directory to open
+ * sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteAllConnectors
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Peek(&servicePtr->connectorList)) != NULL)
+    {
+        DeleteConnector(CONTAINER_OF(linkPtr, Connector_t, link));
     }
 }
 
@@ -538,11 +828,13 @@ static void DirectorySocketReadable
     le_result_t result;
 
     int clientSocketFd;
+    svcdir_ConnectionType_t connectionType = SVCDIR_CONNECTION_SESSION;
+    size_t dataSize = sizeof(connectionType);
 
     // Receive the Client connection file descriptor from the Service Directory.
     result = unixSocket_ReceiveMsg(servicePtr->directorySocketFd,
-                                   NULL,   // dataBuffPtr
-                                   0,      // dataBuffSize
+                                   &connectionType,
+                                   &dataSize,
                                    &clientSocketFd,
                                    NULL);  // credPtr
     if (result == LE_CLOSED)
@@ -568,6 +860,10 @@ static void DirectorySocketReadable
                  servicePtr->interface.id.name,
                  le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
     }
+    else if (connectionType == SVCDIR_CONNECTION_CONNECTOR)
+    {
+        CreateConnector(servicePtr, clientSocketFd);
+    }
     else
     {
         // Create a server-side Session object for that connection to this Service.
@@ -577,7 +873,7 @@ static void DirectorySocketReadable
         // If successful, call the registered "open" handler, if there is one.
         if (sessionRef != NULL)
         {
-            CallOpenHandler(servicePtr, sessionRef);
+            msgInterface_CallOpenHandler(servicePtr, sessionRef);
         }
     }
 }
@@ -812,6 +1108,16 @@ void msgInterface_Init
     le_mem_ExpandPool(ClientInterfacePoolRef, MAX_EXPECTED_CLIENT_INTERFACES );
     le_mem_SetDestructor(ClientInterfacePoolRef, ClientInterfaceDestructor);
 
+    // Create the pool of Connector objects.
+    ConnectorPoolRef = le_mem_CreatePool("MessagingConnectors", sizeof(Connector_t));
+
+    // Create the pool and the map of Local Binding objects.
+    LocalBindingPoolRef = le_mem_CreatePool("MessagingLocalBindings", sizeof(LocalBinding_t));
+    LocalBindingMapRef = le_hashmap_Create("MessagingLocalBindings",
+                                           MAX_EXPECTED_LOCAL_BINDINGS,
+                                           le_hashmap_HashString,
+                                           le_hashmap_EqualsString);
+
     // Create and initialize the pool of event handlers objects.
     HandlerEventPoolRef = le_mem_CreatePool("HandlerEventPool", sizeof(SessionEventHandler_t));
     le_mem_ExpandPool(HandlerEventPoolRef, MAX_EXPECTED_SERVICES*6);
@@ -991,99 +1297,637 @@ void msgInterface_CallCloseHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Dispatches a message received from a client to a service's server.
+ * Call a Service's registered session open handler functions, if there are any registered.
+ *
+ * @note    This only gets called by the server thread for the service.
  */
 //--------------------------------------------------------------------------------------------------
-void msgInterface_ProcessMessageFromClient
+void msgInterface_CallOpenHandler
 (
-    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message reference for the received message.
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Pass the message to the server's registered receive handler, if there is one.
-    if (serviceRef->recvHandler != NULL)
+    le_dls_Link_t* openLinkPtr = le_dls_Peek(&serviceRef->openListPtr);
+
+    while (openLinkPtr)
     {
-        // Set the thread-local received message reference so it can be retrieved by the handler.
-        pthread_setspecific(ThreadLocalRxMsgKey, msgRef);
+        SessionEventHandler_t* openEventPtr = CONTAINER_OF(openLinkPtr, SessionEventHandler_t, link);
 
-        // Call the handler function.
-        serviceRef->recvHandler(msgRef, serviceRef->recvContextPtr);
+        if (openEventPtr->handler != NULL)
+        {
+            openEventPtr->handler(sessionRef, openEventPtr->contextPtr);
+        }
 
-        // Clear the thread-local reference.
-        pthread_setspecific(ThreadLocalRxMsgKey, NULL);
-    }
-    // Discard the message if no handler is registered.
-    else
-    {
-        LE_WARN("No service receive handler (%s:%s). Discarding message. Closing session.",
-                serviceRef->interface.id.name,
-                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
-        le_msg_DeleteSession(le_msg_GetSession(msgRef));
-        le_msg_ReleaseMsg(msgRef);
+        openLinkPtr = le_dls_PeekNext(&serviceRef->openListPtr, openLinkPtr);
     }
 }
 
 
-// =======================================
-//  PUBLIC API FUNCTIONS
-// =======================================
+//--------------------------------------------------------------------------------------------------
+/**
+ * Passes a message received from a client to the service's receive handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallRecvHandler
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_msg_MessageRef_t msgRef      ///< [IN] Message reference for the received message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Set the thread-local received message reference so it can be retrieved by the handler.
+    pthread_setspecific(ThreadLocalRxMsgKey, msgRef);
+
+    // Call the handler function.
+    TRACEPOINT_BEGIN("ipc serve %s txn %zu", serviceRef->interface.id.name,
+                     (size_t)msgMessage_GetTxnId(msgRef));
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    serviceRef->recvHandler(msgRef, serviceRef->recvContextPtr);
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    TRACEPOINT_END();
+
+    // Clear the thread-local reference.
+    pthread_setspecific(ThreadLocalRxMsgKey, NULL);
+
+    // Update the service statistics.  Worker threads may be doing the same concurrently.
+    msgInterface_ServiceStats_t* statsPtr = &serviceRef->stats;
+    uint64_t elapsedUs = ((uint64_t)elapsed.sec * 1000000) + elapsed.usec;
+    uint64_t maxUs = __atomic_load_n(&statsPtr->maxServiceTimeUs, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&statsPtr->msgCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&statsPtr->serviceTimeUs, elapsedUs, __ATOMIC_RELAXED);
+    while ((elapsedUs > maxUs) &&
+           !__atomic_compare_exchange_n(&statsPtr->maxServiceTimeUs, &maxUs, elapsedUs, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        // maxUs has been reloaded by the failed exchange; try again.
+    }
+}
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates a service that is accessible using a given protocol.
+ * Handles a client message on one of the service's worker threads.
  *
- * @return  The service reference.
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          That's why the parameter list looks unusual.
  */
 //--------------------------------------------------------------------------------------------------
-le_msg_ServiceRef_t le_msg_CreateService
+static void ProcessMessageOnWorker
 (
-    le_msg_ProtocolRef_t    protocolRef,    ///< [in] Reference to the protocol to be used.
-    const char*             interfaceName   ///< [in] Server-side interface name.
+    void* param1Ptr,    ///< [IN] Pointer to the Service object.
+    void* param2Ptr     ///< [IN] Message reference for the received message.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Must lock the mutex to prevent races between different threads trying to offer the
-    // same service at the same time, or one thread trying to delete a service while another
-    // tries to create it, or accessing the Service List hashmap while another thread
-    // is updating it.
+    le_msg_ServiceRef_t serviceRef = param1Ptr;
 
-    LOCK
+    __atomic_sub_fetch(&serviceRef->stats.pendingCount, 1, __ATOMIC_RELAXED);
 
-    // Get a Service object.
-    msgInterface_Service_t* servicePtr = GetService(protocolRef, interfaceName);
+    CallRecvHandler(serviceRef, param2Ptr);
+}
 
-    // If the Service object already has a server thread, then it means that this service
-    // is already being offered by someone else in this very process.
-    LE_FATAL_IF(servicePtr->serverThread != NULL,
-                "Duplicate service (%s:%s) offered in same process.",
-                interfaceName,
-                le_msg_GetProtocolIdStr(protocolRef));
 
-    servicePtr->serverThread = le_thread_GetCurrent();
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a service's worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerThreadMain
+(
+    void* contextPtr    ///< [IN] Semaphore to post when the worker is ready.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The thread's Event Loop exists now, so functions can be queued to it.
+    le_sem_Post(contextPtr);
 
-    UNLOCK
+    le_event_RunLoop();
 
-    return servicePtr;
+    return NULL;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Deletes a service.  Any open sessions will be terminated.
+ * Selects the worker thread that will handle requests received on a new server-side session.
+ * Sessions are spread across the service's worker threads in round-robin order.
  *
- * @note    This is a server-only function that can only be called by the service's server thread.
+ * @return  The worker thread, or NULL if the service's server thread handles all requests.
  */
 //--------------------------------------------------------------------------------------------------
-void le_msg_DeleteService
+le_thread_Ref_t msgInterface_SelectWorkerThread
 (
-    le_msg_ServiceRef_t             serviceRef  ///< [in] Reference to the service.
+    le_msg_ServiceRef_t serviceRef  ///< [IN] Reference to the Service object.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
-                "Attempted to delete service (%s:%s) not owned by thread.",
+    if (serviceRef->workerCount == 0)
+    {
+        return NULL;
+    }
+
+    le_thread_Ref_t threadRef = serviceRef->workerThreads[serviceRef->nextWorker];
+
+    serviceRef->nextWorker = (serviceRef->nextWorker + 1) % serviceRef->workerCount;
+
+    return threadRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turns on endpoint caching for a client interface.
+ *
+ * @note The client interface object is kept for the life of the process after this.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_EnableEndpointCache
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    if (!clientRef->cacheEndpoint)
+    {
+        clientRef->cacheEndpoint = true;
+
+        // Keep the object (and its connector) around after its last session is deleted, so the
+        // next session created on this interface can use the connector.
+        le_mem_AddRef(clientRef);
+    }
+
+    UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a client interface wants a connector but doesn't have one yet.
+ *
+ * @return true if a connector should be opened and stored using msgInterface_SetConnector().
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_NeedsConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    bool needsConnector = (clientRef->cacheEndpoint && (clientRef->connectorFd < 0));
+
+    UNLOCK
+
+    return needsConnector;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores a client interface's connector.  The client interface takes ownership of the fd.  If the
+ * interface already has a connector, the new one is closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_SetConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef,  ///< [IN] Reference to the Client Interface object.
+    int                         fd          ///< [IN] Connected connector socket.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    if (clientRef->connectorFd < 0)
+    {
+        clientRef->connectorFd = fd;
+        fd = -1;
+    }
+
+    UNLOCK
+
+    if (fd >= 0)
+    {
+        fd_Close(fd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a client interface's connector, if it has one, so that the next session opened on it goes
+ * through the Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_DropConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    int fd = clientRef->connectorFd;
+    clientRef->connectorFd = -1;
+
+    UNLOCK
+
+    if (fd >= 0)
+    {
+        fd_Close(fd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hands a new session socket to a client interface's server over the interface's connector.
+ *
+ * @return The client's end of the new session socket, whose next message will be the server's
+ *         LE_OK "hello" message, or -1 if the interface has no working connector.
+ */
+//--------------------------------------------------------------------------------------------------
+int msgInterface_HandOffToServer
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int clientFd = -1;
+    int serverFd;
+
+    LOCK
+
+    if (clientRef->connectorFd >= 0)
+    {
+        // The server never sends anything over a connector after the hello, so any event on it
+        // means the server has closed it.  Don't send into a closed connector, because that
+        // would raise SIGPIPE.
+        struct pollfd pollFd = { .fd = clientRef->connectorFd, .events = POLLIN | POLLRDHUP };
+        bool isOpen = (poll(&pollFd, 1, 0) == 0);
+
+        if (isOpen && (unixSocket_CreateSeqPacketPair(&clientFd, &serverFd) == LE_OK))
+        {
+            le_result_t result = unixSocket_SendMsg(clientRef->connectorFd,
+                                                    NULL,       // dataPtr
+                                                    0,          // dataSize
+                                                    serverFd,   // fdToSend
+                                                    false);     // sendCredentials
+            fd_Close(serverFd);
+
+            if (result != LE_OK)
+            {
+                fd_Close(clientFd);
+                clientFd = -1;
+
+                // If the connector is just backed up, keep it for next time.
+                isOpen = (result == LE_NO_MEMORY);
+            }
+        }
+        else
+        {
+            clientFd = -1;
+        }
+
+        if (!isOpen)
+        {
+            LE_DEBUG("Connector to service for interface '%s' closed.", clientRef->interface.id.name);
+            fd_Close(clientRef->connectorFd);
+            clientRef->connectorFd = -1;
+        }
+    }
+
+    UNLOCK
+
+    return clientFd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dispatches a message received from a client to a service's server.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_ProcessMessageFromClient
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_msg_MessageRef_t msgRef      ///< [IN] Message reference for the received message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_thread_Ref_t workerRef = le_msg_GetSession(msgRef)->workerRef;
+
+    // Pass the message to the server's registered receive handler, if there is one.
+    if ((serviceRef->recvHandler != NULL) && (workerRef != NULL)
+        && (workerRef != le_thread_GetCurrent()))
+    {
+        // Hand it to the worker thread that handles this session.  Each session sticks to one
+        // worker, so a client's requests are still handled in the order they were sent.
+        size_t pending = __atomic_add_fetch(&serviceRef->stats.pendingCount, 1,
+                                            __ATOMIC_RELAXED);
+        size_t maxPending = __atomic_load_n(&serviceRef->stats.maxPendingCount,
+                                            __ATOMIC_RELAXED);
+        while ((pending > maxPending) &&
+               !__atomic_compare_exchange_n(&serviceRef->stats.maxPendingCount, &maxPending,
+                                            pending, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            // maxPending has been reloaded by the failed exchange; try again.
+        }
+
+        le_event_QueueFunctionToThread(workerRef, ProcessMessageOnWorker, serviceRef, msgRef);
+    }
+    else if (serviceRef->recvHandler != NULL)
+    {
+        CallRecvHandler(serviceRef, msgRef);
+    }
+    // Discard the message if no handler is registered.
+    else
+    {
+        LE_WARN("No service receive handler (%s:%s). Discarding message. Closing session.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+        le_msg_DeleteSession(le_msg_GetSession(msgRef));
+        le_msg_ReleaseMsg(msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a service in this process can accept sessions right now.
+ *
+ * @warning Assumes that the Mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLocallyAvailable
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (   (servicePtr->serverThread != NULL)
+            && (servicePtr->state != LE_MSG_INTERFACE_SERVICE_HIDDEN) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for a service in this process that a client interface has a local binding to, which can
+ * accept sessions right now.  Must be released using msgInterface_Release() when you are done
+ * with it.
+ *
+ * @return  Reference to the Service object, or NULL if sessions must go through the Service
+ *          Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t msgInterface_FindLocalService
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_Service_t* servicePtr = NULL;
+
+    LOCK
+
+    LocalBinding_t* bindingPtr = le_hashmap_Get(LocalBindingMapRef, clientRef->interface.id.name);
+
+    if (bindingPtr != NULL)
+    {
+        msgInterface_Id_t id;
+
+        id.protocolRef = clientRef->interface.id.protocolRef;
+        LE_ASSERT(le_utf8_Copy(id.name, bindingPtr->serverName, sizeof(id.name), NULL) == LE_OK);
+
+        servicePtr = le_hashmap_Get(ServiceMapRef, &id);
+
+        if ((servicePtr != NULL) && IsLocallyAvailable(servicePtr))
+        {
+            le_mem_AddRef(servicePtr);
+        }
+        else
+        {
+            servicePtr = NULL;
+        }
+    }
+
+    UNLOCK
+
+    return servicePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a service in this process can accept sessions right now, and if not, adds a
+ * client session's link to the list of sessions waiting for the service to be advertised.
+ *
+ * @return  true if the service can accept sessions now (in which case the link was not queued).
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_WaitForLocalService
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_dls_Link_t*      linkPtr     ///< [IN] Session's wait link.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    bool isAvailable = IsLocallyAvailable(serviceRef);
+
+    if (!isAvailable)
+    {
+        le_dls_Queue(&serviceRef->localWaitList, linkPtr);
+    }
+
+    UNLOCK
+
+    return isAvailable;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a client session's link from a service's list of sessions waiting for the service to be
+ * advertised, if it is still on it.
+ *
+ * @return  true if the link was removed, false if it wasn't on the list.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_CancelLocalWait
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_dls_Link_t*      linkPtr     ///< [IN] Session's wait link.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    bool isWaiting = le_dls_IsInList(&serviceRef->localWaitList, linkPtr);
+
+    if (isWaiting)
+    {
+        le_dls_Remove(&serviceRef->localWaitList, linkPtr);
+    }
+
+    UNLOCK
+
+    return isWaiting;
+}
+
+
+// =======================================
+//  PUBLIC API FUNCTIONS
+// =======================================
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a service that is accessible using a given protocol.
+ *
+ * @return  The service reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_msg_CreateService
+(
+    le_msg_ProtocolRef_t    protocolRef,    ///< [in] Reference to the protocol to be used.
+    const char*             interfaceName   ///< [in] Server-side interface name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Must lock the mutex to prevent races between different threads trying to offer the
+    // same service at the same time, or one thread trying to delete a service while another
+    // tries to create it, or accessing the Service List hashmap while another thread
+    // is updating it.
+
+    LOCK
+
+    // Get a Service object.
+    msgInterface_Service_t* servicePtr = GetService(protocolRef, interfaceName);
+
+    // If the Service object already has a server thread, then it means that this service
+    // is already being offered by someone else in this very process.
+    LE_FATAL_IF(servicePtr->serverThread != NULL,
+                "Duplicate service (%s:%s) offered in same process.",
+                interfaceName,
+                le_msg_GetProtocolIdStr(protocolRef));
+
+    servicePtr->serverThread = le_thread_GetCurrent();
+
+    UNLOCK
+
+    return servicePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes a service that can only be used by clients in the same process.
+ *
+ * @return  The service reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_msg_InitLocalService
+(
+    le_msg_LocalService_t*  servicePtr,     ///< [out] Service to initialize.
+    const char*             name,           ///< [in] Service name.
+    le_mem_PoolRef_t        messagePoolRef  ///< [in] Pool to allocate the messages from.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t objectSize = le_mem_GetObjectSize(messagePoolRef);
+
+    LE_FATAL_IF(objectSize <= LE_MSG_LOCAL_HEADER_SIZE,
+                "Message pool objects for local service '%s' too small (%zu bytes).",
+                name,
+                objectSize);
+
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(name,
+                                                             objectSize - LE_MSG_LOCAL_HEADER_SIZE);
+    msgProto_SetMessagePool(protocolRef, messagePoolRef);
+
+    LOCK
+
+    msgInterface_Service_t* serviceRef = GetService(protocolRef, name);
+
+    LE_FATAL_IF(serviceRef->isLocal || (serviceRef->serverThread != NULL),
+                "Duplicate service (%s) offered in same process.",
+                name);
+
+    // The server thread is set when the service is first used by its server.
+    serviceRef->isLocal = true;
+
+    UNLOCK
+
+    servicePtr->serviceRef = serviceRef;
+
+    return serviceRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Declares that a client-side interface is bound to a server-side interface offered in the same
+ * process.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_AddLocalBinding
+(
+    const char* clientInterfaceName,    ///< [in] Name of the client-side interface.
+    const char* serverInterfaceName     ///< [in] Name of the server-side interface.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LocalBinding_t* bindingPtr = le_mem_ForceAlloc(LocalBindingPoolRef);
+
+    LE_FATAL_IF(   (le_utf8_Copy(bindingPtr->clientName,
+                                 clientInterfaceName,
+                                 sizeof(bindingPtr->clientName),
+                                 NULL) != LE_OK)
+                || (le_utf8_Copy(bindingPtr->serverName,
+                                 serverInterfaceName,
+                                 sizeof(bindingPtr->serverName),
+                                 NULL) != LE_OK),
+                "Interface name too long in local binding '%s' -> '%s'.",
+                clientInterfaceName,
+                serverInterfaceName);
+
+    LOCK
+
+    LocalBinding_t* oldBindingPtr = le_hashmap_Put(LocalBindingMapRef,
+                                                   bindingPtr->clientName,
+                                                   bindingPtr);
+
+    UNLOCK
+
+    if (oldBindingPtr != NULL)
+    {
+        le_mem_Release(oldBindingPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a service.  Any open sessions will be terminated.
+ *
+ * @note    This is a server-only function that can only be called by the service's server thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_DeleteService
+(
+    le_msg_ServiceRef_t             serviceRef  ///< [in] Reference to the service.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
+                "Attempted to delete service (%s:%s) not owned by thread.",
                 serviceRef->interface.id.name,
                 le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
 
@@ -1126,6 +1970,9 @@ le_msg_SessionEventHandlerRef_t le_msg_AddServiceOpenHandler
 {
     LE_FATAL_IF(serviceRef == NULL,
                 "Service doesn't exist. Make sure service is started before setting handlers");
+
+    ClaimLocalService(serviceRef);
+
     LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
                 "Service (%s:%s) not owned by calling thread.",
                 serviceRef->interface.id.name,
@@ -1168,6 +2015,9 @@ le_msg_SessionEventHandlerRef_t le_msg_AddServiceCloseHandler
 {
     LE_FATAL_IF(serviceRef == NULL,
                 "Service doesn't exist. Make sure service is started before setting handlers");
+
+    ClaimLocalService(serviceRef);
+
     LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
                 "Service (%s:%s) not owned by calling thread.",
                 serviceRef->interface.id.name,
@@ -1243,6 +2093,8 @@ void le_msg_SetServiceRecvHandler
 )
 //--------------------------------------------------------------------------------------------------
 {
+    ClaimLocalService(serviceRef);
+
     LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
                 "Service (%s:%s) not owned by calling thread.",
                 serviceRef->interface.id.name,
@@ -1253,6 +2105,77 @@ void le_msg_SetServiceRecvHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a pool of worker threads that handle the messages received from clients of a service,
+ * instead of the service's server thread.
+ *
+ * Each session is assigned to one worker when it opens, so messages from the same client are
+ * still handled one at a time and in order, while messages from different clients can be
+ * handled in parallel.  Session open and close handlers still run in the server thread.
+ *
+ * @note    This is a server-only function that can only be called by the service's server thread,
+ *          at most once, and before the service is advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceThreadPool
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              threadCount ///< [in] Number of worker threads (1 or more).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ClaimLocalService(serviceRef);
+
+    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
+                "Service (%s:%s) not owned by calling thread.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF(serviceRef->workerCount != 0,
+                "Service (%s:%s) already has a thread pool.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF(serviceRef->state != LE_MSG_INTERFACE_SERVICE_HIDDEN,
+                "Thread pool must be set before service (%s:%s) is advertised.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF((threadCount == 0) || (threadCount > MSG_INTERFACE_MAX_WORKER_THREADS),
+                "Invalid thread pool size %zu for service (%s:%s) (must be 1 to %d).",
+                threadCount,
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef),
+                MSG_INTERFACE_MAX_WORKER_THREADS);
+
+    le_sem_Ref_t readySemRef = le_sem_Create("ipcWorkerReady", 0);
+    size_t i;
+
+    for (i = 0; i < threadCount; i++)
+    {
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+
+        snprintf(threadName, sizeof(threadName), "ipcWorker%zu", i);
+
+        le_thread_Ref_t threadRef = le_thread_Create(threadName, WorkerThreadMain, readySemRef);
+        le_thread_Start(threadRef);
+
+        serviceRef->workerThreads[i] = threadRef;
+    }
+
+    // Wait for all the workers to be ready to have functions queued to them.
+    for (i = 0; i < threadCount; i++)
+    {
+        le_sem_Wait(readySemRef);
+    }
+
+    le_sem_Delete(readySemRef);
+
+    serviceRef->workerCount = threadCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -1308,11 +2231,40 @@ void le_msg_AdvertiseService
 )
 //--------------------------------------------------------------------------------------------------
 {
+    ClaimLocalService(serviceRef);
+
     LE_FATAL_IF(serviceRef->state != LE_MSG_INTERFACE_SERVICE_HIDDEN,
                 "Re-advertising before hiding service '%s:%s'.",
                 serviceRef->interface.id.name,
                 le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
 
+    // A local service isn't known to the Service Directory.  Just let the clients in this
+    // process that are waiting for it know that it is available.
+    if (serviceRef->isLocal)
+    {
+        LOCK
+        serviceRef->state = LE_MSG_INTERFACE_SERVICE_ADVERTISED;
+        UNLOCK
+
+        for (;;)
+        {
+            le_dls_Link_t* linkPtr;
+
+            LOCK
+            linkPtr = le_dls_Pop(&serviceRef->localWaitList);
+            UNLOCK
+
+            if (linkPtr == NULL)
+            {
+                break;
+            }
+
+            msgSession_LocalServiceAdvertised(linkPtr);
+        }
+
+        return;
+    }
+
     serviceRef->state = LE_MSG_INTERFACE_SERVICE_CONNECTING;
 
     // Open a socket.
@@ -1378,6 +2330,12 @@ void le_msg_HideService
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (serviceRef->isLocal)
+    {
+        serviceRef->state = LE_MSG_INTERFACE_SERVICE_HIDDEN;
+        return;
+    }
+
     // Stop monitoring the directory socket.
     le_fdMonitor_Delete(serviceRef->fdMonitorRef);
     serviceRef->fdMonitorRef = NULL;
@@ -1386,6 +2344,9 @@ void le_msg_HideService
     fd_Close(serviceRef->directorySocketFd);
     serviceRef->directorySocketFd = -1;
 
+    // Clients must not be able to open new sessions through connectors either.
+    DeleteAllConnectors(serviceRef);
+
     serviceRef->state = LE_MSG_INTERFACE_SERVICE_HIDDEN;
 }
 
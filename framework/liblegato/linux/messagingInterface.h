@@ -57,6 +57,34 @@ typedef struct le_msg_Interface
 msgInterface_Interface_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of worker threads that can be attached to a single service using
+ * le_msg_SetServiceThreadPool().
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_INTERFACE_MAX_WORKER_THREADS   8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Service statistics, read by the inspect tool from outside the process.
+ *
+ * These are updated using atomic operations, because the server thread and the service's worker
+ * threads all update them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t        msgCount;           ///< Number of client messages passed to the recvHandler.
+    uint64_t        serviceTimeUs;      ///< Total time spent in the recvHandler, in microseconds.
+    uint64_t        maxServiceTimeUs;   ///< Longest single recvHandler call, in microseconds.
+    size_t          pendingCount;       ///< Messages queued to worker threads, not yet handled.
+    size_t          maxPendingCount;    ///< Largest pendingCount ever seen.
+}
+msgInterface_ServiceStats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Service object.  Represents a single, unique service instance offered by a server.
@@ -89,11 +117,24 @@ typedef struct le_msg_Service
     le_msg_ReceiveHandler_t         recvHandler;    ///< Handler for when messages are received.
     void*                           recvContextPtr; ///< contextPtr parameter for recvHandler.
 
+    size_t          workerCount;        ///< Number of worker threads dispatching client requests
+                                        ///  (0 = requests are handled by the server thread).
+    size_t          nextWorker;         ///< Index of the worker to assign to the next session.
+    le_thread_Ref_t workerThreads[MSG_INTERFACE_MAX_WORKER_THREADS]; ///< Worker threads.
+
     le_dls_List_t                   openListPtr; ///< open List: list of open session handlers
                                                  ///  called when a session is opened
 
     le_dls_List_t                   closeListPtr; ///< open List: list of close session handlers
                                                   ///  called when a session is opened
+    le_dls_List_t   connectorList;      ///< Connectors clients can open sessions through without
+                                        ///  going through the Service Directory.
+
+    bool            isLocal;            ///< true = only clients in this process can use it.
+    le_dls_List_t   localWaitList;      ///< Client sessions in this process waiting for the
+                                        ///  service to be advertised.
+
+    msgInterface_ServiceStats_t stats;  ///< Statistics for the inspect tool.
 }
 msgInterface_Service_t;
 
@@ -108,6 +149,9 @@ typedef struct le_msg_ClientInterface
     msgInterface_Interface_t interface; ///< The interface part of a client interface object.
 
     // Stuff used only on the Client side:
+    bool            cacheEndpoint;      ///< true = keep a connector to the server, so sessions can
+                                        ///  be opened without going through the Service Directory.
+    int             connectorFd;        ///< Fd of the connector socket (-1 if none).
 }
 msgInterface_ClientInterface_t;
 
@@ -270,4 +314,146 @@ void msgInterface_ProcessMessageFromClient
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Selects the worker thread that will handle requests received on a new server-side session.
+ * Sessions are spread across the service's worker threads in round-robin order.
+ *
+ * @return  The worker thread, or NULL if the service's server thread handles all requests.
+ */
+//--------------------------------------------------------------------------------------------------
+le_thread_Ref_t msgInterface_SelectWorkerThread
+(
+    le_msg_ServiceRef_t serviceRef  ///< [IN] Reference to the Service object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turns on endpoint caching for a client interface.  Once a connector has been stored using
+ * msgInterface_SetConnector(), sessions on this interface can be opened over it without going
+ * through the Service Directory.
+ *
+ * @note The client interface object is kept for the life of the process after this.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_EnableEndpointCache
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a client interface wants a connector but doesn't have one yet.
+ *
+ * @return true if a connector should be opened and stored using msgInterface_SetConnector().
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_NeedsConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stores a client interface's connector.  The client interface takes ownership of the fd.  If the
+ * interface already has a connector, the new one is closed.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_SetConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef,  ///< [IN] Reference to the Client Interface object.
+    int                         fd          ///< [IN] Connected connector socket.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a client interface's connector, if it has one, so that the next session opened on it goes
+ * through the Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_DropConnector
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hands a new session socket to a client interface's server over the interface's connector.
+ *
+ * @return The client's end of the new session socket, whose next message will be the server's
+ *         LE_OK "hello" message, or -1 if the interface has no working connector.
+ */
+//--------------------------------------------------------------------------------------------------
+int msgInterface_HandOffToServer
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a Service's registered session open handler functions, if there are any registered.
+ *
+ * @note    This only gets called by the server thread for the service.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_CallOpenHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for a service in this process that a client interface has a local binding to (see
+ * le_msg_AddLocalBinding()), which can accept sessions right now.  Must be released using
+ * msgInterface_Release() when you are done with it.
+ *
+ * @return  Reference to the Service object, or NULL if sessions must go through the Service
+ *          Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t msgInterface_FindLocalService
+(
+    le_msg_ClientInterfaceRef_t clientRef   ///< [IN] Reference to the Client Interface object.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a service in this process can accept sessions right now, and if not, adds a
+ * client session's link to the list of sessions waiting for the service to be advertised.
+ * msgSession_LocalServiceAdvertised() will be called for the link when that happens.
+ *
+ * @return  true if the service can accept sessions now (in which case the link was not queued).
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_WaitForLocalService
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_dls_Link_t*      linkPtr     ///< [IN] Session's wait link.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a client session's link from a service's list of sessions waiting for the service to be
+ * advertised, if it is still on it.
+ *
+ * @return  true if the link was removed, false if it wasn't on the list.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_CancelLocalWait
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_dls_Link_t*      linkPtr     ///< [IN] Session's wait link.
+);
+
+
 #endif // LE_MESSAGING_INTERFACE_H_INCLUDE_GUARD
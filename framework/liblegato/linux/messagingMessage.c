@@ -15,6 +15,34 @@
 #include "fileDescriptor.h"
 #include "unixSocket.h"
 
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// Older C libraries don't provide the memfd and file sealing definitions even when the kernel
+// supports them, so fall back to the values from the kernel's UAPI headers.
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS         1033
+#define F_GET_SEALS         1034
+#endif
+#ifndef F_SEAL_SEAL
+#define F_SEAL_SEAL         0x0001
+#define F_SEAL_SHRINK       0x0002
+#define F_SEAL_GROW         0x0004
+#define F_SEAL_WRITE        0x0008
+#endif
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC         0x0001U
+#define MFD_ALLOW_SEALING   0x0002U
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest payload buffer given to a received message, so that a fixed-size header at the start
+ * of the payload can always be read, even if the sender sent less than that.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_RX_PAYLOAD_SIZE 16
+
 // =======================================
 //  PRIVATE FUNCTIONS
 // =======================================
@@ -67,6 +95,71 @@ static void MessageDestructor
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the fields of a Message object that are specific to the side (client or server) of
+ * the session that the message belongs to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitSideFields
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(msgPtr->sessionRef);
+    switch (interfaceType)
+    {
+        case LE_MSG_INTERFACE_CLIENT:
+            msgPtr->clientServer.client.completionCallback = NULL;
+            msgPtr->clientServer.client.contextPtr = NULL;
+            break;
+
+        case LE_MSG_INTERFACE_SERVER:
+            msgPtr->clientServer.server.responseFd = -1;
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message with a payload buffer of a given size.  The payload buffer is not cleared.
+ *
+ * @return  Pointer to the Message object.
+ */
+//--------------------------------------------------------------------------------------------------
+static Message_t* CreateMessage
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t              bufferSize  ///< [in] Size of the payload buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
+    // object from its Message Pools.
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
+    Message_t* msgPtr = msgProto_AllocMessage(protocolRef, bufferSize);
+
+    // Initialize the Message object's data members.
+    msgPtr->link = LE_DLS_LINK_INIT;
+    msgPtr->sessionRef = sessionRef;
+    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+
+    InitSideFields(msgPtr);
+
+    msgPtr->fd = -1;
+    msgPtr->bufferSize = bufferSize;
+    msgPtr->payloadSize = bufferSize;
+    msgPtr->txnId = 0;
+
+    return msgPtr;
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -89,14 +182,17 @@ void msgMessage_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a Message Pool.
+ * Create the size-classed Message Pools for a protocol.
  *
- * @return  A reference to the pool.
+ * Messages are allocated from the smallest pool that fits the payload they need, so that small
+ * messages don't tie up a buffer big enough for the largest message in the protocol.
+ *
+ * @return  A reference to the slab allocator holding the pools.
  */
 //--------------------------------------------------------------------------------------------------
-le_mem_PoolRef_t msgMessage_CreatePool
+le_mem_SlabRef_t msgMessage_CreateSlab
 (
-    const char* name,       ///< [in] Name of the pool.
+    const char* name,       ///< [in] Name of the pools.
     size_t largestMsgSize   ///< [in] Size of the largest message payload, in bytes.
 )
 //--------------------------------------------------------------------------------------------------
@@ -112,13 +208,34 @@ le_mem_PoolRef_t msgMessage_CreatePool
         LE_DEBUG("Pool name truncated to '%s' for protocol '%s'.", poolName, name);
     }
 
-    le_mem_PoolRef_t poolRef = le_mem_CreatePool(poolName, sizeof(Message_t) + largestMsgSize);
+    le_mem_SlabRef_t slabRef = le_mem_CreateSlabAllocator(poolName,
+                                                          sizeof(Message_t) + largestMsgSize);
 
-    le_mem_SetDestructor(poolRef, MessageDestructor);
+    le_mem_SetSlabDestructor(slabRef, MessageDestructor);
 
-    le_mem_ExpandPool(poolRef, 10); /// @todo Make this configurable.
+    // Servers receive every request into a full-size message, because the response is built in the
+    // same buffer, so that is the size class that needs to be ready up front.
+    le_mem_ExpandSlabAllocator(slabRef, sizeof(Message_t) + largestMsgSize, 10);
+                                    /// @todo Make this configurable.
+
+    return slabRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepares a memory pool provided by a local service to hold the service's Message objects.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_InitPool
+(
+    le_mem_PoolRef_t poolRef    ///< [in] Pool of blocks of LE_MSG_LOCAL_HEADER_SIZE + payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(sizeof(Message_t) <= LE_MSG_LOCAL_HEADER_SIZE);
 
-    return poolRef;
+    le_mem_SetDestructor(poolRef, MessageDestructor);
 }
 
 
@@ -160,9 +277,10 @@ le_result_t msgMessage_Send
 
     // The first bytes come from our transaction ID and the rest (if any)
     // from our Message object's payload section, which comes right after the transaction ID.
+    // Only the part of the payload that is in use is sent.
     return unixSocket_SendMsg(  socketFd,
                                 &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
+                                sizeof(msgPtr->txnId) + msgPtr->payloadSize,
                                 msgPtr->fd,
                                 false   ); // Don't send process credentials.
 }
@@ -170,7 +288,85 @@ le_result_t msgMessage_Send
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receive a single message from a connected socket.
+ * Send several client request messages over a connected socket, in order.  Consecutive messages
+ * that don't carry a file descriptor are handed to the kernel together, so a batch of small
+ * requests costs a single system call.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ *
+ * @note    On failure, *sentCountPtr is set to the number of messages that were sent.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int                     socketFd,       ///< [IN] Connected socket's file descriptor.
+    le_msg_MessageRef_t*    msgRefs,        ///< [IN] The Messages to be sent.
+    size_t                  msgCount,       ///< [IN] Number of Messages to be sent.
+    size_t*                 sentCountPtr    ///< [OUT] Number of Messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Maximum number of messages gathered into one batch send.
+    #define MAX_BATCH_MSGS 16
+
+    struct iovec ioVectors[MAX_BATCH_MSGS];
+    le_result_t result = LE_OK;
+
+    *sentCountPtr = 0;
+
+    while ((*sentCountPtr < msgCount) && (result == LE_OK))
+    {
+        Message_t* msgPtr = msgRefs[*sentCountPtr];
+
+        // A message carrying a file descriptor needs its own control message, so send it alone.
+        if (msgPtr->fd >= 0)
+        {
+            result = msgMessage_Send(socketFd, msgPtr);
+            if (result == LE_OK)
+            {
+                (*sentCountPtr)++;
+            }
+            continue;
+        }
+
+        // Gather the run of messages that carry only data.
+        size_t count = 0;
+        while ((count < MAX_BATCH_MSGS) && ((*sentCountPtr + count) < msgCount))
+        {
+            msgPtr = msgRefs[*sentCountPtr + count];
+            if (msgPtr->fd >= 0)
+            {
+                break;
+            }
+            ioVectors[count].iov_base = &msgPtr->txnId;
+            ioVectors[count].iov_len = sizeof(msgPtr->txnId) + msgPtr->payloadSize;
+            count++;
+        }
+
+        size_t sent;
+        result = unixSocket_SendDataMsgs(socketFd, ioVectors, count, &sent);
+        *sentCountPtr += sent;
+    }
+
+    #undef MAX_BATCH_MSGS
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a single message from a connected socket into a new Message object that is just big
+ * enough to hold it.  On the server side, the Message object is always big enough to hold the
+ * largest message in the protocol, because the response is built in the same buffer.
+ *
+ * The part of the payload buffer that was not filled by the received message is cleared, and the
+ * whole buffer will be sent if the message is sent on (or responded to) without calling
+ * le_msg_SetPayloadSize().
  *
  * @return
  * - LE_OK if successful.
@@ -181,25 +377,165 @@ le_result_t msgMessage_Send
 //--------------------------------------------------------------------------------------------------
 le_result_t msgMessage_Receive
 (
-    int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    int                     socketFd,   ///< [IN] The socket's file descriptor.
+    le_msg_SessionRef_t     sessionRef, ///< [IN] Session the message is received on.
+    le_msg_MessageRef_t*    msgRefPtr   ///< [OUT] Set to the received message (NULL on failure).
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_result_t result;
+    size_t maxPayloadSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
+    size_t bufferSize = maxPayloadSize;
+
+    *msgRefPtr = NULL;
+
+    if (msgSession_GetInterfaceType(sessionRef) == LE_MSG_INTERFACE_CLIENT)
+    {
+        size_t msgSize;
+
+        result = unixSocket_PeekMsgSize(socketFd, &msgSize);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        // A message that is too big for the protocol is truncated (and reported) by the receive
+        // below, so never go over the maximum.
+        if (msgSize < sizeof(((Message_t*)0)->txnId) + MIN_RX_PAYLOAD_SIZE)
+        {
+            bufferSize = MIN_RX_PAYLOAD_SIZE;
+        }
+        else
+        {
+            bufferSize = msgSize - sizeof(((Message_t*)0)->txnId);
+        }
+
+        if (bufferSize > maxPayloadSize)
+        {
+            bufferSize = maxPayloadSize;
+        }
+    }
+
+    Message_t* msgPtr = CreateMessage(sessionRef, bufferSize);
+
     // Receive the first bytes into our transaction ID and the rest (if any)
     // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
-    le_result_t result = unixSocket_ReceiveMsg( socketFd,
-                                                &msgRef->txnId,
-                                                &byteCount,
-                                                &msgRef->fd,
-                                                NULL    );  // Don't receive credentials.
-    if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
+    size_t byteCount = sizeof(msgPtr->txnId) + bufferSize;
+    result = unixSocket_ReceiveMsg( socketFd,
+                                    &msgPtr->txnId,
+                                    &byteCount,
+                                    &msgPtr->fd,
+                                    NULL    );  // Don't receive credentials.
+    if (result != LE_OK)
     {
+        le_mem_Release(msgPtr);
+        return result;
+    }
+
+    size_t receivedSize = 0;
+    if (byteCount > sizeof(msgPtr->txnId))
+    {
+        receivedSize = byteCount - sizeof(msgPtr->txnId);
+    }
+    memset((uint8_t*)msgPtr->payload + receivedSize, 0, bufferSize - receivedSize);
+
+    *msgRefPtr = msgPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a request message sent by a client in the same process into a new Message object on the
+ * server side of the session, just as msgMessage_Receive() would for a request received over a
+ * socket.  The file descriptor (if any) is moved into the copy.
+ *
+ * @return  The server-side copy.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_CopyRequest
+(
+    le_msg_SessionRef_t     sessionRef, ///< [IN] Server-side session to receive the copy on.
+    le_msg_MessageRef_t     msgRef      ///< [IN] Client's request message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The server builds its response in the same buffer, so it gets the largest size.
+    size_t bufferSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
+
+    Message_t* copyPtr = CreateMessage(sessionRef, bufferSize);
+
+    memcpy(copyPtr->payload, msgRef->payload, msgRef->payloadSize);
+    memset((uint8_t*)copyPtr->payload + msgRef->payloadSize, 0, bufferSize - msgRef->payloadSize);
+
+    copyPtr->txnId = msgRef->txnId;
+    copyPtr->fd = msgRef->fd;
+    msgRef->fd = -1;
+
+    return copyPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hands a Message object over to the other end of a session with a peer in the same process,
+ * instead of sending it over a socket.  A response has its response fd moved into place, as
+ * msgMessage_Send() would do.
+ *
+ * Only the part of the payload that is in use is handed over: the rest of the buffer is cleared,
+ * and a client gets a buffer that is just big enough, as it would from msgMessage_Receive().
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_MoveToSession
+(
+    le_msg_MessageRef_t     msgRef,     ///< [IN] The Message to hand over.
+    le_msg_SessionRef_t     sessionRef  ///< [IN] Session at the receiving end.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If this is a response message,
+    if (le_msg_NeedsResponse(msgRef))
+    {
+        // If there was an fd that was received from the client but not fetched from the message
+        // generate a warning and close that fd.
+        if (msgRef->fd >= 0)
+        {
+            LE_WARN("File descriptor not retrieved from message received from client.");
+            fd_Close(msgRef->fd);
+        }
+
+        // Move the responseFd to the normal fd position in the message object.
+        msgRef->fd = msgRef->clientServer.server.responseFd;
         msgRef->clientServer.server.responseFd = -1;
     }
 
-    return result;
+    // The Message object now holds a reference to the receiving Session object instead.
+    le_mem_AddRef(sessionRef);
+    le_mem_Release(msgRef->sessionRef);
+    msgRef->sessionRef = sessionRef;
+
+    InitSideFields(msgRef);
+
+    size_t bufferSize = msgRef->bufferSize;
+
+    if (msgSession_GetInterfaceType(sessionRef) == LE_MSG_INTERFACE_CLIENT)
+    {
+        bufferSize = msgRef->payloadSize;
+
+        if (bufferSize < MIN_RX_PAYLOAD_SIZE)
+        {
+            bufferSize = MIN_RX_PAYLOAD_SIZE;
+        }
+        if (bufferSize > msgRef->bufferSize)
+        {
+            bufferSize = msgRef->bufferSize;
+        }
+    }
+
+    memset((uint8_t*)msgRef->payload + msgRef->payloadSize, 0, bufferSize - msgRef->payloadSize);
+    msgRef->bufferSize = bufferSize;
+    msgRef->payloadSize = bufferSize;
 }
 
 
@@ -245,35 +581,43 @@ le_msg_MessageRef_t le_msg_CreateMsg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
-    // object from its Message Pool.
-    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
-    Message_t* msgPtr = msgProto_AllocMessage(protocolRef);
+    size_t maxPayloadSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
 
-    // Initialize the Message object's data members.
-    msgPtr->link = LE_DLS_LINK_INIT;
-    msgPtr->sessionRef = sessionRef;
-    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+    Message_t* msgPtr = CreateMessage(sessionRef, maxPayloadSize);
+    memset(msgPtr->payload, 0, maxPayloadSize);
 
-    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
-    switch (interfaceType)
-    {
-        case LE_MSG_INTERFACE_CLIENT:
-            msgPtr->clientServer.client.completionCallback = NULL;
-            msgPtr->clientServer.client.contextPtr = NULL;
-            break;
+    return msgPtr;
+}
 
-        case LE_MSG_INTERFACE_SERVER:
-            msgPtr->clientServer.server.responseFd = -1;
-            break;
 
-        default:
-            LE_FATAL("Unhandled interface type (%d).", interfaceType);
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to be sent over a given session, with a payload buffer that is only as big
+ * as the sender needs, instead of big enough for the largest message in the protocol.
+ *
+ * @return  The message reference.
+ *
+ * @note
+ * - This function never returns on failure, so no need to check the return code.
+ * - The payload size must not be larger than the protocol's maximum message size.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateSizedMsg
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t              payloadSize ///< [in] Size of the payload buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxPayloadSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
 
-    msgPtr->fd = -1;
-    msgPtr->txnId = 0;
-    memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
+    LE_FATAL_IF(payloadSize > maxPayloadSize,
+                "Message payload size %zu is larger than protocol maximum (%zu).",
+                payloadSize,
+                maxPayloadSize);
+
+    Message_t* msgPtr = CreateMessage(sessionRef, payloadSize);
+    memset(msgPtr->payload, 0, payloadSize);
 
     return msgPtr;
 }
@@ -368,7 +712,29 @@ size_t le_msg_GetMaxPayloadSize
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(msgRef->sessionRef));
+    return msgRef->bufferSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets how many bytes at the start of the message payload buffer are to be sent.  By default, the
+ * whole payload buffer is sent.
+ **/
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of payload bytes to send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(payloadSize > msgRef->bufferSize,
+                "Payload size %zu is larger than message buffer (%zu).",
+                payloadSize,
+                msgRef->bufferSize);
+
+    msgRef->payloadSize = payloadSize;
 }
 
 
@@ -433,6 +799,174 @@ int le_msg_GetFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a buffer into a sealed, anonymous shared memory file and attaches that file's descriptor
+ * to the message.  The receiver can then map the buffer with le_msg_GetSharedBuffer() instead of
+ * having it copied through the message payload.
+ *
+ * Because this uses the message's file descriptor, it can't be combined with le_msg_SetFd().
+ * An empty buffer sends nothing.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_NOT_IMPLEMENTED if the kernel doesn't support memfd_create().
+ *  - LE_NO_MEMORY if the shared memory could not be allocated.
+ *  - LE_FAULT for any other failure.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t le_msg_SetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    const void*         dataPtr,    ///< [in] Buffer to send.
+    size_t              size        ///< [in] Number of bytes in the buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (size == 0)
+    {
+        return LE_OK;
+    }
+
+#ifdef __NR_memfd_create
+    int fd = syscall(__NR_memfd_create, "le_msg_SharedBuffer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+    {
+        if (errno == ENOSYS)
+        {
+            return LE_NOT_IMPLEMENTED;
+        }
+        LE_ERROR("memfd_create() failed (%m).");
+        return (errno == ENOMEM) ? LE_NO_MEMORY : LE_FAULT;
+    }
+
+    if (ftruncate(fd, size) != 0)
+    {
+        LE_ERROR("Failed to size shared buffer to %zu bytes (%m).", size);
+        fd_Close(fd);
+        return LE_NO_MEMORY;
+    }
+
+    void* mapPtr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map shared buffer (%m).");
+        fd_Close(fd);
+        return LE_NO_MEMORY;
+    }
+    memcpy(mapPtr, dataPtr, size);
+
+    // The writable mapping must be gone before the write seal can be applied.
+    munmap(mapPtr, size);
+
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+    {
+        LE_ERROR("Failed to seal shared buffer (%m).");
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    le_msg_SetFd(msgRef, fd);
+
+    return LE_OK;
+#else
+    (void)msgRef;
+    (void)dataPtr;
+    return LE_NOT_IMPLEMENTED;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a buffer sent using le_msg_SetSharedBuffer() into the caller's address space, read-only.
+ *
+ * The file must be sealed against shrinking and writing, so the sender can't change or truncate
+ * the buffer while the receiver is reading it.  The mapping must be released using
+ * le_msg_ReleaseSharedBuffer().
+ *
+ * If no file descriptor was sent with the message, *dataPtrPtr is set to NULL and *sizePtr to 0.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FAULT if the received file descriptor is not a sealed shared buffer or could not be mapped.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t le_msg_GetSharedBuffer
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    const void**        dataPtrPtr, ///< [out] Set to the address of the mapped buffer.
+    size_t*             sizePtr     ///< [out] Set to the number of bytes in the buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *dataPtrPtr = NULL;
+    *sizePtr = 0;
+
+    int fd = le_msg_GetFd(msgRef);
+    if (fd < 0)
+    {
+        return LE_OK;
+    }
+
+    le_result_t result = LE_FAULT;
+
+    int seals = fcntl(fd, F_GET_SEALS);
+    struct stat st;
+
+    if ((seals < 0) || ((seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) != (F_SEAL_SHRINK | F_SEAL_WRITE)))
+    {
+        LE_ERROR("Received file descriptor is not a sealed shared buffer.");
+    }
+    else if (fstat(fd, &st) != 0)
+    {
+        LE_ERROR("Failed to get shared buffer size (%m).");
+    }
+    else if (st.st_size == 0)
+    {
+        result = LE_OK;
+    }
+    else
+    {
+        void* mapPtr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapPtr == MAP_FAILED)
+        {
+            LE_ERROR("Failed to map shared buffer (%m).");
+        }
+        else
+        {
+            *dataPtrPtr = mapPtr;
+            *sizePtr = st.st_size;
+            result = LE_OK;
+        }
+    }
+
+    // The mapping stays valid after the file descriptor is closed.
+    fd_Close(fd);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a buffer mapped by le_msg_GetSharedBuffer().
+ **/
+//--------------------------------------------------------------------------------------------------
+void le_msg_ReleaseSharedBuffer
+(
+    const void* dataPtr,    ///< [in] Buffer address returned by le_msg_GetSharedBuffer().
+    size_t      size        ///< [in] Buffer size returned by le_msg_GetSharedBuffer().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (dataPtr != NULL)
+    {
+        munmap((void*)dataPtr, size);
+    }
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -540,6 +1074,37 @@ le_msg_MessageRef_t le_msg_RequestSyncResponse
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Requests responses from a server by sending it several requests at once.  All the requests are
+ * sent before the calling thread blocks, and the function returns once every transaction has
+ * either been answered or terminated without a response.
+ *
+ * Each entry in the array is replaced by a reference to the response to that request, or NULL if
+ * the transaction terminated without a response.  The request references are released.
+ *
+ * @note
+ *        - All the requests must belong to the same session.
+ *        - The same restrictions as for le_msg_RequestSyncResponse() apply.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_RequestSyncResponseBatch
+(
+    le_msg_MessageRef_t*    msgRefs,    ///< [in,out] Requests in; responses (or NULL) out.
+    size_t                  msgCount    ///< [in] Number of entries in the array.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgCount == 0)
+    {
+        return;
+    }
+
+    // Tell the Session to do the batch of synchronous request-response transactions.
+    msgSession_DoSyncRequestResponseBatch(msgRefs[0]->sessionRef, msgRefs, msgCount);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a response back to the client that send the request message.
@@ -41,6 +41,8 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    size_t                      bufferSize; ///< Size of this message's payload buffer, in bytes.
+    size_t                      payloadSize;///< Payload bytes to send, or received, in bytes.
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
@@ -61,18 +63,59 @@ void msgMessage_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a Message Pool.
+ * Create the size-classed Message Pools for a protocol.
  *
- * @return  A reference to the pool.
+ * @return  A reference to the slab allocator holding the pools.
  */
 //--------------------------------------------------------------------------------------------------
-le_mem_PoolRef_t msgMessage_CreatePool
+le_mem_SlabRef_t msgMessage_CreateSlab
 (
-    const char* name,       ///< [in] Name of the pool.
+    const char* name,       ///< [in] Name of the pools.
     size_t largestMsgSize   ///< [in] Size of the largest message payload, in bytes.
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepares a memory pool provided by a local service to hold the service's Message objects.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_InitPool
+(
+    le_mem_PoolRef_t poolRef    ///< [in] Pool of blocks of LE_MSG_LOCAL_HEADER_SIZE + payload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a request message sent by a client in the same process into a new Message object on the
+ * server side of the session, just as msgMessage_Receive() would for a request received over a
+ * socket.  The file descriptor (if any) is moved into the copy.
+ *
+ * @return  The server-side copy.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_CopyRequest
+(
+    le_msg_SessionRef_t     sessionRef, ///< [IN] Server-side session to receive the copy on.
+    le_msg_MessageRef_t     msgRef      ///< [IN] Client's request message.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hands a Message object over to the other end of a session with a peer in the same process,
+ * instead of sending it over a socket.  A response has its response fd moved into place, as
+ * msgMessage_Send() would do.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgMessage_MoveToSession
+(
+    le_msg_MessageRef_t     msgRef,     ///< [IN] The Message to hand over.
+    le_msg_SessionRef_t     sessionRef  ///< [IN] Session at the receiving end.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send a single message over a connected socket.
@@ -92,7 +135,31 @@ le_result_t msgMessage_Send
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receive a single message from a connected socket.
+ * Send several client request messages over a connected socket, in order.  Consecutive messages
+ * that don't carry a file descriptor are handed to the kernel together.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the socket reported an error on the send operation.
+ *
+ * @note    On failure, *sentCountPtr is set to the number of messages that were sent.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int                     socketFd,       ///< [IN] Connected socket's file descriptor.
+    le_msg_MessageRef_t*    msgRefs,        ///< [IN] The Messages to be sent.
+    size_t                  msgCount,       ///< [IN] Number of Messages to be sent.
+    size_t*                 sentCountPtr    ///< [OUT] Number of Messages sent.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a single message from a connected socket into a new Message object that is just big
+ * enough to hold it.  On the server side, the Message object is always big enough to hold the
+ * largest message in the protocol, because the response is built in the same buffer.
  *
  * @return
  * - LE_OK if successful.
@@ -103,8 +170,9 @@ le_result_t msgMessage_Send
 //--------------------------------------------------------------------------------------------------
 le_result_t msgMessage_Receive
 (
-    int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    int                     socketFd,   ///< [IN] The socket's file descriptor.
+    le_msg_SessionRef_t     sessionRef, ///< [IN] Session the message is received on.
+    le_msg_MessageRef_t*    msgRefPtr   ///< [OUT] Set to the received message (NULL on failure).
 );
 
 
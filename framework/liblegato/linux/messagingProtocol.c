@@ -115,7 +115,8 @@ static msgProtocol_Protocol_t* CreateProtocol
         LE_CRIT("Protocol identifier truncated from '%s' to '%s'.", protocolId, protocolPtr->id);
     }
 
-    protocolPtr->messagePoolRef = msgMessage_CreatePool(protocolId, largestMsgSize);
+    protocolPtr->messageSlabRef = msgMessage_CreateSlab(protocolId, largestMsgSize);
+    protocolPtr->messagePoolRef = NULL;
 
     LOCK
 
@@ -150,19 +151,48 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from a given Protocol's Message Pools.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t payloadSize              ///< [in] Payload bytes needed (at most the protocol maximum).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Allocate a Message object from this Protocol's Message Pool.
-    return le_mem_ForceAlloc(protocolRef->messagePoolRef);
+    LE_ASSERT(payloadSize <= protocolRef->maxPayloadSize);
+
+    if (protocolRef->messagePoolRef != NULL)
+    {
+        return le_mem_ForceAlloc(protocolRef->messagePoolRef);
+    }
+
+    // Allocate a Message object from the smallest of this Protocol's Message Pools that fits.
+    return le_mem_ForceSlabAlloc(protocolRef->messageSlabRef, sizeof(Message_t) + payloadSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a given Protocol allocate all its Message objects from a pool provided by a local service,
+ * instead of from the Protocol's own size-classed pools.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgProto_SetMessagePool
+(
+    le_msg_ProtocolRef_t protocolRef,
+    le_mem_PoolRef_t poolRef        ///< [in] Pool of blocks of LE_MSG_LOCAL_HEADER_SIZE + payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(le_mem_GetObjectSize(poolRef) >= sizeof(Message_t) + protocolRef->maxPayloadSize);
+
+    msgMessage_InitPool(poolRef);
+
+    protocolRef->messagePoolRef = poolRef;
 }
 
 
@@ -20,7 +20,8 @@ typedef struct le_msg_Protocol
     le_sls_Link_t link;                     ///< Used to link this into the Protocol List.
     char id[LIMIT_MAX_PROTOCOL_ID_BYTES];   ///< Unique identifier for the protocol.
     size_t maxPayloadSize;                  ///< Max payload size (in bytes) in this protocol.
-    le_mem_PoolRef_t messagePoolRef;        ///< Pool of Message objects.
+    le_mem_SlabRef_t messageSlabRef;        ///< Size-classed pools of Message objects.
+    le_mem_PoolRef_t messagePoolRef;        ///< Pool provided by a local service (or NULL).
 }
 msgProtocol_Protocol_t;
 
@@ -39,14 +40,28 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from a given Protocol's Message Pools.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t payloadSize              ///< [in] Payload bytes needed (at most the protocol maximum).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a given Protocol allocate all its Message objects from a pool provided by a local service,
+ * instead of from the Protocol's own size-classed pools.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgProto_SetMessagePool
+(
+    le_msg_ProtocolRef_t protocolRef,
+    le_mem_PoolRef_t poolRef        ///< [in] Pool of blocks of LE_MSG_LOCAL_HEADER_SIZE + payload.
 );
 
 
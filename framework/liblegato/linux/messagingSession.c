@@ -17,6 +17,7 @@
 #include "messagingProtocol.h"
 #include "messagingMessage.h"
 #include "fileDescriptor.h"
+#include "tracepoint.h"
 
 
 // =======================================
@@ -24,10 +25,17 @@
 // =======================================
 
 //--------------------------------------------------------------------------------------------------
-/// The peak number of outstanding request-response transactions that we expect to have
-/// ongoing at the same time in the same process.
+/// Number of slots in a session's Transaction Table when it is first allocated.  Must be a power
+/// of two.
 //--------------------------------------------------------------------------------------------------
-#define MAX_EXPECTED_TXNS 32
+#define MIN_TXN_TABLE_SLOTS 8
+
+//--------------------------------------------------------------------------------------------------
+/// Largest number of slots a session's Transaction Table can grow to.  Must be a power of two.
+/// The table is kept at most half full, so this allows up to half as many outstanding
+/// request-response transactions on the same session.
+//--------------------------------------------------------------------------------------------------
+#define MAX_TXN_TABLE_SLOTS 4096
 
 
 //--------------------------------------------------------------------------------------------------
@@ -64,13 +72,10 @@ static le_mem_PoolRef_t SessionPoolRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Transaction Map.  This is a Safe Reference Map used to generate and match up
- * transaction IDs for request-response transactions.
- *
- * @note    Because this is shared by multiple threads, it must be protected using the Mutex.
+ * Slab allocator from which sessions' Transaction Tables are allocated.
  */
 //--------------------------------------------------------------------------------------------------
-static le_ref_MapRef_t TxnMapRef;
+static le_mem_SlabRef_t TxnTableSlabRef;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -87,6 +92,7 @@ static size_t* SessionObjListChangeCountRef = &SessionObjListChangeCount;
 // =======================================
 
 static void AttemptOpen(msgSession_Session_t* sessionPtr);
+static void CloseLocalLink(msgSession_Session_t* sessionPtr);
 
 
 //--------------------------------------------------------------------------------------------------
@@ -107,6 +113,7 @@ static void PushTransmitQueue
 
     LOCK
     le_dls_Queue(&sessionPtr->transmitQueue, linkPtr);
+    sessionPtr->transmitCount++;
     UNLOCK
 }
 
@@ -131,6 +138,10 @@ static le_msg_MessageRef_t PopTransmitQueue
 
     LOCK
     linkPtr = le_dls_Pop(&sessionPtr->transmitQueue);
+    if (linkPtr != NULL)
+    {
+        sessionPtr->transmitCount--;
+    }
     UNLOCK
 
     if (linkPtr != NULL)
@@ -160,6 +171,7 @@ static void UnPopTransmitQueue
 
     LOCK
     le_dls_Stack(&sessionPtr->transmitQueue, linkPtr);
+    sessionPtr->transmitCount++;
     UNLOCK
 }
 
@@ -207,9 +219,77 @@ static le_msg_MessageRef_t PopReceiveQueue
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the slot of a session's Transaction Table that a given transaction ID maps to.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t TxnSlot
+(
+    msgSession_Session_t* sessionPtr,
+    void* txnId
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ((size_t)txnId & (sessionPtr->txnTableSize - 1));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Doubles the size of a session's Transaction Table (or allocates it, if it doesn't exist yet).
+ *
+ * Transaction IDs that map to different slots in a table also map to different slots in a table
+ * twice its size, so the outstanding transactions can just be moved across.
+ *
+ * @warning Assumes that the Mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowTxnTable
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t oldSize = sessionPtr->txnTableSize;
+    le_msg_MessageRef_t* oldTablePtr = sessionPtr->txnTable;
+    size_t newSize = (oldSize == 0 ? MIN_TXN_TABLE_SLOTS : oldSize * 2);
+
+    LE_FATAL_IF(newSize > MAX_TXN_TABLE_SLOTS,
+                "Too many outstanding transactions (%zu) on session with '%s'.",
+                sessionPtr->txnCount,
+                le_msg_GetInterfaceName(sessionPtr->interfaceRef));
+
+    sessionPtr->txnTable = le_mem_ForceSlabAlloc(TxnTableSlabRef,
+                                                 newSize * sizeof(le_msg_MessageRef_t));
+    memset(sessionPtr->txnTable, 0, newSize * sizeof(le_msg_MessageRef_t));
+    sessionPtr->txnTableSize = newSize;
+
+    if (oldTablePtr != NULL)
+    {
+        size_t i;
+
+        for (i = 0; i < oldSize; i++)
+        {
+            if (oldTablePtr[i] != NULL)
+            {
+                sessionPtr->txnTable[TxnSlot(sessionPtr, msgMessage_GetTxnId(oldTablePtr[i]))] =
+                                                                                    oldTablePtr[i];
+            }
+        }
+
+        le_mem_Release(oldTablePtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a transaction ID for a given message and stores it inside the Message object.
+ *
+ * Transaction IDs are allocated per session, from a counter, skipping any ID whose slot in the
+ * session's Transaction Table is still taken by an older transaction.  That way, a response can
+ * be matched to its request by indexing the table with the response's transaction ID.
  */
 //--------------------------------------------------------------------------------------------------
 static void CreateTxnId
@@ -218,9 +298,28 @@ static void CreateTxnId
 )
 //--------------------------------------------------------------------------------------------------
 {
+    msgSession_Session_t* sessionPtr = le_msg_GetSession(msgRef);
+    uint32_t txnId;
+
     LOCK
 
-    msgMessage_SetTxnId(msgRef, le_ref_CreateRef(TxnMapRef, msgRef));
+    // Keep the table at most half full, so a free slot is never far away.
+    if ((sessionPtr->txnCount + 1) * 2 > sessionPtr->txnTableSize)
+    {
+        GrowTxnTable(sessionPtr);
+    }
+
+    // Zero is not a valid transaction ID; it means "no response expected".
+    do
+    {
+        txnId = ++(sessionPtr->nextTxnId);
+    }
+    while ((txnId == 0) || (sessionPtr->txnTable[TxnSlot(sessionPtr,
+                                                         (void*)(size_t)txnId)] != NULL));
+
+    msgMessage_SetTxnId(msgRef, (void*)(size_t)txnId);
+    sessionPtr->txnTable[TxnSlot(sessionPtr, (void*)(size_t)txnId)] = msgRef;
+    sessionPtr->txnCount++;
 
     UNLOCK
 }
@@ -239,10 +338,23 @@ static le_msg_MessageRef_t LookupTxnId
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_msg_MessageRef_t requestMsgRef;
+    msgSession_Session_t* sessionPtr = le_msg_GetSession(msgRef);
+    void* txnId = msgMessage_GetTxnId(msgRef);
+    le_msg_MessageRef_t requestMsgRef = NULL;
 
     LOCK
-    requestMsgRef = le_ref_Lookup(TxnMapRef, msgMessage_GetTxnId(msgRef));
+
+    if ((txnId != NULL) && (sessionPtr->txnTable != NULL))
+    {
+        requestMsgRef = sessionPtr->txnTable[TxnSlot(sessionPtr, txnId)];
+
+        // The slot may hold a newer transaction if this ID is stale.
+        if ((requestMsgRef != NULL) && (msgMessage_GetTxnId(requestMsgRef) != txnId))
+        {
+            requestMsgRef = NULL;
+        }
+    }
+
     UNLOCK
 
     return requestMsgRef;
@@ -260,9 +372,20 @@ static void DeleteTxnId
 )
 //--------------------------------------------------------------------------------------------------
 {
+    msgSession_Session_t* sessionPtr = le_msg_GetSession(msgRef);
+
     LOCK
 
-    le_ref_DeleteRef(TxnMapRef, msgMessage_GetTxnId(msgRef));
+    if (sessionPtr->txnTable != NULL)
+    {
+        size_t slot = TxnSlot(sessionPtr, msgMessage_GetTxnId(msgRef));
+
+        if (sessionPtr->txnTable[slot] == msgRef)
+        {
+            sessionPtr->txnTable[slot] = NULL;
+            sessionPtr->txnCount--;
+        }
+    }
 
     UNLOCK
 }
@@ -433,10 +556,16 @@ static msgSession_Session_t* CreateSession
     sessionPtr->link = LE_DLS_LINK_INIT;
     sessionPtr->state = LE_MSG_SESSION_STATE_CLOSED;
     sessionPtr->threadRef = le_thread_GetCurrent();
+    sessionPtr->workerRef = NULL;
     sessionPtr->socketFd = -1;
     sessionPtr->fdMonitorRef = NULL;
 
     sessionPtr->txnList = LE_DLS_LIST_INIT;
+    sessionPtr->txnTable = NULL;
+    sessionPtr->txnTableSize = 0;
+    sessionPtr->txnCount = 0;
+    sessionPtr->nextTxnId = 0;
+    sessionPtr->transmitCount = 0;
     sessionPtr->transmitQueue = LE_DLS_LIST_INIT;
     sessionPtr->receiveQueue = LE_DLS_LIST_INIT;
 
@@ -448,6 +577,14 @@ static msgSession_Session_t* CreateSession
     sessionPtr->closeHandler = NULL;
     sessionPtr->closeContextPtr = NULL;
 
+    sessionPtr->localServiceRef = NULL;
+    sessionPtr->peerRef = NULL;
+    sessionPtr->waitLink = LE_DLS_LINK_INIT;
+    sessionPtr->isSyncWaiting = false;
+    sessionPtr->localSemRef = NULL;
+    sessionPtr->syncTxnId = NULL;
+    sessionPtr->syncResponseRef = NULL;
+
     sessionPtr->interfaceRef = interfaceRef;
 
     SessionObjListChangeCount++;
@@ -480,18 +617,35 @@ static void CloseSession
         msgInterface_CallCloseHandler((le_msg_ServiceRef_t)sessionPtr->interfaceRef, sessionPtr);
     }
 
+    // If the other end is in this process, let it know.
+    CloseLocalLink(sessionPtr);
+
+    // If still waiting for a local service to be advertised, stop waiting.
+    if (   (sessionPtr->localServiceRef != NULL)
+        && msgInterface_CancelLocalWait(sessionPtr->localServiceRef, &sessionPtr->waitLink) )
+    {
+        // Release the reference held by the wait.
+        le_mem_Release(sessionPtr);
+    }
+
+    // Sessions with a peer in this process don't have a socket.
+    bool isLocal = (sessionPtr->socketFd < 0);
+
     // Delete the socket and the FD Monitor.
     if (sessionPtr->fdMonitorRef != NULL)
     {
         le_fdMonitor_Delete(sessionPtr->fdMonitorRef);
         sessionPtr->fdMonitorRef = NULL;
     }
-    fd_Close(sessionPtr->socketFd);
-    sessionPtr->socketFd = -1;
+    if (!isLocal)
+    {
+        fd_Close(sessionPtr->socketFd);
+        sessionPtr->socketFd = -1;
+    }
 
     // If there are any messages stranded on the transmit queue, the pending transaction list,
     // or the receive queue, clean them all up.
-    if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
+    if ((sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER) || isLocal)
     {
         PurgeTxnList(sessionPtr);
     }
@@ -628,6 +782,9 @@ static void RetryOpen
 {
     CloseSession(sessionPtr);
 
+    // If the attempt went through the interface's connector, go through the Service Directory next.
+    msgInterface_DropConnector((le_msg_ClientInterfaceRef_t)sessionPtr->interfaceRef);
+
     le_msg_InterfaceRef_t interfaceRef = le_msg_GetSessionInterface(sessionPtr);
     LE_ERROR("Retrying connection on interface (%s:%s)...",
              le_msg_GetInterfaceName(interfaceRef),
@@ -753,6 +910,10 @@ static void ProcessMessageFromServer
     le_msg_MessageRef_t requestMsgRef = LookupTxnId(msgRef);
     if (requestMsgRef != NULL)
     {
+        TRACEPOINT_ASYNC_END((uint32_t)(size_t)msgMessage_GetTxnId(requestMsgRef),
+                             "ipc request %s",
+                             le_msg_GetInterfaceName(sessionPtr->interfaceRef));
+
         // The transaction is complete!  Remove it from the Transaction Map.
         DeleteTxnId(requestMsgRef);
 
@@ -913,11 +1074,10 @@ static void ReceiveMessages
 {
     for (;;)
     {
-        // Create a Message object.
-        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
+        le_msg_MessageRef_t msgRef;
 
-        // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+        // Receive from the socket into a new Message object.
+        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, sessionPtr, &msgRef);
 
         if (result == LE_OK)
         {
@@ -927,7 +1087,6 @@ static void ReceiveMessages
         else
         {
             // Nothing left to receive from the socket.  We are done.
-            le_msg_ReleaseMsg(msgRef);
             break;
         }
     }
@@ -1291,7 +1450,8 @@ static void StartSocketMonitoring
 //--------------------------------------------------------------------------------------------------
 /**
  * Start an attempt to open a session by connecting to the Service Directory and sending it
- * a request to open a session.
+ * a request to open a session.  If the client interface has a connector to its server, the
+ * session's socket is handed to the server over that instead, skipping the Service Directory.
  *
  * If successful, puts the Session object in the OPENING state, leaves the connection socket open
  * and stores its file descriptor in the Session object.
@@ -1318,6 +1478,15 @@ static le_result_t StartSessionOpenAttempt
 {
     sessionPtr->state = LE_MSG_SESSION_STATE_OPENING;
 
+    // Try the connector first.  The server will respond on the new socket just as if the
+    // Service Directory had dispatched it.
+    sessionPtr->socketFd =
+                msgInterface_HandOffToServer((le_msg_ClientInterfaceRef_t)sessionPtr->interfaceRef);
+    if (sessionPtr->socketFd >= 0)
+    {
+        return LE_OK;
+    }
+
     // Create a socket for the session.
     sessionPtr->socketFd = CreateSocket();
 
@@ -1329,6 +1498,7 @@ static le_result_t StartSessionOpenAttempt
         svcdir_OpenRequest_t msg;
         msgInterface_GetInterfaceDetails(sessionPtr->interfaceRef, &(msg.interface));
         msg.shouldWait = shouldWait;
+        msg.isConnector = false;
 
         // Send the request to the Service Directory.
         result = unixSocket_SendDataMsg(sessionPtr->socketFd, &msg, sizeof(msg));
@@ -1389,6 +1559,63 @@ static void AttemptOpen
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a connector to the server of a session's client interface, if the interface caches its
+ * server endpoint and doesn't have a connector yet.  Blocks until the server accepts or the
+ * attempt fails.  Failure is not an error; sessions just keep going through the Service Directory.
+ *
+ * @note    This is used only on the client side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenConnector
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_ClientInterfaceRef_t clientRef = (le_msg_ClientInterfaceRef_t)sessionPtr->interfaceRef;
+
+    if (!msgInterface_NeedsConnector(clientRef))
+    {
+        return;
+    }
+
+    int fd = CreateSocket();
+
+    if (ConnectToServiceDirectory(fd) == LE_OK)
+    {
+        svcdir_OpenRequest_t msg;
+        msgInterface_GetInterfaceDetails(sessionPtr->interfaceRef, &(msg.interface));
+        msg.shouldWait = false;
+        msg.isConnector = true;
+
+        le_result_t serverResponse = LE_FAULT;
+        size_t bytesReceived = sizeof(serverResponse);
+
+        if (   (unixSocket_SendDataMsg(fd, &msg, sizeof(msg)) == LE_OK)
+            && (unixSocket_ReceiveDataMsg(fd, &serverResponse, &bytesReceived) == LE_OK)
+            && (bytesReceived == sizeof(serverResponse))
+            && (serverResponse == LE_OK) )
+        {
+            TRACE("Connector opened on interface (%s:%s)",
+                  le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+                  le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+            fd_SetNonBlocking(fd);
+            msgInterface_SetConnector(clientRef, fd);
+            return;
+        }
+    }
+
+    LE_DEBUG("Failed to open connector on interface (%s:%s).",
+             le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+             le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+    fd_Close(fd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Attempts to open a session, blocking (not returning) until the attempt is complete.
@@ -1435,10 +1662,17 @@ static le_result_t AttemptOpenSync
                 StartSocketMonitoring(sessionPtr, ClientSocketEventHandler);
 
                 sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
+
+                // Now that the server is known to be up, get a connector to it for next time.
+                OpenConnector(sessionPtr);
             }
             else
             {
                 CloseSession(sessionPtr);
+
+                // If the attempt went through the interface's connector, the server may have
+                // rejected it, so go through the Service Directory next time.
+                msgInterface_DropConnector((le_msg_ClientInterfaceRef_t)sessionPtr->interfaceRef);
             }
         }
 
@@ -1501,146 +1735,848 @@ static void TriggerDeferredProcessing
 }
 
 
-// =======================================
-//  PROTECTED (INTER-MODULE) FUNCTIONS
-// =======================================
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a message that a server-side worker thread handed over to the session's thread.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          That's why the parameter list looks unusual.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendQueuedMessage
+(
+    void* param1Ptr,    ///< [IN] Pointer to a Session object.
+    void* param2Ptr     ///< [IN] Reference to the Message object to send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_SendMessage(param1Ptr, param2Ptr);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Exposing the session object list change counter; mainly for the Inspect tool.
+ * Gets the semaphore that a client thread blocks on while waiting for a local service, creating
+ * it if necessary.
+ *
+ * @note    This is used only on the client side, by the session's thread.
  */
 //--------------------------------------------------------------------------------------------------
-size_t** msgSession_GetSessionObjListChgCntRef
+static le_sem_Ref_t GetLocalSem
 (
-    void
+    msgSession_Session_t* sessionPtr
 )
+//--------------------------------------------------------------------------------------------------
 {
-    return (&SessionObjListChangeCountRef);
+    if (sessionPtr->localSemRef == NULL)
+    {
+        sessionPtr->localSemRef = le_sem_Create("ipcLocal", 0);
+    }
+
+    return sessionPtr->localSemRef;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initializes the messagingSession module.  This must be called only once at start-up, before
- * any other functions in that module are called.
+ * Gets the session at the other end of a session with a peer in the same process.  Must be
+ * released using le_mem_Release() when you are done with it.
+ *
+ * @return  The peer session, or NULL if either end has closed.
  */
 //--------------------------------------------------------------------------------------------------
-void msgSession_Init
+static msgSession_Session_t* GetPeer
 (
-    void
+    msgSession_Session_t* sessionPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    SessionPoolRef = le_mem_CreatePool("Session", sizeof(msgSession_Session_t));
-    le_mem_ExpandPool(SessionPoolRef, 10); /// @todo Make this configurable.
+    LOCK
 
-    TxnMapRef = le_ref_CreateMap("MsgTxnIDs", MAX_EXPECTED_TXNS);
+    msgSession_Session_t* peerPtr = sessionPtr->peerRef;
 
-    // Get a reference to the trace keyword that is used to control tracing in this module.
-    TraceRef = le_log_GetTraceRef("messaging");
+    if ((peerPtr != NULL) && (peerPtr->peerRef == sessionPtr))
+    {
+        le_mem_AddRef(peerPtr);
+    }
+    else
+    {
+        peerPtr = NULL;
+    }
+
+    UNLOCK
+
+    return peerPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks the interface type of a given Session reference.
+ * Processes a message handed over by the peer at the other end of a session in the same process,
+ * as if it had been received from the session's socket.
  *
- * @return  interface object type.
+ * @note    This function is called by the Event Loop as a "queued function", except when a client
+ *          does a synchronous transaction with a server in the same thread.
  */
 //--------------------------------------------------------------------------------------------------
-msgInterface_Type_t msgSession_GetInterfaceType
+static void ReceiveLocalMessage
 (
-    le_msg_SessionRef_t sessionRef
+    void* param1Ptr,    ///< [IN] Pointer to the receiving Session object.
+    void* param2Ptr     ///< [IN] Reference to the Message object.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return sessionRef->interfaceRef->interfaceType;
+    msgSession_Session_t* sessionPtr = param1Ptr;
+    le_msg_MessageRef_t msgRef = param2Ptr;
+
+    if (sessionPtr->state != LE_MSG_SESSION_STATE_OPEN)
+    {
+        LE_DEBUG("Discarding message received in session that is not open.");
+        le_msg_ReleaseMsg(msgRef);
+    }
+    else if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
+    {
+        msgInterface_ProcessMessageFromClient((le_msg_ServiceRef_t)sessionPtr->interfaceRef,
+                                              msgRef);
+    }
+    else if ((msgMessage_GetTxnId(msgRef) != NULL) && (LookupTxnId(msgRef) == NULL))
+    {
+        // Late response to a synchronous transaction that has already terminated.
+        le_msg_ReleaseMsg(msgRef);
+    }
+    else
+    {
+        ProcessMessageFromServer(sessionPtr, msgRef);
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks whether a given Session reference is for an open session.
- *
- * @return  true if the session is still open, false if it is closed.
+ * Hands a message over to the thread handling a session with a peer in the same process.
  */
 //--------------------------------------------------------------------------------------------------
-bool msgSession_IsOpen
+static void QueueLocalMessage
 (
-    le_msg_SessionRef_t sessionRef
+    msgSession_Session_t*   sessionPtr, ///< [IN] Receiving Session object.
+    le_msg_MessageRef_t     msgRef      ///< [IN] Message (already moved into that session).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return (sessionRef->state == LE_MSG_SESSION_STATE_OPEN);
+    // NOTE: The message holds a reference to the session, so the session object can't go away
+    //       before the queued function runs.
+    le_event_QueueFunctionToThread(sessionPtr->threadRef, ReceiveLocalMessage, sessionPtr, msgRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sends a given Message object through a given Session.
+ * Sends a message to the peer at the other end of a session in the same process.
+ *
+ * On the server side, this can be called by a worker thread, so that a response gets to a client
+ * blocked in a synchronous transaction even if the client is running in the server thread.
  */
 //--------------------------------------------------------------------------------------------------
-void msgSession_SendMessage
+static void SendLocalMessage
 (
-    le_msg_SessionRef_t sessionRef,
-    le_msg_MessageRef_t messageRef
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Only the thread that is handling events on this socket is allowed to send messages through
-    // this socket.  This prevents multi-threaded races.
-    /// @todo Allow other threads to send?
-    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
-                "Attempt to send by thread that doesn't own session '%s'.",
-                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+    msgSession_Session_t* peerPtr = GetPeer(sessionPtr);
 
-    if (sessionRef->state != LE_MSG_SESSION_STATE_OPEN)
+    if (peerPtr == NULL)
     {
         LE_DEBUG("Discarding message sent in session that is not open.");
+        le_msg_ReleaseMsg(msgRef);
+        return;
+    }
 
-        le_msg_ReleaseMsg(messageRef);
+    if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_CLIENT)
+    {
+        LE_FATAL_IF(le_thread_GetCurrent() != sessionPtr->threadRef,
+                    "Attempt to send by thread that doesn't own session '%s'.",
+                    le_msg_GetInterfaceName(sessionPtr->interfaceRef));
+
+        // Servers always receive full-size messages.
+        if (le_msg_GetMaxPayloadSize(msgRef) == le_msg_GetProtocolMaxMsgSize(
+                                                        le_msg_GetSessionProtocol(sessionPtr)))
+        {
+            msgMessage_MoveToSession(msgRef, peerPtr);
+        }
+        else
+        {
+            le_msg_MessageRef_t copyRef = msgMessage_CopyRequest(peerPtr, msgRef);
+            le_msg_ReleaseMsg(msgRef);
+            msgRef = copyRef;
+        }
+
+        QueueLocalMessage(peerPtr, msgRef);
     }
     else
     {
-        // Put the message on the Transmit Queue.
-        PushTransmitQueue(sessionRef, messageRef);
+        msgMessage_MoveToSession(msgRef, peerPtr);
 
-        // Try to send something from the Transmit Queue.
-        SendFromTransmitQueue(sessionRef);
+        // If the client is blocked waiting for this response, hand it over directly.
+        LOCK
+
+        bool isSyncResponse = (   (peerPtr->syncTxnId != NULL)
+                               && (peerPtr->syncTxnId == msgMessage_GetTxnId(msgRef)) );
+        if (isSyncResponse)
+        {
+            peerPtr->syncResponseRef = msgRef;
+            peerPtr->syncTxnId = NULL;
+            le_sem_Post(peerPtr->localSemRef);
+        }
+
+        UNLOCK
+
+        if (!isSyncResponse)
+        {
+            QueueLocalMessage(peerPtr, msgRef);
+        }
     }
+
+    le_mem_Release(peerPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start an asynchronous request-response transaction.
+ * Starts an asynchronous request-response transaction with a server in the same process.
+ *
+ * @warning The Message object must have already had a transaction ID assigned to it using
+ *          CreateTxnId().
  */
 //--------------------------------------------------------------------------------------------------
-void msgSession_RequestResponse
+static void RequestLocalResponse
 (
-    le_msg_SessionRef_t sessionRef,
-    le_msg_MessageRef_t msgRef
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Only the thread that is handling events on this socket is allowed to do asynchronous
-    // transactions on it.
-    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
-                "Calling thread doesn't own the session '%s'.",
-                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
-    /// @todo Allow other threads to send?
-
-    LE_FATAL_IF(sessionRef->state != LE_MSG_SESSION_STATE_OPEN,
-                "Attempt to send message on session that is not open.");
+    // The request stays on the Transaction List until the response comes back or the session
+    // closes, just as if it had been written to a socket.
+    AddToTxnList(sessionPtr, msgRef);
 
-    // Create an ID for this transaction.
-    CreateTxnId(msgRef);
+    msgSession_Session_t* peerPtr = GetPeer(sessionPtr);
 
-    // Put the message on the Transmit Queue.
-    PushTransmitQueue(sessionRef, msgRef);
+    if (peerPtr != NULL)
+    {
+        QueueLocalMessage(peerPtr, msgMessage_CopyRequest(peerPtr, msgRef));
 
-    // Try to send something from the Transmit Queue.
-    SendFromTransmitQueue(sessionRef);
+        le_mem_Release(peerPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Does a synchronous request-response transaction with a server in the same process.
+ *
+ * @return  The response message, or NULL if the transaction terminated without a response.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t DoLocalSyncRequestResponse
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sem_Ref_t semRef = GetLocalSem(sessionPtr);
+    le_msg_MessageRef_t rxMsgRef;
+
+    // Create an ID for this transaction.
+    CreateTxnId(msgRef);
+
+    // Only wait if the server is still there.  From here on, the server (or its closing) posts
+    // the semaphore and clears syncTxnId.
+    LOCK
+
+    msgSession_Session_t* peerPtr = sessionPtr->peerRef;
+
+    if ((peerPtr != NULL) && (peerPtr->peerRef == sessionPtr))
+    {
+        le_mem_AddRef(peerPtr);
+        sessionPtr->syncTxnId = msgMessage_GetTxnId(msgRef);
+    }
+    else
+    {
+        peerPtr = NULL;
+    }
+
+    UNLOCK
+
+    if (peerPtr != NULL)
+    {
+        le_msg_MessageRef_t requestRef = msgMessage_CopyRequest(peerPtr, msgRef);
+        le_thread_Ref_t currentThread = le_thread_GetCurrent();
+        le_thread_Ref_t handlerThread = (peerPtr->workerRef != NULL ? peerPtr->workerRef
+                                                                    : peerPtr->threadRef);
+        bool isWaiting = true;
+
+        if ((peerPtr->threadRef == currentThread) || (handlerThread == currentThread))
+        {
+            // Queueing the request to this thread would deadlock, so process it right here.
+            ReceiveLocalMessage(peerPtr, requestRef);
+
+            // If this thread's handler didn't respond, no response will ever come.
+            if (handlerThread == currentThread)
+            {
+                LOCK
+
+                if (sessionPtr->syncTxnId != NULL)
+                {
+                    sessionPtr->syncTxnId = NULL;
+                    isWaiting = false;
+                }
+
+                UNLOCK
+
+                if (!isWaiting)
+                {
+                    LE_ERROR("Server (%s) didn't respond to a synchronous request from its own"
+                             " thread.",
+                             le_msg_GetInterfaceName(sessionPtr->interfaceRef));
+                }
+            }
+        }
+        else
+        {
+            QueueLocalMessage(peerPtr, requestRef);
+        }
+
+        if (isWaiting)
+        {
+            le_sem_Wait(semRef);
+        }
+
+        le_mem_Release(peerPtr);
+    }
+
+    // Invalidate the ID for this transaction.
+    DeleteTxnId(msgRef);
+
+    // Don't need the request message anymore.
+    le_msg_ReleaseMsg(msgRef);
+
+    LOCK
+
+    rxMsgRef = sessionPtr->syncResponseRef;
+    sessionPtr->syncResponseRef = NULL;
+
+    UNLOCK
+
+    return rxMsgRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the closing of the peer at the other end of a session in the same process.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          That's why the parameter list looks unusual.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LocalPeerClosed
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Session object (holding a reference for this).
+    void* param2Ptr     ///< [IN] Pointer to the Session object that closed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+
+    // The session may have been closed and reopened with some other peer since.
+    LOCK
+
+    bool isPeer = (sessionPtr->peerRef == param2Ptr);
+    if (isPeer)
+    {
+        sessionPtr->peerRef = NULL;
+    }
+
+    UNLOCK
+
+    if (isPeer)
+    {
+        // Release the reference this session held on its peer.
+        le_mem_Release(param2Ptr);
+
+        if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
+        {
+            if (sessionPtr->state != LE_MSG_SESSION_STATE_CLOSED)
+            {
+                TRACE("Session closed by client of service (%s:%s).",
+                      le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+                      le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+                DeleteSession(sessionPtr);
+            }
+        }
+        else if (sessionPtr->state == LE_MSG_SESSION_STATE_OPEN)
+        {
+            ClientSocketHangUp(sessionPtr);
+        }
+    }
+
+    le_mem_Release(sessionPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disconnects a session from its peer in the same process (if it has one), waking the peer up if
+ * it is blocked waiting for a response, and lets the peer's thread know.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseLocalLink
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    msgSession_Session_t* peerPtr = sessionPtr->peerRef;
+    sessionPtr->peerRef = NULL;
+
+    if ((peerPtr != NULL) && (peerPtr->syncTxnId != NULL))
+    {
+        peerPtr->syncTxnId = NULL;
+        le_sem_Post(peerPtr->localSemRef);
+    }
+
+    UNLOCK
+
+    if (peerPtr != NULL)
+    {
+        // The reference this session held on its peer is handed over to the queued function.
+        le_event_QueueFunctionToThread(peerPtr->threadRef, LocalPeerClosed, peerPtr, sessionPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a local service's open handlers for a new server-side session.
+ *
+ * @note    This function is called by the Event Loop of the server thread as a "queued function",
+ *          unless the client is running in the server thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LocalSessionOpened
+(
+    void* param1Ptr,    ///< [IN] Pointer to the server-side Session object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+    le_msg_ServiceRef_t serviceRef = (le_msg_ServiceRef_t)sessionPtr->interfaceRef;
+
+    (void)param2Ptr;
+
+    // Pin the session to one of the service's worker threads (if it has any).
+    sessionPtr->workerRef = msgInterface_SelectWorkerThread(serviceRef);
+
+    msgInterface_CallOpenHandler(serviceRef, sessionPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connects a client-side session directly to a service in the same process, creating the
+ * server-side session and opening both.
+ *
+ * @note    This is used only on the client side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConnectLocalSession
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_ServiceRef_t     serviceRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The server-side session is handled by the server thread, which deletes it when it closes.
+    msgSession_Session_t* serverSessionPtr = CreateSession((le_msg_InterfaceRef_t)serviceRef);
+    serverSessionPtr->threadRef = serviceRef->serverThread;
+    serverSessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
+
+    // Each end holds a reference to the other until it finds out that the other end closed.
+    le_mem_AddRef(sessionPtr);
+    le_mem_AddRef(serverSessionPtr);
+
+    LOCK
+
+    serverSessionPtr->peerRef = sessionPtr;
+    sessionPtr->peerRef = serverSessionPtr;
+
+    UNLOCK
+
+    sessionPtr->state = LE_MSG_SESSION_STATE_OPEN;
+
+    TRACE("Session opened in-process on interface (%s:%s)",
+          le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+          le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+    // The server's open handlers run in the server thread, before it handles anything sent by
+    // the client.
+    if (serverSessionPtr->threadRef == le_thread_GetCurrent())
+    {
+        LocalSessionOpened(serverSessionPtr, NULL);
+    }
+    else
+    {
+        le_event_QueueFunctionToThread(serverSessionPtr->threadRef,
+                                       LocalSessionOpened,
+                                       serverSessionPtr,
+                                       NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes an asynchronous open of a session with a service in the same process, by calling the
+ * client's open handler.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          That's why the parameter list looks unusual.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LocalSessionOpenComplete
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Session object (holding a reference for this).
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+
+    (void)param2Ptr;
+
+    // The client may have closed the session in the meantime.
+    if ((sessionPtr->state == LE_MSG_SESSION_STATE_OPEN) && (sessionPtr->openHandler != NULL))
+    {
+        sessionPtr->openHandler(sessionPtr, sessionPtr->openContextPtr);
+    }
+
+    le_mem_Release(sessionPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connects a session opened asynchronously with a service in the same process, and queues the
+ * call to the client's open handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenLocalSession
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_ServiceRef_t     serviceRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ConnectLocalSession(sessionPtr, serviceRef);
+
+    le_mem_AddRef(sessionPtr);
+    le_event_QueueFunction(LocalSessionOpenComplete, sessionPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resumes an asynchronous open of a session once the local service it was waiting for has been
+ * advertised.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          That's why the parameter list looks unusual.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResumeLocalOpen
+(
+    void* param1Ptr,    ///< [IN] Pointer to the Session object (holding the wait's reference).
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+
+    (void)param2Ptr;
+
+    if (sessionPtr->state == LE_MSG_SESSION_STATE_OPENING)
+    {
+        OpenLocalSession(sessionPtr, sessionPtr->localServiceRef);
+    }
+
+    le_mem_Release(sessionPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronously opens a session with a service in the same process, if the session was created
+ * for a local service, or its client interface has a local binding to a service that has been
+ * advertised in this process.
+ *
+ * @return
+ * - LE_OK if the session was opened.
+ * - LE_UNAVAILABLE if !shouldWait and the session's local service hasn't been advertised yet.
+ * - LE_NOT_FOUND if the session has to be opened through the Service Directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenLocalSessionSync
+(
+    msgSession_Session_t* sessionPtr,
+    bool shouldWait         ///< true = wait for the session's local service to be advertised.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_ServiceRef_t serviceRef = sessionPtr->localServiceRef;
+
+    if (serviceRef != NULL)
+    {
+        le_sem_Ref_t semRef = GetLocalSem(sessionPtr);
+
+        sessionPtr->isSyncWaiting = true;
+
+        if (!msgInterface_WaitForLocalService(serviceRef, &sessionPtr->waitLink))
+        {
+            if (!shouldWait && msgInterface_CancelLocalWait(serviceRef, &sessionPtr->waitLink))
+            {
+                sessionPtr->isSyncWaiting = false;
+                return LE_UNAVAILABLE;
+            }
+
+            // Wait for msgSession_LocalServiceAdvertised().
+            le_sem_Wait(semRef);
+        }
+
+        sessionPtr->isSyncWaiting = false;
+
+        ConnectLocalSession(sessionPtr, serviceRef);
+
+        return LE_OK;
+    }
+
+    serviceRef = msgInterface_FindLocalService((le_msg_ClientInterfaceRef_t)sessionPtr->interfaceRef);
+
+    if (serviceRef == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    ConnectLocalSession(sessionPtr, serviceRef);
+
+    msgInterface_Release((le_msg_InterfaceRef_t)serviceRef);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor for Session objects.  Frees the session's Transaction Table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionDestructor
+(
+    void* objPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = objPtr;
+
+    if (sessionPtr->txnTable != NULL)
+    {
+        le_mem_Release(sessionPtr->txnTable);
+    }
+
+    if (sessionPtr->localSemRef != NULL)
+    {
+        le_sem_Delete(sessionPtr->localSemRef);
+    }
+}
+
+
+// =======================================
+//  PROTECTED (INTER-MODULE) FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the session object list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** msgSession_GetSessionObjListChgCntRef
+(
+    void
+)
+{
+    return (&SessionObjListChangeCountRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the messagingSession module.  This must be called only once at start-up, before
+ * any other functions in that module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    SessionPoolRef = le_mem_CreatePool("Session", sizeof(msgSession_Session_t));
+    le_mem_ExpandPool(SessionPoolRef, 10); /// @todo Make this configurable.
+
+    le_mem_SetDestructor(SessionPoolRef, SessionDestructor);
+
+    TxnTableSlabRef = le_mem_CreateSlabAllocator("MsgTxnTables",
+                                                 MAX_TXN_TABLE_SLOTS * sizeof(le_msg_MessageRef_t));
+
+    // Get a reference to the trace keyword that is used to control tracing in this module.
+    TraceRef = le_log_GetTraceRef("messaging");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the interface type of a given Session reference.
+ *
+ * @return  interface object type.
+ */
+//--------------------------------------------------------------------------------------------------
+msgInterface_Type_t msgSession_GetInterfaceType
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sessionRef->interfaceRef->interfaceType;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a given Session reference is for an open session.
+ *
+ * @return  true if the session is still open, false if it is closed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgSession_IsOpen
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (sessionRef->state == LE_MSG_SESSION_STATE_OPEN);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a given Message object through a given Session.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_SendMessage
+(
+    le_msg_SessionRef_t sessionRef,
+    le_msg_MessageRef_t messageRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Sessions with a peer in this process hand messages straight over to the other end.
+    if ((sessionRef->socketFd < 0) && (sessionRef->state == LE_MSG_SESSION_STATE_OPEN))
+    {
+        SendLocalMessage(sessionRef, messageRef);
+        return;
+    }
+
+    // On the server side of a service with worker threads, the worker handling the session's
+    // requests hands its responses back to the thread that owns the socket.
+    if ((sessionRef->workerRef != NULL) && (le_thread_GetCurrent() != sessionRef->threadRef))
+    {
+        // NOTE: The message holds a reference to the session, so the session object can't go
+        //       away before the queued function runs.
+        le_event_QueueFunctionToThread(sessionRef->threadRef,
+                                       SendQueuedMessage,
+                                       sessionRef,
+                                       messageRef);
+        return;
+    }
+
+    // Only the thread that is handling events on this socket is allowed to send messages through
+    // this socket.  This prevents multi-threaded races.
+    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
+                "Attempt to send by thread that doesn't own session '%s'.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    if (sessionRef->state != LE_MSG_SESSION_STATE_OPEN)
+    {
+        LE_DEBUG("Discarding message sent in session that is not open.");
+
+        le_msg_ReleaseMsg(messageRef);
+    }
+    else
+    {
+        // Put the message on the Transmit Queue.
+        PushTransmitQueue(sessionRef, messageRef);
+
+        // Try to send something from the Transmit Queue.
+        SendFromTransmitQueue(sessionRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an asynchronous request-response transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_RequestResponse
+(
+    le_msg_SessionRef_t sessionRef,
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Only the thread that is handling events on this socket is allowed to do asynchronous
+    // transactions on it.
+    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
+                "Calling thread doesn't own the session '%s'.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+    /// @todo Allow other threads to send?
+
+    LE_FATAL_IF(sessionRef->state != LE_MSG_SESSION_STATE_OPEN,
+                "Attempt to send message on session that is not open.");
+
+    // Create an ID for this transaction.
+    CreateTxnId(msgRef);
+
+    TRACEPOINT_ASYNC_BEGIN((uint32_t)(size_t)msgMessage_GetTxnId(msgRef), "ipc request %s",
+                           le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    if (sessionRef->socketFd < 0)
+    {
+        RequestLocalResponse(sessionRef, msgRef);
+        return;
+    }
+
+    // Put the message on the Transmit Queue.
+    PushTransmitQueue(sessionRef, msgRef);
+
+    // Try to send something from the Transmit Queue.
+    SendFromTransmitQueue(sessionRef);
 }
 
 
@@ -1664,9 +2600,18 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
                 "Attempted synchronous operation by thread that doesn't own session '%s'.",
                 le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
 
+    if (sessionRef->socketFd < 0)
+    {
+        return DoLocalSyncRequestResponse(sessionRef, msgRef);
+    }
+
     // Create an ID for this transaction.
     CreateTxnId(msgRef);
 
+    TRACEPOINT_BEGIN("ipc request %s txn %zu",
+                     le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)),
+                     (size_t)msgMessage_GetTxnId(msgRef));
+
     // Put the socket into blocking mode.
     fd_SetBlocking(sessionRef->socketFd);
 
@@ -1679,16 +2624,12 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // function call.
     for (;;)
     {
-        rxMsgRef = le_msg_CreateMsg(sessionRef);
-
-        le_result_t result = msgMessage_Receive(sessionRef->socketFd, rxMsgRef);
+        le_result_t result = msgMessage_Receive(sessionRef->socketFd, sessionRef, &rxMsgRef);
 
         if (result != LE_OK)
         {
             // The socket experienced an error or the connection was closed.
             // No message was received.
-            le_msg_ReleaseMsg(rxMsgRef);
-            rxMsgRef = NULL;
             break;
         }
 
@@ -1721,10 +2662,153 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // Put the socket back into non-blocking mode.
     fd_SetNonBlocking(sessionRef->socketFd);
 
+    TRACEPOINT_END();
+
     return rxMsgRef;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a given entry of a batch is a request that is still waiting for its response.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPendingRequest
+(
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (LookupTxnId(msgRef) == msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a batch of synchronous request-response transactions.  All the requests are sent before
+ * any response is waited for, so the whole batch costs one round trip to the server.
+ *
+ * Each entry of the array is replaced by its response message, or NULL if its transaction
+ * terminated without a response.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_DoSyncRequestResponseBatch
+(
+    le_msg_SessionRef_t     sessionRef,
+    le_msg_MessageRef_t*    msgRefs,
+    size_t                  msgCount
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+    size_t sentCount;
+    size_t pendingCount;
+    size_t nextIndex = 0;
+
+    // Only the thread that is handling events on this socket is allowed to do synchronous
+    // transactions on it.
+    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
+                "Attempted synchronous operation by thread that doesn't own session '%s'.",
+                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+    // With a server in this process there is no round trip to save, so just do them one by one.
+    if (sessionRef->socketFd < 0)
+    {
+        for (i = 0; i < msgCount; i++)
+        {
+            LE_ASSERT(le_msg_GetSession(msgRefs[i]) == sessionRef);
+            msgRefs[i] = DoLocalSyncRequestResponse(sessionRef, msgRefs[i]);
+        }
+        return;
+    }
+
+    // Create an ID for each transaction.
+    for (i = 0; i < msgCount; i++)
+    {
+        LE_ASSERT(le_msg_GetSession(msgRefs[i]) == sessionRef);
+        CreateTxnId(msgRefs[i]);
+    }
+
+    // Put the socket into blocking mode.
+    fd_SetBlocking(sessionRef->socketFd);
+
+    // Send all the Request Messages.  Any that couldn't be sent won't get a response.
+    msgMessage_SendBatch(sessionRef->socketFd, msgRefs, msgCount, &sentCount);
+    pendingCount = sentCount;
+
+    // Keep receiving messages until all of the responses are in.  Any that we receive that don't
+    // match one of the transactions that we are waiting for should be queued for later
+    // handling using a queued function call.
+    while (pendingCount > 0)
+    {
+        le_msg_MessageRef_t rxMsgRef;
+        le_result_t result = msgMessage_Receive(sessionRef->socketFd, sessionRef, &rxMsgRef);
+
+        if (result != LE_OK)
+        {
+            // The socket experienced an error or the connection was closed.
+            break;
+        }
+
+        // Find the request this is the response to.  The server handles requests in order, so
+        // the search normally succeeds on the first try.
+        le_msg_MessageRef_t requestMsgRef = LookupTxnId(rxMsgRef);
+
+        if (requestMsgRef != NULL)
+        {
+            for (i = 0; i < sentCount; i++)
+            {
+                size_t index = (nextIndex + i) % sentCount;
+
+                if (msgRefs[index] == requestMsgRef)
+                {
+                    // Got one of the responses we were waiting for.
+                    DeleteTxnId(requestMsgRef);
+                    le_msg_ReleaseMsg(requestMsgRef);
+                    msgRefs[index] = rxMsgRef;
+
+                    nextIndex = (index + 1) % sentCount;
+                    pendingCount--;
+                    break;
+                }
+            }
+
+            if (i < sentCount)
+            {
+                continue;
+            }
+        }
+
+        // Got some other message that we weren't waiting for.
+
+        // If the Receive Queue is empty, queue up a function call on the Event Queue so that
+        // the Event Loop will kick start processing of the Receive Queue later.
+        // (If there's already something on the Receive Queue, then we've already done that.)
+        if (le_dls_IsEmpty(&sessionRef->receiveQueue))
+        {
+            TriggerDeferredProcessing(sessionRef);
+        }
+
+        // Queue the received message to the Receive Queue for later processing.
+        PushReceiveQueue(sessionRef, rxMsgRef);
+    }
+
+    // Any request still outstanding terminated without a response.
+    for (i = 0; i < msgCount; i++)
+    {
+        if ((i >= sentCount) || ((pendingCount > 0) && IsPendingRequest(msgRefs[i])))
+        {
+            DeleteTxnId(msgRefs[i]);
+            le_msg_ReleaseMsg(msgRefs[i]);
+            msgRefs[i] = NULL;
+        }
+    }
+
+    // Put the socket back into non-blocking mode.
+    fd_SetNonBlocking(sessionRef->socketFd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the interface reference for a given Session object.
@@ -1811,6 +2895,10 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
     // Record the client connection file descriptor.
     sessionPtr->socketFd = fd;
 
+    // Pin the session to one of the service's worker threads (if it has any), so that requests
+    // from this client are handled in the order they were received.
+    sessionPtr->workerRef = msgInterface_SelectWorkerThread(serviceRef);
+
     // Start monitoring the server-side session connection socket for events.
     StartSocketMonitoring(sessionPtr, ServerSocketEventHandler);
 
@@ -1854,6 +2942,34 @@ le_msg_SessionRef_t le_msg_CreateSession
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a session with a service that can only be used by clients in the same process.
+ *
+ * @return  The Session reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_msg_CreateLocalSession
+(
+    le_msg_LocalService_t*  servicePtr      ///< [in] Service initialized using
+                                            ///       le_msg_InitLocalService().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_ServiceRef_t serviceRef = servicePtr->serviceRef;
+
+    LE_FATAL_IF(serviceRef == NULL, "Local service not initialized.");
+
+    msgSession_Session_t* sessionPtr = le_msg_CreateSession(
+                                        msgInterface_GetProtocolRef((le_msg_InterfaceRef_t)serviceRef),
+                                        le_msg_GetInterfaceName((le_msg_InterfaceRef_t)serviceRef));
+
+    sessionPtr->localServiceRef = serviceRef;
+
+    return sessionPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets an opaque context value (void pointer) that can be retrieved from that session later using
@@ -1965,6 +3081,28 @@ void le_msg_SetSessionCloseHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keeps a connection to the server of a session's client interface once a session on that
+ * interface has opened synchronously, so that later sessions on the interface open directly with
+ * the server, without going through the Service Directory.
+ *
+ * @note This is a client-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_CacheServerEndpoint
+(
+    le_msg_SessionRef_t             sessionRef  ///< [in] Reference to the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(sessionRef->interfaceRef->interfaceType != LE_MSG_INTERFACE_CLIENT,
+                "Server attempted to cache its own endpoint.");
+
+    msgInterface_EnableEndpointCache((le_msg_ClientInterfaceRef_t)sessionRef->interfaceRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Opens a session with a service, providing a function to be called-back when the session is
@@ -1990,6 +3128,32 @@ void le_msg_OpenSession
     sessionRef->openHandler = callbackFunc;
     sessionRef->openContextPtr = contextPtr;
 
+    // A session with a local service waits for it to be advertised, holding a reference to the
+    // session while it waits.
+    le_msg_ServiceRef_t serviceRef = sessionRef->localServiceRef;
+    if (serviceRef != NULL)
+    {
+        sessionRef->state = LE_MSG_SESSION_STATE_OPENING;
+
+        le_mem_AddRef(sessionRef);
+
+        if (msgInterface_WaitForLocalService(serviceRef, &sessionRef->waitLink))
+        {
+            le_mem_Release(sessionRef);
+            OpenLocalSession(sessionRef, serviceRef);
+        }
+        return;
+    }
+
+    // Connect in-process if the client interface is bound to a service in this process.
+    serviceRef = msgInterface_FindLocalService((le_msg_ClientInterfaceRef_t)sessionRef->interfaceRef);
+    if (serviceRef != NULL)
+    {
+        OpenLocalSession(sessionRef, serviceRef);
+        msgInterface_Release((le_msg_InterfaceRef_t)serviceRef);
+        return;
+    }
+
     AttemptOpen(sessionRef);
 }
 
@@ -2017,6 +3181,11 @@ void le_msg_OpenSessionSync
 {
     le_result_t result;
 
+    if (OpenLocalSessionSync(sessionRef, true /* wait if necessary */ ) == LE_OK)
+    {
+        return;
+    }
+
     do
     {
         result = AttemptOpenSync(sessionRef, true /* wait if necessary */ );
@@ -2074,6 +3243,13 @@ le_result_t le_msg_TryOpenSessionSync
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_result_t result = OpenLocalSessionSync(sessionRef, false /* don't wait */ );
+
+    if (result != LE_NOT_FOUND)
+    {
+        return result;
+    }
+
     // Attempt a synchronous "Open" for the session.
     return AttemptOpenSync(sessionRef, false /* don't wait for binding or advertisement */ );
 }
@@ -2199,6 +3375,27 @@ le_result_t le_msg_GetClientUserCreds
         LE_FATAL("Server-side function called by client.");
     }
 
+    // A session without a socket is either closed or with a client in this same process.
+    if (sessionRef->socketFd < 0)
+    {
+        if (sessionRef->peerRef == NULL)
+        {
+            return LE_CLOSED;
+        }
+
+        if (userIdPtr)
+        {
+            *userIdPtr = getuid();
+        }
+
+        if (processIdPtr)
+        {
+            *processIdPtr = getpid();
+        }
+
+        return LE_OK;
+    }
+
     int result = getsockopt(sessionRef->socketFd, SOL_SOCKET, SO_PEERCRED, &credentials, &credSize);
 
     if (result == -1)
@@ -2226,3 +3423,29 @@ le_result_t le_msg_GetClientUserCreds
 
     return LE_OK;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a local service that a client session is waiting for has been advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_LocalServiceAdvertised
+(
+    le_dls_Link_t* linkPtr          ///< [IN] Session's wait link.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = CONTAINER_OF(linkPtr, msgSession_Session_t, waitLink);
+
+    if (sessionPtr->isSyncWaiting)
+    {
+        // The client thread is blocked in OpenLocalSessionSync().
+        le_sem_Post(sessionPtr->localSemRef);
+    }
+    else
+    {
+        // The reference held by the wait is handed over to the queued function.
+        le_event_QueueFunctionToThread(sessionPtr->threadRef, ResumeLocalOpen, sessionPtr, NULL);
+    }
+}
@@ -43,13 +43,23 @@ typedef struct le_msg_Session
     msgSession_SessionState_t       state;          ///< The state that the session is in.
     int                             socketFd;       ///< File descriptor for the connected socket.
     le_thread_Ref_t                 threadRef;      ///< The thread that handles this session.
+    le_thread_Ref_t                 workerRef;      ///< Server-side worker thread that handles
+                                                    ///  requests received on this session, or
+                                                    ///  NULL if threadRef handles them.
     le_fdMonitor_Ref_t              fdMonitorRef;   ///< File descriptor monitor for the socket.
     le_msg_InterfaceRef_t           interfaceRef;   ///< The interface being accessed.
 
     le_dls_List_t                   txnList;        ///< List of request messages that have been
                                                     ///  sent and are waiting for their response.
 
+    le_msg_MessageRef_t*            txnTable;       ///< Request messages waiting for their
+                                                    ///  response, indexed by transaction ID.
+    size_t                          txnTableSize;   ///< Number of slots in txnTable (power of 2).
+    size_t                          txnCount;       ///< Number of outstanding transactions.
+    uint32_t                        nextTxnId;      ///< Last transaction ID handed out.
+
     le_dls_List_t                   transmitQueue;  ///< Queue of messages waiting to be sent.
+    size_t                          transmitCount;  ///< Number of messages on the Transmit Queue.
 
     le_dls_List_t                   receiveQueue;   ///< Queue of received messages waiting to be
                                                     /// processed.
@@ -61,6 +71,21 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+
+    // Stuff used only for sessions between a client and a server in the same process:
+
+    le_msg_ServiceRef_t             localServiceRef;///< Local service that a client-side session
+                                                    ///  was created for (NULL if none).
+    le_msg_SessionRef_t             peerRef;        ///< Session object at the other end, or NULL
+                                                    ///  if not connected in-process.
+    le_dls_Link_t                   waitLink;       ///< Used to link onto the list of sessions
+                                                    ///  waiting for a local service.
+    bool                            isSyncWaiting;  ///< true = a synchronous open is blocked on
+                                                    ///  localSemRef until the service is ready.
+    le_sem_Ref_t                    localSemRef;    ///< Semaphore that a client thread blocks on
+                                                    ///  (NULL until first needed).
+    void*                           syncTxnId;      ///< Synchronous transaction being waited for.
+    le_msg_MessageRef_t             syncResponseRef;///< Response to that transaction, once in.
 }
 msgSession_Session_t;
 
@@ -150,6 +175,20 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a batch of synchronous request-response transactions.  Each entry of the array is replaced
+ * by its response message, or NULL if its transaction terminated without a response.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_DoSyncRequestResponseBatch
+(
+    le_msg_SessionRef_t     sessionRef,
+    le_msg_MessageRef_t*    msgRefs,
+    size_t                  msgCount
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the interface reference for a given Session object.
@@ -206,4 +245,16 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a local service that a client session is waiting for (see
+ * msgInterface_WaitForLocalService()) has been advertised.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_LocalServiceAdvertised
+(
+    le_dls_Link_t* linkPtr          ///< [IN] Session's wait link.
+);
+
+
 #endif // LE_MESSAGING_SESSION_H_INCLUDE_GUARD
@@ -28,6 +28,14 @@
  *  -# What type of mutex is a given mutex? (recursive?)
  *    - Stored in each Mutex object as a boolean flag.
  *
+ * All but the last of these have to be updated on every lock and unlock, which makes
+ * le_mutex_Lock() and le_mutex_Unlock() noticeably more expensive than the underlying pthreads
+ * calls.  When the framework is built with @c LE_MUTEX_DIAGNOSTICS_DISABLE, mutexes are still kept
+ * on the Mutex List (which is only updated when they are created and deleted), but locking and
+ * unlocking go straight to the pthreads mutex, which is then of the "normal" (or "adaptive") type
+ * rather than the "error checking" type, so that its uncontended path is a single atomic operation
+ * on a futex.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -114,10 +122,11 @@ static pthread_mutex_t MutexListMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
  * @note Terminates the process on failure, so no need to check the return value for errors.
  */
 //--------------------------------------------------------------------------------------------------
-le_mutex_Ref_t CreateMutex
+static le_mutex_Ref_t CreateMutex
 (
     const char* nameStr,
-    bool        isRecursive
+    bool        isRecursive,
+    bool        isAdaptive      ///< Spin for a while before sleeping (only if not recursive).
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -143,9 +152,18 @@ le_mutex_Ref_t CreateMutex
     {
         mutexType = PTHREAD_MUTEX_RECURSIVE_NP;
     }
+    else if (isAdaptive)
+    {
+        // Re-locking by the same thread is caught by le_mutex_Lock() when diagnostics are enabled.
+        mutexType = PTHREAD_MUTEX_ADAPTIVE_NP;
+    }
     else
     {
+#ifdef LE_MUTEX_DIAGNOSTICS_DISABLE
+        mutexType = PTHREAD_MUTEX_FAST_NP;
+#else
         mutexType = PTHREAD_MUTEX_ERRORCHECK_NP;
+#endif
     }
     int result = pthread_mutexattr_settype(&mutexAttrs, mutexType);
     if (result != 0)
@@ -164,6 +182,8 @@ le_mutex_Ref_t CreateMutex
 }
 
 
+#ifndef LE_MUTEX_DIAGNOSTICS_DISABLE
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds a thread's Mutex Record to a Mutex object's waiting list.
@@ -185,6 +205,8 @@ static void AddToWaitingList
     UNLOCK_WAITING_LIST(mutexPtr);
 }
 
+#endif
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -208,6 +230,8 @@ static void RemoveFromWaitingList
 }
 
 
+#ifndef LE_MUTEX_DIAGNOSTICS_DISABLE
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mark a mutex "locked".
@@ -265,6 +289,8 @@ static void MarkUnlocked
     mutexPtr->lockingThreadRef = NULL;
 }
 
+#endif
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -381,7 +407,7 @@ le_mutex_Ref_t le_mutex_CreateRecursive
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return CreateMutex(nameStr, true);
+    return CreateMutex(nameStr, true, false);
 }
 
 
@@ -400,7 +426,27 @@ le_mutex_Ref_t le_mutex_CreateNonRecursive
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return CreateMutex(nameStr, false);
+    return CreateMutex(nameStr, false, false);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an Adaptive mutex: a non-recursive mutex that spins for a short while before sleeping
+ * when it is held by another thread.  Meant for short critical sections.
+ *
+ * @return  Returns a reference to the mutex.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mutex_Ref_t le_mutex_CreateAdaptive
+(
+    const char* nameStr     ///< [in] Name of the mutex
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CreateMutex(nameStr, false, true);
 }
 
 
@@ -450,8 +496,30 @@ void le_mutex_Lock
 {
     int result;
 
+#ifdef LE_MUTEX_DIAGNOSTICS_DISABLE
+
+    result = pthread_mutex_lock(&mutexRef->mutex);
+    if (result != 0)
+    {
+        LE_FATAL("Thread '%s' failed to lock mutex '%s'. Error code %d (%m).",
+                 le_thread_GetMyName(),
+                 mutexRef->name,
+                 result );
+    }
+
+#else
+
     mutex_ThreadRec_t* perThreadRecPtr = thread_GetMutexRecPtr();
 
+    // Adaptive mutexes don't check for this themselves.  Only this thread can have set the
+    // locking thread to itself, so this is safe to read without holding the lock.
+    if ((!mutexRef->isRecursive) && (mutexRef->lockingThreadRef == le_thread_GetCurrent()))
+    {
+        LE_FATAL("DEADLOCK DETECTED! Thread '%s' attempting to re-lock mutex '%s'.",
+                 le_thread_GetMyName(),
+                 mutexRef->name);
+    }
+
     AddToWaitingList(mutexRef, perThreadRecPtr);
 
     result = pthread_mutex_lock(&mutexRef->mutex);
@@ -491,6 +559,8 @@ void le_mutex_Lock
                      result );
         }
     }
+
+#endif
 }
 
 
@@ -513,6 +583,25 @@ le_result_t le_mutex_TryLock
 {
     int result = pthread_mutex_trylock(&mutexRef->mutex);
 
+#ifdef LE_MUTEX_DIAGNOSTICS_DISABLE
+
+    if (result == 0)
+    {
+        return LE_OK;
+    }
+
+    if (result == EBUSY)
+    {
+        return LE_WOULD_BLOCK;
+    }
+
+    LE_FATAL("Thread '%s' failed to trylock mutex '%s'. Error code %d (%m).",
+             le_thread_GetMyName(),
+             mutexRef->name,
+             result );
+
+#else
+
     if (result == 0)
     {
         // Got the lock!
@@ -544,6 +633,8 @@ le_result_t le_mutex_TryLock
     }
 
     return LE_OK;
+
+#endif
 }
 
 
@@ -560,6 +651,8 @@ void le_mutex_Unlock
 {
     int result;
 
+#ifndef LE_MUTEX_DIAGNOSTICS_DISABLE
+
     le_thread_Ref_t lockingThread = mutexRef->lockingThreadRef;
     le_thread_Ref_t currentThread = le_thread_GetCurrent();
 
@@ -591,6 +684,8 @@ void le_mutex_Unlock
         MarkUnlocked(mutexRef);
     }
 
+#endif
+
     // Warning!  If the lock count is now zero, then as soon as we call this function another
     // thread may grab the lock.
     result = pthread_mutex_unlock(&mutexRef->mutex);
@@ -1082,3 +1082,114 @@ bool le_pathIter_IsEmpty
 {
     return GetPathIterPtr(iterRef)->pathSize == 0;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a view of a path string, ready to walk its nodes from the start.  Neither the path
+ * nor the separator are copied, so they must stay as they are for as long as the view is used.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pathIter_InitView
+(
+    le_pathIter_View_t* viewPtr,    ///< [OUT] The view to initialize.
+    const char* pathPtr,            ///< [IN] The path to view.
+    const char* separatorPtr        ///< [IN] Path separator.  Can not be NULL or empty.
+)
+{
+    LE_ASSERT(viewPtr != NULL);
+    LE_ASSERT(pathPtr != NULL);
+    LE_ASSERT((separatorPtr != NULL) && (separatorPtr[0] != '\0'));
+
+    viewPtr->pathPtr = pathPtr;
+    viewPtr->separatorPtr = separatorPtr;
+    viewPtr->separatorSize = strlen(separatorPtr);
+    viewPtr->position = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a view of the path held by an iterator object, ready to walk its nodes from the
+ * start.  The view may only be used until the iterator's path is changed or the iterator is
+ * deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pathIter_GetView
+(
+    le_pathIter_Ref_t iterRef,      ///< [IN] The iterator object to view.
+    le_pathIter_View_t* viewPtr     ///< [OUT] The view to initialize.
+)
+{
+    PathIterator_t* iterPtr = GetPathIterPtr(iterRef);
+
+    le_pathIter_InitView(viewPtr, iterPtr->path, iterPtr->separator);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is the viewed path absolute?
+ *
+ * @return True if the path begins with a separator, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_pathIter_ViewIsAbsolute
+(
+    const le_pathIter_View_t* viewPtr   ///< [IN] The view to read.
+)
+{
+    LE_ASSERT(viewPtr != NULL);
+
+    return strncmp(viewPtr->pathPtr, viewPtr->separatorPtr, viewPtr->separatorSize) == 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move on to the next node of the viewed path.  The node isn't copied, nor null-terminated.
+ *
+ * @return
+ *      LE_OK if a node was found.
+ *      LE_NOT_FOUND if there are no more nodes in the path.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pathIter_ViewNext
+(
+    le_pathIter_View_t* viewPtr,    ///< [IN/OUT] The view to update.
+    const char** nodePtrPtr,        ///< [OUT] Start of the node in the path.
+    size_t* nodeSizePtr             ///< [OUT] Size of the node in bytes.
+)
+{
+    LE_ASSERT(viewPtr != NULL);
+    LE_ASSERT(nodePtrPtr != NULL);
+    LE_ASSERT(nodeSizePtr != NULL);
+
+    const char* startPtr = viewPtr->pathPtr + viewPtr->position;
+
+    // Skip over any separators before the node.
+    while (strncmp(startPtr, viewPtr->separatorPtr, viewPtr->separatorSize) == 0)
+    {
+        startPtr += viewPtr->separatorSize;
+    }
+
+    if (*startPtr == '\0')
+    {
+        viewPtr->position = startPtr - viewPtr->pathPtr;
+        return LE_NOT_FOUND;
+    }
+
+    // The node runs up to the next separator, or the end of the path.
+    const char* endPtr = strstr(startPtr, viewPtr->separatorPtr);
+
+    if (endPtr == NULL)
+    {
+        endPtr = startPtr + strlen(startPtr);
+    }
+
+    *nodePtrPtr = startPtr;
+    *nodeSizePtr = endPtr - startPtr;
+    viewPtr->position = endPtr - viewPtr->pathPtr;
+
+    return LE_OK;
+}
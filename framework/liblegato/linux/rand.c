@@ -3,6 +3,15 @@
  * This Random Number API is a wrapper around a cryptographic pseudo-random number generator (CPRNG)
  * that is properly seeded with entropy.
  *
+ * Small requests are served from a per-thread ChaCha20 generator, so that they don't each need a
+ * system call.  Each generator is seeded from the kernel, and reseeded from the kernel after
+ * RESEED_BYTES bytes of output, and in the child process after a fork().  The generator uses "fast
+ * key erasure": every time it refills its buffer of output, the first bytes of the new output
+ * replace the key, so that random numbers already handed out can't be recovered from its state.
+ * Output bytes are wiped from the buffer as they are handed out, for the same reason.
+ *
+ * Large requests are read directly from the kernel.
+ *
  * @warning
  *          The availability of entropy and seeding of the CPRNG is system dependent.  When porting
  *          this module care must be taken to ensure that the underlying CPRNG and entropy pools are
@@ -26,22 +35,124 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get a random number within the specified range, min to max inclusive.
- *
- * @warning The max value must be greater than the min value, if not this function will log the
- *          error and kill the calling process.
- *
- * @return  The random number.
+ * Number of bytes in a ChaCha20 block.
  */
 //--------------------------------------------------------------------------------------------------
-uint32_t le_rand_GetNumBetween
+#define CHACHA_BLOCK_BYTES          64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in a ChaCha20 key.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHACHA_KEY_BYTES            32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of ChaCha20 blocks generated each time a generator's buffer is refilled.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BUFFER_BLOCKS               16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in a generator's buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BUFFER_BYTES                (BUFFER_BLOCKS * CHACHA_BLOCK_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest request served from the per-thread generator.  Larger ones are read from the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BUFFERED_REQUEST_BYTES  256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes a generator outputs before it is reseeded from the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESEED_BYTES                (1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-thread ChaCha20 generator.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t        key[CHACHA_KEY_BYTES / sizeof(uint32_t)];   ///< Current key.
+    uint64_t        counter;            ///< Block counter.
+    uint8_t         buf[BUFFER_BYTES];  ///< Output not handed out yet is at the end.
+    size_t          availableBytes;     ///< Number of bytes of output left in buf.
+    size_t          bytesUntilReseed;   ///< Output to generate before reseeding.
+    unsigned int    forkCount;          ///< Value of ForkCount when last seeded.
+    bool            isSeeded;           ///< true once the generator has been seeded.
+}
+Generator_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to find the calling thread's generator.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t GeneratorKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure GeneratorKey is only created once.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_once_t GeneratorKeyOnce = PTHREAD_ONCE_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times the process has been forked into a child.  Each generator remembers the value it
+ * was seeded with, so that generators copied into a child process are reseeded before use.
+ * Otherwise the parent and the child would return the same random numbers.
+ */
+//--------------------------------------------------------------------------------------------------
+static unsigned int ForkCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills a buffer with memset() in a way that the compiler won't optimize away, even if the buffer
+ * isn't read again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Wipe
 (
-    uint32_t min,               ///< [IN] Minimum value in range (inclusive).
-    uint32_t max                ///< [IN] Maximum value in range (inclusive).
+    void* bufPtr,
+    size_t bufSize
 )
 {
-    LE_ASSERT(max > min);
+    memset(bufPtr, 0, bufSize);
+    __asm__ __volatile__("" : : "r"(bufPtr) : "memory");
+}
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads random bytes from the kernel.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadEntropy
+(
+    uint8_t* bufPtr,            ///< [OUT] Buffer to store the random bytes in.
+    size_t bufSize              ///< [IN] Number of random bytes to read.
+)
+{
     // Versions of glibc before 2.25 do not have support for the getrandom() functions in which case
     // we need to read directly from /dev/urandom.
 
@@ -58,100 +169,311 @@ uint32_t le_rand_GetNumBetween
     LE_FATAL_IF(fd == -1, "Failed to open /dev/urandom. %m.");
 #endif
 
-    // Determine range of numbers to reject.
-    uint32_t interval = max - min + 1;
-
-    uint64_t numPossibleVals = (uint64_t)UINT32_MAX + 1;
-    uint64_t rejectThreshold = numPossibleVals - (numPossibleVals % interval);
-
-    // Get random number.
-    uint32_t randNum;
+    // Get random numbers.
+    size_t readCount = 0;
 
-    while (1)
+    while (readCount < bufSize)
     {
         ssize_t c;
 
         do
         {
 #ifdef NO_SYS_RANDOM
-            c = read(fd, &randNum, sizeof(randNum));
+            c = read(fd, &(bufPtr[readCount]), (bufSize-readCount));
 #else
-            c = getrandom(&randNum, sizeof(randNum), 0);
+            c = getrandom(&(bufPtr[readCount]), (bufSize-readCount), 0);
 #endif
         }
-        while ( ((c == -1) && (errno == EINTR)) || (c < sizeof(randNum)) );
+        while ( (c == -1) && (errno == EINTR) );
 
         LE_FATAL_IF(c == -1, "Could not read random numbers. %m.");
 
-        // Check if this number is valid.  Reject numbers that are about greater than or equal to
-        // our threshold to avoid bias.
-        if (randNum < rejectThreshold)
-        {
-            // The number is valid.
-            break;
-        }
+        readCount += c;
     }
 
 #ifdef NO_SYS_RANDOM
     fd_Close(fd);
 #endif
+}
 
-    return (randNum % interval) + min;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * ChaCha20 quarter round.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ROTL32(v, n)    (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)                       \
+    do                                                  \
+    {                                                   \
+        a += b; d ^= a; d = ROTL32(d, 16);              \
+        c += d; b ^= c; b = ROTL32(b, 12);              \
+        a += b; d ^= a; d = ROTL32(d, 8);               \
+        c += d; b ^= c; b = ROTL32(b, 7);               \
+    }                                                   \
+    while (0)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes one ChaCha20 block (RFC 8439, section 2.3) from an input state and serializes it
+ * little-endian.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChaChaBlock
+(
+    const uint32_t inState[16],                 ///< [IN] Constants, key, counter and nonce.
+    uint8_t outBlock[CHACHA_BLOCK_BYTES]        ///< [OUT] Key stream block.
+)
+{
+    uint32_t x[16];
+    int i;
+
+    memcpy(x, inState, sizeof(x));
+
+    for (i = 0; i < 10; i++)
+    {
+        // Column rounds.
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+
+        // Diagonal rounds.
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (i = 0; i < 16; i++)
+    {
+        uint32_t word = x[i] + inState[i];
+
+        outBlock[4 * i]     = (uint8_t)word;
+        outBlock[4 * i + 1] = (uint8_t)(word >> 8);
+        outBlock[4 * i + 2] = (uint8_t)(word >> 16);
+        outBlock[4 * i + 3] = (uint8_t)(word >> 24);
+    }
+
+    Wipe(x, sizeof(x));
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get a buffer of random numbers.
+ * Seeds a generator with a fresh key from the kernel and discards its buffered output.
  */
 //--------------------------------------------------------------------------------------------------
-void le_rand_GetBuffer
+static void Reseed
 (
-    uint8_t* bufPtr,            ///< [OUT] Buffer to store the random numbers in.
-    size_t bufSize              ///< [IN] Number of random numbers to get.
+    Generator_t* genPtr
 )
 {
-    LE_ASSERT(bufPtr != NULL);
+    ReadEntropy((uint8_t*)genPtr->key, sizeof(genPtr->key));
 
-    // Versions of glibc before 2.25 do not have support for the getrandom() functions in which case
-    // we need to read directly from /dev/urandom.
+    Wipe(genPtr->buf, sizeof(genPtr->buf));
+    genPtr->counter = 0;
+    genPtr->availableBytes = 0;
+    genPtr->bytesUntilReseed = RESEED_BYTES;
+    genPtr->forkCount = __atomic_load_n(&ForkCount, __ATOMIC_ACQUIRE);
+    genPtr->isSeeded = true;
+}
 
-#ifdef NO_SYS_RANDOM
-    // Open /dev/urandom for reading.
-    int fd;
 
-    do
+//--------------------------------------------------------------------------------------------------
+/**
+ * Refills a generator's buffer.  The first bytes of the new output become the new key and are
+ * wiped from the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Refill
+(
+    Generator_t* genPtr
+)
+{
+    // "expand 32-byte k"
+    uint32_t state[16] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+    size_t i;
+
+    memcpy(&state[4], genPtr->key, sizeof(genPtr->key));
+
+    // The key changes with every refill, so the nonce can stay zero.
+    for (i = 0; i < BUFFER_BLOCKS; i++)
     {
-        fd = open("/dev/urandom", O_RDONLY);
+        state[12] = (uint32_t)genPtr->counter;
+        state[13] = (uint32_t)(genPtr->counter >> 32);
+        genPtr->counter++;
+
+        ChaChaBlock(state, &genPtr->buf[i * CHACHA_BLOCK_BYTES]);
     }
-    while ((fd == -1) && (errno == EINTR));
 
-    LE_FATAL_IF(fd == -1, "Failed to open /dev/urandom. %m.");
-#endif
+    Wipe(state, sizeof(state));
 
-    // Get random numbers.
-    size_t readCount = 0;
+    memcpy(genPtr->key, genPtr->buf, sizeof(genPtr->key));
+    Wipe(genPtr->buf, sizeof(genPtr->key));
 
-    while (readCount < bufSize)
+    genPtr->availableBytes = BUFFER_BYTES - CHACHA_KEY_BYTES;
+    genPtr->bytesUntilReseed -= (genPtr->bytesUntilReseed < BUFFER_BYTES) ?
+                                genPtr->bytesUntilReseed : BUFFER_BYTES;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks the generators copied into a child process as needing to be reseeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChildAfterFork
+(
+    void
+)
+{
+    __atomic_add_fetch(&ForkCount, 1, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wipes and frees a thread's generator when the thread dies.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteGenerator
+(
+    void* objPtr    ///< [IN] Pointer to the thread's generator.
+)
+{
+    Wipe(objPtr, sizeof(Generator_t));
+    free(objPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the thread-local data key used to find each thread's generator.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateGeneratorKey
+(
+    void
+)
+{
+    LE_ASSERT(pthread_key_create(&GeneratorKey, DeleteGenerator) == 0);
+    LE_ASSERT(pthread_atfork(NULL, NULL, ChildAfterFork) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets random bytes from the calling thread's generator, creating or (re)seeding it if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetBufferedBytes
+(
+    uint8_t* bufPtr,            ///< [OUT] Buffer to store the random bytes in.
+    size_t bufSize              ///< [IN] Number of random bytes.  At most
+                                ///       MAX_BUFFERED_REQUEST_BYTES.
+)
+{
+    LE_ASSERT(pthread_once(&GeneratorKeyOnce, CreateGeneratorKey) == 0);
+
+    Generator_t* genPtr = pthread_getspecific(GeneratorKey);
+
+    if (genPtr == NULL)
     {
-        ssize_t c;
+        genPtr = calloc(1, sizeof(Generator_t));
+        LE_ASSERT(genPtr != NULL);
+        LE_ASSERT(pthread_setspecific(GeneratorKey, genPtr) == 0);
+    }
 
-        do
+    if ( (!genPtr->isSeeded) ||
+         (genPtr->forkCount != __atomic_load_n(&ForkCount, __ATOMIC_ACQUIRE)) )
+    {
+        Reseed(genPtr);
+    }
+
+    if (genPtr->availableBytes < bufSize)
+    {
+        if (genPtr->bytesUntilReseed == 0)
         {
-#ifdef NO_SYS_RANDOM
-            c = read(fd, &(bufPtr[readCount]), (bufSize-readCount));
-#else
-            c = getrandom(&(bufPtr[readCount]), (bufSize-readCount), 0);
-#endif
+            Reseed(genPtr);
         }
-        while ( (c == -1) && (errno == EINTR) );
 
-        LE_FATAL_IF(c == -1, "Could not read random numbers. %m.");
+        Refill(genPtr);
+    }
 
-        readCount += c;
+    uint8_t* outPtr = &genPtr->buf[BUFFER_BYTES - genPtr->availableBytes];
+
+    memcpy(bufPtr, outPtr, bufSize);
+    Wipe(outPtr, bufSize);
+    genPtr->availableBytes -= bufSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a random number within the specified range, min to max inclusive.
+ *
+ * @warning The max value must be greater than the min value, if not this function will log the
+ *          error and kill the calling process.
+ *
+ * @return  The random number.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_rand_GetNumBetween
+(
+    uint32_t min,               ///< [IN] Minimum value in range (inclusive).
+    uint32_t max                ///< [IN] Maximum value in range (inclusive).
+)
+{
+    LE_ASSERT(max > min);
+
+    // Determine range of numbers to reject.
+    uint32_t interval = max - min + 1;
+
+    uint64_t numPossibleVals = (uint64_t)UINT32_MAX + 1;
+    uint64_t rejectThreshold = numPossibleVals - (numPossibleVals % interval);
+
+    // Get random number.
+    uint32_t randNum;
+
+    while (1)
+    {
+        GetBufferedBytes((uint8_t*)&randNum, sizeof(randNum));
+
+        // Check if this number is valid.  Reject numbers that are about greater than or equal to
+        // our threshold to avoid bias.
+        if (randNum < rejectThreshold)
+        {
+            // The number is valid.
+            break;
+        }
     }
 
-#ifdef NO_SYS_RANDOM
-    fd_Close(fd);
-#endif
+    return (randNum % interval) + min;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a buffer of random numbers.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_rand_GetBuffer
+(
+    uint8_t* bufPtr,            ///< [OUT] Buffer to store the random numbers in.
+    size_t bufSize              ///< [IN] Number of random numbers to get.
+)
+{
+    LE_ASSERT(bufPtr != NULL);
+
+    if (bufSize <= MAX_BUFFERED_REQUEST_BYTES)
+    {
+        GetBufferedBytes(bufPtr, bufSize);
+    }
+    else
+    {
+        ReadEntropy(bufPtr, bufSize);
+    }
 }
@@ -29,17 +29,109 @@
 /// Name used for diagnostics.
 static const char ModuleName[] = "ref";
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe References are packed into 32 bits when they are sent over IPC (see
+ * le_pack_PackReference()), so they must fit in 32 bits even on 64-bit systems.  The lowest bit
+ * is always 1 and the highest bit is WIDE_FLAG.  The rest hold the index of the reference's slot
+ * and, above it, the slot's generation.
+ *
+ * The slots a map is created with (rounded up to a power of two) are "narrow": their index only
+ * takes up as many bits as the map's expected size needs, and the rest hold the generation, so a
+ * small map can reuse a slot many times before its generation repeats.  Slots added when the map
+ * grows past that are "wide": their index takes up MAX_INDEX_BITS bits.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WIDE_FLAG ((uintptr_t)1 << 31)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bits of a Safe Reference shared by the index and the generation.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INDEX_AND_GENERATION_BITS 30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bits that hold the index in a wide slot's Safe Reference.  This limits a Reference
+ * Map to about a million Safe References at any one time, and leaves 10 bits for the generation.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_INDEX_BITS 20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of slots in a Reference Map.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SLOTS ((size_t)1 << MAX_INDEX_BITS)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mask for the part of a slot's generation counter that is kept in a Safe Reference whose index
+ * takes up a given number of bits.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GENERATION_MASK(indexBits) \
+    ((uint32_t)(((uint64_t)1 << (INDEX_AND_GENERATION_BITS - (indexBits))) - 1))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of a free list link that does not refer to any slot (end of the list).
+ */
+//--------------------------------------------------------------------------------------------------
+#define NO_SLOT UINT32_MAX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A slot in a Reference Map, holding the pointer that one Safe Reference maps to.
+ *
+ * Each time a slot's Safe Reference is deleted, the slot's generation is incremented, so Safe
+ * References made from the slot before that will no longer match it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*       ptr;            ///< Pointer that the slot's Safe Reference maps to.
+    uint32_t    generation;     ///< Number of times the slot has been used.
+    uint32_t    nextFreeIndex;  ///< Next slot on the free list, if this slot is free.
+    bool        inUse;          ///< true if the slot holds a valid Safe Reference.
+}
+Slot_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Iterator over a Reference Map's Safe References.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_ref_Iter
+{
+    struct le_ref_Map*  mapPtr;     ///< The map being iterated over.
+    ssize_t             index;      ///< Slot the iterator is on, or -1 if not yet started.
+    bool                isValid;    ///< true if the iterator is on a slot (not past the end).
+}
+Iter_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference Map object, which stores mappings from Safe References to pointers.
- * The actual mapping is held in a hashmap.
+ *
+ * The mappings are held in an array of slots.  A Safe Reference holds the index of its slot and
+ * the slot's generation, so looking one up is just a bounds check and a compare.  Free slots are
+ * kept on a first-in-first-out list, so that a deleted slot is reused as late as possible, which
+ * makes it less likely that a stale Safe Reference will match the slot's generation again.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct le_ref_Map
 {
-    uint32_t             nextRefNum;     ///< The next Safe Reference value to be assigned.
+    Slot_t*             slotsPtr;       ///< Array of slots.
+    size_t              slotCount;      ///< Number of slots in the array.
+    uint32_t            freeHeadIndex;  ///< First slot on the free list (next to be used).
+    uint32_t            freeTailIndex;  ///< Last slot on the free list (most recently freed).
+    uint32_t            firstGeneration;///< Generation that new slots start at.
+    uint8_t             narrowIndexBits;///< Number of bits of a narrow slot's index.
 
-    le_hashmap_Ref_t    referenceMap;    ///< HashMap of Mapping objects.
+    Iter_t              iterator;       ///< The map's iterator.
 
     char          name[MAX_NAME_BYTES]; ///< The name of the map (for diagnostics).
 }
@@ -53,44 +145,158 @@ Map_t;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t MapPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of Reference Maps created so far.  Used to start each map's slots at a different
+ * generation, so that using a Safe Reference with the wrong map is more likely to be detected.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MapCount;
+
 // =============================================
 //  PRIVATE FUNCTIONS
 // =============================================
 
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef hashing function.
- *
- * @return  Returns the SafeRef itself as it can used as a hash
- *
+ * Adds a slot to the tail of a Reference Map's free list.
  */
 //--------------------------------------------------------------------------------------------------
+static void AddToFreeList
+(
+    Map_t*      mapPtr,     ///< [in] The map.
+    uint32_t    index       ///< [in] Index of the slot.
+)
+{
+    mapPtr->slotsPtr[index].nextFreeIndex = NO_SLOT;
+
+    if (mapPtr->freeTailIndex == NO_SLOT)
+    {
+        mapPtr->freeHeadIndex = index;
+    }
+    else
+    {
+        mapPtr->slotsPtr[mapPtr->freeTailIndex].nextFreeIndex = index;
+    }
+    mapPtr->freeTailIndex = index;
+}
+
 
-size_t hashSafeRef
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds slots to a Reference Map, putting them on its free list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowMap
 (
-    const void* safeRefPtr    ///< [in] Safe Ref to be hashed
+    Map_t*  mapPtr,     ///< [in] The map.
+    size_t  newCount    ///< [in] New number of slots.
 )
 {
-    // Return the key value itself.
-    return (size_t) safeRefPtr;
+    LE_FATAL_IF(newCount > MAX_SLOTS,
+                "Too many Safe References in Map '%s' (maximum is %zu).",
+                mapPtr->name,
+                MAX_SLOTS);
+
+    // It is ok to use realloc here, as maps are never deleted and the slots are only accessed
+    // through their indices.
+    Slot_t* slotsPtr = realloc(mapPtr->slotsPtr, newCount * sizeof(Slot_t));
+    LE_ASSERT(slotsPtr != NULL);
+    mapPtr->slotsPtr = slotsPtr;
+
+    size_t i;
+    for (i = mapPtr->slotCount; i < newCount; i++)
+    {
+        slotsPtr[i].ptr = NULL;
+        slotsPtr[i].generation = mapPtr->firstGeneration;
+        slotsPtr[i].inUse = false;
+        AddToFreeList(mapPtr, (uint32_t)i);
+    }
+
+    mapPtr->slotCount = newCount;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a slot was added when its map grew past its expected size.
+ *
+ * @return true if the slot is wide, false if it is narrow.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsWideSlot
+(
+    Map_t*  mapPtr,     ///< [in] The map.
+    size_t  index       ///< [in] Index of the slot.
+)
+{
+    return (index >= ((size_t)1 << mapPtr->narrowIndexBits));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef equality function.
+ * Makes the Safe Reference for a slot.
  *
- * @return  Returns true if the integers are equal, false otherwise
+ * The lowest bit is always set, so a Safe Reference is never NULL and never looks like a
+ * word-aligned pointer.
  *
+ * @return The Safe Reference.
  */
 //--------------------------------------------------------------------------------------------------
+static inline void* MakeRef
+(
+    Map_t*  mapPtr,     ///< [in] The map.
+    size_t  index       ///< [in] Index of the slot.
+)
+{
+    bool isWide = IsWideSlot(mapPtr, index);
+    unsigned int indexBits = isWide ? MAX_INDEX_BITS : mapPtr->narrowIndexBits;
+    uintptr_t generation = mapPtr->slotsPtr[index].generation & GENERATION_MASK(indexBits);
+    uintptr_t wideFlag = isWide ? WIDE_FLAG : 0;
 
-bool equalsSafeRef
+    return (void*)(wideFlag | (generation << (indexBits + 1)) | ((uintptr_t)index << 1) | 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the slot that a Safe Reference refers to.
+ *
+ * @return A pointer to the slot, or NULL if the Safe Reference is not valid in this map.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Slot_t* FindSlot
 (
-    const void* firstSafeRef,    ///< [in] First SafeRef for comparing.
-    const void* secondSafeRef    ///< [in] Second SafeRef for comparing.
+    Map_t*  mapPtr,     ///< [in] The map.
+    void*   safeRef     ///< [in] The Safe Reference.
 )
 {
-    return firstSafeRef == secondSafeRef;
+    uintptr_t ref = (uintptr_t)safeRef;
+
+    if (((ref & 1) == 0) || (ref > UINT32_MAX))
+    {
+        return NULL;
+    }
+
+    bool isWide = ((ref & WIDE_FLAG) != 0);
+    unsigned int indexBits = isWide ? MAX_INDEX_BITS : mapPtr->narrowIndexBits;
+    size_t index = (ref >> 1) & (((size_t)1 << indexBits) - 1);
+    uint32_t generation = (uint32_t)((ref & ~WIDE_FLAG) >> (indexBits + 1));
+
+    if ((index >= mapPtr->slotCount) || (IsWideSlot(mapPtr, index) != isWide))
+    {
+        return NULL;
+    }
+
+    Slot_t* slotPtr = &mapPtr->slotsPtr[index];
+
+    if ((!slotPtr->inUse) || ((slotPtr->generation & GENERATION_MASK(indexBits)) != generation))
+    {
+        return NULL;
+    }
+
+    return slotPtr;
 }
 
 // =============================================
@@ -149,15 +355,26 @@ le_ref_MapRef_t le_ref_CreateMap
         LE_WARN("Map name '%s%s' truncated to '%s'.", ModuleName, name, mapPtr->name);
     }
 
-    /// @todo Make this a random number so that using a reference from another Map is unlikely to
-    ///       get by undetected.
-    mapPtr->nextRefNum = 0x10000001; // Use only odd numbers.
+    /// @todo Make this a random number so that using a reference from another Map is even less
+    ///       likely to get by undetected.
+    mapPtr->firstGeneration = MapCount++ * 0x9E3779B1;
 
-    mapPtr->referenceMap = le_hashmap_Create(mapPtr->name,
-                                             maxRefs,
-                                             hashSafeRef,
-                                             equalsSafeRef
-                                            );
+    mapPtr->narrowIndexBits = 0;
+    while (   (mapPtr->narrowIndexBits < MAX_INDEX_BITS)
+           && (((size_t)1 << mapPtr->narrowIndexBits) < maxRefs))
+    {
+        mapPtr->narrowIndexBits++;
+    }
+
+    mapPtr->slotsPtr = NULL;
+    mapPtr->slotCount = 0;
+    mapPtr->freeHeadIndex = NO_SLOT;
+    mapPtr->freeTailIndex = NO_SLOT;
+    GrowMap(mapPtr, (maxRefs == 0) ? 1 : maxRefs);
+
+    mapPtr->iterator.mapPtr = mapPtr;
+    mapPtr->iterator.index = -1;
+    mapPtr->iterator.isValid = false;
 
     return mapPtr;
 }
@@ -178,13 +395,26 @@ void* le_ref_CreateRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ssize_t thisRef = mapRef->nextRefNum;
+    // If there are no free slots, double the number of slots.
+    if (mapRef->freeHeadIndex == NO_SLOT)
+    {
+        size_t newCount = mapRef->slotCount * 2;
+        GrowMap(mapRef, (newCount > MAX_SLOTS) ? mapRef->slotCount + 1 : newCount);
+    }
 
-    le_hashmap_Put(mapRef->referenceMap, (const void*)(thisRef), ptr);
+    uint32_t index = mapRef->freeHeadIndex;
+    Slot_t* slotPtr = &mapRef->slotsPtr[index];
+
+    mapRef->freeHeadIndex = slotPtr->nextFreeIndex;
+    if (mapRef->freeHeadIndex == NO_SLOT)
+    {
+        mapRef->freeTailIndex = NO_SLOT;
+    }
 
-    mapRef->nextRefNum += 2; // Increment the reference number for next time, keeping it odd.
+    slotPtr->ptr = ptr;
+    slotPtr->inUse = true;
 
-    return (void *)thisRef;
+    return MakeRef(mapRef, index);
 }
 
 
@@ -204,7 +434,9 @@ void* le_ref_Lookup
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return le_hashmap_Get(mapRef->referenceMap, safeRef);
+    Slot_t* slotPtr = FindSlot(mapRef, safeRef);
+
+    return (slotPtr == NULL) ? NULL : slotPtr->ptr;
 }
 
 
@@ -220,10 +452,20 @@ void le_ref_DeleteRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (le_hashmap_Remove(mapRef->referenceMap, safeRef) == NULL)
+    Slot_t* slotPtr = FindSlot(mapRef, safeRef);
+
+    if (slotPtr == NULL)
     {
         LE_ERROR("Deleting non-existent Safe Reference %p from Map '%s'.", safeRef, mapRef->name);
+        return;
     }
+
+    // Bump the generation so that this Safe Reference no longer matches the slot.
+    slotPtr->ptr = NULL;
+    slotPtr->inUse = false;
+    slotPtr->generation++;
+
+    AddToFreeList(mapRef, (uint32_t)(slotPtr - mapRef->slotsPtr));
 }
 
 
@@ -234,7 +476,7 @@ void le_ref_DeleteRef
  * per map, and calling this function resets the iterator position to the start of the map.  The
  * iterator is not ready for data access until le_ref_NextNode() has been called at least once.
  *
- * @return  Returns A reference to a hashmap iterator which is ready for le_hashmap_NextNode() to be
+ * @return  Returns A reference to an iterator which is ready for le_ref_NextNode() to be
  *          called on it.
  */
 //--------------------------------------------------------------------------------------------------
@@ -243,7 +485,10 @@ le_ref_IterRef_t le_ref_GetIterator
     le_ref_MapRef_t mapRef ///< [in] Reference to the map.
 )
 {
-    return (le_ref_IterRef_t)le_hashmap_GetIterator(mapRef->referenceMap);
+    mapRef->iterator.index = -1;
+    mapRef->iterator.isValid = false;
+
+    return &mapRef->iterator;
 }
 
 
@@ -261,14 +506,30 @@ le_result_t le_ref_NextNode
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_NextNode((le_hashmap_It_Ref_t)iteratorRef);
+    Map_t* mapPtr = iteratorRef->mapPtr;
+    ssize_t index;
+
+    for (index = iteratorRef->index + 1; index < (ssize_t)mapPtr->slotCount; index++)
+    {
+        if (mapPtr->slotsPtr[index].inUse)
+        {
+            iteratorRef->index = index;
+            iteratorRef->isValid = true;
+            return LE_OK;
+        }
+    }
+
+    // Stay past the end of the map.
+    iteratorRef->index = (ssize_t)mapPtr->slotCount;
+    iteratorRef->isValid = false;
+    return LE_NOT_FOUND;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieves a pointer to the safe ref iterator is currently pointing at.  If the iterator has just
- * been initialized and le_hashmap_NextNode() has not been called, or if the iterator has been
+ * been initialized and le_ref_NextNode() has not been called, or if the iterator has been
  * invalidated then this will return NULL.
  *
  * @return  A pointer to the current key, or NULL if the iterator has been invalidated or is not ready.
@@ -280,7 +541,13 @@ const void* le_ref_GetSafeRef
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetKey((le_hashmap_It_Ref_t)iteratorRef);
+    // The slot will no longer be in use if its Safe Reference was deleted during the iteration.
+    if ((!iteratorRef->isValid) || (!iteratorRef->mapPtr->slotsPtr[iteratorRef->index].inUse))
+    {
+        return NULL;
+    }
+
+    return MakeRef(iteratorRef->mapPtr, iteratorRef->index);
 }
 
 
@@ -299,5 +566,10 @@ void* le_ref_GetValue
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetValue((le_hashmap_It_Ref_t)iteratorRef);
+    if ((!iteratorRef->isValid) || (!iteratorRef->mapPtr->slotsPtr[iteratorRef->index].inUse))
+    {
+        return NULL;
+    }
+
+    return iteratorRef->mapPtr->slotsPtr[iteratorRef->index].ptr;
 }
@@ -116,6 +116,79 @@
 //********  SMACK is enabled.  *******************************************************************//
 #if DISABLE_SMACK != 1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The calling process's own SMACK label, as last read by smack_GetProcLabel().
+ *
+ * The cached label is only valid in the process that read it (MyLabelPid), and only until the
+ * process sets its label again (which bumps MyLabelGeneration).  smack_TrySetMyLabel() may be
+ * called in a child process between fork() and exec(), so it only touches MyLabelGeneration, with
+ * an atomic operation; the rest is protected by MyLabelMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static char MyLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
+static pid_t MyLabelPid = 0;
+static unsigned int MyLabelCachedGeneration;
+static unsigned int MyLabelGeneration = 0;
+static pthread_mutex_t MyLabelMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the calling process's own SMACK label from the cache.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the supplied buffer is too small to hold the SMACK label.
+ *      LE_NOT_FOUND if the label isn't cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetCachedMyLabel
+(
+    char* bufPtr,                   ///< [OUT] Buffer to store the SMACK label.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+
+    LE_ASSERT(pthread_mutex_lock(&MyLabelMutex) == 0);
+
+    if ( (MyLabelPid == getpid()) &&
+         (MyLabelCachedGeneration == __atomic_load_n(&MyLabelGeneration, __ATOMIC_ACQUIRE)) )
+    {
+        result = le_utf8_Copy(bufPtr, MyLabel, bufSize, NULL);
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&MyLabelMutex) == 0);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Caches the calling process's own SMACK label, unless the label has been set since it was read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CacheMyLabel
+(
+    const char* labelPtr,           ///< [IN] Label read from the file system.
+    unsigned int generation         ///< [IN] Value of MyLabelGeneration before the label was read.
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&MyLabelMutex) == 0);
+
+    if ( (generation == __atomic_load_n(&MyLabelGeneration, __ATOMIC_ACQUIRE)) &&
+         (le_utf8_Copy(MyLabel, labelPtr, sizeof(MyLabel), NULL) == LE_OK) )
+    {
+        MyLabelPid = getpid();
+        MyLabelCachedGeneration = generation;
+    }
+
+    LE_ASSERT(pthread_mutex_unlock(&MyLabelMutex) == 0);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set SMACK netlabel exception to grant applications permission to communicate with the Internet
@@ -332,6 +405,49 @@ static void MakeRuleStr
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads one or more SMACK rules with a single write to the SMACK load file.  Multiple rules must be
+ * separated by newlines, and must fit in SMACK_RULE_BATCH_BYTES.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadRules
+(
+    const char* rulesPtr,           ///< [IN] Rules.  Need not be null-terminated.
+    size_t rulesLength              ///< [IN] Number of bytes of rules.
+)
+{
+    LE_ASSERT(rulesLength <= SMACK_RULE_BATCH_BYTES);
+
+    // Open the SMACK load file.
+    int fd;
+
+    do
+    {
+        fd = open(SMACK_LOAD_FILE, O_WRONLY);
+    }
+    while ( (fd == -1) && (errno == EINTR) );
+
+    LE_FATAL_IF(fd == -1, "Could not open %s.  %m.\n", SMACK_LOAD_FILE);
+
+    // Write the rules to the SMACK load file.
+    ssize_t numBytes = 0;
+
+    do
+    {
+        numBytes = write(fd, rulesPtr, rulesLength);
+    }
+    while ( (numBytes == -1) && (errno == EINTR) );
+
+    LE_FATAL_IF(numBytes != rulesLength,
+                "Could not write SMACK rules '%.*s'.  %m.", (int)rulesLength, rulesPtr);
+
+    fd_Close(fd);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Shows whether SMACK is enabled or disabled in the Legato Framework.
@@ -384,18 +500,19 @@ void smack_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sets the smack label of the calling process. The calling process must be a privileged process.
+ * Sets the smack label of the calling process, without logging or killing the calling process on
+ * error.  The label is not validated.
  *
- * @note If there's an error, this function will kill the calling process.
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  errno is set.
  */
 //--------------------------------------------------------------------------------------------------
-void smack_SetMyLabel
+le_result_t smack_TrySetMyLabel
 (
     const char* labelPtr            ///< [IN] Label to set the calling process to.
 )
 {
-    CheckLabel(labelPtr);
-
     // Open the calling process's smack file.
     int fd;
 
@@ -405,7 +522,10 @@ void smack_SetMyLabel
     }
     while ( (fd == -1) && (errno == EINTR) );
 
-    LE_FATAL_IF(fd == -1, "Could not open %s.  %m.\n", PROC_SMACK_FILE);
+    if (fd == -1)
+    {
+        return LE_FAULT;
+    }
 
     // Write the label to the file.
     size_t labelSize = strlen(labelPtr);
@@ -418,10 +538,39 @@ void smack_SetMyLabel
     }
     while ( (result == -1) && (errno == EINTR) );
 
-    LE_FATAL_IF(result != labelSize,
-                "Could not write to %s.  %m.\n", PROC_SMACK_FILE);
+    int writeErrno = (result == -1) ? errno : EIO;
 
-    fd_Close(fd);
+    close(fd);
+
+    // Whether or not it worked, the cached label may be out of date now.
+    __atomic_add_fetch(&MyLabelGeneration, 1, __ATOMIC_RELEASE);
+
+    if (result != labelSize)
+    {
+        errno = writeErrno;
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the smack label of the calling process. The calling process must be a privileged process.
+ *
+ * @note If there's an error, this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_SetMyLabel
+(
+    const char* labelPtr            ///< [IN] Label to set the calling process to.
+)
+{
+    CheckLabel(labelPtr);
+
+    LE_FATAL_IF(smack_TrySetMyLabel(labelPtr) != LE_OK,
+                "Could not set the label in %s.  %m.\n", PROC_SMACK_FILE);
 
     LE_DEBUG("Setting process' SMACK label to '%s'.", labelPtr);
 }
@@ -444,6 +593,21 @@ le_result_t smack_GetProcLabel
     size_t bufSize                  ///< [IN] Size of the buffer.
 )
 {
+    bool isMe = (pid == getpid());
+    unsigned int generation = 0;
+
+    if (isMe)
+    {
+        le_result_t result = GetCachedMyLabel(bufPtr, bufSize);
+
+        if (result != LE_NOT_FOUND)
+        {
+            return result;
+        }
+
+        generation = __atomic_load_n(&MyLabelGeneration, __ATOMIC_ACQUIRE);
+    }
+
     // Get the process's smack file name.
     char smackFile[LIMIT_MAX_PATH_BYTES];
     LE_ASSERT(snprintf(smackFile, sizeof(smackFile), "/proc/%d/attr/current", pid) < sizeof(smackFile));
@@ -473,6 +637,11 @@ le_result_t smack_GetProcLabel
         return LE_FAULT;
     }
 
+    if (isMe && (result == LE_OK))
+    {
+        CacheMyLabel(bufPtr, generation);
+    }
+
     return result;
 }
 
@@ -570,32 +739,74 @@ void smack_SetRule
     char rule[SMACK_RULE_STR_BYTES];
     MakeRuleStr(subjectLabelPtr, accessModePtr, objectLabelPtr, rule, sizeof(rule));
 
-    // Open the SMACK load file.
-    int fd;
+    LoadRules(rule, strlen(rule));
 
-    do
+    LE_DEBUG("Set SMACK rule '%s'.", rule);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a rule batch.  The access mode is the same as for smack_SetRule().
+ *
+ * If the batch is full, the rules already in it are loaded first.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRule
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Rule batch.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+)
+{
+    CheckLabel(subjectLabelPtr);
+    CheckLabel(objectLabelPtr);
+
+    // Create the SMACK rule.
+    char rule[SMACK_RULE_STR_BYTES];
+    MakeRuleStr(subjectLabelPtr, accessModePtr, objectLabelPtr, rule, sizeof(rule));
+
+    // Make room for the rule and its newline.
+    size_t ruleLength = strlen(rule);
+
+    if (batchPtr->len + ruleLength + 1 > sizeof(batchPtr->buf))
     {
-        fd = open(SMACK_LOAD_FILE, O_WRONLY);
+        smack_CommitRules(batchPtr);
     }
-    while ( (fd == -1) && (errno == EINTR) );
 
-    LE_FATAL_IF(fd == -1, "Could not open %s.  %m.\n", SMACK_LOAD_FILE);
+    memcpy(batchPtr->buf + batchPtr->len, rule, ruleLength);
+    batchPtr->len += ruleLength;
+    batchPtr->buf[batchPtr->len++] = '\n';
+    batchPtr->count++;
+}
 
-    // Write the rule to the SMACK load file.
-    int numBytes = 0;
-    size_t ruleLength = strlen(rule);
 
-    do
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the rules in a rule batch and empties the batch.  Does nothing if the batch is empty.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRules
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Rule batch.
+)
+{
+    if (batchPtr->count == 0)
     {
-        numBytes = write(fd, rule, ruleLength);
+        return;
     }
-    while ( (numBytes == -1) && (errno == EINTR) );
 
-    LE_FATAL_IF(numBytes != ruleLength, "Could not write SMACK rule '%s'.  %m.", rule);
+    LoadRules(batchPtr->buf, batchPtr->len);
 
-    fd_Close(fd);
+    LE_DEBUG("Set %zu SMACK rules.", batchPtr->count);
 
-    LE_DEBUG("Set SMACK rule '%s'.", rule);
+    batchPtr->len = 0;
+    batchPtr->count = 0;
 }
 
 
@@ -959,6 +1170,25 @@ void smack_SetMyLabel
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the SMACK label of the calling process, without logging or killing the calling process on
+ * error.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  errno is set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t smack_TrySetMyLabel
+(
+    const char* labelPtr            ///< [IN] Label to set the calling process to.
+)
+{
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get's a process's SMACK label.
@@ -1035,6 +1265,41 @@ void smack_SetRule
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a rule batch.  The access mode is the same as for smack_SetRule().
+ *
+ * If the batch is full, the rules already in it are loaded first.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRule
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Rule batch.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the rules in a rule batch and empties the batch.  Does nothing if the batch is empty.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRules
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Rule batch.
+)
+{
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks whether a subject has the specified access mode for an object.
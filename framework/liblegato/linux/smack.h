@@ -63,6 +63,11 @@
  * Use smack_SetRule() to set an explicit SMACK rule that gives a specified subject access to a
  * specified object.
  *
+ * To set many rules at once (e.g., when an app is started), add them to a rule batch with
+ * smack_AddRule() and load them with smack_CommitRules().  The batched rules are written to the
+ * kernel several at a time, which saves an open(), write() and close() per rule.  The rules in a
+ * batch are not in effect until the batch is committed.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -124,10 +129,29 @@ void smack_SetMyLabel
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the SMACK label of the calling process, without logging or killing the calling process on
+ * error.  The label is not validated.  Intended for a child process that is sharing its parent's
+ * memory between clone() and exec().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  errno is set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t smack_TrySetMyLabel
+(
+    const char* labelPtr            ///< [IN] Label to set the calling process to.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get's a process's SMACK label.
  *
+ * The calling process's own label is cached, so getting it again doesn't read the file system.
+ *
  * @return
  *      LE_OK if successful.
  *      LE_OVERFLOW if the supplied buffer is too small to hold the SMACK label.
@@ -206,6 +230,70 @@ void smack_SetRule
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a rule batch's buffer.  smackfs accepts up to a page, less one byte, per write().
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMACK_RULE_BATCH_BYTES      4095
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A batch of SMACK rules that haven't been loaded yet.  See @ref c_smack_setRules.
+ *
+ * Initialize with SMACK_RULE_BATCH_INIT.  A batch is usually declared on the stack by the function
+ * that sets the rules.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t  len;                            ///< Number of bytes used in the buffer.
+    size_t  count;                          ///< Number of rules in the buffer.
+    char    buf[SMACK_RULE_BATCH_BYTES];    ///< Newline-separated rules, in load2 format.
+}
+smack_RuleBatch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializer for an empty rule batch.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMACK_RULE_BATCH_INIT { .len = 0, .count = 0 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an explicit SMACK rule to a rule batch.  The access mode is the same as for smack_SetRule().
+ *
+ * If the batch is full, the rules already in it are loaded first.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_AddRule
+(
+    smack_RuleBatch_t* batchPtr,    ///< [IN] Rule batch.
+    const char* subjectLabelPtr,    ///< [IN] Subject label.
+    const char* accessModePtr,      ///< [IN] Access mode. See smack_SetRule() for details.
+    const char* objectLabelPtr      ///< [IN] Object label.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the rules in a rule batch and empties the batch.  Does nothing if the batch is empty.
+ *
+ * @note If there is an error this function will kill the calling process.
+ */
+//--------------------------------------------------------------------------------------------------
+void smack_CommitRules
+(
+    smack_RuleBatch_t* batchPtr     ///< [IN] Rule batch.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks whether a subject has the specified access mode for an object.
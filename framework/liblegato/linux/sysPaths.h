@@ -66,6 +66,16 @@
 //--------------------------------------------------------------------------------------------------
 #define CFG_TREE_PATH               CURRENT_SYSTEM_PATH"/config"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The locations of the read-only config snapshots published for apps: whole app trees, and the
+ * "system:/apps/<app>" subtrees.  They are kept in RAM, and republished when the framework starts.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_SNAPSHOT_PATH           "/tmp/legato/config"
+#define CFG_TREE_SNAPSHOT_PATH      CFG_SNAPSHOT_PATH"/trees"
+#define CFG_APP_SNAPSHOT_PATH       CFG_SNAPSHOT_PATH"/apps"
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -285,6 +285,24 @@ void thread_InitThread
 
     // Init the thread's timer resources
     timer_InitThread();
+
+    // Record where the thread's stack is, so the Inspect tool can report how much of it is used.
+    thread_Obj_t* threadPtr = pthread_getspecific(ThreadLocalDataKey);
+    pthread_attr_t attr;
+
+    if (pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+        void* stackPtr;
+        size_t stackSize;
+
+        if (pthread_attr_getstack(&attr, &stackPtr, &stackSize) == 0)
+        {
+            threadPtr->stackPtr = stackPtr;
+            threadPtr->stackSize = stackSize;
+        }
+
+        pthread_attr_destroy(&attr);
+    }
 }
 
 
@@ -429,6 +447,8 @@ static thread_Obj_t* CreateThread
     threadPtr->context = context;
     threadPtr->destructorList = LE_DLS_LIST_INIT;
     threadPtr->threadHandle = 0;
+    threadPtr->stackPtr = NULL;
+    threadPtr->stackSize = 0;
 
     memset(&threadPtr->mutexRec, 0, sizeof(threadPtr->mutexRec));
     memset(&threadPtr->semaphoreRec, 0, sizeof(threadPtr->semaphoreRec));
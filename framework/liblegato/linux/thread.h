@@ -59,6 +59,9 @@ typedef struct
     pthread_t               threadHandle;                   ///< The pthreads thread handle.
     le_thread_Ref_t         safeRef;                        ///< Safe reference for this object.
     timer_ThreadRec_t       timerRec[TIMER_TYPE_COUNT];     ///< The thread's timer records.
+    void*                   stackPtr;                       ///< Lowest address of the thread's
+                                                            ///  stack (NULL if not known).
+    size_t                  stackSize;                      ///< Size of the thread's stack.
 }
 thread_Obj_t;
 
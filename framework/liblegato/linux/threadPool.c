@@ -0,0 +1,527 @@
+/**
+ * @file threadPool.c
+ *
+ * Legato @ref c_threadPool implementation.
+ *
+ * Each pool is a <b> Thread Pool object </b>, allocated from the <b> Thread Pool Pool </b> and kept
+ * on the <b> Thread Pool List </b> (for the Inspect tool) until it is deleted.  It has a fixed list
+ * of <b> Worker objects </b>, each with its own worker thread and its own task queue (a
+ * doubly-linked list protected by a mutex).
+ *
+ * A worker takes tasks from the tail of its own queue (newest first) and, when its queue is empty,
+ * steals from the head of the other workers' queues (oldest first), so that the owner and the
+ * thieves work at opposite ends of a queue.  Tasks submitted by a worker of the pool go onto the
+ * tail of its own queue; others are spread over the workers in turn.
+ *
+ * The pool's mutex protects the number of queued tasks, which idle workers wait on through the
+ * pool's condition variable, and the statistics.  It is never held while a queue's mutex is held.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "threadPool.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;           ///< Used to link onto the pool's worker list.
+    ThreadPool_t*       poolPtr;        ///< The pool the worker belongs to.
+    le_thread_Ref_t     threadRef;      ///< The worker thread.
+    le_dls_List_t       taskQueue;      ///< Tasks queued to this worker.
+    pthread_mutex_t     queueMutex;     ///< Protects the task queue.
+}
+Worker_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Task object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t                   link;           ///< Used to link onto a worker's task queue.
+    le_threadPool_WorkFunc_t        workFunc;       ///< Function that does the work.
+    le_threadPool_CompletionFunc_t  completionFunc; ///< Called when done, or NULL.
+    void*                           contextPtr;     ///< Passed to both functions.
+    le_thread_Ref_t                 submitterRef;   ///< Thread to call the completion function on.
+}
+Task_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools from which Thread Pool, Worker and Task objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ThreadPoolPoolRef;
+static le_mem_PoolRef_t WorkerPoolRef;
+static le_mem_PoolRef_t TaskPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread Pool List, and the mutex that protects it.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t ThreadPoolList = LE_DLS_LIST_INIT;
+static pthread_mutex_t ThreadPoolListMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A counter that increments every time a change is made to the Thread Pool List.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ThreadPoolListChangeCount = 0;
+static size_t* ThreadPoolListChangeCountRef = &ThreadPoolListChangeCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the thread-local pointer to the worker object of the current thread (NULL if the thread
+ * isn't a worker).
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t CurrentWorkerKey;
+
+
+/// Longest suffix a worker's index adds to its pool's name to make the worker thread's name.
+#define WORKER_SUFFIX_LEN       (sizeof("-18446744073709551615") - 1)
+
+/// Longest part of the pool's name that is kept in its worker threads' names.
+#define WORKER_NAME_PREFIX_LEN  (LIMIT_MAX_THREAD_NAME_LEN - WORKER_SUFFIX_LEN)
+
+/// Lock and unlock a pool's mutex.
+#define LOCK_POOL(poolPtr)      LE_ASSERT(pthread_mutex_lock(&(poolPtr)->mutex) == 0)
+#define UNLOCK_POOL(poolPtr)    LE_ASSERT(pthread_mutex_unlock(&(poolPtr)->mutex) == 0)
+
+/// Lock and unlock a worker's queue mutex.
+#define LOCK_QUEUE(workerPtr)   LE_ASSERT(pthread_mutex_lock(&(workerPtr)->queueMutex) == 0)
+#define UNLOCK_QUEUE(workerPtr) LE_ASSERT(pthread_mutex_unlock(&(workerPtr)->queueMutex) == 0)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes the newest task from a worker's own queue.
+ *
+ * @return  The task, or NULL if the queue is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static Task_t* PopOwnTask
+(
+    Worker_t* workerPtr
+)
+{
+    LOCK_QUEUE(workerPtr);
+    le_dls_Link_t* linkPtr = le_dls_PopTail(&workerPtr->taskQueue);
+    UNLOCK_QUEUE(workerPtr);
+
+    return (linkPtr == NULL) ? NULL : CONTAINER_OF(linkPtr, Task_t, link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes the oldest task from the queue of another worker of the same pool, starting with the next
+ * worker in the list.
+ *
+ * @return  The task, or NULL if all the other queues are empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static Task_t* StealTask
+(
+    Worker_t* thiefPtr
+)
+{
+    le_dls_List_t* workerListPtr = &thiefPtr->poolPtr->workerList;
+    le_dls_Link_t* linkPtr = le_dls_PeekNext(workerListPtr, &thiefPtr->link);
+
+    for (;;)
+    {
+        if (linkPtr == NULL)
+        {
+            linkPtr = le_dls_Peek(workerListPtr);
+        }
+
+        if (linkPtr == &thiefPtr->link)
+        {
+            return NULL;
+        }
+
+        Worker_t* victimPtr = CONTAINER_OF(linkPtr, Worker_t, link);
+
+        LOCK_QUEUE(victimPtr);
+        le_dls_Link_t* taskLinkPtr = le_dls_Pop(&victimPtr->taskQueue);
+        UNLOCK_QUEUE(victimPtr);
+
+        if (taskLinkPtr != NULL)
+        {
+            return CONTAINER_OF(taskLinkPtr, Task_t, link);
+        }
+
+        linkPtr = le_dls_PeekNext(workerListPtr, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a task's completion function.  Queued to the thread that submitted the task.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallCompletion
+(
+    void* taskPtr,      ///< [IN] The task.
+    void* resultPtr     ///< [IN] Value returned by the task's work function.
+)
+{
+    Task_t* tPtr = taskPtr;
+
+    tPtr->completionFunc(tPtr->contextPtr, resultPtr);
+
+    le_mem_Release(tPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs a task and hands its result to its completion function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunTask
+(
+    Worker_t* workerPtr,
+    Task_t* taskPtr,
+    bool isStolen       ///< [IN] true if the task was taken from another worker's queue.
+)
+{
+    ThreadPool_t* poolPtr = workerPtr->poolPtr;
+
+    LOCK_POOL(poolPtr);
+    poolPtr->queuedCount--;
+    if (isStolen)
+    {
+        poolPtr->stolenCount++;
+    }
+    UNLOCK_POOL(poolPtr);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    void* resultPtr = taskPtr->workFunc(taskPtr->contextPtr);
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    if (taskPtr->completionFunc != NULL)
+    {
+        le_event_QueueFunctionToThread(taskPtr->submitterRef, CallCompletion, taskPtr, resultPtr);
+    }
+    else
+    {
+        le_mem_Release(taskPtr);
+    }
+
+    LOCK_POOL(poolPtr);
+    poolPtr->completedCount++;
+    poolPtr->busyTime = le_clk_Add(poolPtr->busyTime, elapsed);
+    UNLOCK_POOL(poolPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerMain
+(
+    void* contextPtr    ///< [IN] The worker object.
+)
+{
+    Worker_t* workerPtr = contextPtr;
+    ThreadPool_t* poolPtr = workerPtr->poolPtr;
+
+    LE_ASSERT(pthread_setspecific(CurrentWorkerKey, workerPtr) == 0);
+
+    for (;;)
+    {
+        Task_t* taskPtr = PopOwnTask(workerPtr);
+
+        if (taskPtr != NULL)
+        {
+            RunTask(workerPtr, taskPtr, false);
+            continue;
+        }
+
+        taskPtr = StealTask(workerPtr);
+
+        if (taskPtr != NULL)
+        {
+            RunTask(workerPtr, taskPtr, true);
+            continue;
+        }
+
+        // Nothing to do.  A task counted as queued may be on its way into a queue, or be taken by
+        // another worker that hasn't counted it yet, in which case just look again.
+        LOCK_POOL(poolPtr);
+
+        while ((poolPtr->queuedCount == 0) && !poolPtr->isStopping)
+        {
+            LE_ASSERT(pthread_cond_wait(&poolPtr->workAvailable, &poolPtr->mutex) == 0);
+        }
+
+        bool isDone = (poolPtr->queuedCount == 0);
+
+        UNLOCK_POOL(poolPtr);
+
+        if (isDone)
+        {
+            return NULL;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the thread pool list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* threadPool_GetPoolList
+(
+    void
+)
+{
+    return (&ThreadPoolList);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the thread pool list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** threadPool_GetPoolListChgCntRef
+(
+    void
+)
+{
+    return (&ThreadPoolListChangeCountRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread pool module.
+ *
+ * This function must be called exactly once at process start-up before any other thread pool
+ * module functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void threadPool_Init
+(
+    void
+)
+{
+    ThreadPoolPoolRef = le_mem_CreatePool("threadPool", sizeof(ThreadPool_t));
+    WorkerPoolRef = le_mem_CreatePool("threadPoolWorker", sizeof(Worker_t));
+    TaskPoolRef = le_mem_CreatePool("threadPoolTask", sizeof(Task_t));
+
+    LE_ASSERT(pthread_key_create(&CurrentWorkerKey, NULL) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a thread pool and starts its worker threads.
+ *
+ * @return  A reference to the thread pool.
+ *
+ * @note Terminates the process on failure, no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_threadPool_Ref_t le_threadPool_Create
+(
+    const char* name,       ///< [IN] Name of the pool (will be copied, so can be temporary).
+    size_t numWorkers       ///< [IN] Number of worker threads (at least 1).
+)
+{
+    LE_ASSERT(numWorkers > 0);
+
+    ThreadPool_t* poolPtr = le_mem_ForceAlloc(ThreadPoolPoolRef);
+    memset(poolPtr, 0, sizeof(*poolPtr));
+
+    poolPtr->poolLink = LE_DLS_LINK_INIT;
+    if (le_utf8_Copy(poolPtr->name, name, sizeof(poolPtr->name), NULL) == LE_OVERFLOW)
+    {
+        LE_WARN("Thread pool name '%s' truncated to '%s'.", name, poolPtr->name);
+    }
+    poolPtr->workerList = LE_DLS_LIST_INIT;
+    poolPtr->numWorkers = numWorkers;
+    LE_ASSERT(pthread_mutex_init(&poolPtr->mutex, NULL) == 0);
+    LE_ASSERT(pthread_cond_init(&poolPtr->workAvailable, NULL) == 0);
+
+    size_t i;
+    for (i = 0; i < numWorkers; i++)
+    {
+        Worker_t* workerPtr = le_mem_ForceAlloc(WorkerPoolRef);
+
+        workerPtr->link = LE_DLS_LINK_INIT;
+        workerPtr->poolPtr = poolPtr;
+        workerPtr->taskQueue = LE_DLS_LIST_INIT;
+        LE_ASSERT(pthread_mutex_init(&workerPtr->queueMutex, NULL) == 0);
+
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+        LE_ASSERT(snprintf(threadName,
+                           sizeof(threadName),
+                           "%.*s-%zu",
+                           (int)WORKER_NAME_PREFIX_LEN,
+                           poolPtr->name,
+                           i) < sizeof(threadName));
+
+        workerPtr->threadRef = le_thread_Create(threadName, WorkerMain, workerPtr);
+        le_thread_SetJoinable(workerPtr->threadRef);
+
+        le_dls_Queue(&poolPtr->workerList, &workerPtr->link);
+    }
+
+    poolPtr->nextWorkerLinkPtr = le_dls_Peek(&poolPtr->workerList);
+
+    // The worker list must be complete before any worker starts stealing from it.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&poolPtr->workerList);
+    while (linkPtr != NULL)
+    {
+        le_thread_Start(CONTAINER_OF(linkPtr, Worker_t, link)->threadRef);
+        linkPtr = le_dls_PeekNext(&poolPtr->workerList, linkPtr);
+    }
+
+    LE_ASSERT(pthread_mutex_lock(&ThreadPoolListMutex) == 0);
+    le_dls_Queue(&ThreadPoolList, &poolPtr->poolLink);
+    ThreadPoolListChangeCount++;
+    LE_ASSERT(pthread_mutex_unlock(&ThreadPoolListMutex) == 0);
+
+    return poolPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submits a task to a thread pool.
+ *
+ * If a completion function is given, the calling thread must be running an event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Submit
+(
+    le_threadPool_Ref_t poolRef,                    ///< [IN] The thread pool.
+    le_threadPool_WorkFunc_t workFunc,              ///< [IN] Function that does the work.
+    le_threadPool_CompletionFunc_t completionFunc,  ///< [IN] Function to call on the calling
+                                                    ///<      thread when done, or NULL.
+    void* contextPtr                                ///< [IN] Passed to both functions.
+)
+{
+    LE_ASSERT(poolRef != NULL);
+    LE_ASSERT(workFunc != NULL);
+
+    Task_t* taskPtr = le_mem_ForceAlloc(TaskPoolRef);
+
+    taskPtr->link = LE_DLS_LINK_INIT;
+    taskPtr->workFunc = workFunc;
+    taskPtr->completionFunc = completionFunc;
+    taskPtr->contextPtr = contextPtr;
+    taskPtr->submitterRef = (completionFunc != NULL) ? le_thread_GetCurrent() : NULL;
+
+    // A worker of this pool keeps its own tasks; anyone else's go to the workers in turn.
+    Worker_t* workerPtr = pthread_getspecific(CurrentWorkerKey);
+
+    LOCK_POOL(poolRef);
+
+    LE_FATAL_IF(poolRef->isStopping, "Task submitted to thread pool '%s' while deleting it.",
+                poolRef->name);
+
+    if ((workerPtr == NULL) || (workerPtr->poolPtr != poolRef))
+    {
+        workerPtr = CONTAINER_OF(poolRef->nextWorkerLinkPtr, Worker_t, link);
+
+        poolRef->nextWorkerLinkPtr = le_dls_PeekNext(&poolRef->workerList,
+                                                     poolRef->nextWorkerLinkPtr);
+        if (poolRef->nextWorkerLinkPtr == NULL)
+        {
+            poolRef->nextWorkerLinkPtr = le_dls_Peek(&poolRef->workerList);
+        }
+    }
+
+    // Count the task before queuing it, so that the count never drops below zero when a worker
+    // takes it.
+    poolRef->submittedCount++;
+    poolRef->queuedCount++;
+    if (poolRef->queuedCount > poolRef->maxQueuedCount)
+    {
+        poolRef->maxQueuedCount = poolRef->queuedCount;
+    }
+
+    UNLOCK_POOL(poolRef);
+
+    LOCK_QUEUE(workerPtr);
+    le_dls_Queue(&workerPtr->taskQueue, &taskPtr->link);
+    UNLOCK_QUEUE(workerPtr);
+
+    LE_ASSERT(pthread_cond_signal(&poolRef->workAvailable) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a thread pool once the tasks already submitted to it have run.  Blocks until its worker
+ * threads have stopped.
+ *
+ * @warning Must not be called by one of the pool's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_threadPool_Delete
+(
+    le_threadPool_Ref_t poolRef     ///< [IN] The thread pool.
+)
+{
+    LE_ASSERT(poolRef != NULL);
+
+    Worker_t* currentWorkerPtr = pthread_getspecific(CurrentWorkerKey);
+    LE_FATAL_IF((currentWorkerPtr != NULL) && (currentWorkerPtr->poolPtr == poolRef),
+                "Thread pool '%s' deleted by one of its own workers.", poolRef->name);
+
+    LOCK_POOL(poolRef);
+    poolRef->isStopping = true;
+    LE_ASSERT(pthread_cond_broadcast(&poolRef->workAvailable) == 0);
+    UNLOCK_POOL(poolRef);
+
+    // The workers still running walk the worker list, so only take it apart once they all stopped.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&poolRef->workerList);
+    while (linkPtr != NULL)
+    {
+        LE_ASSERT(le_thread_Join(CONTAINER_OF(linkPtr, Worker_t, link)->threadRef, NULL) == LE_OK);
+        linkPtr = le_dls_PeekNext(&poolRef->workerList, linkPtr);
+    }
+
+    while ((linkPtr = le_dls_Pop(&poolRef->workerList)) != NULL)
+    {
+        Worker_t* workerPtr = CONTAINER_OF(linkPtr, Worker_t, link);
+
+        pthread_mutex_destroy(&workerPtr->queueMutex);
+        le_mem_Release(workerPtr);
+    }
+
+    LE_ASSERT(pthread_mutex_lock(&ThreadPoolListMutex) == 0);
+    le_dls_Remove(&ThreadPoolList, &poolRef->poolLink);
+    ThreadPoolListChangeCount++;
+    LE_ASSERT(pthread_mutex_unlock(&ThreadPoolListMutex) == 0);
+
+    pthread_cond_destroy(&poolRef->workAvailable);
+    pthread_mutex_destroy(&poolRef->mutex);
+    le_mem_Release(poolRef);
+}
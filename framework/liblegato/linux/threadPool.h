@@ -0,0 +1,81 @@
+/**
+ * @file threadPool.h
+ *
+ * Thread pool module's intra-framework header file.  This file exposes type definitions and
+ * function interfaces to other modules inside the framework implementation, and to the Inspect
+ * tool.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_THREAD_POOL_H_INCLUDE_GUARD
+#define LEGATO_SRC_THREAD_POOL_H_INCLUDE_GUARD
+
+#include "limit.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread pool object.
+ *
+ * The counters are protected by the pool's mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_threadPool
+{
+    le_dls_Link_t       poolLink;           ///< Used to link onto the process's Thread Pool List.
+    char                name[LIMIT_MAX_THREAD_POOL_NAME_BYTES]; ///< Name of the pool.
+    le_dls_List_t       workerList;         ///< The pool's workers (fixed once created).
+    le_dls_Link_t*      nextWorkerLinkPtr;  ///< Worker to give the next outside task to.
+    pthread_mutex_t     mutex;              ///< Protects the counters and the stopping flag.
+    pthread_cond_t      workAvailable;      ///< Signalled when a task is queued or when stopping.
+    bool                isStopping;         ///< true once the pool is being deleted.
+    size_t              numWorkers;         ///< Number of worker threads.
+    size_t              queuedCount;        ///< Number of tasks waiting in the workers' queues.
+    size_t              maxQueuedCount;     ///< Largest number of tasks that have been waiting.
+    uint64_t            submittedCount;     ///< Number of tasks submitted.
+    uint64_t            completedCount;     ///< Number of tasks run.
+    uint64_t            stolenCount;        ///< Number of tasks run by another worker than the
+                                            ///< one they were queued to.
+    le_clk_Time_t       busyTime;           ///< Total time the workers have spent running tasks.
+}
+ThreadPool_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the thread pool list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* threadPool_GetPoolList
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the thread pool list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** threadPool_GetPoolListChgCntRef
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the thread pool module.
+ *
+ * This function must be called exactly once at process start-up before any other thread pool
+ * module functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void threadPool_Init
+(
+    void
+);
+
+
+#endif /* LEGATO_SRC_THREAD_POOL_H_INCLUDE_GUARD */
@@ -16,6 +16,7 @@
 
 // Include macros for printing out values
 #include "le_print.h"
+#include "tracepoint.h"
 
 
 #define DEFAULT_POOL_NAME "Default Timer Pool"
@@ -119,7 +120,10 @@ static Timer_t* CreateTimer
     timerPtr->interval = (le_clk_Time_t){0, 0};
     timerPtr->repeatCount = 1;
     timerPtr->contextPtr = NULL;
+    timerPtr->slack = (le_clk_Time_t){0, 0};
     timerPtr->link = LE_DLS_LINK_INIT;
+    timerPtr->expiryNode = (timer_HeapNode_t){ 0 };
+    timerPtr->deadlineNode = (timer_HeapNode_t){ 0 };
     timerPtr->isActive = false;
     timerPtr->expiryTime = (le_clk_Time_t){0, 0};
     timerPtr->expiryCount = 0;
@@ -133,108 +137,241 @@ static Timer_t* CreateTimer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the timer record to the given list, sorted according to the timer value
+ * Check whether a timer heap node comes before another one.  Nodes with equal times are ordered
+ * by the order in which they were added.
+ *
+ * @return true if the first node comes first.
  */
 //--------------------------------------------------------------------------------------------------
-static void AddToTimerList
+static inline bool IsEarlier
 (
-    le_dls_List_t* listPtr,               ///< [IN] The list to add to.
-    Timer_t* newTimerPtr                  ///< [IN] The timer to add
+    timer_HeapNode_t* firstNodePtr,     ///< [IN] The first node.
+    timer_HeapNode_t* secondNodePtr     ///< [IN] The second node.
 )
 {
-    Timer_t* timerPtr;
-    le_dls_Link_t* linkPtr;
-
-    if ( newTimerPtr->isActive )
+    if (le_clk_Equal(firstNodePtr->time, secondNodePtr->time))
     {
-        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
-        return;
+        return (firstNodePtr->seqNum < secondNodePtr->seqNum);
     }
 
-    // Get the start of the list
-    linkPtr = le_dls_Peek(listPtr);
-
-    // Find the timer whose expiry time is greater than the new timer.
-    while ( linkPtr != NULL )
-    {
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+    return le_clk_GreaterThan(secondNodePtr->time, firstNodePtr->time);
+}
 
-        if ( le_clk_GreaterThan(timerPtr->expiryTime, newTimerPtr->expiryTime) )
-            break;
 
-        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Meld two timer heaps into one.
+ *
+ * The roots of both heaps must not have any siblings.
+ *
+ * @return:
+ *      - root of the melded heap
+ *      - NULL if both heaps are empty
+ */
+//--------------------------------------------------------------------------------------------------
+static timer_HeapNode_t* MeldHeaps
+(
+    timer_HeapNode_t* firstRootPtr,     ///< [IN] Root of the first heap (can be NULL).
+    timer_HeapNode_t* secondRootPtr     ///< [IN] Root of the second heap (can be NULL).
+)
+{
+    if (firstRootPtr == NULL)
+    {
+        return secondRootPtr;
+    }
+    if (secondRootPtr == NULL)
+    {
+        return firstRootPtr;
     }
 
-    TimerListChangeCount++;
-    if (linkPtr == NULL)
+    // The earlier root stays the root, and the other one becomes its first child.
+    if (IsEarlier(secondRootPtr, firstRootPtr))
     {
-        // The list is either empty, or the new timer has the largest expiry time.
-        // In either case, add the new timer to the end of the list.
-        le_dls_Queue(listPtr, &newTimerPtr->link);
+        timer_HeapNode_t* tempPtr = firstRootPtr;
+        firstRootPtr = secondRootPtr;
+        secondRootPtr = tempPtr;
     }
-    else
+
+    secondRootPtr->prevPtr = firstRootPtr;
+    secondRootPtr->nextPtr = firstRootPtr->childPtr;
+    if (firstRootPtr->childPtr != NULL)
     {
-        // Found a timer with larger expiry time; insert the new timer before it.
-        le_dls_AddBefore(listPtr, linkPtr, &newTimerPtr->link);
+        firstRootPtr->childPtr->prevPtr = secondRootPtr;
     }
+    firstRootPtr->childPtr = secondRootPtr;
 
-    // The new timer is now on the active list
-    newTimerPtr->isActive = true;
+    return firstRootPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Peek at the first timer from the given timer list
+ * Meld a list of sibling heaps into one, using the standard two-pass pairing: siblings are first
+ * melded in pairs from left to right, and the results are then melded from right to left.
  *
  * @return:
- *      - pointer to the first timer on the list
+ *      - root of the melded heap
  *      - NULL if the list is empty
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PeekFromTimerList
+static timer_HeapNode_t* MeldSiblings
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_HeapNode_t* firstSiblingPtr   ///< [IN] First heap on the list of siblings (can be NULL).
 )
 {
-    le_dls_Link_t* linkPtr;
+    // First pass.  The melded pairs are kept on a temporary list, in reverse order.
+    timer_HeapNode_t* pairListPtr = NULL;
 
-    linkPtr = le_dls_Peek(listPtr);
-    if (linkPtr != NULL)
+    while (firstSiblingPtr != NULL)
     {
-        return ( CONTAINER_OF(linkPtr, Timer_t, link) );
+        timer_HeapNode_t* firstPtr = firstSiblingPtr;
+        timer_HeapNode_t* secondPtr = firstPtr->nextPtr;
+
+        firstSiblingPtr = (secondPtr != NULL) ? secondPtr->nextPtr : NULL;
+
+        firstPtr->prevPtr = NULL;
+        firstPtr->nextPtr = NULL;
+        if (secondPtr != NULL)
+        {
+            secondPtr->prevPtr = NULL;
+            secondPtr->nextPtr = NULL;
+        }
+
+        timer_HeapNode_t* pairPtr = MeldHeaps(firstPtr, secondPtr);
+        pairPtr->nextPtr = pairListPtr;
+        pairListPtr = pairPtr;
     }
-    return NULL;
+
+    // Second pass.
+    timer_HeapNode_t* rootPtr = NULL;
+
+    while (pairListPtr != NULL)
+    {
+        timer_HeapNode_t* pairPtr = pairListPtr;
+        pairListPtr = pairPtr->nextPtr;
+
+        pairPtr->nextPtr = NULL;
+        rootPtr = MeldHeaps(rootPtr, pairPtr);
+    }
+
+    return rootPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pop the first timer from the given timer list
- *
- * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ * Add a node to a timer heap.
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PopFromTimerList
+static void AddToHeap
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_HeapNode_t** rootPtrPtr,      ///< [IN,OUT] Root of the heap.
+    timer_HeapNode_t* nodePtr,          ///< [IN] The node to add.
+    le_clk_Time_t time,                 ///< [IN] Time to order the node by.
+    uint64_t seqNum                     ///< [IN] Sequence number of the node.
 )
 {
-    le_dls_Link_t* linkPtr;
-    Timer_t* timerPtr;
+    nodePtr->childPtr = NULL;
+    nodePtr->nextPtr = NULL;
+    nodePtr->prevPtr = NULL;
+    nodePtr->time = time;
+    nodePtr->seqNum = seqNum;
+
+    *rootPtrPtr = MeldHeaps(*rootPtrPtr, nodePtr);
+}
 
-    linkPtr = le_dls_Pop(listPtr);
-    if (linkPtr != NULL)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a node from a timer heap.  Its children are melded together, and then back into the
+ * rest of the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFromHeap
+(
+    timer_HeapNode_t** rootPtrPtr,      ///< [IN,OUT] Root of the heap.
+    timer_HeapNode_t* nodePtr           ///< [IN] The node to remove.
+)
+{
+    timer_HeapNode_t* childrenPtr = MeldSiblings(nodePtr->childPtr);
+
+    if (nodePtr == *rootPtrPtr)
     {
-        TimerListChangeCount++;
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+        *rootPtrPtr = childrenPtr;
+    }
+    else
+    {
+        if (nodePtr->prevPtr->childPtr == nodePtr)
+        {
+            nodePtr->prevPtr->childPtr = nodePtr->nextPtr;
+        }
+        else
+        {
+            nodePtr->prevPtr->nextPtr = nodePtr->nextPtr;
+        }
+        if (nodePtr->nextPtr != NULL)
+        {
+            nodePtr->nextPtr->prevPtr = nodePtr->prevPtr;
+        }
 
-        // The timer is no longer on the active list
-        timerPtr->isActive = false;
+        *rootPtrPtr = MeldHeaps(*rootPtrPtr, childrenPtr);
+    }
+
+    nodePtr->childPtr = NULL;
+    nodePtr->nextPtr = NULL;
+    nodePtr->prevPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the timer record to the given thread's active timers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToTimerList
+(
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread timer record to add to.
+    Timer_t* newTimerPtr                  ///< [IN] The timer to add
+)
+{
+    if ( newTimerPtr->isActive )
+    {
+        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
+        return;
+    }
+
+    TimerListChangeCount++;
+    le_dls_Queue(&threadRecPtr->activeTimerList, &newTimerPtr->link);
+
+    uint64_t seqNum = threadRecPtr->nextSeqNum++;
+
+    AddToHeap(&threadRecPtr->expiryHeapPtr, &newTimerPtr->expiryNode,
+              newTimerPtr->expiryTime, seqNum);
+    AddToHeap(&threadRecPtr->deadlineHeapPtr, &newTimerPtr->deadlineNode,
+              le_clk_Add(newTimerPtr->expiryTime, newTimerPtr->slack), seqNum);
 
-        return timerPtr;
+    // The new timer is now on the active list
+    newTimerPtr->isActive = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Peek at the first timer to expire from the given thread's active timers.
+ *
+ * @return:
+ *      - pointer to the first timer
+ *      - NULL if there are no active timers
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PeekFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread timer record to look at.
+)
+{
+    if (threadRecPtr->expiryHeapPtr != NULL)
+    {
+        return CONTAINER_OF(threadRecPtr->expiryHeapPtr, Timer_t, expiryNode);
     }
     return NULL;
 }
@@ -242,19 +379,48 @@ static Timer_t* PopFromTimerList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove the timer from the given timer list
+ * Remove the timer from the given thread's active timers.
  */
 //--------------------------------------------------------------------------------------------------
 static void RemoveFromTimerList
 (
-    le_dls_List_t* listPtr,             ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread timer record to remove from.
     Timer_t* timerPtr                   ///< [IN] The timer to remove
 )
 {
     // Remove the timer from the active list
     timerPtr->isActive = false;
     TimerListChangeCount++;
-    le_dls_Remove(listPtr, &timerPtr->link);
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+
+    RemoveFromHeap(&threadRecPtr->expiryHeapPtr, &timerPtr->expiryNode);
+    RemoveFromHeap(&threadRecPtr->deadlineHeapPtr, &timerPtr->deadlineNode);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop the first timer to expire from the given thread's active timers.
+ *
+ * @return:
+ *      - pointer to the first timer
+ *      - NULL if there are no active timers
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PopFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread timer record to look at.
+)
+{
+    Timer_t* timerPtr = PeekFromTimerList(threadRecPtr);
+
+    if (timerPtr != NULL)
+    {
+        // The timer is no longer on the active list
+        RemoveFromTimerList(threadRecPtr, timerPtr);
+    }
+
+    return timerPtr;
 }
 
 
@@ -331,18 +497,17 @@ static timer_ThreadRec_t* GetThreadTimerRec
 //--------------------------------------------------------------------------------------------------
 static void RestartTimerFD
 (
-    Timer_t* timerPtr      ///< [IN] (Re)start this timer object
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread timer record.
+    le_clk_Time_t expiryTime            ///< [IN] Time at which the timerFD should expire.
 )
 {
-    timer_ThreadRec_t* threadRecPtr = GetThreadTimerRec(timerPtr);
-
     struct itimerspec timerInterval;
 
-    // Set the timer to expire at the expiry time of the given timer
+    // Set the timer to expire at the given time.
     // There is a small possibility that the time set now will be slightly in the past
     // at this point but it will just cause the timerfd to expire immediately.
-    timerInterval.it_value.tv_sec = timerPtr->expiryTime.sec;
-    timerInterval.it_value.tv_nsec = timerPtr->expiryTime.usec * 1000;
+    timerInterval.it_value.tv_sec = expiryTime.sec;
+    timerInterval.it_value.tv_nsec = expiryTime.usec * 1000;
 
     // The timerFD does not repeat
     timerInterval.it_interval.tv_sec = 0;
@@ -355,10 +520,14 @@ static void RestartTimerFD
         LE_FATAL("timerfd_settime() failed with errno = %d (%m)", errno);
     }
 
-    TRACE("timer '%s' started", timerPtr->name);
+    TRACE("timerFD=%i started, expiring at %li.%06li",
+          threadRecPtr->timerFD,
+          (long)expiryTime.sec,
+          (long)expiryTime.usec);
 
-    // Store the timer for future reference
-    threadRecPtr->firstTimerPtr = timerPtr;
+    // Store the time for future reference
+    threadRecPtr->isTimerFdRunning = true;
+    threadRecPtr->timerFdTime = expiryTime;
 }
 
 
@@ -390,7 +559,41 @@ static void StopTimerFD
     TRACE("timerFD=%i stopped", threadRecPtr->timerFD);
 
     // There is no active timer
-    threadRecPtr->firstTimerPtr = NULL;
+    threadRecPtr->isTimerFdRunning = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure the timerFD is running until the earliest deadline of the active timers, or stopped
+ * if there are no active timers.  The timerFD is only (re)started if that deadline has changed.
+ *
+ * Expiring at the earliest deadline, rather than at the earliest expiry time, lets a single
+ * timerFD expiry handle all the timers that are due by then.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateTimerFD
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread timer record.
+)
+{
+    if (threadRecPtr->deadlineHeapPtr == NULL)
+    {
+        if (threadRecPtr->isTimerFdRunning)
+        {
+            StopTimerFD(threadRecPtr);
+        }
+    }
+    else
+    {
+        le_clk_Time_t deadline = threadRecPtr->deadlineHeapPtr->time;
+
+        if ( !threadRecPtr->isTimerFdRunning ||
+             !le_clk_Equal(threadRecPtr->timerFdTime, deadline) )
+        {
+            RestartTimerFD(threadRecPtr, deadline);
+        }
+    }
 }
 
 
@@ -410,21 +613,11 @@ static void RunTimer
 
     timer_ThreadRec_t* threadRecPtr = GetThreadTimerRec(timerPtr);
 
-    Timer_t* firstTimerPtr;
-
-    AddToTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    AddToTimerList(threadRecPtr, timerPtr);
     //PrintTimerList(&threadRecPtr->activeTimerList);
 
-    // Get the first timer from the active list. This is needed to determine whether the timerFD
-    // needs to be restarted, in case the new timer was put at the beginning of the list.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-
-    // If the timerFD is not running, or it is running a timer that is no longer at the beginning
-    // of the active list, then (re)start the timerFD.
-    if ( (NULL != firstTimerPtr) && (threadRecPtr->firstTimerPtr != firstTimerPtr) )
-    {
-        RestartTimerFD(firstTimerPtr);
-    }
+    // If the new timer has the earliest deadline, the timerFD needs to be restarted.
+    UpdateTimerFD(threadRecPtr);
 }
 
 
@@ -442,25 +635,11 @@ static void StopTimer
 {
     timer_ThreadRec_t* threadRecPtr = GetThreadTimerRec(timerPtr);
 
-    RemoveFromTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    RemoveFromTimerList(threadRecPtr, timerPtr);
 
-    // If the timer was at the start of the active list, then restart the timerFD using the next
-    // timer on the active list, if any.  Otherwise, stop the timerFD.
-    if (timerPtr == threadRecPtr->firstTimerPtr)
-    {
-        TRACE("Stopping the first active timer");
-        threadRecPtr->firstTimerPtr = NULL;
-
-        Timer_t* firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-        if (firstTimerPtr != NULL)
-        {
-            RestartTimerFD(firstTimerPtr);
-        }
-        else
-        {
-            StopTimerFD(threadRecPtr);
-        }
-    }
+    // If the timer had the earliest deadline, then restart the timerFD using the next deadline,
+    // if any.  Otherwise, stop the timerFD.
+    UpdateTimerFD(threadRecPtr);
 }
 
 
@@ -497,14 +676,16 @@ static void ProcessExpiredTimer
         expiredTimer->expiryTime = le_clk_Add(expiredTimer->expiryTime, expiredTimer->interval);
 
         // Add the timer back to the timer list
-        AddToTimerList(&threadRecPtr->activeTimerList, expiredTimer);
+        AddToTimerList(threadRecPtr, expiredTimer);
         //PrintTimerList(&threadRecPtr->activeTimerList);
     }
 
     // call the optional expiry handler function
     if ( expiredTimer->handlerRef != NULL )
     {
+        TRACEPOINT_BEGIN("timer %s", expiredTimer->name);
         expiredTimer->handlerRef(expiredTimer->safeRef);
+        TRACEPOINT_END();
     }
 }
 
@@ -549,52 +730,37 @@ static void TimerFdHandler
     LE_ERROR_IF(numBytes != 8, "On TimerFD read, unexpected numBytes=%zd", numBytes);
     LE_ERROR_IF(expiry != 1,  "On TimerFD read, unexpected expiry=%u", (unsigned int)expiry);
 
-    // Pop off the first timer from the active list, and make sure it is the expected timer.
-    firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
-    LE_ASSERT( NULL != firstTimerPtr);
-
-    LE_ASSERT( threadRecPtr->firstTimerPtr == firstTimerPtr );
+    // The timerFD is no longer running.  This must be noted before processing the expired timers,
+    // in case one of them is started again with the same deadline.
+    threadRecPtr->isTimerFdRunning = false;
 
-    // Need to reset the expected timer, in case processing the current timer will cause the same
-    // timer to be started again, and put back at the start of the active list. This is necessary
-    // since the timerFD is no longer running, so there is no timer associated with it.
-    threadRecPtr->firstTimerPtr = NULL;
+    // Pop off the first timer from the active list.  It is always due, because the timerFD is
+    // only ever run until the deadline of an active timer, which is never earlier than the
+    // expiry time of the first timer.
+    firstTimerPtr = PopFromTimerList(threadRecPtr);
+    LE_ASSERT( NULL != firstTimerPtr);
 
-    // It is the expected timer so process it.
     ProcessExpiredTimer(firstTimerPtr);
 
     // Check if there are any other timers that have since expired, pop them off the
-    // list and process them.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    // list and process them.  This includes timers that are due before their deadlines, so that
+    // they are handled by this timerFD expiry.
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     while ( firstTimerPtr != NULL &&
             le_clk_GreaterThan(clk_GetRelativeTime(firstTimerPtr->isWakeupEnabled),
                                firstTimerPtr->expiryTime) )
     {
         // Pop off the timer and process it
-        firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PopFromTimerList(threadRecPtr);
         ProcessExpiredTimer(firstTimerPtr);
 
         // Try the next timer on the list
-        firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-    }
-
-    // While processing expired timers in the above loop, it is possible that a timer was started,
-    // put in the active list, and expired before the loop completed. If the active list is empty,
-    // but the timerFD is still running, then we need to stop it.
-    if ( (firstTimerPtr == NULL) && ( threadRecPtr->firstTimerPtr != NULL ) )
-    {
-        StopTimerFD(threadRecPtr);
+        firstTimerPtr = PeekFromTimerList(threadRecPtr);
     }
 
-    // If the next timer on the active list exists, then if the timerFD is not running, or it is
-    // running a timer that is no longer at the beginning of the active list, then (re)start the
-    // timerFD.  The timerFD could be running here, if the expiry handler started a new timer,
-    // although it might no longer be at the beginning of the list, if we had multiple timers
-    // expire, and one of them is a repetitive timer.
-    if ( (firstTimerPtr != NULL) && ( threadRecPtr->firstTimerPtr != firstTimerPtr ) )
-    {
-        RestartTimerFD(firstTimerPtr);
-    }
+    // (Re)start the timerFD for the next deadline, or stop it if there are no more active timers.
+    // The timerFD could be running here, if an expiry handler started a new timer.
+    UpdateTimerFD(threadRecPtr);
 }
 
 // =============================================
@@ -696,7 +862,10 @@ void timer_InitThread
 
         recPtr->timerFD = -1;
         recPtr->activeTimerList = LE_DLS_LIST_INIT;
-        recPtr->firstTimerPtr = NULL;
+        recPtr->expiryHeapPtr = NULL;
+        recPtr->deadlineHeapPtr = NULL;
+        recPtr->nextSeqNum = 0;
+        recPtr->isTimerFdRunning = false;
     }
 }
 
@@ -754,6 +923,9 @@ void timer_DestructThread
 
             le_mem_Release(timerPtr);
         }
+
+        threadRecPtr->expiryHeapPtr = NULL;
+        threadRecPtr->deadlineHeapPtr = NULL;
     }
 }
 
@@ -1009,6 +1181,66 @@ le_result_t le_timer_SetRepeat
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, so that its expiry can be handled together with
+ * other timers.  The default is no slack.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetSlack
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set slack for this timer object
+    le_clk_Time_t slack          ///< [IN] Maximum time by which the expiry can be delayed
+)
+{
+    Timer_t* timerPtr = le_ref_Lookup(SafeRefMap, timerRef);
+    LE_FATAL_IF(NULL == timerPtr, "Invalid timer reference %p.", timerRef);
+
+    if ( timerPtr->isActive )
+    {
+        return LE_BUSY;
+    }
+
+    timerPtr->slack = slack;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, in milliseconds.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsSlack
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set slack for this timer object
+    uint32_t slack               ///< [IN] Maximum time by which the expiry can be delayed (ms)
+)
+{
+    time_t seconds = slack / 1000;
+    le_clk_Time_t timeStruct;
+    timeStruct.sec = seconds;
+    timeStruct.usec = (slack - (seconds * 1000)) * 1000;
+
+    return le_timer_SetSlack(timerRef, timeStruct);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Configure if timer expiry will wake up a suspended system.
@@ -1258,7 +1490,7 @@ le_result_t le_timer_Start
         }
 
         LE_PRINT_VALUE("%i", threadRecPtr->timerFD);
-        threadRecPtr->firstTimerPtr = NULL;
+        threadRecPtr->isTimerFdRunning = false;
 
         // Register the timerFD with the event loop.
         // It will not be triggered until the timer is actually started
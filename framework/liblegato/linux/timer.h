@@ -26,6 +26,23 @@ typedef enum
 timer_Type_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of a timer heap.  Timer heaps are pairing heaps, ordered by the time in their nodes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timer_HeapNode
+{
+    struct timer_HeapNode* childPtr;         ///< First child
+    struct timer_HeapNode* nextPtr;          ///< Next sibling
+    struct timer_HeapNode* prevPtr;          ///< Previous sibling, or parent if first child
+    le_clk_Time_t time;                      ///< Time that the heap is ordered by
+    uint64_t seqNum;                         ///< Order in which the nodes were added, used to
+                                             ///  order nodes with equal times
+}
+timer_HeapNode_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Timer object.  Created by le_timer_Create().
@@ -39,9 +56,13 @@ typedef struct
     le_clk_Time_t interval;                  ///< Interval
     uint32_t repeatCount;                    ///< Number of times the timer will repeat
     void* contextPtr;                        ///< Context for timer expiry
+    le_clk_Time_t slack;                     ///< How late the timer is allowed to expire
 
     // Internal State
     le_dls_Link_t link;                      ///< For adding to the timer list
+    timer_HeapNode_t expiryNode;             ///< For adding to the heap ordered by expiry time
+    timer_HeapNode_t deadlineNode;           ///< For adding to the heap ordered by deadline
+                                             ///  (expiry time plus slack)
     bool isActive;                           ///< Is the timer active/running?
     le_clk_Time_t expiryTime;                ///< Time at which the timer should expire
     uint32_t expiryCount;                    ///< Number of times the counter has expired
@@ -67,10 +88,15 @@ typedef struct
 {
     int timerFD;                        ///< System timer used by the thread.
     le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread
-    Timer_t* firstTimerPtr;             ///< Pointer to the timer on the active list that is
-                                        ///  associated with the currently running timerFD,
-                                        ///  or NULL if there are no timers on the active list.
-                                        ///  This is normally the first timer on the list.
+                                        ///  (in no particular order).
+    timer_HeapNode_t* expiryHeapPtr;    ///< Heap of running timers ordered by expiry time.
+                                        ///  The root is the next timer to expire.
+    timer_HeapNode_t* deadlineHeapPtr;  ///< Heap of running timers ordered by deadline (the
+                                        ///  latest time they may expire).  The timerFD is run
+                                        ///  until the root's deadline.
+    uint64_t nextSeqNum;                ///< Sequence number to give to the next started timer.
+    bool isTimerFdRunning;              ///< Is the timerFD running?
+    le_clk_Time_t timerFdTime;          ///< Time the timerFD is running until, if it is running.
 
 }
 timer_ThreadRec_t;
@@ -0,0 +1,267 @@
+/** @file tracepoint.c
+ *
+ * Implementation of the framework's static tracepoints.  See tracepoint.h.
+ *
+ * Every tracepoint is a single write() to the ftrace trace_marker file, which the kernel
+ * time-stamps and stores in its trace buffer.  A single write is atomic, so tracepoints written by
+ * different threads and processes never get mixed up.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "tracepoint.h"
+
+#include <pthread.h>
+
+
+/// Largest tracepoint written, including the newline.  Longer names are truncated.
+#define MAX_TRACEPOINT_BYTES    256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths at which the trace_marker file can be found, depending on where tracefs is mounted.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const TraceMarkerPaths[] =
+{
+    "/sys/kernel/tracing/trace_marker",
+    "/sys/kernel/debug/tracing/trace_marker"
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File descriptor of the trace_marker file, or -1 if it couldn't be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+static int TraceMarkerFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to open the trace_marker file the first time a tracepoint is hit.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_once_t OpenOnce = PTHREAD_ONCE_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens the trace_marker file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenTraceMarker
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(TraceMarkerPaths); i++)
+    {
+        TraceMarkerFd = open(TraceMarkerPaths[i], O_WRONLY | O_CLOEXEC);
+        if (TraceMarkerFd >= 0)
+        {
+            return;
+        }
+    }
+
+    // Can't log here, as this may be called by the logging code itself; just stay disabled.
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a tracepoint to the trace_marker file: the type and the process ID, then the name (if
+ * any), then the suffix (if any).
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteTracepoint
+(
+    char type,              ///< [IN] atrace event type.
+    const char* name,       ///< [IN] Name of the slice or counter, or NULL if none.
+    const char* suffix      ///< [IN] Text to put after the name, or NULL if none.
+)
+{
+    if (TraceMarkerFd < 0)
+    {
+        return;
+    }
+
+    char buffer[MAX_TRACEPOINT_BYTES];
+
+    int len = snprintf(buffer, sizeof(buffer), "%c|%d%s%s%s\n",
+                       type,
+                       getpid(),
+                       (name != NULL) ? "|" : "",
+                       (name != NULL) ? name : "",
+                       (suffix != NULL) ? suffix : "");
+
+    if (len >= (int)sizeof(buffer))
+    {
+        // Truncated; still end with a newline.
+        len = sizeof(buffer) - 1;
+        buffer[len - 1] = '\n';
+    }
+
+    // Errors are ignored: a tracepoint must never disturb the code it is in.
+    if (write(TraceMarkerFd, buffer, len) < 0)
+    {
+        return;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats the name of a slice or counter.
+ *
+ * @return  false if tracepoints can't be written, in which case there is no need to go further.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FormatName
+(
+    char* buffer,           ///< [OUT] Buffer for the name.
+    size_t bufferSize,      ///< [IN] Size of the buffer.
+    const char* format,     ///< [IN] printf-style format of the name.
+    va_list args            ///< [IN] Arguments for the format.
+)
+{
+    pthread_once(&OpenOnce, OpenTraceMarker);
+
+    if (TraceMarkerFd < 0)
+    {
+        return false;
+    }
+
+    vsnprintf(buffer, bufferSize, format, args);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Begins a slice on the calling thread.  Use TRACEPOINT_BEGIN() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_Begin
+(
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+{
+    char name[MAX_TRACEPOINT_BYTES];
+    va_list args;
+
+    va_start(args, format);
+    bool isEnabled = FormatName(name, sizeof(name), format, args);
+    va_end(args);
+
+    if (isEnabled)
+    {
+        WriteTracepoint('B', name, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the last slice begun on the calling thread.  Use TRACEPOINT_END() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_End
+(
+    void
+)
+{
+    pthread_once(&OpenOnce, OpenTraceMarker);
+
+    WriteTracepoint('E', NULL, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Begins an asynchronous slice.  Use TRACEPOINT_ASYNC_BEGIN() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_AsyncBegin
+(
+    uint32_t cookie,        ///< [IN] Tells apart the slices that have the same name.
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+{
+    char name[MAX_TRACEPOINT_BYTES];
+    va_list args;
+
+    va_start(args, format);
+    bool isEnabled = FormatName(name, sizeof(name), format, args);
+    va_end(args);
+
+    if (isEnabled)
+    {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "|%" PRIu32, cookie);
+        WriteTracepoint('S', name, suffix);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends an asynchronous slice.  Use TRACEPOINT_ASYNC_END() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_AsyncEnd
+(
+    uint32_t cookie,        ///< [IN] Cookie passed when the slice was begun.
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+{
+    char name[MAX_TRACEPOINT_BYTES];
+    va_list args;
+
+    va_start(args, format);
+    bool isEnabled = FormatName(name, sizeof(name), format, args);
+    va_end(args);
+
+    if (isEnabled)
+    {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "|%" PRIu32, cookie);
+        WriteTracepoint('F', name, suffix);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the value of a counter.  Use TRACEPOINT_COUNTER() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_Counter
+(
+    int64_t value,          ///< [IN] New value of the counter.
+    const char* format,     ///< [IN] printf-style format of the counter's name.
+    ...
+)
+{
+    char name[MAX_TRACEPOINT_BYTES];
+    va_list args;
+
+    va_start(args, format);
+    bool isEnabled = FormatName(name, sizeof(name), format, args);
+    va_end(args);
+
+    if (isEnabled)
+    {
+        char suffix[24];
+        snprintf(suffix, sizeof(suffix), "|%" PRId64, value);
+        WriteTracepoint('C', name, suffix);
+    }
+}
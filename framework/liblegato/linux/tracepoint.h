@@ -0,0 +1,125 @@
+/** @file tracepoint.h
+ *
+ * Static tracepoints in the framework's messaging, event loop, timer and memory pool code.
+ *
+ * The tracepoints are compiled out unless LE_TRACEPOINTS_ENABLE is defined (see
+ * le_build_config.h), in which case the macros below evaluate to nothing and their arguments are
+ * not evaluated.
+ *
+ * When they are compiled in, the tracepoints are written to the ftrace trace_marker file in the
+ * format used by Android's atrace, which Perfetto, Catapult and trace-cmd/KernelShark understand:
+ *
+ *  - "B|pid|name" and "E|pid" begin and end a slice on the calling thread;
+ *  - "S|pid|name|cookie" and "F|pid|name|cookie" begin and end an asynchronous slice, which may
+ *    end on another thread than the one it began on;
+ *  - "C|pid|name|value" sets a counter.
+ *
+ * Because ftrace time-stamps every entry with the same clock, the slices from all processes can
+ * be lined up, e.g. to follow an IPC transaction from the client to the server and back.  IPC
+ * slices are named after the interface and the transaction ID to make that possible.
+ *
+ * If trace_marker can't be opened (e.g., tracefs isn't mounted, or the process is sandboxed),
+ * the tracepoints do nothing.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LE_TRACEPOINT_H_INCLUDE_GUARD
+#define LE_TRACEPOINT_H_INCLUDE_GUARD
+
+
+#ifdef LE_TRACEPOINTS_ENABLE
+
+/// Begins a slice on the calling thread.  Takes a printf-style format and arguments for its name.
+#define TRACEPOINT_BEGIN(...)                   tracepoint_Begin(__VA_ARGS__)
+
+/// Ends the last slice begun on the calling thread.
+#define TRACEPOINT_END()                        tracepoint_End()
+
+/// Begins an asynchronous slice identified by its name and a cookie.
+#define TRACEPOINT_ASYNC_BEGIN(cookie, ...)     tracepoint_AsyncBegin((cookie), __VA_ARGS__)
+
+/// Ends an asynchronous slice identified by its name and a cookie.
+#define TRACEPOINT_ASYNC_END(cookie, ...)       tracepoint_AsyncEnd((cookie), __VA_ARGS__)
+
+/// Sets the value of a counter.
+#define TRACEPOINT_COUNTER(value, ...)          tracepoint_Counter((value), __VA_ARGS__)
+
+#else
+
+#define TRACEPOINT_BEGIN(...)                   ((void)0)
+#define TRACEPOINT_END()                        ((void)0)
+#define TRACEPOINT_ASYNC_BEGIN(cookie, ...)     ((void)0)
+#define TRACEPOINT_ASYNC_END(cookie, ...)       ((void)0)
+#define TRACEPOINT_COUNTER(value, ...)          ((void)0)
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Begins a slice on the calling thread.  Use TRACEPOINT_BEGIN() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_Begin
+(
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+__attribute__ ((format (printf, 1, 2)));
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the last slice begun on the calling thread.  Use TRACEPOINT_END() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_End
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Begins an asynchronous slice.  Use TRACEPOINT_ASYNC_BEGIN() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_AsyncBegin
+(
+    uint32_t cookie,        ///< [IN] Tells apart the slices that have the same name.
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+__attribute__ ((format (printf, 2, 3)));
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends an asynchronous slice.  Use TRACEPOINT_ASYNC_END() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_AsyncEnd
+(
+    uint32_t cookie,        ///< [IN] Cookie passed when the slice was begun.
+    const char* format,     ///< [IN] printf-style format of the slice's name.
+    ...
+)
+__attribute__ ((format (printf, 2, 3)));
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the value of a counter.  Use TRACEPOINT_COUNTER() instead.
+ */
+//--------------------------------------------------------------------------------------------------
+void tracepoint_Counter
+(
+    int64_t value,          ///< [IN] New value of the counter.
+    const char* format,     ///< [IN] printf-style format of the counter's name.
+    ...
+)
+__attribute__ ((format (printf, 2, 3)));
+
+
+#endif // LE_TRACEPOINT_H_INCLUDE_GUARD
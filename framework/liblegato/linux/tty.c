@@ -12,8 +12,10 @@
 #include "legato.h"
 #include "smack.h"
 #include "fileDescriptor.h"
+#include "ttyBaud.h"
 #include "le_tty.h"
 #include <termios.h>
+#include <linux/serial.h>
 
 // ==============================================
 //  PRIVATE DATA
@@ -25,6 +27,10 @@
 /// Flags to enable local echo in termios struct.
 #define ECHO_FLAGS (ECHO | ECHOE | ECHOK | ECHONL)
 
+/// Largest difference between a requested custom baud rate and the one set by the driver, in
+/// percents.  UARTs generally tolerate a few percents of mismatch between the two ends.
+#define CUSTOM_BAUD_TOLERANCE 2
+
 static tty_Speed_t SpeedTable[] =
 {
     B0, // LE_TTY_SPEED_0
@@ -203,6 +209,27 @@ static inline le_result_t ConvertBaudIntoSpeed
     return LE_NOT_FOUND;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a baud rate set by the driver is close enough to the requested one.
+ *
+ * @return
+ *  - true if the difference is within CUSTOM_BAUD_TOLERANCE
+ *  - false otherwise
+ **/
+//--------------------------------------------------------------------------------------------------
+static inline bool IsBaudRateClose
+(
+    uint32_t baudRate,          ///< [in] baud rate set by the driver
+    uint32_t requestedRate      ///< [in] requested baud rate
+)
+{
+    uint64_t diff = (baudRate > requestedRate) ? (baudRate - requestedRate) :
+                                                 (requestedRate - baudRate);
+
+    return (diff * 100) <= ((uint64_t)requestedRate * CUSTOM_BAUD_TOLERANCE);
+}
+
 // ==============================================
 //  PUBLIC API FUNCTIONS
 // ==============================================
@@ -638,3 +665,117 @@ le_result_t le_tty_SetRaw
 
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set baud rate of serial port to any value, including the ones which are not listed by
+ * #tty_Speed_t.  The driver may round the baud rate to the closest one it can generate.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if value cannot be set
+ *  - LE_NOT_FOUND if value is not supported
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetCustomBaudRate
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t baudRate       ///< [IN] Baud rate, in bits/s
+)
+{
+    uint32_t inRate, outRate;
+    le_result_t result;
+
+    if (0 == baudRate) {
+        LE_ERROR("Custom baud rate of 0 is not permitted");
+        return LE_NOT_FOUND;
+    }
+
+    result = ttyBaud_Set(fd, baudRate);
+    if (LE_OK != result) {
+        LE_ERROR("Cannot set custom baud rate %"PRIu32, baudRate);
+        return result;
+    }
+    if (-1 == tcflush(fd, TCIOFLUSH)) {
+        LE_ERROR("Cannot flush termios");
+        return LE_FAULT;
+    }
+
+    // Test if value is supported
+    result = ttyBaud_Get(fd, &inRate, &outRate);
+    if (LE_OK != result) {
+        return result;
+    }
+
+    if ( !IsBaudRateClose(inRate, baudRate)
+            ||
+         !IsBaudRateClose(outRate, baudRate)
+       ) {
+        LE_ERROR("Speed rate was not setted, %"PRIu32" not supported (%"PRIu32"/%"PRIu32")",
+                 baudRate, inRate, outRate);
+        return LE_UNSUPPORTED;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get baud rate of serial port, in bits/s.  Unlike le_tty_GetBaudRate(), it also gets the baud
+ * rates which are not listed by #tty_Speed_t.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_GetCustomBaudRate
+(
+    int fd,                     ///< [IN] File Descriptor
+    uint32_t *inRatePtr,        ///< [OUT] input baud rate
+    uint32_t *outRatePtr        ///< [OUT] output baud rate
+)
+{
+    return ttyBaud_Get(fd, inRatePtr, outRatePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the low latency mode of a serial port.  In low latency mode, the driver pushes
+ * the received bytes to the reader as soon as they arrive instead of deferring it, at the cost of
+ * CPU load.  This is recommended for high baud rates, where deferred pushes can overrun the UART.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support the low latency mode
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_tty_SetLowLatency
+(
+    int fd,             ///< [IN] File Descriptor
+    bool isEnabled      ///< [IN] Enable the low latency mode?
+)
+{
+    struct serial_struct serialSettings;
+
+    if (-1 == ioctl(fd, TIOCGSERIAL, &serialSettings)) {
+        LE_ERROR("Cannot retrieve serial settings: %m");
+        return ((ENOTTY == errno) || (EINVAL == errno)) ? LE_UNSUPPORTED : LE_FAULT;
+    }
+
+    if (isEnabled) {
+        serialSettings.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serialSettings.flags &= ~ASYNC_LOW_LATENCY;
+    }
+
+    if (-1 == ioctl(fd, TIOCSSERIAL, &serialSettings)) {
+        LE_ERROR("Cannot set serial settings: %m");
+        return ((ENOTTY == errno) || (EINVAL == errno)) ? LE_UNSUPPORTED : LE_FAULT;
+    }
+
+    return LE_OK;
+}
@@ -0,0 +1,162 @@
+/** @file ttyBaud.c
+ *
+ * Implementation of the framework's internal functions for setting baud rates which are not in the
+ * Bxxxxxx table of termios.  They use the termios2 interface of the kernel, which can't be
+ * included along with the termios.h of the C library; hence this separate file.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "ttyBaud.h"
+#include <asm/termbits.h>
+#include <asm/ioctls.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Baud rates which have their own Bxxxxxx code; they are set with it rather than with BOTHER, so
+ * that they are still reported by cfgetispeed() and cfgetospeed().
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    uint32_t baudRate;      ///< Baud rate, in bits/s
+    tcflag_t code;          ///< Bxxxxxx code of the baud rate
+}
+StandardRateTable[] =
+{
+    { 50, B50 }, { 75, B75 }, { 110, B110 }, { 134, B134 }, { 150, B150 }, { 200, B200 },
+    { 300, B300 }, { 600, B600 }, { 1200, B1200 }, { 1800, B1800 }, { 2400, B2400 },
+    { 4800, B4800 }, { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+    { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+    { 500000, B500000 }, { 576000, B576000 }, { 921600, B921600 }, { 1000000, B1000000 },
+    { 1152000, B1152000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+    { 2500000, B2500000 }, { 3000000, B3000000 }, { 3500000, B3500000 },
+    { 4000000, B4000000 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Bxxxxxx code of a baud rate.
+ *
+ * @return
+ *  - The code of the baud rate if it is a standard one, BOTHER otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static tcflag_t GetBaudCode
+(
+    uint32_t baudRate       ///< [IN] Baud rate, in bits/s
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(StandardRateTable); i++)
+    {
+        if (StandardRateTable[i].baudRate == baudRate)
+        {
+            return StandardRateTable[i].code;
+        }
+    }
+
+    return BOTHER;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the termios2 settings of a serial port.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support termios2
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetSettings
+(
+    int fd,                         ///< [IN] File Descriptor
+    struct termios2* settingsPtr    ///< [OUT] Port settings
+)
+{
+    if (-1 == ioctl(fd, TCGETS2, settingsPtr))
+    {
+        LE_ERROR("Cannot retrieve port settings: %m");
+        return ((ENOTTY == errno) || (EINVAL == errno)) ? LE_UNSUPPORTED : LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets both the input and output baud rates of a serial port to any value, provided that the
+ * driver accepts it.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ttyBaud_Set
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t baudRate       ///< [IN] Baud rate, in bits/s
+)
+{
+    struct termios2 portSettings;
+    tcflag_t code = GetBaudCode(baudRate);
+    le_result_t result = GetSettings(fd, &portSettings);
+
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    // Assume full-duplex, symmetrical.
+    portSettings.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    portSettings.c_cflag |= code | (code << IBSHIFT);
+    portSettings.c_ispeed = baudRate;
+    portSettings.c_ospeed = baudRate;
+
+    if (-1 == ioctl(fd, TCSETS2, &portSettings))
+    {
+        LE_ERROR("Cannot set port settings: %m");
+        return ((ENOTTY == errno) || (EINVAL == errno)) ? LE_UNSUPPORTED : LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the input and output baud rates of a serial port, in bits/s.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ttyBaud_Get
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t* inRatePtr,    ///< [OUT] Input baud rate
+    uint32_t* outRatePtr    ///< [OUT] Output baud rate
+)
+{
+    struct termios2 portSettings;
+    le_result_t result = GetSettings(fd, &portSettings);
+
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    *inRatePtr = portSettings.c_ispeed;
+    *outRatePtr = portSettings.c_ospeed;
+
+    return LE_OK;
+}
@@ -0,0 +1,48 @@
+/** @file ttyBaud.h
+ *
+ * Declaration of the framework's internal functions for setting baud rates which are not in the
+ * Bxxxxxx table of termios.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LE_TTY_BAUD_H_INCLUDE_GUARD
+#define LE_TTY_BAUD_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets both the input and output baud rates of a serial port to any value, provided that the
+ * driver accepts it.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ttyBaud_Set
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t baudRate       ///< [IN] Baud rate, in bits/s
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the input and output baud rates of a serial port, in bits/s.
+ *
+ * @return
+ *  - LE_OK if successful
+ *  - LE_UNSUPPORTED if the driver doesn't support custom baud rates
+ *  - LE_FAULT for any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ttyBaud_Get
+(
+    int fd,                 ///< [IN] File Descriptor
+    uint32_t* inRatePtr,    ///< [OUT] Input baud rate
+    uint32_t* outRatePtr    ///< [OUT] Output baud rate
+);
+
+
+#endif // LE_TTY_BAUD_H_INCLUDE_GUARD
@@ -539,6 +539,102 @@ le_result_t unixSocket_SendDataMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends several messages containing only data through a connected Unix domain datagram or
+ * sequenced-packet socket, using as few system calls as possible.  Each I/O vector is sent as a
+ * separate message, in order.
+ *
+ * @return
+ * - LE_OK if all the messages were sent.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @note On failure, *sentCountPtr is set to the number of messages that were sent before the
+ *       failure occurred.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendDataMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to send.
+    struct iovec* ioVectors,    ///< [IN] Array of data payloads, one per message.
+    size_t msgCount,            ///< [IN] Number of messages to send.
+    size_t* sentCountPtr        ///< [OUT] Number of messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Number of messages handed to sendmmsg() at a time.
+    #define MAX_MSGS_PER_CALL 16
+
+    struct mmsghdr msgHeaders[MAX_MSGS_PER_CALL];
+
+    *sentCountPtr = 0;
+
+    while (*sentCountPtr < msgCount)
+    {
+        size_t count = msgCount - *sentCountPtr;
+        size_t i;
+
+        if (count > MAX_MSGS_PER_CALL)
+        {
+            count = MAX_MSGS_PER_CALL;
+        }
+
+        memset(msgHeaders, 0, sizeof(msgHeaders));
+        for (i = 0; i < count; i++)
+        {
+            msgHeaders[i].msg_hdr.msg_iov = &ioVectors[*sentCountPtr + i];
+            msgHeaders[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Send as many as possible (retry if interrupted by a signal).
+        int sent;
+        do
+        {
+            sent = sendmmsg(localSocketFd, msgHeaders, count, 0);
+        }
+        while ((sent < 0) && (errno == EINTR));
+
+        if (sent < 0)
+        {
+            switch (errno)
+            {
+                case EAGAIN:  // Same as EWOULDBLOCK
+                    return LE_NO_MEMORY;
+
+                case ENOTCONN:
+                case ECONNRESET:
+                case EPIPE:
+                    LE_WARN("sendmmsg() failed with errno %d (%m).", errno);
+                    return LE_COMM_ERROR;
+
+                default:
+                    LE_ERROR("sendmmsg() failed with errno %d (%m).", errno);
+                    return LE_FAULT;
+            }
+        }
+
+        for (i = 0; i < (size_t)sent; i++)
+        {
+            if (msgHeaders[i].msg_len < ioVectors[*sentCountPtr].iov_len)
+            {
+                LE_ERROR("The last %zu data bytes (of %zu total) were discarded by sendmmsg()!",
+                         ioVectors[*sentCountPtr].iov_len - msgHeaders[i].msg_len,
+                         ioVectors[*sentCountPtr].iov_len);
+                return LE_FAULT;
+            }
+            (*sentCountPtr)++;
+        }
+    }
+
+    #undef MAX_MSGS_PER_CALL
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receives through a connected Unix domain socket a message containing any combination of
@@ -725,6 +821,66 @@ le_result_t unixSocket_ReceiveDataMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the data payload of the next message waiting to be received on a connected
+ * Unix domain datagram or sequenced-packet socket, without receiving it.  This allows the
+ * receive buffer to be sized to fit the message.
+ *
+ * @return
+ * - LE_OK if successful
+ * - LE_WOULD_BLOCK if the socket is set non-blocking and there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ *
+ * @note    A message with an empty data payload is indistinguishable from a closed connection.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_PeekMsgSize
+(
+    int localSocketFd,      ///< [IN] fd of local socket that will be used to receive the message.
+    size_t* dataSizePtr     ///< [OUT] Ptr to where the size of the data payload will be put.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char byte;
+    ssize_t bytesReceived;
+
+    // MSG_TRUNC makes recv() report the full size of the message even though it only has room for
+    // one byte, and MSG_PEEK leaves the message (and any ancillary data) on the socket.
+    do
+    {
+        bytesReceived = recv(localSocketFd, &byte, sizeof(byte), MSG_PEEK | MSG_TRUNC);
+    }
+    while ((bytesReceived < 0) && (errno == EINTR));
+
+    if (bytesReceived < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return LE_WOULD_BLOCK;
+        }
+        else if (errno == ECONNRESET)
+        {
+            return LE_CLOSED;
+        }
+        else
+        {
+            LE_ERROR("recv() failed with errno %d (%m).", errno);
+            return LE_FAULT;
+        }
+    }
+    else if (bytesReceived == 0)
+    {
+        return LE_CLOSED;
+    }
+
+    *dataSizePtr = bytesReceived;
+
+    return LE_OK;
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
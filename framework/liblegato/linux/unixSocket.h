@@ -447,6 +447,32 @@ le_result_t unixSocket_SendDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends several messages containing only data through a connected Unix domain datagram or
+ * sequenced-packet socket, using as few system calls as possible.  Each I/O vector is sent as a
+ * separate message, in order.
+ *
+ * @return
+ * - LE_OK if all the messages were sent.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @note On failure, *sentCountPtr is set to the number of messages that were sent before the
+ *       failure occurred.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendDataMsgs
+(
+    int localSocketFd,          ///< [IN] fd of the local socket that will be used to send.
+    struct iovec* ioVectors,    ///< [IN] Array of data payloads, one per message.
+    size_t msgCount,            ///< [IN] Number of messages to send.
+    size_t* sentCountPtr        ///< [OUT] Number of messages sent.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receives through a connected Unix domain socket a message containing any combination of
@@ -518,6 +544,28 @@ le_result_t unixSocket_ReceiveDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the data payload of the next message waiting to be received on a connected
+ * Unix domain datagram or sequenced-packet socket, without receiving it.  This allows the
+ * receive buffer to be sized to fit the message.
+ *
+ * @return
+ * - LE_OK if successful
+ * - LE_WOULD_BLOCK if the socket is set non-blocking and there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ *
+ * @note    A message with an empty data payload is indistinguishable from a closed connection.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_PeekMsgSize
+(
+    int localSocketFd,      ///< [IN] fd of local socket that will be used to receive the message.
+    size_t* dataSizePtr     ///< [OUT] Ptr to where the size of the data payload will be put.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the socket error state code (SO_ERROR).
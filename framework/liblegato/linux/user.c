@@ -15,6 +15,12 @@
  * Groups are created and deleted by modifying the /etc/group file.  File update and locking is
  * handled in the same way as the passwd file.
  *
+ * The results of user and group look-ups are kept in a small Look-up Cache, and the apps
+ * translation table is kept in memory, so that daemons looking up the same few users for every
+ * client connection don't re-read and re-parse these files each time.  Both are checked against
+ * the files' status (see FileStamp_t) before being used, so changes made by other processes are
+ * picked up.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -26,6 +32,8 @@
 #include <grp.h>
 #include <sys/file.h>
 #include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <pthread.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -146,6 +154,358 @@ static le_mem_PoolRef_t AppsTabPool = NULL;
 //--------------------------------------------------------------------------------------------------
 static bool IsEtcWritable = false;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * What is known about a file's status when its content was last read.  If any of this has changed,
+ * the file has been modified since.
+ *
+ * File modification times are coarse on some file systems, so a file that was modified less than a
+ * second before it was read could be modified again without its status changing.  Such a stamp is
+ * "racy" and is never considered current.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool            isValid;    ///< false if the file hasn't been read (or couldn't be stat'ed).
+    bool            isMissing;  ///< true if the file didn't exist.
+    bool            isRacy;     ///< true if the file had just been modified when it was read.
+    dev_t           dev;        ///< Device holding the file.
+    ino_t           ino;        ///< Inode number (changes if the file is replaced).
+    off_t           size;       ///< Size of the file.
+    struct timespec mtime;      ///< Modification time.
+    struct timespec ctime;      ///< Status change time.
+}
+FileStamp_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Status of the apps translation table file when it was last read into AppsTab.
+ */
+//--------------------------------------------------------------------------------------------------
+static FileStamp_t AppsTabStamp;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of entries in the Look-up Cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOOKUP_CACHE_SIZE   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kinds of look-up kept in the Look-up Cache.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LOOKUP_NONE = 0,        ///< Unused entry.
+    LOOKUP_USER_BY_ID,      ///< User name from a uid (user_GetName()).
+    LOOKUP_USER_BY_NAME,    ///< uid and gid from a user name (user_GetIDs(), user_GetUid()).
+    LOOKUP_GROUP_BY_ID,     ///< Group name from a gid (user_GetGroupName()).
+    LOOKUP_GROUP_BY_NAME,   ///< gid from a group name (user_GetGid()).
+}
+LookupKind_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look-up Cache entry: the result of a successful look-up.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    LookupKind_t    kind;                               ///< Kind of look-up.
+    uid_t           uid;                                ///< uid (user look-ups only).
+    gid_t           gid;                                ///< gid.
+    char            name[LIMIT_MAX_USER_NAME_BYTES];    ///< User or group name.
+}
+LookupCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look-up Cache.  Entries are replaced round-robin.  Emptied whenever the passwd file, the group
+ * file or the apps translation table file changes.
+ *
+ * Protected by LookupCacheMutex, together with the stamps below.
+ */
+//--------------------------------------------------------------------------------------------------
+static LookupCacheEntry_t LookupCache[LOOKUP_CACHE_SIZE];
+static size_t NextLookupCacheEntry = 0;
+static FileStamp_t PasswdCacheStamp;
+static FileStamp_t GroupCacheStamp;
+static FileStamp_t AppsTabCacheStamp;
+static pthread_mutex_t LookupCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Locks the Look-up Cache.
+#define LOCK_CACHE()    LE_ASSERT(pthread_mutex_lock(&LookupCacheMutex) == 0)
+
+/// Unlocks the Look-up Cache.
+#define UNLOCK_CACHE()  LE_ASSERT(pthread_mutex_unlock(&LookupCacheMutex) == 0)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a file is unchanged since a stamp was taken, and updates the stamp to the file's
+ * current status.
+ *
+ * @return
+ *      true if the file is unchanged and the stamp isn't racy.
+ *      false if the content read with the old stamp must be read again.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckFileStamp
+(
+    FileStamp_t* stampPtr,      ///< [IN/OUT] Stamp taken when the file was last read.
+    const char* pathPtr         ///< [IN] Path of the file.
+)
+{
+    struct stat st;
+
+    if (stat(pathPtr, &st) != 0)
+    {
+        // A file that doesn't exist stays that way until it is created.
+        bool isCurrent = stampPtr->isValid && stampPtr->isMissing;
+        bool isMissing = (errno == ENOENT);
+
+        memset(stampPtr, 0, sizeof(*stampPtr));
+        stampPtr->isValid = isMissing;
+        stampPtr->isMissing = isMissing;
+
+        return isCurrent && isMissing;
+    }
+
+    bool isCurrent = stampPtr->isValid
+                     && (!stampPtr->isMissing)
+                     && (!stampPtr->isRacy)
+                     && (stampPtr->dev == st.st_dev)
+                     && (stampPtr->ino == st.st_ino)
+                     && (stampPtr->size == st.st_size)
+                     && (stampPtr->mtime.tv_sec == st.st_mtim.tv_sec)
+                     && (stampPtr->mtime.tv_nsec == st.st_mtim.tv_nsec)
+                     && (stampPtr->ctime.tv_sec == st.st_ctim.tv_sec)
+                     && (stampPtr->ctime.tv_nsec == st.st_ctim.tv_nsec);
+
+    if (!isCurrent)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+
+        stampPtr->isValid = true;
+        stampPtr->isMissing = false;
+        stampPtr->isRacy = (st.st_mtim.tv_sec >= now.tv_sec - 1)
+                           || (st.st_ctim.tv_sec >= now.tv_sec - 1);
+        stampPtr->dev = st.st_dev;
+        stampPtr->ino = st.st_ino;
+        stampPtr->size = st.st_size;
+        stampPtr->mtime = st.st_mtim;
+        stampPtr->ctime = st.st_ctim;
+    }
+
+    return isCurrent;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the apps translation table file into AppsTab, unless it hasn't changed since it was last
+ * read.  If the file doesn't exist, AppsTab is left as it is.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the file couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadAppsTab
+(
+    void
+)
+{
+    // Take the stamp before reading, so that a change made while reading is seen next time.
+    if (CheckFileStamp(&AppsTabStamp, APPS_TRANSLATION_FILE))
+    {
+        return LE_OK;
+    }
+
+    if (ReadAppsTab() != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes AppsTab to the apps translation table file.
+ *
+ * @return
+ *      LE_OK if successful, or if the file couldn't be opened.
+ *      LE_FAULT if the file couldn't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAppsTab
+(
+    void
+)
+{
+    // The file will be read again the next time it is needed.
+    AppsTabStamp.isValid = false;
+
+    FILE *fd = fopen(APPS_TRANSLATION_FILE, "w");
+    if (fd)
+    {
+        size_t rc;
+        rc = fwrite(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
+        fclose(fd);
+        if (NbAppsInTranslationTable != rc)
+        {
+            LE_ERROR("Write of apps translation table failed (rc %zu != %u)",
+                     rc, NbAppsInTranslationTable);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties the Look-up Cache if any of the files its entries were read from has changed.
+ *
+ * @warning Must be called with the Look-up Cache locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ValidateLookupCache
+(
+    void
+)
+{
+    // Check all the files, so that all the stamps are up to date.
+    bool isCurrent = CheckFileStamp(&PasswdCacheStamp, PASSWORD_FILE);
+    isCurrent = CheckFileStamp(&GroupCacheStamp, GROUP_FILE) && isCurrent;
+    if (!IsEtcWritable)
+    {
+        isCurrent = CheckFileStamp(&AppsTabCacheStamp, APPS_TRANSLATION_FILE) && isCurrent;
+    }
+
+    if (!isCurrent)
+    {
+        memset(LookupCache, 0, sizeof(LookupCache));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties the Look-up Cache.  Called before this module changes the passwd or group files.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateLookupCache
+(
+    void
+)
+{
+    LOCK_CACHE();
+
+    memset(LookupCache, 0, sizeof(LookupCache));
+    PasswdCacheStamp.isValid = false;
+    GroupCacheStamp.isValid = false;
+    AppsTabCacheStamp.isValid = false;
+
+    UNLOCK_CACHE();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks for the result of a look-up in the Look-up Cache, after emptying it if it is out of date.
+ *
+ * @return
+ *      true if found, in which case *entryPtr is a copy of the entry.
+ *      false if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FindInLookupCache
+(
+    LookupKind_t kind,              ///< [IN] Kind of look-up.
+    uint32_t id,                    ///< [IN] uid or gid to look up (look-ups by id only).
+    const char* namePtr,            ///< [IN] Name to look up (look-ups by name only).
+    LookupCacheEntry_t* entryPtr    ///< [OUT] Copy of the entry.
+)
+{
+    bool isFound = false;
+    size_t i;
+
+    LOCK_CACHE();
+
+    ValidateLookupCache();
+
+    for (i = 0; (i < LOOKUP_CACHE_SIZE) && (!isFound); i++)
+    {
+        LookupCacheEntry_t* cachedPtr = &LookupCache[i];
+
+        if (cachedPtr->kind != kind)
+        {
+            continue;
+        }
+
+        switch (kind)
+        {
+            case LOOKUP_USER_BY_ID:
+                isFound = (cachedPtr->uid == id);
+                break;
+
+            case LOOKUP_GROUP_BY_ID:
+                isFound = (cachedPtr->gid == id);
+                break;
+
+            default:
+                isFound = (strcmp(cachedPtr->name, namePtr) == 0);
+                break;
+        }
+
+        if (isFound)
+        {
+            *entryPtr = *cachedPtr;
+        }
+    }
+
+    UNLOCK_CACHE();
+
+    return isFound;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds the result of a successful look-up to the Look-up Cache.  Names too long for an entry
+ * aren't cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToLookupCache
+(
+    LookupKind_t kind,              ///< [IN] Kind of look-up.
+    uid_t uid,                      ///< [IN] uid (user look-ups only).
+    gid_t gid,                      ///< [IN] gid.
+    const char* namePtr             ///< [IN] User or group name.
+)
+{
+    LookupCacheEntry_t entry = { .kind = kind, .uid = uid, .gid = gid };
+
+    if (le_utf8_Copy(entry.name, namePtr, sizeof(entry.name), NULL) != LE_OK)
+    {
+        return;
+    }
+
+    LOCK_CACHE();
+
+    LookupCache[NextLookupCacheEntry] = entry;
+    NextLookupCacheEntry = (NextLookupCacheEntry + 1) % LOOKUP_CACHE_SIZE;
+
+    UNLOCK_CACHE();
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Updates the user or group ID range value from a string.  If the string contains the value to
@@ -590,25 +950,16 @@ static le_result_t GetName
         uint32_t ids = uid - BASE_MIN_UID;
 
         // /etc is not writable so try first to read the apps translation tab if it exist.
-        FILE *fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
+        }
 
-            // Check if the apps already exists in the apps translation table.
-            if ('\0' != AppsTab[ids].name[0])
-            {
-                // Copy the username to the caller's buffer.
-                return le_utf8_Copy(nameBufPtr, AppsTab[ids].name, nameBufSize, NULL);
-            }
+        // Check if the apps already exists in the apps translation table.
+        if ('\0' != AppsTab[ids].name[0])
+        {
+            // Copy the username to the caller's buffer.
+            return le_utf8_Copy(nameBufPtr, AppsTab[ids].name, nameBufSize, NULL);
         }
     }
 
@@ -672,25 +1023,16 @@ static le_result_t GetGroupName
         uint32_t ids = gid - BASE_MIN_UID;
 
         // /etc is not writable so try first to read the apps translation tab if it exist.
-        FILE *fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
+        }
 
-            // Check if the apps already exists in the apps translation table.
-            if ('\0' != AppsTab[ids].name[0])
-            {
-                // Copy the username to the caller's buffer.
-                return le_utf8_Copy(nameBufPtr, AppsTab[ids].name, nameBufSize, NULL);
-            }
+        // Check if the apps already exists in the apps translation table.
+        if ('\0' != AppsTab[ids].name[0])
+        {
+            // Copy the username to the caller's buffer.
+            return le_utf8_Copy(nameBufPtr, AppsTab[ids].name, nameBufSize, NULL);
         }
     }
 
@@ -754,18 +1096,9 @@ static le_result_t GetIDs
     if (!IsEtcWritable)
     {
         // /etc is not writable so try first to read the apps translation tab if it exist.
-        FILE *fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
         }
 
         for (ids = 0; ids < NbAppsInTranslationTable; ids++)
@@ -871,18 +1204,9 @@ static le_result_t GetGid
     if (!IsEtcWritable)
     {
         // /etc is not writable so try first to read the apps translation tab if it exist.
-        FILE *fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
         }
 
         for (ids = 0; ids < NbAppsInTranslationTable; ids++)
@@ -1142,6 +1466,8 @@ le_result_t user_Create
                                 ///        user.  This can be NULL if the gid is not needed.
 )
 {
+    InvalidateLookupCache();
+
     // Consider this a duplicate if either group or user do not exist
     bool isDuplicate = true;
 
@@ -1158,18 +1484,9 @@ le_result_t user_Create
         // /etc is not writable. Use the apps translation table instead /etc/passwd.
         uint32_t ids;
         uint32_t uidfree = (uint32_t)-1;
-        FILE *fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
         }
 
         for (ids = 0; ids < NbAppsInTranslationTable; ids++)
@@ -1202,18 +1519,9 @@ le_result_t user_Create
                 snprintf(appsUserName, sizeof(appsUserName), USERNAME_TABLE_PREFIX "%02u", uidfree);
                 snprintf(AppsTab[uidfree].name, sizeof(appTab_t), "%s", usernamePtr);
                 // Write the apps translation table into flash
-                fd = fopen(APPS_TRANSLATION_FILE, "w");
-                if (fd)
+                if (WriteAppsTab() != LE_OK)
                 {
-                    size_t rc;
-                    rc = fwrite(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-                    fclose(fd);
-                    if (NbAppsInTranslationTable != rc)
-                    {
-                        LE_ERROR("Write of apps translation table failed (rc %zu != %u)",
-                                 rc, NbAppsInTranslationTable);
-                        return LE_FAULT;
-                    }
+                    return LE_FAULT;
                 }
                 usernamePtr = appsUserName;
             }
@@ -1416,6 +1724,8 @@ le_result_t user_CreateGroup
     gid_t* gidPtr                ///< [OUT] Pointer to store the gid.
 )
 {
+    InvalidateLookupCache();
+
     // Lock the group file for reading and writing.
     FILE* groupFilePtr;
 
@@ -1721,38 +2031,19 @@ static le_result_t DeleteUser
     else
     {
         uint32_t uid;
-        FILE* fd = fopen(APPS_TRANSLATION_FILE, "r");
-        if (fd)
+        if (ReadAppsTab() != LE_OK)
         {
-            size_t rc;
-            rc = fread(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-            fclose(fd);
-            if (NbAppsInTranslationTable != rc)
-            {
-                LE_ERROR("Read of apps translation table failed (rc %zu != %u)",
-                         rc, NbAppsInTranslationTable);
-                return LE_FAULT;
-            }
+            return LE_FAULT;
         }
 
         for (uid = 0; uid < NbAppsInTranslationTable; uid++)
         {
             if (0 == strcmp(AppsTab[uid].name, namePtr))
             {
-                size_t rc;
-
                 memset(AppsTab[uid].name, 0, sizeof(appTab_t));
-                fd = fopen(APPS_TRANSLATION_FILE, "w");
-                if (fd)
+                if (WriteAppsTab() != LE_OK)
                 {
-                    rc = fwrite(AppsTab, sizeof(appTab_t), NbAppsInTranslationTable, fd);
-                    fclose(fd);
-                    if (NbAppsInTranslationTable != rc)
-                    {
-                        LE_ERROR("Write of apps translation table failed (rc %zu != %u)",
-                                 rc, NbAppsInTranslationTable);
-                        return LE_FAULT;
-                    }
+                    return LE_FAULT;
                 }
                 return LE_OK;
             }
@@ -1778,6 +2069,8 @@ le_result_t user_Delete
     const char* namePtr     ///< [IN] Pointer to the name of the user to delete.
 )
 {
+    InvalidateLookupCache();
+
     FILE* passwdFilePtr;
     FILE* groupFilePtr;
 
@@ -1951,6 +2244,8 @@ le_result_t user_DeleteGroup
     const char* groupNamePtr     ///< [IN] Pointer to the name of the group to delete.
 )
 {
+    InvalidateLookupCache();
+
     FILE* groupFilePtr;
 
     if (IsEtcWritable)
@@ -2044,6 +2339,23 @@ le_result_t user_GetIDs
                                 ///        This can be NULL if the gid is not needed.
 )
 {
+    LookupCacheEntry_t entry;
+
+    if (FindInLookupCache(LOOKUP_USER_BY_NAME, 0, usernamePtr, &entry))
+    {
+        if (uidPtr != NULL)
+        {
+            *uidPtr = entry.uid;
+        }
+
+        if (gidPtr != NULL)
+        {
+            *gidPtr = entry.gid;
+        }
+
+        return LE_OK;
+    }
+
     // Lock the passwd file for reading.
     int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2052,11 +2364,26 @@ le_result_t user_GetIDs
         return LE_FAULT;
     }
 
-    le_result_t r = GetIDs(usernamePtr, uidPtr, gidPtr);
+    le_result_t r = GetIDs(usernamePtr, &entry.uid, &entry.gid);
 
     // Release the lock on the passwd file.
     le_flock_Close(fd);
 
+    if (r == LE_OK)
+    {
+        AddToLookupCache(LOOKUP_USER_BY_NAME, entry.uid, entry.gid, usernamePtr);
+
+        if (uidPtr != NULL)
+        {
+            *uidPtr = entry.uid;
+        }
+
+        if (gidPtr != NULL)
+        {
+            *gidPtr = entry.gid;
+        }
+    }
+
     return r;
 }
 
@@ -2077,27 +2404,7 @@ le_result_t user_GetUid
     uid_t* uidPtr               ///< [OUT] Pointer to store the uid.
 )
 {
-    // Lock the passwd file for reading.
-    int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
-    if (fd < 0)
-    {
-        LE_ERROR("Could not read file %s.  %m.", PASSWORD_FILE);
-        return LE_FAULT;
-    }
-
-    uid_t uid;
-
-    le_result_t result = GetUid(usernamePtr, &uid);
-
-    // Release the lock on the passwd file.
-    le_flock_Close(fd);
-
-    if (result == LE_OK)
-    {
-        *uidPtr = uid;
-    }
-
-    return result;
+    return user_GetIDs(usernamePtr, uidPtr, NULL);
 }
 
 
@@ -2117,6 +2424,14 @@ le_result_t user_GetGid
     gid_t* gidPtr                ///< [OUT] Pointer to store the gid.
 )
 {
+    LookupCacheEntry_t entry;
+
+    if (FindInLookupCache(LOOKUP_GROUP_BY_NAME, 0, groupNamePtr, &entry))
+    {
+        *gidPtr = entry.gid;
+        return LE_OK;
+    }
+
     // Lock the group file for reading.
     int fd = le_flock_Open(GROUP_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2134,6 +2449,7 @@ le_result_t user_GetGid
 
     if (result == LE_OK)
     {
+        AddToLookupCache(LOOKUP_GROUP_BY_NAME, 0, gid, groupNamePtr);
         *gidPtr = gid;
     }
 
@@ -2159,6 +2475,13 @@ le_result_t user_GetName
     size_t nameBufSize          ///< [IN] The size of the buffer that the user name will be stored in.
 )
 {
+    LookupCacheEntry_t entry;
+
+    if (FindInLookupCache(LOOKUP_USER_BY_ID, uid, NULL, &entry))
+    {
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+
     // Lock the passwd file for reading.
     int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2172,6 +2495,11 @@ le_result_t user_GetName
     // Release the lock on the passwd file.
     le_flock_Close(fd);
 
+    if (r == LE_OK)
+    {
+        AddToLookupCache(LOOKUP_USER_BY_ID, uid, 0, nameBufPtr);
+    }
+
     return r;
 }
 
@@ -2194,6 +2522,13 @@ le_result_t user_GetGroupName
     size_t nameBufSize          ///< [IN] The size of the buffer that the group name will be stored in.
 )
 {
+    LookupCacheEntry_t entry;
+
+    if (FindInLookupCache(LOOKUP_GROUP_BY_ID, gid, NULL, &entry))
+    {
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+
     // Lock the group file for reading.
     int fd = le_flock_Open(GROUP_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2207,6 +2542,11 @@ le_result_t user_GetGroupName
     // Release the lock on the group file.
     le_flock_Close(fd);
 
+    if (r == LE_OK)
+    {
+        AddToLookupCache(LOOKUP_GROUP_BY_ID, 0, gid, nameBufPtr);
+    }
+
     return r;
 }
 
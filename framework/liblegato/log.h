@@ -44,6 +44,14 @@
 #define LOG_DEFAULT_LOG_FILTER      LE_LOG_INFO
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of log messages.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define LOG_MAX_MSG_SIZE            256
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.  This must be called VERY early in the process initialization.
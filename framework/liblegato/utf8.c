@@ -6,6 +6,10 @@
 
 #include "legato.h"
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 
 //--------------------------------------------------------------------------------------------------
 // Local definitions.
@@ -17,6 +21,105 @@
 #define IS_FOUR_BYTE_CHAR(leadByte)             ( (leadByte & 0xF8) == 0xF0 )
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Machine word used to scan strings several bytes at a time.  May alias any other type.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef uintptr_t __attribute__((__may_alias__)) Word_t;
+
+/// Word with 0x01 in every byte.
+#define WORD_ONES       ((Word_t)-1 / 0xFF)
+
+/// Word with 0x80 in every byte.
+#define WORD_HIGHS      (WORD_ONES * 0x80)
+
+/// Non-zero if any byte of a word is zero.
+#define WORD_HAS_ZERO(word)         ( ((word) - WORD_ONES) & ~(word) & WORD_HIGHS )
+
+/// Non-zero if any byte of a word is not ASCII.
+#define WORD_HAS_NON_ASCII(word)    ( (word) & WORD_HIGHS )
+
+/// true if a byte is neither ASCII nor the null-terminator.
+#define IS_ASCII_CHAR(byte)         ( (uint8_t)((uint8_t)(byte) - 1) < 0x7F )
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the single-byte (ASCII) characters at the start of a string, stopping at the first
+ * null-terminator or non-ASCII byte, or at about maxBytes bytes (more may be counted).
+ *
+ * Most strings are ASCII, so the other functions skip over ASCII runs with this before looking at
+ * the string one character at a time.  The string is read a word at a time (16 bytes at a time
+ * with NEON).  The reads are aligned, so they never cross a page boundary even when they go past
+ * the null-terminator.  AddressSanitizer doesn't know that, so it is told not to check them.
+ *
+ * @return
+ *      Number of ASCII characters.
+ */
+//--------------------------------------------------------------------------------------------------
+__attribute__((no_sanitize_address))
+static size_t AsciiSpan
+(
+    const char* string,     ///< [IN] The string.
+    size_t maxBytes         ///< [IN] Number of bytes after which to stop looking.
+)
+{
+    size_t i = 0;
+
+    // Go a byte at a time up to the first word boundary.
+    while (((uintptr_t)&string[i] & (sizeof(Word_t) - 1)) != 0)
+    {
+        if (!IS_ASCII_CHAR(string[i]))
+        {
+            return i;
+        }
+        i++;
+    }
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    // Then 16 bytes at a time.  Subtracting one turns the null-terminator into 0xFF and leaves
+    // ASCII characters below 0x7F, so a single maximum finds both the end of the string and
+    // non-ASCII bytes.
+    if ((((uintptr_t)&string[i] & 0xF) == 0) && (i < maxBytes))
+    {
+        const uint8x16_t ones = vdupq_n_u8(1);
+
+        while (i < maxBytes)
+        {
+            uint8x16_t bytes = vld1q_u8((const uint8_t*)&string[i]);
+
+            if (vmaxvq_u8(vsubq_u8(bytes, ones)) >= 0x7F)
+            {
+                break;
+            }
+            i += 16;
+        }
+    }
+#endif
+
+    // Then a word at a time.
+    while (i < maxBytes)
+    {
+        Word_t word = *(const Word_t*)&string[i];
+
+        if (WORD_HAS_ZERO(word) | WORD_HAS_NON_ASCII(word))
+        {
+            break;
+        }
+        i += sizeof(Word_t);
+    }
+
+    // Then find the byte that stopped us a byte at a time.
+    while ((i < maxBytes) && IS_ASCII_CHAR(string[i]))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function returns the number of characters in string.
@@ -45,8 +148,19 @@ ssize_t le_utf8_NumChars
         return 0;
     }
 
-    while (string[strIndex] != '\0')
+    while (1)
     {
+        // Skip over ASCII characters quickly.
+        size_t asciiCount = AsciiSpan(&string[strIndex], SIZE_MAX);
+
+        strIndex += asciiCount;
+        numChars += asciiCount;
+
+        if (string[strIndex] == '\0')
+        {
+            break;
+        }
+
         numBytes = le_utf8_NumBytesInChar(string[strIndex]);
 
         if (numBytes == 0)
@@ -173,10 +287,32 @@ le_result_t le_utf8_Copy
     // Check parameters.
     LE_ASSERT( (destStr != NULL) && (srcStr != NULL) && (destSize > 0) );
 
-    // Go through the string copying one character at a time.
+    // Go through the string copying ASCII runs in one go and other characters one at a time.
     size_t i = 0;
     while (1)
     {
+        // Only destSize - 1 bytes fit, leaving room for the null-terminator.
+        size_t asciiCount = AsciiSpan(&srcStr[i], destSize - 1 - i);
+
+        if (asciiCount > destSize - 1 - i)
+        {
+            // The run doesn't fit, so copy what fits and stop.
+            asciiCount = destSize - 1 - i;
+            memcpy(&destStr[i], &srcStr[i], asciiCount);
+            i += asciiCount;
+            destStr[i] = '\0';
+
+            if (numBytesPtr)
+            {
+                *numBytesPtr = i;
+            }
+
+            return LE_OVERFLOW;
+        }
+
+        memcpy(&destStr[i], &srcStr[i], asciiCount);
+        i += asciiCount;
+
         if (srcStr[i] == '\0')
         {
             // NULL character found.  Complete the copy and return.
@@ -412,8 +548,16 @@ bool le_utf8_IsFormatCorrect
         return false;
     }
 
-    while (string[strIndex] != '\0')
+    while (1)
     {
+        // Skip over ASCII characters quickly.
+        strIndex += AsciiSpan(&string[strIndex], SIZE_MAX);
+
+        if (string[strIndex] == '\0')
+        {
+            break;
+        }
+
         numBytes = le_utf8_NumBytesInChar(string[strIndex]);
 
         if (numBytes == 0)
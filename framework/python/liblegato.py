@@ -5,6 +5,7 @@ Wrapper for _liblegato_py.so C Extension.
 from _liblegato_py import ffi, lib
 from enum import IntEnum, Enum
 import inspect
+import struct
 import sys
 import types
 from functools import wraps
@@ -138,6 +139,135 @@ for name in dir(lib):
         # for types, enums, etc, just import into this module
         setattr(current_module, name, obj)
 
+# -fast path-
+# The hot calls (message packing, synchronous messaging and event loop servicing) go through the
+# compiled _liblegato_fast module when it is available, instead of converting each value through
+# cffi.  Otherwise they fall back to the cffi bindings.  See liblegato_fast.c for the pack formats.
+try:
+    import _liblegato_fast as _fast
+except ImportError:
+    _fast = None
+
+_PACK_FORMATS = {
+    'b': 'b', 'B': 'B', 'h': 'h', 'H': 'H', 'i': 'i', 'I': 'I', 'q': 'q', 'Q': 'Q',
+    '?': '?', 'd': 'd', 'z': 'I', 'r': 'I',
+}
+
+def _ref_to_int(ref):
+    return int(ffi.cast('uintptr_t', ref))
+
+def _parse_pack_format(fmt):
+    """
+    Split a pack format into (format character, maximum string size) pairs.
+    """
+    items = []
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        i += 1
+        if c == 's':
+            start = i
+            while i < len(fmt) and fmt[i].isdigit():
+                i += 1
+            if start == i:
+                raise ValueError("Format 's' must be followed by the maximum size")
+            items.append((c, int(fmt[start:i])))
+        elif c in _PACK_FORMATS:
+            items.append((c, 0))
+        else:
+            raise ValueError("Unknown format character '%s'" % c)
+    return items
+
+def _payload(msgRef):
+    return ffi.buffer(lib.le_msg_GetPayloadPtr(msgRef), lib.le_msg_GetMaxPayloadSize(msgRef))
+
+def _slow_pack(msgRef, offset, fmt, values):
+    buf = _payload(msgRef)
+    items = _parse_pack_format(fmt)
+    if len(items) != len(values):
+        raise TypeError("Wrong number of values for the format")
+    for (c, maxSize), value in zip(items, values):
+        if c == 's':
+            if len(value) > maxSize or offset + 4 + maxSize > len(buf):
+                raise OverflowError("Value does not fit in the message")
+            struct.pack_into('=I', buf, offset, len(value))
+            buf[offset + 4:offset + 4 + len(value)] = value
+            offset += 4 + len(value)
+        else:
+            if c == 'r' and value is None:
+                value = 0
+            struct.pack_into('=' + _PACK_FORMATS[c], buf, offset, value)
+            offset += struct.calcsize(_PACK_FORMATS[c])
+    return offset
+
+def _slow_unpack(msgRef, offset, fmt):
+    buf = _payload(msgRef)
+    values = []
+    for c, maxSize in _parse_pack_format(fmt):
+        if c == 's':
+            size, = struct.unpack_from('=I', buf, offset)
+            if size > maxSize:
+                raise OverflowError("Value does not fit in the message")
+            values.append(buf[offset + 4:offset + 4 + size])
+            offset += 4 + size
+        else:
+            value, = struct.unpack_from('=' + _PACK_FORMATS[c], buf, offset)
+            values.append(value)
+            offset += struct.calcsize(_PACK_FORMATS[c])
+    return tuple(values), offset
+
+def le_msg_Pack(msgRef, offset, fmt, *values):
+    """
+    Pack values into the payload of a message, starting at offset.
+
+    Returns the offset following the packed values.
+    """
+    if _fast:
+        return _fast.msg_Pack(_ref_to_int(msgRef), offset, fmt, *values)
+    return _slow_pack(msgRef, offset, fmt, values)
+
+def le_msg_Unpack(msgRef, offset, fmt):
+    """
+    Unpack values from the payload of a message, starting at offset.
+
+    Returns the tuple of values and the offset following them.
+    """
+    if _fast:
+        return _fast.msg_Unpack(_ref_to_int(msgRef), offset, fmt)
+    return _slow_unpack(msgRef, offset, fmt)
+
+def le_event_ServiceAll():
+    """
+    Service the event loop until there is nothing left to do.
+
+    Returns the number of times the event loop was serviced.
+    """
+    if _fast:
+        return _fast.event_ServiceAll()
+    count = 0
+    while lib.le_event_ServiceLoop() == lib.LE_OK:
+        count += 1
+    return count
+
+if _fast:
+    # Same functions as the cffi ones, but the blocking calls let other Python threads run.
+    def le_msg_CreateMsg(sessionRef):
+        return ffi.cast('le_msg_MessageRef_t', _fast.msg_CreateMsg(_ref_to_int(sessionRef)))
+
+    def le_msg_ReleaseMsg(msgRef):
+        _fast.msg_ReleaseMsg(_ref_to_int(msgRef))
+
+    def le_msg_Send(msgRef):
+        _fast.msg_Send(_ref_to_int(msgRef))
+
+    def le_msg_RequestSyncResponse(msgRef):
+        return ffi.cast('le_msg_MessageRef_t',
+                        _fast.msg_RequestSyncResponse(_ref_to_int(msgRef)))
+
+    def le_msg_Respond(msgRef):
+        _fast.msg_Respond(_ref_to_int(msgRef))
+# -end fast path-
+
 def _le_log_msg(level, formatString, *args):
     frame, filename, lineno, function, lines, index = inspect.stack()[2]
     args = map(convert_to_py, args) # convert args to python for formatting
@@ -0,0 +1,773 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file liblegato_fast.c
+ *
+ * CPython extension module providing a fast path for the hot liblegato calls of the Python
+ * bindings: packing and unpacking of messages, synchronous messaging and event loop servicing.
+ *
+ * Unlike the cffi generated bindings, a whole message is packed or unpacked in a single call,
+ * with the values described by a format string, and the blocking calls release the GIL.
+ * References are passed as integers (their address); liblegato.py converts them from and to the
+ * cffi pointers used by the rest of the bindings.
+ *
+ * Format characters:
+ *  - b, B: int8_t, uint8_t
+ *  - h, H: int16_t, uint16_t
+ *  - i, I: int32_t, uint32_t
+ *  - q, Q: int64_t, uint64_t
+ *  - ?: bool
+ *  - d: double
+ *  - z: size_t
+ *  - r: reference
+ *  - s<max>: string of at most max bytes, e.g. "s256"
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+// Python.h must be included first.
+#include <Python.h>
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a C pointer from a Python integer holding its address.
+ *
+ * @return The pointer, or NULL with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* GetPointer
+(
+    PyObject* objPtr    ///< [IN] Python integer
+)
+{
+    void* ptr = PyLong_AsVoidPtr(objPtr);
+
+    if ((NULL == ptr) && !PyErr_Occurred())
+    {
+        PyErr_SetString(PyExc_ValueError, "NULL reference");
+    }
+
+    return ptr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a message reference from the first argument of a call.
+ *
+ * @return The message reference, or NULL with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t GetMsgRef
+(
+    PyObject* argsPtr   ///< [IN] Arguments of the call
+)
+{
+    PyObject* refObjPtr;
+
+    if (!PyArg_ParseTuple(argsPtr, "O", &refObjPtr))
+    {
+        return NULL;
+    }
+
+    return GetPointer(refObjPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the payload of a message, and check that an offset is within it.
+ *
+ * @return The payload at the offset, or NULL with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* GetPayload
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] Message
+    Py_ssize_t offset,              ///< [IN] Offset in the payload
+    size_t* sizePtr                 ///< [OUT] Bytes available after the offset
+)
+{
+    size_t maxSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    if ((offset < 0) || ((size_t)offset > maxSize))
+    {
+        PyErr_SetString(PyExc_ValueError, "Offset out of the message payload");
+        return NULL;
+    }
+
+    *sizePtr = maxSize - offset;
+    return (uint8_t*)le_msg_GetPayloadPtr(msgRef) + offset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the maximum size which follows the 's' format character.
+ *
+ * @return The maximum size, or 0 with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ParseStringSize
+(
+    const char** formatPtr  ///< [IN/OUT] Format, right after the 's'
+)
+{
+    char* endPtr;
+    unsigned long maxSize = strtoul(*formatPtr, &endPtr, 10);
+
+    if ((endPtr == *formatPtr) || (0 == maxSize) || (maxSize > UINT32_MAX))
+    {
+        PyErr_SetString(PyExc_ValueError, "Format 's' must be followed by the maximum size");
+        return 0;
+    }
+
+    *formatPtr = endPtr;
+    return (uint32_t)maxSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a single value into a buffer.
+ *
+ * @return true if successful, false with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PackValue
+(
+    const char** formatPtr,     ///< [IN/OUT] Format, at the value's format character
+    PyObject* valuePtr,         ///< [IN] Value to pack
+    uint8_t** bufferPtr,        ///< [IN/OUT] Buffer
+    size_t* sizePtr             ///< [IN/OUT] Bytes available in the buffer
+)
+{
+    char format = *((*formatPtr)++);
+    bool isPacked = false;
+
+    switch (format)
+    {
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'q':
+        {
+            long long value = PyLong_AsLongLong(valuePtr);
+
+            if ((-1 == value) && PyErr_Occurred())
+            {
+                return false;
+            }
+
+            switch (format)
+            {
+                case 'b':
+                    isPacked = le_pack_PackInt8(bufferPtr, sizePtr, (int8_t)value);
+                    break;
+                case 'h':
+                    isPacked = le_pack_PackInt16(bufferPtr, sizePtr, (int16_t)value);
+                    break;
+                case 'i':
+                    isPacked = le_pack_PackInt32(bufferPtr, sizePtr, (int32_t)value);
+                    break;
+                default:
+                    isPacked = le_pack_PackInt64(bufferPtr, sizePtr, (int64_t)value);
+                    break;
+            }
+            break;
+        }
+
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'Q':
+        case 'z':
+        {
+            unsigned long long value = PyLong_AsUnsignedLongLongMask(valuePtr);
+
+            if (((unsigned long long)-1 == value) && PyErr_Occurred())
+            {
+                return false;
+            }
+
+            switch (format)
+            {
+                case 'B':
+                    isPacked = le_pack_PackUint8(bufferPtr, sizePtr, (uint8_t)value);
+                    break;
+                case 'H':
+                    isPacked = le_pack_PackUint16(bufferPtr, sizePtr, (uint16_t)value);
+                    break;
+                case 'I':
+                    isPacked = le_pack_PackUint32(bufferPtr, sizePtr, (uint32_t)value);
+                    break;
+                case 'z':
+                    isPacked = le_pack_PackSize(bufferPtr, sizePtr, (size_t)value);
+                    break;
+                default:
+                    isPacked = le_pack_PackUint64(bufferPtr, sizePtr, (uint64_t)value);
+                    break;
+            }
+            break;
+        }
+
+        case '?':
+        {
+            int value = PyObject_IsTrue(valuePtr);
+
+            if (-1 == value)
+            {
+                return false;
+            }
+            isPacked = le_pack_PackBool(bufferPtr, sizePtr, value);
+            break;
+        }
+
+        case 'd':
+        {
+            double value = PyFloat_AsDouble(valuePtr);
+
+            if ((-1.0 == value) && PyErr_Occurred())
+            {
+                return false;
+            }
+            isPacked = le_pack_PackDouble(bufferPtr, sizePtr, value);
+            break;
+        }
+
+        case 'r':
+        {
+            void* ref = (Py_None == valuePtr) ? NULL : PyLong_AsVoidPtr(valuePtr);
+
+            if (PyErr_Occurred())
+            {
+                return false;
+            }
+            isPacked = le_pack_PackReference(bufferPtr, sizePtr, ref);
+            break;
+        }
+
+        case 's':
+        {
+            uint32_t maxSize = ParseStringSize(formatPtr);
+            const char* strPtr = PyBytes_AsString(valuePtr);
+
+            if ((0 == maxSize) || (NULL == strPtr))
+            {
+                return false;
+            }
+            isPacked = le_pack_PackString(bufferPtr, sizePtr, strPtr, maxSize);
+            break;
+        }
+
+        default:
+            PyErr_Format(PyExc_ValueError, "Unknown format character '%c'", format);
+            return false;
+    }
+
+    if (!isPacked)
+    {
+        PyErr_SetString(PyExc_OverflowError, "Value does not fit in the message");
+    }
+
+    return isPacked;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a single value from a buffer.
+ *
+ * @return A new reference to the value, or NULL with a Python exception set on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* UnpackValue
+(
+    const char** formatPtr,     ///< [IN/OUT] Format, at the value's format character
+    uint8_t** bufferPtr,        ///< [IN/OUT] Buffer
+    size_t* sizePtr             ///< [IN/OUT] Bytes available in the buffer
+)
+{
+    char format = *((*formatPtr)++);
+    bool isUnpacked = false;
+    PyObject* valuePtr = NULL;
+
+    switch (format)
+    {
+        case 'b':
+        {
+            int8_t value;
+            isUnpacked = le_pack_UnpackInt8(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromLong(value) : NULL;
+            break;
+        }
+        case 'B':
+        {
+            uint8_t value;
+            isUnpacked = le_pack_UnpackUint8(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromUnsignedLong(value) : NULL;
+            break;
+        }
+        case 'h':
+        {
+            int16_t value;
+            isUnpacked = le_pack_UnpackInt16(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromLong(value) : NULL;
+            break;
+        }
+        case 'H':
+        {
+            uint16_t value;
+            isUnpacked = le_pack_UnpackUint16(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromUnsignedLong(value) : NULL;
+            break;
+        }
+        case 'i':
+        {
+            int32_t value;
+            isUnpacked = le_pack_UnpackInt32(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromLong(value) : NULL;
+            break;
+        }
+        case 'I':
+        {
+            uint32_t value;
+            isUnpacked = le_pack_UnpackUint32(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromUnsignedLong(value) : NULL;
+            break;
+        }
+        case 'q':
+        {
+            int64_t value;
+            isUnpacked = le_pack_UnpackInt64(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromLongLong(value) : NULL;
+            break;
+        }
+        case 'Q':
+        {
+            uint64_t value;
+            isUnpacked = le_pack_UnpackUint64(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromUnsignedLongLong(value) : NULL;
+            break;
+        }
+        case 'z':
+        {
+            size_t value;
+            isUnpacked = le_pack_UnpackSize(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyLong_FromSize_t(value) : NULL;
+            break;
+        }
+        case '?':
+        {
+            bool value;
+            isUnpacked = le_pack_UnpackBool(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyBool_FromLong(value) : NULL;
+            break;
+        }
+        case 'd':
+        {
+            double value;
+            isUnpacked = le_pack_UnpackDouble(bufferPtr, sizePtr, &value);
+            valuePtr = isUnpacked ? PyFloat_FromDouble(value) : NULL;
+            break;
+        }
+        case 'r':
+        {
+            void* ref;
+            isUnpacked = le_pack_UnpackReference(bufferPtr, sizePtr, &ref);
+            valuePtr = isUnpacked ? PyLong_FromVoidPtr(ref) : NULL;
+            break;
+        }
+        case 's':
+        {
+            uint32_t maxSize = ParseStringSize(formatPtr);
+            uint32_t strSize;
+
+            if (0 == maxSize)
+            {
+                return NULL;
+            }
+
+            // Unpack in place, rather than through a temporary buffer.
+            if ((*sizePtr >= (maxSize + sizeof(uint32_t))) &&
+                le_pack_UnpackUint32(bufferPtr, sizePtr, &strSize) &&
+                (strSize <= maxSize))
+            {
+                isUnpacked = true;
+                valuePtr = PyBytes_FromStringAndSize((const char*)*bufferPtr, strSize);
+                *bufferPtr += strSize;
+                *sizePtr -= maxSize;
+            }
+            break;
+        }
+
+        default:
+            PyErr_Format(PyExc_ValueError, "Unknown format character '%c'", format);
+            return NULL;
+    }
+
+    if (!isUnpacked)
+    {
+        PyErr_SetString(PyExc_OverflowError, "Value does not fit in the message");
+    }
+
+    return valuePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_Pack(msgRef, offset, format, *values)
+ *
+ * Pack values into the payload of a message, starting at an offset.
+ *
+ * @return The offset following the packed values.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgPack
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    Py_ssize_t argCount = PyTuple_Size(argsPtr);
+    PyObject* headerPtr;
+    PyObject* refObjPtr;
+    Py_ssize_t offset;
+    const char* formatPtr;
+    size_t size;
+    Py_ssize_t i;
+
+    if (argCount < 3)
+    {
+        PyErr_SetString(PyExc_TypeError, "msg_Pack(msgRef, offset, format, *values)");
+        return NULL;
+    }
+
+    headerPtr = PyTuple_GetSlice(argsPtr, 0, 3);
+    if (!PyArg_ParseTuple(headerPtr, "Ons", &refObjPtr, &offset, &formatPtr))
+    {
+        Py_DECREF(headerPtr);
+        return NULL;
+    }
+    Py_DECREF(headerPtr);
+
+    le_msg_MessageRef_t msgRef = GetPointer(refObjPtr);
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    uint8_t* bufferPtr = GetPayload(msgRef, offset, &size);
+    uint8_t* startPtr = bufferPtr;
+    if (NULL == bufferPtr)
+    {
+        return NULL;
+    }
+
+    for (i = 3; *formatPtr != '\0'; i++)
+    {
+        if (i >= argCount)
+        {
+            PyErr_SetString(PyExc_TypeError, "Not enough values for the format");
+            return NULL;
+        }
+        if (!PackValue(&formatPtr, PyTuple_GET_ITEM(argsPtr, i), &bufferPtr, &size))
+        {
+            return NULL;
+        }
+    }
+
+    if (i != argCount)
+    {
+        PyErr_SetString(PyExc_TypeError, "Too many values for the format");
+        return NULL;
+    }
+
+    return PyLong_FromSsize_t(offset + (bufferPtr - startPtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_Unpack(msgRef, offset, format)
+ *
+ * Unpack values from the payload of a message, starting at an offset.
+ *
+ * @return A tuple of the tuple of values and the offset following them.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgUnpack
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    PyObject* refObjPtr;
+    Py_ssize_t offset;
+    const char* formatPtr;
+    size_t size;
+
+    if (!PyArg_ParseTuple(argsPtr, "Ons", &refObjPtr, &offset, &formatPtr))
+    {
+        return NULL;
+    }
+
+    le_msg_MessageRef_t msgRef = GetPointer(refObjPtr);
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    uint8_t* bufferPtr = GetPayload(msgRef, offset, &size);
+    uint8_t* startPtr = bufferPtr;
+    if (NULL == bufferPtr)
+    {
+        return NULL;
+    }
+
+    PyObject* valuesPtr = PyList_New(0);
+    if (NULL == valuesPtr)
+    {
+        return NULL;
+    }
+
+    while (*formatPtr != '\0')
+    {
+        PyObject* valuePtr = UnpackValue(&formatPtr, &bufferPtr, &size);
+
+        if ((NULL == valuePtr) || (-1 == PyList_Append(valuesPtr, valuePtr)))
+        {
+            Py_XDECREF(valuePtr);
+            Py_DECREF(valuesPtr);
+            return NULL;
+        }
+        Py_DECREF(valuePtr);
+    }
+
+    PyObject* resultPtr = Py_BuildValue("Nn", PyList_AsTuple(valuesPtr),
+                                        offset + (bufferPtr - startPtr));
+    Py_DECREF(valuesPtr);
+
+    return resultPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_CreateMsg(sessionRef)
+ *
+ * @return The new message reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgCreateMsg
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    PyObject* refObjPtr;
+
+    if (!PyArg_ParseTuple(argsPtr, "O", &refObjPtr))
+    {
+        return NULL;
+    }
+
+    le_msg_SessionRef_t sessionRef = GetPointer(refObjPtr);
+    if (NULL == sessionRef)
+    {
+        return NULL;
+    }
+
+    return PyLong_FromVoidPtr(le_msg_CreateMsg(sessionRef));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_ReleaseMsg(msgRef)
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgReleaseMsg
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    le_msg_MessageRef_t msgRef = GetMsgRef(argsPtr);
+
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    le_msg_ReleaseMsg(msgRef);
+    Py_RETURN_NONE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_Send(msgRef)
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgSend
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    le_msg_MessageRef_t msgRef = GetMsgRef(argsPtr);
+
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    le_msg_Send(msgRef);
+    Py_RETURN_NONE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_RequestSyncResponse(msgRef)
+ *
+ * Sends a request and waits for the response, letting the other Python threads run meanwhile.
+ *
+ * @return The response message reference, or 0 if the session was closed.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgRequestSyncResponse
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    le_msg_MessageRef_t msgRef = GetMsgRef(argsPtr);
+    le_msg_MessageRef_t responseRef;
+
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    responseRef = le_msg_RequestSyncResponse(msgRef);
+    Py_END_ALLOW_THREADS
+
+    return PyLong_FromVoidPtr(responseRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * msg_Respond(msgRef)
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* MsgRespond
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    le_msg_MessageRef_t msgRef = GetMsgRef(argsPtr);
+
+    if (NULL == msgRef)
+    {
+        return NULL;
+    }
+
+    le_msg_Respond(msgRef);
+    Py_RETURN_NONE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * event_ServiceAll()
+ *
+ * Services the calling thread's event loop until there is nothing left to do.  The GIL is
+ * released meanwhile; Python handlers take it back when they are called.
+ *
+ * @return The number of times the event loop was serviced.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyObject* EventServiceAll
+(
+    PyObject* selfPtr,
+    PyObject* argsPtr
+)
+{
+    long count = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    while (LE_OK == le_event_ServiceLoop())
+    {
+        count++;
+    }
+    Py_END_ALLOW_THREADS
+
+    return PyLong_FromLong(count);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Methods of the module.
+ */
+//--------------------------------------------------------------------------------------------------
+static PyMethodDef Methods[] =
+{
+    { "msg_Pack", MsgPack, METH_VARARGS, "Pack values into a message" },
+    { "msg_Unpack", MsgUnpack, METH_VARARGS, "Unpack values from a message" },
+    { "msg_CreateMsg", MsgCreateMsg, METH_VARARGS, "Create a message" },
+    { "msg_ReleaseMsg", MsgReleaseMsg, METH_VARARGS, "Release a message" },
+    { "msg_Send", MsgSend, METH_VARARGS, "Send a message" },
+    { "msg_RequestSyncResponse", MsgRequestSyncResponse, METH_VARARGS,
+      "Send a request and wait for the response" },
+    { "msg_Respond", MsgRespond, METH_VARARGS, "Respond to a request" },
+    { "event_ServiceAll", EventServiceAll, METH_NOARGS,
+      "Service the event loop until there is nothing left to do" },
+    { NULL, NULL, 0, NULL }
+};
+
+
+#if PY_MAJOR_VERSION >= 3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Definition of the module.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct PyModuleDef Module =
+{
+    PyModuleDef_HEAD_INIT,
+    "_liblegato_fast",
+    "Fast path for the hot liblegato calls",
+    -1,
+    Methods
+};
+
+PyMODINIT_FUNC PyInit__liblegato_fast
+(
+    void
+)
+{
+    return PyModule_Create(&Module);
+}
+
+#else
+
+PyMODINIT_FUNC init_liblegato_fast
+(
+    void
+)
+{
+    Py_InitModule3("_liblegato_fast", Methods, "Fast path for the hot liblegato calls");
+}
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * Test of the Legato Arena Allocator API.
+ *
+ * Fills an arena across several chunks, checks that blocks don't overlap and are aligned, then
+ * checks that resetting and rewinding reuse the arena's chunks instead of taking more from the
+ * chunk pool, and that freeing the arena gives them all back.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+/// Size of the chunks in the test's chunk pool.
+#define CHUNK_BYTES     256
+
+/// Number of blocks allocated in each round.
+#define NUM_BLOCKS      100
+
+
+static le_mem_PoolRef_t ChunkPool;
+static le_arena_Arena_t Arena;
+static uint8_t* Blocks[NUM_BLOCKS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of chunks taken from the test's chunk pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ChunksInUse
+(
+    void
+)
+{
+    le_mem_PoolStats_t stats;
+
+    le_mem_GetStats(ChunkPool, &stats);
+
+    return stats.numBlocksInUse;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates NUM_BLOCKS blocks of varying sizes, each filled with its index.
+ *
+ * @return true if all the blocks are suitably aligned.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FillBlocks
+(
+    void
+)
+{
+    bool isAligned = true;
+    size_t i;
+
+    for (i = 0; i < NUM_BLOCKS; i++)
+    {
+        size_t size = 1 + (i % 23);
+
+        Blocks[i] = le_arena_ForceAlloc(&Arena, size);
+        memset(Blocks[i], (int)i, size);
+        isAligned = isAligned && (((uintptr_t)Blocks[i] % sizeof(void*)) == 0);
+    }
+
+    return isAligned;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that every block allocated by FillBlocks() still holds its index.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckBlocks
+(
+    size_t numBlocks
+)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < numBlocks; i++)
+    {
+        for (j = 0; j < 1 + (i % 23); j++)
+        {
+            if (Blocks[i][j] != (uint8_t)i)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(9);
+
+    ChunkPool = le_mem_CreatePool("ArenaTestChunk", CHUNK_BYTES);
+    le_arena_Init(&Arena, ChunkPool);
+
+    LE_TEST_OK(ChunksInUse() == 0, "No chunk is taken before the first allocation");
+
+    LE_TEST_OK(FillBlocks(), "Blocks are aligned");
+    LE_TEST_OK(CheckBlocks(NUM_BLOCKS), "Blocks don't overlap");
+
+    size_t numChunks = ChunksInUse();
+    LE_TEST_OK(numChunks > 1, "Allocations spread over %zu chunks", numChunks);
+
+    le_arena_Reset(&Arena);
+    FillBlocks();
+    LE_TEST_OK(CheckBlocks(NUM_BLOCKS) && (ChunksInUse() == numChunks),
+               "Reset arena is refilled without taking more chunks");
+
+    // Rewind to half way, then allocate the second half again, plus a block too big for a chunk.
+    le_arena_Reset(&Arena);
+    size_t i;
+    for (i = 0; i < NUM_BLOCKS / 2; i++)
+    {
+        size_t size = 1 + (i % 23);
+
+        Blocks[i] = le_arena_ForceAlloc(&Arena, size);
+        memset(Blocks[i], (int)i, size);
+    }
+
+    le_arena_Mark_t mark = le_arena_GetMark(&Arena);
+    char* largePtr = le_arena_ForceAlloc(&Arena, 4 * CHUNK_BYTES);
+    memset(largePtr, 0xFF, 4 * CHUNK_BYTES);
+    char* copyPtr = le_arena_StrDup(&Arena, "arena");
+    LE_TEST_OK(strcmp(copyPtr, "arena") == 0, "String is copied into the arena");
+
+    le_arena_Rewind(&Arena, &mark);
+    for (i = NUM_BLOCKS / 2; i < NUM_BLOCKS; i++)
+    {
+        size_t size = 1 + (i % 23);
+
+        Blocks[i] = le_arena_ForceAlloc(&Arena, size);
+        memset(Blocks[i], (int)i, size);
+    }
+    LE_TEST_OK(CheckBlocks(NUM_BLOCKS), "Blocks allocated before the mark survive a rewind");
+    LE_TEST_OK(ChunksInUse() == numChunks, "Rewound arena is refilled without taking more chunks");
+
+    le_arena_Free(&Arena);
+    LE_TEST_OK(ChunksInUse() == 0, "Freeing the arena gives back all its chunks");
+
+    LE_TEST_EXIT;
+}
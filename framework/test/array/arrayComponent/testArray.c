@@ -0,0 +1,314 @@
+/**
+ * Test of the Legato Array Containers API.
+ *
+ * Fills each kind of container past several growth steps and checks its contents against a
+ * simple reference, then checks that all the storage has been given back to the slab allocator.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+/// Number of elements put in each container.
+#define NUM_ELEMS       1000
+
+/// Largest block the slab allocator will hand out.
+#define MAX_BLOCK_SIZE  (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Element stored in the containers.  Larger than a word so that the byte swaps are exercised.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    key;
+    uint32_t    value;
+    uint8_t     padding[12];
+}
+Elem_t;
+
+
+static le_mem_SlabRef_t Slab;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives a scrambled sequence of distinct keys.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Key
+(
+    uint32_t i
+)
+{
+    return (i * 7919) % 10007;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares two elements by key.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareElems
+(
+    const void* firstElemPtr,
+    const void* secondElemPtr
+)
+{
+    uint32_t a = ((const Elem_t*)firstElemPtr)->key;
+    uint32_t b = ((const Elem_t*)secondElemPtr)->key;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares a key with an element's key.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareKey
+(
+    const void* keyPtr,
+    const void* elemPtr
+)
+{
+    uint32_t a = *(const uint32_t*)keyPtr;
+    uint32_t b = ((const Elem_t*)elemPtr)->key;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests vectors.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestVector
+(
+    void
+)
+{
+    le_vec_Vector_t vec;
+    uint32_t i;
+    bool isRight = true;
+
+    le_vec_Init(&vec, Slab, sizeof(Elem_t));
+
+    // Even values appended, odd values inserted between them.
+    for (i = 0; i < NUM_ELEMS; i += 2)
+    {
+        Elem_t* elemPtr = le_vec_Append(&vec);
+        isRight = isRight && (elemPtr->key == 0) && (elemPtr->value == 0);
+        elemPtr->value = i;
+    }
+    for (i = 1; i < NUM_ELEMS; i += 2)
+    {
+        ((Elem_t*)le_vec_Insert(&vec, i))->value = i;
+    }
+
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        isRight = isRight && (((Elem_t*)le_vec_Get(&vec, i))->value == i);
+    }
+    LE_TEST_OK(isRight && (le_vec_NumElems(&vec) == NUM_ELEMS),
+               "Vector holds appended and inserted elements in order");
+
+    // Remove the odd values again.
+    for (i = 1; i <= NUM_ELEMS / 2; i++)
+    {
+        le_vec_Remove(&vec, i);
+    }
+    for (i = 0; i < NUM_ELEMS / 2; i++)
+    {
+        isRight = isRight && (((Elem_t*)le_vec_Get(&vec, i))->value == 2 * i);
+    }
+    LE_TEST_OK(isRight && (le_vec_NumElems(&vec) == NUM_ELEMS / 2),
+               "Vector elements are removed from the middle");
+
+    le_vec_Free(&vec);
+    LE_TEST_OK(le_vec_NumElems(&vec) == 0, "Vector is empty after being freed");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests ring buffers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestRing
+(
+    void
+)
+{
+    le_ring_Buffer_t ring;
+    uint32_t nextIn = 0;
+    uint32_t nextOut = 0;
+    uint32_t i;
+    bool isRight = true;
+    Elem_t elem;
+
+    le_ring_Init(&ring, Slab, sizeof(Elem_t));
+
+    LE_TEST_OK(!le_ring_PopFront(&ring, &elem) && (le_ring_PeekFront(&ring) == NULL),
+               "Empty ring buffer has nothing to pop");
+
+    // Push three, pop two, so the contents wrap around while the ring buffer grows.
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        ((Elem_t*)le_ring_PushBack(&ring))->value = nextIn++;
+        ((Elem_t*)le_ring_PushBack(&ring))->value = nextIn++;
+        ((Elem_t*)le_ring_PushBack(&ring))->value = nextIn++;
+
+        isRight = isRight && (((Elem_t*)le_ring_PeekFront(&ring))->value == nextOut);
+        isRight = isRight && le_ring_PopFront(&ring, &elem) && (elem.value == nextOut++);
+        isRight = isRight && le_ring_PopFront(&ring, NULL);
+        nextOut++;
+    }
+
+    for (i = 0; i < le_ring_NumElems(&ring); i++)
+    {
+        isRight = isRight && (((Elem_t*)le_ring_Get(&ring, i))->value == nextOut + i);
+    }
+    LE_TEST_OK(isRight && (le_ring_NumElems(&ring) == nextIn - nextOut),
+               "Ring buffer keeps elements in order while wrapping and growing");
+
+    while (le_ring_PopFront(&ring, &elem))
+    {
+        isRight = isRight && (elem.value == nextOut++);
+    }
+    LE_TEST_OK(isRight && (nextOut == nextIn), "Ring buffer drains in order");
+
+    le_ring_Free(&ring);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests heaps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestHeap
+(
+    void
+)
+{
+    le_heap_Heap_t heap;
+    uint32_t i;
+    uint32_t lastKey = 0;
+    size_t numPopped = 0;
+    bool isRight = true;
+    Elem_t elem;
+
+    le_heap_Init(&heap, Slab, sizeof(Elem_t), CompareElems);
+
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        memset(&elem, 0, sizeof(elem));
+        elem.key = Key(i);
+        elem.value = i;
+        le_heap_Push(&heap, &elem);
+    }
+    LE_TEST_OK(le_heap_NumElems(&heap) == NUM_ELEMS, "Heap holds all the pushed elements");
+
+    while (le_heap_NumElems(&heap) > 0)
+    {
+        uint32_t peekedKey = ((Elem_t*)le_heap_Peek(&heap))->key;
+
+        isRight = isRight && le_heap_Pop(&heap, &elem) && (elem.key == peekedKey);
+        isRight = isRight && (elem.key >= lastKey) && (Key(elem.value) == elem.key);
+        lastKey = elem.key;
+        numPopped++;
+    }
+    LE_TEST_OK(isRight && (numPopped == NUM_ELEMS), "Heap pops elements in key order");
+    LE_TEST_OK(!le_heap_Pop(&heap, &elem) && (le_heap_Peek(&heap) == NULL),
+               "Empty heap has nothing to pop");
+
+    le_heap_Free(&heap);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests array maps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestMap
+(
+    void
+)
+{
+    le_amap_Map_t map;
+    uint32_t i;
+    bool isRight = true;
+    bool isNew;
+
+    le_amap_Init(&map, Slab, sizeof(Elem_t), CompareKey);
+
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        uint32_t key = Key(i);
+        Elem_t* elemPtr = le_amap_Insert(&map, &key, &isNew);
+
+        isRight = isRight && isNew;
+        elemPtr->key = key;
+        elemPtr->value = i;
+    }
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        uint32_t key = Key(i);
+
+        isRight = isRight && (((Elem_t*)le_amap_Insert(&map, &key, &isNew))->value == i);
+        isRight = isRight && !isNew;
+    }
+    LE_TEST_OK(isRight && (le_amap_NumElems(&map) == NUM_ELEMS),
+               "Array map inserts each key once");
+
+    for (i = 1; i < le_amap_NumElems(&map); i++)
+    {
+        isRight = isRight && (((Elem_t*)le_amap_GetAt(&map, i - 1))->key
+                              < ((Elem_t*)le_amap_GetAt(&map, i))->key);
+    }
+    LE_TEST_OK(isRight, "Array map elements are in key order");
+
+    for (i = 0; i < NUM_ELEMS; i += 2)
+    {
+        uint32_t key = Key(i);
+        isRight = isRight && le_amap_Remove(&map, &key) && !le_amap_Remove(&map, &key);
+    }
+    for (i = 0; i < NUM_ELEMS; i++)
+    {
+        uint32_t key = Key(i);
+        Elem_t* elemPtr = le_amap_Find(&map, &key);
+
+        isRight = isRight && ((i % 2 == 0) ? (elemPtr == NULL) : (elemPtr->value == i));
+    }
+    LE_TEST_OK(isRight && (le_amap_NumElems(&map) == NUM_ELEMS / 2),
+               "Array map finds the remaining keys after removals");
+
+    le_amap_Free(&map);
+}
+
+
+COMPONENT_INIT
+{
+    le_mem_PoolStats_t stats;
+
+    LE_TEST_PLAN(13);
+
+    Slab = le_mem_CreateSlabAllocator("ArrayTest", MAX_BLOCK_SIZE);
+
+    TestVector();
+    TestRing();
+    TestHeap();
+    TestMap();
+
+    le_mem_GetSlabStats(Slab, &stats);
+    LE_TEST_OK(stats.numBlocksInUse == 0, "All container storage was released");
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,104 @@
+/**
+ * Test of the Legato Config Snapshot API.
+ *
+ * Writes values of each type to the app's config tree through the Config Tree API, then checks
+ * that a snapshot reads the same values, that an open snapshot doesn't change when the tree does,
+ * and that reopening it shows the change.  Also checks that the app's settings in the system tree
+ * can be read.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+/// Base path of the values written by the test.
+#define BASE_PATH   "/cfgSnapshotTest"
+
+/// Name of the test app, under which its settings are kept in the system tree.
+#define APP_NAME    "test_CfgSnapshot"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the test values to the app's config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteValues
+(
+    int32_t intValue    ///< [IN] Value to write to the integer node.
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(BASE_PATH);
+
+    le_cfg_SetString(iterRef, "string", "snapshot");
+    le_cfg_SetInt(iterRef, "group/int", intValue);
+    le_cfg_SetFloat(iterRef, "group/float", 2.75);
+    le_cfg_SetBool(iterRef, "group/bool", false);
+    le_cfg_SetEmpty(iterRef, "empty");
+
+    le_cfg_CommitTxn(iterRef);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(13);
+
+    WriteValues(42);
+
+    le_cfgSnapshot_Ref_t snapshotRef = le_cfgSnapshot_Open(BASE_PATH);
+
+    LE_TEST_ASSERT(snapshotRef != NULL, "Snapshot of the app's tree is opened");
+
+    char buffer[32];
+
+    LE_TEST_OK(   (le_cfgSnapshot_GetString(snapshotRef, "string", buffer, sizeof(buffer), "")
+                   == LE_OK)
+               && (strcmp(buffer, "snapshot") == 0),
+               "String value is read");
+    LE_TEST_OK(le_cfgSnapshot_GetInt(snapshotRef, "group/int", 0) == 42, "Integer value is read");
+    LE_TEST_OK(le_cfgSnapshot_GetFloat(snapshotRef, "group/float", 0.0) == 2.75,
+               "Floating point value is read");
+    LE_TEST_OK(le_cfgSnapshot_GetInt(snapshotRef, "group/float", 0) == 3,
+               "Floating point value is rounded to an integer");
+    LE_TEST_OK(le_cfgSnapshot_GetBool(snapshotRef, "group/bool", true) == false,
+               "Boolean value is read");
+    LE_TEST_OK(le_cfgSnapshot_GetBool(snapshotRef, "string", true) == true,
+               "Default value is returned for a value of another type");
+    LE_TEST_OK(   le_cfgSnapshot_NodeExists(snapshotRef, "group")
+               && !le_cfgSnapshot_NodeExists(snapshotRef, "missing"),
+               "Existing and missing nodes are told apart");
+    LE_TEST_OK(   (le_cfgSnapshot_GetString(snapshotRef, "empty", buffer, sizeof(buffer), "default")
+                   == LE_OK)
+               && (strcmp(buffer, "default") == 0),
+               "Default value is returned for an empty node");
+
+    WriteValues(43);
+
+    LE_TEST_OK(le_cfgSnapshot_GetInt(snapshotRef, "group/int", 0) == 42,
+               "Open snapshot doesn't change when the tree does");
+
+    le_cfgSnapshot_Close(snapshotRef);
+
+    snapshotRef = le_cfgSnapshot_Open(BASE_PATH "/group");
+
+    LE_TEST_ASSERT(snapshotRef != NULL, "Snapshot is reopened");
+    LE_TEST_OK(le_cfgSnapshot_GetInt(snapshotRef, "int", 0) == 43,
+               "Reopened snapshot shows the change");
+
+    le_cfgSnapshot_Close(snapshotRef);
+
+    snapshotRef = le_cfgSnapshot_Open("system:/apps/" APP_NAME);
+
+    LE_TEST_OK(   (snapshotRef != NULL)
+               && le_cfgSnapshot_NodeExists(snapshotRef, "procs"),
+               "App's settings in the system tree are read");
+
+    if (snapshotRef != NULL)
+    {
+        le_cfgSnapshot_Close(snapshotRef);
+    }
+
+    LE_TEST_EXIT;
+}
@@ -12,7 +12,7 @@ COMPONENT_INIT
     size_t numChars;
     le_result_t result;
 
-    LE_TEST_PLAN(40);
+    LE_TEST_PLAN(43);
 
     /*
      * Clock related tests
@@ -26,6 +26,17 @@ COMPONENT_INIT
     le_clk_GetAbsoluteTime();
     LE_TEST_OK(true, "Absolute clock exists");
 
+    le_clk_Time_t coarseTime = le_clk_GetCoarseTime();
+    LE_TEST_OK(!le_clk_GreaterThan(coarseTime, le_clk_GetCoarseTime()),
+               "Coarse clock is monotonic");
+
+    // The component initializer is called by the event loop, so the dispatch time is fixed.
+    le_clk_Time_t dispatchTime = le_clk_GetDispatchTime();
+    LE_TEST_OK(!le_clk_GreaterThan(dispatchTime, le_clk_GetRelativeTime()),
+               "Dispatch time is not in the future");
+    LE_TEST_OK(le_clk_Equal(dispatchTime, le_clk_GetDispatchTime()),
+               "Dispatch time doesn't change within a handler");
+
 
     /*
      * UTC date/time related tests
@@ -0,0 +1,191 @@
+/**
+ * Test of the Legato Coroutine API.
+ *
+ * Runs coroutines that sleep, wait for a pipe to become readable, and wait to be resumed from
+ * another thread and from themselves, plus many coroutines sleeping at the same time.  The test
+ * ends when the last coroutine ends.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+/// Number of coroutines sleeping at the same time.
+#define NUM_SLEEPERS    1000
+
+/// Time the coroutines sleep for, in milliseconds.
+#define SLEEP_MS        50
+
+
+/// Number of coroutines that haven't ended yet.
+static size_t Remaining;
+
+/// Number of the sleepers that have woken up.
+static size_t NumAwake;
+
+/// The pipe the reader and the writer coroutines share.
+static int Pipe[2];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the test when the last coroutine ends.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoroutineDone
+(
+    void
+)
+{
+    if (--Remaining == 0)
+    {
+        LE_TEST_OK(NumAwake == NUM_SLEEPERS, "%zu sleeping coroutines woke up", NumAwake);
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sleeps for a while.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Sleeper
+(
+    void* contextPtr
+)
+{
+    le_coro_Sleep(SLEEP_MS);
+    NumAwake++;
+
+    CoroutineDone();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that sleeping takes as long as asked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimedSleeper
+(
+    void* contextPtr
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    le_coro_Sleep(SLEEP_MS);
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    LE_TEST_OK((elapsed.sec * 1000 + elapsed.usec / 1000) >= SLEEP_MS, "Sleep takes long enough");
+
+    CoroutineDone();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a byte to arrive on the pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Reader
+(
+    void* contextPtr
+)
+{
+    short events = le_coro_AwaitFd(Pipe[0], POLLIN);
+    char byte = 0;
+
+    LE_TEST_OK(   (events & POLLIN)
+               && (read(Pipe[0], &byte, 1) == 1)
+               && (byte == 'x'),
+               "Coroutine waits for a file descriptor");
+
+    CoroutineDone();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a byte to the pipe after a while.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Writer
+(
+    void* contextPtr
+)
+{
+    le_coro_Sleep(SLEEP_MS);
+
+    LE_ASSERT(write(Pipe[1], "x", 1) == 1);
+
+    CoroutineDone();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that resumes a coroutine.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ResumerThread
+(
+    void* contextPtr
+)
+{
+    le_coro_Resume(contextPtr, (void*)42);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits to be resumed by another thread, then by itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Awaiter
+(
+    void* contextPtr
+)
+{
+    le_coro_Ref_t selfRef = le_coro_GetCurrent();
+
+    LE_TEST_OK(selfRef != NULL, "Coroutine is current while running");
+
+    le_thread_Start(le_thread_Create("resumer", ResumerThread, selfRef));
+
+    LE_TEST_OK(le_coro_Await() == (void*)42, "Coroutine is resumed from another thread");
+
+    le_coro_Resume(selfRef, (void*)43);
+
+    LE_TEST_OK(le_coro_Await() == (void*)43, "Coroutine resumed before waiting doesn't wait");
+
+    CoroutineDone();
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(7);
+
+    LE_TEST_OK(le_coro_GetCurrent() == NULL, "No coroutine is current outside of coroutines");
+
+    LE_ASSERT(pipe(Pipe) == 0);
+
+    Remaining = NUM_SLEEPERS + 4;
+
+    for (size_t i = 0; i < NUM_SLEEPERS; i++)
+    {
+        le_coro_Ref_t coroRef = le_coro_Create("sleeper", Sleeper, NULL);
+
+        LE_ASSERT(le_coro_SetStackSize(coroRef, LE_CORO_MIN_STACK_SIZE) == LE_OK);
+        le_coro_Start(coroRef);
+    }
+
+    le_coro_Start(le_coro_Create("timedSleeper", TimedSleeper, NULL));
+    le_coro_Start(le_coro_Create("reader", Reader, NULL));
+    le_coro_Start(le_coro_Create("writer", Writer, NULL));
+    le_coro_Start(le_coro_Create("awaiter", Awaiter, NULL));
+}
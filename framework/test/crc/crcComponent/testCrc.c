@@ -6,6 +6,31 @@
 
 #include "legato.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference CRC-32, computed one bit at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReferenceCrc32
+(
+    const uint8_t* addressPtr,
+    size_t size,
+    uint32_t crc
+)
+{
+    while (size-- > 0)
+    {
+        int bit;
+
+        crc ^= *addressPtr++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+        }
+    }
+    return crc;
+}
+
 COMPONENT_INIT
 {
     uint32_t    crc;
@@ -19,8 +44,11 @@ COMPONENT_INIT
                     0xFE, 0xFE, 0xFE, 0xFE
                 };
     uint8_t     data3[2] = { 0x00, 0x00 };
+    static uint8_t bigData[4096];
+    size_t      i;
+    bool        allMatch = true;
 
-    LE_TEST_PLAN(3); // Indicate that there are 3 test cases in this app.
+    LE_TEST_PLAN(5); // Indicate that there are 5 test cases in this app.
 
     // Execute the 3 test cases.
     crc = le_crc_Crc32(data1, sizeof(data1), LE_CRC_START_CRC32);
@@ -38,6 +66,48 @@ COMPONENT_INIT
     LE_TEST_OK(crc == expected, "Verified final CRC (0x%08" PRIX32 ") is valid (0x%08" PRIX32 ")",
         crc, expected);
 
+    // Check every length and alignment around the block sizes against the reference.
+    for (i = 0; i < sizeof(bigData); i++)
+    {
+        bigData[i] = (uint8_t)((i * 2654435761U) >> 13);
+    }
+    for (i = 0; (i < 300) && allMatch; i++)
+    {
+        size_t offset;
+
+        for (offset = 0; offset < 8; offset++)
+        {
+            if (le_crc_Crc32(bigData + offset, i, LE_CRC_START_CRC32) !=
+                ReferenceCrc32(bigData + offset, i, LE_CRC_START_CRC32))
+            {
+                LE_TEST_INFO("Mismatch for length %zu at offset %zu", i, offset);
+                allMatch = false;
+            }
+        }
+    }
+    LE_TEST_OK(allMatch &&
+               (le_crc_Crc32(bigData, sizeof(bigData), LE_CRC_START_CRC32) ==
+                ReferenceCrc32(bigData, sizeof(bigData), LE_CRC_START_CRC32)),
+               "Verified CRC of all lengths and alignments");
+
+    // The same data, split over several buffers.
+    {
+        le_crc_Buffer_t buffers[] =
+        {
+            { bigData, 3 },
+            { NULL, 100 },
+            { bigData + 3, 0 },
+            { bigData + 3, 1000 },
+            { bigData + 1003, sizeof(bigData) - 1003 }
+        };
+
+        crc = le_crc_Crc32Buffers(buffers, NUM_ARRAY_MEMBERS(buffers), LE_CRC_START_CRC32);
+        expected = ReferenceCrc32(bigData, sizeof(bigData), LE_CRC_START_CRC32);
+        LE_TEST_OK(crc == expected,
+                   "Verified multi-buffer CRC (0x%08" PRIX32 ") is valid (0x%08" PRIX32 ")",
+                   crc, expected);
+    }
+
     // End the test sequence.
     LE_TEST_EXIT;
 }
@@ -26,10 +26,7 @@ static const char* ServiceOpenContextPtr = ContextStr;
  * Pool for burger messages.
  */
 //--------------------------------------------------------------------------------------------------
-LE_MEM_DEFINE_STATIC_POOL(BurgerMessage,
-                          2,
-                          LE_MSG_LOCAL_HEADER_SIZE +
-                          sizeof(burger_Message_t));
+static le_mem_PoolRef_t BurgerMessagePoolRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -187,12 +184,13 @@ void burgerServer_Init
 )
 {
 #if defined(TEST_LOCAL)
+    BurgerMessagePoolRef = le_mem_CreatePool("BurgerMessage",
+                                             LE_MSG_LOCAL_HEADER_SIZE + sizeof(burger_Message_t));
+    le_mem_ExpandPool(BurgerMessagePoolRef, 2);
+
     BurgerServiceRef = le_msg_InitLocalService(&BurgerService,
                                                serviceInstanceName,
-                                               le_mem_InitStaticPool(BurgerMessage,
-                                                                     2,
-                                                                     LE_MSG_LOCAL_HEADER_SIZE +
-                                                                     sizeof(burger_Message_t)));
+                                               BurgerMessagePoolRef);
 #endif
 }
 
@@ -0,0 +1,169 @@
+/**
+ * Test of the Legato Thread Pool API.
+ *
+ * Submits tasks from the main thread and checks that they all run and that their completion
+ * functions are called on the main thread, then has a task submit more tasks from its worker and
+ * checks that deleting the pool waits for them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+/// Number of workers in the pool.
+#define NUM_WORKERS         4
+
+/// Number of tasks submitted by the main thread.
+#define NUM_TASKS           200
+
+/// Number of tasks submitted by a worker.
+#define NUM_CHILD_TASKS     50
+
+
+static le_threadPool_Ref_t PoolRef;
+static le_thread_Ref_t MainThreadRef;
+static pthread_mutex_t CountMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int Values[NUM_TASKS];
+static size_t RunCount;
+static size_t CompletionCount;
+static size_t ChildRunCount;
+static bool AllOnMainThread = true;
+static bool AllResultsRight = true;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Increments a counter shared with the workers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Increment
+(
+    size_t* counterPtr
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&CountMutex) == 0);
+    (*counterPtr)++;
+    LE_ASSERT(pthread_mutex_unlock(&CountMutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work function of the tasks submitted by the main thread: squares its value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* Square
+(
+    void* contextPtr
+)
+{
+    int* valuePtr = contextPtr;
+
+    // Give the other workers a chance to steal.
+    usleep(1000);
+
+    *valuePtr = (*valuePtr) * (*valuePtr);
+
+    Increment(&RunCount);
+
+    return valuePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work function of the tasks submitted by a worker.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* Child
+(
+    void* contextPtr
+)
+{
+    Increment(&ChildRunCount);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work function of a task that submits more tasks to its own pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* Parent
+(
+    void* contextPtr
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_CHILD_TASKS; i++)
+    {
+        le_threadPool_Submit(PoolRef, Child, NULL, NULL);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion function of the tasks submitted by the main thread.  Once they are all done, runs the
+ * rest of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SquareDone
+(
+    void* contextPtr,
+    void* resultPtr
+)
+{
+    int index = (int*)contextPtr - Values;
+
+    if (le_thread_GetCurrent() != MainThreadRef)
+    {
+        AllOnMainThread = false;
+    }
+    if ((resultPtr != contextPtr) || (Values[index] != index * index))
+    {
+        LE_TEST_INFO("Wrong result for task %d: %d", index, Values[index]);
+        AllResultsRight = false;
+    }
+
+    if (++CompletionCount < NUM_TASKS)
+    {
+        return;
+    }
+
+    LE_TEST_OK(RunCount == NUM_TASKS, "All %d tasks ran", NUM_TASKS);
+    LE_TEST_OK(AllResultsRight, "All tasks computed the right result");
+    LE_TEST_OK(AllOnMainThread, "All completion functions were called on the main thread");
+
+    le_threadPool_Submit(PoolRef, Parent, NULL, NULL);
+
+    le_threadPool_Delete(PoolRef);
+
+    LE_TEST_OK(ChildRunCount == NUM_CHILD_TASKS,
+               "Deleting the pool waited for the %d tasks submitted by a worker", NUM_CHILD_TASKS);
+
+    LE_TEST_EXIT;
+}
+
+
+COMPONENT_INIT
+{
+    int i;
+
+    LE_TEST_PLAN(4);
+
+    MainThreadRef = le_thread_GetCurrent();
+    PoolRef = le_threadPool_Create("testPool", NUM_WORKERS);
+
+    for (i = 0; i < NUM_TASKS; i++)
+    {
+        Values[i] = i;
+        le_threadPool_Submit(PoolRef, Square, SquareDone, &Values[i]);
+    }
+}
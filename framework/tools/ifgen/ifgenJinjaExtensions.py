@@ -51,6 +51,9 @@ def IsStringParameter(paramObj):
 def IsArrayParameter(paramObj):
     return isinstance(paramObj, interfaceIR.ArrayParameter)
 
+def IsSharedParameter(paramObj):
+    return isinstance(paramObj, interfaceIR.SharedParameter)
+
 ### Structure member tests
 def IsStringMember(memberObj):
     return isinstance(memberObj, interfaceIR.StructStringMember)
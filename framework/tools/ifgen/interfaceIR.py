@@ -162,6 +162,19 @@ class HandlerType(Type):
         if any([isinstance(parameter.apiType, HandlerType) for parameter in self.parameters]):
             raise Exception("Handlers cannot have handler parameters")
 
+        if any([isinstance(parameter, SharedParameter) for parameter in self.parameters]):
+            raise Exception("Handlers cannot have shared buffer parameters")
+
+    def GetMaxInputSize(self):
+        """
+        Get size of the largest message for a call to this handler, not including the message ID,
+        or None if it can't be known.  The message starts with the client's context pointer.
+        """
+        size = GetMaxInputSize(self.parameters)
+        if size is None:
+            return None
+        return self.size + size
+
     def __str__(self):
         return "Handler %s(%s)" \
             % (self.name,
@@ -199,7 +212,8 @@ class StructStringMember(StructMember):
         self.maxCount = maxCount
 
     def MaxSize(self):
-        return self.maxCount * self.apiType.size
+        # Strings are packed with their length first.
+        return UINT32_TYPE.size + self.maxCount * self.apiType.size
 
     def __str__(self):
         return "{} {}[{}]".format(self.apiType, self.name, self.maxCount)
@@ -210,7 +224,8 @@ class StructArrayMember(StructMember):
         self.maxCount = maxCount
 
     def MaxSize(self):
-        return self.maxCount * self.apiType.size
+        # Arrays are packed with their element count first.
+        return UINT32_TYPE.size + self.maxCount * self.apiType.size
 
     def __str__(self):
         return "{} {}[{}]".format(self.apiType, self.name, self.maxCount)
@@ -240,6 +255,8 @@ def MakeStructMember(interface, typeObj, name, arraySize):
         if arraySize == None:
             raise Exception("String needs a size limit")
         return StructStringMember(name, arraySize)
+    elif typeObj == SHARED_TYPE:
+        raise Exception("Structures cannot have shared buffer members")
     elif arraySize != None:
         # If a range is provided, it's an array
         return StructArrayMember(typeObj, name, arraySize)
@@ -265,6 +282,7 @@ DOUBLE_TYPE = BasicType('double', 8)
 SIZE_TYPE   = BasicType('size', 4)
 STRING_TYPE = BasicType('string', 1)
 FILE_TYPE   = BasicType('file', 0)
+SHARED_TYPE = BasicType('shared', 1)
 RESULT_TYPE = BasicType('le_result_t', 4)
 ONOFF_TYPE  = BasicType('le_onoff_t', 4)
 # Indicates an error occurred parsing a type -- e.g. reference to type that doesn't exist
@@ -336,6 +354,29 @@ class StringParameter(Parameter):
     def __repr__(self):
         return "<StringParameter {}>".format(str(self))
 
+class SharedParameter(ArrayParameter):
+    """
+    Byte buffer passed in a sealed shared memory region instead of being copied through the
+    message.  Looks the same as a uint8 array parameter in the generated API.
+    """
+    def __init__(self, name, maxCount, direction=DIR_IN):
+        super(SharedParameter, self).__init__(UINT8_TYPE, name, maxCount, direction)
+
+    def GetMaxSize(self):
+        # Only the file descriptor is sent with the message; the data is not in the payload.
+        return 0
+
+    def __str__(self):
+        result = "shared %s[%d] " % (self.name, self.maxCount)
+        if self.direction & DIR_IN:
+            result += "IN"
+        if self.direction & DIR_OUT:
+            result += "OUT"
+        return result
+
+    def __repr__(self):
+        return "<SharedParameter {}>".format(str(self))
+
 def MakeParameter(interface, typeObj, name, arraySize, direction=DIR_IN):
     """Helper to make a parameter object"""
     if direction == None:
@@ -351,6 +392,13 @@ def MakeParameter(interface, typeObj, name, arraySize, direction=DIR_IN):
         if arraySize == None:
             raise Exception("String needs a size limit")
         return StringParameter(name, arraySize, direction)
+    elif typeObj == SHARED_TYPE:
+        # Shared buffers are also special
+        if arraySize == None:
+            raise Exception("Shared buffer needs a size limit")
+        if direction != DIR_IN:
+            raise Exception("Shared buffers can only be input parameters")
+        return SharedParameter(name, arraySize, direction)
     elif arraySize != None:
         if isinstance(typeObj, HandlerType):
             raise Exception("Cannot have arrays of handlers")
@@ -360,6 +408,54 @@ def MakeParameter(interface, typeObj, name, arraySize, direction=DIR_IN):
         # Simple parameter
         return Parameter(typeObj, name, direction)
 
+def IsPackedArraySizeKnown(typeObj):
+    """
+    Check if the space reserved in a message for an array of a type is known from the type's size.
+
+    Arrays reserve room for their elements using the element's C size, which is not the packed
+    size for structures, references and sizes.
+    """
+    if isinstance(typeObj, StructType):
+        return False
+    if isinstance(typeObj, ReferenceType) or typeObj == SIZE_TYPE:
+        return False
+    return True
+
+def IsPackedSizeKnown(typeObj):
+    """Check if the space needed to pack a value of a type is at most the type's size"""
+    if isinstance(typeObj, StructType):
+        return all([IsPackedSizeKnown(member.apiType) and
+                    (not isinstance(member, StructArrayMember) or
+                     IsPackedArraySizeKnown(member.apiType))
+                    for member in typeObj.members])
+    return True
+
+def GetMaxInputSize(parameters):
+    """
+    Get size of the largest message needed to send the inputs in a list of parameters: the input
+    parameters themselves, plus the requested size of each string or array output.  Add 4 bytes
+    for the required outputs bit mask if there are any outputs.
+
+    Returns None if the size can't be known exactly enough, in which case the largest message
+    in the interface must be used.
+    """
+    size = 0
+    if any([parameter.direction & DIR_OUT for parameter in parameters]):
+        size += UINT32_TYPE.size
+
+    for parameter in parameters:
+        if parameter.direction & DIR_IN:
+            if not IsPackedSizeKnown(parameter.apiType):
+                return None
+            if (isinstance(parameter, ArrayParameter) and
+                not IsPackedArraySizeKnown(parameter.apiType)):
+                return None
+            size += parameter.GetMaxSize()
+        elif isinstance(parameter, (StringParameter, ArrayParameter)):
+            size += UINT32_TYPE.size
+
+    return size
+
 #---------------------------------------------------------------------------------------------------
 # Declarations
 #---------------------------------------------------------------------------------------------------
@@ -390,8 +486,23 @@ class Function(object):
         if len(handlers) > 1:
             raise Exception('A function can only have one handler parameter')
 
+        # Only one file descriptor can be sent with each message.
+        fdParameters = [ parameter for parameter in parameters
+                         if (parameter.direction & DIR_IN) and
+                            (isinstance(parameter, SharedParameter) or
+                             parameter.apiType == FILE_TYPE) ]
+        if len(fdParameters) > 1:
+            raise Exception('A function can only have one file or shared buffer input parameter')
+
         self.comment = ""
 
+    def GetMaxInputSize(self):
+        """
+        Get size of the largest request message for this function, not including the message ID,
+        or None if it can't be known.
+        """
+        return GetMaxInputSize(self.parameters)
+
     def __str__(self):
         if self.returnType == None:
             return "FUNCTION %s(%s)" \
@@ -458,6 +569,7 @@ class Interface(object):
                     'size':   SIZE_TYPE,
                     'string': STRING_TYPE,
                     'file':   FILE_TYPE,
+                    'shared': SHARED_TYPE,
                     'le_result_t': RESULT_TYPE,
                     'le_onoff_t': ONOFF_TYPE }
 
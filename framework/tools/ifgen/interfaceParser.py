@@ -2995,6 +2995,12 @@ def main(argv, stdin=sys.stdin, stdout=sys.stdout, stderr=sys.stderr):
 
 
 
+# Cache of parsed interfaces, keyed on the resolved path of the .api file, the search path and
+# the interface name.  None (the default) disables caching.  Batch code generation sets it to a
+# dictionary so that files used by several interfaces, such as the ones named in USETYPES
+# statements, are only parsed once per ifgen process.
+ParseCache = None
+
 def ParseCode(apiFile, searchPath=[], ifaceName=None):
     if os.path.isabs(apiFile) or os.path.isfile(apiFile):
         apiPath = apiFile
@@ -3009,6 +3015,11 @@ def ParseCode(apiFile, searchPath=[], ifaceName=None):
             # path but at least will raise a reasonable exception
             apiPath = apiFile
 
+    if ParseCache is not None:
+        cacheKey = (os.path.abspath(apiPath), tuple(searchPath), ifaceName)
+        if cacheKey in ParseCache:
+            return ParseCache[cacheKey]
+
     fileStream = ANTLRFileStream(apiPath, 'utf-8')
     lexer = interfaceLexer(fileStream)
     tokens = CommonTokenStream(lexer)
@@ -3034,6 +3045,9 @@ def ParseCode(apiFile, searchPath=[], ifaceName=None):
                                                            DOC_PRE_COMMENT,
                                                            DOC_POST_COMMENT ]) ])
 
+    if ParseCache is not None:
+        ParseCache[cacheKey] = iface
+
     return iface
 
 
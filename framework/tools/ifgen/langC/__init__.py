@@ -12,6 +12,11 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='generate asynchronous-style server functions')
+    parser.add_argument('--server-threads',
+                        dest="serverThreads",
+                        type=int,
+                        default=0,
+                        help='handle client requests on a pool of this many server threads')
 
 # Custom filters needed for C templates
 Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
@@ -26,10 +31,15 @@ Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
             'GetParameterCountPtr': codeGenHelpers.GetParameterCountPtr,
             'PackFunction':        codeGenHelpers.GetPackFunction,
             'UnpackFunction':      codeGenHelpers.GetUnpackFunction,
+            'PackArrayFunction':   codeGenHelpers.GetPackArrayFunction,
+            'UnpackArrayFunction': codeGenHelpers.GetUnpackArrayFunction,
+            'BlockPackCondition':  codeGenHelpers.GetBlockPackCondition,
             'CAPIParameters':      codeGenHelpers.IterCAPIParameters }
 
 
-Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter }
+Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter,
+          'RequestResponseFunction': codeGenHelpers.IsRequestResponseFunction,
+          'BatchOutputParameter':  codeGenHelpers.IsBatchOutputParameter }
 
 Globals = { 'Labeler':             codeGenHelpers.Labeler }
 
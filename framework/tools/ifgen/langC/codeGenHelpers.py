@@ -296,6 +296,80 @@ def GetUnpackFunction(apiType):
     else:
         return _PackFunctionMapping[apiType] % ("Unpack", )
 
+# Basic types which are packed as a straight copy of their memory, so arrays of them can be packed
+# and unpacked in a single copy.
+_BlockPackTypes = frozenset([interfaceIR.UINT8_TYPE,
+                             interfaceIR.UINT16_TYPE,
+                             interfaceIR.UINT32_TYPE,
+                             interfaceIR.UINT64_TYPE,
+                             interfaceIR.INT8_TYPE,
+                             interfaceIR.INT16_TYPE,
+                             interfaceIR.INT32_TYPE,
+                             interfaceIR.INT64_TYPE,
+                             interfaceIR.CHAR_TYPE,
+                             interfaceIR.DOUBLE_TYPE,
+                             interfaceIR.RESULT_TYPE,
+                             interfaceIR.ONOFF_TYPE])
+
+def GetPackArrayFunction(apiType):
+    """
+    Get the function which packs a whole array of apiType, or None if the array must be packed
+    element by element using LE_PACK_PACKARRAY.
+    """
+    if apiType in _BlockPackTypes:
+        return _PackFunctionMapping[apiType] % ("Pack", ) + "Array"
+    elif isinstance(apiType, interfaceIR.StructType):
+        return "{}_Pack{}Array".format(apiType.iface.name, apiType.name)
+    else:
+        return None
+
+def GetUnpackArrayFunction(apiType):
+    """
+    Get the function which unpacks a whole array of apiType, or None if the array must be unpacked
+    element by element using LE_PACK_UNPACKARRAY.
+    """
+    if apiType in _BlockPackTypes:
+        return _PackFunctionMapping[apiType] % ("Unpack", ) + "Array"
+    elif isinstance(apiType, interfaceIR.StructType):
+        return "{}_Unpack{}Array".format(apiType.iface.name, apiType.name)
+    else:
+        return None
+
+def GetBlockPackCondition(apiType):
+    """
+    Get a C constant expression which is true if values of apiType are packed as a straight copy of
+    their memory, or None if they never are.
+
+    Structures are only packed as a copy of their memory if all their members are, and the C
+    compiler hasn't added any padding between them.  Whether it has can only be known at compile
+    time.
+    """
+    if apiType in _BlockPackTypes:
+        return "1"
+    elif isinstance(apiType, interfaceIR.EnumType) or \
+         isinstance(apiType, interfaceIR.BitmaskType):
+        return "(sizeof({}) == {})".format(FormatType(apiType), apiType.size)
+    elif isinstance(apiType, interfaceIR.StructType):
+        conditions = []
+        memberSizes = []
+        for member in apiType.members:
+            if isinstance(member, interfaceIR.StructStringMember) or \
+               isinstance(member, interfaceIR.StructArrayMember):
+                return None
+            memberCondition = GetBlockPackCondition(member.apiType)
+            if memberCondition is None:
+                return None
+            elif memberCondition != "1":
+                conditions.append(memberCondition)
+            memberSizes.append("sizeof({})".format(FormatType(member.apiType)))
+        if not memberSizes:
+            return None
+        conditions.insert(0, "(sizeof({}) == ({}))".format(FormatType(apiType),
+                                                            " + ".join(memberSizes)))
+        return " && ".join(conditions)
+    else:
+        return None
+
 def EscapeString(string):
     return string.encode('string_escape').replace('"', '\\"')
 
@@ -305,6 +379,23 @@ def EscapeString(string):
 def IsSizeParameter(parameter):
     return isinstance(parameter, SizeParameter)
 
+def IsRequestResponseFunction(function):
+    """
+    Is this a plain request-response function, which can also be called in a batch or
+    asynchronously?  Add/remove handler functions and functions with callbacks aren't.
+    """
+    return (not isinstance(function, interfaceIR.EventFunction) and
+            not any([isinstance(parameter.apiType, interfaceIR.HandlerType)
+                     for parameter in function.parameters]))
+
+def IsBatchOutputParameter(parameter):
+    """
+    Does this C API parameter need to be kept until a batched request's response arrives?
+    """
+    if isinstance(parameter, SizeParameter):
+        parameter = parameter.relatedParameter
+    return (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT
+
 #---------------------------------------------------------------------------------------------------
 # Global functions
 #---------------------------------------------------------------------------------------------------
@@ -52,6 +52,58 @@ _ClientData_t;
 static le_mem_PoolRef_t _ClientDataPool;
 
 
+{%- if any(functions, "RequestResponseFunction") %}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of requests a client thread can queue in a batch.  Queueing another request
+ * sends the batch first.
+ */
+//--------------------------------------------------------------------------------------------------
+#define _MAX_BATCH_REQUESTS 16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Where the outputs of a batched request are to be stored when its response arrives.  These are
+ * the output pointers the caller gave when the request was queued.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef union
+{
+    void* _noOutputsPtr;    ///< Unused; keeps the union valid if no function has outputs.
+    {%- for function in functions if function is RequestResponseFunction %}
+    {%- if function.returnType or any(function|CAPIParameters, "BatchOutputParameter") %}
+    struct
+    {
+        {%- if function.returnType %}
+        {{function.returnType|FormatType}}* _resultPtr;
+        {%- endif %}
+        {%- for parameter in function|CAPIParameters if parameter is BatchOutputParameter %}
+        {{parameter|FormatParameter}};
+        {%- endfor %}
+    }
+    {{function.name}};
+    {%- endif %}
+    {%- endfor %}
+}
+_BatchOutputs_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A request queued on a client thread's batch.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_MessageRef_t msgRef;         ///< Request message, not yet sent
+    void (*unpackFunc)(le_msg_MessageRef_t, _BatchOutputs_t*); ///< Stores the response's outputs
+    _BatchOutputs_t     outputs;        ///< Where the outputs are to be stored
+}
+_BatchRequest_t;
+
+
+{% endif -%}
 //--------------------------------------------------------------------------------------------------
 /**
  * Client Thread Objects
@@ -65,6 +117,10 @@ typedef struct
     int                 clientCount;    ///< Number of clients sharing this thread
     {{apiName}}_DisconnectHandler_t disconnectHandler; ///< Disconnect handler for this thread
     void*               contextPtr;     ///< Context for disconnect handler
+    {%- if any(functions, "RequestResponseFunction") %}
+    size_t              batchCount;     ///< Number of requests queued in the batch
+    _BatchRequest_t     batch[_MAX_BATCH_REQUESTS]; ///< Requests queued for the next SendBatch
+    {%- endif %}
 }
 _ClientThreadData_t;
 
@@ -430,6 +486,27 @@ le_result_t {{apiName}}_TryConnectService
     return DoConnectService(false);
 }
 
+{%- if any(functions, "RequestResponseFunction") %}
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release any requests that are still queued in a client thread's batch.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DiscardBatch
+(
+    _ClientThreadData_t* clientThreadPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < clientThreadPtr->batchCount; i++)
+    {
+        le_msg_ReleaseMsg(clientThreadPtr->batch[i].msgRef);
+    }
+    clientThreadPtr->batchCount = 0;
+}
+
+{% endif -%}
 //--------------------------------------------------------------------------------------------------
 // Session close handler.
 //
@@ -442,6 +519,10 @@ static void SessionCloseHandler
 )
 {
     _ClientThreadData_t* clientThreadPtr = contextPtr;
+    {%- if any(functions, "RequestResponseFunction") %}
+
+    DiscardBatch(clientThreadPtr);
+    {%- endif %}
 
     le_msg_DeleteSession( clientThreadPtr->sessionRef );
 
@@ -528,6 +609,9 @@ void {{apiName}}_DisconnectService
         // This is the last client for this thread, so close the session.
         if ( clientThreadPtr->clientCount == 1 )
         {
+            {%- if any(functions, "RequestResponseFunction") %}
+            DiscardBatch(clientThreadPtr);
+            {%- endif %}
             le_msg_DeleteSession( clientThreadPtr->sessionRef );
 
             // Need to delete the thread specific data, since it is no longer valid.  If a new
@@ -552,9 +636,135 @@ void {{apiName}}_DisconnectService
 }
 
 
+{%- if any(functions, "RequestResponseFunction") %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send all the requests queued by the current client thread's Batch functions to the server in
+ * one go, wait for all the responses, and store their results and outputs.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_SendBatch
+(
+    void
+)
+{
+    _ClientThreadData_t* clientThreadPtr = GetClientThreadDataPtr();
+    le_msg_MessageRef_t msgRefs[_MAX_BATCH_REQUESTS];
+    size_t count;
+    size_t i;
+
+    LE_FATAL_IF(clientThreadPtr==NULL,
+                "{{apiName}}_ConnectService() not called for current thread");
+
+    count = clientThreadPtr->batchCount;
+    for (i = 0; i < count; i++)
+    {
+        msgRefs[i] = clientThreadPtr->batch[i].msgRef;
+    }
+    clientThreadPtr->batchCount = 0;
+
+    TRACE("Sending batch of %zu messages to server and waiting for responses", count);
+
+    le_msg_RequestSyncResponseBatch(msgRefs, count);
+
+    for (i = 0; i < count; i++)
+    {
+        // It is a serious error if we don't get a valid response from the server.  Call
+        // disconnect handler (if one is defined) to allow cleanup
+        if (msgRefs[i] == NULL)
+        {
+            SessionCloseHandler(clientThreadPtr->sessionRef, clientThreadPtr);
+        }
+
+        clientThreadPtr->batch[i].unpackFunc(msgRefs[i], &clientThreadPtr->batch[i].outputs);
+
+        // Release the message object, now that all results/output has been copied.
+        le_msg_ReleaseMsg(msgRefs[i]);
+    }
+}
+{%- endif %}
+
+
 //--------------------------------------------------------------------------------------------------
 // Client Specific Client Code
 //--------------------------------------------------------------------------------------------------
+{#- Builds the request message for a function call in _msgRef, with _msgPtr, _msgBufPtr and
+ # _msgBufSize left just past the packed inputs.  Shared by the normal, Batch and Async functions.
+ # If allOutputs is set, every output is requested instead of those the caller passed in. #}
+{%- macro PackRequest(function, allOutputs=False) %}
+
+    // Range check values, if appropriate
+    {%- for parameter in function.parameters if parameter is InParameter %}
+    {%- if parameter is StringParameter %}
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- elif parameter is ArrayParameter %}
+    if ( (NULL == {{parameter|FormatParameterName}}) &&
+         (0 != {{parameter|GetParameterCount}}) )
+    {
+        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
+                 "{{parameter|GetParameterCount}} must be zero");
+    }
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- endif %}
+    {%- endfor %}
+
+
+    // Create a new message object, just big enough for the inputs, and get the message buffer
+    {%- set inputSize = function.GetMaxInputSize() %}
+    {%- if inputSize is none %}
+    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    {%- else %}
+    _msgRef = le_msg_CreateSizedMsg(GetCurrentSessionRef(),
+                                    offsetof(_Message_t, buffer) + {{inputSize}});
+    {%- endif %}
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _MSG_BUF_SIZE(_msgRef);
+
+    // Pack a list of outputs requested by the client.
+    {%- if any(function.parameters, "OutParameter") %}
+    uint32_t _requiredOutputs = 0;
+    {%- for output in function.parameters if output is OutParameter %}
+    {%- if allOutputs %}
+    _requiredOutputs |= (1 << {{loop.index0}});
+    {%- else %}
+    _requiredOutputs |= ((!!({{output|FormatParameterName}})) << {{loop.index0}});
+    {%- endif %}
+    {%- endfor %}
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
+    {%- endif %}
+
+    // Pack the input parameters
+    {%- if function is RemoveHandlerFunction %}
+    {#- Remove handlers only have one parameter which is special so handle it separately from
+     # the general case. #}
+    // The passed in handlerRef is a safe reference for the client data object.  Need to get the
+    // real handlerRef from the client data object and then delete both the safe reference and
+    // the object since they are no longer needed.
+    _LOCK
+    _ClientData_t* clientDataPtr = le_ref_Lookup(_HandlerRefMap, handlerRef);
+    LE_FATAL_IF(clientDataPtr==NULL, "Invalid reference");
+    le_ref_DeleteRef(_HandlerRefMap, handlerRef);
+    _UNLOCK
+    handlerRef = ({{function.parameters[0].apiType|FormatType}})clientDataPtr->handlerRef;
+    le_mem_Release(clientDataPtr);
+    LE_ASSERT(le_pack_PackReference( &_msgBufPtr, &_msgBufSize,
+                                     {{function.parameters[0]|FormatParameterName}} ));
+    {%- else %}
+    {{- pack.PackInputs(function.parameters, allOutputs) }}
+    {%- endif %}
+{%- endmacro %}
 {%- for function in functions %}
 {#- Before emitting an add handler, emit the handler first (if any).
  # there should only be one handler in the function parameter list #}
@@ -573,7 +783,7 @@ static void _Handle_{{apiName}}_{{function.name}}
     le_msg_MessageRef_t _msgRef = _reportPtr;
     _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     uint8_t* _msgBufPtr = _msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _MSG_BUF_SIZE(_msgRef);
 
     // The clientContextPtr always exists and is always first. It is a safe reference to the client
     // data object, but we already get the pointer to the client data object through the _dataPtr
@@ -665,69 +875,13 @@ error_unpack:
 
     {{function.returnType|FormatType}} _result;
     {%- endif %}
-
-    // Range check values, if appropriate
-    {%- for parameter in function.parameters if parameter is InParameter %}
-    {%- if parameter is StringParameter %}
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
-    {%- elif parameter is ArrayParameter %}
-    if ( (NULL == {{parameter|FormatParameterName}}) &&
-         (0 != {{parameter|GetParameterCount}}) )
-    {
-        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
-                 "{{parameter|GetParameterCount}} must be zero");
-    }
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
-    {%- endif %}
-    {%- endfor %}
-
-
-    // Create a new message object and get the message buffer
-    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
-    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
-    _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
-    _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
-
-    // Pack a list of outputs requested by the client.
-    {%- if any(function.parameters, "OutParameter") %}
-    uint32_t _requiredOutputs = 0;
-    {%- for output in function.parameters if output is OutParameter %}
-    _requiredOutputs |= ((!!({{output|FormatParameterName}})) << {{loop.index0}});
-    {%- endfor %}
-    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
-    {%- endif %}
-
-    // Pack the input parameters
-    {%- if function is RemoveHandlerFunction %}
-    {#- Remove handlers only have one parameter which is special so handle it separately from
-     # the general case. #}
-    // The passed in handlerRef is a safe reference for the client data object.  Need to get the
-    // real handlerRef from the client data object and then delete both the safe reference and
-    // the object since they are no longer needed.
-    _LOCK
-    _ClientData_t* clientDataPtr = le_ref_Lookup(_HandlerRefMap, handlerRef);
-    LE_FATAL_IF(clientDataPtr==NULL, "Invalid reference");
-    le_ref_DeleteRef(_HandlerRefMap, handlerRef);
-    _UNLOCK
-    handlerRef = ({{function.parameters[0].apiType|FormatType}})clientDataPtr->handlerRef;
-    le_mem_Release(clientDataPtr);
-    LE_ASSERT(le_pack_PackReference( &_msgBufPtr, &_msgBufSize,
-                                     {{function.parameters[0]|FormatParameterName}} ));
-    {%- else %}
-    {{- pack.PackInputs(function.parameters) }}
-    {%- endif %}
+    {{- PackRequest(function) }}
 
     // Send a request to the server and get the response.
     TRACE("Sending message to server and waiting for response : %ti bytes sent",
           _msgBufPtr-_msgPtr->buffer);
 
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     _responseMsgRef = le_msg_RequestSyncResponse(_msgRef);
     // It is a serious error if we don't get a valid response from the server.  Call disconnect
     // handler (if one is defined) to allow cleanup
@@ -739,7 +893,7 @@ error_unpack:
     // Process the result and/or output parameters, if there are any.
     _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _MSG_BUF_SIZE(_responseMsgRef);
     {%- if function.returnType %}
 
     // Unpack the result first
@@ -788,6 +942,265 @@ error_unpack:
     {%- endif %}
     {%- endwith %}
 }
+{%- if function is RequestResponseFunction %}
+{%- set hasOutputs = function.returnType or any(function|CAPIParameters, "BatchOutputParameter") %}
+
+
+// This function unpacks the response to a batched {{apiName}}_{{function.name}}() request into the
+// outputs that were given when the request was queued.
+static void _BatchUnpack_{{apiName}}_{{function.name}}
+(
+    le_msg_MessageRef_t _responseMsgRef,
+    _BatchOutputs_t* _outputsPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
+
+    // Will not be used if no data is received from server.
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+    __attribute__((unused)) size_t _msgBufSize = _MSG_BUF_SIZE(_responseMsgRef);
+    {%- if not hasOutputs %}
+
+    (void)_outputsPtr;
+    {%- endif %}
+    {%- if function.returnType %}
+
+    {{function.returnType|FormatType}} _result;
+    {%- endif %}
+    {%- if any(function|CAPIParameters, "BatchOutputParameter") %}
+
+    // Restore the output pointers given when the request was queued
+    {%- for parameter in function|CAPIParameters if parameter is BatchOutputParameter %}
+    {{parameter|FormatParameter}} = _outputsPtr->{{function.name}}.{{parameter|FormatParameterName}};
+    {%- endfor %}
+    {%- endif %}
+    {%- if function.returnType %}
+
+    // Unpack the result first
+    if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+    {
+        goto {{error_unpack_label}};
+    }
+    if (_outputsPtr->{{function.name}}._resultPtr)
+    {
+        *_outputsPtr->{{function.name}}._resultPtr = _result;
+    }
+    {%- endif %}
+
+    // Unpack any "out" parameters
+    {%- call pack.UnpackOutputs(function.parameters) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
+
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a call to {{apiName}}_{{function.name}}() in the current client thread's batch, to be sent
+ * by the next call to {{apiName}}_SendBatch().
+ *
+ * The result and outputs are stored when the batch is sent, so the pointers given for them must
+ * remain valid until then.  If the batch is already full, it is sent first.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_Batch{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last or function.returnType %},{% endif %}
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}}* _resultPtr
+        ///< [OUT] Set to the function's result when the batch is sent (can be NULL).
+    {%- elif not (function|CAPIParameters|list) %}
+    void
+    {%- endif %}
+)
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+    {{- PackRequest(function) }}
+
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+
+    // Queue the request, sending the batch first if it is full.
+    _ClientThreadData_t* _clientThreadPtr = GetClientThreadDataPtr();
+    if (_clientThreadPtr->batchCount == _MAX_BATCH_REQUESTS)
+    {
+        {{apiName}}_SendBatch();
+    }
+
+    _BatchRequest_t* _requestPtr = &_clientThreadPtr->batch[_clientThreadPtr->batchCount++];
+    _requestPtr->msgRef = _msgRef;
+    _requestPtr->unpackFunc = _BatchUnpack_{{apiName}}_{{function.name}};
+    {%- if function.returnType %}
+    _requestPtr->outputs.{{function.name}}._resultPtr = _resultPtr;
+    {%- endif %}
+    {%- for parameter in function|CAPIParameters if parameter is BatchOutputParameter %}
+    _requestPtr->outputs.{{function.name}}.{{parameter|FormatParameterName}} =
+        {#- #} {{parameter|FormatParameterName}};
+    {%- endfor %}
+}
+
+
+// This function is called when the response to a {{apiName}}_{{function.name}}Async() request
+// arrives.  It unpacks the result and outputs, and passes them to the caller's callback, which is
+// stored in a client data object.
+static void _AsyncResponse_{{apiName}}_{{function.name}}
+(
+    le_msg_MessageRef_t _responseMsgRef,
+    void* _contextPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    _ClientData_t* _clientDataPtr = _contextPtr;
+    {{apiName}}_{{function.name}}AsyncFunc_t _callbackPtr =
+        {#- #} ({{apiName}}_{{function.name}}AsyncFunc_t)_clientDataPtr->handlerPtr;
+    void* contextPtr = _clientDataPtr->contextPtr;
+
+    // The client data object is no longer needed, now that the callback has been pulled out.
+    le_mem_Release(_clientDataPtr);
+
+    // The transaction terminates without a response if the session is closed, in which case
+    // there is nothing to report.
+    if (_responseMsgRef == NULL)
+    {
+        LE_DEBUG("No response to {{apiName}}_{{function.name}}Async() request");
+        return;
+    }
+
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
+
+    // Will not be used if no data is received from server.
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+    __attribute__((unused)) size_t _msgBufSize = _MSG_BUF_SIZE(_responseMsgRef);
+    {%- if function.returnType %}
+
+    {{function.returnType|FormatType}} _result;
+    {%- endif %}
+    {%- if any(function.parameters, "OutParameter") %}
+
+    // Storage for the "out" parameters, which are all requested
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    char {{parameter.name}}Buffer[{{parameter.maxCount + 1}}] = "";
+    char* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = sizeof({{parameter.name}}Buffer);
+    {%- elif parameter is ArrayParameter %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}Buffer[{{parameter.maxCount}}];
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = 0;
+    size_t* {{parameter|GetParameterCountPtr}} = &{{parameter.name}}Size;
+    {%- elif parameter.apiType is BasicType and parameter.apiType.name == 'file' %}
+    int {{parameter.name}}Value = -1;
+    int* {{parameter|FormatParameterName}} = &{{parameter.name}}Value;
+    {%- else %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}Value;
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = &{{parameter.name}}Value;
+    {%- endif %}
+    {%- endfor %}
+    {%- endif %}
+    {%- if function.returnType %}
+
+    // Unpack the result first
+    if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+    {
+        goto {{error_unpack_label}};
+    }
+    {%- endif %}
+
+    // Unpack any "out" parameters
+    {%- call pack.UnpackOutputs(function.parameters) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
+
+    // Release the message object, now that all results/output has been copied.
+    le_msg_ReleaseMsg(_responseMsgRef);
+
+    // Pass the results on to the caller
+    if (_callbackPtr != NULL)
+    {
+        _callbackPtr(
+            {%- if function.returnType %}_result, {% endif %}
+            {%- for parameter in function.parameters if parameter is OutParameter %}
+            {%- if parameter is StringParameter or parameter.apiType is StructType %}
+            {{- parameter|FormatParameterName }}
+            {%- elif parameter is ArrayParameter %}
+            {{- parameter|FormatParameterName }}, {{parameter.name}}Size
+            {%- else %}
+            {{- parameter.name }}Value
+            {%- endif %}, {% endfor %}contextPtr);
+    }
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a call to {{apiName}}_{{function.name}}() without waiting for it to complete.  The callback
+ * is called by this thread's event loop with the result and all the outputs when the response
+ * arrives, so many calls can be in progress at once.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters if parameter is not BatchOutputParameter %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {{apiName}}_{{function.name}}AsyncFunc_t callbackPtr,
+        ///< [IN] Called when the response arrives (can be NULL).
+    void* contextPtr
+        ///< [IN] Passed to the callback.
+)
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+    {{- PackRequest(function, True) }}
+
+    // Keep the callback and its context in a client data object until the response arrives.
+    _ClientData_t* _clientDataPtr = le_mem_ForceAlloc(_ClientDataPool);
+    _clientDataPtr->handlerPtr = (le_event_HandlerFunc_t)callbackPtr;
+    _clientDataPtr->contextPtr = contextPtr;
+    _clientDataPtr->handlerRef = NULL;
+    _clientDataPtr->callersThreadRef = le_thread_GetCurrent();
+
+    // Send a request to the server; the response is handled by this thread's event loop.
+    TRACE("Sending message to server : %ti bytes sent", _msgBufPtr-_msgPtr->buffer);
+
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+    le_msg_RequestResponse(_msgRef, _AsyncResponse_{{apiName}}_{{function.name}}, _clientDataPtr);
+}
+{%- endif %}
 {%- endfor %}
 
 
@@ -800,7 +1213,7 @@ static void ClientIndicationRecvHandler
     // Get the message payload
     _Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
     uint8_t* _msgBufPtr = msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _MSG_BUF_SIZE(msgRef);
 
     // Have to partially unpack the received message in order to know which thread
     // the queued function should actually go to.
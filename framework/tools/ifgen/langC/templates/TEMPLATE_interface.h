@@ -98,4 +98,96 @@ void {{apiName}}_DisconnectService
 (
     void
 );
+{%- if any(functions, "RequestResponseFunction") %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send all the requests queued by the current client thread's Batch functions to the server in
+ * one go, wait for all the responses, and store their results and outputs.
+ *
+ * Each function in this API that doesn't take a handler has a Batch variant that packs its
+ * request and queues it instead of sending it, so that several calls cost a single round trip to
+ * the server.  For details, see @ref c_messagingClientBatching.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_SendBatch
+(
+    void
+);
+{%- endif %}
+{%- endblock %}
+{% block FunctionDeclaration %}
+{{- super() }}
+{%- if function is RequestResponseFunction %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a call to {{apiName}}_{{function.name}}() in the current client thread's batch, to be sent
+ * by the next call to {{apiName}}_SendBatch().
+ *
+ * The result and outputs are stored when the batch is sent, so the pointers given for them must
+ * remain valid until then.  If the batch is already full, it is sent first.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_Batch{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last or function.returnType %},{% endif %}
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}}* _resultPtr
+        ///< [OUT] Set to the function's result when the batch is sent (can be NULL).
+    {%- elif not (function|CAPIParameters|list) %}
+    void
+    {%- endif %}
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Callback for {{apiName}}_{{function.name}}Async(), called with the result and outputs of the
+ * call when its response arrives.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*{{apiName}}_{{function.name}}AsyncFunc_t)
+(
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}} _result,
+        ///< Result of the call.
+    {%- endif %}
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {{parameter|FormatParameter(True)}},
+        ///<{{parameter.comments|join("\n///<")|indent(8)}}
+    {%- if parameter is ArrayParameter %}
+    size_t {{parameter.name}}Size,
+        ///< Number of elements in {{parameter|FormatParameterName}}.
+    {%- endif %}
+    {%- endfor %}
+    void* contextPtr
+        ///< Context given to {{apiName}}_{{function.name}}Async().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a call to {{apiName}}_{{function.name}}() without waiting for it to complete.  The callback
+ * is called by this thread's event loop with the result and all the outputs when the response
+ * arrives, so many calls can be in progress at once.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters if parameter is not BatchOutputParameter %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {{apiName}}_{{function.name}}AsyncFunc_t callbackPtr,
+        ///< [IN] Called when the response arrives (can be NULL).
+    void* contextPtr
+        ///< [IN] Passed to the callback.
+);
+{%- endif %}
 {%- endblock %}
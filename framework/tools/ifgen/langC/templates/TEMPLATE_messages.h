@@ -43,6 +43,10 @@ typedef struct __attribute__((packed))
     uint8_t buffer[_MAX_MSG_SIZE];
 }
 _Message_t;
+
+// Size of the part of a message's payload buffer that follows the message ID.  Messages are only as
+// big as they need to be, so this can be less than _MAX_MSG_SIZE.
+#define _MSG_BUF_SIZE(msgRef) (le_msg_GetMaxPayloadSize(msgRef) - offsetof(_Message_t, buffer))
 {% for function in functions %}
 #define _MSGID_{{apiName}}_{{function.name}} {{loop.index0}}
 {%- endfor %}
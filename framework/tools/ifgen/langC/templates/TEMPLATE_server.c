@@ -141,10 +141,12 @@ static le_thread_Ref_t _ServerThreadRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Client Session Reference for the current message received from a client
+ * Key under which the Client Session Reference for the current message received from a client is
+ * kept in thread-local storage.  Thread-local, because a server with a thread pool handles messages
+ * from different clients in parallel.
  */
 //--------------------------------------------------------------------------------------------------
-static le_msg_SessionRef_t _ClientSessionRef;
+static pthread_key_t _ClientSessionKey;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -188,7 +190,7 @@ static void CleanupClientData
 
     // Store the client session ref so it can be retrieved by the server using the
     // GetClientSessionRef() function, if it's needed inside handler removal functions.
-    _ClientSessionRef = sessionRef;
+    pthread_setspecific(_ClientSessionKey, sessionRef);
 
     le_ref_IterRef_t iterRef = le_ref_GetIterator(_HandlerRefMap);
     le_result_t result = le_ref_NextNode(iterRef);
@@ -226,7 +228,7 @@ static void CleanupClientData
     }
 
     // Clear the client session ref, since the event has now been processed.
-    _ClientSessionRef = 0;
+    pthread_setspecific(_ClientSessionKey, NULL);
 
     _UNLOCK
 }
@@ -303,7 +305,7 @@ le_msg_SessionRef_t {{apiName}}_GetClientSessionRef
     void
 )
 {
-    return _ClientSessionRef;
+    return pthread_getspecific(_ClientSessionKey);
 }
 
 
@@ -338,10 +340,18 @@ void {{apiName}}_AdvertiseService
     // Don't expect that to be more than 2-3, so use 3 as a reasonable guess.
     _HandlerRefMap = le_ref_CreateMap("{{apiName}}_ServerHandlers", 3);
 
+    // Create the thread-local storage key for the current client session reference.
+    LE_ASSERT(pthread_key_create(&_ClientSessionKey, NULL) == 0);
+
     // Start the server side of the service
     protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(_Message_t));
     _ServerServiceRef = le_msg_CreateService(protocolRef, SERVICE_INSTANCE_NAME);
     le_msg_SetServiceRecvHandler(_ServerServiceRef, ServerMsgRecvHandler, NULL);
+    {%- if args.serverThreads %}
+
+    // Handle requests from different clients in parallel on a pool of threads.
+    le_msg_SetServiceThreadPool(_ServerServiceRef, {{args.serverThreads}});
+    {%- endif %}
     le_msg_AdvertiseService(_ServerServiceRef);
 
     // Register for client sessions being closed
@@ -385,12 +395,19 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
     __attribute__((unused)) uint8_t* _msgBufPtr;
     __attribute__((unused)) size_t _msgBufSize;
 
-    // Create a new message object and get the message buffer
+    // Create a new message object, just big enough for the handler's inputs, and get the message
+    // buffer
+    {%- set inputSize = handler.apiType.GetMaxInputSize() %}
+    {%- if inputSize is none %}
     _msgRef = le_msg_CreateMsg(serverDataPtr->clientSessionRef);
+    {%- else %}
+    _msgRef = le_msg_CreateSizedMsg(serverDataPtr->clientSessionRef,
+                                    offsetof(_Message_t, buffer) + {{inputSize}});
+    {%- endif %}
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _MSG_BUF_SIZE(_msgRef);
 
     // Always pack the client context pointer first
     LE_ASSERT(le_pack_PackReference( &_msgBufPtr, &_msgBufSize, serverDataPtr->contextPtr ))
@@ -403,6 +420,7 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
           serverDataPtr->clientSessionRef,
           _msgBufPtr-_msgPtr->buffer);
 
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     SendMsgToClient(_msgRef);
 
     {%- if function is not AddHandlerFunction %}
@@ -475,6 +493,7 @@ void {{apiName}}_{{function.name}}Respond
     // Return the response
     TRACE("Sending response to client session %p", le_msg_GetSession(_msgRef));
 
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     le_msg_Respond(_msgRef);
 
     // Release the command
@@ -521,6 +540,7 @@ static void Handle_{{apiName}}_{{function.name}}
         {{parameter|FormatParameterName(forceInput=True)}}
         {%- endif %}
         {%- endfor %} );
+    {{- pack.ReleaseInputs(function.parameters) }}
 
     return;
     {%- if error_unpack_label.IsUsed() %}
@@ -642,6 +662,7 @@ static void Handle_{{apiName}}_{{function.name}}
         {{parameter|FormatParameterName}}
         {%- endif %}{% if not loop.last %}, {% endif %}
         {%- endfor %} );
+    {{- pack.ReleaseInputs(function.parameters) }}
     {%- if function is AddHandlerFunction %}
 
     if (_result)
@@ -682,7 +703,7 @@ static void Handle_{{apiName}}_{{function.name}}
           le_msg_GetSession(_msgRef),
           _msgBufPtr-_msgBufStartPtr);
 
-
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef));
     le_msg_Respond(_msgRef);
 
     return;
@@ -709,7 +730,7 @@ static void ServerMsgRecvHandler
     // Get the client session ref for the current message.  This ref is used by the server to
     // get info about the client process, such as user id.  If there are multiple clients, then
     // the session ref may be different for each message, hence it has to be queried each time.
-    _ClientSessionRef = le_msg_GetSession(msgRef);
+    pthread_setspecific(_ClientSessionKey, le_msg_GetSession(msgRef));
 
     // Dispatch to appropriate message handler and get response
     switch (msgPtr->id)
@@ -724,5 +745,5 @@ static void ServerMsgRecvHandler
 
     // Clear the client session ref associated with the current message, since the message
     // has now been processed.
-    _ClientSessionRef = 0;
+    pthread_setspecific(_ClientSessionKey, NULL);
 }
@@ -120,6 +120,8 @@ def GetDefaultValue(apiType):
 def FormatParameter(context, parameter, name=None, qualifiedTypes=None):
     if name == None:
         name = parameter.name
+    if isinstance(parameter, interfaceIR.SharedParameter):
+        raise Exception("Shared buffer parameters are not supported in Java")
     if parameter.direction == interfaceIR.DIR_OUT:
         if isinstance(parameter, interfaceIR.ArrayParameter):
             return "Ref<%s[]> %s" % (FormatBoxedType(context, parameter.apiType, qualifiedTypes), name)
@@ -31,7 +31,9 @@ Filters = {
             }
 
 
-Tests = { 'SizeParameter':         langC.codeGenHelpers.IsSizeParameter }
+Tests = { 'SizeParameter':         langC.codeGenHelpers.IsSizeParameter,
+          'RequestResponseFunction': langC.codeGenHelpers.IsRequestResponseFunction,
+          'BatchOutputParameter':  langC.codeGenHelpers.IsBatchOutputParameter }
 
 Globals = langC.Globals.copy()
 Globals.update({
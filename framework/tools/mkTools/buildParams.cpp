@@ -28,6 +28,7 @@ BuildParams_t::BuildParams_t
     codeGenOnly(false),
     isStandAloneComp(false),
     noPie(false),
+    lto(false),
     argc(0),
     argv(NULL)
 //--------------------------------------------------------------------------------------------------
@@ -46,6 +46,7 @@ struct BuildParams_t
     bool                    isStandAloneComp;   ///< true = generate stand-alone component
     bool                    binPack;            ///< true = generate a binary package for redist.
     bool                    noPie;              ///< true = generate executable without pie.
+    bool                    lto;                ///< true = use link-time optimization.
 
     int                     argc;               ///< Number of arguments (argc to main)
     const char**            argv;               ///< Argument list (argv to main)
@@ -63,6 +64,7 @@ struct BuildParams_t
     std::string             objcopyPath;        ///< Object file copier (needed for -d option)
     std::string             readelfPath;        ///< ELF file reader (needed for -d option)
     std::string             compilerCachePath;  ///< Compiler cache (ccache, sccache, ...)
+    std::string             componentCacheDir;  ///< Cache of linked component libraries
     std::list<std::string>  crossToolPaths;     ///< Tool chain executable paths
 
     /// Constructor
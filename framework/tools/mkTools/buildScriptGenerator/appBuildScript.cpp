@@ -65,16 +65,13 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         "  description = Creating info.properties\n"
         // Delete the old info.properties file, if there is one.
         "  command = rm -f $out && $\n"
-        // Compute the MD5 checksum of the staging area.
-        // Don't follow symlinks (-P), and include the directory structure and the contents of
-        // symlinks as part of the MD5 hash.
-        "            md5=$$( ( cd $workingDir/staging && $\n"
-        "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-        "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-        "                      find -P -type l -print0 |LC_ALL=C sort -z"
-                             " |xargs -0 -r -n 1 readlink $\n"
-        "                    ) | md5sum) && $\n"
-        "            md5=$${md5%% *} && $\n"
+        // Give everything in the staging area the time stamp it will be packed with now, rather
+        // than when packing, so the staged files don't look modified to the next build.
+        "            legato-staging touch `stat -c %Y $adefPath` $workingDir/staging && $\n"
+        // Compute the MD5 checksum of the staging area, only rehashing the files that changed
+        // since the last build.
+        "            md5=`legato-staging md5 -m $workingDir/staging.manifest"
+                                           " $workingDir/staging` && $\n"
         // Generate the app's info.properties file.
         "            ( echo \"app.name=$name\" && $\n"
         "              echo \"app.md5=$$md5\" && $\n"
@@ -91,9 +88,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         "  command = $\n"
         // Change all file time stamp to generate reproducible build. Can't use gnu tar --mtime
         // option as it is not available in other tar (e.g bsdtar)
-        "            mtime=`stat -c %Y $adefPath` && $\n"
-        "            find $workingDir/staging -exec touch --no-dereference "
-                    "--date=@$$mtime {} \\; && $\n"
+        "            legato-staging touch `stat -c %Y $adefPath` $workingDir/staging && $\n"
         "            (cd $workingDir/staging && find . -print0 | LC_ALL=C sort -z"
                      " |tar --no-recursion --null -T - -cjf - ) > $workingDir/$name.$target && $\n"
         // Get the size of the tarball.
@@ -449,14 +444,16 @@ void AppBuildScriptGenerator_t::GenerateAppBundleBuildStatement
                << "/staging/read-only/bin/" << exeName;
     }
 
-    // It also depends on the generated config file.
+    // It also depends on the generated config file and settings blob.
     script << " $builddir/" << appPtr->ConfigFilePath();
+    script << " $builddir/" << appPtr->SettingsFilePath();
 
     // End of dependency list.
     script << "\n";
 
     // Tell the build rule what the app's name and version are and where its working directory is.
     script << "  name = " << appPtr->name << "\n"
+              "  adefPath = " << appPtr->defFilePtr->path << "\n"
               "  version = " << appPtr->version << "\n"
               "  workingDir = $builddir/" + appPtr->workingDir << "\n"
               "\n";
@@ -660,6 +657,9 @@ void AppBuildScriptGenerator_t::Generate
         GenerateAppBundleBuildStatement(appPtr, buildParams.outputDir);
     }
 
+    // Add the build statement that runs all the ifgen jobs added above.
+    baseGeneratorPtr->GenerateIfgenBatchBuildStatement();
+
     // Add a build statement for the build.ninja file itself.
     GenerateNinjaScriptBuildStatement(appPtr);
 }
@@ -222,6 +222,10 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -g";
     }
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
     script << " $cFlags" // Include user-provided CFLAGS last so other settings can be overridden.
               "\n\n";
 
@@ -245,18 +249,35 @@ void BuildScriptGenerator_t::GenerateBuildRules
     {
         script << " -g";
     }
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
     script << " $cxxFlags" // Include user-provided CXXFLAGS last so
                            // other settings can be overridden
               "\n\n";
 
-    // Generate rules for linking C and C++ object code files into shared libraries.
+    // Generate rules for linking C and C++ object code files into shared libraries.  If a
+    // component cache is configured, a library linked from the same inputs before, possibly in
+    // another build tree, is copied from the cache instead.
+    std::string linkLibPrefix;
+    if (!buildParams.componentCacheDir.empty())
+    {
+        linkLibPrefix = "libcache " + buildParams.componentCacheDir + " $out -- ";
+    }
+
     script << "rule LinkCLib\n"
               "  description = Linking C library\n"
-              "  command = " << compilerCachePath << " " << cCompilerPath << " " << sysrootOption;
+              "  command = " << linkLibPrefix <<
+                                compilerCachePath << " " << cCompilerPath << " " << sysrootOption;
     if (!buildParams.debugDir.empty())
     {
         script << " -Wl,--build-id -g";
     }
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
     script << " -shared -o $out $in $ldFlags";
     if (!buildParams.debugDir.empty())
     {
@@ -268,11 +289,16 @@ void BuildScriptGenerator_t::GenerateBuildRules
 
     script << "rule LinkCxxLib\n"
               "  description = Linking C++ library\n"
-              "  command = " << compilerCachePath << " " << cxxCompilerPath << " " << sysrootOption;
+              "  command = " << linkLibPrefix <<
+                                compilerCachePath << " " << cxxCompilerPath << " " << sysrootOption;
     if (!buildParams.debugDir.empty())
     {
         script << " -Wl,--build-id -g";
     }
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
     script << " -shared -o $out $in $ldFlags";
     if (!buildParams.debugDir.empty())
     {
@@ -295,6 +321,11 @@ void BuildScriptGenerator_t::GenerateBuildRules
       script << " -fPIE -pie";
     }
 
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
+
     script << " -o $out $in $ldFlags";
     if (!buildParams.debugDir.empty())
     {
@@ -317,6 +348,11 @@ void BuildScriptGenerator_t::GenerateBuildRules
       script << " -fPIE -pie";
     }
 
+    if (buildParams.lto)
+    {
+        script << " -flto";
+    }
+
     script << " -o $out $in $ldFlags";
     if (!buildParams.debugDir.empty())
     {
@@ -358,10 +394,12 @@ void BuildScriptGenerator_t::GenerateBuildRules
               "            $externalCommand\n"
               "\n";
 
-    // Generate a rule for running ifgen.
+    // Generate a rule for running a batch of ifgen jobs in a single ifgen process.  ifgen leaves
+    // unchanged files untouched, so restat the outputs to avoid rebuilding what depends on them.
     script << "rule GenInterfaceCode\n"
               "  description = Generating IPC interface code\n"
-              "  command = ifgen --output-dir $outputDir $ifgenFlags $in\n"
+              "  command = ifgen --batch $in\n"
+              "  restat = 1\n"
               "\n";
 
     // Generate a rule for generating a Python C Extension .c file for an API
@@ -369,6 +407,12 @@ void BuildScriptGenerator_t::GenerateBuildRules
               "  description = Generating Python API C Extension\n"
               "  command = " << "cextgenerator.py $in -o $workDir > /dev/null\n";
 
+    // Generate a rule for compiling a JavaScript file into a JerryScript snapshot.
+    script << "rule JsSnapshot\n"
+              "  description = Generating JerryScript snapshot\n"
+              "  command = jerry-snapshot generate -o $out $in > /dev/null\n"
+              "\n";
+
     // Generate a rule for copying a file.
     script << "rule CopyFile\n"
               "  description = Copying file\n"
@@ -391,6 +435,113 @@ void BuildScriptGenerator_t::GenerateBuildRules
               "\n";
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quote a command-line argument for an ifgen batch file.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string QuoteIfgenArg
+(
+    const std::string& arg
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return '"' + path::EscapeQuotes(arg) + '"';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an ifgen code generation job to the script's batch.  All the jobs are run by a single ifgen
+ * process (see GenerateIfgenBatchBuildStatement()), which loads its templates and parses each
+ * .api file only once, instead of one ifgen process being started per interface.
+ *
+ * Output paths are given as they are to appear in the build script (they may use $builddir).
+ **/
+//--------------------------------------------------------------------------------------------------
+void BuildScriptGenerator_t::AddIfgenJob
+(
+    const std::string& outputFiles,     ///< Space-separated list of the files generated.
+    const std::string& apiFilePath,     ///< The .api file to generate code for.
+    const std::set<std::string>& includedApiFiles, ///< .api files it includes, recursively.
+    const std::string& ifgenFlags,      ///< Job-specific ifgen command-line arguments.
+    const std::string& outputDir        ///< Output directory (may start with $builddir).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const std::string buildDirVar = "$builddir";
+
+    // The batch file is read by ifgen, not ninja, so expand $builddir.
+    std::string expandedOutputDir = outputDir;
+    if (outputDir.compare(0, buildDirVar.size(), buildDirVar) == 0)
+    {
+        expandedOutputDir = path::MakeAbsolute(buildParams.workingDir)
+                          + outputDir.substr(buildDirVar.size());
+    }
+
+    std::string job = "--output-dir " + QuoteIfgenArg(expandedOutputDir);
+
+    if (ifgenFlags.find_first_not_of(' ') != std::string::npos)
+    {
+        job += " " + ifgenFlags.substr(ifgenFlags.find_first_not_of(' '));
+    }
+
+    for (const auto& dir : buildParams.interfaceDirs)
+    {
+        job += " --import-dir " + QuoteIfgenArg(dir);
+    }
+
+    job += " " + QuoteIfgenArg(apiFilePath);
+
+    ifgenJobs.push_back(job);
+
+    ifgenOutputs += " " + outputFiles;
+
+    ifgenInputs.insert(apiFilePath);
+    ifgenInputs.insert(includedApiFiles.begin(), includedApiFiles.end());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the ifgen batch file and, to the build script, the build statement that runs it.  Must be
+ * called after all the ifgen jobs have been added.
+ **/
+//--------------------------------------------------------------------------------------------------
+void BuildScriptGenerator_t::GenerateIfgenBatchBuildStatement
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (ifgenJobs.empty())
+    {
+        return;
+    }
+
+    // Only rewrite the batch file when the jobs change, so that ifgen isn't run again for nothing.
+    std::string batchFilePath = path::Combine(buildParams.workingDir, "ifgen_jobs");
+
+    file::OutputFile_t batchFile(batchFilePath);
+
+    for (const auto& job : ifgenJobs)
+    {
+        batchFile << job << "\n";
+    }
+
+    batchFile.Commit();
+
+    script << "build" << ifgenOutputs << ": GenInterfaceCode " << batchFilePath << " |";
+
+    for (const auto& apiFilePath : ifgenInputs)
+    {
+        script << " " << apiFilePath;
+    }
+
+    script << "\n\n";
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write to a given build script the build statements for the build script itself.
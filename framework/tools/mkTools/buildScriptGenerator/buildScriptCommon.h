@@ -65,10 +65,21 @@ class BuildScriptGenerator_t
         const mk::BuildParams_t& buildParams;
         const std::string scriptPath;
 
+        std::list<std::string> ifgenJobs;       ///< ifgen command lines, run as a single batch.
+        std::string ifgenOutputs;               ///< Files generated by the ifgen jobs.
+        std::set<std::string> ifgenInputs;      ///< .api files read by the ifgen jobs.
+
     public:
         virtual void GenerateIfgenFlagsDef(void);
         virtual void GenerateBuildRules(void);
 
+        virtual void AddIfgenJob(const std::string& outputFiles,
+                                 const std::string& apiFilePath,
+                                 const std::set<std::string>& includedApiFiles,
+                                 const std::string& ifgenFlags,
+                                 const std::string& outputDir);
+        virtual void GenerateIfgenBatchBuildStatement(void);
+
         virtual void GenerateNinjaScriptBuildStatement(const std::set<std::string>& dependencies);
         virtual void GenerateFileBundleBuildStatement(const model::FileSystemObject_t& fileObject,
                                                       model::FileSystemObjectSet_t& bundledFiles);
@@ -815,31 +815,66 @@ void ComponentBuildScriptGenerator_t::GenerateBuildStatements
                << (lineno - 1);
         script << "\n\n";
     }
+
+    // JavaScript is precompiled into snapshots regardless of how the rest of the component is
+    // built, so the runtime can execute the byte-code in place instead of parsing at start-up.
+    for (auto snapshotPtr : componentPtr->jsSnapshots)
+    {
+        script << "build $builddir/" << snapshotPtr->path << ": JsSnapshot "
+               << snapshotPtr->sourceFilePath << "\n\n";
+    }
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write out to a given script file a space-separated list of paths to all the .api files needed
- * by a given .api file (specified through USETYPES statements in the .api files).
+ * Add to a set the paths to all the .api files needed by a given .api file (specified through
+ * USETYPES statements in the .api files).
  **/
 //--------------------------------------------------------------------------------------------------
 void ComponentBuildScriptGenerator_t::GetIncludedApis
 (
-    const model::ApiFile_t* apiFilePtr
+    const model::ApiFile_t* apiFilePtr,
+    std::set<std::string>& apiFiles
 )
 //--------------------------------------------------------------------------------------------------
 {
     for (auto includedApiPtr : apiFilePtr->includes)
     {
-        script << " " << includedApiPtr->path;
+        apiFiles.insert(includedApiPtr->path);
 
         // Recurse.
-        GetIncludedApis(includedApiPtr);
+        GetIncludedApis(includedApiPtr, apiFiles);
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an ifgen job generating some files from a given .api file.  The jobs of all the interfaces
+ * in the build script are run by a single build statement.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ComponentBuildScriptGenerator_t::GenerateIfgenBuildStatement
+(
+    const std::string& outputFiles,     ///< Space-separated list of the files generated.
+    const model::ApiFile_t* apiFilePtr,
+    const std::string& ifgenFlags,
+    const std::string& outputDir
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::set<std::string> includedApiFiles;
+    GetIncludedApis(apiFilePtr, includedApiFiles);
+
+    baseGeneratorPtr->AddIfgenJob(outputFiles,
+                                  apiFilePtr->path,
+                                  includedApiFiles,
+                                  ifgenFlags,
+                                  outputDir);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print to a given script a build statement for building the header file for a given types-only
@@ -859,15 +894,10 @@ void ComponentBuildScriptGenerator_t::GenerateTypesOnlyBuildStatement
     {
         generatedIPC.insert(cFiles.interfaceFile);
 
-        script << "build $builddir/" << cFiles.interfaceFile << ":"
-                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags = --gen-interface"
-                  " --name-prefix " << ifPtr->internalName <<
-                  " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.interfaceFile) << "\n"
-                  "\n";
+        GenerateIfgenBuildStatement("$builddir/" + cFiles.interfaceFile,
+                                    ifPtr->apiFilePtr,
+                                    "--gen-interface --name-prefix " + ifPtr->internalName,
+                                    "$builddir/" + path::GetContainingDir(cFiles.interfaceFile));
     }
 }
 
@@ -891,16 +921,11 @@ void ComponentBuildScriptGenerator_t::GenerateJavaTypesOnlyBuildStatement
     {
         generatedIPC.insert(javaFiles.interfaceSourceFile);
 
-        script << "build " <<
-                  path::Combine(buildParams.workingDir, javaFiles.interfaceSourceFile) << ":"
-                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags = --gen-interface --lang Java"
-                  " --name-prefix " << ifPtr->internalName << " $ifgenFlags\n"
-                  "  outputDir = $builddir/" <<
-                  path::Combine(ifPtr->componentPtr->workingDir, "src") << "\n"
-                  "\n";
+        GenerateIfgenBuildStatement(
+                            path::Combine(buildParams.workingDir, javaFiles.interfaceSourceFile),
+                            ifPtr->apiFilePtr,
+                            "--gen-interface --lang Java --name-prefix " + ifPtr->internalName,
+                            "$builddir/" + path::Combine(ifPtr->componentPtr->workingDir, "src"));
     }
 }
 
@@ -924,13 +949,10 @@ void ComponentBuildScriptGenerator_t::GenerateClientUsetypesBuildStatement
     {
         generatedIPC.insert(headerFile);
 
-        script << "build $builddir/" << headerFile <<
-                  ": GenInterfaceCode " << apiFilePtr->path << " |";
-        GetIncludedApis(apiFilePtr);
-        script << "\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(headerFile) << "\n"
-                  "  ifgenFlags = --gen-interface $ifgenFlags\n"
-                  "\n";
+        GenerateIfgenBuildStatement("$builddir/" + headerFile,
+                                    apiFilePtr,
+                                    "--gen-interface",
+                                    "$builddir/" + path::GetContainingDir(headerFile));
     }
 }
 
@@ -954,13 +976,10 @@ void ComponentBuildScriptGenerator_t::GenerateServerUsetypesBuildStatement
     {
         generatedIPC.insert(headerFile);
 
-        script << "build $builddir/" << headerFile <<
-                  ": GenInterfaceCode " << apiFilePtr->path << " |";
-        GetIncludedApis(apiFilePtr);
-        script << "\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(headerFile) << "\n"
-                  "  ifgenFlags = --gen-server-interface $ifgenFlags\n"
-                  "\n";
+        GenerateIfgenBuildStatement("$builddir/" + headerFile,
+                                    apiFilePtr,
+                                    "--gen-server-interface",
+                                    "$builddir/" + path::GetContainingDir(headerFile));
     }
 }
 
@@ -983,14 +1002,10 @@ void ComponentBuildScriptGenerator_t::GenerateJavaUsetypesBuildStatement
     if (generatedIPC.find(interfaceFile) == generatedIPC.end())
     {
         generatedIPC.insert(interfaceFile);
-        script << "build " << path::Combine(buildParams.workingDir, interfaceFile) <<
-                  ": GenInterfaceCode " << apiFilePtr->path << " |";
-        GetIncludedApis(apiFilePtr);
-        script << "\n"
-                  "  outputDir = $builddir/" <<
-                  path::Combine(apiFilePtr->codeGenDir, "src") << "\n"
-                  "  ifgenFlags = --gen-interface --lang Java $ifgenFlags\n"
-                  "\n";
+        GenerateIfgenBuildStatement(path::Combine(buildParams.workingDir, interfaceFile),
+                                    apiFilePtr,
+                                    "--gen-interface --lang Java",
+                                    "$builddir/" + path::Combine(apiFilePtr->codeGenDir, "src"));
     }
 }
 
@@ -1074,12 +1089,10 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
     if (!generatedFiles.empty())
     {
         ifgenFlags += " --name-prefix " + ifPtr->internalName;
-        script << "build" << generatedFiles <<
-                  ": GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags =" << ifgenFlags << " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n\n";
+        GenerateIfgenBuildStatement(generatedFiles,
+                                    ifPtr->apiFilePtr,
+                                    ifgenFlags,
+                                    "$builddir/" + path::GetContainingDir(cFiles.sourceFile));
     }
 }
 
@@ -1122,17 +1135,11 @@ void ComponentBuildScriptGenerator_t::GenerateJavaBuildStatement
         requiredFlags += " " + apiFlag;
     }
 
-    script << "build " << generatedFiles << ": $\n"
-              "      GenInterfaceCode " << apiFilePtr->path << " | ";
-
-    GetIncludedApis(apiFilePtr);
-
-    script << "\n"
-              "  ifgenFlags = --lang Java" << requiredFlags << " --name-prefix "
-           << internalName << " $ifgenFlags\n"
-              "  outputDir = " << path::Combine(buildParams.workingDir,
-                                                path::Combine(componentPtr->workingDir, "src"))
-           << "\n\n";
+    GenerateIfgenBuildStatement(generatedFiles,
+                                apiFilePtr,
+                                "--lang Java" + requiredFlags + " --name-prefix " + internalName,
+                                path::Combine(buildParams.workingDir,
+                                              path::Combine(componentPtr->workingDir, "src")));
 }
 
 
@@ -1176,15 +1183,11 @@ void ComponentBuildScriptGenerator_t::GeneratePythonBuildStatement
 {
     std::string apiFlag = "--gen-all";
     std::string outputDir = path::Combine("$builddir", apiFilePtr->codeGenDir);
-    script << "build " << path::Combine(outputDir, pythonFiles.cdefSourceFile) << " $\n"
-              "      " << path::Combine(outputDir, pythonFiles.wrapperSourceFile) << " : $\n"
-              "      GenInterfaceCode " << apiFilePtr->path << " | ";
-
-    GetIncludedApis(apiFilePtr);
-    script << "\n"
-              "  ifgenFlags = --lang Python " << apiFlag << " --name-prefix "
-           << internalName << " $ifgenFlags\n"
-              "  outputDir = " << outputDir << "\n\n";
+    GenerateIfgenBuildStatement(path::Combine(outputDir, pythonFiles.cdefSourceFile) + " " +
+                                path::Combine(outputDir, pythonFiles.wrapperSourceFile),
+                                apiFilePtr,
+                                "--lang Python " + apiFlag + " --name-prefix " + internalName,
+                                outputDir);
 
     // Generate only the cffi cdef.h file of the included APIs
     apiFlag = "--gen-cdef";
@@ -1198,15 +1201,11 @@ void ComponentBuildScriptGenerator_t::GeneratePythonBuildStatement
         std::string pyCdefSourceFilePath = path::Combine(outputDir, pyCdefSourceFile + "_cdef.h");
         apiList += " " + pyCdefSourceFilePath;
 
-        script << "build " << pyCdefSourceFilePath << " : $\n"
-                  "      GenInterfaceCode " << includedApiPtr->path << " | ";
-
-        GetIncludedApis(includedApiPtr);
         // cffi cdef.h files generated in folder includedApi
-        script << "\n"
-                  "  ifgenFlags = --lang Python " << apiFlag << " --name-prefix "
-               << baseName << " $ifgenFlags\n"
-                  "  outputDir = " << outputDir + "/includedApi" << "\n\n";
+        GenerateIfgenBuildStatement(pyCdefSourceFilePath,
+                                    includedApiPtr,
+                                    "--lang Python " + apiFlag + " --name-prefix " + baseName,
+                                    outputDir + "/includedApi");
     }
     // generate the ffi C code. Add implicit dependencies on the included APIs
     script << "build " << path::Combine(outputDir, pythonFiles.cExtensionSourceFile) <<  ": $\n"
@@ -1351,14 +1350,15 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
         {
             ifgenFlags += " --async-server";
         }
+        if (ifPtr->threadCount > 0)
+        {
+            ifgenFlags += " --server-threads " + std::to_string(ifPtr->threadCount);
+        }
         ifgenFlags += " --name-prefix " + ifPtr->internalName;
-        script << "build" << generatedFiles << ":"
-                  " GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
-        GetIncludedApis(ifPtr->apiFilePtr);
-        script << "\n"
-                  "  ifgenFlags =" << ifgenFlags << " $ifgenFlags\n"
-                  "  outputDir = $builddir/" << path::GetContainingDir(cFiles.sourceFile) << "\n"
-                  "\n";
+        GenerateIfgenBuildStatement(generatedFiles,
+                                    ifPtr->apiFilePtr,
+                                    ifgenFlags,
+                                    "$builddir/" + path::GetContainingDir(cFiles.sourceFile));
     }
 }
 
@@ -1625,6 +1625,9 @@ void ComponentBuildScriptGenerator_t::Generate
     // Add build statements for all the IPC interfaces' generated files.
     GenerateIpcBuildStatements(componentPtr);
 
+    // Add the build statement that runs all the ifgen jobs added above.
+    baseGeneratorPtr->GenerateIfgenBatchBuildStatement();
+
     // Add a build statement for the build.ninja file itself.
     GenerateNinjaScriptBuildStatement(componentPtr);
 }
@@ -32,7 +32,12 @@ class ComponentBuildScriptGenerator_t : protected RequireBaseGenerator_t
         virtual void GetJavaInterfaceFiles(std::list<std::string>& result,
                                            model::Component_t* componentPtr);
 
-        virtual void GetIncludedApis(const model::ApiFile_t* apiFilePtr);
+        virtual void GetIncludedApis(const model::ApiFile_t* apiFilePtr,
+                                     std::set<std::string>& apiFiles);
+        virtual void GenerateIfgenBuildStatement(const std::string& outputFiles,
+                                                 const model::ApiFile_t* apiFilePtr,
+                                                 const std::string& ifgenFlags,
+                                                 const std::string& outputDir);
 
         virtual void GenerateTypesOnlyBuildStatement(const model::ApiTypesOnlyInterface_t* ifPtr);
         virtual void GenerateJavaTypesOnlyBuildStatement(const model::ApiTypesOnlyInterface_t* ifPtr);
@@ -476,6 +476,9 @@ void ExeBuildScriptGenerator_t::Generate
     // Add build statements for all the IPC interfaces' generated files.
     GenerateIpcBuildStatements(exePtr);
 
+    // Add the build statement that runs all the ifgen jobs added above.
+    baseGeneratorPtr->GenerateIfgenBatchBuildStatement();
+
     // Add a build statement for the build.ninja file itself.
     GenerateNinjaScriptBuildStatement(exePtr);
 }
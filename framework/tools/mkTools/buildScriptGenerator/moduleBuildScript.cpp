@@ -165,8 +165,8 @@ void ModuleBuildScriptGenerator_t::GenerateMakefile
                                 + "/modules/" + modulePtr->name);
     const std::string& compilerPath = buildParams.cCompilerPath;
 
-    std::ofstream makefile;
-    OpenFile(makefile, buildPath + "/Makefile", buildParams.beVerbose);
+    file::MakeDir(buildPath);
+    file::OutputFile_t makefile(buildPath + "/Makefile");
 
     // Specify kernel module name and list all object files to link
     makefile << "obj-m += " << modulePtr->name << ".o\n";
@@ -223,7 +223,7 @@ void ModuleBuildScriptGenerator_t::GenerateMakefile
     makefile << "clean:\n";
     makefile << "\t make -C $(KBUILD) M=" + buildPath + " clean\n";
 
-    CloseFile(makefile);
+    makefile.Commit();
 }
 
 
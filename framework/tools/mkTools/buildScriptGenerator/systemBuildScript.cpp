@@ -60,13 +60,16 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     "  description = Creating system info.properties\n"
     "  command = $\n"
 
-    // Copy the framework bin and lib directories into the system's staging area.
+    // Copy the framework bin and lib directories into the system's staging area.  Keep the
+    // files' time stamps so the hashes of the unchanged ones can be reused from the manifest.
     "            mkdir -p $stagingDir/bin && $\n"
     "            mkdir -p $stagingDir/lib && $\n"
     "            find $$LEGATO_ROOT/build/$target/framework/bin/* -type d -prune -o"
-                                  " -print | xargs cp -P -t $stagingDir/bin && $\n"
+                                  " -print | xargs cp -P --preserve=timestamps"
+                                  " -t $stagingDir/bin && $\n"
     "            find $$LEGATO_ROOT/build/$target/framework/lib/* -type d -prune -o"
-                       " \\( -type f -o -type l \\) -print | xargs cp -P -t $stagingDir/lib && $\n"
+                       " \\( -type f -o -type l \\) -print | xargs cp -P --preserve=timestamps"
+                       " -t $stagingDir/lib && $\n"
 
     // Copy liblegato Python files into the system's staging area.
     // cd in a subshell is used because it allows us to use the --parents option to recreate the
@@ -130,15 +133,9 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     // Delete the old info.properties file, if there is one.
     "            rm -f $out && $\n"
 
-    // Compute the MD5 checksum of the staging area.
-    // Don't follow symlinks (-P), and include the directory structure and the contents of symlinks
-    // as part of the MD5 hash.
-    "            md5=$$( ( cd $stagingDir && $\n"
-    "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-    "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-    "                      find -P -type l -print0 |LC_ALL=C sort -z |xargs -0 -r -n 1 readlink $\n"
-    "                    ) | md5sum) && $\n"
-    "            md5=$${md5%% *} && $\n"
+    // Compute the MD5 checksum of the staging area, only rehashing the files that changed since
+    // the last build.
+    "            md5=`legato-staging md5 -m $stagingDir.manifest $stagingDir` && $\n"
 
     // Get the Legato framework version and append the MD5 sum to it to get the system version.
     "           frameworkVersion=$$( cat $$LEGATO_ROOT/version ) && $\n"
@@ -161,8 +158,8 @@ void SystemBuildScriptGenerator_t::GenerateSystemBuildRules
     "  command = $\n"
     // Change all file time stamp to generate reproducible build. Can't use gnu tar --mtime option
     // as it is not available in other tar (e.g bsdtar)
-    "            mtime=`stat -c %Y " << systemPtr->defFilePtr->path <<"` && $\n"
-    "            find $stagingDir -exec touch  --no-dereference --date=@$$mtime {} \\; && $\n"
+    "            legato-staging touch `stat -c %Y " << systemPtr->defFilePtr->path << "`"
+                                       " $stagingDir && $\n"
     // Pack the system's staging area into a compressed tarball.
     "           (cd $stagingDir && find . -print0 | LC_ALL=C sort -z"
                                  " |tar --no-recursion --null -T -"
@@ -534,6 +531,9 @@ void SystemBuildScriptGenerator_t::Generate
         GenerateSystemPackBuildStatement(systemPtr);
     }
 
+    // Add the build statement that runs all the ifgen jobs added above.
+    baseGeneratorPtr->GenerateIfgenBatchBuildStatement();
+
     // Add a build statement for the build.ninja file itself.
     GenerateNinjaScriptBuildStatement(systemPtr);
 }
@@ -89,13 +89,7 @@ void GenerateCLangComponentMainFile
 
     // Open the .c file for writing.
     file::MakeDir(outputDir);
-    std::ofstream fileStream(filePath, std::ofstream::trunc);
-    if (!fileStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t fileStream(filePath);
 
     // Generate file header and #include directives.
     fileStream << "/*\n"
@@ -214,6 +208,8 @@ void GenerateCLangComponentMainFile
                   "#ifdef __cplusplus\n"
                   "}\n"
                   "#endif\n";
+
+    fileStream.Commit();
 }
 
 
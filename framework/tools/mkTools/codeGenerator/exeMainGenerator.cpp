@@ -45,13 +45,7 @@ void GenerateCLangExeMain
 
     // Open the file as an output stream.
     file::MakeDir(path::GetContainingDir(sourceFile));
-    std::ofstream outputFile(sourceFile);
-    if (outputFile.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), sourceFile)
-        );
-    }
+    file::OutputFile_t outputFile(sourceFile);
 
     // Generate the file header comment and #include directives.
     outputFile << "\n"
@@ -157,6 +151,42 @@ void GenerateCLangExeMain
                   "    #endif\n"
                   "\n";
 
+    // Client-side interfaces bound to a server-side interface in this same executable can talk
+    // to it directly, without going through the Service Directory.
+    std::set<std::string> serverIfNames;
+    for (auto componentInstancePtr : exePtr->componentInstances)
+    {
+        for (auto ifInstancePtr : componentInstancePtr->serverApis)
+        {
+            serverIfNames.insert(ifInstancePtr->name);
+        }
+    }
+    bool isFirstLocalBinding = true;
+    for (auto componentInstancePtr : exePtr->componentInstances)
+    {
+        for (auto ifInstancePtr : componentInstancePtr->clientApis)
+        {
+            auto bindingPtr = ifInstancePtr->bindingPtr;
+
+            if (   (bindingPtr != NULL)
+                && (bindingPtr->serverType == model::Binding_t::INTERNAL)
+                && (serverIfNames.count(bindingPtr->serverIfName) != 0) )
+            {
+                if (isFirstLocalBinding)
+                {
+                    outputFile << "    // Bind client-side interfaces to servers in this process.\n";
+                    isFirstLocalBinding = false;
+                }
+                outputFile << "    le_msg_AddLocalBinding(\"" << ifInstancePtr->name << "\", \""
+                           << bindingPtr->serverIfName << "\");\n";
+            }
+        }
+    }
+    if (!isFirstLocalBinding)
+    {
+        outputFile << "\n";
+    }
+
     // Iterate over the list of Component Instances, loading their dynamic libraries.
     outputFile << "    // Load dynamic libraries.\n";
     for (auto componentInstancePtr : exePtr->componentInstances)
@@ -205,7 +235,7 @@ void GenerateCLangExeMain
                   "    LE_FATAL(\"== SHOULDN'T GET HERE! ==\");\n"
                   "}\n";
 
-    outputFile.close();
+    outputFile.Commit();
 }
 
 
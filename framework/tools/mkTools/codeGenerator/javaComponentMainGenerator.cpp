@@ -43,13 +43,7 @@ void GenerateJavaComponentMainFile
 
     // Open the .java file for writing.
     file::MakeDir(outputDir);
-    std::ofstream outputFile(filePath, std::ofstream::trunc);
-    if (!outputFile.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t outputFile(filePath);
 
     std::string apiImports;
     std::string serverVars;
@@ -159,6 +153,8 @@ void GenerateJavaComponentMainFile
                   "        return component;\n"
                   "    }\n"
                   "}\n";
+
+    outputFile.Commit();
 }
 
 
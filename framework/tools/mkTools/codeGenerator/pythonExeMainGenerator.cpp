@@ -32,7 +32,7 @@ void GeneratePythonExeMain
     file::MakeDir(path::GetContainingDir(launcherFile));
 
     // Open the file as an output stream.
-    std::ofstream outputFile(launcherFile);
+    file::OutputFile_t outputFile(launcherFile);
 
     outputFile << "#!/usr/bin/env python\n";
     outputFile << "import sys\n"
@@ -94,7 +94,7 @@ void GeneratePythonExeMain
     }
     outputFile << "liblegato.le_event_RunLoop()";
     outputFile << "\n\n";
-    outputFile.close();
+    outputFile.Commit();
 }
 
 
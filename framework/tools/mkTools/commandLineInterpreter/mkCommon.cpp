@@ -305,6 +305,11 @@ void FindToolChain
     buildParams.objcopyPath = GetToolPath(buildParams.target, "OBJCOPY");
     buildParams.readelfPath = GetToolPath(buildParams.target, "READELF");
     buildParams.compilerCachePath = GetToolPath(buildParams.target, "CCACHE", false);
+    buildParams.componentCacheDir = GetTargetEnvInfo(buildParams.target, "COMPONENT_CACHE");
+    if (!buildParams.componentCacheDir.empty())
+    {
+        buildParams.componentCacheDir = path::MakeAbsolute(buildParams.componentCacheDir);
+    }
     buildParams.crossToolPaths = GetCrossToolPaths(buildParams.target);
 
     if (buildParams.beVerbose)
@@ -321,6 +326,7 @@ void FindToolChain
         std::cout << "Object file copier/translator = " << buildParams.objcopyPath << std::endl;
         std::cout << "ELF file info extractor = " << buildParams.readelfPath << std::endl;
         std::cout << "Compiler cache = " << buildParams.compilerCachePath << std::endl;
+        std::cout << "Component cache = " << buildParams.componentCacheDir << std::endl;
 
         std::cout << "Cross tool paths = ";
         for (const auto &crossToolPath : buildParams.crossToolPaths)
@@ -459,6 +465,15 @@ void RunNinja
         //   may seem to be the natural choice, given that these functions do not modify
         //   either the array of pointers or the characters to which the function points,
         //   but this would disallow existing correct code.
+        // When profiling, ninja has to run as a child process so its build edges can be
+        // collected once it has finished.
+        if (profile::IsEnabled())
+        {
+            int exitCode = profile::RunNinja(buildParams.workingDir, ninjaArgv);
+            profile::Report();
+            exit(exitCode);
+        }
+
         (void)execvp("ninja", const_cast<char **>(ninjaArgv));
 
         int errCode = errno;
@@ -482,6 +497,8 @@ void GenerateCode
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("generate: component", componentPtr->name);
+
     // Create a working directory to build the component in.
     file::MakeDir(path::Combine(buildParams.workingDir, componentPtr->workingDir));
 
@@ -495,7 +512,7 @@ void GenerateCode
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Generate code for all the components in a given set.
+ * Generate code for all the components in a given set, in parallel.
  */
 //--------------------------------------------------------------------------------------------------
 void GenerateCode
@@ -505,16 +522,17 @@ void GenerateCode
 )
 //--------------------------------------------------------------------------------------------------
 {
-    for (auto componentPtr : components)
-    {
-        GenerateCode(componentPtr, buildParams);
-    }
+    generator::ForEachInParallel(components, buildParams,
+                                 [&buildParams](model::Component_t* componentPtr)
+                                 {
+                                     GenerateCode(componentPtr, buildParams);
+                                 });
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Generate code for all the components in a given map.
+ * Generate code for all the components in a given map, in parallel.
  */
 //--------------------------------------------------------------------------------------------------
 void GenerateCode
@@ -524,10 +542,12 @@ void GenerateCode
 )
 //--------------------------------------------------------------------------------------------------
 {
-    for (auto& mapEntry : components)
-    {
-        GenerateCode(mapEntry.second, buildParams);
-    }
+    generator::ForEachInParallel(components, buildParams,
+                                 [&buildParams](
+                                     const std::pair<const std::string, model::Component_t*>& entry)
+                                 {
+                                     GenerateCode(entry.second, buildParams);
+                                 });
 }
 
 
@@ -275,6 +275,13 @@ static void GetCommandLineArgs
                                   " is intended to be included in a system definition (.sdef) "
                                   " file's 'apps:' section in place of a .adef file."));
 
+    args::AddOptionalFlag(&BuildParams.lto,
+                          'T',
+                          "lto",
+                          LE_I18N("Compile and link with link-time optimization.  This lets the"
+                                  " compiler inline the generated IPC code into its callers and"
+                                  " merge the pack/unpack helpers duplicated across interfaces."));
+
     args::AddOptionalFlag(&BuildParams.noPie,
                           'p',
                           "no-pie",
@@ -353,6 +360,9 @@ void MakeApp
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
+    // Reuse the parse trees of unchanged definition files from previous runs.
+    parser::cache::SetDir(path::Combine(BuildParams.workingDir, "parseCache"));
+
     // If we have been asked not to run Ninja, then delete the staging area because it probably
     // will contain some of the wrong files now that .Xdef file have changed.
     if (DontRunNinja)
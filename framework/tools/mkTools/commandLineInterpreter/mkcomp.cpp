@@ -215,6 +215,13 @@ static void GetCommandLineArgs
                                   " that need to be regenerated when the build.ninja finds itself"
                                   " out of date."));
 
+    args::AddOptionalFlag(&BuildParams.lto,
+                          'T',
+                          "lto",
+                          LE_I18N("Compile and link with link-time optimization.  This lets the"
+                                  " compiler inline the generated IPC code into its callers and"
+                                  " merge the pack/unpack helpers duplicated across interfaces."));
+
     args::AddOptionalFlag(&BuildParams.codeGenOnly,
                           'g',
                           "generate-code",
@@ -274,6 +281,9 @@ void MakeComponent
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
+    // Reuse the parse trees of unchanged definition files from previous runs.
+    parser::cache::SetDir(path::Combine(BuildParams.workingDir, "parseCache"));
+
     // If we have not been asked to ignore any already existing build.ninja, and the command-line
     // arguments and environment variables we were given are the same as last time, just run ninja.
     if (!DontRunNinja)
@@ -207,6 +207,13 @@ static void GetCommandLineArgs
                                   " This is useful for supporting context-sensitive auto-complete"
                                   " and related features in source code editors, for example."));
 
+    args::AddOptionalFlag(&BuildParams.lto,
+                          'T',
+                          "lto",
+                          LE_I18N("Compile and link with link-time optimization.  This lets the"
+                                  " compiler inline the generated IPC code into its callers and"
+                                  " merge the pack/unpack helpers duplicated across interfaces."));
+
     args::AddOptionalFlag(&BuildParams.noPie,
                           'p',
                           "no-pie",
@@ -464,6 +471,9 @@ void MakeExecutable
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
+    // Reuse the parse trees of unchanged definition files from previous runs.
+    parser::cache::SetDir(path::Combine(BuildParams.workingDir, "parseCache"));
+
     // If we have not been asked to ignore any already existing build.ninja, and the command-line
     // arguments and environment variables we were given are the same as last time, just run ninja.
     if (!DontRunNinja)
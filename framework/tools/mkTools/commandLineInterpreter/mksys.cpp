@@ -39,16 +39,32 @@ static std::string SystemName;
 /// a new build.ninja.
 static bool DontRunNinja = false;
 
+/// true if the time spent in each phase of the build should be reported.
+static bool Profile = false;
+
 /// Steps to run to generate a Linux system
 static const generator::SystemGenerator_t LinuxSteps[] =
 {
     [](model::System_t* systemPtr, const mk::BuildParams_t& buildParams)
     {
+        profile::Scope_t profileScope("generate: components");
         GenerateCode(model::Component_t::GetComponentMap(), buildParams);
     },
-    generator::ForAllApps<GenerateCode>,
-    config::Generate,
-    ninja::Generate,
+    [](model::System_t* systemPtr, const mk::BuildParams_t& buildParams)
+    {
+        profile::Scope_t profileScope("generate: apps");
+        generator::ForAllApps<GenerateCode>(systemPtr, buildParams);
+    },
+    [](model::System_t* systemPtr, const mk::BuildParams_t& buildParams)
+    {
+        profile::Scope_t profileScope("generate: config");
+        config::Generate(systemPtr, buildParams);
+    },
+    [](model::System_t* systemPtr, const mk::BuildParams_t& buildParams)
+    {
+        profile::Scope_t profileScope("generate: build script");
+        ninja::Generate(systemPtr, buildParams);
+    },
     NULL
 };
 
@@ -229,6 +245,21 @@ static void GetCommandLineArgs
                                   " regenerate itself and any other files that need to be"
                                   " regenerated when the build.ninja finds itself out of date."));
 
+    args::AddOptionalFlag(&BuildParams.lto,
+                          'T',
+                          "lto",
+                          LE_I18N("Compile and link with link-time optimization.  This lets the"
+                                  " compiler inline the generated IPC code into its callers and"
+                                  " merge the pack/unpack helpers duplicated across interfaces."));
+
+    args::AddOptionalFlag(&Profile,
+                          'R',
+                          "profile",
+                          LE_I18N("Report the time spent in each phase of the build (parsing,"
+                                  " modelling, code generation and the ninja build steps) and"
+                                  " save it as a Chrome trace in profile.json in the working"
+                                  " directory."));
+
     args::AddOptionalFlag(&BuildParams.codeGenOnly,
                           'g',
                           "generate-code",
@@ -296,6 +327,11 @@ void MakeSystem
 {
     GetCommandLineArgs(argc, argv);
 
+    if (Profile)
+    {
+        profile::Enable(path::Combine(BuildParams.workingDir, "profile.json"));
+    }
+
     BuildParams.argc = argc;
     BuildParams.argv = argv;
 
@@ -306,6 +342,9 @@ void MakeSystem
     // Set the target-specific environment variables (e.g., LEGATO_TARGET).
     envVars::SetTargetSpecific(BuildParams);
 
+    // Reuse the parse trees of unchanged definition files from previous runs.
+    parser::cache::SetDir(path::Combine(BuildParams.workingDir, "parseCache"));
+
     // Compute the staging directory path.
     auto stagingDir = path::Combine(BuildParams.workingDir, "staging");
 
@@ -341,7 +380,11 @@ void MakeSystem
     }
 
     // Construct a model of the system.
-    model::System_t* systemPtr = modeller::GetSystem(SdefFilePath, BuildParams);
+    model::System_t* systemPtr;
+    {
+        profile::Scope_t profileScope("model");
+        systemPtr = modeller::GetSystem(SdefFilePath, BuildParams);
+    }
 
     // If verbose mode is on, print a summary of the system model.
     if (BuildParams.beVerbose)
@@ -362,6 +405,8 @@ void MakeSystem
     {
         RunNinja(BuildParams);
     }
+
+    profile::Report();
 }
 
 
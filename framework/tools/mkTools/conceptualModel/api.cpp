@@ -422,7 +422,8 @@ ApiServerInterface_t::ApiServerInterface_t
 //--------------------------------------------------------------------------------------------------
 :   ApiRef_t(aPtr, cPtr, iName),
     async(isAsync),
-    manualStart(false)
+    manualStart(false),
+    threadCount(0)
 //--------------------------------------------------------------------------------------------------
 {
 }
@@ -440,17 +441,16 @@ void ApiServerInterface_t::GetInterfaceFiles
 const
 //--------------------------------------------------------------------------------------------------
 {
-    std::string codeGenDir;
+    std::string dirName = (async ? "async_server" : "server");
 
-    if (async)
+    // Servers with a thread pool get different generated code.
+    if (threadCount > 0)
     {
-        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "async_server/");
-    }
-    else
-    {
-        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "server/");
+        dirName += "_threads" + std::to_string(threadCount);
     }
 
+    std::string codeGenDir = path::Combine(apiFilePtr->codeGenDir, dirName + "/");
+
     cFiles.interfaceFile = codeGenDir + internalName + "_server.h";
     cFiles.internalHFile = codeGenDir + internalName + "_messages.h";
     cFiles.sourceFile = codeGenDir + internalName + "_server.c";
@@ -176,6 +176,7 @@ struct ApiServerInterface_t : public ApiRef_t
 {
     const bool async;         ///< true = component wants to use asynchronous mode of operation.
     bool manualStart;   ///< true = generated main() should not call AdvertiseService() function.
+    size_t threadCount; ///< Number of threads handling client requests (0 = the server thread).
 
     ApiServerInterface_t(ApiFile_t* aPtr, Component_t* cPtr, const std::string& iName, bool async);
 
@@ -329,4 +329,21 @@ const
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path to the app's settings.bin file relative to the build's working directory.
+ *
+ * @return the file path.
+ */
+//--------------------------------------------------------------------------------------------------
+std::string App_t::SettingsFilePath
+(
+)
+const
+//--------------------------------------------------------------------------------------------------
+{
+    return workingDir + "/staging/settings.bin";
+}
+
+
 } // namespace modeller
@@ -113,6 +113,9 @@ struct App_t : public HasTargetInfo_t
 
     // Get the path to the app's root.cfg file relative to the build's working directory.
     std::string ConfigFilePath() const;
+
+    // Get the path to the app's settings.bin file relative to the build's working directory.
+    std::string SettingsFilePath() const;
 };
 
 
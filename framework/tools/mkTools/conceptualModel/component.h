@@ -28,6 +28,7 @@ struct Component_t : public HasTargetInfo_t
     std::list<ObjectFile_t*> cxxObjectFiles;///< List of .o files to build from C++ source files.
     std::list<JavaPackage_t*> javaPackages; ///< List of packages of Java code.
     std::list<PythonPackage_t*> pythonPackages; ///< List of packages of Python code.
+    std::list<ObjectFile_t*> jsSnapshots;   ///< List of JerryScript snapshots to build from .js.
     std::list<std::string> externalBuildCommands; ///< List of external build commands.
 
     std::set<std::string> staticLibs;   ///< Static library files required by this component.
@@ -100,6 +101,12 @@ struct Component_t : public HasTargetInfo_t
         return pythonPackages.empty() != true;
     }
 
+    // Does the component have JavaScript code?
+    bool HasJavaScriptCode() const
+    {
+        return jsSnapshots.empty() != true;
+    }
+
     // Is the component built using an external build process
     bool HasExternalBuild() const
     {
@@ -831,12 +831,245 @@ static void GenerateAppWatchdogConfig
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A value in an app's settings blob.
+ **/
+//--------------------------------------------------------------------------------------------------
+struct SettingValue_t
+{
+    enum Type_t
+    {
+        INT = 0,
+        BOOL = 1,
+        STRING = 2
+    };
+
+    Type_t type;
+    int64_t intValue;           ///< Value of an INT, or 0/1 for a BOOL.
+    std::string stringValue;    ///< Value of a STRING.
+
+    SettingValue_t(int64_t value) : type(INT), intValue(value) {}
+    SettingValue_t(bool value) : type(BOOL), intValue(value ? 1 : 0) {}
+    SettingValue_t(const std::string& value) : type(STRING), intValue(0), stringValue(value) {}
+};
+
+
+/// Settings to put in a settings blob, by path relative to the app's node in the config tree.
+/// Ordered the way the blob needs them to be.
+typedef std::map<std::string, SettingValue_t> Settings_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Collect the app's static settings: the ones written to the config tree from the .adef that
+ * the Supervisor reads when it starts the app.  They must be kept the same as the ones written
+ * to root.cfg by GenerateAppLimitsConfig(), GenerateProcessConfig() etc.
+ **/
+//--------------------------------------------------------------------------------------------------
+static Settings_t GetAppSettings
+(
+    const model::App_t* appPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Settings_t settings;
+
+    if (appPtr->version != "")
+    {
+        settings.emplace("version", SettingValue_t(appPtr->version));
+    }
+
+    settings.emplace("sandboxed", SettingValue_t(appPtr->isSandboxed));
+    settings.emplace("startManual",
+                     SettingValue_t(appPtr->startTrigger == model::App_t::MANUAL));
+
+    settings.emplace("maxSecureStorageBytes",
+                     SettingValue_t((int64_t)appPtr->maxSecureStorageBytes.Get()));
+    settings.emplace("maxThreads", SettingValue_t((int64_t)appPtr->maxThreads.Get()));
+    settings.emplace("maxMQueueBytes", SettingValue_t((int64_t)appPtr->maxMQueueBytes.Get()));
+    settings.emplace("maxQueuedSignals", SettingValue_t((int64_t)appPtr->maxQueuedSignals.Get()));
+    settings.emplace("maxMemoryBytes", SettingValue_t((int64_t)appPtr->maxMemoryBytes.Get()));
+    settings.emplace("cpuShare", SettingValue_t((int64_t)appPtr->cpuShare.Get()));
+
+    // Not supported for unsandboxed apps (GenerateAppLimitsConfig() warns about it).
+    if (appPtr->maxFileSystemBytes.IsSet() && appPtr->isSandboxed)
+    {
+        settings.emplace("maxFileSystemBytes",
+                         SettingValue_t((int64_t)appPtr->maxFileSystemBytes.Get()));
+    }
+
+    if (appPtr->watchdogTimeout.IsSet())
+    {
+        settings.emplace("watchdogTimeout", SettingValue_t((int64_t)appPtr->watchdogTimeout.Get()));
+    }
+    if (appPtr->maxWatchdogTimeout.IsSet())
+    {
+        settings.emplace("maxWatchdogTimeout",
+                         SettingValue_t((int64_t)appPtr->maxWatchdogTimeout.Get()));
+    }
+    if (appPtr->watchdogAction.IsSet())
+    {
+        settings.emplace("watchdogAction", SettingValue_t(appPtr->watchdogAction.Get()));
+    }
+
+    for (auto procEnvPtr : appPtr->processEnvs)
+    {
+        for (auto procPtr : procEnvPtr->processes)
+        {
+            std::string procPath = "procs/" + procPtr->GetName() + "/";
+
+            if (procEnvPtr->faultAction.IsSet())
+            {
+                settings.emplace(procPath + "faultAction",
+                                 SettingValue_t(procEnvPtr->faultAction.Get()));
+            }
+            auto& startPriority = procEnvPtr->GetStartPriority();
+            if (startPriority.IsSet())
+            {
+                settings.emplace(procPath + "priority", SettingValue_t(startPriority.Get()));
+            }
+
+            settings.emplace(procPath + "maxCoreDumpFileBytes",
+                             SettingValue_t((int64_t)procEnvPtr->maxCoreDumpFileBytes.Get()));
+            settings.emplace(procPath + "maxFileBytes",
+                             SettingValue_t((int64_t)procEnvPtr->maxFileBytes.Get()));
+            settings.emplace(procPath + "maxLockedMemoryBytes",
+                             SettingValue_t((int64_t)procEnvPtr->maxLockedMemoryBytes.Get()));
+            settings.emplace(procPath + "maxFileDescriptors",
+                             SettingValue_t((int64_t)procEnvPtr->maxFileDescriptors.Get()));
+
+            if (procEnvPtr->watchdogTimeout.IsSet())
+            {
+                settings.emplace(procPath + "watchdogTimeout",
+                                 SettingValue_t((int64_t)procEnvPtr->watchdogTimeout.Get()));
+            }
+            if (procEnvPtr->maxWatchdogTimeout.IsSet())
+            {
+                settings.emplace(procPath + "maxWatchdogTimeout",
+                                 SettingValue_t((int64_t)procEnvPtr->maxWatchdogTimeout.Get()));
+            }
+            if (procEnvPtr->watchdogAction.IsSet())
+            {
+                settings.emplace(procPath + "watchdogAction",
+                                 SettingValue_t(procEnvPtr->watchdogAction.Get()));
+            }
+        }
+    }
+
+    return settings;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an integer to a settings blob, in little-endian byte order.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void WriteLittleEndian
+(
+    std::ostream& blobStream,
+    uint64_t value,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (size_t i = 0; i < numBytes; i++)
+    {
+        blobStream.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the app's settings blob: a read-only copy of the app's static settings from root.cfg
+ * that the framework can memory-map and read without going through the Config Tree.  It will be
+ * output to a file called "settings.bin" in the app's staging directory.
+ *
+ * All integers are little-endian.  The file is made of:
+ *
+ *  - a 16-byte header: the magic number "LESB", the format version (uint32, 1), the number of
+ *    entries (uint32) and the offset from the start of the file of the string table (uint32);
+ *  - the entries, sorted by key (byte-wise), 16 bytes each: the offset of the key in the string
+ *    table (uint32), the value type (uint32, 0 = integer, 1 = boolean, 2 = string) and the value
+ *    (int64; 0 or 1 for a boolean, the offset of the string in the string table for a string);
+ *  - the string table: NUL-terminated UTF-8 strings.
+ *
+ * Keys are paths relative to the app's node in the config tree, like "maxThreads" or
+ * "procs/myProc/maxFileBytes".
+ **/
+//--------------------------------------------------------------------------------------------------
+static void GenerateSettingsBlob
+(
+    const model::App_t* appPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const size_t HeaderSize = 16;
+    static const size_t EntrySize = 16;
+
+    std::string filePath = path::Combine(buildParams.workingDir, appPtr->SettingsFilePath());
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Generating settings blob for app '%s' in file '%s'."),
+                                appPtr->name, filePath)
+                  << std::endl;
+    }
+
+    Settings_t settings = GetAppSettings(appPtr);
+
+    // Build the string table first, so the entries can refer to it.
+    std::string stringTable;
+    std::vector<std::pair<uint32_t, uint64_t>> entryOffsets;
+
+    for (const auto& setting : settings)
+    {
+        uint32_t keyOffset = stringTable.size();
+        stringTable.append(setting.first);
+        stringTable.push_back('\0');
+
+        uint64_t value = setting.second.intValue;
+        if (setting.second.type == SettingValue_t::STRING)
+        {
+            value = stringTable.size();
+            stringTable.append(setting.second.stringValue);
+            stringTable.push_back('\0');
+        }
+
+        entryOffsets.push_back(std::make_pair(keyOffset, value));
+    }
+
+    file::OutputFile_t blobStream(filePath);
+
+    blobStream.write("LESB", 4);
+    WriteLittleEndian(blobStream, 1, 4);
+    WriteLittleEndian(blobStream, settings.size(), 4);
+    WriteLittleEndian(blobStream, HeaderSize + (settings.size() * EntrySize), 4);
+
+    auto entryIter = entryOffsets.begin();
+    for (const auto& setting : settings)
+    {
+        WriteLittleEndian(blobStream, entryIter->first, 4);
+        WriteLittleEndian(blobStream, setting.second.type, 4);
+        WriteLittleEndian(blobStream, entryIter->second, 8);
+        entryIter++;
+    }
+
+    blobStream.write(stringTable.data(), stringTable.size());
+
+    blobStream.Commit();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate the configuration that the framework needs for a given app.  This is the configuration
  * that will be installed in the system configuration tree by the installer when the app is
  * installed on the target.  It will be output to a file called "root.cfg" in the app's staging
- * directory.
+ * directory, along with a memory-mappable copy of the app's static settings called "settings.bin".
  **/
 //--------------------------------------------------------------------------------------------------
 void Generate
@@ -857,14 +1090,7 @@ void Generate
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t cfgStream(filePath);
 
     cfgStream << "{" << std::endl;
 
@@ -885,6 +1111,10 @@ void Generate
     GenerateAppWatchdogConfig(cfgStream, appPtr);
 
     cfgStream << "}" << std::endl;
+
+    cfgStream.Commit();
+
+    GenerateSettingsBlob(appPtr, buildParams);
 }
 
 
@@ -1172,14 +1402,7 @@ static void GenerateModulesConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t cfgStream(filePath);
 
     // Create a map to store the modules and its dependencies for detecting cycle.
     std::map<std::string, VectorPairStringToken_t> checkCycleMap;
@@ -1249,6 +1472,8 @@ static void GenerateModulesConfig
 
     // Check for cyclic dependencies in kernel modules
     hasCyclicDependency(checkCycleMap, visitedMap, recurStackMap);
+
+    cfgStream.Commit();
 }
 
 
@@ -1274,14 +1499,7 @@ static void GenerateUsersConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t cfgStream(filePath);
 
     cfgStream << "{\n";
 
@@ -1306,6 +1524,8 @@ static void GenerateUsersConfig
     }
 
     cfgStream << "}\n";
+
+    cfgStream.Commit();
 }
 
 
@@ -1367,14 +1587,7 @@ static void GenerateAppsConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t cfgStream(filePath);
 
     cfgStream << "{\n";
 
@@ -1388,6 +1601,8 @@ static void GenerateAppsConfig
     }
 
     cfgStream << "}\n";
+
+    cfgStream.Commit();
 }
 
 
@@ -1432,20 +1647,15 @@ static void GenerateFrameworkConfig
     }
 
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    file::OutputFile_t cfgStream(filePath);
 
     cfgStream << "{" << std::endl;
 
     GenerateExternalWatchdogKickConfig(cfgStream, systemPtr);
 
     cfgStream << "}" << std::endl;
+
+    cfgStream.Commit();
 }
 
 
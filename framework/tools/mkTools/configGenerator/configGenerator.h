@@ -18,7 +18,7 @@ namespace config
  * Generate the configuration that the framework needs for a given app.  This is the configuration
  * that will be installed in the system configuration tree by the installer when the app is
  * installed on the target.  It will be output to a file called "root.cfg" in the app's staging
- * directory.
+ * directory, along with a memory-mappable copy of the app's static settings called "settings.bin".
  **/
 //--------------------------------------------------------------------------------------------------
 void Generate
@@ -311,7 +311,8 @@ void MakeDir
 
         int status = mkdir(path.c_str(), mode);
 
-        if (status != 0)
+        // Another generator thread may have created it in the meantime.
+        if ((status != 0) && ((errno != EEXIST) || !DirectoryExists(path)))
         {
             int err = errno;
 
@@ -437,4 +438,142 @@ void DeleteFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether two files have identical content.
+ *
+ * @return true if both files can be read and their contents are the same.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HaveSameContent
+(
+    const std::string& path1,
+    const std::string& path2
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat stat1;
+    struct stat stat2;
+
+    if (   (stat(path1.c_str(), &stat1) != 0)
+        || (stat(path2.c_str(), &stat2) != 0)
+        || (stat1.st_size != stat2.st_size)
+        || !S_ISREG(stat2.st_mode))
+    {
+        return false;
+    }
+
+    std::ifstream file1(path1, std::ios::binary);
+    std::ifstream file2(path2, std::ios::binary);
+
+    char buffer1[4096];
+    char buffer2[sizeof(buffer1)];
+
+    while (file1.good() && file2.good())
+    {
+        file1.read(buffer1, sizeof(buffer1));
+        file2.read(buffer2, sizeof(buffer2));
+
+        if (   (file1.gcount() != file2.gcount())
+            || (memcmp(buffer1, buffer2, file1.gcount()) != 0))
+        {
+            return false;
+        }
+    }
+
+    return file1.eof() && file2.eof();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a temporary file for writing the content of a generated file.
+ *
+ * @throw mk::Exception_t if the file can't be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+OutputFile_t::OutputFile_t
+(
+    const std::string& filePath ///< Path of the file to generate.
+)
+//--------------------------------------------------------------------------------------------------
+:   filePath(filePath),
+    tempFilePath(filePath + ".tmp"),
+    isCommitted(false)
+{
+    open(tempFilePath, std::ofstream::trunc);
+
+    if (!is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), tempFilePath)
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discards the temporary file if the output was never committed.
+ */
+//--------------------------------------------------------------------------------------------------
+OutputFile_t::~OutputFile_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!isCommitted)
+    {
+        close();
+        unlink(tempFilePath.c_str());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes the output and moves it into place if its content differs from the existing file.
+ *
+ * @return true if the destination file was (re)written, false if it was already up to date.
+ *
+ * @throw mk::Exception_t if the output couldn't be written or moved into place.
+ */
+//--------------------------------------------------------------------------------------------------
+bool OutputFile_t::Commit
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    close();
+
+    if (fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to write file '%s'."), tempFilePath)
+        );
+    }
+
+    isCommitted = true;
+
+    if (HaveSameContent(tempFilePath, filePath))
+    {
+        unlink(tempFilePath.c_str());
+        return false;
+    }
+
+    if (rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+    {
+        int error = errno;
+        unlink(tempFilePath.c_str());
+
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to rename '%s' to '%s' (%s)."),
+                       tempFilePath, filePath, strerror(error))
+        );
+    }
+
+    return true;
+}
+
+
 } // namespace file
@@ -173,6 +173,40 @@ void DeleteFile
 );
 
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output file stream for generated files.
+ *
+ * Content is written to a temporary file next to the destination.  When the output is committed,
+ * the temporary file replaces the destination only if the content differs; otherwise it is
+ * discarded and the destination is left untouched, so its timestamp doesn't trigger rebuilds of
+ * everything that depends on it.  The replacement is an atomic rename, so a reader never sees a
+ * partially written file.
+ *
+ * If the object is destroyed without being committed (e.g., because generation failed), the
+ * temporary file is deleted and the destination is left as it was.
+ */
+//--------------------------------------------------------------------------------------------------
+class OutputFile_t : public std::ofstream
+{
+    public:
+
+        OutputFile_t(const std::string& filePath);
+        ~OutputFile_t();
+
+        bool Commit();
+
+        const std::string& Path() const { return filePath; }
+
+    private:
+
+        std::string filePath;       ///< Path of the destination file.
+        std::string tempFilePath;   ///< Path of the temporary file being written.
+        bool isCommitted;
+};
+
+
 } // namespace file
 
 #endif // LEGATO_MKTOOLS_FILE_H_INCLUDE_GUARD
@@ -40,6 +40,78 @@ typedef void (*ModuleGenerator_t)(model::Module_t* modulePtr,
 typedef void (*SystemGenerator_t)(model::System_t* systemPtr,
                                   const mk::BuildParams_t& buildParams);
 
+/**
+ * Run a function on each item of a container, spreading the items over a pool of worker threads.
+ *
+ * Uses as many threads as ninja is told to run jobs, or one per CPU by default, except in verbose
+ * mode where the items are handled in order so the progress messages stay readable.  The function
+ * must only write files that belong to the item it is given.  If it throws for several items, the
+ * exception thrown for the earliest item in the container is rethrown, so errors are reported
+ * the same way regardless of scheduling.
+ */
+template<class Container, class Func>
+void ForEachInParallel
+(
+    const Container& items,
+    const mk::BuildParams_t& buildParams,
+    Func func
+)
+{
+    std::vector<const typename Container::value_type*> itemPtrs;
+
+    for (const auto& item : items)
+    {
+        itemPtrs.push_back(&item);
+    }
+
+    size_t threadCount = (buildParams.jobCount > 0 ? buildParams.jobCount
+                                                   : std::thread::hardware_concurrency());
+    if (buildParams.beVerbose)
+    {
+        threadCount = 1;
+    }
+    threadCount = std::max<size_t>(1, std::min(threadCount, itemPtrs.size()));
+
+    std::vector<std::exception_ptr> errors(itemPtrs.size());
+    std::atomic<size_t> nextIndex(0);
+
+    auto worker = [&]()
+    {
+        for (size_t i = nextIndex++; i < itemPtrs.size(); i = nextIndex++)
+        {
+            try
+            {
+                func(*itemPtrs[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 /**
  * Run all generators in a collection on a model
  */
@@ -57,7 +129,7 @@ void RunAllGenerators(GeneratorIter generatorPtr,
 }
 
 /**
- * Adaptor to run a component generator on all components in an app.
+ * Adaptor to run a component generator on all components in an app, in parallel.
  */
 template<ComponentGenerator_t ComponentGenerator>
 void ForAllComponents
@@ -66,14 +138,15 @@ void ForAllComponents
     const mk::BuildParams_t& buildParams
 )
 {
-    for (auto componentPtr : appPtr->components)
-    {
-        ComponentGenerator(componentPtr, buildParams);
-    }
+    ForEachInParallel(appPtr->components, buildParams,
+                      [&buildParams](model::Component_t* componentPtr)
+                      {
+                          ComponentGenerator(componentPtr, buildParams);
+                      });
 }
 
 /**
- * Adaptor to run a component generator on all components in an executable.
+ * Adaptor to run a component generator on all components in an executable, in parallel.
  */
 template<ComponentGenerator_t ComponentGenerator>
 void ForAllComponents
@@ -82,14 +155,23 @@ void ForAllComponents
     const mk::BuildParams_t& buildParams
 )
 {
+    // A component may be instantiated more than once, but must only be generated once.
+    std::set<model::Component_t*> components;
+
     for (auto componentInstancePtr : exePtr->componentInstances)
     {
-        ComponentGenerator(componentInstancePtr->componentPtr, buildParams);
+        components.insert(componentInstancePtr->componentPtr);
     }
+
+    ForEachInParallel(components, buildParams,
+                      [&buildParams](model::Component_t* componentPtr)
+                      {
+                          ComponentGenerator(componentPtr, buildParams);
+                      });
 }
 
 /**
- * Adaptor to run an app generator on all apps in a system.
+ * Adaptor to run an app generator on all apps in a system, in parallel.
  */
 template<AppGenerator_t AppGenerator>
 void ForAllApps
@@ -98,10 +180,11 @@ void ForAllApps
     const mk::BuildParams_t& buildParams
 )
 {
-    for (auto appMapEntry : systemPtr->apps)
-    {
-        AppGenerator(appMapEntry.second, buildParams);
-    }
+    ForEachInParallel(systemPtr->apps, buildParams,
+                      [&buildParams](const std::pair<const std::string, model::App_t*>& appMapEntry)
+                      {
+                          AppGenerator(appMapEntry.second, buildParams);
+                      });
 }
 
 }
@@ -16,6 +16,8 @@
 
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -29,6 +31,7 @@
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <typeindex>
 #include <unordered_set>
 #include <unordered_map>
@@ -44,6 +47,7 @@
 #include "file.h"
 #include "format.h"
 #include "md5.h"
+#include "profile.h"
 #include "parseTree/parseTree.h"
 #include "parser/parser.h"
 #include "conceptualModel/conceptualModel.h"
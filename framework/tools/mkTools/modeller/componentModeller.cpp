@@ -200,6 +200,58 @@ static void AddPythonPackage
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds the source files from a given "javascript:" section to a given Component_t object.
+ *
+ * Each script is compiled into a JerryScript snapshot at build time.  The snapshot, not the
+ * script, is bundled into the app's lib directory so the runtime never has to parse it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddJavaScript
+(
+    model::Component_t* componentPtr,
+    parseTree::CompoundItem_t* sectionPtr,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto tokenListPtr = static_cast<parseTree::TokenList_t*>(sectionPtr);
+
+    for (auto contentPtr: tokenListPtr->Contents())
+    {
+        auto filePath = FindSourceFile(componentPtr, contentPtr, buildParams);
+
+        if (filePath.empty())
+        {
+            continue;
+        }
+
+        if (!path::IsJavaScriptSource(filePath))
+        {
+            contentPtr->ThrowException(
+                mk::format(LE_I18N("Unrecognized file name extension on JavaScript file '%s'."),
+                           filePath)
+            );
+        }
+
+        auto snapshotName = path::RemoveSuffix(path::GetLastNode(filePath), ".js") + ".snapshot";
+        auto snapshotPath = path::Combine(componentPtr->workingDir, "js/") + snapshotName;
+
+        componentPtr->jsSnapshots.push_back(new model::ObjectFile_t(snapshotPath, filePath));
+
+        model::Permissions_t perms(1, 0, 0);
+
+        auto snapshotFile = new model::FileSystemObject_t("$builddir/" + snapshotPath,
+                                                          path::Combine("lib/", snapshotName),
+                                                          perms);
+
+        componentPtr->bundledFiles.insert(
+                std::shared_ptr<model::FileSystemObject_t>(snapshotFile));
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds the python files corresponding to all client APIs.
@@ -487,6 +539,7 @@ static void GetProvidedApi
     // Check for options.
     bool async = false;
     bool manualStart = false;
+    size_t threadCount = 0;
     for (auto contentPtr : contentList)
     {
         if (contentPtr->type == parseTree::Token_t::SERVER_IPC_OPTION)
@@ -499,6 +552,19 @@ static void GetProvidedApi
             {
                 manualStart = true;
             }
+            else if (contentPtr->text.compare(0, 9, "[threads=") == 0)
+            {
+                // The lexer has already checked that it is "[threads=<digits>]".
+                std::string numStr = contentPtr->text.substr(9, contentPtr->text.length() - 10);
+                threadCount = std::stoul(numStr.substr(0, 3));
+
+                if ((numStr.length() > 3) || (threadCount < 1) || (threadCount > 8))
+                {
+                    contentPtr->ThrowException(
+                        LE_I18N("Server thread count must be between 1 and 8.")
+                    );
+                }
+            }
         }
     }
 
@@ -517,6 +583,7 @@ static void GetProvidedApi
                                                  internalName,
                                                  async);
     ifPtr->manualStart = manualStart;
+    ifPtr->threadCount = threadCount;
 
     componentPtr->serverApis.push_back(ifPtr);
 
@@ -870,6 +937,17 @@ static void PrintSummary
         }
     }
 
+    if (!componentPtr->jsSnapshots.empty())
+    {
+        std::cout << LE_I18N("  JavaScript sources:") << std::endl;
+
+        for (auto snapshotPtr : componentPtr->jsSnapshots)
+        {
+            std::cout << mk::format(LE_I18N("    '%s'"), snapshotPtr->sourceFilePath)
+                      << std::endl;
+        }
+    }
+
     if (!componentPtr->subComponents.empty())
     {
         std::cout << LE_I18N("  Depends on components:") << std::endl;
@@ -994,6 +1072,12 @@ static void PrintSummary
                                      " suppressed.")
                           << std::endl;
             }
+            if (itemPtr->threadCount > 0)
+            {
+                std::cout << mk::format(LE_I18N("      Client requests handled by %zu threads."),
+                                        itemPtr->threadCount)
+                          << std::endl;
+            }
         }
     }
 }
@@ -1105,6 +1189,10 @@ model::Component_t* GetComponent
         {
             AddPythonPackage(componentPtr, sectionPtr, buildParams);
         }
+        else if (sectionName == "javascript")
+        {
+            AddJavaScript(componentPtr, sectionPtr, buildParams);
+        }
         else if (sectionName == "cflags")
         {
             AddCFlags(componentPtr, sectionPtr);
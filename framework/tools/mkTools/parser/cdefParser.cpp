@@ -240,6 +240,10 @@ static parseTree::CompoundItem_t* ParseSection
     {
         return ParseTokenListSection(lexer, sectionNameTokenPtr, parseTree::Token_t::FILE_PATH);
     }
+    else if (sectionName == "javascript")
+    {
+        return ParseTokenListSection(lexer, sectionNameTokenPtr, parseTree::Token_t::FILE_PATH);
+    }
     else if (sectionName == "bundles")
     {
         return ParseComplexSection(lexer, sectionNameTokenPtr, ParseBundlesSubsection);
@@ -11,6 +11,12 @@
 
 #include "mkTools.h"
 
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 
 namespace parser
 {
@@ -18,7 +24,8 @@ namespace parser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Constructor
+ * Constructor.  Maps the whole file into memory, so the lexer can look ahead and back up by just
+ * moving its position in the buffer.
  */
 //--------------------------------------------------------------------------------------------------
 Lexer_t::LexerContext_t::LexerContext_t
@@ -27,7 +34,9 @@ Lexer_t::LexerContext_t::LexerContext_t
 )
 //--------------------------------------------------------------------------------------------------
 :   filePtr(filePtr),
-    inputStream(filePtr->path),
+    buffer(NULL),
+    size(0),
+    pos(0),
     line(1),
     column(0),
     ifNestDepth(0)
@@ -40,41 +49,79 @@ Lexer_t::LexerContext_t::LexerContext_t
             mk::format(LE_I18N("File not found: '%s'."), filePtr->path)
         );
     }
-    if (!inputStream.is_open())
+
+    int fd = open(filePtr->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
     {
         throw mk::Exception_t(
             mk::format(LE_I18N("Failed to open file '%s' for reading."), filePtr->path)
         );
     }
 
-    // Read in the first characters.
-    Buffer(2);
-
-    if (inputStream.bad())
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
     {
+        close(fd);
         throw mk::Exception_t(
             mk::format(LE_I18N("Failed to read from file '%s'."), filePtr->path)
         );
     }
+
+    // An empty file can't be mapped, but there is nothing to read from it anyway.
+    if (fileStat.st_size > 0)
+    {
+        void* mappingPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mappingPtr == MAP_FAILED)
+        {
+            close(fd);
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to read from file '%s'."), filePtr->path)
+            );
+        }
+
+        buffer = static_cast<const char*>(mappingPtr);
+        size = fileStat.st_size;
+    }
+
+    close(fd);
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Ensure at least n elements are present in the lookahead character buffer
+ * Destructor
  */
 //--------------------------------------------------------------------------------------------------
-void Lexer_t::LexerContext_t::Buffer
+Lexer_t::LexerContext_t::~LexerContext_t
 (
-    size_t n
 )
+//--------------------------------------------------------------------------------------------------
 {
-    while (inputStream.good() && (nextChars.size() < n))
+    if (buffer != NULL)
     {
-        nextChars.push_back(inputStream.get());
+        munmap(const_cast<char*>(buffer), size);
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the characters that have not been consumed yet start with a given string.
+ */
+//--------------------------------------------------------------------------------------------------
+bool Lexer_t::LexerContext_t::IsNext
+(
+    const char* string
+)
+const
+//--------------------------------------------------------------------------------------------------
+{
+    size_t length = strlen(string);
+
+    return (((size - pos) >= length) && (memcmp(buffer + pos, string, length) == 0));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Constructor
@@ -85,7 +132,8 @@ Lexer_t::Lexer_t
     parseTree::DefFile_t* fileObjPtr
 )
 //--------------------------------------------------------------------------------------------------
-:   beVerbose(false)
+:   usedFileSystemPredicate(false),
+    beVerbose(false)
 //--------------------------------------------------------------------------------------------------
 {
     // Setup the lexer context for the top-level file
@@ -199,42 +247,42 @@ bool Lexer_t::IsMatch
     switch (type)
     {
         case parseTree::Token_t::END_OF_FILE:
-            return (context.top().nextChars[0] == EOF);
+            return (context.top().NextChar(0) == EOF);
 
         case parseTree::Token_t::OPEN_CURLY:
-            return (context.top().nextChars[0] == '{');
+            return (context.top().NextChar(0) == '{');
 
         case parseTree::Token_t::CLOSE_CURLY:
-            return (context.top().nextChars[0] == '}');
+            return (context.top().NextChar(0) == '}');
 
         case parseTree::Token_t::OPEN_PARENTHESIS:
-            return (context.top().nextChars[0] == '(');
+            return (context.top().NextChar(0) == '(');
 
         case parseTree::Token_t::CLOSE_PARENTHESIS:
-            return (context.top().nextChars[0] == ')');
+            return (context.top().NextChar(0) == ')');
 
         case parseTree::Token_t::COLON:
-            return (context.top().nextChars[0] == ':');
+            return (context.top().NextChar(0) == ':');
 
         case parseTree::Token_t::EQUALS:
-            return (context.top().nextChars[0] == '=');
+            return (context.top().NextChar(0) == '=');
 
         case parseTree::Token_t::DOT:
-            return (context.top().nextChars[0] == '.');
+            return (context.top().NextChar(0) == '.');
 
         case parseTree::Token_t::STAR:
-            return (context.top().nextChars[0] == '*');
+            return (context.top().NextChar(0) == '*');
 
         case parseTree::Token_t::ARROW:
-            return ((context.top().nextChars[0] == '-') && (context.top().nextChars[1] == '>'));
+            return ((context.top().NextChar(0) == '-') && (context.top().NextChar(1) == '>'));
 
         case parseTree::Token_t::WHITESPACE:
-            return IsWhitespace(context.top().nextChars[0]);
+            return IsWhitespace(context.top().NextChar(0));
 
         case parseTree::Token_t::COMMENT:
-            if (context.top().nextChars[0] == '/')
+            if (context.top().NextChar(0) == '/')
             {
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().NextChar(1);
                 return ((secondChar == '/') || (secondChar == '*'));
             }
             else
@@ -246,11 +294,11 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::SERVER_IPC_OPTION:
         case parseTree::Token_t::CLIENT_IPC_OPTION:
         case parseTree::Token_t::OPTIONAL_OPEN_SQUARE:
-            return (context.top().nextChars[0] == '[');
+            return (context.top().NextChar(0) == '[');
 
         case parseTree::Token_t::ARG:
             // Can be anything in a FILE_PATH, plus the equals sign (=).
-            if (context.top().nextChars[0] == '=')
+            if (context.top().NextChar(0) == '=')
             {
                 return true;
             }
@@ -259,22 +307,22 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::FILE_PATH:
             // Can be anything in a FILE_NAME, plus the forward slash (/).
             // If it starts with a slash, it could be a comment or a file path.
-            if (context.top().nextChars[0] == '/')
+            if (context.top().NextChar(0) == '/')
             {
                 // If it's not a comment, then it's a file path.
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().NextChar(1);
                 return ((secondChar != '/') && (secondChar != '*'));
             }
             // *** FALL THROUGH ***
 
         case parseTree::Token_t::FILE_NAME:
-            return (   IsFileNameChar(context.top().nextChars[0])
-                       || (context.top().nextChars[0] == '\'')   // Could be in single-quotes.
-                       || (context.top().nextChars[0] == '"') ); // Could be in quotes.
+            return (   IsFileNameChar(context.top().NextChar(0))
+                       || (context.top().NextChar(0) == '\'')   // Could be in single-quotes.
+                       || (context.top().NextChar(0) == '"') ); // Could be in quotes.
 
         case parseTree::Token_t::IPC_AGENT:
             // Can start with the same characters as a NAME or GROUP_NAME, plus '<'.
-            if (context.top().nextChars[0] == '<')
+            if (context.top().NextChar(0) == '<')
             {
                 return true;
             }
@@ -283,17 +331,17 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::NAME:
         case parseTree::Token_t::GROUP_NAME:
         case parseTree::Token_t::DOTTED_NAME:
-            return (   islower(context.top().nextChars[0])
-                       || isupper(context.top().nextChars[0])
-                       || (context.top().nextChars[0] == '_') );
+            return (   islower(context.top().NextChar(0))
+                       || isupper(context.top().NextChar(0))
+                       || (context.top().NextChar(0) == '_') );
 
         case parseTree::Token_t::INTEGER:
-            return (isdigit(context.top().nextChars[0]));
+            return (isdigit(context.top().NextChar(0)));
 
         case parseTree::Token_t::SIGNED_INTEGER:
-            return (   (context.top().nextChars[0] == '+')
-                       || (context.top().nextChars[0] == '-')
-                       || isdigit(context.top().nextChars[0]));
+            return (   (context.top().NextChar(0) == '+')
+                       || (context.top().NextChar(0) == '-')
+                       || isdigit(context.top().NextChar(0)));
 
         case parseTree::Token_t::BOOLEAN:
             return IsMatchBoolean();
@@ -305,10 +353,10 @@ bool Lexer_t::IsMatch
             throw mk::Exception_t(LE_I18N("Internal error: STRING lookahead not implemented."));
 
         case parseTree::Token_t::MD5_HASH:
-            return isxdigit(context.top().nextChars[0]);
+            return isxdigit(context.top().NextChar(0));
 
         case parseTree::Token_t::DIRECTIVE:
-            return context.top().nextChars[0] == '#';
+            return context.top().NextChar(0) == '#';
     }
 
     throw mk::Exception_t(LE_I18N("Internal error: IsMatch(): Invalid token type requested."));
@@ -340,7 +388,7 @@ void Lexer_t::SkipToNextDirective
 
     while (true)
     {
-        switch (context.top().nextChars[0])
+        switch (context.top().NextChar(0))
         {
             case '#':
                 // Found a directive
@@ -348,7 +396,7 @@ void Lexer_t::SkipToNextDirective
 
             case '/':
             {
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().NextChar(1);
                 if (secondChar == '/' ||
                     secondChar == '*')
                 {
@@ -368,7 +416,7 @@ void Lexer_t::SkipToNextDirective
             case '\'':
                 // Found a quoted string.  Pull the whole thing as it may contain embedded
                 // directives that should be ignored.
-                PullQuoted(phonyTokenPtr, context.top().nextChars[0]);
+                PullQuoted(phonyTokenPtr, context.top().NextChar(0));
                 break;
 
             default:
@@ -396,11 +444,11 @@ parseTree::Token_t* Lexer_t::PullRaw
     {
         case parseTree::Token_t::END_OF_FILE:
 
-            if (context.top().nextChars[0] != EOF)
+            if (context.top().NextChar(0) != EOF)
             {
                 ThrowException(
                     mk::format(LE_I18N("Expected end-of-file, but found '%c'."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().NextChar(0))
                 );
             }
             break;
@@ -704,10 +752,8 @@ void Lexer_t::ResetTo(parseTree::Token_t* resetTokenPtr)
                                                   "across file boundary"));
         }
 
-        // Re-add the text to the buffer
-        context.top().nextChars.insert(context.top().nextChars.begin(),
-                                       lastTokenPtr->text.begin(),
-                                       lastTokenPtr->text.end());
+        // Step back over the token's text in the buffer
+        context.top().pos -= lastTokenPtr->text.size();
 
         // Reset column & line numbers
         context.top().line = lastTokenPtr->line;
@@ -1123,6 +1169,7 @@ bool Lexer_t::PullAndEvalBoolExpression
                 auto curDir = path::GetContainingDir(context.top().filePtr->path);
 
                 result = (file::FindFile(fileName, { curDir }) != "");
+                usedFileSystemPredicate = true;
 
                 MarkVarsUsed(substitutedVars, fileNamePtr);
             }
@@ -1136,6 +1183,7 @@ bool Lexer_t::PullAndEvalBoolExpression
                 auto curDir = path::GetContainingDir(context.top().filePtr->path);
 
                 result = (file::FindDirectory(fileName, { curDir }) != "");
+                usedFileSystemPredicate = true;
 
                 MarkVarsUsed(substitutedVars, fileNamePtr);
             }
@@ -1197,21 +1245,10 @@ bool Lexer_t::IsMatchBoolean
 )
 //--------------------------------------------------------------------------------------------------
 {
-    static const char true_string[] = "true",
-        false_string[] = "false",
-        on_string[] = "on",
-        off_string[] = "off";
-
-    // Need at most 5 characters (for false)
-    context.top().Buffer(5);
-    return std::equal(true_string, true_string + sizeof(true_string) - 1,
-                      context.top().nextChars.begin()) ||
-        std::equal(false_string, false_string + sizeof(false_string) - 1,
-                   context.top().nextChars.begin()) ||
-        std::equal(on_string, on_string + sizeof(on_string) - 1,
-                   context.top().nextChars.begin()) ||
-        std::equal(off_string, off_string + sizeof(off_string) - 1,
-                   context.top().nextChars.begin());
+    return (   context.top().IsNext("true")
+            || context.top().IsNext("false")
+            || context.top().IsNext("on")
+            || context.top().IsNext("off") );
 }
 
 
@@ -1233,7 +1270,7 @@ void Lexer_t::PullConstString
 
     while (*charPtr != '\0')
     {
-        if (context.top().nextChars[0] != *charPtr)
+        if (context.top().NextChar(0) != *charPtr)
         {
             UnexpectedChar(mk::format(LE_I18N("Unexpected character %%s. Expected '%s'"),
                                       tokenString));
@@ -1260,7 +1297,7 @@ void Lexer_t::PullWhitespace
     size_t start_line = context.top().line,
         start_column = context.top().column;
 
-    while (IsWhitespace(context.top().nextChars[0]))
+    while (IsWhitespace(context.top().NextChar(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1285,7 +1322,7 @@ void Lexer_t::PullComment
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '/')
+    if (context.top().NextChar(0) != '/')
     {
         ThrowException(LE_I18N("Expected '/' at start of comment."));
     }
@@ -1294,33 +1331,33 @@ void Lexer_t::PullComment
     AdvanceOneCharacter(tokenPtr);
 
     // Figure out which kind of comment it is.
-    if (context.top().nextChars[0] == '/')
+    if (context.top().NextChar(0) == '/')
     {
         // C++ style comment, terminated by either new-line or end-of-file.
         AdvanceOneCharacter(tokenPtr);
-        while ((context.top().nextChars[0] != '\n') && (context.top().nextChars[0] != EOF))
+        while ((context.top().NextChar(0) != '\n') && (context.top().NextChar(0) != EOF))
         {
             AdvanceOneCharacter(tokenPtr);
         }
     }
-    else if (context.top().nextChars[0] == '*')
+    else if (context.top().NextChar(0) == '*')
     {
         // C style comment, terminated by "*/" digraph.
         AdvanceOneCharacter(tokenPtr);
         for (;;)
         {
-            if (context.top().nextChars[0] == '*')
+            if (context.top().NextChar(0) == '*')
             {
                 AdvanceOneCharacter(tokenPtr);
 
-                if (context.top().nextChars[0] == '/')
+                if (context.top().NextChar(0) == '/')
                 {
                     AdvanceOneCharacter(tokenPtr);
 
                     break;
                 }
             }
-            else if (context.top().nextChars[0] == EOF)
+            else if (context.top().NextChar(0) == EOF)
             {
                 ThrowException(
                     mk::format(LE_I18N("Unexpected end-of-file before end of comment.\n"
@@ -1351,17 +1388,17 @@ void Lexer_t::PullInteger
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (!isdigit(context.top().nextChars[0]))
+    if (!isdigit(context.top().NextChar(0)))
     {
         UnexpectedChar(LE_I18N("Unexpected character %s at beginning of integer."));
     }
 
-    while (isdigit(context.top().nextChars[0]))
+    while (isdigit(context.top().NextChar(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
 
-    if (context.top().nextChars[0] == 'K')
+    if (context.top().NextChar(0) == 'K')
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1379,8 +1416,8 @@ void Lexer_t::PullSignedInteger
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (context.top().nextChars[0] == '-')
-           || (context.top().nextChars[0] == '+'))
+    if (   (context.top().NextChar(0) == '-')
+           || (context.top().NextChar(0) == '+'))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1400,27 +1437,27 @@ void Lexer_t::PullBoolean
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == 't')
+    if (context.top().NextChar(0) == 't')
     {
         PullConstString(tokenPtr, "true");
     }
-    else if (context.top().nextChars[0] == 'f')
+    else if (context.top().NextChar(0) == 'f')
     {
         PullConstString(tokenPtr, "false");
     }
-    else if (context.top().nextChars[0] == 'o')
+    else if (context.top().NextChar(0) == 'o')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        if (context.top().nextChars[0] == 'n')
+        if (context.top().NextChar(0) == 'n')
         {
             AdvanceOneCharacter(tokenPtr);
         }
-        else if (context.top().nextChars[0] == 'f')
+        else if (context.top().NextChar(0) == 'f')
         {
             AdvanceOneCharacter(tokenPtr);
 
-            if (context.top().nextChars[0] != 'f')
+            if (context.top().NextChar(0) != 'f')
             {
                 ThrowException(LE_I18N("Unexpected boolean value.  Only 'true', 'false', "
                                        "'on', or 'off' allowed."));
@@ -1448,38 +1485,38 @@ void Lexer_t::PullFloat
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (isdigit(context.top().nextChars[0]) == false)
-           && (context.top().nextChars[0] != '+')
-           && (context.top().nextChars[0] != '-'))
+    if (   (isdigit(context.top().NextChar(0)) == false)
+           && (context.top().NextChar(0) != '+')
+           && (context.top().NextChar(0) != '-'))
     {
         UnexpectedChar(LE_I18N("Unexpected character %s at beginning of floating point value."));
     }
 
     AdvanceOneCharacter(tokenPtr);
 
-    while (isdigit(context.top().nextChars[0]))
+    while (isdigit(context.top().NextChar(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
 
-    if (context.top().nextChars[0] == '.')
+    if (context.top().NextChar(0) == '.')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (isdigit(context.top().nextChars[0]))
+        while (isdigit(context.top().NextChar(0)))
         {
             AdvanceOneCharacter(tokenPtr);
         }
     }
 
-    if (   (context.top().nextChars[0] == 'e')
-           || (context.top().nextChars[0] == 'E'))
+    if (   (context.top().NextChar(0) == 'e')
+           || (context.top().NextChar(0) == 'E'))
     {
         AdvanceOneCharacter(tokenPtr);
 
-        if (   (isdigit(context.top().nextChars[0]) == false)
-               && (context.top().nextChars[0] != '+')
-               && (context.top().nextChars[0] != '-'))
+        if (   (isdigit(context.top().NextChar(0)) == false)
+               && (context.top().NextChar(0) != '+')
+               && (context.top().NextChar(0) != '-'))
         {
             UnexpectedChar(LE_I18N("Unexpected character %s in exponent part of"
                                    " floating point value."));
@@ -1487,7 +1524,7 @@ void Lexer_t::PullFloat
 
         AdvanceOneCharacter(tokenPtr);
 
-        while (isdigit(context.top().nextChars[0]))
+        while (isdigit(context.top().NextChar(0)))
         {
             AdvanceOneCharacter(tokenPtr);
         }
@@ -1506,10 +1543,10 @@ void Lexer_t::PullString
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (context.top().nextChars[0] == '"')
-           || (context.top().nextChars[0] == '\''))
+    if (   (context.top().NextChar(0) == '"')
+           || (context.top().NextChar(0) == '\''))
     {
-        PullQuoted(tokenPtr, context.top().nextChars[0]);
+        PullQuoted(tokenPtr, context.top().NextChar(0));
     }
     else
     {
@@ -1529,7 +1566,7 @@ void Lexer_t::PullFilePermissions
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '[')
+    if (context.top().NextChar(0) != '[')
     {
         ThrowException(LE_I18N("Expected '[' at start of file permissions."));
     }
@@ -1538,7 +1575,7 @@ void Lexer_t::PullFilePermissions
     AdvanceOneCharacter(tokenPtr);
 
     // Must be something between the square brackets.
-    if (context.top().nextChars[0] == ']')
+    if (context.top().NextChar(0) == ']')
     {
         ThrowException(LE_I18N("Empty file permissions."));
     }
@@ -1547,24 +1584,58 @@ void Lexer_t::PullFilePermissions
     do
     {
         // Check for end-of-file or illegal character in file permissions.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().NextChar(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of file permissions."));
         }
-        else if ((context.top().nextChars[0] != 'r') && (context.top().nextChars[0] != 'w') && (context.top().nextChars[0] != 'x'))
+        else if ((context.top().NextChar(0) != 'r') && (context.top().NextChar(0) != 'w') && (context.top().NextChar(0) != 'x'))
         {
             UnexpectedChar(LE_I18N("Unexpected character %s inside file permissions."));
         }
 
         AdvanceOneCharacter(tokenPtr);
 
-    } while (context.top().nextChars[0] != ']');
+    } while (context.top().NextChar(0) != ']');
 
     // Eat the trailing ']'.
     AdvanceOneCharacter(tokenPtr);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an IPC option is a thread pool option (e.g., "[threads=4]").
+ *
+ * @return true if the option is "[threads=" followed by a decimal number and "]".
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsThreadsIpcOption
+(
+    const std::string& option
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const std::string prefix = "[threads=";
+
+    if (   (option.compare(0, prefix.length(), prefix) != 0)
+        || (option.length() < prefix.length() + 2)
+        || (option.back() != ']') )
+    {
+        return false;
+    }
+
+    for (size_t i = prefix.length(); i < option.length() - 1; i++)
+    {
+        if (!isdigit(option[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pull a server-side IPC option (e.g., "[manual-start]") from the file and store it in the token.
@@ -1580,7 +1651,8 @@ void Lexer_t::PullServerIpcOption
 
     // Check that it's one of the valid server-side options.
     if (   (tokenPtr->text != "[manual-start]")
-           && (tokenPtr->text != "[async]") )
+           && (tokenPtr->text != "[async]")
+           && !IsThreadsIpcOption(tokenPtr->text) )
     {
         ThrowException(
             mk::format(LE_I18N("Invalid server-side IPC option: '%s'"), tokenPtr->text)
@@ -1625,7 +1697,7 @@ void Lexer_t::PullIpcOption
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '[')
+    if (context.top().NextChar(0) != '[')
     {
         ThrowException(LE_I18N("Expected '[' at start of IPC option."));
     }
@@ -1634,7 +1706,7 @@ void Lexer_t::PullIpcOption
     AdvanceOneCharacter(tokenPtr);
 
     // Must be something between the square brackets.
-    if (context.top().nextChars[0] == ']')
+    if (context.top().NextChar(0) == ']')
     {
         ThrowException(LE_I18N("Empty IPC option."));
     }
@@ -1643,18 +1715,21 @@ void Lexer_t::PullIpcOption
     do
     {
         // Check for end-of-file or illegal character in option.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().NextChar(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of IPC option."));
         }
-        else if ((context.top().nextChars[0] != '-') && !islower(context.top().nextChars[0]))
+        else if (   (context.top().NextChar(0) != '-')
+                 && (context.top().NextChar(0) != '=')
+                 && !islower(context.top().NextChar(0))
+                 && !isdigit(context.top().NextChar(0)) )
         {
             UnexpectedChar(LE_I18N("Unexpected character %s inside option."));
         }
 
         AdvanceOneCharacter(tokenPtr);
 
-    } while (context.top().nextChars[0] != ']');
+    } while (context.top().NextChar(0) != ']');
 
     // Eat the trailing ']'.
     AdvanceOneCharacter(tokenPtr);
@@ -1674,11 +1749,11 @@ void Lexer_t::PullArg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().NextChar(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().NextChar(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1687,18 +1762,18 @@ void Lexer_t::PullArg
         size_t start_line = context.top().line;
         size_t start_column = context.top().column;
 
-        while (IsArgChar(context.top().nextChars[0]))
+        while (IsArgChar(context.top().NextChar(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().NextChar(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
             else
             {
-                if (context.top().nextChars[0] == '/')
+                if (context.top().NextChar(0) == '/')
                 {
                     // Check for comment start.
-                    int secondChar = context.top().nextChars[1];
+                    int secondChar = context.top().NextChar(1);
                     if ((secondChar == '/') || (secondChar == '*'))
                     {
                         break;
@@ -1714,11 +1789,11 @@ void Lexer_t::PullArg
         if ((start_line == context.top().line) &&
             (start_column == context.top().column))
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().NextChar(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in argument."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().NextChar(0))
                 );
             }
             else
@@ -1743,11 +1818,11 @@ void Lexer_t::PullFilePath
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().NextChar(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().NextChar(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1756,18 +1831,18 @@ void Lexer_t::PullFilePath
         size_t start_line = context.top().line,
             start_column = context.top().column;
 
-        while (IsFilePathChar(context.top().nextChars[0]))
+        while (IsFilePathChar(context.top().NextChar(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().NextChar(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
             else
             {
-                if (context.top().nextChars[0] == '/')
+                if (context.top().NextChar(0) == '/')
                 {
                     // Check for comment start.
-                    int secondChar = context.top().nextChars[1];
+                    int secondChar = context.top().NextChar(1);
                     if ((secondChar == '/') || (secondChar == '*'))
                     {
                         break;
@@ -1783,11 +1858,11 @@ void Lexer_t::PullFilePath
         if (start_line == context.top().line &&
             start_column == context.top().column)
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().NextChar(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in file path."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().NextChar(0))
                 );
             }
             else
@@ -1812,11 +1887,11 @@ void Lexer_t::PullFileName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().NextChar(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().NextChar(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1825,9 +1900,9 @@ void Lexer_t::PullFileName
         size_t start_line = context.top().line,
             start_column = context.top().column;
 
-        while (IsFileNameChar(context.top().nextChars[0]))
+        while (IsFileNameChar(context.top().NextChar(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().NextChar(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
@@ -1842,11 +1917,11 @@ void Lexer_t::PullFileName
         if ((start_line == context.top().line) &&
             (start_column == context.top().column))
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().NextChar(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in name."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().NextChar(0))
                 );
             }
             else
@@ -1869,9 +1944,9 @@ void Lexer_t::PullName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().NextChar(0))
+           || isupper(context.top().NextChar(0))
+           || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1882,10 +1957,10 @@ void Lexer_t::PullName
                                " or an underscore ('_')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_') )
+    while (   islower(context.top().NextChar(0))
+              || isupper(context.top().NextChar(0))
+              || isdigit(context.top().NextChar(0))
+              || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1907,14 +1982,14 @@ void Lexer_t::PullDottedName
     {
         PullName(tokenPtr);
 
-        if (context.top().nextChars[0] == '.')
+        if (context.top().NextChar(0) == '.')
         {
             AdvanceOneCharacter(tokenPtr);
         }
     }
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_'));
+    while (   islower(context.top().NextChar(0))
+              || isupper(context.top().NextChar(0))
+              || (context.top().NextChar(0) == '_'));
 }
 
 
@@ -1929,9 +2004,9 @@ void Lexer_t::PullGroupName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().NextChar(0))
+           || isupper(context.top().NextChar(0))
+           || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1942,11 +2017,11 @@ void Lexer_t::PullGroupName
                                "('a'-'z' or 'A'-'Z') or an underscore ('_')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_')
-              || (context.top().nextChars[0] == '-') )
+    while (   islower(context.top().NextChar(0))
+              || isupper(context.top().NextChar(0))
+              || isdigit(context.top().NextChar(0))
+              || (context.top().NextChar(0) == '_')
+              || (context.top().NextChar(0) == '-') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1964,23 +2039,23 @@ void Lexer_t::PullIpcAgentName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    auto firstChar = context.top().nextChars[0];
+    auto firstChar = context.top().NextChar(0);
 
     // User names are enclosed in angle brackets (e.g., "<username>").
     if (firstChar == '<')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (   islower(context.top().nextChars[0])
-                  || isupper(context.top().nextChars[0])
-                  || isdigit(context.top().nextChars[0])
-                  || (context.top().nextChars[0] == '_')
-                  || (context.top().nextChars[0] == '-') )
+        while (   islower(context.top().NextChar(0))
+                  || isupper(context.top().NextChar(0))
+                  || isdigit(context.top().NextChar(0))
+                  || (context.top().NextChar(0) == '_')
+                  || (context.top().NextChar(0) == '-') )
         {
             AdvanceOneCharacter(tokenPtr);
         }
 
-        if (context.top().nextChars[0] != '>')
+        if (context.top().NextChar(0) != '>')
         {
             UnexpectedChar(LE_I18N("Unexpected character %s in user name.  "
                                    "Must be terminated with '>'."));
@@ -1991,16 +2066,16 @@ void Lexer_t::PullIpcAgentName
         }
     }
     // App names have the same rules as C programming language identifiers.
-    else if (   islower(context.top().nextChars[0])
-                || isupper(context.top().nextChars[0])
-                || (context.top().nextChars[0] == '_') )
+    else if (   islower(context.top().NextChar(0))
+                || isupper(context.top().NextChar(0))
+                || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (   islower(context.top().nextChars[0])
-                  || isupper(context.top().nextChars[0])
-                  || isdigit(context.top().nextChars[0])
-                  || (context.top().nextChars[0] == '_') )
+        while (   islower(context.top().NextChar(0))
+                  || isupper(context.top().NextChar(0))
+                  || isdigit(context.top().NextChar(0))
+                  || (context.top().NextChar(0) == '_') )
         {
             AdvanceOneCharacter(tokenPtr);
         }
@@ -2032,14 +2107,14 @@ void Lexer_t::PullQuoted
     // Eat the leading quote.
     AdvanceOneCharacter(tokenPtr);
 
-    while (context.top().nextChars[0] != quoteChar)
+    while (context.top().NextChar(0) != quoteChar)
     {
         // Don't allow end of file or end of line characters inside the quoted string.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().NextChar(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of quoted string."));
         }
-        if ((context.top().nextChars[0] == '\n') || (context.top().nextChars[0] == '\r'))
+        if ((context.top().NextChar(0) == '\n') || (context.top().NextChar(0) == '\r'))
         {
             ThrowException(LE_I18N("Unexpected end-of-line before end of quoted string."));
         }
@@ -2071,16 +2146,16 @@ void Lexer_t::PullEnvVar
 
     // If the next character is a curly brace, remember that we need to look for the closing curly.
     bool hasCurlies = false;    // true if ${ENV_VAR} style.  false if $ENV_VAR style.
-    if (context.top().nextChars[0] == '{')
+    if (context.top().NextChar(0) == '{')
     {
         AdvanceOneCharacter(tokenPtr->text);
         hasCurlies = true;
     }
 
     // Pull the first character of the environment variable name.
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().NextChar(0))
+           || isupper(context.top().NextChar(0))
+           || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr->text);
     }
@@ -2093,10 +2168,10 @@ void Lexer_t::PullEnvVar
     }
 
     // Pull the rest of the environment variable name.
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_') )
+    while (   islower(context.top().NextChar(0))
+              || isupper(context.top().NextChar(0))
+              || isdigit(context.top().NextChar(0))
+              || (context.top().NextChar(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr->text);
     }
@@ -2104,18 +2179,18 @@ void Lexer_t::PullEnvVar
     // If there was an opening curly brace, match the closing one now.
     if (hasCurlies)
     {
-        if (context.top().nextChars[0] == '}')
+        if (context.top().NextChar(0) == '}')
         {
             AdvanceOneCharacter(tokenPtr->text);
         }
-        else if (context.top().nextChars[0] == EOF)
+        else if (context.top().NextChar(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file inside environment variable name."));
         }
         else
         {
             ThrowException(
-                mk::format(LE_I18N("'}' expected.  '%c' found."), (char)context.top().nextChars[0])
+                mk::format(LE_I18N("'}' expected.  '%c' found."), (char)context.top().NextChar(0))
             );
         }
     }
@@ -2136,15 +2211,15 @@ void Lexer_t::PullMd5
     // There are always exactly 32 hexadecimal digits in an md5 sum.
     for (int i = 0; i < 32; i++)
     {
-        if (   (!isdigit(context.top().nextChars[0]))
-               && (context.top().nextChars[0] != 'a')
-               && (context.top().nextChars[0] != 'b')
-               && (context.top().nextChars[0] != 'c')
-               && (context.top().nextChars[0] != 'd')
-               && (context.top().nextChars[0] != 'e')
-               && (context.top().nextChars[0] != 'f')  )
+        if (   (!isdigit(context.top().NextChar(0)))
+               && (context.top().NextChar(0) != 'a')
+               && (context.top().NextChar(0) != 'b')
+               && (context.top().NextChar(0) != 'c')
+               && (context.top().NextChar(0) != 'd')
+               && (context.top().NextChar(0) != 'e')
+               && (context.top().NextChar(0) != 'f')  )
         {
-            if (IsWhitespace(context.top().nextChars[0]))
+            if (IsWhitespace(context.top().NextChar(0)))
             {
                 ThrowException(LE_I18N("MD5 hash too short."));
             }
@@ -2156,13 +2231,13 @@ void Lexer_t::PullMd5
     }
 
     // Make sure it isn't too long.
-    if (   isdigit(context.top().nextChars[0])
-           || (context.top().nextChars[0] == 'a')
-           || (context.top().nextChars[0] == 'b')
-           || (context.top().nextChars[0] == 'c')
-           || (context.top().nextChars[0] == 'd')
-           || (context.top().nextChars[0] == 'e')
-           || (context.top().nextChars[0] == 'f')  )
+    if (   isdigit(context.top().NextChar(0))
+           || (context.top().NextChar(0) == 'a')
+           || (context.top().NextChar(0) == 'b')
+           || (context.top().NextChar(0) == 'c')
+           || (context.top().NextChar(0) == 'd')
+           || (context.top().NextChar(0) == 'e')
+           || (context.top().NextChar(0) == 'f')  )
     {
         ThrowException(LE_I18N("MD5 hash too long."));
     }
@@ -2181,7 +2256,7 @@ void Lexer_t::PullDirective
 //--------------------------------------------------------------------------------------------------
 {
     // advance past the '#'
-    if (context.top().nextChars[0] == '#')
+    if (context.top().NextChar(0) == '#')
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2191,8 +2266,8 @@ void Lexer_t::PullDirective
                                "Must start with '#' character."));
     }
 
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0]))
+    if (   islower(context.top().NextChar(0))
+           || isupper(context.top().NextChar(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2202,8 +2277,8 @@ void Lexer_t::PullDirective
                                "Must start with a letter ('a'-'z' or 'A'-'Z')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0]))
+    while (   islower(context.top().NextChar(0))
+              || isupper(context.top().NextChar(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2440,6 +2515,25 @@ parseTree::Token_t *Lexer_t::FindVarUse
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the names of all the environment or build variables used by the lexer in processing
+ * directives.
+ */
+//--------------------------------------------------------------------------------------------------
+void Lexer_t::GetUsedVarNames
+(
+    std::set<std::string>& names   ///< [OUT] Set to add the names to.
+) const
+//--------------------------------------------------------------------------------------------------
+{
+    for (const auto& varUse : usedVars)
+    {
+        names.insert(varUse.first);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Advance the current file position by one character, appending the character into a given string
@@ -2454,9 +2548,9 @@ void Lexer_t::AdvanceOneCharacter
 )
 //--------------------------------------------------------------------------------------------------
 {
-    string += context.top().nextChars[0];
+    string += context.top().NextChar(0);
 
-    if (context.top().nextChars[0] == '\n')
+    if (context.top().NextChar(0) == '\n')
     {
         context.top().line++;
         context.top().column = 0;
@@ -2466,13 +2560,7 @@ void Lexer_t::AdvanceOneCharacter
         context.top().column++;
     }
 
-    context.top().nextChars.pop_front();
-    context.top().Buffer(2);
-
-    if (context.top().inputStream.bad())
-    {
-        ThrowException(LE_I18N("Failed to fetch next character from file."));
-    }
+    context.top().pos++;
 }
 
 
@@ -2513,7 +2601,7 @@ void Lexer_t::UnexpectedChar
 )
 //--------------------------------------------------------------------------------------------------
 {
-    throw mk::Exception_t(UnexpectedCharErrorMsg(context.top().nextChars[0],
+    throw mk::Exception_t(UnexpectedCharErrorMsg(context.top().NextChar(0),
                                                  context.top().line,
                                                  context.top().column,
                                                  message));
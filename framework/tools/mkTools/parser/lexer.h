@@ -45,6 +45,12 @@ class Lexer_t
         // Find if a build variable has been used by the lexer in a processing directive
         parseTree::Token_t *FindVarUse(const std::string &name);
 
+        // Get the names of all the variables used by the lexer in processing directives.
+        void GetUsedVarNames(std::set<std::string>& names) const;
+
+        // true = a processing directive depended on whether some file or directory exists.
+        bool usedFileSystemPredicate;
+
         // true = print progress messages to the standard output stream.
         bool beVerbose;
 
@@ -58,16 +64,26 @@ class Lexer_t
         {
             parseTree::DefFileFragment_t* filePtr;  ///< Pointer to the File object for the file being parsed.
 
-            std::ifstream inputStream;      ///< File input stream from which tokens will be matched.
-            std::deque<int> nextChars;      ///< File buffer for characters read from the input
-                                            ///< stream but not yet consumed.
+            const char* buffer;             ///< Contents of the file, mapped into memory.
+            size_t size;                    ///< Size of the file, in bytes.
+            size_t pos;                     ///< Offset in the buffer of the next character that
+                                            ///< has not been consumed yet.
             size_t line;                    ///< File line number.
             size_t column;                  ///< Char index on line (treat tab & return same as space).
             size_t ifNestDepth;             ///< Current number of nested #if directives.
 
             LexerContext_t(parseTree::DefFileFragment_t *filePtr);
+            LexerContext_t(const LexerContext_t&) = delete;
+            ~LexerContext_t();
+
+            /// Look ahead at the n'th character after the ones already consumed (0 = the next
+            /// one).  Returns EOF past the end of the file.
+            int NextChar(size_t n) const
+            {
+                return ((pos + n) < size) ? static_cast<unsigned char>(buffer[pos + n]) : EOF;
+            }
 
-            void Buffer(size_t n);
+            bool IsNext(const char* string) const;
         };
 
         std::stack<LexerContext_t> context;
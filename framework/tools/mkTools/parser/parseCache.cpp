@@ -0,0 +1,807 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseCache.cpp  Implementation of the persistent cache of parsed definition files.
+ *
+ * A cache file contains, in order (integers are 32-bit, in host byte order, and strings are a
+ * length followed by the bytes):
+ *
+ *  - a magic string and the format version,
+ *  - the size and modification time of the mk tools executable that wrote it,
+ *  - the type and path of the definition file,
+ *  - the path and content MD5 of the file and of every file it includes (file fragments),
+ *  - the name and value of every variable used by processing directives,
+ *  - the tokens referenced by the parse tree (fragment index, type, line, column and text),
+ *  - the parse tree itself: for each item, its content type, first and last token indices, and
+ *    either its token indices or, recursively, its sub-items.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace parser
+{
+
+namespace cache
+{
+
+
+/// Identifies a parse cache file.  Bump the format version when the layout changes.
+static const std::string Magic = "mkParseCache";
+static const uint32_t FormatVersion = 1;
+
+/// Directory the cache files are kept in ("" = cache disabled).
+static std::string CacheDir;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An item of a parse tree, as read from a cache file, before the parse tree objects are created.
+ */
+//--------------------------------------------------------------------------------------------------
+struct CachedItem_t
+{
+    parseTree::Content_t::Type_t type;
+    uint32_t firstToken;
+    uint32_t lastToken;
+    std::vector<uint32_t> tokens;       ///< Token indices, if the item is a token list.
+    std::vector<CachedItem_t> items;    ///< Sub-items, if the item is a compound item list.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A token, as read from a cache file.
+ */
+//--------------------------------------------------------------------------------------------------
+struct CachedToken_t
+{
+    uint32_t fragment;
+    parseTree::Token_t::Type_t type;
+    uint32_t line;
+    uint32_t column;
+    std::string text;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a content type is a compound item list (as opposed to a token list).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsCompoundItemList
+(
+    parseTree::Content_t::Type_t type
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (   (type == parseTree::Content_t::COMPLEX_SECTION)
+            || (type == parseTree::Content_t::APP)
+            || (type == parseTree::Content_t::MODULE));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a stamp identifying the running mk tools executable, so that parse trees produced by a
+ * different version of the parsers are never used.
+ *
+ * @return The stamp, or "" if it can't be determined.
+ */
+//--------------------------------------------------------------------------------------------------
+static const std::string& GetToolStamp
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static std::string stamp;
+    static bool isDone = false;
+
+    if (!isDone)
+    {
+        struct stat st;
+
+        if (stat("/proc/self/exe", &st) == 0)
+        {
+            stamp = std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime) + "."
+                  + std::to_string(st.st_mtim.tv_nsec);
+        }
+
+        isDone = true;
+    }
+
+    return stamp;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the whole content of a file.
+ *
+ * @return true if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadFile
+(
+    const std::string& filePath,
+    std::string& content
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream inputStream(filePath, std::ios::binary);
+
+    if (!inputStream.is_open())
+    {
+        return false;
+    }
+
+    std::ostringstream buffer;
+    buffer << inputStream.rdbuf();
+
+    if (inputStream.bad())
+    {
+        return false;
+    }
+
+    content = buffer.str();
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's content.
+ *
+ * @return The hash, or "" if the file can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string FileMd5
+(
+    const std::string& filePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string content;
+
+    if (!ReadFile(filePath, content))
+    {
+        return "";
+    }
+
+    return md5(content);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the cache file for a given definition file.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string CacheFilePath
+(
+    const parseTree::DefFile_t* defFilePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return path::Combine(CacheDir, defFilePtr->pathMd5);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequential reader over the content of a cache file.  All reads fail once the end of the data
+ * is reached.
+ */
+//--------------------------------------------------------------------------------------------------
+class Reader_t
+{
+    public:
+
+        Reader_t(const std::string& d): data(d), pos(0) {}
+
+        bool Get(uint32_t& value)
+        {
+            if (data.size() - pos < sizeof(value))
+            {
+                return false;
+            }
+            memcpy(&value, data.data() + pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool Get(std::string& value)
+        {
+            uint32_t len;
+
+            if (!Get(len) || (data.size() - pos < len))
+            {
+                return false;
+            }
+            value.assign(data, pos, len);
+            pos += len;
+            return true;
+        }
+
+        bool AtEnd() const { return pos == data.size(); }
+
+    private:
+
+        const std::string& data;
+        size_t pos;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequential writer of the content of a cache file.
+ */
+//--------------------------------------------------------------------------------------------------
+class Writer_t
+{
+    public:
+
+        void Put(uint32_t value)
+        {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void Put(const std::string& value)
+        {
+            Put(static_cast<uint32_t>(value.size()));
+            data.append(value);
+        }
+
+        const std::string& Data() const { return data; }
+
+    private:
+
+        std::string data;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a parse tree item, and all its sub-items, from a cache file.
+ *
+ * @return true if successful, false if the data is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadItem
+(
+    Reader_t& reader,
+    size_t tokenCount,  ///< Number of tokens in the file, to validate token indices.
+    CachedItem_t& item
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t type;
+    uint32_t count;
+
+    if (   !reader.Get(type)
+        || !reader.Get(item.firstToken)
+        || !reader.Get(item.lastToken)
+        || !reader.Get(count)
+        || (type == parseTree::Content_t::TOKEN)
+        || (type > parseTree::Content_t::MODULE)
+        || (item.firstToken >= tokenCount)
+        || (item.lastToken >= tokenCount))
+    {
+        return false;
+    }
+
+    item.type = static_cast<parseTree::Content_t::Type_t>(type);
+
+    if (IsCompoundItemList(item.type))
+    {
+        item.items.resize(count);
+
+        for (auto& subItem : item.items)
+        {
+            if (!ReadItem(reader, tokenCount, subItem))
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        item.tokens.resize(count);
+
+        for (auto& tokenIndex : item.tokens)
+        {
+            if (!reader.Get(tokenIndex) || (tokenIndex >= tokenCount))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the parse tree object for an item read from a cache file.
+ *
+ * @return Pointer to the new object.
+ */
+//--------------------------------------------------------------------------------------------------
+static parseTree::CompoundItem_t* BuildItem
+(
+    const CachedItem_t& item,
+    const std::vector<parseTree::Token_t*>& tokens
+)
+//--------------------------------------------------------------------------------------------------
+{
+    parseTree::CompoundItem_t* itemPtr;
+    auto firstTokenPtr = tokens[item.firstToken];
+
+    if (IsCompoundItemList(item.type))
+    {
+        parseTree::CompoundItemList_t* listPtr;
+
+        switch (item.type)
+        {
+            case parseTree::Content_t::APP:
+                listPtr = new parseTree::App_t(firstTokenPtr);
+                break;
+
+            case parseTree::Content_t::MODULE:
+                listPtr = new parseTree::Module_t(firstTokenPtr);
+                break;
+
+            default:
+                listPtr = new parseTree::ComplexSection_t(firstTokenPtr);
+                break;
+        }
+
+        for (const auto& subItem : item.items)
+        {
+            listPtr->AddContent(BuildItem(subItem, tokens));
+        }
+
+        itemPtr = listPtr;
+    }
+    else
+    {
+        auto listPtr = parseTree::CreateTokenList(item.type, firstTokenPtr);
+
+        // Some token lists add their first token to their content on construction.
+        for (size_t i = listPtr->Contents().size(); i < item.tokens.size(); i++)
+        {
+            listPtr->AddContent(tokens[item.tokens[i]]);
+        }
+
+        itemPtr = listPtr;
+    }
+
+    itemPtr->lastTokenPtr = tokens[item.lastToken];
+
+    return itemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the directory in which parse trees are cached.  An empty path disables the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void SetDir
+(
+    const std::string& dirPath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    CacheDir = dirPath;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Populates a definition file object from the cache, if a valid cached parse tree exists for it.
+ *
+ * @return true if the file was loaded from the cache, false if it must be parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool Load
+(
+    parseTree::DefFile_t* defFilePtr    ///< Definition file object to populate.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty() || (defFilePtr->type == parseTree::DefFile_t::SDEF))
+    {
+        return false;
+    }
+
+    std::string data;
+
+    if (!ReadFile(CacheFilePath(defFilePtr), data))
+    {
+        return false;
+    }
+
+    Reader_t reader(data);
+
+    std::string magic;
+    uint32_t version;
+    std::string toolStamp;
+    uint32_t type;
+    std::string filePath;
+
+    if (   !reader.Get(magic) || (magic != Magic)
+        || !reader.Get(version) || (version != FormatVersion)
+        || !reader.Get(toolStamp) || toolStamp.empty() || (toolStamp != GetToolStamp())
+        || !reader.Get(type) || (type != defFilePtr->type)
+        || !reader.Get(filePath) || (filePath != defFilePtr->path))
+    {
+        return false;
+    }
+
+    // The file and everything it includes must be unchanged.
+    uint32_t count;
+    std::vector<std::string> fragmentPaths;
+
+    if (!reader.Get(count) || (count == 0))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        std::string fragmentPath;
+        std::string contentMd5;
+
+        if (   !reader.Get(fragmentPath)
+            || !reader.Get(contentMd5)
+            || (FileMd5(fragmentPath) != contentMd5))
+        {
+            return false;
+        }
+
+        fragmentPaths.push_back(fragmentPath);
+    }
+
+    // The processing directives must evaluate the same way.
+    if (!reader.Get(count))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        std::string name;
+        std::string value;
+
+        if (!reader.Get(name) || !reader.Get(value) || (envVars::Get(name) != value))
+        {
+            return false;
+        }
+    }
+
+    // Read in the tokens and the tree, checking everything before creating any object.
+    std::vector<CachedToken_t> cachedTokens;
+
+    if (!reader.Get(count))
+    {
+        return false;
+    }
+    cachedTokens.resize(count);
+    for (auto& token : cachedTokens)
+    {
+        uint32_t tokenType;
+
+        if (   !reader.Get(token.fragment)
+            || !reader.Get(tokenType)
+            || !reader.Get(token.line)
+            || !reader.Get(token.column)
+            || !reader.Get(token.text)
+            || (token.fragment >= fragmentPaths.size())
+            || (tokenType > parseTree::Token_t::OPTIONAL_OPEN_SQUARE))
+        {
+            return false;
+        }
+
+        token.type = static_cast<parseTree::Token_t::Type_t>(tokenType);
+    }
+
+    std::vector<CachedItem_t> cachedSections;
+
+    if (!reader.Get(count))
+    {
+        return false;
+    }
+    cachedSections.resize(count);
+    for (auto& section : cachedSections)
+    {
+        if (!ReadItem(reader, cachedTokens.size(), section))
+        {
+            return false;
+        }
+    }
+
+    if (!reader.AtEnd())
+    {
+        return false;
+    }
+
+    // Everything checks out, so build the parse tree.
+    std::vector<parseTree::DefFileFragment_t*> fragments = { defFilePtr };
+
+    for (size_t i = 1; i < fragmentPaths.size(); i++)
+    {
+        fragments.push_back(new parseTree::DefFileFragment_t(fragmentPaths[i]));
+    }
+
+    std::vector<parseTree::Token_t*> tokens;
+    tokens.reserve(cachedTokens.size());
+
+    for (auto& cachedToken : cachedTokens)
+    {
+        auto fragmentPtr = fragments[cachedToken.fragment];
+        auto tokenPtr = new parseTree::Token_t(cachedToken.type,
+                                               fragmentPtr,
+                                               cachedToken.line,
+                                               cachedToken.column);
+        tokenPtr->text = std::move(cachedToken.text);
+
+        if (fragmentPtr->firstTokenPtr == NULL)
+        {
+            fragmentPtr->firstTokenPtr = tokenPtr;
+        }
+
+        tokens.push_back(tokenPtr);
+    }
+
+    for (const auto& section : cachedSections)
+    {
+        defFilePtr->sections.push_back(BuildItem(section, tokens));
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a file fragment and all the fragments it includes to a list, depth first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetFragments
+(
+    const parseTree::DefFileFragment_t* fragmentPtr,
+    std::vector<const parseTree::DefFileFragment_t*>& fragments
+)
+//--------------------------------------------------------------------------------------------------
+{
+    fragments.push_back(fragmentPtr);
+
+    for (const auto& include : fragmentPtr->includedFiles)
+    {
+        GetFragments(include.second, fragments);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Assigns indices to all the tokens referenced by a parse tree item and its sub-items, in
+ * the order they are first referenced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexTokens
+(
+    const parseTree::CompoundItem_t* itemPtr,
+    std::map<const parseTree::Token_t*, uint32_t>& tokenIndices,
+    std::vector<const parseTree::Token_t*>& tokens
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto addToken = [&tokenIndices, &tokens](const parseTree::Token_t* tokenPtr)
+    {
+        if (tokenIndices.insert(std::make_pair(tokenPtr, tokens.size())).second)
+        {
+            tokens.push_back(tokenPtr);
+        }
+    };
+
+    addToken(itemPtr->firstTokenPtr);
+    addToken(itemPtr->lastTokenPtr);
+
+    if (IsCompoundItemList(itemPtr->type))
+    {
+        for (auto subItemPtr : parseTree::ToCompoundItemListPtr(itemPtr)->Contents())
+        {
+            IndexTokens(subItemPtr, tokenIndices, tokens);
+        }
+    }
+    else
+    {
+        for (auto tokenPtr : parseTree::ToTokenListPtr(itemPtr)->Contents())
+        {
+            addToken(tokenPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a parse tree item, and all its sub-items, to a cache file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteItem
+(
+    Writer_t& writer,
+    const parseTree::CompoundItem_t* itemPtr,
+    const std::map<const parseTree::Token_t*, uint32_t>& tokenIndices
+)
+//--------------------------------------------------------------------------------------------------
+{
+    writer.Put(itemPtr->type);
+    writer.Put(tokenIndices.at(itemPtr->firstTokenPtr));
+    writer.Put(tokenIndices.at(itemPtr->lastTokenPtr));
+
+    if (IsCompoundItemList(itemPtr->type))
+    {
+        const auto& contents = parseTree::ToCompoundItemListPtr(itemPtr)->Contents();
+
+        writer.Put(contents.size());
+        for (auto subItemPtr : contents)
+        {
+            WriteItem(writer, subItemPtr, tokenIndices);
+        }
+    }
+    else
+    {
+        const auto& contents = parseTree::ToTokenListPtr(itemPtr)->Contents();
+
+        writer.Put(contents.size());
+        for (auto tokenPtr : contents)
+        {
+            writer.Put(tokenIndices.at(tokenPtr));
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the parse tree of a freshly parsed definition file to the cache.  Failures are not
+ * errors; the file will just be parsed again next time.
+ */
+//--------------------------------------------------------------------------------------------------
+void Store
+(
+    const parseTree::DefFile_t* defFilePtr, ///< The parsed definition file.
+    const Lexer_t& lexer                    ///< The lexer that parsed it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   CacheDir.empty()
+        || (defFilePtr->type == parseTree::DefFile_t::SDEF)
+        || lexer.usedFileSystemPredicate
+        || GetToolStamp().empty())
+    {
+        return;
+    }
+
+    Writer_t writer;
+
+    writer.Put(Magic);
+    writer.Put(FormatVersion);
+    writer.Put(GetToolStamp());
+    writer.Put(defFilePtr->type);
+    writer.Put(defFilePtr->path);
+
+    std::vector<const parseTree::DefFileFragment_t*> fragments;
+    std::map<const parseTree::DefFileFragment_t*, uint32_t> fragmentIndices;
+
+    GetFragments(defFilePtr, fragments);
+
+    writer.Put(fragments.size());
+    for (auto fragmentPtr : fragments)
+    {
+        auto contentMd5 = FileMd5(fragmentPtr->path);
+
+        if (contentMd5.empty())
+        {
+            return;
+        }
+
+        auto index = static_cast<uint32_t>(fragmentIndices.size());
+
+        fragmentIndices[fragmentPtr] = index;
+        writer.Put(fragmentPtr->path);
+        writer.Put(contentMd5);
+    }
+
+    // CURDIR is always the directory of the file being lexed, which is covered by the file path.
+    std::set<std::string> varNames;
+
+    lexer.GetUsedVarNames(varNames);
+    varNames.erase("CURDIR");
+
+    writer.Put(varNames.size());
+    for (const auto& name : varNames)
+    {
+        writer.Put(name);
+        writer.Put(envVars::Get(name));
+    }
+
+    std::map<const parseTree::Token_t*, uint32_t> tokenIndices;
+    std::vector<const parseTree::Token_t*> tokens;
+
+    for (auto sectionPtr : defFilePtr->sections)
+    {
+        IndexTokens(sectionPtr, tokenIndices, tokens);
+    }
+
+    writer.Put(tokens.size());
+    for (auto tokenPtr : tokens)
+    {
+        auto fragmentIter = fragmentIndices.find(tokenPtr->filePtr);
+
+        if (fragmentIter == fragmentIndices.end())
+        {
+            return;
+        }
+
+        writer.Put(fragmentIter->second);
+        writer.Put(tokenPtr->type);
+        writer.Put(tokenPtr->line);
+        writer.Put(tokenPtr->column);
+        writer.Put(tokenPtr->text);
+    }
+
+    writer.Put(defFilePtr->sections.size());
+    for (auto sectionPtr : defFilePtr->sections)
+    {
+        WriteItem(writer, sectionPtr, tokenIndices);
+    }
+
+    // Write to a temporary file first, so a concurrent or interrupted build never sees a partial
+    // cache file.
+    auto cacheFilePath = CacheFilePath(defFilePtr);
+    auto tempFilePath = cacheFilePath + ".tmp" + std::to_string(getpid());
+
+    try
+    {
+        file::MakeDir(CacheDir);
+    }
+    catch (const mk::Exception_t&)
+    {
+        return;
+    }
+
+    {
+        std::ofstream outputStream(tempFilePath, std::ios::binary | std::ios::trunc);
+
+        outputStream.write(writer.Data().data(), writer.Data().size());
+        outputStream.close();
+
+        if (outputStream.fail())
+        {
+            unlink(tempFilePath.c_str());
+            return;
+        }
+    }
+
+    if (rename(tempFilePath.c_str(), cacheFilePath.c_str()) != 0)
+    {
+        unlink(tempFilePath.c_str());
+    }
+}
+
+
+
+} // namespace cache
+
+} // namespace parser
@@ -0,0 +1,66 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseCache.h  Persistent cache of parsed definition files.
+ *
+ * Parse trees of .cdef, .adef and .mdef files are saved in a compact binary form in the cache
+ * directory, one file per definition file, named after the definition file's path MD5.  A cached
+ * parse tree is used instead of lexing and parsing the file again as long as the content of the
+ * file and all the files it includes, the values of the variables used by its processing
+ * directives and the mk tools executable are all unchanged.
+ *
+ * .sdef files are never cached, because parsing them has side-effects (build variables).  Files
+ * whose processing directives test for the existence of files or directories aren't cached either.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
+
+
+namespace cache
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the directory in which parse trees are cached.  An empty path disables the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void SetDir
+(
+    const std::string& dirPath
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Populates a definition file object from the cache, if a valid cached parse tree exists for it.
+ *
+ * @return true if the file was loaded from the cache, false if it must be parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+bool Load
+(
+    parseTree::DefFile_t* defFilePtr    ///< Definition file object to populate.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves the parse tree of a freshly parsed definition file to the cache.  Failures are not
+ * errors; the file will just be parsed again next time.
+ */
+//--------------------------------------------------------------------------------------------------
+void Store
+(
+    const parseTree::DefFile_t* defFilePtr, ///< The parsed definition file.
+    const Lexer_t& lexer                    ///< The lexer that parsed it.
+);
+
+
+
+} // namespace cache
+
+#endif // LEGATO_MKTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
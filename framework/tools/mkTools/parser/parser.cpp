@@ -386,12 +386,26 @@ void ParseFile
 )
 //--------------------------------------------------------------------------------------------------
 {
+    profile::Scope_t profileScope("parse", defFilePtr->path);
+
     if (beVerbose)
     {
         std::cout << mk::format(LE_I18N("Parsing file: '%s'."), defFilePtr->path)
                   << std::endl;
     }
 
+    if (cache::Load(defFilePtr))
+    {
+        if (beVerbose)
+        {
+            std::cout << mk::format(LE_I18N("Loaded parse tree of '%s' from cache."),
+                                    defFilePtr->path)
+                      << std::endl;
+        }
+
+        return;
+    }
+
     // Create a Lexer for this file.
     Lexer_t lexer(defFilePtr);
     lexer.beVerbose = beVerbose;
@@ -408,6 +422,8 @@ void ParseFile
             lexer.UnexpectedChar(LE_I18N("Unexpected character %s"));
         }
     }
+
+    cache::Store(defFilePtr, lexer);
 }
 
 
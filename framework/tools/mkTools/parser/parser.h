@@ -50,6 +50,7 @@ namespace parser
 #include "mdefParser.h"
 #include "sdefParser.h"
 #include "apiParser.h"
+#include "parseCache.h"
 
 
 //--------------------------------------------------------------------------------------------------
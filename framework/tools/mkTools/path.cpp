@@ -721,6 +721,27 @@ bool IsPythonSource
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Figures out whether or not a given string is a JavaScript source code file path.
+ *
+ * @return true if this is a JavaScript source code file path.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsJavaScriptSource
+(
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If it ends in ".js", then it's a JavaScript source code file.
+    static const std::list<std::string> suffixes = { ".js" };
+
+    return (HasSuffix(path, suffixes) != "");
+}
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Figures out whether or not a given string is a library file path.
@@ -251,6 +251,20 @@ bool IsPythonSource
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Figures out whether or not a given string is a JavaScript source code file path.
+ *
+ * @return true if this is a JavaScript source code file path.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsJavaScriptSource
+(
+    const std::string& path
+);
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Figures out whether or not a given string is a library file path.
@@ -0,0 +1,536 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file profile.cpp  Build performance profiling.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+
+#include <iomanip>
+#include <mutex>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace profile
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace "process" IDs of the events recorded by the mk tools and of the ninja build edges.
+ */
+//--------------------------------------------------------------------------------------------------
+static const int MkPid = 1;
+static const int NinjaPid = 2;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A timed event.  Times are in microseconds since profiling was enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+struct Event_t
+{
+    std::string phase;
+    std::string name;
+    long long startUs;
+    long long durationUs;
+    int pid;
+    int tid;
+};
+
+
+static bool IsProfiling = false;
+static std::string TraceFilePath;
+static std::chrono::steady_clock::time_point StartTime;
+
+/// Recorded events and the trace thread IDs assigned to the mk tools' threads.  Code generation
+/// runs on several threads, so both are protected by the mutex.
+static std::mutex EventsMutex;
+static std::vector<Event_t> Events;
+static std::map<std::thread::id, int> ThreadIds;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Converts a time point to microseconds since profiling was enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static long long ToUs
+(
+    std::chrono::steady_clock::time_point time
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - StartTime).count();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records an event of the mk tools, on the calling thread's track.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordMkEvent
+(
+    const std::string& phase,
+    const std::string& name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(EventsMutex);
+
+    auto threadIdIter = ThreadIds.find(std::this_thread::get_id());
+    if (threadIdIter == ThreadIds.end())
+    {
+        int tid = ThreadIds.size() + 1;
+        threadIdIter = ThreadIds.insert(std::make_pair(std::this_thread::get_id(), tid)).first;
+    }
+
+    Events.push_back({ phase, name, ToUs(start), ToUs(end) - ToUs(start),
+                       MkPid, threadIdIter->second });
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables profiling.  Must be called before anything that should be profiled.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const std::string& traceFilePath    ///< Path of the Chrome trace file to write.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    IsProfiling = true;
+    TraceFilePath = traceFilePath;
+    StartTime = std::chrono::steady_clock::now();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether profiling is enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsEnabled
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return IsProfiling;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts timing a scope.
+ */
+//--------------------------------------------------------------------------------------------------
+Scope_t::Scope_t
+(
+    const char* phaseName,          ///< Build phase the event belongs to (e.g., "parse").
+    const std::string& eventName    ///< Event name (e.g., file parsed).  Defaults to the phase.
+)
+//--------------------------------------------------------------------------------------------------
+:   phaseName(IsProfiling ? phaseName : NULL)
+{
+    if (IsProfiling)
+    {
+        this->eventName = eventName.empty() ? phaseName : eventName;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the timed scope.
+ */
+//--------------------------------------------------------------------------------------------------
+Scope_t::~Scope_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (phaseName != NULL)
+    {
+        RecordMkEvent(phaseName, eventName, start, std::chrono::steady_clock::now());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Works out which build phase a ninja build edge belongs to, from the path of its first output.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetNinjaEdgePhase
+(
+    const std::string& outputPath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (outputPath.find("/staging/") != std::string::npos)
+    {
+        return "ninja: stage";
+    }
+
+    auto fileName = path::GetLastNode(outputPath);
+    auto dotPos = fileName.rfind('.');
+    auto extension = (dotPos == std::string::npos) ? std::string() : fileName.substr(dotPos);
+
+    if (extension == ".o")
+    {
+        return "ninja: compile";
+    }
+    if ((extension == ".so") || (extension == ""))
+    {
+        return "ninja: link";
+    }
+    if (   (extension == ".c") || (extension == ".h")
+        || (extension == ".java") || (extension == ".py"))
+    {
+        return "ninja: ifgen";
+    }
+    if (extension == ".ninja")
+    {
+        return "ninja: regenerate";
+    }
+    if (extension == ".update")
+    {
+        return "ninja: package";
+    }
+
+    return "ninja: other";
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the build edges that ninja logged from a given offset in its log onwards.
+ *
+ * Edges that produce several outputs are logged once per output, with the same start and end
+ * times; those are recorded as a single event.  Edges are spread over as many trace threads as
+ * were needed to run them, so parallel jobs show up side by side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordNinjaEdges
+(
+    const std::string& logPath,     ///< Path of the .ninja_log file.
+    std::streamoff logOffset,       ///< Size of the log before ninja was run.
+    long long ninjaStartUs          ///< When ninja was started.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream log(logPath);
+
+    if (!log.is_open())
+    {
+        return;
+    }
+
+    // If ninja compacted its log, the offset is meaningless; take everything it contains.
+    log.seekg(0, std::ios::end);
+    if (log.tellg() < logOffset)
+    {
+        logOffset = 0;
+    }
+    log.seekg(logOffset);
+
+    struct Edge_t
+    {
+        long long startMs;
+        long long endMs;
+        std::string output;
+        size_t outputCount;
+    };
+    std::vector<Edge_t> edges;
+
+    // Each line is "<start ms>\t<end ms>\t<mtime>\t<output path>\t<command hash>".
+    std::string line;
+    while (std::getline(log, line))
+    {
+        if (line.empty() || (line[0] == '#'))
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        long long startMs;
+        long long endMs;
+        std::string mtime;
+        std::string output;
+
+        if (   !(fields >> startMs >> endMs)
+            || !std::getline(fields.ignore(), mtime, '\t')
+            || !std::getline(fields, output, '\t'))
+        {
+            continue;
+        }
+
+        if (   !edges.empty()
+            && (edges.back().startMs == startMs)
+            && (edges.back().endMs == endMs))
+        {
+            edges.back().outputCount++;
+        }
+        else
+        {
+            edges.push_back({ startMs, endMs, output, 1 });
+        }
+    }
+
+    std::stable_sort(edges.begin(),
+                     edges.end(),
+                     [](const Edge_t& a, const Edge_t& b) { return a.startMs < b.startMs; });
+
+    std::vector<long long> laneEndMs;
+
+    std::lock_guard<std::mutex> lock(EventsMutex);
+
+    for (const auto& edge : edges)
+    {
+        size_t lane = 0;
+        while ((lane < laneEndMs.size()) && (laneEndMs[lane] > edge.startMs))
+        {
+            lane++;
+        }
+        if (lane == laneEndMs.size())
+        {
+            laneEndMs.push_back(0);
+        }
+        laneEndMs[lane] = edge.endMs;
+
+        std::string name = edge.output;
+        if (edge.outputCount > 1)
+        {
+            name += mk::format(" (+%d more)", edge.outputCount - 1);
+        }
+
+        Events.push_back({ GetNinjaEdgePhase(edge.output),
+                           name,
+                           ninjaStartUs + (edge.startMs * 1000),
+                           (edge.endMs - edge.startMs) * 1000,
+                           NinjaPid,
+                           static_cast<int>(lane) + 1 });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs ninja as a child process and records the build edges it ran, from the .ninja_log file in
+ * the build's working directory.
+ *
+ * @return ninja's exit code.
+ */
+//--------------------------------------------------------------------------------------------------
+int RunNinja
+(
+    const std::string& workingDir,  ///< The build's working directory.
+    const char** ninjaArgv          ///< ninja's command line.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto logPath = path::Combine(workingDir, ".ninja_log");
+
+    // Only the entries ninja appends to its log during this run are of interest.
+    std::streamoff logOffset = 0;
+    struct stat logStat;
+    if (stat(logPath.c_str(), &logStat) == 0)
+    {
+        logOffset = logStat.st_size;
+    }
+
+    std::cout.flush();
+
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to fork ninja process (%s)."), strerror(errno))
+        );
+    }
+
+    if (pid == 0)
+    {
+        (void)execvp("ninja", const_cast<char **>(ninjaArgv));
+
+        std::cerr << mk::format(LE_I18N("Failed to execute ninja (%s)."), strerror(errno))
+                  << std::endl;
+        _exit(EXIT_FAILURE);
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Failed to wait for ninja (%s)."), strerror(errno))
+            );
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    RecordMkEvent("ninja", "ninja", start, end);
+    RecordNinjaEdges(logPath, logOffset, ToUs(start));
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Escapes a string for use in a JSON document.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string EscapeJson
+(
+    const std::string& str
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string result;
+
+    for (char c : str)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            result += mk::format("\\u%04x", static_cast<int>(c));
+        }
+        else
+        {
+            result += c;
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the recorded events to the Chrome trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteTrace
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    file::MakeDir(path::GetContainingDir(TraceFilePath));
+
+    std::ofstream trace(TraceFilePath, std::ofstream::trunc);
+    if (!trace.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), TraceFilePath)
+        );
+    }
+
+    trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+          << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << MkPid
+          << ",\"args\":{\"name\":\"mk\"}},\n"
+          << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << NinjaPid
+          << ",\"args\":{\"name\":\"ninja\"}}";
+
+    for (const auto& event : Events)
+    {
+        trace << ",\n{\"name\":\"" << EscapeJson(event.name) << "\""
+              << ",\"cat\":\"" << EscapeJson(event.phase) << "\""
+              << ",\"ph\":\"X\",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs
+              << ",\"pid\":" << event.pid << ",\"tid\":" << event.tid << "}";
+    }
+
+    trace << "\n]}\n";
+
+    trace.close();
+    if (trace.fail())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to write file '%s'."), TraceFilePath)
+        );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the summary table of the time spent in each phase and writes the Chrome trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+void Report
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!IsProfiling)
+    {
+        return;
+    }
+
+    auto wallTimeUs = ToUs(std::chrono::steady_clock::now());
+
+    std::lock_guard<std::mutex> lock(EventsMutex);
+
+    // Total the events of each phase, listing the phases in the order they were first seen.
+    std::vector<std::string> phases;
+    std::map<std::string, std::pair<size_t, long long>> totals;
+
+    for (const auto& event : Events)
+    {
+        auto& total = totals[event.phase];
+        if (total.first == 0)
+        {
+            phases.push_back(event.phase);
+        }
+        total.first++;
+        total.second += event.durationUs;
+    }
+
+    std::cout << mk::format(LE_I18N("Build profile (wall time %.3f s):"), wallTimeUs / 1e6)
+              << std::endl
+              << "  " << std::left << std::setw(24) << LE_I18N("Phase")
+              << std::right << std::setw(10) << LE_I18N("Events")
+              << std::setw(14) << LE_I18N("Time (s)") << std::endl;
+
+    for (const auto& phase : phases)
+    {
+        const auto& total = totals[phase];
+
+        std::cout << "  " << std::left << std::setw(24) << phase
+                  << std::right << std::setw(10) << total.first
+                  << std::setw(14) << std::fixed << std::setprecision(3) << (total.second / 1e6)
+                  << std::endl;
+    }
+
+    std::cout << LE_I18N("Phases can overlap: parsing is part of modelling, and jobs that ran in"
+                         " parallel are all counted in full.") << std::endl;
+
+    WriteTrace();
+
+    std::cout << mk::format(LE_I18N("Chrome trace written to '%s'."), TraceFilePath) << std::endl;
+}
+
+
+} // namespace profile
@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file profile.h  Build performance profiling.
+ *
+ * When enabled, the mk tools record how long each phase of a build takes (parsing, modelling,
+ * code generation, ...) and, once ninja has finished, the duration of every ninja build edge,
+ * taken from the .ninja_log file.  The result is printed as a summary table and saved as a
+ * Chrome trace (viewable in chrome://tracing or Perfetto).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
+
+#include <chrono>
+
+namespace profile
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables profiling.  Must be called before anything that should be profiled.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const std::string& traceFilePath    ///< Path of the Chrome trace file to write.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether profiling is enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Times the scope it is declared in and records it as an event of a given build phase.  Does
+ * nothing if profiling isn't enabled.  Can be used from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+class Scope_t
+{
+    public:
+
+        Scope_t(const char* phaseName, const std::string& eventName = "");
+        ~Scope_t();
+
+    private:
+
+        const char* phaseName;
+        std::string eventName;
+        std::chrono::steady_clock::time_point start;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs ninja as a child process and records the build edges it ran, from the .ninja_log file in
+ * the build's working directory.
+ *
+ * @return ninja's exit code.
+ */
+//--------------------------------------------------------------------------------------------------
+int RunNinja
+(
+    const std::string& workingDir,  ///< The build's working directory.
+    const char** ninjaArgv          ///< ninja's command line.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the summary table of the time spent in each phase and writes the Chrome trace file.
+ */
+//--------------------------------------------------------------------------------------------------
+void Report
+(
+    void
+);
+
+
+} // namespace profile
+
+#endif // LEGATO_MKTOOLS_PROFILE_H_INCLUDE_GUARD
@@ -9,15 +9,16 @@
 #define _LARGEFILE64_SOURCE
 #include "legato.h"
 #include <endian.h>
+#include <pthread.h>
 
 #include "flash-ubi.h"
+#include "bsdiff.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Defines some executables requested by the tool
  */
 //--------------------------------------------------------------------------------------------------
-#define BSDIFF "bsdiff"
 #define HDRCNV "hdrcnv"
 
 //--------------------------------------------------------------------------------------------------
@@ -92,6 +93,28 @@ typedef struct
 }
 DeltaPatchHeader_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Structure for the computation of the segment patches of a destination image. The suffix array of
+ * the origin image is sorted only one time and shared by all the threads, each thread computing
+ * the patch of the next segment not yet taken by another one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    u_char *origPtr;         ///< Origin image
+    off_t origSize;          ///< Size of the origin image
+    off_t *suffixArrayPtr;   ///< Suffix array of the origin image
+    u_char *destPtr;         ///< Destination image
+    off_t destSize;          ///< Size of the destination image
+    size_t segmentSize;      ///< Size of a patch segment
+    int numPatches;          ///< Total number of patch segments
+    int nextPatch;           ///< Next patch segment to compute
+    pthread_mutex_t mutex;   ///< Mutex protecting nextPatch
+    pid_t pid;               ///< Pid used to name the segment patch files
+}
+DiffJob_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure to get correspondance between a partition name and image type for the CWE headers
@@ -168,6 +191,13 @@ static char *ProgName;
 //--------------------------------------------------------------------------------------------------
 static bool IsVerbose = false;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of threads computing the segment patches in parallel. 0 means one per online CPU.
+ */
+//--------------------------------------------------------------------------------------------------
+static long NbJobs = 0;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Original and destination name pointer
@@ -210,13 +240,6 @@ static DeltaPatchHeader_t PatchHeader;
 //--------------------------------------------------------------------------------------------------
 static uint8_t Chunk[SEGMENT_SIZE];
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Buffer for the segment patch
- */
-//--------------------------------------------------------------------------------------------------
-static uint8_t PatchedChunk[2 * SEGMENT_SIZE];
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Flash device page size
@@ -791,6 +814,164 @@ static void ExecSystem
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load a whole image into memory. The buffer is allocated one byte larger to never call malloc(3)
+ * with 0 for an empty image. In case of error, call exit(3).
+ *
+ * @return
+ *      - The buffer containing the image, to be released with free(3)
+ */
+//--------------------------------------------------------------------------------------------------
+static u_char* LoadImage
+(
+    char* namePtr,
+    off_t* sizePtr
+)
+{
+    int fd;
+    struct stat st;
+    u_char* imagePtr;
+    off_t offset = 0;
+    ssize_t len;
+
+    fd = open( namePtr, O_RDONLY );
+    if( 0 > fd )
+    {
+        fprintf(stderr, "Unable to open file %s: %m\n", namePtr);
+        exit(1);
+    }
+    fstat( fd, &st );
+    imagePtr = malloc( st.st_size + 1 );
+    if( !imagePtr )
+    {
+        fprintf(stderr, "Unable to allocate %lld bytes for %s\n",
+                (long long)st.st_size, namePtr);
+        exit(1);
+    }
+    while( (offset < st.st_size) &&
+           (0 < (len = read( fd, imagePtr + offset, st.st_size - offset ))) )
+    {
+        offset += len;
+    }
+    close( fd );
+    if( offset != st.st_size )
+    {
+        fprintf(stderr, "read() of %s fails: %m\n", namePtr );
+        exit(4);
+    }
+    *sizePtr = st.st_size;
+    return imagePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread computing the patches of the segments of a destination image until all segments are
+ * done. The patch of the segment N is written into the file patched.<pid>.bin.<N>
+ */
+//--------------------------------------------------------------------------------------------------
+static void* DiffSegmentThread
+(
+    void* ctxPtr
+)
+{
+    DiffJob_t* jobPtr = ctxPtr;
+    char patchName[PATH_MAX];
+    off_t offset, len;
+    int patchNum;
+
+    for( ;; )
+    {
+        pthread_mutex_lock( &jobPtr->mutex );
+        patchNum = jobPtr->nextPatch++;
+        pthread_mutex_unlock( &jobPtr->mutex );
+        if( patchNum >= jobPtr->numPatches )
+        {
+            break;
+        }
+
+        offset = (off_t)patchNum * jobPtr->segmentSize;
+        len = jobPtr->destSize - offset;
+        if( len > (off_t)jobPtr->segmentSize )
+        {
+            len = jobPtr->segmentSize;
+        }
+        snprintf( patchName, sizeof(patchName), "patched.%u.bin.%d", jobPtr->pid, patchNum );
+        if( IsVerbose )
+        {
+            printf( "bsdiff segment %d at offset 0x%llx into %s\n",
+                    patchNum, (long long)offset, patchName );
+        }
+        bsDiff( jobPtr->origPtr, jobPtr->origSize, jobPtr->suffixArrayPtr,
+                jobPtr->destPtr + offset, len, patchName );
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the patches of all segments of a destination image against the origin image, using
+ * NbJobs threads. In case of error, call exit(3).
+ */
+//--------------------------------------------------------------------------------------------------
+static void DiffSegments
+(
+    DiffJob_t* jobPtr
+)
+{
+    pthread_t* threadsPtr;
+    long nbThreads = NbJobs;
+    long i;
+    int rc;
+
+    if( 0 == jobPtr->numPatches )
+    {
+        return;
+    }
+    if( 0 >= nbThreads )
+    {
+        nbThreads = sysconf( _SC_NPROCESSORS_ONLN );
+    }
+    if( (0 >= nbThreads) || (nbThreads > jobPtr->numPatches) )
+    {
+        nbThreads = (0 >= nbThreads) ? 1 : jobPtr->numPatches;
+    }
+
+    threadsPtr = calloc( nbThreads, sizeof(pthread_t) );
+    if( !threadsPtr )
+    {
+        fprintf(stderr, "Unable to allocate %ld threads\n", nbThreads);
+        exit(1);
+    }
+
+    jobPtr->suffixArrayPtr = bsDiff_Sort( jobPtr->origPtr, jobPtr->origSize );
+    jobPtr->nextPatch = 0;
+    pthread_mutex_init( &jobPtr->mutex, NULL );
+
+    if( IsVerbose )
+    {
+        printf( "Computing %d segment patches with %ld threads\n", jobPtr->numPatches, nbThreads );
+    }
+    for( i = 0; i < nbThreads; i++ )
+    {
+        rc = pthread_create( &threadsPtr[i], NULL, DiffSegmentThread, jobPtr );
+        if( rc )
+        {
+            fprintf(stderr, "pthread_create() fails: %s\n", strerror(rc));
+            exit(2);
+        }
+    }
+    for( i = 0; i < nbThreads; i++ )
+    {
+        pthread_join( threadsPtr[i], NULL );
+    }
+    free( threadsPtr );
+
+    pthread_mutex_destroy( &jobPtr->mutex );
+    free( jobPtr->suffixArrayPtr );
+    jobPtr->suffixArrayPtr = NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print usage and exit...
@@ -802,7 +983,7 @@ static void Usage
 )
 {
     fprintf(stderr,
-            "usage: %s -T TARGET [-o patchname] [-S 4K|2K] [-E 256K|128K] [-N] [-v]\n"
+            "usage: %s -T TARGET [-o patchname] [-S 4K|2K] [-E 256K|128K] [-N] [-j JOBS] [-v]\n"
             "        {-p PART {[-U VOLID] file-orig file-dest}}\n",
             ProgName );
     fprintf(stderr, "\n");
@@ -817,6 +998,9 @@ static void Usage
                     "        Specify another PEB size (optional - specified only one time).\n");
     fprintf(stderr, "   -N, --no-spkg-header\n"
                     "        Do not generate the CWE SPKG header.\n");
+    fprintf(stderr, "   -j, --jobs <JOBS>\n"
+                    "        Compute the segment patches with JOBS threads."
+                           " Else use one thread per CPU.\n");
     fprintf(stderr, "   -v, --verbose\n"
                     "        Be verbose.\n");
     fprintf(stderr, "   -p, --partition <PART>\n"
@@ -886,6 +1070,8 @@ int main
     char tmpName[PATH_MAX];
     int fdr, fdw, fdp;
     int len, patchNum = 0;
+    off_t offset;
+    DiffJob_t diffJob;
     int iargc = argc;
     char** argvPtr = &argv[1];
     struct stat st;
@@ -910,7 +1096,8 @@ int main
 
     ProgName = argv[0];
 
-    CheckForTool( BSDIFF, NULL );
+    memset( &diffJob, 0, sizeof(diffJob) );
+    diffJob.pid = pid;
 
     getcwd(CurrentWorkDir, sizeof(CurrentWorkDir));
     atexit( Exithandler );
@@ -1044,6 +1231,23 @@ int main
             iargc--;
         }
 
+        else if( (iargc >= 5) &&
+                 ((0 == strcmp(*argvPtr, "--jobs")) || (0 == strcmp(*argvPtr, "-j"))) )
+        {
+            char *endPtr;
+
+            ++argvPtr;
+            errno = 0;
+            NbJobs = strtol( *argvPtr, &endPtr, 10 );
+            if( (errno) || (*endPtr) || (0 >= NbJobs) )
+            {
+                fprintf(stderr, "Incorrect number of jobs '%s'\n", *argvPtr );
+                exit(1);
+            }
+            ++argvPtr;
+            iargc -= 2;
+        }
+
         else if( (iargc >= 4) &&
                  ((0 == strcmp(*argvPtr, "--verbose")) || (0 == strcmp(*argvPtr, "-v"))) )
         {
@@ -1233,22 +1437,10 @@ int main
             {
                 snprintf(OrigName, sizeof(OrigName), "%s", OrigPtr);
             }
-            fdr = open( OrigName, O_RDONLY );
-            if( 0 > fdr )
-            {
-                fprintf(stderr, "Unable to open origin file %s: %m\n", OrigName);
-                exit(1);
-            }
-            fstat( fdr, &st );
-            PatchMetaHeader.origSize = htobe32(st.st_size);
+            diffJob.origPtr = LoadImage( OrigName, &diffJob.origSize );
+            PatchMetaHeader.origSize = htobe32(diffJob.origSize);
 
-            crc32Orig = LE_CRC_START_CRC32;
-
-            while( 0 < (len = read( fdr, Chunk, chunkLen )) )
-            {
-                crc32Orig = le_crc_Crc32( Chunk, len, crc32Orig );
-            }
-            close( fdr );
+            crc32Orig = le_crc_Crc32( diffJob.origPtr, diffJob.origSize, LE_CRC_START_CRC32 );
             PatchMetaHeader.origCrc32 = htobe32(crc32Orig);
 
             if( notUbiOpt && isUbiImage )
@@ -1263,18 +1455,19 @@ int main
             {
                 snprintf(DestName, sizeof(DestName), "%s", DestPtr);
             }
-            fdr = open( DestName, O_RDONLY );
-            if( 0 > fdr )
-            {
-                fprintf(stderr, "Unable to open destination file %s: %m\n", DestPtr);
-                exit(1);
-            }
-            fstat( fdr, &st );
-            PatchMetaHeader.destSize = htobe32(st.st_size);
+            diffJob.destPtr = LoadImage( DestName, &diffJob.destSize );
+            PatchMetaHeader.destSize = htobe32(diffJob.destSize);
 
             PatchMetaHeader.ubiVolId = htobe32(ubiVolId);
 
-            crc32Dest = LE_CRC_START_CRC32;
+            crc32Dest = le_crc_Crc32( diffJob.destPtr, diffJob.destSize, LE_CRC_START_CRC32 );
+
+            // Compute all the segment patches in parallel, then gather them in the segment order
+            diffJob.segmentSize = chunkLen;
+            diffJob.numPatches = (diffJob.destSize + chunkLen - 1) / chunkLen;
+            DiffSegments( &diffJob );
+            free( diffJob.origPtr );
+            free( diffJob.destPtr );
 
             snprintf( tmpName, sizeof(tmpName),
                       "patch.%u.bin",
@@ -1287,28 +1480,8 @@ int main
             }
             write( fdp, &PatchMetaHeader, sizeof(PatchMetaHeader) );
 
-            while( 0 < (len = read( fdr, Chunk, chunkLen)) )
+            for( patchNum = 0; patchNum < diffJob.numPatches; )
             {
-                crc32Dest = le_crc_Crc32( Chunk, len, crc32Dest );
-                snprintf( tmpName, sizeof(tmpName), "patchdest.%u.bin.%d", pid, patchNum );
-                fdw = open( tmpName, O_WRONLY | O_TRUNC | O_CREAT, S_IWUSR | S_IRUSR );
-                if( 0 <= fdw )
-                {
-                    write( fdw, Chunk, len );
-                    close( fdw );
-                }
-                else {
-                    fprintf( stderr, "Open of patch file %s fails: %m\n", tmpName );
-                    exit(3);
-                }
-                snprintf( CmdBuf, sizeof(CmdBuf),
-                          BSDIFF " %s %s patched.%u.bin.%d",
-                          OrigName, tmpName, pid, patchNum );
-                if( IsVerbose )
-                {
-                    printf( "%s\n", CmdBuf );
-                }
-                ExecSystem( CmdBuf );
                 snprintf( tmpName, sizeof(tmpName), "patched.%u.bin.%d", pid, patchNum );
                 fdw = open( tmpName, O_RDONLY );
                 if( 0 > fdw )
@@ -1324,20 +1497,18 @@ int main
                 printf("Patch Header: offset 0x%x number %d size %u (0x%x)\n",
                        be32toh(PatchHeader.offset), be32toh(PatchHeader.number),
                        be32toh(PatchHeader.size), be32toh(PatchHeader.size));
-                len = read( fdw, PatchedChunk, st.st_size );
-                if( 0 > len )
+                write( fdp, &PatchHeader, sizeof(PatchHeader) );
+                for( offset = 0; offset < st.st_size; offset += len )
                 {
-                    fprintf(stderr, "read() fails: %m\n" );
-                    exit(4);
+                    len = read( fdw, Chunk, sizeof(Chunk) );
+                    if( 0 >= len )
+                    {
+                        fprintf(stderr, "read() fails: %m\n" );
+                        exit(4);
+                    }
+                    write( fdp, Chunk, len );
                 }
                 close(fdw);
-                write( fdp, &PatchHeader, sizeof(PatchHeader) );
-                write( fdp, PatchedChunk, st.st_size );
-            }
-            if( len < 0 )
-            {
-                fprintf(stderr, "read() fails: %m\n" );
-                exit(4);
             }
 
             PatchMetaHeader.destCrc32 = htobe32(crc32Dest);
@@ -1354,7 +1525,6 @@ int main
                     be32toh(PatchMetaHeader.ubiVolId),
                     be32toh(PatchMetaHeader.origSize), be32toh(PatchMetaHeader.origCrc32),
                     be32toh(PatchMetaHeader.destSize), be32toh(PatchMetaHeader.destCrc32));
-            close( fdr );
             close( fdp );
 
             snprintf( CmdBuf, sizeof(CmdBuf),
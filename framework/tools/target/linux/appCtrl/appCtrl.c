@@ -72,12 +72,28 @@ static void (*CommandFunc)(void);
         if (condition) { INTERNAL_ERR(formatString, ##__VA_ARGS__); }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * An installed application, as read from the Supervisor's snapshot (see le_appInfo_GetSnapshot()).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_APP_NAME_BYTES];    // The name of the app.
+    bool isRunning;                         // true if the app is running.
+    ssize_t memUsed;                        // Memory used by the app in bytes, -1 if not known.
+    uint32_t faultCount;                    // Faults of the app's processes since it started.
+    le_sls_Link_t link;                     // The link in the list of apps.
+}
+AppSnapshot_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Type for functions that prints some information for an application.
  */
 //--------------------------------------------------------------------------------------------------
-typedef void (*PrintAppFunc_t)(const char* appNamePtr);
+typedef void (*PrintAppFunc_t)(const AppSnapshot_t* appPtr);
 
 
 //--------------------------------------------------------------------------------------------------
@@ -176,6 +192,30 @@ static le_mem_PoolRef_t ProcNamePool;
 static le_hashmap_Ref_t ProcObjMap;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of app snapshot objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AppSnapshotPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of installed apps, in the order of the snapshot.  Only valid once IsSnapshotLoaded is true.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_List_t AppSnapshotList = LE_SLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the Supervisor's snapshot has been read into AppSnapshotList.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSnapshotLoaded = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints help to stdout and exits.
@@ -202,6 +242,7 @@ static void PrintHelp
         "    app status [<appName>]\n"
         "    app version <appName>\n"
         "    app info [<appName>]\n"
+        "    app usage <appName>\n"
         "    app runProc <appName> <procName> [options]\n"
         "    app runProc <appName> [<procName>] --exe=<exePath> [options]\n"
         "\n"
@@ -249,6 +290,10 @@ static void PrintHelp
         "       If no name is given, prints the information of all installed applications.\n"
         "       If a name is given, prints the information of the specified application.\n"
         "\n"
+        "    app usage <appName>\n"
+        "       Prints the recent CPU and memory use of the specified application, as sampled by\n"
+        "       the Supervisor while the application runs.  CPU use is in percent of one CPU.\n"
+        "\n"
         "    app runProc <appName> <procName> [options]\n"
         "       Runs a configured process inside an app using the process settings from the\n"
         "       configuration database.  If an exePath is provided as an option then the specified\n"
@@ -530,111 +575,159 @@ static void RestartLegato
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Prints the list of installed apps.
- *
- * Iterate over the list of apps and calls the specified printFunc for each app.  If the printFunc
- * is NULL then the name of the app is printed.
+ * Reads the snapshot of all installed apps from the Supervisor, in one request, into
+ * AppSnapshotList.  Does nothing if it has already been read.
  */
 //--------------------------------------------------------------------------------------------------
-static void ListInstalledApps
+static void LoadSnapshot
 (
-    PrintAppFunc_t printFunc            ///< [IN] Function to use for printing app information.
+    void
 )
 {
-    le_cfg_ConnectService();
-
-    if (printFunc != NULL)
+    if (IsSnapshotLoaded)
     {
-        le_appInfo_ConnectService();
+        return;
     }
 
-    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn("system:/apps");
+    le_appInfo_ConnectService();
 
-    if (le_cfg_GoToFirstChild(cfgIter) == LE_NOT_FOUND)
-    {
-        LE_DEBUG("There are no installed apps.");
-        exit(EXIT_SUCCESS);
-    }
+    int fd;
 
-    // Iterate over the list of apps.
-    do
-    {
-        char appName[LIMIT_MAX_APP_NAME_BYTES];
+    INTERNAL_ERR_IF(le_appInfo_GetSnapshot(&fd) != LE_OK, "Could not get the app snapshot.");
 
-        INTERNAL_ERR_IF(le_cfg_GetNodeName(cfgIter, "", appName, sizeof(appName)) != LE_OK,
-                        "Application name in config is too long.");
+    FILE* filePtr = fdopen(fd, "r");
 
-        if (printFunc == NULL)
+    INTERNAL_ERR_IF(filePtr == NULL, "Could not read the app snapshot.  %m.");
+
+    AppSnapshot_t* appPtr = NULL;
+    char line[LIMIT_MAX_PATH_BYTES];
+
+    while (fgets(line, sizeof(line), filePtr) != NULL)
+    {
+        char name[LIMIT_MAX_PATH_BYTES];
+        char state[16];
+        long long value;
+        unsigned int faultCount;
+        int pid;
+
+        if (sscanf(line, "app %s %15s %lld", name, state, &value) == 3)
         {
-            printf("%s\n", appName);
+            appPtr = le_mem_ForceAlloc(AppSnapshotPool);
+
+            INTERNAL_ERR_IF(le_utf8_Copy(appPtr->name, name, sizeof(appPtr->name), NULL) != LE_OK,
+                            "App name '%s' is too long.", name);
+            appPtr->isRunning = (strcmp(state, "running") == 0);
+            appPtr->memUsed = value;
+            appPtr->faultCount = 0;
+            appPtr->link = LE_SLS_LINK_INIT;
+
+            le_sls_Queue(&AppSnapshotList, &(appPtr->link));
         }
-        else
+        else if (   (appPtr != NULL)
+                 && (sscanf(line, "proc %s %d %15s %u", name, &pid, state, &faultCount) == 4))
         {
-            printFunc(appName);
+            appPtr->faultCount += faultCount;
         }
     }
-    while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+
+    fclose(filePtr);
+
+    IsSnapshotLoaded = true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks whether an installed application is running.
+ * Gets an installed app from the snapshot.
  *
  * @return
- *      true if running.
- *      false if stopped.
+ *      The app, or NULL if it is not installed.
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsAppRunning
+static const AppSnapshot_t* GetAppSnapshot
 (
-    const char* appNamePtr          ///< [IN] App name to get the state for.
+    const char* appNamePtr          ///< [IN] App name.
 )
 {
-    le_appInfo_State_t appState;
+    LoadSnapshot();
 
-    appState = le_appInfo_GetState(appNamePtr);
+    le_sls_Link_t* linkPtr = le_sls_Peek(&AppSnapshotList);
 
-    switch (appState)
+    while (linkPtr != NULL)
     {
-        case LE_APPINFO_STOPPED:
-            return false;
+        AppSnapshot_t* appPtr = CONTAINER_OF(linkPtr, AppSnapshot_t, link);
 
-        case LE_APPINFO_RUNNING:
-            return true;
+        if (strcmp(appPtr->name, appNamePtr) == 0)
+        {
+            return appPtr;
+        }
 
-        default:
-            INTERNAL_ERR("Supervisor returned an unknown state for app '%s'.", appNamePtr);
+        linkPtr = le_sls_PeekNext(&AppSnapshotList, linkPtr);
     }
+
+    return NULL;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Prints the application status.
+ * Prints the list of installed apps.
+ *
+ * Iterate over the list of apps and calls the specified printFunc for each app.  If the printFunc
+ * is NULL then the name of the app is printed.
  */
 //--------------------------------------------------------------------------------------------------
-static void PrintAppState
+static void ListInstalledApps
 (
-    const char* appNamePtr      ///< [IN] Application name to get the status for.
+    PrintAppFunc_t printFunc            ///< [IN] Function to use for printing app information.
 )
 {
-    le_appInfo_ConnectService();
-    le_cfg_ConnectService();
+    LoadSnapshot();
 
-    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn("system:/apps");
+    if (le_sls_IsEmpty(&AppSnapshotList))
+    {
+        LE_DEBUG("There are no installed apps.");
+        exit(EXIT_SUCCESS);
+    }
 
-    if (!le_cfg_NodeExists(cfgIter, appNamePtr))
+    // Iterate over the list of apps.
+    le_sls_Link_t* linkPtr = le_sls_Peek(&AppSnapshotList);
+
+    while (linkPtr != NULL)
     {
-        printf("[not installed] %s\n", appNamePtr);
+        const AppSnapshot_t* appPtr = CONTAINER_OF(linkPtr, AppSnapshot_t, link);
+
+        if (printFunc == NULL)
+        {
+            printf("%s\n", appPtr->name);
+        }
+        else
+        {
+            printFunc(appPtr);
+        }
+
+        linkPtr = le_sls_PeekNext(&AppSnapshotList, linkPtr);
     }
-    else if (IsAppRunning(appNamePtr))
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints an installed application's status.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintAppState
+(
+    const AppSnapshot_t* appPtr     ///< [IN] Application to print the status of.
+)
+{
+    if (appPtr->isRunning)
     {
-        printf("[running] %s\n", appNamePtr);
+        printf("[running] %s\n", appPtr->name);
     }
     else
     {
-        printf("[stopped] %s\n", appNamePtr);
+        printf("[stopped] %s\n", appPtr->name);
     }
 }
 
@@ -657,7 +750,16 @@ static void PrintStatus
     }
     else
     {
-        PrintAppState(AppNamePtr);
+        const AppSnapshot_t* appPtr = GetAppSnapshot(AppNamePtr);
+
+        if (appPtr == NULL)
+        {
+            printf("[not installed] %s\n", AppNamePtr);
+        }
+        else
+        {
+            PrintAppState(appPtr);
+        }
     }
 
     exit(EXIT_SUCCESS);
@@ -1125,24 +1227,31 @@ static void PrintAppProcs
  * Prints an installed application's info.
  */
 //--------------------------------------------------------------------------------------------------
-static void PrintInstalledAppInfo
+static void PrintAppInfo
 (
-    const char* appNamePtr
+    const AppSnapshot_t* appPtr     ///< [IN] Application to print the information for.
 )
 {
-    printf("%s\n", appNamePtr);
+    printf("%s\n", appPtr->name);
 
-    if (IsAppRunning(appNamePtr))
+    if (appPtr->isRunning)
     {
         printf("  status: running\n");
-        PrintAppProcs(appNamePtr, "  ");
+        PrintAppProcs(appPtr->name, "  ");
+
+        if (appPtr->memUsed >= 0)
+        {
+            printf("  memory used: %zd bytes\n", appPtr->memUsed);
+        }
     }
     else
     {
         printf("  status: stopped\n");
     }
 
-    PrintedAppInfoFile(appNamePtr, "  ");
+    printf("  faults: %" PRIu32 "\n", appPtr->faultCount);
+
+    PrintedAppInfoFile(appPtr->name, "  ");
 
     printf("\n");
 }
@@ -1150,51 +1259,52 @@ static void PrintInstalledAppInfo
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Prints the application information.
- */
+ * Implements the "info" command.
+ *
+ * @note This function does not return.
+ **/
 //--------------------------------------------------------------------------------------------------
-static void PrintAppInfo
+static void PrintInfo
 (
-    const char* appNamePtr      ///< [IN] Application name to get the information for.
+    void
 )
 {
-    le_appInfo_ConnectService();
-    le_cfg_ConnectService();
-
-    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn("system:/apps");
-
-    if (!le_cfg_NodeExists(cfgIter, appNamePtr))
+    if (AppNamePtr == NULL)
     {
-        printf("[not installed] %s\n", appNamePtr);
-        printf("\n");
+        ListInstalledApps(PrintAppInfo);
     }
     else
     {
-        PrintInstalledAppInfo(appNamePtr);
+        const AppSnapshot_t* appPtr = GetAppSnapshot(AppNamePtr);
+
+        if (appPtr == NULL)
+        {
+            printf("[not installed] %s\n", AppNamePtr);
+            printf("\n");
+        }
+        else
+        {
+            PrintAppInfo(appPtr);
+        }
     }
+
+    exit(EXIT_SUCCESS);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Implements the "info" command.
+ * Implements the "list" command.
  *
  * @note This function does not return.
  **/
 //--------------------------------------------------------------------------------------------------
-static void PrintInfo
+static void ListApps
 (
     void
 )
 {
-    if (AppNamePtr == NULL)
-    {
-        ListInstalledApps(PrintAppInfo);
-    }
-    else
-    {
-        PrintAppInfo(AppNamePtr);
-    }
+    ListInstalledApps(NULL);
 
     exit(EXIT_SUCCESS);
 }
@@ -1202,17 +1312,45 @@ static void PrintInfo
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Implements the "list" command.
+ * Implements the "usage" command.
  *
  * @note This function does not return.
  **/
 //--------------------------------------------------------------------------------------------------
-static void ListApps
+static void PrintUsage
 (
     void
 )
 {
-    ListInstalledApps(NULL);
+    le_appInfo_ConnectService();
+
+    uint32_t sampleTime[LE_APPINFO_MAX_USAGE_SAMPLES];
+    uint32_t cpuPermille[LE_APPINFO_MAX_USAGE_SAMPLES];
+    uint64_t memUsed[LE_APPINFO_MAX_USAGE_SAMPLES];
+    size_t sampleTimeNum = NUM_ARRAY_MEMBERS(sampleTime);
+    size_t cpuPermilleNum = NUM_ARRAY_MEMBERS(cpuPermille);
+    size_t memUsedNum = NUM_ARRAY_MEMBERS(memUsed);
+
+    if (le_appInfo_GetUsageHistory(AppNamePtr,
+                                   sampleTime, &sampleTimeNum,
+                                   cpuPermille, &cpuPermilleNum,
+                                   memUsed, &memUsedNum) != LE_OK)
+    {
+        printf("No usage samples for app '%s'.\n", AppNamePtr);
+        exit(EXIT_SUCCESS);
+    }
+
+    printf("%10s %7s %12s\n", "TIME(s)", "CPU(%)", "MEM(KB)");
+
+    size_t i;
+    for (i = 0; (i < sampleTimeNum) && (i < cpuPermilleNum) && (i < memUsedNum); i++)
+    {
+        printf("%10" PRIu32 " %5" PRIu32 ".%" PRIu32 " %12" PRIu64 "\n",
+               sampleTime[i],
+               cpuPermille[i] / 10,
+               cpuPermille[i] % 10,
+               memUsed[i] / 1024);
+    }
 
     exit(EXIT_SUCCESS);
 }
@@ -1860,6 +1998,12 @@ static void CommandArgHandler
 
         le_arg_AddPositionalCallback(AppNameArgHandler);
     }
+    else if (strcmp(command, "usage") == 0)
+    {
+        CommandFunc = PrintUsage;
+
+        le_arg_AddPositionalCallback(AppNameArgHandler);
+    }
     else if (strcmp(command, "info") == 0)
     {
         CommandFunc = PrintInfo;
@@ -1882,6 +2026,7 @@ COMPONENT_INIT
     ProcObjPool = le_mem_CreatePool("ProcObjPool", sizeof(ProcObj_t));
     ThreadObjPool = le_mem_CreatePool("ThreadObjPool", sizeof(ThreadObj_t));
     ProcNamePool = le_mem_CreatePool("ProcNamePool", sizeof(ProcName_t));
+    AppSnapshotPool = le_mem_CreatePool("AppSnapshotPool", sizeof(AppSnapshot_t));
 
     ProcObjMap = le_hashmap_Create("ProcsMap",
                                    EST_MAX_NUM_PROC,
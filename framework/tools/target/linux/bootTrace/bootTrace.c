@@ -0,0 +1,300 @@
+/** @file bootTrace.c
+ *
+ * Command line tool used to export the boot trace recorded by the framework as a Chrome trace,
+ * which can be viewed with chrome://tracing or Perfetto.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "bootTrace.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of distinct processes that are named in the exported trace.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_NAMED_PIDS              256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sizes of the buffers for the category and the name of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CATEGORY_BYTES              64
+#define NAME_BYTES                  128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints help to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintHelp
+(
+    void
+)
+{
+    puts(
+        "NAME:\n"
+        "    bootTrace - Exports the trace of the last start of the framework.\n"
+        "\n"
+        "DESCRIPTION:\n"
+        "    bootTrace export [FILE_PATH]\n"
+        "       Writes the boot trace as Chrome trace JSON to FILE_PATH, or to stdout if no\n"
+        "       FILE_PATH is given.  The trace has the start-up phases of the framework, each\n"
+        "       framework daemon, kernel module and auto-started app, and the time that each\n"
+        "       client spent blocked waiting for the service it is bound to.\n"
+        "\n"
+        );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a string to the trace as a JSON string.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteJsonString
+(
+    FILE* outPtr,               ///< [IN] Trace being written.
+    const char* strPtr          ///< [IN] String to write.
+)
+{
+    fputc('"', outPtr);
+
+    for (; *strPtr != '\0'; strPtr++)
+    {
+        if ((*strPtr == '"') || (*strPtr == '\\'))
+        {
+            fputc('\\', outPtr);
+            fputc(*strPtr, outPtr);
+        }
+        else if ((unsigned char)*strPtr < ' ')
+        {
+            fprintf(outPtr, "\\u%04x", (unsigned char)*strPtr);
+        }
+        else
+        {
+            fputc(*strPtr, outPtr);
+        }
+    }
+
+    fputc('"', outPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a metadata event to the trace naming a process, if the process is still running.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteProcessName
+(
+    FILE* outPtr,               ///< [IN] Trace being written.
+    int pid                     ///< [IN] The process.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    char name[LIMIT_MAX_PROCESS_NAME_BYTES] = "";
+
+    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+
+    FILE* commPtr = fopen(path, "r");
+
+    if (commPtr == NULL)
+    {
+        return;
+    }
+
+    if (fgets(name, sizeof(name), commPtr) != NULL)
+    {
+        name[strcspn(name, "\n")] = '\0';
+
+        fprintf(outPtr, ",\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":",
+                pid);
+        WriteJsonString(outPtr, name);
+        fputs("}}", outPtr);
+    }
+
+    fclose(commPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the next record from the boot trace.
+ *
+ * @return true if a record was read, false at the end of the trace.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadRecord
+(
+    FILE* inPtr,                ///< [IN] The boot trace.
+    int* pidPtr,                ///< [OUT] Process the record is for.
+    uint64_t* startTimePtr,     ///< [OUT] Start time, in microseconds.
+    uint64_t* durationPtr,      ///< [OUT] Duration, in microseconds.
+    char* categoryPtr,          ///< [OUT] Category, CATEGORY_BYTES long.
+    char* namePtr               ///< [OUT] Name, NAME_BYTES long.
+)
+{
+    char line[256];
+
+    while (fgets(line, sizeof(line), inPtr) != NULL)
+    {
+        // Skip any malformed records.
+        if (sscanf(line,
+                   "%d\t%" SCNu64 "\t%" SCNu64 "\t%63[^\t]\t%127[^\n]",
+                   pidPtr,
+                   startTimePtr,
+                   durationPtr,
+                   categoryPtr,
+                   namePtr) == 5)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exports the boot trace.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExportTrace
+(
+    void
+)
+{
+    FILE* inPtr = fopen(BOOT_TRACE_FILE, "r");
+
+    if (inPtr == NULL)
+    {
+        fprintf(stderr, "Could not open the boot trace, '%s'.  %m.\n", BOOT_TRACE_FILE);
+        exit(EXIT_FAILURE);
+    }
+
+    const char* outPathPtr = le_arg_GetArg(1);
+    FILE* outPtr = stdout;
+
+    if (outPathPtr != NULL)
+    {
+        outPtr = fopen(outPathPtr, "w");
+
+        if (outPtr == NULL)
+        {
+            fprintf(stderr, "Could not create '%s'.  %m.\n", outPathPtr);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int pids[MAX_NAMED_PIDS];
+    size_t pidCount = 0;
+    bool isFirst = true;
+    int pid;
+    uint64_t startTime;
+    uint64_t duration;
+    char category[CATEGORY_BYTES];
+    char name[NAME_BYTES];
+
+    // Times are shown from the earliest step.  Steps are recorded when they finish, so that isn't
+    // necessarily the first record.
+    uint64_t baseTime = UINT64_MAX;
+
+    while (ReadRecord(inPtr, &pid, &startTime, &duration, category, name))
+    {
+        if (startTime < baseTime)
+        {
+            baseTime = startTime;
+        }
+    }
+
+    rewind(inPtr);
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", outPtr);
+
+    while (ReadRecord(inPtr, &pid, &startTime, &duration, category, name))
+    {
+        fprintf(outPtr,
+                "%s\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64
+                    ",\"cat\":",
+                isFirst ? "" : ",",
+                pid,
+                pid,
+                startTime - baseTime,
+                duration);
+        WriteJsonString(outPtr, category);
+        fputs(",\"name\":", outPtr);
+        WriteJsonString(outPtr, name);
+        fputc('}', outPtr);
+
+        isFirst = false;
+
+        size_t i;
+
+        for (i = 0; (i < pidCount) && (pids[i] != pid); i++)
+        {
+        }
+
+        if ((i == pidCount) && (pidCount < MAX_NAMED_PIDS))
+        {
+            pids[pidCount++] = pid;
+        }
+    }
+
+    fclose(inPtr);
+
+    if (isFirst == false)
+    {
+        for (size_t i = 0; i < pidCount; i++)
+        {
+            WriteProcessName(outPtr, pids[i]);
+        }
+    }
+
+    fputs("\n]}\n", outPtr);
+
+    if ((outPtr != stdout) && (fclose(outPtr) != 0))
+    {
+        fprintf(stderr, "Could not write '%s'.  %m.\n", outPathPtr);
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    const char* cmdPtr = le_arg_GetArg(0);
+
+    if (cmdPtr == NULL)
+    {
+        fprintf(stderr, "Please specify a command.\n");
+
+        PrintHelp();
+        exit(EXIT_FAILURE);
+    }
+
+    if (strcmp(cmdPtr, "export") == 0)
+    {
+        ExportTrace();
+    }
+    else if ((strcmp(cmdPtr, "help") == 0) || (strcmp(cmdPtr, "--help") == 0))
+    {
+        PrintHelp();
+    }
+    else
+    {
+        fprintf(stderr, "Unknown command.\n");
+
+        PrintHelp();
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -312,62 +312,269 @@ static json_t* CreateJsonNodeFromIterator
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Dump tree data to a JSON object.  This function will start at the iterator's current location
- *  extract all tree data from there and insert it into the given JSON object.
+ *  Read a token of the configTree's native text format from a stream.  For value tokens, the text
+ *  of the value is copied, unescaped, into the given buffer.
+ *
+ *  @return The character that introduced the token, ('~', '!', '[', '(', '"', '{' or '}',) or EOF
+ *          if the end of the stream was hit or the token could not be read.
  */
 // -------------------------------------------------------------------------------------------------
-static void DumpTreeJSON
+static int ReadNativeToken
 (
-    le_cfg_IteratorRef_t iterRef,  ///< Read the tree data from this iterator.
-    json_t* jsonObject             ///< JSON object to hold the tree data.
+    FILE* filePtr,     ///< Stream to read the token from.
+    char* bufferPtr,   ///< Buffer to hold the value of the token.
+    size_t bufferSize  ///< Size of the buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int next;
+
+    do
+    {
+        next = fgetc(filePtr);
+    }
+    while (isspace(next));
+
+    int terminal;
+
+    switch (next)
+    {
+        case '!':
+            bufferPtr[0] = fgetc(filePtr);
+            bufferPtr[1] = 0;
+            return next;
+
+        case '[':
+            terminal = ']';
+            break;
+
+        case '(':
+            terminal = ')';
+            break;
+
+        case '\"':
+            terminal = '\"';
+            break;
+
+        case '~':
+        case '{':
+        case '}':
+            return next;
+
+        default:
+            return EOF;
+    }
+
+    size_t count = 0;
+    int c;
+
+    while ((c = fgetc(filePtr)) != terminal)
+    {
+        if (c == '\\')
+        {
+            c = fgetc(filePtr);
+        }
+
+        if ((c == EOF) || (count >= (bufferSize - 1)))
+        {
+            return EOF;
+        }
+
+        bufferPtr[count++] = c;
+    }
+
+    bufferPtr[count] = 0;
+
+    return next;
+}
+
+
+
+
+static json_t* ReadNativeChildren(FILE* filePtr);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value in the configTree's native text format and create a JSON node for it.
+ *
+ *  @return A new JSON node object, or NULL if the data could not be parsed.
+ */
+// -------------------------------------------------------------------------------------------------
+static json_t* ReadNativeNode
+(
+    FILE* filePtr,       ///< Stream to read the node value from.
+    const char* namePtr  ///< Name to give the node.
 )
 // -------------------------------------------------------------------------------------------------
 {
     // Note that because this is a recursive function, the buffer here is static in order to save on
-    // stack space.  The implication here is that we then have to be careful how it is later
-    // accessed.  Also, this makes the function not thread safe.  But this trade off was made as
-    // this was not intended to be a multi-threaded program.
+    // stack space.  The name is copied into the node before recursing, so the buffer is free to be
+    // reused by then.
     static char strBuffer[LE_CFG_STR_LEN_BYTES] = "";
 
-    // Build up the child array.
+    int token = ReadNativeToken(filePtr, strBuffer, sizeof(strBuffer));
+    json_t* nodePtr = NULL;
+    json_t* valuePtr = NULL;
+
+    switch (token)
+    {
+        case '~':
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_STEM));
+            valuePtr = json_array();
+            json_object_set_new(nodePtr, JSON_FIELD_CHILDREN, valuePtr);
+            return nodePtr;
+
+        case '!':
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_BOOL));
+            valuePtr = json_boolean(strBuffer[0] == 't');
+            break;
+
+        case '[':
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_INT));
+            valuePtr = json_integer(strtoll(strBuffer, NULL, 10));
+            break;
+
+        case '(':
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_FLOAT));
+            valuePtr = json_real(strtod(strBuffer, NULL));
+            break;
+
+        case '\"':
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_STRING));
+            valuePtr = json_string(strBuffer);
+            break;
+
+        case '{':
+            valuePtr = ReadNativeChildren(filePtr);
+            if (valuePtr == NULL)
+            {
+                return NULL;
+            }
+
+            nodePtr = CreateJsonNode(namePtr, NodeTypeStr(LE_CFG_TYPE_STEM));
+            json_object_set_new(nodePtr, JSON_FIELD_CHILDREN, valuePtr);
+            return nodePtr;
+
+        default:
+            return NULL;
+    }
+
+    json_object_set_new(nodePtr, JSON_FIELD_VALUE, valuePtr);
+
+    return nodePtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read the children of a stem in the configTree's native text format, up to and including the
+ *  closing '}'.  The opening '{' must already have been read.
+ *
+ *  @return A new JSON array of the child nodes, or NULL if the data could not be parsed.
+ */
+// -------------------------------------------------------------------------------------------------
+static json_t* ReadNativeChildren
+(
+    FILE* filePtr  ///< Stream to read the children from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Static for the same reason as in ReadNativeNode.  The name is consumed before the recursive
+    // call can overwrite it.
+    static char nameBuffer[LE_CFG_NAME_LEN_BYTES] = "";
+
     json_t* childArrayPtr = json_array();
+    int token;
 
-    do
+    while ((token = ReadNativeToken(filePtr, nameBuffer, sizeof(nameBuffer))) == '\"')
     {
-        // Simply grab the name and the type of the current node.
-        le_cfg_GetNodeName(iterRef, "", strBuffer, sizeof(strBuffer));
-        le_cfg_nodeType_t type = le_cfg_GetNodeType(iterRef, "");
+        json_t* childPtr = ReadNativeNode(filePtr, nameBuffer);
 
-        switch (type)
+        if (childPtr == NULL)
         {
-            // It's a stem object, so mark this item as being a stem and recurse into the stem's
-            // sub-items.
-            case LE_CFG_TYPE_STEM:
-                {
-                    json_t* nodePtr = CreateJsonNode(strBuffer, NodeTypeStr(type));
+            json_decref(childArrayPtr);
+            return NULL;
+        }
 
-                    le_cfg_GoToFirstChild(iterRef);
-                    DumpTreeJSON(iterRef, nodePtr);
-                    le_cfg_GoToParent(iterRef);
-                    json_array_append(childArrayPtr, nodePtr);
-                }
-                break;
+        json_array_append_new(childArrayPtr, childPtr);
+    }
 
-            default:
-                {
-                    json_t* nodePtr = CreateJsonNodeFromIterator(iterRef);
-                    if (nodePtr != NULL)
-                    {
-                        json_array_append(childArrayPtr, nodePtr);
-                    }
-                }
-                break;
+    if (token != '}')
+    {
+        json_decref(childArrayPtr);
+        return NULL;
+    }
+
+    return childArrayPtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Dump tree data to a JSON object.  The whole sub-tree at the iterator's current location is
+ *  fetched from the configTree in one request, in its native format, and converted to JSON here.
+ *  This is much faster than walking the tree one node at a time.
+ *
+ *  @return LE_OK if successful, LE_FAULT otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t DumpTreeJSON
+(
+    le_cfg_IteratorRef_t iterRef,  ///< Read the tree data from this iterator.
+    json_t* jsonObject             ///< JSON object to hold the tree data.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    FILE* filePtr = tmpfile();
+
+    if (filePtr == NULL)
+    {
+        fprintf(stderr, "Failed to create temporary file: %s\n", strerror(errno));
+        return LE_FAULT;
+    }
+
+    // The descriptor is closed once it has been sent, so send a copy.
+    int fd = dup(fileno(filePtr));
+    le_result_t result = LE_FAULT;
+
+    if (   (fd != -1)
+        && (le_cfgAdmin_ExportTreeToFd(iterRef, fd, "") == LE_OK))
+    {
+        rewind(filePtr);
+
+        char tokenBuffer[2];
+        json_t* childArrayPtr = NULL;
+
+        if (ReadNativeToken(filePtr, tokenBuffer, sizeof(tokenBuffer)) == '{')
+        {
+            childArrayPtr = ReadNativeChildren(filePtr);
+        }
+        else
+        {
+            childArrayPtr = json_array();
+        }
+
+        if (childArrayPtr != NULL)
+        {
+            json_object_set_new(jsonObject, JSON_FIELD_CHILDREN, childArrayPtr);
+            result = LE_OK;
+        }
+        else
+        {
+            fprintf(stderr, "Unexpected data received from the configTree.\n");
         }
     }
-    while (le_cfg_GoToNextSibling(iterRef) == LE_OK);
 
-    // Set children into the JSON document.
-    json_object_set_new(jsonObject, JSON_FIELD_CHILDREN, childArrayPtr);
+    fclose(filePtr);
+
+    return result;
 }
 
 
@@ -610,6 +817,7 @@ static int HandleGetJSON
 {
     json_t* nodePtr = NULL;
     char *json_dumps_result;
+    int result = EXIT_SUCCESS;
 
     // Get the node path from our command line arguments.
     if (strcmp("*", nodePathPtr) == 0)
@@ -636,12 +844,14 @@ static int HandleGetJSON
             json_t* treeNodePtr = CreateJsonNode(treeName, "tree");
             strcat(treeName, ":/");
 
-            // Start a read transaction at the specified node path.  Then dump the value, (if any.)
+            // Start a read transaction at the root of the tree.  Then dump the value, (if any.)
             le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(treeName);
-            le_cfg_GoToFirstChild(iterRef);
 
             // Dump tree to JSON
-            DumpTreeJSON(iterRef, treeNodePtr);
+            if (DumpTreeJSON(iterRef, treeNodePtr) != LE_OK)
+            {
+                json_object_set_new(treeNodePtr, JSON_FIELD_CHILDREN, json_array());
+            }
             le_cfg_CancelTxn(iterRef);
 
             json_array_append(treeListPtr, treeNodePtr);
@@ -677,9 +887,13 @@ static int HandleGetJSON
                     }
 
                     nodePtr = CreateJsonNode(strBuffer, nodeType);
-                    le_cfg_GoToFirstChild(iterRef);
-                    DumpTreeJSON(iterRef, nodePtr);
-                    le_cfg_GoToParent(iterRef);
+                    if (DumpTreeJSON(iterRef, nodePtr) != LE_OK)
+                    {
+                        json_decref(nodePtr);
+                        le_cfg_CancelTxn(iterRef);
+
+                        return EXIT_FAILURE;
+                    }
                 }
                 break;
 
@@ -700,8 +914,6 @@ static int HandleGetJSON
     // Dump Json content
     // stdout mode?
 
-    int result = EXIT_SUCCESS;
-
     if (filePathPtr == NULL)
     {
         json_dumps_result = json_dumps(nodePtr, JSON_COMPACT);
@@ -730,95 +942,114 @@ static int HandleGetJSON
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Function that handles the actual import of JSON data into the configTree.
- *
- *  @return LE_OK if the import is successful, LE_FAULT otherwise.
+ *  Write a string in the configTree's native text format, escaping as needed.
+ */
+// -------------------------------------------------------------------------------------------------
+static void WriteNativeString
+(
+    FILE* filePtr,         ///< Stream to write to.
+    char startChar,        ///< Opening delimiter.
+    char endChar,          ///< Closing delimiter.
+    const char* stringPtr  ///< String to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    fputc(startChar, filePtr);
+
+    for (; *stringPtr != 0; stringPtr++)
+    {
+        if ((*stringPtr == '\"') || (*stringPtr == '\\'))
+        {
+            fputc('\\', filePtr);
+        }
+
+        fputc(*stringPtr, filePtr);
+    }
+
+    fputc(endChar, filePtr);
+    fputc(' ', filePtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Convert a JSON node to the configTree's native text format, so that it can be imported in one
+ *  request.  Only the node's value is written, its name is written by the caller.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t HandleImportJSONIteration
+static void WriteNativeValue
 (
-    le_cfg_IteratorRef_t iterRef,  ///< Dump the JSON data into this iterator.
-    json_t* nodePtr                ///< From this JSON object.
+    FILE* filePtr,   ///< Stream to write the converted data to.
+    json_t* nodePtr  ///< JSON object to convert.
 )
 // -------------------------------------------------------------------------------------------------
 {
     // Get value
     json_t* value = json_object_get(nodePtr, JSON_FIELD_VALUE);
 
-    // Check type
+    // Check type.  A whole tree, as written by export, is imported like a stem.
     const char* typeStr = json_string_value(json_object_get(nodePtr, JSON_FIELD_TYPE));
-    le_cfg_nodeType_t type = GetNodeTypeFromString(typeStr);
+    le_cfg_nodeType_t type = LE_CFG_TYPE_STEM;
+
+    if ((typeStr == NULL) || (strcmp(typeStr, "tree") != 0))
+    {
+        type = GetNodeTypeFromString(typeStr != NULL ? typeStr : "");
+    }
 
     switch (type)
     {
         case LE_CFG_TYPE_BOOL:
-            le_cfg_SetBool(iterRef, "", json_is_true(value));
+            fputs(json_is_true(value) ? "!t " : "!f ", filePtr);
             break;
 
         case LE_CFG_TYPE_STRING:
-            le_cfg_SetString(iterRef, "", json_string_value(value));
+            {
+                const char* strPtr = json_string_value(value);
+                WriteNativeString(filePtr, '\"', '\"', (strPtr != NULL) ? strPtr : "");
+            }
             break;
 
         case LE_CFG_TYPE_INT:
-            le_cfg_SetInt(iterRef, "", json_integer_value(value));
+            fprintf(filePtr, "[%" PRId32 "] ", (int32_t)json_integer_value(value));
             break;
 
         case LE_CFG_TYPE_FLOAT:
-            le_cfg_SetFloat(iterRef, "", json_real_value(value));
+            fprintf(filePtr, "(%f) ", json_real_value(value));
             break;
 
         case LE_CFG_TYPE_STEM:
             {
-                // Iterate on children
                 json_t* childrenPtr = json_object_get(nodePtr, JSON_FIELD_CHILDREN);
                 json_t* childPtr;
-                int i;
+                size_t i;
+
+                if (json_array_size(childrenPtr) == 0)
+                {
+                    fputs("~ ", filePtr);
+                    break;
+                }
+
+                fputs("{ ", filePtr);
 
                 json_array_foreach(childrenPtr, i, childPtr)
                 {
-                    // Get name
                     const char* name = json_string_value(json_object_get(childPtr,
                                                                          JSON_FIELD_NAME));
 
-                    // Is node exist with this name?
-                    le_cfg_nodeType_t existingType = le_cfg_GetNodeType(iterRef, name);
-                    switch (existingType)
-                    {
-                        case LE_CFG_TYPE_DOESNT_EXIST:
-                        case LE_CFG_TYPE_STEM:
-                        case LE_CFG_TYPE_EMPTY:
-                            // Not existing, already a stem or empty node, nothing to do
-                        break;
-
-                        default:
-                            // Issue with node creation
-                            fprintf(stderr, "Node conflict when importing, at node %s", name);
-                            return LE_NOT_POSSIBLE;
-                        break;
-                    }
-
-                    // Iterate to this child
-                    le_cfg_GoToNode(iterRef, name);
-
-                    // Iterate
-                    le_result_t subResult = HandleImportJSONIteration(iterRef, childPtr);
-                    if (subResult != LE_OK)
-                    {
-                        // Something went wrong
-                        return subResult;
-                    }
-
-                    // Go back to parent
-                    le_cfg_GoToParent(iterRef);
+                    WriteNativeString(filePtr, '\"', '\"', (name != NULL) ? name : "");
+                    WriteNativeValue(filePtr, childPtr);
                 }
+
+                fputs("} ", filePtr);
             }
             break;
 
         default:
-            return LE_FAULT;
+            fputs("~ ", filePtr);
+            break;
     }
-
-    return LE_OK;
 }
 
 
@@ -827,9 +1058,10 @@ static le_result_t HandleImportJSONIteration
 // -------------------------------------------------------------------------------------------------
 /**
  *  Load a JSON representation of some config data and import it into the configTree at the
- *  iterator's starting location.
+ *  iterator's starting location.  As with the native format, the imported data replaces the node.
  *
- *  @return LE_OK if the import is successful.  LE_FAULT otherwise.
+ *  @return LE_OK if the import is successful.  LE_FORMAT_ERROR if the configTree rejected the data.
+ *          LE_FAULT otherwise.
  */
 // -------------------------------------------------------------------------------------------------
 static le_result_t HandleImportJSON
@@ -856,11 +1088,38 @@ static le_result_t HandleImportJSON
         return LE_FAULT;
     }
 
-    // OK, looks like the JSON loaded, so iterate through it and dump it's contents into the
-    // configTree.
-    le_result_t result = HandleImportJSONIteration(iterRef, decodedRootPtr);
+    // OK, looks like the JSON loaded, so convert it to the configTree's native format and import
+    // it in one go.
+    FILE* filePtr = tmpfile();
+
+    if (filePtr == NULL)
+    {
+        fprintf(stderr, "Failed to create temporary file: %s\n", strerror(errno));
+        json_decref(decodedRootPtr);
+
+        return LE_FAULT;
+    }
+
+    WriteNativeValue(filePtr, decodedRootPtr);
     json_decref(decodedRootPtr);
 
+    le_result_t result = LE_FAULT;
+
+    if ((fflush(filePtr) == 0) && (ferror(filePtr) == 0))
+    {
+        rewind(filePtr);
+
+        // The descriptor is closed once it has been sent, so send a copy.
+        int fd = dup(fileno(filePtr));
+
+        if (fd != -1)
+        {
+            result = le_cfgAdmin_ImportTreeFromFd(iterRef, fd, "");
+        }
+    }
+
+    fclose(filePtr);
+
     return result;
 }
 
@@ -1174,7 +1433,17 @@ static int HandleImport
     }
     else
     {
-        result = le_cfgAdmin_ImportTree(iterRef, FilePath, "");
+        // Open the file here and hand it over, so the tree is read in a single request.
+        int fd = open(FilePath, O_RDONLY);
+
+        if (fd == -1)
+        {
+            result = LE_FAULT;
+        }
+        else
+        {
+            result = le_cfgAdmin_ImportTreeFromFd(iterRef, fd, "");
+        }
     }
 
     if (result != LE_OK)
@@ -1214,9 +1483,18 @@ static int HandleExport
     }
     else
     {
-        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
-        result = le_cfgAdmin_ExportTree(iterRef, FilePath, "");
-        le_cfg_CancelTxn(iterRef);
+        int fd = open(FilePath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+
+        if (fd == -1)
+        {
+            result = LE_FAULT;
+        }
+        else
+        {
+            le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
+            result = le_cfgAdmin_ExportTreeToFd(iterRef, fd, "");
+            le_cfg_CancelTxn(iterRef);
+        }
     }
 
     if (result != LE_OK)
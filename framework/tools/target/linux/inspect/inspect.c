@@ -22,12 +22,14 @@
 #include "addr.h"
 #include "fileDescriptor.h"
 #include "timer.h"
+#include "fdMonitor.h"
+#include "threadPool.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Objects of these types are used to refer to lists of memory pools, thread objects, timers,
- * mutexes, semaphores, and service objects. They can be used to iterate over those lists in a
- * remote process.
+ * mutexes, semaphores, thread pools, and service objects. They can be used to iterate over those
+ * lists in a remote process.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct MemPoolIter*         MemPoolIter_Ref_t;
@@ -36,10 +38,12 @@ typedef struct TimerIter*           TimerIter_Ref_t;
 typedef struct MutexIter*           MutexIter_Ref_t;
 typedef struct SemaphoreIter*       SemaphoreIter_Ref_t;
 typedef struct ThreadMemberObjIter* ThreadMemberObjIter_Ref_t;
+typedef struct HandlerIter*         HandlerIter_Ref_t;
 typedef struct ServiceObjIter*      ServiceObjIter_Ref_t;
 typedef struct ClientObjIter*       ClientObjIter_Ref_t;
 typedef struct SessionObjIter*      SessionObjIter_Ref_t;
 typedef struct InterfaceObjIter*    InterfaceObjIter_Ref_t;
+typedef struct ThreadPoolIter*      ThreadPoolIter_Ref_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -54,6 +58,8 @@ typedef enum
     INSPECT_INSP_TYPE_TIMER,
     INSPECT_INSP_TYPE_MUTEX,
     INSPECT_INSP_TYPE_SEMAPHORE,
+    INSPECT_INSP_TYPE_HANDLERS,
+    INSPECT_INSP_TYPE_THREAD_POOL,
     INSPECT_INSP_TYPE_IPC_SERVERS,
     INSPECT_INSP_TYPE_IPC_CLIENTS,
     INSPECT_INSP_TYPE_IPC_SERVERS_SESSIONS,
@@ -85,11 +91,37 @@ typedef struct
 {
     le_dls_List_t* bucketsPtr;  ///< Array of buckets in the hashmap in the remote process.
     size_t bucketCount;         ///< Size of the array of buckets.
+    le_dls_List_t* oldBucketsPtr; ///< Array of buckets still being rehashed, or NULL if none.
+    size_t oldBucketCount;      ///< Size of the array of old buckets.
     size_t* mapChgCntRef;       ///< Change counter for the remote map.
 }
 RemoteHashmapAccess_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the remote address of a bucket in a remote hashmap.  If the hashmap is part-way through a
+ * rehash, the old buckets come before the new ones.
+ *
+ * @return
+ *      The address of the bucket in the remote process.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t* GetRemoteBucketPtr
+(
+    RemoteHashmapAccess_t* mapPtr,  ///< [IN] The remote hashmap.
+    size_t index                    ///< [IN] Index of the bucket, counting old buckets first.
+)
+{
+    if (index < mapPtr->oldBucketCount)
+    {
+        return mapPtr->oldBucketsPtr + index;
+    }
+
+    return mapPtr->bucketsPtr + (index - mapPtr->oldBucketCount);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Iterator objects for stepping through the list of memory pools, thread objects, timers, mutexes,
@@ -147,6 +179,20 @@ typedef struct ThreadMemberObjIter
 }
 ThreadMemberObjIter_t;
 
+typedef struct HandlerIter
+{
+    RemoteListAccess_t threadObjList;
+    RemoteListAccess_t handlerList;   ///< Event handler list for the current thread in the remote
+                                      ///< process.
+    RemoteListAccess_t fdMonitorList; ///< FD Monitor list for the current thread in the remote
+                                      ///< process.
+    thread_Obj_t currThreadObj;
+    bool isFdMonitor;                 ///< true = the current handler is an FD Monitor's handler.
+    Handler_t currHandler;            ///< Current event handler from the list.
+    FdMonitor_t currFdMonitor;        ///< Current FD Monitor from the list.
+}
+HandlerIter_t;
+
 typedef struct ServiceObjIter
 {
     RemoteHashmapAccess_t serviceObjMap; ///< Service object map in the remote process.
@@ -198,6 +244,13 @@ typedef struct InterfaceObjIter
 }
 InterfaceObjIter_t;
 
+typedef struct ThreadPoolIter
+{
+    RemoteListAccess_t threadPoolList; ///< Thread pool list in the remote process.
+    ThreadPool_t currThreadPool;       ///< Current thread pool from the list.
+}
+ThreadPoolIter_t;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -297,6 +350,47 @@ static bool IsFollowing = false;
 static bool IsVerbose = false;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * true = show the allocation and lock wait rates of memory pools.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsRateShown = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time over which the rates are measured when not following, in seconds.  When following, the
+ * rates are measured over the refresh interval.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_RATE_WINDOW                 1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counters of a memory pool seen by the previous inspection, to compute rates from.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_COMPONENT_NAME_LEN + 1 + LIMIT_MAX_MEM_POOL_NAME_BYTES]; ///< Pool name.
+    uint64_t numAllocs;         ///< Number of allocations.
+    uint64_t numLockWaits;      ///< Number of lock waits.
+    uint64_t statsPeriodMs;     ///< Time covered by the counters.
+}
+PoolSample_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool samples, by pool name, and the pool they are allocated from.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t PoolSampleMap = NULL;
+static le_mem_PoolRef_t PoolSamplePool = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Flags indicating how an inspection ended.
@@ -638,6 +732,71 @@ static SemaphoreIter_Ref_t CreateSemaphoreIter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over the event handlers and FD Monitors of all
+ * threads of a specific process.
+ * See the comment block for CreateMemPoolIter for additional detail.
+ *
+ * @return
+ *      An iterator to the handlers for the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static HandlerIter_Ref_t CreateHandlerIter
+(
+    void
+)
+{
+    // Get the address offsets of the list of thread objs, and of the change counters of the lists
+    // to walk, for the process to inspect.
+    off_t threadObjListAddrOffset = GetRemoteAddress(PidToInspect, thread_GetThreadObjList());
+    off_t threadObjListChgCntAddrOffset = GetRemoteAddress(PidToInspect,
+                                                           thread_GetThreadObjListChgCntRef());
+    off_t handlerListChgCntAddrOffset = GetRemoteAddress(PidToInspect,
+                                                         event_GetHandlerListChgCntRef());
+    off_t fdMonitorListChgCntAddrOffset = GetRemoteAddress(PidToInspect,
+                                                           fdMon_GetFdMonitorListChgCntRef());
+
+    // Create the iterator.
+    HandlerIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    InitRemoteListAccessObj(&iteratorPtr->threadObjList);
+    InitRemoteListAccessObj(&iteratorPtr->handlerList);
+    InitRemoteListAccessObj(&iteratorPtr->fdMonitorList);
+    iteratorPtr->isFdMonitor = true;
+
+    // Get the list of thread objs for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, threadObjListAddrOffset, &(iteratorPtr->threadObjList.List),
+                          sizeof(iteratorPtr->threadObjList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread obj list"));
+    }
+
+    // Get the change counter refs for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, threadObjListChgCntAddrOffset,
+                          &(iteratorPtr->threadObjList.ListChgCntRef),
+                          sizeof(iteratorPtr->threadObjList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter ref"));
+    }
+
+    if (fd_ReadFromOffset(FdProcMem, handlerListChgCntAddrOffset,
+                          &(iteratorPtr->handlerList.ListChgCntRef),
+                          sizeof(iteratorPtr->handlerList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("handler list change counter ref"));
+    }
+
+    if (fd_ReadFromOffset(FdProcMem, fdMonitorListChgCntAddrOffset,
+                          &(iteratorPtr->fdMonitorList.ListChgCntRef),
+                          sizeof(iteratorPtr->fdMonitorList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("FD Monitor list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an iterator that can be used to iterate over the map of interface objects. See the
@@ -710,6 +869,8 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
 
     iteratorPtr->interfaceObjMap.bucketsPtr = map.bucketsPtr;
     iteratorPtr->interfaceObjMap.bucketCount = map.bucketCount;
+    iteratorPtr->interfaceObjMap.oldBucketsPtr = map.oldBucketsPtr;
+    iteratorPtr->interfaceObjMap.oldBucketCount = map.oldBucketCount;
 
     // Get the mapChgCntRef for the process-under-inspection.
     if (fd_ReadFromOffset(FdProcMem, mapChgCntAddrOffset,
@@ -723,7 +884,8 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
     iteratorPtr->currIndex = 0;
 
     // Get the list of interface objects.
-    if (fd_ReadFromOffset(FdProcMem, (ssize_t)iteratorPtr->interfaceObjMap.bucketsPtr,
+    if (fd_ReadFromOffset(FdProcMem,
+                          (ssize_t)GetRemoteBucketPtr(&iteratorPtr->interfaceObjMap, 0),
                           &(iteratorPtr->interfaceObjList.List),
                           sizeof(iteratorPtr->interfaceObjList.List)) != LE_OK)
     {
@@ -813,6 +975,50 @@ static SessionObjIter_Ref_t CreateSessionObjIter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over the list of thread pools for a specific
+ * process. See the comment block for CreateMemPoolIter for additional detail.
+ *
+ * @return
+ *      An iterator to the list of thread pools for the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static ThreadPoolIter_Ref_t CreateThreadPoolIter
+(
+    void
+)
+{
+    // Get the address offset of the thread pool list for the process to inspect.
+    off_t listAddrOffset = GetRemoteAddress(PidToInspect, threadPool_GetPoolList());
+
+    // Get the address offset of the thread pool list change counter for the process to inspect.
+    off_t listChgCntAddrOffset = GetRemoteAddress(PidToInspect,
+                                                  threadPool_GetPoolListChgCntRef());
+
+    // Create the iterator.
+    ThreadPoolIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    InitRemoteListAccessObj(&iteratorPtr->threadPoolList);
+
+    // Get the List for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listAddrOffset, &(iteratorPtr->threadPoolList.List),
+                             sizeof(iteratorPtr->threadPoolList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread pool list"));
+    }
+
+    // Get the ListChgCntRef for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
+                          &(iteratorPtr->threadPoolList.ListChgCntRef),
+                          sizeof(iteratorPtr->threadPoolList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread pool list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the memory pool list change counter from the specified iterator.
@@ -895,6 +1101,43 @@ static size_t GetThreadMemberObjListChgCnt
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the counter of the remote lists walked by a handler iterator.  The counter is the sum of the
+ * change counters of the thread obj list, the event handler lists and the FD Monitor lists.
+ *
+ * @return
+ *      The counter of the remote lists.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetHandlerListChgCnt
+(
+    HandlerIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t threadObjListChgCnt, handlerListChgCnt, fdMonitorListChgCnt;
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->threadObjList.ListChgCntRef),
+                          &threadObjListChgCnt, sizeof(threadObjListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread obj list change counter"));
+    }
+
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->handlerList.ListChgCntRef),
+                          &handlerListChgCnt, sizeof(handlerListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("handler list change counter"));
+    }
+
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->fdMonitorList.ListChgCntRef),
+                          &fdMonitorListChgCnt, sizeof(fdMonitorListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("FD Monitor list change counter"));
+    }
+
+    return (threadObjListChgCnt + handlerListChgCnt + fdMonitorListChgCnt);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the interface object map change counter from the specified iterator.
@@ -944,6 +1187,30 @@ static size_t GetSessionListChgCnt
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the thread pool list change counter from the specified iterator.
+ *
+ * @return
+ *      List change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetThreadPoolListChgCnt
+(
+    ThreadPoolIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t threadPoolListChgCnt;
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->threadPoolList.ListChgCntRef),
+                          &threadPoolListChgCnt, sizeof(threadPoolListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread pool list change counter"));
+    }
+
+    return threadPoolListChgCnt;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the next link of the provided link. This is for accessing a list in a remote process,
@@ -1339,6 +1606,90 @@ static Semaphore_t* GetNextSemaphore
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next handler from the specified iterator.  The event handlers of a thread are returned
+ * first, then its FD Monitors, then those of the next thread.  The handler read is in the
+ * iterator's currHandler or currFdMonitor, depending on isFdMonitor.
+ *
+ * @return
+ *      The iterator, or NULL when the handlers of all thread objects have been iterated.
+ */
+//--------------------------------------------------------------------------------------------------
+static HandlerIter_t* GetNextHandler
+(
+    HandlerIter_Ref_t handlerIterRef ///< [IN] The iterator to get the next handler from.
+)
+{
+    le_dls_Link_t* remLinkPtr;
+
+    while (true)
+    {
+        if (!handlerIterRef->isFdMonitor)
+        {
+            remLinkPtr = GetNextLink(&(handlerIterRef->handlerList),
+                                     &(handlerIterRef->currHandler.threadLink));
+            if (remLinkPtr != NULL)
+            {
+                Handler_t* remHandlerPtr = CONTAINER_OF(remLinkPtr, Handler_t, threadLink);
+
+                if (fd_ReadFromOffset(FdProcMem, (ssize_t)remHandlerPtr,
+                                      &(handlerIterRef->currHandler),
+                                      sizeof(handlerIterRef->currHandler)) != LE_OK)
+                {
+                    INTERNAL_ERR(REMOTE_READ_ERR("event handler object"));
+                }
+
+                return handlerIterRef;
+            }
+
+            // No more event handlers for this thread; move on to its FD Monitors.
+            handlerIterRef->isFdMonitor = true;
+        }
+
+        remLinkPtr = GetNextLink(&(handlerIterRef->fdMonitorList),
+                                 &(handlerIterRef->currFdMonitor.link));
+        if (remLinkPtr != NULL)
+        {
+            FdMonitor_t* remFdMonitorPtr = CONTAINER_OF(remLinkPtr, FdMonitor_t, link);
+
+            if (fd_ReadFromOffset(FdProcMem, (ssize_t)remFdMonitorPtr,
+                                  &(handlerIterRef->currFdMonitor),
+                                  sizeof(handlerIterRef->currFdMonitor)) != LE_OK)
+            {
+                INTERNAL_ERR(REMOTE_READ_ERR("FD Monitor object"));
+            }
+
+            return handlerIterRef;
+        }
+
+        // Move on to the next thread.
+        remLinkPtr = GetNextLink(&(handlerIterRef->threadObjList),
+                                 &(handlerIterRef->currThreadObj.link));
+        if (remLinkPtr == NULL)
+        {
+            return NULL;
+        }
+
+        thread_Obj_t* remThreadObjPtr = CONTAINER_OF(remLinkPtr, thread_Obj_t, link);
+
+        if (fd_ReadFromOffset(FdProcMem, (ssize_t)remThreadObjPtr,
+                              &(handlerIterRef->currThreadObj),
+                              sizeof(handlerIterRef->currThreadObj)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("thread object"));
+        }
+
+        // Start over on the lists of this thread.
+        handlerIterRef->handlerList.List = handlerIterRef->currThreadObj.eventRec.handlerList;
+        handlerIterRef->handlerList.headLinkPtr = NULL;
+        handlerIterRef->fdMonitorList.List = handlerIterRef->currThreadObj.eventRec.fdMonitorList;
+        handlerIterRef->fdMonitorList.headLinkPtr = NULL;
+        handlerIterRef->isFdMonitor = false;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the pointer to the next interface instance object. For other detail see GetNextMemPool.
@@ -1367,7 +1718,8 @@ static void* GetNextInterfaceObjPtr
     while (remEntryNextLinkPtr == NULL)
     {
         // Increment the bucket index. Return null if we run out of buckets.
-        if (iterator->currIndex < (iterator->interfaceObjMap.bucketCount - 1))
+        if (iterator->currIndex < (iterator->interfaceObjMap.oldBucketCount +
+                                   iterator->interfaceObjMap.bucketCount - 1))
         {
             iterator->currIndex++;
         }
@@ -1378,7 +1730,8 @@ static void* GetNextInterfaceObjPtr
 
         // So we haven't run out of buckets yet. Then update our interface object list.
         if (fd_ReadFromOffset(FdProcMem,
-                              (ssize_t)(iterator->interfaceObjMap.bucketsPtr + iterator->currIndex),
+                              (ssize_t)GetRemoteBucketPtr(&iterator->interfaceObjMap,
+                                                          iterator->currIndex),
                               &(iterator->interfaceObjList.List),
                               sizeof(iterator->interfaceObjList.List)) != LE_OK)
         {
@@ -1538,6 +1891,41 @@ static msgSession_Session_t* GetNextSessionObj
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next thread pool from the specified iterator. For other detail see GetNextMemPool.
+ *
+ * @return
+ *      A thread pool from the iterator's list of thread pools.
+ */
+//--------------------------------------------------------------------------------------------------
+static ThreadPool_t* GetNextThreadPool
+(
+    ThreadPoolIter_Ref_t threadPoolIterRef ///< [IN] The iterator to get the next thread pool from.
+)
+{
+    le_dls_Link_t* linkPtr = GetNextLink(&(threadPoolIterRef->threadPoolList),
+                                         &(threadPoolIterRef->currThreadPool.poolLink));
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Get the address of the thread pool.
+    ThreadPool_t* threadPoolPtr = CONTAINER_OF(linkPtr, ThreadPool_t, poolLink);
+
+    // Read the thread pool into our own memory.
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)threadPoolPtr, &(threadPoolIterRef->currThreadPool),
+                          sizeof(threadPoolIterRef->currThreadPool)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("thread pool object"));
+    }
+
+    return &(threadPoolIterRef->currThreadPool);
+}
+
+
 // TODO: migrate the above to a separate module.
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1555,7 +1943,8 @@ static void PrintHelp
         "              Legato process.\n"
         "\n"
         "SYNOPSIS:\n"
-        "    inspect <pools|threads|timers|mutexes|semaphores> [OPTIONS] PID\n"
+        "    inspect <pools|threads|timers|mutexes|semaphores|handlers|threadpools>"
+                                                                        " [OPTIONS] PID\n"
         "    inspect ipc <servers|clients [sessions]> [OPTIONS] PID\n"
         "\n"
         "DESCRIPTION:\n"
@@ -1567,8 +1956,23 @@ static void PrintHelp
                                         " specified process.\n"
         "    inspect semaphores         Prints the info of semaphores in all threads for the"
                                         " specified process.\n"
+        "    inspect handlers           Prints how many times the event handlers and fd event"
+                                        " handlers in all\n"
+        "                               threads of the specified process have been called, and"
+                                        " how long\n"
+        "                               they took (total, longest and mean, in seconds).\n"
+        "    inspect threadpools        Prints the info of thread pools for the specified"
+                                        " process: how many\n"
+        "                               tasks were submitted, run, and stolen by idle workers,"
+                                        " how many are\n"
+        "                               waiting, and the time spent running them (in seconds).\n"
         "    inspect ipc                Prints the info of ipc in all threads for the"
                                         " specified process.\n"
+        "                               For servers, this includes the number of messages"
+                                        " handled, the time\n"
+        "                               spent handling them, and the number of messages waiting"
+                                        " for a worker\n"
+        "                               thread.\n"
         "\n"
         "OPTIONS:\n"
         "    -f\n"
@@ -1583,6 +1987,13 @@ static void PrintHelp
         "    --format=json\n"
         "        Outputs the inspection results in JSON format.\n"
         "\n"
+        "    --rate\n"
+        "        For pools, also prints the allocation rate, the rate at which operations on a\n"
+        "        pool had to wait for the memory pool lock held by another thread, and the\n"
+        "        sampled mean allocation latency.  The rates are measured over one second, or\n"
+        "        over the refresh interval when following.  The counters are kept by the\n"
+        "        process itself, so this adds no overhead to it.\n"
+        "\n"
         "    --help\n"
         "        Display this help and exit.\n"
         );
@@ -1639,6 +2050,15 @@ static char SubPoolStr[] = "(Sub-pool)";
 static char SuperPoolStr[] = "";
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Strings representing the types of handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static char EventHandlerStr[] = "event";
+static char FdHandlerStr[] = "fd";
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * These tables define the display tables of each inspection type. The column width is left at 0
@@ -1656,6 +2076,10 @@ static ColumnInfo_t MemPoolTableInfo[] =
     {"MAX USED",    "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"OVERFLOWS",   "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"ALLOCS",      "%*s",  NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, true},
+    {"ALLOCS/S",    "%*s",  NULL, "%*.1f",      sizeof(uint32_t),            false, 0, false},
+    {"LOCK WAITS",  "%*s",  NULL, "%*"PRIu64"", sizeof(uint64_t),            false, 0, false},
+    {"WAITS/S",     "%*s",  NULL, "%*.1f",      sizeof(uint32_t),            false, 0, false},
+    {"ALLOC NS",    "%*s",  NULL, "%*"PRIu64"", sizeof(uint32_t),            false, 0, false},
     {"BLK BYTES",   "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"USED BYTES",  "%*s",  NULL, "%*zu",       sizeof(size_t),              false, 0, true},
     {"MEMORY POOL", "%-*s", NULL, "%-*s",       LIMIT_MAX_MEM_POOL_NAME_LEN, true,  0, true},
@@ -1665,17 +2089,23 @@ static size_t MemPoolTableInfoSize = NUM_ARRAY_MEMBERS(MemPoolTableInfo);
 
 static ColumnInfo_t ThreadObjTableInfo[] =
 {
-    {"NAME",             "%*s", NULL, "%*s",  MAX_THREAD_NAME_SIZE, true,  0, true},
-    {"JOINABLE",         "%*s", NULL, "%*u",  sizeof(bool),         false, 0, true},
-    {"STARTED",          "%*s", NULL, "%*u",  sizeof(bool),         false, 0, true},
-    {"DETACHSTATE",      "%*s", NULL, "%*s",  0,                    true,  0, true},
-    {"SCHED POLICY",     "%*s", NULL, "%*s",  0,                    true,  0, true},
-    {"SCHED PARAM",      "%*s", NULL, "%*u",  sizeof(int),          false, 0, true},
-    {"INHERIT SCHED",    "%*s", NULL, "%*s",  0,                    true,  0, true},
-    {"CONTENTION SCOPE", "%*s", NULL, "%*s",  0,                    true,  0, true},
-    {"GUARD SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true},
-    {"STACK ADDR",       "%*s", NULL, "%*X",  sizeof(uint64_t),     false, 0, true},
-    {"STACK SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true}
+    {"NAME",             "%*s", NULL, "%*s",        MAX_THREAD_NAME_SIZE, true,  0, true},
+    {"JOINABLE",         "%*s", NULL, "%*u",        sizeof(bool),         false, 0, true},
+    {"STARTED",          "%*s", NULL, "%*u",        sizeof(bool),         false, 0, true},
+    {"DETACHSTATE",      "%*s", NULL, "%*s",        0,                    true,  0, true},
+    {"SCHED POLICY",     "%*s", NULL, "%*s",        0,                    true,  0, true},
+    {"SCHED PARAM",      "%*s", NULL, "%*u",        sizeof(int),          false, 0, true},
+    {"INHERIT SCHED",    "%*s", NULL, "%*s",        0,                    true,  0, true},
+    {"CONTENTION SCOPE", "%*s", NULL, "%*s",        0,                    true,  0, true},
+    {"GUARD SIZE",       "%*s", NULL, "%*zu",       sizeof(size_t),       false, 0, true},
+    {"STACK ADDR",       "%*s", NULL, "%*X",        sizeof(uint64_t),     false, 0, true},
+    {"STACK SIZE",       "%*s", NULL, "%*zu",       sizeof(size_t),       false, 0, true},
+    {"STACK USED",       "%*s", NULL, "%*zu",       sizeof(size_t),       false, 0, true},
+    {"EVENT REPORTS",    "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),     false, 0, true},
+    {"QUEUED",           "%*s", NULL, "%*zu",       sizeof(size_t),       false, 0, true},
+    {"MAX QUEUED",       "%*s", NULL, "%*zu",       sizeof(size_t),       false, 0, true},
+    {"HANDLER TIME",     "%*s", NULL, "%*f",        sizeof(double),       false, 0, true},
+    {"MAX HANDLER TIME", "%*s", NULL, "%*f",        sizeof(double),       false, 0, true}
 };
 static size_t ThreadObjTableInfoSize = NUM_ARRAY_MEMBERS(ThreadObjTableInfo);
 
@@ -1706,11 +2136,41 @@ static ColumnInfo_t SemaphoreTableInfo[] =
 };
 static size_t SemaphoreTableInfoSize = NUM_ARRAY_MEMBERS(SemaphoreTableInfo);
 
+static ColumnInfo_t HandlerTableInfo[] =
+{
+    {"NAME",       "%*s", NULL, "%*s",        MAX_FD_MONITOR_NAME_BYTES, true,  0, true},
+    {"TYPE",       "%*s", NULL, "%*s",        0,                         true,  0, true},
+    {"THREAD",     "%*s", NULL, "%*s",        MAX_THREAD_NAME_SIZE,      true,  0, true},
+    {"CALLS",      "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),          false, 0, true},
+    {"TOTAL TIME", "%*s", NULL, "%*f",        sizeof(double),            false, 0, true},
+    {"MAX TIME",   "%*s", NULL, "%*f",        sizeof(double),            false, 0, true},
+    {"MEAN TIME",  "%*s", NULL, "%*f",        sizeof(double),            false, 0, true}
+};
+static size_t HandlerTableInfoSize = NUM_ARRAY_MEMBERS(HandlerTableInfo);
+
+static ColumnInfo_t ThreadPoolTableInfo[] =
+{
+    {"NAME",       "%*s", NULL, "%*s",        LIMIT_MAX_THREAD_POOL_NAME_BYTES, true,  0, true},
+    {"WORKERS",    "%*s", NULL, "%*zu",       sizeof(size_t),                   false, 0, true},
+    {"SUBMITTED",  "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),                 false, 0, true},
+    {"COMPLETED",  "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),                 false, 0, true},
+    {"STOLEN",     "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),                 false, 0, true},
+    {"QUEUED",     "%*s", NULL, "%*zu",       sizeof(size_t),                   false, 0, true},
+    {"MAX QUEUED", "%*s", NULL, "%*zu",       sizeof(size_t),                   false, 0, true},
+    {"BUSY TIME",  "%*s", NULL, "%*f",        sizeof(double),                   false, 0, true}
+};
+static size_t ThreadPoolTableInfoSize = NUM_ARRAY_MEMBERS(ThreadPoolTableInfo);
+
 static ColumnInfo_t ServiceObjTableInfo[] =
 {
     {"INTERFACE NAME", "%*s", NULL, "%*s",  LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
     {"STATE",          "%*s", NULL, "%*s",  0,                                  true,  0, true},
     {"THREAD NAME",    "%*s", NULL, "%*s",  MAX_THREAD_NAME_SIZE,               true,  0, true},
+    {"MESSAGES",       "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t),             false, 0, true},
+    {"SERVICE TIME",   "%*s", NULL, "%*f",  sizeof(double),                     false, 0, true},
+    {"MAX SERVICE TIME", "%*s", NULL, "%*f", sizeof(double),                    false, 0, true},
+    {"PENDING",        "%*s", NULL, "%*zu", sizeof(size_t),                     false, 0, true},
+    {"MAX PENDING",    "%*s", NULL, "%*zu", sizeof(size_t),                     false, 0, false},
     {"PROTOCOL ID",    "%*s", NULL, "%*s",  LIMIT_MAX_PROTOCOL_ID_BYTES,        true,  0, false},
     {"MAX PAYLOAD",    "%*s", NULL, "%*zu", sizeof(size_t),                     false, 0, false},
     {"FD",             "%*s", NULL, "%*d",  sizeof(int),                        false, 0, false}
@@ -1730,7 +2190,9 @@ static ColumnInfo_t SessionObjTableInfo[] =
     {"INTERFACE NAME", "%*s", NULL, "%*s", LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
     {"STATE",          "%*s", NULL, "%*s", 0,                                  true,  0, true},
     {"THREAD NAME",    "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,               true,  0, true},
-    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false}
+    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false},
+    {"TX QUEUE",       "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"PENDING TXNS",   "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false}
 };
 static size_t SessionObjTableInfoSize = NUM_ARRAY_MEMBERS(SessionObjTableInfo);
 
@@ -1967,6 +2429,30 @@ static void InitDisplayTable
         size_t subPoolColumnStrLen = subPoolStrLen > superPoolStrLen ? subPoolStrLen  :
                                                                        superPoolStrLen;
         InitDisplayTableMaxDataSize("SUB-POOL", table, tableSize, subPoolColumnStrLen);
+
+        // The rate columns are otherwise only printed in verbose mode.
+        if (IsRateShown)
+        {
+            int i;
+            for (i = 0; i < tableSize; i++)
+            {
+                if ((strcmp(table[i].colTitle, "ALLOCS/S") == 0) ||
+                    (strcmp(table[i].colTitle, "LOCK WAITS") == 0) ||
+                    (strcmp(table[i].colTitle, "WAITS/S") == 0) ||
+                    (strcmp(table[i].colTitle, "ALLOC NS") == 0))
+                {
+                    table[i].isPrintSimple = true;
+                }
+            }
+        }
+    }
+    else if (table == HandlerTableInfo)
+    {
+        size_t eventHandlerStrLen = strlen(EventHandlerStr);
+        size_t fdHandlerStrLen = strlen(FdHandlerStr);
+        InitDisplayTableMaxDataSize("TYPE", table, tableSize,
+                                    eventHandlerStrLen > fdHandlerStrLen ? eventHandlerStrLen :
+                                                                           fdHandlerStrLen);
     }
     else if (table == ServiceObjTableInfo)
     {
@@ -2054,6 +2540,14 @@ static void InitDisplay
             InitDisplayTable(SemaphoreTableInfo, SemaphoreTableInfoSize);
             break;
 
+        case INSPECT_INSP_TYPE_HANDLERS:
+            InitDisplayTable(HandlerTableInfo, HandlerTableInfoSize);
+            break;
+
+        case INSPECT_INSP_TYPE_THREAD_POOL:
+            InitDisplayTable(ThreadPoolTableInfo, ThreadPoolTableInfoSize);
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             InitDisplayTable(ServiceObjTableInfo, ServiceObjTableInfoSize);
             break;
@@ -2249,6 +2743,18 @@ static int PrintInspectHeader
             tableSize = SemaphoreTableInfoSize;
             break;
 
+        case INSPECT_INSP_TYPE_HANDLERS:
+            strncpy(inspectTypeString, "Handlers", inspectTypeStringSize);
+            table = HandlerTableInfo;
+            tableSize = HandlerTableInfoSize;
+            break;
+
+        case INSPECT_INSP_TYPE_THREAD_POOL:
+            strncpy(inspectTypeString, "Thread Pools", inspectTypeStringSize);
+            table = ThreadPoolTableInfo;
+            tableSize = ThreadPoolTableInfoSize;
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             strncpy(inspectTypeString, "IPC Server Interface", inspectTypeStringSize);
             table = ServiceObjTableInfo;
@@ -2712,6 +3218,67 @@ static void FillBoolColField
 static bool IsPrintedNodeFirst = true;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the allocation and lock wait rates of a memory pool, over the time since the previous
+ * inspection, or since its stats were last reset if it wasn't seen before (or it was reset since).
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetMemPoolRates
+(
+    const char* name,                   ///< [IN] Pool name.
+    const le_mem_PoolStats_t* statsPtr, ///< [IN] Pool stats.
+    double* allocRatePtr,               ///< [OUT] Allocations per second.
+    double* lockWaitRatePtr             ///< [OUT] Lock waits per second.
+)
+{
+    uint64_t numAllocs = statsPtr->numAllocs;
+    uint64_t numLockWaits = statsPtr->numLockWaits;
+    uint64_t periodMs = statsPtr->statsPeriodMs;
+
+    if (PoolSampleMap == NULL)
+    {
+        PoolSampleMap = le_hashmap_Create("PoolSamples", 64,
+                                          le_hashmap_HashString, le_hashmap_EqualsString);
+        PoolSamplePool = le_mem_CreatePool("PoolSamples", sizeof(PoolSample_t));
+    }
+
+    PoolSample_t* samplePtr = le_hashmap_Get(PoolSampleMap, name);
+
+    if (samplePtr == NULL)
+    {
+        samplePtr = le_mem_ForceAlloc(PoolSamplePool);
+        LE_ASSERT(le_utf8_Copy(samplePtr->name, name, sizeof(samplePtr->name), NULL) == LE_OK);
+        le_hashmap_Put(PoolSampleMap, samplePtr->name, samplePtr);
+    }
+    // The stats period is measured from the pool's reset time, so it also measures the time
+    // between two samples.
+    else if ((periodMs > samplePtr->statsPeriodMs) &&
+             (numAllocs >= samplePtr->numAllocs) &&
+             (numLockWaits >= samplePtr->numLockWaits))
+    {
+        numAllocs -= samplePtr->numAllocs;
+        numLockWaits -= samplePtr->numLockWaits;
+        periodMs -= samplePtr->statsPeriodMs;
+    }
+
+    samplePtr->numAllocs = statsPtr->numAllocs;
+    samplePtr->numLockWaits = statsPtr->numLockWaits;
+    samplePtr->statsPeriodMs = statsPtr->statsPeriodMs;
+
+    if (periodMs == 0)
+    {
+        *allocRatePtr = 0;
+        *lockWaitRatePtr = 0;
+    }
+    else
+    {
+        *allocRatePtr = ((double)numAllocs * 1000) / periodMs;
+        *lockWaitRatePtr = ((double)numLockWaits * 1000) / periodMs;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print memory pool information to stdout.
@@ -2738,6 +3305,10 @@ static int PrintMemPoolInfo
     INTERNAL_ERR_IF(le_mem_GetName(memPool, name, sizeof(name)) != LE_OK,
                     "Name buffer is too small.");
 
+    double allocRate;
+    double lockWaitRate;
+    GetMemPoolRates(name, &poolStats, &allocRate, &lockWaitRate);
+
     // Output mem pool info
     int index = 0;
 
@@ -2756,6 +3327,14 @@ static int PrintMemPoolInfo
                                                                  MemPoolTableInfoSize, &index);
         FillUint64ColField(poolStats.numAllocs,                  MemPoolTableInfo,
                                                                  MemPoolTableInfoSize, &index);
+        FillDoubleColField(allocRate,                            MemPoolTableInfo,
+                                                                 MemPoolTableInfoSize, &index);
+        FillUint64ColField(poolStats.numLockWaits,               MemPoolTableInfo,
+                                                                 MemPoolTableInfoSize, &index);
+        FillDoubleColField(lockWaitRate,                         MemPoolTableInfo,
+                                                                 MemPoolTableInfoSize, &index);
+        FillUint64ColField(poolStats.allocLatencyNs,             MemPoolTableInfo,
+                                                                 MemPoolTableInfoSize, &index);
         FillSizeTColField (blockSize,                            MemPoolTableInfo,
                                                                  MemPoolTableInfoSize, &index);
         FillSizeTColField (blockSize*(poolStats.numBlocksInUse), MemPoolTableInfo,
@@ -2794,6 +3373,14 @@ static int PrintMemPoolInfo
                                                             MemPoolTableInfoSize, &index, &printed);
         ExportUint64ToJson(poolStats.numAllocs,             MemPoolTableInfo,
                                                             MemPoolTableInfoSize, &index, &printed);
+        ExportDoubleToJson(allocRate,                       MemPoolTableInfo,
+                                                            MemPoolTableInfoSize, &index, &printed);
+        ExportUint64ToJson(poolStats.numLockWaits,          MemPoolTableInfo,
+                                                            MemPoolTableInfoSize, &index, &printed);
+        ExportDoubleToJson(lockWaitRate,                    MemPoolTableInfo,
+                                                            MemPoolTableInfoSize, &index, &printed);
+        ExportUint64ToJson(poolStats.allocLatencyNs,        MemPoolTableInfo,
+                                                            MemPoolTableInfoSize, &index, &printed);
         ExportSizeTToJson (blockSize,                       MemPoolTableInfo,
                                                             MemPoolTableInfoSize, &index, &printed);
         ExportSizeTToJson (blockSize*(poolStats.numBlocksInUse), MemPoolTableInfo,
@@ -2810,6 +3397,89 @@ static int PrintMemPoolInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets how much of a thread's stack, in the process being inspected, has been used.  Stacks grow
+ * down, and the kernel only gives a stack page memory when it is first touched, so the stack has
+ * been used down to the lowest page of it that is resident or swapped out, as reported by
+ * /proc/<PID>/pagemap (see Documentation/admin-guide/mm/pagemap.rst).  This is a high-water mark,
+ * to the nearest page.
+ *
+ * @return
+ *      Number of bytes of the stack used, or 0 if not known.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetStackUsed
+(
+    uintptr_t stackAddr,    ///< [IN] Lowest address of the stack.
+    size_t stackSize        ///< [IN] Size of the stack.
+)
+{
+    // Bits of a pagemap entry telling if the page is present in RAM or swapped out.
+    const uint64_t presentOrSwapped = (UINT64_C(1) << 63) | (UINT64_C(1) << 62);
+
+    if ((stackAddr == 0) || (stackSize == 0))
+    {
+        return 0;
+    }
+
+    char pagemapPath[LIMIT_MAX_PATH_BYTES];
+    int snprintSize = snprintf(pagemapPath, sizeof(pagemapPath), "/proc/%d/pagemap", PidToInspect);
+
+    if ((snprintSize < 0) || (snprintSize >= sizeof(pagemapPath)))
+    {
+        INTERNAL_ERR("Could not build the path to the pagemap of process %d.", PidToInspect);
+    }
+
+    int fd = open(pagemapPath, O_RDONLY);
+
+    if (fd == -1)
+    {
+        return 0;
+    }
+
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t firstPage = stackAddr / pageSize;
+    uintptr_t endPage = (stackAddr + stackSize + pageSize - 1) / pageSize;
+    size_t stackUsed = 0;
+
+    // Look for the lowest page used, a batch of pagemap entries at a time.
+    uint64_t entries[512];
+    uintptr_t page = firstPage;
+
+    while ((page < endPage) && (stackUsed == 0))
+    {
+        size_t count = NUM_ARRAY_MEMBERS(entries);
+
+        if (count > endPage - page)
+        {
+            count = endPage - page;
+        }
+
+        if (fd_ReadFromOffset(fd, (off_t)(page * sizeof(uint64_t)), entries,
+                              count * sizeof(uint64_t)) != LE_OK)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (entries[i] & presentOrSwapped)
+            {
+                stackUsed = (stackAddr + stackSize) - ((page + i) * pageSize);
+                break;
+            }
+        }
+
+        page += count;
+    }
+
+    fd_Close(fd);
+
+    return stackUsed;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print thread obj information to stdout.
@@ -2865,12 +3535,15 @@ static int PrintThreadObjInfo
         INTERNAL_ERR("pthread_attr_getguardsize failed.");
     }
 
-    uint32_t stackAddr[1]; // Need to handle both 32 and 64-bit platforms
-    size_t stackSize;
-    if (pthread_attr_getstack(&threadObjRef->attr, (void**)&stackAddr, &stackSize) != 0)
-    {
-        INTERNAL_ERR("pthread_attr_getstack failed.");
-    }
+    uintptr_t stackAddr = (uintptr_t)threadObjRef->stackPtr;
+    size_t stackSize = threadObjRef->stackSize;
+    size_t stackUsed = GetStackUsed(stackAddr, stackSize);
+
+    const event_Stats_t* eventStatsPtr = &threadObjRef->eventRec.stats;
+    double handlerTime = (double)eventStatsPtr->handlerTime.sec +
+                         ((double)eventStatsPtr->handlerTime.usec / 1000000);
+    double maxHandlerTime = (double)eventStatsPtr->maxHandlerTime.sec +
+                            ((double)eventStatsPtr->maxHandlerTime.usec / 1000000);
 
     // Output thread object info
     int index = 0;
@@ -2895,10 +3568,22 @@ static int PrintThreadObjInfo
                                                                     ThreadObjTableInfoSize, &index);
         FillSizeTColField (guardSize,                               ThreadObjTableInfo,
                                                                     ThreadObjTableInfoSize, &index);
-        FillUint64ColField(stackAddr[0],                            ThreadObjTableInfo,
+        FillUint64ColField(stackAddr,                               ThreadObjTableInfo,
                                                                     ThreadObjTableInfoSize, &index);
         FillSizeTColField (stackSize,                               ThreadObjTableInfo,
                                                                     ThreadObjTableInfoSize, &index);
+        FillSizeTColField (stackUsed,                               ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(eventStatsPtr->reportCount,              ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillSizeTColField (threadObjRef->eventRec.eventQueue.count, ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillSizeTColField (eventStatsPtr->maxQueueDepth,            ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillDoubleColField(handlerTime,                             ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillDoubleColField(maxHandlerTime,                          ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
 
         PrintInfo(ThreadObjTableInfo, ThreadObjTableInfoSize);
         lineCount++;
@@ -2937,10 +3622,22 @@ static int PrintThreadObjInfo
                                                           ThreadObjTableInfoSize, &index, &printed);
         ExportSizeTToJson (guardSize,                     ThreadObjTableInfo,
                                                           ThreadObjTableInfoSize, &index, &printed);
-        ExportUint64ToJson(stackAddr[0],                  ThreadObjTableInfo,
+        ExportUint64ToJson(stackAddr,                     ThreadObjTableInfo,
                                                           ThreadObjTableInfoSize, &index, &printed);
         ExportSizeTToJson (stackSize,                     ThreadObjTableInfo,
                                                           ThreadObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson (stackUsed,                     ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(eventStatsPtr->reportCount,    ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadObjRef->eventRec.eventQueue.count, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson (eventStatsPtr->maxQueueDepth,  ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(handlerTime,                   ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(maxHandlerTime,                ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3394,6 +4091,177 @@ static int PrintSemaphoreInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the current handler of a handler iterator.
+ *
+ * @return
+ *      Number of lines printed.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintHandlerInfo
+(
+    HandlerIter_Ref_t handlerIterRef   ///< [IN] iterator whose current handler is to be printed.
+)
+{
+    int lineCount = 0;
+
+    char* name;
+    char* typeStr;
+    const event_HandlerStats_t* statsPtr;
+    if (handlerIterRef->isFdMonitor)
+    {
+        name = handlerIterRef->currFdMonitor.name;
+        typeStr = FdHandlerStr;
+        statsPtr = &handlerIterRef->currFdMonitor.stats;
+    }
+    else
+    {
+        name = handlerIterRef->currHandler.name;
+        typeStr = EventHandlerStr;
+        statsPtr = &handlerIterRef->currHandler.stats;
+    }
+
+    double totalTime = (double)statsPtr->totalTime.sec +
+                       ((double)statsPtr->totalTime.usec / 1000000);
+    double maxTime = (double)statsPtr->maxTime.sec + ((double)statsPtr->maxTime.usec / 1000000);
+    double meanTime = (statsPtr->callCount == 0) ? 0 : (totalTime / statsPtr->callCount);
+
+    char* threadName = handlerIterRef->currThreadObj.name;
+
+    // Output handler info
+    int index = 0;
+
+    if (!IsOutputJson)
+    {
+        FillStrColField   (name,                 HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillStrColField   (typeStr,              HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillStrColField   (threadName,           HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillUint64ColField(statsPtr->callCount,  HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillDoubleColField(totalTime,            HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillDoubleColField(maxTime,              HandlerTableInfo, HandlerTableInfoSize, &index);
+        FillDoubleColField(meanTime,             HandlerTableInfo, HandlerTableInfoSize, &index);
+
+        PrintInfo(HandlerTableInfo, HandlerTableInfoSize);
+        lineCount++;
+    }
+    else
+    {
+        // If it's not the first time, print a comma.
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+
+        printf("[");
+
+        ExportStrToJson   (name,                HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportStrToJson   (typeStr,             HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportStrToJson   (threadName,          HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->callCount, HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportDoubleToJson(totalTime,           HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportDoubleToJson(maxTime,             HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+        ExportDoubleToJson(meanTime,            HandlerTableInfo,
+                                                HandlerTableInfoSize, &index, &printed);
+
+        printf("]");
+    }
+
+    return lineCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print thread pool information to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintThreadPoolInfo
+(
+    ThreadPool_t* threadPoolRef   ///< [IN] ref to thread pool to be printed.
+)
+{
+    int lineCount = 0;
+    double busyTime = (double)threadPoolRef->busyTime.sec +
+                      ((double)threadPoolRef->busyTime.usec / 1000000);
+
+    // Output thread pool info
+    int index = 0;
+
+    if (!IsOutputJson)
+    {
+        FillStrColField   (threadPoolRef->name,           ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillSizeTColField (threadPoolRef->numWorkers,     ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillUint64ColField(threadPoolRef->submittedCount, ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillUint64ColField(threadPoolRef->completedCount, ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillUint64ColField(threadPoolRef->stolenCount,    ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillSizeTColField (threadPoolRef->queuedCount,    ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillSizeTColField (threadPoolRef->maxQueuedCount, ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+        FillDoubleColField(busyTime,                      ThreadPoolTableInfo,
+                                                          ThreadPoolTableInfoSize, &index);
+
+        PrintInfo(ThreadPoolTableInfo, ThreadPoolTableInfoSize);
+        lineCount++;
+    }
+    else
+    {
+        // If it's not the first time, print a comma.
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+
+        printf("[");
+
+        ExportStrToJson   (threadPoolRef->name,           ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadPoolRef->numWorkers,     ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadPoolRef->submittedCount, ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadPoolRef->completedCount, ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadPoolRef->stolenCount,    ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadPoolRef->queuedCount,    ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadPoolRef->maxQueuedCount, ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+        ExportDoubleToJson(busyTime,                      ThreadPoolTableInfo,
+                                                     ThreadPoolTableInfoSize, &index, &printed);
+
+        printf("]");
+    }
+
+    return lineCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Look up the thread name associated with the thread object safe ref being passed in. If there's no
@@ -3462,6 +4330,10 @@ static int PrintServiceObjInfo
     char threadName[MAX_THREAD_NAME_SIZE] = {0};
     LookupThreadName((size_t)serviceObjRef->serverThread, threadName, MAX_THREAD_NAME_SIZE);
 
+    const msgInterface_ServiceStats_t* statsPtr = &serviceObjRef->stats;
+    double serviceTime = (double)statsPtr->serviceTimeUs / 1000000;
+    double maxServiceTime = (double)statsPtr->maxServiceTimeUs / 1000000;
+
     // Output service object info
     int index = 0;
 
@@ -3473,6 +4345,16 @@ static int PrintServiceObjInfo
                                                             ServiceObjTableInfoSize, &index);
         FillStrColField  (threadName,                       ServiceObjTableInfo,
                                                             ServiceObjTableInfoSize, &index);
+        FillUint64ColField(statsPtr->msgCount,              ServiceObjTableInfo,
+                                                            ServiceObjTableInfoSize, &index);
+        FillDoubleColField(serviceTime,                     ServiceObjTableInfo,
+                                                            ServiceObjTableInfoSize, &index);
+        FillDoubleColField(maxServiceTime,                  ServiceObjTableInfo,
+                                                            ServiceObjTableInfoSize, &index);
+        FillSizeTColField(statsPtr->pendingCount,           ServiceObjTableInfo,
+                                                            ServiceObjTableInfoSize, &index);
+        FillSizeTColField(statsPtr->maxPendingCount,        ServiceObjTableInfo,
+                                                            ServiceObjTableInfoSize, &index);
         FillStrColField  (protocol.id,                      ServiceObjTableInfo,
                                                             ServiceObjTableInfoSize, &index);
         FillSizeTColField(protocol.maxPayloadSize,          ServiceObjTableInfo,
@@ -3505,6 +4387,16 @@ static int PrintServiceObjInfo
                                                          ServiceObjTableInfoSize, &index, &printed);
         ExportStrToJson  (threadName,                    ServiceObjTableInfo,
                                                          ServiceObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(statsPtr->msgCount,           ServiceObjTableInfo,
+                                                         ServiceObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(serviceTime,                  ServiceObjTableInfo,
+                                                         ServiceObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(maxServiceTime,               ServiceObjTableInfo,
+                                                         ServiceObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(statsPtr->pendingCount,        ServiceObjTableInfo,
+                                                         ServiceObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(statsPtr->maxPendingCount,     ServiceObjTableInfo,
+                                                         ServiceObjTableInfoSize, &index, &printed);
         ExportStrToJson  (protocol.id,                   ServiceObjTableInfo,
                                                          ServiceObjTableInfoSize, &index, &printed);
         ExportSizeTToJson(protocol.maxPayloadSize,       ServiceObjTableInfo,
@@ -3624,6 +4516,10 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index);
         FillIntColField(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->transmitCount, SessionObjTableInfo,
+                                                        SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->txnCount, SessionObjTableInfo,
+                                                   SessionObjTableInfoSize, &index);
 
         PrintInfo(SessionObjTableInfo, SessionObjTableInfoSize);
         lineCount++;
@@ -3652,6 +4548,10 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index, &printed);
         ExportIntToJson(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->transmitCount, SessionObjTableInfo,
+                                                        SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->txnCount, SessionObjTableInfo,
+                                                   SessionObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3819,6 +4719,20 @@ static void InspectFunc
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintSemaphoreInfo;
             break;
 
+        case INSPECT_INSP_TYPE_HANDLERS:
+            createIterFunc    = (CreateIterFunc_t)    CreateHandlerIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetHandlerListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextHandler;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintHandlerInfo;
+            break;
+
+        case INSPECT_INSP_TYPE_THREAD_POOL:
+            createIterFunc    = (CreateIterFunc_t)    CreateThreadPoolIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetThreadPoolListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextThreadPool;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintThreadPoolInfo;
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             createIterFunc    = (CreateIterFunc_t)    CreateServiceObjIter;
             getListChgCntFunc = (GetListChgCntFunc_t) GetInterfaceObjMapChgCnt;
@@ -3901,6 +4815,39 @@ static void InspectFunc
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the counters of all the memory pools, so the next inspection prints the rates measured
+ * from now on.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleMemPools
+(
+    void
+)
+{
+    MemPoolIter_Ref_t iterRef = CreateMemPoolIter();
+    MemPool_t* poolPtr;
+
+    // If the list changes on the way, the pools that are missed only get their lifetime rates.
+    while ((poolPtr = GetNextMemPool(iterRef)) != NULL)
+    {
+        le_mem_PoolStats_t poolStats;
+        char name[LIMIT_MAX_COMPONENT_NAME_LEN + 1 + LIMIT_MAX_MEM_POOL_NAME_BYTES];
+        double allocRate;
+        double lockWaitRate;
+
+        le_mem_GetStats(poolPtr, &poolStats);
+        INTERNAL_ERR_IF(le_mem_GetName(poolPtr, name, sizeof(name)) != LE_OK,
+                        "Name buffer is too small.");
+
+        GetMemPoolRates(name, &poolStats, &allocRate, &lockWaitRate);
+    }
+
+    le_mem_Release(iterRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Refresh timer handler.
@@ -4038,6 +4985,14 @@ static void CommandArgHandler
     {
         InspectType = INSPECT_INSP_TYPE_SEMAPHORE;
     }
+    else if (strcmp(command, "handlers") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_HANDLERS;
+    }
+    else if (strcmp(command, "threadpools") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_THREAD_POOL;
+    }
     else if (strcmp(command, "ipc") == 0)
     {
         le_arg_AddPositionalCallback(IpcInterfaceTypeHandler);
@@ -4137,6 +5092,14 @@ static void InitIteratorPool
             size = sizeof(SemaphoreIter_t);
             break;
 
+        case INSPECT_INSP_TYPE_HANDLERS:
+            size = sizeof(HandlerIter_t);
+            break;
+
+        case INSPECT_INSP_TYPE_THREAD_POOL:
+            size = sizeof(ThreadPoolIter_t);
+            break;
+
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             // Make the block size big enough to accomodate either one.
             // Technically a little wasteful.
@@ -4183,13 +5146,30 @@ COMPONENT_INIT
     // --format=json option outputs data to the specified file in JSON format.
     le_arg_SetStringCallback(FormatOptionCallback, NULL, "format");
 
+    // --rate option prints the allocation and lock wait rates of memory pools.
+    le_arg_SetFlagVar(&IsRateShown, NULL, "rate");
+
     le_arg_Scan();
 
+    if (IsRateShown && (InspectType != INSPECT_INSP_TYPE_MEM_POOL))
+    {
+        fprintf(stderr, "The --rate option only applies to pools.\n");
+        exit(EXIT_FAILURE);
+    }
+
     // Create a memory pool for iterators.
     InitIteratorPool(InspectType);
 
     InitDisplay(InspectType);
 
+    // When following, the first inspection prints the rates over the pools' lifetimes, and the
+    // following ones the rates over the refresh interval.
+    if (IsRateShown && !IsFollowing)
+    {
+        SampleMemPools();
+        sleep(DEFAULT_RATE_WINDOW);
+    }
+
     // Start the inspection.
     InspectFunc(InspectType);
 
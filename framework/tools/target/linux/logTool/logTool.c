@@ -26,6 +26,16 @@ $ log trace keyword processName/componentName
  * To disable a trace:
  * @verbatim
 $ log stoptrace keyword processName/componentName
+@endverbatim
+ *
+ * To list the busiest rate-limited logging call sites in a process:
+ * @verbatim
+$ log hot processName
+@endverbatim
+ *
+ * To stream the WARNING and more severe messages of a component that match a pattern:
+ * @verbatim
+$ log stream WARNING processName/componentName "timeout|retry"
 @endverbatim
  *
  *
@@ -91,6 +101,14 @@ static const char* CommandParamPtr = NULL;
 static const char* SessionIdPtr = DEFAULT_SESSION_ID;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pointer to the regular expression that streamed messages must match, or NULL if none.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* PatternPtr = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * True if an error response was received from the Log Control Daemon.
@@ -119,6 +137,8 @@ static void PrintHelpAndExit
         "    log trace KEYWORD_STR [DESTINATION]\n"
         "    log stoptrace KEYWORD_STR [DESTINATION]\n"
         "    log forget PROCESS_NAME\n"
+        "    log hot [PROCESS]\n"
+        "    log stream FILTER_STR [DESTINATION [PATTERN]]\n"
         "\n"
         "DESCRIPTION:\n"
         "    log list            Lists all processes/components registered with the\n"
@@ -146,6 +166,23 @@ static void PrintHelpAndExit
         "                        Future processes with that name will have default\n"
         "                        settings.\n"
         "\n"
+        "    log hot             Lists the rate-limited logging call sites that have logged\n"
+        "                        the most messages in running processes, busiest first.\n"
+        "                        For each call site, the number of messages logged or\n"
+        "                        suppressed, and how many of those were suppressed, are\n"
+        "                        listed.  PROCESS is a process name, a PID, or '*' for all\n"
+        "                        processes (the default).\n"
+        "\n"
+        "    log stream          Prints the log messages of the DESTINATION as they are\n"
+        "                        logged, until interrupted.  Only the messages at least\n"
+        "                        as severe as FILTER_STR (see 'log level') and, if a\n"
+        "                        PATTERN is given, that match that extended regular\n"
+        "                        expression are printed.  The filtering is done by the\n"
+        "                        log daemon and the logging processes, so messages\n"
+        "                        that aren't printed aren't sent.  Messages less severe\n"
+        "                        than a component's log level are never logged, so\n"
+        "                        can't be streamed either.\n"
+        "\n"
         "The [DESTINATION] is optional and specifies the process and component to\n"
         "send the command to.  The [DESTINATION] must be in this format:\n"
         "\n"
@@ -184,8 +221,10 @@ static void MsgReceiveHandler
 )
 {
     const char* responseStr = le_msg_GetPayloadPtr(msgRef);
-    // Print out whatever the Log Control Daemon sent us.
+    // Print out whatever the Log Control Daemon sent us.  Flush it right away, as streamed
+    // messages may be piped into another program.
     printf("%s\n", responseStr);
+    fflush(stdout);
 
     // If the first character of the response is a '*', then there has been an error.
     if (responseStr[0] == '*')
@@ -385,6 +424,21 @@ static void AppendToCommand
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called by le_arg_Scan() when the pattern argument for a "stream" command is
+ * seen on the command line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PatternArgHandler
+(
+    const char* pattern
+)
+{
+    PatternPtr = pattern;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function that gets called by le_arg_Scan() when a log session identifier is seen on the
@@ -414,6 +468,13 @@ static void SessionIdArgHandler
     }
 
     SessionIdPtr = sessionId;
+
+    // The stream command can have a pattern after the destination.
+    if (Command == LOG_CMD_STREAM)
+    {
+        le_arg_AddPositionalCallback(PatternArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
 }
 
 
@@ -529,6 +590,22 @@ static void CommandArgHandler
         // This command has only a process name (or pid) as a parameter.
         le_arg_AddPositionalCallback(ProcessIdArgHandler);
     }
+    else if (strcmp(command, "hot") == 0)
+    {
+        Command = LOG_CMD_LIST_HOT_SITES;
+
+        // This command has an optional process name (or pid) as a parameter.
+        CommandParamPtr = "*";
+        le_arg_AddPositionalCallback(ProcessIdArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
+    else if (strcmp(command, "stream") == 0)
+    {
+        Command = LOG_CMD_STREAM;
+
+        // Expect a log level next.
+        le_arg_AddPositionalCallback(LogLevelArgHandler);
+    }
     else
     {
         char errorMsg[100];
@@ -573,6 +650,20 @@ COMPONENT_INIT
 
             break;
 
+        case LOG_CMD_STREAM:
+
+            AppendToCommand(msgRef, SessionIdPtr);
+            AppendToCommand(msgRef, "/");
+            AppendToCommand(msgRef, CommandParamPtr);
+
+            if (PatternPtr != NULL)
+            {
+                AppendToCommand(msgRef, "/");
+                AppendToCommand(msgRef, PatternPtr);
+            }
+
+            break;
+
         case LOG_CMD_LIST_COMPONENTS:
 
             // This one has no arguments.
@@ -580,6 +671,7 @@ COMPONENT_INIT
             break;
 
         case LOG_CMD_FORGET_PROCESS:
+        case LOG_CMD_LIST_HOT_SITES:
 
             AppendToCommand(msgRef, CommandParamPtr);
 
@@ -588,6 +680,7 @@ COMPONENT_INIT
 
     // Send the command and wait for messages from the Log Control Daemon.  When the Log Control
     // Daemon has finished executing the command, it will close the IPC session, resulting in a
-    // call to SessionCloseHandler().
+    // call to SessionCloseHandler().  When streaming, that only happens if the command failed;
+    // otherwise the messages keep coming until the tool is interrupted.
     le_msg_Send(msgRef);
 }
@@ -273,6 +273,15 @@ static le_mem_PoolRef_t FilePool = NULL;
 static const char* RequiresPathPtr = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if only the file access system calls stop the tracees, through a seccomp filter installed
+ * by the Supervisor.  false if every system call stops them.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool UseSysCallFilter = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints a generic message on stderr so that the user is aware there is a problem, logs the
@@ -330,6 +339,11 @@ static void PrintHelp
         "   -o <PATH>, --output=<PATH>\n"
         "       Writes the 'requires' section to a file specified at PATH.\n"
         "\n"
+        "   -f, --filter\n"
+        "       Only stops the app's processes on the system calls that access files, using a\n"
+        "       seccomp filter, instead of on every system call.  The app runs much faster, but\n"
+        "       it is stopped when tracing ends, because the filter stays in its processes.\n"
+        "\n"
         );
 
     exit(EXIT_SUCCESS);
@@ -350,6 +364,20 @@ static void SetRequireFilePath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Selects the seccomp filter mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetFilterMode
+(
+    void
+)
+{
+    UseSysCallFilter = true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the system call number from the registers.
@@ -724,6 +752,23 @@ static void StartAppTrace
         exit(EXIT_FAILURE);
     }
 
+    // Only have the file access system calls stop the app's processes, if requested.
+    if (UseSysCallFilter)
+    {
+        int32_t sysCalls[NUM_ARRAY_MEMBERS(FileAccessSysCalls)];
+        size_t i;
+
+        INTERNAL_ERR_IF(NUM_ARRAY_MEMBERS(sysCalls) > LE_APPCTRL_MAX_TRACE_SYS_CALLS,
+                        "Too many system calls to filter (%zu).", NUM_ARRAY_MEMBERS(sysCalls));
+
+        for (i = 0; i < NUM_ARRAY_MEMBERS(sysCalls); i++)
+        {
+            sysCalls[i] = FileAccessSysCalls[i].sysCallNum;
+        }
+
+        le_appCtrl_SetTraceSysCalls(AppRef, sysCalls, NUM_ARRAY_MEMBERS(sysCalls));
+    }
+
     // Set an attach handler.
     le_appCtrl_AddTraceAttachHandler(AppRef, AttachHandler, NULL);
 
@@ -1321,6 +1366,13 @@ static void CreateRequiresSection
     const char* fileToUsePtr = RequiresPathPtr;
     char reqFilePath[MAX_PATH_BYTES] = "";
 
+    // Once we exit, the filtered system calls would fail in the app's processes, so stop the app.
+    if (UseSysCallFilter)
+    {
+        printf("Stopping app '%s'.\n", AppNamePtr);
+        le_appCtrl_Stop(AppNamePtr);
+    }
+
     if (fileToUsePtr == NULL)
     {
         // Ask the user for the path.
@@ -1459,12 +1511,18 @@ static void SigChildHandler
             if (traceePtr->needInit)
             {
                 // Set ptrace options.
-                if (Ptrace(PTRACE_SETOPTIONS, traceePtr->tid, NULL,
-                           (void*)(PTRACE_O_TRACESYSGOOD |
+                intptr_t options = PTRACE_O_TRACESYSGOOD |
                                    PTRACE_O_TRACEEXEC |
                                    PTRACE_O_TRACECLONE |
                                    PTRACE_O_TRACEFORK |
-                                   PTRACE_O_TRACEVFORK)) == LE_NOT_FOUND)
+                                   PTRACE_O_TRACEVFORK;
+
+                if (UseSysCallFilter)
+                {
+                    options |= PTRACE_O_TRACESECCOMP;
+                }
+
+                if (Ptrace(PTRACE_SETOPTIONS, traceePtr->tid, NULL, (void*)options) == LE_NOT_FOUND)
                 {
                     continue;
                 }
@@ -1495,6 +1553,13 @@ static void SigChildHandler
                 }
             }
 
+            // Handle the stops for the system calls trapped by the seccomp filter.  These happen
+            // when the system call is entered only.
+            if ( (status >> 8) == (SIGTRAP | PTRACE_EVENT_SECCOMP << 8) )
+            {
+                HandleSysCall(pid);
+            }
+
             // Handle syscall-stops.
             if (sig == (SIGTRAP | 0x80))
             {
@@ -1511,8 +1576,10 @@ static void SigChildHandler
                 sigToDeliver = sig;
             }
 
-            // Restart the tracee.
-            if (Ptrace(PTRACE_SYSCALL, pid, NULL, (void*)(intptr_t)sigToDeliver) == LE_NOT_FOUND)
+            // Restart the tracee.  With the seccomp filter, the tracee only needs to stop again on
+            // the filtered system calls, which the filter takes care of.
+            if (Ptrace(UseSysCallFilter ? PTRACE_CONT : PTRACE_SYSCALL, pid, NULL,
+                       (void*)(intptr_t)sigToDeliver) == LE_NOT_FOUND)
             {
                 continue;
             }
@@ -1637,6 +1704,7 @@ COMPONENT_INIT
     // Handle options.
     le_arg_SetFlagCallback(PrintHelp, "h", "help");
     le_arg_SetStringCallback(SetRequireFilePath, "o", "output");
+    le_arg_SetFlagCallback(SetFilterMode, "f", "filter");
 
     // Get the app to trace.
     le_arg_AddPositionalCallback(StoreAppName);
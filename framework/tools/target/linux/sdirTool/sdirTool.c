@@ -50,6 +50,12 @@ static const char* ClientIfPtr = NULL;
 static const char* ServerIfPtr = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/// App name string (used by Load() and Unload()).  NULL = all apps and users.
+//--------------------------------------------------------------------------------------------------
+static const char* AppNamePtr = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints help to stdout and exits with EXIT_SUCCESS.
@@ -68,6 +74,8 @@ static void PrintHelpAndExit
         "    sdir list\n"
         "    sdir list --format=json\n"
         "    sdir load\n"
+        "    sdir load APP_NAME\n"
+        "    sdir unload APP_NAME\n"
         "    sdir bind CLIENT_IF SERVER_IF\n"
         "    sdir help\n"
         "    sdir -h\n"
@@ -87,6 +95,19 @@ static void PrintHelpAndExit
         "            The tool will not exit until it gets confirmation from\n"
         "            the Service Directory that the changes have been applied.\n"
         "\n"
+        "    sdir load APP_NAME\n"
+        "            Like 'sdir load', but only updates the bindings of app APP_NAME's\n"
+        "            client-side interfaces and the bindings of other apps and users\n"
+        "            to APP_NAME's services, leaving all other bindings alone.\n"
+        "            Bindings of unsandboxed apps belong to the root user, so they\n"
+        "            are all reloaded.\n"
+        "\n"
+        "    sdir unload APP_NAME\n"
+        "            Deletes the bindings of app APP_NAME's client-side interfaces and\n"
+        "            the bindings to APP_NAME's services from the Service Directory.\n"
+        "            Must be run while the app is still installed.  Does nothing for\n"
+        "            unsandboxed apps; run 'sdir load' after removing those.\n"
+        "\n"
         "    sdir bind CLIENT_IF SERVER_IF\n"
         "            Creates a temporary binding in the Service Directory from\n"
         "            client-side IPC interface CLIENT_IF to server-side IPC interface\n"
@@ -243,19 +264,31 @@ static void List
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Send an "Unbind All" request to the Service Directory.
+ * Send a "Bind All" or "Bind User" request to the Service Directory, replacing all its bindings,
+ * or those of one user, with the ones that have been written to a given file.
  */
 //--------------------------------------------------------------------------------------------------
-static void SendUnbindAllRequest
+static void SendBindRequest
 (
-    void
+    FILE* bindingsFilePtr,      ///< [in] File containing the le_sdtp_Binding_t records.
+    le_sdtp_MsgType_t msgType,  ///< [in] LE_SDTP_MSGID_BIND_ALL or LE_SDTP_MSGID_BIND_USER.
+    uid_t uid                   ///< [in] User whose bindings are replaced (Bind User only).
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if ((fflush(bindingsFilePtr) != 0) || (fseek(bindingsFilePtr, 0, SEEK_SET) != 0))
+    {
+        ExitWithErrorMsg("Failed to write bindings file.");
+    }
+
     le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
     le_sdtp_Msg_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
 
-    msgPtr->msgType = LE_SDTP_MSGID_UNBIND_ALL;
+    msgPtr->msgType = msgType;
+    msgPtr->client = uid;
+
+    // The message takes ownership of the fd it is given, so give it a duplicate.
+    le_msg_SetFd(msgRef, dup(fileno(bindingsFilePtr)));
 
     msgRef = le_msg_RequestSyncResponse(msgRef);
 
@@ -396,11 +429,13 @@ static le_result_t GetServerUid
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Send a binding from a configuration tree iterator's current node to the Service Directory.
+ * Write a binding from a configuration tree iterator's current node to the file of bindings to be
+ * sent to the Service Directory.
  */
 //--------------------------------------------------------------------------------------------------
-static void SendCfgBindRequest
+static void WriteCfgBinding
 (
+    FILE* bindingsFilePtr,      ///< [in] File to write the binding record to.
     uid_t uid,                  ///< [in] Unix user ID of the client whose binding is being created.
     le_cfg_IteratorRef_t i      ///< [in] Configuration read iterator.
 )
@@ -408,17 +443,16 @@ static void SendCfgBindRequest
 {
     le_result_t result;
 
-    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
-    le_sdtp_Msg_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    le_sdtp_Binding_t binding;
 
-    msgPtr->msgType = LE_SDTP_MSGID_BIND;
-    msgPtr->client = uid;
+    memset(&binding, 0, sizeof(binding));
+    binding.client = uid;
 
     // Fetch the client's service name.
     result = le_cfg_GetNodeName(i,
                                 "",
-                                msgPtr->clientInterfaceName,
-                                sizeof(msgPtr->clientInterfaceName));
+                                binding.clientInterfaceName,
+                                sizeof(binding.clientInterfaceName));
     if (result != LE_OK)
     {
         char path[LIMIT_MAX_PATH_BYTES];
@@ -428,7 +462,7 @@ static void SendCfgBindRequest
     }
 
     // Fetch the server's user ID.
-    result = GetServerUid(i, &msgPtr->server);
+    result = GetServerUid(i, &binding.server);
     if (result != LE_OK)
     {
         return;
@@ -437,8 +471,8 @@ static void SendCfgBindRequest
     // Fetch the server's service name.
     result = le_cfg_GetString(i,
                               "interface",
-                              msgPtr->serverInterfaceName,
-                              sizeof(msgPtr->serverInterfaceName),
+                              binding.serverInterfaceName,
+                              sizeof(binding.serverInterfaceName),
                               "");
     if (result != LE_OK)
     {
@@ -447,7 +481,7 @@ static void SendCfgBindRequest
         LE_CRIT("Server interface name too big (@ %s)", path);
         return;
     }
-    if (msgPtr->serverInterfaceName[0] == '\0')
+    if (binding.serverInterfaceName[0] == '\0')
     {
         char path[LIMIT_MAX_PATH_BYTES];
         le_cfg_GetPath(i, "interface", path, sizeof(path));
@@ -455,14 +489,10 @@ static void SendCfgBindRequest
         return;
     }
 
-    msgRef = le_msg_RequestSyncResponse(msgRef);
-
-    if (msgRef == NULL)
+    if (fwrite(&binding, sizeof(binding), 1, bindingsFilePtr) != 1)
     {
-        ExitWithErrorMsg("Communication with Service Directory failed.");
+        ExitWithErrorMsg("Failed to write bindings file.");
     }
-
-    le_msg_ReleaseMsg(msgRef);
 }
 
 
@@ -583,8 +613,13 @@ static void Load
     // Start a read transaction on the root of the "system" configuration tree.
     le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:");
 
-    // Tell the Service Directory to delete all existing bindings.
-    SendUnbindAllRequest();
+    // Collect all the bindings in a temporary file, so they can be sent to the Service Directory
+    // in a single request.
+    FILE* bindingsFilePtr = tmpfile();
+    if (bindingsFilePtr == NULL)
+    {
+        ExitWithErrorMsg("Failed to create bindings file.");
+    }
 
     // Iterate over the users collection.
     le_cfg_GoToNode(i, "/users");
@@ -600,7 +635,7 @@ static void Load
             result = le_cfg_GoToFirstChild(i);
             while (result == LE_OK)
             {
-                SendCfgBindRequest(uid, i);
+                WriteCfgBinding(bindingsFilePtr, uid, i);
 
                 result = le_cfg_GoToNextSibling(i);
             }
@@ -628,7 +663,7 @@ static void Load
             result = le_cfg_GoToFirstChild(i);
             while (result == LE_OK)
             {
-                SendCfgBindRequest(uid, i);
+                WriteCfgBinding(bindingsFilePtr, uid, i);
 
                 result = le_cfg_GoToNextSibling(i);
             }
@@ -641,6 +676,227 @@ static void Load
         result = le_cfg_GoToNextSibling(i);
     }
 
+    // Tell the Service Directory to replace all existing bindings with the ones collected.
+    SendBindRequest(bindingsFilePtr, LE_SDTP_MSGID_BIND_ALL, 0);
+
+    fclose(bindingsFilePtr);
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the bindings of the users or apps in a collection to a given app's services to the file
+ * of bindings to be sent to the Service Directory.
+ *
+ * Only the server app name of each binding is read, so that the cost of looking for the few
+ * bindings to the app stays low.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteBindingsToApp
+(
+    FILE* bindingsFilePtr,      ///< [in] File to write the binding records to.
+    le_cfg_IteratorRef_t i,     ///< [in] Configuration read iterator on the "system" tree.
+    const char* collectionPath, ///< [in] "/users" or "/apps".
+    const char* appName         ///< [in] Name of the server app.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isAppCollection = (strcmp(collectionPath, "/apps") == 0);
+
+    le_cfg_GoToNode(i, collectionPath);
+    le_result_t result = le_cfg_GoToFirstChild(i);
+    while (result == LE_OK)
+    {
+        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+
+        // The app's own bindings have already been written.
+        if (   (le_cfg_GetNodeName(i, "", clientName, sizeof(clientName)) == LE_OK)
+            && !(isAppCollection && (strcmp(clientName, appName) == 0)) )
+        {
+            le_cfg_GoToNode(i, "bindings");
+            result = le_cfg_GoToFirstChild(i);
+            while (result == LE_OK)
+            {
+                char serverAppName[LIMIT_MAX_APP_NAME_BYTES];
+
+                if (   (le_cfg_GetString(i, "app", serverAppName, sizeof(serverAppName), "")
+                        == LE_OK)
+                    && (strcmp(serverAppName, appName) == 0) )
+                {
+                    // Look up the client's user ID from its node, then come back to the binding.
+                    char bindingName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];
+                    uid_t uid;
+
+                    if (le_cfg_GetNodeName(i, "", bindingName, sizeof(bindingName)) == LE_OK)
+                    {
+                        le_cfg_GoToNode(i, "../..");
+                        result = (isAppCollection ? GetAppUid(i, &uid) : GetUserUid(i, &uid));
+                        le_cfg_GoToNode(i, "bindings");
+                        le_cfg_GoToNode(i, bindingName);
+
+                        if (result == LE_OK)
+                        {
+                            WriteCfgBinding(bindingsFilePtr, uid, i);
+                        }
+                    }
+                }
+
+                result = le_cfg_GoToNextSibling(i);
+            }
+
+            // Go back up to the user or app node.
+            le_cfg_GoToNode(i, "../..");
+        }
+
+        // Move on to the next user or app.
+        result = le_cfg_GoToNextSibling(i);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Execute a 'load' command for a single app.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadApp
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    // Connect to the Configuration API server.
+    le_cfg_ConnectService();
+
+    // Initialize the "User API".
+    user_Init();
+
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:/apps");
+
+    if (!le_cfg_NodeExists(i, AppNamePtr))
+    {
+        le_cfg_CancelTxn(i);
+
+        char errorMsg[255];
+        snprintf(errorMsg, sizeof(errorMsg), "App '%s' is not installed.", AppNamePtr);
+        ExitWithErrorMsg(errorMsg);
+    }
+
+    le_cfg_GoToNode(i, AppNamePtr);
+
+    // The bindings of an unsandboxed app are the root user's, which can't be told apart from
+    // those of the other unsandboxed apps and of the framework, so reload everything.
+    if (!le_cfg_GetBool(i, "sandboxed", true))
+    {
+        le_cfg_CancelTxn(i);
+        Load();
+    }
+
+    uid_t uid;
+    if (GetAppUid(i, &uid) != LE_OK)
+    {
+        le_cfg_CancelTxn(i);
+        ExitWithErrorMsg("Failed to get the app's user ID.");
+    }
+
+    FILE* bindingsFilePtr = tmpfile();
+    if (bindingsFilePtr == NULL)
+    {
+        ExitWithErrorMsg("Failed to create bindings file.");
+    }
+
+    // Collect the app's own bindings.
+    le_cfg_GoToNode(i, "bindings");
+    result = le_cfg_GoToFirstChild(i);
+    while (result == LE_OK)
+    {
+        WriteCfgBinding(bindingsFilePtr, uid, i);
+
+        result = le_cfg_GoToNextSibling(i);
+    }
+
+    // Collect the bindings of other users and apps to the app's services, which couldn't be
+    // created before the app's user existed.
+    WriteBindingsToApp(bindingsFilePtr, i, "/users", AppNamePtr);
+    WriteBindingsToApp(bindingsFilePtr, i, "/apps", AppNamePtr);
+
+    le_cfg_CancelTxn(i);
+
+    // Tell the Service Directory to replace the app's bindings with the ones collected.
+    SendBindRequest(bindingsFilePtr, LE_SDTP_MSGID_BIND_USER, uid);
+
+    fclose(bindingsFilePtr);
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Execute an 'unload' command.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Unload
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Connect to the Configuration API server.
+    le_cfg_ConnectService();
+
+    // Initialize the "User API".
+    user_Init();
+
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:/apps");
+
+    if (!le_cfg_NodeExists(i, AppNamePtr))
+    {
+        le_cfg_CancelTxn(i);
+
+        char errorMsg[255];
+        snprintf(errorMsg, sizeof(errorMsg), "App '%s' is not installed.", AppNamePtr);
+        ExitWithErrorMsg(errorMsg);
+    }
+
+    le_cfg_GoToNode(i, AppNamePtr);
+
+    // The bindings of an unsandboxed app are the root user's.  They go away with the next
+    // full load.
+    if (!le_cfg_GetBool(i, "sandboxed", true))
+    {
+        le_cfg_CancelTxn(i);
+        exit(EXIT_SUCCESS);
+    }
+
+    uid_t uid;
+    le_result_t result = GetAppUid(i, &uid);
+
+    le_cfg_CancelTxn(i);
+
+    if (result != LE_OK)
+    {
+        ExitWithErrorMsg("Failed to get the app's user ID.");
+    }
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(SessionRef);
+    le_sdtp_Msg_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->msgType = LE_SDTP_MSGID_UNBIND_USER;
+    msgPtr->client = uid;
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+
+    if (msgRef == NULL)
+    {
+        ExitWithErrorMsg("Communication with Service Directory failed.");
+    }
+
+    le_msg_ReleaseMsg(msgRef);
 
     exit(EXIT_SUCCESS);
 }
@@ -822,6 +1078,23 @@ static void ServerIfArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Positional argument callback function that gets called with the APP_NAME argument from the
+ * command line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void AppNameArgHandler
+(
+    const char* argPtr  ///< Pointer to the argument string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Just save it for now.
+    AppNamePtr = argPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Positional argument callback function that gets called with the command argument from the
@@ -842,6 +1115,16 @@ static void CommandArgHandler
         le_arg_AddPositionalCallback(ClientIfArgHandler);
         le_arg_AddPositionalCallback(ServerIfArgHandler);
     }
+    // The load command takes an optional app name, and the unload command a mandatory one.
+    else if (strcmp(CommandPtr, "load") == 0)
+    {
+        le_arg_AddPositionalCallback(AppNameArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
+    else if (strcmp(CommandPtr, "unload") == 0)
+    {
+        le_arg_AddPositionalCallback(AppNameArgHandler);
+    }
 }
 
 
@@ -911,7 +1194,18 @@ COMPONENT_INIT
     }
     else if (strcmp(CommandPtr, "load") == 0)
     {
-        Load();
+        if (AppNamePtr == NULL)
+        {
+            Load();
+        }
+        else
+        {
+            LoadApp();
+        }
+    }
+    else if (strcmp(CommandPtr, "unload") == 0)
+    {
+        Unload();
     }
     else if (strcmp(CommandPtr, "bind") == 0)
     {